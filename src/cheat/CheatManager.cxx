@@ -15,15 +15,16 @@
 // this file, and for a DISCLAIMER OF ALL WARRANTIES.
 //============================================================================
 
-#include <iomanip>
-
 #include "OSystem.hxx"
+#include "Console.hxx"
+#include "System.hxx"
 #include "Cheat.hxx"
 #include "Settings.hxx"
 #include "CheetahCheat.hxx"
 #include "BankRomCheat.hxx"
 #include "RamCheat.hxx"
 #include "Vec.hxx"
+#include "repository/KeyValueRepository.hxx"
 
 #include "CheatManager.hxx"
 
@@ -100,6 +101,31 @@ void CheatManager::addPerFrame(string_view name, string_view code, bool enable)
     if(found)
       myPerFrameList.erase(perFrameIt);
   }
+
+  updatePerFramePatches();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void CheatManager::updatePerFramePatches()
+{
+  myPerFramePatches.clear();
+  for(const auto& cheat: myPerFrameList)
+    if(const auto* ramCheat = dynamic_cast<const RamCheat*>(cheat.get()))
+      myPerFramePatches.push_back({ramCheat->ramAddress(), ramCheat->ramValue()});
+
+  // Poke in address order; for duplicate addresses, the last cheat still wins
+  std::ranges::stable_sort(myPerFramePatches, {}, &RamPatch::address);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void CheatManager::evaluatePerFrame() const
+{
+  if(myPerFramePatches.empty())
+    return;
+
+  System& system = myOSystem.console().system();
+  for(const auto& [address, value]: myPerFramePatches)
+    system.pokeOob(address, value);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -182,37 +208,16 @@ void CheatManager::enable(string_view code, bool enable)
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void CheatManager::loadCheatDatabase()
+void CheatManager::setRepository(shared_ptr<KeyValueRepositoryAtomic> repository)
 {
-  std::stringstream in;
-  try         { myOSystem.cheatFile().read(in); }
-  catch(...)  { return; }
-
-  string md5, cheat;
-  while(in >> std::quoted(md5) >> std::quoted(cheat))
-    myCheatMap.emplace(md5, cheat);
-
-  myListIsDirty = false;
-}
-
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void CheatManager::saveCheatDatabase()
-{
-  if(!myListIsDirty)
-    return;
-
-  std::ostringstream out;
-  for(const auto& [md5, cheat]: myCheatMap)
-    out << std::quoted(md5) << ' ' << std::quoted(cheat) << '\n';
-
-  try         { myOSystem.cheatFile().write(out.view()); }
-  catch(...)  { return; }
+  myRepository = std::move(repository);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void CheatManager::loadCheats(string_view md5sum)
 {
   myPerFrameList.clear();
+  myPerFramePatches.clear();
   myCheatList.clear();
   myCurrentCheat = "";
 
@@ -223,15 +228,12 @@ void CheatManager::loadCheats(string_view md5sum)
     myOSystem.settings().setValue("cheat", "");
 
   // Remember the cheats for this ROM
-  const auto& iter = myCheatMap.find(md5sum);
-  if(iter != myCheatMap.end())
-    myCurrentCheat = iter->second;
+  Variant romCheats;
+  if(myRepository && myRepository->get(md5sum, romCheats))
+    myCurrentCheat = romCheats.toString();
 
   // Parse the cheat list, constructing cheats and adding them to the manager
-  const string& mapCheats = (iter != myCheatMap.end())
-    ? iter->second
-    : EmptyString();
-  parse(cheats.empty() ? mapCheats : mapCheats + cheats);
+  parse(cheats.empty() ? myCurrentCheat : myCurrentCheat + cheats);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -244,24 +246,18 @@ void CheatManager::saveCheats(string_view md5sum)
     serialized += std::format("{}:{}:{}", c->name(), c->code(), c->enabled());
   }
 
-  const bool changed = serialized != myCurrentCheat;
-
-  // Only update the list if absolutely necessary
-  if(changed)
+  // Only update the repository if absolutely necessary
+  if(myRepository && serialized != myCurrentCheat)
   {
-    const auto iter = myCheatMap.find(md5sum);
-
-    // Erase old entry and add a new one only if it's changed
-    if(iter != myCheatMap.end())
-      myCheatMap.erase(iter);
-    // Add new entry only if there are any cheats defined
-    if(!serialized.empty())
-      myCheatMap.emplace(md5sum, serialized);
+    // Keep an entry only if there are any cheats defined
+    if(serialized.empty())
+      myRepository->remove(md5sum);
+    else
+      myRepository->save(md5sum, serialized);
   }
 
-  // Update the dirty flag
-  myListIsDirty = myListIsDirty || changed;
   myPerFrameList.clear();
+  myPerFramePatches.clear();
   myCheatList.clear();
 }
 
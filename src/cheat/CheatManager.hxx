@@ -18,10 +18,9 @@
 #ifndef CHEAT_MANAGER_HXX
 #define CHEAT_MANAGER_HXX
 
-#include <map>
-
 class Cheat;
 class OSystem;
+class KeyValueRepositoryAtomic;
 
 #include "bspf.hxx"
 
@@ -100,22 +99,25 @@ class CheatManager
     const CheatList& perFrame() const { return myPerFrameList; }
 
     /**
-      Load all cheats (for all ROMs) from disk to internal database.
+      Apply all enabled per-frame cheats; called once per frame.
     */
-    void loadCheatDatabase();
+    void evaluatePerFrame() const;
 
     /**
-      Save all cheats (for all ROMs) in internal database to disk.
+      Set the repository holding the cheats of all ROMs, keyed by MD5sum.
+      Only the cheats of the current ROM are ever read or written.
     */
-    void saveCheatDatabase();
+    void setRepository(shared_ptr<KeyValueRepositoryAtomic> repository);
 
     /**
-      Load cheats for ROM with given MD5sum to cheatlist(s).
+      Load cheats for ROM with given MD5sum from the repository to
+      cheatlist(s).
     */
     void loadCheats(string_view md5sum);
 
     /**
-      Saves cheats for ROM with given MD5sum to cheat map.
+      Saves cheats for ROM with given MD5sum to the repository (if they
+      have been modified).
     */
     void saveCheats(string_view md5sum);
 
@@ -142,22 +144,30 @@ class CheatManager
     */
     void parse(string_view cheats);
 
+    /**
+      Rebuild the RAM patches from the per-frame cheatlist.
+    */
+    void updatePerFramePatches();
+
   private:
     OSystem& myOSystem;
 
     CheatList myCheatList;
     CheatList myPerFrameList;
 
-    std::map<string,string, std::less<>> myCheatMap;
-    string myCheatFile;
+    // The per-frame cheats, resolved into the RAM pokes they do each frame
+    struct RamPatch {
+      uInt16 address{0};
+      uInt8  value{0};
+    };
+    vector<RamPatch> myPerFramePatches;
+
+    shared_ptr<KeyValueRepositoryAtomic> myRepository;
 
     // This is set each time a new cheat/ROM is loaded, for later
     // comparison to see if the cheatcode list has actually been modified
     string myCurrentCheat;
 
-    // Indicates that the list has been modified, and should be saved to disk
-    bool myListIsDirty{false};
-
   private:
     // Following constructors and assignment operators not supported
     CheatManager() = delete;
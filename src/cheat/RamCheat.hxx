@@ -30,6 +30,10 @@ class RamCheat : public Cheat
     bool disable() override;
     void evaluate() override;
 
+    // The RAM location and the value poked into it every frame
+    uInt16 ramAddress() const { return address; }
+    uInt8  ramValue() const { return value; }
+
   private:
     uInt16 address{0};
     uInt8  value{0};
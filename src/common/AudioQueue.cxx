@@ -15,45 +15,206 @@
 // this file, and for a DISCLAIMER OF ALL WARRANTIES.
 //============================================================================
 
+#include <bit>
+#include <thread>
+
 #include "AudioQueue.hxx"
+#include "PerfCounters.hxx"
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+AudioQueue::Ring::Ring(uInt32 slots)
+  : myMask{std::bit_ceil(slots) - 1},
+    mySlot{std::make_unique<std::atomic<Int16*>[]>(myMask + 1)}
+{
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void AudioQueue::Ring::push(Int16* fragment)
+{
+  // The ring always has more slots than there are fragments, so this never
+  // overwrites a slot that is still queued
+  const uInt32 tail = myTail.load(std::memory_order_relaxed);
+
+  mySlot[tail & myMask].store(fragment, std::memory_order_relaxed);
+  myTail.store(tail + 1, std::memory_order_release);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+Int16* AudioQueue::Ring::pop()
+{
+  uInt32 head = myHead.load(std::memory_order_acquire);
+
+  for (;;) {
+    if (head == myTail.load(std::memory_order_acquire)) return nullptr;
+
+    Int16* fragment = mySlot[head & myMask].load(std::memory_order_relaxed);
+
+    // A failed exchange means the other side took this fragment; retry with
+    // the updated head
+    if (myHead.compare_exchange_weak(head, head + 1,
+        std::memory_order_acq_rel, std::memory_order_acquire))
+      return fragment;
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt32 AudioQueue::Ring::size() const
+{
+  const uInt32 head = myHead.load(std::memory_order_acquire);
+
+  return myTail.load(std::memory_order_acquire) - head;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+AudioQueue::FreeList::FreeList(uInt32 fragments)
+  : myNext{std::make_unique<std::atomic<uInt32>[]>(fragments)}
+{
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void AudioQueue::FreeList::push(uInt32 index)
+{
+  uInt32 head = myHead.load(std::memory_order_relaxed);
+
+  do
+    myNext[index].store(head, std::memory_order_relaxed);
+  while (!myHead.compare_exchange_weak(head, index,
+         std::memory_order_release, std::memory_order_relaxed));
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt32 AudioQueue::FreeList::pop()
+{
+  uInt32 head = myHead.load(std::memory_order_acquire);
+
+  // The head can only change by pushes while we are popping, which never
+  // touch the link of the current head
+  while (head != NO_FRAGMENT &&
+         !myHead.compare_exchange_weak(head,
+           myNext[head].load(std::memory_order_relaxed),
+           std::memory_order_acquire, std::memory_order_acquire));
+
+  return head;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+AudioQueue::Tap::Tap(shared_ptr<AudioQueue> queue)
+  : myQueue{std::move(queue)},
+    myCursor{myQueue->myTapSequence.load(std::memory_order_acquire)}
+{
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+AudioQueue::Tap::~Tap()
+{
+  if (myFragment != NO_FRAGMENT) myQueue->release(myFragment);
+
+  myQueue->myTaps.fetch_sub(1, std::memory_order_relaxed);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+const Int16* AudioQueue::Tap::read()
+{
+  AudioQueue& queue = *myQueue;
+
+  if (myFragment != NO_FRAGMENT) {
+    queue.release(myFragment);
+    myFragment = NO_FRAGMENT;
+  }
+
+  for (;;) {
+    const uInt64 published = queue.myTapSequence.load(std::memory_order_acquire);
+    if (myCursor == published) return nullptr;
+
+    // Skip what has been overwritten already
+    if (published - myCursor > TAP_SLOTS) {
+      myDropped += published - TAP_SLOTS - myCursor;
+      myCursor = published - TAP_SLOTS;
+    }
+
+    const std::atomic<uInt64>& slot = queue.myTapSlot[myCursor % TAP_SLOTS];
+    const uInt64 packed = slot.load(std::memory_order_acquire);
+
+    if (static_cast<uInt32>(packed >> 32) == static_cast<uInt32>(myCursor)) {
+      // Take a reference, unless the fragment has been freed meanwhile...
+      const uInt32 index = static_cast<uInt32>(packed) - 1;
+      std::atomic<uInt32>& references = queue.myReferences[index];
+      uInt32 count = references.load(std::memory_order_relaxed);
+
+      while (count > 0 && !references.compare_exchange_weak(count, count + 1,
+             std::memory_order_acquire, std::memory_order_relaxed));
+
+      // ... and make sure that it is still the published one (and not
+      // already refilled by the producer)
+      if (count > 0) {
+        if (slot.load(std::memory_order_acquire) == packed) {
+          myFragment = index;
+          ++myCursor;
+
+          return queue.fragmentAt(index);
+        }
+        queue.release(index);
+      }
+    }
+
+    // The producer has overwritten the slot while we were reading it
+    ++myDropped;
+    ++myCursor;
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+unique_ptr<AudioQueue::Tap> AudioQueue::openTap(const shared_ptr<AudioQueue>& queue)
+{
+  uInt32 taps = queue->myTaps.load(std::memory_order_relaxed);
+
+  do
+    if (taps >= MAX_TAPS) return nullptr;
+  while (!queue->myTaps.compare_exchange_weak(taps, taps + 1,
+         std::memory_order_relaxed));
+
+  return std::make_unique<Tap>(queue);
+}
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 AudioQueue::AudioQueue(uInt32 fragmentSize, uInt32 capacity, bool isStereo)
   : myFragmentSize{fragmentSize},
     myIsStereo{isStereo},
-    myFragmentQueue{capacity},
-    myAllFragments{capacity + 2}
+    myCapacity{capacity},
+    myFragmentStride{fragmentSize * (isStereo ? 2 : 1)},
+    // Besides the queued fragments, one is being filled and one is being
+    // played (two while dequeuing); the taps may hold the published ones
+    // and one each
+    myFragmentCount{capacity + 2 + TAP_SLOTS + MAX_TAPS},
+    myQueued{capacity + 2},
+    myFree{myFragmentCount},
+    myFragmentBuffer{std::make_unique<Int16[]>(
+      static_cast<size_t>(myFragmentStride) * myFragmentCount)},
+    myReferences{std::make_unique<std::atomic<uInt32>[]>(myFragmentCount)},
+    myTapSlot{std::make_unique<std::atomic<uInt64>[]>(TAP_SLOTS)}
 {
-  const uInt8 sampleSize = myIsStereo ? 2 : 1;
-
-  myFragmentBuffer = std::make_unique<Int16[]>(
-      static_cast<size_t>(myFragmentSize) * sampleSize * (capacity + 2));
+  for (uInt32 i = 2; i < myFragmentCount; ++i)
+    myFree.push(i);
 
-  for (uInt32 i = 0; i < capacity; ++i)
-    myFragmentQueue[i] = myAllFragments[i] = myFragmentBuffer.get() +
-      static_cast<size_t>(myFragmentSize) * sampleSize * i;
+  // These are owned by the producer and the sound driver
+  myFirstFragmentForEnqueue = fragmentAt(0);
+  myReferences[0] = 1;
 
-  myAllFragments[capacity] = myFirstFragmentForEnqueue =
-    myFragmentBuffer.get() + static_cast<size_t>(myFragmentSize) * sampleSize *
-    capacity;
-
-  myAllFragments[capacity + 1] = myFirstFragmentForDequeue =
-    myFragmentBuffer.get() + static_cast<size_t>(myFragmentSize) * sampleSize *
-    (capacity + 1);
+  myFirstFragmentForDequeue = fragmentAt(1);
+  myReferences[1] = 1;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 uInt32 AudioQueue::capacity() const
 {
-  return static_cast<uInt32>(myFragmentQueue.size());
+  return myCapacity;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 uInt32 AudioQueue::size() const
 {
-  const std::scoped_lock guard(myMutex);
-
-  return mySize;
+  // During an overflow the queue briefly holds one fragment more
+  return std::min(myQueued.size(), myCapacity);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -68,10 +229,19 @@ uInt32 AudioQueue::fragmentSize() const
   return myFragmentSize;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+size_t AudioQueue::memoryUsage() const
+{
+  return static_cast<size_t>(myFragmentStride) * myFragmentCount * sizeof(Int16) +
+         std::bit_ceil(myCapacity + 2) * sizeof(std::atomic<Int16*>) +
+         static_cast<size_t>(myFragmentCount) * 2 * sizeof(std::atomic<uInt32>) +
+         TAP_SLOTS * sizeof(std::atomic<uInt64>);
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 Int16* AudioQueue::enqueue(Int16* fragment)
 {
-  const std::scoped_lock guard(myMutex);
+  PERF_SCOPE(AudioQueue);
 
   Int16* newFragment = nullptr;  // NOLINT (must not be const)
 
@@ -84,40 +254,62 @@ Int16* AudioQueue::enqueue(Int16* fragment)
     return newFragment;
   }
 
-  const auto capacity = static_cast<uInt8>(myFragmentQueue.size());
-  const uInt8 fragmentIndex = (myNextFragment + mySize) % capacity;
+  // Our reference passes on to the queue, the taps get another one
+  if (myTaps.load(std::memory_order_relaxed) > 0)
+    publish(indexOf(fragment));
 
-  newFragment = myFragmentQueue.at(fragmentIndex);
-  myFragmentQueue.at(fragmentIndex) = fragment;
+  myQueued.push(fragment);
 
-  if (mySize < capacity) ++mySize;
-  else {
-    myNextFragment = (myNextFragment + 1) % capacity;
-    if (!myIgnoreOverflows) myOverflowLogger.log();
+  // If the queue is full, we drop the oldest queued fragment
+  if (myQueued.size() > myCapacity) {
+    Int16* dropped = myQueued.pop();  // NOLINT (must not be const)
+
+    if (dropped) {
+      release(indexOf(dropped));
+
+      if (!myIgnoreOverflows) {
+        myOverflowLogger.log();
+        myOverflows.fetch_add(1, std::memory_order_relaxed);
+      }
+    }
   }
 
-  return newFragment;
+  // There are enough fragments that one is always free, apart from the
+  // moment in which the consumer (or a tap) is about to return one
+  uInt32 index = NO_FRAGMENT;
+  while ((index = myFree.pop()) == NO_FRAGMENT)
+    std::this_thread::yield();
+
+  // Release, so that a tap which takes a reference right now sees that the
+  // fragment isn't the published one anymore
+  myReferences[index].store(1, std::memory_order_release);
+
+  return fragmentAt(index);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 Int16* AudioQueue::dequeue(Int16* fragment)
 {
-  const std::scoped_lock guard(myMutex);
+  PERF_SCOPE(AudioQueue);
 
-  if (mySize == 0) return nullptr;
+  if (!fragment && !myFirstFragmentForDequeue)
+    throw std::runtime_error("dequeue called empty");
 
-  if (!fragment) {
-    if (!myFirstFragmentForDequeue) throw std::runtime_error("dequeue called empty");
+  Int16* nextFragment = myQueued.pop();  // NOLINT (must not be const)
+  if (!nextFragment) {
+    if (!myIsUnderrun) myUnderruns.fetch_add(1, std::memory_order_relaxed);
+    myIsUnderrun = true;
+
+    return nullptr;
+  }
+  myIsUnderrun = false;
 
+  if (!fragment) {
     fragment = myFirstFragmentForDequeue;
     myFirstFragmentForDequeue = nullptr;
   }
 
-  Int16* nextFragment = myFragmentQueue.at(myNextFragment);  // NOLINT (must not be const)
-  myFragmentQueue.at(myNextFragment) = fragment;
-
-  --mySize;
-  myNextFragment = (myNextFragment + 1) % myFragmentQueue.size();
+  release(indexOf(fragment));
 
   return nextFragment;
 }
@@ -125,8 +317,6 @@ Int16* AudioQueue::dequeue(Int16* fragment)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void AudioQueue::closeSink(Int16* fragment)
 {
-  const std::scoped_lock guard(myMutex);
-
   if (myFirstFragmentForDequeue && fragment)
     throw std::runtime_error("attempt to return unknown buffer on closeSink");
 
@@ -139,3 +329,24 @@ void AudioQueue::ignoreOverflows(bool shouldIgnoreOverflows)
 {
   myIgnoreOverflows = shouldIgnoreOverflows;
 }
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void AudioQueue::release(uInt32 index)
+{
+  if (myReferences[index].fetch_sub(1, std::memory_order_acq_rel) == 1)
+    myFree.push(index);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void AudioQueue::publish(uInt32 index)
+{
+  const uInt64 sequence = myTapSequence.load(std::memory_order_relaxed);
+
+  myReferences[index].fetch_add(1, std::memory_order_relaxed);
+
+  const uInt64 evicted = myTapSlot[sequence % TAP_SLOTS].exchange(
+    (sequence << 32) | (index + 1), std::memory_order_acq_rel);
+  if (evicted) release(static_cast<uInt32>(evicted) - 1);
+
+  myTapSequence.store(sequence + 1, std::memory_order_release);
+}
@@ -18,7 +18,7 @@
 #ifndef AUDIO_QUEUE_HXX
 #define AUDIO_QUEUE_HXX
 
-#include <mutex>
+#include <atomic>
 
 #include "bspf.hxx"
 #include "StaggeredLogger.hxx"
@@ -33,6 +33,22 @@
   The queue needs to be threadsafe as the (SDL) audio driver runs on a
   separate thread. Samples are stored as signed 16 bit integers
   (platform endian).
+
+  There is exactly one producer (the emulation) and one consumer (the sound
+  driver), so the queue is lock-free: queued fragments travel through a
+  ring indexed by atomic counters, and fragments return to a free list once
+  they are no longer referenced. The audio callback thus never waits for
+  the emulation thread. On overflow, the producer drops the oldest queued
+  fragment from the consumer side of the ring with a compare-and-swap on
+  its head.
+
+  Additional consumers (e.g. the shared memory export or the metrics
+  server) can read the same fragments through a Tap. While any tap is open,
+  the producer also publishes each fragment into a broadcast ring, in which
+  every tap has its own read cursor. Fragments are reference counted, so a
+  tap reads them in place, and neither the producer nor the sound driver
+  ever waits for a tap; a tap which falls behind by more than the broadcast
+  ring loses the oldest fragments instead.
 */
 class AudioQueue
 {
@@ -48,6 +64,59 @@ class AudioQueue
     AudioQueue(uInt32 fragmentSize, uInt32 capacity, bool isStereo);
     ~AudioQueue() = default;
 
+    /**
+      A read cursor on the fragments produced by the emulation, independent
+      of the sound driver and any other tap. Each tap must only be used by
+      one thread at a time; it keeps the queue alive until it is destroyed.
+     */
+    class Tap
+    {
+      public:
+        explicit Tap(shared_ptr<AudioQueue> queue);
+        ~Tap();
+
+        /**
+          Get the next fragment produced since the previous call (or since
+          the tap was opened), or nullptr if there is none. This releases
+          the previously returned fragment, which is valid until then.
+         */
+        const Int16* read();
+
+        /**
+          The queue this tap is reading.
+         */
+        const AudioQueue& queue() const { return *myQueue; }
+
+        /**
+          The number of fragments missed because the tap fell behind.
+         */
+        uInt64 dropped() const { return myDropped; }
+
+      private:
+        shared_ptr<AudioQueue> myQueue;
+
+        // The sequence number of the next fragment to read
+        uInt64 myCursor{0};
+
+        // The fragment returned by the last read, if any
+        uInt32 myFragment{NO_FRAGMENT};
+
+        uInt64 myDropped{0};
+
+      private:
+        Tap() = delete;
+        Tap(const Tap&) = delete;
+        Tap(Tap&&) = delete;
+        Tap& operator=(const Tap&) = delete;
+        Tap& operator=(Tap&&) = delete;
+    };
+
+    /**
+      Open a tap on the given queue, or return nullptr if the maximum number
+      of taps is already open.
+     */
+    static unique_ptr<Tap> openTap(const shared_ptr<AudioQueue>& queue);
+
     /**
        Capacity getter.
      */
@@ -68,6 +137,11 @@ class AudioQueue
      */
     uInt32 fragmentSize() const;
 
+    /**
+      The number of bytes owned by the queue (the fragments and the rings).
+     */
+    size_t memoryUsage() const;
+
     /**
       Enqueue a new fragment and get a new fragmen to fill.
 
@@ -97,6 +171,108 @@ class AudioQueue
      */
     void ignoreOverflows(bool shouldIgnoreOverflows);
 
+    /**
+      The number of fragments dropped because the queue was full (apart from
+      the ignored overflows).
+     */
+    uInt64 overflows() const { return myOverflows.load(std::memory_order_relaxed); }
+
+    /**
+      The number of times the sound driver ran out of queued fragments.
+     */
+    uInt64 underruns() const { return myUnderruns.load(std::memory_order_relaxed); }
+
+  private:
+
+    // The number of taps that can be open at the same time
+    static constexpr uInt32 MAX_TAPS = 4;
+
+    // The number of fragments published to the taps that are kept, about
+    // half a second
+    static constexpr uInt32 TAP_SLOTS = 64;
+
+    static constexpr uInt32 NO_FRAGMENT = ~0U;
+
+    /**
+      A fixed size ring of fragment pointers. Each ring has a single pushing
+      thread, but the queued ring is also popped by the producer on overflow,
+      so the head is always advanced by CAS.
+      Head and tail are free running counters and live on their own cache
+      lines to avoid false sharing between the two threads.
+     */
+    class Ring
+    {
+      public:
+        explicit Ring(uInt32 slots);
+
+        void push(Int16* fragment);
+        Int16* pop();
+
+        uInt32 size() const;
+
+      private:
+        // The slot count is a power of two, so indices stay consistent when
+        // the counters wrap
+        uInt32 myMask{0};
+        unique_ptr<std::atomic<Int16*>[]> mySlot;
+
+        alignas(64) std::atomic<uInt32> myHead{0};
+        alignas(64) std::atomic<uInt32> myTail{0};
+
+      private:
+        Ring() = delete;
+        Ring(const Ring&) = delete;
+        Ring(Ring&&) = delete;
+        Ring& operator=(const Ring&) = delete;
+        Ring& operator=(Ring&&) = delete;
+    };
+
+    /**
+      A stack of free fragment indices, which may be pushed by every thread
+      dropping the last reference to a fragment. Only the producer pops, so
+      the stack is safe from the ABA problem.
+     */
+    class FreeList
+    {
+      public:
+        explicit FreeList(uInt32 fragments);
+
+        void push(uInt32 index);
+        uInt32 pop();
+
+      private:
+        unique_ptr<std::atomic<uInt32>[]> myNext;
+
+        alignas(64) std::atomic<uInt32> myHead{NO_FRAGMENT};
+
+      private:
+        FreeList() = delete;
+        FreeList(const FreeList&) = delete;
+        FreeList(FreeList&&) = delete;
+        FreeList& operator=(const FreeList&) = delete;
+        FreeList& operator=(FreeList&&) = delete;
+    };
+
+  private:
+
+    Int16* fragmentAt(uInt32 index) const {
+      return myFragmentBuffer.get() + static_cast<size_t>(myFragmentStride) * index;
+    }
+    uInt32 indexOf(const Int16* fragment) const {
+      return static_cast<uInt32>((fragment - myFragmentBuffer.get()) / myFragmentStride);
+    }
+
+    /**
+      Drop a reference to a fragment, and return it to the free list if it
+      was the last one.
+     */
+    void release(uInt32 index);
+
+    /**
+      Publish a fragment to the taps, dropping the oldest published one.
+     */
+    void publish(uInt32 index);
+
   private:
 
     // The size of an individual fragment (in stereo / mono samples)
@@ -105,23 +281,33 @@ class AudioQueue
     // Are we using stereo samples?
     bool myIsStereo{false};
 
-    // The fragment queue
-    vector<Int16*> myFragmentQueue;
+    // The number of fragments that can be queued
+    uInt32 myCapacity{0};
+
+    // The number of samples per fragment (times two for stereo), and the
+    // number of fragments allocated
+    uInt32 myFragmentStride{0};
+    uInt32 myFragmentCount{0};
 
-    // All fragments, including the two fragments that are in circulation.
-    vector<Int16*> myAllFragments;
+    // Fragments filled by the emulation and waiting for playback
+    Ring myQueued;
+
+    // Fragments which are no longer referenced and ready to be filled again
+    FreeList myFree;
 
     // We allocate a consecutive slice of memory for the fragments.
     unique_ptr<Int16[]> myFragmentBuffer;
 
-    // The nubmer if queued fragments
-    uInt32 mySize{0};
-
-    // The next fragment.
-    uInt32 myNextFragment{0};
+    // The references to each fragment: the one being filled or played, and
+    // those queued, published in the broadcast ring or read by a tap
+    unique_ptr<std::atomic<uInt32>[]> myReferences;
 
-    // We need a mutex for thread safety.
-    mutable std::mutex myMutex;
+    // The broadcast ring; each slot holds the lower 32 bits of the sequence
+    // number of the fragment and its index + 1 (0 = empty)
+    unique_ptr<std::atomic<uInt64>[]> myTapSlot;
+    // The number of fragments published so far
+    alignas(64) std::atomic<uInt64> myTapSequence{0};
+    std::atomic<uInt32> myTaps{0};
 
     // The first (empty) enqueue call returns this fragment.
     Int16* myFirstFragmentForEnqueue{nullptr};
@@ -129,10 +315,16 @@ class AudioQueue
     Int16* myFirstFragmentForDequeue{nullptr};
 
     // Log overflows?
-    bool myIgnoreOverflows{true};
+    std::atomic<bool> myIgnoreOverflows{true};
 
     StaggeredLogger myOverflowLogger{"audio buffer overflow", Logger::Level::INFO};
 
+    // Statistics, read from other threads. An underrun is counted once
+    // until the next fragment could be dequeued again.
+    std::atomic<uInt64> myOverflows{0};
+    std::atomic<uInt64> myUnderruns{0};
+    bool myIsUnderrun{true};
+
   private:
     AudioQueue() = delete;
     AudioQueue(const AudioQueue&) = delete;
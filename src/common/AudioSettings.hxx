@@ -37,7 +37,8 @@ class AudioSettings
     enum class ResamplingQuality: uInt8 {
       nearestNeighbour   = 0,
       lanczos_2          = 1,
-      lanczos_3          = 2
+      lanczos_3          = 2,
+      blep               = 3
     };
 
     static constexpr string_view SETTING_PRESET              = "audio.preset";
@@ -149,8 +149,16 @@ bool Bezel::load()
           const FSNode node(imagePath);
           if(node.exists())
           {
+            // Decoding the PNG is expensive, so only do it for a new image
+            const uInt64 modified = node.getLastModified();
+            if(imagePath != myImagePath || modified != myImageModified)
+            {
+              myImagePath.clear();
+              myOSystem.png().loadImage(imagePath, *mySurface, metaData);
+              myImagePath = imagePath;
+              myImageModified = modified;
+            }
             isValid = true;
-            myOSystem.png().loadImage(imagePath, *mySurface, metaData);
             break;
           }
         }
@@ -200,6 +208,7 @@ bool Bezel::load()
       if(mySurface)
         myFB.deallocateSurface(mySurface);
       mySurface = nullptr;
+      myImagePath.clear();
       myInfo = Info();
       myFB.showTextMessage("Invalid bezel image ('" + imageName + "')!");
       isValid = false;
@@ -139,6 +139,12 @@ class Bezel
     // Bezel info structure
     Info myInfo;
 
+    // The image (and its modification time) currently decoded into the
+    // surface, which is reused as long as the same image is loaded (e.g.
+    // after video mode changes, or for ROMs sharing a bezel)
+    string myImagePath;
+    uInt64 myImageModified{0};
+
   private:
     // Following constructors and assignment operators not supported
     Bezel() = delete;
@@ -96,6 +96,9 @@ void DevSettingsHandler::loadSettings(SettingsSet set)
   myUncompressed[set] = settings.getInt(prefix + "tm.uncompressed");
   myStateInterval[set] = settings.getString(prefix + "tm.interval");
   myStateHorizon[set] = settings.getString(prefix + "tm.horizon");
+  myStateDelta[set] = settings.getBool(prefix + "tm.delta");
+  myStateBudget[set] = settings.getInt(prefix + "tm.budget");
+  myStateBudgetMem[set] = settings.getInt(prefix + "tm.budgetmem");
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -173,6 +176,9 @@ void DevSettingsHandler::saveSettings(SettingsSet set)
   settings.setValue(prefix + "tm.uncompressed", myUncompressed[set]);
   settings.setValue(prefix + "tm.interval", myStateInterval[set]);
   settings.setValue(prefix + "tm.horizon", myStateHorizon[set]);
+  settings.setValue(prefix + "tm.delta", myStateDelta[set]);
+  settings.setValue(prefix + "tm.budget", myStateBudget[set]);
+  settings.setValue(prefix + "tm.budgetmem", myStateBudgetMem[set]);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -197,6 +203,10 @@ void DevSettingsHandler::applySettings(SettingsSet set)
   {
     myOSystem.console().system().m6502().setReadFromWritePortBreak(myRWPortBreak[set]);
     myOSystem.console().system().m6502().setWriteToReadPortBreak(myWRPortBreak[set]);
+    if(set == SettingsSet::developer)
+      myOSystem.console().system().enableAccessTracking();
+    myOSystem.console().system().setAccessCounting(set == SettingsSet::developer
+      ? System::AccessCounting::batched : System::AccessCounting::off);
   }
 #endif
 
@@ -89,6 +89,9 @@ class DevSettingsHandler
     std::array<int, numSets>    myUncompressed{};
     std::array<string, numSets> myStateInterval{};
     std::array<string, numSets> myStateHorizon{};
+    std::array<bool, numSets>   myStateDelta{};
+    std::array<int, numSets>    myStateBudget{};
+    std::array<int, numSets>    myStateBudgetMem{};
 
   private:
     void handleEnableDebugColors(bool enable);
@@ -0,0 +1,139 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2026 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#include <ctime>
+
+#include "FSNodeFactory.hxx"
+#include "DirectoryIndex.hxx"
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool DirectoryIndex::getAllChildren(const FSNode& dir, FSList& fslist,
+    FSNode::ListMode mode, const FSNode::NameFilter& filter,
+    bool includeParentDirectory, const FSNode::CancelCheck& isCancelled)
+{
+  if(!dir.isDirectory())
+    return false;
+
+  // Add parent node, if it is valid to do so
+  if(includeParentDirectory && dir.hasParent() && mode != FSNode::ListMode::FilesOnly)
+  {
+    FSNode parent = dir.getParent();
+    parent.setName("..");
+    fslist.emplace_back(std::move(parent));
+  }
+
+  if(!addChildren(dir, fslist, mode, filter, isCancelled))
+    return false;
+
+  std::ranges::sort(fslist, [](const FSNode& node1, const FSNode& node2)
+  {
+    if(node1.isDirectory() != node2.isDirectory())
+      return node1.isDirectory();
+    else
+      return BSPF::compareIgnoreCase(node1.getName(), node2.getName()) < 0;
+  });
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool DirectoryIndex::addChildren(const FSNode& dir, FSList& fslist,
+    FSNode::ListMode mode, const FSNode::NameFilter& filter,
+    const FSNode::CancelCheck& isCancelled)
+{
+  const Directory* entry = directory(dir, isCancelled);
+  if(entry == nullptr)
+    return false;
+
+  for(const auto& node: entry->entries)
+  {
+    if(isCancelled())
+      return false;
+
+    const bool isZip = BSPF::endsWithIgnoreCase(node.getPath(), ".zip");
+
+    // Honor the chosen mode; a ZIP file is a file for the file system
+    if(isZip || !node.isDirectory())
+    {
+      if(mode != FSNode::ListMode::DirectoriesOnly && filter(node))
+        fslist.push_back(node);
+    }
+    else if(mode != FSNode::ListMode::FilesOnly)
+    {
+      // The result may be partial, even if cancelled
+      if(!addChildren(node, fslist, mode, filter, isCancelled))
+        return false;
+    }
+  }
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+const DirectoryIndex::Directory* DirectoryIndex::directory(
+    const FSNode& dir, const FSNode::CancelCheck& isCancelled)
+{
+  const uInt64 modified = dir.getLastModified();
+  Directory& entry = myDirectories.try_emplace(dir.getPath()).first->second;
+
+  // The modification time only has a resolution of seconds; the entries
+  // can only be trusted if they were read after the second in which the
+  // last change happened
+  if(entry.modified == modified && modified != 0 && modified < entry.listed)
+  {
+    // ZIP files may have been overwritten in place
+    for(auto& zip: entry.zips)
+    {
+      if(const uInt64 current = FSNodeFactory::create(zip.path,
+           FSNodeFactory::Type::SYSTEM)->getLastModified();
+         current != zip.modified)
+      {
+        entry.entries[zip.entry] = FSNode(zip.path);
+        zip.modified = current;
+      }
+    }
+    return &entry;
+  }
+
+  entry.entries.clear();
+  entry.zips.clear();
+  entry.modified = modified;
+  entry.listed = static_cast<uInt64>(std::time(nullptr));
+
+  FSList children;
+  if(!dir.getChildren(children, FSNode::ListMode::All,
+      [](const FSNode&) { return true; }, false, false, isCancelled))
+  {
+    myDirectories.erase(dir.getPath());
+    return nullptr;
+  }
+  entry.entries = std::move(children);
+
+  for(size_t i = 0; i < entry.entries.size(); ++i)
+  {
+    // Nodes inside a ZIP file have the path of the virtual file appended
+    const string& path = entry.entries[i].getPath();
+    const size_t pos = BSPF::findIgnoreCase(path, ".zip");
+
+    if(pos != string::npos &&
+       (pos + 4 == path.length() || path[pos + 4] == '/'))
+      entry.zips.push_back({i, path.substr(0, pos + 4), entry.entries[i].getLastModified()});
+  }
+
+  if(myListedCallback)
+    myListedCallback(dir.getPath(), entry.modified, entry.listed, entry.entries);
+
+  return &entry;
+}
@@ -0,0 +1,107 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2026 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#ifndef DIRECTORY_INDEX_HXX
+#define DIRECTORY_INDEX_HXX
+
+#include <unordered_map>
+
+#include "bspf.hxx"
+#include "FSNode.hxx"
+
+/**
+  An index of the directory trees listed by the launcher when ROMs from all
+  subdirectories are shown.  Each directory's entries are remembered
+  together with the directory's modification time, so when a tree is
+  listed again, only the directories changed since (i.e. with files added,
+  removed or renamed) are read again.  Likewise, ZIP files are only
+  examined again when they were modified.
+
+  @author  Stella Team
+*/
+class DirectoryIndex
+{
+  public:
+    // Called whenever a directory was read (again), with its path,
+    // modification time, the time it was read and its entries
+    using ListedCallback = std::function<void(const string&, uInt64, uInt64,
+                                              const FSList&)>;
+
+  public:
+    DirectoryIndex() = default;
+    ~DirectoryIndex() = default;
+
+    /**
+      Return the contents of the given directory and all its
+      subdirectories, like FSNode::getAllChildren().
+
+      @return  True if successful, false otherwise (e.g. when the directory
+               does not exist or the listing was cancelled)
+    */
+    bool getAllChildren(const FSNode& dir, FSList& fslist,
+                        FSNode::ListMode mode, const FSNode::NameFilter& filter,
+                        bool includeParentDirectory,
+                        const FSNode::CancelCheck& isCancelled);
+
+    /**
+      Forget all directories, e.g. when the contents may have changed
+      without the modification times reflecting it.
+    */
+    void clear() { myDirectories.clear(); }
+
+    /**
+      Set the function to be informed about each directory read.
+    */
+    void setListedCallback(ListedCallback callback) {
+      myListedCallback = std::move(callback);
+    }
+
+  private:
+    struct ZipFile {
+      size_t entry{0};
+      string path;  // of the ZIP file itself, without any virtual file
+      uInt64 modified{0};
+    };
+    struct Directory {
+      uInt64 modified{0};
+      uInt64 listed{0};  // when the entries were read
+      FSList entries;    // unfiltered, ZIP files already examined
+      std::vector<ZipFile> zips;
+    };
+
+    // Get the (possibly cached) entries of a single directory
+    const Directory* directory(const FSNode& dir,
+                               const FSNode::CancelCheck& isCancelled);
+
+    bool addChildren(const FSNode& dir, FSList& fslist,
+                     FSNode::ListMode mode, const FSNode::NameFilter& filter,
+                     const FSNode::CancelCheck& isCancelled);
+
+  private:
+    std::unordered_map<string, Directory> myDirectories;
+
+    ListedCallback myListedCallback;
+
+  private:
+    // Following constructors and assignment operators not supported
+    DirectoryIndex(const DirectoryIndex&) = delete;
+    DirectoryIndex(DirectoryIndex&&) = delete;
+    DirectoryIndex& operator=(const DirectoryIndex&) = delete;
+    DirectoryIndex& operator=(DirectoryIndex&&) = delete;
+};
+
+#endif
@@ -79,13 +79,25 @@ string EventHandlerSDL::pasteText(string& text) const
   return text;
 };
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void EventHandlerSDL::waitEvent(uInt32 timeout)
+{
+  ASSERT_MAIN_THREAD;
+
+  // Leaves the event in the queue for pollEvent()
+  SDL_WaitEventTimeout(nullptr, static_cast<Sint32>(timeout));
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void EventHandlerSDL::pollEvent()
 {
   ASSERT_MAIN_THREAD;
 
+  myReceivedEvents = false;
   while(SDL_PollEvent(&myEvent))
   {
+    myReceivedEvents = true;
+
     switch(myEvent.type)
     {
       // keyboard events
@@ -250,6 +262,21 @@ void EventHandlerSDL::pollEvent()
   }
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void EventHandlerSDL::pollAnalogEvents()
+{
+  ASSERT_MAIN_THREAD;
+
+#ifdef JOYSTICK_SUPPORT
+  SDL_PumpEvents();
+
+  // Take only the axis events out of the queue, in their original order
+  while(SDL_PeepEvents(&myEvent, 1, SDL_GETEVENT, SDL_EVENT_JOYSTICK_AXIS_MOTION,
+                       SDL_EVENT_JOYSTICK_AXIS_MOTION) > 0)
+    handleJoyAxisEvent(myEvent.jaxis.which, myEvent.jaxis.axis, myEvent.jaxis.value);
+#endif
+}
+
 #ifdef JOYSTICK_SUPPORT
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 EventHandlerSDL::JoystickSDL::JoystickSDL(int idx)
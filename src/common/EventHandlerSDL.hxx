@@ -50,6 +50,16 @@ class EventHandlerSDL : public EventHandler
     */
     void pollEvent() override;
 
+    /**
+      Wait for an SDL event to arrive.
+    */
+    void waitEvent(uInt32 timeout) override;
+
+    /**
+      Collects and dispatches any pending SDL joystick axis events.
+    */
+    void pollAnalogEvents() override;
+
   private:
     SDL_Event myEvent{0};
 
@@ -60,6 +60,7 @@ FBBackendSDL::~FBBackendSDL()
 {
   ASSERT_MAIN_THREAD;
 
+  myTexturePool.clearTextures();
   if(myRenderer)
     SDL_DestroyRenderer(myRenderer);
   if(myWindow)
@@ -271,6 +272,7 @@ bool FBBackendSDL::setVideoMode(const VideoModeHandler::Mode& mode,
        std::cmp_not_equal(h, mode.screenS.h) || adaptRefresh)
     {
       // Renderer has to be destroyed *before* the window gets destroyed to avoid memory leaks
+      myTexturePool.clearTextures();
       SDL_DestroyRenderer(myRenderer);
       myRenderer = nullptr;
       SDL_DestroyWindow(myWindow);
@@ -439,6 +441,7 @@ bool FBBackendSDL::createRenderer()
 
   if(recreate)
   {
+    myTexturePool.clearTextures();
     if(myRenderer)
       SDL_DestroyRenderer(myRenderer);
 
@@ -639,7 +642,7 @@ void FBBackendSDL::detectFeatures()
   myRenderTargetSupport = detectRenderTargetSupport();
 
   if(myRenderer && !myRenderTargetSupport)
-    Logger::info("Render targets are not supported --- QIS not available");
+    Logger::info("Render targets are not supported --- QIS done in software");
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
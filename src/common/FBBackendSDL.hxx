@@ -25,6 +25,7 @@ class FBSurfaceSDL;
 
 #include "bspf.hxx"
 #include "FBBackend.hxx"
+#include "sdl_blitter/TexturePool.hxx"
 
 /**
   This class implements a standard SDL 2D, hardware accelerated framebuffer
@@ -57,6 +58,12 @@ class FBBackendSDL : public FBBackend
      */
     const SDL_PixelFormatDetails& pixelFormat() const { return *myPixelFormat; }
 
+    /**
+      Get the pool of textures and surfaces, which survives video mode
+      changes (but not a new renderer for the textures).
+     */
+    TexturePool& texturePool() { return myTexturePool; }
+
     /**
       Does the renderer support render targets?
      */
@@ -300,6 +307,9 @@ class FBBackendSDL : public FBBackend
     SDL_Window* myWindow{nullptr};
     SDL_Renderer* myRenderer{nullptr};
 
+    // Textures and surfaces released by the blitters and surfaces
+    TexturePool myTexturePool;
+
     // Used by mapRGB (when palettes are created)
     const SDL_PixelFormatDetails* myPixelFormat{nullptr};
 
@@ -59,7 +59,7 @@ FBSurfaceSDL::~FBSurfaceSDL()
 
   if(mySurface)
   {
-    SDL_DestroySurface(mySurface);
+    myBackend.texturePool().releaseSurface(mySurface);
     mySurface = nullptr;
   }
 }
@@ -71,6 +71,7 @@ void FBSurfaceSDL::fillRect(uInt32 x, uInt32 y, uInt32 w, uInt32 h, ColorId colo
 
   const SDL_Rect tmp = ToSDLRect(x, y, w, h);
   SDL_FillSurfaceRect(mySurface, &tmp, myPalette[color]);
+  setDirty(x, y, w, h);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -164,17 +165,47 @@ bool FBSurfaceSDL::render()
   assert(myBlitter);
 
   if(myIsVisible)
-    myBlitter->blit(*mySurface);
+  {
+    uInt32 x = 0, y = 0, w = 0, h = 0;
+    dirtyRect(x, y, w, h);
+
+    // Clip against the surface, which is all of it if fully dirty
+    const auto sw = static_cast<uInt32>(mySurface->w),
+               sh = static_cast<uInt32>(mySurface->h);
+    const SDL_Rect dirty = x < sw && y < sh
+      ? ToSDLRect(x, y, std::min(w, sw - x), std::min(h, sh - y))
+      : SDL_Rect{0, 0, 0, 0};
+
+    myBlitter->blit(*mySurface, dirty);
+    setClean();
+  }
 
   return myIsVisible;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool FBSurfaceSDL::lockPixels(uInt32*& pixels, uInt32& pitch)
+{
+  assert(myBlitter);
+
+  return myIsVisible && !myIsStatic && myBlitter->lock(pixels, pitch);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void FBSurfaceSDL::unlockPixels()
+{
+  assert(myBlitter);
+
+  myBlitter->unlock();
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void FBSurfaceSDL::invalidate()
 {
   ASSERT_MAIN_THREAD;
 
   SDL_FillSurfaceRect(mySurface, nullptr, 0);
+  setDirty();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -186,6 +217,7 @@ void FBSurfaceSDL::invalidateRect(uInt32 x, uInt32 y, uInt32 w, uInt32 h)
   //       without affecting the background display.
   const SDL_Rect tmp = ToSDLRect(x, y, w, h);
   SDL_FillSurfaceRect(mySurface, &tmp, 0);
+  setDirty(x, y, w, h);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -200,7 +232,7 @@ void FBSurfaceSDL::resize(uInt32 width, uInt32 height)
   ASSERT_MAIN_THREAD;
 
   if(mySurface)
-    SDL_DestroySurface(mySurface);
+    myBackend.texturePool().releaseSurface(mySurface);
 
   // NOTE: Currently, a resize changes a 'static' surface to 'streaming'
   //       No code currently does this, but we should at least check for it
@@ -220,7 +252,7 @@ void FBSurfaceSDL::createSurface(uInt32 width, uInt32 height, const uInt32* data
 
   // Create a surface in the same format as the parent GL class
   const SDL_PixelFormatDetails& pf = myBackend.pixelFormat();
-  mySurface = SDL_CreateSurface(width, height, pf.format);
+  mySurface = myBackend.texturePool().acquireSurface(pf.format, width, height);
   if(!mySurface)
     throw std::runtime_error(SDL_GetError());
 
@@ -237,6 +269,7 @@ void FBSurfaceSDL::createSurface(uInt32 width, uInt32 height, const uInt32* data
   assert(mySurface->pitch % pf.bytes_per_pixel == 0);
   myPitch = mySurface->pitch / pf.bytes_per_pixel;
   ////////////////////////////////////////////////////
+  setDirty();
 
   myIsStatic = data != nullptr;
   if(myIsStatic)
@@ -57,6 +57,8 @@ class FBSurfaceSDL : public FBSurface
 
     void translateCoords(Int32& x, Int32& y) const override;
     bool render() override;
+    bool lockPixels(uInt32*& pixels, uInt32& pitch) override;
+    void unlockPixels() override;
     void invalidate() override;
     void invalidateRect(uInt32 x, uInt32 y, uInt32 w, uInt32 h) override;
 
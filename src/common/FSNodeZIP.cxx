@@ -52,10 +52,19 @@ FSNodeZIP::FSNodeZIP(string_view p)
 
 // cerr << " => p: " << p << '\n';
 
+  // Create a concrete FSNode to use
+  // This *must not* be a ZIP file; it must be a real FSNode object that
+  // has direct access to the actual filesystem (aka, a 'System' node)
+  // Behind the scenes, this node is actually a platform-specific object
+  // for whatever system we are running on
+  _realNode = FSNodeFactory::create(_zipFile,
+      FSNodeFactory::Type::SYSTEM);
+
   // Open file at least once to initialize the virtual file count
+  ZipHandler zip;
   try
   {
-    zipHandler()->open(_zipFile);
+    zip.open(_zipFile, getLastModified());
   }
   catch(const std::runtime_error&)
   {
@@ -63,7 +72,7 @@ FSNodeZIP::FSNodeZIP(string_view p)
     //       For now, we just indicate that no ROMs were found
     _error = zip_error::NO_ROMS;
   }
-  _numFiles = zipHandler()->romFiles();
+  _numFiles = zip.romFiles();
   if(_numFiles == 0)
   {
     _error = zip_error::NO_ROMS;
@@ -80,9 +89,9 @@ FSNodeZIP::FSNodeZIP(string_view p)
   else if(_numFiles == 1)
   {
     bool found = false;
-    while(zipHandler()->hasNext() && !found)
+    while(zip.hasNext() && !found)
     {
-      const auto& [name, size] = zipHandler()->next();
+      const auto& [name, size] = zip.next();
       if(Bankswitch::isValidRomName(name))
       {
         _virtualPath = name;
@@ -98,14 +107,6 @@ FSNodeZIP::FSNodeZIP(string_view p)
   else if(_numFiles > 1)
     _isDirectory = true;
 
-  // Create a concrete FSNode to use
-  // This *must not* be a ZIP file; it must be a real FSNode object that
-  // has direct access to the actual filesystem (aka, a 'System' node)
-  // Behind the scenes, this node is actually a platform-specific object
-  // for whatever system we are running on
-  _realNode = FSNodeFactory::create(_zipFile,
-      FSNodeFactory::Type::SYSTEM);
-
   setFlags(_zipFile, _virtualPath, _realNode);
 // cerr << "==============================================================\n";
 // cerr << _name << ", file: " << _isFile << ", dir: " << _isDirectory << "\n\n";
@@ -155,10 +156,11 @@ bool FSNodeZIP::exists() const
     // We need to inspect the actual path, not just the ZIP file itself
     try
     {
-      zipHandler()->open(_zipFile);
-      while(zipHandler()->hasNext())
+      ZipHandler zip;
+      zip.open(_zipFile, getLastModified());
+      while(zip.hasNext())
       {
-        const auto& [name, size] = zipHandler()->next();
+        const auto& [name, size] = zip.next();
         if(BSPF::startsWithIgnoreCase(name, _virtualPath))
           return true;
       }
@@ -181,12 +183,13 @@ bool FSNodeZIP::getChildren(AbstractFSList& myList, ListMode mode) const
     return false;
 
   std::set<string> dirs;
-  zipHandler()->open(_zipFile);
-  while(zipHandler()->hasNext())
+  ZipHandler zip;
+  zip.open(_zipFile, getLastModified());
+  while(zip.hasNext())
   {
     // Only consider entries that start with '_virtualPath'
     // Ignore empty filenames and '__MACOSX' virtual directories
-    const auto& [name, size] = zipHandler()->next();
+    const auto& [name, size] = zip.next();
     if(BSPF::startsWithIgnoreCase(name, "__MACOSX") || name == EmptyString())
       continue;
     if(BSPF::startsWithIgnoreCase(name, _virtualPath))
@@ -214,7 +217,49 @@ bool FSNodeZIP::getChildren(AbstractFSList& myList, ListMode mode) const
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-size_t FSNodeZIP::read(ByteBuffer& buffer, size_t) const
+size_t FSNodeZIP::read(ByteBuffer& buffer, size_t size) const
+{
+  return read(buffer, size, nullptr);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+size_t FSNodeZIP::read(ByteBuffer& buffer, size_t size, string& md5) const
+{
+  return read(buffer, size, &md5);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+size_t FSNodeZIP::read(ByteBuffer& buffer, size_t size, string* md5) const
+{
+  // Every read uses its own handler (and stream), so several files can be
+  // decompressed in parallel; the central directory is only read once
+  ZipHandler zip;
+  if(!open(zip))
+    return 0;
+
+  // Only inflate as much as was asked for
+  if(size > 0 && size < _size)
+  {
+    buffer = std::make_unique<uInt8[]>(size);
+    zip.openStream()->read(0, std::span<uInt8>(buffer.get(), size));
+    return size;
+  }
+  // Hash the whole file while inflating it, if asked to
+  return md5 ? zip.decompress(buffer, *md5) : zip.decompress(buffer);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+unique_ptr<ZipHandler::SeekableStream> FSNodeZIP::openStream() const
+{
+  ZipHandler zip;
+  if(!open(zip))
+    throw std::runtime_error("ZIP file contains errors/not found");
+
+  return zip.openStream();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool FSNodeZIP::open(ZipHandler& zip) const
 {
   switch(_error)
   {
@@ -226,16 +271,14 @@ size_t FSNodeZIP::read(ByteBuffer& buffer, size_t) const
     default: throw std::runtime_error("FSNodeZIP::read default case hit");
   }
 
-  zipHandler()->open(_zipFile);
-
-  bool found = false;
-  while(zipHandler()->hasNext() && !found)
+  zip.open(_zipFile, getLastModified());
+  while(zip.hasNext())
   {
-    const auto& [name, size] = zipHandler()->next();
-    found = name == _virtualPath;
+    const auto& [name, size] = zip.next();
+    if(name == _virtualPath)
+      return true;
   }
-
-  return found ? zipHandler()->decompress(buffer) : 0;
+  return false;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
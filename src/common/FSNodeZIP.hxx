@@ -60,10 +60,15 @@ class FSNodeZIP : public AbstractFSNode
     //////////////////////////////////////////////////////////
 
     size_t getSize() const override { return _size; }
+    // Files within ZIP archives share the modification time of the archive
+    uInt64 getLastModified() const override {
+      return _realNode ? _realNode->getLastModified() : 0;
+    }
     bool getChildren(AbstractFSList& list, ListMode mode) const override;
     AbstractFSNodePtr getParent() const override;
 
     size_t read(ByteBuffer& buffer, size_t) const override;
+    size_t read(ByteBuffer& buffer, size_t, string& md5) const override;
     size_t read(std::stringstream& buffer) const override;
     size_t write(const ByteBuffer&, size_t) const override {
       throw std::runtime_error("ZIP file writing not implemented");
@@ -72,6 +77,12 @@ class FSNodeZIP : public AbstractFSNode
       throw std::runtime_error("ZIP file writing not implemented");
     }
 
+    /**
+     * Open the file for random access, without decompressing it up front
+     * (e.g. for MovieCart streams).  This method can throw exceptions.
+     */
+    unique_ptr<ZipHandler::SeekableStream> openStream() const;
+
   private:
     FSNodeZIP(const string& zipfile, const string& virtualpath,
         const AbstractFSNodePtr& realnode, size_t size, bool isdir);
@@ -79,6 +90,12 @@ class FSNodeZIP : public AbstractFSNode
     void setFlags(const string& zipfile, const string& virtualpath,
         const AbstractFSNodePtr& realnode);
 
+    // Open the ZIP file in the handler, and select this file
+    bool open(ZipHandler& zip) const;
+
+    // Read the file, and compute its MD5 while inflating if 'md5' is given
+    size_t read(ByteBuffer& buffer, size_t size, string* md5) const;
+
     friend std::ostream& operator<<(std::ostream& os, const FSNodeZIP& node)
     {
       os << "_zipFile:     " << node._zipFile << '\n'
@@ -111,12 +128,6 @@ class FSNodeZIP : public AbstractFSNode
     size_t _size{0};
 
     bool _isDirectory{false}, _isFile{false};
-
-    // ZipHandler static reference variable responsible for accessing ZIP files
-    static unique_ptr<ZipHandler>& zipHandler() {
-      static unique_ptr<ZipHandler> z = std::make_unique<ZipHandler>();
-      return z;
-    }
 };
 
 #endif
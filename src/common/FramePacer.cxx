@@ -0,0 +1,71 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2026 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#include <cmath>
+
+#include "FramePacer.hxx"
+
+using namespace std::chrono;
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void FramePacer::reset(int refreshRate)
+{
+  myPeriod = refreshRate > 0 ? 1. / refreshRate : 0.;
+  myHasVBlank = false;
+  myWork = 0.;
+  myMargin = MIN_MARGIN;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void FramePacer::presented(Clock::time_point presentStart,
+                           Clock::time_point presentEnd)
+{
+  if(myPeriod == 0.)
+    return;
+
+  const double work = duration<double>(presentStart - myFrameStart).count();
+  const double wait = duration<double>(presentEnd - presentStart).count();
+
+  // React to slower frames immediately, to faster ones only gradually
+  myWork = work > myWork ? work : myWork + (work - myWork) * 0.05;
+
+  // Waiting for most of a period means the intended vblank was missed
+  if(myHasVBlank && wait > myPeriod / 2)
+    myMargin = std::min(myMargin * 2, myPeriod / 4);
+  else
+    myMargin = std::max(myMargin * 0.99, MIN_MARGIN);
+
+  myLastVBlank = presentEnd;
+  myHasVBlank = true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+FramePacer::Clock::time_point FramePacer::nextStart(Clock::time_point due) const
+{
+  if(myPeriod == 0. || !myHasVBlank)
+    return due;
+
+  // Choose the first vblank the frame isn't more than half a period early
+  // for; this keeps the average frame rate at the emulated one, even if it
+  // differs from the refresh rate
+  const double lead = myWork + myMargin;
+  const double dueOffset = duration<double>(due - myLastVBlank).count() + lead;
+  const double vblanks = std::max(1., std::ceil(dueOffset / myPeriod - 0.5));
+
+  return myLastVBlank + duration_cast<Clock::duration>(
+    duration<double>(vblanks * myPeriod - lead));
+}
@@ -0,0 +1,100 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2026 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#ifndef FRAME_PACER_HXX
+#define FRAME_PACER_HXX
+
+#include <chrono>
+
+#include "bspf.hxx"
+
+/**
+  Schedules the start of each frame when late-latching: the next frame is
+  emulated and rendered just in time before the vblank it is presented at,
+  instead of directly after the previous present.  This way the input
+  polled at the start of the frame is shown about one frame earlier.
+
+  The time needed for emulating and rendering a frame is measured, and a
+  safety margin is added which grows whenever a vblank was missed.  This
+  works only when presenting blocks until the vblank (i.e. with vsync);
+  otherwise frames are started as they are due.
+
+  @author  Stella Team
+*/
+class FramePacer
+{
+  public:
+    using Clock = std::chrono::high_resolution_clock;
+
+    FramePacer() = default;
+    ~FramePacer() = default;
+
+    /**
+      Start pacing anew, e.g. when emulation is (re)entered.
+
+      @param refreshRate  The display refresh rate in Hz, 0 if not syncing
+                          to the display
+    */
+    void reset(int refreshRate);
+
+    /**
+      Record that a frame is started, before polling the input.
+    */
+    void frameStarted() { myFrameStart = Clock::now(); }
+
+    /**
+      Record the timing of the frame just presented.
+
+      @param presentStart  When presenting started
+      @param presentEnd    When presenting returned (i.e. after the vblank)
+    */
+    void presented(Clock::time_point presentStart, Clock::time_point presentEnd);
+
+    /**
+      Get the time to start the next frame at.
+
+      @param due  When the next frame is due according to emulation time
+
+      @return  The start time, so that the frame is ready just before the
+               first vblank not (much) earlier than it is due
+    */
+    Clock::time_point nextStart(Clock::time_point due) const;
+
+  private:
+    // The display refresh period, zero when not syncing to the display
+    double myPeriod{0.};
+
+    Clock::time_point myFrameStart;
+    Clock::time_point myLastVBlank;
+    bool myHasVBlank{false};
+
+    // The (smoothed) time needed from the start of a frame until presenting
+    double myWork{0.};
+    // The safety margin before the vblank
+    double myMargin{MIN_MARGIN};
+
+    static constexpr double MIN_MARGIN = 0.001;  // 1 ms
+
+  private:
+    // Following constructors and assignment operators not supported
+    FramePacer(const FramePacer&) = delete;
+    FramePacer(FramePacer&&) = delete;
+    FramePacer& operator=(const FramePacer&) = delete;
+    FramePacer& operator=(FramePacer&&) = delete;
+};
+
+#endif // FRAME_PACER_HXX
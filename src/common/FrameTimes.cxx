@@ -0,0 +1,141 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2026 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+
+#include <cmath>
+
+#include "FrameTimes.hxx"
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void FrameTimes::reset()
+{
+  myCount = 0;
+  myCurrent.fill(0.F);
+  myLastEnd = Clock::time_point{};
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void FrameTimes::endFrame()
+{
+  const Clock::time_point now = Clock::now();
+
+  // The first frame after a reset has no interval yet
+  if(myLastEnd != Clock::time_point{})
+  {
+    add(Phase::Interval, now - myLastEnd);
+
+    const size_t index = myCount & (HISTORY - 1);
+    for(size_t phase = 0; phase < NUM_PHASES; ++phase)
+      myTimes[phase][index] = myCurrent[phase];
+    ++myCount;
+  }
+  myLastEnd = now;
+  myCurrent.fill(0.F);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+vector<float> FrameTimes::sorted(Phase phase) const
+{
+  const auto& times = myTimes[static_cast<size_t>(phase)];
+  vector<float> result(times.begin(), times.begin() + frames());
+
+  std::ranges::sort(result);
+  return result;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+float FrameTimes::percentile(Phase phase, double percent) const
+{
+  const vector<float> times = sorted(phase);
+  if(times.empty())
+    return 0.F;
+
+  // Nearest rank
+  const auto rank = static_cast<size_t>(
+    std::ceil(std::clamp(percent, 0., 100.) / 100. * times.size()));
+  return times[std::max<size_t>(rank, 1) - 1];
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+float FrameTimes::mean(Phase phase, size_t lastFrames) const
+{
+  const auto& times = myTimes[static_cast<size_t>(phase)];
+  const size_t n = std::min(lastFrames, frames());
+  if(n == 0)
+    return 0.F;
+
+  double sum = 0.;
+  for(size_t i = myCount - n; i < myCount; ++i)
+    sum += times[i & (HISTORY - 1)];
+  return static_cast<float>(sum / n);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+FrameTimes::Histogram FrameTimes::histogram(Phase phase, float maxMs) const
+{
+  Histogram bins{};
+  const auto& times = myTimes[static_cast<size_t>(phase)];
+
+  if(maxMs <= 0.F)
+    return bins;
+
+  for(size_t i = 0; i < frames(); ++i)
+  {
+    const auto bin = static_cast<size_t>(times[i] / maxMs * BINS);
+    ++bins[std::min(bin, BINS - 1)];
+  }
+  return bins;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+string FrameTimes::summary() const
+{
+  if(frames() == 0)
+    return "Frame -";
+
+  return std::format("Frame p50 {:.2f} p95 {:.2f} p99 {:.2f}ms",
+                     percentile(Phase::Interval, 50),
+                     percentile(Phase::Interval, 95),
+                     percentile(Phase::Interval, 99));
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+string FrameTimes::report() const
+{
+  std::ostringstream buf;
+
+  buf << std::format("Frame times of the last {} frames (ms)\n", frames());
+  buf << std::format("{:<10} {:>8} {:>8} {:>8} {:>8}",
+                     "", "p50", "p95", "p99", "max");
+  for(size_t phase = 0; phase < NUM_PHASES; ++phase)
+  {
+    const auto p = static_cast<Phase>(phase);
+    buf << std::format("\n{:<10} {:>8.2f} {:>8.2f} {:>8.2f} {:>8.2f}",
+                       name(p), percentile(p, 50), percentile(p, 95),
+                       percentile(p, 99), percentile(p, 100));
+  }
+  return buf.str();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+string_view FrameTimes::name(Phase phase)
+{
+  static constexpr std::array<string_view, NUM_PHASES> names = {
+    "emulation", "render", "present", "interval"
+  };
+  return names[static_cast<size_t>(phase)];
+}
@@ -0,0 +1,145 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2026 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+
+#ifndef FRAME_TIMES_HXX
+#define FRAME_TIMES_HXX
+
+#include <chrono>
+
+#include "bspf.hxx"
+
+/**
+  Records how long each displayed frame took, split into emulation,
+  rendering and presenting, plus the interval between two presented frames
+  on the host.  The last frames are kept in a fixed ring, from which
+  percentiles and histograms are computed; unlike the average of the
+  FpsMeter, these show the occasional stutter.
+
+  The times are shown in the frame stats overlay, logged after a benchmark
+  and can be queried from the debugger prompt ('frametimes').
+
+  @author  Stella Team
+*/
+class FrameTimes
+{
+  public:
+    enum class Phase: uInt8 {
+      Emulation,  // main thread time emulating or waiting for the emulation
+      Render,     // drawing the TIA image, overlays and messages
+      Present,    // pushing the frame to the screen (blocks with vsync)
+      Interval,   // time between two presented frames
+      NumPhases
+    };
+    static constexpr size_t NUM_PHASES = static_cast<size_t>(Phase::NumPhases);
+
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr size_t HISTORY = 512;  // must be a power of two
+    static constexpr size_t BINS = 32;
+    using Histogram = std::array<uInt32, BINS>;
+
+  public:
+    FrameTimes() = default;
+    ~FrameTimes() = default;
+
+    /**
+      Forget all recorded frames.
+    */
+    void reset();
+
+    /**
+      Add time spent in the given phase to the current frame.
+    */
+    template<typename Rep, typename Period>
+    void add(Phase phase, std::chrono::duration<Rep, Period> time) {
+      myCurrent[static_cast<size_t>(phase)] +=
+        std::chrono::duration<float, std::milli>(time).count();
+    }
+
+    /**
+      Finish the current frame (when it has been presented), and start
+      recording the next one.
+    */
+    void endFrame();
+
+    /**
+      The number of frames available for the statistics.
+    */
+    size_t frames() const { return std::min(myCount, HISTORY); }
+
+    /**
+      The number of frames recorded since the last reset.
+    */
+    size_t count() const { return myCount; }
+
+    /**
+      The given percentile of a phase over the recorded frames.
+
+      @param phase    The phase
+      @param percent  The percentile (0 - 100)
+      @return  The time in milliseconds
+    */
+    float percentile(Phase phase, double percent) const;
+
+    /**
+      The mean time of a phase over the most recent frames.
+
+      @param phase       The phase
+      @param lastFrames  The number of frames to use (at most HISTORY)
+      @return  The time in milliseconds
+    */
+    float mean(Phase phase, size_t lastFrames = HISTORY) const;
+
+    /**
+      Count the recorded frames of a phase in BINS equal bins from zero to
+      the given time.  Longer frames are counted in the last bin.
+    */
+    Histogram histogram(Phase phase, float maxMs) const;
+
+    /**
+      A short summary of the host frame interval (for the stats overlay).
+    */
+    string summary() const;
+
+    /**
+      A table of all phases' percentiles (for logs and the debugger).
+    */
+    string report() const;
+
+    static string_view name(Phase phase);
+
+  private:
+    vector<float> sorted(Phase phase) const;
+
+  private:
+    // Times per frame in milliseconds, one ring per phase
+    std::array<std::array<float, HISTORY>, NUM_PHASES> myTimes{};
+    size_t myCount{0};
+
+    std::array<float, NUM_PHASES> myCurrent{};
+    Clock::time_point myLastEnd;
+
+  private:
+    // Following constructors and assignment operators not supported
+    FrameTimes(const FrameTimes&) = delete;
+    FrameTimes(FrameTimes&&) = delete;
+    FrameTimes& operator=(const FrameTimes&) = delete;
+    FrameTimes& operator=(FrameTimes&&) = delete;
+};
+
+#endif // FRAME_TIMES_HXX
@@ -50,6 +50,7 @@
 #include "Launcher.hxx"
 #include "Base.hxx"
 #include "MD5.hxx"
+#include "ScoreTracker.hxx"
 
 #include "HighScoresManager.hxx"
 
@@ -64,6 +65,9 @@ HighScoresManager::HighScoresManager(OSystem& osystem)
 {
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+HighScoresManager::~HighScoresManager() = default;
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void HighScoresManager::setRepository(
     shared_ptr<CompositeKeyValueRepositoryAtomic> repo)
@@ -84,6 +88,52 @@ Int16 HighScoresManager::peek(uInt16 addr) const
   return NO_VALUE;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void HighScoresManager::trackScores(const ScoreCallback& onScore,
+                                    const ScoreCallback& onVariation)
+{
+  myScoreCallback = onScore;
+  myVariationCallback = onVariation;
+
+  stopTracking();
+  if(myOSystem.hasConsole())
+    startTracking();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void HighScoresManager::startTracking()
+{
+  uInt32 numVariations = 0;
+  ScoresProps info;
+
+  // Nothing to watch if nobody listens
+  if((!myScoreCallback && !myVariationCallback) ||
+     !scoresProps(myOSystem.console().properties(), numVariations, info))
+    return;
+
+  myTracker = make_unique<ScoreTracker>(info, numVariations);
+  myTracker->onScoreChanged(myScoreCallback);
+  myTracker->onVariationChanged(myVariationCallback);
+  myTracker->attach(myOSystem.console().riot(),
+                    [this](uInt16 addr) { return peek(addr); });
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void HighScoresManager::stopTracking()
+{
+  // The RIOT is kept for the next console, which must not be watched
+  if(myTracker)
+    myTracker->detach();
+  myTracker.reset();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void HighScoresManager::update()
+{
+  if(myTracker)
+    myTracker->update();
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 json HighScoresManager::properties(const Properties& props)
 {
@@ -130,6 +180,15 @@ uInt32 HighScoresManager::numVariations(const json& jprops)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool HighScoresManager::get(const Properties& props, uInt32& numVariationsR,
                             ScoresProps& info) const
+{
+  scoresProps(props, numVariationsR, info);
+
+  return enabled();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool HighScoresManager::scoresProps(const Properties& props,
+                                    uInt32& numVariationsR, ScoresProps& info)
 {
   const json jprops = properties(props);
 
@@ -151,7 +210,7 @@ bool HighScoresManager::get(const Properties& props, uInt32& numVariationsR,
 
   info.scoreAddr = getPropScoreAddr(jprops);
 
-  return enabled();
+  return jprops.contains(SCORE_ADDRESSES);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -332,6 +391,15 @@ Int32 HighScoresManager::score(uInt32 numAddrBytes, uInt32 trailingZeroes,
   if (!myOSystem.hasConsole())
     return NO_VALUE;
 
+  return score(numAddrBytes, trailingZeroes, isBCD, scoreAddr,
+               [this](uInt16 addr) { return peek(addr); });
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+Int32 HighScoresManager::score(uInt32 numAddrBytes, uInt32 trailingZeroes,
+                               bool isBCD, const ScoreAddresses& scoreAddr,
+                               const PeekFunc& peek)
+{
   Int32 totalScore = 0;
 
   for (uInt32 b = 0; b < numAddrBytes; ++b)
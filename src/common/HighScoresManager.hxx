@@ -19,6 +19,9 @@
 #define HIGHSCORES_MANAGER_HXX
 
 class OSystem;
+class ScoreTracker;
+
+#include <functional>
 
 #include "Props.hxx"
 #include "json_lib.hxx"
@@ -97,7 +100,7 @@ class HighScoresManager
 
   public:
     explicit HighScoresManager(OSystem& osystem);
-    virtual ~HighScoresManager() = default;
+    virtual ~HighScoresManager();
 
     void setRepository(shared_ptr<CompositeKeyValueRepositoryAtomic> repo);
 
@@ -111,6 +114,14 @@ class HighScoresManager
     */
     bool get(const Properties& props, uInt32& numVariations,
              HSM::ScoresProps& info) const;
+    /**
+      Get the highscore data of the given properties, without requiring an
+      OSystem (e.g. for headless consoles)
+
+      @return True if the properties define score addresses, else false
+    */
+    static bool scoresProps(const Properties& props, uInt32& numVariations,
+                            HSM::ScoresProps& info);
     /**
       Set the highscore data of game's properties
     */
@@ -125,6 +136,16 @@ class HighScoresManager
     Int32 score(uInt32 numAddrBytes, uInt32 trailingZeroes, bool isBCD,
                 const HSM::ScoreAddresses& scoreAddr) const;
 
+    /**
+      Calculate the score from given parameters, reading the memory of any
+      console through 'peek'
+
+      @return The current score or -1 if no valid data exists
+    */
+    using PeekFunc = std::function<Int16(uInt16 addr)>;
+    static Int32 score(uInt32 numAddrBytes, uInt32 trailingZeroes, bool isBCD,
+                       const HSM::ScoreAddresses& scoreAddr, const PeekFunc& peek);
+
     // Convert the given value, using only the maximum bits required by maxVal
     //  and adjusted for BCD and zero based data
     static Int32 convert(Int32 val, uInt32 maxVal, bool isBCD, bool zeroBased);
@@ -154,6 +175,22 @@ class HighScoresManager
     // Peek into memory
     Int16 peek(uInt16 addr) const;
 
+    /**
+      Follow the score and variation of the running consoles, instead of
+      polling score() and variation().  The callbacks are called with the
+      new and the previous value from update(), once per change (see
+      ScoreTracker).
+    */
+    using ScoreCallback = std::function<void(Int32 value, Int32 previous)>;
+    void trackScores(const ScoreCallback& onScore,
+                     const ScoreCallback& onVariation = nullptr);
+
+    // Called by OSystem when a console is started resp. closed, and after
+    // each emulated frame
+    void startTracking();
+    void stopTracking();
+    void update();
+
     void loadHighScores(HSM::ScoresData& data);
     void saveHighScores(HSM::ScoresData& data) const;
 
@@ -257,6 +294,10 @@ class HighScoresManager
     shared_ptr<CompositeKeyValueRepositoryAtomic> myHighscoreRepository
       = std::make_shared<CompositeKeyValueRepositoryNoop>();
 
+    // Score tracking of the running console, if requested
+    ScoreCallback myScoreCallback, myVariationCallback;
+    unique_ptr<ScoreTracker> myTracker;
+
   private:
     // Following constructors and assignment operators not supported
     HighScoresManager() = delete;
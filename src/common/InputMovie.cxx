@@ -0,0 +1,299 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2026 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#include "InputMovie.hxx"
+
+/*
+  File layout (after the header, ROM MD5 and controller names):
+
+    'K' <cycles> <size> <state>                    keyframe
+    'U' <cycles> <count> { <event> <value> }*      changed event values
+    'E'                                            end of movie
+
+  The movie always starts with a keyframe.  A keyframe is written before
+  the update of the same poll.
+*/
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+InputMovie::~InputMovie()
+{
+  stop();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool InputMovie::startRecording(string_view filename, const Info& info,
+                                const SaveFunc& save)
+{
+  stop();
+
+  myFile = std::make_unique<Serializer>(filename,
+                                        Serializer::FileMode::ReadWriteTrunc);
+  if(!*myFile)
+  {
+    myFile.reset();
+    return false;
+  }
+
+  try
+  {
+    myFile->putString(MOVIE_HEADER);
+    myFile->putString(info.md5);
+    myFile->putString(info.left);
+    myFile->putString(info.right);
+  }
+  catch(...)
+  {
+    myFile.reset();
+    return false;
+  }
+
+  myValues.fill(Event::NoType);
+  myPolls = myKeyframes = 0;
+  myRecording = writeKeyframe(0, save);
+  if(!myRecording)
+    myFile.reset();
+
+  return myRecording;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool InputMovie::record(uInt64 cycles, const Event& event, const SaveFunc& save)
+{
+  if(!myRecording)
+    return false;
+
+  if(++myPolls % KEYFRAME_INTERVAL == 0 && !writeKeyframe(cycles, save))
+  {
+    stop();
+    return false;
+  }
+
+  vector<std::pair<uInt16, Int32>> changes;
+  for(uInt32 type = 0; type < Event::LastType; ++type)
+  {
+    const Int32 value = event.get(static_cast<Event::Type>(type));
+    if(value != myValues[type])
+    {
+      changes.emplace_back(type, value);
+      myValues[type] = value;
+    }
+  }
+  if(changes.empty())
+    return true;
+
+  try
+  {
+    myFile->putByte(static_cast<uInt8>(Record::Update));
+    myFile->putLong(cycles);
+    myFile->putShort(static_cast<uInt16>(changes.size()));
+    for(const auto& [type, value]: changes)
+    {
+      myFile->putShort(type);
+      myFile->putInt(static_cast<uInt32>(value));
+    }
+  }
+  catch(...)
+  {
+    stop();
+    return false;
+  }
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool InputMovie::startPlayback(string_view filename, const Info& info,
+                               const LoadFunc& load, uInt32 keyframe)
+{
+  stop();
+
+  myFile = std::make_unique<Serializer>(filename, Serializer::FileMode::ReadOnly);
+  if(!*myFile)
+  {
+    myFile.reset();
+    return false;
+  }
+
+  try
+  {
+    if(myFile->getString() != MOVIE_HEADER || myFile->getString() != info.md5 ||
+       myFile->getString() != info.left || myFile->getString() != info.right)
+    {
+      myFile.reset();
+      return false;
+    }
+  }
+  catch(...)
+  {
+    myFile.reset();
+    return false;
+  }
+
+  // Skip to the requested keyframe; the event values are accumulated on
+  // the way, since updates only contain the changes
+  myValues.fill(Event::NoType);
+  myKeyframes = 0;
+  for(;;)
+  {
+    if(!readRecord() || myNext.type == Record::End)
+    {
+      myFile.reset();
+      return false;
+    }
+    if(myNext.type == Record::Keyframe && myKeyframes++ == keyframe)
+      break;
+    if(myNext.type == Record::Update)
+      for(const auto& [type, value]: myNext.changes)
+        myValues[type] = value;
+  }
+
+  Serializer state(std::span<const std::byte>(
+    reinterpret_cast<const std::byte*>(myNext.state.data()), myNext.state.size()));
+  if(!load(state) || !readRecord())
+  {
+    myFile.reset();
+    return false;
+  }
+
+  myPlaying = true;
+
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool InputMovie::play(uInt64 cycles, Event& event, const SaveFunc& save)
+{
+  bool synced = true;
+
+  while(myPlaying && myNext.type != Record::End && cycles >= myNext.cycles)
+  {
+    if(myNext.type == Record::Keyframe)
+    {
+      ++myKeyframes;
+
+      ByteArray state;
+      synced = saveToArray(save, state) && state == myNext.state && synced;
+    }
+    else
+      for(const auto& [type, value]: myNext.changes)
+        myValues[type] = value;
+
+    if(!readRecord())
+      myNext.type = Record::End;
+  }
+
+  for(uInt32 type = 0; type < Event::LastType; ++type)
+    event.set(static_cast<Event::Type>(type), myValues[type]);
+
+  if(myNext.type == Record::End)
+    stop();
+
+  return synced;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void InputMovie::stop()
+{
+  if(myRecording)
+  {
+    try
+    {
+      myFile->putByte(static_cast<uInt8>(Record::End));
+    }
+    catch(...) { }
+  }
+  myFile.reset();
+  myRecording = myPlaying = false;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool InputMovie::writeKeyframe(uInt64 cycles, const SaveFunc& save)
+{
+  ByteArray state;
+  if(!saveToArray(save, state))
+    return false;
+
+  try
+  {
+    myFile->putByte(static_cast<uInt8>(Record::Keyframe));
+    myFile->putLong(cycles);
+    myFile->putInt(static_cast<uInt32>(state.size()));
+    myFile->putByteArray(state);
+  }
+  catch(...)
+  {
+    return false;
+  }
+  ++myKeyframes;
+
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool InputMovie::readRecord()
+{
+  try
+  {
+    myNext.type = static_cast<Record>(myFile->getByte());
+    switch(myNext.type)
+    {
+      case Record::Keyframe:
+        myNext.cycles = myFile->getLong();
+        myNext.state.resize(myFile->getInt());
+        myFile->getByteArray(myNext.state);
+        return true;
+
+      case Record::Update:
+      {
+        myNext.cycles = myFile->getLong();
+        myNext.changes.resize(myFile->getShort());
+        for(auto& [type, value]: myNext.changes)
+        {
+          type = myFile->getShort();
+          value = static_cast<Int32>(myFile->getInt());
+          if(type >= Event::LastType)
+            return false;
+        }
+        return true;
+      }
+
+      case Record::End:
+        return true;
+
+      default:
+        break;
+    }
+  }
+  catch(...)
+  {
+    // A movie which was not stopped properly ends without an end record
+  }
+  return false;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool InputMovie::saveToArray(const SaveFunc& save, ByteArray& state)
+{
+  Serializer out;
+  if(!save(out))
+    return false;
+
+  state.resize(out.size());
+  out.rewind();
+  out.getByteArray(state);
+
+  return true;
+}
@@ -0,0 +1,170 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2026 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#ifndef INPUT_MOVIE_HXX
+#define INPUT_MOVIE_HXX
+
+#include <functional>
+
+#include "bspf.hxx"
+#include "Event.hxx"
+#include "Serializer.hxx"
+
+/**
+  Records and plays back input movies.  Instead of full states, a movie
+  stores the state once at its start, followed by the changes of the event
+  values (controllers, console switches) each time the input is polled,
+  together with the CPU cycle at which this happened.  Since the emulation
+  is deterministic, replaying the input at exactly the same cycles
+  reproduces the recording.
+
+  Every KEYFRAME_INTERVAL polls a complete state (keyframe) is stored too.
+  Playback can start at any keyframe, and compares the emulated state with
+  each keyframe it passes, which detects desynchronization.
+
+  The class only deals with the file and the event values; the caller
+  provides the functions to save and load the emulation state, and is
+  responsible for stopping emulation at the cycles of each update.
+
+  @author  Stella Team
+*/
+class InputMovie
+{
+  public:
+    static constexpr string_view MOVIE_HEADER = "03030000movie";
+    // polls between two keyframes (about 10 seconds)
+    static constexpr uInt32 KEYFRAME_INTERVAL = 600;
+
+    // The ROM and controllers a movie was recorded with
+    struct Info {
+      string md5;
+      string left;
+      string right;
+    };
+
+    using SaveFunc = std::function<bool(Serializer&)>;
+    using LoadFunc = std::function<bool(Serializer&)>;
+
+    InputMovie() = default;
+    ~InputMovie();
+
+  public:
+    /**
+      Start recording a new movie, beginning with the current state.
+
+      @param filename  The file to record to (overwritten)
+      @param info      The ROM and controllers used
+      @param save      Saves the current state
+
+      @return  False if the file or the state could not be written
+    */
+    bool startRecording(string_view filename, const Info& info,
+                        const SaveFunc& save);
+
+    /**
+      Record the event values at the given cycles.  This must be called
+      each time the input is polled, before it is passed to the controllers.
+
+      @return  False if writing failed, which also stops the recording
+    */
+    bool record(uInt64 cycles, const Event& event, const SaveFunc& save);
+
+    /**
+      Start playing back a movie, loading the state of the given keyframe
+      (0 is the start of the movie).
+
+      @param filename  The file to play back
+      @param info      The ROM and controllers used, must match the movie
+      @param load      Loads a state
+      @param keyframe  The keyframe to start at
+
+      @return  False if the movie doesn't exist, doesn't match or is invalid
+    */
+    bool startPlayback(string_view filename, const Info& info,
+                       const LoadFunc& load, uInt32 keyframe = 0);
+
+    /**
+      Play back all updates due at the given cycles, and set the event
+      values to the recorded ones.  This must be called each time the input
+      is polled, before it is passed to the controllers.  Playback ends
+      after the last update.
+
+      @return  False if a keyframe differs from the current state
+    */
+    bool play(uInt64 cycles, Event& event, const SaveFunc& save);
+
+    /**
+      Stop recording or playing back.
+    */
+    void stop();
+
+    bool isRecording() const { return myRecording; }
+    bool isPlaying() const { return myPlaying; }
+
+    /**
+      The cycles of the next update to be played back; emulation must stop
+      exactly there.
+    */
+    uInt64 nextCycles() const { return myNext.cycles; }
+
+    /**
+      The number of keyframes recorded or passed during playback.
+    */
+    uInt32 keyframes() const { return myKeyframes; }
+
+  private:
+    enum class Record: uInt8 {
+      Keyframe = 'K',
+      Update   = 'U',
+      End      = 'E'
+    };
+
+    using Values = std::array<Int32, Event::LastType>;
+
+    // The next record to be played back
+    struct Next {
+      Record type{Record::End};
+      uInt64 cycles{0};
+      ByteArray state;
+      vector<std::pair<uInt16, Int32>> changes;
+    };
+
+    bool writeKeyframe(uInt64 cycles, const SaveFunc& save);
+    bool readRecord();
+    static bool saveToArray(const SaveFunc& save, ByteArray& state);
+
+  private:
+    unique_ptr<Serializer> myFile;
+    bool myRecording{false};
+    bool myPlaying{false};
+
+    // The event values after the last update
+    Values myValues{};
+
+    uInt32 myPolls{0};
+    uInt32 myKeyframes{0};
+    Next myNext;
+
+  private:
+    // Following constructors and assignment operators not supported
+    InputMovie(const InputMovie&) = delete;
+    InputMovie(InputMovie&&) = delete;
+    InputMovie& operator=(const InputMovie&) = delete;
+    InputMovie& operator=(InputMovie&&) = delete;
+};
+
+#endif
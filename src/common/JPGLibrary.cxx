@@ -18,6 +18,7 @@
 #ifdef IMAGE_SUPPORT
 
 #include <limits>
+#include <mutex>
 #include <span>
 
 #include "OSystem.hxx"
@@ -40,6 +41,38 @@ JPGLibrary::JPGLibrary(OSystem& osystem)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void JPGLibrary::loadImage(string_view filename, FBSurface& surface,
                            VariantList& metaData)
+{
+  readImage(filename, myFileBuffer, metaData,
+    [&](std::span<const uInt8> pixels, uInt32 width, uInt32 height) {
+      // Load image into the surface, setting the correct dimensions
+      loadImagetoSurface(surface, pixels, width, height);
+    });
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void JPGLibrary::loadImage(string_view filename, vector<uInt32>& pixels,
+                           uInt32& width, uInt32& height, VariantList& metaData)
+{
+  vector<std::byte> fileBuffer;
+
+  readImage(filename, fileBuffer, metaData,
+    [&](std::span<const uInt8> rgb, uInt32 w, uInt32 h) {
+      width = w;
+      height = h;
+      pixels.resize(static_cast<size_t>(w) * h);
+
+      const uInt8* i_ptr = rgb.data();
+      for(auto& pixel: pixels)
+      {
+        pixel = 0xFF000000 | (i_ptr[0] << 16) | (i_ptr[1] << 8) | i_ptr[2];
+        i_ptr += 3;
+      }
+    });
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void JPGLibrary::readImage(string_view filename, vector<std::byte>& fileBuffer,
+                           VariantList& metaData, const StoreFunc& store)
 {
   auto in = FSNode(filename).openIFStream(std::ios_base::binary |
                                           std::ios_base::ate);
@@ -55,9 +88,9 @@ void JPGLibrary::loadImage(string_view filename, FBSurface& surface,
   if(size > static_cast<size_t>(std::numeric_limits<int>::max()))
     throw std::runtime_error{"JPG file too large"};
 
-  myFileBuffer.resize(size);
+  fileBuffer.resize(size);
 
-  if(!in.read(reinterpret_cast<char*>(myFileBuffer.data()),
+  if(!in.read(reinterpret_cast<char*>(fileBuffer.data()),
               static_cast<std::streamsize>(size)))
     throw std::runtime_error{"JPG image data reading failed"};
 
@@ -71,9 +104,12 @@ void JPGLibrary::loadImage(string_view filename, FBSurface& surface,
     NJGuard& operator=(NJGuard&&) = delete;
   };
 
+  // nanojpeg decodes into a single global context
+  static std::mutex decodeMutex;
+  const std::scoped_lock lock(decodeMutex);
   const NJGuard guard;
 
-  if(njDecode(reinterpret_cast<const char*>(myFileBuffer.data()),
+  if(njDecode(reinterpret_cast<const char*>(fileBuffer.data()),
               static_cast<int>(size)))
     throw std::runtime_error{"Error decoding the JPG image"};
 
@@ -84,10 +120,9 @@ void JPGLibrary::loadImage(string_view filename, FBSurface& surface,
       static_cast<size_t>(width) * static_cast<size_t>(height) * 3 };
 
   // Read the meta data we got
-  readMetaData({myFileBuffer.data(), size}, metaData);
+  readMetaData({fileBuffer.data(), size}, metaData);
 
-  // Load image into the surface, setting the correct dimensions
-  loadImagetoSurface(surface, pixels, width, height);
+  store(pixels, width, height);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -23,6 +23,7 @@
 class OSystem;
 class FBSurface;
 
+#include <functional>
 #include <span>
 
 #include "Variant.hxx"
@@ -54,12 +55,44 @@ class JPGLibrary
     */
     void loadImage(string_view filename, FBSurface& surface, VariantList& metaData);
 
+    /**
+      Read a JPG image from the specified file into a pixel buffer, in its
+      original size.  Unlike the method above, this may be called from any
+      thread.
+
+      @param filename  The filename to load the JPG image
+      @param pixels    The ARGB8888 image data, 'width' pixels per row
+      @param width     The width of the JPG image
+      @param height    The height of the JPG image
+      @param metaData  The meta data of the JPG image
+
+      @post  On failure, a std::runtime_error is thrown containing a more
+             detailed error message.
+    */
+    static void loadImage(string_view filename, vector<uInt32>& pixels,
+                          uInt32& width, uInt32& height, VariantList& metaData);
+
   private:
     OSystem& myOSystem;
 
     // Holds the decoded bytes from the JPG file
     static vector<std::byte> myFileBuffer;
 
+    // Stores the decoded RGB triples of an image
+    using StoreFunc = std::function<void(std::span<const uInt8> pixels,
+                                         uInt32 width, uInt32 height)>;
+
+    /**
+      The actual method which reads a JPG image.
+
+      @param filename    The filename to load the JPG image
+      @param fileBuffer  Holds the bytes from the JPG file
+      @param metaData    The meta data of the JPG image
+      @param store       Called with the decoded image data
+    */
+    static void readImage(string_view filename, vector<std::byte>& fileBuffer,
+                          VariantList& metaData, const StoreFunc& store);
+
     /**
       Load the decoded JPG data into the FBSurface.  The surface is
       resized as necessary to accommodate the data.
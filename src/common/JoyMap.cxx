@@ -25,6 +25,7 @@ using json = nlohmann::json;
 void JoyMap::add(Event::Type event, const JoyMapping& mapping)
 {
   myMap[mapping] = event;
+  setTableEntry(mapping, event);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -44,6 +45,8 @@ void JoyMap::add(Event::Type event, EventMode mode, int button,
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void JoyMap::erase(const JoyMapping& mapping)
 {
+  // mapping may refer to the key of the erased element
+  setTableEntry(mapping, UNMAPPED);
   myMap.erase(mapping);
 }
 
@@ -62,6 +65,20 @@ void JoyMap::erase(EventMode mode, int button, int hat, JoyHatDir hdir)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 Event::Type JoyMap::get(const JoyMapping& mapping) const
 {
+  if(const size_t entry = tableEntry(mapping); entry < TABLE_SIZE)
+  {
+    const auto& table = myTables[static_cast<size_t>(mapping.mode)];
+    if(table.empty())
+      return Event::Type::NoType;
+
+    if(table[entry] != UNMAPPED)
+      return table[entry];
+
+    // try without button as modifier
+    const Event::Type event = table[entry % CONTROLS];
+    return event != UNMAPPED ? event : Event::Type::NoType;
+  }
+
   auto find = myMap.find(mapping);
   if(find != myMap.end())
     return find->second;
@@ -92,6 +109,51 @@ Event::Type JoyMap::get(EventMode mode, int button,
   return get(JoyMapping(mode, button, hat, hdir));
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+size_t JoyMap::tableEntry(const JoyMapping& mapping)
+{
+  if(static_cast<size_t>(mapping.mode) >= static_cast<size_t>(EventMode::kNumModes) ||
+     mapping.button < JOY_CTRL_NONE || mapping.button >= MAX_BUTTONS)
+    return TABLE_SIZE;
+
+  size_t control = 0;
+  if(mapping.hat == JOY_CTRL_NONE && mapping.hdir == JoyHatDir::CENTER)
+  {
+    const int axis = static_cast<int>(mapping.axis);
+    const int adir = static_cast<int>(mapping.adir);
+    if(axis < JOY_CTRL_NONE || axis > static_cast<int>(JoyAxis::A7) ||
+       adir < static_cast<int>(JoyDir::NEG) || adir > static_cast<int>(JoyDir::ANALOG))
+      return TABLE_SIZE;
+
+    control = (axis + 1) * 4 + (adir + 1);
+  }
+  else if(mapping.axis == JoyAxis::NONE && mapping.adir == JoyDir::NONE &&
+          mapping.hat >= 0 && mapping.hat < MAX_HATS &&
+          mapping.hdir < JoyHatDir::CENTER)
+    control = AXIS_CONTROLS + mapping.hat * 4 + static_cast<size_t>(mapping.hdir);
+  else
+    return TABLE_SIZE;
+
+  return (mapping.button + 1) * CONTROLS + control;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void JoyMap::setTableEntry(const JoyMapping& mapping, Event::Type event)
+{
+  const size_t entry = tableEntry(mapping);
+  if(entry >= TABLE_SIZE)
+    return;
+
+  auto& table = myTables[static_cast<size_t>(mapping.mode)];
+  if(table.empty())
+  {
+    if(event == UNMAPPED)
+      return;
+    table.assign(TABLE_SIZE, UNMAPPED);
+  }
+  table[entry] = event;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool JoyMap::check(const JoyMapping& mapping) const
 {
@@ -125,6 +125,16 @@ class JoyMap
   private:
     static string getDesc(Event::Type event, const JoyMapping& mapping);
 
+    /**
+      Get the entry of a mapping in the lookup table of its mode.
+
+      @return  The entry, or TABLE_SIZE if the mapping is not held in the table
+    */
+    static size_t tableEntry(const JoyMapping& mapping);
+
+    /** Update the lookup table for a mapping */
+    void setTableEntry(const JoyMapping& mapping, Event::Type event);
+
     struct JoyHash {
       size_t operator()(const JoyMapping& m)const {
         return std::hash<uInt64>()((static_cast<uInt64>(m.mode)) // 3 bits
@@ -140,6 +150,20 @@ class JoyMap
 
     std::unordered_map<JoyMapping, Event::Type, JoyHash> myMap;
 
+    // Per mode lookup tables of events, directly indexed by the (optional)
+    // button and either an axis direction or a hat direction; they mirror
+    // myMap, which stays the reference and also holds the mappings beyond
+    // the table's limits.  A mode's table is only allocated once the mode
+    // gets its first mapping.
+    static constexpr int MAX_BUTTONS = 32;
+    static constexpr int MAX_HATS = 4;
+    static constexpr size_t AXIS_CONTROLS = 9 * 4;  // (NONE, 0..7) x (NEG, NONE, POS, ANALOG)
+    static constexpr size_t CONTROLS = AXIS_CONTROLS + MAX_HATS * 4;
+    static constexpr size_t TABLE_SIZE = (MAX_BUTTONS + 1) * CONTROLS;
+    static constexpr Event::Type UNMAPPED = Event::LastType;
+    std::array<std::vector<Event::Type>,
+               static_cast<size_t>(EventMode::kNumModes)> myTables;
+
     // Following constructors and assignment operators not supported
     JoyMap(const JoyMap&) = delete;
     JoyMap(JoyMap&&) = delete;
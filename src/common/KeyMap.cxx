@@ -69,7 +69,10 @@ namespace {
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void KeyMap::add(Event::Type event, const Mapping& mapping)
 {
-  myMap[convertMod(mapping)] = event;
+  const Mapping m = convertMod(mapping);
+
+  myMap[m] = event;
+  addTableEntry(m, event);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -81,7 +84,10 @@ void KeyMap::add(Event::Type event, EventMode mode, int key, int mod)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void KeyMap::erase(const Mapping& mapping)
 {
-  myMap.erase(convertMod(mapping));
+  const Mapping m = convertMod(mapping);
+
+  myMap.erase(m);
+  eraseTableEntry(m);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -95,6 +101,27 @@ Event::Type KeyMap::get(const Mapping& mapping) const
 {
   Mapping m = convertMod(mapping);
 
+  if(static_cast<uInt32>(m.key) < KBDK_COUNT)
+  {
+    const KeyTable& table = myTables[static_cast<size_t>(m.mode)];
+    if(table.empty())
+      return Event::Type::NoType;
+
+    const auto& entries = table[m.key];
+    if(myModEnabled)
+    {
+      const auto find = std::ranges::find_if(entries, [&](const KeyEvent& e) {
+        return Mapping(m.mode, m.key, e.mod) == m;
+      });
+      if(find != entries.end())
+        return find->event;
+    }
+
+    // mapping not found, try without modifiers
+    const auto find = std::ranges::find(entries, KBDM_NONE, &KeyEvent::mod);
+    return find != entries.end() ? find->event : Event::Type::NoType;
+  }
+
   if(myModEnabled)
   {
     const auto find = myMap.find(m);
@@ -333,6 +360,45 @@ void KeyMap::eraseEvent(Event::Type event, EventMode mode)
     else item++;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void KeyMap::addTableEntry(const Mapping& mapping, Event::Type event)
+{
+  if(static_cast<uInt32>(mapping.key) >= KBDK_COUNT)
+    return;
+
+  KeyTable& table = myTables[static_cast<size_t>(mapping.mode)];
+  if(table.empty())
+    table.resize(KBDK_COUNT);
+
+  // like myMap, update an existing equal mapping instead of adding it again
+  auto& entries = table[mapping.key];
+  const auto find = std::ranges::find_if(entries, [&](const KeyEvent& e) {
+    return Mapping(mapping.mode, mapping.key, e.mod) == mapping;
+  });
+  if(find != entries.end())
+    find->event = event;
+  else
+    entries.push_back({mapping.mod, event});
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void KeyMap::eraseTableEntry(const Mapping& mapping)
+{
+  if(static_cast<uInt32>(mapping.key) >= KBDK_COUNT)
+    return;
+
+  KeyTable& table = myTables[static_cast<size_t>(mapping.mode)];
+  if(table.empty())
+    return;
+
+  auto& entries = table[mapping.key];
+  const auto find = std::ranges::find_if(entries, [&](const KeyEvent& e) {
+    return Mapping(mapping.mode, mapping.key, e.mod) == mapping;
+  });
+  if(find != entries.end())
+    entries.erase(find);
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 KeyMap::Mapping KeyMap::convertMod(const Mapping& mapping)
 {
@@ -108,6 +108,10 @@ class KeyMap
     //** Convert modifiers */
     static Mapping convertMod(const Mapping& mapping);
 
+    /** Mirror adding/erasing a (converted) mapping in the lookup tables */
+    void addTableEntry(const Mapping& mapping, Event::Type event);
+    void eraseTableEntry(const Mapping& mapping);
+
     struct KeyHash {
       size_t operator()(const Mapping& m) const {
         return std::hash<uInt64>()((static_cast<uInt64>(m.mode))    // 3 bits
@@ -123,6 +127,19 @@ class KeyMap
 
     std::unordered_map<Mapping, Event::Type, KeyHash> myMap;
 
+    // Per mode lookup tables, directly indexed by key, of the modifier
+    // combinations mapped for each key.  They mirror myMap, which stays the
+    // reference (and also holds any keys beyond KBDK_COUNT), so that get()
+    // only has to compare the few mappings of a single key.  A mode's table
+    // is only allocated once the mode gets its first mapping.
+    struct KeyEvent
+    {
+      StellaMod mod{KBDM_NONE};
+      Event::Type event{Event::NoType};
+    };
+    using KeyTable = std::vector<std::vector<KeyEvent>>;
+    std::array<KeyTable, static_cast<size_t>(EventMode::kNumModes)> myTables;
+
     // Indicates whether the key-combos tied to a modifier key are
     // being used or not (e.g. Ctrl by default is the fire button,
     // pressing it with a movement key could inadvertantly activate
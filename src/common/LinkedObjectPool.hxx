@@ -19,6 +19,7 @@
 #define LINKED_OBJECT_POOL_HXX
 
 #include <cassert>
+#include <functional>
 
 #include "bspf.hxx"
 
@@ -142,6 +143,14 @@ class LinkedObjectPool
       return myNodes[myCurrentIdx].value;
     }
 
+    /**
+      Return node data that the given iterator points to.
+    */
+    T& value(const_iter i) {
+      assert(i.index() != npos);
+      return myNodes[i.index()].value;
+    }
+
     /**
       Does the 'current' iterator point to a valid node in the list?
       This must be called before 'current()' is called.
@@ -188,6 +197,7 @@ class LinkedObjectPool
     /**
       Return an iterator to the specified node in the list.
     */
+    const_iter currentIter() const { return const_iter(this, myCurrentIdx); }
     const_iter first() const { return const_iter(this, myHead); }
     const_iter last()  const { return const_iter(this, myTail); }
     const_iter previous(const_iter i) const {
@@ -350,6 +360,20 @@ class LinkedObjectPool
     [[nodiscard]] bool empty() const { return mySize == 0; }
     [[nodiscard]] bool full()  const { return mySize == myCapacity; }
 
+    /**
+      Answer the number of bytes owned by the pool.  The memory owned by
+      each (active or recycled) node's data is determined by 'owned'.
+    */
+    [[nodiscard]] size_t memoryUsage(
+        const std::function<size_t(const T&)>& owned) const {
+      size_t bytes = myNodes.capacity() * sizeof(Node);
+
+      for(const auto& node: myNodes)
+        bytes += owned(node.value);
+
+      return bytes;
+    }
+
   #if 0
     friend std::ostream& operator<<(std::ostream& os, const LinkedObjectPool<T>& p) {
       for(const auto& i: p.myList)
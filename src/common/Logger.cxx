@@ -15,6 +15,8 @@
 // this file, and for a DISCLAIMER OF ALL WARRANTIES.
 //============================================================================
 
+#include <chrono>
+
 #include "Logger.hxx"
 
 #ifdef __LIB_RETRO__
@@ -29,6 +31,41 @@ Logger& Logger::instance()
   return loggerInstance;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+Logger::Logger()
+{
+#ifndef __LIB_RETRO__
+  myDrainThread = std::thread([this] {
+    std::unique_lock lock(myMutex);
+
+    // Polling keeps the logging threads free of wakeup calls, except on bursts
+    while(!myQuit)
+    {
+      myDrainCondition.wait_for(lock, std::chrono::milliseconds(20));
+      drain();
+    }
+  });
+#endif
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+Logger::~Logger()
+{
+  if(myDrainThread.joinable())
+  {
+    {
+      const std::scoped_lock lock(myMutex);
+      myQuit = true;
+    }
+    myDrainCondition.notify_one();
+    myDrainThread.join();
+  }
+
+  // Write what was logged after the last drain
+  const std::scoped_lock lock(myMutex);
+  drain();
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void Logger::log(string_view message, Level level)
 {
@@ -55,26 +92,210 @@ void Logger::debug(string_view message)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void Logger::logMessage(string_view message, Level level)
 {
-  const std::scoped_lock lock(mutex);
-
 #ifdef __LIB_RETRO__
+  const std::scoped_lock lock(myMutex);
+
+  // The frontend does its own filtering
   libretro_logger(static_cast<int>(level), string{message}.c_str());
+  if(accepts(level))
+  {
+    output(message, level);
+    cout << std::flush;
+  }
+#else
+  if(!accepts(level))
+    return;
+
+  ThreadBuffer& buffer = threadBuffer();
+  const auto index = static_cast<size_t>(level);
+
+  // Rate limiting (per thread), in windows of one second
+  const uInt32 limit = myRateLimits[index].load(std::memory_order_relaxed);
+  if(limit > 0)
+  {
+    const auto now = static_cast<uInt64>(
+      std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+
+    if(now - buffer.windowStart >= 1000)
+    {
+      buffer.windowStart = now;
+      buffer.count.fill(0);
+    }
+    if(++buffer.count[index] > limit)
+    {
+      buffer.suppressed[index].fetch_add(1, std::memory_order_relaxed);
+      return;
+    }
+  }
+
+  if(!push(buffer, message, level))
+  {
+    // Too long for any ring; this is rare enough to simply block
+    if(message.size() > ThreadBuffer::NUM_ENTRIES * Entry::TEXT_SIZE)
+    {
+      const std::scoped_lock lock(myMutex);
+
+      drain();
+      output(message, level);
+      cout << std::flush;
+    }
+    else
+      buffer.dropped.fetch_add(1, std::memory_order_relaxed);
+  }
 #endif
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool Logger::accepts(Level level) const
+{
+  return level == Level::ERR || level == Level::ALWAYS ||
+         static_cast<int>(level) <= myLogLevel.load(std::memory_order_relaxed);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+Logger::ThreadBuffer& Logger::threadBuffer()
+{
+  // Releases the ring of a thread for reuse when the thread ends
+  struct Owner {
+    ThreadBuffer* buffer{nullptr};
+
+    ~Owner() {
+      if(buffer)
+        buffer->inUse.store(false, std::memory_order_release);
+    }
+  };
+  thread_local Owner owner;
+
+  if(owner.buffer == nullptr)
+  {
+    const std::scoped_lock lock(myBuffersMutex);
+
+    for(const auto& buffer: myBuffers)
+      if(!buffer->inUse.load(std::memory_order_acquire))
+      {
+        buffer->inUse.store(true, std::memory_order_relaxed);
+        owner.buffer = buffer.get();
+        break;
+      }
+
+    if(owner.buffer == nullptr)
+    {
+      myBuffers.push_back(std::make_unique<ThreadBuffer>());
+      owner.buffer = myBuffers.back().get();
+    }
+  }
+
+  return *owner.buffer;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool Logger::push(ThreadBuffer& buffer, string_view message, Level level)
+{
+  constexpr uInt32 mask = ThreadBuffer::NUM_ENTRIES - 1;
+
+  const auto needed = static_cast<uInt32>(
+    std::max<size_t>((message.size() + Entry::TEXT_SIZE - 1) / Entry::TEXT_SIZE, 1));
+  const uInt32 tail = buffer.tail.load(std::memory_order_relaxed);
+
+  if(ThreadBuffer::NUM_ENTRIES - (tail - buffer.head.load(std::memory_order_acquire)) < needed)
+    return false;
 
-  if(level == Logger::Level::ERR)
+  const uInt64 sequence = mySequence.fetch_add(1, std::memory_order_relaxed);
+
+  for(uInt32 i = 0; i < needed; ++i)
   {
-    cout << message << '\n' << std::flush;
-    myLogMessages += message;
-    myLogMessages += "\n";
+    Entry& entry = buffer.entries[(tail + i) & mask];
+    const string_view part = message.substr(i * Entry::TEXT_SIZE, Entry::TEXT_SIZE);
+
+    entry.sequence = sequence;
+    entry.level = level;
+    entry.more = i + 1 < needed;
+    entry.size = static_cast<uInt8>(part.size());
+    std::copy(part.begin(), part.end(), entry.text.begin());
   }
-  else if(static_cast<int>(level) <= myLogLevel ||
-          level == Logger::Level::ALWAYS)
+
+  // Publish the message only once it is complete
+  buffer.tail.store(tail + needed, std::memory_order_release);
+
+  // Only wake up the drain early on bursts, which would fill the ring
+  if(tail + needed - buffer.head.load(std::memory_order_relaxed) >=
+     ThreadBuffer::NUM_ENTRIES / 2)
+    myDrainCondition.notify_one();
+
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Logger::drain()
+{
+  constexpr uInt32 mask = ThreadBuffer::NUM_ENTRIES - 1;
+
+  struct Message {
+    uInt64 sequence{0};
+    Level level{Level::ALWAYS};
+    string text;
+  };
+  vector<Message> messages;
+  uInt32 dropped = 0;
+  std::array<uInt32, NUM_LEVELS> suppressed{};
+
+  vector<ThreadBuffer*> buffers;
+  {
+    const std::scoped_lock lock(myBuffersMutex);
+
+    for(const auto& buffer: myBuffers)
+      buffers.push_back(buffer.get());
+  }
+
+  for(auto* buffer: buffers)
   {
-    if(myLogToConsole)
-      cout << message << '\n' << std::flush;
-    myLogMessages += message;
-    myLogMessages += "\n";
+    uInt32 head = buffer->head.load(std::memory_order_relaxed);
+    const uInt32 tail = buffer->tail.load(std::memory_order_acquire);
+    bool continued = false;
+
+    for(; head != tail; ++head)
+    {
+      const Entry& entry = buffer->entries[head & mask];
+
+      if(!continued)
+        messages.push_back({entry.sequence, entry.level, {}});
+      messages.back().text.append(entry.text.data(), entry.size);
+      continued = entry.more;
+    }
+    buffer->head.store(head, std::memory_order_release);
+
+    dropped += buffer->dropped.exchange(0, std::memory_order_relaxed);
+    for(size_t i = 0; i < NUM_LEVELS; ++i)
+      suppressed[i] += buffer->suppressed[i].exchange(0, std::memory_order_relaxed);
   }
+
+  // Restore the order in which the threads logged
+  std::ranges::sort(messages, {}, &Message::sequence);
+
+  for(const auto& message: messages)
+    output(message.text, message.level);
+
+  if(dropped > 0)
+    output(std::format("{} log messages dropped (log buffer full)", dropped),
+           Level::ERR);
+  for(size_t i = 0; i < NUM_LEVELS; ++i)
+    if(suppressed[i] > 0)
+      output(std::format("{} log messages suppressed (rate limit)", suppressed[i]),
+             static_cast<Level>(i));
+
+  if(!messages.empty() || dropped > 0)
+    cout << std::flush;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Logger::output(string_view message, Level level)
+{
+  if(level == Level::ERR || myLogToConsole.load(std::memory_order_relaxed))
+    cout << message << '\n';
+
+  myLogMessages += message;
+  myLogMessages += "\n";
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -93,3 +314,18 @@ void Logger::setLogParameters(Level logLevel, bool logToConsole)
 {
   setLogParameters(static_cast<int>(logLevel), logToConsole);
 }
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Logger::setRateLimit(Level level, uInt32 messagesPerSecond)
+{
+  myRateLimits[static_cast<size_t>(level)] = messagesPerSecond;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+string Logger::logMessages()
+{
+  const std::scoped_lock lock(myMutex);
+
+  drain();
+  return myLogMessages;
+}
@@ -18,10 +18,25 @@
 #ifndef LOGGER_HXX
 #define LOGGER_HXX
 
+#include <atomic>
+#include <condition_variable>
 #include <mutex>
+#include <thread>
 
 #include "bspf.hxx"
 
+/**
+  The logger collects all log messages and writes them to the console.
+
+  Logging never blocks the calling thread (e.g. the emulation thread):
+  each thread writes its messages into its own lock-free ring, and a
+  background thread drains the rings to the console and the message log.
+  Messages which don't fit into a full ring, or which exceed the rate limit
+  of their level, are dropped and summarized by a note instead.
+
+  The libretro core has no emulation thread, and the frontend expects its
+  log callback to be called synchronously, so it logs directly.
+*/
 class Logger {
 
   public:
@@ -50,24 +65,101 @@ class Logger {
     void setLogParameters(int logLevel, bool logToConsole);
     void setLogParameters(Level logLevel, bool logToConsole);
 
-    const string& logMessages() const { return myLogMessages; }
+    /**
+      Limit the number of messages of the given level, which each thread
+      may log per second; the default of 0 means unlimited.
+    */
+    void setRateLimit(Level level, uInt32 messagesPerSecond);
+
+    /**
+      Answer all messages logged so far, including those not drained yet.
+    */
+    string logMessages();
 
   protected:
-    Logger() = default;
-    ~Logger() = default;
+    Logger();
+    ~Logger();
 
   private:
-    int myLogLevel{static_cast<int>(Level::MAX)};
-    bool myLogToConsole{true};
+    static constexpr size_t NUM_LEVELS = static_cast<size_t>(Level::ALWAYS) + 1;
+
+    // One message (or part of a longer one) in a thread's ring
+    struct Entry {
+      static constexpr size_t TEXT_SIZE = 244;
+
+      uInt64 sequence{0};
+      Level level{Level::ALWAYS};
+      bool more{false};    // the message continues in the next entry
+      uInt8 size{0};
+      std::array<char, TEXT_SIZE> text{};
+    };
+
+    /**
+      The messages of a single thread.  The owning thread is the only one
+      which pushes, the drain (under myMutex) is the only one which pops.
+      Head and tail are free running counters on their own cache lines.
+    */
+    struct ThreadBuffer {
+      static constexpr uInt32 NUM_ENTRIES = 1024;  // a power of two
+
+      std::array<Entry, NUM_ENTRIES> entries;
+
+      alignas(64) std::atomic<uInt32> head{0};  // next entry to drain
+      alignas(64) std::atomic<uInt32> tail{0};  // next entry to push
+
+      // Messages dropped since the last drain, as the ring was full or
+      // the rate limit was exceeded
+      std::atomic<uInt32> dropped{0};
+      std::array<std::atomic<uInt32>, NUM_LEVELS> suppressed{};
+      // Cleared when the owning thread ends, so the ring can be reused
+      std::atomic<bool> inUse{true};
+
+      // Rate limiting, only accessed by the owning thread
+      uInt64 windowStart{0};
+      std::array<uInt32, NUM_LEVELS> count{};
+    };
+
+    std::atomic<int> myLogLevel{static_cast<int>(Level::MAX)};
+    std::atomic<bool> myLogToConsole{true};
+    std::array<std::atomic<uInt32>, NUM_LEVELS> myRateLimits{};
+
+    // Orders the messages of all threads
+    std::atomic<uInt64> mySequence{0};
+
+    // Guards the message log and draining the rings
+    std::mutex myMutex;
 
     // The list of log messages
     string myLogMessages;
 
-    std::mutex mutex;
+    // The rings of all threads; these are never deleted, but reused
+    vector<unique_ptr<ThreadBuffer>> myBuffers;
+    std::mutex myBuffersMutex;
+
+    // The background thread draining the rings
+    std::thread myDrainThread;
+    std::condition_variable myDrainCondition;
+    bool myQuit{false};
 
   private:
     void logMessage(string_view message, Level level);
 
+    // Answer whether the message passes the level filter
+    bool accepts(Level level) const;
+
+    // Answer the ring of the calling thread, creating it if necessary
+    ThreadBuffer& threadBuffer();
+
+    // Push a message into the given ring, answer false if it is full
+    bool push(ThreadBuffer& buffer, string_view message, Level level);
+
+    // Write all pushed messages to the console and the message log;
+    // must be called with myMutex locked
+    void drain();
+
+    // Write a single message; must be called with myMutex locked
+    void output(string_view message, Level level);
+
     Logger(const Logger&) = delete;
     Logger(Logger&&) = delete;
     Logger& operator=(const Logger&) = delete;
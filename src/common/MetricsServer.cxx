@@ -0,0 +1,292 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2026 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+
+#ifdef HTTP_LIB_SUPPORT
+
+#include <cmath>
+
+#if defined(BSPF_WINDOWS)
+  #include "Windows.hxx"
+#else
+  #include <sys/resource.h>
+#endif
+
+#include "http_lib.hxx"
+
+#include "AudioQueue.hxx"
+#include "Console.hxx"
+#include "FrameBuffer.hxx"
+#include "Logger.hxx"
+#include "MemoryReport.hxx"
+#include "OSystem.hxx"
+#include "RewindManager.hxx"
+#include "StateManager.hxx"
+#include "ThreadScheduling.hxx"
+#include "EventHandler.hxx"
+#include "MetricsServer.hxx"
+
+namespace {
+  /**
+    Runs each connection directly on the listening thread, so that the
+    server needs only a single (background) thread.
+  */
+  class InlineTaskQueue : public httplib::TaskQueue
+  {
+    public:
+      bool enqueue(std::function<void()> fn) override { fn(); return true; }
+      void shutdown() override { }
+  };
+
+  // The CPU time used by the process so far, in seconds
+  double cpuSeconds()
+  {
+  #if defined(BSPF_WINDOWS)
+    FILETIME creation, exit, kernel, user;
+    if(!GetProcessTimes(GetCurrentProcess(), &creation, &exit, &kernel, &user))
+      return 0.;
+
+    const auto seconds = [](const FILETIME& time) {
+      return static_cast<double>((static_cast<uInt64>(time.dwHighDateTime) << 32) |
+                                 time.dwLowDateTime) / 1e7;  // 100 ns units
+    };
+    return seconds(kernel) + seconds(user);
+  #else
+    rusage usage{};
+    if(getrusage(RUSAGE_SELF, &usage) != 0)
+      return 0.;
+
+    const auto seconds = [](const timeval& time) {
+      return static_cast<double>(time.tv_sec) +
+             static_cast<double>(time.tv_usec) / 1e6;
+    };
+    return seconds(usage.ru_utime) + seconds(usage.ru_stime);
+  #endif
+  }
+} // namespace
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+MetricsServer::MetricsServer(const string& address, int port)
+  : myServer{std::make_unique<httplib::Server>()}
+{
+  myServer->new_task_queue = [] { return new InlineTaskQueue; };
+  // A scraper must not hold the only thread with an idle connection
+  myServer->set_keep_alive_max_count(1);
+  myServer->set_read_timeout(std::chrono::seconds(2));
+  myServer->set_write_timeout(std::chrono::seconds(2));
+
+  myServer->Get("/metrics", [this](const httplib::Request&, httplib::Response& res) {
+    res.set_content(metrics(), "text/plain; version=0.0.4");
+  });
+
+  if(!myServer->bind_to_port(address, port))
+  {
+    Logger::error(std::format("Metrics: could not bind to {}:{}", address, port));
+    return;
+  }
+
+  myThread = std::thread([this] {
+    ThreadScheduling::setBackground();
+    myServer->listen_after_bind();
+  });
+  Logger::info(std::format("Metrics: serving at http://{}:{}/metrics",
+                           address, port));
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+MetricsServer::~MetricsServer()
+{
+  if(myThread.joinable())
+  {
+    myServer->stop();
+    myThread.join();
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void MetricsServer::update(OSystem& osystem)
+{
+  using namespace std::chrono;
+
+  // The tap only keeps the last half second, so it is read on every call
+  readAudio(osystem);
+
+  const steady_clock::time_point now = steady_clock::now();
+  const double elapsed = duration<double>(now - myLastUpdate).count();
+  if(elapsed < 1.)
+    return;
+  myLastUpdate = now;
+
+  constexpr auto relaxed = std::memory_order_relaxed;
+
+  const bool emulating = osystem.hasConsole() &&
+    osystem.eventHandler().state() == EventHandlerState::EMULATION;
+  const uInt64 frames = myFramesDisplayed.load(relaxed);
+  const double fps = static_cast<double>(frames - myLastFrames) / elapsed;
+  const double frameRate = emulating ? osystem.frameRate() : 0.;
+  myLastFrames = frames;
+
+  myEmulating.store(emulating, relaxed);
+  myFps.store(fps, relaxed);
+  mySpeed.store(frameRate > 0 ? fps / frameRate : 0., relaxed);
+
+  const FrameTimes& frameTimes = osystem.frameTimes();
+  for(size_t phase = 0; phase < FrameTimes::NUM_PHASES; ++phase)
+    for(size_t q = 0; q < QUANTILES.size(); ++q)
+      myFrameTimes[phase][q].store(frameTimes.frames() > 0
+        ? frameTimes.percentile(static_cast<FrameTimes::Phase>(phase),
+                                QUANTILES[q]) / 1000. : 0., relaxed);
+
+  // The counters of each console start from zero
+  const AudioQueue* queue = osystem.hasConsole()
+    ? osystem.console().audioQueue() : nullptr;
+  if(queue != myAudioQueue)
+  {
+    myUnderrunBase += myLastUnderruns;
+    myOverflowBase += myLastOverflows;
+    myLastUnderruns = myLastOverflows = 0;
+    myAudioQueue = queue;
+  }
+  if(queue)
+  {
+    myLastUnderruns = queue->underruns();
+    myLastOverflows = queue->overflows();
+  }
+  myAudioUnderruns.store(myUnderrunBase + myLastUnderruns, relaxed);
+  myAudioOverflows.store(myOverflowBase + myLastOverflows, relaxed);
+
+  myAudioPeak.store(myPeakSample / 32768., relaxed);
+  myAudioRms.store(mySamples > 0
+    ? std::sqrt(mySampleSquares / static_cast<double>(mySamples)) / 32768. : 0.,
+    relaxed);
+  myPeakSample = 0;
+  mySampleSquares = 0.;
+  mySamples = 0;
+
+  MemoryReport console, framebuffer;
+  if(osystem.hasConsole())
+    osystem.console().memoryReport(console);
+  osystem.frameBuffer().memoryReport(framebuffer);
+  myMemory[static_cast<size_t>(Subsystem::Console)].store(console.total(), relaxed);
+  myMemory[static_cast<size_t>(Subsystem::Rewind)].store(
+    osystem.state().rewindManager().memoryUsage(), relaxed);
+  myMemory[static_cast<size_t>(Subsystem::FrameBuffer)].store(
+    framebuffer.total(), relaxed);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void MetricsServer::readAudio(OSystem& osystem)
+{
+  const AudioQueue* queue = osystem.hasConsole()
+    ? osystem.console().audioQueue() : nullptr;
+
+  // The tap keeps the queue of the previous console alive, so a new queue
+  // can't have the same address
+  if(!queue)
+    myAudioTap.reset();
+  else if(!myAudioTap || &myAudioTap->queue() != queue)
+    myAudioTap = AudioQueue::openTap(osystem.console().sharedAudioQueue());
+
+  if(!myAudioTap)
+    return;
+
+  const size_t count = static_cast<size_t>(queue->fragmentSize()) *
+                       (queue->isStereo() ? 2 : 1);
+  while(const Int16* fragment = myAudioTap->read())
+  {
+    for(size_t i = 0; i < count; ++i)
+    {
+      const Int32 sample = fragment[i];
+      myPeakSample = std::max(myPeakSample, std::abs(sample));
+      mySampleSquares += static_cast<double>(sample * sample);
+    }
+    mySamples += count;
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+string MetricsServer::metrics() const
+{
+  constexpr auto relaxed = std::memory_order_relaxed;
+  std::ostringstream buf;
+
+  const auto header = [&buf](string_view name, string_view type, string_view help) {
+    buf << "# HELP " << name << ' ' << help << '\n'
+        << "# TYPE " << name << ' ' << type << '\n';
+  };
+
+  header("stella_emulating", "gauge", "1 if a ROM is being emulated");
+  buf << "stella_emulating " << (myEmulating.load(relaxed) ? 1 : 0) << '\n';
+
+  header("stella_fps", "gauge", "Displayed frames per second");
+  buf << std::format("stella_fps {:.2f}\n", myFps.load(relaxed));
+
+  header("stella_emulation_speed_ratio", "gauge",
+         "Emulation speed relative to the console's frame rate");
+  buf << std::format("stella_emulation_speed_ratio {:.4f}\n", mySpeed.load(relaxed));
+
+  header("stella_frame_time_seconds", "gauge",
+         "Frame time percentiles over the last displayed frames");
+  for(size_t phase = 0; phase < FrameTimes::NUM_PHASES; ++phase)
+  {
+    string name{FrameTimes::name(static_cast<FrameTimes::Phase>(phase))};
+    BSPF::toLowerCase(name);
+    for(size_t q = 0; q < QUANTILES.size(); ++q)
+      buf << std::format(
+        "stella_frame_time_seconds{{phase=\"{}\",quantile=\"{}\"}} {:.6f}\n",
+        name, QUANTILES[q] / 100, myFrameTimes[phase][q].load(relaxed));
+  }
+
+  header("stella_frames_displayed_total", "counter", "Frames displayed");
+  buf << "stella_frames_displayed_total " << myFramesDisplayed.load(relaxed) << '\n';
+
+  header("stella_frames_dropped_total", "counter",
+         "Frames emulated, but not displayed");
+  buf << "stella_frames_dropped_total " << myFramesDropped.load(relaxed) << '\n';
+
+  header("stella_audio_underruns_total", "counter",
+         "Times the sound driver ran out of audio fragments");
+  buf << "stella_audio_underruns_total " << myAudioUnderruns.load(relaxed) << '\n';
+
+  header("stella_audio_overflows_total", "counter",
+         "Audio fragments dropped because the queue was full");
+  buf << "stella_audio_overflows_total " << myAudioOverflows.load(relaxed) << '\n';
+
+  header("stella_audio_peak_ratio", "gauge",
+         "Peak audio level over the last second, relative to full scale");
+  buf << std::format("stella_audio_peak_ratio {:.4f}\n", myAudioPeak.load(relaxed));
+
+  header("stella_audio_rms_ratio", "gauge",
+         "RMS audio level over the last second, relative to full scale");
+  buf << std::format("stella_audio_rms_ratio {:.4f}\n", myAudioRms.load(relaxed));
+
+  header("process_cpu_seconds_total", "counter",
+         "User and system CPU time spent in seconds");
+  buf << std::format("process_cpu_seconds_total {:.3f}\n", cpuSeconds());
+
+  static constexpr std::array<string_view, NUM_SUBSYSTEMS> SUBSYSTEMS = {
+    "console", "rewind", "framebuffer"
+  };
+  header("stella_memory_bytes", "gauge", "Memory owned by each subsystem");
+  for(size_t i = 0; i < NUM_SUBSYSTEMS; ++i)
+    buf << "stella_memory_bytes{subsystem=\"" << SUBSYSTEMS[i] << "\"} "
+        << myMemory[i].load(relaxed) << '\n';
+
+  return buf.str();
+}
+
+#endif // HTTP_LIB_SUPPORT
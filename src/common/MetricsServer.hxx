@@ -0,0 +1,141 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2026 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+
+#ifndef METRICS_SERVER_HXX
+#define METRICS_SERVER_HXX
+
+class OSystem;
+
+namespace httplib {
+  class Server;
+} // namespace httplib
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include "AudioQueue.hxx"
+#include "FrameTimes.hxx"
+#include "bspf.hxx"
+
+/**
+  Serves metrics of a running instance over HTTP in the Prometheus text
+  format ('-metrics <port>', at '/metrics'), so that unattended installations
+  can be monitored remotely: the emulation speed, the frame time percentiles,
+  displayed and dropped frames, audio queue underruns and overflows, the
+  audio levels, the process CPU time and the memory used by the subsystems.
+
+  The main thread publishes the values once per second into atomic
+  variables, which the server thread reads without any locking.  The server
+  handles one request at a time on a single thread of low priority, so it
+  never competes with the emulation.
+
+  @author  Stella Team
+*/
+class MetricsServer
+{
+  public:
+    /**
+      Start serving on the given address and port.  Check isRunning() for
+      whether the port could be bound.
+    */
+    MetricsServer(const string& address, int port);
+    ~MetricsServer();
+
+    bool isRunning() const { return myThread.joinable(); }
+
+    /**
+      Count frames rendered by the emulation; all but the one displayed
+      are dropped.
+    */
+    void addFrame(uInt32 frames) {
+      myFramesDisplayed.fetch_add(1, std::memory_order_relaxed);
+      myFramesDropped.fetch_add(frames - 1, std::memory_order_relaxed);
+    }
+
+    /**
+      Publish the current values, at most once per second.  Must be called
+      from the main thread.
+    */
+    void update(OSystem& osystem);
+
+  private:
+    // Frame time quantiles published per phase
+    static constexpr std::array<double, 3> QUANTILES = { 50, 95, 99 };
+
+    // Subsystems the memory is reported for
+    enum class Subsystem: uInt8 { Console, Rewind, FrameBuffer, NumSubsystems };
+    static constexpr size_t NUM_SUBSYSTEMS =
+      static_cast<size_t>(Subsystem::NumSubsystems);
+
+    /**
+      Accumulate the levels of the audio fragments produced since the last
+      call, read through a tap on the audio queue.
+    */
+    void readAudio(OSystem& osystem);
+
+    /**
+      Format the published values (called from the server thread).
+    */
+    string metrics() const;
+
+  private:
+    unique_ptr<httplib::Server> myServer;
+    std::thread myThread;
+
+    std::chrono::steady_clock::time_point myLastUpdate;
+    uInt64 myLastFrames{0};
+
+    // Published values
+    std::atomic<bool> myEmulating{false};
+    std::atomic<double> myFps{0.};
+    std::atomic<double> mySpeed{0.};
+    std::atomic<uInt64> myFramesDisplayed{0};
+    std::atomic<uInt64> myFramesDropped{0};
+    std::atomic<uInt64> myAudioUnderruns{0};
+    std::atomic<uInt64> myAudioOverflows{0};
+    // Relative to full scale
+    std::atomic<double> myAudioPeak{0.};
+    std::atomic<double> myAudioRms{0.};
+    // Seconds, per phase and quantile
+    std::array<std::array<std::atomic<double>, QUANTILES.size()>,
+               FrameTimes::NUM_PHASES> myFrameTimes{};
+    std::array<std::atomic<uInt64>, NUM_SUBSYSTEMS> myMemory{};
+
+    // The audio counters of the previous console, since they are reset with
+    // each new console
+    const void* myAudioQueue{nullptr};
+    uInt64 myUnderrunBase{0}, myOverflowBase{0};
+    uInt64 myLastUnderruns{0}, myLastOverflows{0};
+
+    // The audio levels since the last update
+    unique_ptr<AudioQueue::Tap> myAudioTap;
+    Int32 myPeakSample{0};
+    double mySampleSquares{0.};
+    uInt64 mySamples{0};
+
+  private:
+    // Following constructors and assignment operators not supported
+    MetricsServer() = delete;
+    MetricsServer(const MetricsServer&) = delete;
+    MetricsServer(MetricsServer&&) = delete;
+    MetricsServer& operator=(const MetricsServer&) = delete;
+    MetricsServer& operator=(MetricsServer&&) = delete;
+};
+
+#endif // METRICS_SERVER_HXX
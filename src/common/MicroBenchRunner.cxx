@@ -0,0 +1,518 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2026 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#include <chrono>
+#include <fstream>
+
+#include "MicroBenchRunner.hxx"
+#include "FSNode.hxx"
+#include "Cart.hxx"
+#include "Cart4K.hxx"
+#include "CartCreator.hxx"
+#include "CartDetector.hxx"
+#include "MD5.hxx"
+#include "Control.hxx"
+#include "ConsoleIO.hxx"
+#include "Switches.hxx"
+#include "Joystick.hxx"
+#include "Props.hxx"
+#include "Event.hxx"
+#include "M6502.hxx"
+#include "M6532.hxx"
+#include "TIA.hxx"
+#include "ConsoleTiming.hxx"
+#include "FrameManager.hxx"
+#include "System.hxx"
+#include "Random.hxx"
+#include "Serializer.hxx"
+#include "DispatchResult.hxx"
+#include "LanczosResampler.hxx"
+#include "BlepResampler.hxx"
+#include "AtariNTSC.hxx"
+#include "PhosphorHandler.hxx"
+#include "Version.hxx"
+#include "json_lib.hxx"
+
+using namespace std::chrono;
+
+namespace {
+  constexpr uInt32 SEED = 0x2600;
+
+  // Frames per repetition for the benchmarks running whole frames
+  constexpr uInt32 FRAMES = 60;
+
+  // Synthetic 4K ROM: an endless loop on RIOT RAM, which never touches the
+  // TIA (which therefore only idles along)
+  constexpr std::array<uInt8, 14> CPU_KERNEL = {
+    0xA2, 0x7F,         // F000  LDX #$7F
+    0xB5, 0x80,         // F002  LDA $80,X
+    0x69, 0x01,         // F004  ADC #$01
+    0x95, 0x80,         // F006  STA $80,X
+    0xCA,               // F008  DEX
+    0x10, 0xF7,         // F009  BPL $F002
+    0x4C, 0x00, 0xF0    // F00B  JMP $F000
+  };
+
+  // Synthetic 4K ROM: a complete NTSC frame with an asymmetric playfield and
+  // background/playfield colors changing on every visible scanline
+  constexpr std::array<uInt8, 55> TIA_KERNEL = {
+    0xA9, 0x02,         // F000  LDA #$02
+    0x85, 0x00,         // F002  STA VSYNC
+    0x85, 0x02,         // F004  STA WSYNC
+    0x85, 0x02,         // F006  STA WSYNC
+    0x85, 0x02,         // F008  STA WSYNC
+    0xA9, 0x00,         // F00A  LDA #$00
+    0x85, 0x00,         // F00C  STA VSYNC
+    0xA2, 0x25,         // F00E  LDX #37
+    0x85, 0x02,         // F010  STA WSYNC
+    0xCA,               // F012  DEX
+    0xD0, 0xFB,         // F013  BNE $F010
+    0x85, 0x01,         // F015  STA VBLANK
+    0xA2, 0xC0,         // F017  LDX #192
+    0x85, 0x02,         // F019  STA WSYNC
+    0x86, 0x09,         // F01B  STX COLUBK
+    0x86, 0x0E,         // F01D  STX PF1
+    0x8A,               // F01F  TXA
+    0x49, 0xFF,         // F020  EOR #$FF
+    0x85, 0x08,         // F022  STA COLUPF
+    0x85, 0x0F,         // F024  STA PF2
+    0xCA,               // F026  DEX
+    0xD0, 0xF0,         // F027  BNE $F019
+    0xA9, 0x02,         // F029  LDA #$02
+    0x85, 0x01,         // F02B  STA VBLANK
+    0xA2, 0x1E,         // F02D  LDX #30
+    0x85, 0x02,         // F02F  STA WSYNC
+    0xCA,               // F031  DEX
+    0xD0, 0xFB,         // F032  BNE $F02F
+    0x4C, 0x00, 0xF0    // F034  JMP $F000
+  };
+
+  template<size_t N>
+  ByteBuffer createRom(const std::array<uInt8, N>& code)
+  {
+    constexpr size_t size = 4_KB;
+    ByteBuffer image = std::make_unique<uInt8[]>(size);
+
+    std::fill_n(image.get(), size, 0xEA);  // NOP
+    std::ranges::copy(code, image.get());
+    // RESET and BRK vectors both point to $F000
+    image[size - 4] = image[size - 2] = 0x00;
+    image[size - 3] = image[size - 1] = 0xF0;
+
+    return image;
+  }
+
+  ByteBuffer randomImage(Random& rng, size_t size)
+  {
+    ByteBuffer image = std::make_unique<uInt8[]>(size);
+
+    for(size_t i = 0; i < size; ++i)
+      image[i] = static_cast<uInt8>(rng.next());
+
+    return image;
+  }
+
+  struct IO: public ConsoleIO {
+    Controller& leftController() const override { return *myLeftControl; }
+    Controller& rightController() const override { return *myRightControl; }
+    Switches& switches() const override { return *mySwitches; }
+
+    unique_ptr<Controller> myLeftControl;
+    unique_ptr<Controller> myRightControl;
+    unique_ptr<Switches> mySwitches;
+  };
+
+  // A headless NTSC console, without FrameBuffer or Sound attached
+  class Machine {
+    public:
+      Machine(unique_ptr<Cartridge> cartridge, Settings& settings)
+        : myCart{std::move(cartridge)},
+          myRandom{SEED},
+          myCpu{settings},
+          myRiot{myIO, settings},
+          // The TIA is too large to be placed on the stack
+          myTia{std::make_unique<TIA>(myIO,
+                []() { return ConsoleTiming::ntsc; }, settings,
+                [] (bool enable) {})},
+          mySystem{myRandom, myCpu, myRiot, *myTia, *myCart}
+      {
+        myIO.myLeftControl = std::make_unique<Joystick>(
+            Controller::Jack::Left, myEvent, mySystem);
+        myIO.myRightControl = std::make_unique<Joystick>(
+            Controller::Jack::Right, myEvent, mySystem);
+        myIO.mySwitches = std::make_unique<Switches>(myEvent, myProps, settings);
+
+        myTia->bindToControllers();
+        myCart->setStartBankFromPropsFunc([]() { return -1; });
+        mySystem.initialize();
+        myTia->setFrameManager(&myFrameManager);
+        mySystem.reset();
+      }
+
+      void runCycles(uInt64 cycles)
+      {
+        // The CPU stops at the end of each frame
+        for(uInt64 executed = 0; executed < cycles; )
+        {
+          DispatchResult result;
+
+          myCpu.execute(cycles - executed, result);
+          if(!result.isSuccess())
+            throw std::runtime_error("ERROR: emulation failed");
+          executed += result.getCycles();
+        }
+      }
+
+      void runFrames(uInt32 frames)
+      {
+        for(uInt32 i = 0; i < frames; ++i)
+        {
+          do
+            myTia->update();
+          while(!myTia->newFramePending());
+          myTia->renderToFrameBuffer();
+        }
+      }
+
+      System& system() { return mySystem; }
+
+    private:
+      IO myIO;
+      const Event myEvent;
+      const Properties myProps;
+      FrameManager myFrameManager;
+
+      unique_ptr<Cartridge> myCart;
+      Random myRandom;
+      M6502 myCpu;
+      M6532 myRiot;
+      unique_ptr<TIA> myTia;
+      System mySystem;
+  };
+
+  shared_ptr<Machine> createMachine(const ByteBuffer& image, size_t size,
+                                    Settings& settings)
+  {
+    const string md5 = MD5::hash(image, size);
+
+    return std::make_shared<Machine>(
+        std::make_unique<Cartridge4K>(image, size, md5, settings), settings);
+  }
+
+  double median(const vector<double>& sorted)
+  {
+    return sorted.empty() ? 0. : sorted[sorted.size() / 2];
+  }
+} // namespace
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+MicroBenchRunner::MicroBenchRunner(int argc, char* argv[])
+{
+  for (int i = 2; i < argc; ++i) {
+    const string arg = argv[i];
+
+    if (arg == "-filter") {
+      if (++i < argc) myFilter = argv[i];
+      continue;
+    }
+
+    if (arg == "-repetitions") {
+      if (++i < argc)
+        myRepetitions = static_cast<uInt32>(std::max(BSPF::stoi(argv[i]), 1));
+      continue;
+    }
+
+    if (arg == "-json") {
+      if (++i < argc) myJsonFile = argv[i];
+      continue;
+    }
+
+    myRomFiles.push_back(arg);
+  }
+
+  mySettings.setValue("fastscbios", true);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool MicroBenchRunner::run()
+{
+  vector<Benchmark> benchmarks;
+  addBenchmarks(benchmarks);
+
+  cout << std::format("Stella micro benchmarks, median of {} repetitions\n\n",
+                      myRepetitions);
+  cout << std::format("{:<40} {:>10} {:<10} {:>14} {:>14}\n", "benchmark",
+                      "ops/rep", "unit", "median ns/op", "min ns/op");
+
+  vector<Result> results;
+  results.reserve(benchmarks.size());
+
+  for (const Benchmark& benchmark : benchmarks) {
+    const Result& result = results.emplace_back(measure(benchmark));
+
+    cout << std::format("{:<40} {:>10} {:<10} {:>14.3f} {:>14.3f}\n",
+                        result.name, result.ops, result.unit,
+                        median(result.times), result.times.front());
+    cout.flush();
+  }
+
+  if (!myJsonFile.empty()) writeJson(results);
+
+  return !results.empty();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool MicroBenchRunner::selected(string_view name) const
+{
+  return name.starts_with(myFilter);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void MicroBenchRunner::addBenchmarks(vector<Benchmark>& benchmarks)
+{
+  Settings& settings = mySettings;
+  constexpr uInt64 frameCycles = 262 * 76;
+
+  if (selected("m6502.execute")) {
+    auto machine = createMachine(createRom(CPU_KERNEL), 4_KB, settings);
+    constexpr uInt64 cycles = FRAMES * frameCycles;
+
+    benchmarks.push_back({"m6502.execute", "cycle", cycles,
+        [machine, cycles]() { machine->runCycles(cycles); }});
+  }
+
+  if (selected("tia.kernel")) {
+    auto machine = createMachine(createRom(TIA_KERNEL), 4_KB, settings);
+
+    benchmarks.push_back({"tia.kernel", "frame", FRAMES,
+        [machine]() { machine->runFrames(FRAMES); }});
+  }
+
+  if (selected("state.roundtrip")) {
+    constexpr uInt32 roundtrips = 100;
+    auto machine = createMachine(createRom(TIA_KERNEL), 4_KB, settings);
+    auto state = std::make_shared<Serializer>();
+
+    machine->runFrames(1);
+    benchmarks.push_back({"state.roundtrip", "roundtrip", roundtrips,
+        [machine, state]() {
+          for (uInt32 i = 0; i < roundtrips; ++i) {
+            state->reset();
+            if (!machine->system().save(*state))
+              throw std::runtime_error("ERROR: unable to save state");
+            state->rewind();
+            if (!machine->system().load(*state))
+              throw std::runtime_error("ERROR: unable to load state");
+          }
+        }});
+  }
+
+  if (selected("audio.lanczos")) {
+    constexpr uInt32 fragments = 100, fragmentSize = 1024;
+    auto input = std::make_shared<vector<Int16>>(512 * 2);
+    Random rng(SEED);
+
+    for (Int16& sample : *input)
+      sample = static_cast<Int16>(rng.next() & 0x1fff);
+
+    auto resampler = std::make_shared<LanczosResampler>(
+        Resampler::Format(31400, 512, true),
+        Resampler::Format(48000, fragmentSize, true),
+        [input]() { return input->data(); }, 3);
+    auto output = std::make_shared<vector<float>>(fragmentSize * 2);
+
+    benchmarks.push_back({"audio.lanczos", "sample", fragments * fragmentSize,
+        [resampler, output]() {
+          for (uInt32 i = 0; i < fragments; ++i)
+            resampler->fillFragment(output->data(),
+                                    static_cast<uInt32>(output->size()));
+        }});
+  }
+
+  if (selected("audio.blep")) {
+    constexpr uInt32 fragments = 100, fragmentSize = 1024;
+    auto input = std::make_shared<vector<Int16>>(512 * 2);
+    Random rng(SEED);
+
+    // TIA output changes its level only every few samples
+    Int16 level = 0;
+    for (size_t i = 0; i < input->size(); ++i) {
+      if (i % 8 == 0)
+        level = static_cast<Int16>(rng.next() & 0x1fff);
+      (*input)[i] = level;
+    }
+
+    auto resampler = std::make_shared<BlepResampler>(
+        Resampler::Format(31400, 512, true),
+        Resampler::Format(48000, fragmentSize, true),
+        [input]() { return input->data(); });
+    auto output = std::make_shared<vector<float>>(fragmentSize * 2);
+
+    benchmarks.push_back({"audio.blep", "sample", fragments * fragmentSize,
+        [resampler, output]() {
+          for (uInt32 i = 0; i < fragments; ++i)
+            resampler->fillFragment(output->data(),
+                                    static_cast<uInt32>(output->size()));
+        }});
+  }
+
+  constexpr uInt32 width = TIAConstants::frameBufferWidth, height = 210;
+  constexpr uInt32 outWidth = AtariNTSC::outWidth(width);
+
+  if (selected("ntsc.render")) {
+    constexpr uInt32 frames = 10;
+    auto ntsc = std::make_shared<AtariNTSC>();
+    auto input = std::make_shared<vector<uInt8>>(width * height);
+    auto output = std::make_shared<vector<uInt32>>(outWidth * height);
+    Random rng(SEED);
+    PaletteArray palette;
+
+    for (uInt32& color : palette)
+      color = rng.next() & 0xffffff;
+    for (uInt8& pixel : *input)
+      pixel = static_cast<uInt8>(rng.next());
+
+    ntsc->initialize(AtariNTSC::TV_Composite);
+    ntsc->setPalette(palette);
+
+    benchmarks.push_back({"ntsc.render", "frame", frames,
+        [ntsc, input, output]() {
+          for (uInt32 i = 0; i < frames; ++i)
+            ntsc->render(input->data(), width, height, output->data(),
+                         outWidth * sizeof(uInt32));
+        }});
+  }
+
+  if (selected("phosphor.blend")) {
+    constexpr uInt32 frames = 10;
+    auto phosphor = std::make_shared<PhosphorHandler>();
+    auto current = std::make_shared<vector<uInt32>>(outWidth * height * 2);
+    auto previous = std::make_shared<vector<uInt32>>(outWidth * height);
+    Random rng(SEED);
+
+    // Two different frames are blended alternately, so the result never
+    // settles
+    for (uInt32& color : *current)
+      color = rng.next() & 0xffffff;
+    phosphor->initialize(true, 50);
+
+    benchmarks.push_back({"phosphor.blend", "frame", frames,
+        [phosphor, current, previous]() {
+          for (uInt32 i = 0; i < frames; ++i) {
+            const uInt32* in = current->data() + (i & 1) * outWidth * height;
+            uInt32* out = previous->data();
+
+            for (uInt32 y = 0; y < height; ++y)
+              PhosphorHandler::blendRow(in + y * outWidth, out + y * outWidth,
+                                        nullptr, outWidth);
+          }
+        }});
+  }
+
+  // The given ROMs are run as a whole, and included in the detection
+  auto images = std::make_shared<vector<std::pair<ByteBuffer, size_t>>>();
+
+  for (const string& romFile : myRomFiles) {
+    const FSNode node(romFile);
+    ByteBuffer image;
+    const size_t size = node.isFile() ? node.read(image) : 0;
+
+    if (size == 0)
+      throw std::runtime_error("ERROR: unable to read " + romFile);
+
+    const string name = "rom." + node.getNameWithExt("");
+    if (selected(name)) {
+      string md5 = MD5::hash(image, size);
+      const string type;
+      unique_ptr<Cartridge> cartridge = CartCreator::create(
+          node, image, size, md5, type, settings);
+      auto machine = std::make_shared<Machine>(std::move(cartridge), settings);
+
+      benchmarks.push_back({name, "frame", FRAMES,
+          [machine]() { machine->runFrames(FRAMES); }});
+    }
+    images->emplace_back(std::move(image), size);
+  }
+
+  if (selected("cart.detect")) {
+    Random rng(SEED);
+
+    for (size_t size = 2_KB; size <= 64_KB; size *= 2)
+      images->emplace_back(randomImage(rng, size), size);
+
+    benchmarks.push_back({"cart.detect", "image", images->size(),
+        [images]() {
+          for (const auto& [image, size] : *images)
+            CartDetector::autodetectType(image, size);
+        }});
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+MicroBenchRunner::Result MicroBenchRunner::measure(
+    const Benchmark& benchmark) const
+{
+  Result result{benchmark.name, benchmark.unit, benchmark.ops, {}};
+
+  // Warmup, which also fills the caches
+  benchmark.body();
+
+  result.times.reserve(myRepetitions);
+  for (uInt32 i = 0; i < myRepetitions; ++i) {
+    const auto start = steady_clock::now();
+    benchmark.body();
+    const duration<double, std::nano> elapsed = steady_clock::now() - start;
+
+    result.times.push_back(elapsed.count() / static_cast<double>(benchmark.ops));
+  }
+  std::ranges::sort(result.times);
+
+  return result;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void MicroBenchRunner::writeJson(const vector<Result>& results) const
+{
+  using json = nlohmann::json;
+
+  json benchmarks = json::array();
+
+  for (const Result& result : results) {
+    benchmarks.push_back({
+      {"name", result.name},
+      {"unit", result.unit},
+      {"ops", result.ops},
+      {"ns_per_op", {
+        {"median", median(result.times)},
+        {"min", result.times.front()},
+        {"max", result.times.back()}
+      }}
+    });
+  }
+
+  const json report = {
+    {"version", string{STELLA_VERSION}},
+    {"repetitions", myRepetitions},
+    {"benchmarks", benchmarks}
+  };
+
+  std::ofstream out(myJsonFile);
+  if (!out)
+    throw std::runtime_error("ERROR: unable to write " + myJsonFile);
+
+  out << report.dump(2) << '\n';
+}
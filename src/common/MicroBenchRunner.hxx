@@ -0,0 +1,101 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2026 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#ifndef MICRO_BENCH_RUNNER_HXX
+#define MICRO_BENCH_RUNNER_HXX
+
+#include "bspf.hxx"
+#include "Settings.hxx"
+
+/**
+  Headless runner for micro benchmarks of the emulation and rendering
+  kernels ('stella -microbench').  Unlike the ProfilingRunner, which measures
+  whole ROMs, each benchmark isolates a single hot path:
+
+    m6502.execute     CPU opcode throughput on a synthetic RAM-only loop
+    tia.kernel        TIA::cycle() driven by a synthetic playfield kernel
+    state.roundtrip   saving and loading the System state
+    audio.lanczos     LanczosResampler::fillFragment()
+    audio.blep        BlepResampler::fillFragment()
+    ntsc.render       AtariNTSC::render() of a full frame
+    phosphor.blend    PhosphorHandler::blendRow() for a full frame
+    cart.detect       CartDetector::autodetectType() on synthetic images
+
+  ROM images given on the commandline (e.g. the CDF/DPC+ ROMs from
+  test/roms/profile) are additionally run as 'rom.<name>', which mostly
+  measures the Thumbulator, and are included in 'cart.detect'.
+
+  All inputs are generated from fixed seeds, so that the results are
+  comparable between builds.  Each benchmark is run once for warmup and then
+  '-repetitions <n>' times; the median and minimum time per operation are
+  reported, and optionally written as JSON ('-json <file>').  Benchmarks can
+  be selected by name prefix ('-filter <prefix>').
+*/
+class MicroBenchRunner
+{
+  public:
+    MicroBenchRunner(int argc, char* argv[]);
+    ~MicroBenchRunner() = default;
+
+    bool run();
+
+  private:
+    struct Benchmark {
+      string name;
+      string unit;
+      uInt64 ops{0};                   // operations per repetition
+      std::function<void()> body;      // runs one repetition
+    };
+
+    struct Result {
+      string name;
+      string unit;
+      uInt64 ops{0};
+      vector<double> times;            // sorted, in nanoseconds per operation
+    };
+
+  private:
+    void addBenchmarks(vector<Benchmark>& benchmarks);
+    bool selected(string_view name) const;
+
+    Result measure(const Benchmark& benchmark) const;
+
+    void writeJson(const vector<Result>& results) const;
+
+  private:
+    vector<string> myRomFiles;
+
+    // Only run benchmarks starting with this prefix (if not empty)
+    string myFilter;
+
+    uInt32 myRepetitions{7};
+
+    // Write the results as JSON to this file (if not empty)
+    string myJsonFile;
+
+    Settings mySettings;
+
+  private:
+    // Following constructors and assignment operators not supported
+    MicroBenchRunner() = delete;
+    MicroBenchRunner(const MicroBenchRunner&) = delete;
+    MicroBenchRunner(MicroBenchRunner&&) = delete;
+    MicroBenchRunner& operator=(const MicroBenchRunner&) = delete;
+    MicroBenchRunner& operator=(MicroBenchRunner&&) = delete;
+};
+
+#endif
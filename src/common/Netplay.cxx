@@ -0,0 +1,474 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2026 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#include "Console.hxx"
+#include "Control.hxx"
+#include "DispatchResult.hxx"
+#include "EmulationTiming.hxx"
+#include "M6532.hxx"
+#include "Props.hxx"
+#include "System.hxx"
+#include "TIA.hxx"
+
+#include "Netplay.hxx"
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+Netplay::~Netplay()
+{
+  stop();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool Netplay::host(Console& console, uInt16 port)
+{
+  stop();
+  if(!mySocket.listen(port))
+    return false;
+
+  myConsole = &console;
+  myMD5 = console.properties().get(PropType::Cart_MD5);
+  myIsHost = true;
+  mySyncState.clear();
+  myIdleFrames = 0;
+  myStatus = Status::Connecting;
+
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool Netplay::join(Console& console, string_view address)
+{
+  stop();
+
+  string host{address};
+  uInt16 port = DEFAULT_PORT;
+  if(const auto colon = host.rfind(':'); colon != string::npos)
+  {
+    port = static_cast<uInt16>(BSPF::stoi(host.substr(colon + 1), DEFAULT_PORT));
+    host.erase(colon);
+  }
+  if(!mySocket.connect(host, port))
+    return false;
+
+  myConsole = &console;
+  myMD5 = console.properties().get(PropType::Cart_MD5);
+  myIsHost = false;
+  mySyncState.clear();
+  myChunks.clear();
+  myIdleFrames = RESEND_FRAMES;  // say hello immediately
+  myStatus = Status::Connecting;
+
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Netplay::stop()
+{
+  if(myStatus != Status::Off && mySocket.hasPeer())
+  {
+    Serializer out(std::span<std::byte>{myPacket});
+    startPacket(out, Packet::Quit);
+    sendPacket(out);
+  }
+  mySocket.close();
+  myStatus = Status::Off;
+  myConsole = nullptr;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Netplay::start()
+{
+  myFrame = myLocalFrames = myRemoteFrames = myRemoteAcked = 0;
+  myRollbackFrame = NO_ROLLBACK;
+  myIdleFrames = myRollbacks = 0;
+  myStatus = Status::Running;
+
+  // The states are only kept for a few frames, so large memory blocks
+  // (e.g. ARM RAM) can share their unchanged pages
+  for(auto& state: myStates)
+    state.enablePages(true);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Netplay::end(string_view message)
+{
+  mySocket.close();
+  myStatus = Status::Off;
+  myConsole = nullptr;
+  myMessage = message;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool Netplay::emulateFrame(Event& event, DispatchResult& result)
+{
+  receive();
+
+  if(myStatus == Status::Connecting)
+  {
+    // The setup packets may get lost, so they are repeated until answered
+    if(++myIdleFrames >= RESEND_FRAMES)
+    {
+      myIdleFrames = 0;
+      if(myIsHost)
+        sendState();
+      else if(mySyncState.empty())
+      {
+        Serializer out(std::span<std::byte>{myPacket});
+        startPacket(out, Packet::Hello);
+        out.putString(myMD5);
+        sendPacket(out);
+      }
+    }
+    return false;
+  }
+  if(myStatus != Status::Running)
+    return false;
+
+  if(++myIdleFrames > TIMEOUT_FRAMES)
+  {
+    end("Netplay connection lost");
+    return false;
+  }
+
+  if(myRollbackFrame < myFrame)
+    rollback(event, result);
+
+  // Never get further ahead than can be rolled back, and keep the
+  // inputs the remote player may still need
+  if(myFrame - myRemoteFrames >= MAX_ROLLBACK ||
+     myLocalFrames - myRemoteAcked >= HISTORY / 2)
+  {
+    sendInputs();
+    return false;
+  }
+
+  myLocalInputs[myFrame % HISTORY] = readInput(event);
+  myLocalFrames = myFrame + 1;
+  sendInputs();
+
+  saveState(myFrame);
+  runFrame(event, myFrame, result);
+  ++myFrame;
+
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Netplay::receive()
+{
+  size_t size = 0;
+  while(myStatus != Status::Off &&
+        (size = mySocket.receive(std::span<std::byte>{myPacket})) > 0)
+  {
+    try
+    {
+      Serializer in(std::span<const std::byte>{myPacket.data(), size});
+      if(in.getInt() == MAGIC)
+        handlePacket(in);
+    }
+    catch(...)
+    {
+      // Ignore truncated packets
+    }
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Netplay::handlePacket(Serializer& in)
+{
+  myIdleFrames = 0;
+
+  switch(static_cast<Packet>(in.getByte()))
+  {
+    case Packet::Hello:
+      if(!myIsHost || myStatus != Status::Connecting)
+        break;
+      if(in.getString() != myMD5)
+      {
+        end("Netplay client uses a different ROM");
+        break;
+      }
+      if(mySyncState.empty())
+      {
+        // Emulation doesn't continue before the client is ready
+        Serializer state;
+        myConsole->save(state);
+        mySyncState.resize(state.size());
+        state.rewind();
+        state.getByteArray(mySyncState);
+      }
+      sendState();
+      break;
+
+    case Packet::State:
+      if(!myIsHost)
+        handleState(in);
+      break;
+
+    case Packet::Ready:
+      if(myIsHost && myStatus == Status::Connecting)
+        start();
+      break;
+
+    case Packet::Input:
+    {
+      // The client only sends input once it received the state
+      if(myIsHost && myStatus == Status::Connecting && !mySyncState.empty())
+        start();
+      if(myStatus != Status::Running)
+        break;
+
+      const uInt32 acked = in.getInt();
+      myRemoteAcked = std::clamp(acked, myRemoteAcked, myLocalFrames);
+
+      const uInt32 first = in.getInt();
+      const uInt8 count = in.getByte();
+      for(uInt32 frame = first; frame < first + count; ++frame)
+      {
+        const Input input = in.getShort();
+        if(frame == myRemoteFrames)
+          confirmInput(frame, input);
+      }
+      break;
+    }
+
+    case Packet::Quit:
+      end("Remote player left netplay");
+      break;
+
+    default:
+      break;
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Netplay::handleState(Serializer& in)
+{
+  const uInt32 size = in.getInt();
+  const uInt32 offset = in.getInt();
+  const uInt16 length = in.getShort();
+
+  if(myStatus == Status::Connecting)
+  {
+    if(mySyncState.size() != size)
+    {
+      mySyncState.resize(size);
+      myChunks.assign((size + CHUNK_SIZE - 1) / CHUNK_SIZE, false);
+      myMissingChunks = static_cast<uInt32>(myChunks.size());
+    }
+    const uInt32 chunk = offset / CHUNK_SIZE;
+    if(offset % CHUNK_SIZE != 0 || chunk >= myChunks.size() ||
+       offset + length > size || myChunks[chunk])
+      return;
+
+    in.getByteArray(std::span<uInt8>{mySyncState.data() + offset, length});
+    myChunks[chunk] = true;
+    if(--myMissingChunks > 0)
+      return;
+
+    Serializer state(std::span<const std::byte>(
+      reinterpret_cast<const std::byte*>(mySyncState.data()), mySyncState.size()));
+    if(!myConsole->load(state))
+    {
+      end("Netplay state could not be loaded");
+      return;
+    }
+    start();
+  }
+
+  // Also answer repeated chunks, in case the host missed the answer
+  Serializer out(std::span<std::byte>{myPacket});
+  startPacket(out, Packet::Ready);
+  sendPacket(out);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Netplay::confirmInput(uInt32 frame, Input input)
+{
+  Input& stored = myRemoteInputs[frame % HISTORY];
+
+  // Frames already emulated used the prediction
+  if(frame < myFrame && stored != input)
+    myRollbackFrame = std::min(myRollbackFrame, frame);
+
+  stored = input;
+  ++myRemoteFrames;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Netplay::startPacket(Serializer& out, Packet type)
+{
+  out.putInt(MAGIC);
+  out.putByte(static_cast<uInt8>(type));
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Netplay::sendPacket(Serializer& out)
+{
+  mySocket.send(std::span<const std::byte>{myPacket.data(), out.position()});
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Netplay::sendState()
+{
+  const auto size = static_cast<uInt32>(mySyncState.size());
+
+  for(uInt32 offset = 0; offset < size; offset += CHUNK_SIZE)
+  {
+    const auto length = static_cast<uInt16>(std::min(CHUNK_SIZE, size - offset));
+
+    Serializer out(std::span<std::byte>{myPacket});
+    startPacket(out, Packet::State);
+    out.putInt(size);
+    out.putInt(offset);
+    out.putShort(length);
+    out.putByteArray(std::span<const uInt8>{mySyncState.data() + offset, length});
+    sendPacket(out);
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Netplay::sendInputs()
+{
+  // All inputs the remote player has not acknowledged yet are sent again,
+  // so lost packets don't need to be detected
+  Serializer out(std::span<std::byte>{myPacket});
+  startPacket(out, Packet::Input);
+  out.putInt(myRemoteFrames);
+  out.putInt(myRemoteAcked);
+  out.putByte(static_cast<uInt8>(myLocalFrames - myRemoteAcked));
+  for(uInt32 frame = myRemoteAcked; frame < myLocalFrames; ++frame)
+    out.putShort(myLocalInputs[frame % HISTORY]);
+  sendPacket(out);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Netplay::saveState(uInt32 frame)
+{
+  Serializer& state = myStates[frame % MAX_ROLLBACK];
+
+  state.reset();
+  myConsole->save(state);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Netplay::rollback(Event& event, DispatchResult& result)
+{
+  TIA& tia = myConsole->tia();
+  Serializer& state = myStates[myRollbackFrame % MAX_ROLLBACK];
+
+  state.rewind();
+  if(!myConsole->load(state))
+  {
+    end("Netplay rollback failed");
+    return;
+  }
+
+  // The frames emulated again have been heard already
+  tia.setAudioSuspended(true);
+  for(uInt32 frame = myRollbackFrame; frame < myFrame; ++frame)
+  {
+    if(frame != myRollbackFrame)
+      saveState(frame);
+    runFrame(event, frame, result);
+  }
+  tia.setAudioSuspended(false);
+
+  myRollbackFrame = NO_ROLLBACK;
+  ++myRollbacks;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Netplay::runFrame(Event& event, uInt32 frame, DispatchResult& result)
+{
+  // Predict that the remote input didn't change since the last one received
+  Input& remote = myRemoteInputs[frame % HISTORY];
+  if(frame >= myRemoteFrames)
+    remote = myRemoteFrames > 0 ? myRemoteInputs[(myRemoteFrames - 1) % HISTORY] : 0;
+
+  const Input local = myLocalInputs[frame % HISTORY];
+  if(myIsHost)
+    applyInput(event, local, remote);
+  else
+    applyInput(event, remote, local);
+
+  // Emulate in scanline steps until the frame is complete; both consoles
+  // must stop at exactly the same cycle
+  TIA& tia = myConsole->tia();
+  const System& system = myConsole->system();
+  const uInt32 frames = tia.framesSinceLastRender();
+  const uInt64 maxCycles = system.cycles() +
+    uInt64{2} * myConsole->emulationTiming().cyclesPerFrame();
+  uInt64 cycles = 0;
+
+  do
+  {
+    tia.update(result, 76);
+    cycles += result.getCycles();
+  }
+  while(result.getStatus() == DispatchResult::Status::ok &&
+        tia.framesSinceLastRender() == frames && system.cycles() < maxCycles);
+
+  if(result.getStatus() == DispatchResult::Status::ok)
+    result.setOk(cycles);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+Netplay::Input Netplay::readInput(const Event& event)
+{
+  Input input = 0;
+
+  for(size_t i = 0; i < LEFT_JOYSTICK.size(); ++i)
+    if(event.get(LEFT_JOYSTICK[i]) != 0)
+      input |= 1 << i;
+  for(size_t i = 0; i < SWITCHES.size(); ++i)
+    if(event.get(SWITCHES[i]) != 0)
+      input |= 1 << (LEFT_JOYSTICK.size() + i);
+
+  return input;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Netplay::applyInput(Event& event, Input left, Input right)
+{
+  // Pass the inputs to the controllers, but keep the local event values,
+  // they are needed to read the local input of the next frame
+  std::array<Int32, LEFT_JOYSTICK.size() + RIGHT_JOYSTICK.size() + SWITCHES.size()>
+    saved{};
+  size_t idx = 0;
+
+  const auto set = [&](Event::Type type, bool active) {
+    saved[idx++] = event.get(type);
+    event.set(type, active ? 1 : 0);
+  };
+  for(size_t i = 0; i < LEFT_JOYSTICK.size(); ++i)
+    set(LEFT_JOYSTICK[i], left & (1 << i));
+  for(size_t i = 0; i < RIGHT_JOYSTICK.size(); ++i)
+    set(RIGHT_JOYSTICK[i], right & (1 << i));
+  for(size_t i = 0; i < SWITCHES.size(); ++i)
+    set(SWITCHES[i], (left | right) & (1 << (LEFT_JOYSTICK.size() + i)));
+
+  myConsole->riot().update();
+
+  idx = 0;
+  for(const auto type: LEFT_JOYSTICK)
+    event.set(type, saved[idx++]);
+  for(const auto type: RIGHT_JOYSTICK)
+    event.set(type, saved[idx++]);
+  for(const auto type: SWITCHES)
+    event.set(type, saved[idx++]);
+}
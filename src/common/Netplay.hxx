@@ -0,0 +1,218 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2026 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#ifndef NETPLAY_HXX
+#define NETPLAY_HXX
+
+class Console;
+class DispatchResult;
+
+#include "bspf.hxx"
+#include "Event.hxx"
+#include "Serializer.hxx"
+#include "UdpSocket.hxx"
+
+/**
+  Rollback netplay for two players, connected over UDP.
+
+  The host sends its state to the client once, afterwards both consoles
+  emulate in lockstep frames and only exchange the input of each frame.
+  The host's player controls the left joystick, the client's player the
+  right one; both local players use the left joystick mappings, and both
+  can use the console switches.
+
+  To hide the network latency, the input of the remote player is not
+  waited for, but predicted to stay unchanged.  The state at the start of
+  each of the last MAX_ROLLBACK frames is kept, so when the actual input
+  arrives and differs from the prediction, the frames since then are
+  emulated again within the current frame.  A console never gets more
+  than MAX_ROLLBACK frames ahead of the input it has received.
+
+  The states are saved into Serializers which keep their buffers, so after
+  the first frames, saving and loading them doesn't allocate.  The ARM RAM
+  of CDF, BUS and ELF carts is kept as copy-on-write pages, so each state
+  only copies the pages which changed.
+
+  Both consoles must emulate deterministically: same ROM and properties,
+  and joysticks in both ports.
+
+  @author  Stella Team
+*/
+class Netplay
+{
+  public:
+    static constexpr uInt16 DEFAULT_PORT = 2600;
+    // number of frames which can be emulated again after a misprediction
+    static constexpr uInt32 MAX_ROLLBACK = 8;
+
+    enum class Status: uInt8 {
+      Off,
+      Connecting,
+      Running
+    };
+
+    Netplay() = default;
+    ~Netplay();
+
+  public:
+    /**
+      Wait for a client to connect on the given port, and send it the
+      current state of the console.
+
+      @return  False if the port can't be used
+    */
+    bool host(Console& console, uInt16 port);
+
+    /**
+      Connect to the host at the given address ('host[:port]'), and
+      replace the state of the console with the host's.
+
+      @return  False if the address can't be resolved
+    */
+    bool join(Console& console, string_view address);
+
+    /**
+      End the session, telling the remote player.
+    */
+    void stop();
+
+    Status status() const { return myStatus; }
+
+    /**
+      The reason the session ended, if it wasn't stopped locally.
+    */
+    const string& message() const { return myMessage; }
+
+    /**
+      The number of rollbacks since the session started.
+    */
+    uInt32 rollbacks() const { return myRollbacks; }
+
+    /**
+      Handle the network traffic and emulate the next frame, unless the
+      connection is being established or the remote player is too far
+      behind.  This must be called once per frame; it replaces passing the
+      event values to the controllers.
+
+      @param event   The current (local) event values
+      @param result  The result of the emulation
+
+      @return  True if a frame was emulated
+    */
+    bool emulateFrame(Event& event, DispatchResult& result);
+
+  private:
+    // The input of one player in one frame (the joystick and console
+    // switch events which are active)
+    using Input = uInt16;
+
+    enum class Packet: uInt8 {
+      Hello = 'H',  // client -> host: <ROM MD5>
+      State = 'S',  // host -> client: <size> <offset> <length> <bytes>
+      Ready = 'R',  // client -> host: state received
+      Input = 'I',  // <remote frames received> <first frame> <count> <inputs>
+      Quit  = 'Q'
+    };
+
+    static constexpr uInt32 MAGIC = 0x53744E50;  // "StNP"
+    static constexpr size_t MAX_PACKET_SIZE = 1500;
+    static constexpr uInt32 CHUNK_SIZE = 1024;
+    // inputs kept per player; more than can ever be unacknowledged
+    static constexpr uInt32 HISTORY = 64;
+    // frames between resending the connection setup packets
+    static constexpr uInt32 RESEND_FRAMES = 30;
+    // frames without any packet before the connection is considered lost
+    static constexpr uInt32 TIMEOUT_FRAMES = 600;
+    static constexpr uInt32 NO_ROLLBACK = ~0U;
+
+    static constexpr std::array<Event::Type, 7> LEFT_JOYSTICK = {
+      Event::LeftJoystickUp, Event::LeftJoystickDown, Event::LeftJoystickLeft,
+      Event::LeftJoystickRight, Event::LeftJoystickFire, Event::LeftJoystickFire5,
+      Event::LeftJoystickFire9
+    };
+    static constexpr std::array<Event::Type, 7> RIGHT_JOYSTICK = {
+      Event::RightJoystickUp, Event::RightJoystickDown, Event::RightJoystickLeft,
+      Event::RightJoystickRight, Event::RightJoystickFire, Event::RightJoystickFire5,
+      Event::RightJoystickFire9
+    };
+    static constexpr std::array<Event::Type, 8> SWITCHES = {
+      Event::ConsoleColor, Event::ConsoleBlackWhite,
+      Event::ConsoleLeftDiffA, Event::ConsoleLeftDiffB,
+      Event::ConsoleRightDiffA, Event::ConsoleRightDiffB,
+      Event::ConsoleSelect, Event::ConsoleReset
+    };
+
+    void start();
+    void end(string_view message);
+
+    void receive();
+    void handlePacket(Serializer& in);
+    void handleState(Serializer& in);
+    void confirmInput(uInt32 frame, Input input);
+
+    static void startPacket(Serializer& out, Packet type);
+    void sendPacket(Serializer& out);
+    void sendState();
+    void sendInputs();
+
+    void saveState(uInt32 frame);
+    void rollback(Event& event, DispatchResult& result);
+    void runFrame(Event& event, uInt32 frame, DispatchResult& result);
+
+    static Input readInput(const Event& event);
+    void applyInput(Event& event, Input left, Input right);
+
+  private:
+    Console* myConsole{nullptr};
+    UdpSocket mySocket;
+    Status myStatus{Status::Off};
+    bool myIsHost{false};
+    string myMD5;
+    string myMessage;
+
+    // The state sent by the host, and the chunks of it the client received
+    ByteArray mySyncState;
+    vector<bool> myChunks;
+    uInt32 myMissingChunks{0};
+
+    uInt32 myFrame{0};          // the next frame to emulate
+    uInt32 myLocalFrames{0};    // local inputs recorded
+    uInt32 myRemoteFrames{0};   // remote inputs received (without gaps)
+    uInt32 myRemoteAcked{0};    // local inputs the remote player received
+    uInt32 myRollbackFrame{NO_ROLLBACK};  // first mispredicted frame
+    uInt32 myIdleFrames{0};
+    uInt32 myRollbacks{0};
+
+    // Inputs by frame; for the remote player, frames not yet received
+    // contain the prediction they were emulated with
+    std::array<Input, HISTORY> myLocalInputs{};
+    std::array<Input, HISTORY> myRemoteInputs{};
+
+    // The states at the start of the last MAX_ROLLBACK frames
+    std::array<Serializer, MAX_ROLLBACK> myStates;
+
+    std::array<std::byte, MAX_PACKET_SIZE> myPacket{};
+
+  private:
+    // Following constructors and assignment operators not supported
+    Netplay(const Netplay&) = delete;
+    Netplay(Netplay&&) = delete;
+    Netplay& operator=(const Netplay&) = delete;
+    Netplay& operator=(Netplay&&) = delete;
+};
+
+#endif
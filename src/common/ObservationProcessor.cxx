@@ -0,0 +1,241 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2026 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+  #define OBSERVATION_SSE2
+  #include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__) || defined(_M_ARM64)
+  #define OBSERVATION_NEON
+  #include <arm_neon.h>
+#endif
+
+#include "ObservationProcessor.hxx"
+
+namespace {
+  constexpr uInt32 SRC_WIDTH = TIAConstants::frameBufferWidth;
+
+  // Add the weighted source row to the 16 bit accumulators
+  void accumulateRow(const uInt8* src, uInt16 weight, uInt16* acc)
+  {
+    uInt32 x = 0;
+
+  #if defined(OBSERVATION_SSE2)
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i w = _mm_set1_epi16(static_cast<short>(weight));
+    for(; x + 16 <= SRC_WIDTH; x += 16)
+    {
+      const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + x));
+      auto* a = reinterpret_cast<__m128i*>(acc + x);
+      _mm_storeu_si128(a, _mm_add_epi16(_mm_loadu_si128(a),
+                       _mm_mullo_epi16(_mm_unpacklo_epi8(v, zero), w)));
+      _mm_storeu_si128(a + 1, _mm_add_epi16(_mm_loadu_si128(a + 1),
+                       _mm_mullo_epi16(_mm_unpackhi_epi8(v, zero), w)));
+    }
+  #elif defined(OBSERVATION_NEON)
+    const uint16x8_t w = vdupq_n_u16(weight);
+    for(; x + 16 <= SRC_WIDTH; x += 16)
+    {
+      const uint8x16_t v = vld1q_u8(src + x);
+      vst1q_u16(acc + x, vmlaq_u16(vld1q_u16(acc + x),
+                                   vmovl_u8(vget_low_u8(v)), w));
+      vst1q_u16(acc + x + 8, vmlaq_u16(vld1q_u16(acc + x + 8),
+                                       vmovl_u8(vget_high_u8(v)), w));
+    }
+  #endif
+    for(; x < SRC_WIDTH; ++x)
+      acc[x] += src[x] * weight;
+  }
+
+  // dst = max(a, b)
+  void maxBytes(const uInt8* a, const uInt8* b, uInt8* dst, size_t count)
+  {
+    size_t i = 0;
+
+  #if defined(OBSERVATION_SSE2)
+    for(; i + 16 <= count; i += 16)
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_max_epu8(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i)),
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i))));
+  #elif defined(OBSERVATION_NEON)
+    for(; i + 16 <= count; i += 16)
+      vst1q_u8(dst + i, vmaxq_u8(vld1q_u8(a + i), vld1q_u8(b + i)));
+  #endif
+    for(; i < count; ++i)
+      dst[i] = std::max(a[i], b[i]);
+  }
+} // namespace
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+ObservationProcessor::ObservationProcessor(const Config& config)
+  : myConfig{config}
+{
+  myConfig.width = std::max(myConfig.width, 1U);
+  myConfig.height = std::max(myConfig.height, 1U);
+  myConfig.stack = std::max(myConfig.stack, 1U);
+
+  myGray.resize(static_cast<size_t>(SRC_WIDTH) * TIAConstants::frameBufferHeight);
+  myPrevGray.resize(myGray.size());
+  myFrames.resize(observationSize());
+
+  calculateTaps(myHTaps, SRC_WIDTH, myConfig.width);
+
+  // Until a palette is set, use the luminance bits of the TIA colors
+  for(uInt32 i = 0; i < myGrayLUT.size(); ++i)
+    myGrayLUT[i] = static_cast<uInt8>((i & 0x0e) * 255 / 14);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void ObservationProcessor::setPalette(const PaletteArray& rgbPalette)
+{
+  for(uInt32 i = 0; i < myGrayLUT.size(); ++i)
+  {
+    const uInt32 r = (rgbPalette[i] >> 16) & 0xff;
+    const uInt32 g = (rgbPalette[i] >> 8) & 0xff;
+    const uInt32 b =  rgbPalette[i] & 0xff;
+
+    // ITU-R BT.601 luma, like the grayscale conversion of OpenCV
+    myGrayLUT[i] = static_cast<uInt8>((r * 299 + g * 587 + b * 114 + 500) / 1000);
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void ObservationProcessor::reset()
+{
+  myLines = myPrevLines = 0;
+  myEmpty = true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void ObservationProcessor::process(const uInt8* frame, uInt32 lines, uInt8* out)
+{
+  toGrayscale(frame, lines);
+
+  // Objects which are only drawn every other frame must not disappear
+  if(myConfig.maxPool && myPrevLines == myLines)
+    maxBytes(myGray.data(), myPrevGray.data(), myPrevGray.data(),
+             static_cast<size_t>(SRC_WIDTH) * myLines);
+
+  const size_t frameSize = static_cast<size_t>(myConfig.width) * myConfig.height;
+
+  // Replace the oldest frame by the new one; after a reset, fill all
+  if(myEmpty)
+    myOldest = 0;
+  uInt8* newest = myFrames.data() + frameSize * myOldest;
+  downscale(newest);
+  if(myEmpty)
+  {
+    for(uInt32 i = 1; i < myConfig.stack; ++i)
+      std::copy_n(newest, frameSize, myFrames.data() + frameSize * i);
+    myEmpty = false;
+  }
+  else
+    myOldest = (myOldest + 1) % myConfig.stack;
+
+  for(uInt32 i = 0; i < myConfig.stack; ++i)
+    std::copy_n(myFrames.data() + frameSize * ((myOldest + i) % myConfig.stack),
+                frameSize, out + frameSize * i);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void ObservationProcessor::addFrame(const uInt8* frame, uInt32 lines)
+{
+  toGrayscale(frame, lines);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void ObservationProcessor::calculateTaps(Taps& taps, uInt32 srcSize,
+                                         uInt32 dstSize)
+{
+  // Area averaging: output pixel i covers the source interval
+  // [i * srcSize / dstSize, (i + 1) * srcSize / dstSize).  The weights are
+  // the rounded differences of the scaled positions, so that they always
+  // add up to exactly 256.
+  const auto scaled = [&](uInt64 pos) {  // pos in source pixels * dstSize
+    return static_cast<uInt32>((pos * 256 + srcSize / 2) / srcSize);
+  };
+
+  taps.first.clear();
+  taps.offset.clear();
+  taps.weights.clear();
+
+  for(uInt32 i = 0; i < dstSize; ++i)
+  {
+    const uInt64 start = static_cast<uInt64>(i) * srcSize,
+                 end = start + srcSize;
+    const auto first = static_cast<uInt32>(start / dstSize);
+
+    taps.first.push_back(first);
+    taps.offset.push_back(static_cast<uInt32>(taps.weights.size()));
+    for(uInt32 j = first; static_cast<uInt64>(j) * dstSize < end; ++j)
+    {
+      const uInt64 from = std::max(start, static_cast<uInt64>(j) * dstSize),
+                   to = std::min(end, static_cast<uInt64>(j + 1) * dstSize);
+      taps.weights.push_back(static_cast<uInt16>(scaled(to) - scaled(from)));
+    }
+  }
+  taps.offset.push_back(static_cast<uInt32>(taps.weights.size()));
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void ObservationProcessor::toGrayscale(const uInt8* frame, uInt32 lines)
+{
+  std::swap(myGray, myPrevGray);
+  myPrevLines = myLines;
+  myLines = std::clamp(lines, 1U, TIAConstants::frameBufferHeight);
+
+  const size_t size = static_cast<size_t>(SRC_WIDTH) * myLines;
+  for(size_t i = 0; i < size; ++i)
+    myGray[i] = myGrayLUT[frame[i]];
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void ObservationProcessor::downscale(uInt8* dst)
+{
+  // Max-pooling has written the combined frame into myPrevGray
+  const uInt8* src = myConfig.maxPool && myPrevLines == myLines
+    ? myPrevGray.data() : myGray.data();
+
+  if(myVTapsLines != myLines)
+  {
+    calculateTaps(myVTaps, myLines, myConfig.height);
+    myVTapsLines = myLines;
+  }
+
+  std::array<uInt16, SRC_WIDTH> acc{};
+
+  for(uInt32 y = 0; y < myConfig.height; ++y)
+  {
+    // Vertical pass (SIMD), 8.8 fixed point
+    acc.fill(0);
+    const uInt16* vw = myVTaps.weights.data() + myVTaps.offset[y];
+    for(uInt32 k = 0; k < myVTaps.count(y); ++k)
+      accumulateRow(src + static_cast<size_t>(myVTaps.first[y] + k) * SRC_WIDTH,
+                    vw[k], acc.data());
+
+    // Horizontal pass, the result has 16 fractional bits
+    for(uInt32 x = 0; x < myConfig.width; ++x)
+    {
+      const uInt16* hw = myHTaps.weights.data() + myHTaps.offset[x];
+      const uInt16* a = acc.data() + myHTaps.first[x];
+      uInt32 sum = 1U << 15;
+      for(uInt32 k = 0; k < myHTaps.count(x); ++k)
+        sum += static_cast<uInt32>(a[k]) * hw[k];
+      *dst++ = static_cast<uInt8>(sum >> 16);
+    }
+  }
+}
@@ -0,0 +1,129 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2026 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+
+#ifndef OBSERVATION_PROCESSOR_HXX
+#define OBSERVATION_PROCESSOR_HXX
+
+#include "FrameBufferConstants.hxx"
+#include "TIAConstants.hxx"
+#include "bspf.hxx"
+
+/**
+  Converts the TIA frame buffer (palette indices) into the observations
+  commonly used for reinforcement learning: each frame is converted to
+  grayscale through a lookup table, max-pooled with the previous frame
+  (to remove flicker), downscaled by area averaging (e.g. to 84x84), and
+  the last few results are stacked.
+
+  Working on the palette indices avoids expanding each frame to RGB first.
+  The results are written into buffers provided by the caller, laid out as
+  'stack' planes of 'width' x 'height' bytes, oldest frame first.
+
+  @author  Stella Team
+*/
+class ObservationProcessor
+{
+  public:
+    struct Config {
+      uInt32 width{84};
+      uInt32 height{84};
+      uInt32 stack{4};       // number of frames per observation
+      bool maxPool{true};    // max-pool with the previous frame
+    };
+
+  public:
+    explicit ObservationProcessor(const Config& config);
+    ~ObservationProcessor() = default;
+
+    /**
+      Set the palette used for the grayscale conversion.
+
+      @param rgbPalette  The 256 colors in R/G/B format
+    */
+    void setPalette(const PaletteArray& rgbPalette);
+
+    // Bytes required for one (stacked) observation
+    size_t observationSize() const {
+      return static_cast<size_t>(myConfig.width) * myConfig.height * myConfig.stack;
+    }
+
+    /**
+      Forget the previous frames, e.g. at the start of an episode.  The next
+      frame then fills the whole stack.
+    */
+    void reset();
+
+    /**
+      Add a frame and write the resulting observation.
+
+      @param frame  The palette indices, TIAConstants::frameBufferWidth wide
+      @param lines  The number of scanlines of the frame
+      @param out    Receives observationSize() bytes
+    */
+    void process(const uInt8* frame, uInt32 lines, uInt8* out);
+
+    /**
+      Add a frame which is only used for max-pooling with the next one,
+      e.g. the second to last frame when frames are skipped.
+    */
+    void addFrame(const uInt8* frame, uInt32 lines);
+
+  private:
+    // The source pixels and 8 bit weights (summing up to 256) of each
+    // output pixel, for one direction
+    struct Taps {
+      vector<uInt32> first;    // first source pixel of each output pixel
+      vector<uInt32> offset;   // offset of the first weight of each output pixel
+      vector<uInt16> weights;
+
+      uInt32 count(uInt32 i) const { return offset[i + 1] - offset[i]; }
+    };
+
+  private:
+    static void calculateTaps(Taps& taps, uInt32 srcSize, uInt32 dstSize);
+
+    void toGrayscale(const uInt8* frame, uInt32 lines);
+    void downscale(uInt8* dst);
+
+  private:
+    Config myConfig;
+
+    std::array<uInt8, 256> myGrayLUT{};
+
+    // The current and the previous frame in grayscale
+    ByteArray myGray, myPrevGray;
+    uInt32 myLines{0}, myPrevLines{0};
+
+    Taps myHTaps, myVTaps;
+    uInt32 myVTapsLines{0};  // source lines myVTaps was calculated for
+
+    // Ring buffer of downscaled frames, and the position of the oldest one
+    ByteArray myFrames;
+    uInt32 myOldest{0};
+    bool myEmpty{true};
+
+  private:
+    // Following constructors and assignment operators not supported
+    ObservationProcessor() = delete;
+    ObservationProcessor(const ObservationProcessor&) = delete;
+    ObservationProcessor(ObservationProcessor&&) = delete;
+    ObservationProcessor& operator=(const ObservationProcessor&) = delete;
+    ObservationProcessor& operator=(ObservationProcessor&&) = delete;
+};
+
+#endif
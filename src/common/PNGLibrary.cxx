@@ -33,9 +33,74 @@ PNGLibrary::PNGLibrary(OSystem& osystem)
 {
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+PNGLibrary::~PNGLibrary()
+{
+  // Queued snapshots are still written before the thread exits
+  {
+    const std::scoped_lock lock(myImageMutex);
+    myQuitWriter = true;
+  }
+  myImageQueued.notify_one();
+
+  if(myWriterThread.joinable())
+    myWriterThread.join();
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void PNGLibrary::loadImage(string_view filename, FBSurface& surface,
                            VariantList& metaData)
+{
+  readImage(filename, metaData, [&](uInt32 width, uInt32 height) {
+    // First determine if we need to resize the surface
+    if(width > surface.width() || height > surface.height())
+      surface.resize(width, height);
+
+    // The source dimensions are set here; the destination dimensions are
+    // set by whoever owns the surface
+    surface.setSrcPos(0, 0);
+    surface.setSrcSize(width, height);
+    myRowPointers.resize(height);
+
+    // Format is SDL_PIXELFORMAT_ARGB8888
+    uInt32* base{};
+    uInt32 pitch{};
+    surface.basePtr(base, pitch);
+
+    // Set row pointers into surface buffer
+    const uInt32 rowStride = pitch * sizeof(uInt32);
+    png_bytep* dst = myRowPointers.data();  // NOLINT(misc-const-correctness)
+    auto*      row = reinterpret_cast<png_bytep>(base);
+    for(uInt32 y = 0; y < height; ++y, row += rowStride)
+      *dst++ = row;
+
+    return std::span<png_bytep>(myRowPointers);
+  });
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void PNGLibrary::loadImage(string_view filename, vector<uInt32>& pixels,
+                           uInt32& width, uInt32& height, VariantList& metaData)
+{
+  vector<png_bytep> rowPointers;
+
+  readImage(filename, metaData, [&](uInt32 w, uInt32 h) {
+    width = w;
+    height = h;
+    pixels.resize(static_cast<size_t>(w) * h);
+
+    rowPointers.resize(h);
+    for(uInt32 y = 0; y < h; ++y)
+      rowPointers[y] = reinterpret_cast<png_bytep>(pixels.data() +
+                                                   static_cast<size_t>(y) * w);
+
+    return std::span<png_bytep>(rowPointers);
+  });
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void PNGLibrary::readImage(string_view filename, VariantList& metaData,
+                           const RowsFunc& getRows)
 {
   png_structp png_ptr{nullptr};
   png_infop info_ptr{nullptr};
@@ -105,30 +170,11 @@ void PNGLibrary::loadImage(string_view filename, FBSurface& surface,
   png_set_bgr(png_ptr);
   png_read_update_info(png_ptr, info_ptr);
 
-  // First determine if we need to resize the surface
-  if(width > surface.width() || height > surface.height())
-    surface.resize(width, height);
-
-  // The source dimensions are set here; the destination dimensions are
-  // set by whoever owns the surface
-  surface.setSrcPos(0, 0);
-  surface.setSrcSize(width, height);
-  myRowPointers.resize(height);
-
-  // Format is SDL_PIXELFORMAT_ARGB8888
-  uInt32* base{};
-  uInt32 pitch{};
-  surface.basePtr(base, pitch);
+  // Let the caller provide the destination rows
+  const std::span<png_bytep> rows = getRows(width, height);
 
-  // Set row pointers into surface buffer
-  const uInt32 rowStride = pitch * sizeof(uInt32);
-  png_bytep* dst = myRowPointers.data();  // NOLINT(misc-const-correctness)
-  auto*      row = reinterpret_cast<png_bytep>(base);
-  for(uInt32 y = 0; y < height; ++y, row += rowStride)
-    *dst++ = row;
-
-  // And read directly into the surface buffer
-  png_read_image(png_ptr, myRowPointers.data());
+  // And read directly into them
+  png_read_image(png_ptr, rows.data());
 
   // We're finished reading
   png_read_end(png_ptr, info_ptr);
@@ -144,7 +190,7 @@ void PNGLibrary::loadImage(string_view filename, FBSurface& surface,
     // Swap ARGB32 -> ABGR32 on big-endian CPUs
     for(uInt32 y = 0; y < height; ++y)
     {
-      auto* row = reinterpret_cast<uInt32*>(myRowPointers[y]);
+      auto* row = reinterpret_cast<uInt32*>(rows[y]);
       for(uInt32 x = 0; x < width; ++x)
         row[x] = byteswap<uInt32>(row[x]);
     }
@@ -187,35 +233,130 @@ void PNGLibrary::saveImage(string_view filename, const VariantList& metaData)
 #endif
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void PNGLibrary::saveImage(string_view filename, std::span<uInt32> pixels,
+                           uInt32 width, uInt32 height,
+                           const VariantList& metaData)
+{
+  vector<png_bytep> rowPointers(height);
+  for(uInt32 y = 0; y < height; ++y)
+    rowPointers[y] = reinterpret_cast<png_bytep>(pixels.data() +
+                                                 static_cast<size_t>(y) * width);
+
+  std::ofstream out(string{filename}, std::ios_base::binary);
+  if(!out.is_open())
+    throw std::runtime_error("ERROR: Couldn't create image file");
+
+  saveImageToDisk(out, std::span<png_bytep>(rowPointers), width, height, metaData);
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void PNGLibrary::saveImage(const FSNode& filename, const FBSurface& surface,
                            const Common::Rect& rect, const VariantList& metaData)
 {
-#if 0
-  size_t width = rect.w(), height = rect.h();
+  ImageJob job;
+  job.width = rect.w();
+  job.height = rect.h();
   if(rect.empty())
   {
-    width  = surface.width();
-    height = surface.height();
+    job.width  = surface.width();
+    job.height = surface.height();
   }
+  job.filename = filename.getPath();
+  job.metaData = metaData;
 
-  const size_t bufferSize = width * height * 4;
-  if(bufferSize > myPNGReadBuffer.size())
-    myPNGReadBuffer.resize(bufferSize);
+  // Reuse the buffer of an already written snapshot, if available
+  {
+    const std::scoped_lock lock(myImageMutex);
+    if(!myFreeBuffers.empty())
+    {
+      job.pixels = std::move(myFreeBuffers.back());
+      myFreeBuffers.pop_back();
+    }
+  }
+  job.pixels.resize(job.width * job.height * 4);
 
-  surface.readPixels(myPNGReadBuffer.data(), static_cast<uInt32>(width), rect);
+  // Only the copy is done here; everything else happens in the background
+  surface.readPixels(job.pixels.data(), static_cast<uInt32>(job.width), rect);
 
-  // Create a span of row pointers
-  std::vector<png_bytep> rowPointers(height);
-  for(size_t y = 0; y < height; ++y)
-    rowPointers[y] = myPNGReadBuffer.data() + y * width * 4;
+  queueImage(std::move(job));
+}
 
-  std::ofstream out(string{filename}, std::ios_base::binary);
-  if(!out.is_open())
-    throw std::runtime_error("ERROR: Couldn't create snapshot file");
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void PNGLibrary::queueImage(ImageJob&& job)
+{
+  std::unique_lock lock(myImageMutex);
 
-  saveImageToDisk(out, std::span<png_bytep>(rowPointers), width, height, metaData);
-#endif
+  if(!myWriterThread.joinable())
+    myWriterThread = std::thread(&PNGLibrary::writerThread, this);
+
+  // Wait instead of dropping snapshots when the writer can't keep up
+  myImageWritten.wait(lock, [this] {
+    return myImageQueue.size() < MAX_QUEUED_IMAGES;
+  });
+  myImageQueue.push_back(std::move(job));
+
+  lock.unlock();
+  myImageQueued.notify_one();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool PNGLibrary::imagePending(string_view filename)
+{
+  const std::scoped_lock lock(myImageMutex);
+
+  return myWritingImage == filename ||
+    std::ranges::any_of(myImageQueue, [filename](const ImageJob& job) {
+      return job.filename == filename;
+    });
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void PNGLibrary::writerThread()
+{
+  vector<png_bytep> rowPointers;
+
+  std::unique_lock lock(myImageMutex);
+  for(;;)
+  {
+    myImageQueued.wait(lock, [this] {
+      return !myImageQueue.empty() || myQuitWriter;
+    });
+    if(myImageQueue.empty())
+      break;
+
+    ImageJob job = std::move(myImageQueue.front());
+    myImageQueue.pop_front();
+    myWritingImage = job.filename;
+    lock.unlock();
+
+    string error;
+    try
+    {
+      rowPointers.resize(job.height);
+      for(size_t y = 0; y < job.height; ++y)
+        rowPointers[y] = job.pixels.data() + y * job.width * 4;
+
+      std::ofstream out(job.filename, std::ios_base::binary);
+      if(!out.is_open())
+        throw std::runtime_error("ERROR: Couldn't create snapshot file");
+
+      saveImageToDisk(out, std::span<png_bytep>(rowPointers),
+                      job.width, job.height, job.metaData);
+    }
+    catch(const std::runtime_error& e)
+    {
+      error = e.what();
+    }
+
+    lock.lock();
+    if(!error.empty())
+      myImageError = error;
+    myWritingImage.clear();
+    if(myFreeBuffers.size() < MAX_QUEUED_IMAGES)
+      myFreeBuffers.push_back(std::move(job.pixels));
+    myImageWritten.notify_all();
+  }
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -375,14 +516,15 @@ void PNGLibrary::takeSnapshot(uInt32 number)
     // Determine if the file already exists, checking each successive filename
     // until one doesn't exist
     filename = sspath + ".png";
+    // Snapshots which are still being written don't exist yet
     const FSNode node(filename);
-    if(node.exists())
+    if(node.exists() || imagePending(filename))
     {
       for(uInt32 i = 1; ; ++i)
       {
         filename = std::format("{}_{}.png", sspath, i);
         const FSNode next(filename);
-        if(!next.exists())
+        if(!next.exists() && !imagePending(filename))
           break;
       }
     }
@@ -402,8 +544,16 @@ void PNGLibrary::takeSnapshot(uInt32 number)
   VarList::push_back(metaData, "ROM MD5", myOSystem.console().properties().get(PropType::Cart_MD5));
   VarList::push_back(metaData, "TV Effects", myOSystem.frameBuffer().tiaSurface().effectsInfo());
 
-  // Now create a PNG snapshot
+  // Now create a PNG snapshot, reporting a failure of the previous one first
   string message = "Snapshot saved";
+  {
+    const std::scoped_lock lock(myImageMutex);
+    if(!myImageError.empty())
+    {
+      message = myImageError;
+      myImageError.clear();
+    }
+  }
   if(myOSystem.settings().getBool("ss1x"))
   {
     try
@@ -23,6 +23,11 @@
 #include <fstream>
 #include <span>
 #include <bit>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
 #include <png.h>
 
 #include "bspf.hxx"
@@ -42,7 +47,7 @@ class PNGLibrary
 {
   public:
     explicit PNGLibrary(OSystem& osystem);
-    ~PNGLibrary() = default;
+    ~PNGLibrary();
 
     /**
       Read a PNG image from the specified file into a FBSurface structure,
@@ -59,6 +64,23 @@ class PNGLibrary
     void loadImage(string_view filename, FBSurface& surface,
                    VariantList& metaData);
 
+    /**
+      Read a PNG image from the specified file into a pixel buffer, in its
+      original size.  Unlike the method above, this may be called from any
+      thread.
+
+      @param filename  The filename to load the PNG image
+      @param pixels    The ARGB8888 image data, 'width' pixels per row
+      @param width     The width of the PNG image
+      @param height    The height of the PNG image
+      @param metaData  The meta data of the PNG image
+
+      @post  On failure, a std::runtime_error is thrown containing a more
+             detailed error message.
+    */
+    static void loadImage(string_view filename, vector<uInt32>& pixels,
+                          uInt32& width, uInt32& height, VariantList& metaData);
+
     /**
       Save the current FrameBuffer image to a PNG file.  Note that in most
       cases this will be a TIA image, but it could actually be used for
@@ -75,21 +97,42 @@ class PNGLibrary
                    const VariantList& metaData = VariantList{});
 
     /**
-      Save the given surface to a PNG file.
+      Save the given surface to a PNG file.  The pixels are copied
+      immediately, while compressing and writing the image happens on a
+      background thread.  If too many images are still waiting to be
+      written, this blocks until one of them has been finished.
 
       @param filename  The filename to save the PNG image
       @param surface   The surface data for the PNG image
       @param rect      The area of the surface to use
       @param metaData  The meta data to add to the PNG image
 
-      @post  On success, the PNG file has been saved to 'filename',
-             otherwise a std::runtime_error is thrown containing a
-             more detailed error message.
+      @post  On success, the PNG file has been queued for 'filename'.
+             Errors while writing it are reported by the next call to
+             takeSnapshot().
     */
     void saveImage(const FSNode& filename, const FBSurface& surface,
                    const Common::Rect& rect = Common::Rect{},
                    const VariantList& metaData = VariantList{});
 
+    /**
+      Save the given pixel buffer to a PNG file, on the calling thread.
+      This may be called from any thread.
+
+      @param filename  The filename to save the PNG image
+      @param pixels    The ARGB8888 image data, 'width' pixels per row;
+                       this is consumed on big-endian architectures
+      @param width     The width of the PNG image
+      @param height    The height of the PNG image
+      @param metaData  The meta data to add to the PNG image
+
+      @post  On failure, a std::runtime_error is thrown containing a more
+             detailed error message.
+    */
+    static void saveImage(string_view filename, std::span<uInt32> pixels,
+                          uInt32 width, uInt32 height,
+                          const VariantList& metaData = VariantList{});
+
     /**
       Called at regular intervals, and used to determine whether a
       continuous snapshot is due to be taken.
@@ -132,6 +175,17 @@ class PNGLibrary
     void takeSnapshot(uInt32 number = 0);
 
   private:
+    // A snapshot waiting to be written by the background thread
+    struct ImageJob {
+      string filename;
+      ByteArray pixels;  // ARGB8888, 'width' pixels per row
+      size_t width{0}, height{0};
+      VariantList metaData;
+    };
+
+    // Maximum number of snapshots waiting to be written
+    static constexpr size_t MAX_QUEUED_IMAGES = 4;
+
     // Global OSystem object
     OSystem& myOSystem;
 
@@ -143,6 +197,46 @@ class PNGLibrary
     // calls to loadImage() and saveImage() to avoid repeated heap allocation.
     vector<png_bytep> myRowPointers;
 
+    // Snapshots waiting to be written, and the buffers of finished ones
+    // for reuse; all protected by myImageMutex
+    std::deque<ImageJob> myImageQueue;
+    vector<ByteArray> myFreeBuffers;
+    string myWritingImage;  // filename currently being written, if any
+    string myImageError;  // last error of the background thread
+    bool myQuitWriter{false};
+    std::mutex myImageMutex;
+    std::condition_variable myImageQueued, myImageWritten;
+    std::thread myWriterThread;
+
+    /**
+      Queue a snapshot for the background thread, starting it on first use.
+    */
+    void queueImage(ImageJob&& job);
+
+    /**
+      Answer whether an image with the given name is waiting to be written.
+    */
+    bool imagePending(string_view filename);
+
+    /**
+      The background thread, compressing and writing queued snapshots.
+    */
+    void writerThread();
+
+    // Provides the destination rows for an image of the given size
+    using RowsFunc =
+      std::function<std::span<png_bytep>(uInt32 width, uInt32 height)>;
+
+    /**
+      The actual method which reads a PNG image.
+
+      @param filename  The filename to load the PNG image
+      @param metaData  The meta data of the PNG image
+      @param getRows   Called once the size of the image is known
+    */
+    static void readImage(string_view filename, VariantList& metaData,
+                          const RowsFunc& getRows);
+
     /**
       The actual method which saves a PNG image.
 
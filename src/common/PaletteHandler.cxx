@@ -215,7 +215,6 @@ void PaletteHandler::changeColorPhaseShift(int direction)
     else
       myPhasePAL = newPhase;
 
-    generateCustomPalette(timing);
     setPalette(SETTING_CUSTOM);
 
     showAdjustableMessage();
@@ -336,10 +335,49 @@ void PaletteHandler::setPalette()
     // Now consider the current display format
     const PaletteArray* palette = palettes[paletteType][static_cast<int>(timing)];
 
-    if(paletteType == PaletteType::Custom)
-      generateCustomPalette(timing);
+    if(paletteType == PaletteType::User)
+    {
+      myOSystem.frameBuffer().setTIAPalette(adjustedPalette(*palette));
+      return;
+    }
+
+    const PaletteKey key = paletteKey(paletteType, timing);
+    const auto it = std::ranges::find(myPaletteCache, key, &CachedPalette::key);
+    if(it != myPaletteCache.end())
+      std::rotate(myPaletteCache.begin(), it, it + 1);
+    else
+    {
+      if(paletteType == PaletteType::Custom)
+        generateCustomPalette(timing);
+
+      if(myPaletteCache.size() == PALETTE_CACHE_SIZE)
+        myPaletteCache.pop_back();
+      myPaletteCache.insert(myPaletteCache.begin(), {key, adjustedPalette(*palette)});
+    }
+    myOSystem.frameBuffer().setTIAPalette(myPaletteCache.front().palette);
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+PaletteHandler::PaletteKey PaletteHandler::paletteKey(PaletteType type,
+                                                      ConsoleTiming timing) const
+{
+  return { type, timing, {
+    myPhaseNTSC, myPhasePAL,
+    myRedScale, myGreenScale, myBlueScale,
+    myRedShift, myGreenShift, myBlueShift,
+    myHue, mySaturation, myContrast, myBrightness, myGamma
+  } };
+}
 
-    myOSystem.frameBuffer().setTIAPalette(adjustedPalette(*palette));
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+const PaletteArray& PaletteHandler::standardPalette(ConsoleTiming timing)
+{
+  switch(timing)
+  {
+    case ConsoleTiming::pal:    return ourPALPalette;
+    case ConsoleTiming::secam:  return ourSECAMPalette;
+    default:                    return ourNTSCPalette;
   }
 }
 
@@ -121,6 +121,12 @@ class PaletteHandler
     */
     void setPalette();
 
+    /**
+      The unadjusted standard palette for the given timing (e.g. for
+      consoles without an OSystem).
+    */
+    static const PaletteArray& standardPalette(ConsoleTiming timing);
+
 
   private:
     static constexpr char DEGREE = 0x1c;
@@ -254,6 +260,24 @@ class PaletteHandler
 
   private:
     static constexpr int NUM_ADJUSTABLES = 12;
+    // Number of adjusted palettes remembered
+    static constexpr size_t PALETTE_CACHE_SIZE = 16;
+
+    // Everything an adjusted palette depends on (except for the contents
+    // of a user palette, which are therefore not cached)
+    struct PaletteKey {
+      PaletteType type{PaletteType::Standard};
+      ConsoleTiming timing{ConsoleTiming::ntsc};
+      std::array<float, NUM_ADJUSTABLES + 1> values{};
+
+      bool operator==(const PaletteKey&) const = default;
+    };
+    struct CachedPalette {
+      PaletteKey key;
+      PaletteArray palette;
+    };
+
+    PaletteKey paletteKey(PaletteType type, ConsoleTiming timing) const;
 
     OSystem& myOSystem;
 
@@ -304,6 +328,10 @@ class PaletteHandler
     // successfully loaded
     bool myUserPaletteDefined{false};
 
+    // Recently adjusted palettes, most recently used first; moving a slider
+    // back and forth during color tuning mostly hits these
+    vector<CachedPalette> myPaletteCache;
+
     // Table of RGB values for NTSC, PAL and SECAM
     static const PaletteArray ourNTSCPalette;
     static const PaletteArray ourPALPalette;
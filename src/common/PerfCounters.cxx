@@ -0,0 +1,90 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2026 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#include <fstream>
+
+#include "PerfCounters.hxx"
+
+namespace {
+  constexpr std::array<string_view, PerfCounters::NUM_IDS> NAMES = {
+    "m6502", "tia", "arm", "tiasurface", "ntsc", "audiocallback", "audioqueue"
+  };
+
+  std::ofstream ourDump;
+  uInt64 ourFrameNumber{0};
+} // namespace
+
+PerfCounters::Frame PerfCounters::ourLastFrame;
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void PerfCounters::endFrame(uInt32 frames)
+{
+  using namespace std::chrono;
+
+  ourLastFrame.frames = frames;
+  for(size_t i = 0; i < NUM_IDS; ++i)
+  {
+    const steady_clock::duration time(static_cast<steady_clock::rep>(
+      ourCounters[i].exchange(0, std::memory_order_relaxed)));
+
+    ourLastFrame.time[i] = duration<double, std::micro>(time).count();
+  }
+
+  if(ourDump.is_open())
+  {
+    ourDump << ++ourFrameNumber << ',' << frames;
+    for(const double time: ourLastFrame.time)
+      ourDump << ',' << std::format("{:.1f}", time);
+    ourDump << '\n';
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+string PerfCounters::summary()
+{
+  const auto& t = ourLastFrame.time;
+  const auto ms = [&t](Id id) { return t[static_cast<size_t>(id)] / 1000; };
+
+  // TIA and ARM code run inside the 6507 scope
+  const double cpu = std::max(ms(Id::M6502) - ms(Id::TIA) - ms(Id::ARM), 0.);
+
+  return std::format("CPU {:.2f} TIA {:.2f} ARM {:.2f} Vid {:.2f} Aud {:.2f}ms",
+                     cpu, ms(Id::TIA), ms(Id::ARM),
+                     ms(Id::TIASurface), ms(Id::AudioCallback));
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void PerfCounters::setDumpFile(string_view filename)
+{
+  if(ourDump.is_open())
+    ourDump.close();
+  ourFrameNumber = 0;
+
+  if(filename.empty())
+    return;
+
+  ourDump.open(string{filename}, std::ios::out | std::ios::trunc);
+  if(ourDump.is_open())
+  {
+    // All times in microseconds; TIA and ARM are part of m6502,
+    // ntsc is part of tiasurface
+    ourDump << "frame,frames";
+    for(const auto& name: NAMES)
+      ourDump << ',' << name;
+    ourDump << '\n';
+  }
+}
@@ -0,0 +1,127 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2026 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+#ifndef PERF_COUNTERS_HXX
+#define PERF_COUNTERS_HXX
+
+#include <atomic>
+#include <chrono>
+
+#include "bspf.hxx"
+
+/**
+  Timing counters for the hot paths of the emulation, rendering and audio
+  pipelines.  They are only compiled in when PERF_COUNTERS is defined
+  (configure --enable-perfcounters); otherwise PERF_SCOPE expands to nothing.
+
+  Scopes may be entered from any thread and nest (e.g. TIA and ARM time is
+  also part of the 6507 time).  The times are aggregated until endFrame() is
+  called for each displayed frame, and can be shown in the frame stats
+  overlay and dumped to a CSV file.
+
+  @author  Stella Team
+*/
+class PerfCounters
+{
+  public:
+    enum class Id: uInt8 {
+      M6502, TIA, ARM, TIASurface, NTSC, AudioCallback, AudioQueue,
+      NumIds
+    };
+    static constexpr size_t NUM_IDS = static_cast<size_t>(Id::NumIds);
+
+    // Times per displayed frame, in microseconds
+    struct Frame {
+      uInt32 frames{0};  // emulated frames
+      std::array<double, NUM_IDS> time{};
+    };
+
+    /**
+      Measures the time between construction and destruction.
+    */
+    class Scope
+    {
+      public:
+        explicit Scope(Id id)
+          : myId{id}, myStart{std::chrono::steady_clock::now()} { }
+        ~Scope() {
+          add(myId, std::chrono::steady_clock::now() - myStart);
+        }
+
+      private:
+        Id myId;
+        std::chrono::steady_clock::time_point myStart;
+
+      private:
+        Scope(const Scope&) = delete;
+        Scope(Scope&&) = delete;
+        Scope& operator=(const Scope&) = delete;
+        Scope& operator=(Scope&&) = delete;
+    };
+
+  public:
+    /**
+      Add the given time to a counter.
+    */
+    static void add(Id id, std::chrono::steady_clock::duration time) {
+      ourCounters[static_cast<size_t>(id)].fetch_add(
+        static_cast<uInt64>(time.count()), std::memory_order_relaxed);
+    }
+
+    /**
+      Finish the current displayed frame, and start aggregating the next.
+
+      @param frames  The number of frames emulated for this displayed frame
+    */
+    static void endFrame(uInt32 frames);
+
+    /**
+      The times of the last displayed frame.
+    */
+    static const Frame& lastFrame() { return ourLastFrame; }
+
+    /**
+      A short, human readable summary of the last displayed frame.
+    */
+    static string summary();
+
+    /**
+      Write each displayed frame to the given CSV file (empty to disable).
+    */
+    static void setDumpFile(string_view filename);
+
+  private:
+    static inline std::array<std::atomic<uInt64>, NUM_IDS> ourCounters{};
+    static Frame ourLastFrame;
+
+  private:
+    // Following constructors and assignment operators not supported
+    PerfCounters() = delete;
+    ~PerfCounters() = delete;
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters(PerfCounters&&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+    PerfCounters& operator=(PerfCounters&&) = delete;
+};
+
+#ifdef PERF_COUNTERS
+  #define PERF_SCOPE(id) \
+    const PerfCounters::Scope perfScope(PerfCounters::Id::id)
+#else
+  #define PERF_SCOPE(id)
+#endif
+
+#endif // PERF_COUNTERS_HXX
@@ -15,6 +15,14 @@
 // this file, and for a DISCLAIMER OF ALL WARRANTIES.
 //============================================================================
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+  #define PHOSPHOR_SSE2
+  #include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__) || defined(_M_ARM64)
+  #define PHOSPHOR_NEON
+  #include <arm_neon.h>
+#endif
+
 #include "PhosphorHandler.hxx"
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -44,10 +52,120 @@ bool PhosphorHandler::initialize(bool enable, int blend)
       for(int p = 255; p >= 0; --p)
         ourPhosphorLUT[c][p] = getPhosphor(static_cast<uInt8>(c), static_cast<uInt8>(p));
     myLUTInitialized = true;
+
+    // Find a fixed point factor which results in exactly the same decay
+    ourDecayFactor = 0;
+    const auto base = static_cast<uInt32>(myPhosphorPercent * 65536);
+    for(uInt32 factor = base > 2 ? base - 2 : 1; factor <= base + 2; ++factor)
+    {
+      if(factor > 0xFFFF)
+        break;
+
+      bool exact = true;
+      for(uInt32 p = 0; p < 256 && exact; ++p)
+        exact = ((p * factor) >> 16) == ourPhosphorLUT[0][p];
+      if(exact)
+      {
+        ourDecayFactor = factor;
+        break;
+      }
+    }
   }
   return true;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool PhosphorHandler::blendRow(const uInt32* current, uInt32* previous,
+                               uInt32* out, uInt32 count)
+{
+  uInt32 x = 0;
+  uInt32 changed = 0;
+
+  // Each color channel is max(current, previous * factor >> 16), alpha is 0
+#if defined(PHOSPHOR_SSE2)
+  if(ourDecayFactor)
+  {
+    const __m128i factor = _mm_set1_epi16(static_cast<short>(ourDecayFactor));
+    const __m128i mask = _mm_set1_epi32(0x00FFFFFF);
+    const __m128i zero = _mm_setzero_si128();
+    __m128i diff = zero;
+
+    for(; x + 4 <= count; x += 4)
+    {
+      const __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(current + x));
+      const __m128i p = _mm_loadu_si128(reinterpret_cast<const __m128i*>(previous + x));
+
+      const __m128i decayed = _mm_packus_epi16(
+        _mm_mulhi_epu16(_mm_unpacklo_epi8(p, zero), factor),
+        _mm_mulhi_epu16(_mm_unpackhi_epi8(p, zero), factor));
+      const __m128i result = _mm_and_si128(_mm_max_epu8(c, decayed), mask);
+
+      diff = _mm_or_si128(diff, _mm_xor_si128(result, p));
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(previous + x), result);
+      if(out)
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + x), result);
+    }
+    changed = _mm_movemask_epi8(_mm_cmpeq_epi8(diff, zero)) != 0xFFFF;
+  }
+#elif defined(PHOSPHOR_NEON)
+  if(ourDecayFactor)
+  {
+    const auto factor = static_cast<uInt16>(ourDecayFactor);
+    const uint8x16_t mask = vreinterpretq_u8_u32(vdupq_n_u32(0x00FFFFFF));
+    uint8x16_t diff = vdupq_n_u8(0);
+
+    const auto decay = [factor](uint16x8_t v) {
+      return vmovn_u16(vcombine_u16(
+        vshrn_n_u32(vmull_n_u16(vget_low_u16(v), factor), 16),
+        vshrn_n_u32(vmull_n_u16(vget_high_u16(v), factor), 16)));
+    };
+
+    for(; x + 4 <= count; x += 4)
+    {
+      const uint8x16_t c = vreinterpretq_u8_u32(vld1q_u32(current + x));
+      const uint8x16_t p = vreinterpretq_u8_u32(vld1q_u32(previous + x));
+
+      const uint8x16_t decayed = vcombine_u8(
+        decay(vmovl_u8(vget_low_u8(p))), decay(vmovl_u8(vget_high_u8(p))));
+      const uint8x16_t result = vandq_u8(vmaxq_u8(c, decayed), mask);
+
+      diff = vorrq_u8(diff, veorq_u8(result, p));
+      vst1q_u32(previous + x, vreinterpretq_u32_u8(result));
+      if(out)
+        vst1q_u32(out + x, vreinterpretq_u32_u8(result));
+    }
+    const uint32x4_t diff32 = vreinterpretq_u32_u8(diff);
+    const uint32x2_t diff64 = vorr_u32(vget_low_u32(diff32), vget_high_u32(diff32));
+    changed = vget_lane_u32(diff64, 0) | vget_lane_u32(diff64, 1);
+  }
+#endif
+
+  // Scalar code for the remaining pixels (or all, if SIMD is not available)
+  for(; x < count; ++x)
+  {
+    const uInt32 result = getPixel(current[x], previous[x]);
+
+    changed |= result ^ previous[x];
+    previous[x] = result;
+    if(out)
+      out[x] = result;
+  }
+  return changed != 0;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool PhosphorHandler::DirtyRows::skipRow(uInt32 y, uInt64 hash)
+{
+  const bool unchanged = myHashes[y] == hash;
+
+  if(!unchanged)
+  {
+    myHashes[y] = hash;
+    myStable[y] = false;
+  }
+  return unchanged && myStable[y];
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 PhosphorHandler::PhosphorMode PhosphorHandler::toPhosphorMode(string_view name)
 {
@@ -75,3 +193,4 @@ string_view PhosphorHandler::toPhosphorName(PhosphorMode type)
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 PhosphorHandler::PhosphorLUT PhosphorHandler::ourPhosphorLUT;
+uInt32 PhosphorHandler::ourDecayFactor = 0;
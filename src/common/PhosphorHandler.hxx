@@ -19,6 +19,7 @@
 #define PHOSPHOR_HANDLER_HXX
 
 #include "FrameBufferConstants.hxx"
+#include "TIAConstants.hxx"
 #include "bspf.hxx"
 
 class PhosphorHandler
@@ -53,6 +54,9 @@ class PhosphorHandler
     static PhosphorMode toPhosphorMode(string_view name);
     static string_view toPhosphorName(PhosphorMode type);
 
+    // Number of bytes used by the (shared) blending lookup table
+    static constexpr size_t memoryUsage() { return sizeof(PhosphorLUT); }
+
     /**
       Used to calculate an averaged color pixel for the 'phosphor' effect.
 
@@ -75,6 +79,51 @@ class PhosphorHandler
               (ourPhosphorLUT[bc][bp] << 16);
     }
 
+    /**
+      Blend a row of pixels using getPixel(), using SIMD instructions where
+      possible.  The result is stored back into 'previous' (for the next
+      frame), and optionally into 'out' (which may be the same as 'current').
+
+      @param current   RGB colors of the current frame
+      @param previous  RGB colors of the previous frame, receives the result
+      @param out       Receives the result too, if not nullptr
+      @param count     Number of pixels in the row
+
+      @return  Whether the blending changed any pixel of 'previous'
+    */
+    static bool blendRow(const uInt32* current, uInt32* previous,
+                         uInt32* out, uInt32 count);
+
+    /**
+      Keeps track of the rows which don't have to be blended again, because
+      both the input (TIA pixels) and the blended result have not changed
+      since the last frame.
+    */
+    class DirtyRows
+    {
+      public:
+        DirtyRows() { invalidate(); }
+
+        // All rows must be rendered and blended again
+        void invalidate() { myStable.fill(false); }
+
+        /**
+          Answer whether the given row can be skipped.  This is the case
+          when the TIA row is the same as in the last frame (according to
+          its hash, see TIA::frameBufferLineHashes), and blending it didn't
+          change the result any more.  The hash is remembered for the next
+          frame.
+        */
+        bool skipRow(uInt32 y, uInt64 hash);
+
+        // Remember whether blending the given row changed the result
+        void setStable(uInt32 y, bool stable) { myStable[y] = stable; }
+
+      private:
+        std::array<uInt64, TIAConstants::frameBufferHeight> myHashes{};
+        std::array<bool, TIAConstants::frameBufferHeight> myStable{};
+    };
+
   private:
     // Use phosphor effect
     bool myUsePhosphor{false};
@@ -87,6 +136,10 @@ class PhosphorHandler
     using PhosphorLUT = BSPF::array2D<uInt8, kColor, kColor>;
     static PhosphorLUT ourPhosphorLUT;
 
+    // Fixed point factor reproducing the decay of the LUT exactly
+    // (decay = value * factor >> 16), used by the SIMD code; 0 if none exists
+    static uInt32 ourDecayFactor;
+
   private:
     PhosphorHandler(const PhosphorHandler&) = delete;
     PhosphorHandler(PhosphorHandler&&) = delete;
@@ -0,0 +1,236 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2026 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#include "OSystem.hxx"
+#include "FrameBuffer.hxx"
+#include "FrameTimes.hxx"
+#include "NTSCFilter.hxx"
+#include "Settings.hxx"
+#include "TIASurface.hxx"
+
+#include "QualityGovernor.hxx"
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void QualityGovernor::setStages(string_view list)
+{
+  myStages.clear();
+
+  while(!list.empty())
+  {
+    const size_t comma = list.find(',');
+    const string_view token = list.substr(0, comma);
+    list = comma == string_view::npos ? string_view{} : list.substr(comma + 1);
+
+    for(size_t i = 0; i < NUM_STAGES; ++i)
+    {
+      const auto stage = static_cast<Stage>(i);
+      if(BSPF::equalsIgnoreCase(token, name(stage)) &&
+         std::ranges::find(myStages, stage) == myStages.end())
+        myStages.push_back(stage);
+    }
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void QualityGovernor::reset(TIASurface& surface)
+{
+  // NTSC filtering and phosphor blending have been set from the settings
+  // again, the other effects are only suppressed by the surface
+  surface.suppressScanlines(false);
+  surface.suppressSmoothing(false);
+
+  myLevel = 0;
+  myReduced.fill(false);
+  myUpWindows.fill(UP_WINDOWS);
+  myGoodWindows = 0;
+  myJustRestored = false;
+  myWarmUp = true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void QualityGovernor::update(OSystem& osystem)
+{
+  if(myStages.empty())
+    return;
+
+  // Automatic phosphor mode may have enabled the effect again
+  if(myReduced[static_cast<size_t>(Stage::Phosphor)] &&
+     osystem.frameBuffer().tiaSurface().phosphorEnabled())
+    osystem.frameBuffer().tiaSurface().enablePhosphor(false);
+
+  const FrameTimes& times = osystem.frameTimes();
+  if(times.count() < myWindowStart)  // the times were reset
+  {
+    myWindowStart = times.count();
+    myWarmUp = true;
+  }
+  if(times.count() < myWindowStart + WINDOW)
+    return;
+  myWindowStart = times.count();
+
+  // Starting up (e.g. loading a ROM or leaving a menu) is usually slow
+  if(myWarmUp)
+  {
+    myWarmUp = false;
+    return;
+  }
+
+  // Frame timing is meaningless when not running at emulation speed
+  const float frameRate = osystem.frameRate();
+  if(frameRate <= 0.F || osystem.settings().getBool("turbo"))
+    return;
+
+  // The mean interval also covers frames quantized to the display refresh
+  // (e.g. 50Hz on a 60Hz display), unlike a percentile
+  const double period = 1000. / frameRate;
+  const double interval = times.mean(FrameTimes::Phase::Interval, WINDOW);
+
+  if(interval > period * SLOW_FACTOR)
+  {
+    // The stage restored last is too slow, try it again much later
+    if(myJustRestored)
+      myUpWindows[myLevel] = std::min(myUpWindows[myLevel] * 2, MAX_UP_WINDOWS);
+    myGoodWindows = 0;
+    myJustRestored = false;
+    if(myLevel < myStages.size())
+      stepDown(osystem);
+  }
+  else if(interval <= period * FAST_FACTOR && myLevel > 0)
+  {
+    myJustRestored = false;
+    if(++myGoodWindows >= myUpWindows[myLevel - 1])
+    {
+      myGoodWindows = 0;
+      myJustRestored = true;
+      stepUp(osystem);
+    }
+  }
+  else
+  {
+    myGoodWindows = 0;
+    myJustRestored = false;
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void QualityGovernor::stepDown(OSystem& osystem)
+{
+  // Skip the stages whose effects are not enabled anyway
+  while(myLevel < myStages.size())
+  {
+    const Stage stage = myStages[myLevel++];
+    if(reduce(stage, osystem))
+    {
+      myReduced[static_cast<size_t>(stage)] = true;
+      osystem.frameBuffer().showTextMessage(
+        "Host too slow, " + string{name(stage)} + " disabled");
+      break;
+    }
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void QualityGovernor::stepUp(OSystem& osystem)
+{
+  while(myLevel > 0)
+  {
+    const Stage stage = myStages[--myLevel];
+    bool& reduced = myReduced[static_cast<size_t>(stage)];
+    if(reduced)
+    {
+      reduced = false;
+      restore(stage, osystem);
+      break;
+    }
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool QualityGovernor::reduce(Stage stage, OSystem& osystem)
+{
+  TIASurface& surface = osystem.frameBuffer().tiaSurface();
+
+  switch(stage)
+  {
+    case Stage::NTSC:
+      if(!surface.ntscEnabled())
+        return false;
+      surface.enableNTSC(false);
+      return true;
+
+    case Stage::Phosphor:
+      if(!surface.phosphorEnabled())
+        return false;
+      surface.enablePhosphor(false);
+      return true;
+
+    case Stage::Scanlines:
+      if(!surface.scanlinesEnabled())
+        return false;
+      surface.suppressScanlines(true);
+      return true;
+
+    case Stage::Smoothing:
+      if(!surface.smoothingEnabled())
+        return false;
+      surface.suppressSmoothing(true);
+      return true;
+
+    default:
+      return false;
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void QualityGovernor::restore(Stage stage, OSystem& osystem)
+{
+  TIASurface& surface = osystem.frameBuffer().tiaSurface();
+
+  switch(stage)
+  {
+    case Stage::NTSC:
+      // Unless filtering was switched off in the meantime
+      if(osystem.settings().getInt("tv.filter") !=
+         static_cast<int>(NTSCFilter::Preset::OFF))
+        surface.enableNTSC(true);
+      break;
+
+    case Stage::Phosphor:
+      surface.enablePhosphor(true);
+      break;
+
+    case Stage::Scanlines:
+      surface.suppressScanlines(false);
+      break;
+
+    case Stage::Smoothing:
+      surface.suppressSmoothing(false);
+      break;
+
+    default:
+      break;
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+string_view QualityGovernor::name(Stage stage)
+{
+  static constexpr std::array<string_view, NUM_STAGES> names = {
+    "ntsc", "phosphor", "scanlines", "qis"
+  };
+  return names[static_cast<size_t>(stage)];
+}
@@ -0,0 +1,132 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2026 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#ifndef QUALITY_GOVERNOR_HXX
+#define QUALITY_GOVERNOR_HXX
+
+class OSystem;
+class TIASurface;
+
+#include "bspf.hxx"
+
+/**
+  Adapts the video post-processing to the speed of the host: when frames
+  are presented later than the emulation produces them, the costly TIA
+  effects are disabled one after the other, in the order configured by
+  '-tv.governor' (e.g. 'ntsc,phosphor,scanlines,qis').  When the frames are
+  on time again for a while, the effects are restored in reverse order.
+
+  The decisions are based on the mean host frame interval (see FrameTimes)
+  over a window of frames, compared to the emulated frame rate.  Stepping
+  up requires several good windows, and the number doubles whenever a
+  restored effect turns out to be too slow again, so the governor settles
+  instead of toggling an effect back and forth.
+
+  Only the rendering is changed, never the settings; effects which are not
+  enabled anyway are skipped.
+
+  @author  Stella Team
+*/
+class QualityGovernor
+{
+  public:
+    enum class Stage: uInt8 {
+      NTSC,       // Blargg NTSC filtering
+      Phosphor,   // phosphor blending
+      Scanlines,  // scanline mask overlay
+      Smoothing,  // smooth (QIS) scaling
+      NumStages
+    };
+
+    QualityGovernor() = default;
+    ~QualityGovernor() = default;
+
+    /**
+      Set the stages to reduce, in order, from a comma separated list of
+      'ntsc', 'phosphor', 'scanlines' and 'qis'.  An empty list disables
+      the governor.
+    */
+    void setStages(string_view list);
+
+    /**
+      Forget all reduced stages, e.g. when the TIA surface has been set up
+      again from the settings.
+    */
+    void reset(TIASurface& surface);
+
+    /**
+      Check the recent frame times and step down or up, if necessary.  Must
+      be called after each presented frame.
+    */
+    void update(OSystem& osystem);
+
+    /**
+      The number of stages currently reduced.
+    */
+    size_t level() const { return myLevel; }
+
+  private:
+    static constexpr size_t NUM_STAGES = static_cast<size_t>(Stage::NumStages);
+
+    // Frames per window, about two seconds
+    static constexpr size_t WINDOW = 120;
+    // Step down when frames take this much longer than emulated, and allow
+    // stepping up only when they are at most this late
+    static constexpr double SLOW_FACTOR = 1.10, FAST_FACTOR = 1.02;
+    // Good windows required for stepping up, initially and at most
+    static constexpr uInt32 UP_WINDOWS = 3, MAX_UP_WINDOWS = 48;
+
+  private:
+    void stepDown(OSystem& osystem);
+    void stepUp(OSystem& osystem);
+
+    // Disable the effect of a stage if enabled; returns whether it was
+    static bool reduce(Stage stage, OSystem& osystem);
+    static void restore(Stage stage, OSystem& osystem);
+
+    static string_view name(Stage stage);
+
+  private:
+    // The stages in the order they are reduced
+    vector<Stage> myStages;
+
+    // The first 'myLevel' stages are reduced, those which were enabled
+    // are marked in 'myReduced'
+    size_t myLevel{0};
+    std::array<bool, NUM_STAGES> myReduced{};
+
+    // Good windows required before restoring the stage at each level
+    std::array<uInt32, NUM_STAGES> myUpWindows{
+      UP_WINDOWS, UP_WINDOWS, UP_WINDOWS, UP_WINDOWS
+    };
+    uInt32 myGoodWindows{0};
+    bool myJustRestored{false};
+
+    // Frame count (of FrameTimes) at the start of the current window; the
+    // first window after the times were reset is skipped
+    size_t myWindowStart{0};
+    bool myWarmUp{true};
+
+  private:
+    // Following constructors and assignment operators not supported
+    QualityGovernor(const QualityGovernor&) = delete;
+    QualityGovernor(QualityGovernor&&) = delete;
+    QualityGovernor& operator=(const QualityGovernor&) = delete;
+    QualityGovernor& operator=(QualityGovernor&&) = delete;
+};
+
+#endif // QUALITY_GOVERNOR_HXX
@@ -15,17 +15,24 @@
 // this file, and for a DISCLAIMER OF ALL WARRANTIES.
 //============================================================================
 
+#include <chrono>
 #include <cmath>
 
 #include "OSystem.hxx"
 #include "Console.hxx"
 #include "Serializer.hxx"
 #include "StateManager.hxx"
+#include "StateWriter.hxx"
 #include "TIA.hxx"
+#include "EmulationTiming.hxx"
 #include "EventHandler.hxx"
 
 #include "RewindManager.hxx"
 
+#ifdef ZIP_SUPPORT
+  #include <zlib.h>
+#endif
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 RewindManager::RewindManager(OSystem& system, StateManager& statemgr)
   : myOSystem{system},
@@ -41,6 +48,14 @@ void RewindManager::setup()
 
   const string& prefix = myOSystem.settings().getBool("dev.settings") ? "dev." : "plr.";
 
+  // Key frames and deltas cannot be mixed with complete states
+  const bool deltaMode = myOSystem.settings().getBool(prefix + "tm.delta");
+  if(deltaMode != myDeltaMode)
+  {
+    clear();
+    myDeltaMode = deltaMode;
+  }
+
   // TODO - Add proper bounds checking (define constexpr variables for this)
   //        Use those bounds in DeveloperDialog too
   mySize = std::min<uInt32>(
@@ -56,6 +71,13 @@ void RewindManager::setup()
     if(INT_SETTINGS[i] == myOSystem.settings().getString(prefix + "tm.interval"))
       myInterval = INTERVAL_CYCLES[i];
 
+  myBudgetCPU = std::min(myOSystem.settings().getInt(prefix + "tm.budget"), 100);
+  myBudgetMemory = myOSystem.settings().getInt(prefix + "tm.budgetmem");
+  myStateCost = 0;
+  myMemoryFactor = 1;
+  myEffectiveInterval = myInterval;
+  myCompressionLevel = 1;
+
   myHorizon = HORIZON_CYCLES[NUM_HORIZONS-1];
   for(int i = 0; i < NUM_HORIZONS; ++i)
     if(HOR_SETTINGS[i] == myOSystem.settings().getString(prefix + "tm.horizon"))
@@ -103,7 +125,7 @@ bool RewindManager::addState(string_view message, bool timeMachine)
   {
     // check if the current state has the right interval from the last state
     const RewindState& lastState = myStateList.current();
-    uInt32 interval = myInterval;
+    uInt64 interval = getEffectiveInterval();
 
     // adjust frame timed intervals to actual scanlines (vs 262)
     if(interval >= 76 * 262 && interval <= 76 * 262 * 30)
@@ -118,6 +140,8 @@ bool RewindManager::addState(string_view message, bool timeMachine)
       return false;
   }
 
+  const auto startTime = std::chrono::steady_clock::now();
+
   // Remove all future states
   myStateList.removeToLast();
 
@@ -129,19 +153,83 @@ bool RewindManager::addState(string_view message, bool timeMachine)
   // This updates the 'current' iterator inside the list
   myStateList.addLast();
   RewindState& state = myStateList.current();
-  Serializer& s = state.data;
+  Serializer& s = myDeltaMode ? myScratch : state.data;
 
   s.rewind();  // rewind Serializer internal buffers
   if(myStateManager.saveState(s) && myOSystem.console().tia().saveDisplay(s))
   {
+    if(myDeltaMode)
+    {
+      myBuffer.resize(s.position());
+      s.rewind();
+      s.getByteArray(myBuffer);
+      packState(state, myBuffer);
+    }
+    myOSystem.console().tia().createThumbnail(state.thumbnail, THUMBNAIL_SCALE);
     state.message = message;
     state.cycles = myOSystem.console().system().cycles();
     myLastTimeMachineAdd = timeMachine;
+
+    if(timeMachine && budgetMode())
+      updateBudget(std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - startTime).count());
     return true;
   }
+  if(myDeltaMode)
+  {
+    // Never base any deltas on an invalid state
+    state.packed.clear();
+    state.keyFrame = true;
+    myLastStateValid = false;
+  }
   return false;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RewindManager::updateBudget(double stateCost)
+{
+  // Smooth the measurements, single states can be delayed e.g. by the OS
+  myStateCost = myStateCost > 0 ? myStateCost * 0.75 + stateCost * 0.25
+                                : stateCost;
+
+  // The interval required to stay within the CPU budget, assuming that
+  // the emulation runs in real time
+  uInt64 interval = myInterval;
+  bool cpuBound = false;
+  if(myBudgetCPU)
+  {
+    const double cyclesPerSecond =
+        myOSystem.console().emulationTiming().cyclesPerSecond();
+    const auto minInterval = static_cast<uInt64>(
+        myStateCost * 100 / myBudgetCPU * cyclesPerSecond);
+
+    cpuBound = minInterval > myInterval;
+    interval = std::max<uInt64>(interval, minInterval);
+  }
+
+  if(myBudgetMemory)
+  {
+    const size_t limit = size_t{myBudgetMemory} << 20;
+
+    if(memoryUsage() > limit)
+    {
+      // Capture less often, and drop states until we are below the limit
+      myMemoryFactor = std::min(myMemoryFactor * 1.25, 1000.0);
+      while(myStateList.size() > 2 && memoryUsage() > limit)
+        compressStates();
+      // Compress harder, unless this breaks the CPU budget
+      if(!cpuBound)
+        myCompressionLevel = std::min(myCompressionLevel + 1, 9);
+    }
+    else if(memoryUsage() < limit / 2)
+      myMemoryFactor = std::max(myMemoryFactor / 1.25, 1.0);
+  }
+  if(cpuBound)
+    myCompressionLevel = std::max(myCompressionLevel - 1, 0);
+
+  myEffectiveInterval = static_cast<uInt64>(interval * myMemoryFactor);
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 uInt32 RewindManager::rewindStates(uInt32 numStates)
 {
@@ -226,6 +314,17 @@ uInt32 RewindManager::windStates(uInt32 numStates, bool unwind)
     return rewindStates(numStates);
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool RewindManager::reloadState()
+{
+  if(!myStateList.currentIsValid())
+    return false;
+
+  myStateList.current().data.rewind();  // rewind Serializer internal buffers
+  loadState(myOSystem.console().system().cycles(), 0);
+  return true;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 string RewindManager::saveAllStates()
 {
@@ -239,41 +338,58 @@ string RewindManager::saveAllStates()
       << myOSystem.console().properties().get(PropType::Cart_Name)
       << ".sta";
 
-    Serializer out(buf.view(), Serializer::FileMode::ReadWriteTrunc);
-    if (!out)
-      return "Can't save to all states file";
-
-    const uInt32 curIdx = getCurrentIdx();
-    rewindStates(MAX_BUF_SIZE);
-    const uInt32 numStates = static_cast<uInt32>(cyclesList().size());
-
-    // Save header
-    buf.str("");
-    out.putString(StateManager::STATE_HEADER);
-    out.putShort(numStates);
-
-    for (uInt32 i = 0; i < numStates; ++i)
-    {
-      RewindState& state = myStateList.current();
-      Serializer& s = state.data;
-      const auto stateSize = static_cast<uInt32>(s.size());
+    // The states are only collected in memory now, the file is written
+    // in the background
+    uInt32 numStates = 0;
+    const auto save = [&](Serializer& out) {
+      bool valid = true;
+      const uInt32 curIdx = getCurrentIdx();
+      rewindStates(MAX_BUF_SIZE);
+      numStates = static_cast<uInt32>(cyclesList().size());
 
-      out.putInt(stateSize);
+      // Save header
+      out.putString(StateManager::STATE_HEADER);
+      out.putShort(numStates);
 
-      // Rewind Serializer internal buffers
-      s.rewind();
+      for (uInt32 i = 0; i < numStates; ++i)
+      {
+        RewindState& state = myStateList.current();
+
+        if(myDeltaMode)
+        {
+          // Save uncompressed state
+          valid = unpackState(myStateList.currentIter(), myBuffer) && valid;
+          out.putInt(static_cast<uInt32>(myBuffer.size()));
+          out.putByteArray(myBuffer);
+        }
+        else
+        {
+          Serializer& s = state.data;
+          const auto stateSize = static_cast<uInt32>(s.size());
+
+          out.putInt(stateSize);
+
+          // Rewind Serializer internal buffers
+          s.rewind();
+
+          // Save state
+          ByteArray buffer(stateSize);
+          s.getByteArray(buffer);
+          out.putByteArray(buffer);
+        }
+        out.putString(state.message);
+        out.putLong(state.cycles);
+
+        unwindStates(1);
+      }
+      // restore old state position
+      rewindStates(numStates - curIdx);
 
-      // Save state
-      ByteArray buffer(stateSize);
-      s.getByteArray(buffer);
-      out.putByteArray(buffer);
-      out.putString(state.message);
-      out.putLong(state.cycles);
+      return valid;
+    };
 
-      unwindStates(1);
-    }
-    // restore old state position
-    rewindStates(numStates - curIdx);
+    if (!myStateManager.stateWriter().write(buf.view(), save, false))
+      return "Can't save to all states file";
 
     buf.str("");
     buf << "Saved " << numStates << " states";
@@ -295,6 +411,9 @@ string RewindManager::loadAllStates()
       << myOSystem.console().properties().get(PropType::Cart_Name)
       << ".sta";
 
+    // The file may still be being written
+    myStateManager.stateWriter().flush();
+
     // Make sure the file can be opened for reading
     Serializer in(buf.view(), Serializer::FileMode::ReadOnly);
     if (!in)
@@ -321,17 +440,29 @@ string RewindManager::loadAllStates()
       // This updates the 'current' iterator inside the list
       myStateList.addLast();
       RewindState& state = myStateList.current();
-      Serializer& s = state.data;
-
-      // Rewind Serializer internal buffers
-      s.rewind();
 
       // Fill new state with saved values
-      ByteArray buffer(stateSize);
-      in.getByteArray(buffer);
-      s.putByteArray(buffer);
+      if(myDeltaMode)
+      {
+        myBuffer.resize(stateSize);
+        in.getByteArray(myBuffer);
+        packState(state, myBuffer);
+      }
+      else
+      {
+        Serializer& s = state.data;
+
+        // Rewind Serializer internal buffers
+        s.rewind();
+
+        ByteArray buffer(stateSize);
+        in.getByteArray(buffer);
+        s.putByteArray(buffer);
+      }
       state.message = in.getString();
       state.cycles = in.getLong();
+      // thumbnails are not saved
+      state.thumbnail.clear();
     }
 
     // initialize current state (parameters ignored)
@@ -350,7 +481,7 @@ string RewindManager::loadAllStates()
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void RewindManager::compressStates()
 {
-  double expectedCycles = myInterval * myFactor * (1 + myFactor);
+  double expectedCycles = getEffectiveInterval() * myFactor * (1 + myFactor);
   double maxError = 1.5;
   uInt32 idx = myStateList.size() - 2;
   // in case maxError is <= 1.5 remove first state by default:
@@ -378,15 +509,46 @@ void RewindManager::compressStates()
     }
     --idx;
   }
-   myStateList.remove(removeIter); // remove
+  if(myDeltaMode)
+  {
+    // The following state is based on the removed one, so it must become
+    // either a key frame or a delta to the state preceding the removed one
+    const auto nextIter = myStateList.next(removeIter);
+
+    if(nextIter != myStateList.cend() && !nextIter->keyFrame)
+    {
+      RewindState& next = myStateList.value(nextIter);
+
+      unpackState(nextIter, myBuffer);
+      if(removeIter->keyFrame)
+      {
+        packKeyFrame(next, myBuffer, myCompressionLevel);
+        next.keyFrame = true;
+      }
+      else
+      {
+        unpackState(myStateList.previous(removeIter), myDelta);
+        encodeDelta(myDelta, myBuffer, next.packed);
+      }
+    }
+  }
+  myStateList.remove(removeIter); // remove
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 string RewindManager::loadState(Int64 startCycles, uInt32 numStates)
 {
   RewindState& state = myStateList.current();
-  Serializer& s = state.data;
+  Serializer& s = myDeltaMode ? myScratch : state.data;
 
+  if(myDeltaMode)
+  {
+    // A state which can't be unpacked fails to load below
+    myLastStateValid = unpackState(myStateList.currentIter(), myLastState);
+    s.rewind();
+    s.putByteArray(myLastState);
+    s.rewind();
+  }
   myStateManager.loadState(s);
   myOSystem.console().tia().loadDisplay(s);
 
@@ -407,7 +569,182 @@ string RewindManager::loadState(Int64 startCycles, uInt32 numStates)
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-string RewindManager::getUnitString(Int64 cycles)
+void RewindManager::packState(RewindState& state, ByteArray& data)
+{
+  state.size = static_cast<uInt32>(data.size());
+  state.keyFrame = true;
+
+  // Deltas are only possible if the previous state is still the cached one
+  const auto prevIter = myStateList.previous(myStateList.currentIter());
+  if(myLastStateValid && prevIter != myStateList.cend())
+  {
+    uInt32 chain = 1;
+    for(auto it = prevIter; !it->keyFrame; it = myStateList.previous(it))
+      ++chain;
+
+    if(chain < KEY_FRAME_INTERVAL)
+    {
+      encodeDelta(myLastState, data, myDelta);
+      // Only use the delta if it actually saves memory
+      state.keyFrame = myDelta.size() >= data.size();
+    }
+  }
+  if(state.keyFrame)
+    packKeyFrame(state, data, myCompressionLevel);
+  else
+    state.packed.assign(myDelta.begin(), myDelta.end());
+
+  // Don't let reused list entries keep the memory of former key frames
+  if(state.packed.capacity() > state.packed.size() * 2)
+    state.packed.shrink_to_fit();
+
+  std::swap(myLastState, data);
+  myLastStateValid = true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool RewindManager::unpackState(
+    Common::LinkedObjectPool<RewindState>::const_iter it, ByteArray& data)
+{
+  // Find the key frame this state is based on...
+  auto keyIter = it;
+  while(!keyIter->keyFrame)
+    keyIter = myStateList.previous(keyIter);
+
+  // ...and apply all deltas from there on
+  if(!unpackKeyFrame(*keyIter, data))
+    return false;
+
+  ByteArray base;
+  while(keyIter != it)
+  {
+    keyIter = myStateList.next(keyIter);
+    std::swap(base, data);
+    decodeDelta(base, keyIter->packed, keyIter->size, data);
+  }
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RewindManager::packKeyFrame(RewindState& state, const ByteArray& data,
+                                 int level)
+{
+#ifdef ZIP_SUPPORT
+  // Fast compression is usually sufficient, key frames are rare and mostly
+  // contain zeroed or repeated data (budget mode adapts the level)
+  uLongf packedSize = compressBound(static_cast<uLong>(data.size()));
+  state.packed.resize(packedSize);
+  if(level > 0 && compress2(state.packed.data(), &packedSize, data.data(),
+               static_cast<uLong>(data.size()), level) == Z_OK &&
+     packedSize < data.size())
+  {
+    state.packed.resize(packedSize);
+    return;
+  }
+#else
+  (void)level;
+#endif
+  state.packed.assign(data.begin(), data.end());
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool RewindManager::unpackKeyFrame(const RewindState& state, ByteArray& data)
+{
+#ifdef ZIP_SUPPORT
+  if(state.packed.size() != state.size)
+  {
+    uLongf size = state.size;
+    data.resize(size);
+    if(uncompress(data.data(), &size, state.packed.data(),
+                  static_cast<uLong>(state.packed.size())) == Z_OK &&
+       size == state.size)
+      return true;
+
+    // Don't pass on a partially inflated state
+    data.clear();
+    return false;
+  }
+#endif
+  data.assign(state.packed.begin(), state.packed.end());
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RewindManager::encodeDelta(const ByteArray& base, const ByteArray& data,
+                                ByteArray& delta)
+{
+  // Unchanged runs shorter than this are stored as part of the changed bytes
+  constexpr size_t MIN_RUN = 4;
+
+  const auto putLength = [&delta](size_t length) {
+    while(length >= 0x80)
+    {
+      delta.push_back(static_cast<uInt8>(length | 0x80));
+      length >>= 7;
+    }
+    delta.push_back(static_cast<uInt8>(length));
+  };
+  const size_t size = data.size();
+  const size_t common = std::min(size, base.size());
+  const auto unchanged = [&](size_t i) {
+    return i + MIN_RUN <= common &&
+      std::equal(data.begin() + i, data.begin() + i + MIN_RUN, base.begin() + i);
+  };
+
+  delta.clear();
+  size_t i = 0;
+  while(i < size)
+  {
+    const size_t start = i;
+    while(i < common && data[i] == base[i])
+      ++i;
+    putLength(i - start);
+
+    const size_t changed = i;
+    while(i < size && !unchanged(i))
+      ++i;
+    putLength(i - changed);
+
+    for(size_t j = changed; j < i; ++j)
+      delta.push_back(j < common ? data[j] ^ base[j] : data[j]);
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RewindManager::decodeDelta(const ByteArray& base, const ByteArray& delta,
+                                uInt32 size, ByteArray& data)
+{
+  size_t pos = 0;
+  const auto getLength = [&delta, &pos]() {
+    size_t length = 0;
+    for(int shift = 0; pos < delta.size(); shift += 7)
+    {
+      const uInt8 b = delta[pos++];
+      length |= static_cast<size_t>(b & 0x7f) << shift;
+      if(!(b & 0x80))
+        break;
+    }
+    return length;
+  };
+
+  // Start with the base data (zero padded), then apply the changes
+  const size_t common = std::min<size_t>(size, base.size());
+  data.resize(size);
+  std::copy_n(base.begin(), common, data.begin());
+  std::fill(data.begin() + common, data.end(), 0);
+
+  size_t i = 0;
+  while(pos < delta.size())
+  {
+    i += getLength();
+    const size_t changed = getLength();
+    for(size_t j = 0; j < changed; ++j)
+      data[i++] ^= delta[pos++];
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+string RewindManager::getUnitString(Int64 cycles) const
 {
   constexpr size_t NTSC_FREQ = 1193182; // ~76*262*60
   constexpr size_t PAL_FREQ  = 1182298; // ~76*312*50
@@ -443,6 +780,18 @@ string RewindManager::getUnitString(Int64 cycles)
   return result.str();
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+size_t RewindManager::memoryUsage() const
+{
+  const auto owned = [](const RewindState& state) {
+    return state.data.memoryUsage() + state.packed.capacity() +
+           state.thumbnail.capacity() + state.message.capacity();
+  };
+
+  return myStateList.memoryUsage(owned) + myLastState.capacity() +
+         myBuffer.capacity() + myDelta.capacity() + myScratch.memoryUsage();
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 uInt64 RewindManager::getFirstCycles() const
 {
@@ -475,3 +824,63 @@ IntArray RewindManager::cyclesList() const
 
   return arr;
 }
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool RewindManager::showThumbnail(uInt32 idx)
+{
+  uInt32 i = 0;
+  for(const auto& state: myStateList)
+    if(++i == idx)
+    {
+      if(state.thumbnail.empty())
+        return false;
+
+      myOSystem.console().tia().showThumbnail(state.thumbnail, THUMBNAIL_SCALE);
+      return true;
+    }
+
+  return false;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RewindManager::getAllStates(vector<ByteArray>& states)
+{
+  states.resize(myStateList.size());
+
+  size_t i = 0;
+  for(auto& state: myStateList)
+  {
+    ByteArray& data = states[i];
+
+    if(myDeltaMode)
+    {
+      // Deltas are always relative to the previous state in the list
+      if(state.keyFrame)
+        unpackKeyFrame(state, data);
+      else if(!states[i - 1].empty())
+        decodeDelta(states[i - 1], state.packed, state.size, data);
+      else
+        data.clear();  // based on a key frame which couldn't be inflated
+    }
+    else
+    {
+      data.resize(state.data.size());
+      state.data.rewind();
+      state.data.getByteArray(data);
+    }
+    ++i;
+  }
+
+#ifdef DEBUG_BUILD
+  // Both ways of unpacking must give the same states
+  if(myDeltaMode)
+  {
+    ByteArray data;
+    i = 0;
+    for(auto it = myStateList.cbegin(); it != myStateList.cend(); ++it, ++i)
+      if(!unpackState(it, data) || data != states[i])
+        cerr << "ERROR: RewindManager::getAllStates() differs for state "
+             << i << '\n';
+  }
+#endif
+}
@@ -42,6 +42,19 @@ class StateManager;
   If the list is full, states are either removed at the beginning (compression
   off) or at selective positions (compression on).
 
+  Optionally (delta mode), only every KEY_FRAME_INTERVAL'th state is stored
+  completely (key frame, deflated if possible).  All other states are stored
+  as XOR differences to their predecessor, run-length encoding the unchanged
+  bytes.  Since most of a save state (e.g. RAM, ARM memory) changes only
+  little between two states, this allows much longer horizons within the
+  same memory.
+
+  Optionally (budget mode), the Time Machine limits the share of the
+  emulation time spent on adding states, and/or the memory used by the
+  states.  The cost of each state is measured, and the interval between the
+  states and the compression level of the key frames are adapted on the fly.
+  This mostly matters for carts with large states (e.g. CDF or ELF).
+
   @author  Stephen Anthony
 */
 class RewindManager
@@ -52,6 +65,10 @@ class RewindManager
 
   public:
     static constexpr uInt32 MAX_BUF_SIZE = 1000;
+    // maximum distance between two complete states in delta mode
+    static constexpr uInt32 KEY_FRAME_INTERVAL = 30;
+    // downscaling factor of the thumbnails shown while scrubbing the timeline
+    static constexpr uInt32 THUMBNAIL_SCALE = 2;
     static constexpr int NUM_INTERVALS = 7;
     // cycle values for the intervals
     static constexpr std::array<uInt32, NUM_INTERVALS> INTERVAL_CYCLES = {
@@ -139,6 +156,14 @@ class RewindManager
     */
     uInt32 windStates(uInt32 numStates, bool unwind);
 
+    /**
+      Load the current state again, without moving in the state list
+      (e.g. to replay from it).
+
+      @return  False if there is no current state
+    */
+    bool reloadState();
+
     string saveAllStates();
     string loadAllStates();
 
@@ -147,12 +172,13 @@ class RewindManager
     void resize(uInt32 size) { myStateList.resize(size); }
     void clear() {
       myStateList.clear();
+      myLastStateValid = false;
     }
 
     /**
       Convert the cycles into a unit string.
     */
-    string getUnitString(Int64 cycles);
+    string getUnitString(Int64 cycles) const;
 
     uInt32 getCurrentIdx() { return myStateList.currentIdx(); }
     uInt32 getLastIdx() { return myStateList.size(); }
@@ -162,12 +188,42 @@ class RewindManager
     uInt64 getLastCycles() const;
     uInt64 getInterval() const { return myInterval; }
 
+    /**
+      Budget mode: the interval actually used between two Time Machine
+      states, which can be larger than the configured one.
+    */
+    bool budgetMode() const { return myBudgetCPU || myBudgetMemory; }
+    uInt64 getEffectiveInterval() const {
+      return budgetMode() ? myEffectiveInterval : myInterval;
+    }
+
     /**
       Get a collection of cycle timestamps, offset from the first one in
       the list.  This also determines the number of states in the list.
     */
     IntArray cyclesList() const;
 
+    /**
+      Show the thumbnail of the given state (1 = first) instead of the
+      current frame, without loading the state.
+
+      @return  False if the state has no thumbnail
+    */
+    bool showThumbnail(uInt32 idx);
+
+    /**
+      Get the uncompressed data of all states in the list, oldest first.
+      Each state starts with the StateManager header, followed by the
+      console state.
+    */
+    void getAllStates(vector<ByteArray>& states);
+
+    /**
+      Answer the number of bytes owned by the states in the list (including
+      recycled ones) and the buffers used for (un)packing them.
+    */
+    size_t memoryUsage() const;
+
   private:
     OSystem& myOSystem;
     StateManager& myStateManager;
@@ -178,11 +234,36 @@ class RewindManager
     uInt64 myHorizon{0};
     double myFactor{0.0};
     bool   myLastTimeMachineAdd{false};
+    bool   myDeltaMode{false};
+
+    // Delta mode: the uncompressed data of the current state, and buffers
+    // used while (un)packing states
+    ByteArray myLastState;
+    bool myLastStateValid{false};
+    ByteArray myBuffer, myDelta;
+    Serializer myScratch;
+
+    // Budget mode: maximum share of the emulation time spent on adding
+    // Time Machine states (in percent) and maximum memory used (in MB)
+    uInt32 myBudgetCPU{0};
+    uInt32 myBudgetMemory{0};
+    // Budget mode: average time needed to add a state (in seconds), factor
+    // applied to the interval while above the memory limit, and the
+    // resulting interval
+    double myStateCost{0.0};
+    double myMemoryFactor{1.0};
+    uInt64 myEffectiveInterval{0};
+    // zlib level used for the key frames (delta mode)
+    int myCompressionLevel{1};
 
     struct RewindState {
       Serializer data;  // actual save state
+      ByteArray packed; // (deflated) key frame or delta to previous state (delta mode)
+      ByteArray thumbnail; // downscaled frame, empty if not available
       string message;   // describes save state origin
       uInt64 cycles{0}; // cycles since emulation started
+      uInt32 size{0};   // uncompressed size of state (delta mode)
+      bool keyFrame{true};
 
       // We do nothing on object instantiation or copy
       // The goal of LinkedObjectPool is to not do any allocations at all
@@ -215,6 +296,55 @@ class RewindManager
     */
     string loadState(Int64 startCycles, uInt32 numStates);
 
+    /**
+      Budget mode: Adapt the interval and the compression level to the time
+      needed for adding the last state and to the memory used.
+    */
+    void updateBudget(double stateCost);
+
+    /**
+      Delta mode: Store the uncompressed state data in 'state', either as key
+      frame or as a delta to the previous state in the list.  Afterwards
+      'data' contains the data of the previous current state.
+
+      @param state  The (new) current state
+      @param data   The uncompressed data of the state
+    */
+    void packState(RewindState& state, ByteArray& data);
+
+    /**
+      Delta mode: Reconstruct the uncompressed data of the given state.
+
+      @param it    Iterator pointing to the state
+      @param data  Receives the uncompressed data of the state
+
+      @return  False if the key frame of the state couldn't be inflated
+    */
+    bool unpackState(Common::LinkedObjectPool<RewindState>::const_iter it,
+                     ByteArray& data);
+
+    /**
+      Delta mode: Store 'data' as key frame of the given state, deflated if
+      this is supported and makes it smaller.  A key frame is deflated iff
+      its packed size differs from its size.
+    */
+    static void packKeyFrame(RewindState& state, const ByteArray& data,
+                             int level);
+    static bool unpackKeyFrame(const RewindState& state, ByteArray& data);
+
+    /**
+      Encode 'data' as a sequence of (unchanged bytes, changed bytes) runs
+      relative to 'base'.  The changed bytes are stored XORed with 'base'.
+    */
+    static void encodeDelta(const ByteArray& base, const ByteArray& data,
+                            ByteArray& delta);
+
+    /**
+      Apply the given delta to 'base', resulting in 'data' of 'size' bytes.
+    */
+    static void decodeDelta(const ByteArray& base, const ByteArray& delta,
+                            uInt32 size, ByteArray& data);
+
   private:
     // Following constructors and assignment operators not supported
     RewindManager() = delete;
@@ -0,0 +1,278 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2026 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#include "OSystem.hxx"
+#include "Bankswitch.hxx"
+#include "CartDetector.hxx"
+#include "ControllerDetector.hxx"
+#include "json_lib.hxx"
+
+#include "RomIndex.hxx"
+
+using json = nlohmann::json;
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+RomIndex::RomIndex(OSystem& osystem)
+  : myOSystem{osystem}
+{
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+RomIndex::~RomIndex()
+{
+  stopScan();
+  save();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RomIndex::setRepository(shared_ptr<KeyValueRepositoryAtomic> repo)
+{
+  stopScan();
+
+  const std::scoped_lock lock(myMutex);
+
+  myRepository = std::move(repo);
+  myStored = myRepository->load();
+  myEntries.clear();
+  myPendingSaves.clear();
+  myScanKey.clear();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+const RomIndex::Entry& RomIndex::get(const FSNode& node)
+{
+  save();
+
+  const string& path = node.getPath();
+  const size_t fileSize = node.getSize();
+  const uInt64 modified = node.getLastModified();
+  {
+    const std::scoped_lock lock(myMutex);
+
+    if(const Entry* entry = find(path, fileSize, modified); entry)
+      return *entry;
+  }
+
+  // Examine the ROM without holding the lock, so the scanner can continue
+  Entry entry = examine(node);
+
+  const std::scoped_lock lock(myMutex);
+
+  Entry& stored = myEntries[path] = std::move(entry);
+  // ROMs with an unknown modification time (e.g. inside ZIP files) are
+  // only kept in memory, since we can't tell when they change
+  if(stored.modified && !stored.md5.empty() && myRepository)
+    myRepository->save(path, serialize(stored));
+
+  return stored;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+string RomIndex::knownMD5(const FSNode& node)
+{
+  const size_t fileSize = node.getSize();
+  const uInt64 modified = node.getLastModified();
+
+  const std::scoped_lock lock(myMutex);
+
+  const Entry* entry = find(node.getPath(), fileSize, modified);
+  return entry ? entry->md5 : EmptyString();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RomIndex::scan(const FSList& files)
+{
+  const string key = files.empty() ? EmptyString()
+    : files.front().getPath() + '|' + files.back().getPath() + '|' +
+      std::to_string(files.size());
+  if(key == myScanKey)
+    return;
+
+  stopScan();
+  myScanKey = key;
+
+  StringList paths;
+  for(const auto& file: files)
+    if(file.isFile() && Bankswitch::isValidRomName(file))
+      paths.push_back(file.getPath());
+
+  if(paths.empty())
+    return;
+
+  myScanThread = std::thread([this, paths = std::move(paths)]
+  {
+    for(const auto& path: paths)
+    {
+      if(myStopScan)
+        break;
+
+      // Use a private node, the list's nodes are shared with the launcher
+      const FSNode node(path);
+      const uInt64 modified = node.getLastModified();
+      if(modified == 0)
+        continue;
+      {
+        const std::scoped_lock lock(myMutex);
+
+        if(myEntries.contains(path) || find(path, node.getSize(), modified))
+          continue;
+      }
+
+      Entry entry = examine(node);
+
+      const std::scoped_lock lock(myMutex);
+
+      // An entry added meanwhile by get() is never replaced
+      if(!myEntries.contains(path) && !entry.md5.empty())
+      {
+        myEntries.emplace(path, std::move(entry));
+        myPendingSaves.push_back(path);
+      }
+    }
+  });
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RomIndex::save()
+{
+  vector<std::pair<string, string>> infos;
+  {
+    const std::scoped_lock lock(myMutex);
+
+    if(myPendingSaves.empty() || !myRepository)
+      return;
+
+    for(const auto& path: myPendingSaves)
+      if(const auto it = myEntries.find(path); it != myEntries.end())
+        infos.emplace_back(path, serialize(it->second));
+    myPendingSaves.clear();
+  }
+
+  const KeyValueRepositoryBatch batch(myRepository.get());
+  for(const auto& [path, info]: infos)
+    myRepository->save(path, info);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+RomIndex::Entry RomIndex::examine(const FSNode& node) const
+{
+  Entry entry;
+
+  entry.fileSize = node.getSize();
+  entry.modified = node.getLastModified();
+
+  try
+  {
+    size_t size = 0;
+    string md5;
+    if(const ByteBuffer image = OSystem::openROM(node, size, false, &md5);
+       image != nullptr)
+    {
+      // The settings are only passed through by the detector, not accessed
+      const Settings& settings = myOSystem.settings();
+
+      entry.md5 = md5;
+      entry.type = Bankswitch::typeToName(CartDetector::autodetectType(image, size));
+      entry.left = Controller::getPropName(ControllerDetector::autodetectPort(
+          image, size, Controller::Jack::Left, settings, false));
+      entry.right = Controller::getPropName(ControllerDetector::autodetectPort(
+          image, size, Controller::Jack::Right, settings, false));
+      entry.plusROM = CartDetector::isProbablyPlusROM(image, size);
+      entry.romSize = size;
+    }
+  }
+  catch(const std::runtime_error&)
+  {
+    // Invalid ROMs result in an empty entry
+  }
+
+  return entry;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+const RomIndex::Entry* RomIndex::find(const string& path, size_t fileSize,
+                                      uInt64 modified)
+{
+  const auto isCurrent = [&](const Entry& entry) {
+    return entry.fileSize == fileSize && entry.modified == modified;
+  };
+
+  if(const auto it = myEntries.find(path); it != myEntries.end())
+    return isCurrent(it->second) ? &it->second : nullptr;
+
+  if(const auto it = myStored.find(path); it != myStored.end())
+    if(Entry entry = deserialize(it->second.toString()); isCurrent(entry))
+      return &(myEntries[path] = std::move(entry));
+
+  return nullptr;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RomIndex::stopScan()
+{
+  if(myScanThread.joinable())
+  {
+    myStopScan = true;
+    myScanThread.join();
+  }
+  myStopScan = false;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+string RomIndex::serialize(const Entry& entry)
+{
+  const json info = {
+    {"md5", entry.md5},
+    {"type", entry.type},
+    {"left", entry.left},
+    {"right", entry.right},
+    {"plusrom", entry.plusROM},
+    {"romsize", entry.romSize},
+    {"size", entry.fileSize},
+    {"modified", entry.modified}
+  };
+
+  return info.dump();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+RomIndex::Entry RomIndex::deserialize(const string& info)
+{
+  Entry entry;
+
+  try
+  {
+    const json parsed = json::parse(info);
+
+    entry.md5 = parsed.at("md5").get<string>();
+    entry.type = parsed.at("type").get<string>();
+    entry.left = parsed.at("left").get<string>();
+    entry.right = parsed.at("right").get<string>();
+    entry.plusROM = parsed.at("plusrom").get<bool>();
+    entry.romSize = parsed.at("romsize").get<size_t>();
+    entry.fileSize = parsed.at("size").get<size_t>();
+    entry.modified = parsed.at("modified").get<uInt64>();
+  }
+  catch(const json::exception&)
+  {
+    // A damaged entry never matches, and is replaced
+    entry.modified = 0;
+    entry.fileSize = 0;
+  }
+
+  return entry;
+}
@@ -0,0 +1,137 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2026 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#ifndef ROM_INDEX_HXX
+#define ROM_INDEX_HXX
+
+class OSystem;
+
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+#include "bspf.hxx"
+#include "FSNode.hxx"
+#include "repository/KeyValueRepository.hxx"
+
+/**
+  A persistent index of the information the launcher shows for each ROM
+  (MD5, detected bankswitch type and controllers), keyed by path and
+  validated by file size and modification time.
+
+  Entries are looked up and saved on the main thread only.  A background
+  thread may examine all ROMs of a directory in advance; its results are
+  stored in memory and written to the repository by the next call to
+  save().
+
+  @author  Stella Team
+*/
+class RomIndex
+{
+  public:
+    struct Entry {
+      string md5;
+      string type;          // detected bankswitch type
+      string left, right;   // detected controllers (property names)
+      bool plusROM{false};
+      size_t romSize{0};    // the size of the ROM data actually used
+
+      size_t fileSize{0};
+      uInt64 modified{0};
+    };
+
+  public:
+    explicit RomIndex(OSystem& osystem);
+    ~RomIndex();
+
+    void setRepository(shared_ptr<KeyValueRepositoryAtomic> repo);
+
+    /**
+      Get the index entry for the given ROM, examining the ROM if there
+      is no current entry for it.
+
+      @param node  The ROM file
+
+      @return  The entry; the MD5 is empty if the file is no valid ROM
+    */
+    const Entry& get(const FSNode& node);
+
+    /**
+      Get the MD5 of the given ROM, if it is already indexed.  Unlike get(),
+      this never examines the ROM.
+
+      @param node  The ROM file
+
+      @return  The MD5, or an empty string if there is no current entry
+    */
+    string knownMD5(const FSNode& node);
+
+    /**
+      Examine all ROMs in the given list in the background, unless this
+      list is already being (or was) scanned.
+
+      @param files  The contents of the current launcher directory
+    */
+    void scan(const FSList& files);
+
+    /**
+      Write all results from the background scanner to the repository.
+    */
+    void save();
+
+  private:
+    // Examines the ROM; this does not access any shared state
+    Entry examine(const FSNode& node) const;
+
+    // Returns the entry if it is still current
+    const Entry* find(const string& path, size_t fileSize, uInt64 modified);
+
+    void stopScan();
+
+    static string serialize(const Entry& entry);
+    static Entry deserialize(const string& info);
+
+  private:
+    OSystem& myOSystem;
+
+    shared_ptr<KeyValueRepositoryAtomic> myRepository;
+
+    // Entries as loaded from the repository, parsed on first use
+    KVRMap myStored;
+
+    // Parsed or newly created entries, protected by myMutex
+    std::unordered_map<string, Entry> myEntries;
+    std::mutex myMutex;
+
+    // Paths examined by the scanner, waiting to be saved
+    StringList myPendingSaves;
+
+    std::thread myScanThread;
+    std::atomic<bool> myStopScan{false};
+    string myScanKey;
+
+  private:
+    // Following constructors and assignment operators not supported
+    RomIndex() = delete;
+    RomIndex(const RomIndex&) = delete;
+    RomIndex(RomIndex&&) = delete;
+    RomIndex& operator=(const RomIndex&) = delete;
+    RomIndex& operator=(RomIndex&&) = delete;
+};
+
+#endif
@@ -0,0 +1,124 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2026 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#include "M6532.hxx"
+#include "ScoreTracker.hxx"
+
+namespace {
+  // RIOT RAM is only visible at $80 - $FF in the zero page
+  constexpr bool inRiotRAM(uInt16 addr) { return addr >= 0x80 && addr <= 0xff; }
+} // namespace
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+ScoreTracker::ScoreTracker(const HSM::ScoresProps& info, uInt32 numVariations)
+  : myInfo{info},
+    myNumVariations{numVariations},
+    myNumAddrBytes{std::min(
+      HighScoresManager::numAddrBytes(info.numDigits, info.trailingZeroes),
+      HSM::MAX_SCORE_ADDR)}
+{
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void ScoreTracker::attach(M6532& riot, const HighScoresManager::PeekFunc& peek)
+{
+  detach();
+  myRiot = &riot;
+  myPeek = peek;
+
+  const auto watch = [this](uInt16 addr) {
+    if(inRiotRAM(addr))
+      myRiot->watchRAM(addr);
+    else if(std::ranges::find(myPolled, addr) == myPolled.end())
+      myPolled.push_back(addr);
+  };
+  for(uInt32 b = 0; b < myNumAddrBytes; ++b)
+    watch(myInfo.scoreAddr[b]);
+  if(myInfo.varsAddr != HSM::DEFAULT_ADDRESS)
+    watch(myInfo.varsAddr);
+
+  myPolledValues.assign(myPolled.size(), HSM::NO_VALUE);
+  myScore = myVariation = HSM::NO_VALUE;
+  myPending = true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void ScoreTracker::detach()
+{
+  if(myRiot)
+    myRiot->clearRAMWatches();
+  myRiot = nullptr;
+  myPeek = nullptr;
+  myPolled.clear();
+  myPolledValues.clear();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool ScoreTracker::pollChanged()
+{
+  bool changed = false;
+
+  for(size_t i = 0; i < myPolled.size(); ++i)
+  {
+    const Int16 value = myPeek(myPolled[i]);
+    changed = changed || value != myPolledValues[i];
+    myPolledValues[i] = value;
+  }
+  return changed;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool ScoreTracker::update()
+{
+  if(!myRiot)
+    return false;
+
+  // Both must be called, to reset the watch and remember the polled values
+  const bool watched = myRiot->takeWatchedChanges();
+  const bool polled = pollChanged();
+  if(!watched && !polled && !myPending)
+    return false;
+
+  bool changed = false;
+
+  const Int32 variation = myInfo.varsAddr == HSM::DEFAULT_ADDRESS
+    ? (myNumVariations == 1 ? static_cast<Int32>(HSM::DEFAULT_VARIATION)
+                            : HSM::NO_VALUE)
+    : HighScoresManager::convert(myPeek(myInfo.varsAddr), myNumVariations,
+                                 myInfo.varsBCD, myInfo.varsZeroBased);
+  if(variation != myVariation)
+  {
+    const Int32 previous = std::exchange(myVariation, variation);
+    if(myVariationCallback)
+      myVariationCallback(variation, previous);
+    changed = true;
+  }
+
+  const Int32 score = HighScoresManager::score(myNumAddrBytes,
+      myInfo.trailingZeroes, myInfo.scoreBCD, myInfo.scoreAddr, myPeek);
+  // BCD scores are invalid while they are being updated, try again later
+  myPending = score == HSM::NO_VALUE;
+  if(!myPending && score != myScore)
+  {
+    const Int32 previous = std::exchange(myScore, score);
+    if(myScoreCallback)
+      myScoreCallback(score, previous);
+    changed = true;
+  }
+
+  return changed;
+}
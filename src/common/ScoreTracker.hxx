@@ -0,0 +1,110 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2026 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#ifndef SCORE_TRACKER_HXX
+#define SCORE_TRACKER_HXX
+
+class M6532;
+
+#include "bspf.hxx"
+#include "HighScoresManager.hxx"
+
+/**
+  Tracks the score and variation of a running console, as defined by the
+  ROM's high score properties, without reading and decoding them every
+  frame.  The addresses in RIOT RAM are watched for writes by the M6532,
+  so the (BCD) values are only decoded once they changed; the callbacks are
+  then called once per new value.  Addresses in cartridge RAM can't be
+  watched and are compared on each update instead.
+
+  Only one tracker can be attached to a RIOT at a time.
+
+  @author  Stella Team
+*/
+class ScoreTracker
+{
+  public:
+    // Called with the new and the previous value
+    using Callback = HighScoresManager::ScoreCallback;
+
+    ScoreTracker(const HSM::ScoresProps& info, uInt32 numVariations);
+    ~ScoreTracker() = default;
+
+    /**
+      Start watching the addresses of the given RIOT.
+
+      @param riot  The RIOT of the console
+      @param peek  Reads any of the addresses (also in cartridge RAM)
+    */
+    void attach(M6532& riot, const HighScoresManager::PeekFunc& peek);
+
+    /**
+      Stop watching; must be called before the RIOT is used otherwise.
+    */
+    void detach();
+
+    void onScoreChanged(const Callback& callback) { myScoreCallback = callback; }
+    void onVariationChanged(const Callback& callback) {
+      myVariationCallback = callback;
+    }
+
+    /**
+      Decode the values if their bytes changed, and call the callbacks.
+      Should be called after each frame.
+
+      @return  True if the score or the variation changed
+    */
+    bool update();
+
+    // The values as of the last update (HSM::NO_VALUE if not yet known)
+    Int32 score() const { return myScore; }
+    Int32 variation() const { return myVariation; }
+
+  private:
+    // Whether a byte outside RIOT RAM changed since the last update
+    bool pollChanged();
+
+  private:
+    HSM::ScoresProps myInfo;
+    uInt32 myNumVariations{1};
+    uInt32 myNumAddrBytes{0};
+
+    M6532* myRiot{nullptr};
+    HighScoresManager::PeekFunc myPeek;
+
+    // Addresses which are not in RIOT RAM, and their last values
+    vector<uInt16> myPolled;
+    vector<Int16> myPolledValues;
+
+    // A change was seen, but a BCD score was invalid (being updated)
+    bool myPending{false};
+
+    Int32 myScore{HSM::NO_VALUE};
+    Int32 myVariation{HSM::NO_VALUE};
+
+    Callback myScoreCallback, myVariationCallback;
+
+  private:
+    // Following constructors and assignment operators not supported
+    ScoreTracker() = delete;
+    ScoreTracker(const ScoreTracker&) = delete;
+    ScoreTracker(ScoreTracker&&) = delete;
+    ScoreTracker& operator=(const ScoreTracker&) = delete;
+    ScoreTracker& operator=(ScoreTracker&&) = delete;
+};
+
+#endif // SCORE_TRACKER_HXX
@@ -0,0 +1,96 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2026 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#include "SearchIndex.hxx"
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void SearchIndex::add(uInt32 id, string_view text)
+{
+  if(text.empty())
+    return;
+
+  const auto index = static_cast<uInt32>(myTexts.size());
+  string upper{text};
+  BSPF::toUpperCase(upper);
+
+  for(size_t i = 0; i + 3 <= upper.length(); ++i)
+  {
+    auto& texts = myTrigrams[trigram(&upper[i])];
+
+    // Texts are added in ascending order, so duplicates are at the end
+    if(texts.empty() || texts.back() != index)
+      texts.push_back(index);
+  }
+  myTexts.push_back({id, std::move(upper)});
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+std::vector<uInt32> SearchIndex::find(string_view pattern) const
+{
+  string upper{pattern};
+  BSPF::toUpperCase(upper);
+
+  // Collect the texts containing all trigrams of the literal parts
+  std::vector<const std::vector<uInt32>*> lists;
+  size_t literal = 0;  // length of the current literal part
+
+  for(size_t i = 0; i < upper.length(); ++i)
+  {
+    if(upper[i] == '*' || upper[i] == '?')
+      literal = 0;
+    else if(++literal >= 3)
+    {
+      const auto it = myTrigrams.find(trigram(&upper[i - 2]));
+      if(it == myTrigrams.end())
+        return {};
+      lists.push_back(&it->second);
+    }
+  }
+
+  std::vector<uInt32> candidates;
+  if(lists.empty())
+  {
+    // Too short for the index, all texts must be checked
+    candidates.resize(myTexts.size());
+    for(uInt32 i = 0; i < candidates.size(); ++i)
+      candidates[i] = i;
+  }
+  else
+  {
+    // Intersect, starting with the shortest list
+    std::ranges::sort(lists, {}, &std::vector<uInt32>::size);
+    candidates = *lists.front();
+    for(size_t l = 1; l < lists.size() && !candidates.empty(); ++l)
+    {
+      std::vector<uInt32> common;
+      std::ranges::set_intersection(candidates, *lists[l],
+                                    std::back_inserter(common));
+      candidates = std::move(common);
+    }
+  }
+
+  std::vector<uInt32> result;
+  for(const uInt32 i: candidates)
+    if(BSPF::matchWithWildcards(myTexts[i].text, upper))
+      result.push_back(myTexts[i].id);
+
+  std::ranges::sort(result);
+  const auto [first, last] = std::ranges::unique(result);
+  result.erase(first, last);
+
+  return result;
+}
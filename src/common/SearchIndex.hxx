@@ -0,0 +1,85 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2026 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#ifndef SEARCH_INDEX_HXX
+#define SEARCH_INDEX_HXX
+
+#include <unordered_map>
+
+#include "bspf.hxx"
+
+/**
+  An in-memory index for finding items by any of their texts, using the
+  (case insensitive) wildcard patterns of BSPF::matchWithWildcards().
+
+  Each text is split into trigrams (sequences of three characters).  Every
+  literal part of a pattern must appear in a matching text, so only the
+  texts containing all trigrams of the pattern have to be checked.
+
+  @author  Stella Team
+*/
+class SearchIndex
+{
+  public:
+    SearchIndex() = default;
+    ~SearchIndex() = default;
+
+    /**
+      Add a text to the given item; an item can have several texts.
+
+      @param id    The item the text belongs to
+      @param text  The text to be searched
+    */
+    void add(uInt32 id, string_view text);
+
+    /**
+      Find all items having at least one text matching the pattern.
+
+      @param pattern  The pattern, may contain '*' and '?' as wildcards
+
+      @return  The matching items, in ascending order
+    */
+    std::vector<uInt32> find(string_view pattern) const;
+
+    bool empty() const { return myTexts.empty(); }
+
+  private:
+    struct Text {
+      uInt32 id{0};
+      string text;  // in upper case
+    };
+
+    static constexpr uInt32 trigram(const char* s) {
+      return static_cast<uInt8>(s[0]) << 16 | static_cast<uInt8>(s[1]) << 8 |
+             static_cast<uInt8>(s[2]);
+    }
+
+  private:
+    std::vector<Text> myTexts;
+
+    // The indices of the texts containing each trigram, in ascending order
+    std::unordered_map<uInt32, std::vector<uInt32>> myTrigrams;
+
+  private:
+    // Following constructors and assignment operators not supported
+    SearchIndex(const SearchIndex&) = delete;
+    SearchIndex(SearchIndex&&) = delete;
+    SearchIndex& operator=(const SearchIndex&) = delete;
+    SearchIndex& operator=(SearchIndex&&) = delete;
+};
+
+#endif
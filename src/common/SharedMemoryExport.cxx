@@ -0,0 +1,286 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2026 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+
+#ifdef GUI_SUPPORT
+
+#if defined(BSPF_WINDOWS)
+  #include "Windows.hxx"
+#else
+  #include <fcntl.h>
+  #include <sys/mman.h>
+  #include <unistd.h>
+#endif
+
+#include "Console.hxx"
+#include "EmulationTiming.hxx"
+#include "FrameBuffer.hxx"
+#include "Logger.hxx"
+#include "OSystem.hxx"
+#include "Settings.hxx"
+#include "TIA.hxx"
+#include "TIASurface.hxx"
+#include "SharedMemoryExport.hxx"
+
+namespace {
+  constexpr size_t align64(size_t size) { return (size + 63) & ~size_t{63}; }
+} // namespace
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+SharedMemoryExport::SharedMemoryExport(OSystem& osystem)
+  : myOSystem{osystem}
+{
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+SharedMemoryExport::~SharedMemoryExport()
+{
+  stop();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void SharedMemoryExport::start()
+{
+  stop();
+
+  const string& name = myOSystem.settings().getString("shmexport");
+  if(name.empty())
+    return;
+
+  myFormat = myOSystem.settings().getString("shmformat") == "rgba"
+    ? Format::RGBA : Format::Indices;
+  const size_t bytesPerPixel = myFormat == Format::RGBA ? 4 : 1;
+
+  myFrameSlotSize = static_cast<uInt32>(align64(sizeof(FrameSlot) +
+    TIAConstants::H_PIXEL * TIAConstants::frameBufferHeight * bytesPerPixel));
+  myAudioSlotSize = static_cast<uInt32>(align64(sizeof(AudioSlot) +
+    AUDIO_SLOT_SAMPLES * 2 * sizeof(Int16)));
+
+  const size_t headerSize = align64(sizeof(Header));
+  const size_t size = headerSize + static_cast<size_t>(FRAME_SLOTS) * myFrameSlotSize +
+                      static_cast<size_t>(AUDIO_SLOTS) * myAudioSlotSize;
+
+  if(!mapSegment(name, size))
+  {
+    Logger::error("ERROR: Couldn't create shared memory '" + name + "'");
+    myOSystem.frameBuffer().showTextMessage("Couldn't create shared memory");
+    return;
+  }
+
+  // The segment may be left over from an earlier run, so initialize it all
+  myHeader = new(mySegment) Header{};
+  myFrameSlots = mySegment + headerSize;
+  myAudioSlots = myFrameSlots + static_cast<size_t>(FRAME_SLOTS) * myFrameSlotSize;
+  for(uInt32 i = 0; i < FRAME_SLOTS; ++i)
+    new(myFrameSlots + static_cast<size_t>(i) * myFrameSlotSize) FrameSlot{};
+  for(uInt32 i = 0; i < AUDIO_SLOTS; ++i)
+    new(myAudioSlots + static_cast<size_t>(i) * myAudioSlotSize) AudioSlot{};
+
+  myHeader->version = VERSION;
+  myHeader->format = myFormat;
+  myHeader->frameSlots = FRAME_SLOTS;
+  myHeader->frameSlotSize = myFrameSlotSize;
+  myHeader->audioSlots = AUDIO_SLOTS;
+  myHeader->audioSlotSize = myAudioSlotSize;
+  myHeader->audioSampleRate =
+    myOSystem.console().emulationTiming().audioSampleRate();
+  updatePalette();
+  std::atomic_thread_fence(std::memory_order_release);
+  myHeader->magic = {'S', 'S', 'H', 'M'};
+
+  myFrameSequence = myAudioSequence = 0;
+
+  myTIA = &myOSystem.console().tia();
+  if(const auto queue = myOSystem.console().sharedAudioQueue(); queue)
+  {
+    myAudioTap = AudioQueue::openTap(queue);
+    if(!myAudioTap)
+      Logger::error("ERROR: Couldn't export audio to shared memory '" + name + "'");
+  }
+
+  Logger::info("Exporting frames and audio to shared memory '" + name + "'");
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void SharedMemoryExport::stop()
+{
+  if(!isExporting())
+    return;
+
+  myAudioTap.reset();
+  myTIA = nullptr;
+  unmapSegment();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void SharedMemoryExport::addFrame(uInt32 frames)
+{
+  if(!isExporting())
+    return;
+
+  updatePalette();
+
+  const uInt64 sequence = ++myFrameSequence;
+  auto* slot = reinterpret_cast<FrameSlot*>(
+    myFrameSlots + ((sequence - 1) % FRAME_SLOTS) * myFrameSlotSize);
+  uInt8* pixels = reinterpret_cast<uInt8*>(slot) + sizeof(FrameSlot);
+
+  // Invalidate the slot while it is written
+  slot->sequence.store(0, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+
+  const uInt8* frame = myTIA->frameBuffer();
+  const uInt32 height = std::min(myTIA->height(), TIAConstants::frameBufferHeight);
+  const size_t count = static_cast<size_t>(TIAConstants::H_PIXEL) * height;
+
+  slot->width = TIAConstants::H_PIXEL;
+  slot->height = height;
+  slot->frames = frames;
+  if(myFormat == Format::RGBA)
+  {
+    const auto& palette = myHeader->palette;
+    for(size_t i = 0; i < count; ++i, pixels += 4)
+    {
+      const uInt32 rgb = palette[frame[i]];
+      pixels[0] = static_cast<uInt8>(rgb >> 16);
+      pixels[1] = static_cast<uInt8>(rgb >> 8);
+      pixels[2] = static_cast<uInt8>(rgb);
+      pixels[3] = 0xff;
+    }
+  }
+  else
+    std::copy_n(frame, count, pixels);
+
+  slot->sequence.store(sequence, std::memory_order_release);
+  myHeader->frameSequence.store(sequence, std::memory_order_release);
+
+  if(myAudioTap)
+  {
+    const AudioQueue& queue = myAudioTap->queue();
+    while(const Int16* fragment = myAudioTap->read())
+      addAudio(fragment, queue.fragmentSize(), queue.isStereo());
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void SharedMemoryExport::addAudio(const Int16* fragment, uInt32 samples,
+                                  bool stereo)
+{
+  const uInt32 channels = stereo ? 2 : 1;
+
+  // Fragments larger than a slot are split
+  while(samples > 0)
+  {
+    const uInt32 count = std::min(samples, AUDIO_SLOT_SAMPLES);
+    const uInt64 sequence = ++myAudioSequence;
+    auto* slot = reinterpret_cast<AudioSlot*>(
+      myAudioSlots + ((sequence - 1) % AUDIO_SLOTS) * myAudioSlotSize);
+
+    slot->sequence.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    slot->samples = count;
+    slot->channels = channels;
+    std::copy_n(fragment, static_cast<size_t>(count) * channels,
+                reinterpret_cast<Int16*>(reinterpret_cast<uInt8*>(slot) +
+                                         sizeof(AudioSlot)));
+
+    slot->sequence.store(sequence, std::memory_order_release);
+    myHeader->audioSequence.store(sequence, std::memory_order_release);
+
+    fragment += static_cast<size_t>(count) * channels;
+    samples -= count;
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void SharedMemoryExport::updatePalette()
+{
+  const PaletteArray& palette = myOSystem.frameBuffer().tiaSurface().rgbPalette();
+
+  if(!std::equal(palette.begin(), palette.end(), myHeader->palette.begin()))
+  {
+    std::copy(palette.begin(), palette.end(), myHeader->palette.begin());
+    ++myHeader->paletteVersion;
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool SharedMemoryExport::mapSegment(const string& name, size_t size)
+{
+  void* segment = nullptr;
+
+#if defined(BSPF_WINDOWS)
+  myName = "Local\\" + name;
+  HANDLE mapping = CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr,
+      PAGE_READWRITE, static_cast<DWORD>(static_cast<uInt64>(size) >> 32),
+      static_cast<DWORD>(size), myName.c_str());
+  if(mapping == nullptr)
+    return false;
+
+  segment = MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, size);
+  if(segment == nullptr)
+  {
+    CloseHandle(mapping);
+    return false;
+  }
+  myMapping = mapping;
+#else
+  myName = "/" + name;
+  const int fd = shm_open(myName.c_str(), O_CREAT | O_RDWR, 0644);
+  if(fd < 0)
+    return false;
+
+  if(ftruncate(fd, static_cast<off_t>(size)) == 0)
+    segment = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+
+  if(segment == nullptr || segment == MAP_FAILED)
+  {
+    shm_unlink(myName.c_str());
+    return false;
+  }
+#endif
+
+  mySegment = static_cast<uInt8*>(segment);
+  mySegmentSize = size;
+
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void SharedMemoryExport::unmapSegment()
+{
+  if(mySegment == nullptr)
+    return;
+
+#if defined(BSPF_WINDOWS)
+  UnmapViewOfFile(mySegment);
+  CloseHandle(myMapping);
+  myMapping = nullptr;
+#else
+  munmap(mySegment, mySegmentSize);
+  // Readers which still have the segment mapped can continue to use it
+  shm_unlink(myName.c_str());
+#endif
+
+  mySegment = myFrameSlots = myAudioSlots = nullptr;
+  myHeader = nullptr;
+  mySegmentSize = 0;
+}
+
+#endif  // GUI_SUPPORT
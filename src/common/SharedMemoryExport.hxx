@@ -0,0 +1,185 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2026 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+
+#ifdef GUI_SUPPORT
+
+#ifndef SHARED_MEMORY_EXPORT_HXX
+#define SHARED_MEMORY_EXPORT_HXX
+
+#include <atomic>
+
+#include "bspf.hxx"
+#include "AudioQueue.hxx"
+#include "TIAConstants.hxx"
+
+class OSystem;
+class TIA;
+
+/**
+  This class exports the emulated frames and sound into a named shared
+  memory segment ('shmexport'), so that other processes (recorders,
+  analyzers, encoders) can read them without any copying through files or
+  sockets.  On POSIX systems the segment is created with shm_open() (i.e.
+  '/dev/shm/<name>' on Linux), on Windows as the file mapping
+  'Local\<name>'.
+
+  The segment starts with a header (native byte order):
+    "SSHM", version, pixel format (0 = palette indices, 1 = RGBA),
+    number and size of the frame slots, number and size of the audio slots,
+    audio sample rate, palette version, a reserved value (all 4 bytes),
+    frame sequence, audio sequence (8 bytes each),
+    palette (256 * 4 bytes, 0x00RRGGBB)
+  followed by two rings of slots.  A frame slot consists of its sequence
+  (8 bytes), width, height, number of emulated frames, a reserved value
+  (4 bytes each) and the pixels; an audio slot of its sequence (8 bytes),
+  the number of samples per channel, the number of channels (4 bytes each)
+  and the (interleaved) 16 bit samples.  The palette version is increased
+  whenever the palette changes.
+
+  The sequences in the header count the frames/fragments written so far;
+  item n (starting at 1) is stored in slot (n - 1) % slots.  While a slot is
+  written, its sequence is 0.  So a reader has to read the slot's sequence,
+  copy the data, and then check that the sequence is still the expected
+  one; otherwise the slot was overwritten meanwhile.
+
+  @author  Stella Team
+*/
+class SharedMemoryExport
+{
+  public:
+    explicit SharedMemoryExport(OSystem& osystem);
+    ~SharedMemoryExport();
+
+    /**
+      Answer whether the export is active.
+    */
+    bool isExporting() const { return myTIA != nullptr; }
+
+    /**
+      Start exporting the current console, if 'shmexport' names a segment.
+    */
+    void start();
+
+    /**
+      Stop exporting and remove the segment.
+    */
+    void stop();
+
+    /**
+      Export the frame just rendered by the TIA (must not be called while
+      the emulation runs on another thread), and the audio fragments
+      produced since the previous one.
+
+      @param frames  The number of frames emulated since the last one
+    */
+    void addFrame(uInt32 frames);
+
+  private:
+    static constexpr uInt32 VERSION = 1;
+    static constexpr uInt32 FRAME_SLOTS = 8;
+    static constexpr uInt32 AUDIO_SLOTS = 64;
+    static constexpr uInt32 AUDIO_SLOT_SAMPLES = 2048;  // per channel
+
+    enum class Format: uInt32 { Indices = 0, RGBA = 1 };
+
+    struct Header {
+      std::array<char, 4> magic;
+      uInt32 version;
+      Format format;
+      uInt32 frameSlots;
+      uInt32 frameSlotSize;
+      uInt32 audioSlots;
+      uInt32 audioSlotSize;
+      uInt32 audioSampleRate;
+      uInt32 paletteVersion;
+      uInt32 reserved;
+      std::atomic<uInt64> frameSequence;
+      std::atomic<uInt64> audioSequence;
+      std::array<uInt32, 256> palette;
+    };
+
+    struct FrameSlot {
+      std::atomic<uInt64> sequence;
+      uInt32 width;
+      uInt32 height;
+      uInt32 frames;
+      uInt32 reserved;
+      // followed by the pixels
+    };
+
+    struct AudioSlot {
+      std::atomic<uInt64> sequence;
+      uInt32 samples;
+      uInt32 channels;
+      // followed by the samples
+    };
+
+    static_assert(std::atomic<uInt64>::is_always_lock_free,
+                  "shared memory requires lock-free atomics");
+
+  private:
+    bool mapSegment(const string& name, size_t size);
+    void unmapSegment();
+
+    /**
+      Export an audio fragment read from the tap.
+    */
+    void addAudio(const Int16* fragment, uInt32 samples, bool stereo);
+
+    void updatePalette();
+
+  private:
+    // Global OSystem object
+    OSystem& myOSystem;
+
+    // The TIA being exported, nullptr if not exporting
+    TIA* myTIA{nullptr};
+
+    // Reads the audio fragments while they are queued for playback
+    unique_ptr<AudioQueue::Tap> myAudioTap;
+
+    // The mapped segment and its parts
+    uInt8* mySegment{nullptr};
+    size_t mySegmentSize{0};
+    Header* myHeader{nullptr};
+    uInt8* myFrameSlots{nullptr};
+    uInt8* myAudioSlots{nullptr};
+
+    Format myFormat{Format::Indices};
+    uInt32 myFrameSlotSize{0}, myAudioSlotSize{0};
+
+    // Only accessed by the main thread, the shared counters are only written
+    uInt64 myFrameSequence{0}, myAudioSequence{0};
+
+    string myName;
+  #ifdef BSPF_WINDOWS
+    void* myMapping{nullptr};
+  #endif
+
+  private:
+    // Following constructors and assignment operators not supported
+    SharedMemoryExport() = delete;
+    SharedMemoryExport(const SharedMemoryExport&) = delete;
+    SharedMemoryExport(SharedMemoryExport&&) = delete;
+    SharedMemoryExport& operator=(const SharedMemoryExport&) = delete;
+    SharedMemoryExport& operator=(SharedMemoryExport&&) = delete;
+};
+
+#endif
+
+#endif  // GUI_SUPPORT
@@ -0,0 +1,127 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2026 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#ifdef IMAGE_SUPPORT
+
+#include <ctime>
+
+#include "SnapshotIndex.hxx"
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+SnapshotIndex::SnapshotIndex(const FSNode& dir)
+  : myDir{dir},
+    myBuild{std::async(std::launch::async, &SnapshotIndex::build, dir)},
+    myLastCheck{std::chrono::steady_clock::now()}
+{
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+FSList SnapshotIndex::find(string_view name)
+{
+  refresh();
+
+  // Without any index yet, there's nothing else to do than to wait
+  if(!myIndex && myBuild.valid())
+    myIndex = myBuild.get();
+  if(!myIndex)
+    return {};
+
+  const auto it = myIndex->images.find(key(name));
+  return it != myIndex->images.end() ? it->second : FSList{};
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void SnapshotIndex::refresh(bool force)
+{
+  using namespace std::chrono;
+
+  if(myBuild.valid())
+  {
+    if(myBuild.wait_for(seconds(0)) != std::future_status::ready)
+      return;
+    myIndex = myBuild.get();
+  }
+
+  const steady_clock::time_point now = steady_clock::now();
+  if(!force && now - myLastCheck < CHECK_INTERVAL)
+    return;
+  myLastCheck = now;
+
+  // The modification time only has a resolution of seconds; the index can
+  // only be trusted if it was built after the second of the last change
+  const uInt64 modified = myDir.getLastModified();
+  if(myIndex && myIndex->modified == modified && modified != 0 &&
+     modified < myIndex->listed)
+    return;
+
+  myBuild = std::async(std::launch::async, &SnapshotIndex::build, myDir);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+SnapshotIndex::IndexPtr SnapshotIndex::build(const FSNode& dir)
+{
+  auto index = std::make_shared<Index>();
+  index->modified = dir.getLastModified();
+  index->listed = static_cast<uInt64>(std::time(nullptr));
+
+  FSList files;
+  dir.getChildren(files, FSNode::ListMode::FilesOnly,
+    [](const FSNode& node) {
+      return BSPF::endsWithIgnoreCase(node.getName(), ".png") ||
+             BSPF::endsWithIgnoreCase(node.getName(), ".jpg");
+    }, false, false);
+
+  for(auto& file: files)
+  {
+    const string name = key(file.getName());
+    index->images[name].push_back(file);
+
+    // Numbered images belong to the name before the number, too
+    const size_t sep = name.find_last_of('_');
+    if(sep != string::npos && sep + 1 < name.size() &&
+       std::ranges::all_of(name.substr(sep + 1),
+                           [](char c) { return c >= '0' && c <= '9'; }))
+      index->images[name.substr(0, sep)].push_back(file);
+  }
+
+  for(auto& [name, images]: index->images)
+    std::ranges::sort(images, [](const FSNode& node1, const FSNode& node2)
+    {
+      const int compare = BSPF::compareIgnoreCase(
+        node1.getNameWithExt(), node2.getNameWithExt());
+      // PNGs first!
+      return compare < 0 ||
+        (compare == 0 && BSPF::endsWithIgnoreCase(node1.getName(), ".png") &&
+                         !BSPF::endsWithIgnoreCase(node2.getName(), ".png"));
+    });
+
+  return index;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+string SnapshotIndex::key(string_view name)
+{
+  string s{name};
+  if(const size_t dot = s.find_last_of('.');
+     dot != string::npos && (BSPF::endsWithIgnoreCase(s, ".png") ||
+                             BSPF::endsWithIgnoreCase(s, ".jpg")))
+    s.erase(dot);
+
+  return BSPF::toLowerCase(s);
+}
+
+#endif  // IMAGE_SUPPORT
@@ -0,0 +1,105 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2026 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#ifdef IMAGE_SUPPORT
+
+#ifndef SNAPSHOT_INDEX_HXX
+#define SNAPSHOT_INDEX_HXX
+
+#include <chrono>
+#include <future>
+#include <unordered_map>
+
+#include "bspf.hxx"
+#include "FSNode.hxx"
+
+/**
+  An index of the images in the snapshot directory, so that the launcher
+  can find the snapshots of a ROM without probing the file system for every
+  name variant and extension (which is slow on network file systems).
+
+  The directory is listed once in the background, and each image is
+  indexed by its name without extension, ignoring case; numbered images
+  (<name>_<n>.png|jpg) are indexed by <name> as well.  The directory's
+  modification time, which changes when images are added, removed or
+  renamed, is checked at most every few seconds; if it changed, the index
+  is built again in the background, while the old one is still used.
+
+  @author  Stella Team
+*/
+class SnapshotIndex
+{
+  public:
+    explicit SnapshotIndex(const FSNode& dir);
+    ~SnapshotIndex() = default;
+
+    const string& path() const { return myDir.getPath(); }
+
+    /**
+      Get the images <name>.png|jpg and <name>_<n>.png|jpg, ignoring case.
+      The very first call waits until the directory was listed.
+
+      @param name  The ROM name (without extension)
+      @return  The images, sorted by name, PNG before JPG
+    */
+    FSList find(string_view name);
+
+    /**
+      Check whether the directory changed, and if so, build the index again
+      in the background.
+
+      @param force  Check now, e.g. when images may have just been saved,
+                    instead of at most every few seconds
+    */
+    void refresh(bool force = false);
+
+  private:
+    struct Index {
+      std::unordered_map<string, FSList> images;
+      uInt64 modified{0};  // of the directory
+      uInt64 listed{0};    // when the directory was listed
+    };
+    using IndexPtr = shared_ptr<const Index>;
+
+    static IndexPtr build(const FSNode& dir);
+
+    // Lower case, without extension
+    static string key(string_view name);
+
+  private:
+    FSNode myDir;
+
+    IndexPtr myIndex;
+    std::future<IndexPtr> myBuild;
+
+    std::chrono::steady_clock::time_point myLastCheck;
+
+    // Minimum time between checks of the directory
+    static constexpr std::chrono::seconds CHECK_INTERVAL{2};
+
+  private:
+    // Following constructors and assignment operators not supported
+    SnapshotIndex() = delete;
+    SnapshotIndex(const SnapshotIndex&) = delete;
+    SnapshotIndex(SnapshotIndex&&) = delete;
+    SnapshotIndex& operator=(const SnapshotIndex&) = delete;
+    SnapshotIndex& operator=(SnapshotIndex&&) = delete;
+};
+
+#endif
+
+#endif  // IMAGE_SUPPORT
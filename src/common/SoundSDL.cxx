@@ -30,7 +30,10 @@
 #include "AudioSettings.hxx"
 #include "audio/SimpleResampler.hxx"
 #include "audio/LanczosResampler.hxx"
+#include "audio/BlepResampler.hxx"
 #include "ThreadDebugging.hxx"
+#include "ThreadScheduling.hxx"
+#include "PerfCounters.hxx"
 
 #include "SoundSDL.hxx"
 
@@ -59,8 +62,8 @@ SoundSDL::SoundSDL(OSystem& osystem, AudioSettings& audioSettings)
 
   Logger::debug("SoundSDL::SoundSDL initialized");
 
-  // Reserve 8K for the audio buffer; seems to be enough on most systems
-  myBuffer.reserve(8_KB);
+  // Allocate 8K for the audio buffer; seems to be enough on most systems
+  myBuffer.resize(8_KB);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -96,13 +99,38 @@ bool SoundSDL::openDevice()
   {
     SDL_DestroyAudioStream(myStream);
     myStream = nullptr;
+    SDL_CloseAudioDevice(myDevice);
+    myDevice = 0;
   }
 
-  mySpec = { SDL_AUDIO_F32, 2, static_cast<int>(myAudioSettings.sampleRate()) };
+  myRequestedSampleRate = myAudioSettings.sampleRate();
+  myRequestedFragmentSize = myAudioSettings.fragmentSize();
+  myCallbackPriority = ThreadScheduling::parsePriority(
+      myOSystem.settings().getString("threads.priority"));
+  myCallbackScheduled = false;
+
+  // Let the device ask for one fragment per callback, which is then filled
+  // in a single pass
+  SDL_SetHint(SDL_HINT_AUDIO_DEVICE_SAMPLE_FRAMES,
+              std::to_string(myRequestedFragmentSize).c_str());
+
+  mySpec = { SDL_AUDIO_F32, 2, static_cast<int>(myRequestedSampleRate) };
 
   myDevice = SDL_OpenAudioDevice(SDL_AUDIO_DEVICE_DEFAULT_PLAYBACK, &mySpec);
   if(myDevice == 0)
     return SOUND_ERROR();
+
+  // Resample straight to the rate and channels the device actually runs
+  // at, so that the stream only has to pass the samples through.  The
+  // samples stay float, which is what SDL mixes in anyway.
+  SDL_AudioSpec deviceSpec{};
+  int deviceFrames = 0;
+  if(SDL_GetAudioDeviceFormat(myDevice, &deviceSpec, &deviceFrames))
+  {
+    mySpec.freq = deviceSpec.freq;
+    mySpec.channels = deviceSpec.channels == 1 ? 1 : 2;
+  }
+
   myStream = SDL_CreateAudioStream(&mySpec, nullptr);
   if(!myStream)
     return SOUND_ERROR();
@@ -147,7 +175,8 @@ void SoundSDL::open(shared_ptr<AudioQueue> audioQueue,
 
   // Do we need to re-open the sound device?
   // Only do this when absolutely necessary
-  if(myAudioSettings.sampleRate() != static_cast<uInt32>(mySpec.freq))
+  if(myAudioSettings.sampleRate() != myRequestedSampleRate ||
+     myAudioSettings.fragmentSize() != myRequestedFragmentSize)
     openDevice();
 
   Logger::debug("SoundSDL::open started ...");
@@ -217,7 +246,10 @@ void SoundSDL::setVolume(uInt32 volume, bool persist)
       ? static_cast<float>(volume) / 100.F
       : 0.F;
 
-    SDL_SetAudioStreamGain(myStream, myVolumeFactor);
+    // The volume is applied by the resampler, which saves another pass
+    // over the samples in the stream
+    if(myResampler)
+      myResampler->setVolume(myVolumeFactor);
     myWavHandler.setVolumeFactor(myVolumeFactor);
 
     if(persist)
@@ -277,7 +309,10 @@ string SoundSDL::about() const
     default:
       break;  // Not supposed to get here
   }
-  buf << "    Sample rate:   " << static_cast<uInt32>(mySpec.freq) << " Hz\n";
+  buf << "    Sample rate:   " << static_cast<uInt32>(mySpec.freq) << " Hz";
+  if(static_cast<uInt32>(mySpec.freq) != myRequestedSampleRate)
+    buf << " (device rate, " << myRequestedSampleRate << " Hz requested)";
+  buf << '\n';
   buf << "    Resampling:    ";
   switch(myAudioSettings.resamplingQuality())
   {
@@ -291,6 +326,9 @@ string SoundSDL::about() const
     case lanczos_3:
       buf << "Quality 3, Lanczos (a = 3)\n";
       break;
+    case blep:
+      buf << "Quality 4, band-limited steps\n";
+      break;
     default:
       break;  // Not supposed to get here
   }
@@ -306,17 +344,27 @@ void SoundSDL::initResampler()
 {
   const Resampler::NextFragmentCallback nextFragmentCallback = [this] () -> Int16* {
     Int16* nextFragment = nullptr;
+    const uInt32 prebuffer = myEmulationTiming->prebufferFragmentCount();
 
     if(myUnderrun)
-      nextFragment = myAudioQueue->size() >= myEmulationTiming->prebufferFragmentCount()
+    {
+      nextFragment = myAudioQueue->size() >= prebuffer
         ? myAudioQueue->dequeue(myCurrentFragment)
         : nullptr;
+      if(nextFragment)
+        myResampler->resetRate(myAudioQueue->size());
+    }
     else
       nextFragment = myAudioQueue->dequeue(myCurrentFragment);
 
     myUnderrun = nextFragment == nullptr;
     if(nextFragment)
+    {
       myCurrentFragment = nextFragment;
+      // Keep the queue at the prebuffered fill, which drains any latency
+      // accumulated from drifting emulation and audio device clocks
+      myResampler->adjustRate(myAudioQueue->size(), prebuffer);
+    }
 
     return nextFragment;
   };
@@ -344,26 +392,44 @@ void SoundSDL::initResampler()
                                                   nextFragmentCallback, 3);
       break;
 
+    case blep:
+      myResampler = std::make_unique<BlepResampler>(formatFrom, formatTo,
+                                               nextFragmentCallback);
+      break;
+
     default:
       throw std::runtime_error("invalid resampling quality");
   }
+  myResampler->setVolume(myVolumeFactor);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void SoundSDL::audioCallback(void* object, SDL_AudioStream* stream,
                              int additional_amt, int)
 {
+  PERF_SCOPE(AudioCallback);
+
   auto* self = static_cast<SoundSDL*>(object);
+
+  // The callback runs on a thread owned by SDL, which is only known here
+  if(!self->myCallbackScheduled)
+  {
+    ThreadScheduling::setPriority(self->myCallbackPriority,
+                                  ThreadScheduling::Task::audio);
+    self->myCallbackScheduled = true;
+  }
+
   if(self->myResampler)
   {
     std::vector<uInt8>& buf = self->myBuffer;
 
     // Make sure we always have enough room in the buffer
-    if(std::cmp_greater_equal(additional_amt, buf.capacity()))
+    if(std::cmp_greater(additional_amt, buf.size()))
       buf.resize(additional_amt);
 
     // The stream is 32-bit float (even though this callback is 8-bits), since
-    // the resampler and TIA audio subsystem always generate float samples
+    // the resampler generates float samples.  Resampling, high-pass and
+    // volume are all done in this single pass over the whole request.
     auto* s = reinterpret_cast<float*>(buf.data());
     self->myResampler->fillFragment(s, additional_amt >> 2);
 
@@ -387,6 +453,12 @@ void SoundSDL::stopWav()
   myWavHandler.stop();
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void SoundSDL::prefetchWav(const string& fileName)
+{
+  WavCache::prefetch(fileName);
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 uInt32 SoundSDL::wavSize() const
 {
@@ -397,26 +469,20 @@ uInt32 SoundSDL::wavSize() const
 bool SoundSDL::WavHandler::play(SDL_AudioDeviceID device,
     const string& fileName, uInt32 position, uInt32 length)
 {
-  // Load WAV file
-  if(fileName != myFilename || myBuffer == nullptr)
-  {
-    if(myBuffer)
-    {
-      SDL_free(myBuffer);
-      myBuffer = nullptr;
-    }
-    SDL_zero(mySpec);
-    if(!SDL_LoadWAV(fileName.c_str(), &mySpec, &myBuffer, &myLength))
-      return false;
-  }
+  // Usually prefetched and decoded already
+  WavCache::WavPtr wav = WavCache::get(fileName);
+  if(!wav)
+    return false;
 
-  if(position > myLength)
+  const auto wavLength = static_cast<uInt32>(wav->samples.size());
+  if(position > wavLength)
     return false;
 
   if(myStream)
     SDL_UnbindAudioStream(myStream);
+  myRemaining = 0;
 
-  myStream = SDL_CreateAudioStream(&mySpec, nullptr);
+  myStream = SDL_CreateAudioStream(&wav->spec, nullptr);
   if(myStream == nullptr)
     return false;
   if(!SDL_BindAudioStream(device, myStream))
@@ -425,11 +491,11 @@ bool SoundSDL::WavHandler::play(SDL_AudioDeviceID device,
     return false;
   SDL_SetAudioStreamGain(myStream, myVolumeFactor);
 
-  myFilename = fileName;
+  myWav = std::move(wav);
+  myPos = myWav->samples.data() + position;
   myRemaining = length
-    ? std::min(length, myLength - position)
-    : myLength;
-  myPos = myBuffer + position;
+    ? std::min(length, wavLength - position)
+    : wavLength;
 
   return true;
 }
@@ -437,12 +503,12 @@ bool SoundSDL::WavHandler::play(SDL_AudioDeviceID device,
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void SoundSDL::WavHandler::stop()
 {
-  if(myBuffer)
+  if(myWav)
   {
-    // Clean up
+    // Clean up; the samples stay in the cache
     myRemaining = 0;
     SDL_UnbindAudioStream(myStream);  myStream = nullptr;
-    SDL_free(myBuffer);  myBuffer = nullptr;
+    myWav.reset();
   }
 }
 
@@ -487,13 +553,4 @@ void SoundSDL::WavHandler::wavCallback(void* object, SDL_AudioStream* stream,
   }
 }
 
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-SoundSDL::WavHandler::~WavHandler()
-{
-  ASSERT_MAIN_THREAD;
-
-  if(myBuffer)
-    SDL_free(myBuffer);
-}
-
 #endif  // SOUND_SUPPORT
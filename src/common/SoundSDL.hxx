@@ -30,6 +30,8 @@ class Resampler;
 
 #include "bspf.hxx"
 #include "Sound.hxx"
+#include "ThreadScheduling.hxx"
+#include "WavCache.hxx"
 
 /**
   This class implements the sound API for SDL.
@@ -126,6 +128,14 @@ class SoundSDL : public Sound
     */
     void stopWav() override;
 
+    /**
+      Decode a WAV file in the background, so that it can be played
+      without delay later on.
+
+      @param fileName  The name of the WAV file
+    */
+    void prefetchWav(const string& fileName) override;
+
     /**
       Get the size of the WAV file which remains to be played.
 
@@ -149,9 +159,19 @@ class SoundSDL : public Sound
     // Indicates if the sound device was successfully initialized
     bool myIsInitializedFlag{false};
 
-    // Audio specification structure
+    // Audio specification structure (of the stream, which matches the
+    // device's rate and channels)
     SDL_AudioSpec mySpec{};
 
+    // The sample rate and fragment size the device was opened with
+    uInt32 myRequestedSampleRate{0};
+    uInt32 myRequestedFragmentSize{0};
+
+    // The priority of the audio callback thread, which is raised by the
+    // first callback
+    ThreadScheduling::Priority myCallbackPriority{ThreadScheduling::Priority::normal};
+    bool myCallbackScheduled{false};
+
     // Audio device and stream, which handles all interaction with SDL sound backend
     SDL_AudioDeviceID myDevice{};
     SDL_AudioStream* myStream{nullptr};
@@ -178,27 +198,24 @@ class SoundSDL : public Sound
     {
       public:
         explicit WavHandler() = default;
-        ~WavHandler();
+        ~WavHandler() = default;
 
         bool play(SDL_AudioDeviceID device, const string& fileName,
                   uInt32 position, uInt32 length);
         void stop();
-        uInt32 size() const { return myBuffer ? myRemaining : 0; }
+        uInt32 size() const { return myWav ? myRemaining : 0; }
         void setSpeed(double speed) { mySpeed = speed; }
         void setVolumeFactor(float volumeFactor);
         void pause(bool state) const;
 
       private:
-        string myFilename;
         SDL_AudioStream* myStream{nullptr};
-        SDL_AudioSpec mySpec{};
-        uInt8* myBuffer{nullptr};
-        uInt32 myLength{0};
+        WavCache::WavPtr myWav;  // the decoded samples, owned by the cache
         double mySpeed{1.0};
         float myVolumeFactor{1.F};  // Current volume level (0.F - 1.F)
 
-        uInt8* myPos{nullptr};  // pointer to the audio buffer to be played
-        uInt32 myRemaining{0};  // remaining length of the sample we have to play
+        const uInt8* myPos{nullptr};  // pointer to the audio buffer to be played
+        uInt32 myRemaining{0};        // remaining length of the sample we have to play
 
       private:
         // Callback function invoked by the SDL Audio library when it needs data
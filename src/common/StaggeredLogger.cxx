@@ -44,13 +44,8 @@ StaggeredLogger::StaggeredLogger(string_view message, Logger::Level level)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 StaggeredLogger::~StaggeredLogger()
 {
-  myTimer->clear(myTimerId);
-
-  // make sure that the worker thread joins before continuing with the destruction
-  myTimer.reset();
-
-  // the worker thread has joined and there will be no more reentrant calls ->
-  // continue with destruction
+  // waits for a running callback -> there will be no more reentrant calls
+  myTimer.clear(myTimerId);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -126,8 +121,8 @@ void StaggeredLogger::startInterval()
   myCurrentEventCount = 0;
   myLastIntervalStartTimestamp = now;
 
-  myTimer->clear(myTimerId);
-  myTimerId = myTimer->setTimeout(std::bind(&StaggeredLogger::onTimerExpired, this, ++myTimerCallbackId), myCurrentIntervalSize);
+  myTimer.clear(myTimerId);
+  myTimerId = myTimer.setTimeout(std::bind(&StaggeredLogger::onTimerExpired, this, ++myTimerCallbackId), myCurrentIntervalSize);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
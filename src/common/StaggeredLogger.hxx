@@ -73,10 +73,9 @@ class StaggeredLogger
 
     std::mutex myMutex;
 
-    // We need control over the destruction porcess and over the exact point where
-    // the worker thread joins -> allocate on the heap end delete explicitly in
-    // our destructor.
-    unique_ptr<TimerManager> myTimer{std::make_unique<TimerManager>()};
+    // The global timer is advanced by the main loop, so the callbacks run on
+    // the main thread
+    TimerManager& myTimer{TimerManager::global()};
     TimerManager::TimerId myTimerId{0};
 
     // It is possible that the timer callback is running even after TimerManager::clear
@@ -0,0 +1,80 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2026 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#include <fstream>
+
+#include "Logger.hxx"
+#include "StartupTrace.hxx"
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void StartupTrace::start(string_view filename)
+{
+  ourFilename = filename;
+  ourOrigin = std::chrono::steady_clock::now();
+  ourStages.clear();
+  ourEnabled = !ourFilename.empty();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void StartupTrace::add(string_view name,
+                       std::chrono::steady_clock::time_point start,
+                       std::chrono::steady_clock::time_point end)
+{
+  using std::chrono::duration_cast, std::chrono::microseconds;
+
+  ourStages.emplace_back(name,
+    static_cast<uInt64>(duration_cast<microseconds>(start - ourOrigin).count()),
+    static_cast<uInt64>(duration_cast<microseconds>(end - start).count()));
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void StartupTrace::firstPresent()
+{
+  if(!ourEnabled)
+    return;
+  ourEnabled = false;
+
+  const auto now = static_cast<uInt64>(
+    std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::steady_clock::now() - ourOrigin).count());
+
+  // Enclosing stages end after the ones they contain, order by start
+  std::ranges::stable_sort(ourStages, {}, &Stage::start);
+
+  std::ofstream out(ourFilename, std::ios::out | std::ios::trunc);
+  if(!out)
+  {
+    Logger::error(std::format("ERROR: Couldn't write startup trace '{}'",
+                              ourFilename));
+    return;
+  }
+
+  // See the 'Trace Event Format' document for a description
+  out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n"
+      << std::format("{{\"name\":\"startup\",\"ph\":\"X\",\"ts\":0,\"dur\":{},"
+                     "\"pid\":1,\"tid\":1}}", now);
+  for(const auto& stage: ourStages)
+    out << std::format(",\n{{\"name\":\"{}\",\"ph\":\"X\",\"ts\":{},\"dur\":{},"
+                       "\"pid\":1,\"tid\":1}}",
+                       stage.name, stage.start, stage.duration);
+  out << std::format(",\n{{\"name\":\"first present\",\"ph\":\"i\",\"s\":\"g\","
+                     "\"ts\":{},\"pid\":1,\"tid\":1}}\n]}}\n", now);
+
+  Logger::info(std::format("Startup trace ({:.1f}ms) written to '{}'",
+                           now / 1000.0, ourFilename));
+  ourStages.clear();
+}
@@ -0,0 +1,103 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2026 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#ifndef STARTUP_TRACE_HXX
+#define STARTUP_TRACE_HXX
+
+#include <chrono>
+
+#include "bspf.hxx"
+
+/**
+  Records the time spent in each stage of application startup, from the
+  commandline being parsed until the first frame is presented, and writes
+  it as a Chrome trace ('-starttrace <file>').  The result can be viewed in
+  chrome://tracing or Perfetto.
+
+  Startup happens on the main thread only, so no locking is done.  When
+  tracing is not enabled, a scope only costs a clock read.
+
+  @author  Stella Team
+*/
+class StartupTrace
+{
+  public:
+    /**
+      Records the time between construction and destruction as a stage.
+      The name must be a string literal (or otherwise outlive the trace).
+    */
+    class Scope
+    {
+      public:
+        explicit Scope(string_view name)
+          : myName{name}, myStart{std::chrono::steady_clock::now()} { }
+        ~Scope() {
+          if(ourEnabled)
+            add(myName, myStart, std::chrono::steady_clock::now());
+        }
+
+      private:
+        string_view myName;
+        std::chrono::steady_clock::time_point myStart;
+
+      private:
+        Scope(const Scope&) = delete;
+        Scope(Scope&&) = delete;
+        Scope& operator=(const Scope&) = delete;
+        Scope& operator=(Scope&&) = delete;
+    };
+
+  public:
+    /**
+      Start tracing; the trace is written to the given file when the first
+      frame has been presented.
+    */
+    static void start(string_view filename);
+
+    /**
+      Mark the first presented frame, write the trace and stop tracing.
+      Does nothing when tracing is not (or no longer) enabled.
+    */
+    static void firstPresent();
+
+  private:
+    static void add(string_view name, std::chrono::steady_clock::time_point start,
+                    std::chrono::steady_clock::time_point end);
+
+  private:
+    struct Stage {
+      string_view name;
+      uInt64 start{0};     // microseconds since start()
+      uInt64 duration{0};  // microseconds
+    };
+
+    static inline bool ourEnabled{false};
+    static inline string ourFilename;
+    static inline std::chrono::steady_clock::time_point ourOrigin;
+    static inline vector<Stage> ourStages;
+
+  private:
+    // Following constructors and assignment operators not supported
+    StartupTrace() = delete;
+    ~StartupTrace() = delete;
+    StartupTrace(const StartupTrace&) = delete;
+    StartupTrace(StartupTrace&&) = delete;
+    StartupTrace& operator=(const StartupTrace&) = delete;
+    StartupTrace& operator=(StartupTrace&&) = delete;
+};
+
+#endif
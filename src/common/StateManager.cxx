@@ -20,16 +20,30 @@
 #include "Console.hxx"
 #include "Cart.hxx"
 #include "Switches.hxx"
+#include "System.hxx"
+#include "TIA.hxx"
+#include "M6502.hxx"
+#include "DispatchResult.hxx"
+#include "EmulationTiming.hxx"
 #include "RewindManager.hxx"
+#include "InputMovie.hxx"
+#include "Netplay.hxx"
+#include "EventHandler.hxx"
+#include "StateWriter.hxx"
 
 #include "StateManager.hxx"
 
-// #define MOVIE_HEADER "03030000movie"
+#ifdef ZIP_SUPPORT
+  #include <zlib.h>
+#endif
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 StateManager::StateManager(OSystem& osystem)
   : myOSystem{osystem},
-    myRewindManager{std::make_unique<RewindManager>(osystem, *this)}
+    myMovie{std::make_unique<InputMovie>()},
+    myNetplay{std::make_unique<Netplay>()},
+    myRewindManager{std::make_unique<RewindManager>(osystem, *this)},
+    myStateWriter{std::make_unique<StateWriter>()}
 {
   reset();
 }
@@ -37,92 +51,17 @@ StateManager::StateManager(OSystem& osystem)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 StateManager::~StateManager() = default;
 
-#if 0
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void StateManager::toggleRecordMode()
+void StateManager::toggleTimeMachine()
 {
-  if(myActiveMode != kMovieRecordMode)  // Turn on movie record mode
-  {
-    myActiveMode = kOffMode;
-
-    string moviefile = /*myOSystem.baseDir() +*/ "test.inp";
-    if(myMovieWriter.isOpen())
-      myMovieWriter.close();
-    if(!myMovieWriter.open(moviefile))
-      return false;
-
-    // Prepend the ROM md5 so this state file only works with that ROM
-    myMovieWriter.putString(myOSystem.console().properties().get(Cartridge_MD5));
-
-    if(!myOSystem.console().save(myMovieWriter))
-      return false;
-
-    // Save controller types for this ROM
-    // We need to check this, since some controllers save more state than
-    // normal, and those states files wouldn't be compatible with normal
-    // controllers.
-    myMovieWriter.putString(
-      myOSystem.console().controller(Controller::Jack::Left).name());
-    myMovieWriter.putString(
-      myOSystem.console().controller(Controller::Jack::Right).name());
-
-    // If we get this far, we're really in movie record mode
-    myActiveMode = kMovieRecordMode;
-  }
-  else  // Turn off movie record mode
-  {
-    myActiveMode = kOffMode;
-    myMovieWriter.close();
-    return false;
-  }
-
-  return myActiveMode == kMovieRecordMode;
-////////////////////////////////////////////////////////
-// FIXME - For now, I'm going to use this to activate movie playback
-  // Close the writer, since we're about to re-open in read mode
-  myMovieWriter.close();
-
-  if(myActiveMode != kMoviePlaybackMode)  // Turn on movie playback mode
-  {
-    myActiveMode = kOffMode;
-
-    string moviefile = /*myOSystem.baseDir() + */ "test.inp";
-    if(myMovieReader.isOpen())
-      myMovieReader.close();
-    if(!myMovieReader.open(moviefile))
-      return false;
-
-    // Check the ROM md5
-    if(myMovieReader.getString() !=
-       myOSystem.console().properties().get(Cartridge_MD5))
-      return false;
-
-    if(!myOSystem.console().load(myMovieReader))
-      return false;
-
-    // Check controller types
-    const string& left  = myMovieReader.getString();
-    const string& right = myMovieReader.getString();
-
-    if(left != myOSystem.console().controller(Controller::Jack::Left).name() ||
-       right != myOSystem.console().controller(Controller::Jack::Right).name())
-      return false;
-
-    // If we get this far, we're really in movie record mode
-    myActiveMode = kMoviePlaybackMode;
-  }
-  else  // Turn off movie playback mode
+  // Rewinding would desynchronize the remote console
+  if(myActiveMode == Mode::Netplay)
   {
-    myActiveMode = kOffMode;
-    myMovieReader.close();
-    return false;
+    myOSystem.frameBuffer().showTextMessage("Time Machine not available during netplay");
+    return;
   }
-}
-#endif
+  stopMovie();
 
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void StateManager::toggleTimeMachine()
-{
   const bool devSettings = myOSystem.settings().getBool("dev.settings");
 
   myActiveMode = (myActiveMode == Mode::TimeMachine)
@@ -137,6 +76,17 @@ void StateManager::toggleTimeMachine()
     devSettings ? "dev.timemachine" : "plr.timemachine", enabled);
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void StateManager::setRewindMode(Mode mode)
+{
+  // The setting takes effect with the next console
+  if(myActiveMode == Mode::Netplay)
+    return;
+
+  stopMovie();
+  myActiveMode = mode;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool StateManager::addExtraState(string_view message)
 {
@@ -169,29 +119,234 @@ void StateManager::update()
 {
   if(myActiveMode == Mode::TimeMachine)
     myRewindManager->addState("Time Machine", true);
+}
 
-#if 0
-  switch(myActiveMode)
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool StateManager::startMovieRecording(string_view filename)
+{
+  stopMovie();
+  stopNetplay();
+  if(!myOSystem.hasConsole())
+    return false;
+
+  const Console& console = myOSystem.console();
+  const InputMovie::Info info{console.properties().get(PropType::Cart_MD5),
+    console.leftController().name(), console.rightController().name()};
+
+  if(!myMovie->startRecording(filename, info,
+      [&console](Serializer& out) { return console.save(out); }))
   {
-    case Mode::TimeMachine:
-      myRewindManager->addState("Time Machine", true);
-      break;
-
-    case Mode::MovieRecord:
-      myOSystem.console().controller(Controller::Jack::Left).save(myMovieWriter);
-      myOSystem.console().controller(Controller::Jack::Right).save(myMovieWriter);
-      myOSystem.console().switches().save(myMovieWriter);
-      break;
-
-    case Mode::MoviePlayback:
-      myOSystem.console().controller(Controller::Jack::Left).load(myMovieReader);
-      myOSystem.console().controller(Controller::Jack::Right).load(myMovieReader);
-      myOSystem.console().switches().load(myMovieReader);
-      break;
-    default:
-      break;
+    myOSystem.frameBuffer().showTextMessage(
+      std::format("Can't record movie {}", filename));
+    return false;
   }
-#endif
+
+  myActiveMode = Mode::MovieRecord;
+  myOSystem.frameBuffer().showTextMessage("Movie recording started");
+
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool StateManager::startMoviePlayback(string_view filename)
+{
+  stopMovie();
+  stopNetplay();
+  if(!myOSystem.hasConsole())
+    return false;
+
+  Console& console = myOSystem.console();
+  const InputMovie::Info info{console.properties().get(PropType::Cart_MD5),
+    console.leftController().name(), console.rightController().name()};
+
+  if(!myMovie->startPlayback(filename, info,
+      [&console](Serializer& in) { return console.load(in); }))
+  {
+    myOSystem.frameBuffer().showTextMessage(
+      std::format("Can't play movie {}", filename));
+    return false;
+  }
+
+  myActiveMode = Mode::MoviePlayback;
+  myOSystem.frameBuffer().showTextMessage("Movie playback started");
+
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void StateManager::startMovie()
+{
+  // The movie is only started with the first console
+  const string record = myOSystem.settings().getString("recordmovie");
+  const string play = myOSystem.settings().getString("playmovie");
+  myOSystem.settings().setValue("recordmovie", "");
+  myOSystem.settings().setValue("playmovie", "");
+
+  if(!play.empty())
+    startMoviePlayback(play);
+  else if(!record.empty())
+    startMovieRecording(record);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void StateManager::stopMovie()
+{
+  if(myActiveMode != Mode::MovieRecord && myActiveMode != Mode::MoviePlayback)
+    return;
+
+  myMovie->stop();
+  myActiveMode = Mode::Off;
+  myOSystem.frameBuffer().showTextMessage("Movie stopped");
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void StateManager::updateMovie(Event& event)
+{
+  if(myActiveMode == Mode::MovieRecord)
+  {
+    const Console& console = myOSystem.console();
+
+    // Use the cycles before any halt, playback can only stop there
+    if(!myMovie->record(console.system().m6502().lastStopCycles(), event,
+        [&console](Serializer& out) { return console.save(out); }))
+    {
+      myActiveMode = Mode::Off;
+      myOSystem.frameBuffer().showTextMessage("Movie recording failed");
+    }
+  }
+  else if(myActiveMode == Mode::MoviePlayback)
+  {
+    const Console& console = myOSystem.console();
+
+    if(!myMovie->play(console.system().cycles(), event,
+        [&console](Serializer& out) { return console.save(out); }))
+      myOSystem.frameBuffer().showTextMessage(std::format(
+        "Movie desynchronized at keyframe {}", myMovie->keyframes() - 1));
+
+    if(!myMovie->isPlaying())
+    {
+      myActiveMode = Mode::Off;
+      myOSystem.frameBuffer().showTextMessage("Movie playback finished");
+    }
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void StateManager::emulateMovie(DispatchResult& result, uInt64 maxCycles)
+{
+  const uInt64 cycles = myOSystem.console().system().cycles();
+  const uInt64 next = myMovie->nextCycles();
+
+  myOSystem.console().tia().update(result,
+    next > cycles ? std::min(next - cycles, maxCycles) : maxCycles);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool StateManager::hostNetplay(uInt16 port)
+{
+  stopMovie();
+  stopNetplay();
+  if(!myOSystem.hasConsole())
+    return false;
+
+  if(!checkNetplayControllers())
+    return false;
+
+  if(!myNetplay->host(myOSystem.console(), port))
+  {
+    myOSystem.frameBuffer().showTextMessage(
+      std::format("Can't host netplay on port {}", port));
+    return false;
+  }
+
+  myActiveMode = Mode::Netplay;
+  myOSystem.frameBuffer().showTextMessage(
+    std::format("Waiting for netplay client on port {}", port));
+
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool StateManager::joinNetplay(string_view address)
+{
+  stopMovie();
+  stopNetplay();
+  if(!myOSystem.hasConsole())
+    return false;
+
+  if(!checkNetplayControllers())
+    return false;
+
+  if(!myNetplay->join(myOSystem.console(), address))
+  {
+    myOSystem.frameBuffer().showTextMessage(
+      std::format("Can't connect to netplay host {}", address));
+    return false;
+  }
+
+  myActiveMode = Mode::Netplay;
+  myOSystem.frameBuffer().showTextMessage(
+    std::format("Connecting to netplay host {}", address));
+
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void StateManager::startNetplay()
+{
+  // The session is only started with the first console
+  const int port = myOSystem.settings().getInt("nethost");
+  const string address = myOSystem.settings().getString("netjoin");
+  myOSystem.settings().setValue("nethost", 0);
+  myOSystem.settings().setValue("netjoin", "");
+
+  if(port > 0)
+    hostNetplay(static_cast<uInt16>(port));
+  else if(!address.empty())
+    joinNetplay(address);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void StateManager::stopNetplay()
+{
+  if(myActiveMode != Mode::Netplay)
+    return;
+
+  myNetplay->stop();
+  myActiveMode = Mode::Off;
+  myOSystem.frameBuffer().showTextMessage("Netplay stopped");
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool StateManager::emulateNetplay(DispatchResult& result)
+{
+  const Netplay::Status status = myNetplay->status();
+  const bool emulated = myNetplay->emulateFrame(myOSystem.eventHandler().event(), result);
+
+  if(myNetplay->status() == Netplay::Status::Off)
+  {
+    myActiveMode = Mode::Off;
+    myOSystem.frameBuffer().showTextMessage(myNetplay->message());
+  }
+  else if(status == Netplay::Status::Connecting &&
+          myNetplay->status() == Netplay::Status::Running)
+    myOSystem.frameBuffer().showTextMessage("Netplay started");
+
+  return emulated;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool StateManager::checkNetplayControllers()
+{
+  const Console& console = myOSystem.console();
+
+  if(console.leftController().type() != Controller::Type::Joystick ||
+     console.rightController().type() != Controller::Type::Joystick)
+  {
+    myOSystem.frameBuffer().showTextMessage("Netplay requires joysticks in both ports");
+    return false;
+  }
+  return true;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -203,11 +358,23 @@ void StateManager::loadState(int slot)
   if(slot < 0)
     slot = myCurrentSlot;
 
+  // A movie can't continue from a different state, and the remote
+  // console in a netplay session would be out of sync
+  if(myActiveMode == Mode::Netplay)
+  {
+    myOSystem.frameBuffer().showTextMessage("States can't be loaded during netplay");
+    return;
+  }
+  stopMovie();
+
   const auto path = std::format("{}{}.st{}",
     myOSystem.stateDir().getPath(),
     myOSystem.console().properties().get(PropType::Cart_Name),
     slot);
 
+  // The state may still be being written
+  myStateWriter->flush();
+
   Serializer in(path, Serializer::FileMode::ReadOnly);
   if(!in)
   {
@@ -221,10 +388,11 @@ void StateManager::loadState(int slot)
     // First test if we have a valid header
     // If so, do a complete state load using the Console
     const auto header = in.getString();
-    if(header != STATE_HEADER)
+    if(header != STATE_HEADER && header != COMPRESSED_STATE_HEADER)
       myOSystem.frameBuffer().showTextMessage(
         std::format("Incompatible state {} file", slot));
-    else if(myOSystem.console().load(in))
+    else if(header == STATE_HEADER ? myOSystem.console().load(in)
+                                   : readCompressedState(in))
       myOSystem.frameBuffer().showTextMessage(
         std::format("State {} loaded", slot));
     else
@@ -252,29 +420,10 @@ void StateManager::saveState(int slot)
     myOSystem.console().properties().get(PropType::Cart_Name),
     slot);
 
-  Serializer out(path, Serializer::FileMode::ReadWriteTrunc);
-  if(!out)
-  {
-    myOSystem.frameBuffer().showTextMessage(
-      std::format("Can't open/save to state file {}", slot));
-    return;
-  }
-
-  try
-  {
-    // Add header so that if the state format changes in the future,
-    // we'll know right away, without having to parse the rest of the file
-    out.putString(STATE_HEADER);
-  }
-  catch(...)
-  {
-    myOSystem.frameBuffer().showTextMessage(
-      std::format("Error saving state {}", slot));
-    return;
-  }
-
-  // Do a complete state save using the Console
-  if(myOSystem.console().save(out))
+  // Do a complete state save using the Console; only saving it into
+  // memory is done now, the file is written in the background
+  if(myStateWriter->write(path,
+      [this](Serializer& out) { return saveState(out); }))
   {
     if(myOSystem.settings().getBool("autoslot"))
     {
@@ -358,9 +507,96 @@ bool StateManager::saveState(Serializer& out)
   return false;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool StateManager::readCompressedState(Serializer& in)
+{
+#ifdef ZIP_SUPPORT
+  ByteArray data(in.getInt());
+  ByteArray packed(in.getInt());
+  in.getByteArray(packed);
+
+  uLongf size = static_cast<uLongf>(data.size());
+  if(uncompress(data.data(), &size, packed.data(),
+                static_cast<uLong>(packed.size())) != Z_OK || size != data.size())
+    return false;
+
+  Serializer state(std::span<const std::byte>(
+    reinterpret_cast<const std::byte*>(data.data()), data.size()));
+  return loadState(state);
+#else
+  // Only readable with compression support
+  return false;
+#endif
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void StateManager::setRunAheadFrames(uInt32 frames)
+{
+  myRunAheadFrames = std::min(frames, MAX_RUNAHEAD_FRAMES);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool StateManager::runAhead()
+{
+  // Movies rely on the CPU stopping where the input was polled, netplay
+  // applies the input per frame
+  if(myRunAheadFrames == 0 || !myOSystem.hasConsole() ||
+     myActiveMode == Mode::MovieRecord || myActiveMode == Mode::MoviePlayback ||
+     myActiveMode == Mode::Netplay)
+    return false;
+
+  TIA& tia = myOSystem.console().tia();
+  bool success = false;
+
+  // Skipped frames would leave nothing to show
+  if(tia.frameSkip() > 0)
+    return false;
+
+  // Speculative frames must neither be heard nor recorded
+  tia.setAudioSuspended(true);
+
+  // The shown framebuffer is excluded, it receives the speculative frame
+  myRunAheadState.rewind();
+  if(saveState(myRunAheadState) && tia.saveDisplay(myRunAheadState, false))
+  {
+    // Limit the cycles in case the ROM stops generating frames
+    const System& system = myOSystem.console().system();
+    const uInt32 frames = tia.framesSinceLastRender() + myRunAheadFrames;
+    const uInt64 maxCycles = system.cycles() +
+      static_cast<uInt64>(myRunAheadFrames) * 2 *
+      myOSystem.console().emulationTiming().cyclesPerFrame();
+    DispatchResult result;
+
+    do
+      tia.update(result);
+    while(result.getStatus() == DispatchResult::Status::ok &&
+          tia.framesSinceLastRender() < frames && system.cycles() < maxCycles);
+
+    if(tia.framesSinceLastRender() >= frames)
+    {
+      tia.renderToFrameBuffer();
+      success = true;
+    }
+
+    myRunAheadState.rewind();
+    if(!loadState(myRunAheadState) || !tia.loadDisplay(myRunAheadState, false))
+      success = false;
+
+    // The current frame has been replaced by the speculative one
+    if(success)
+      tia.clearPendingFrame();
+  }
+
+  tia.setAudioSuspended(false);
+
+  return success;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void StateManager::reset()
 {
+  stopMovie();
+  stopNetplay();
   myCurrentSlot = 0;
   myRewindManager->clear();
 
@@ -370,22 +606,5 @@ void StateManager::reset()
 
   myActiveMode = timeMachine ? Mode::TimeMachine : Mode::Off;
 
-#if 0
-  myCurrentSlot = 0;
-
-  switch(myActiveMode)
-  {
-    case kMovieRecordMode:
-      myMovieWriter.close();
-      break;
-
-    case kMoviePlaybackMode:
-      myMovieReader.close();
-      break;
-
-    default:
-      break;
-  }
-  myActiveMode = kOffMode;
-#endif
+  setRunAheadFrames(myOSystem.settings().getInt("runahead"));
 }
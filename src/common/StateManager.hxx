@@ -18,8 +18,13 @@
 #ifndef STATE_MANAGER_HXX
 #define STATE_MANAGER_HXX
 
+class DispatchResult;
+class Event;
+class InputMovie;
+class Netplay;
 class OSystem;
 class RewindManager;
+class StateWriter;
 
 #include "Serializer.hxx"
 
@@ -35,11 +40,16 @@ class StateManager
   public:
     enum class Mode: uInt8 {
       Off,
-      TimeMachine
-//       MovieRecord,
-//       MoviePlayback
+      TimeMachine,
+      MovieRecord,
+      MoviePlayback,
+      Netplay
     };
     static constexpr string_view STATE_HEADER = "07000001state";
+    // State files starting with this header contain a deflated state
+    // (including the STATE_HEADER)
+    static constexpr string_view COMPRESSED_STATE_HEADER = "07000001zstate";
+    static constexpr uInt32 MAX_RUNAHEAD_FRAMES = 5;
 
     /**
       Create a new statemananger class.
@@ -53,13 +63,6 @@ class StateManager
     */
     Mode mode() const { return myActiveMode; }
 
-#if 0
-    /**
-      Toggle movie recording mode (FIXME - currently disabled)
-    */
-    void toggleRecordMode();
-#endif
-
     /**
       Toggle state rewind recording mode; this uses the RewindManager
       for its functionality.
@@ -70,7 +73,7 @@ class StateManager
       Sets state rewind recording mode; this uses the RewindManager
       for its functionality.
     */
-    void setRewindMode(Mode mode) { myActiveMode = mode; }
+    void setRewindMode(Mode mode);
 
     /**
       Optionally adds one extra state when entering the Time Machine dialog;
@@ -98,6 +101,77 @@ class StateManager
     */
     void update();
 
+    /**
+      Start recording an input movie of the current console to the given
+      file, or playing one back.  This replaces the Time Machine.
+      See InputMovie for details.
+
+      @return  False if the movie could not be started
+    */
+    bool startMovieRecording(string_view filename);
+    bool startMoviePlayback(string_view filename);
+
+    /**
+      Start recording or playing back the movie given on the commandline
+      ('-recordmovie' or '-playmovie'), if any.
+    */
+    void startMovie();
+
+    /**
+      Stop recording or playing back the current movie.
+    */
+    void stopMovie();
+
+    /**
+      Record the input or, during playback, replace it with the recorded
+      one.  This must be called each time the input is polled, before it
+      is passed to the controllers.
+
+      @param event  The current event values
+    */
+    void updateMovie(Event& event);
+
+    /**
+      During playback, emulate until the next recorded input update (but
+      at most the given number of cycles).  Playback must stop exactly
+      where the input was polled when recording.
+
+      @param result     The result of the emulation
+      @param maxCycles  The maximum number of cycles to emulate
+    */
+    void emulateMovie(DispatchResult& result, uInt64 maxCycles);
+
+    /**
+      Host a netplay session on the given port, or join the one at the
+      given address ('host[:port]').  This replaces the Time Machine.
+      See Netplay for details.
+
+      @return  False if the session could not be started
+    */
+    bool hostNetplay(uInt16 port);
+    bool joinNetplay(string_view address);
+
+    /**
+      Host or join the netplay session given on the commandline
+      ('-nethost' or '-netjoin'), if any.
+    */
+    void startNetplay();
+
+    /**
+      Leave the current netplay session.
+    */
+    void stopNetplay();
+
+    /**
+      During netplay, emulate the next frame with the input of both players.
+      This replaces passing the input to the controllers when polling.
+
+      @param result  The result of the emulation
+
+      @return  False if no frame was emulated (e.g. while connecting)
+    */
+    bool emulateNetplay(DispatchResult& result);
+
     /**
       Load a state into the current system.
 
@@ -144,6 +218,29 @@ class StateManager
     */
     bool saveState(Serializer& out);
 
+    /**
+      Set the number of frames emulated ahead of the current frame before
+      it is displayed (0 disables run-ahead).
+
+      @param frames  The number of frames to run ahead
+    */
+    void setRunAheadFrames(uInt32 frames);
+
+    /**
+      Answers the number of frames emulated ahead of the current frame.
+    */
+    uInt32 runAheadFrames() const { return myRunAheadFrames; }
+
+    /**
+      Emulate the configured number of frames ahead using the current input,
+      render the last one to the framebuffer and restore the current state
+      again. This hides the input latency of games which react to input
+      only a few frames later.
+
+      @return  False if run-ahead is disabled or failed, else true
+    */
+    bool runAhead();
+
     /**
       Resets manager to defaults.
     */
@@ -159,6 +256,22 @@ class StateManager
     */
     RewindManager& rewindManager() const { return *myRewindManager; }
 
+    /**
+      Writes the state files in the background
+    */
+    StateWriter& stateWriter() const { return *myStateWriter; }
+
+  private:
+    /**
+      Load a compressed state, following the COMPRESSED_STATE_HEADER.
+    */
+    bool readCompressedState(Serializer& in);
+
+    /**
+      Netplay only supports joysticks; shows a message otherwise.
+    */
+    bool checkNetplayControllers();
+
   private:
     // The parent OSystem object
     OSystem& myOSystem;
@@ -172,15 +285,23 @@ class StateManager
     // MD5 of the currently active ROM (either in movie or rewind mode)
     string myMD5;
 
-#if 0
-    // Serializer classes used to save/load the eventstream
-    Serializer myMovieWriter;
-    Serializer myMovieReader;
-#endif
+    // The movie being recorded or played back
+    unique_ptr<InputMovie> myMovie;
+
+    // The current netplay session
+    unique_ptr<Netplay> myNetplay;
 
     // Stored savestates to be later rewound
     unique_ptr<RewindManager> myRewindManager;
 
+    // Writes the state files, in the background
+    unique_ptr<StateWriter> myStateWriter;
+
+    // Number of frames to run ahead, and the state to return to afterwards
+    // (its buffer is sized by the first save and reused afterwards)
+    uInt32 myRunAheadFrames{0};
+    Serializer myRunAheadState;
+
   private:
     // Following constructors and assignment operators not supported
     StateManager() = delete;
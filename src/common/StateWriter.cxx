@@ -0,0 +1,158 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2026 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#include <cstdio>
+
+#include "FSNode.hxx"
+#include "Logger.hxx"
+#include "StateManager.hxx"
+#include "StateWriter.hxx"
+
+#ifdef ZIP_SUPPORT
+  #include <zlib.h>
+#endif
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+StateWriter::~StateWriter()
+{
+  {
+    const std::scoped_lock lock(myMutex);
+    myQuit = true;
+  }
+  myQueued.notify_one();
+
+  // The thread writes all queued states before it quits
+  if(myWriterThread.joinable())
+    myWriterThread.join();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool StateWriter::write(string_view path, const SaveFunc& save, bool compress)
+{
+  Job job{string{path}, {}, 0, compress};
+  {
+    const std::scoped_lock lock(myMutex);
+    if(!myFreeBuffers.empty())
+    {
+      job.data = std::move(myFreeBuffers.back());
+      myFreeBuffers.pop_back();
+    }
+  }
+
+  Serializer out(job.data);
+  if(!save(out))
+    return false;
+  job.size = out.size();
+
+  {
+    const std::scoped_lock lock(myMutex);
+    myJobs.push_back(std::move(job));
+
+    if(!myWriterThread.joinable())
+      myWriterThread = std::thread(&StateWriter::writerThread, this);
+  }
+  myQueued.notify_one();
+
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void StateWriter::flush()
+{
+  std::unique_lock lock(myMutex);
+  myDone.wait(lock, [this] { return myJobs.empty() && !myWriting; });
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void StateWriter::writerThread()
+{
+  std::unique_lock lock(myMutex);
+  for(;;)
+  {
+    myQueued.wait(lock, [this] { return myQuit || !myJobs.empty(); });
+    if(myJobs.empty())
+      break;
+
+    Job job = std::move(myJobs.front());
+    myJobs.pop_front();
+    myWriting = true;
+    lock.unlock();
+
+    if(!writeFile(job))
+      Logger::error(std::format("ERROR: Couldn't write state file '{}'", job.path));
+
+    lock.lock();
+    myWriting = false;
+    if(myFreeBuffers.size() < MAX_FREE_BUFFERS)
+      myFreeBuffers.push_back(std::move(job.data));
+    myDone.notify_all();
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool StateWriter::writeFile(const Job& job)
+{
+  const std::span state(job.data.data(), job.size);
+  std::span<const std::byte> contents = state;
+
+#ifdef ZIP_SUPPORT
+  // States contain lots of unused RAM and repeated data, so they usually
+  // shrink to a fraction of their size
+  Serializer::Arena file;
+  if(job.compress)
+  {
+    uLongf packedSize = compressBound(static_cast<uLong>(state.size()));
+    ByteArray packed(packedSize);
+    if(compress2(packed.data(), &packedSize,
+                 reinterpret_cast<const Bytef*>(state.data()),
+                 static_cast<uLong>(state.size()), Z_BEST_SPEED) == Z_OK)
+    {
+      Serializer out(file);
+      out.putString(StateManager::COMPRESSED_STATE_HEADER);
+      out.putInt(static_cast<uInt32>(state.size()));
+      out.putInt(static_cast<uInt32>(packedSize));
+      out.putByteArray(std::span(packed.data(), packedSize));
+      contents = std::span(file.data(), out.size());
+    }
+  }
+#endif
+
+  // Write a temporary file first, so that the old file stays intact if
+  // anything goes wrong
+  const string tempPath = job.path + ".tmp";
+  {
+    std::fstream out = FSNode(tempPath).openFStream(
+      std::ios::out | std::ios::binary | std::ios::trunc);
+    if(!out.is_open())
+      return false;
+
+    out.write(reinterpret_cast<const char*>(contents.data()),
+              static_cast<std::streamsize>(contents.size()));
+    out.close();
+    if(out.fail())
+      return false;
+  }
+
+  FSNode tempFile(tempPath);
+  if(!tempFile.rename(job.path))
+  {
+    // Not all systems replace an existing file when renaming
+    std::remove(job.path.c_str());
+    return tempFile.rename(job.path);
+  }
+  return true;
+}
@@ -0,0 +1,109 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2026 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#ifndef STATE_WRITER_HXX
+#define STATE_WRITER_HXX
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+#include "bspf.hxx"
+#include "Serializer.hxx"
+
+/**
+  Writes state files in the background.  The state is saved into memory
+  by the calling thread, which is fast; compressing it and writing the file
+  is left to a background thread, so that saving a state never stalls the
+  emulation.
+
+  Each file is written to a temporary file first, which then replaces the
+  old file, so that an interrupted write never leaves a broken state.
+  The memory of written states is kept for the next states.  Files which
+  are still being written must be flushed before they are read again, and
+  everything is flushed when the writer is destroyed.
+
+  @author  Stella Team
+*/
+class StateWriter
+{
+  public:
+    // Saves the state into the given Serializer; returns false on errors
+    using SaveFunc = std::function<bool(Serializer&)>;
+
+    StateWriter() = default;
+    ~StateWriter();
+
+    /**
+      Save a state into memory now, and write it to the given file in the
+      background.  Write errors are only logged.
+
+      @param path      The file to write
+      @param save      Saves the state
+      @param compress  Write the state compressed (if supported), following
+                       the StateManager::COMPRESSED_STATE_HEADER
+
+      @return  False if the state could not be saved
+    */
+    bool write(string_view path, const SaveFunc& save, bool compress = true);
+
+    /**
+      Wait until all states have been written.
+    */
+    void flush();
+
+  private:
+    struct Job {
+      string path;
+      Serializer::Arena data;
+      size_t size{0};
+      bool compress{false};
+    };
+
+    void writerThread();
+
+    /**
+      Write the state of the job to its file.  This does not access any
+      shared state.
+    */
+    static bool writeFile(const Job& job);
+
+  private:
+    // Number of unused buffers kept for later states
+    static constexpr size_t MAX_FREE_BUFFERS = 2;
+
+    // The queue and the buffers, all protected by myMutex
+    std::deque<Job> myJobs;
+    vector<Serializer::Arena> myFreeBuffers;
+    bool myWriting{false};  // a job has been taken from the queue
+    bool myQuit{false};
+
+    std::mutex myMutex;
+    std::condition_variable myQueued, myDone;
+    std::thread myWriterThread;  // started by the first write
+
+  private:
+    // Following constructors and assignment operators not supported
+    StateWriter(const StateWriter&) = delete;
+    StateWriter(StateWriter&&) = delete;
+    StateWriter& operator=(const StateWriter&) = delete;
+    StateWriter& operator=(StateWriter&&) = delete;
+};
+
+#endif
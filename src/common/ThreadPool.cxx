@@ -0,0 +1,127 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2026 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#include "ThreadScheduling.hxx"
+#include "ThreadPool.hxx"
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+ThreadPool::ThreadPool(uInt32 numThreads, const vector<int>& cpus)
+{
+  for(uInt32 i = 1; i < numThreads; ++i)
+    myWorkers.emplace_back(&ThreadPool::workerThread, this,
+                           cpus.empty() ? -1 : cpus[(i - 1) % cpus.size()]);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+ThreadPool::~ThreadPool()
+{
+  {
+    const std::lock_guard<std::mutex> lock(myMutex);
+    myStop = true;
+  }
+  myWakeUp.notify_all();
+
+  for(auto& worker: myWorkers)
+    worker.join();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt32 ThreadPool::renderThreads(bool enable)
+{
+  const uInt32 systemThreads = enable ? std::thread::hardware_concurrency() : 0;
+
+  return systemThreads <= 1
+    ? 1
+    : std::max<uInt32>(1, std::min<uInt32>(4, systemThreads - 1));
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void ThreadPool::run(uInt32 numStripes, const StripeFunc& func)
+{
+  // Not worth waking up any threads
+  if(myWorkers.empty() || numStripes <= 1)
+  {
+    for(uInt32 stripe = 0; stripe < numStripes; ++stripe)
+      func(stripe, numStripes);
+    return;
+  }
+
+  {
+    // Workers which woke up late for the previous job must be done with it
+    std::unique_lock<std::mutex> lock(myMutex);
+    myIdle.wait(lock, [this] { return myBusy == 0; });
+
+    myNumStripes = numStripes;
+    myFinishedStripes = 0;
+    myJob = &func;
+    myNextStripe = 0;
+    ++myGeneration;
+  }
+  myWakeUp.notify_all();
+
+  // Make the calling thread busy too...
+  processStripes();
+
+  // ...and wait until all workers are done
+  std::unique_lock<std::mutex> lock(myMutex);
+  myIdle.wait(lock, [this, numStripes] {
+    return myBusy == 0 && myFinishedStripes == numStripes;
+  });
+  myJob = nullptr;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void ThreadPool::processStripes()
+{
+  uInt32 stripe = 0;
+  while((stripe = myNextStripe.fetch_add(1)) < myNumStripes)
+  {
+    (*myJob)(stripe, myNumStripes);
+    ++myFinishedStripes;
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void ThreadPool::workerThread(int cpu)
+{
+  uInt64 generation = 0;
+
+  ThreadScheduling::setAffinity(cpu);
+
+  for(;;)
+  {
+    {
+      std::unique_lock<std::mutex> lock(myMutex);
+      myWakeUp.wait(lock, [this, generation] {
+        return myStop || myGeneration != generation;
+      });
+      if(myStop)
+        return;
+
+      generation = myGeneration;
+      ++myBusy;
+    }
+
+    processStripes();
+
+    {
+      const std::lock_guard<std::mutex> lock(myMutex);
+      --myBusy;
+    }
+    myIdle.notify_one();
+  }
+}
@@ -0,0 +1,109 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2026 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#ifndef THREAD_POOL_HXX
+#define THREAD_POOL_HXX
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+#include "bspf.hxx"
+
+/**
+  A persistent pool of worker threads, used to split rendering work
+  (TV effects, phosphor blending etc.) into horizontal stripes.
+
+  The threads are created once and then sleep until a job is started.  The
+  stripes of a job are handed out through an atomic counter, so no locking
+  is required while a job is processed.  The calling thread always works on
+  the job too.
+
+  @author  Stella Team
+*/
+class ThreadPool
+{
+  public:
+    // Renders the given stripe (0 .. numStripes - 1)
+    using StripeFunc = std::function<void(uInt32 stripe, uInt32 numStripes)>;
+
+    /**
+      Create a pool which uses 'numThreads' threads in total, including the
+      calling thread.  A value <= 1 means the pool runs all jobs directly.
+      If CPUs are given, the worker threads are pinned to them in turn.
+    */
+    explicit ThreadPool(uInt32 numThreads, const vector<int>& cpus = {});
+    ~ThreadPool();
+
+    /**
+      The number of threads to use for rendering; always leaves one core
+      for the emulation, and uses at most 4 threads.
+
+      @param enable  Whether threading should be used at all
+    */
+    static uInt32 renderThreads(bool enable);
+
+    /**
+      Answer the total number of threads (including the calling one).
+    */
+    uInt32 numThreads() const { return static_cast<uInt32>(myWorkers.size()) + 1; }
+
+    /**
+      Process all stripes of a job using all threads, and return when all
+      stripes have been completed.
+
+      @param numStripes  The number of stripes to split the job into
+      @param func        The function processing a stripe
+    */
+    void run(uInt32 numStripes, const StripeFunc& func);
+
+    /**
+      Convenience method, splitting the job into one stripe per thread.
+    */
+    void run(const StripeFunc& func) { run(numThreads(), func); }
+
+  private:
+    void workerThread(int cpu);
+    void processStripes();
+
+  private:
+    vector<std::thread> myWorkers;
+
+    std::mutex myMutex;
+    std::condition_variable myWakeUp, myIdle;
+    uInt64 myGeneration{0}; // incremented for each new job
+    uInt32 myBusy{0};       // number of workers currently processing a job
+    bool myStop{false};
+
+    // The current job
+    const StripeFunc* myJob{nullptr};
+    uInt32 myNumStripes{0};
+    std::atomic<uInt32> myNextStripe{0};
+    std::atomic<uInt32> myFinishedStripes{0};
+
+  private:
+    // Following constructors and assignment operators not supported
+    ThreadPool() = delete;
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool(ThreadPool&&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+    ThreadPool& operator=(ThreadPool&&) = delete;
+};
+
+#endif
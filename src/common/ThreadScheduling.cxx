@@ -0,0 +1,184 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2026 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#if defined(BSPF_WINDOWS)
+  #include "Windows.hxx"
+  #include <avrt.h>
+  #ifdef _MSC_VER
+    #pragma comment(lib, "avrt.lib")
+  #endif
+#elif defined(BSPF_MACOS)
+  #include <pthread.h>
+#else
+  #include <pthread.h>
+  #include <sched.h>
+  #ifdef __linux__
+    #include <sys/resource.h>
+    #include <sys/syscall.h>
+    #include <unistd.h>
+  #endif
+#endif
+
+#include "Logger.hxx"
+#include "Settings.hxx"
+#include "ThreadScheduling.hxx"
+
+namespace ThreadScheduling {
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+Config config(const Settings& settings)
+{
+  Config config;
+
+  config.priority = parsePriority(settings.getString("threads.priority"));
+  config.mainCpu = settings.getInt("threads.cpu.main");
+  config.emulationCpu = settings.getInt("threads.cpu.emulation");
+  config.renderCpus = parseCpuList(settings.getString("threads.cpu.render"));
+  config.handoff = parseHandoff(settings.getString("threads.handoff"));
+
+  return config;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+Priority parsePriority(string_view name)
+{
+  if(BSPF::equalsIgnoreCase(name, "realtime"))
+    return Priority::realtime;
+  if(BSPF::equalsIgnoreCase(name, "high"))
+    return Priority::high;
+
+  return Priority::normal;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+Handoff parseHandoff(string_view name)
+{
+  if(BSPF::equalsIgnoreCase(name, "run"))
+    return Handoff::run;
+  if(BSPF::equalsIgnoreCase(name, "spin"))
+    return Handoff::spin;
+
+  return Handoff::park;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+vector<int> parseCpuList(string_view list)
+{
+  vector<int> cpus;
+
+  while(!list.empty())
+  {
+    const size_t comma = list.find(',');
+    const string_view range = list.substr(0, comma);
+    list = comma == string_view::npos ? string_view{} : list.substr(comma + 1);
+
+    const size_t dash = range.find('-');
+    const int first = BSPF::stoi(range.substr(0, dash), -1);
+    const int last = dash == string_view::npos
+      ? first : BSPF::stoi(range.substr(dash + 1), -1);
+
+    for(int cpu = first; cpu >= 0 && cpu <= last; ++cpu)
+      cpus.push_back(cpu);
+  }
+
+  return cpus;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool setPriority(Priority priority, Task task)
+{
+  if(priority == Priority::normal)
+    return true;
+
+#if defined(BSPF_WINDOWS)
+  // MMCSS boosts registered threads into the real-time range while they
+  // run, without requiring any privileges
+  DWORD taskIndex = 0;
+  const HANDLE mmcss = AvSetMmThreadCharacteristicsW(
+      task == Task::audio ? L"Pro Audio" : L"Games", &taskIndex);
+  if(mmcss && priority == Priority::realtime)
+    AvSetMmThreadPriority(mmcss, AVRT_PRIORITY_CRITICAL);
+
+  const bool ok = SetThreadPriority(GetCurrentThread(),
+    priority == Priority::realtime ? THREAD_PRIORITY_TIME_CRITICAL
+                                   : THREAD_PRIORITY_HIGHEST) || mmcss;
+#elif defined(BSPF_MACOS)
+  (void)task;
+  const bool ok = pthread_set_qos_class_self_np(
+    priority == Priority::realtime ? QOS_CLASS_USER_INTERACTIVE
+                                   : QOS_CLASS_USER_INITIATED, 0) == 0;
+#else
+  (void)task;
+  bool ok = false;
+  if(priority == Priority::realtime)
+  {
+    // Stay below the priorities of the kernel's and the audio server's
+    // threads, so that they can still preempt us
+    sched_param param{};
+    param.sched_priority = sched_get_priority_min(SCHED_FIFO) + 1;
+    ok = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param) == 0;
+  }
+#ifdef __linux__
+  // On Linux, the nice value applies to the single thread given by its id
+  if(!ok)
+    ok = setpriority(PRIO_PROCESS, static_cast<id_t>(syscall(SYS_gettid)), -10) == 0;
+#endif
+#endif
+
+  if(!ok)
+    Logger::info(std::format("Could not raise the {} thread priority",
+                             task == Task::audio ? "audio" : "emulation"));
+  return ok;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void setBackground()
+{
+#if defined(BSPF_WINDOWS)
+  SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_LOWEST);
+#elif defined(BSPF_MACOS)
+  pthread_set_qos_class_self_np(QOS_CLASS_UTILITY, 0);
+#elif defined(__linux__)
+  setpriority(PRIO_PROCESS, static_cast<id_t>(syscall(SYS_gettid)), 10);
+#endif
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool setAffinity(int cpu)
+{
+  if(cpu < 0)
+    return true;
+
+#if defined(BSPF_WINDOWS)
+  const bool ok = cpu < 64 &&
+    SetThreadAffinityMask(GetCurrentThread(), DWORD_PTR{1} << cpu) != 0;
+#elif !defined(__linux__) || defined(__ANDROID__)
+  // e.g. macOS only supports affinity hints between threads, not pinning
+  const bool ok = false;
+#else
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  CPU_SET(cpu, &set);
+  const bool ok = pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#endif
+
+  if(!ok)
+    Logger::info(std::format("Could not pin thread to CPU {}", cpu));
+  return ok;
+}
+
+} // namespace ThreadScheduling
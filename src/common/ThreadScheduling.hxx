@@ -0,0 +1,113 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2026 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#ifndef THREAD_SCHEDULING_HXX
+#define THREAD_SCHEDULING_HXX
+
+class Settings;
+
+#include "bspf.hxx"
+
+/**
+  Scheduling of the time critical threads.  On hosts running several
+  instances (or other load), the OS scheduler may preempt the emulation
+  worker or the audio callback in the middle of a timeslice, which causes
+  audio underruns.  The priority of these threads can therefore be raised
+  ('threads.priority'), and the main, emulation and render pool threads can
+  be pinned to CPUs ('threads.cpu.main', 'threads.cpu.emulation',
+  'threads.cpu.render').  How the main thread and the emulation worker hand
+  off timeslices is selected by 'threads.handoff'.
+
+  All methods apply to the calling thread, and fail silently (apart from a
+  log message) if the OS doesn't allow the change.
+
+  @author  Stella Team
+*/
+namespace ThreadScheduling {
+
+  enum class Priority: uInt8 {
+    normal,    // don't change the OS defaults
+    high,      // elevated priority, e.g. a negative nice value
+    realtime   // real-time scheduling (falls back to high if not permitted)
+  };
+
+  // The type of work of a thread, which selects the MMCSS task on Windows
+  enum class Task: uInt8 {
+    emulation,
+    audio
+  };
+
+  // How the emulation worker and the main thread wait for each other
+  enum class Handoff: uInt8 {
+    park,      // sleep right away
+    spin,      // spin briefly before sleeping, and up to each deadline
+    run        // keep spinning for up to a frame (costs a CPU core)
+  };
+
+  struct Config {
+    Priority priority{Priority::normal};
+    int mainCpu{-1};           // -1 = any CPU
+    int emulationCpu{-1};
+    vector<int> renderCpus;    // empty = any CPU
+    Handoff handoff{Handoff::park};
+  };
+
+  /**
+    Read the configuration from the settings.
+  */
+  Config config(const Settings& settings);
+
+  /**
+    Parse a priority name ('normal', 'high' or 'realtime').
+  */
+  Priority parsePriority(string_view name);
+
+  /**
+    Parse a handoff mode name ('park', 'spin' or 'run').
+  */
+  Handoff parseHandoff(string_view name);
+
+  /**
+    Parse a list of CPUs, e.g. '2,4-7'.
+  */
+  vector<int> parseCpuList(string_view list);
+
+  /**
+    Change the priority of the calling thread, and register it with the
+    multimedia class scheduler (MMCSS) on Windows.
+
+    @return  True if the priority could be changed
+  */
+  bool setPriority(Priority priority, Task task);
+
+  /**
+    Lower the priority of the calling thread, for housekeeping work that
+    must never preempt the emulation, audio or render threads.
+  */
+  void setBackground();
+
+  /**
+    Pin the calling thread to the given CPU.  Not supported on macOS.
+
+    @param cpu  The CPU to run on (-1 = don't change)
+    @return  True if the affinity could be changed
+  */
+  bool setAffinity(int cpu);
+
+} // namespace ThreadScheduling
+
+#endif
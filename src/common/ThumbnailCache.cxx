@@ -0,0 +1,287 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2026 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#ifdef IMAGE_SUPPORT
+
+#include <cmath>
+
+#include "OSystem.hxx"
+#include "JPGLibrary.hxx"
+#include "MD5.hxx"
+#include "PNGLibrary.hxx"
+
+#include "ThumbnailCache.hxx"
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+ThumbnailCache::ThumbnailCache(const OSystem& osystem, uInt32 width, uInt32 height)
+  : myCacheDir{osystem.baseDir()},
+    myWidth{width},
+    myHeight{height}
+{
+  myCacheDir /= "thumbnails";
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+ThumbnailCache::~ThumbnailCache()
+{
+  {
+    const std::scoped_lock lock(myMutex);
+    myQuit = true;
+  }
+  myRequested.notify_one();
+
+  if(myLoaderThread.joinable())
+    myLoaderThread.join();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+ThumbnailCache::ThumbnailPtr ThumbnailCache::get(const string& fileName)
+{
+  // Check the file without holding the lock
+  const FSNode node(fileName);
+  const size_t fileSize = node.getSize();
+  const uInt64 modified = node.getLastModified();
+
+  const std::scoped_lock lock(myMutex);
+
+  if(const auto it = myEntries.find(fileName); it != myEntries.end())
+  {
+    if(isCurrent(*it->second.thumbnail, fileSize, modified))
+    {
+      // Mark as most recently used
+      myOrder.splice(myOrder.end(), myOrder, it->second.order);
+      return it->second.thumbnail;
+    }
+    myOrder.erase(it->second.order);
+    myEntries.erase(it);
+  }
+
+  // The most recent request is loaded first
+  if(myLoading != fileName)
+  {
+    std::erase(myRequests, fileName);
+    myRequests.push_front(fileName);
+  }
+
+  if(!myLoaderThread.joinable())
+    myLoaderThread = std::thread(&ThumbnailCache::loaderThread, this);
+  myRequested.notify_one();
+
+  return nullptr;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void ThumbnailCache::prefetch(const StringList& fileNames)
+{
+  const std::scoped_lock lock(myMutex);
+
+  myPrefetches.clear();
+  for(const auto& fileName: fileNames)
+    if(!myEntries.contains(fileName) && fileName != myLoading)
+      myPrefetches.push_back(fileName);
+
+  if(myPrefetches.empty())
+    return;
+
+  if(!myLoaderThread.joinable())
+    myLoaderThread = std::thread(&ThumbnailCache::loaderThread, this);
+  myRequested.notify_one();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void ThumbnailCache::loaderThread()
+{
+  if(!myCacheDir.isDirectory())
+    myCacheDir.makeDir();
+
+  std::unique_lock lock(myMutex);
+  for(;;)
+  {
+    myRequested.wait(lock, [this] {
+      return myQuit || !myRequests.empty() || !myPrefetches.empty();
+    });
+    if(myQuit)
+      break;
+
+    const bool requested = !myRequests.empty();
+    std::deque<string>& queue = requested ? myRequests : myPrefetches;
+    string fileName = std::move(queue.front());
+    queue.pop_front();
+    if(myEntries.contains(fileName))
+      continue;
+
+    myLoading = fileName;
+    lock.unlock();
+
+    // Only requested images which don't exist are remembered, since most
+    // prefetched names are just guesses
+    const ThumbnailPtr thumbnail = load(fileName, requested);
+
+    lock.lock();
+    if(thumbnail)
+      add(thumbnail);
+    myLoading.clear();
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+ThumbnailCache::ThumbnailPtr ThumbnailCache::load(const string& fileName,
+                                                  bool requested) const
+{
+  const FSNode node(fileName);
+  if(!requested && !node.exists())
+    return nullptr;
+
+  auto thumbnail = std::make_shared<Thumbnail>();
+  thumbnail->fileName = fileName;
+  thumbnail->fileSize = node.getSize();
+  thumbnail->modified = node.getLastModified();
+
+  // The stored thumbnail is only valid for this version and size of the
+  // image; files inside archives have no modification time to check
+  FSNode cacheFile;
+  if(thumbnail->modified)
+  {
+    cacheFile = myCacheDir;
+    cacheFile /= MD5::hash(std::format("{}|{}|{}|{}x{}", thumbnail->fileName,
+        thumbnail->fileSize, thumbnail->modified, myWidth, myHeight)) + ".png";
+
+    try
+    {
+      if(cacheFile.exists())
+      {
+        PNGLibrary::loadImage(cacheFile.getPath(), thumbnail->pixels,
+            thumbnail->width, thumbnail->height, thumbnail->metaData);
+        return thumbnail;
+      }
+    }
+    catch(const std::runtime_error&)
+    {
+      // Decode the original image instead
+    }
+  }
+
+  try
+  {
+    if(BSPF::endsWithIgnoreCase(thumbnail->fileName, ".png"))
+      PNGLibrary::loadImage(thumbnail->fileName, thumbnail->pixels,
+          thumbnail->width, thumbnail->height, thumbnail->metaData);
+    else
+      JPGLibrary::loadImage(thumbnail->fileName, thumbnail->pixels,
+          thumbnail->width, thumbnail->height, thumbnail->metaData);
+  }
+  catch(const std::runtime_error& e)
+  {
+    thumbnail->pixels.clear();
+    thumbnail->width = thumbnail->height = 0;
+    thumbnail->error = e.what();
+    return thumbnail;
+  }
+
+  // Images which are small already are not worth storing again
+  if(thumbnail->width > myWidth || thumbnail->height > myHeight)
+  {
+    scale(*thumbnail);
+
+    if(thumbnail->modified)
+    {
+      try
+      {
+        // PNGLibrary can store at most 16 meta data entries
+        const VariantList metaData(thumbnail->metaData.begin(),
+            thumbnail->metaData.begin() +
+            std::min<size_t>(thumbnail->metaData.size(), 16));
+        vector<uInt32> pixels = thumbnail->pixels;
+
+        PNGLibrary::saveImage(cacheFile.getPath(), pixels,
+            thumbnail->width, thumbnail->height, metaData);
+      }
+      catch(const std::runtime_error&)
+      {
+        // Not storing the thumbnail only costs time on the next start
+      }
+    }
+  }
+  return thumbnail;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void ThumbnailCache::scale(Thumbnail& thumbnail) const
+{
+  const size_t w = thumbnail.width, h = thumbnail.height;
+  const double factor = std::min(static_cast<double>(myWidth) / w,
+                                 static_cast<double>(myHeight) / h);
+  const size_t tw = std::max<size_t>(std::lround(w * factor), 1);
+  const size_t th = std::max<size_t>(std::lround(h * factor), 1);
+
+  vector<uInt32> pixels(tw * th);
+  uInt32* dst = pixels.data();
+
+  for(size_t ty = 0; ty < th; ++ty)
+  {
+    const size_t y0 = ty * h / th, y1 = std::max(y0 + 1, (ty + 1) * h / th);
+
+    for(size_t tx = 0; tx < tw; ++tx)
+    {
+      const size_t x0 = tx * w / tw, x1 = std::max(x0 + 1, (tx + 1) * w / tw);
+      uInt32 a{0}, r{0}, g{0}, b{0};
+
+      for(size_t y = y0; y < y1; ++y)
+      {
+        const uInt32* src = thumbnail.pixels.data() + y * w;
+        for(size_t x = x0; x < x1; ++x)
+        {
+          const uInt32 pixel = src[x];
+          a += pixel >> 24;
+          r += (pixel >> 16) & 0xFF;
+          g += (pixel >> 8) & 0xFF;
+          b += pixel & 0xFF;
+        }
+      }
+      const auto n = static_cast<uInt32>((x1 - x0) * (y1 - y0));
+      *dst++ = ((a / n) << 24) | ((r / n) << 16) | ((g / n) << 8) | (b / n);
+    }
+  }
+  thumbnail.pixels = std::move(pixels);
+  thumbnail.width  = static_cast<uInt32>(tw);
+  thumbnail.height = static_cast<uInt32>(th);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void ThumbnailCache::add(const ThumbnailPtr& thumbnail)
+{
+  // Replace an outdated entry for the same file
+  if(const auto it = myEntries.find(thumbnail->fileName); it != myEntries.end())
+  {
+    myOrder.erase(it->second.order);
+    myEntries.erase(it);
+  }
+
+  // If cache is full, evict the oldest entry
+  if(myEntries.size() >= CACHE_SIZE)
+  {
+    myEntries.erase(myOrder.front());
+    myOrder.pop_front();
+  }
+
+  // Insert the new entry at the back (most recently used)
+  myOrder.push_back(thumbnail->fileName);
+  myEntries.emplace(thumbnail->fileName,
+                    Entry{thumbnail, std::prev(myOrder.end())});
+}
+
+#endif  // IMAGE_SUPPORT
@@ -0,0 +1,163 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2026 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#ifdef IMAGE_SUPPORT
+
+#ifndef THUMBNAIL_CACHE_HXX
+#define THUMBNAIL_CACHE_HXX
+
+class OSystem;
+
+#include <condition_variable>
+#include <deque>
+#include <list>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+#include "bspf.hxx"
+#include "FSNode.hxx"
+#include "Variant.hxx"
+
+/**
+  Provides PNG and JPG images scaled down to the size they are shown at
+  in the launcher.
+
+  The images are decoded and scaled by a background thread.  The most
+  recently used thumbnails are kept in memory, and every scaled thumbnail
+  is also stored as a PNG file in the 'thumbnails' directory, so that an
+  image is only decoded in its original size once.
+
+  @author  Stella Team
+*/
+class ThumbnailCache
+{
+  public:
+    struct Thumbnail {
+      string fileName;        // the original image
+      vector<uInt32> pixels;  // ARGB8888, 'width' pixels per row
+      uInt32 width{0}, height{0};
+      VariantList metaData;   // of the original image
+      string error;           // set if the image couldn't be loaded
+
+      size_t fileSize{0};     // of the original image when it was loaded
+      uInt64 modified{0};
+    };
+    using ThumbnailPtr = shared_ptr<const Thumbnail>;
+
+  public:
+    /**
+      Create a cache for thumbnails of at most the given size.
+
+      @param osystem  The OSystem object, for the cache directory
+      @param width    The maximum width of the thumbnails
+      @param height   The maximum height of the thumbnails
+    */
+    ThumbnailCache(const OSystem& osystem, uInt32 width, uInt32 height);
+    ~ThumbnailCache();
+
+    /**
+      Get the thumbnail of the given image.  If it isn't available yet,
+      it is loaded in the background, before any prefetched images.
+
+      @param fileName  The image file
+
+      @return  The thumbnail, or nullptr if it is still being loaded
+    */
+    ThumbnailPtr get(const string& fileName);
+
+    /**
+      Load the thumbnails of the given images in the background, once all
+      images requested by get() are done.  This replaces the images of any
+      earlier call, and files which don't exist are ignored.
+
+      @param fileNames  The image files, in the order they will be loaded
+    */
+    void prefetch(const StringList& fileNames);
+
+  private:
+    // Maximum number of thumbnails kept in memory
+    static constexpr size_t CACHE_SIZE = 32;
+
+    struct Entry {
+      ThumbnailPtr thumbnail;
+      std::list<string>::iterator order;
+    };
+
+    /**
+      The background thread, loading requested and prefetched images.
+    */
+    void loaderThread();
+
+    /**
+      Load the thumbnail of the given image, from the directory if possible.
+      This does not access any shared state.
+
+      @param fileName   The image file
+      @param requested  Whether a missing file results in an error thumbnail,
+                        instead of nullptr
+
+      @return  The thumbnail, which has an error message on failure
+    */
+    ThumbnailPtr load(const string& fileName, bool requested) const;
+
+    /**
+      Scale the image down to fit the maximum thumbnail size.  Each target
+      pixel is the average of the source pixels it covers.
+    */
+    void scale(Thumbnail& thumbnail) const;
+
+    /**
+      Answer whether the thumbnail matches the current version of its image.
+    */
+    static bool isCurrent(const Thumbnail& thumbnail, size_t fileSize,
+                          uInt64 modified) {
+      return thumbnail.fileSize == fileSize && thumbnail.modified == modified;
+    }
+
+    /**
+      Add the thumbnail to the memory cache, evicting the oldest if full.
+    */
+    void add(const ThumbnailPtr& thumbnail);
+
+  private:
+    FSNode myCacheDir;
+    const uInt32 myWidth{0}, myHeight{0};
+
+    // The memory cache and the requests, all protected by myMutex
+    std::unordered_map<string, Entry> myEntries;  // filename -> thumbnail
+    std::list<string> myOrder;  // front = oldest, back = newest
+    std::deque<string> myRequests;    // newest first
+    std::deque<string> myPrefetches;
+    string myLoading;  // the image currently being loaded, if any
+    bool myQuit{false};
+    std::mutex myMutex;
+    std::condition_variable myRequested;
+    std::thread myLoaderThread;
+
+  private:
+    // Following constructors and assignment operators not supported
+    ThumbnailCache() = delete;
+    ThumbnailCache(const ThumbnailCache&) = delete;
+    ThumbnailCache(ThumbnailCache&&) = delete;
+    ThumbnailCache& operator=(const ThumbnailCache&) = delete;
+    ThumbnailCache& operator=(ThumbnailCache&&) = delete;
+};
+
+#endif
+
+#endif  // IMAGE_SUPPORT
@@ -15,30 +15,19 @@
 // this file, and for a DISCLAIMER OF ALL WARRANTIES.
 //============================================================================
 
-#include <cassert>
 #include "TimerManager.hxx"
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-TimerManager::~TimerManager()
+TimerManager::TimerManager()
+  : start{Clock::now()}
 {
-  ScopedLock lock(sync);
+}
 
-  // The worker might not be running
-  if (worker.joinable())
-  {
-    done = true;
-    lock.unlock();
-    wakeUp.notify_all();
-
-    // If a timer handler is running, this
-    // will make sure it has returned before
-    // allowing any deallocations to happen
-    worker.join();
-
-    // Note that any timers still in the queue
-    // will be destructed properly but they
-    // will not be invoked
-  }
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TimerManager::~TimerManager()
+{
+  // Makes sure that no callback is running anymore
+  clear();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -47,28 +36,17 @@ TimerManager::TimerId TimerManager::addTimer(
     millisec msPeriod,
     const TFunction& func)
 {
-  ScopedLock lock(sync);
-
-  // Lazily start thread when first timer is requested
-  if (!worker.joinable())
-    worker = std::thread(&TimerManager::timerThreadWorker, this);
+  const ScopedLock lock(sync);
 
   // Assign an ID and insert it into function storage
-  auto id = nextId++;
-  const auto iter = active.emplace(id, Timer(id, Clock::now() + Duration(msDelay),
-      Duration(msPeriod), func));
-
-  // Insert a reference to the Timer into ordering queue
-  const auto place = queue.emplace(iter.first->second);
-
-  // We need to notify the timer thread only if we inserted
-  // this timer into the front of the timer queue
-  const bool needNotify = (place == queue.begin());
-
-  lock.unlock();
+  const auto id = nextId++;
+  Timer& timer = active[id];
+  timer.id = id;
+  timer.expires = std::max(now() + msDelay, current + 1);
+  timer.period = msPeriod;
+  timer.handler = func;
 
-  if (needNotify)
-    wakeUp.notify_all();
+  schedule(timer);
 
   return id;
 }
@@ -77,16 +55,110 @@ TimerManager::TimerId TimerManager::addTimer(
 bool TimerManager::clear(TimerId id)
 {
   ScopedLock lock(sync);
-  const auto i = active.find(id);
-  return destroy_impl(lock, i, true);
+  return destroy_impl(lock, active.find(id));
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void TimerManager::clear()
 {
   ScopedLock lock(sync);
-  while (!active.empty())
-    destroy_impl(lock, active.begin(), queue.size() == 1);
+
+  auto i = active.begin();
+  while(i != active.end())
+  {
+    if(i->second.waitCond)
+      ++i;  // already flagged, removed by advance() when its callback returns
+    else if(i->second.running)
+    {
+      // Might release the lock while waiting, so start over
+      destroy_impl(lock, i);
+      i = active.begin();
+    }
+    else
+      i = active.erase(i);
+  }
+
+  for(auto& level: wheel)
+    for(auto& slot: level)
+      slot.clear();
+  overflow.clear();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TimerManager::advance()
+{
+  ScopedLock lock(sync);
+
+  const Tick target = now();
+  vector<TimerId> due;
+
+  if(active.empty())
+    current = std::max(current, target);
+
+  while(current < target)
+  {
+    ++current;
+
+    // Move the timers of the next slot of the upper levels down, highest
+    // level first
+    if((current & SLOT_MASK) == 0)
+    {
+      if(((current >> SLOT_BITS) & SLOT_MASK) == 0)
+      {
+        if(((current >> (SLOT_BITS * 2)) & SLOT_MASK) == 0)
+          cascade(LEVELS);
+        cascade(2);
+      }
+      cascade(1);
+    }
+    expireSlot(wheel[0][current & SLOT_MASK], due);
+  }
+  if(due.empty())
+    return;
+
+  // Call the handlers outside the lock
+  advancing = std::this_thread::get_id();
+  for(const auto id: due)
+  {
+    const auto i = active.find(id);
+    if(i == active.end())
+      continue;
+
+    // Timers added meanwhile can rehash 'active', which invalidates 'i'
+    // (but not 'timer'), so the timer is removed by its id below
+    Timer& timer = i->second;
+    if(timer.running)
+    {
+      lock.unlock();
+      timer.handler();
+      lock.lock();
+    }
+
+    if(timer.running)
+    {
+      timer.running = false;
+
+      // If it is periodic, schedule it again (missed periods are skipped)
+      if(timer.period > 0)
+      {
+        timer.expires = std::max(timer.expires + timer.period, current + 1);
+        schedule(timer);
+      }
+      else
+        active.erase(id);
+    }
+    else
+    {
+      // Running was set to false, clear was called for this Timer while
+      // the callback was in progress (or before it could be started).  The
+      // thread trying to destroy this timer might be waiting on a condition
+      // variable, so notify it.
+      if(timer.waitCond)
+        timer.waitCond->notify_all();
+      active.erase(id);
+    }
+  }
+  advancing = std::thread::id{};
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -111,136 +183,86 @@ TimerManager& TimerManager::global()
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void TimerManager::timerThreadWorker()
+TimerManager::Tick TimerManager::now() const
 {
-  ScopedLock lock(sync);
-
-  while (!done)
-  {
-    if (queue.empty())
-    {
-      // Wait for done or work
-      wakeUp.wait(lock, [this] { return done || !queue.empty(); });
-      continue;
-    }
+  return std::chrono::duration_cast<std::chrono::milliseconds>(
+    Clock::now() - start).count();
+}
 
-    const auto queueHead = queue.begin();
-    Timer& timer = *queueHead;
-    const auto now = Clock::now();
-    if (now >= timer.next)
-    {
-      queue.erase(queueHead);
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TimerManager::schedule(const Timer& timer)
+{
+  // Timers always expire after the current tick
+  const Tick delta = timer.expires - current;
+
+  if(delta < SLOTS)
+    wheel[0][timer.expires & SLOT_MASK].push_back(timer.id);
+  else if(delta < SLOTS * SLOTS)
+    wheel[1][(timer.expires >> SLOT_BITS) & SLOT_MASK].push_back(timer.id);
+  else if(delta < SLOTS * SLOTS * SLOTS)
+    wheel[2][(timer.expires >> (SLOT_BITS * 2)) & SLOT_MASK].push_back(timer.id);
+  else
+    overflow.push_back(timer.id);
+}
 
-      // Mark it as running to handle racing destroy
-      timer.running = true;
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TimerManager::cascade(uInt32 level)
+{
+  Slot& slot = level == LEVELS
+    ? overflow
+    : wheel[level][(current >> (SLOT_BITS * level)) & SLOT_MASK];
 
-      // Call the handler outside the lock
-      lock.unlock();
-      timer.handler();
-      lock.lock();
+  Slot ids;
+  ids.swap(slot);
 
-      if (timer.running)
-      {
-        timer.running = false;
-
-        // If it is periodic, schedule a new one
-        if (timer.period.count() > 0)
-        {
-          timer.next = timer.next + timer.period;
-          queue.emplace(timer);
-        }
-        else
-        {
-          // Not rescheduling, destruct it
-          active.erase(timer.id);
-        }
-      }
-      else
-      {
-        // timer.running changed!
-        //
-        // Running was set to false, destroy was called
-        // for this Timer while the callback was in progress
-        // (this thread was not holding the lock during the callback)
-        // The thread trying to destroy this timer is waiting on
-        // a condition variable, so notify it
-        timer.waitCond->notify_all();
+  for(const auto id: ids)
+  {
+    const auto i = active.find(id);
+    if(i != active.end() && !i->second.running)
+      schedule(i->second);
+  }
+}
 
-        // The clearTimer call expects us to remove the instance
-        // when it detects that it is racing with its callback
-        active.erase(timer.id);
-      }
-    }
-    else
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TimerManager::expireSlot(Slot& slot, vector<TimerId>& due)
+{
+  for(const auto id: slot)
+  {
+    const auto i = active.find(id);
+    if(i != active.end() && i->second.expires == current && !i->second.running)
     {
-      // Wait until the timer is ready or a timer creation notifies. Note that wait until accesses
-      // time_point by reference, so we make a copy in case the current time is deleted while the
-      // thread sleeps.
-      const auto next = timer.next;
-      wakeUp.wait_until(lock, next);
+      // Mark it as running to handle racing destroy
+      i->second.running = true;
+      due.push_back(id);
     }
   }
+  slot.clear();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-// NOTE: if notify is true, returns with lock unlocked
-bool TimerManager::destroy_impl(ScopedLock& lock, TimerMap::iterator i,
-                                bool notify)
+bool TimerManager::destroy_impl(ScopedLock& lock, TimerMap::iterator i)
 {
-  assert(lock.owns_lock());
-
-  if (i == active.end())
+  if(i == active.end())
     return false;
 
   Timer& timer = i->second;
-  if (timer.running)
+  if(timer.running || timer.waitCond)
   {
-    // A callback is in progress for this Timer,
-    // so flag it for deletion in the worker
+    // A callback is in progress (or about to be) for this Timer,
+    // so flag it for deletion in advance()
     timer.running = false;
+    if(!timer.waitCond)
+      timer.waitCond = std::make_unique<ConditionVar>();
 
-    // Assign a condition variable to this timer
-    timer.waitCond = std::make_unique<ConditionVar>();
-
-    // Block until the callback is finished
-    if (std::this_thread::get_id() != worker.get_id())
-      timer.waitCond->wait(lock);
-  }
-  else
-  {
-    queue.erase(timer);
-    active.erase(i);
-
-    if (notify)
+    // Block until the callback is finished, unless called from the callback
+    if(std::this_thread::get_id() != advancing)
     {
-      lock.unlock();
-      wakeUp.notify_all();
+      const TimerId id = timer.id;
+      timer.waitCond->wait(lock, [this, id] { return !active.contains(id); });
     }
   }
+  else
+    active.erase(i);  // the ids left in the wheel are skipped
 
   return true;
 }
-
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-// TimerManager::Timer implementation
-//
-
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-TimerManager::Timer::Timer(Timer&& r) noexcept
-  : id{r.id},
-    next{r.next},
-    period{r.period},
-    handler{std::move(r.handler)},
-    running{r.running}
-{
-}
-
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-TimerManager::Timer::Timer(TimerId tid, Timestamp tnext, Duration tperiod,
-                           const TFunction& func) noexcept
-  : id{tid},
-    next{tnext},
-    period{tperiod},
-    handler{func}
-{
-}
@@ -18,11 +18,10 @@
 #ifndef TIMER_MANAGER_HXX
 #define TIMER_MANAGER_HXX
 
-#include <algorithm>
+#include <array>
 #include <functional>
 #include <chrono>
 #include <unordered_map>
-#include <set>
 #include <cstdint>
 #include <thread>
 #include <mutex>
@@ -31,14 +30,24 @@
 #include "bspf.hxx"
 
 /**
-  This class provides a portable periodic/one-shot timer infrastructure
-  using worker threads and generic C++11 code.
+  This class provides a portable periodic/one-shot timer infrastructure.
+
+  Timers are kept in a hierarchical timer wheel (three levels of 64 slots
+  with a resolution of one millisecond, plus an overflow list for timers
+  more than ~4 minutes away).  There is no worker thread; the owner drives
+  the wheel by calling advance(), which runs the handlers of all expired
+  timers on the calling thread.  OSystem::mainLoop() does this for the
+  OSystem timer and the global one on each of its wakeups, so timers never
+  require additional wakeups (and fire with the granularity of a frame).
+
+  Timers can be added and cleared from any thread.
 
   @author  Doug Gale (doug65536)
            From "Code Review"
            https://codereview.stackexchange.com/questions/127552/portable-periodic-one-shot-timer-thread-follow-up
 
-           Modifications and cleanup for Stella by Stephen Anthony
+           Modifications and cleanup for Stella by Stephen Anthony,
+           timer wheel by Stella Team
 */
 class TimerManager
 {
@@ -52,8 +61,7 @@ class TimerManager
     // Values that are a large-range millisecond count
     using millisec = uInt64;
 
-    // Constructor does not start worker until there is a Timer.
-    explicit TimerManager() = default;
+    explicit TimerManager();
 
     // Destructor is thread safe, even if a timer callback is running.
     // All callbacks are guaranteed to have returned before this
@@ -61,7 +69,7 @@ class TimerManager
     ~TimerManager();
 
     /**
-      Create a new timer using milliseconds, and add it to the internal queue.
+      Create a new timer using milliseconds, and add it to the wheel.
 
       @param msDelay  Callback starts firing this many milliseconds from now
       @param msPeriod If non-zero, callback is fired again after this period
@@ -92,9 +100,8 @@ class TimerManager
     /**
       Destroy the specified timer.
 
-      Synchronizes with the worker thread if the callback for this timer
-      is running, which guarantees that the handler for that callback is
-      not running before clear() returns.
+      If the callback for this timer is running on another thread (the one
+      calling advance()), this waits until it has returned.
 
       You are not required to clear any timers. You can forget their
       TimerId if you do not need to cancel them.
@@ -112,6 +119,13 @@ class TimerManager
     */
     void clear();
 
+    /**
+      Advance the wheel to the current time and run the handlers of all
+      timers which have expired since the last call.  Should only be called
+      from one thread.
+    */
+    void advance();
+
     // Peek at current state
     std::size_t size() const noexcept;
     bool empty() const noexcept;
@@ -141,26 +155,20 @@ class TimerManager
     using ConditionVar = std::condition_variable;
 
     using Clock = std::chrono::steady_clock;
-    using Timestamp = std::chrono::time_point<Clock>;
-    using Duration = std::chrono::milliseconds;
 
-    struct Timer
-    {
-      explicit Timer(TimerId tid = 0) : id{tid} { }
-      Timer(Timer&& r) noexcept;
+    // Ticks are milliseconds since construction
+    using Tick = uInt64;
 
-      Timer(TimerId id, Timestamp next, Duration period, const TFunction& func) noexcept;
-
-      // Never called
-      Timer() = default;
-      ~Timer() = default;
-      Timer(Timer const& r) = delete;
-      Timer& operator=(Timer const& r) = delete;
-      Timer& operator=(Timer&& r) = delete;
+    static constexpr uInt32 SLOT_BITS = 6;
+    static constexpr uInt32 SLOTS = 1 << SLOT_BITS;
+    static constexpr uInt32 SLOT_MASK = SLOTS - 1;
+    static constexpr uInt32 LEVELS = 3;
 
+    struct Timer
+    {
       TimerId id{0};
-      Timestamp next;
-      Duration period{0};
+      Tick expires{0};
+      Tick period{0};
       TFunction handler;
 
       // You must be holding the 'sync' lock to assign waitCond
@@ -169,22 +177,18 @@ class TimerManager
       bool running{false};
     };
 
-    // Comparison functor to sort the timer "queue" by Timer::next
-    struct NextActiveComparator
-    {
-      bool operator()(Timer const& a, Timer const& b) const noexcept
-      {
-        return a.next < b.next;
-      }
-    };
-
-    // Queue is a set of references to Timer objects, sorted by next
-    using QueueValue = std::reference_wrapper<Timer>;
-    using Queue = std::multiset<QueueValue, NextActiveComparator>;
+    // Slots hold the ids of their timers; ids of cleared timers are skipped
+    // when the slot is processed
+    using Slot = vector<TimerId>;
     using TimerMap = std::unordered_map<TimerId, Timer>;
 
-    void timerThreadWorker();
-    bool destroy_impl(ScopedLock& lock, TimerMap::iterator i, bool notify);
+    Tick now() const;
+
+    void schedule(const Timer& timer);
+    void cascade(uInt32 level);
+    void expireSlot(Slot& slot, vector<TimerId>& due);
+
+    bool destroy_impl(ScopedLock& lock, TimerMap::iterator i);
 
     // Inexhaustible source of unique IDs
     TimerId nextId{no_timer + 1};
@@ -192,17 +196,20 @@ class TimerManager
     // The Timer objects are physically stored in this map
     TimerMap active;
 
-    // The ordering queue holds references to items in 'active'
-    Queue queue;
+    // The wheel levels, each slot covering 64 times the range of a slot of
+    // the level below, and the timers beyond the last level
+    std::array<std::array<Slot, SLOTS>, LEVELS> wheel;
+    Slot overflow;
+
+    // All timers expiring at or before this tick have been handled
+    Tick current{0};
+
+    const Clock::time_point start;
 
-    // One worker thread for an unlimited number of timers is acceptable
-    // Lazily started when first timer is started
-    // TODO: Implement auto-stopping the timer thread when it is idle for
-    // a configurable period.
     mutable Lock sync;
-    ConditionVar wakeUp;
-    std::thread worker;
-    bool done{false};
+
+    // The thread currently running callbacks in advance()
+    std::thread::id advancing;
 
     // Valid IDs are guaranteed not to be this value
     static TimerId constexpr no_timer = static_cast<TimerId>(0);
@@ -0,0 +1,222 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2026 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#ifdef HTTP_LIB_SUPPORT
+  #include <cstring>
+
+  #ifdef BSPF_WINDOWS
+    #include <winsock2.h>
+    #include <ws2tcpip.h>
+    #ifdef _MSC_VER
+      #pragma comment(lib, "ws2_32.lib")
+    #endif
+    using SocketHandle = SOCKET;
+    using SocketLength = int;
+    constexpr SocketHandle NO_SOCKET = INVALID_SOCKET;
+  #else
+    #include <fcntl.h>
+    #include <netdb.h>
+    #include <netinet/in.h>
+    #include <sys/socket.h>
+    #include <unistd.h>
+    using SocketHandle = int;
+    using SocketLength = socklen_t;
+    constexpr SocketHandle NO_SOCKET = -1;
+  #endif
+#endif
+
+#include "UdpSocket.hxx"
+
+#ifdef HTTP_LIB_SUPPORT
+struct UdpSocket::Impl
+{
+  SocketHandle socket{NO_SOCKET};
+  sockaddr_storage peer{};
+  SocketLength peerLength{0};
+  bool listening{false};
+
+  Impl() {
+  #ifdef BSPF_WINDOWS
+    WSADATA data;
+    WSAStartup(MAKEWORD(2, 2), &data);
+  #endif
+  }
+  ~Impl() {
+    close();
+  #ifdef BSPF_WINDOWS
+    WSACleanup();
+  #endif
+  }
+
+  bool open(int family) {
+    close();
+    socket = ::socket(family, SOCK_DGRAM, IPPROTO_UDP);
+    if(socket == NO_SOCKET)
+      return false;
+
+  #ifdef BSPF_WINDOWS
+    u_long nonBlocking = 1;
+    ioctlsocket(socket, FIONBIO, &nonBlocking);
+  #else
+    fcntl(socket, F_SETFL, fcntl(socket, F_GETFL, 0) | O_NONBLOCK);
+  #endif
+    return true;
+  }
+
+  void close() {
+    if(socket != NO_SOCKET)
+    {
+    #ifdef BSPF_WINDOWS
+      closesocket(socket);
+    #else
+      ::close(socket);
+    #endif
+      socket = NO_SOCKET;
+    }
+  }
+
+  Impl(const Impl&) = delete;
+  Impl(Impl&&) = delete;
+  Impl& operator=(const Impl&) = delete;
+  Impl& operator=(Impl&&) = delete;
+};
+#else
+struct UdpSocket::Impl { };
+#endif
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+UdpSocket::UdpSocket()
+  : myImpl{std::make_unique<Impl>()}
+{
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+UdpSocket::~UdpSocket() = default;
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool UdpSocket::listen(uInt16 port)
+{
+  close();
+#ifdef HTTP_LIB_SUPPORT
+  if(!myImpl->open(AF_INET))
+    return false;
+
+  sockaddr_in address{};
+  address.sin_family = AF_INET;
+  address.sin_addr.s_addr = htonl(INADDR_ANY);
+  address.sin_port = htons(port);
+  if(bind(myImpl->socket, reinterpret_cast<const sockaddr*>(&address),
+          sizeof(address)) != 0)
+  {
+    myImpl->close();
+    return false;
+  }
+  myImpl->listening = true;
+
+  return true;
+#else
+  return false;
+#endif
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool UdpSocket::connect(string_view host, uInt16 port)
+{
+  close();
+#ifdef HTTP_LIB_SUPPORT
+  addrinfo hints{};
+  hints.ai_family = AF_UNSPEC;
+  hints.ai_socktype = SOCK_DGRAM;
+  addrinfo* result = nullptr;
+  if(getaddrinfo(string{host}.c_str(), std::to_string(port).c_str(),
+                 &hints, &result) != 0 || result == nullptr)
+    return false;
+
+  const bool success = myImpl->open(result->ai_family);
+  if(success)
+  {
+    std::memcpy(&myImpl->peer, result->ai_addr, result->ai_addrlen);
+    myImpl->peerLength = static_cast<SocketLength>(result->ai_addrlen);
+    myHasPeer = true;
+  }
+  freeaddrinfo(result);
+
+  return success;
+#else
+  return false;
+#endif
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void UdpSocket::close()
+{
+#ifdef HTTP_LIB_SUPPORT
+  myImpl->close();
+  myImpl->listening = false;
+#endif
+  myHasPeer = false;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool UdpSocket::send(std::span<const std::byte> data)
+{
+#ifdef HTTP_LIB_SUPPORT
+  if(!myHasPeer)
+    return false;
+
+  return sendto(myImpl->socket, reinterpret_cast<const char*>(data.data()),
+                static_cast<int>(data.size()), 0,
+                reinterpret_cast<const sockaddr*>(&myImpl->peer),
+                myImpl->peerLength) == static_cast<int>(data.size());
+#else
+  return false;
+#endif
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+size_t UdpSocket::receive(std::span<std::byte> buffer)
+{
+#ifdef HTTP_LIB_SUPPORT
+  if(myImpl->socket == NO_SOCKET)
+    return 0;
+
+  sockaddr_storage sender{};
+  SocketLength senderLength = sizeof(sender);
+  const auto size = recvfrom(myImpl->socket,
+    reinterpret_cast<char*>(buffer.data()), static_cast<int>(buffer.size()), 0,
+    reinterpret_cast<sockaddr*>(&sender), &senderLength);
+  if(size <= 0)
+    return 0;
+
+  if(myImpl->listening)
+  {
+    // The first sender becomes the peer, anybody else is ignored
+    if(!myHasPeer)
+    {
+      myImpl->peer = sender;
+      myImpl->peerLength = senderLength;
+      myHasPeer = true;
+    }
+    else if(senderLength != myImpl->peerLength ||
+            std::memcmp(&sender, &myImpl->peer, senderLength) != 0)
+      return 0;
+  }
+  return static_cast<size_t>(size);
+#else
+  return 0;
+#endif
+}
@@ -0,0 +1,93 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2026 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#ifndef UDP_SOCKET_HXX
+#define UDP_SOCKET_HXX
+
+#include <span>
+
+#include "bspf.hxx"
+
+/**
+  A minimal non-blocking UDP socket, connected to a single peer.
+
+  The socket is either bound to a local port, and then talks to whoever
+  sent the first datagram (host), or sends to a given address (client).
+  Networking is only available with HTTP_LIB_SUPPORT, which also provides
+  PlusROM networking; otherwise the socket can't be opened.
+
+  @author  Stella Team
+*/
+class UdpSocket
+{
+  public:
+    UdpSocket();
+    ~UdpSocket();
+
+  public:
+    /**
+      Bind the socket to the given local port and wait for a peer.
+
+      @return  False if the socket could not be created or bound
+    */
+    bool listen(uInt16 port);
+
+    /**
+      Send to the given peer address from an arbitrary local port.
+
+      @return  False if the address can't be resolved or no socket created
+    */
+    bool connect(string_view host, uInt16 port);
+
+    /**
+      Close the socket.
+    */
+    void close();
+
+    /**
+      Answers whether a peer is known, i.e. whether send() can succeed.
+    */
+    bool hasPeer() const { return myHasPeer; }
+
+    /**
+      Send a datagram to the peer.
+    */
+    bool send(std::span<const std::byte> data);
+
+    /**
+      Receive the next pending datagram, without blocking.  When listening,
+      the sender of the first datagram becomes the peer, and datagrams of
+      other senders are dropped.
+
+      @return  The size of the datagram, 0 if none is pending
+    */
+    size_t receive(std::span<std::byte> buffer);
+
+  private:
+    struct Impl;
+    unique_ptr<Impl> myImpl;
+    bool myHasPeer{false};
+
+  private:
+    // Following constructors and assignment operators not supported
+    UdpSocket(const UdpSocket&) = delete;
+    UdpSocket(UdpSocket&&) = delete;
+    UdpSocket& operator=(const UdpSocket&) = delete;
+    UdpSocket& operator=(UdpSocket&&) = delete;
+};
+
+#endif
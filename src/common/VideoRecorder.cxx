@@ -0,0 +1,367 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2026 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#ifdef GUI_SUPPORT
+
+#ifdef ZIP_SUPPORT
+  #include <zlib.h>
+#endif
+#ifndef BSPF_WINDOWS
+  #include <csignal>
+#endif
+
+#include "OSystem.hxx"
+#include "Console.hxx"
+#include "FrameBuffer.hxx"
+#include "FSNode.hxx"
+#include "Props.hxx"
+#include "TIA.hxx"
+#include "TIASurface.hxx"
+#include "VideoRecorder.hxx"
+
+namespace {
+  constexpr uInt8 VERSION = 1;
+  constexpr uInt8 STORED = 0, DEFLATED = 1;
+
+  void put(ByteArray& out, uInt32 value, uInt32 bytes)
+  {
+    for(uInt32 i = 0; i < bytes; ++i)
+      out.push_back(static_cast<uInt8>(value >> (i * 8)));
+  }
+
+  uInt32 get(const uInt8*& in, uInt32 bytes)
+  {
+    uInt32 value = 0;
+    for(uInt32 i = 0; i < bytes; ++i)
+      value |= static_cast<uInt32>(*in++) << (i * 8);
+    return value;
+  }
+
+  // Replace all occurrences of 'key' in 'str' with 'value'
+  void replaceAll(string& str, string_view key, string_view value)
+  {
+    for(size_t pos = str.find(key); pos != string::npos;
+        pos = str.find(key, pos + value.size()))
+      str.replace(pos, key.size(), value);
+  }
+}  // namespace
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+VideoRecorder::VideoRecorder(OSystem& osystem)
+  : myOSystem{osystem}
+{
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+VideoRecorder::~VideoRecorder()
+{
+  // The console may already be gone, so only the pending frames are written
+  if(isRecording())
+  {
+    myTIA = nullptr;
+    queueBlock();
+  }
+  {
+    const std::scoped_lock lock(myBlockMutex);
+    myQuitWriter = true;
+  }
+  myBlockQueued.notify_one();
+
+  if(myWriterThread.joinable())
+    myWriterThread.join();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void VideoRecorder::toggleRecording()
+{
+  if(isRecording())
+    stopRecording();
+  else
+    startRecording();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void VideoRecorder::startRecording()
+{
+  if(!myOSystem.hasConsole())
+    return;
+
+  // Figure out an unused file name
+#ifdef IMAGE_SUPPORT
+  const FSNode& dir = myOSystem.snapshotSaveDir();
+#else
+  const FSNode& dir = myOSystem.userDir();
+#endif
+  const string path = dir.getPath() +
+      (myOSystem.settings().getString("snapname") != "int"
+        ? myOSystem.romFile().getNameWithExt("")
+        : myOSystem.console().properties().get(PropType::Cart_Name));
+  string filename = path + ".svid";
+  for(uInt32 i = 1; FSNode(filename).exists(); ++i)
+    filename = std::format("{}_{}.svid", path, i);
+
+  myFile.open(filename, std::ios_base::binary);
+  if(!myFile.is_open())
+  {
+    myOSystem.frameBuffer().showTextMessage("Couldn't create recording file");
+    return;
+  }
+
+  // Write the header
+  const FrameBuffer& fb = myOSystem.frameBuffer();
+  for(uInt32 i = 0; i < 256; ++i)
+    fb.getRGB(fb.tiaSurface().mapIndexedPixel(static_cast<uInt8>(i)),
+              &myPalette[i * 3], &myPalette[i * 3 + 1], &myPalette[i * 3 + 2]);
+
+  ByteArray header{'S', 'V', 'I', 'D', VERSION,
+                   static_cast<uInt8>(TIAConstants::H_PIXEL)};
+  put(header, static_cast<uInt32>(myOSystem.frameRate() * 1000), 4);
+  put(header, myOSystem.console().emulationTiming().audioSampleRate(), 4);
+  header.insert(header.end(), myPalette.begin(), myPalette.end());
+  myFile.write(reinterpret_cast<const char*>(header.data()),
+               static_cast<std::streamsize>(header.size()));
+
+  myTIA = &myOSystem.console().tia();
+  myTIA->setAudioCapture(&myAudioSamples);
+  myAudioSamples.clear();
+  myBlock = Block{};
+  myFrames = 0;
+
+  const string_view pipe = myOSystem.settings().getString("recpipe");
+  if(!pipe.empty())
+    openPipe(filename, std::min(myTIA->height(), TIAConstants::frameBufferHeight));
+
+  myQuitWriter = false;
+  myWriterThread = std::thread(&VideoRecorder::writerThread, this);
+
+  myOSystem.frameBuffer().showTextMessage("Recording started");
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void VideoRecorder::stopRecording()
+{
+  if(!isRecording())
+    return;
+
+  myTIA->setAudioCapture(nullptr);
+  myTIA = nullptr;
+  queueBlock();
+
+  // Wait until all frames have been written
+  {
+    const std::scoped_lock lock(myBlockMutex);
+    myQuitWriter = true;
+  }
+  myBlockQueued.notify_one();
+  myWriterThread.join();
+
+  myOSystem.frameBuffer().showTextMessage(
+    std::format("Recording stopped, {} frames recorded", myFrames));
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void VideoRecorder::addFrame(uInt32 frames)
+{
+  if(!isRecording())
+    return;
+
+  const uInt8* frame = myTIA->frameBuffer();
+  const uInt32 height = std::min(myTIA->height(), TIAConstants::frameBufferHeight);
+  ByteArray& data = myBlock.data;
+
+  put(data, height, 2);
+  put(data, std::clamp(frames, 1U, 255U), 1);
+  put(data, static_cast<uInt32>(myAudioSamples.size()), 4);
+  data.insert(data.end(), myAudioSamples.begin(), myAudioSamples.end());
+  myAudioSamples.clear();
+
+  // Mark the changed lines (all for the first frame of a block) ...
+  const size_t mask = data.size();
+  data.resize(mask + (height + 7) / 8);
+  for(uInt32 y = 0; y < height; ++y)
+  {
+    const size_t offset = static_cast<size_t>(y) * TIAConstants::H_PIXEL;
+    if(myBlock.frames == 0 ||
+       !std::equal(frame + offset, frame + offset + TIAConstants::H_PIXEL,
+                   myLastFrame.begin() + offset))
+      data[mask + y / 8] |= 1 << (y % 8);
+  }
+  // ... and append them
+  for(uInt32 y = 0; y < height; ++y)
+    if(data[mask + y / 8] & (1 << (y % 8)))
+    {
+      const size_t offset = static_cast<size_t>(y) * TIAConstants::H_PIXEL;
+      data.insert(data.end(), frame + offset, frame + offset + TIAConstants::H_PIXEL);
+      std::copy_n(frame + offset, TIAConstants::H_PIXEL, myLastFrame.begin() + offset);
+    }
+
+  ++myFrames;
+  if(++myBlock.frames == FRAMES_PER_BLOCK || data.size() >= MAX_BLOCK_SIZE)
+    queueBlock();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void VideoRecorder::queueBlock()
+{
+  if(myBlock.frames == 0)
+    return;
+
+  std::unique_lock lock(myBlockMutex);
+
+  // Wait instead of dropping frames when the writer can't keep up
+  myBlockWritten.wait(lock, [this] {
+    return myBlockQueue.size() < MAX_QUEUED_BLOCKS;
+  });
+  myBlockQueue.push_back(std::move(myBlock));
+  myBlock = Block{};
+
+  lock.unlock();
+  myBlockQueued.notify_one();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void VideoRecorder::writerThread()
+{
+  ByteArray stored;
+
+  std::unique_lock lock(myBlockMutex);
+  for(;;)
+  {
+    myBlockQueued.wait(lock, [this] {
+      return !myBlockQueue.empty() || myQuitWriter;
+    });
+    if(myBlockQueue.empty())
+      break;
+
+    const Block block = std::move(myBlockQueue.front());
+    myBlockQueue.pop_front();
+    lock.unlock();
+    myBlockWritten.notify_all();
+
+    // Compress the block, if this makes it smaller
+    uInt8 compression = STORED;
+    const uInt8* data = block.data.data();
+    size_t size = block.data.size();
+  #ifdef ZIP_SUPPORT
+    uLongf packedSize = compressBound(static_cast<uLong>(size));
+    stored.resize(packedSize);
+    if(compress(stored.data(), &packedSize, data, static_cast<uLong>(size)) == Z_OK &&
+       packedSize < size)
+    {
+      compression = DEFLATED;
+      data = stored.data();
+      size = packedSize;
+    }
+  #endif
+    ByteArray header;
+    put(header, block.frames, 4);
+    put(header, static_cast<uInt32>(block.data.size()), 4);
+    put(header, static_cast<uInt32>(size), 4);
+    put(header, compression, 1);
+    myFile.write(reinterpret_cast<const char*>(header.data()),
+                 static_cast<std::streamsize>(header.size()));
+    myFile.write(reinterpret_cast<const char*>(data),
+                 static_cast<std::streamsize>(size));
+
+    if(myPipe)
+      pipeFrames(block.data, block.frames);
+
+    lock.lock();
+  }
+  lock.unlock();
+
+  myFile.close();
+  if(myPipe)
+  {
+  #ifdef BSPF_WINDOWS
+    _pclose(myPipe);
+  #else
+    pclose(myPipe);
+  #endif
+    myPipe = nullptr;
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void VideoRecorder::pipeFrames(const ByteArray& data, uInt32 frames)
+{
+  // Each block starts with a complete frame
+  FrameArray frame{};
+  vector<uInt8> rgb(static_cast<size_t>(TIAConstants::H_PIXEL) * myPipeHeight * 3);
+  const uInt8* in = data.data();
+
+  for(uInt32 i = 0; i < frames; ++i)
+  {
+    const uInt32 height = get(in, 2);
+    const uInt32 repeat = get(in, 1);
+    in += get(in, 4);  // audio samples
+
+    const uInt8* mask = in;
+    in += (height + 7) / 8;
+    for(uInt32 y = 0; y < height; ++y)
+      if(mask[y / 8] & (1 << (y % 8)))
+      {
+        std::copy_n(in, TIAConstants::H_PIXEL,
+                    frame.begin() + static_cast<size_t>(y) * TIAConstants::H_PIXEL);
+        in += TIAConstants::H_PIXEL;
+      }
+
+    // Frames of a different height are cropped or padded with black
+    const size_t pixels = static_cast<size_t>(TIAConstants::H_PIXEL) *
+                          std::min(height, myPipeHeight);
+    std::ranges::fill(rgb, 0);
+    for(size_t p = 0; p < pixels; ++p)
+      std::copy_n(&myPalette[frame[p] * 3], 3, &rgb[p * 3]);
+
+    // Dropped frames are repeated to keep the frame rate constant
+    for(uInt32 r = 0; r < repeat; ++r)
+      if(fwrite(rgb.data(), 1, rgb.size(), myPipe) != rgb.size())
+      {
+        // The encoder quit, keep recording into the file only
+      #ifdef BSPF_WINDOWS
+        _pclose(myPipe);
+      #else
+        pclose(myPipe);
+      #endif
+        myPipe = nullptr;
+        return;
+      }
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void VideoRecorder::openPipe(string_view filename, uInt32 height)
+{
+  string command{myOSystem.settings().getString("recpipe")};
+  replaceAll(command, "{width}", std::to_string(TIAConstants::H_PIXEL));
+  replaceAll(command, "{height}", std::to_string(height));
+  replaceAll(command, "{rate}", std::format("{:.3f}", myOSystem.frameRate()));
+  replaceAll(command, "{file}", filename.substr(0, filename.size() - 5));
+
+#ifdef BSPF_WINDOWS
+  myPipe = _popen(command.c_str(), "wb");
+#else
+  // A terminated encoder must not terminate the emulator too
+  std::signal(SIGPIPE, SIG_IGN);
+  myPipe = popen(command.c_str(), "w");
+#endif
+  myPipeHeight = height;
+  if(!myPipe)
+    Logger::error("ERROR: Couldn't start video encoder: " + command);
+}
+
+#endif  // GUI_SUPPORT
@@ -0,0 +1,175 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2026 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#ifdef GUI_SUPPORT
+
+#ifndef VIDEO_RECORDER_HXX
+#define VIDEO_RECORDER_HXX
+
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <thread>
+
+#include "bspf.hxx"
+#include "TIAConstants.hxx"
+
+class OSystem;
+class TIA;
+
+/**
+  This class records the emulated frames and sound into a file.  Only the
+  raw TIA output is stored: the palette indices of the lines which changed
+  since the previous frame, and the channel volumes of the audio samples.
+  Blocks of frames are compressed (if zlib is available) and written by a
+  background thread, so recording costs almost nothing during emulation.
+
+  The file starts with this header (all values little endian):
+    "SVID", version (1 byte), width (1 byte), frame rate * 1000 (4 bytes),
+    audio sample rate (4 bytes), palette (256 * RGB, 768 bytes)
+  followed by blocks of frames:
+    frame count, raw size, stored size (4 bytes each),
+    compression (1 byte, 0 = none, 1 = zlib), stored data
+  Each block decodes to its frames on its own:
+    height (2 bytes), number of emulated frames shown by the frame (1 byte),
+    audio sample count (4 bytes), audio samples
+    (channel 0 volume in bits 0..3, channel 1 volume in bits 4..7),
+    one bit per line (LSB first) set if the line changed since the previous
+    frame of the block, the pixels of each changed line
+
+  Optionally, the decoded frames can also be piped as raw RGB24 video into
+  an external encoder (e.g. ffmpeg), see setting 'recpipe'.
+
+  @author  Stella Team
+*/
+class VideoRecorder
+{
+  public:
+    explicit VideoRecorder(OSystem& osystem);
+    ~VideoRecorder();
+
+    /**
+      Answer whether a recording is in progress.
+    */
+    bool isRecording() const { return myTIA != nullptr; }
+
+    /**
+      Start a new recording of the current console, or stop the current one.
+    */
+    void toggleRecording();
+
+    /**
+      Stop the current recording (if any), writing all pending frames.
+    */
+    void stopRecording();
+
+    /**
+      Add the frame just rendered by the TIA, together with the audio
+      emulated since the last one (must not be called while the emulation
+      runs on another thread).
+
+      @param frames  The number of frames emulated since the last one
+    */
+    void addFrame(uInt32 frames);
+
+  private:
+    // A block of encoded frames waiting to be compressed and written
+    struct Block {
+      ByteArray data;
+      uInt32 frames{0};
+    };
+
+    // A block is handed to the background thread when it contains this many
+    // frames, or this many bytes
+    static constexpr uInt32 FRAMES_PER_BLOCK = 256;
+    static constexpr size_t MAX_BLOCK_SIZE = static_cast<size_t>(4) << 20;
+
+    // Maximum number of blocks waiting to be written
+    static constexpr size_t MAX_QUEUED_BLOCKS = 4;
+
+    using FrameArray =
+      std::array<uInt8, static_cast<size_t>(TIAConstants::H_PIXEL * TIAConstants::frameBufferHeight)>;
+
+    // Global OSystem object
+    OSystem& myOSystem;
+
+    // The TIA being recorded, nullptr if not recording
+    TIA* myTIA{nullptr};
+
+    // The block currently being filled, and the last frame added to it
+    Block myBlock;
+    FrameArray myLastFrame{};
+
+    // The audio samples emulated since the last frame
+    ByteArray myAudioSamples;
+
+    // Blocks waiting to be written; protected by myBlockMutex
+    std::deque<Block> myBlockQueue;
+    bool myQuitWriter{false};
+    std::mutex myBlockMutex;
+    std::condition_variable myBlockQueued, myBlockWritten;
+    std::thread myWriterThread;
+
+    // The output file and the pipe to the encoder; only used by the
+    // background thread while recording
+    std::ofstream myFile;
+    FILE* myPipe{nullptr};
+    uInt32 myPipeHeight{0};
+    std::array<uInt8, 256 * 3> myPalette{};
+
+    // Number of frames recorded
+    uInt32 myFrames{0};
+
+    /**
+      Start a new recording of the current console.
+    */
+    void startRecording();
+
+    /**
+      Queue the current block for the background thread, and start a new one.
+    */
+    void queueBlock();
+
+    /**
+      The background thread, compressing and writing queued blocks.
+    */
+    void writerThread();
+
+    /**
+      Decode the frames of the given raw block into RGB24 for the pipe.
+    */
+    void pipeFrames(const ByteArray& data, uInt32 frames);
+
+    /**
+      Open the pipe to the external encoder configured by 'recpipe'.
+    */
+    void openPipe(string_view filename, uInt32 height);
+
+  private:
+    // Following constructors and assignment operators not supported
+    VideoRecorder() = delete;
+    VideoRecorder(const VideoRecorder&) = delete;
+    VideoRecorder(VideoRecorder&&) = delete;
+    VideoRecorder& operator=(const VideoRecorder&) = delete;
+    VideoRecorder& operator=(VideoRecorder&&) = delete;
+};
+
+#endif
+
+#endif  // GUI_SUPPORT
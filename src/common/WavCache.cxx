@@ -0,0 +1,76 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2026 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+
+#ifdef SOUND_SUPPORT
+
+#include "WavCache.hxx"
+
+std::mutex WavCache::ourMutex;
+std::unordered_map<string, std::shared_future<WavCache::WavPtr>> WavCache::ourWavs;
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void WavCache::prefetch(const string& fileName)
+{
+  entry(fileName);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+WavCache::WavPtr WavCache::get(const string& fileName)
+{
+  WavPtr wav = entry(fileName).get();
+
+  // Try again next time, the file may have been fixed in between
+  if(!wav)
+  {
+    const std::lock_guard<std::mutex> lock(ourMutex);
+    ourWavs.erase(fileName);
+  }
+
+  return wav;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+std::shared_future<WavCache::WavPtr> WavCache::entry(const string& fileName)
+{
+  const std::lock_guard<std::mutex> lock(ourMutex);
+
+  auto it = ourWavs.find(fileName);
+  if(it == ourWavs.end())
+    it = ourWavs.emplace(fileName,
+      std::async(std::launch::async, &WavCache::load, fileName).share()).first;
+
+  return it->second;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+WavCache::WavPtr WavCache::load(const string& fileName)
+{
+  auto wav = std::make_shared<Wav>();
+  uInt8* buffer = nullptr;
+  uInt32 length = 0;
+
+  if(!SDL_LoadWAV(fileName.c_str(), &wav->spec, &buffer, &length))
+    return nullptr;
+
+  wav->samples.assign(buffer, buffer + length);
+  SDL_free(buffer);
+
+  return wav;
+}
+
+#endif  // SOUND_SUPPORT
@@ -0,0 +1,88 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2026 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+
+#ifdef SOUND_SUPPORT
+
+#ifndef WAV_CACHE_HXX
+#define WAV_CACHE_HXX
+
+#include <future>
+#include <mutex>
+#include <unordered_map>
+
+#include "SDL_lib.hxx"
+
+#include "bspf.hxx"
+
+/**
+  Decodes WAV files (e.g. the KidVid tapes) on a background thread, and
+  keeps the decoded samples ready to be played.  Files are prefetched
+  before they are needed, so that starting a song never waits for the
+  disk; if a file wasn't prefetched, it is loaded when first requested.
+
+  The cache is shared by all instances in the process (e.g. the consoles
+  of a batch run), and decoded files are kept until the process ends.
+
+  @author  Stella Team
+*/
+class WavCache
+{
+  public:
+    struct Wav {
+      SDL_AudioSpec spec{};
+      ByteArray samples;
+    };
+    using WavPtr = shared_ptr<const Wav>;
+
+  public:
+    /**
+      Start decoding the given file in the background, unless it is
+      already cached or being decoded.
+    */
+    static void prefetch(const string& fileName);
+
+    /**
+      Get the decoded file, waiting for it to be decoded if necessary.
+
+      @return  The decoded file, or nullptr if it couldn't be loaded
+    */
+    static WavPtr get(const string& fileName);
+
+  private:
+    static WavPtr load(const string& fileName);
+
+    // Get (or start) the decoding of the given file
+    static std::shared_future<WavPtr> entry(const string& fileName);
+
+  private:
+    static std::mutex ourMutex;
+    static std::unordered_map<string, std::shared_future<WavPtr>> ourWavs;
+
+  private:
+    // Following constructors and assignment operators not supported
+    WavCache() = delete;
+    ~WavCache() = delete;
+    WavCache(const WavCache&) = delete;
+    WavCache(WavCache&&) = delete;
+    WavCache& operator=(const WavCache&) = delete;
+    WavCache& operator=(WavCache&&) = delete;
+};
+
+#endif  // WAV_CACHE_HXX
+
+#endif  // SOUND_SUPPORT
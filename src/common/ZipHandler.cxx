@@ -20,54 +20,17 @@
 #include <zlib.h>
 
 #include "Bankswitch.hxx"
+#include "MD5.hxx"
 #include "ZipHandler.hxx"
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void ZipHandler::open(const string& filename)
+void ZipHandler::open(const string& filename, uInt64 modified)
 {
-  // Close already open file (if any) and add to cache
-  addToCache();
-
   // Ensure we start with a nullptr result
   myZip.reset();
+  myHeader = nullptr;
 
-  ZipFilePtr ptr = findCached(filename);
-  if(ptr)
-  {
-    // Only a previously used entry will exist in the cache, so we know it's valid
-    myZip = std::move(ptr);
-
-    // Was already initialized; we just need to re-open it
-    if(!myZip->open())
-      throw std::runtime_error(errorMessage(ZipError::FILE_ERROR));
-  }
-  else
-  {
-    // Allocate memory for the ZipFile structure
-    try        { ptr = std::make_unique<ZipFile>(filename); }
-    catch(...) { throw std::runtime_error(errorMessage(ZipError::OUT_OF_MEMORY)); }
-
-    // Open the file and initialize it
-    if(!ptr->open())
-      throw std::runtime_error(errorMessage(ZipError::FILE_ERROR));
-    ptr->initialize();
-
-    myZip = std::move(ptr);
-
-    // Count ROM files (we do it here so it will be cached)
-    try
-    {
-      while(hasNext())
-      {
-        if(myZip->nextFileIsValidRom())
-          myZip->myRomfiles++;
-      }
-    }
-    catch(...)
-    {
-      myZip->myRomfiles = 0;
-    }
-  }
+  myZip = openFile(filename, modified);
 
   reset();  // Reset iterator to beginning for subsequent use
 }
@@ -76,14 +39,13 @@ void ZipHandler::open(const string& filename)
 void ZipHandler::reset()
 {
   // Reset the position and go from there
-  if(myZip)
-    myZip->myCdPos = 0;
+  myPos = 0;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool ZipHandler::hasNext() const
 {
-  return myZip && (myZip->myCdPos < myZip->myEcd.cdSize);
+  return myZip && (myPos < myZip->myDirectory->headers.size());
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -91,11 +53,12 @@ std::tuple<string, size_t> ZipHandler::next()
 {
   while(hasNext())
   {
-    const ZipHeader* const header = myZip->nextFile();
-    if(!header)
-      throw std::runtime_error(errorMessage(ZipError::FILE_CORRUPT));
-    if(header->uncompressedLength > 0)
-      return {string{header->filename}, header->uncompressedLength};
+    const ZipHeader& header = myZip->myDirectory->headers[myPos++];
+    if(header.uncompressedLength > 0)
+    {
+      myHeader = &header;
+      return {header.filename, header.uncompressedLength};
+    }
   }
   return {EmptyString(), 0};
 }
@@ -103,64 +66,118 @@ std::tuple<string, size_t> ZipHandler::next()
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 uInt64 ZipHandler::decompress(ByteBuffer& image)
 {
-  if(!myZip || myZip->myHeader.uncompressedLength == 0)
+  if(!myZip || !myHeader)
     throw std::runtime_error("Invalid ZIP archive");
 
-  const uInt64 length = myZip->myHeader.uncompressedLength;
+  const uInt64 length = myHeader->uncompressedLength;
   image = std::make_unique<uInt8[]>(length);
 
-  myZip->decompress(std::span<uInt8>(image.get(), static_cast<size_t>(length)));
+  myZip->decompress(*myHeader,
+                    std::span<uInt8>(image.get(), static_cast<size_t>(length)));
   return length;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-ZipHandler::ZipFilePtr ZipHandler::findCached(const string& filename)
+uInt64 ZipHandler::decompress(ByteBuffer& image, string& md5)
 {
-  auto it = myZipCache.find(filename);
-  if(it == myZipCache.end())
-      return {};
+  if(!myZip || !myHeader)
+    throw std::runtime_error("Invalid ZIP archive");
 
-  // Extract ZipFilePtr
-  ZipFilePtr result = std::move(it->second.first);
+  const uInt64 length = myHeader->uncompressedLength;
+  image = std::make_unique<uInt8[]>(length);
 
-  // Remove from both map and list
-  myCacheOrder.erase(it->second.second);
-  myZipCache.erase(it);
+  MD5 hasher;
+  myZip->decompress(*myHeader,
+                    std::span<uInt8>(image.get(), static_cast<size_t>(length)),
+                    &hasher);
+  md5 = hasher.hexdigest();
 
-  return result;
+  return length;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void ZipHandler::addToCache()
+unique_ptr<ZipHandler::SeekableStream> ZipHandler::openStream() const
 {
-  if(myZip == nullptr)
-    return;
+  if(!myZip || !myHeader)
+    throw std::runtime_error("Invalid ZIP archive");
+
+  // The stream gets a file handle of its own
+  auto zip = std::make_unique<ZipFile>(myZip->myFilename);
+  if(!zip->open())
+    throw std::runtime_error(errorMessage(ZipError::FILE_ERROR));
+  zip->myDirectory = myZip->myDirectory;
+
+  return std::make_unique<SeekableStream>(std::move(zip), *myHeader);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+ZipHandler::ZipFilePtr ZipHandler::openFile(const string& filename,
+                                            uInt64 modified)
+{
+  // Allocate memory for the ZipFile structure
+  ZipFilePtr ptr;
+  try        { ptr = std::make_unique<ZipFile>(filename); }
+  catch(...) { throw std::runtime_error(errorMessage(ZipError::OUT_OF_MEMORY)); }
+
+  // Open the file
+  if(!ptr->open())
+    throw std::runtime_error(errorMessage(ZipError::FILE_ERROR));
+
+  // Only read the central directory if it isn't cached yet, or the file
+  // was changed in the meantime
+  ptr->myDirectory = findCached(filename, modified, ptr->myLength);
+  if(!ptr->myDirectory)
+  {
+    ptr->myDirectory = ptr->readDirectory();
+    addToCache(filename, modified, ptr->myLength, ptr->myDirectory);
+  }
 
-  // Close the open file
-  myZip->close();
+  return ptr;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+ZipHandler::ZipDirectoryPtr ZipHandler::findCached(const string& filename,
+    uInt64 modified, uInt64 length)
+{
+  DirectoryCache& cache = directoryCache();
+  const std::lock_guard<std::mutex> lock(cache.mutex);
+
+  const auto it = cache.entries.find(filename);
+  if(it == cache.entries.end() ||
+     it->second.modified != modified || it->second.length != length)
+    return {};
 
-  const string key = myZip->myFilename;
+  // Mark as most recently used
+  cache.order.splice(cache.order.end(), cache.order, it->second.order);
+
+  return it->second.directory;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void ZipHandler::addToCache(const string& filename, uInt64 modified,
+                            uInt64 length, const ZipDirectoryPtr& directory)
+{
+  DirectoryCache& cache = directoryCache();
+  const std::lock_guard<std::mutex> lock(cache.mutex);
+
+  // Replace an outdated entry for the same file
+  if(const auto it = cache.entries.find(filename); it != cache.entries.end())
+  {
+    cache.order.erase(it->second.order);
+    cache.entries.erase(it);
+  }
 
   // If cache is full, evict the oldest entry
-  if(myZipCache.size() >= CACHE_SIZE)
+  if(cache.entries.size() >= CACHE_SIZE)
   {
-    const string& oldestKey = myCacheOrder.front();
-    myZipCache.erase(oldestKey);
-    myCacheOrder.pop_front();
+    cache.entries.erase(cache.order.front());
+    cache.order.pop_front();
   }
 
   // Insert the new entry at the back (most recently used)
-  myCacheOrder.push_back(key);
-  auto iter = std::prev(myCacheOrder.end());
-  myZipCache.emplace(key, std::make_pair(std::move(myZip), iter));
-
-#if 0
-  cerr << "\nCACHE contents:\n";
-    for(cachenum = 0; cachenum < myZipCache.size(); ++cachenum)
-      if(myZipCache[cachenum] != nullptr)
-        cerr << "  " << cachenum << " : " << myZipCache[cachenum]->filename << '\n';
-  cerr << '\n';
-#endif
+  cache.order.push_back(filename);
+  cache.entries.emplace(filename, DirectoryCache::Entry{
+      modified, length, directory, std::prev(cache.order.end())});
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -195,47 +212,66 @@ bool ZipHandler::ZipFile::open()
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void ZipHandler::ZipFile::initialize()
+ZipHandler::ZipDirectoryPtr ZipHandler::ZipFile::readDirectory()
 {
-  readEcd();
+  auto directory = std::make_shared<ZipDirectory>();
+  ZipEcd& ecd = directory->ecd;
+
+  readEcd(ecd);
 
   // Verify that we can work with this zipfile (no disk spanning allowed)
-  if(myEcd.diskNumber != myEcd.cdStartDiskNumber ||
-     myEcd.cdDiskEntries != myEcd.cdTotalEntries)
+  if(ecd.diskNumber != ecd.cdStartDiskNumber ||
+     ecd.cdDiskEntries != ecd.cdTotalEntries)
     throw std::runtime_error(errorMessage(ZipError::UNSUPPORTED));
 
   // Allocate memory for the central directory
-  myCd.resize(myEcd.cdSize);
+  vector<uInt8> cd(ecd.cdSize);
 
   // Read the central directory
   uInt64 read_length = 0;
-  const bool success = readStream(myCd.data(), myEcd.cdStartDiskOffset,
-                                  myEcd.cdSize, read_length);
+  const bool success = readStream(cd.data(), ecd.cdStartDiskOffset,
+                                  ecd.cdSize, read_length);
   if(!success)
     throw std::runtime_error(errorMessage(ZipError::FILE_ERROR));
-  else if(read_length != myEcd.cdSize)
+  else if(read_length != ecd.cdSize)
     throw std::runtime_error(errorMessage(ZipError::FILE_TRUNCATED));
-}
 
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void ZipHandler::ZipFile::close()
-{
-  if(myStream.is_open())
-    myStream.close();
-}
+  // Extract all file headers, and count ROM files (so it will be cached)
+  directory->headers.reserve(ecd.cdTotalEntries);
+  for(uInt64 pos = 0; pos < ecd.cdSize; )
+  {
+    // Make sure we have enough data
+    const CentralDirEntryReader reader(cd.data() + pos);
+    if(pos + CentralDirEntryReader::minimumLength() > ecd.cdSize ||
+       !reader.signatureCorrect() || pos + reader.totalLength() > ecd.cdSize)
+      throw std::runtime_error(errorMessage(ZipError::FILE_CORRUPT));
 
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool ZipHandler::ZipFile::nextFileIsValidRom()
-{
-  const ZipHeader* header = nextFile();
-  if(!header || header->uncompressedLength == 0)
-    return false;
+    // Extract file header info
+    ZipHeader& header = directory->headers.emplace_back();
+    header.versionCreated     = reader.versionCreated();
+    header.versionNeeded      = reader.versionNeeded();
+    header.bitFlag            = reader.generalFlag();
+    header.compression        = reader.compressionMethod();
+    header.crc                = reader.crc32();
+    header.compressedLength   = reader.compressedSize();
+    header.uncompressedLength = reader.uncompressedSize();
+    header.startDiskNumber    = reader.startDisk();
+    header.localHeaderOffset  = reader.headerOffset();
+    header.filename           = reader.filename();
+
+    if(header.uncompressedLength > 0 &&
+       Bankswitch::isValidRomName(header.filename))
+      directory->romFiles++;
+
+    // Advance the position
+    pos += reader.totalLength();
+  }
 
-  return Bankswitch::isValidRomName(header->filename);
+  return directory;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void ZipHandler::ZipFile::readEcd()
+void ZipHandler::ZipFile::readEcd(ZipEcd& ecd)
 {
   vector<uInt8> buffer;
 
@@ -261,12 +297,12 @@ void ZipHandler::ZipFile::readEcd()
       if(reader.signatureCorrect() &&
          ((static_cast<uInt64>(offset) + reader.totalLength()) <= buflen))
       {
-        myEcd.diskNumber        = reader.thisDiskNo();
-        myEcd.cdStartDiskNumber = reader.dirStartDisk();
-        myEcd.cdDiskEntries     = reader.dirDiskEntries();
-        myEcd.cdTotalEntries    = reader.dirTotalEntries();
-        myEcd.cdSize            = reader.dirSize();
-        myEcd.cdStartDiskOffset = reader.dirOffset();
+        ecd.diskNumber        = reader.thisDiskNo();
+        ecd.cdStartDiskNumber = reader.dirStartDisk();
+        ecd.cdDiskEntries     = reader.dirDiskEntries();
+        ecd.cdTotalEntries    = reader.dirTotalEntries();
+        ecd.cdSize            = reader.dirSize();
+        ecd.cdStartDiskOffset = reader.dirOffset();
         return;
       }
     }
@@ -295,71 +331,46 @@ bool ZipHandler::ZipFile::readStream(uInt8* out, uInt64 offset,
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-const ZipHandler::ZipHeader* ZipHandler::ZipFile::nextFile()
-{
-  // Make sure we have enough data
-  // If we're at or past the end, we're done
-  const CentralDirEntryReader reader(myCd.data() + myCdPos);
-  if(!reader.signatureCorrect() || ((myCdPos + reader.totalLength()) > myEcd.cdSize))
-    return nullptr;
-
-  // Extract file header info
-  myHeader.versionCreated     = reader.versionCreated();
-  myHeader.versionNeeded      = reader.versionNeeded();
-  myHeader.bitFlag            = reader.generalFlag();
-  myHeader.compression        = reader.compressionMethod();
-  myHeader.crc                = reader.crc32();
-  myHeader.compressedLength   = reader.compressedSize();
-  myHeader.uncompressedLength = reader.uncompressedSize();
-  myHeader.startDiskNumber    = reader.startDisk();
-  myHeader.localHeaderOffset  = reader.headerOffset();
-  myHeader.filename           = reader.filename();
-
-  // Advance the position
-  myCdPos += reader.totalLength();
-  return &myHeader;
-}
-
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void ZipHandler::ZipFile::decompress(std::span<uInt8> out)
+void ZipHandler::ZipFile::decompress(const ZipHeader& header,
+                                     std::span<uInt8> out, MD5* md5)
 {
   // If we don't have enough buffer, error
-  if(out.size() < myHeader.uncompressedLength)
+  if(out.size() < header.uncompressedLength)
     throw std::runtime_error(errorMessage(ZipError::BUFFER_TOO_SMALL));
 
   // Make sure the info in the header aligns with what we know
-  if(myHeader.startDiskNumber != myEcd.diskNumber)
+  if(header.startDiskNumber != myDirectory->ecd.diskNumber)
     throw std::runtime_error(errorMessage(ZipError::UNSUPPORTED));
 
   // Get the compressed data offset
-  const uInt64 offset = getCompressedDataOffset();
+  const uInt64 offset = getCompressedDataOffset(header);
 
   // Handle compression types
-  switch(myHeader.compression)
+  switch(header.compression)
   {
-    case 0: decompressDataType0(out, offset); break;
-    case 8: decompressDataType8(out, offset); break;
+    case 0: decompressDataType0(header, out, offset, md5); break;
+    case 8: decompressDataType8(header, out, offset, md5); break;
     default:
       throw std::runtime_error(errorMessage(ZipError::UNSUPPORTED));
   }
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-uInt64 ZipHandler::ZipFile::getCompressedDataOffset()
+uInt64 ZipHandler::ZipFile::getCompressedDataOffset(const ZipHeader& header)
 {
   // Don't support a number of features
-  const GeneralFlagReader flags(myHeader.bitFlag);
-  if(myHeader.startDiskNumber != myEcd.diskNumber ||
-     myHeader.versionNeeded > 63 || flags.patchData() ||
+  const GeneralFlagReader flags(header.bitFlag);
+  if(header.startDiskNumber != myDirectory->ecd.diskNumber ||
+     header.versionNeeded > 63 || flags.patchData() ||
      flags.encrypted() || flags.strongEncryption())
     throw std::runtime_error(errorMessage(ZipError::UNSUPPORTED));
 
-  // Use a small local buffer; myBuffer is reserved for streaming decompression
+  // Read into a small local buffer
   std::array<uInt8, LocalFileHeaderReader::minimumLength()> localBuf{};
 
   // Read the fixed-sized part of the local file header
   uInt64 read_length = 0;
-  const bool success = readStream(localBuf.data(), myHeader.localHeaderOffset,
+  const bool success = readStream(localBuf.data(), header.localHeaderOffset,
                                   localBuf.size(), read_length);
   if(!success)
     throw std::runtime_error(errorMessage(ZipError::FILE_ERROR));
@@ -371,33 +382,42 @@ uInt64 ZipHandler::ZipFile::getCompressedDataOffset()
   if(!reader.signatureCorrect())
     throw std::runtime_error(errorMessage(ZipError::BAD_SIGNATURE));
 
-  return myHeader.localHeaderOffset + reader.totalLength();
+  return header.localHeaderOffset + reader.totalLength();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void ZipHandler::ZipFile::decompressDataType0(std::span<uInt8> out,
-                                              uInt64 offset)
+void ZipHandler::ZipFile::decompressDataType0(const ZipHeader& header,
+                                              std::span<uInt8> out,
+                                              uInt64 offset, MD5* md5)
 {
   // The data is uncompressed; just read it
   uInt64 read_length = 0;
   const bool success = readStream(out.data(), offset,
-                                  myHeader.compressedLength, read_length);
+                                  header.compressedLength, read_length);
   if(!success)
     throw std::runtime_error(errorMessage(ZipError::FILE_ERROR));
-  else if(read_length != myHeader.compressedLength)
+  else if(read_length != header.compressedLength)
     throw std::runtime_error(errorMessage(ZipError::FILE_TRUNCATED));
+
+  if(md5)
+    md5->update(out.data(), static_cast<size_t>(read_length));
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void ZipHandler::ZipFile::decompressDataType8(std::span<uInt8> out,
-                                              uInt64 offset)
+void ZipHandler::ZipFile::decompressDataType8(const ZipHeader& header,
+                                              std::span<uInt8> out,
+                                              uInt64 offset, MD5* md5)
 {
   // Seek ONCE to start of compressed data
   myStream.seekg(offset, std::ios::beg);
   if(!myStream)
     throw std::runtime_error(errorMessage(ZipError::FILE_ERROR));
 
-  size_t input_remaining = myHeader.compressedLength;
+  size_t input_remaining = header.compressedLength;
+
+  // Input buffer; each decompression has its own, since several can run
+  // in parallel (on different ZipFile objects)
+  vector<uInt8> buffer(std::min<size_t>(input_remaining, DECOMPRESS_BUFSIZE));
 
   // Setup zlib stream
   z_stream stream{};
@@ -407,7 +427,12 @@ void ZipHandler::ZipFile::decompressDataType8(std::span<uInt8> out,
   stream.avail_in  = 0;
   stream.next_in   = Z_NULL;
   stream.next_out  = out.data();
-  stream.avail_out = static_cast<uInt32>(out.size());
+  stream.avail_out = 0;
+
+  // When hashing, inflate in small pieces so each one is still in the
+  // cache when it's fed to the MD5
+  size_t output_remaining = out.size();
+  const size_t outputChunk = md5 ? HASH_CHUNKSIZE : output_remaining;
 
   // RAII cleanup
   struct InflateGuard {
@@ -435,7 +460,7 @@ void ZipHandler::ZipFile::decompressDataType8(std::span<uInt8> out,
       const size_t chunkSize = std::min(input_remaining, DECOMPRESS_BUFSIZE);
 
       // Read in the next chunk of data
-      myStream.read(reinterpret_cast<char*>(myBuffer.data()), chunkSize);
+      myStream.read(reinterpret_cast<char*>(buffer.data()), chunkSize);
       const auto read_length = static_cast<uInt64>(myStream.gcount());
 
       // If we read nothing, but still have data left, the file is truncated
@@ -447,15 +472,23 @@ void ZipHandler::ZipFile::decompressDataType8(std::span<uInt8> out,
         throw std::runtime_error(errorMessage(ZipError::FILE_ERROR));
 
       // Fill out the input data
-      stream.next_in  = myBuffer.data();
+      stream.next_in  = buffer.data();
       stream.avail_in = static_cast<uInt32>(read_length);
 
       input_remaining -= read_length;
     }
 
     // Now inflate
+    uInt8* const chunk = stream.next_out;
+    stream.avail_out = static_cast<uInt32>(
+        std::min(output_remaining, outputChunk));
     const int zerr = inflate(&stream, Z_NO_FLUSH);
 
+    const auto inflated = static_cast<size_t>(stream.next_out - chunk);
+    output_remaining -= inflated;
+    if(md5)
+      md5->update(chunk, inflated);
+
     if(zerr == Z_STREAM_END)
       break;
 
@@ -465,8 +498,200 @@ void ZipHandler::ZipFile::decompressDataType8(std::span<uInt8> out,
 
   // Final validation
   // If anything looks funny, report an error
-  if(stream.avail_out > 0 || input_remaining > 0)
+  if(output_remaining > 0 || input_remaining > 0)
     throw std::runtime_error(errorMessage(ZipError::DECOMPRESS_ERROR));
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// ZipHandler::SeekableStream implementation
+//
+
+struct ZipHandler::SeekableStream::Inflater
+{
+  z_stream stream{};
+
+  Inflater() {
+    if(inflateInit2(&stream, -MAX_WBITS) != Z_OK)
+      throw std::runtime_error(errorMessage(ZipError::DECOMPRESS_ERROR));
+  }
+  ~Inflater() { inflateEnd(&stream); }
+
+  Inflater(const Inflater&) = delete;
+  Inflater(Inflater&&) = delete;
+  Inflater& operator=(const Inflater&) = delete;
+  Inflater& operator=(Inflater&&) = delete;
+};
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+ZipHandler::SeekableStream::SeekableStream(ZipFilePtr zip,
+                                           const ZipHeader& header)
+  : myZip{std::move(zip)},
+    myHeader{header}
+{
+  myDataOffset = myZip->getCompressedDataOffset(myHeader);
+
+  switch(myHeader.compression)
+  {
+    case 0:
+      break;
+
+    case 8:
+      myInflater = std::make_unique<Inflater>();
+      myInput.resize(static_cast<size_t>(
+          std::min<uInt64>(myHeader.compressedLength, ZipFile::DECOMPRESS_BUFSIZE)));
+      myWindow.resize(WINDOW_SIZE);
+      break;
+
+    default:
+      throw std::runtime_error(errorMessage(ZipError::UNSUPPORTED));
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+ZipHandler::SeekableStream::~SeekableStream()  // NOLINT (Inflater is incomplete in the header)
+{
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void ZipHandler::SeekableStream::read(uInt64 offset, std::span<uInt8> out)
+{
+  if(offset > size() || out.size() > size() - offset)
+    throw std::runtime_error(errorMessage(ZipError::FILE_TRUNCATED));
+
+  // Stored data can be read directly
+  if(!myInflater)
+  {
+    uInt64 read_length = 0;
+    if(!myZip->readStream(out.data(), myDataOffset + offset, out.size(),
+                          read_length))
+      throw std::runtime_error(errorMessage(ZipError::FILE_ERROR));
+    else if(read_length != out.size())
+      throw std::runtime_error(errorMessage(ZipError::FILE_TRUNCATED));
+    return;
+  }
+
+  // Restart at the nearest access point before 'offset', unless inflating
+  // on from the current position gets there sooner
+  const auto next = std::ranges::upper_bound(myAccessPoints, offset, {},
+                                             &AccessPoint::out);
+  const AccessPoint* point =
+    next == myAccessPoints.begin() ? nullptr : &*std::prev(next);
+  if(offset < myPosition || (point && point->out > myPosition))
+    restart(point);
+
+  // Skip the data up to 'offset'
+  const uInt8* chunk = nullptr;
+  while(myPosition < offset)
+    inflateChunk(static_cast<size_t>(offset - myPosition), chunk);
+
+  for(size_t done = 0; done < out.size(); )
+  {
+    const size_t inflated = inflateChunk(out.size() - done, chunk);
+    std::copy_n(chunk, inflated, out.begin() + done);
+    done += inflated;
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void ZipHandler::SeekableStream::restart(const AccessPoint* point)
+{
+  z_stream& stream = myInflater->stream;
+  if(inflateReset(&stream) != Z_OK)
+    throw std::runtime_error(errorMessage(ZipError::DECOMPRESS_ERROR));
+  stream.avail_in = 0;
+
+  if(!point)
+  {
+    myInputRead = myPosition = 0;
+    myWindowPos = 0;
+    return;
+  }
+
+  // An access point can be in the middle of a byte
+  if(point->bits > 0)
+  {
+    uInt8 byte = 0;
+    uInt64 read_length = 0;
+    if(!myZip->readStream(&byte, myDataOffset + point->in - 1, 1, read_length) ||
+       read_length != 1)
+      throw std::runtime_error(errorMessage(ZipError::FILE_ERROR));
+    inflatePrime(&stream, point->bits, byte >> (8 - point->bits));
+  }
+  if(inflateSetDictionary(&stream, point->window.data(), WINDOW_SIZE) != Z_OK)
+    throw std::runtime_error(errorMessage(ZipError::DECOMPRESS_ERROR));
+
+  myInputRead = point->in;
+  myPosition = point->out;
+  std::ranges::copy(point->window, myWindow.begin());
+  myWindowPos = 0;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+size_t ZipHandler::SeekableStream::inflateChunk(size_t length,
+                                                const uInt8*& chunk)
+{
+  z_stream& stream = myInflater->stream;
+
+  // Refill input buffer when empty
+  if(stream.avail_in == 0)
+  {
+    const uInt64 remaining = myHeader.compressedLength - myInputRead;
+    uInt64 read_length = 0;
+    if(remaining == 0)
+      throw std::runtime_error(errorMessage(ZipError::FILE_TRUNCATED));
+    if(!myZip->readStream(myInput.data(), myDataOffset + myInputRead,
+                          std::min<uInt64>(remaining, myInput.size()),
+                          read_length))
+      throw std::runtime_error(errorMessage(ZipError::FILE_ERROR));
+    if(read_length == 0)
+      throw std::runtime_error(errorMessage(ZipError::FILE_TRUNCATED));
+
+    stream.next_in  = myInput.data();
+    stream.avail_in = static_cast<uInt32>(read_length);
+    myInputRead += read_length;
+  }
+
+  // Inflate into the window, stopping at the end of each block
+  if(myWindowPos == WINDOW_SIZE)
+    myWindowPos = 0;
+  chunk = myWindow.data() + myWindowPos;
+  stream.next_out  = myWindow.data() + myWindowPos;
+  stream.avail_out = static_cast<uInt32>(std::min(length, WINDOW_SIZE - myWindowPos));
+
+  const int zerr = inflate(&stream, Z_BLOCK);
+  const auto inflated = static_cast<size_t>(stream.next_out - chunk);
+  if((zerr != Z_OK && zerr != Z_STREAM_END) ||
+     (zerr == Z_STREAM_END && inflated == 0))
+    throw std::runtime_error(errorMessage(ZipError::DECOMPRESS_ERROR));
+
+  myWindowPos += inflated;
+  myPosition += inflated;
+
+  // Inflating can be restarted after the end of a block (but not the last)
+  const uInt64 lastPoint = myAccessPoints.empty() ? 0 : myAccessPoints.back().out;
+  if((stream.data_type & 128) && !(stream.data_type & 64) &&
+     myPosition >= lastPoint + ACCESS_POINT_SPAN)
+    addAccessPoint();
+
+  return inflated;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void ZipHandler::SeekableStream::addAccessPoint()
+{
+  const z_stream& stream = myInflater->stream;
+
+  AccessPoint& point = myAccessPoints.emplace_back();
+  point.out  = myPosition;
+  point.in   = myInputRead - stream.avail_in;
+  point.bits = stream.data_type & 7;
+
+  // Oldest bytes first
+  point.window.reserve(WINDOW_SIZE);
+  point.window.insert(point.window.end(),
+                      myWindow.begin() + myWindowPos, myWindow.end());
+  point.window.insert(point.window.end(),
+                      myWindow.begin(), myWindow.begin() + myWindowPos);
+}
+
 #endif  /* ZIP_SUPPORT */
@@ -24,10 +24,13 @@
 #include <span>
 #include <tuple>
 #include <list>
+#include <mutex>
 #include <unordered_map>
 
 #include "bspf.hxx"
 
+class MD5;
+
 /**
   This class implements a thin wrapper around the zip file management code
   from the MAME project.
@@ -42,8 +45,10 @@ class ZipHandler
     ~ZipHandler() = default;
 
     // Open ZIP file for processing
+    // The central directory is cached for all handlers, and only read again
+    // when the modification time ('modified') or size of the file changes
     // An exception will be thrown on any errors
-    void open(const string& filename);
+    void open(const string& filename, uInt64 modified);
 
     // The following form an iterator for processing the filenames in the ZIP file
     void reset();          // Reset iterator to first file
@@ -56,8 +61,20 @@ class ZipHandler
     //       will require changes to FSNode and friends
     uInt64 decompress(ByteBuffer& image);
 
+    // Same as above, but also compute the MD5 of the file contents as they
+    // are being decompressed, instead of in a second pass afterwards
+    uInt64 decompress(ByteBuffer& image, string& md5);
+
+    // Random access to the contents of a file, see below
+    class SeekableStream;
+
+    // Open the currently selected file for random access, without
+    // decompressing it up front
+    // An exception will be thrown on any errors
+    unique_ptr<SeekableStream> openStream() const;
+
     // Answer the number of ROM files (with a valid extension) found
-    uInt16 romFiles() const { return myZip ? myZip->myRomfiles : 0; }
+    uInt16 romFiles() const { return myZip ? myZip->myDirectory->romFiles : 0; }
 
   private:
     // Error types
@@ -103,23 +120,26 @@ class ZipHandler
       uInt64 cdStartDiskOffset{0}; // offset of start of central directory with respect to the starting disk number
     };
 
+    // Contains the parsed central directory, which never changes once read
+    struct ZipDirectory
+    {
+      ZipEcd ecd;                 // end of central directory
+      vector<ZipHeader> headers;  // all file headers, in directory order
+      uInt16 romFiles{0};         // number of ROM files in central directory
+    };
+    using ZipDirectoryPtr = shared_ptr<const ZipDirectory>;
+
     // Describes an open ZIP file
     struct ZipFile
     {
       static constexpr size_t DECOMPRESS_BUFSIZE = 128_KB;
+      static constexpr size_t HASH_CHUNKSIZE = 16_KB;
 
       string  myFilename;     // copy of ZIP filename (for caching)
       std::fstream myStream;  // C++ fstream file handle
       uInt64  myLength{0};    // length of zip file
-      uInt16  myRomfiles{0};  // number of ROM files in central directory
-
-      ZipEcd  myEcd;          // end of central directory
-
-      vector<uInt8> myCd;     // central directory raw data
-      uInt64    myCdPos{0};   // position in central directory
-      ZipHeader myHeader;     // current file header
 
-      array<uInt8, DECOMPRESS_BUFSIZE> myBuffer{}; // buffer for decompression
+      ZipDirectoryPtr myDirectory;  // central directory (possibly cached)
 
       /** Constructor */
       explicit ZipFile(const string& filename);
@@ -127,35 +147,30 @@ class ZipHandler
       /** Open the file and set up the internal stream buffer*/
       bool open();
 
-      /** Read the ZIP contents from the internal stream buffer */
-      void initialize();
-
-      /** Close previously opened internal stream buffer */
-      void close();
-
-      /** Answers whether the next file is a valid ROM based on filename */
-      bool nextFileIsValidRom();
+      /** Read and parse the central directory from the internal stream buffer */
+      ZipDirectoryPtr readDirectory();
 
       /** Read the ECD data */
-      void readEcd();
+      void readEcd(ZipEcd& ecd);
 
       /** Read data from stream */
       bool readStream(uInt8* out, uInt64 offset, uInt64 length, uInt64& actual);
 
-      /** Return the next entry in the ZIP file */
-      const ZipHeader* nextFile();
-
-      /** Decompress the most recently found file in the ZIP into target buffer */
-      void decompress(std::span<uInt8> out);
+      /** Decompress the given file in the ZIP into target buffer,
+          optionally feeding the decompressed data to 'md5' */
+      void decompress(const ZipHeader& header, std::span<uInt8> out,
+                      MD5* md5 = nullptr);
 
       /** Return the offset of the compressed data */
-      uInt64 getCompressedDataOffset();
+      uInt64 getCompressedDataOffset(const ZipHeader& header);
 
       /** Decompress type 0 data (which is uncompressed) */
-      void decompressDataType0(std::span<uInt8> out, uInt64 offset);
+      void decompressDataType0(const ZipHeader& header, std::span<uInt8> out,
+                               uInt64 offset, MD5* md5);
 
       /** Decompress type 8 data (which is deflated) */
-      void decompressDataType8(std::span<uInt8> out, uInt64 offset);
+      void decompressDataType8(const ZipHeader& header, std::span<uInt8> out,
+                               uInt64 offset, MD5* md5);
     };
     using ZipFilePtr = unique_ptr<ZipFile>;
 
@@ -327,21 +342,41 @@ class ZipHandler
       return zip_error_s[static_cast<size_t>(err)];
     }
 
-    /** Search cache for given ZIP file */
-    ZipFilePtr findCached(const string& filename);
+    /** Open the given ZIP file, and get its central directory */
+    static ZipFilePtr openFile(const string& filename, uInt64 modified);
 
-    /** Close a ZIP file and add it to the cache */
-    void addToCache();
+    /** Search cache for the central directory of given ZIP file */
+    static ZipDirectoryPtr findCached(const string& filename, uInt64 modified,
+                                      uInt64 length);
+
+    /** Add the central directory of a ZIP file to the cache */
+    static void addToCache(const string& filename, uInt64 modified,
+                           uInt64 length, const ZipDirectoryPtr& directory);
 
   private:
-    static constexpr size_t CACHE_SIZE = 64; // number of open files to cache
+    static constexpr size_t CACHE_SIZE = 64; // number of directories to cache
 
-    ZipFilePtr myZip;
+    // Process-wide LRU cache of central directories, shared by all threads
+    struct DirectoryCache
+    {
+      struct Entry
+      {
+        uInt64 modified{0}, length{0};  // of the ZIP file when it was read
+        ZipDirectoryPtr directory;
+        std::list<string>::iterator order;
+      };
+      std::mutex mutex;
+      std::unordered_map<string, Entry> entries;  // filename -> directory
+      std::list<string> order; // front = oldest, back = newest
+    };
+    static DirectoryCache& directoryCache() {
+      static DirectoryCache cache;
+      return cache;
+    }
 
-    // LRU cache: map filename -> (ZipFilePtr, iterator in list)
-    std::unordered_map<string, std::pair<ZipFilePtr,
-                       std::list<string>::iterator>> myZipCache;
-    std::list<string> myCacheOrder; // front = oldest, back = newest
+    ZipFilePtr myZip;
+    size_t myPos{0};  // position of iterator in central directory
+    const ZipHeader* myHeader{nullptr};  // most recently returned file
 
   private:
     // Following constructors and assignment operators not supported
@@ -351,6 +386,83 @@ class ZipHandler
     ZipHandler& operator=(ZipHandler&&) = delete;
 };
 
+/**
+  Random access to a (possibly large) file in a ZIP archive, without
+  decompressing all of it up front.  Stored files are read directly.
+  Deflated files are inflated on demand, and every ACCESS_POINT_SPAN bytes
+  (at the next deflate block boundary) the state needed to restart inflating
+  there is recorded: the position in the compressed data, including the bit
+  offset, and the last 32 KB of output.  Seeking backwards then only has to
+  inflate from the nearest access point, instead of from the start.
+
+  Each stream has its own file handle, so it can be used from another
+  thread than the handler which opened it (but only from one at a time).
+*/
+class ZipHandler::SeekableStream
+{
+  public:
+    static constexpr size_t ACCESS_POINT_SPAN = 1024_KB;
+
+    SeekableStream(ZipFilePtr zip, const ZipHeader& header);
+    ~SeekableStream();
+
+    // Size of the (uncompressed) file
+    uInt64 size() const { return myHeader.uncompressedLength; }
+
+    // Read 'out.size()' bytes starting at 'offset' into 'out'
+    // An exception will be thrown on any errors
+    void read(uInt64 offset, std::span<uInt8> out);
+
+  private:
+    static constexpr size_t WINDOW_SIZE = 32_KB;  // deflate window size
+
+    struct AccessPoint
+    {
+      uInt64 out{0};        // position in the uncompressed data
+      uInt64 in{0};         // position in the compressed data
+      int bits{0};          // bits of the byte before 'in' still to be used
+      vector<uInt8> window; // the WINDOW_SIZE bytes of output before 'out'
+    };
+
+    /** Restart inflating at the given access point (or the start) */
+    void restart(const AccessPoint* point);
+
+    /** Inflate at most 'length' bytes, and set 'chunk' to them */
+    size_t inflateChunk(size_t length, const uInt8*& chunk);
+
+    /** Record an access point at the current position */
+    void addAccessPoint();
+
+  private:
+    ZipFilePtr myZip;
+    ZipHeader myHeader;
+    uInt64 myDataOffset{0};  // offset of the compressed data
+
+    // The zlib stream (only for deflated files)
+    struct Inflater;
+    unique_ptr<Inflater> myInflater;
+
+    vector<uInt8> myInput;   // compressed data
+    uInt64 myInputRead{0};   // compressed bytes read so far
+
+    // Circular buffer of the most recent output; when it has wrapped,
+    // the oldest byte is at 'myWindowPos'
+    vector<uInt8> myWindow;
+    size_t myWindowPos{0};
+
+    uInt64 myPosition{0};    // uncompressed bytes inflated so far
+
+    vector<AccessPoint> myAccessPoints;  // sorted by 'out'
+
+  private:
+    // Following constructors and assignment operators not supported
+    SeekableStream() = delete;
+    SeekableStream(const SeekableStream&) = delete;
+    SeekableStream(SeekableStream&&) = delete;
+    SeekableStream& operator=(const SeekableStream&) = delete;
+    SeekableStream& operator=(SeekableStream&&) = delete;
+};
+
 #endif  /* ZIP_HANDLER_HXX */
 
 #endif  /* ZIP_SUPPORT */
@@ -0,0 +1,195 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2026 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#include <cmath>
+
+#include "BlepResampler.hxx"
+
+namespace {
+
+  constexpr float CLIPPING_FACTOR = 0.75;
+  constexpr float HIGH_PASS_CUT_OFF = 10;
+
+  // The cut-off frequency of the steps, relative to the output Nyquist
+  // frequency (leaves room for the transition band of the window)
+  constexpr double CUT_OFF = 0.9;
+
+  double sinc(double x)
+  {
+    return x == 0. ? 1. : sin(BSPF::PI_d * x) / (BSPF::PI_d * x);
+  }
+
+  double blackman(double x, double width)
+  {
+    // x in [-width / 2, width / 2]
+    const double t = 2. * BSPF::PI_d * (x / width + 0.5);
+
+    return 0.42 - 0.5 * cos(t) + 0.08 * cos(2. * t);
+  }
+
+} // namespace
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+BlepResampler::BlepResampler(
+    Resampler::Format formatFrom,
+    Resampler::Format formatTo,
+    const Resampler::NextFragmentCallback& nextFragmentCallback)
+  : Resampler(formatFrom, formatTo, nextFragmentCallback),
+    myHighPassL{HIGH_PASS_CUT_OFF, static_cast<float>(formatTo.sampleRate)},
+    myHighPassR{HIGH_PASS_CUT_OFF, static_cast<float>(formatTo.sampleRate)}
+{
+  precomputeKernels();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void BlepResampler::precomputeKernels()
+{
+  // A step at phase k lies k / PHASES output samples after the current
+  // output sample, and appears with a delay of half the kernel size
+  constexpr double width = KERNEL_SIZE;
+
+  for(uInt32 k = 0; k < PHASES; ++k)
+  {
+    float* kernel = myKernels.data() + static_cast<size_t>(KERNEL_SIZE) * k;
+    const double offset = width / 2 + static_cast<double>(k) / PHASES;
+    double sum = 0.;
+
+    for(uInt32 j = 0; j < KERNEL_SIZE; ++j)
+    {
+      const double x = static_cast<double>(j) - offset;
+      const double value = std::abs(x) < width / 2
+        ? CUT_OFF * sinc(CUT_OFF * x) * blackman(x, width) : 0.;
+
+      kernel[j] = static_cast<float>(value);
+      sum += value;
+    }
+
+    // Each step must reach its full height, otherwise the output drifts
+    for(uInt32 j = 0; j < KERNEL_SIZE; ++j)
+      kernel[j] = static_cast<float>(kernel[j] / sum);
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void BlepResampler::fillFragment(float* fragment, uInt32 length)
+{
+  if (myIsUnderrun) {
+    Int16* nextFragment = myNextFragmentCallback();
+
+    if (nextFragment) {
+      myCurrentFragment = nextFragment;
+      myFragmentIndex = 0;
+      myIsUnderrun = false;
+    }
+  }
+
+  if (!myCurrentFragment) {
+    std::fill_n(fragment, length, 0.F);
+    return;
+  }
+
+  const size_t outputSamples = myFormatTo.stereo ? (length >> 1) : length;
+  const uInt64 timeIndexPerSample = myFormatTo.sampleRate * TIME_SUBDIVISION;
+  const float volume = myVolume.load(std::memory_order_relaxed);
+
+  for (size_t i = 0; i < outputSamples; ++i) {
+    // Add the steps of all input samples starting before the next output
+    // sample
+    while (myNextSampleTime < myTimeStep) {
+      nextSample(static_cast<uInt32>(myNextSampleTime * PHASES / myTimeStep));
+      myNextSampleTime += timeIndexPerSample;
+    }
+    myNextSampleTime -= myTimeStep;
+
+    // Integrate the impulses of the steps
+    float& impulseL = myImpulses[0][myReadIndex];
+    float& impulseR = myImpulses[1][myReadIndex];
+    myLevel[0] += impulseL;
+    myLevel[1] += impulseR;
+    impulseL = impulseR = 0.F;
+    myReadIndex = (myReadIndex + 1) & (BUFFER_SIZE - 1);
+
+    if (myFormatFrom.stereo) {
+      const float sampleL = myHighPassL.apply(myLevel[0]) * volume;
+      const float sampleR = myHighPassR.apply(myLevel[1]) * volume;
+
+      if (myFormatTo.stereo) {
+        fragment[2*i] = sampleL;
+        fragment[2*i + 1] = sampleR;
+      }
+      else
+        fragment[i] = (sampleL + sampleR) / 2.F;
+    } else {
+      const float sample = myHighPassL.apply(myLevel[0]) * volume;
+
+      if (myFormatTo.stereo)
+        fragment[2*i] = fragment[2*i + 1] = sample;
+      else
+        fragment[i] = sample;
+    }
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void BlepResampler::nextSample(uInt32 phase)
+{
+  constexpr float scale = CLIPPING_FACTOR / static_cast<float>(0x7fff);
+
+  if (myFormatFrom.stereo) {
+    const float sampleL = myCurrentFragment[2 * static_cast<size_t>(myFragmentIndex)] * scale;
+    const float sampleR = myCurrentFragment[2 * static_cast<size_t>(myFragmentIndex) + 1] * scale;
+
+    addStep(0, sampleL - myInput[0], phase);
+    addStep(1, sampleR - myInput[1], phase);
+    myInput[0] = sampleL;
+    myInput[1] = sampleR;
+  }
+  else {
+    const float sample = myCurrentFragment[myFragmentIndex] * scale;
+
+    addStep(0, sample - myInput[0], phase);
+    myInput[0] = sample;
+  }
+
+  ++myFragmentIndex;
+
+  if (myFragmentIndex >= myFormatFrom.fragmentSize) {
+    myFragmentIndex %= myFormatFrom.fragmentSize;
+
+    Int16* nextFragment = myNextFragmentCallback();
+    if (nextFragment) {
+      myCurrentFragment = nextFragment;
+      myIsUnderrun = false;
+    } else {
+      myUnderrunLogger.log();
+      myIsUnderrun = true;
+    }
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+FORCE_INLINE void BlepResampler::addStep(uInt32 channel, float delta, uInt32 phase)
+{
+  // Most input samples just continue the current level
+  if (delta == 0.F) return;
+
+  const float* kernel = myKernels.data() + static_cast<size_t>(KERNEL_SIZE) * phase;
+  auto& impulses = myImpulses[channel];
+
+  for (uInt32 j = 0; j < KERNEL_SIZE; ++j)
+    impulses[(myReadIndex + j) & (BUFFER_SIZE - 1)] += delta * kernel[j];
+}
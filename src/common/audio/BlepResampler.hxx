@@ -0,0 +1,106 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2026 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#ifndef BLEP_RESAMPLER_HXX
+#define BLEP_RESAMPLER_HXX
+
+#include "bspf.hxx"
+#include "Resampler.hxx"
+#include "HighPass.hxx"
+
+/**
+  Synthesizes the output directly from the transitions of the TIA output.
+  The TIA output is a step function, whose level only changes when a channel
+  changes its volume, so each transition is written as a band-limited step
+  (BLEP) into the output, at its exact (sub-sample) position.  The output is
+  the running sum of these steps.
+
+  Unlike the Lanczos resampler, which convolutes every output sample with
+  all input samples in its kernel, the cost per output sample is constant,
+  plus one kernel per transition (which are rare compared to the sample
+  rate).
+
+  @author  Stella Team
+*/
+class BlepResampler : public Resampler
+{
+  public:
+    BlepResampler(
+      Resampler::Format formatFrom,
+      Resampler::Format formatTo,
+      const Resampler::NextFragmentCallback& nextFragmentCallback
+    );
+    ~BlepResampler() override = default;
+
+    void fillFragment(float* fragment, uInt32 length) override;
+
+  private:
+    void precomputeKernels();
+
+    /**
+      Read the next input sample and add the steps to its levels.
+
+      @param phase  The position of the step between the current and the
+                    next output sample (0 .. PHASES - 1)
+    */
+    void nextSample(uInt32 phase);
+
+    void addStep(uInt32 channel, float delta, uInt32 phase);
+
+  private:
+    // The number of output samples covered by a band-limited step, which is
+    // also the delay of the output
+    static constexpr uInt32 KERNEL_SIZE = 16;
+
+    // The resolution of the step positions between two output samples
+    static constexpr uInt32 PHASES = 64;
+
+    // The size of the ring buffers for the pending steps (power of two)
+    static constexpr uInt32 BUFFER_SIZE = 32;
+    static_assert(BUFFER_SIZE >= KERNEL_SIZE + 1);
+
+    // One band-limited impulse per phase, which are integrated into steps
+    std::array<float, static_cast<size_t>(PHASES) * KERNEL_SIZE> myKernels{};
+
+    // The impulses of pending steps for each channel, and the integrated
+    // output level
+    std::array<std::array<float, BUFFER_SIZE>, 2> myImpulses{};
+    std::array<float, 2> myLevel{};
+    uInt32 myReadIndex{0};
+
+    // The level of the last input sample for each channel
+    std::array<float, 2> myInput{};
+
+    Int16* myCurrentFragment{nullptr};
+    uInt32 myFragmentIndex{0};
+    bool myIsUnderrun{true};
+
+    HighPass myHighPassL;
+    HighPass myHighPassR;
+
+    // The time until the next input sample starts
+    uInt64 myNextSampleTime{0};
+
+  private:
+    BlepResampler() = delete;
+    BlepResampler(const BlepResampler&) = delete;
+    BlepResampler(BlepResampler&&) = delete;
+    BlepResampler& operator=(const BlepResampler&) = delete;
+    BlepResampler& operator=(BlepResampler&&) = delete;
+};
+
+#endif // BLEP_RESAMPLER_HXX
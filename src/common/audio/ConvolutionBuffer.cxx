@@ -15,31 +15,126 @@
 // this file, and for a DISCLAIMER OF ALL WARRANTIES.
 //============================================================================
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+  #define CONVOLUTION_SSE2
+  #include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__) || defined(_M_ARM64)
+  #define CONVOLUTION_NEON
+  #include <arm_neon.h>
+#endif
+
 #include "ConvolutionBuffer.hxx"
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-ConvolutionBuffer::ConvolutionBuffer(uInt32 size)
-  : myData{std::make_unique<float[]>(size)},
-    mySize{size}
+ConvolutionBuffer::ConvolutionBuffer(uInt32 size, bool stereo)
+  : myData{std::make_unique<float[]>(static_cast<size_t>(size) * (stereo ? 4 : 2))},
+    mySize{size},
+    myChannels{stereo ? 2U : 1U}
 {
-  std::fill_n(myData.get(), mySize, 0.F);
+  std::fill_n(myData.get(), static_cast<size_t>(mySize) * myChannels * 2, 0.F);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void ConvolutionBuffer::shift(float nextValue)
 {
-  myData[myFirstIndex] = nextValue;
+  myData[myFirstIndex] = myData[myFirstIndex + mySize] = nextValue;
+  myFirstIndex = (myFirstIndex + 1) % mySize;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void ConvolutionBuffer::shift(float nextLeft, float nextRight)
+{
+  float* const data = myData.get() + 2 * static_cast<size_t>(myFirstIndex);
+
+  data[0] = data[2 * mySize] = nextLeft;
+  data[1] = data[2 * mySize + 1] = nextRight;
   myFirstIndex = (myFirstIndex + 1) % mySize;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 float ConvolutionBuffer::convoluteWith(const float* const kernel) const
 {
+  const float* const data = myData.get() + myFirstIndex;
   float result = 0.F;
+  uInt32 i = 0;
 
-  for (uInt32 i = 0; i < mySize; ++i) {
-    result += kernel[i] * myData[(myFirstIndex + i) % mySize];
-  }
+#if defined(CONVOLUTION_SSE2)
+  __m128 sum = _mm_setzero_ps();
+
+  for (; i + 4 <= mySize; i += 4)
+    sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(kernel + i), _mm_loadu_ps(data + i)));
+
+  sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+  sum = _mm_add_ss(sum, _mm_shuffle_ps(sum, sum, 1));
+  result = _mm_cvtss_f32(sum);
+#elif defined(CONVOLUTION_NEON)
+  float32x4_t sum = vdupq_n_f32(0.F);
+
+  for (; i + 4 <= mySize; i += 4)
+    sum = vmlaq_f32(sum, vld1q_f32(kernel + i), vld1q_f32(data + i));
+
+  const float32x2_t pair = vadd_f32(vget_low_f32(sum), vget_high_f32(sum));
+  result = vget_lane_f32(vpadd_f32(pair, pair), 0);
+#endif
+
+  for (; i < mySize; ++i)
+    result += kernel[i] * data[i];
 
   return result;
 }
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void ConvolutionBuffer::convoluteWith(const float* const kernel,
+                                      float& left, float& right) const
+{
+  // Samples are interleaved as L R L R ..., so each kernel tap is applied
+  // to two neighbouring values
+  const float* const data = myData.get() + 2 * static_cast<size_t>(myFirstIndex);
+  uInt32 i = 0;
+
+  left = right = 0.F;
+
+#if defined(CONVOLUTION_SSE2)
+  __m128 sum = _mm_setzero_ps();
+
+  for (; i + 4 <= mySize; i += 4) {
+    const __m128 k = _mm_loadu_ps(kernel + i);
+
+    sum = _mm_add_ps(sum, _mm_mul_ps(_mm_unpacklo_ps(k, k), _mm_loadu_ps(data + 2 * i)));
+    sum = _mm_add_ps(sum, _mm_mul_ps(_mm_unpackhi_ps(k, k), _mm_loadu_ps(data + 2 * i + 4)));
+  }
+  for (; i + 2 <= mySize; i += 2) {
+    const __m128 k = _mm_setr_ps(kernel[i], kernel[i], kernel[i + 1], kernel[i + 1]);
+
+    sum = _mm_add_ps(sum, _mm_mul_ps(k, _mm_loadu_ps(data + 2 * i)));
+  }
+
+  // Lanes are L R L R; fold the upper pair onto the lower one
+  sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+  left = _mm_cvtss_f32(sum);
+  right = _mm_cvtss_f32(_mm_shuffle_ps(sum, sum, 1));
+#elif defined(CONVOLUTION_NEON)
+  float32x4_t sum = vdupq_n_f32(0.F);
+
+  for (; i + 4 <= mySize; i += 4) {
+    const float32x4x2_t k = vzipq_f32(vld1q_f32(kernel + i), vld1q_f32(kernel + i));
+
+    sum = vmlaq_f32(sum, k.val[0], vld1q_f32(data + 2 * i));
+    sum = vmlaq_f32(sum, k.val[1], vld1q_f32(data + 2 * i + 4));
+  }
+  for (; i + 2 <= mySize; i += 2) {
+    const float32x4_t k = vcombine_f32(vdup_n_f32(kernel[i]), vdup_n_f32(kernel[i + 1]));
+
+    sum = vmlaq_f32(sum, k, vld1q_f32(data + 2 * i));
+  }
+
+  const float32x2_t pair = vadd_f32(vget_low_f32(sum), vget_high_f32(sum));
+  left = vget_lane_f32(pair, 0);
+  right = vget_lane_f32(pair, 1);
+#endif
+
+  for (; i < mySize; ++i) {
+    left += kernel[i] * data[2 * i];
+    right += kernel[i] * data[2 * i + 1];
+  }
+}
@@ -20,15 +20,23 @@
 
 #include "bspf.hxx"
 
+/**
+  A ring buffer of the most recent samples for one or two (interleaved)
+  channels. Every sample is stored twice, mySize apart, so the current
+  window is always a contiguous run of memory and the convolution can use
+  unaligned vector loads without any wraparound.
+*/
 class ConvolutionBuffer
 {
   public:
-    explicit ConvolutionBuffer(uInt32 size);
+    explicit ConvolutionBuffer(uInt32 size, bool stereo = false);
     ~ConvolutionBuffer() = default;
 
     void shift(float nextValue);
+    void shift(float nextLeft, float nextRight);
 
     float convoluteWith(const float* kernel) const;
+    void convoluteWith(const float* kernel, float& left, float& right) const;
 
   private:
 
@@ -38,6 +46,8 @@ class ConvolutionBuffer
 
     uInt32 mySize{0};
 
+    uInt32 myChannels{1};
+
   private:
     ConvolutionBuffer() = delete;
     ConvolutionBuffer(const ConvolutionBuffer&) = delete;
@@ -79,13 +79,7 @@ LanczosResampler::LanczosResampler(
   myPrecomputedKernels = std::make_unique<float[]>(
       static_cast<size_t>(myPrecomputedKernelCount) * myKernelSize);
 
-  if (myFormatFrom.stereo)
-  {
-    myBufferL = std::make_unique<ConvolutionBuffer>(myKernelSize);
-    myBufferR = std::make_unique<ConvolutionBuffer>(myKernelSize);
-  }
-  else
-    myBuffer = std::make_unique<ConvolutionBuffer>(myKernelSize);
+  myBuffer = std::make_unique<ConvolutionBuffer>(myKernelSize, myFormatFrom.stereo);
 
   precomputeKernels();
 }
@@ -93,34 +87,22 @@ LanczosResampler::LanczosResampler(
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void LanczosResampler::precomputeKernels()
 {
-  // timeIndex = time * formatFrom.sampleRate * formatTo.sampleRAte
-  uInt32 timeIndex = 0;
-
-  for (uInt32 i = 0; i < myPrecomputedKernelCount; ++i) {
+  // Between two input samples, time * formatFrom.sampleRate only takes the
+  // values k / N (k = 0 .. N - 1) without rate adjustment, so we compute one
+  // kernel per phase k. With rate adjustment, the phase is rounded down to the
+  // nearest of these.
+  for (uInt32 k = 0; k < myPrecomputedKernelCount; ++k) {
     float* kernel = myPrecomputedKernels.get() +
-                    static_cast<size_t>(myKernelSize) * i;
+                    static_cast<size_t>(myKernelSize) * k;
     // The kernel is normalized such to be evaluate on time * formatFrom.sampleRate
     const float center =
-      static_cast<float>(timeIndex) / static_cast<float>(myFormatTo.sampleRate);
+      static_cast<float>(k) / static_cast<float>(myPrecomputedKernelCount);
 
     for (uInt32 j = 0; j < 2 * myKernelParameter; ++j) {
       kernel[j] = lanczosKernel(
           center - static_cast<float>(j) + static_cast<float>(myKernelParameter) - 1.F, myKernelParameter
         ) * CLIPPING_FACTOR;
     }
-
-    // Next step: time += 1 / formatTo.sampleRate
-    //
-    // By construction, we limit the argument during kernel evaluation to 0 .. 1, which
-    // corresponds to 0 .. 1 / formatFrom.sampleRate for time. To implement this, we decompose
-    // time as follows:
-    //
-    // time = N / formatFrom.sampleRate + delta
-    // timeIndex = N * formatTo.sampleRate + delta * formatTo.sampleRate * formatFrom.sampleRate
-    //
-    // with N integral and delta < 0. From this, it follows that we replace
-    // time with delta, i.e. take the modulus of timeIndex.
-    timeIndex = (timeIndex + myFormatFrom.sampleRate) % myFormatTo.sampleRate;
   }
 }
 
@@ -143,15 +125,20 @@ void LanczosResampler::fillFragment(float* fragment, uInt32 length)
   }
 
   const size_t outputSamples = myFormatTo.stereo ? (length >> 1) : length;
+  const uInt64 timeIndexPerSample = myFormatTo.sampleRate * TIME_SUBDIVISION;
+  const float volume = myVolume.load(std::memory_order_relaxed);
 
   for (size_t i = 0; i < outputSamples; ++i) {
-    const float* kernel = myPrecomputedKernels.get() +
-        static_cast<size_t>(myCurrentKernelIndex) * myKernelSize;
-    myCurrentKernelIndex = (myCurrentKernelIndex + 1) % myPrecomputedKernelCount;
+    // The phase of the output sample between the two current input samples
+    const auto phase = static_cast<size_t>(
+        myTimeIndex * myPrecomputedKernelCount / timeIndexPerSample);
+    const float* kernel = myPrecomputedKernels.get() + phase * myKernelSize;
 
     if (myFormatFrom.stereo) {
-      const float sampleL = myBufferL->convoluteWith(kernel);
-      const float sampleR = myBufferR->convoluteWith(kernel);
+      float sampleL = 0.F, sampleR = 0.F;
+      myBuffer->convoluteWith(kernel, sampleL, sampleR);
+      sampleL *= volume;
+      sampleR *= volume;
 
       if (myFormatTo.stereo) {
         fragment[2*i] = sampleL;
@@ -160,7 +147,7 @@ void LanczosResampler::fillFragment(float* fragment, uInt32 length)
       else
         fragment[i] = (sampleL + sampleR) / 2.F;
     } else {
-      const float sample = myBuffer->convoluteWith(kernel);
+      const float sample = myBuffer->convoluteWith(kernel) * volume;
 
       if (myFormatTo.stereo)
         fragment[2*i] = fragment[2*i + 1] = sample;
@@ -168,12 +155,12 @@ void LanczosResampler::fillFragment(float* fragment, uInt32 length)
         fragment[i] = sample;
     }
 
-    myTimeIndex += myFormatFrom.sampleRate;
+    myTimeIndex += myTimeStep;
 
-    const uInt32 samplesToShift = myTimeIndex / myFormatTo.sampleRate;
+    const auto samplesToShift = static_cast<uInt32>(myTimeIndex / timeIndexPerSample);
     if (samplesToShift == 0) continue;
 
-    myTimeIndex %= myFormatTo.sampleRate;
+    myTimeIndex %= timeIndexPerSample;
     shiftSamples(samplesToShift);
   }
 }
@@ -183,12 +170,13 @@ FORCE_INLINE void LanczosResampler::shiftSamples(uInt32 samplesToShift)
 {
   while (samplesToShift-- > 0) {
     if (myFormatFrom.stereo) {
-      myBufferL->shift(myHighPassL.apply(
-        myCurrentFragment[2 * static_cast<size_t>(myFragmentIndex)] /
-            static_cast<float>(0x7fff)));
-      myBufferR->shift(myHighPassR.apply(
-        myCurrentFragment[2 * static_cast<size_t>(myFragmentIndex) + 1] /
-            static_cast<float>(0x7fff)));
+      myBuffer->shift(
+        myHighPassL.apply(
+          myCurrentFragment[2 * static_cast<size_t>(myFragmentIndex)] /
+              static_cast<float>(0x7fff)),
+        myHighPassR.apply(
+          myCurrentFragment[2 * static_cast<size_t>(myFragmentIndex) + 1] /
+              static_cast<float>(0x7fff)));
     }
     else
       myBuffer->shift(myHighPass.apply(myCurrentFragment[myFragmentIndex] /
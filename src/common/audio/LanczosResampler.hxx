@@ -45,14 +45,12 @@ class LanczosResampler : public Resampler
 
     uInt32 myPrecomputedKernelCount{0};
     uInt32 myKernelSize{0};
-    uInt32 myCurrentKernelIndex{0};
     unique_ptr<float[]> myPrecomputedKernels;
 
     uInt32 myKernelParameter{0};
 
+    // Interleaved for stereo input
     unique_ptr<ConvolutionBuffer> myBuffer;
-    unique_ptr<ConvolutionBuffer> myBufferL;
-    unique_ptr<ConvolutionBuffer> myBufferR;
 
     Int16* myCurrentFragment{nullptr};
     uInt32 myFragmentIndex{0};
@@ -62,7 +60,7 @@ class LanczosResampler : public Resampler
     HighPass myHighPassR;
     HighPass myHighPass;
 
-    uInt32 myTimeIndex{0};
+    uInt64 myTimeIndex{0};
 };
 
 #endif // LANCZOS_RESAMPLER_HXX
@@ -18,6 +18,9 @@
 #ifndef RESAMPLER_HXX
 #define RESAMPLER_HXX
 
+#include <algorithm>
+#include <atomic>
+#include <cmath>
 #include <functional>
 
 #include "bspf.hxx"
@@ -55,12 +58,52 @@ class Resampler {
       : myFormatFrom{formatFrom},
         myFormatTo{formatTo},
         myNextFragmentCallback{nextFragmentCallback},
-        myUnderrunLogger{"audio buffer underrun", Logger::Level::INFO} { }
+        myUnderrunLogger{"audio buffer underrun", Logger::Level::INFO},
+        myTimeStep{static_cast<uInt64>(formatFrom.sampleRate) * TIME_SUBDIVISION} { }
 
     virtual void fillFragment(float* fragment, uInt32 length) = 0;
 
+    /**
+      Set the volume which is applied to the output samples, as part of the
+      resampling pass (0.F - 1.F).  This may be called while another thread
+      fills fragments.
+    */
+    void setVolume(float volume) { myVolume.store(volume, std::memory_order_relaxed); }
+
     virtual ~Resampler() = default;
 
+    /**
+      Dynamic rate control: Adjust the resampling ratio slightly, so that the
+      fill of the audio queue converges towards the given target.  A queue
+      which is too full is drained by consuming the input slightly faster
+      (and vice versa), instead of dropping or repeating whole fragments.
+
+      @param fill    The current number of fragments in the queue
+      @param target  The number of fragments the queue should contain
+    */
+    void adjustRate(uInt32 fill, uInt32 target)
+    {
+      // The queue fill jumps by several fragments per emulated frame, so
+      // only its average is controlled
+      myAverageFill += (static_cast<double>(fill) - myAverageFill) * FILL_SMOOTHING;
+
+      const double error = (myAverageFill - target) / std::max(target, 1U);
+      const double adjustment = std::clamp(error * MAX_RATE_ADJUSTMENT,
+                                           -MAX_RATE_ADJUSTMENT, MAX_RATE_ADJUSTMENT);
+
+      myTimeStep = static_cast<uInt64>(std::llround(
+        static_cast<double>(myFormatFrom.sampleRate) * TIME_SUBDIVISION * (1. + adjustment)));
+    }
+
+    /**
+      Restart rate control (e.g. after an underrun) with the given fill.
+    */
+    void resetRate(uInt32 fill)
+    {
+      myAverageFill = fill;
+      myTimeStep = static_cast<uInt64>(myFormatFrom.sampleRate) * TIME_SUBDIVISION;
+    }
+
   protected:
 
     Format myFormatFrom;
@@ -70,6 +113,24 @@ class Resampler {
 
     StaggeredLogger myUnderrunLogger;
 
+    // The resamplers keep track of time in units of
+    // 1 / (formatFrom.sampleRate * formatTo.sampleRate * TIME_SUBDIVISION)
+    // seconds.  Each output sample advances the time by myTimeStep, which is
+    // formatTo.sampleRate * TIME_SUBDIVISION per input sample without any
+    // rate adjustment.
+    static constexpr uInt64 TIME_SUBDIVISION = 4096;
+    uInt64 myTimeStep{0};
+
+    std::atomic<float> myVolume{1.F};
+
+  private:
+    // The maximum relative change of the resampling ratio (0.5%), which is
+    // about the limit for not noticing the pitch change
+    static constexpr double MAX_RATE_ADJUSTMENT = 0.005;
+    static constexpr double FILL_SMOOTHING = 0.01;
+
+    double myAverageFill{0.};
+
   private:
 
     Resampler() = delete;
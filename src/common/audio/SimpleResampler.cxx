@@ -45,16 +45,17 @@ void SimpleResampler::fillFragment(float* fragment, uInt32 length)
   }
 
   const size_t outputSamples = myFormatTo.stereo ? (length >> 1) : length;
+  const uInt64 timeIndexPerSample = myFormatTo.sampleRate * TIME_SUBDIVISION;
+  const float scale = myVolume.load(std::memory_order_relaxed) / static_cast<float>(0x7fff);
 
-  // For the following math, remember that myTimeIndex = time * myFormatFrom.sampleRate * myFormatTo.sampleRate
+  // For the following math, remember that
+  // myTimeIndex = time * myFormatFrom.sampleRate * myFormatTo.sampleRate * TIME_SUBDIVISION
   for (size_t i = 0; i < outputSamples; ++i) {
     if (myFormatFrom.stereo) {
       const float sampleL = static_cast<float>(
-          myCurrentFragment[2*static_cast<size_t>(myFragmentIndex)]) /
-          static_cast<float>(0x7fff);
+          myCurrentFragment[2*static_cast<size_t>(myFragmentIndex)]) * scale;
       const float sampleR = static_cast<float>(
-          myCurrentFragment[2*static_cast<size_t>(myFragmentIndex) + 1]) /
-          static_cast<float>(0x7fff);
+          myCurrentFragment[2*static_cast<size_t>(myFragmentIndex) + 1]) * scale;
 
       if (myFormatTo.stereo) {
         fragment[2*i] = sampleL;
@@ -63,8 +64,7 @@ void SimpleResampler::fillFragment(float* fragment, uInt32 length)
       else
         fragment[i] = (sampleL + sampleR) / 2.F;
     } else {
-      const auto sample = static_cast<float>(myCurrentFragment[myFragmentIndex] /
-          static_cast<float>(0x7fff));
+      const auto sample = static_cast<float>(myCurrentFragment[myFragmentIndex]) * scale;
 
       if (myFormatTo.stereo)
         fragment[2*i] = fragment[2*i + 1] = sample;
@@ -72,14 +72,14 @@ void SimpleResampler::fillFragment(float* fragment, uInt32 length)
         fragment[i] = sample;
     }
 
-    // time += 1 / myFormatTo.sampleRate
-    myTimeIndex += myFormatFrom.sampleRate;
+    // time += 1 / myFormatTo.sampleRate (modified by the rate adjustment)
+    myTimeIndex += myTimeStep;
 
     // time >= 1 / myFormatFrom.sampleRate
-    if (myTimeIndex >= myFormatTo.sampleRate) {
+    if (myTimeIndex >= timeIndexPerSample) {
       // myFragmentIndex += time * myFormatFrom.sampleRate
-      myFragmentIndex += myTimeIndex / myFormatTo.sampleRate;
-      myTimeIndex %= myFormatTo.sampleRate;
+      myFragmentIndex += static_cast<uInt32>(myTimeIndex / timeIndexPerSample);
+      myTimeIndex %= timeIndexPerSample;
     }
 
     if (myFragmentIndex >= myFormatFrom.fragmentSize) {
@@ -35,7 +35,7 @@ class SimpleResampler : public Resampler
 
   private:
     Int16* myCurrentFragment{nullptr};
-    uInt32 myTimeIndex{0};
+    uInt64 myTimeIndex{0};
     uInt32 myFragmentIndex{0};
     bool myIsUnderrun{true};
 
@@ -86,7 +86,30 @@ using BoolArray = std::vector<bool>;
 using ByteArray = std::vector<uInt8>;
 using ShortArray = std::vector<uInt16>;
 using StringList = std::vector<std::string>;
-using ByteBuffer = std::unique_ptr<uInt8[]>;
+
+// Memory for a ByteBuffer normally comes from new[], but a file may also be
+// mapped directly into it (see FSNode::read); in that case the deleter
+// carries the function and length needed to unmap it again
+class ByteBufferDeleter
+{
+  public:
+    using Release = void (*)(uInt8*, size_t);
+
+    constexpr ByteBufferDeleter() = default;
+    constexpr ByteBufferDeleter(std::default_delete<uInt8[]>) { }  // NOLINT
+    constexpr ByteBufferDeleter(Release release, size_t size)
+      : myRelease{release}, mySize{size} { }
+
+    void operator()(uInt8* ptr) const {
+      if(myRelease) myRelease(ptr, mySize);
+      else          delete[] ptr;
+    }
+
+  private:
+    Release myRelease{nullptr};
+    size_t mySize{0};
+};
+using ByteBuffer = std::unique_ptr<uInt8[], ByteBufferDeleter>;
 using DWordBuffer = std::unique_ptr<uInt32[]>;
 
 // We use KB a lot; let's make a literal for it
@@ -320,6 +320,7 @@ NLOHMANN_JSON_SERIALIZE_ENUM(Event::Type, {
   {Event::TakeSnapshot, "TakeSnapshot"},
   {Event::ToggleContSnapshots, "ToggleContSnapshots"},
   {Event::ToggleContSnapshotsFrame, "ToggleContSnapshotsFrame"},
+  {Event::ToggleVideoRecording, "ToggleVideoRecording"},
   {Event::ToggleTurbo, "ToggleTurbo"},
   {Event::NextState, "NextState"},
   {Event::PreviousState, "PreviousState"},
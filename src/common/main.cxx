@@ -33,11 +33,16 @@
 #include "PNGLibrary.hxx"
 #include "TIASurface.hxx"
 #include "ProfilingRunner.hxx"
+#include "MicroBenchRunner.hxx"
+#include "RegressionRunner.hxx"
 
 #include "ThreadDebugging.hxx"
+#include "StartupTrace.hxx"
 
 #ifdef DEBUGGER_SUPPORT
   #include "Debugger.hxx"
+  #include "DebugScriptRunner.hxx"
+  #include "LockstepServer.hxx"
 #endif
 
 #ifdef CHEATCODE_SUPPORT
@@ -90,7 +95,7 @@ void parseCommandLine(int ac, const char* const av[],
         cerr << "Missing argument for '" << key << "'\n";
         continue;
       }
-      if(key == "basedir" || key == "break")
+      if(key == "basedir" || key == "break" || key == "starttrace")
         localOpts[key] = av[i];
       else
         globalOpts[key] = av[i];
@@ -145,6 +150,52 @@ bool isProfilingRun(int ac, char* av[])
   return string(av[1]) == "-profile";
 }
 
+/**
+  Checks whether the commandline contains an argument corresponding to
+  running the micro benchmarks.
+*/
+bool isMicroBenchRun(int ac, char* av[])
+{
+  if (ac <= 1) return false;
+
+  return string(av[1]) == "-microbench";
+}
+
+/**
+  Checks whether the commandline contains an argument corresponding to
+  verifying the emulation against golden frame hashes.
+*/
+bool isRegressionRun(int ac, char* av[])
+{
+  if (ac <= 1) return false;
+
+  return string(av[1]) == "-regress";
+}
+
+#ifdef DEBUGGER_SUPPORT
+/**
+  Checks whether the commandline contains an argument corresponding to
+  running a debugger script headless.
+*/
+bool isDebugScriptRun(int ac, char* av[])
+{
+  if (ac <= 1) return false;
+
+  return string(av[1]) == "-debugscript";
+}
+
+/**
+  Checks whether the commandline contains an argument corresponding to
+  running the lockstep server.
+*/
+bool isLockstepRun(int ac, char* av[])
+{
+  if (ac <= 1) return false;
+
+  return string(av[1]) == "-lockstep";
+}
+#endif
+
 /**
   In Windows, attach console to allow command line output (e.g. for -help).
   This is needed since by default Windows doesn't set up stdout/stderr
@@ -208,6 +259,64 @@ int main(int ac, char* av[])
     }
   }
 
+  if (isRegressionRun(ac, av)) {
+    RegressionRunner runner(ac, av);
+
+    try
+    {
+      return runner.run() ? 0 : 1;
+    }
+    catch(const std::runtime_error& e)
+    {
+      cerr << e.what() << '\n';
+      return 1;
+    }
+  }
+
+  if (isMicroBenchRun(ac, av)) {
+    MicroBenchRunner runner(ac, av);
+
+    try
+    {
+      return runner.run() ? 0 : 1;
+    }
+    catch(const std::runtime_error& e)
+    {
+      cerr << e.what() << '\n';
+      return 1;
+    }
+  }
+
+#ifdef DEBUGGER_SUPPORT
+  if (isDebugScriptRun(ac, av)) {
+    DebugScriptRunner runner(ac, av);
+
+    try
+    {
+      return runner.run() ? 0 : 1;
+    }
+    catch(const std::runtime_error& e)
+    {
+      cerr << e.what() << '\n';
+      return 1;
+    }
+  }
+
+  if (isLockstepRun(ac, av)) {
+    LockstepServer server(ac, av);
+
+    try
+    {
+      return server.run() ? 0 : 1;
+    }
+    catch(const std::runtime_error& e)
+    {
+      cerr << e.what() << '\n';
+      return 1;
+    }
+  }
+#endif
+
   unique_ptr<OSystem> theOSystem;
 
   const auto Cleanup = [&theOSystem]() {
@@ -228,15 +337,26 @@ int main(int ac, char* av[])
   Settings::Options globalOpts, localOpts;
   parseCommandLine(ac, av, globalOpts, localOpts);
 
+  // Optionally record the time spent in each stage until the first frame
+  StartupTrace::start(localOpts["starttrace"].toString());
+
   // Check for custom base directory; some ports make use of this
   checkForCustomBaseDir(localOpts);
 
   // Create the parent OSystem object and initialize settings
-  theOSystem = MediaFactory::createOSystem();
+  {
+    const StartupTrace::Scope trace("createOSystem");
+    theOSystem = MediaFactory::createOSystem();
+  }
 
   // Create the full OSystem after the settings, since settings are
   // probably needed for defaults
-  if(!theOSystem->initialize(globalOpts))
+  bool initialized = false;
+  {
+    const StartupTrace::Scope trace("OSystem::initialize");
+    initialized = theOSystem->initialize(globalOpts);
+  }
+  if(!initialized)
   {
     Logger::error("ERROR: Couldn't create OSystem");
     return Cleanup();
@@ -10,31 +10,56 @@ MODULE_OBJS := \
 	src/common/FBBackendSDL.o \
 	src/common/FBSurfaceSDL.o \
 	src/common/FpsMeter.o \
+	src/common/FramePacer.o \
+	src/common/FrameTimes.o \
+	src/common/PerfCounters.o \
 	src/common/FSNodeZIP.o \
 	src/common/HighScoresManager.o \
+	src/common/ScoreTracker.o \
+	src/common/RomIndex.o \
+	src/common/SearchIndex.o \
+	src/common/DirectoryIndex.o \
+	src/common/InputMovie.o \
 	src/common/JoyMap.o \
 	src/common/JPGLibrary.o \
 	src/common/KeyMap.o \
 	src/common/Logger.o \
 	src/common/main.o \
+	src/common/MetricsServer.o \
+	src/common/MicroBenchRunner.o \
 	src/common/MouseControl.o \
+	src/common/Netplay.o \
+	src/common/ObservationProcessor.o \
 	src/common/PaletteHandler.o \
 	src/common/PhosphorHandler.o \
 	src/common/PhysicalJoystick.o \
 	src/common/PJoystickHandler.o \
 	src/common/PKeyboardHandler.o \
 	src/common/PNGLibrary.o \
+	src/common/QualityGovernor.o \
+	src/common/VideoRecorder.o \
 	src/common/RewindManager.o \
+	src/common/SharedMemoryExport.o \
+	src/common/SnapshotIndex.o \
 	src/common/SoundSDL.o \
 	src/common/StaggeredLogger.o \
+	src/common/StartupTrace.o \
 	src/common/StateManager.o \
+	src/common/StateWriter.o \
 	src/common/ThreadDebugging.o \
+	src/common/ThreadPool.o \
+	src/common/ThreadScheduling.o \
+	src/common/ThumbnailCache.o \
 	src/common/TimerManager.o \
+	src/common/UdpSocket.o \
 	src/common/VideoModeHandler.o \
+	src/common/WavCache.o \
 	src/common/ZipHandler.o \
 	src/common/sdl_blitter/BilinearBlitter.o \
 	src/common/sdl_blitter/QisBlitter.o \
+	src/common/sdl_blitter/SoftwareQisBlitter.o \
 	src/common/sdl_blitter/BlitterFactory.o \
+	src/common/sdl_blitter/TexturePool.o \
 	src/common/repository/KeyValueRepositoryPropertyFile.o \
 	src/common/repository/KeyValueRepositoryJsonFile.o \
 	src/common/repository/KeyValueRepositoryConfigfile.o \
@@ -31,9 +31,8 @@ namespace {
           Variant serialized;
           myKvr.get(myKey, serialized);
 
-          std::istringstream in{serialized.toString()};
-
-          return KeyValueRepositoryJsonFile::load(in);
+          return KeyValueRepositoryJsonFile::load(
+            string_view{serialized.toString()});
         }
 
         bool save(const KVRMap& values) override {
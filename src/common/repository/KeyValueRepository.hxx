@@ -59,7 +59,48 @@ class KeyValueRepositoryAtomic : public KeyValueRepository {
 
     virtual void remove(string_view key) = 0;
 
+    /**
+      Begin and end a batch of writes.  Repositories backed by a database
+      group all writes of a batch (including those to other repositories
+      in the same database) into one transaction.  Batches may be nested,
+      only the outermost one is committed.
+
+      Use KeyValueRepositoryBatch instead of calling these directly.
+    */
+    virtual void beginBatch() { }
+    virtual void endBatch() { }
+
     KeyValueRepositoryAtomic* atomic() override { return this; }
 };
 
+/**
+  Groups all writes to a repository during its lifetime into a batch.
+  Passing nullptr (for a non-atomic repository) is allowed, and makes the
+  batch a no-op.
+*/
+class KeyValueRepositoryBatch {
+  public:
+    explicit KeyValueRepositoryBatch(KeyValueRepositoryAtomic* repo)
+      : myRepo{repo}
+    {
+      if (myRepo) myRepo->beginBatch();
+    }
+
+    ~KeyValueRepositoryBatch()
+    {
+      if (myRepo) myRepo->endBatch();
+    }
+
+  private:
+    KeyValueRepositoryAtomic* myRepo{nullptr};
+
+  private:
+    // Following constructors and assignment operators not supported
+    KeyValueRepositoryBatch() = delete;
+    KeyValueRepositoryBatch(const KeyValueRepositoryBatch&) = delete;
+    KeyValueRepositoryBatch(KeyValueRepositoryBatch&&) = delete;
+    KeyValueRepositoryBatch& operator=(const KeyValueRepositoryBatch&) = delete;
+    KeyValueRepositoryBatch& operator=(KeyValueRepositoryBatch&&) = delete;
+};
+
 #endif // KEY_VALUE_REPOSITORY_HXX
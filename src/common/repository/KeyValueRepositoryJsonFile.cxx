@@ -27,6 +27,162 @@ namespace {
 
     return parsed.is_discarded() ? json(s) : parsed;
   }
+
+  /**
+    SAX handler which turns the members of the top-level object directly
+    into map entries.  Strings are stored as is, all other values as their
+    (compact) JSON text, which is built while parsing; so only one value is
+    held in memory at a time, instead of the whole document.
+  */
+  class SaxReader {
+    public:
+      explicit SaxReader(KVRMap& map) : myMap{map} { }
+
+      bool null() { return scalar("null"); }
+      bool boolean(bool b) { return scalar(b ? "true" : "false"); }
+      bool number_integer(json::number_integer_t i) {
+        return scalar(std::to_string(i));
+      }
+      bool number_unsigned(json::number_unsigned_t u) {
+        return scalar(std::to_string(u));
+      }
+      bool number_float(json::number_float_t f, const json::string_t&) {
+        return scalar(json(f).dump());
+      }
+      bool string(json::string_t& s) {
+        if (myDepth == 1) {
+          myMap[myKey] = std::move(s);
+          return true;
+        }
+        return scalar(json(s).dump());
+      }
+      bool binary(json::binary_t&) { return false; }
+
+      bool start_object(size_t) {
+        if (myDepth == 0) {
+          myDepth = 1;
+          return true;
+        }
+        return open('{');
+      }
+      bool key(json::string_t& k) {
+        if (myDepth == 1) {
+          myKey = std::move(k);
+          return true;
+        }
+        separator();
+        myText += json(k).dump();
+        myText += ':';
+        myAfterKey = true;
+
+        return true;
+      }
+      bool end_object() {
+        if (myDepth == 1) {
+          myDepth = 0;
+          return true;
+        }
+        return close('}');
+      }
+
+      bool start_array(size_t) { return open('['); }
+      bool end_array() { return close(']'); }
+
+      bool parse_error(size_t, const std::string&, const json::exception& err) {
+        myError = err.what();
+        return false;
+      }
+
+      bool notAnObject() const { return myNotAnObject; }
+      const std::string& error() const { return myError; }
+
+    private:
+      bool scalar(string_view text) {
+        if (myDepth == 0) {
+          myNotAnObject = true;
+          return false;
+        }
+        if (myDepth == 1)
+          myMap[myKey] = std::string{text};
+        else {
+          separator();
+          myText += text;
+        }
+        return true;
+      }
+
+      bool open(char c) {
+        if (myDepth == 0) {
+          myNotAnObject = true;
+          return false;
+        }
+        if (myDepth == 1)
+          myText.clear();
+        else
+          separator();
+        myText += c;
+        myFirst.push_back(true);
+        ++myDepth;
+
+        return true;
+      }
+
+      bool close(char c) {
+        myText += c;
+        myFirst.pop_back();
+        if (--myDepth == 1)
+          myMap[myKey] = myText;
+
+        return true;
+      }
+
+      void separator() {
+        if (myAfterKey)
+          myAfterKey = false;
+        else if (myFirst.back())
+          myFirst.back() = false;
+        else
+          myText += ',';
+      }
+
+    private:
+      KVRMap& myMap;  // NOLINT
+
+      uInt32 myDepth{0};
+      std::string myKey;
+      // JSON text of the current (nested) value
+      std::string myText;
+      // For each open container, whether no element was written yet
+      std::vector<bool> myFirst;
+      bool myAfterKey{false};
+
+      bool myNotAnObject{false};
+      std::string myError;
+  };
+
+  template<typename InputType>
+  KVRMap parse(InputType&& in)
+  {
+    KVRMap map;
+
+    try {
+      SaxReader reader{map};
+
+      if (json::sax_parse(std::forward<InputType>(in), &reader))
+        return map;
+
+      if (reader.notAnObject())
+        Logger::error("KeyValueRepositoryJsonFile: not an object");
+      else
+        Logger::error("KeyValueRepositoryJsonFile: error during deserialization: " +
+                      reader.error());
+    }
+    catch (const json::exception& err) {
+      Logger::error("KeyValueRepositoryJsonFile: error during deserialization: " +
+                    string(err.what()));
+    }
+    return {};
+  }
 } // namespace
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -38,40 +194,35 @@ KeyValueRepositoryJsonFile::KeyValueRepositoryJsonFile(const FSNode& node)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 KVRMap KeyValueRepositoryJsonFile::load(std::istream& in)
 {
-  try {
-    KVRMap map;
-
-    json deserialized = json::parse(in);
-
-    if (!deserialized.is_object()) {
-      Logger::error("KeyVallueRepositoryJsonFile: not an object");
-
-      return map;
-    }
-
-    for (const auto& [key, value] : deserialized.items())
-      map[key] = value.is_string() ? value.get<string>() : value.dump();
-
-    return map;
-  }
-  catch (const json::exception& err) {
-    Logger::error("KeyValueRepositoryJsonFile: error during deserialization: " +
-                  string(err.what()));
+  return parse(in);
+}
 
-    return {};
-  }
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+KVRMap KeyValueRepositoryJsonFile::load(string_view in)
+{
+  return parse(in);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool KeyValueRepositoryJsonFile::save(std::ostream& out, const KVRMap& values)
 {
+  // Write the members one by one, formatted like json::dump(2) would for
+  // the whole object, but without building the document in memory
   try {
-    json serializedJson = json::object();
-
-    for (const auto& [key, value] : values)
-      serializedJson[key] = jsonIfValid(value.toString());
-
-    out << serializedJson.dump(2);
+    bool first = true;
+
+    out << '{';
+    for (const auto& [key, value] : values) {
+      out << (first ? "\n  " : ",\n  ") << json(key).dump() << ": ";
+      first = false;
+
+      // Indent the value one more level
+      for (const char c: jsonIfValid(value.toString()).dump(2)) {
+        out << c;
+        if (c == '\n') out << "  ";
+      }
+    }
+    out << (first ? "}" : "\n}");
 
     return true;
   }
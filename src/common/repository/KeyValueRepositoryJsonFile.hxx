@@ -33,6 +33,8 @@ class KeyValueRepositoryJsonFile : public KeyValueRepositoryFile<KeyValueReposit
 
     static KVRMap load(std::istream& in);
 
+    static KVRMap load(string_view in);
+
     static bool save(std::ostream& out, const KVRMap& values);
 };
 
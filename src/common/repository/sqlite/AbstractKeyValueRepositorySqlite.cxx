@@ -135,3 +135,25 @@ void AbstractKeyValueRepositorySqlite::remove(string_view key)
     Logger::error(err.what());
   }
 }
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void AbstractKeyValueRepositorySqlite::beginBatch()
+{
+  try {
+    database().beginBatch();
+  }
+  catch (const SqliteError& err) {
+    Logger::error(err.what());
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void AbstractKeyValueRepositorySqlite::endBatch()
+{
+  try {
+    database().endBatch();
+  }
+  catch (const SqliteError& err) {
+    Logger::error(err.what());
+  }
+}
@@ -39,6 +39,10 @@ class AbstractKeyValueRepositorySqlite : public KeyValueRepositoryAtomic
 
     void remove(string_view key) override;
 
+    void beginBatch() override;
+
+    void endBatch() override;
+
   protected:
 
     virtual SqliteStatement& stmtInsert(string_view key, string_view value) = 0;
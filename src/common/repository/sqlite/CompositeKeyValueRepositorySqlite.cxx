@@ -93,12 +93,12 @@ void CompositeKeyValueRepositorySqlite::initialize()
     myColKey2.c_str()
   );
 
-  myStmtInsert = std::make_unique<SqliteStatement>(myDb,
+  myStmtInsert = &myDb.statement(
     "INSERT OR REPLACE INTO `%s` VALUES (?, ?, ?)",
     myTableName.c_str()
   );
 
-  myStmtSelect = std::make_unique<SqliteStatement>(myDb,
+  myStmtSelect = &myDb.statement(
     "SELECT `%s`, `%s` FROM `%s` WHERE `%s` = ?",
     myColKey2.c_str(),
     myColValue.c_str(),
@@ -106,26 +106,26 @@ void CompositeKeyValueRepositorySqlite::initialize()
     myColKey1.c_str()
   );
 
-  myStmtCountSet = std::make_unique<SqliteStatement>(myDb,
+  myStmtCountSet = &myDb.statement(
     "SELECT COUNT(*) FROM `%s` WHERE `%s` = ?",
     myTableName.c_str(),
     myColKey1.c_str()
   );
 
-  myStmtDelete = std::make_unique<SqliteStatement>(myDb,
+  myStmtDelete = &myDb.statement(
     "DELETE FROM `%s` WHERE `%s` = ? AND `%s` = ?",
     myTableName.c_str(),
     myColKey1.c_str(),
     myColKey2.c_str()
   );
 
-  myStmtDeleteSet = std::make_unique<SqliteStatement>(myDb,
+  myStmtDeleteSet = &myDb.statement(
     "DELETE FROM `%s` WHERE `%s` = ?",
     myTableName.c_str(),
     myColKey1.c_str()
   );
 
-  myStmtSelectOne = std::make_unique<SqliteStatement>(myDb,
+  myStmtSelectOne = &myDb.statement(
     "SELECT `%s` FROM `%s` WHERE `%s` = ? AND `%s` = ?",
     myColValue.c_str(),
     myTableName.c_str(),
@@ -133,7 +133,7 @@ void CompositeKeyValueRepositorySqlite::initialize()
     myColKey2.c_str()
   );
 
-  myStmtCount = std::make_unique<SqliteStatement>(myDb,
+  myStmtCount = &myDb.statement(
     "SELECT COUNT(*) FROM `%s` WHERE `%s` = ? AND `%s` = ?",
     myTableName.c_str(),
     myColKey1.c_str(),
@@ -86,13 +86,13 @@ class CompositeKeyValueRepositorySqlite : public CompositeKeyValueRepositoryAtom
     string myColKey2;
     string myColValue;
 
-    unique_ptr<SqliteStatement> myStmtInsert;
-    unique_ptr<SqliteStatement> myStmtSelect;
-    unique_ptr<SqliteStatement> myStmtCountSet;
-    unique_ptr<SqliteStatement> myStmtDelete;
-    unique_ptr<SqliteStatement> myStmtDeleteSet;
-    unique_ptr<SqliteStatement> myStmtSelectOne;
-    unique_ptr<SqliteStatement> myStmtCount;
+    SqliteStatement* myStmtInsert{nullptr};
+    SqliteStatement* myStmtSelect{nullptr};
+    SqliteStatement* myStmtCountSet{nullptr};
+    SqliteStatement* myStmtDelete{nullptr};
+    SqliteStatement* myStmtDeleteSet{nullptr};
+    SqliteStatement* myStmtSelectOne{nullptr};
+    SqliteStatement* myStmtCount{nullptr};
 
    private:
 
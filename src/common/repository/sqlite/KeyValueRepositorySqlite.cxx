@@ -86,33 +86,32 @@ void KeyValueRepositorySqlite::initialize()
     myColValue.c_str()
   );
 
-  myStmtInsert = std::make_unique<SqliteStatement>(myDb,
+  myStmtInsert = &myDb.statement(
     "INSERT OR REPLACE INTO `%s` VALUES (?, ?)",
     myTableName.c_str()
   );
 
-  myStmtSelect = std::make_unique<SqliteStatement>(myDb,
+  myStmtSelect = &myDb.statement(
     "SELECT `%s`, `%s` FROM `%s`",
     myColKey.c_str(),
     myColValue.c_str(),
     myTableName.c_str()
   );
 
-  myStmtDelete = std::make_unique<SqliteStatement>(myDb,
+  myStmtDelete = &myDb.statement(
     "DELETE FROM `%s` WHERE `%s` = ?",
     myTableName.c_str(),
     myColKey.c_str()
   );
 
-  myStmtSelectOne = std::make_unique<SqliteStatement>(myDb,
+  myStmtSelectOne = &myDb.statement(
     "SELECT `%s` FROM `%s` WHERE `%s` = ?",
     myColValue.c_str(),
     myTableName.c_str(),
     myColKey.c_str()
   );
 
-  myStmtCount = std::make_unique<SqliteStatement>(
-    myDb,
+  myStmtCount = &myDb.statement(
     "SELECT COUNT(`%s`) FROM `%s` WHERE `%s` = ?",
     myColKey.c_str(),
     myTableName.c_str(),
@@ -49,11 +49,11 @@ class KeyValueRepositorySqlite : public AbstractKeyValueRepositorySqlite
     string myColKey;
     string myColValue;
 
-    unique_ptr<SqliteStatement> myStmtInsert;
-    unique_ptr<SqliteStatement> myStmtSelect;
-    unique_ptr<SqliteStatement> myStmtDelete;
-    unique_ptr<SqliteStatement> myStmtSelectOne;
-    unique_ptr<SqliteStatement> myStmtCount;
+    SqliteStatement* myStmtInsert{nullptr};
+    SqliteStatement* myStmtSelect{nullptr};
+    SqliteStatement* myStmtDelete{nullptr};
+    SqliteStatement* myStmtSelectOne{nullptr};
+    SqliteStatement* myStmtCount{nullptr};
 
   private:
 
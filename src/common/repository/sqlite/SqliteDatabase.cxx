@@ -31,6 +31,9 @@ SqliteDatabase::SqliteDatabase(const string& databaseDirectory,
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 SqliteDatabase::~SqliteDatabase()
 {
+  // Statements must be finalized before closing the handle
+  myStatements.clear();
+
   if (myHandle) sqlite3_close_v2(myHandle);
 }
 
@@ -71,6 +74,10 @@ void SqliteDatabase::initialize()
   exec("PRAGMA journal_mode=WAL");
   exec("PRAGMA synchronous=1");
 
+  // Other connections (e.g. a background import) may hold the write lock
+  // for a moment
+  sqlite3_busy_timeout(myHandle, 5000);
+
   switch (sqlite3_wal_checkpoint_v2(myHandle, nullptr, SQLITE_CHECKPOINT_TRUNCATE, nullptr, nullptr)) {
     case SQLITE_OK:
     case SQLITE_BUSY:
@@ -94,9 +101,29 @@ void SqliteDatabase::exec(string_view sql)
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-Int32 SqliteDatabase::getUserVersion() const
+SqliteStatement& SqliteDatabase::statement(string_view sql)
 {
-  SqliteStatement stmt(*this, "PRAGMA user_version");
+  auto it = myStatements.find(string{sql});
+
+  if (it == myStatements.end())
+    it = myStatements.emplace(
+      string{sql}, std::make_unique<SqliteStatement>(myHandle, sql)
+    ).first;
+
+  return it->second->reset();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void SqliteDatabase::resetStatements()
+{
+  for (const auto& [sql, stmt]: myStatements)
+    stmt->reset();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+Int32 SqliteDatabase::getUserVersion()
+{
+  SqliteStatement& stmt{statement("PRAGMA user_version")};
 
   if (!stmt.step())
     throw SqliteError("failed to get user_version");
@@ -110,3 +137,32 @@ void SqliteDatabase::setUserVersion(Int32 version) const
   SqliteStatement(*this, "PRAGMA user_version = %i", static_cast<int>(version))
     .step();
 }
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void SqliteDatabase::beginBatch()
+{
+  // Don't take over a transaction that is already open
+  if (myBatchDepth == 0 && !sqlite3_get_autocommit(myHandle)) return;
+
+  if (myBatchDepth == 0) exec("BEGIN TRANSACTION");
+  ++myBatchDepth;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void SqliteDatabase::endBatch()
+{
+  if (myBatchDepth == 0) return;
+
+  if (--myBatchDepth > 0) return;
+
+  try {
+    exec("COMMIT TRANSACTION");
+  }
+  catch (const SqliteError&) {
+    // Don't leave the transaction open if the commit failed
+    if (!sqlite3_get_autocommit(myHandle))
+      sqlite3_exec(myHandle, "ROLLBACK TRANSACTION", nullptr, nullptr, nullptr);
+
+    throw;
+  }
+}
@@ -19,9 +19,12 @@
 #define SQLITE_DATABASE_HXX
 
 #include <sqlite3.h>
+#include <unordered_map>
 
 #include "bspf.hxx"
 
+class SqliteStatement;
+
 class SqliteDatabase
 {
   public:
@@ -41,15 +44,38 @@ class SqliteDatabase
     template<class T, class ...Ts>
     void exec(string_view sql, T arg1, Ts... args);
 
-    Int32 getUserVersion() const;
+    // Get the prepared statement for the given SQL, preparing it on first
+    // use.  The statement is reset, and stays valid as long as the database.
+    SqliteStatement& statement(string_view sql);
+
+    template<class T, class ...Ts>
+    SqliteStatement& statement(string_view sql, T arg1, Ts... args);
+
+    // Reset all prepared statements.  A statement that is left on a row
+    // keeps its read transaction open, and with it an outdated view of the
+    // changes made by other connections.
+    void resetStatements();
+
+    Int32 getUserVersion();
     void setUserVersion(Int32 version) const;
 
+    // Begin and end a (possibly nested) batch of writes, which is done in
+    // a single transaction
+    void beginBatch();
+    void endBatch();
+
   private:
 
     string myDatabaseFile;
 
     sqlite3* myHandle{nullptr};
 
+    // Nesting depth of the current batch; the transaction is open while > 0
+    uInt32 myBatchDepth{0};
+
+    // Prepared statements, keyed by their SQL
+    std::unordered_map<string, unique_ptr<SqliteStatement>> myStatements;
+
   private:
 
     SqliteDatabase(const SqliteDatabase&) = delete;
@@ -78,6 +104,17 @@ void SqliteDatabase::exec(string_view sql, T arg1, Ts... args)
   exec(buffer);
 }
 
+template <class T, class ...Ts>
+SqliteStatement& SqliteDatabase::statement(string_view sql, T arg1, Ts... args)
+{
+  char buffer[512];
+
+  if (snprintf(buffer, 512, string{sql}.c_str(), arg1, args...) >= 512)
+    throw std::runtime_error("SQL statement too long");
+
+  return statement(buffer);
+}
+
 #ifdef __clang__
 #pragma clang diagnostic pop
 #endif
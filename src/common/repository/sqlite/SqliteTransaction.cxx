@@ -22,7 +22,8 @@
 SqliteTransaction::SqliteTransaction(SqliteDatabase& db)
   : myDb{db}
 {
-  if (sqlite3_get_autocommit(db)) {
+  // Nested in an already open transaction (e.g. a batch); leave it to that
+  if (!sqlite3_get_autocommit(db)) {
     myTransactionClosed = true;
     return;
   }
@@ -15,16 +15,20 @@
 // this file, and for a DISCLAIMER OF ALL WARRANTIES.
 //============================================================================
 
+#include <iomanip>
+
 #include "Logger.hxx"
 #include "SqliteError.hxx"
 #include "repository/KeyValueRepositoryNoop.hxx"
 #include "repository/CompositeKeyValueRepositoryNoop.hxx"
 #include "repository/CompositeKVRJsonAdapter.hxx"
 #include "repository/KeyValueRepositoryConfigfile.hxx"
+#include "repository/KeyValueRepositoryJsonFile.hxx"
 #include "repository/KeyValueRepositoryPropertyFile.hxx"
 #include "KeyValueRepositorySqlite.hxx"
 #include "CompositeKeyValueRepositorySqlite.hxx"
 #include "SqliteStatement.hxx"
+#include "SqliteTransaction.hxx"
 #include "FSNode.hxx"
 
 #ifdef BSPF_MACOS
@@ -34,7 +38,41 @@
 #include "StellaDb.hxx"
 
 namespace {
-  constexpr Int32 CURRENT_VERSION = 1;
+  constexpr Int32 CURRENT_VERSION = 2;
+
+  /**
+    Passes all accesses on to the given repository, but only after calling
+    'wait'.  This keeps the game properties from being read or written
+    while the old ones are imported in the background.
+  */
+  class WaitingRepository : public KeyValueRepositoryAtomic
+  {
+    public:
+      using KeyValueRepositoryAtomic::save;
+
+      WaitingRepository(unique_ptr<KeyValueRepositoryAtomic> repo,
+                        const std::function<void()>& wait)
+        : myRepo{std::move(repo)}, myWait{wait} { }
+
+      KVRMap load() override { myWait(); return myRepo->load(); }
+      bool save(const KVRMap& values) override {
+        myWait(); return myRepo->save(values);
+      }
+      bool has(string_view key) override { myWait(); return myRepo->has(key); }
+      bool get(string_view key, Variant& value) override {
+        myWait(); return myRepo->get(key, value);
+      }
+      bool save(string_view key, const Variant& value) override {
+        myWait(); return myRepo->save(key, value);
+      }
+      void remove(string_view key) override { myWait(); myRepo->remove(key); }
+      void beginBatch() override { myWait(); myRepo->beginBatch(); }
+      void endBatch() override { myRepo->endBatch(); }
+
+    private:
+      unique_ptr<KeyValueRepositoryAtomic> myRepo;
+      std::function<void()> myWait;
+  };
 } // namespace
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -45,8 +83,16 @@ StellaDb::StellaDb(const string& databaseDirectory, const string& databaseName)
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void StellaDb::initialize()
+StellaDb::~StellaDb()
+{
+  stopImport();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void StellaDb::initialize(const ImportProgress& progress)
 {
+  stopImport();
+
   try {
     myDb = std::make_unique<SqliteDatabase>(myDatabaseDirectory, myDatabaseName);
     myDb->initialize();
@@ -57,16 +103,29 @@ void StellaDb::initialize()
 
     auto propertyRepositoryHost = std::make_unique<KeyValueRepositorySqlite>(*myDb, "properties", "md5", "properties");
     propertyRepositoryHost->initialize();
-    myPropertyRepositoryHost = std::move(propertyRepositoryHost);
+    myPropertyRepositoryHost = std::make_unique<WaitingRepository>(
+        std::move(propertyRepositoryHost), [this] { waitForImport(); });
 
     auto highscoreRepository = std::make_unique<CompositeKeyValueRepositorySqlite>(*myDb, "highscores", "md5", "variation", "highscore_data");
     highscoreRepository->initialize();
     myHighscoreRepository = std::move(highscoreRepository);
 
+    auto romIndexRepository = std::make_unique<KeyValueRepositorySqlite>(*myDb, "romindex", "path", "info");
+    romIndexRepository->initialize();
+    myRomIndexRepository = std::move(romIndexRepository);
+
+    auto detectionRepository = std::make_unique<CompositeKeyValueRepositorySqlite>(*myDb, "detection", "md5", "detector", "result");
+    detectionRepository->initialize();
+    myDetectionRepository = std::move(detectionRepository);
+
+    auto cheatRepository = std::make_unique<KeyValueRepositorySqlite>(*myDb, "cheats", "md5", "cheats");
+    cheatRepository->initialize();
+    myCheatRepository = std::move(cheatRepository);
+
     myPropertyRepository = std::make_unique<CompositeKVRJsonAdapter>(*myPropertyRepositoryHost);
 
     if (myDb->getUserVersion() == 0) {
-      initializeDb();
+      initializeDb(progress);
     } else {
       migrate();
     }
@@ -77,6 +136,9 @@ void StellaDb::initialize()
     mySettingsRepository = std::make_unique<KeyValueRepositoryNoop>();
     myPropertyRepository = std::make_unique<CompositeKeyValueRepositoryNoop>();
     myHighscoreRepository = std::make_unique<CompositeKeyValueRepositoryNoop>();
+    myRomIndexRepository = std::make_unique<KeyValueRepositoryNoop>();
+    myDetectionRepository = std::make_unique<CompositeKeyValueRepositoryNoop>();
+    myCheatRepository = std::make_unique<KeyValueRepositoryNoop>();
 
     myDb.reset();
     myPropertyRepositoryHost.reset();
@@ -96,17 +158,31 @@ bool StellaDb::isValid() const
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void StellaDb::initializeDb()
+void StellaDb::initializeDb(const ImportProgress& progress)
 {
-  importOldSettings();
+  // An interrupted property import leaves the version at 0; the settings
+  // may have changed since, so they are only imported once
+  SqliteStatement& count{myDb->statement("SELECT COUNT(*) FROM `settings`")};
+  if (count.step() && count.columnInt(0) == 0)
+    importOldSettings();
+
+  SqliteStatement& cheatCount{myDb->statement("SELECT COUNT(*) FROM `cheats`")};
+  if (cheatCount.step() && cheatCount.columnInt(0) == 0)
+    importOldCheats();
 
   FSNode legacyPropertyFile{myDatabaseDirectory};
   legacyPropertyFile /= "stella.pro";
 
-  if (legacyPropertyFile.exists() && legacyPropertyFile.isFile())
-    importOldPropset(legacyPropertyFile);
+  if (!legacyPropertyFile.exists() || !legacyPropertyFile.isFile()) {
+    myDb->setUserVersion(CURRENT_VERSION);
 
-  myDb->setUserVersion(CURRENT_VERSION);
+    return;
+  }
+
+  // The import sets the version when it has finished
+  myImportThread = std::thread([this, legacyPropertyFile, progress] {
+    importOldPropset(legacyPropertyFile, progress);
+  });
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -166,7 +242,7 @@ void StellaDb::importOldStellaDb(const FSNode& node)
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void StellaDb::importOldPropset(const FSNode& node)
+void StellaDb::importOldPropset(const FSNode& node, const ImportProgress& progress)
 {
   Logger::info("importing old game properties from " + node.getPath());
 
@@ -186,24 +262,122 @@ void StellaDb::importOldPropset(const FSNode& node)
     return;
   }
 
-  while (true) {
+  // Convert all properties first, so they can be inserted in one transaction
+  const auto size = std::max<size_t>(in.view().size(), 1);
+  uInt32 percent = 0;
+  KVRMap properties;
+
+  while (!myStopImport) {
     auto props = KeyValueRepositoryPropertyFile::load(in);
 
     if (props.empty())
       break;
+
+    if (progress && in.good()) {
+      // Report in steps of 10%
+      const auto current = static_cast<uInt32>(static_cast<size_t>(in.tellg()) * 10 / size) * 10;
+      if (current != percent) progress(percent = current);
+    }
+
     if (!props.contains("Cart.MD5") || props["Cart.MD5"].toString().empty())
       continue;
 
-    myPropertyRepository->get(props["Cart.MD5"].toString())->save(props);
+    std::ostringstream out;
+    if (KeyValueRepositoryJsonFile::save(out, props))
+      properties[props["Cart.MD5"].toString()] = out.str();
+  }
+
+  if (myStopImport) return;
+
+  try {
+    // The main connection must not be used from this thread
+    SqliteDatabase db(myDatabaseDirectory, myDatabaseName);
+    db.initialize();
+
+    // Properties already in the database (e.g. saved during an earlier,
+    // interrupted import) take precedence over the old ones
+    SqliteTransaction tx{db};
+    for (const auto& [md5, props]: properties)
+      db.statement("INSERT OR IGNORE INTO `properties` VALUES (?, ?)")
+        .bind(1, md5)
+        .bind(2, props.toString())
+        .step();
+
+    db.setUserVersion(CURRENT_VERSION);
+    tx.commit();
+  }
+  catch (const SqliteError& err) {
+    Logger::error(err.what());
   }
+
+  if (progress) progress(100);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void StellaDb::importOldCheats()
+{
+  FSNode legacyCheatFile{myDatabaseDirectory};
+  legacyCheatFile /= "stella.cht";
+
+  if (!legacyCheatFile.exists() || !legacyCheatFile.isFile()) return;
+
+  Logger::info("importing old cheats from " + legacyCheatFile.getPath());
+
+  std::stringstream in;
+
+  try {
+    legacyCheatFile.read(in);
+  }
+  catch (...) {
+    Logger::error("import failed");
+
+    return;
+  }
+
+  KVRMap cheats;
+  string md5, cheat;
+
+  while (in >> std::quoted(md5) >> std::quoted(cheat))
+    cheats[md5] = cheat;
+
+  myCheatRepository->save(cheats);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void StellaDb::stopImport()
+{
+  if (myImportThread.joinable()) {
+    myStopImport = true;
+    myImportThread.join();
+  }
+  myStopImport = false;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void StellaDb::waitForImport()
+{
+  // The repositories are only accessed from the main thread, which is also
+  // the only one joining the import
+  if (!myImportThread.joinable()) return;
+
+  myImportThread.join();
+
+  // Don't keep reading from before the import
+  if (myDb) myDb->resetStatements();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void StellaDb::migrate()
 {
   const Int32 version = myDb->getUserVersion();
-  switch (version) {  // NOLINT (could be written as IF/ELSE)
+  switch (version) {
     case 1:
+      // The cheats used to be kept in their own file
+      importOldCheats();
+      myDb->setUserVersion(CURRENT_VERSION);
+      return;
+
+    case CURRENT_VERSION:
       return;
 
     default: {
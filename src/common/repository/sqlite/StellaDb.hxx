@@ -18,6 +18,10 @@
 #ifndef STELLA_DB_HXX
 #define STELLA_DB_HXX
 
+#include <atomic>
+#include <functional>
+#include <thread>
+
 #include "bspf.hxx"
 #include "SqliteDatabase.hxx"
 #include "repository/KeyValueRepository.hxx"
@@ -27,9 +31,16 @@
 class StellaDb
 {
   public:
+    // Called from the import thread with the progress (0 - 100) of importing
+    // the old game properties
+    using ImportProgress = std::function<void(uInt32 percent)>;
+
     StellaDb(const string& databaseDirectory, const string& databaseName);
+    ~StellaDb();
 
-    void initialize();
+    // On first run, the old settings are imported before this returns, but
+    // the (much larger) old game properties are imported in the background
+    void initialize(const ImportProgress& progress = nullptr);
 
     KeyValueRepositoryAtomic& settingsRepository() const {
       return *mySettingsRepository;
@@ -40,17 +51,29 @@ class StellaDb
     CompositeKeyValueRepositoryAtomic& highscoreRepository() const {
       return *myHighscoreRepository;
     }
+    KeyValueRepositoryAtomic& romIndexRepository() const {
+      return *myRomIndexRepository;
+    }
+    CompositeKeyValueRepositoryAtomic& detectionRepository() const {
+      return *myDetectionRepository;
+    }
+    KeyValueRepositoryAtomic& cheatRepository() const {
+      return *myCheatRepository;
+    }
 
     string databaseFileName() const;
 
     bool isValid() const;
 
   private:
-    void initializeDb();
+    void initializeDb(const ImportProgress& progress);
     void importOldSettings();
     void importStellarc(const FSNode& node);
     void importOldStellaDb(const FSNode& node);
-    void importOldPropset(const FSNode& node);
+    void importOldPropset(const FSNode& node, const ImportProgress& progress);
+    void importOldCheats();
+    void stopImport();
+    void waitForImport();
 
     void migrate();
 
@@ -63,6 +86,14 @@ class StellaDb
     unique_ptr<KeyValueRepositoryAtomic> myPropertyRepositoryHost;
     unique_ptr<CompositeKeyValueRepository> myPropertyRepository;
     unique_ptr<CompositeKeyValueRepositoryAtomic> myHighscoreRepository;
+    unique_ptr<KeyValueRepositoryAtomic> myRomIndexRepository;
+    unique_ptr<CompositeKeyValueRepositoryAtomic> myDetectionRepository;
+    unique_ptr<KeyValueRepositoryAtomic> myCheatRepository;
+
+    // Imports the old game properties on first run, using its own connection
+    // The game properties can only be accessed once it has finished
+    std::thread myImportThread;
+    std::atomic<bool> myStopImport{false};
 };
 
 #endif // STELLA_DB_HXX
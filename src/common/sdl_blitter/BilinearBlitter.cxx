@@ -60,6 +60,9 @@ void BilinearBlitter::reinitialize(
   myDstRect.w = myFB.scaleX(destRect.w);
   myDstRect.h = myFB.scaleY(destRect.h);
   SDL_RectToFRect(&myDstRect, &myDstFRect);
+
+  // Upload the surface again with the new geometry
+  myTextureValid = false;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -75,16 +78,14 @@ void BilinearBlitter::free()
     myTexture, mySecondaryTexture
   };
   for (SDL_Texture* texture: textures) {
-    if (!texture) continue;
-
-    SDL_DestroyTexture(texture);
+    myFB.texturePool().releaseTexture(texture);
   }
 
   myTexturesAreAllocated = false;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void BilinearBlitter::blit(SDL_Surface& surface)
+void BilinearBlitter::blit(SDL_Surface& surface, const SDL_Rect& dirty)
 {
   ASSERT_MAIN_THREAD;
 
@@ -93,14 +94,73 @@ void BilinearBlitter::blit(SDL_Surface& surface)
   SDL_Texture* texture = myTexture;
 
   if(myStaticData == nullptr) {
-    SDL_UpdateTexture(myTexture, &mySrcRect, surface.pixels, surface.pitch);
-    myTexture = mySecondaryTexture;
-    mySecondaryTexture = texture;
+    if(!SDL_RectEmpty(&dirty) || myTextureWritten || !myTextureValid) {
+      // Pixels written directly in the texture don't need to be uploaded
+      if(!myTextureWritten) {
+        // Only upload the modified area, plus the area which the other
+        // texture received with the last upload
+        SDL_Rect upload = mySrcRect;
+        if(myTextureValid) {
+          SDL_Rect modified{0, 0, 0, 0};
+          SDL_GetRectUnion(&dirty, &myStaleRect, &modified);
+          SDL_GetRectIntersection(&modified, &mySrcRect, &upload);
+        }
+        if(!SDL_RectEmpty(&upload))
+          SDL_UpdateTexture(myTexture, &upload,
+            static_cast<const uInt8*>(surface.pixels) +
+              upload.y * static_cast<size_t>(surface.pitch) + upload.x * sizeof(uInt32),
+            surface.pitch);
+      }
+      // The other texture, which is uploaded next, lacks the area modified
+      // now (or everything, if its content is undefined)
+      myStaleRect = myTextureWritten || !myTextureValid ? mySrcRect : dirty;
+      myTextureWritten = false;
+      myTextureValid = true;
+
+      myTexture = mySecondaryTexture;
+      mySecondaryTexture = texture;
+    }
+    else
+      // Unchanged, draw the last uploaded texture again
+      texture = mySecondaryTexture;
   }
 
   SDL_RenderTexture(myFB.renderer(), texture, &mySrcFRect, &myDstFRect);
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool BilinearBlitter::lock(uInt32*& pixels, uInt32& pitch)
+{
+  ASSERT_MAIN_THREAD;
+
+  if(myStaticData != nullptr) return false;
+
+  recreateTexturesIfNecessary();
+
+  void* texPixels = nullptr;
+  int texPitch = 0;
+  if(!SDL_LockTexture(myTexture, nullptr, &texPixels, &texPitch))
+    return false;
+
+  pixels = static_cast<uInt32*>(texPixels);
+  pitch = static_cast<uInt32>(texPitch) >> 2;
+  myTextureLocked = true;
+
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void BilinearBlitter::unlock()
+{
+  ASSERT_MAIN_THREAD;
+
+  if(!myTextureLocked) return;
+
+  SDL_UnlockTexture(myTexture);
+  myTextureLocked = false;
+  myTextureWritten = true;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void BilinearBlitter::recreateTexturesIfNecessary()
 {
@@ -118,13 +178,17 @@ void BilinearBlitter::recreateTexturesIfNecessary()
     ? SDL_TEXTUREACCESS_STREAMING
     : SDL_TEXTUREACCESS_STATIC;
 
-  myTexture = SDL_CreateTexture(myFB.renderer(), myFB.pixelFormat().format,
+  // Textures released before (e.g. by the blitter replaced by this one on
+  // a video mode change) are reused
+  TexturePool& pool = myFB.texturePool();
+
+  myTexture = pool.acquireTexture(myFB.renderer(), myFB.pixelFormat().format,
       texAccess, mySrcRect.w, mySrcRect.h);
   SDL_SetTextureScaleMode(myTexture, myInterpolate
       ? SDL_SCALEMODE_LINEAR : SDL_SCALEMODE_NEAREST);
 
   if (myStaticData == nullptr) {
-    mySecondaryTexture = SDL_CreateTexture(myFB.renderer(),
+    mySecondaryTexture = pool.acquireTexture(myFB.renderer(),
         myFB.pixelFormat().format,
         texAccess, mySrcRect.w, mySrcRect.h);
     SDL_SetTextureScaleMode(mySecondaryTexture, myInterpolate
@@ -150,4 +214,5 @@ void BilinearBlitter::recreateTexturesIfNecessary()
 
   myRecreateTextures = false;
   myTexturesAreAllocated = true;
+  myTextureWritten = myTextureValid = false;
 }
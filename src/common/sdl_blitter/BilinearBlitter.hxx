@@ -36,7 +36,10 @@ class BilinearBlitter : public Blitter {
       uInt8 blendLevel, SDL_Surface* staticData = nullptr
     ) override;
 
-    void blit(SDL_Surface& surface) override;
+    void blit(SDL_Surface& surface, const SDL_Rect& dirty) override;
+
+    bool lock(uInt32*& pixels, uInt32& pitch) override;
+    void unlock() override;
 
   private:
     FBBackendSDL& myFB;
@@ -50,6 +53,12 @@ class BilinearBlitter : public Blitter {
     bool myInterpolate{false};
     bool myTexturesAreAllocated{false};
     bool myRecreateTextures{false};
+    bool myTextureLocked{false}, myTextureWritten{false};
+    bool myTextureValid{false};  // textures contain the last uploaded pixels
+
+    // The area in which the texture to be uploaded next still lacks the
+    // pixels of the last upload (to the other texture)
+    SDL_Rect myStaleRect{0, 0, 0, 0};
 
     SDL_Surface* myStaticData{nullptr};
 
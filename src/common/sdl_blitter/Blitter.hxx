@@ -33,7 +33,25 @@ class Blitter {
       uInt8 blendLevel, SDL_Surface* staticData = nullptr
     ) = 0;
 
-    virtual void blit(SDL_Surface& surface) = 0;
+    /**
+      Draw the surface.  Unless it is dirty, the texture uploaded before is
+      drawn again.
+
+      @param surface  The surface to draw
+      @param dirty    The area of the surface modified since the last blit
+                      (empty if unmodified)
+    */
+    virtual void blit(SDL_Surface& surface, const SDL_Rect& dirty) = 0;
+
+    /**
+      Give direct access to the pixels of the texture drawn by the next
+      blit, which then skips uploading the surface.  All pixels within the
+      source rectangle must be written, since their old content is undefined.
+
+      @return  False if the blitter doesn't support direct access
+    */
+    virtual bool lock(uInt32*& pixels, uInt32& pitch) { return false; }
+    virtual void unlock() { }
 
   protected:
 
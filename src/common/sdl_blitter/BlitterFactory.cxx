@@ -19,6 +19,7 @@
 
 #include "BilinearBlitter.hxx"
 #include "QisBlitter.hxx"
+#include "SoftwareQisBlitter.hxx"
 
 unique_ptr<Blitter>
 BlitterFactory::createBlitter(FBBackendSDL& fb, ScalingAlgorithm scaling)
@@ -38,7 +39,7 @@ BlitterFactory::createBlitter(FBBackendSDL& fb, ScalingAlgorithm scaling)
       if (QisBlitter::isSupported(fb))
         return std::make_unique<QisBlitter>(fb);
       else
-        return std::make_unique<BilinearBlitter>(fb, true);
+        return std::make_unique<SoftwareQisBlitter>(fb);
 
     default:
       throw std::runtime_error("unreachable");
@@ -67,6 +67,9 @@ void QisBlitter::reinitialize(
   myDstRect.w = myFB.scaleX(destRect.w);
   myDstRect.h = myFB.scaleY(destRect.h);
   SDL_RectToFRect(&myDstRect, &myDstFRect);
+
+  // Upload the surface again with the new geometry
+  myTextureValid = false;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -78,29 +81,38 @@ void QisBlitter::free()
 
   ASSERT_MAIN_THREAD;
 
-  const std::array<SDL_Texture*, 3> textures = {
-    mySrcTexture, myIntermediateTexture, mySecondaryIntermediateTexture
+  const std::array<SDL_Texture*, 4> textures = {
+    mySrcTexture, mySecondarySrcTexture,
+    myIntermediateTexture, mySecondaryIntermediateTexture
   };
   for (SDL_Texture* texture: textures) {
-    if (!texture) continue;
-
-    SDL_DestroyTexture(texture);
+    myFB.texturePool().releaseTexture(texture);
   }
 
   myTexturesAreAllocated = false;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void QisBlitter::blit(SDL_Surface& surface)
+void QisBlitter::blit(SDL_Surface& surface, const SDL_Rect& dirtyRect)
 {
+  // The scaling pass always processes the whole texture
+  const bool dirty = !SDL_RectEmpty(&dirtyRect);
+
   ASSERT_MAIN_THREAD;
 
   recreateTexturesIfNecessary();
 
   SDL_Texture* intermediateTexture = myIntermediateTexture;
 
-  if(myStaticData == nullptr) {
-    SDL_UpdateTexture(mySrcTexture, &mySrcRect, surface.pixels, surface.pitch);
+  // Unchanged, draw the last scaled texture again
+  if(myStaticData == nullptr && !dirty && !myTextureWritten && myTextureValid)
+    intermediateTexture = mySecondaryIntermediateTexture;
+  else if(myStaticData == nullptr) {
+    // Pixels written directly in the texture don't need to be uploaded
+    if(!myTextureWritten)
+      SDL_UpdateTexture(mySrcTexture, &mySrcRect, surface.pixels, surface.pitch);
+    myTextureWritten = false;
+    myTextureValid = true;
 
     blitToIntermediate();
 
@@ -117,6 +129,41 @@ void QisBlitter::blit(SDL_Surface& surface)
                     &myIntermediateFRect, &myDstFRect);
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool QisBlitter::lock(uInt32*& pixels, uInt32& pitch)
+{
+  ASSERT_MAIN_THREAD;
+
+  if(myStaticData != nullptr) return false;
+
+  recreateTexturesIfNecessary();
+
+  // The source textures are streaming textures, which are swapped after
+  // each blit, so the texture written now is not in use by the GPU
+  void* texPixels = nullptr;
+  int texPitch = 0;
+  if(!SDL_LockTexture(mySrcTexture, nullptr, &texPixels, &texPitch))
+    return false;
+
+  pixels = static_cast<uInt32*>(texPixels);
+  pitch = static_cast<uInt32>(texPitch) >> 2;
+  myTextureLocked = true;
+
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void QisBlitter::unlock()
+{
+  ASSERT_MAIN_THREAD;
+
+  if(!myTextureLocked) return;
+
+  SDL_UnlockTexture(mySrcTexture);
+  myTextureLocked = false;
+  myTextureWritten = true;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void QisBlitter::blitToIntermediate()
 {
@@ -159,13 +206,17 @@ void QisBlitter::recreateTexturesIfNecessary()
   myIntermediateRect.y = 0;
   SDL_RectToFRect(&myIntermediateRect, &myIntermediateFRect);
 
-  mySrcTexture = SDL_CreateTexture(myFB.renderer(), myFB.pixelFormat().format,
+  // Textures released before (e.g. by the blitter replaced by this one on
+  // a video mode change) are reused
+  TexturePool& pool = myFB.texturePool();
+
+  mySrcTexture = pool.acquireTexture(myFB.renderer(), myFB.pixelFormat().format,
     texAccess, mySrcRect.w, mySrcRect.h);
   SDL_SetTextureScaleMode(mySrcTexture, SDL_SCALEMODE_NEAREST);
   SDL_SetTextureBlendMode(mySrcTexture, SDL_BLENDMODE_NONE);
 
   if (myStaticData == nullptr) {
-    mySecondarySrcTexture = SDL_CreateTexture(myFB.renderer(),
+    mySecondarySrcTexture = pool.acquireTexture(myFB.renderer(),
         myFB.pixelFormat().format, texAccess, mySrcRect.w, mySrcRect.h);
     SDL_SetTextureScaleMode(mySecondarySrcTexture, SDL_SCALEMODE_NEAREST);
     SDL_SetTextureBlendMode(mySecondarySrcTexture, SDL_BLENDMODE_NONE);
@@ -173,12 +224,12 @@ void QisBlitter::recreateTexturesIfNecessary()
     mySecondarySrcTexture = nullptr;
   }
 
-  myIntermediateTexture = SDL_CreateTexture(myFB.renderer(), myFB.pixelFormat().format,
-      SDL_TEXTUREACCESS_TARGET, myIntermediateRect.w, myIntermediateRect.h);
+  myIntermediateTexture = pool.acquireTexture(myFB.renderer(),
+      myFB.pixelFormat().format, SDL_TEXTUREACCESS_TARGET, myIntermediateRect.w, myIntermediateRect.h);
   SDL_SetTextureScaleMode(myIntermediateTexture, SDL_SCALEMODE_LINEAR);
 
   if (myStaticData == nullptr) {
-    mySecondaryIntermediateTexture = SDL_CreateTexture(myFB.renderer(),
+    mySecondaryIntermediateTexture = pool.acquireTexture(myFB.renderer(),
         myFB.pixelFormat().format, SDL_TEXTUREACCESS_TARGET,
         myIntermediateRect.w, myIntermediateRect.h);
     SDL_SetTextureScaleMode(mySecondaryIntermediateTexture,
@@ -207,4 +258,5 @@ void QisBlitter::recreateTexturesIfNecessary()
 
   myRecreateTextures = false;
   myTexturesAreAllocated = true;
+  myTextureWritten = myTextureValid = false;
 }
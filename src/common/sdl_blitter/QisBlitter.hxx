@@ -38,7 +38,10 @@ class QisBlitter : public Blitter {
       uInt8 blendLevel, SDL_Surface* staticData
     ) override;
 
-    void blit(SDL_Surface& surface) override;
+    void blit(SDL_Surface& surface, const SDL_Rect& dirty) override;
+
+    bool lock(uInt32*& pixels, uInt32& pitch) override;
+    void unlock() override;
 
   private:
 
@@ -60,6 +63,8 @@ class QisBlitter : public Blitter {
     bool myEnableBlend{false};
     bool myTexturesAreAllocated{false};
     bool myRecreateTextures{false};
+    bool myTextureLocked{false}, myTextureWritten{false};
+    bool myTextureValid{false};  // textures contain the last uploaded pixels
 
     SDL_Surface* myStaticData{nullptr};
 
@@ -0,0 +1,364 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2026 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+  #define SOFTWARE_QIS_SSE2
+  #include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__) || defined(_M_ARM64)
+  #define SOFTWARE_QIS_NEON
+  #include <arm_neon.h>
+#endif
+
+#include <cmath>
+
+#include "FBBackendSDL.hxx"
+#include "ThreadDebugging.hxx"
+#include "SoftwareQisBlitter.hxx"
+
+namespace {
+  // Each channel is (p0 * (256 - weight) + p1 * weight) >> 8
+  inline uInt32 blendPixel(uInt32 p0, uInt32 p1, uInt32 weight)
+  {
+    const uInt32 inverse = 256 - weight;
+    const uInt32 rb = (((p0 & 0xFF00FF) * inverse +
+                        (p1 & 0xFF00FF) * weight) >> 8) & 0xFF00FF;
+    const uInt32 ag = (((p0 >> 8) & 0xFF00FF) * inverse +
+                       ((p1 >> 8) & 0xFF00FF) * weight) & 0xFF00FF00;
+    return rb | ag;
+  }
+} // namespace
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+SoftwareQisBlitter::SoftwareQisBlitter(FBBackendSDL& fb)
+  : myFB{fb}
+{
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+SoftwareQisBlitter::~SoftwareQisBlitter()
+{
+  free();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void SoftwareQisBlitter::reinitialize(
+  SDL_Rect srcRect, SDL_Rect destRect, bool enableBlend,
+  uInt8 blendLevel, SDL_Surface* staticData
+)
+{
+  myRecreateTextures = myRecreateTextures || !(
+    mySrcRect.w == srcRect.w &&
+    mySrcRect.h == srcRect.h &&
+    myDstRect.w == myFB.scaleX(destRect.w) &&
+    myDstRect.h == myFB.scaleY(destRect.h) &&
+    blendLevel  == myBlendLevel &&
+    enableBlend == myEnableBlend &&
+    myStaticData == staticData
+   );
+
+  myEnableBlend = enableBlend;
+  myBlendLevel = blendLevel;
+  myStaticData = staticData;
+
+  mySrcRect = srcRect;
+
+  myDstRect.x = myFB.scaleX(destRect.x);
+  myDstRect.y = myFB.scaleY(destRect.y);
+  myDstRect.w = myFB.scaleX(destRect.w);
+  myDstRect.h = myFB.scaleY(destRect.h);
+  SDL_RectToFRect(&myDstRect, &myDstFRect);
+
+  // Scale the surface again with the new geometry
+  myTextureValid = false;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void SoftwareQisBlitter::free()
+{
+  if (!myTexturesAreAllocated) {
+    return;
+  }
+
+  ASSERT_MAIN_THREAD;
+
+  const std::array<SDL_Texture*, 2> textures = {
+    myTexture, mySecondaryTexture
+  };
+  for (SDL_Texture* texture: textures) {
+    myFB.texturePool().releaseTexture(texture);
+  }
+
+  myTexturesAreAllocated = false;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void SoftwareQisBlitter::blit(SDL_Surface& surface, const SDL_Rect& dirty)
+{
+  ASSERT_MAIN_THREAD;
+
+  recreateTexturesIfNecessary();
+
+  SDL_Texture* texture = myTexture;
+
+  if(myStaticData == nullptr) {
+    if(!SDL_RectEmpty(&dirty) || myTextureWritten || !myTextureValid) {
+      // The scaling pass always processes the whole source
+      if(myTextureWritten)
+        scale(myPixels.data(), mySrcRect.w, myTexture);
+      else
+        scale(static_cast<const uInt32*>(surface.pixels),
+              static_cast<uInt32>(surface.pitch) >> 2, myTexture);
+      myTextureWritten = false;
+      myTextureValid = true;
+
+      myTexture = mySecondaryTexture;
+      mySecondaryTexture = texture;
+    }
+    else
+      // Unchanged, draw the last scaled texture again
+      texture = mySecondaryTexture;
+  }
+
+  SDL_RenderTexture(myFB.renderer(), texture, nullptr, &myDstFRect);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool SoftwareQisBlitter::lock(uInt32*& pixels, uInt32& pitch)
+{
+  ASSERT_MAIN_THREAD;
+
+  if(myStaticData != nullptr) return false;
+
+  recreateTexturesIfNecessary();
+
+  // The source is only read by the scaling pass, so it is kept in memory
+  // instead of a texture
+  pixels = myPixels.data();
+  pitch = static_cast<uInt32>(mySrcRect.w);
+  myTextureLocked = true;
+
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void SoftwareQisBlitter::unlock()
+{
+  ASSERT_MAIN_THREAD;
+
+  if(!myTextureLocked) return;
+
+  myTextureLocked = false;
+  myTextureWritten = true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void SoftwareQisBlitter::scale(const uInt32* pixels, uInt32 pitch,
+                               SDL_Texture* texture)
+{
+  if(SDL_RectEmpty(&mySrcRect) || SDL_RectEmpty(&myDstRect))
+    return;
+
+  const auto srcHeight = static_cast<uInt32>(mySrcRect.h);
+  const auto dstWidth = static_cast<uInt32>(myDstRect.w);
+  const auto dstHeight = static_cast<uInt32>(myDstRect.h);
+
+  // Horizontal pass, once for each source row
+  for(uInt32 y = 0; y < srcHeight; ++y)
+  {
+    const uInt32* src = pixels + static_cast<size_t>(y) * pitch;
+    uInt32* out = myExpandedRows.data() + static_cast<size_t>(y) * dstWidth;
+
+    for(uInt32 x = 0; x < dstWidth; ++x)
+    {
+      const Tap& tap = myColumnTaps[x];
+      out[x] = tap.weight == 0 ? src[tap.index0]
+        : blendPixel(src[tap.index0], src[tap.index1], tap.weight);
+    }
+  }
+
+  // Vertical pass, directly into the texture
+  void* texPixels = nullptr;
+  int texPitch = 0;
+  if(!SDL_LockTexture(texture, nullptr, &texPixels, &texPitch))
+    return;
+
+  for(uInt32 y = 0; y < dstHeight; ++y)
+  {
+    const Tap& tap = myRowTaps[y];
+    const uInt32* row0 =
+      myExpandedRows.data() + static_cast<size_t>(tap.index0) * dstWidth;
+    auto* out = reinterpret_cast<uInt32*>(
+      static_cast<uInt8*>(texPixels) + static_cast<size_t>(y) * texPitch);
+
+    if(tap.weight == 0)
+      std::copy_n(row0, dstWidth, out);
+    else
+      blendRow(row0,
+        myExpandedRows.data() + static_cast<size_t>(tap.index1) * dstWidth,
+        tap.weight, out, dstWidth);
+  }
+
+  SDL_UnlockTexture(texture);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void SoftwareQisBlitter::computeTaps(vector<Tap>& taps, uInt32 srcSize,
+                                     uInt32 dstSize)
+{
+  taps.resize(dstSize);
+  if(srcSize == 0)
+    return;
+
+  // The size of the integer scaled image, which is then scaled bilinearly
+  const uInt32 factor = std::max(dstSize / srcSize, 1U);
+  const uInt32 size = factor * srcSize;
+
+  for(uInt32 i = 0; i < dstSize; ++i)
+  {
+    // Sample at the pixel center, like the GPU does
+    const double pos =
+      std::max((i + 0.5) * size / dstSize - 0.5, 0.0);
+    const uInt32 pos0 = std::min(static_cast<uInt32>(pos), size - 1);
+    const uInt32 pos1 = std::min(pos0 + 1, size - 1);
+    const auto weight = static_cast<uInt32>(std::lround((pos - pos0) * 256));
+
+    Tap& tap = taps[i];
+    tap.index0 = pos0 / factor;
+    tap.index1 = pos1 / factor;
+    tap.weight = weight;
+
+    // Within one source pixel, or (almost) exactly on the next one
+    if(tap.index0 == tap.index1 || weight == 0)
+      tap.weight = 0;
+    else if(weight >= 256)
+    {
+      tap.index0 = tap.index1;
+      tap.weight = 0;
+    }
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void SoftwareQisBlitter::blendRow(const uInt32* row0, const uInt32* row1,
+                                  uInt32 weight, uInt32* out, uInt32 count)
+{
+  uInt32 x = 0;
+
+#if defined(SOFTWARE_QIS_SSE2)
+  const __m128i weight0 = _mm_set1_epi16(static_cast<short>(256 - weight));
+  const __m128i weight1 = _mm_set1_epi16(static_cast<short>(weight));
+  const __m128i zero = _mm_setzero_si128();
+
+  // The 16 bit sums are at most 255 * 256, so they can't overflow
+  const auto blend = [&](__m128i p0, __m128i p1) {
+    return _mm_srli_epi16(_mm_add_epi16(_mm_mullo_epi16(p0, weight0),
+                                        _mm_mullo_epi16(p1, weight1)), 8);
+  };
+
+  for(; x + 4 <= count; x += 4)
+  {
+    const __m128i p0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row0 + x));
+    const __m128i p1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row1 + x));
+
+    const __m128i result = _mm_packus_epi16(
+      blend(_mm_unpacklo_epi8(p0, zero), _mm_unpacklo_epi8(p1, zero)),
+      blend(_mm_unpackhi_epi8(p0, zero), _mm_unpackhi_epi8(p1, zero)));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out + x), result);
+  }
+#elif defined(SOFTWARE_QIS_NEON)
+  const uint8x8_t weight0 = vdup_n_u8(static_cast<uInt8>(256 - weight));
+  const uint8x8_t weight1 = vdup_n_u8(static_cast<uInt8>(weight));
+
+  for(; x + 4 <= count; x += 4)
+  {
+    const uint8x16_t p0 = vreinterpretq_u8_u32(vld1q_u32(row0 + x));
+    const uint8x16_t p1 = vreinterpretq_u8_u32(vld1q_u32(row1 + x));
+
+    const uint16x8_t lo = vmlal_u8(vmull_u8(vget_low_u8(p0), weight0),
+                                   vget_low_u8(p1), weight1);
+    const uint16x8_t hi = vmlal_u8(vmull_u8(vget_high_u8(p0), weight0),
+                                   vget_high_u8(p1), weight1);
+    vst1q_u32(out + x, vreinterpretq_u32_u8(
+      vcombine_u8(vshrn_n_u16(lo, 8), vshrn_n_u16(hi, 8))));
+  }
+#endif
+
+  for(; x < count; ++x)
+    out[x] = blendPixel(row0[x], row1[x], weight);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void SoftwareQisBlitter::recreateTexturesIfNecessary()
+{
+  if (myTexturesAreAllocated && !myRecreateTextures) {
+    return;
+  }
+
+  ASSERT_MAIN_THREAD;
+
+  if (myTexturesAreAllocated) {
+    free();
+  }
+
+  const auto srcWidth = static_cast<uInt32>(mySrcRect.w);
+  const auto srcHeight = static_cast<uInt32>(mySrcRect.h);
+  const auto dstWidth = static_cast<uInt32>(myDstRect.w);
+
+  computeTaps(myColumnTaps, srcWidth, dstWidth);
+  computeTaps(myRowTaps, srcHeight, static_cast<uInt32>(myDstRect.h));
+  myExpandedRows.resize(static_cast<size_t>(srcHeight) * dstWidth);
+  myPixels.resize(myStaticData == nullptr
+                  ? static_cast<size_t>(srcHeight) * srcWidth : 0);
+
+  // Textures released before (e.g. by the blitter replaced by this one on
+  // a video mode change) are reused.  The textures have the destination
+  // size, so nothing is scaled when drawing them.
+  TexturePool& pool = myFB.texturePool();
+
+  myTexture = pool.acquireTexture(myFB.renderer(), myFB.pixelFormat().format,
+      SDL_TEXTUREACCESS_STREAMING, myDstRect.w, myDstRect.h);
+  SDL_SetTextureScaleMode(myTexture, SDL_SCALEMODE_NEAREST);
+
+  if (myStaticData == nullptr) {
+    mySecondaryTexture = pool.acquireTexture(myFB.renderer(),
+        myFB.pixelFormat().format, SDL_TEXTUREACCESS_STREAMING,
+        myDstRect.w, myDstRect.h);
+    SDL_SetTextureScaleMode(mySecondaryTexture, SDL_SCALEMODE_NEAREST);
+  } else {
+    mySecondaryTexture = nullptr;
+    scale(static_cast<const uInt32*>(myStaticData->pixels),
+          static_cast<uInt32>(myStaticData->pitch) >> 2, myTexture);
+  }
+
+  const std::array<SDL_Texture*, 2> textures = { myTexture, mySecondaryTexture };
+
+  for (SDL_Texture* texture: textures) {
+    if (!texture) continue;
+
+    if (myEnableBlend) {
+      SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+      SDL_SetTextureAlphaMod(texture, myBlendLevel * 2.55);
+    } else {
+      SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_NONE);
+    }
+  }
+
+  myRecreateTextures = false;
+  myTexturesAreAllocated = true;
+  myTextureWritten = myTextureValid = false;
+}
@@ -0,0 +1,113 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2026 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+
+#ifndef SOFTWARE_QIS_BLITTER_HXX
+#define SOFTWARE_QIS_BLITTER_HXX
+
+class FBBackendSDL;
+
+#include "Blitter.hxx"
+#include "SDL_lib.hxx"
+
+/**
+  Quasi integer scaling on the CPU, for renderers without render target
+  support (e.g. the software renderer), which QisBlitter requires.
+
+  Like QisBlitter, the source is scaled up by the largest integer factor
+  fitting into the destination (nearest neighbour), and then bilinearly to
+  the final size.  Both passes are combined and written directly into a
+  streaming texture of the destination size, which is drawn unscaled.
+  Each source row is expanded horizontally once, then every destination
+  row blends the two nearest expanded rows (using SSE2/NEON if available).
+
+  @author  Stella Team
+*/
+class SoftwareQisBlitter : public Blitter {
+
+  public:
+
+    explicit SoftwareQisBlitter(FBBackendSDL& fb);
+
+    ~SoftwareQisBlitter() override;
+
+    void reinitialize(
+      SDL_Rect srcRect, SDL_Rect destRect, bool enableBlend,
+      uInt8 blendLevel, SDL_Surface* staticData
+    ) override;
+
+    void blit(SDL_Surface& surface, const SDL_Rect& dirty) override;
+
+    bool lock(uInt32*& pixels, uInt32& pitch) override;
+    void unlock() override;
+
+  private:
+
+    // The two source pixels blended into a destination pixel, and the
+    // weight of the second one (0 - 255)
+    struct Tap {
+      uInt32 index0{0}, index1{0};
+      uInt32 weight{0};
+    };
+
+    FBBackendSDL& myFB;
+
+    SDL_Texture* myTexture{nullptr};
+    SDL_Texture* mySecondaryTexture{nullptr};
+
+    SDL_Rect mySrcRect{0, 0, 0, 0}, myDstRect{0, 0, 0, 0};
+    SDL_FRect myDstFRect{0.F, 0.F, 0.F, 0.F};
+
+    uInt32 myBlendLevel{100};
+    bool myEnableBlend{false};
+    bool myTexturesAreAllocated{false};
+    bool myRecreateTextures{false};
+    bool myTextureLocked{false}, myTextureWritten{false};
+    bool myTextureValid{false};  // textures contain the last scaled pixels
+
+    SDL_Surface* myStaticData{nullptr};
+
+    vector<Tap> myColumnTaps, myRowTaps;
+    vector<uInt32> myExpandedRows;  // source rows, scaled horizontally
+    vector<uInt32> myPixels;        // the source, if written by lock()
+
+  private:
+
+    void free();
+
+    void recreateTexturesIfNecessary();
+
+    // Scale the source pixels into the given texture
+    void scale(const uInt32* pixels, uInt32 pitch, SDL_Texture* texture);
+
+    static void computeTaps(vector<Tap>& taps, uInt32 srcSize, uInt32 dstSize);
+
+    static void blendRow(const uInt32* row0, const uInt32* row1,
+                         uInt32 weight, uInt32* out, uInt32 count);
+
+  private:
+
+    SoftwareQisBlitter(const SoftwareQisBlitter&) = delete;
+
+    SoftwareQisBlitter(SoftwareQisBlitter&&) = delete;
+
+    SoftwareQisBlitter& operator=(const SoftwareQisBlitter&) = delete;
+
+    SoftwareQisBlitter& operator=(SoftwareQisBlitter&&) = delete;
+};
+
+#endif // SOFTWARE_QIS_BLITTER_HXX
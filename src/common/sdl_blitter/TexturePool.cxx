@@ -0,0 +1,160 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2026 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#include "ThreadDebugging.hxx"
+#include "TexturePool.hxx"
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TexturePool::~TexturePool()
+{
+  for(const auto& entry: myUnused)
+    destroy(entry);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+SDL_Texture* TexturePool::acquireTexture(SDL_Renderer* renderer,
+    SDL_PixelFormat format, SDL_TextureAccess access, int w, int h)
+{
+  ASSERT_MAIN_THREAD;
+
+  Entry entry{format, static_cast<int>(access), w, h};
+  auto* texture = static_cast<SDL_Texture*>(acquire(entry));
+
+  if(texture)
+  {
+    // Undo whatever the last user has set
+    SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_NONE);
+    SDL_SetTextureAlphaMod(texture, 255);
+    SDL_SetTextureColorMod(texture, 255, 255, 255);
+    SDL_SetTextureScaleMode(texture, SDL_SCALEMODE_NEAREST);
+  }
+  else
+  {
+    texture = SDL_CreateTexture(renderer, format, access, w, h);
+    if(!texture)
+      return nullptr;
+  }
+  entry.object = texture;
+  myUsedTextures.emplace(texture, entry);
+
+  return texture;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TexturePool::releaseTexture(SDL_Texture* texture)
+{
+  if(!texture)
+    return;
+
+  ASSERT_MAIN_THREAD;
+
+  const auto it = myUsedTextures.find(texture);
+  if(it == myUsedTextures.end())
+  {
+    // Created by a previous renderer
+    SDL_DestroyTexture(texture);
+    return;
+  }
+  release(it->second);
+  myUsedTextures.erase(it);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+SDL_Surface* TexturePool::acquireSurface(SDL_PixelFormat format, int w, int h)
+{
+  ASSERT_MAIN_THREAD;
+
+  auto* surface = static_cast<SDL_Surface*>(acquire(Entry{format, -1, w, h}));
+
+  if(surface)
+    SDL_FillSurfaceRect(surface, nullptr, 0);
+  else
+    surface = SDL_CreateSurface(w, h, format);
+
+  return surface;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TexturePool::releaseSurface(SDL_Surface* surface)
+{
+  if(!surface)
+    return;
+
+  ASSERT_MAIN_THREAD;
+
+  release(Entry{surface->format, -1, surface->w, surface->h, surface});
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TexturePool::clearTextures()
+{
+  ASSERT_MAIN_THREAD;
+
+  std::erase_if(myUnused, [this](const Entry& entry) {
+    if(entry.access < 0)
+      return false;
+
+    myUnusedBytes -= entry.bytes();
+    destroy(entry);
+    return true;
+  });
+  // Textures still in use are destroyed together with the renderer
+  myUsedTextures.clear();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void* TexturePool::acquire(const Entry& key)
+{
+  // Prefer the most recently released object
+  for(auto it = myUnused.rbegin(); it != myUnused.rend(); ++it)
+  {
+    if(it->matches(key))
+    {
+      void* object = it->object;
+
+      myUnusedBytes -= it->bytes();
+      myUnused.erase(std::next(it).base());
+      return object;
+    }
+  }
+  return nullptr;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TexturePool::release(const Entry& entry)
+{
+  myUnused.push_back(entry);
+  myUnusedBytes += entry.bytes();
+
+  // Destroy the least recently released objects beyond the limit
+  size_t trimmed = 0;
+  while(myUnusedBytes > MAX_UNUSED_BYTES && trimmed < myUnused.size())
+  {
+    myUnusedBytes -= myUnused[trimmed].bytes();
+    destroy(myUnused[trimmed++]);
+  }
+  myUnused.erase(myUnused.begin(), myUnused.begin() + trimmed);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TexturePool::destroy(const Entry& entry)
+{
+  if(entry.access < 0)
+    SDL_DestroySurface(static_cast<SDL_Surface*>(entry.object));
+  else
+    SDL_DestroyTexture(static_cast<SDL_Texture*>(entry.object));
+}
@@ -0,0 +1,108 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2026 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#ifndef TEXTURE_POOL_HXX
+#define TEXTURE_POOL_HXX
+
+#include <unordered_map>
+
+#include "bspf.hxx"
+#include "SDL_lib.hxx"
+
+/**
+  Keeps the textures and surfaces released by the blitters and surfaces, so
+  that they can be reused when the same (format, size, access) is requested
+  again.  Video mode changes (fullscreen, bezel, TV effects, ...) recreate
+  all blitters, which would otherwise destroy and allocate identical
+  textures again.
+
+  Released objects are kept until the pool exceeds its size limit, in which
+  case the least recently released ones are destroyed.  Textures belong to
+  the renderer, so they must be cleared before it is destroyed; textures
+  still in use at that time are destroyed when released.
+
+  @author  Stella Team
+*/
+class TexturePool
+{
+  public:
+    TexturePool() = default;
+    ~TexturePool();
+
+    /**
+      Answer an unused texture, which is either reused or newly created.
+      The texture is reset to no blending, no color/alpha modulation and
+      nearest scaling; its content is undefined.
+    */
+    SDL_Texture* acquireTexture(SDL_Renderer* renderer, SDL_PixelFormat format,
+                                SDL_TextureAccess access, int w, int h);
+    void releaseTexture(SDL_Texture* texture);
+
+    /**
+      Answer an unused surface, which is either reused or newly created.
+      The surface is cleared, like a new one.
+    */
+    SDL_Surface* acquireSurface(SDL_PixelFormat format, int w, int h);
+    void releaseSurface(SDL_Surface* surface);
+
+    /**
+      Destroy all unused textures; must be called before the renderer is
+      destroyed.
+    */
+    void clearTextures();
+
+  private:
+    struct Entry {
+      SDL_PixelFormat format{SDL_PIXELFORMAT_UNKNOWN};
+      int access{-1};     // -1 for surfaces
+      int w{0}, h{0};
+      void* object{nullptr};
+
+      bool matches(const Entry& other) const {
+        return format == other.format && access == other.access &&
+               w == other.w && h == other.h;
+      }
+      size_t bytes() const {
+        return static_cast<size_t>(w) * h * SDL_BYTESPERPIXEL(format);
+      }
+    };
+
+    void* acquire(const Entry& key);
+    void release(const Entry& entry);
+
+    static void destroy(const Entry& entry);
+
+  private:
+    // Memory kept in unused textures and surfaces
+    static constexpr size_t MAX_UNUSED_BYTES = 64 * 1024 * 1024;
+
+    // Unused objects, the least recently released first
+    vector<Entry> myUnused;
+    size_t myUnusedBytes{0};
+
+    // Textures created by the current renderer and not released yet
+    std::unordered_map<SDL_Texture*, Entry> myUsedTextures;
+
+  private:
+    // Following constructors and assignment operators not supported
+    TexturePool(const TexturePool&) = delete;
+    TexturePool(TexturePool&&) = delete;
+    TexturePool& operator=(const TexturePool&) = delete;
+    TexturePool& operator=(TexturePool&&) = delete;
+};
+
+#endif // TEXTURE_POOL_HXX
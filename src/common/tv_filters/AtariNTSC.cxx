@@ -16,10 +16,19 @@
 //============================================================================
 
 #include <cstring>
-#include <thread>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+  #define ATARI_NTSC_SSE2
+  #include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__) || defined(_M_ARM64)
+  #define ATARI_NTSC_NEON
+  #include <arm_neon.h>
+#endif
 
 #include "AtariNTSC.hxx"
 #include "PhosphorHandler.hxx"
+#include "ThreadPool.hxx"
+#include "PerfCounters.hxx"
 
 // blitter related
 #ifndef restrict
@@ -36,95 +45,126 @@
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void AtariNTSC::initialize(const Setup& setup)
 {
-  init(myImpl, setup);
+  if(myInitialized && setup == mySetup)
+    return;
+
+  // Tweaking artifacts or fringing doesn't need new filters
+  if(myInitialized && setup.sharpness == mySetup.sharpness &&
+     setup.resolution == mySetup.resolution && setup.bleed == mySetup.bleed)
+    initArtifacts(myImpl, setup);
+  else
+    init(myImpl, setup);
+
+  mySetup = setup;
+  myInitialized = true;
   generateKernels();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void AtariNTSC::setPalette(const PaletteArray& palette)
 {
-  uInt8* ptr = myRGBPalette.data();  // NOLINT (erroneously marked as const)
+  std::array<uInt8, palette_size * 3L> rgbPalette;
+  uInt8* ptr = rgbPalette.data();  // NOLINT (erroneously marked as const)
   for(auto p: palette)
   {
     *ptr++ = (p >> 16) & 0xff;
     *ptr++ = (p >> 8) & 0xff;
     *ptr++ = p & 0xff;
   }
+  if(rgbPalette == myRGBPalette && !myKernelCache.empty())
+    return;
+
+  myRGBPalette = rgbPalette;
   generateKernels();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void AtariNTSC::generateKernels()
 {
-  const uInt8* ptr = myRGBPalette.data();
-  for(size_t entry = 0; entry < myRGBPalette.size() / 3; ++entry)
+  // All rendered rows change with the kernels
+  myPhosphorRows.invalidate();
+
+  // Palettes and setups are often set repeatedly (e.g. while adjusting them)
+  const auto it = std::ranges::find_if(myKernelCache,
+      [this](const auto& cached) {
+        return cached->setup == mySetup && cached->palette == myRGBPalette;
+      });
+  if(it != myKernelCache.end())
   {
-    const float r = (*ptr++) / 255.F * rgb_unit + rgb_offset,
-                g = (*ptr++) / 255.F * rgb_unit + rgb_offset,
-                b = (*ptr++) / 255.F * rgb_unit + rgb_offset;
-    float y, i, q;  RGB_TO_YIQ( r, g, b, y, i, q );  // NOLINT
+    std::rotate(myKernelCache.begin(), it, it + 1);
+    myColorTable = myKernelCache.front()->table;
+    return;
+  }
 
-    // Generate kernel
-    int ir, ig, ib;  YIQ_TO_RGB( y, i, q, myImpl.to_rgb.data(), ir, ig, ib );  //NOLINT
-    const uInt32 rgb = PACK_RGB( ir, ig, ib );
+  // Each entry is independent, so the rendering threads can share the work
+  const auto generateStripe = [this](uInt32 stripe, uInt32 numStripes)
+  {
+    for(size_t entry = stripe; entry < palette_size; entry += numStripes)
+    {
+      const uInt8* ptr = &myRGBPalette[entry * 3];
+      const float r = ptr[0] / 255.F * rgb_unit + rgb_offset,
+                  g = ptr[1] / 255.F * rgb_unit + rgb_offset,
+                  b = ptr[2] / 255.F * rgb_unit + rgb_offset;
+      float y, i, q;  RGB_TO_YIQ( r, g, b, y, i, q );  // NOLINT
 
-    uInt32* kernel = myColorTable[entry].data();
-    genKernel(myImpl, y, i, q, kernel);
+      // Generate kernel
+      int ir, ig, ib;  YIQ_TO_RGB( y, i, q, myImpl.to_rgb.data(), ir, ig, ib );  //NOLINT
+      const uInt32 rgb = PACK_RGB( ir, ig, ib );
 
-    for ( uInt32 c = 0; c < rgb_kernel_size / 2; ++c )
-    {
-      const uInt32 error = rgb -
-          kernel [c    ] - kernel [(c+10)%14+14] -
-          kernel [c + 7] - kernel [c + 3    +14];
-      kernel [c + 3 + 14] += error;
+      uInt32* kernel = myColorTable[entry].data();
+      genKernel(myImpl, y, i, q, kernel);
+
+      for ( uInt32 c = 0; c < rgb_kernel_size / 2; ++c )
+      {
+        const uInt32 error = rgb -
+            kernel [c    ] - kernel [(c+10)%14+14] -
+            kernel [c + 7] - kernel [c + 3    +14];
+        kernel [c + 3 + 14] += error;
+      }
     }
-  }
-}
+  };
 
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void AtariNTSC::enableThreading(bool enable)
-{
-  uInt32 systemThreads = enable ? std::thread::hardware_concurrency() : 0;
-  if(systemThreads <= 1)
-  {
-    myWorkerThreads = 0;
-    myTotalThreads  = 1;
-  }
+  if(myThreadPool)
+    myThreadPool->run(generateStripe);
   else
-  {
-    systemThreads = std::max<uInt32>(1, std::min<uInt32>(4, systemThreads - 1));
+    generateStripe(0, 1);
 
-    myWorkerThreads = systemThreads - 1;
-    myTotalThreads  = systemThreads;
+  if(myKernelCache.size() == KERNEL_CACHE_SIZE)
+    myKernelCache.pop_back();
+  myKernelCache.insert(myKernelCache.begin(),
+      std::make_unique<CachedKernels>(mySetup, myRGBPalette, myColorTable));
+}
 
-    myThreads = std::make_unique<std::thread[]>(myWorkerThreads);  // NOLINT
-  }
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void AtariNTSC::enableSIMD(bool enable)
+{
+#if defined(ATARI_NTSC_SSE2) || defined(ATARI_NTSC_NEON)
+  mySIMD = enable;
+#else
+  mySIMD = false;
+#endif
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void AtariNTSC::render(const uInt8* atari_in, uInt32 in_width, uInt32 in_height,
-                       void* rgb_out, uInt32 out_pitch, uInt32* rgb_in)
+                       void* rgb_out, uInt32 out_pitch, uInt32* rgb_in,
+                       const uInt64* line_hashes)
 {
-  // Spawn the threads...
-  for(uInt32 i = 0; i < myWorkerThreads; ++i)
+  PERF_SCOPE(NTSC);
+
+  const auto renderStripe = [=, this](uInt32 stripe, uInt32 numStripes)
   {
-    myThreads[i] = std::thread([rgb_in, atari_in, in_width, in_height,
-                                i, rgb_out, out_pitch, this]
-    {
-      rgb_in == nullptr ?
-        renderThread(atari_in, in_width, in_height, myTotalThreads,
-                     i+1, rgb_out, out_pitch) :
-        renderWithPhosphorThread(atari_in, in_width, in_height, myTotalThreads,
-                                 i+1, rgb_in, rgb_out, out_pitch);
-    });
-  }
-  // Make the main thread busy too
-  rgb_in == nullptr ?
-    renderThread(atari_in, in_width, in_height, myTotalThreads, 0, rgb_out, out_pitch) :
-    renderWithPhosphorThread(atari_in, in_width, in_height, myTotalThreads, 0, rgb_in, rgb_out, out_pitch);
-  // ...and make them join again
-  for(uInt32 i = 0; i < myWorkerThreads; ++i)
-    myThreads[i].join();
+    rgb_in == nullptr ?
+      renderThread(atari_in, in_width, in_height, numStripes,
+                   stripe, rgb_out, out_pitch) :
+      renderWithPhosphorThread(atari_in, in_width, in_height, numStripes,
+                               stripe, rgb_in, line_hashes, rgb_out, out_pitch);
+  };
+
+  if(myThreadPool)
+    myThreadPool->run(renderStripe);
+  else
+    renderStripe(0, 1);
 
   // Copy phosphor values into out buffer
   if(rgb_in != nullptr)
@@ -155,6 +195,12 @@ void AtariNTSC::renderThread(const uInt8* atari_in, uInt32 in_width,
     line_out[0] = line_out[1] = 0;
     line_out += 2;
 
+#if defined(ATARI_NTSC_SSE2) || defined(ATARI_NTSC_NEON)
+    if(mySIMD)
+      line_out = renderChunksSIMD(line_in, line_out, chunk_count,
+                                  kernel0, kernel1, kernelx0, kernelx1);
+    else
+#endif
     for(uInt32 n = chunk_count; n; --n)
     {
       // order of input and output pixels must not be altered
@@ -208,7 +254,7 @@ void AtariNTSC::renderThread(const uInt8* atari_in, uInt32 in_width,
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void AtariNTSC::renderWithPhosphorThread(const uInt8* atari_in, uInt32 in_width,
   uInt32 in_height, uInt32 numThreads, uInt32 threadNum, uInt32* rgb_in,
-  void* rgb_out, uInt32 out_pitch)
+  const uInt64* line_hashes, void* rgb_out, uInt32 out_pitch)
 {
   // Adapt parameters to thread number
   const uInt32 yStart = in_height * threadNum / numThreads;
@@ -220,8 +266,20 @@ void AtariNTSC::renderWithPhosphorThread(const uInt8* atari_in, uInt32 in_width,
 
   uInt32 const chunk_count = (in_width - 1) / PIXEL_in_chunk;
 
+  const uInt32 blend_count = AtariNTSC::outWidth(in_width) / 8 * 8;
+
   for(uInt32 y = yStart; y < yEnd; ++y)
   {
+    // Rows which would result in the same blended pixels can be skipped,
+    // since the phosphor buffer is copied into the output buffer anyway
+    if(myPhosphorRows.skipRow(y, line_hashes[y]))
+    {
+      bufofs += blend_count;
+      atari_in += in_width;
+      rgb_out = static_cast<char*>(rgb_out) + out_pitch;
+      continue;
+    }
+
     const uInt8* line_in = atari_in;
     ATARI_NTSC_BEGIN_ROW(NTSC_black, line_in[0]);
     auto* restrict line_out = static_cast<uInt32*>(rgb_out);
@@ -231,6 +289,12 @@ void AtariNTSC::renderWithPhosphorThread(const uInt8* atari_in, uInt32 in_width,
     line_out[0] = line_out[1] = 0;
     line_out += 2;
 
+#if defined(ATARI_NTSC_SSE2) || defined(ATARI_NTSC_NEON)
+    if(mySIMD)
+      line_out = renderChunksSIMD(line_in, line_out, chunk_count,
+                                  kernel0, kernel1, kernelx0, kernelx1);
+    else
+#endif
     for(uInt32 n = chunk_count; n; --n)
     {
       // order of input and output pixels must not be altered
@@ -276,65 +340,128 @@ void AtariNTSC::renderWithPhosphorThread(const uInt8* atari_in, uInt32 in_width,
     ATARI_NTSC_RGB_OUT_8888(6, line_out[6])
 #endif
 
-    // Do phosphor mode (blend the resulting frames)
-    // Note: The unrolled code assumed that AtariNTSC::outWidth(kTIAW) == outPitch == 565
-    // Now this got changed to 568 so the final 5 calculations got removed.
-    for (uInt32 x = AtariNTSC::outWidth(in_width) / 8; x; --x)
-    {
-      // Store back into displayed frame buffer (for next frame)
-      rgb_in[bufofs] = PhosphorHandler::getPixel(out[bufofs], rgb_in[bufofs]);
-      ++bufofs;
-      rgb_in[bufofs] = PhosphorHandler::getPixel(out[bufofs], rgb_in[bufofs]);
-      ++bufofs;
-      rgb_in[bufofs] = PhosphorHandler::getPixel(out[bufofs], rgb_in[bufofs]);
-      ++bufofs;
-      rgb_in[bufofs] = PhosphorHandler::getPixel(out[bufofs], rgb_in[bufofs]);
-      ++bufofs;
-      rgb_in[bufofs] = PhosphorHandler::getPixel(out[bufofs], rgb_in[bufofs]);
-      ++bufofs;
-      rgb_in[bufofs] = PhosphorHandler::getPixel(out[bufofs], rgb_in[bufofs]);
-      ++bufofs;
-      rgb_in[bufofs] = PhosphorHandler::getPixel(out[bufofs], rgb_in[bufofs]);
-      ++bufofs;
-      rgb_in[bufofs] = PhosphorHandler::getPixel(out[bufofs], rgb_in[bufofs]);
-      ++bufofs;
-    }
-    // finish final 565 % 8 = 5 pixels
-    /*rgb_in[bufofs] = PhosphorHandler::getPixel(out[bufofs], rgb_in[bufofs]);
-    ++bufofs;
-    rgb_in[bufofs] = PhosphorHandler::getPixel(out[bufofs], rgb_in[bufofs]);
-    ++bufofs;
-    rgb_in[bufofs] = PhosphorHandler::getPixel(out[bufofs], rgb_in[bufofs]);
-    ++bufofs;
-    rgb_in[bufofs] = PhosphorHandler::getPixel(out[bufofs], rgb_in[bufofs]);
-    ++bufofs;
-    rgb_in[bufofs] = PhosphorHandler::getPixel(out[bufofs], rgb_in[bufofs]);
-    ++bufofs;*/
-#if 0
-    rgb_in[bufofs] = PhosphorHandler::getPixel(out[bufofs], rgb_in[bufofs]);
-    ++bufofs;
-    rgb_in[bufofs] = PhosphorHandler::getPixel(out[bufofs], rgb_in[bufofs]);
-    ++bufofs;
-#endif
+    // Do phosphor mode (blend the resulting frames) and store back into
+    // displayed frame buffer (for next frame)
+    // Note: This assumes that AtariNTSC::outWidth(kTIAW) == outPitch == 568
+    myPhosphorRows.setStable(y, !PhosphorHandler::blendRow(
+        out + bufofs, rgb_in + bufofs, nullptr, blend_count));
+    bufofs += blend_count;
 
     atari_in += in_width;
     rgb_out = static_cast<char*>(rgb_out) + out_pitch;
   }
 }
 
+#if defined(ATARI_NTSC_SSE2)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void AtariNTSC::init(init_t& impl, const Setup& setup)
+uInt32* AtariNTSC::renderChunksSIMD(const uInt8*& line_in, uInt32* line_out,
+    uInt32 chunk_count, uInt32 const*& kernel0, uInt32 const*& kernel1,
+    uInt32 const*& kernelx0, uInt32 const*& kernelx1) const
 {
-  impl.artifacts = setup.artifacts;
-  if ( impl.artifacts > 0 )
-    impl.artifacts *= artifacts_max - artifacts_mid;
-  impl.artifacts = impl.artifacts * artifacts_mid + artifacts_mid;
+  const __m128i clamp_mask = _mm_set1_epi32(atari_ntsc_clamp_mask);
+  const __m128i clamp_add  = _mm_set1_epi32(atari_ntsc_clamp_add);
+  const __m128i mask_r = _mm_set1_epi32(0x00FF0000);
+  const __m128i mask_g = _mm_set1_epi32(0x0000FF00);
+  const __m128i mask_b = _mm_set1_epi32(0x000000FF);
+
+  // Vector version of ATARI_NTSC_CLAMP and the 8888 packing
+  const auto clampAndPack = [&](__m128i raw) {
+    const __m128i sub = _mm_and_si128(_mm_srli_epi32(raw, 9), clamp_mask);
+    __m128i clamp = _mm_sub_epi32(clamp_add, sub);
+    raw = _mm_or_si128(raw, clamp);
+    clamp = _mm_sub_epi32(clamp, sub);
+    raw = _mm_and_si128(raw, clamp);
+
+    return _mm_or_si128(
+      _mm_or_si128(_mm_and_si128(_mm_srli_epi32(raw, 5), mask_r),
+                   _mm_and_si128(_mm_srli_epi32(raw, 3), mask_g)),
+      _mm_and_si128(_mm_srli_epi32(raw, 1), mask_b));
+  };
+  const auto load = [](uInt32 const* ptr) {
+    return _mm_loadu_si128(reinterpret_cast<const __m128i*>(ptr));
+  };
+
+  for(uInt32 n = chunk_count; n; --n)
+  {
+    // Output pixels 0..3 (see ATARI_NTSC_RGB_OUT_8888 for the indices)
+    kernelx0 = kernel0;
+    kernel0 = myColorTable[line_in[0]].data();
+    const __m128i raw0 = _mm_add_epi32(
+      _mm_add_epi32(load(kernel0), load(kernel1 + 17)),
+      _mm_add_epi32(load(kernelx0 + 7), load(kernelx1 + 24)));
+
+    // Output pixels 4..6; the 4th lane is overwritten by the next chunk
+    kernelx1 = kernel1;
+    kernel1 = myColorTable[line_in[1]].data();
+    const __m128i raw1 = _mm_add_epi32(
+      _mm_add_epi32(load(kernel0 + 4), load(kernel1 + 14)),
+      _mm_add_epi32(load(kernelx0 + 11), load(kernelx1 + 21)));
+
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(line_out), clampAndPack(raw0));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(line_out + 4), clampAndPack(raw1));
+
+    line_in += 2;
+    line_out += 7;
+  }
+  return line_out;
+}
 
-  impl.fringing = setup.fringing;
-  if ( impl.fringing > 0 )
-    impl.fringing *= fringing_max - fringing_mid;
-  impl.fringing = impl.fringing * fringing_mid + fringing_mid;
+#elif defined(ATARI_NTSC_NEON)
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt32* AtariNTSC::renderChunksSIMD(const uInt8*& line_in, uInt32* line_out,
+    uInt32 chunk_count, uInt32 const*& kernel0, uInt32 const*& kernel1,
+    uInt32 const*& kernelx0, uInt32 const*& kernelx1) const
+{
+  const uint32x4_t clamp_mask = vdupq_n_u32(atari_ntsc_clamp_mask);
+  const uint32x4_t clamp_add  = vdupq_n_u32(atari_ntsc_clamp_add);
+  const uint32x4_t mask_r = vdupq_n_u32(0x00FF0000);
+  const uint32x4_t mask_g = vdupq_n_u32(0x0000FF00);
+  const uint32x4_t mask_b = vdupq_n_u32(0x000000FF);
+
+  // Vector version of ATARI_NTSC_CLAMP and the 8888 packing
+  const auto clampAndPack = [&](uint32x4_t raw) {
+    const uint32x4_t sub = vandq_u32(vshrq_n_u32(raw, 9), clamp_mask);
+    uint32x4_t clamp = vsubq_u32(clamp_add, sub);
+    raw = vorrq_u32(raw, clamp);
+    clamp = vsubq_u32(clamp, sub);
+    raw = vandq_u32(raw, clamp);
+
+    return vorrq_u32(
+      vorrq_u32(vandq_u32(vshrq_n_u32(raw, 5), mask_r),
+                vandq_u32(vshrq_n_u32(raw, 3), mask_g)),
+      vandq_u32(vshrq_n_u32(raw, 1), mask_b));
+  };
+
+  for(uInt32 n = chunk_count; n; --n)
+  {
+    // Output pixels 0..3 (see ATARI_NTSC_RGB_OUT_8888 for the indices)
+    kernelx0 = kernel0;
+    kernel0 = myColorTable[line_in[0]].data();
+    const uint32x4_t raw0 = vaddq_u32(
+      vaddq_u32(vld1q_u32(kernel0), vld1q_u32(kernel1 + 17)),
+      vaddq_u32(vld1q_u32(kernelx0 + 7), vld1q_u32(kernelx1 + 24)));
+
+    // Output pixels 4..6; the 4th lane is overwritten by the next chunk
+    kernelx1 = kernel1;
+    kernel1 = myColorTable[line_in[1]].data();
+    const uint32x4_t raw1 = vaddq_u32(
+      vaddq_u32(vld1q_u32(kernel0 + 4), vld1q_u32(kernel1 + 14)),
+      vaddq_u32(vld1q_u32(kernelx0 + 11), vld1q_u32(kernelx1 + 21)));
+
+    vst1q_u32(line_out, clampAndPack(raw0));
+    vst1q_u32(line_out + 4, clampAndPack(raw1));
+
+    line_in += 2;
+    line_out += 7;
+  }
+  return line_out;
+}
+#endif
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void AtariNTSC::init(init_t& impl, const Setup& setup)
+{
+  initArtifacts(impl, setup);
   initFilters(impl, setup);
 
   /* setup decoder matricies */
@@ -361,6 +488,20 @@ void AtariNTSC::init(init_t& impl, const Setup& setup)
   }
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void AtariNTSC::initArtifacts(init_t& impl, const Setup& setup)
+{
+  impl.artifacts = setup.artifacts;
+  if ( impl.artifacts > 0 )
+    impl.artifacts *= artifacts_max - artifacts_mid;
+  impl.artifacts = impl.artifacts * artifacts_mid + artifacts_mid;
+
+  impl.fringing = setup.fringing;
+  if ( impl.fringing > 0 )
+    impl.fringing *= fringing_max - fringing_mid;
+  impl.fringing = impl.fringing * fringing_mid + fringing_mid;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void AtariNTSC::initFilters(init_t& impl, const Setup& setup)
 {
@@ -41,16 +41,18 @@
 #define ATARI_NTSC_HXX
 
 #include <cmath>
-#include <thread>
+
+class ThreadPool;
 
 #include "FrameBufferConstants.hxx"
+#include "PhosphorHandler.hxx"
 #include "bspf.hxx"
 
 class AtariNTSC
 {
   public:
     // By default, threading is turned off and palette is blank
-    AtariNTSC() { enableThreading(false); myRGBPalette.fill(0); }
+    AtariNTSC() { enableSIMD(true); myRGBPalette.fill(0); }
 
     // Image parameters, ranging from -1.0 to 1.0. Actual internal values shown
     // in parenthesis and should remain fairly stable in future versions.
@@ -64,6 +66,8 @@ class AtariNTSC
       float artifacts{0.F};  // artifacts caused by color changes
       float fringing{0.F};   // color artifacts caused by brightness changes
       float bleed{0.F};      // color bleed (color resolution reduction)
+
+      bool operator==(const Setup&) const = default;
     };
 
     // Video format presets
@@ -80,22 +84,42 @@ class AtariNTSC
       0.2F, 0.1F, 0.5F, 0.5F, 0.5F
     };
 
-    // Initializes and adjusts parameters
+    // Initializes and adjusts parameters; only the stages affected by
+    // changed parameters are recalculated
     // Note that this must be called before setting a palette
     void initialize(const Setup& setup);
 
     // Set palette for normal Blarrg mode
     void setPalette(const PaletteArray& palette);
 
-    // Set up threading
-    void enableThreading(bool enable);
+    // Set up threading; the rows are rendered in stripes by the given
+    // pool (nullptr disables threading)
+    void setThreadPool(ThreadPool* pool) { myThreadPool = pool; }
+
+    // The phosphor buffer passed to render() has been modified externally,
+    // so all rows must be blended again
+    void invalidatePhosphor() { myPhosphorRows.invalidate(); }
+
+    // Number of bytes used by the kernels of recently used palettes and
+    // setups (the current kernels are part of the object)
+    size_t memoryUsage() const {
+      return myKernelCache.capacity() * sizeof(unique_ptr<CachedKernels>) +
+             myKernelCache.size() * sizeof(CachedKernels);
+    }
+
+    // Use SIMD instructions (SSE2 or NEON) for rendering, if available for
+    // the target platform; otherwise the (reference) scalar code is used
+    void enableSIMD(bool enable);
 
     // Filters one or more rows of pixels. Input pixels are 8-bit Atari
     // palette colors.
     //  In_row_width is the number of pixels to get to the next input row.
     //  Out_pitch is the number of *bytes* to get to the next output row.
+    //  Rgb_in enables phosphor blending, which requires the line_hashes of
+    //  the input rows (see TIA::frameBufferLineHashes) as well.
     void render(const uInt8* atari_in, uInt32 in_width, uInt32 in_height,
-                void* rgb_out, uInt32 out_pitch, uInt32* rgb_in = nullptr);
+                void* rgb_out, uInt32 out_pitch, uInt32* rgb_in = nullptr,
+                const uInt64* line_hashes = nullptr);
 
     // Number of output pixels written by blitter for given input width.
     // Width might be rounded down slightly; use inWidth() on result to
@@ -113,7 +137,14 @@ class AtariNTSC
       uInt32 numThreads, uInt32 threadNum, void* rgb_out, uInt32 out_pitch);
     void renderWithPhosphorThread(const uInt8* atari_in, uInt32 in_width,
       uInt32 in_height, uInt32 numThreads, uInt32 threadNum, uInt32* rgb_in,
-      void* rgb_out, uInt32 out_pitch);
+      const uInt64* line_hashes, void* rgb_out, uInt32 out_pitch);
+
+    // Render all complete chunks of a row, same as the scalar ATARI_NTSC_xxx
+    // code, but generating four output pixels at once. Returns the advanced
+    // output pointer.
+    uInt32* renderChunksSIMD(const uInt8*& line_in, uInt32* line_out,
+      uInt32 chunk_count, uInt32 const*& kernel0, uInt32 const*& kernel1,
+      uInt32 const*& kernelx0, uInt32 const*& kernelx1) const;
 
   private:
     static constexpr Int32
@@ -157,10 +188,21 @@ class AtariNTSC
     std::array<uInt8, palette_size * 3L> myRGBPalette{};
     BSPF::array2D<uInt32, palette_size, entry_size> myColorTable{};
 
-    // Rendering threads
-    unique_ptr<std::thread[]> myThreads;
-    // Number of rendering and total threads
-    uInt32 myWorkerThreads{0}, myTotalThreads{0};
+    // Kernels of recently used palettes and setups, most recently used first
+    static constexpr size_t KERNEL_CACHE_SIZE = 8;
+    struct CachedKernels {
+      Setup setup;
+      std::array<uInt8, palette_size * 3L> palette;
+      BSPF::array2D<uInt32, palette_size, entry_size> table;
+    };
+    vector<unique_ptr<CachedKernels>> myKernelCache;
+
+    // Rendering threads (owned by the caller)
+    ThreadPool* myThreadPool{nullptr};
+    // Use SIMD rendering code
+    bool mySIMD{false};
+    // Rows which are unchanged in phosphor mode
+    PhosphorHandler::DirtyRows myPhosphorRows;
 
     struct init_t
     {
@@ -176,6 +218,9 @@ class AtariNTSC
       }
     };
     init_t myImpl;
+    // The setup myImpl was initialized with
+    Setup mySetup;
+    bool myInitialized{false};
 
     // Converted from C-style macros; I don't even pretend to understand the logic here :)
     static constexpr int PIXEL_OFFSET1( int ntsc, int scaled ) {
@@ -205,7 +250,9 @@ class AtariNTSC
     };
 
     static void init(init_t& impl, const Setup& setup);
+    // The filters depend on sharpness, resolution and bleed only
     static void initFilters(init_t& impl, const Setup& setup);
+    static void initArtifacts(init_t& impl, const Setup& setup);
     // Generate pixel at all burst phases and column alignments
     static void genKernel(init_t& impl, float y, float i, float q, uInt32* out);
 
@@ -113,15 +113,29 @@ class NTSCFilter
       myNTSC.render(src_buf, src_width, src_height, dest_buf, dest_pitch);
     }
     void render(const uInt8* src_buf, uInt32 src_width, uInt32 src_height,
-                uInt32* dest_buf, uInt32 dest_pitch, uInt32* prev_buf)
+                uInt32* dest_buf, uInt32 dest_pitch, uInt32* prev_buf,
+                const uInt64* line_hashes)
     {
-      myNTSC.render(src_buf, src_width, src_height, dest_buf, dest_pitch, prev_buf);
+      myNTSC.render(src_buf, src_width, src_height, dest_buf, dest_pitch,
+                    prev_buf, line_hashes);
     }
 
-    // Enable threading for the NTSC rendering
-    void enableThreading(bool enable)
+    // Set the threads used for the NTSC rendering (nullptr disables threading)
+    void setThreadPool(ThreadPool* pool)
     {
-      myNTSC.enableThreading(enable);
+      myNTSC.setThreadPool(pool);
+    }
+
+    // The phosphor buffer has been modified, so all rows must be blended
+    void invalidatePhosphor()
+    {
+      myNTSC.invalidatePhosphor();
+    }
+
+    // Number of bytes used by the filter, including its kernels
+    size_t memoryUsage() const
+    {
+      return sizeof(NTSCFilter) + myNTSC.memoryUsage();
     }
 
   private:
@@ -25,6 +25,7 @@ void BreakpointMap::add(const Breakpoint& breakpoint, uInt32 flags)
 
   myInitialized = true;
   myMap[bp] = flags;
+  myAddresses.set(bp.addr & ADDRESS_MASK);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -44,6 +45,13 @@ void BreakpointMap::erase(const Breakpoint& breakpoint)
 
     myMap.erase(bp13);
   }
+
+  // Other banks might still use the same address
+  const uInt16 addr = breakpoint.addr & ADDRESS_MASK;
+  myAddresses.reset(addr);
+  for(const auto& [bp, flags]: myMap)
+    if((bp.addr & ADDRESS_MASK) == addr)
+      myAddresses.set(addr);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -55,6 +63,9 @@ void BreakpointMap::erase(uInt16 addr, uInt8 bank)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 uInt32 BreakpointMap::get(const Breakpoint& breakpoint) const
 {
+  if(!myAddresses.test(breakpoint.addr & ADDRESS_MASK))
+    return 0;
+
   // 16 bit breakpoint
   auto find = myMap.find(breakpoint);
   if(find != myMap.end())
@@ -79,6 +90,9 @@ uInt32 BreakpointMap::get(uInt16 addr, uInt8 bank) const
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool BreakpointMap::check(const Breakpoint& breakpoint) const
 {
+  if(!myAddresses.test(breakpoint.addr & ADDRESS_MASK))
+    return false;
+
   // 16 bit breakpoint
   auto find = myMap.find(breakpoint);
   if(find != myMap.end())
@@ -18,6 +18,7 @@
 #ifndef BREAKPOINT_HXX
 #define BREAKPOINT_HXX
 
+#include <bitset>
 #include <unordered_map>
 
 #include "bspf.hxx"
@@ -87,7 +88,7 @@ class BreakpointMap
     BreakpointList getBreakpoints() const;
 
     /** clear all breakpoints */
-    void clear() { myMap.clear(); }
+    void clear() { myMap.clear(); myAddresses.reset(); }
     size_t size() const { return myMap.size(); }
 
   private:
@@ -102,6 +103,9 @@ class BreakpointMap
     };
 
     std::unordered_map<Breakpoint, uInt32, BreakpointHash> myMap;
+    // Pre-filter for check()/get(), which are called for every instruction;
+    // a bit is set if any breakpoint (in any bank) maps to the 13 bit address
+    std::bitset<ADDRESS_MASK + 1> myAddresses;
     bool myInitialized{false};
 
     // Following constructors and assignment operators not supported
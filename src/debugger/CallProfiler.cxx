@@ -0,0 +1,210 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2026 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+
+#include <algorithm>
+#include <map>
+
+#include "CallProfiler.hxx"
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void CallProfiler::enable(bool enable)
+{
+  myEnabled = enable;
+  unwind();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void CallProfiler::reset()
+{
+  myNodes.assign(1, Node{});
+  myChildren.clear();
+  unwind();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void CallProfiler::unwind()
+{
+  myFrames.assign(1, Frame{ROOT, 0});
+  myLastCycles = 0;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void CallProfiler::enter(uInt16 addr, uInt8 bank, uInt8 returnSP)
+{
+  // Code which never returns (e.g. JSR used to push an address) would
+  // grow the stack forever
+  if(myFrames.size() == MAX_DEPTH)
+    return;
+
+  const uInt32 parent = myFrames.back().node;
+  const uInt32 routine = (static_cast<uInt32>(bank) << 16) | addr;
+  const auto [it, inserted] = myChildren.try_emplace(
+    (static_cast<uInt64>(parent) << 32) | routine,
+    static_cast<uInt32>(myNodes.size()));
+
+  if(inserted)
+    myNodes.emplace_back(routine, parent);
+
+  ++myNodes[it->second].calls;
+  myFrames.emplace_back(it->second, returnSP);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+vector<uInt64> CallProfiler::inclusiveCycles() const
+{
+  vector<uInt64> inclusive(myNodes.size());
+
+  // Children are always created after their parents
+  for(size_t i = myNodes.size() - 1; i > 0; --i)
+  {
+    inclusive[i] += myNodes[i].self;
+    inclusive[myNodes[i].parent] += inclusive[i];
+  }
+  inclusive[ROOT] += myNodes[ROOT].self;
+
+  return inclusive;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+string CallProfiler::report(const NameFunction& name) const
+{
+  const vector<uInt64> inclusive = inclusiveCycles();
+  const uInt64 total = inclusive[ROOT];
+
+  if(total == 0)
+    return "no cycles profiled";
+
+  // Sum up the nodes of each routine; for recursive routines only the
+  // outermost call counts as inclusive
+  std::map<uInt32, Totals> totals;
+  for(uInt32 i = 1; i < myNodes.size(); ++i)
+  {
+    const Node& node = myNodes[i];
+    Totals& t = totals[node.routine];
+
+    t.exclusive += node.self;
+    t.calls += node.calls;
+
+    bool recursive = false;
+    for(uInt32 p = node.parent; p != ROOT && !recursive; p = myNodes[p].parent)
+      recursive = myNodes[p].routine == node.routine;
+    if(!recursive)
+      t.inclusive += inclusive[i];
+  }
+
+  vector<std::pair<uInt32, Totals>> sorted(totals.begin(), totals.end());
+  std::ranges::sort(sorted, [](const auto& a, const auto& b) {
+    return a.second.inclusive > b.second.inclusive;
+  });
+
+  std::ostringstream buf;
+  buf << std::format("{} cycles profiled\n", total)
+      << std::format("{:>7} {:>10} {:>7} {:>10} {:>8}  {}",
+                     "incl%", "inclusive", "excl%", "exclusive", "calls", "routine")
+      << std::format("\n{:>6.2f}% {:>10} {:>6.2f}% {:>10} {:>8}  {}",
+                     100., total, myNodes[ROOT].self * 100. / total,
+                     myNodes[ROOT].self, "", "[top]");
+
+  for(const auto& [routine, t]: sorted)
+    buf << std::format("\n{:>6.2f}% {:>10} {:>6.2f}% {:>10} {:>8}  {}",
+                       t.inclusive * 100. / total, t.inclusive,
+                       t.exclusive * 100. / total, t.exclusive, t.calls,
+                       name(static_cast<uInt16>(routine),
+                            static_cast<uInt8>(routine >> 16)));
+
+  return buf.str();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+string CallProfiler::callGraph(const NameFunction& name) const
+{
+  const vector<uInt64> inclusive = inclusiveCycles();
+  const double total = std::max<uInt64>(inclusive[ROOT], 1);
+
+  // Routines and edges (caller << 32 | callee), the root is routine ~0
+  constexpr uInt64 TOP = 0xFFFFFFFF;
+  std::map<uInt64, Totals> routines, edges;
+
+  routines[TOP].inclusive = inclusive[ROOT];
+  routines[TOP].exclusive = myNodes[ROOT].self;
+  for(uInt32 i = 1; i < myNodes.size(); ++i)
+  {
+    const Node& node = myNodes[i];
+    const uInt64 caller = node.parent == ROOT ? TOP : myNodes[node.parent].routine;
+    Totals& r = routines[node.routine];
+    Totals& e = edges[(caller << 32) | node.routine];
+
+    r.inclusive += inclusive[i];
+    r.exclusive += node.self;
+    e.inclusive += inclusive[i];
+    e.calls += node.calls;
+  }
+
+  const auto label = [&](uInt64 routine) {
+    return routine == TOP ? string{"[top]"}
+      : name(static_cast<uInt16>(routine), static_cast<uInt8>(routine >> 16));
+  };
+
+  std::ostringstream buf;
+  buf << "digraph calls {\n"
+      << "  node [shape=box];\n";
+  for(const auto& [routine, r]: routines)
+    buf << std::format("  n{:x} [label=\"{}\\n{:.2f}% ({:.2f}%)\"];\n",
+                       routine, label(routine), r.inclusive * 100. / total,
+                       r.exclusive * 100. / total);
+  for(const auto& [edge, e]: edges)
+    buf << std::format("  n{:x} -> n{:x} [label=\"{}x\\n{:.2f}%\"];\n",
+                       edge >> 32, edge & TOP, e.calls,
+                       e.inclusive * 100. / total);
+  buf << "}\n";
+
+  return buf.str();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+string CallProfiler::collapsedStacks(const NameFunction& name) const
+{
+  std::unordered_map<uInt32, string> names;
+  const auto cachedName = [&](uInt32 routine) -> const string& {
+    auto it = names.find(routine);
+    if(it == names.end())
+      it = names.emplace(routine, name(static_cast<uInt16>(routine),
+                                       static_cast<uInt8>(routine >> 16))).first;
+    return it->second;
+  };
+
+  std::ostringstream buf;
+  vector<uInt32> path;
+
+  for(uInt32 i = 0; i < myNodes.size(); ++i)
+  {
+    if(myNodes[i].self == 0)
+      continue;
+
+    path.clear();
+    for(uInt32 n = i; n != ROOT; n = myNodes[n].parent)
+      path.push_back(n);
+
+    buf << "[top]";
+    for(auto it = path.rbegin(); it != path.rend(); ++it)
+      buf << ';' << cachedName(myNodes[*it].routine);
+    buf << ' ' << myNodes[i].self << '\n';
+  }
+
+  return buf.str();
+}
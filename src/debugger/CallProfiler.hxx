@@ -0,0 +1,162 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2026 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+
+#ifndef CALL_PROFILER_HXX
+#define CALL_PROFILER_HXX
+
+#include <functional>
+#include <unordered_map>
+
+#include "bspf.hxx"
+
+/**
+  This class attributes the CPU cycles to the 6502 routines, by following
+  the JSR/RTS (and BRK/RTI) frames.  The cycles are collected in a calling
+  context tree, from which the inclusive and exclusive cycles per routine,
+  the call graph and the collapsed stacks (for flame graphs) are created.
+
+  Returns are matched by the stack pointer, so that routines which drop
+  their return address (or reset the stack) are unwound correctly, and
+  RTS used as an indirect jump is not mistaken for a return.
+
+  The profiler is only fed by the debugger execution engine of M6502, so
+  it costs nothing while disabled.
+
+  @author  Stella Team
+*/
+class CallProfiler
+{
+  public:
+    // Names a routine by its start address and bank
+    using NameFunction = std::function<string(uInt16 addr, uInt8 bank)>;
+
+  public:
+    CallProfiler() { reset(); }
+    ~CallProfiler() = default;
+
+    void enable(bool enable);
+    bool isEnabled() const { return myEnabled; }
+
+    /**
+      Discard all collected cycles and calls.
+    */
+    void reset();
+
+    /**
+      Discard the open frames, which are invalid after e.g. loading a state.
+    */
+    void unwind();
+
+    /**
+      Called after each executed instruction.
+
+      @param opcode  The opcode of the instruction
+      @param pc      The PC after the instruction
+      @param bank    The bank of the PC (only needed for JSR and BRK)
+      @param sp      The stack pointer after the instruction
+      @param cycles  The system cycles after the instruction
+    */
+    void step(uInt8 opcode, uInt16 pc, uInt8 bank, uInt8 sp, uInt64 cycles) {
+      if(myLastCycles)
+        myNodes[myFrames.back().node].self += cycles - myLastCycles;
+      myLastCycles = cycles;
+
+      switch(opcode)
+      {
+        case 0x20:  // JSR
+          enter(pc, bank, static_cast<uInt8>(sp + 2));
+          break;
+        case 0x00:  // BRK
+          enter(pc, bank, static_cast<uInt8>(sp + 3));
+          break;
+        case 0x60:  // RTS
+        case 0x40:  // RTI
+        case 0x9A:  // TXS
+          leave(sp);
+          break;
+        default:
+          break;
+      }
+    }
+
+    /**
+      Answer the table of the inclusive and exclusive cycles per routine,
+      ordered by inclusive cycles.
+    */
+    string report(const NameFunction& name) const;
+
+    /**
+      Answer the call graph in Graphviz DOT format.
+    */
+    string callGraph(const NameFunction& name) const;
+
+    /**
+      Answer the calling contexts in collapsed stack format.
+    */
+    string collapsedStacks(const NameFunction& name) const;
+
+  private:
+    // A node of the calling context tree
+    struct Node {
+      uInt32 routine{0};  // bank << 16 | address
+      uInt32 parent{0};
+      uInt64 self{0};
+      uInt64 calls{0};
+    };
+    struct Frame {
+      uInt32 node{0};
+      uInt8 returnSP{0};  // the stack pointer after returning
+    };
+    struct Totals {
+      uInt64 inclusive{0};
+      uInt64 exclusive{0};
+      uInt64 calls{0};
+    };
+
+    static constexpr uInt32 ROOT = 0;
+    static constexpr size_t MAX_DEPTH = 64;
+
+  private:
+    void enter(uInt16 addr, uInt8 bank, uInt8 returnSP);
+    void leave(uInt8 sp) {
+      while(myFrames.size() > 1 && sp >= myFrames.back().returnSP)
+        myFrames.pop_back();
+    }
+
+    // Inclusive cycles of all nodes
+    vector<uInt64> inclusiveCycles() const;
+
+  private:
+    bool myEnabled{false};
+
+    vector<Node> myNodes;
+    // Child nodes, by parent node << 32 | routine
+    std::unordered_map<uInt64, uInt32> myChildren;
+    vector<Frame> myFrames;
+
+    uInt64 myLastCycles{0};
+
+  private:
+    // Following constructors and assignment operators not supported
+    CallProfiler(const CallProfiler&) = delete;
+    CallProfiler(CallProfiler&&) = delete;
+    CallProfiler& operator=(const CallProfiler&) = delete;
+    CallProfiler& operator=(CallProfiler&&) = delete;
+};
+
+#endif // CALL_PROFILER_HXX
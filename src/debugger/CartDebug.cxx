@@ -33,6 +33,7 @@
 #include "RomWidget.hxx"
 #include "Base.hxx"
 #include "Device.hxx"
+#include "ThreadPool.hxx"
 #include "TIA.hxx"
 #include "M6532.hxx"
 
@@ -241,7 +242,7 @@ string CartDebug::toString()
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool CartDebug::disassembleAddr(uInt16 address, bool force)
 {
-  const Cartridge& cart = myConsole.cartridge();
+  Cartridge& cart = myConsole.cartridge();
   const int segCount = cart.segmentCount();
   // ROM/RAM bank or ZP-RAM?
   const int addrBank = (address & 0x1000)
@@ -254,35 +255,68 @@ bool CartDebug::disassembleAddr(uInt16 address, bool force)
     // else the lineOfs in fillDisassemblyList will be too large
     myDisassembly.list.clear();
     myAddrToLineList.clear();
+    mySegmentCache.resize(segCount);
+    // Bank changes are detected per segment below
+    cart.bankChanged();
 
     myDisassembly.fieldwidth = 24;
     for(int seg = 0; seg < segCount; ++seg)
     {
       const int bank = cart.getSegmentBank(seg);
-      Disassembly disassembly;
-      AddrToLineList addrToLineList;
+      SegmentDisassembly& segment = mySegmentCache[seg];
       BankInfo& info = myBankInfo[bank];
+      const auto lineOfs = static_cast<int>(myDisassembly.list.size());
 
       info.offset = cart.bankOrigin(bank) | cart.bankSize() * seg;
-      const uInt16 segAddress = bank == addrBank ? address : info.offset;
-      // Disassemble segment
-      changed |= disassemble(bank, segAddress, disassembly, addrToLineList, force);
 
-       // Add extra empty line between segments
+      // Only disassemble the segment again if it might have changed,
+      // or if it doesn't contain the (new) address yet
+      const uInt16 segStart = 0x1000 + cart.bankSize() * seg;
+      bool valid = !force && segment.bank == bank &&
+                   !mySystem.isPageDirty(segStart, segStart + cart.bankSize() - 1);
+      if(valid && bank == addrBank)
+      {
+        const auto line = segment.addrToLineList.find(address & 0xFFF);
+        valid = line != segment.addrToLineList.end() &&
+                segment.disassembly.list[line->second].disasm[0] != '.';
+      }
+
+      if(!valid)
+      {
+        const uInt16 segAddress = bank == addrBank ? address : info.offset;
+        Disassembly disassembly;
+        AddrToLineList addrToLineList;
+
+        // Disassemble segment
+        const bool disassembled =
+          disassemble(bank, segAddress, disassembly, addrToLineList, true);
+
+        segment.bank = disassembled ? bank : -1;
+        segment.disassembly = std::move(disassembly);
+        segment.addrToLineList.clear();
+        for(const auto& [addr, line]: addrToLineList)
+          segment.addrToLineList.emplace(addr, line - lineOfs);
+        changed |= disassembled;
+      }
+
+      // Aggregate segment disassemblies
+      myDisassembly.list.insert(myDisassembly.list.end(),
+                                segment.disassembly.list.begin(),
+                                segment.disassembly.list.end());
+      myDisassembly.fieldwidth = std::max(myDisassembly.fieldwidth,
+                                          segment.disassembly.fieldwidth);
+      for(const auto& [addr, line]: segment.addrToLineList)
+        myAddrToLineList.emplace(addr, line + lineOfs);
+
+      // Add extra empty line between segments
       if(seg < segCount - 1)
       {
         CartDebug::DisassemblyTag tag;
         tag.address = 0;
         tag.disasm = " ";
-        disassembly.list.push_back(tag);
-        addrToLineList.emplace(0, static_cast<uInt32>(disassembly.list.size() +
-                               myDisassembly.list.size()) - 1);
+        myDisassembly.list.push_back(tag);
+        myAddrToLineList.emplace(0, static_cast<int>(myDisassembly.list.size()) - 1);
       }
-      // Aggregate segment disassemblies
-      myDisassembly.list.insert(myDisassembly.list.end(),
-                                disassembly.list.begin(), disassembly.list.end());
-      myDisassembly.fieldwidth = std::max(myDisassembly.fieldwidth, disassembly.fieldwidth);
-      myAddrToLineList.insert(addrToLineList.begin(), addrToLineList.end());
     }
     return changed;
   }
@@ -324,34 +358,10 @@ bool CartDebug::disassemble(int bank, uInt16 PC, Disassembly& disassembly,
       //(PC & 0x1000) ? myBankInfo[getBank(PC)] :
         //myBankInfo[myBankInfo.size()-1];
 
-    // If the offset has changed, all old addresses must be 'converted'
-    // For example, if the list contains any $fxxx and the address space is now
-    // $bxxx, it must be changed
-    const uInt16 offset = (PC & 0x1000) ? myConsole.cartridge().bankOrigin(bank, PC) : 0;
-    if (offset && info.offset == 0)
-      info.offset = offset;
-    AddressList& addresses = info.addressList;
-    for(auto& i: addresses)
-      i = (i & 0xFFF) + offset;
-
     // Only add addresses when absolutely necessary, to cut down on the
     // work that Distella has to do
-    if(bankChanged || !pcfound)
-    {
-      AddressList::const_iterator i;
-      for(i = addresses.cbegin(); i != addresses.cend(); ++i)
-      {
-        if(PC == *i)  // already present
-          break;
-      }
-      // Otherwise, add the item at the end
-      if(i == addresses.end())
-      {
-        addresses.push_back(PC);
-        if(!DiStella::settings.resolveCode)
-          addDirective(Device::AccessType::CODE, PC, PC, bank);
-      }
-    }
+    prepareAddressList(bank, PC, bankChanged || !pcfound);
+
     // Always attempt to resolve code sections unless it's been
     // specifically disabled
     const bool found = fillDisassemblyList(info, disassembly, addrToLineList, PC);
@@ -366,6 +376,39 @@ bool CartDebug::disassemble(int bank, uInt16 PC, Disassembly& disassembly,
   return changed;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void CartDebug::prepareAddressList(int bank, uInt16 PC, bool addPC)
+{
+  BankInfo& info = myBankInfo[bank];
+
+  // If the offset has changed, all old addresses must be 'converted'
+  // For example, if the list contains any $fxxx and the address space is now
+  // $bxxx, it must be changed
+  const uInt16 offset = (PC & 0x1000) ? myConsole.cartridge().bankOrigin(bank, PC) : 0;
+  if (offset && info.offset == 0)
+    info.offset = offset;
+  AddressList& addresses = info.addressList;
+  for(auto& i: addresses)
+    i = (i & 0xFFF) + offset;
+
+  if(addPC)
+  {
+    AddressList::const_iterator i;
+    for(i = addresses.cbegin(); i != addresses.cend(); ++i)
+    {
+      if(PC == *i)  // already present
+        break;
+    }
+    // Otherwise, add the item at the end
+    if(i == addresses.end())
+    {
+      addresses.push_back(PC);
+      if(!DiStella::settings.resolveCode)
+        addDirective(Device::AccessType::CODE, PC, PC, bank);
+    }
+  }
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool CartDebug::fillDisassemblyList(BankInfo& info, Disassembly& disassembly,
                                     AddrToLineList& addrToLineList, uInt16 search)
@@ -624,6 +667,7 @@ bool CartDebug::addLabel(const string& label, uInt16 address)
       myUserLabels.emplace(address, newLabel);
       myLabelLength = std::max(myLabelLength, static_cast<uInt16>(newLabel.size()));
       mySystem.setDirtyPage(address);
+      ++myLabelGeneration;
       return true;
   }
 }
@@ -656,6 +700,7 @@ bool CartDebug::removeLabel(const string& label)
     // Erase the label itself
     mySystem.setDirtyPage(iter->second);
     myUserAddresses.erase(iter);
+    ++myLabelGeneration;
 
     return true;
   }
@@ -873,6 +918,7 @@ string CartDebug::loadSymbolFile()
 
   myUserAddresses.clear();
   myUserLabels.clear();
+  ++myLabelGeneration;
 
   std::stringstream in;
   try
@@ -1108,117 +1154,199 @@ string CartDebug::saveDisassembly(string path)
   settings.bytesWidth = 8+1;  // same as Stella debugger
   settings.bFlag = DiStella::settings.bFlag; // process break routine (TODO)
 
-  Disassembly disasm;
-  disasm.list.reserve(2048);
   Cartridge& cart = myConsole.cartridge();
   const uInt16 romBankCount = cart.romBankCount();
   const uInt16 oldBank = cart.getBank();
 
-  // prepare for switching banks
-  uInt32 origin = 0;
-
-  for(int bank = 0; std::cmp_less(bank, romBankCount); ++bank)
+  const auto switchBank = [&](int bank)
   {
     // TODO: not every CartDebugWidget does it like that, we need a method
     cart.unlockHotspots();
     cart.bank(bank);
     cart.lockHotspots();
+  };
 
-    BankInfo& info = myBankInfo[bank];
+  // The banks are independent, so they are disassembled in parallel from
+  // snapshots of the address space; only switching banks and applying the
+  // results to the System is done serially
+  struct BankJob {
+    DiStella::Snapshot snapshot;
+    ReservedEquates reserved;
+    string text;
+  };
+  vector<unique_ptr<BankJob>> jobs(romBankCount);
 
-    disassembleBank(bank);
+  for(int bank = 0; std::cmp_less(bank, romBankCount); ++bank)
+  {
+    switchBank(bank);
+    prepareAddressList(bank, 0xFFFF, true);
 
     // An empty address list means that DiStella can't do a disassembly
-    if(info.addressList.empty())
+    if(myBankInfo[bank].addressList.empty())
       continue;
 
-    buf << "\n\n;***********************************************************\n"
-      << ";      Bank " << bank;
-    if (romBankCount > 1)
-      buf << " / 0.." << romBankCount - 1;
-    buf << "\n;***********************************************************\n\n";
+    jobs[bank] = std::make_unique<BankJob>();
+    jobs[bank]->snapshot.take();
+  }
 
-    // Disassemble bank
-    disasm.list.clear();
-    const DiStella distella(*this, disasm.list, info, settings,
-                            myDisLabels, myDisDirectives, myReserved);
+  ThreadPool pool(std::max(std::thread::hardware_concurrency(), 1U));
+  const auto disassembleBanks = [&](const vector<int>& banks)
+  {
+    pool.run(static_cast<uInt32>(banks.size()), [&](uInt32 job, uInt32)
+    {
+      BankJob& bankJob = *jobs[banks[job]];
+      DisassemblyList list;
+      AddrTypeArray labels, directives;
+
+      list.reserve(2048);
+      bankJob.snapshot.access.fill(Device::NONE);
+      bankJob.reserved = ReservedEquates{};
+
+      // Disassemble bank
+      const DiStella distella(*this, list, myBankInfo[banks[job]], settings,
+                              labels, directives, bankJob.reserved,
+                              &bankJob.snapshot);
+
+      std::ostringstream text;
+      // Format in 'distella' style
+      for(const auto& dt: list)
+      {
+        const DisassemblyTag& tag = dt;
 
-    if (myReserved.breakFound)
-      addLabel("Break", myDebugger.dpeek(0xfffe));
+        // Add label (if any)
+        if(!tag.label.empty())
+          text << ALIGN(4) << (tag.label) << "\n";
+        text << "    ";
 
-    buf << "    SEG     CODE\n";
+        switch(tag.type)
+        {
+          case Device::CODE:
+            text << ALIGN(32) << tag.disasm << tag.ccount.substr(0, 5) << tag.ctotal << tag.ccount.substr(5, 2);
+            if (tag.disasm.find("WSYNC") != std::string::npos)
+              text << "\n;---------------------------------------";
+            break;
+
+          case Device::ROW:
+            text << ".byte   " << ALIGN(32) << tag.disasm.substr(6, 8*4-1) << "; $" << Base::HEX4 << tag.address << " (*)";
+            break;
+
+          case Device::GFX:
+            text << ".byte   " << (settings.gfxFormat == Base::Fmt::_2 ? "%" : "$")
+                << tag.bytes << " ; |";
+            for(int c = 12; c < 20; ++c)
+              text << ((tag.disasm[c] == '\x1e') ? "#" : " ");
+            text << ALIGN(13) << "|" << "$" << Base::HEX4 << tag.address << " (G)";
+            break;
+
+          case Device::PGFX:
+            text << ".byte   " << (settings.gfxFormat == Base::Fmt::_2 ? "%" : "$")
+                << tag.bytes << " ; |";
+            for(int c = 12; c < 20; ++c)
+              text << ((tag.disasm[c] == '\x1f') ? "*" : " ");
+            text << ALIGN(13) << "|" << "$" << Base::HEX4 << tag.address << " (P)";
+            break;
+
+          case Device::COL:
+            text << ".byte   " << ALIGN(32) << tag.disasm.substr(6, 15) << "; $" << Base::HEX4 << tag.address << " (C)";
+            break;
+
+          case Device::PCOL:
+            text << ".byte   " << ALIGN(32) << tag.disasm.substr(6, 15) << "; $" << Base::HEX4 << tag.address << " (CP)";
+            break;
+
+          case Device::BCOL:
+            text << ".byte   " << ALIGN(32) << tag.disasm.substr(6, 15) << "; $" << Base::HEX4 << tag.address << " (CB)";
+            break;
+
+          case Device::AUD:
+            text << ".byte   " << ALIGN(32) << tag.disasm.substr(6, 8 * 4 - 1) << "; $" << Base::HEX4 << tag.address << " (A)";
+            break;
+
+          case Device::DATA:
+            text << ".byte   " << ALIGN(32) << tag.disasm.substr(6, 8 * 4 - 1) << "; $" << Base::HEX4 << tag.address << " (D)";
+            break;
+
+          case Device::NONE:
+          default:
+            break;
+        } // switch
+        text << "\n";
+      }
+      bankJob.text = text.str();
+    });
+  };
 
-    if(romBankCount == 1)
-      buf << "    ORG     $" << Base::HEX4 << info.offset << "\n\n";
-    else
-      buf << "    ORG     $" << Base::HEX4 << origin << "\n"
-          << "    RORG    $" << Base::HEX4 << info.offset << "\n\n";
-    origin += static_cast<uInt32>(info.size);
+  vector<int> banks;
+  for(int bank = 0; std::cmp_less(bank, romBankCount); ++bank)
+    if(jobs[bank])
+      banks.push_back(bank);
+  disassembleBanks(banks);
+
+  // A BRK adds a label for the break routine, which all following banks
+  // must be disassembled with; since this is rare, these banks are simply
+  // disassembled again
+  const size_t numLabels = myUserLabels.size();
+  banks.clear();
+  for(int bank = 0; std::cmp_less(bank, romBankCount); ++bank)
+  {
+    if(!jobs[bank])
+      continue;
 
-    // Format in 'distella' style
-    for(const auto& dt: disasm.list)
+    if(myUserLabels.size() != numLabels)
+      banks.push_back(bank);
+    if(jobs[bank]->reserved.breakFound)
     {
-      const DisassemblyTag& tag = dt;
-
-      // Add label (if any)
-      if(!tag.label.empty())
-        buf << ALIGN(4) << (tag.label) << "\n";
-      buf << "    ";
-
-      switch(tag.type)
-      {
-        case Device::CODE:
-          buf << ALIGN(32) << tag.disasm << tag.ccount.substr(0, 5) << tag.ctotal << tag.ccount.substr(5, 2);
-          if (tag.disasm.find("WSYNC") != std::string::npos)
-            buf << "\n;---------------------------------------";
-          break;
+      disassembleBanks(banks);
+      banks.clear();
+      switchBank(bank);
+      addLabel("Break", myDebugger.dpeek(0xfffe));
+    }
+  }
+  disassembleBanks(banks);
 
-        case Device::ROW:
-          buf << ".byte   " << ALIGN(32) << tag.disasm.substr(6, 8*4-1) << "; $" << Base::HEX4 << tag.address << " (*)";
-          break;
+  // Merge the results in bank order
+  const auto merge = [](auto& equates, const auto& bankEquates)
+  {
+    for(size_t i = 0; i < equates.size(); ++i)
+      equates[i] = equates[i] || bankEquates[i];
+  };
+  uInt32 origin = 0;
 
-        case Device::GFX:
-          buf << ".byte   " << (settings.gfxFormat == Base::Fmt::_2 ? "%" : "$")
-              << tag.bytes << " ; |";
-          for(int c = 12; c < 20; ++c)
-            buf << ((tag.disasm[c] == '\x1e') ? "#" : " ");
-          buf << ALIGN(13) << "|" << "$" << Base::HEX4 << tag.address << " (G)";
-          break;
+  for(int bank = 0; std::cmp_less(bank, romBankCount); ++bank)
+  {
+    if(!jobs[bank])
+      continue;
 
-        case Device::PGFX:
-          buf << ".byte   " << (settings.gfxFormat == Base::Fmt::_2 ? "%" : "$")
-              << tag.bytes << " ; |";
-          for(int c = 12; c < 20; ++c)
-            buf << ((tag.disasm[c] == '\x1f') ? "*" : " ");
-          buf << ALIGN(13) << "|" << "$" << Base::HEX4 << tag.address << " (P)";
-          break;
+    const BankJob& bankJob = *jobs[bank];
+    const BankInfo& info = myBankInfo[bank];
 
-        case Device::COL:
-          buf << ".byte   " << ALIGN(32) << tag.disasm.substr(6, 15) << "; $" << Base::HEX4 << tag.address << " (C)";
-          break;
+    switchBank(bank);
+    bankJob.snapshot.apply();
 
-        case Device::PCOL:
-          buf << ".byte   " << ALIGN(32) << tag.disasm.substr(6, 15) << "; $" << Base::HEX4 << tag.address << " (CP)";
-          break;
+    merge(myReserved.TIARead, bankJob.reserved.TIARead);
+    merge(myReserved.TIAWrite, bankJob.reserved.TIAWrite);
+    merge(myReserved.IOReadWrite, bankJob.reserved.IOReadWrite);
+    merge(myReserved.ZPRAM, bankJob.reserved.ZPRAM);
+    myReserved.Label.insert(bankJob.reserved.Label.begin(),
+                            bankJob.reserved.Label.end());
+    myReserved.breakFound = bankJob.reserved.breakFound;
 
-        case Device::BCOL:
-          buf << ".byte   " << ALIGN(32) << tag.disasm.substr(6, 15) << "; $" << Base::HEX4 << tag.address << " (CB)";
-          break;
+    buf << "\n\n;***********************************************************\n"
+      << ";      Bank " << bank;
+    if (romBankCount > 1)
+      buf << " / 0.." << romBankCount - 1;
+    buf << "\n;***********************************************************\n\n";
 
-        case Device::AUD:
-          buf << ".byte   " << ALIGN(32) << tag.disasm.substr(6, 8 * 4 - 1) << "; $" << Base::HEX4 << tag.address << " (A)";
-          break;
+    buf << "    SEG     CODE\n";
 
-        case Device::DATA:
-          buf << ".byte   " << ALIGN(32) << tag.disasm.substr(6, 8 * 4 - 1) << "; $" << Base::HEX4 << tag.address << " (D)";
-          break;
+    if(romBankCount == 1)
+      buf << "    ORG     $" << Base::HEX4 << info.offset << "\n\n";
+    else
+      buf << "    ORG     $" << Base::HEX4 << origin << "\n"
+          << "    RORG    $" << Base::HEX4 << info.offset << "\n\n";
+    origin += static_cast<uInt32>(info.size);
 
-        case Device::NONE:
-        default:
-          break;
-      } // switch
-      buf << "\n";
-    }
+    buf << bankJob.text;
   }
   cart.unlockHotspots();
   cart.bank(oldBank);
@@ -1446,6 +1574,7 @@ string CartDebug::saveAccessFile(string path)
 {
   string out;
   out.reserve(512);
+  myConsole.system().flushAccessCounters();
   out += myConsole.tia().getAccessCounters();
   out += myConsole.riot().getAccessCounters();
   out += myConsole.cartridge().getAccessCounters();
@@ -221,6 +221,12 @@ class CartDebug : public DebuggerSystem
                     int places = -1, bool isRam = false) const;
     int getAddress(string_view label) const;
 
+    /**
+      Answers a number which changes whenever user labels are added or
+      removed (e.g. to invalidate parsed expressions).
+    */
+    uInt32 labelGeneration() const { return myLabelGeneration; }
+
     /**
       Load constants from list file (as generated by DASM).
     */
@@ -324,6 +330,10 @@ class CartDebug : public DebuggerSystem
     bool disassemble(int bank, uInt16 PC, Disassembly& disassembly,
                      AddrToLineList& addrToLineList, bool force = false);
 
+    // Convert the address list of the bank to the bank's origin, and
+    // optionally add the given program counter to it
+    void prepareAddressList(int bank, uInt16 PC, bool addPC);
+
     // Actually call DiStella to fill the DisassemblyList structure
     // Return whether the search address was actually in the list
     bool fillDisassemblyList(BankInfo& bankinfo, Disassembly& disassembly,
@@ -358,6 +368,16 @@ class CartDebug : public DebuggerSystem
     AddrToLineList myAddrToLineList;
     bool myAddrToLineIsROM{true};
 
+    // For carts with multiple segments, the last disassembly of each one
+    // (line numbers relative to the segment's first line); a segment is
+    // only disassembled again if its bank or its pages have changed
+    struct SegmentDisassembly {
+      int bank{-1};
+      Disassembly disassembly;
+      AddrToLineList addrToLineList;
+    };
+    vector<SegmentDisassembly> mySegmentCache;
+
     // Mappings from label to address (and vice versa) for items
     // defined by the user (either through a DASM symbol file or manually
     // from the commandline in the debugger)
@@ -379,6 +399,9 @@ class CartDebug : public DebuggerSystem
     // The maximum length of all labels currently defined
     uInt16 myLabelLength{8};  // longest pre-defined label
 
+    // Incremented whenever the user labels change
+    uInt32 myLabelGeneration{0};
+
     /// Table of instruction mnemonics
     static std::array<string_view, 16>  ourTIAMnemonicR; // read mode
     static std::array<string_view, 64>  ourTIAMnemonicW; // write mode
@@ -0,0 +1,494 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2026 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#include <charconv>
+
+#include "DebugScriptRunner.hxx"
+#include "Base.hxx"
+#include "FSNode.hxx"
+#include "Cart.hxx"
+#include "CartCreator.hxx"
+#include "CartDebug.hxx"
+#include "MD5.hxx"
+#include "Serializer.hxx"
+#include "DispatchResult.hxx"
+#include "BreakpointMap.hxx"
+#include "TrapArray.hxx"
+#include "HeadlessConsole.hxx"
+#include "InputMovie.hxx"
+#include "DebuggerExpressions.hxx"
+#include "MemoryReport.hxx"
+
+namespace {
+  struct CommandInfo {
+    string_view name;
+    uInt32 minArgs{0}, maxArgs{0};
+    bool file{false};
+  };
+
+  // Indexed by DebugScriptRunner::Op
+  constexpr std::array<CommandInfo, 13> COMMANDS = {{
+    { "break",     1, 2 },
+    { "delBreak",  1, 2 },
+    { "trap",      1, 2 },
+    { "trapRead",  1, 2 },
+    { "trapWrite", 1, 2 },
+    { "frame",     0, 1 },
+    { "dump",      1, 2 },
+    { "cpu",       0, 0 },
+    { "reset",     0, 0 },
+    { "saveState", 1, 1, true },
+    { "loadState", 1, 1, true },
+    { "movie",     1, 2, true },
+    { "memory",    0, 0 }
+  }};
+
+  // Parse a number using the prefixes of the debugger prompt (default hex)
+  bool parseValue(string_view str, uInt32& value)
+  {
+    int base = 16;
+    if(!str.empty())
+    {
+      switch(str[0])
+      {
+        case '$':  base = 16;  str.remove_prefix(1);  break;
+        case '#':  base = 10;  str.remove_prefix(1);  break;
+        case '%':  base = 2;   str.remove_prefix(1);  break;
+        default:   break;
+      }
+    }
+    const auto [ptr, ec] =
+      std::from_chars(str.data(), str.data() + str.size(), value, base);
+
+    return !str.empty() && ec == std::errc{} && ptr == str.data() + str.size();
+  }
+} // namespace
+
+struct DebugScriptRunner::Machine
+{
+  Machine(unique_ptr<Cartridge> cart, Settings& settings,
+          const Properties& props)
+    : console{std::move(cart), settings, props}
+  {
+    console.detectLayout();
+  }
+
+  HeadlessConsole console;
+  string md5;
+  bool trapsArmed{false};
+};
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+DebugScriptRunner::DebugScriptRunner(int argc, char* argv[])
+{
+  // argv[1] is '-debugscript'
+  if(argc > 2)
+    myScriptFile = argv[2];
+  for(int i = 3; i < argc; ++i)
+    myRomFiles.emplace_back(argv[i]);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+DebugScriptRunner::~DebugScriptRunner() = default;
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool DebugScriptRunner::run()
+{
+  if(myScriptFile.empty() || myRomFiles.empty())
+    throw std::runtime_error("usage: stella -debugscript <script> <rom> [<rom> ...]");
+
+  compile();
+
+  bool ok = true;
+  for(const string& romFile: myRomFiles)
+    ok = runRom(romFile) && ok;
+
+  return ok;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void DebugScriptRunner::compile()
+{
+  const FSNode script(myScriptFile);
+  std::stringstream in;
+
+  try
+  {
+    script.read(in);
+  }
+  catch(const std::runtime_error& e)
+  {
+    throw std::runtime_error(std::format("ERROR: unable to read script {} ({})",
+                                         myScriptFile, e.what()));
+  }
+
+  string text;
+  uInt32 line = 0;
+  while(std::getline(in, text))
+  {
+    ++line;
+
+    // Skip empty/comment lines
+    text = BSPF::trim(text);
+    if(text.empty() || text[0] == ';')
+      continue;
+
+    std::istringstream words(text);
+    string name, word;
+    StringList args;
+    words >> name;
+    while(words >> word)
+      args.push_back(word);
+
+    const auto* info = std::ranges::find_if(COMMANDS,
+      [&name](const CommandInfo& c) { return BSPF::equalsIgnoreCase(c.name, name); });
+    if(info == COMMANDS.end())
+      throw std::runtime_error(std::format("ERROR: {}:{}: unsupported command '{}'",
+                                           myScriptFile, line, name));
+    if(args.size() < info->minArgs || args.size() > info->maxArgs)
+      throw std::runtime_error(std::format("ERROR: {}:{}: wrong number of arguments",
+                                           myScriptFile, line));
+
+    Command& command = myScript.emplace_back();
+    command.op = static_cast<Op>(std::distance(COMMANDS.begin(), info));
+    command.line = line;
+
+    if(info->file)
+      command.file = args[0];
+    for(size_t i = info->file ? 1 : 0; i < args.size(); ++i)
+    {
+      uInt32 value = 0;
+      if(!parseValue(args[i], value))
+        throw std::runtime_error(std::format("ERROR: {}:{}: invalid argument '{}'",
+                                             myScriptFile, line, args[i]));
+      command.args.push_back(value);
+    }
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool DebugScriptRunner::runRom(const string& romFile)
+{
+  cout << "; " << romFile << '\n';
+
+  const FSNode imageFile(romFile);
+  ByteBuffer image;
+  const size_t size = imageFile.isFile() ? imageFile.read(image) : 0;
+  if(size == 0)
+  {
+    cout << "ERROR: unable to read " << romFile << '\n';
+    return false;
+  }
+
+  string md5 = MD5::hash(image, size);
+  const string type;
+  unique_ptr<Cartridge> cartridge = CartCreator::create(
+      imageFile, image, size, md5, type, mySettings);
+  if(!cartridge)
+  {
+    cout << "ERROR: unable to determine cartridge type\n";
+    return false;
+  }
+
+  Machine machine(std::move(cartridge), mySettings, myProps);
+  machine.md5 = md5;
+
+  bool ok = true;
+  for(const Command& command: myScript)
+  {
+    if(!execute(command, machine))
+    {
+      cout << std::format("ERROR: {}:{}: {} failed\n", myScriptFile,
+                          command.line, COMMANDS[static_cast<int>(command.op)].name);
+      ok = false;
+      break;
+    }
+  }
+  cout.flush();
+
+  return ok;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool DebugScriptRunner::execute(const Command& command, Machine& machine)
+{
+  const vector<uInt32>& args = command.args;
+  const uInt32 arg0 = args.empty() ? 0 : args[0];
+
+  switch(command.op)
+  {
+    case Op::Break:
+    case Op::DelBreak:
+    {
+      const auto addr = static_cast<uInt16>(arg0);
+      const auto bank = static_cast<uInt8>(args.size() > 1
+        ? args[1] : machine.console.cartridge().getBank(addr));
+
+      if(command.op == Op::Break)
+        machine.console.cpu().breakPoints().add(addr, bank);
+      else
+        machine.console.cpu().breakPoints().erase(addr, bank);
+      return true;
+    }
+
+    case Op::Trap:
+    case Op::TrapRead:
+    case Op::TrapWrite:
+    {
+      const uInt32 end = args.size() > 1 ? args[1] : arg0;
+      if(arg0 > end || end > 0xffff)
+        return false;
+
+      setTraps(machine, arg0, end, command.op != Op::TrapWrite,
+               command.op != Op::TrapRead);
+      return true;
+    }
+
+    case Op::Frame:
+      return runFrames(machine, args.empty() ? 1 : arg0);
+
+    case Op::Dump:
+    {
+      const uInt32 end = args.size() > 1 ? args[1] : arg0 + 127;
+      if(arg0 > end)
+        return false;
+
+      dump(machine, arg0, std::min<uInt32>(end, 0xffff));
+      return true;
+    }
+
+    case Op::Cpu:
+      showCpu(machine);
+      return true;
+
+    case Op::Reset:
+      machine.console.system().reset();
+      return true;
+
+    case Op::SaveState:
+    {
+      Serializer out(command.file, Serializer::FileMode::ReadWriteTrunc);
+      if(!out)
+        return false;
+
+      out.putString(machine.md5);
+      return machine.console.save(out);
+    }
+
+    case Op::LoadState:
+    {
+      Serializer in(command.file, Serializer::FileMode::ReadOnly);
+      if(!in || in.getString() != machine.md5)
+        return false;
+
+      return machine.console.load(in);
+    }
+
+    case Op::Movie:
+      return playMovie(machine, command.file, arg0);
+
+    case Op::Memory:
+    {
+      MemoryReport report;
+      machine.console.system().memoryReport(report);
+      cout << report.toString() << '\n';
+      return true;
+    }
+
+    default:
+      break;
+  }
+  return false;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool DebugScriptRunner::runFrames(Machine& machine, uInt32 frames)
+{
+  TIA& tia = machine.console.tia();
+  const uInt32 target = tia.frameCount() + frames;
+  DispatchResult result;
+
+  while(tia.frameCount() < target)
+  {
+    tia.update(result);
+    if(tia.newFramePending())
+      tia.renderToFrameBuffer();
+
+    if(result.getStatus() == DispatchResult::Status::debugger)
+    {
+      // Stop early, the next 'frame' command will continue from here
+      cout << result.getMessage() << '\n';
+      showCpu(machine);
+      break;
+    }
+    if(result.getStatus() != DispatchResult::Status::ok)
+      return false;
+  }
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void DebugScriptRunner::setTraps(Machine& machine, uInt32 begin, uInt32 end,
+                                 bool read, bool write)
+{
+  M6502& cpu = machine.console.cpu();
+
+  // Traps only fire if a condition is true; the debugger creates one for
+  // each address range, here the trap arrays alone define the addresses
+  if(!machine.trapsArmed)
+  {
+    cpu.addCondTrap(new ConstExpression(1), "");
+    machine.trapsArmed = true;
+  }
+  if(read)  cpu.readTraps().initialize();
+  if(write) cpu.writeTraps().initialize();
+
+  // Add all mirrors, like DebuggerParser::executeTrapRW()
+  for(uInt32 addr = begin; addr <= end; ++addr)
+  {
+    // Mask and value selecting the area, mirror bits for reads and writes
+    uInt32 mask = 0, value = 0, readBits = 0, writeBits = 0;
+
+    switch(CartDebug::addressType(addr))
+    {
+      case CartDebug::AddrType::TIA:
+        mask = 0x1080;  value = 0x0000;  readBits = 0x000f;  writeBits = 0x003f;
+        break;
+
+      case CartDebug::AddrType::IO:
+        mask = 0x1280;  value = 0x0280;  readBits = writeBits = 0x029f;
+        break;
+
+      case CartDebug::AddrType::ZPRAM:
+        mask = 0x1280;  value = 0x0080;  readBits = writeBits = 0x00ff;
+        break;
+
+      case CartDebug::AddrType::ROM:
+        if(addr < 0x1000)
+          continue;
+        mask = 0x1000;  value = 0x1000;  readBits = writeBits = 0x0fff;
+        break;
+
+      default:
+        continue;
+    }
+
+    for(uInt32 i = 0; i <= 0xffff; ++i)
+    {
+      if((i & mask) != value)
+        continue;
+      if(read && (i & readBits) == (addr & readBits))
+        cpu.readTraps().add(i);
+      if(write && (i & writeBits) == (addr & writeBits))
+        cpu.writeTraps().add(i);
+    }
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void DebugScriptRunner::dump(Machine& machine, uInt32 begin, uInt32 end)
+{
+  using Common::Base;
+
+  // Read the memory without bankswitching or changing the bus
+  Cartridge& cart = machine.console.cartridge();
+  System& system = machine.console.system();
+  const bool locked = cart.hotspotsLocked();
+  cart.lockHotspots();
+  system.lockDataBus();
+
+  for(uInt32 i = begin; i <= end; i += 16)
+  {
+    cout << Base::toString(i, Base::Fmt::_16_4) << ": ";
+    for(uInt32 j = i; j < i + 16 && j <= end; ++j)
+    {
+      cout << Base::toString(system.peekOob(j), Base::Fmt::_16_2) << ' ';
+      if(j == i + 7 && j != end) cout << "- ";
+    }
+    cout << '\n';
+  }
+
+  system.unlockDataBus();
+  if(!locked)
+    cart.unlockHotspots();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void DebugScriptRunner::showCpu(const Machine& machine)
+{
+  const M6502& cpu = machine.console.cpu();
+  const TIA& tia = machine.console.tia();
+
+  cout << std::format("PC={:04x} A={:02x} X={:02x} Y={:02x} SP={:02x} PS={:02x}"
+                      " frame={} scanline={} cycle={}\n",
+                      cpu.PC, cpu.A, cpu.X, cpu.Y, cpu.SP, cpu.PS(),
+                      tia.frameCount(), tia.scanlines(),
+                      tia.clocksThisLine() / 3);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool DebugScriptRunner::playMovie(Machine& machine, const string& file,
+                                  uInt32 keyframe)
+{
+  HeadlessConsole& console = machine.console;
+  const InputMovie::Info info{machine.md5, console.leftController().name(),
+                              console.rightController().name()};
+  InputMovie movie;
+
+  if(!movie.startPlayback(file, info,
+      [&console](Serializer& in) { return console.load(in); }, keyframe))
+    return false;
+
+  const auto save = [&console](Serializer& out) { return console.save(out); };
+  TIA& tia = console.tia();
+  const uInt32 frames = tia.frameCount();
+  DispatchResult result;
+  bool synced = true;
+
+  // Like StateManager::updateMovie() and OSystem::dispatchEmulation(), but
+  // without waiting for real time
+  for(;;)
+  {
+    if(!movie.play(console.system().cycles(), console.event(), save))
+    {
+      cout << std::format("movie: desynchronized at keyframe {}\n",
+                          movie.keyframes() - 1);
+      synced = false;
+    }
+    console.riot().update();
+
+    if(!movie.isPlaying())
+      break;
+
+    tia.update(result, movie.nextCycles() - console.system().cycles());
+    if(tia.newFramePending())
+      tia.renderToFrameBuffer();
+
+    if(result.getStatus() == DispatchResult::Status::debugger)
+    {
+      // Report and continue, the movie has to be played back completely
+      cout << result.getMessage() << '\n';
+      showCpu(machine);
+    }
+    else if(result.getStatus() != DispatchResult::Status::ok)
+      return false;
+  }
+
+  cout << std::format("movie: {} frames, {} keyframes\n",
+                      tia.frameCount() - frames, movie.keyframes());
+  return synced;
+}
@@ -0,0 +1,121 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2026 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#ifndef DEBUG_SCRIPT_RUNNER_HXX
+#define DEBUG_SCRIPT_RUNNER_HXX
+
+#include "bspf.hxx"
+#include "Settings.hxx"
+#include "Props.hxx"
+
+/**
+  Headless runner for debugger scripts, started with
+  'stella -debugscript <script> <rom> [<rom> ...]'.
+
+  Like the ProfilingRunner, each ROM is emulated without any OSystem,
+  FrameBuffer or Sound.  The script is parsed once into a list of commands,
+  which is then executed against each ROM in turn, writing its results to
+  stdout.  This allows running regression traces without a GUI session.
+
+  Only the debugger commands which make sense without the GUI debugger are
+  supported (one per line, ';' starts a comment line):
+
+    break <addr> [bank]         set a breakpoint
+    delBreak <addr> [bank]      remove a breakpoint
+    trap <addr> [end]           set a read/write trap on an address (range)
+    trapRead <addr> [end]       set a read trap on an address (range)
+    trapWrite <addr> [end]      set a write trap on an address (range)
+    frame [n]                   run n frames, or until a break or trap hits
+    dump <addr> [end]           dump memory (default 128 bytes)
+    cpu                         show the CPU registers and beam position
+    reset                       reset the system
+    saveState <file>            save the emulation state to a file
+    loadState <file>            load the emulation state from a file
+    movie <file> [keyframe]     play back an input movie at maximum speed,
+                                from the start or the given keyframe
+    memory                      show the memory used by the chips and cart
+
+  Numbers are hex by default; '$' (hex), '#' (decimal) and '%' (binary)
+  prefixes are accepted as in the debugger prompt.
+
+  @author  Stella Team
+*/
+class DebugScriptRunner
+{
+  public:
+    DebugScriptRunner(int argc, char* argv[]);
+    ~DebugScriptRunner();
+
+    /**
+      Compile the script and run it against all ROMs.
+
+      @return  False if the script or the emulation of any ROM failed
+    */
+    bool run();
+
+  private:
+    enum class Op: uInt8 {
+      Break, DelBreak, Trap, TrapRead, TrapWrite, Frame, Dump, Cpu, Reset,
+      SaveState, LoadState, Movie, Memory
+    };
+
+    struct Command {
+      Op op{Op::Cpu};
+      uInt32 line{0};
+      vector<uInt32> args;
+      string file;
+    };
+
+    // All the emulation objects for one ROM
+    struct Machine;
+
+  private:
+    /**
+      Parse the script file into myScript, throwing on errors.
+    */
+    void compile();
+
+    bool runRom(const string& romFile);
+    bool execute(const Command& command, Machine& machine);
+
+    static bool runFrames(Machine& machine, uInt32 frames);
+    static void setTraps(Machine& machine, uInt32 begin, uInt32 end,
+                         bool read, bool write);
+    static void dump(Machine& machine, uInt32 begin, uInt32 end);
+    static void showCpu(const Machine& machine);
+    static bool playMovie(Machine& machine, const string& file, uInt32 keyframe);
+
+  private:
+    string myScriptFile;
+    vector<string> myRomFiles;
+
+    // The compiled script, shared by all ROMs
+    vector<Command> myScript;
+
+    Settings mySettings;
+    Properties myProps;
+
+  private:
+    // Following constructors and assignment operators not supported
+    DebugScriptRunner() = delete;
+    DebugScriptRunner(const DebugScriptRunner&) = delete;
+    DebugScriptRunner(DebugScriptRunner&&) = delete;
+    DebugScriptRunner& operator=(const DebugScriptRunner&) = delete;
+    DebugScriptRunner& operator=(DebugScriptRunner&&) = delete;
+};
+
+#endif
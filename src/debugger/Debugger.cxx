@@ -44,6 +44,8 @@
 
 #include "RomWidget.hxx"
 #include "Expression.hxx"
+#include "ExpressionProgram.hxx"
+#include "StateSearch.hxx"
 #include "YaccParser.hxx"
 
 #include "TIA.hxx"
@@ -95,14 +97,31 @@ void Debugger::initialize()
 
   myOSystem.settings().setValue("dbg.res", mySize);
 
+  // The dialog is (re)created on first use
+  myCartDebug->setDebugWidget(nullptr);
   delete myDialog;  myDialog = nullptr;
-  myDialog = new DebuggerDialog(myOSystem, *this, 0, 0, mySize.w, mySize.h);
-
-  myCartDebug->setDebugWidget(myDialog->cartDebug());
 
   saveOldState();
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+DebuggerDialog& Debugger::dialog() const
+{
+  if(myDialog == nullptr)
+  {
+    myDialog = new DebuggerDialog(myOSystem, const_cast<Debugger&>(*this),
+                                  0, 0, mySize.w, mySize.h);
+    myCartDebug->setDebugWidget(myDialog->cartDebug());
+  }
+  return *myDialog;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+Dialog* Debugger::baseDialog()
+{
+  return &dialog();
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 FBInitStatus Debugger::initializeVideo()
 {
@@ -125,8 +144,8 @@ bool Debugger::start(string_view message, int address, bool read,
     string text{message};
     if(address > -1)
       text += cartDebug().getLabel(address, read, 4);
-    myDialog->message().setText(text);
-    myDialog->message().setToolTip(toolTip);
+    dialog().message().setText(text);
+    dialog().message().setToolTip(toolTip);
     return true;
   }
   return false;
@@ -139,7 +158,7 @@ bool Debugger::startWithFatalError(string_view message)
   {
     // This must be done *after* we enter debug mode,
     // so the dialog is properly shown
-    myDialog->showFatalMessage(message);
+    dialog().showFatalMessage(message);
     return true;
   }
   return false;
@@ -149,7 +168,7 @@ bool Debugger::startWithFatalError(string_view message)
 void Debugger::quit()
 {
   if(myOSystem.settings().getBool("dbg.autosave")
-     && myDialog->prompt().isLoaded())
+     && myDialog != nullptr && myDialog->prompt().isLoaded())
     myParser->run("save");
 }
 
@@ -249,6 +268,7 @@ void Debugger::reset()
   unlockSystem();
   mySystem.reset();
   lockSystem();
+  myStepHistory.clear();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -295,6 +315,7 @@ void Debugger::loadState(int state)
   unlockSystem();
   myOSystem.state().loadState(state);
   lockSystem();
+  myStepHistory.clear();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -307,6 +328,7 @@ void Debugger::loadAllStates()
   unlockSystem();
   myOSystem.state().rewindManager().loadAllStates();
   lockSystem();
+  myStepHistory.clear();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -322,7 +344,7 @@ int Debugger::step(bool save)
   lockSystem();
 
   if(save)
-    addState("step");
+    addStep("step");
   return static_cast<int>(mySystem.cycles() - startCycle);
 }
 
@@ -359,7 +381,7 @@ int Debugger::trace()
     myOSystem.console().tia().flushLineCache();
     lockSystem();
 
-    addState("trace");
+    addStep("trace");
     return static_cast<int>(mySystem.cycles() - startCycle);
   }
   else
@@ -675,21 +697,79 @@ void Debugger::nextFrame(int frames)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void Debugger::updateRewindbuttons(const RewindManager& r)
 {
-  myDialog->rewindButton().setEnabled(!r.atFirst());
-  myDialog->unwindButton().setEnabled(!r.atLast());
+  const uInt64 keyFrame = r.getCurrentCycles();
+  const uInt32 position = myStepHistory.position(keyFrame);
+
+  dialog().rewindButton().setEnabled(!r.atFirst() || position > 0);
+  dialog().unwindButton().setEnabled(!r.atLast() ||
+                                     position < myStepHistory.size(keyFrame));
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-uInt16 Debugger::windStates(uInt16 numStates, bool unwind, string& message)
+uInt16 Debugger::windStates(uInt16 numStates, bool unwind, string& message,
+                            bool steps)
 {
   RewindManager& r = myOSystem.state().rewindManager();
 
   saveOldState();
   unlockSystem();
 
-  const uInt64 startCycles = myOSystem.console().system().cycles();
-  const uInt16 winds = r.windStates(numStates, unwind);
-  message = r.getUnitString(myOSystem.console().system().cycles() - startCycles);
+  const uInt64 startCycles = mySystem.cycles();
+  uInt16 winds = 0;
+  bool loaded = false;
+
+  if(!steps)
+  {
+    winds = r.windStates(numStates, unwind);
+    myStepHistory.setPosition(r.getCurrentCycles(), 0);
+    loaded = true;
+  }
+  // Steps only move the position within the steps of the current key frame,
+  // the target is then replayed from the last loaded state
+  else for(; winds < numStates; ++winds)
+  {
+    const uInt64 keyFrame = r.getCurrentCycles();
+    const uInt32 position = myStepHistory.position(keyFrame);
+
+    if(unwind)
+    {
+      if(position < myStepHistory.size(keyFrame))
+        myStepHistory.setPosition(keyFrame, position + 1);
+      else if(r.unwindStates(1))
+        myStepHistory.setPosition(r.getCurrentCycles(), 0);
+      else
+        break;
+    }
+    else
+    {
+      if(position > 0)
+        myStepHistory.setPosition(keyFrame, position - 1);
+      else if(r.rewindStates(1))
+      {
+        const uInt64 prevKeyFrame = r.getCurrentCycles();
+        myStepHistory.setPosition(prevKeyFrame, myStepHistory.size(prevKeyFrame));
+        loaded = true;
+      }
+      else
+        break;
+    }
+  }
+
+  if(winds)
+  {
+    const uInt64 keyFrame = r.getCurrentCycles();
+    const uInt32 position = myStepHistory.position(keyFrame);
+
+    // Going back requires replaying from the key frame
+    if(!unwind && !loaded)
+      r.reloadState();
+    if(position > 0)
+    {
+      mySystem.m6502().replay(myStepHistory.cycles(keyFrame, position));
+      myOSystem.console().tia().flushLineCache();
+    }
+  }
+  message = r.getUnitString(mySystem.cycles() - startCycles);
 
   lockSystem();
 
@@ -709,6 +789,43 @@ uInt16 Debugger::unwindStates(uInt16 numStates, string& message)
   return windStates(numStates, true, message);
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool Debugger::findState(Expression* condition, string& message)
+{
+  ExpressionProgram program(condition);
+  if(!program.resolveLabels())
+  {
+    message = "condition may only use memory and labels";
+    return false;
+  }
+
+  RewindManager& r = myOSystem.state().rewindManager();
+  vector<ByteArray> states;
+  r.getAllStates(states);
+
+  const StateSearch search(myOSystem.romFile(),
+                           myOSystem.console().cartridge().detectedType());
+  const Int32 found = search.findFirst(program, states);
+  if(found < 0)
+  {
+    message = std::format("condition not met in any of {} states",
+                          states.size());
+    return false;
+  }
+
+  // State list positions are one based
+  const Int32 diff = static_cast<Int32>(r.getCurrentIdx()) - (found + 1);
+  string unitString;
+  if(diff > 0)
+    windStates(diff, false, unitString, false);
+  else if(diff < 0)
+    windStates(-diff, true, unitString, false);
+  message = std::format("found state {}/{}", found + 1, states.size());
+  if(diff != 0)
+    message += std::format(" (~{})", unitString);
+  return true;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void Debugger::clearAllBreakPoints() const
 {
@@ -759,15 +876,36 @@ void Debugger::addState(string_view rewindMsg)
 {
   // Add another rewind level to the Time Machine buffer
   RewindManager& r = myOSystem.state().rewindManager();
+  const uInt64 prevKeyFrame = r.getCurrentCycles();
+
   r.addState(rewindMsg);
+  myStepHistory.addKeyFrame(prevKeyFrame, r.getCurrentCycles());
+  myStepHistory.removeBefore(r.getFirstCycles());
   updateRewindbuttons(r);
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Debugger::addStep(string_view rewindMsg)
+{
+  RewindManager& r = myOSystem.state().rewindManager();
+
+  // Only every n-th step is saved as a rewind state, the others are replayed
+  // from it when going back.  Stepping from a rewound state must discard
+  // the future states, which a new rewind state does.
+  if(r.getLastIdx() != 0 && r.atLast() &&
+     myStepHistory.addStep(r.getCurrentCycles(), mySystem.cycles()))
+    updateRewindbuttons(r);
+  else
+    addState(rewindMsg);
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void Debugger::setStartState()
 {
   // Lock the bus each time the debugger is entered, so we don't disturb anything
   lockSystem();
+  // From now on, collect the access flags for the disassembly
+  mySystem.enableAccessTracking();
 
   // Save initial state and add it to the rewind list (except when in currently rewinding)
   const RewindManager& r = myOSystem.state().rewindManager();
@@ -779,15 +917,18 @@ void Debugger::setStartState()
     updateRewindbuttons(r);
 
   // Set the 're-disassemble' flag, but don't do it until the next scheduled time
-  myDialog->rom().invalidate(false);
+  dialog().rom().invalidate(false);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void Debugger::setQuitState()
 {
-  myDialog->saveConfig();
+  dialog().saveConfig();
   saveOldState();
 
+  // Emulation continues from the current step
+  myStepHistory.truncate(myOSystem.state().rewindManager().getCurrentCycles());
+
   // Bus must be unlocked for normal operation when leaving debugger mode
   unlockSystem();
 
@@ -803,6 +944,7 @@ bool Debugger::addFunction(string_view name, string_view definition,
 {
   myFunctions.emplace(name, unique_ptr<Expression>(exp));
   myFunctionDefs.emplace(name, definition);
+  ++myFunctionGeneration;
 
   return true;
 }
@@ -825,6 +967,7 @@ bool Debugger::delFunction(string_view name)
       return false;
 
   myFunctions.erase(string{name});    // TODO: temp string fixed in C++23
+  ++myFunctionGeneration;
 
   if(!myFunctionDefs.contains(name))
     return false;
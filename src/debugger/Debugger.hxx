@@ -49,6 +49,7 @@ class RewindManager;
 #include "DebuggerDialog.hxx"
 #include "FrameBufferConstants.hxx"
 #include "Cart.hxx"
+#include "StepHistory.hxx"
 #include "bspf.hxx"
 
 /**
@@ -117,6 +118,8 @@ class Debugger : public DialogContainer
     const Expression& getFunction(string_view name) const;
 
     const string& getFunctionDef(string_view name) const;
+    // Changes whenever functions are added or removed
+    uInt32 functionGeneration() const { return myFunctionGeneration; }
     FunctionDefMap getFunctionDefMap() const;
     static string builtinHelp();
 
@@ -146,12 +149,12 @@ class Debugger : public DialogContainer
     */
     TIADebug& tiaDebug() const { return *myTiaDebug; }
 
-    const GUI::Font& lfont() const      { return myDialog->lfont();     }
-    const GUI::Font& nlfont() const     { return myDialog->nfont();     }
+    const GUI::Font& lfont() const      { return dialog().lfont();      }
+    const GUI::Font& nlfont() const     { return dialog().nfont();      }
     DebuggerParser& parser() const      { return *myParser;             }
-    PromptWidget& prompt() const        { return myDialog->prompt();    }
-    RomWidget& rom() const              { return myDialog->rom();       }
-    TiaOutputWidget& tiaOutput() const  { return myDialog->tiaOutput(); }
+    PromptWidget& prompt() const        { return dialog().prompt();     }
+    RomWidget& rom() const              { return dialog().rom();        }
+    TiaOutputWidget& tiaOutput() const  { return dialog().tiaOutput();  }
 
     BreakpointMap& breakPoints() const;
 
@@ -280,9 +283,16 @@ class Debugger : public DialogContainer
     /**
       Return (and possibly create) the bottom-most dialog of this container.
     */
-    Dialog* baseDialog() override { return myDialog; }
+    Dialog* baseDialog() override;
 
   private:
+    /**
+      Return the debugger dialog, creating it the first time it's needed.
+      Building the complete widget tree is costly, and not necessary at all
+      when the debugger is never entered.
+    */
+    DebuggerDialog& dialog() const;
+
     /**
       Save state of each debugger subsystem and, by default, mark all
       pages as clean (ie, turn off the dirty flag).
@@ -294,6 +304,12 @@ class Debugger : public DialogContainer
     */
     void addState(string_view rewindMsg);
 
+    /**
+      Records a step or trace; only every n-th one is saved as a rewind
+      state with the given message (see StepHistory).
+    */
+    void addStep(string_view rewindMsg);
+
     /**
       Set initial state before entering the debugger.
     */
@@ -311,6 +327,14 @@ class Debugger : public DialogContainer
     uInt16 rewindStates(uInt16 numStates, string& message);
     uInt16 unwindStates(uInt16 numStates, string& message);
 
+    /**
+      Search all rewind states (on worker threads) for the first one in which
+      the condition holds, and wind to it.  Takes ownership of the condition.
+
+      @return  True if a matching state was found
+    */
+    bool findState(Expression* condition, string& message);
+
     void clearAllBreakPoints() const;
 
     void addReadTrap(uInt16 t) const;
@@ -338,7 +362,8 @@ class Debugger : public DialogContainer
     Console& myConsole;
     System&  mySystem;
 
-    DebuggerDialog* myDialog{nullptr};
+    // The dialog tree is only built when first needed, see dialog()
+    mutable DebuggerDialog* myDialog{nullptr};
     unique_ptr<DebuggerParser> myParser;
     unique_ptr<CartDebug>      myCartDebug;
     unique_ptr<CpuDebug>       myCpuDebug;
@@ -349,6 +374,7 @@ class Debugger : public DialogContainer
 
     FunctionMap myFunctions;
     FunctionDefMap myFunctionDefs;
+    uInt32 myFunctionGeneration{0};
 
     // Dimensions of the entire debugger window
     Common::Size mySize{DebuggerDialog::kSmallFontMinW,
@@ -367,9 +393,13 @@ class Debugger : public DialogContainer
     static constexpr Int8 ANY_BANK = -1;
     bool myFirstLog{true};
 
+    // The steps made since the last rewind states
+    StepHistory myStepHistory;
+
   private:
-    // rewind/unwind n states
-    uInt16 windStates(uInt16 numStates, bool unwind, string& message);
+    // rewind/unwind n states (or steps, if 'steps' is set)
+    uInt16 windStates(uInt16 numStates, bool unwind, string& message,
+                      bool steps = true);
     // update the rewind/unwind button state
     void updateRewindbuttons(const RewindManager& r);
 
@@ -18,8 +18,6 @@
 #ifndef DEBUGGER_EXPRESSIONS_HXX
 #define DEBUGGER_EXPRESSIONS_HXX
 
-#include <functional>
-
 #include "bspf.hxx"
 #include "CartDebug.hxx"
 #include "CpuDebug.hxx"
@@ -27,6 +25,7 @@
 #include "TIADebug.hxx"
 #include "Debugger.hxx"
 #include "Expression.hxx"
+#include "ExpressionProgram.hxx"
 
 /**
   All expressions currently supported by the debugger.
@@ -40,6 +39,9 @@ class BinAndExpression : public Expression
     BinAndExpression(Expression* left, Expression* right) : Expression(left, right) { }
     Int32 evaluate() const override
       { return myLHS->evaluate() & myRHS->evaluate(); }
+    void compile(ExpressionProgram& program) const override
+      { myLHS->compile(program); myRHS->compile(program);
+        program.emit(ExpressionProgram::Op::BinAnd); }
 };
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -49,6 +51,8 @@ class BinNotExpression : public Expression
     explicit BinNotExpression(Expression* left) : Expression(left) { }
     Int32 evaluate() const override
       { return ~(myLHS->evaluate()); }
+    void compile(ExpressionProgram& program) const override
+      { myLHS->compile(program); program.emit(ExpressionProgram::Op::BinNot); }
 };
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -58,6 +62,9 @@ class BinOrExpression : public Expression
     BinOrExpression(Expression* left, Expression* right) : Expression(left, right) { }
     Int32 evaluate() const override
       { return myLHS->evaluate() | myRHS->evaluate(); }
+    void compile(ExpressionProgram& program) const override
+      { myLHS->compile(program); myRHS->compile(program);
+        program.emit(ExpressionProgram::Op::BinOr); }
 };
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -67,6 +74,9 @@ class BinXorExpression : public Expression
     BinXorExpression(Expression* left, Expression* right) : Expression(left, right) { }
     Int32 evaluate() const override
       { return myLHS->evaluate() ^ myRHS->evaluate(); }
+    void compile(ExpressionProgram& program) const override
+      { myLHS->compile(program); myRHS->compile(program);
+        program.emit(ExpressionProgram::Op::BinXor); }
 };
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -76,6 +86,8 @@ class ByteDerefExpression : public Expression
     explicit ByteDerefExpression(Expression* left): Expression(left) { }
     Int32 evaluate() const override
       { return Debugger::debugger().peek(myLHS->evaluate()); }
+    void compile(ExpressionProgram& program) const override
+      { myLHS->compile(program); program.emit(ExpressionProgram::Op::ByteDeref); }
 };
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -85,6 +97,9 @@ class ByteDerefOffsetExpression : public Expression
     ByteDerefOffsetExpression(Expression* left, Expression* right) : Expression(left, right) { }
     Int32 evaluate() const override
       { return Debugger::debugger().peek(myLHS->evaluate() + myRHS->evaluate()); }
+    void compile(ExpressionProgram& program) const override
+      { myLHS->compile(program); myRHS->compile(program);
+        program.emit(ExpressionProgram::Op::ByteDerefOffset); }
 };
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -94,6 +109,8 @@ class ConstExpression : public Expression
     explicit ConstExpression(int value) : myValue{value} { }
     Int32 evaluate() const override
       { return myValue; }
+    void compile(ExpressionProgram& program) const override
+      { program.emit(ExpressionProgram::Op::Const, myValue); }
 
   private:
     int myValue;
@@ -103,12 +120,14 @@ class ConstExpression : public Expression
 class CpuMethodExpression : public Expression
 {
   public:
-    explicit CpuMethodExpression(CpuMethod method) : myMethod{std::mem_fn(method)} { }
+    explicit CpuMethodExpression(CpuMethod method) : myMethod{method} { }
     Int32 evaluate() const override
-      { return myMethod(Debugger::debugger().cpuDebug()); }
+      { return (Debugger::debugger().cpuDebug().*myMethod)(); }
+    void compile(ExpressionProgram& program) const override
+      { program.emitMethod(myMethod); }
 
   private:
-    std::function<int(const CpuDebug&)> myMethod;
+    CpuMethod myMethod{nullptr};
 };
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -119,6 +138,9 @@ class DivExpression : public Expression
     Int32 evaluate() const override
       { const int denom = myRHS->evaluate();
         return denom == 0 ? 0 : myLHS->evaluate() / denom; }
+    void compile(ExpressionProgram& program) const override
+      { myLHS->compile(program); myRHS->compile(program);
+        program.emit(ExpressionProgram::Op::Div); }
 };
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -128,6 +150,9 @@ class EqualsExpression : public Expression
     EqualsExpression(Expression* left, Expression* right) : Expression(left, right) { }
     Int32 evaluate() const override
       { return myLHS->evaluate() == myRHS->evaluate(); }
+    void compile(ExpressionProgram& program) const override
+      { myLHS->compile(program); myRHS->compile(program);
+        program.emit(ExpressionProgram::Op::Equals); }
 };
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -161,6 +186,9 @@ class GreaterEqualsExpression : public Expression
     GreaterEqualsExpression(Expression* left, Expression* right) : Expression(left, right) { }
     Int32 evaluate() const override
       { return myLHS->evaluate() >= myRHS->evaluate(); }
+    void compile(ExpressionProgram& program) const override
+      { myLHS->compile(program); myRHS->compile(program);
+        program.emit(ExpressionProgram::Op::GreaterEquals); }
 };
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -170,6 +198,9 @@ class GreaterExpression : public Expression
     GreaterExpression(Expression* left, Expression* right) : Expression(left, right) { }
     Int32 evaluate() const override
       { return myLHS->evaluate() > myRHS->evaluate(); }
+    void compile(ExpressionProgram& program) const override
+      { myLHS->compile(program); myRHS->compile(program);
+        program.emit(ExpressionProgram::Op::Greater); }
 };
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -179,6 +210,8 @@ class HiByteExpression : public Expression
     explicit HiByteExpression(Expression* left) : Expression(left) { }
     Int32 evaluate() const override
       { return 0xff & (myLHS->evaluate() >> 8); }
+    void compile(ExpressionProgram& program) const override
+      { myLHS->compile(program); program.emit(ExpressionProgram::Op::HiByte); }
 };
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -188,6 +221,9 @@ class LessEqualsExpression : public Expression
     LessEqualsExpression(Expression* left, Expression* right) : Expression(left, right) { }
     Int32 evaluate() const override
       { return myLHS->evaluate() <= myRHS->evaluate(); }
+    void compile(ExpressionProgram& program) const override
+      { myLHS->compile(program); myRHS->compile(program);
+        program.emit(ExpressionProgram::Op::LessEquals); }
 };
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -197,6 +233,9 @@ class LessExpression : public Expression
     LessExpression(Expression* left, Expression* right) : Expression(left, right) { }
     Int32 evaluate() const override
       { return myLHS->evaluate() < myRHS->evaluate(); }
+    void compile(ExpressionProgram& program) const override
+      { myLHS->compile(program); myRHS->compile(program);
+        program.emit(ExpressionProgram::Op::Less); }
 };
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -206,6 +245,8 @@ class LoByteExpression : public Expression
     explicit LoByteExpression(Expression* left) : Expression(left) { }
     Int32 evaluate() const override
       { return 0xff & myLHS->evaluate(); }
+    void compile(ExpressionProgram& program) const override
+      { myLHS->compile(program); program.emit(ExpressionProgram::Op::LoByte); }
 };
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -215,6 +256,12 @@ class LogAndExpression : public Expression
     LogAndExpression(Expression* left, Expression* right) : Expression(left, right) { }
     Int32 evaluate() const override
       { return myLHS->evaluate() && myRHS->evaluate(); }
+    void compile(ExpressionProgram& program) const override
+      { myLHS->compile(program);
+        const size_t jump = program.emitJump(ExpressionProgram::Op::JumpIfFalse);
+        myRHS->compile(program);
+        program.patchJump(jump);
+        program.emit(ExpressionProgram::Op::Bool); }
 };
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -224,6 +271,8 @@ class LogNotExpression : public Expression
     explicit LogNotExpression(Expression* left) : Expression(left) { }
     Int32 evaluate() const override
       { return !(myLHS->evaluate()); }
+    void compile(ExpressionProgram& program) const override
+      { myLHS->compile(program); program.emit(ExpressionProgram::Op::LogNot); }
 };
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -233,6 +282,12 @@ class LogOrExpression : public Expression
     LogOrExpression(Expression* left, Expression* right) : Expression(left, right) { }
     Int32 evaluate() const override
       { return myLHS->evaluate() || myRHS->evaluate(); }
+    void compile(ExpressionProgram& program) const override
+      { myLHS->compile(program);
+        const size_t jump = program.emitJump(ExpressionProgram::Op::JumpIfTrue);
+        myRHS->compile(program);
+        program.patchJump(jump);
+        program.emit(ExpressionProgram::Op::Bool); }
 };
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -242,6 +297,9 @@ class MinusExpression : public Expression
     MinusExpression(Expression* left, Expression* right) : Expression(left, right) { }
     Int32 evaluate() const override
       { return myLHS->evaluate() - myRHS->evaluate(); }
+    void compile(ExpressionProgram& program) const override
+      { myLHS->compile(program); myRHS->compile(program);
+        program.emit(ExpressionProgram::Op::Minus); }
 };
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -252,6 +310,9 @@ class ModExpression : public Expression
     Int32 evaluate() const override
       { const int rhs = myRHS->evaluate();
         return rhs == 0 ? 0 : myLHS->evaluate() % rhs; }
+    void compile(ExpressionProgram& program) const override
+      { myLHS->compile(program); myRHS->compile(program);
+        program.emit(ExpressionProgram::Op::Mod); }
 };
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -261,6 +322,9 @@ class MultExpression : public Expression
     MultExpression(Expression* left, Expression* right) : Expression(left, right) { }
     Int32 evaluate() const override
       { return myLHS->evaluate() * myRHS->evaluate(); }
+    void compile(ExpressionProgram& program) const override
+      { myLHS->compile(program); myRHS->compile(program);
+        program.emit(ExpressionProgram::Op::Mult); }
 };
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -270,6 +334,9 @@ class NotEqualsExpression : public Expression
     NotEqualsExpression(Expression* left, Expression* right) : Expression(left, right) { }
     Int32 evaluate() const override
       { return myLHS->evaluate() != myRHS->evaluate(); }
+    void compile(ExpressionProgram& program) const override
+      { myLHS->compile(program); myRHS->compile(program);
+        program.emit(ExpressionProgram::Op::NotEquals); }
 };
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -279,6 +346,9 @@ class PlusExpression : public Expression
     PlusExpression(Expression* left, Expression* right) : Expression(left, right) { }
     Int32 evaluate() const override
       { return myLHS->evaluate() + myRHS->evaluate(); }
+    void compile(ExpressionProgram& program) const override
+      { myLHS->compile(program); myRHS->compile(program);
+        program.emit(ExpressionProgram::Op::Plus); }
 };
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -286,12 +356,14 @@ class CartMethodExpression : public Expression
 {
   public:
     explicit CartMethodExpression(CartMethod method) :
-      myMethod{std::mem_fn(method)} { }
+      myMethod{method} { }
     Int32 evaluate() const override
-      { return myMethod(Debugger::debugger().cartDebug()); }
+      { return (Debugger::debugger().cartDebug().*myMethod)(); }
+    void compile(ExpressionProgram& program) const override
+      { program.emitMethod(myMethod); }
 
   private:
-    std::function<int(CartDebug&)> myMethod;
+    CartMethod myMethod{nullptr};
 };
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -301,6 +373,9 @@ class ShiftLeftExpression : public Expression
     ShiftLeftExpression(Expression* left, Expression* right) : Expression(left, right) { }
     Int32 evaluate() const override
       { return myLHS->evaluate() << myRHS->evaluate(); }
+    void compile(ExpressionProgram& program) const override
+      { myLHS->compile(program); myRHS->compile(program);
+        program.emit(ExpressionProgram::Op::ShiftLeft); }
 };
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -310,6 +385,9 @@ class ShiftRightExpression : public Expression
     ShiftRightExpression(Expression* left, Expression* right) : Expression(left, right) { }
     Int32 evaluate() const override
       { return myLHS->evaluate() >> myRHS->evaluate(); }
+    void compile(ExpressionProgram& program) const override
+      { myLHS->compile(program); myRHS->compile(program);
+        program.emit(ExpressionProgram::Op::ShiftRight); }
 };
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -317,12 +395,14 @@ class RiotMethodExpression : public Expression
 {
   public:
     explicit RiotMethodExpression(RiotMethod method) :
-      myMethod{std::mem_fn(method)} { }
+      myMethod{method} { }
     Int32 evaluate() const override
-      { return myMethod(Debugger::debugger().riotDebug()); }
+      { return (Debugger::debugger().riotDebug().*myMethod)(); }
+    void compile(ExpressionProgram& program) const override
+      { program.emitMethod(myMethod); }
 
   private:
-    std::function<int(const RiotDebug&)> myMethod;
+    RiotMethod myMethod{nullptr};
 };
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -330,12 +410,14 @@ class TiaMethodExpression : public Expression
 {
   public:
     explicit TiaMethodExpression(TiaMethod method) :
-      myMethod{std::mem_fn(method)} { }
+      myMethod{method} { }
     Int32 evaluate() const override
-      { return myMethod(Debugger::debugger().tiaDebug()); }
+      { return (Debugger::debugger().tiaDebug().*myMethod)(); }
+    void compile(ExpressionProgram& program) const override
+      { program.emitMethod(myMethod); }
 
   private:
-    std::function<int(const TIADebug&)> myMethod;
+    TiaMethod myMethod{nullptr};
 };
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -345,6 +427,8 @@ class UnaryMinusExpression : public Expression
     explicit UnaryMinusExpression(Expression* left) : Expression(left) { }
     Int32 evaluate() const override
       { return -(myLHS->evaluate()); }
+    void compile(ExpressionProgram& program) const override
+      { myLHS->compile(program); program.emit(ExpressionProgram::Op::UnaryMinus); }
 };
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -354,6 +438,8 @@ class WordDerefExpression : public Expression
     explicit WordDerefExpression(Expression* left) : Expression(left) { }
     Int32 evaluate() const override
       { return Debugger::debugger().dpeekAsInt(myLHS->evaluate()); }
+    void compile(ExpressionProgram& program) const override
+      { myLHS->compile(program); program.emit(ExpressionProgram::Op::WordDeref); }
 };
 
 #endif
@@ -22,9 +22,11 @@
 #include "RiotDebug.hxx"
 #include "ControlLowLevel.hxx"
 #include "TIADebug.hxx"
+#include "TIA.hxx"
 #include "TiaOutputWidget.hxx"
 #include "YaccParser.hxx"
 #include "Expression.hxx"
+#include "ExpressionProgram.hxx"
 #include "FSNode.hxx"
 #include "OSystem.hxx"
 #include "System.hxx"
@@ -36,6 +38,10 @@
 #include "BrowserDialog.hxx"
 #include "FrameBuffer.hxx"
 #include "TimerManager.hxx"
+#include "TraceRecorder.hxx"
+#include "CallProfiler.hxx"
+#include "MemoryReport.hxx"
+#include "ArmProfiler.hxx"
 #include "Vec.hxx"
 #include "bspf.hxx"
 
@@ -378,11 +384,8 @@ bool DebuggerParser::getArgs(string_view command, string& verb)
   args.reserve(argCount);
   for(const auto& argStr: argStrings)
   {
-    if(!YaccParser::parse(argStr))
-    {
-      unique_ptr<Expression> expr(YaccParser::getResult());
-      args.push_back(expr->evaluate());
-    }
+    if(const auto program = myExpressions.get(argStr); program)
+      args.push_back(program->evaluate());
     else
       args.push_back(-1);
   }
@@ -917,6 +920,54 @@ void DebuggerParser::executeA()
   debugger.cpuDebug().setA(static_cast<uInt8>(args[0]));
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// "armProfile"
+void DebuggerParser::executeArmProfile()
+{
+  Cartridge& cart = debugger.myConsole.cartridge();
+  const string cmd = argCount ? BSPF::toLowerCase(argStrings[0]) : "flat";
+
+  if(cmd == "on" || cmd == "off")
+  {
+    if(cart.enableArmProfiler(cmd == "on"))
+      commandResult << "ARM profiler " << (cmd == "on" ? "enabled" : "disabled");
+    else
+      commandResult << red("cartridge has no ARM code");
+    return;
+  }
+
+  ArmProfiler* profiler = cart.armProfiler();
+  if(profiler == nullptr)
+  {
+    commandResult << red("ARM profiler not enabled, use 'armProfile on'");
+    return;
+  }
+
+  if(cmd == "flat")
+    commandResult << profiler->flatProfile();
+  else if(cmd == "reset")
+  {
+    profiler->reset();
+    commandResult << "ARM profile reset";
+  }
+  else if(cmd == "stacks")
+  {
+    const FSNode node(debugger.myOSystem.userDir().getPath() + cartName() + ".folded");
+
+    try
+    {
+      node.write(profiler->collapsedStacks());
+      commandResult << "saved " << node.getShortPath() << " OK";
+    }
+    catch(...)
+    {
+      commandResult << red("Unable to save collapsed stacks to " + node.getShortPath());
+    }
+  }
+  else
+    commandResult << red("invalid argument, use on|off|reset|flat|stacks");
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 // "aud"
 void DebuggerParser::executeAud()
@@ -1012,7 +1063,8 @@ void DebuggerParser::executeBreak()
 // "breakIf"
 void DebuggerParser::executeBreakIf()
 {
-  if(YaccParser::parse(argStrings[0]) != 0)
+  auto program = myExpressions.get(argStrings[0]);
+  if(!program)
   {
     commandResult << red("invalid expression");
     return;
@@ -1030,7 +1082,7 @@ void DebuggerParser::executeBreakIf()
   }
 
   const uInt32 ret = debugger.m6502().addCondBreak(
-                       YaccParser::getResult(), argStrings[0]);
+                       std::move(program), argStrings[0]);
   commandResult << "added breakIf " << Base::toString(ret);
 }
 
@@ -1469,6 +1521,26 @@ void DebuggerParser::executeExitRom()
   debugger.exit(true);
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// "findState"
+void DebuggerParser::executeFindState()
+{
+  if(YaccParser::parse(argStrings[0]) != 0)
+  {
+    commandResult << red("invalid expression");
+    return;
+  }
+
+  string message;
+  if(debugger.findState(YaccParser::getResult(), message))
+  {
+    debugger.rom().invalidate();
+    commandResult << message;
+  }
+  else
+    commandResult << red(message);
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 // "frame"
 void DebuggerParser::executeFrame()
@@ -1480,6 +1552,13 @@ void DebuggerParser::executeFrame()
   commandResult << "advanced " << dec << count << " frame(s)";
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// "frameTimes"
+void DebuggerParser::executeFrameTimes()
+{
+  commandResult << debugger.myOSystem.frameTimes().report();
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 // "function"
 void DebuggerParser::executeFunction()
@@ -1852,6 +1931,13 @@ void DebuggerParser::executeLogTrace()
   commandResult << "logTrace " << (enable ? "enabled" : "disabled");
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// "memory"
+void DebuggerParser::executeMemory()
+{
+  commandResult << debugger.myOSystem.memoryReport().toString();
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 // "n"
 void DebuggerParser::executeN()
@@ -1903,6 +1989,55 @@ void DebuggerParser::executePrintTimer()
   printTimer(args[0]);
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// "profile"
+void DebuggerParser::executeProfile()
+{
+  CallProfiler& profiler = debugger.m6502().callProfiler();
+  const string cmd = argCount ? BSPF::toLowerCase(argStrings[0]) : "show";
+
+  // Routines are named by their labels, plus the bank for multi-bank carts
+  const bool banked = debugger.myConsole.cartridge().romBankCount() > 1;
+  const auto name = [this, banked](uInt16 addr, uInt8 bank) {
+    string label = debugger.cartDebug().getLabel(addr, true, 4);
+    if(banked)
+      label += std::format("@{}", bank);
+    return label;
+  };
+  const auto save = [this](string_view ext, const string& data) {
+    const FSNode node(debugger.myOSystem.userDir().getPath() + cartName() + string{ext});
+
+    try
+    {
+      node.write(data);
+      commandResult << "saved " << node.getShortPath() << " OK";
+    }
+    catch(...)
+    {
+      commandResult << red("Unable to save " + node.getShortPath());
+    }
+  };
+
+  if(cmd == "on" || cmd == "off")
+  {
+    profiler.enable(cmd == "on");
+    commandResult << "6502 profiler " << (cmd == "on" ? "enabled" : "disabled");
+  }
+  else if(cmd == "reset")
+  {
+    profiler.reset();
+    commandResult << "6502 profile reset";
+  }
+  else if(cmd == "show")
+    commandResult << profiler.report(name);
+  else if(cmd == "graph")
+    save(".dot", profiler.callGraph(name));
+  else if(cmd == "stacks")
+    save(".folded", profiler.collapsedStacks(name));
+  else
+    commandResult << red("invalid argument, use on|off|reset|show|graph|stacks");
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 // "ram"
 void DebuggerParser::executeRam()
@@ -2250,7 +2385,8 @@ void DebuggerParser::executeSaveState()
 // "saveStateIf"
 void DebuggerParser::executeSaveStateIf()
 {
-  if(YaccParser::parse(argStrings[0]) != 0)
+  auto program = myExpressions.get(argStrings[0]);
+  if(!program)
   {
     commandResult << red("invalid expression");
     return;
@@ -2268,7 +2404,7 @@ void DebuggerParser::executeSaveStateIf()
   }
 
   const uInt32 ret = debugger.m6502().addCondSaveState(
-    YaccParser::getResult(), argStrings[0]);
+    std::move(program), argStrings[0]);
   commandResult << "added saveStateIf " << Base::toString(ret);
 }
 
@@ -2294,13 +2430,13 @@ void DebuggerParser::executeStep()
 // "stepWhile"
 void DebuggerParser::executeStepWhile()
 {
-  if(YaccParser::parse(argStrings[0]) != 0)
+  const auto program = myExpressions.get(argStrings[0]);
+  if(!program)
   {
     commandResult << red("invalid expression");
     return;
   }
 
-  const Expression* expr = YaccParser::getResult();
   int ncycles = 0;
 
   // Create a progress dialog box to show the progress searching through the
@@ -2315,7 +2451,7 @@ void DebuggerParser::executeStepWhile()
   do {
     ncycles += debugger.step(false);
     progress.incProgress();
-  } while(expr->evaluate() && !progress.isCancelled());
+  } while(program->evaluate() && !progress.isCancelled());
 
   progress.close();
   std::format_to(std::ostreambuf_iterator(commandResult),
@@ -2338,6 +2474,74 @@ void DebuggerParser::executeTia()
   commandResult << debugger.tiaDebug().toString();
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// "tiaCapture"
+void DebuggerParser::executeTiaCapture()
+{
+  TIA& tia = debugger.tiaDebug().tia();
+
+  if(tia.isCapturing())
+  {
+    commandResult << "tiaCapture stopped, " << dec << tia.stopCapture()
+                  << " writes captured";
+    return;
+  }
+
+  const string path = argCount
+    ? argStrings[0]
+    : debugger.myOSystem.userDir().getPath() + cartName() + ".stia";
+
+  if(!tia.startCapture(path))
+  {
+    commandResult << red("failed to create capture file " + path);
+    return;
+  }
+  commandResult << "tiaCapture started (" << path << ")";
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// "tiaHistory"
+void DebuggerParser::executeTiaHistory()
+{
+  TIA& tia = debugger.tiaDebug().tia();
+  const bool enable = !tia.registerHistoryEnabled();
+
+  tia.enableRegisterHistory(enable);
+  commandResult << "TIA register history " << (enable ? "enabled" : "disabled");
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// "tiaReplay"
+void DebuggerParser::executeTiaReplay()
+{
+  TIA& tia = debugger.tiaDebug().tia();
+
+  if(tia.isReplaying())
+  {
+    commandResult << "tiaReplay stopped, " << dec << tia.stopReplay()
+                  << " writes replayed";
+    return;
+  }
+
+  const string path = argCount
+    ? argStrings[0]
+    : debugger.myOSystem.userDir().getPath() + cartName() + ".stia";
+
+  if(!tia.startReplay(path))
+  {
+    commandResult << red("failed to load capture file " + path);
+    return;
+  }
+  commandResult << "tiaReplay started (" << path << ")";
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// "tiaWrites"
+void DebuggerParser::executeTiaWrites()
+{
+  commandResult << debugger.tiaDebug().registerHistory(argCount != 0 ? args[0] : -1);
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 // "timer"
 void DebuggerParser::executeTimer()
@@ -2457,6 +2661,53 @@ void DebuggerParser::executeTrace()
   commandResult << "executed " << dec << debugger.trace() << " cycles";
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// "traceFormat"
+void DebuggerParser::executeTraceFormat()
+{
+  const string inPath = argCount
+    ? argStrings[0]
+    : debugger.myOSystem.userDir().getPath() + cartName() + ".trace";
+  const string outPath = inPath + ".txt";
+
+  std::ofstream out(outPath);
+  if(!out || !TraceRecorder::format(inPath, out))
+  {
+    commandResult << red("failed to format trace file " + inPath);
+    return;
+  }
+  commandResult << "formatted trace as " << outPath;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// "traceRecord"
+void DebuggerParser::executeTraceRecord()
+{
+  TraceRecorder& recorder = debugger.m6502().traceRecorder();
+
+  if(recorder.isRecording())
+  {
+    const uInt64 dropped = recorder.stop();
+
+    commandResult << "traceRecord stopped, " << dec << recorder.recorded()
+                  << " instructions recorded";
+    if(dropped)
+      commandResult << red(std::format(", {} dropped", dropped));
+    return;
+  }
+
+  const string path = argCount
+    ? argStrings[0]
+    : debugger.myOSystem.userDir().getPath() + cartName() + ".trace";
+
+  if(!recorder.start(path))
+  {
+    commandResult << red("failed to create trace file " + path);
+    return;
+  }
+  commandResult << "traceRecord started (" << path << ")";
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 // "trap"
 void DebuggerParser::executeTrap()
@@ -2573,7 +2824,8 @@ void DebuggerParser::executeTraps(bool read, bool write, string_view command,
   if(hasCond)
     condition += ')';
 
-  if(YaccParser::parse(condition) != 0)
+  auto program = myExpressions.get(condition);
+  if(!program)
   {
     commandResult << red("invalid expression");
     return;
@@ -2605,7 +2857,7 @@ void DebuggerParser::executeTraps(bool read, bool write, string_view command,
   else
   {
     const auto ret = debugger.m6502().addCondTrap(
-      YaccParser::getResult(), hasCond ? argStrings[0] : "");
+      std::move(program), hasCond ? argStrings[0] : "");
     commandResult << "added trap " << Base::toString(ret);
     myTraps.emplace_back(std::make_unique<Trap>(read, write, begin, end, condition));
     for(uInt32 addr = begin; addr <= end; ++addr)
@@ -2786,6 +3038,19 @@ DebuggerParser::CommandArray DebuggerParser::commands = { {
     &DebuggerParser::executeA
   },
 
+  {
+    "armProfile",
+    "Profile ARM code by function",
+    "Argument is on|off|reset|flat|stacks (default flat)\n"
+    "'flat' shows the cycles per function, 'stacks' saves them as\n"
+    "collapsed stacks (for flame graphs) to <cartname>.folded\n"
+    "Example: armProfile on, armProfile, armProfile stacks",
+    false,
+    false,
+    { Parameters::ARG_LABEL, Parameters::ARG_END_ARGS },
+    &DebuggerParser::executeArmProfile
+  },
+
   {
     "aud",
     "Mark 'AUD' range in disassembly",
@@ -3134,6 +3399,17 @@ DebuggerParser::CommandArray DebuggerParser::commands = { {
     &DebuggerParser::executeExitRom
   },
 
+  {
+    "findState",
+    "Wind to first rewind state where <condition> is true",
+    "Condition may only use memory and labels, see documentation\n"
+    "Example: findState *lives==0",
+    true,
+    false,
+    { Parameters::ARG_WORD, Parameters::ARG_END_ARGS },
+    &DebuggerParser::executeFindState
+  },
+
   {
     "frame",
     "Advance emulation by <xx> frames (default=1)",
@@ -3144,6 +3420,16 @@ DebuggerParser::CommandArray DebuggerParser::commands = { {
     &DebuggerParser::executeFrame
   },
 
+  {
+    "frameTimes",
+    "Show percentiles of the last displayed frames' times",
+    "Example: frameTimes (no parameters)",
+    false,
+    false,
+    { Parameters::ARG_END_ARGS },
+    &DebuggerParser::executeFrameTimes
+  },
+
   {
     "function",
     "Define function name xx for expression yy",
@@ -3405,6 +3691,16 @@ DebuggerParser::CommandArray DebuggerParser::commands = { {
     &DebuggerParser::executeLogTrace
   },
 
+  {
+    "memory",
+    "Show memory used by the emulator subsystems",
+    "Example: memory (no parameters)",
+    false,
+    false,
+    { Parameters::ARG_END_ARGS },
+    &DebuggerParser::executeMemory
+  },
+
   {
     "n",
     "Negative Flag: set (0 or 1), or toggle (no arg)",
@@ -3476,6 +3772,19 @@ DebuggerParser::CommandArray DebuggerParser::commands = { {
     &DebuggerParser::executePrintTimer
   },
 
+  {
+    "profile",
+    "Profile 6502 routines by JSR/RTS",
+    "Argument is on|off|reset|show|graph|stacks (default show)\n"
+    "'show' lists the inclusive/exclusive cycles per routine, 'graph' saves\n"
+    "the call graph (<cartname>.dot), 'stacks' the collapsed stacks\n"
+    "(<cartname>.folded)\nExample: profile on, profile, profile graph",
+    false,
+    false,
+    { Parameters::ARG_LABEL, Parameters::ARG_END_ARGS },
+    &DebuggerParser::executeProfile
+  },
+
   {
     "ram",
     "Show ZP RAM, or set address xx to yy1 [yy2 ...]",
@@ -3744,6 +4053,52 @@ DebuggerParser::CommandArray DebuggerParser::commands = { {
     &DebuggerParser::executeTia
   },
 
+  {
+    "tiaCapture",
+    "Toggle capturing the TIA register writes [to file xx]",
+    "Captures every TIA register write, for re-rendering with tiaReplay\n"
+    "Example: tiaCapture, tiaCapture myfile.stia\n"
+    "NOTE: writes to user dir by default",
+    false,
+    false,
+    { Parameters::ARG_FILE, Parameters::ARG_END_ARGS },
+    &DebuggerParser::executeTiaCapture
+  },
+
+  {
+    "tiaHistory",
+    "Toggle recording the TIA register writes",
+    "Records every TIA register write of the current and the last frame\n"
+    "Example: tiaHistory (no parameters)",
+    false,
+    false,
+    { Parameters::ARG_END_ARGS },
+    &DebuggerParser::executeTiaHistory
+  },
+
+  {
+    "tiaReplay",
+    "Toggle replaying captured TIA register writes [from file xx]",
+    "Feeds a tiaCapture file into the TIA, without emulating CPU or cartridge\n"
+    "Example: tiaReplay, tiaReplay myfile.stia\n"
+    "NOTE: reads from user dir by default",
+    false,
+    false,
+    { Parameters::ARG_FILE, Parameters::ARG_END_ARGS },
+    &DebuggerParser::executeTiaReplay
+  },
+
+  {
+    "tiaWrites",
+    "Show recorded TIA register writes [of scanline xx] in current frame",
+    "Requires tiaHistory to be enabled\n"
+    "Example: tiaWrites, tiaWrites 50",
+    false,
+    false,
+    { Parameters::ARG_WORD, Parameters::ARG_END_ARGS },
+    &DebuggerParser::executeTiaWrites
+  },
+
   {
     "timer",
     "Set a cycle counting timer from addresses xx to yy [banks aa bb]",
@@ -3765,6 +4120,30 @@ DebuggerParser::CommandArray DebuggerParser::commands = { {
     &DebuggerParser::executeTrace
   },
 
+  {
+    "traceFormat",
+    "Convert a binary trace file [xx] into text",
+    "Writes the disassembled trace to <file>.txt\n"
+    "Example: traceFormat, traceFormat myfile.trace\n"
+    "NOTE: reads from user dir by default",
+    false,
+    false,
+    { Parameters::ARG_FILE, Parameters::ARG_END_ARGS },
+    &DebuggerParser::executeTraceFormat
+  },
+
+  {
+    "traceRecord",
+    "Toggle recording a binary trace [to file xx]",
+    "Records every executed instruction with negligible slowdown\n"
+    "Example: traceRecord, traceRecord myfile.trace\n"
+    "NOTE: writes to user dir by default, use traceFormat to view",
+    false,
+    false,
+    { Parameters::ARG_FILE, Parameters::ARG_END_ARGS },
+    &DebuggerParser::executeTraceRecord
+  },
+
   {
     "trap",
     "Trap read/write access to address(es) xx [yy]",
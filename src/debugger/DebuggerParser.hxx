@@ -28,6 +28,7 @@ struct Command;
 #include "bspf.hxx"
 #include "Device.hxx"
 #include "FrameBufferConstants.hxx"
+#include "ExpressionCache.hxx"
 
 class DebuggerParser
 {
@@ -97,7 +98,7 @@ class DebuggerParser
       array<Parameters, 10> parms;
       void (DebuggerParser::*executor)();
     };
-    using CommandArray = std::array<Command, 112>;
+    using CommandArray = std::array<Command, 123>;
     static CommandArray commands;
 
     struct Trap
@@ -133,6 +134,9 @@ class DebuggerParser
 
     StringList myWatches;
 
+    // Compiled programs of the expressions parsed so far
+    ExpressionCache myExpressions;
+
     // Keep track of traps (read and/or write)
     vector<unique_ptr<Trap>> myTraps;  // TODO: do these really need to be pointers?
     void listTraps(bool listCond);
@@ -149,6 +153,7 @@ class DebuggerParser
 
     // List of available command methods
     void executeA();
+    void executeArmProfile();
     void executeAud();
     void executeAutoSave();
     void executeBase();
@@ -183,7 +188,9 @@ class DebuggerParser
     void executeDump();
     void executeExec();
     void executeExitRom();
+    void executeFindState();
     void executeFrame();
+    void executeFrameTimes();
     void executeFunction();
     void executeGfx();
     void executeHelp();
@@ -210,6 +217,7 @@ class DebuggerParser
     void executeLogBreaks();
     void executeLogExec();
     void executeLogTrace();
+    void executeMemory();
     void executeN();
     void executePalette();
     void executePc();
@@ -217,6 +225,7 @@ class DebuggerParser
     void executePGfx();
     void executePrint();
     void executePrintTimer();
+    void executeProfile();
     void executeRam();
     void executeReset();
     void executeResetTimers();
@@ -243,8 +252,14 @@ class DebuggerParser
     void executeStepWhile();
     void executeSwchb();
     void executeTia();
+    void executeTiaCapture();
+    void executeTiaHistory();
+    void executeTiaReplay();
+    void executeTiaWrites();
     void executeTimer();
     void executeTrace();
+    void executeTraceFormat();
+    void executeTraceRecord();
     void executeTrap();
     void executeTrapIf();
     void executeTrapRead();
@@ -26,11 +26,13 @@ DiStella::DiStella(const CartDebug& dbg, CartDebug::DisassemblyList& list,
                    CartDebug::BankInfo& info, const DiStella::Settings& s,
                    CartDebug::AddrTypeArray& labels,
                    CartDebug::AddrTypeArray& directives,
-                   CartDebug::ReservedEquates& reserved)
+                   CartDebug::ReservedEquates& reserved,
+                   Snapshot* snapshot)
   : myDbg{dbg},
     myList{list},
     mySettings{s},
     myReserved{reserved},
+    mySnapshot{snapshot},
     myOffset{info.offset},
     myLabels{labels},
     myDirectives{directives}
@@ -192,7 +194,7 @@ void DiStella::disasm(uInt32 distart, int pass)
         mark(myPC + myOffset, Device::VALID_ENTRY);
 
       // get opcode
-      opcode = Debugger::debugger().peek(myPC + myOffset);
+      opcode = peek(myPC + myOffset);
       // get address mode for opcode
       addrMode = ourLookup[opcode].addr_mode;
 
@@ -217,7 +219,7 @@ void DiStella::disasm(uInt32 distart, int pass)
           // the opcode's operand address matches a label address
           if(pass == 3) {
             // output the byte of the opcode incl. cycles
-            const uInt8 nextOpcode = Debugger::debugger().peek(myPC + myOffset);
+            const uInt8 nextOpcode = peek(myPC + myOffset);
 
             cycles += static_cast<int>(ourLookup[opcode].cycles) -
                       static_cast<int>(ourLookup[nextOpcode].cycles);
@@ -278,7 +280,7 @@ void DiStella::disasm(uInt32 distart, int pass)
                 else
                   myDisasmBuf << Base::HEX4 << myPC + myOffset << "'     '";
 
-                opcode = Debugger::debugger().peek(myPC + myOffset);  ++myPC;
+                opcode = peek(myPC + myOffset);  ++myPC;
                 myDisasmBuf << ".byte $" << Base::HEX2 << static_cast<int>(opcode);
                 addEntry(Device::DATA);
               }
@@ -324,7 +326,7 @@ void DiStella::disasm(uInt32 distart, int pass)
 
         case AddressingMode::ABSOLUTE:
         {
-          ad = Debugger::debugger().dpeek(myPC + myOffset);  myPC += 2;
+          ad = dpeek(myPC + myOffset);  myPC += 2;
           labelFound = mark(ad, Device::REFERENCED);
           if(pass == 3) {
             if(ad < 0x100 && mySettings.fFlag)
@@ -361,7 +363,7 @@ void DiStella::disasm(uInt32 distart, int pass)
 
         case AddressingMode::ZERO_PAGE:
         {
-          d1 = Debugger::debugger().peek(myPC + myOffset);  ++myPC;
+          d1 = peek(myPC + myOffset);  ++myPC;
           labelFound = mark(d1, Device::REFERENCED);
           if(pass == 3) {
             nextLine << "     ";
@@ -373,7 +375,7 @@ void DiStella::disasm(uInt32 distart, int pass)
 
         case AddressingMode::IMMEDIATE:
         {
-          d1 = Debugger::debugger().peek(myPC + myOffset);
+          d1 = peek(myPC + myOffset);
           if(pass == 3) {
             if (checkBits(myPC, Device::COL | Device::PCOL | Device::BCOL,
                 /*Device::CODE |*/ Device::GFX | Device::PGFX))
@@ -388,7 +390,7 @@ void DiStella::disasm(uInt32 distart, int pass)
 
         case AddressingMode::ABSOLUTE_X:
         {
-          ad = Debugger::debugger().dpeek(myPC + myOffset);  myPC += 2;
+          ad = dpeek(myPC + myOffset);  myPC += 2;
           labelFound = mark(ad, Device::REFERENCED);
           if(pass == 2 && !checkBit(ad & myAppData.end, Device::CODE)) {
             // Since we can't know what address is being accessed unless we also
@@ -435,7 +437,7 @@ void DiStella::disasm(uInt32 distart, int pass)
 
         case AddressingMode::ABSOLUTE_Y:
         {
-          ad = Debugger::debugger().dpeek(myPC + myOffset);  myPC += 2;
+          ad = dpeek(myPC + myOffset);  myPC += 2;
           labelFound = mark(ad, Device::REFERENCED);
           if(pass == 2 && !checkBit(ad & myAppData.end, Device::CODE)) {
             // Since we can't know what address is being accessed unless we also
@@ -482,7 +484,7 @@ void DiStella::disasm(uInt32 distart, int pass)
 
         case AddressingMode::INDIRECT_X:
         {
-          d1 = Debugger::debugger().peek(myPC + myOffset);  ++myPC;
+          d1 = peek(myPC + myOffset);  ++myPC;
           if(pass == 3) {
             labelFound = mark(d1, 0);  // dummy call to get address type
             nextLine << "     (";
@@ -495,7 +497,7 @@ void DiStella::disasm(uInt32 distart, int pass)
 
         case AddressingMode::INDIRECT_Y:
         {
-          d1 = Debugger::debugger().peek(myPC + myOffset);  ++myPC;
+          d1 = peek(myPC + myOffset);  ++myPC;
           if(pass == 3) {
             labelFound = mark(d1, 0);  // dummy call to get address type
             nextLine << "     (";
@@ -508,7 +510,7 @@ void DiStella::disasm(uInt32 distart, int pass)
 
         case AddressingMode::ZERO_PAGE_X:
         {
-          d1 = Debugger::debugger().peek(myPC + myOffset);  ++myPC;
+          d1 = peek(myPC + myOffset);  ++myPC;
           labelFound = mark(d1, Device::REFERENCED);
           if(pass == 3) {
             nextLine << "     ";
@@ -521,7 +523,7 @@ void DiStella::disasm(uInt32 distart, int pass)
 
         case AddressingMode::ZERO_PAGE_Y:
         {
-          d1 = Debugger::debugger().peek(myPC + myOffset);  ++myPC;
+          d1 = peek(myPC + myOffset);  ++myPC;
           labelFound = mark(d1, Device::REFERENCED);
           if(pass == 3) {
             nextLine << "     ";
@@ -537,7 +539,7 @@ void DiStella::disasm(uInt32 distart, int pass)
           // SA - 04-06-2010: there seemed to be a bug in distella,
           // where wraparound occurred on a 32-bit int, and subsequent
           // indexing into the labels array caused a crash
-          d1 = Debugger::debugger().peek(myPC + myOffset);  ++myPC;
+          d1 = peek(myPC + myOffset);  ++myPC;
           ad = ((myPC + static_cast<Int8>(d1)) & 0xfff) + myOffset;
 
           labelFound = mark(ad, Device::REFERENCED);
@@ -556,7 +558,7 @@ void DiStella::disasm(uInt32 distart, int pass)
 
         case AddressingMode::ABS_INDIRECT:
         {
-          ad = Debugger::debugger().dpeek(myPC + myOffset);  myPC += 2;
+          ad = dpeek(myPC + myOffset);  myPC += 2;
           labelFound = mark(ad, Device::REFERENCED);
           if(pass == 2 && !checkBit(ad & myAppData.end, Device::CODE)) {
             // Since we can't know what address is being accessed unless we also
@@ -677,10 +679,10 @@ void DiStella::disasmPass1(CartDebug::AddressList& debuggerAddresses)
         if (checkBits(k, Device::Device::DATA | Device::GFX | Device::PGFX |
             Device::COL | Device::PCOL | Device::BCOL | Device::AUD,
             Device::CODE)) {
-          //if (Debugger::debugger().getAccessFlags(k) &
+          //if (getAccessFlags(k) &
           //    (Device::DATA | Device::GFX | Device::PGFX)) {
           // TODO: this should never happen, remove when we are sure
-          // TODO: NOT USED: uInt16 flags = Debugger::debugger().getAccessFlags(k);
+          // TODO: NOT USED: uInt16 flags = getAccessFlags(k);
           myPCEnd = k - 1;
           break;
         }
@@ -716,7 +718,7 @@ void DiStella::disasmPass1(CartDebug::AddressList& debuggerAddresses)
     // Stella itself can provide hints on whether an address has ever
     // been referenced as CODE
     while (myAddressQueue.empty() && std::cmp_less_equal(codeAccessPoint, myAppData.end)) {
-      if ((Debugger::debugger().getAccessFlags(codeAccessPoint + myOffset) & Device::CODE)
+      if ((getAccessFlags(codeAccessPoint + myOffset) & Device::CODE)
           && !(myLabels[codeAccessPoint & myAppData.end] & Device::CODE)) {
         myAddressQueue.push(codeAccessPoint + myOffset);
         ++codeAccessPoint;
@@ -730,9 +732,9 @@ void DiStella::disasmPass1(CartDebug::AddressList& debuggerAddresses)
   for (int k = 0; std::cmp_less_equal(k, myAppData.end); k++) {
     // Let the emulation core know about tentative code
     if (checkBit(k, Device::CODE) &&
-      !(Debugger::debugger().getAccessFlags(k + myOffset) & Device::CODE)
+      !(getAccessFlags(k + myOffset) & Device::CODE)
       && myOffset != 0) {
-      Debugger::debugger().setAccessFlags(k + myOffset, Device::TCODE);
+      setAccessFlags(k + myOffset, Device::TCODE);
     }
 
     // Must be ROW / unused bytes
@@ -765,7 +767,7 @@ void DiStella::disasmFromAddress(uInt32 distart)
 
     // so this should be code now...
     // get opcode
-    opcode = Debugger::debugger().peek(myPC + myOffset);  ++myPC;
+    opcode = peek(myPC + myOffset);  ++myPC;
     // get address mode for opcode
     addrMode = ourLookup[opcode].addr_mode;
 
@@ -801,7 +803,7 @@ void DiStella::disasmFromAddress(uInt32 distart)
     // Add operand(s)
     switch (addrMode) {
       case AddressingMode::ABSOLUTE:
-        ad = Debugger::debugger().dpeek(myPC + myOffset);  myPC += 2;
+        ad = dpeek(myPC + myOffset);  myPC += 2;
         mark(ad, Device::REFERENCED);
         // handle JMP/JSR
         if (ourLookup[opcode].source == AccessMode::ADDR) {
@@ -818,7 +820,7 @@ void DiStella::disasmFromAddress(uInt32 distart)
       case AddressingMode::ABSOLUTE_X:
       case AddressingMode::ABSOLUTE_Y:
       case AddressingMode::ABS_INDIRECT:
-        ad = Debugger::debugger().dpeek(myPC + myOffset);  myPC += 2;
+        ad = dpeek(myPC + myOffset);  myPC += 2;
         mark(ad, Device::REFERENCED);
         break;
 
@@ -831,7 +833,7 @@ void DiStella::disasmFromAddress(uInt32 distart)
       case AddressingMode::ZERO_PAGE:
       case AddressingMode::ZERO_PAGE_X:
       case AddressingMode::ZERO_PAGE_Y:
-        d1 = Debugger::debugger().peek(myPC + myOffset);  ++myPC;
+        d1 = peek(myPC + myOffset);  ++myPC;
         mark(d1, Device::REFERENCED);
         break;
 
@@ -839,7 +841,7 @@ void DiStella::disasmFromAddress(uInt32 distart)
         // SA - 04-06-2010: there seemed to be a bug in distella,
         // where wraparound occurred on a 32-bit int, and subsequent
         // indexing into the labels array caused a crash
-        d1 = Debugger::debugger().peek(myPC + myOffset);  ++myPC;
+        d1 = peek(myPC + myOffset);  ++myPC;
         ad = ((myPC + static_cast<Int8>(d1)) & 0xfff) + myOffset;
         mark(ad, Device::REFERENCED);
         // do NOT use flags set by debugger, else known CODE will not analyzed statically.
@@ -855,7 +857,7 @@ void DiStella::disasmFromAddress(uInt32 distart)
 
     // mark BRK vector
     if (opcode == 0x00) {
-      ad = Debugger::debugger().dpeek(0xfffe, Device::DATA);
+      ad = dpeek(0xfffe, Device::DATA);
       if (!myReserved.breakFound) {
         myAddressQueue.push(ad);
         mark(ad, Device::CODE);
@@ -964,7 +966,7 @@ bool DiStella::checkBit(uInt16 address, uInt16 mask, bool useDebugger) const
   const uInt16 label = myLabels[address & myAppData.end],
     lastbits = label & (Device::REFERENCED | Device::VALID_ENTRY),
     directive = myDirectives[address & myAppData.end] & ~(Device::REFERENCED | Device::VALID_ENTRY),
-    debugger = Debugger::debugger().getAccessFlags(address | myOffset) & ~(Device::REFERENCED | Device::VALID_ENTRY);
+    debugger = getAccessFlags(address | myOffset) & ~(Device::REFERENCED | Device::VALID_ENTRY);
 
   // Any address marked by a manual directive always takes priority
   if (directive)
@@ -1053,10 +1055,10 @@ void DiStella::addEntry(Device::AccessType type)
       // but it could also indicate that code will *never* be accessed
       // Since it is impossible to tell the difference, marking the address
       // in the disassembly at least tells the user about it
-      if (!(Debugger::debugger().getAccessFlags(tag.address) & Device::CODE)
+      if (!(getAccessFlags(tag.address) & Device::CODE)
           && myOffset != 0) {
         tag.ccount += " *";
-        Debugger::debugger().setAccessFlags(tag.address, Device::TCODE);
+        setAccessFlags(tag.address, Device::TCODE);
       }
       break;
 
@@ -1092,7 +1094,7 @@ void DiStella::outputGraphics()
 {
   const bool isPGfx = checkBit(myPC, Device::PGFX);
   const string& bitString = isPGfx ? "\x1f" : "\x1e";
-  const uInt8 byte = Debugger::debugger().peek(myPC + myOffset);
+  const uInt8 byte = peek(myPC + myOffset);
 
   // add extra spacing line when switching from non-graphics to graphics
   if (mySegType != Device::GFX && mySegType != Device::NONE) {
@@ -1120,7 +1122,7 @@ void DiStella::outputGraphics()
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void DiStella::outputColors()
 {
-  const uInt8 byte = Debugger::debugger().peek(myPC + myOffset);
+  const uInt8 byte = peek(myPC + myOffset);
 
   // add extra spacing line when switching from non-colors to colors
   if(mySegType != Device::COL && mySegType != Device::NONE)
@@ -1217,14 +1219,14 @@ void DiStella::outputBytes(Device::AccessType type)
 
       myDisasmBuf << Base::HEX4 << myPC + myOffset << "'L" << Base::HEX4
         << myPC + myOffset << "'.byte " << "$" << Base::HEX2
-        << static_cast<int>(Debugger::debugger().peek(myPC + myOffset));
+        << static_cast<int>(peek(myPC + myOffset));
       ++myPC;
       numBytes = 1;
       lineEmpty = false;
     } else if (lineEmpty) {
       // start a new line without a label
       myDisasmBuf << Base::HEX4 << myPC + myOffset << "'     '"
-        << ".byte $" << Base::HEX2 << static_cast<int>(Debugger::debugger().peek(myPC + myOffset));
+        << ".byte $" << Base::HEX2 << static_cast<int>(peek(myPC + myOffset));
       ++myPC;
       numBytes = 1;
       lineEmpty = false;
@@ -1234,7 +1236,7 @@ void DiStella::outputBytes(Device::AccessType type)
       addEntry(type);
       lineEmpty = true;
     } else {
-      myDisasmBuf << ",$" << Base::HEX2 << static_cast<int>(Debugger::debugger().peek(myPC + myOffset));
+      myDisasmBuf << ",$" << Base::HEX2 << static_cast<int>(peek(myPC + myOffset));
       ++myPC;
     }
     isType = checkBits(myPC, type,
@@ -1259,6 +1261,108 @@ void DiStella::processDirectives(const CartDebug::DirectiveList& directives)
   }
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt8 DiStella::peek(uInt16 address, Device::AccessFlags flags)
+{
+  if(!mySnapshot)
+    return Debugger::debugger().peek(address, flags);
+
+  // Only an instruction at the very end of the address space reads
+  // from outside of the cartridge
+  if(!(address & 0x1000))
+    return mySnapshot->wrap[address & 0x1];
+
+  mySnapshot->access[address & 0xFFF] |= flags | (address & Device::HADDR);
+  return mySnapshot->rom[address & 0xFFF];
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt16 DiStella::dpeek(uInt16 address, Device::AccessFlags flags)
+{
+  if(!mySnapshot)
+    return Debugger::debugger().dpeek(address, flags);
+
+  return static_cast<uInt16>(peek(address, flags) |
+                             (peek(address + 1, flags) << 8));
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+Device::AccessFlags DiStella::getAccessFlags(uInt16 address) const
+{
+  if(!mySnapshot)
+    return Debugger::debugger().getAccessFlags(address);
+
+  return (address & 0x1000)
+    ? mySnapshot->flags[address & 0xFFF] | mySnapshot->access[address & 0xFFF]
+    : Device::NONE;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void DiStella::setAccessFlags(uInt16 address, Device::AccessFlags flags)
+{
+  if(!mySnapshot)
+    Debugger::debugger().setAccessFlags(address, flags);
+  else if(address & 0x1000)
+    mySnapshot->access[address & 0xFFF] |= flags | (address & Device::HADDR);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void DiStella::Snapshot::take()
+{
+  Debugger& debugger = Debugger::debugger();
+
+  for(uInt16 addr = 0; addr < 0x1000; ++addr)
+  {
+    rom[addr] = debugger.peek(0x1000 | addr);
+    flags[addr] = debugger.getAccessFlags(0x1000 | addr);
+  }
+  wrap = { debugger.peek(0x0000), debugger.peek(0x0001) };
+  access.fill(Device::NONE);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void DiStella::Snapshot::apply() const
+{
+  Debugger& debugger = Debugger::debugger();
+
+  for(uInt16 addr = 0; addr < 0x1000; ++addr)
+    if(access[addr] != Device::NONE)
+      debugger.setAccessFlags((access[addr] & Device::HADDR) | 0x1000 | addr,
+                              access[addr] & ~Device::HADDR);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+string DiStella::disassembleInstruction(uInt16 pc, const std::array<uInt8, 3>& code)
+{
+  const Instruction_tag& inst = ourLookup[code[0]];
+  const int lo = code[1];
+  const int word = code[1] | (code[2] << 8);
+  std::ostringstream buf;
+
+  buf << inst.mnemonic;
+  switch(inst.addr_mode)
+  {
+    using enum AddressingMode;
+
+    case ACCUMULATOR:  buf << " a";                                  break;
+    case IMMEDIATE:    buf << " #$" << Base::HEX2 << lo;             break;
+    case ZERO_PAGE:    buf << " $" << Base::HEX2 << lo;              break;
+    case ZERO_PAGE_X:  buf << " $" << Base::HEX2 << lo << ",x";      break;
+    case ZERO_PAGE_Y:  buf << " $" << Base::HEX2 << lo << ",y";      break;
+    case ABSOLUTE:     buf << " $" << Base::HEX4 << word;            break;
+    case ABSOLUTE_X:   buf << " $" << Base::HEX4 << word << ",x";    break;
+    case ABSOLUTE_Y:   buf << " $" << Base::HEX4 << word << ",y";    break;
+    case ABS_INDIRECT: buf << " ($" << Base::HEX4 << word << ")";    break;
+    case INDIRECT_X:   buf << " ($" << Base::HEX2 << lo << ",x)";    break;
+    case INDIRECT_Y:   buf << " ($" << Base::HEX2 << lo << "),y";    break;
+    case RELATIVE:
+      buf << " $" << Base::HEX4 << ((pc + 2 + static_cast<Int8>(code[1])) & 0xFFFF);
+      break;
+    default:                                                         break;
+  }
+  return buf.str();
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 DiStella::Settings DiStella::settings;
 
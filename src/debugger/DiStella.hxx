@@ -54,6 +54,33 @@ class DiStella
     };
     static Settings settings;  // Default settings
 
+    /**
+      A copy of the cartridge address space and its access flags, taken
+      while the bank to disassemble is switched in.  Disassembling from a
+      snapshot doesn't access the System, so that several banks can be
+      disassembled in parallel.  The access flags set by the disassembly
+      are collected, and must be applied to the System afterwards.
+    */
+    struct Snapshot {
+      std::array<uInt8, 0x1000> rom{};
+      std::array<Device::AccessFlags, 0x1000> flags{};
+      // Flags (incl. the high address bits) set by the disassembly
+      std::array<Device::AccessFlags, 0x1000> access{};
+      // Operands of an instruction at the end of the address space
+      std::array<uInt8, 2> wrap{};
+
+      /**
+        Copy the currently visible cartridge address space.
+      */
+      void take();
+
+      /**
+        Apply the collected access flags; the same bank must be switched
+        in as when the snapshot was taken.
+      */
+      void apply() const;
+    };
+
   public:
     /**
       Disassemble the current state of the System from the given start address.
@@ -65,14 +92,28 @@ class DiStella
       @param labels      Array storing label info determined by Distella
       @param directives  Array storing directive info determined by Distella
       @param reserved    The TIA/RIOT addresses referenced in the disassembled code
+      @param snapshot    Disassemble from this snapshot instead of the System
     */
     DiStella(const CartDebug& dbg, CartDebug::DisassemblyList& list,
              CartDebug::BankInfo& info, const DiStella::Settings& settings,
              CartDebug::AddrTypeArray& labels,
              CartDebug::AddrTypeArray& directives,
-             CartDebug::ReservedEquates& reserved);
+             CartDebug::ReservedEquates& reserved,
+             Snapshot* snapshot = nullptr);
     ~DiStella() = default;
 
+    /**
+      Disassemble a single instruction from its opcode and operand bytes,
+      without any labels.  This is used for formatting recorded execution
+      traces, where the code may have been in another bank than the
+      current one.
+
+      @param pc    The address of the instruction
+      @param code  The opcode, followed by up to two operand bytes
+      @return  The disassembled instruction
+    */
+    static string disassembleInstruction(uInt16 pc, const std::array<uInt8, 3>& code);
+
   private:
     /**
       Enumeration of the addressing type (RAM, ROM, RIOT, TIA...)
@@ -111,6 +152,12 @@ class DiStella
     string getColor(uInt8 byte);
     void outputBytes(Device::AccessType type);
 
+    // Access memory and access flags, either in the System or the snapshot
+    uInt8 peek(uInt16 address, Device::AccessFlags flags = Device::NONE);
+    uInt16 dpeek(uInt16 address, Device::AccessFlags flags = Device::NONE);
+    Device::AccessFlags getAccessFlags(uInt16 address) const;
+    void setAccessFlags(uInt16 address, Device::AccessFlags flags);
+
     // Convenience methods to generate appropriate labels
     void labelA12High(std::ostringstream& buf, uInt8 op, uInt16 addr, AddressType labfound)
     {
@@ -139,6 +186,7 @@ class DiStella
     CartDebug::DisassemblyList& myList;
     const Settings& mySettings;
     CartDebug::ReservedEquates& myReserved;
+    Snapshot* mySnapshot{nullptr};
     std::stringstream myDisasmBuf;
     std::queue<uInt16> myAddressQueue;
     uInt16 myOffset{0}, myPC{0}, myPCEnd{0};
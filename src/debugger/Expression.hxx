@@ -18,6 +18,8 @@
 #ifndef EXPRESSION_HXX
 #define EXPRESSION_HXX
 
+class ExpressionProgram;
+
 #include "bspf.hxx"
 
 /**
@@ -37,6 +39,13 @@ class Expression
 
     virtual Int32 evaluate() const { return 0; }
 
+    /**
+      Append the postfix code for this expression to the given program
+      (see ExpressionProgram).  By default the node is evaluated by calling
+      back into evaluate() from the program.
+    */
+    virtual void compile(ExpressionProgram& program) const;
+
   protected:
     unique_ptr<Expression> myLHS, myRHS;
 
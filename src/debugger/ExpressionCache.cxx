@@ -0,0 +1,77 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2026 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+
+#include "Debugger.hxx"
+#include "CartDebug.hxx"
+#include "ExpressionProgram.hxx"
+#include "YaccParser.hxx"
+#include "ExpressionCache.hxx"
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+shared_ptr<const ExpressionProgram> ExpressionCache::get(string_view expression)
+{
+  const Debugger& debugger = Debugger::debugger();
+  const uInt32 labelGeneration = debugger.cartDebug().labelGeneration();
+  const uInt32 functionGeneration = debugger.functionGeneration();
+
+  if(labelGeneration != myLabelGeneration ||
+     functionGeneration != myFunctionGeneration)
+  {
+    myPrograms.clear();
+    myLabelGeneration = labelGeneration;
+    myFunctionGeneration = functionGeneration;
+  }
+
+  string key = normalize(expression);
+  if(const auto it = myPrograms.find(key); it != myPrograms.end())
+    return it->second;
+
+  if(YaccParser::parse(key) != 0)
+    return nullptr;
+
+  if(myPrograms.size() >= MAX_PROGRAMS)
+    myPrograms.clear();
+
+  auto program = std::make_shared<const ExpressionProgram>(YaccParser::getResult());
+  myPrograms.emplace(std::move(key), program);
+
+  return program;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+string ExpressionCache::normalize(string_view expression)
+{
+  // Trim, and collapse all other whitespace into single spaces
+  string result;
+  bool space = false;
+
+  result.reserve(expression.size());
+  for(const char c: expression)
+  {
+    if(std::isspace(static_cast<unsigned char>(c)))
+      space = !result.empty();
+    else
+    {
+      if(space)
+        result += ' ';
+      result += c;
+      space = false;
+    }
+  }
+  return result;
+}
@@ -0,0 +1,80 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2026 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+
+#ifndef EXPRESSION_CACHE_HXX
+#define EXPRESSION_CACHE_HXX
+
+#include <unordered_map>
+
+class ExpressionProgram;
+
+#include "bspf.hxx"
+
+/**
+  This class caches the compiled programs of parsed expressions, keyed by
+  their (whitespace normalized) source text.  Commands like 'breakIf',
+  'trapIf', 'saveStateIf' or braced arguments in scripts are often given the
+  same expressions over and over again, and each program is parsed and
+  compiled only once.
+
+  How identifiers are parsed depends on the labels and user defined
+  functions, so the cache is dropped whenever these change.
+
+  @author  Stella Team
+*/
+class ExpressionCache
+{
+  public:
+    ExpressionCache() = default;
+    ~ExpressionCache() = default;
+
+    /**
+      Answer the compiled program of the given expression, parsing it only
+      if it is not cached yet.  The program may be shared with earlier
+      callers, and must not be modified.
+
+      @param expression  The expression source text
+      @return  The program, or nullptr if the expression is invalid
+               (see YaccParser::errorMessage())
+    */
+    shared_ptr<const ExpressionProgram> get(string_view expression);
+
+    void clear() { myPrograms.clear(); }
+
+  private:
+    static string normalize(string_view expression);
+
+  private:
+    std::unordered_map<string, shared_ptr<const ExpressionProgram>> myPrograms;
+
+    // Generations of the labels and functions the programs were parsed with
+    uInt32 myLabelGeneration{0};
+    uInt32 myFunctionGeneration{0};
+
+    // Limit the cache for scripts generating many different expressions
+    static constexpr size_t MAX_PROGRAMS = 1024;
+
+  private:
+    // Following constructors and assignment operators not supported
+    ExpressionCache(const ExpressionCache&) = delete;
+    ExpressionCache(ExpressionCache&&) = delete;
+    ExpressionCache& operator=(const ExpressionCache&) = delete;
+    ExpressionCache& operator=(ExpressionCache&&) = delete;
+};
+
+#endif
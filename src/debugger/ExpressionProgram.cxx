@@ -0,0 +1,256 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2026 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#include "Debugger.hxx"
+#include "DebuggerExpressions.hxx"
+#include "System.hxx"
+#include "ExpressionProgram.hxx"
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Expression::compile(ExpressionProgram& program) const
+{
+  program.emitEval(*this);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+ExpressionProgram::ExpressionProgram(Expression* expr)
+  : myExpression{expr}
+{
+  myExpression->compile(*this);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void ExpressionProgram::emit(Op op, Int32 value)
+{
+  myCode.push_back({op, value});
+
+  // Track the stack depth, so that evaluate() never needs to allocate
+  switch(op)
+  {
+    using enum Op;
+
+    case Const: case Eval:
+    case CpuMethod: case CartMethod: case RiotMethod: case TiaMethod:
+      ++myDepth;
+      if(myDepth > myStack.size())
+        myStack.resize(myDepth);
+      break;
+
+    case ByteDeref: case WordDeref: case UnaryMinus: case BinNot:
+    case LogNot: case HiByte: case LoByte: case Bool:
+      break;
+
+    default:  // binary operators and jumps
+      --myDepth;
+      break;
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void ExpressionProgram::emitEval(const Expression& expr)
+{
+  myNodes.push_back(&expr);
+  emit(Op::Eval, static_cast<Int32>(myNodes.size() - 1));
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void ExpressionProgram::emitMethod(CpuMethod method)
+{
+  myCpuMethods.push_back(method);
+  emit(Op::CpuMethod, static_cast<Int32>(myCpuMethods.size() - 1));
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void ExpressionProgram::emitMethod(CartMethod method)
+{
+  myCartMethods.push_back(method);
+  emit(Op::CartMethod, static_cast<Int32>(myCartMethods.size() - 1));
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void ExpressionProgram::emitMethod(RiotMethod method)
+{
+  myRiotMethods.push_back(method);
+  emit(Op::RiotMethod, static_cast<Int32>(myRiotMethods.size() - 1));
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void ExpressionProgram::emitMethod(TiaMethod method)
+{
+  myTiaMethods.push_back(method);
+  emit(Op::TiaMethod, static_cast<Int32>(myTiaMethods.size() - 1));
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+size_t ExpressionProgram::emitJump(Op op)
+{
+  emit(op);
+  return myCode.size() - 1;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void ExpressionProgram::patchJump(size_t jump)
+{
+  myCode[jump].value = static_cast<Int32>(myCode.size());
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+Int32 ExpressionProgram::evaluate() const
+{
+  Debugger& debugger = Debugger::debugger();
+
+  return run([&debugger](uInt16 addr) { return debugger.peek(addr); },
+             myStack.data());
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+Int32 ExpressionProgram::evaluate(System& system, vector<Int32>& stack) const
+{
+  stack.resize(myStack.size());
+
+  return run([&system](uInt16 addr) { return system.peekOob(addr); },
+             stack.data());
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool ExpressionProgram::resolveLabels()
+{
+  for(Instruction& inst: myCode)
+  {
+    switch(inst.op)
+    {
+      using enum Op;
+
+      case Eval:
+      {
+        if(dynamic_cast<const EquateExpression*>(myNodes[inst.value]) == nullptr)
+          return false;
+
+        inst = {Const, myNodes[inst.value]->evaluate()};
+        break;
+      }
+      case CpuMethod: case CartMethod: case RiotMethod: case TiaMethod:
+        return false;
+
+      default:
+        break;
+    }
+  }
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+template<typename Peek>
+Int32 ExpressionProgram::run(const Peek& peek, Int32* sp) const
+{
+  // sp points behind the top value
+  size_t pc = 0;
+
+  while(pc < myCode.size())
+  {
+    const Instruction& inst = myCode[pc++];
+
+    switch(inst.op)
+    {
+      using enum Op;
+
+      case Const:
+        *sp++ = inst.value;
+        break;
+      case Eval:
+        *sp++ = myNodes[inst.value]->evaluate();
+        break;
+      case CpuMethod:
+        *sp++ = (Debugger::debugger().cpuDebug().*myCpuMethods[inst.value])();
+        break;
+      case CartMethod:
+        *sp++ = (Debugger::debugger().cartDebug().*myCartMethods[inst.value])();
+        break;
+      case RiotMethod:
+        *sp++ = (Debugger::debugger().riotDebug().*myRiotMethods[inst.value])();
+        break;
+      case TiaMethod:
+        *sp++ = (Debugger::debugger().tiaDebug().*myTiaMethods[inst.value])();
+        break;
+
+      case ByteDeref:
+        sp[-1] = peek(static_cast<uInt16>(sp[-1]));
+        break;
+      case WordDeref:
+        sp[-1] = peek(static_cast<uInt16>(sp[-1])) |
+                 (peek(static_cast<uInt16>(sp[-1] + 1)) << 8);
+        break;
+      case UnaryMinus:
+        sp[-1] = -sp[-1];
+        break;
+      case BinNot:
+        sp[-1] = ~sp[-1];
+        break;
+      case LogNot:
+        sp[-1] = !sp[-1];
+        break;
+      case HiByte:
+        sp[-1] = 0xff & (sp[-1] >> 8);
+        break;
+      case LoByte:
+        sp[-1] = 0xff & sp[-1];
+        break;
+      case Bool:
+        sp[-1] = sp[-1] != 0;
+        break;
+
+      case JumpIfFalse:
+        if(sp[-1] == 0)  pc = inst.value;
+        else             --sp;
+        break;
+      case JumpIfTrue:
+        if(sp[-1] != 0)  pc = inst.value;
+        else             --sp;
+        break;
+
+      default:
+      {
+        const Int32 rhs = *--sp;
+        Int32& lhs = sp[-1];
+
+        switch(inst.op)
+        {
+          case Plus:            lhs = lhs + rhs;                     break;
+          case Minus:           lhs = lhs - rhs;                     break;
+          case Mult:            lhs = lhs * rhs;                     break;
+          case Div:             lhs = rhs == 0 ? 0 : lhs / rhs;      break;
+          case Mod:             lhs = rhs == 0 ? 0 : lhs % rhs;      break;
+          case BinAnd:          lhs = lhs & rhs;                     break;
+          case BinOr:           lhs = lhs | rhs;                     break;
+          case BinXor:          lhs = lhs ^ rhs;                     break;
+          case ShiftLeft:       lhs = lhs << rhs;                    break;
+          case ShiftRight:      lhs = lhs >> rhs;                    break;
+          case ByteDerefOffset: lhs = peek(static_cast<uInt16>(lhs + rhs)); break;
+          case Equals:          lhs = lhs == rhs;                    break;
+          case NotEquals:       lhs = lhs != rhs;                    break;
+          case Less:            lhs = lhs < rhs;                     break;
+          case LessEquals:      lhs = lhs <= rhs;                    break;
+          case Greater:         lhs = lhs > rhs;                     break;
+          case GreaterEquals:   lhs = lhs >= rhs;                    break;
+          default:                                                   break;
+        }
+        break;
+      }
+    }
+  }
+  return sp[-1];
+}
@@ -0,0 +1,139 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2026 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#ifndef EXPRESSION_PROGRAM_HXX
+#define EXPRESSION_PROGRAM_HXX
+
+class System;
+
+#include "bspf.hxx"
+#include "CartDebug.hxx"
+#include "CpuDebug.hxx"
+#include "RiotDebug.hxx"
+#include "TIADebug.hxx"
+#include "Expression.hxx"
+
+/**
+  This class flattens an expression tree into a postfix program, which is
+  evaluated by a single loop over a preallocated value stack.  Conditional
+  breaks, traps and save states are evaluated after every instruction, and
+  this avoids walking the (heap allocated, virtual) tree each time.
+
+  Nodes whose value must be looked up at evaluation time (labels, user
+  defined functions) are compiled into a call back into the tree.
+
+  @author  Stella Team
+*/
+class ExpressionProgram
+{
+  public:
+    enum class Op: uInt8 {
+      // push a value
+      Const, Eval, CpuMethod, CartMethod, RiotMethod, TiaMethod,
+      // replace the top value
+      ByteDeref, WordDeref, UnaryMinus, BinNot, LogNot, HiByte, LoByte, Bool,
+      // combine the two top values
+      Plus, Minus, Mult, Div, Mod, BinAnd, BinOr, BinXor,
+      ShiftLeft, ShiftRight, ByteDerefOffset,
+      Equals, NotEquals, Less, LessEquals, Greater, GreaterEquals,
+      // short circuit for logical and/or; pop the top value unless jumping
+      JumpIfFalse, JumpIfTrue
+    };
+
+  public:
+    /**
+      Compile the given expression, and take ownership of it.
+    */
+    explicit ExpressionProgram(Expression* expr);
+    ~ExpressionProgram() = default;
+
+    /**
+      Evaluate the compiled expression; equivalent to expression().evaluate()
+    */
+    Int32 evaluate() const;
+
+    /**
+      Replace all labels by their current values, so that the program can be
+      evaluated against copies of the system (see below).
+
+      @return  False if the program depends on anything but memory contents
+               and labels (e.g. registers or user defined functions)
+    */
+    bool resolveLabels();
+
+    /**
+      Evaluate the compiled expression against the memory of the given
+      system, which may be a copy running on another thread.  Each thread
+      must provide its own value stack.  Only valid after resolveLabels().
+    */
+    Int32 evaluate(System& system, vector<Int32>& stack) const;
+
+    /**
+      The expression tree this program was compiled from.
+    */
+    const Expression& expression() const { return *myExpression; }
+
+    /**
+      Methods used by Expression::compile() to append code to the program.
+    */
+    void emit(Op op, Int32 value = 0);
+    void emitEval(const Expression& expr);
+    void emitMethod(CpuMethod method);
+    void emitMethod(CartMethod method);
+    void emitMethod(RiotMethod method);
+    void emitMethod(TiaMethod method);
+
+    /**
+      Append a forward jump, and resolve it to the current end of the
+      program later on.
+    */
+    size_t emitJump(Op op);
+    void patchJump(size_t jump);
+
+  private:
+    template<typename Peek>
+    Int32 run(const Peek& peek, Int32* sp) const;
+
+  private:
+    struct Instruction {
+      Op op{Op::Const};
+      Int32 value{0};  // constant, jump target or index into the tables below
+    };
+
+    unique_ptr<Expression> myExpression;
+
+    vector<Instruction> myCode;
+    vector<const Expression*> myNodes;
+    vector<CpuMethod> myCpuMethods;
+    vector<CartMethod> myCartMethods;
+    vector<RiotMethod> myRiotMethods;
+    vector<TiaMethod> myTiaMethods;
+
+    // The value stack, sized to the maximum depth while compiling
+    mutable vector<Int32> myStack;
+    size_t myDepth{0};
+
+  private:
+    // Following constructors and assignment operators not supported
+    ExpressionProgram() = delete;
+    ExpressionProgram(const ExpressionProgram&) = delete;
+    ExpressionProgram(ExpressionProgram&&) = delete;
+    ExpressionProgram& operator=(const ExpressionProgram&) = delete;
+    ExpressionProgram& operator=(ExpressionProgram&&) = delete;
+};
+
+#endif
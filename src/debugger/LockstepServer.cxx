@@ -0,0 +1,357 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2026 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#include <barrier>
+#include <chrono>
+#include <thread>
+
+#include "Cart.hxx"
+#include "CartCreator.hxx"
+#include "DispatchResult.hxx"
+#include "FSNode.hxx"
+#include "HeadlessConsole.hxx"
+#include "InputMovie.hxx"
+#include "MD5.hxx"
+#include "Props.hxx"
+#include "Serializer.hxx"
+#include "Settings.hxx"
+#include "LockstepServer.hxx"
+
+using namespace std::chrono;
+
+namespace {
+  // CRC-32 (as used by zlib), which is cheap enough to be taken every frame
+  constexpr auto CRC_TABLE = [] {
+    std::array<uInt32, 256> table{};
+    for(uInt32 i = 0; i < table.size(); ++i)
+    {
+      uInt32 crc = i;
+      for(int bit = 0; bit < 8; ++bit)
+        crc = (crc & 1) ? 0xEDB88320 ^ (crc >> 1) : crc >> 1;
+      table[i] = crc;
+    }
+    return table;
+  }();
+
+  constexpr uInt32 crc32(uInt32 crc, uInt8 value) {
+    return CRC_TABLE[(crc ^ value) & 0xFF] ^ (crc >> 8);
+  }
+} // namespace
+
+struct LockstepServer::Instance
+{
+  size_t index{0};
+  unique_ptr<HeadlessConsole> console;
+  InputMovie movie;
+};
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+LockstepServer::LockstepServer(int argc, char* argv[])
+{
+  // argv[1] is '-lockstep'
+  for(int i = 2; i < argc; ++i)
+  {
+    const string arg = argv[i];
+
+    if(arg == "-jobs" && i + 1 < argc)
+      myJobs = static_cast<uInt32>(std::max(BSPF::stoi(argv[++i]), 0));
+    else if(arg == "-frames" && i + 1 < argc)
+      myMaxFrames = static_cast<uInt32>(std::max(BSPF::stoi(argv[++i]), 0));
+    else if(arg == "-hashlog" && i + 1 < argc)
+      myHashLogFile = argv[++i];
+    else if(arg == "-verify" && i + 1 < argc)
+      myVerifyFile = argv[++i];
+    else if(myRomFile.empty())
+      myRomFile = arg;
+    else
+      mySlots.emplace_back().movie = arg;
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+LockstepServer::~LockstepServer() = default;
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool LockstepServer::run()
+{
+  if(myRomFile.empty() || mySlots.empty())
+    throw std::runtime_error("usage: stella -lockstep [-jobs <n>] [-frames <n>] "
+      "[-hashlog <file>] [-verify <file>] <rom> <movie> [<movie> ...]");
+
+  // Consoles playing back the same input must stay identical
+  vector<string> inputs;
+  for(size_t i = 0; i < mySlots.size(); ++i)
+  {
+    Slot& slot = mySlots[i];
+    ByteBuffer movie;
+    const FSNode node(slot.movie);
+    const size_t size = node.isFile() ? node.read(movie) : 0;
+    const string md5 = size > 0 ? MD5::hash(movie, size) : std::format("missing {}", i);
+
+    slot.group = std::distance(inputs.begin(), std::ranges::find(inputs, md5));
+    inputs.push_back(md5);
+  }
+
+  loadVerifyLog();
+  if(!myHashLogFile.empty())
+  {
+    myHashLog.open(myHashLogFile);
+    if(!myHashLog)
+      throw std::runtime_error("ERROR: unable to write " + myHashLogFile);
+  }
+
+  uInt32 jobs = myJobs > 0 ? myJobs : std::max(std::thread::hardware_concurrency(), 1U);
+  jobs = std::min<uInt32>(jobs, static_cast<uInt32>(mySlots.size()));
+
+  cout << std::format("Lockstep: {} consoles on {} cores...\n", mySlots.size(), jobs)
+       << std::flush;
+
+  // The last worker to finish a frame compares the hashes
+  std::barrier frameEnd(jobs, [this]() noexcept {
+    try
+    {
+      endFrame();
+    }
+    catch(...)
+    {
+      myDone = true;
+    }
+  });
+
+  const auto worker = [&](uInt32 core) {
+    // Settings are not thread-safe, so each core gets its own copy
+    Settings settings;
+    const Properties props;
+    vector<unique_ptr<Instance>> instances;
+
+    for(size_t i = core; i < mySlots.size(); i += jobs)
+    {
+      auto& instance = instances.emplace_back(std::make_unique<Instance>());
+      instance->index = i;
+      createInstance(*instance, settings, props);
+    }
+
+    do
+    {
+      for(auto& instance: instances)
+        if(mySlots[instance->index].active)
+          stepFrame(*instance);
+
+      frameEnd.arrive_and_wait();
+    }
+    while(!myDone);
+  };
+
+  const time_point<high_resolution_clock> start = high_resolution_clock::now();
+
+  vector<std::thread> threads;
+  threads.reserve(jobs);
+  for(uInt32 core = 0; core < jobs; ++core)
+    threads.emplace_back(worker, core);
+  for(auto& thread: threads)
+    thread.join();
+
+  const double realtime =
+    duration_cast<duration<double>>(high_resolution_clock::now() - start).count();
+
+  bool ok = true;
+  for(size_t i = 0; i < mySlots.size(); ++i)
+  {
+    const Slot& slot = mySlots[i];
+    cout << std::format("console {} ({}): {} frames, {}\n", i, slot.movie,
+                        slot.frames, slot.failed ? slot.message : "ok");
+    ok = ok && !slot.failed;
+  }
+  cout << std::format("{} frames in {:.2f} seconds\n", myFrame, realtime);
+
+  return ok;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void LockstepServer::loadVerifyLog()
+{
+  if(myVerifyFile.empty())
+    return;
+
+  std::ifstream in(myVerifyFile);
+  if(!in)
+    throw std::runtime_error("ERROR: unable to read " + myVerifyFile);
+
+  myVerifyHashes.resize(mySlots.size());
+
+  // '<frame> <console> <hash>' per line, frames start at 1
+  uInt32 frame = 0, hash = 0;
+  size_t console = 0;
+  while(in >> std::dec >> frame >> console >> std::hex >> hash)
+  {
+    if(console >= myVerifyHashes.size() || frame == 0)
+      continue;
+
+    vector<uInt32>& hashes = myVerifyHashes[console];
+    if(hashes.size() < frame)
+      hashes.resize(frame, 0);
+    hashes[frame - 1] = hash;
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool LockstepServer::createInstance(Instance& instance, Settings& settings,
+                                    const Properties& props)
+{
+  Slot& slot = mySlots[instance.index];
+  slot.failed = true;
+
+  const FSNode imageFile(myRomFile);
+  ByteBuffer image;
+  const size_t size = imageFile.isFile() ? imageFile.read(image) : 0;
+  if(size == 0)
+  {
+    slot.message = "unable to read " + myRomFile;
+    return false;
+  }
+
+  string md5 = MD5::hash(image, size);
+  const string type;
+  unique_ptr<Cartridge> cartridge = CartCreator::create(
+      imageFile, image, size, md5, type, settings);
+  if(!cartridge)
+  {
+    slot.message = "unable to determine cartridge type";
+    return false;
+  }
+
+  instance.console = std::make_unique<HeadlessConsole>(std::move(cartridge),
+                                                       settings, props);
+  HeadlessConsole& console = *instance.console;
+  console.detectLayout();
+
+  const InputMovie::Info info{md5, console.leftController().name(),
+                              console.rightController().name()};
+  if(!instance.movie.startPlayback(slot.movie, info,
+      [&console](Serializer& in) { return console.load(in); }))
+  {
+    slot.message = "movie missing or not recorded with this ROM";
+    return false;
+  }
+
+  slot.failed = false;
+  slot.active = true;
+
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void LockstepServer::stepFrame(Instance& instance)
+{
+  Slot& slot = mySlots[instance.index];
+  HeadlessConsole& console = *instance.console;
+  InputMovie& movie = instance.movie;
+  const auto save = [&console](Serializer& out) { return console.save(out); };
+  TIA& tia = console.tia();
+  const uInt32 frame = tia.frameCount();
+  DispatchResult result;
+
+  // Like DebugScriptRunner::playMovie(), but only for one frame
+  while(tia.frameCount() == frame)
+  {
+    if(!movie.play(console.system().cycles(), console.event(), save))
+    {
+      slot.message = std::format("desynchronized from the recording at keyframe {}",
+                                 movie.keyframes() - 1);
+      slot.failed = true;
+      slot.active = false;
+      return;
+    }
+    console.riot().update();
+
+    if(!movie.isPlaying())
+    {
+      slot.active = false;
+      return;
+    }
+
+    tia.update(result, movie.nextCycles() - console.system().cycles());
+    if(result.getStatus() != DispatchResult::Status::ok)
+    {
+      slot.message = result.getMessage();
+      slot.failed = true;
+      slot.active = false;
+      return;
+    }
+  }
+
+  slot.hash = hashState(console);
+  ++slot.frames;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void LockstepServer::endFrame()
+{
+  ++myFrame;
+
+  bool active = false;
+  for(size_t i = 0; i < mySlots.size(); ++i)
+  {
+    Slot& slot = mySlots[i];
+    if(slot.failed || slot.frames != myFrame)
+      continue;
+
+    if(myHashLog.is_open())
+      myHashLog << std::format("{} {} {:08x}\n", myFrame, i, slot.hash);
+
+    const Slot& first = mySlots[slot.group];
+    if(slot.group != i && first.frames == myFrame && first.hash != slot.hash)
+    {
+      slot.message = std::format("diverged from console {} at frame {}",
+                                 slot.group, myFrame);
+      slot.failed = true;
+    }
+    else if(i < myVerifyHashes.size() && myFrame <= myVerifyHashes[i].size() &&
+            myVerifyHashes[i][myFrame - 1] != slot.hash)
+    {
+      slot.message = std::format("differs from {} at frame {}", myVerifyFile, myFrame);
+      slot.failed = true;
+    }
+
+    if(slot.failed)
+      slot.active = false;
+    active = active || slot.active;
+  }
+
+  myDone = !active || (myMaxFrames > 0 && myFrame >= myMaxFrames);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt32 LockstepServer::hashState(HeadlessConsole& console)
+{
+  uInt32 crc = ~0U;
+
+  const uInt8* ram = console.riot().getRAM();
+  for(uInt32 i = 0; i < 128; ++i)
+    crc = crc32(crc, ram[i]);
+
+  const M6502& cpu = console.cpu();
+  for(const uInt8 reg: {cpu.A, cpu.X, cpu.Y, cpu.SP, cpu.PS(),
+                        static_cast<uInt8>(cpu.PC), static_cast<uInt8>(cpu.PC >> 8)})
+    crc = crc32(crc, reg);
+
+  const Cartridge& cart = console.cartridge();
+  for(uInt32 addr = 0; addr < cart.internalRamSize(); ++addr)
+    crc = crc32(crc, cart.internalRamGetValue(static_cast<uInt16>(addr)));
+
+  return ~crc;
+}
@@ -0,0 +1,123 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2026 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#ifndef LOCKSTEP_SERVER_HXX
+#define LOCKSTEP_SERVER_HXX
+
+class HeadlessConsole;
+class Properties;
+class Settings;
+
+#include <fstream>
+
+#include "bspf.hxx"
+
+/**
+  Headless lockstep server for verifying tournament submissions, started
+  with 'stella -lockstep [options] <rom> <movie> [<movie> ...]'.
+
+  Each input movie (see InputMovie) is played back on its own console, and
+  all consoles run in one process.  Like the ProfilingRunner batch mode,
+  the consoles are spread across a pool of worker threads, but here all
+  of them advance one frame at a time and wait for each other at the end
+  of every frame.
+
+  After each frame, a hash (CRC-32) of the RIOT RAM, the CPU registers and
+  the cartridge RAM of each console is taken.  Consoles playing back the
+  same input must produce the same hashes, so differences are reported as
+  divergences.  The hashes can also be written to a log, and compared with
+  the log of an earlier (e.g. the submitter's) run.
+
+  Options:
+    -jobs <n>          number of worker threads (0 = all cores, default)
+    -frames <n>        stop after n frames, even if movies continue
+    -hashlog <file>    write '<frame> <console> <hash>' lines to a file
+    -verify <file>     compare the hashes with a log written by -hashlog
+
+  @author  Stella Team
+*/
+class LockstepServer
+{
+  public:
+    LockstepServer(int argc, char* argv[]);
+    ~LockstepServer();
+
+    /**
+      Play back all movies in lockstep.
+
+      @return  False if any console failed, diverged or differed from the
+               verification log
+    */
+    bool run();
+
+  private:
+    // The shared results of one console; each is only written by the
+    // worker owning the console, and read between frames
+    struct Slot {
+      string movie;
+      size_t group{0};      // index of the first console with the same input
+      uInt32 hash{0};
+      uInt32 frames{0};
+      bool active{false};   // still playing back
+      bool failed{false};
+      string message;
+    };
+
+    // One console with its movie, owned by a worker thread
+    struct Instance;
+
+  private:
+    void loadVerifyLog();
+    bool createInstance(Instance& instance, Settings& settings,
+                        const Properties& props);
+    void stepFrame(Instance& instance);
+
+    /**
+      Compare and log the hashes of the frame just finished, and decide
+      whether to continue.  Called by the last worker reaching the end of
+      the frame.
+    */
+    void endFrame();
+
+    static uInt32 hashState(HeadlessConsole& console);
+
+  private:
+    string myRomFile;
+    vector<Slot> mySlots;
+
+    uInt32 myJobs{0};
+    uInt32 myMaxFrames{0};
+    string myHashLogFile;
+    string myVerifyFile;
+
+    std::ofstream myHashLog;
+    // Verification hashes by console and frame
+    vector<vector<uInt32>> myVerifyHashes;
+
+    uInt32 myFrame{0};
+    bool myDone{false};
+
+  private:
+    // Following constructors and assignment operators not supported
+    LockstepServer() = delete;
+    LockstepServer(const LockstepServer&) = delete;
+    LockstepServer(LockstepServer&&) = delete;
+    LockstepServer& operator=(const LockstepServer&) = delete;
+    LockstepServer& operator=(LockstepServer&&) = delete;
+};
+
+#endif
@@ -0,0 +1,178 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2026 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#include <bit>
+
+#include "RamSearch.hxx"
+
+namespace {
+  // The following work on eight bytes packed into one 64 bit word
+  constexpr uInt64 LSB = 0x0101010101010101ULL;
+  constexpr uInt64 MSB = 0x8080808080808080ULL;
+
+  constexpr uInt64 broadcast(uInt8 value)
+  {
+    return LSB * value;
+  }
+
+  // Load eight bytes (lowest address in the lowest byte), padding with
+  // zeros beyond the end of the RAM
+  inline uInt64 load(const ByteArray& ram, uInt32 pos)
+  {
+    const uInt32 size = std::min<uInt32>(8, static_cast<uInt32>(ram.size()) - pos);
+    uInt64 word = 0;
+    for(uInt32 i = 0; i < size; ++i)
+      word |= uInt64{ram[pos + i]} << (i * 8);
+    return word;
+  }
+
+  // MSB set in each byte which is zero
+  constexpr uInt64 zeroBytes(uInt64 x)
+  {
+    return ~(((x & ~MSB) + ~MSB) | x | ~MSB);
+  }
+
+  // Bytewise subtraction, without borrows crossing byte boundaries
+  constexpr uInt64 subBytes(uInt64 x, uInt64 y)
+  {
+    return ((x | MSB) - (y & ~MSB)) ^ ((x ^ ~y) & MSB);
+  }
+
+  // MSB set in each byte where x < y (unsigned)
+  constexpr uInt64 lessBytes(uInt64 x, uInt64 y)
+  {
+    return ((~x & y) | (~(x ^ y) & subBytes(x, y))) & MSB;
+  }
+
+  // Gather the MSBs of all bytes into one byte, lowest address in bit 0
+  constexpr uInt8 gather(uInt64 msbs)
+  {
+    return static_cast<uInt8>(((msbs >> 7) * 0x0102040810204080ULL) >> 56);
+  }
+} // namespace
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RamSearch::reset()
+{
+  myCandidates.clear();
+  myValues.clear();
+  mySize = 0;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RamSearch::start(const ByteArray& ram)
+{
+  mySize = static_cast<uInt32>(ram.size());
+  myValues = ram;
+  myCandidates.assign((mySize + 63) / 64, ~uInt64{0});
+
+  // Addresses beyond the end of the RAM are never candidates
+  if(mySize & 63)
+    myCandidates.back() = (uInt64{1} << (mySize & 63)) - 1;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+template<typename Kernel>
+void RamSearch::filter(const ByteArray& ram, const Kernel& kernel)
+{
+  // The RAM size can only change with a new search
+  if(ram.size() != mySize)
+  {
+    reset();
+    return;
+  }
+
+  for(uInt32 i = 0; i < myCandidates.size(); ++i)
+  {
+    uInt64& bits = myCandidates[i];
+    if(bits == 0)
+      continue;
+
+    uInt64 mask = 0;
+    for(uInt32 j = 0, pos = i * 64; j < 64 && pos < mySize; j += 8, pos += 8)
+      mask |= uInt64{kernel(load(ram, pos), load(myValues, pos))} << j;
+    bits &= mask;
+  }
+  myValues = ram;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RamSearch::filterEqual(const ByteArray& ram, uInt8 value)
+{
+  const uInt64 pattern = broadcast(value);
+
+  filter(ram, [pattern](uInt64 cur, uInt64) {
+    return gather(zeroBytes(cur ^ pattern));
+  });
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RamSearch::filterChanged(const ByteArray& ram)
+{
+  filter(ram, [](uInt64 cur, uInt64 old) {
+    return static_cast<uInt8>(~gather(zeroBytes(cur ^ old)));
+  });
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RamSearch::filterChangedBy(const ByteArray& ram, int offset)
+{
+  if(offset == 0 || offset < -255 || offset > 255)
+  {
+    // No change, or a change which cannot happen without wrapping
+    filter(ram, [offset](uInt64 cur, uInt64 old) {
+      return offset == 0 ? gather(zeroBytes(cur ^ old)) : uInt8{0};
+    });
+  }
+  else if(offset > 0)
+  {
+    // The new value must be at least 'offset', otherwise the addition wrapped
+    const uInt64 delta = broadcast(static_cast<uInt8>(offset));
+
+    filter(ram, [delta](uInt64 cur, uInt64 old) {
+      return gather(zeroBytes(subBytes(cur, old) ^ delta) & ~lessBytes(cur, delta));
+    });
+  }
+  else
+  {
+    // The new value must be below '256 + offset', otherwise the subtraction wrapped
+    const uInt64 delta = broadcast(static_cast<uInt8>(-offset));
+    const uInt64 limit = broadcast(static_cast<uInt8>(256 + offset));
+
+    filter(ram, [delta, limit](uInt64 cur, uInt64 old) {
+      return gather(zeroBytes(subBytes(old, cur) ^ delta) & lessBytes(cur, limit));
+    });
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt32 RamSearch::count() const
+{
+  uInt32 total = 0;
+  for(const uInt64 bits: myCandidates)
+    total += std::popcount(bits);
+  return total;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RamSearch::fillHiliteList(uInt32 start, uInt32 size, BoolArray& list) const
+{
+  list.clear();
+  list.reserve(size);
+  for(uInt32 addr = start; addr < start + size; ++addr)
+    list.push_back(isCandidate(addr));
+}
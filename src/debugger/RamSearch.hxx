@@ -0,0 +1,105 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2026 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#ifndef RAM_SEARCH_HXX
+#define RAM_SEARCH_HXX
+
+#include "bspf.hxx"
+
+/**
+  This class implements the search/compare engine used by the RAM widgets.
+
+  The candidate addresses are kept as a bitset, together with a snapshot of
+  the RAM taken at the last search or compare.  Each refinement filters the
+  bitset in place, eight bytes at a time (SWAR), so multi-KB cart RAM (e.g.
+  CDF or ELF) is handled as cheaply as the 128 bytes of RIOT RAM.
+
+  @author  Stella Team
+*/
+class RamSearch
+{
+  public:
+    RamSearch() = default;
+    ~RamSearch() = default;
+
+    /**
+      Clear all candidates.
+    */
+    void reset();
+
+    /**
+      Start a new search; all addresses of the given RAM become candidates.
+    */
+    void start(const ByteArray& ram);
+
+    /**
+      Keep only the candidates whose current value equals the given value.
+    */
+    void filterEqual(const ByteArray& ram, uInt8 value);
+
+    /**
+      Keep only the candidates whose value changed since the last refinement.
+    */
+    void filterChanged(const ByteArray& ram);
+
+    /**
+      Keep only the candidates whose value changed by exactly the given
+      amount (without wrapping) since the last refinement.
+    */
+    void filterChangedBy(const ByteArray& ram, int offset);
+
+    /**
+      Answer whether the given address is still a candidate.
+    */
+    bool isCandidate(uInt32 addr) const {
+      return addr < mySize && (myCandidates[addr >> 6] >> (addr & 63)) & 1;
+    }
+
+    /**
+      Answer the number of remaining candidates.
+    */
+    uInt32 count() const;
+
+    /**
+      Fill the highlight list for the given range of addresses.
+    */
+    void fillHiliteList(uInt32 start, uInt32 size, BoolArray& list) const;
+
+  private:
+    // Filter the candidates with the given kernel, which returns a byte mask
+    // for each eight bytes of RAM (one bit per address)
+    template<typename Kernel>
+    void filter(const ByteArray& ram, const Kernel& kernel);
+
+  private:
+    // One bit per address
+    std::vector<uInt64> myCandidates;
+
+    // RAM contents at the last search or compare
+    ByteArray myValues;
+
+    uInt32 mySize{0};
+
+  private:
+    // Following constructors and assignment operators not supported
+    RamSearch(const RamSearch&) = delete;
+    RamSearch(RamSearch&&) = delete;
+    RamSearch& operator=(const RamSearch&) = delete;
+    RamSearch& operator=(RamSearch&&) = delete;
+};
+
+#endif
@@ -0,0 +1,110 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2026 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#include <atomic>
+#include <thread>
+
+#include "Cart.hxx"
+#include "CartCreator.hxx"
+#include "ExpressionProgram.hxx"
+#include "HeadlessConsole.hxx"
+#include "MD5.hxx"
+#include "Props.hxx"
+#include "Serializer.hxx"
+#include "Settings.hxx"
+#include "StateManager.hxx"
+#include "StateSearch.hxx"
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+StateSearch::StateSearch(const FSNode& romFile, string_view type)
+  : myRomFile{romFile},
+    myType{type}
+{
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+Int32 StateSearch::findFirst(const ExpressionProgram& condition,
+                             const vector<ByteArray>& states, uInt32 jobs) const
+{
+  if(jobs == 0)
+    jobs = std::max(std::thread::hardware_concurrency(), 1U);
+  jobs = std::min<uInt32>(jobs, std::max<uInt32>(static_cast<uInt32>(states.size()), 1));
+
+  const auto NONE = static_cast<size_t>(states.size());
+  std::atomic<size_t> nextState{0};
+  std::atomic<size_t> found{NONE};
+
+  const auto worker = [&]() {
+    // Settings are not thread-safe, so each worker gets its own copy
+    Settings settings;
+    const Properties props;
+
+    ByteBuffer image;
+    const size_t size = myRomFile.read(image);
+    string md5 = MD5::hash(image, size);
+    unique_ptr<Cartridge> cart =
+      CartCreator::create(myRomFile, image, size, md5, myType, settings);
+    if(!cart)
+      return;
+
+    HeadlessConsole console(std::move(cart), settings, props);
+    vector<Int32> stack;
+
+    for(size_t i = nextState++; i < found.load(); i = nextState++)
+    {
+      try
+      {
+        Serializer in(std::span<const std::byte>(
+            reinterpret_cast<const std::byte*>(states[i].data()), states[i].size()));
+
+        // Only the system state is needed, the controllers of the main
+        // console may differ from the joysticks used here
+        if(in.getString() != StateManager::STATE_HEADER ||
+           !console.system().load(in))
+          continue;
+      }
+      catch(...)
+      {
+        continue;
+      }
+
+      // Don't let the condition trigger any bankswitching
+      console.cartridge().lockHotspots();
+      console.system().lockDataBus();
+      const bool match = condition.evaluate(console.system(), stack) != 0;
+      console.system().unlockDataBus();
+      console.cartridge().unlockHotspots();
+
+      if(match)
+      {
+        // Keep the earliest match
+        size_t earliest = found.load();
+        while(i < earliest && !found.compare_exchange_weak(earliest, i)) { }
+        return;
+      }
+    }
+  };
+
+  vector<std::thread> threads;
+  threads.reserve(jobs);
+  for(uInt32 i = 0; i < jobs; ++i)
+    threads.emplace_back(worker);
+  for(auto& thread: threads)
+    thread.join();
+
+  return found == NONE ? -1 : static_cast<Int32>(found.load());
+}
@@ -0,0 +1,76 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2026 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#ifndef STATE_SEARCH_HXX
+#define STATE_SEARCH_HXX
+
+class ExpressionProgram;
+
+#include "bspf.hxx"
+#include "FSNode.hxx"
+
+/**
+  Searches a list of save states (e.g. all rewind states) for the first one
+  in which a condition holds.
+
+  The states are distributed over a pool of worker threads.  Each worker
+  creates its own copy of the cartridge and a HeadlessConsole, loads the
+  states into it and evaluates the condition against its memory.  Since the
+  workers take the states in increasing order, they can stop as soon as an
+  earlier state is known to match.
+
+  @author  Stella Team
+*/
+class StateSearch
+{
+  public:
+    /**
+      Create a new search for states of the given ROM.
+
+      @param romFile  The ROM the states were created with
+      @param type     The bankswitching type of the ROM
+    */
+    StateSearch(const FSNode& romFile, string_view type);
+    ~StateSearch() = default;
+
+    /**
+      Find the first of the given states for which the condition holds.
+      The condition must have been prepared with resolveLabels().
+
+      @param condition  The condition to evaluate for each state
+      @param states     The states, each starting with the state header
+      @param jobs       The number of worker threads (0 = all cores)
+
+      @return  The index of the first matching state, or -1 if none matches
+    */
+    Int32 findFirst(const ExpressionProgram& condition,
+                    const vector<ByteArray>& states, uInt32 jobs = 0) const;
+
+  private:
+    FSNode myRomFile;
+    string myType;
+
+  private:
+    // Following constructors and assignment operators not supported
+    StateSearch() = delete;
+    StateSearch(const StateSearch&) = delete;
+    StateSearch(StateSearch&&) = delete;
+    StateSearch& operator=(const StateSearch&) = delete;
+    StateSearch& operator=(StateSearch&&) = delete;
+};
+
+#endif
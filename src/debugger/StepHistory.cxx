@@ -0,0 +1,87 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2026 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#include "StepHistory.hxx"
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void StepHistory::clear()
+{
+  mySteps.clear();
+  myKeyFrame = 0;
+  myPosition = 0;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void StepHistory::addKeyFrame(uInt64 prevKeyFrame, uInt64 keyFrame)
+{
+  truncate(prevKeyFrame);
+  mySteps.erase(mySteps.lower_bound(keyFrame), mySteps.end());
+  setPosition(keyFrame, 0);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void StepHistory::truncate(uInt64 keyFrame)
+{
+  const auto it = mySteps.find(keyFrame);
+  if(it == mySteps.end())
+    return;
+
+  const uInt32 position = this->position(keyFrame);
+  if(position)
+    it->second.resize(std::min<size_t>(it->second.size(), position));
+  else
+    mySteps.erase(it);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void StepHistory::removeBefore(uInt64 cycles)
+{
+  mySteps.erase(mySteps.begin(), mySteps.lower_bound(cycles));
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool StepHistory::addStep(uInt64 keyFrame, uInt64 cycles)
+{
+  const uInt32 position = this->position(keyFrame);
+
+  if(position + 1 >= KEYFRAME_STEPS)
+    return false;
+
+  auto& steps = mySteps[keyFrame];
+  steps.resize(std::min<size_t>(steps.size(), position));
+  steps.push_back(cycles);
+  setPosition(keyFrame, position + 1);
+
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt32 StepHistory::size(uInt64 keyFrame) const
+{
+  const auto it = mySteps.find(keyFrame);
+
+  return it != mySteps.end() ? static_cast<uInt32>(it->second.size()) : 0;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt64 StepHistory::cycles(uInt64 keyFrame, uInt32 step) const
+{
+  const auto it = mySteps.find(keyFrame);
+
+  return it != mySteps.end() && step > 0 && step <= it->second.size()
+      ? it->second[step - 1] : keyFrame;
+}
@@ -0,0 +1,120 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2026 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#ifndef STEP_HISTORY_HXX
+#define STEP_HISTORY_HXX
+
+#include <map>
+
+#include "bspf.hxx"
+
+/**
+  Remembers the single steps (and traces) made in the debugger, so that
+  they can be undone without saving a rewind state for each step.
+
+  The rewind states serve as sparse key frames; for each of them, only the
+  system cycles at the end of each following step are stored.  Going back
+  one step reloads the key frame and deterministically re-executes the CPU
+  until the cycles of the previous step are reached again.  Only every
+  KEYFRAME_STEPS'th step adds a new rewind state, which limits the time
+  needed to replay.
+
+  Key frames are identified by their cycles.  Since the rewind states may
+  also be added or removed elsewhere, the position is only valid as long
+  as the current rewind state is the key frame it refers to.
+
+  @author  Stella Team
+*/
+class StepHistory
+{
+  public:
+    // Maximum number of steps stored (and replayed) after one key frame
+    static constexpr uInt32 KEYFRAME_STEPS = 100;
+
+  public:
+    StepHistory() = default;
+    ~StepHistory() = default;
+
+    /**
+      Forget all steps.
+    */
+    void clear();
+
+    /**
+      A new key frame has been added after the current position of the key
+      frame 'prevKeyFrame'.  All steps after that position, and those of any
+      later key frames, are discarded.
+    */
+    void addKeyFrame(uInt64 prevKeyFrame, uInt64 keyFrame);
+
+    /**
+      Discard the steps after the current position of the key frame, e.g.
+      because emulation continues from there.
+    */
+    void truncate(uInt64 keyFrame);
+
+    /**
+      Discard the steps of all key frames before 'cycles' (which have been
+      removed from the rewind states).
+    */
+    void removeBefore(uInt64 cycles);
+
+    /**
+      Record a step from the current position, which ended at 'cycles'.
+      All steps after the current position are discarded.
+
+      @return  False if the step must be saved as a new key frame instead
+    */
+    bool addStep(uInt64 keyFrame, uInt64 cycles);
+
+    /**
+      The number of steps from the key frame to the current position.
+    */
+    uInt32 position(uInt64 keyFrame) const {
+      return keyFrame == myKeyFrame ? myPosition : 0;
+    }
+    void setPosition(uInt64 keyFrame, uInt32 position) {
+      myKeyFrame = keyFrame;  myPosition = position;
+    }
+
+    /**
+      The number of steps stored after the key frame.
+    */
+    uInt32 size(uInt64 keyFrame) const;
+
+    /**
+      The cycles at the end of the step (1 based) after the key frame.
+    */
+    uInt64 cycles(uInt64 keyFrame, uInt32 step) const;
+
+  private:
+    // Key frame cycles -> cycles at the end of each following step
+    std::map<uInt64, vector<uInt64>> mySteps;
+
+    // The key frame and the number of steps replayed from it
+    uInt64 myKeyFrame{0};
+    uInt32 myPosition{0};
+
+  private:
+    // Following constructors and assignment operators not supported
+    StepHistory(const StepHistory&) = delete;
+    StepHistory(StepHistory&&) = delete;
+    StepHistory& operator=(const StepHistory&) = delete;
+    StepHistory& operator=(StepHistory&&) = delete;
+};
+
+#endif
@@ -18,6 +18,7 @@
 #include "Base.hxx"
 #include "System.hxx"
 #include "Debugger.hxx"
+#include "CartDebug.hxx"
 #include "TIA.hxx"
 #include "DelayQueueIterator.hxx"
 #include "RiotDebug.hxx"
@@ -1035,6 +1036,51 @@ string TIADebug::palette()
   return result;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+std::array<uInt8, 64> TIADebug::registersAt(uInt32 cycle, bool lastFrame) const
+{
+  TIA::RegisterWrites writes;
+  std::array<uInt8, 64> regs = myTIA.registerHistory(writes, lastFrame);
+
+  for(const auto& write: writes)
+  {
+    if(write.cycle > cycle)
+      break;
+    regs[write.address] = write.value;
+  }
+  return regs;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+string TIADebug::registerHistory(int scanline, bool lastFrame) const
+{
+  if(!myTIA.registerHistoryEnabled())
+    return "TIA register history disabled";
+
+  TIA::RegisterWrites writes;
+  myTIA.registerHistory(writes, lastFrame);
+
+  const CartDebug& cart = myDebugger.cartDebug();
+  std::ostringstream buf;
+  uInt32 count = 0;
+
+  buf << "scanline  clock  cycle  register\n";
+  for(const auto& write: writes)
+  {
+    if(scanline >= 0 && write.y != scanline)
+      continue;
+
+    buf << std::format("{:>8}  {:>5}  {:>5}  {:<7}= ${:02X}\n",
+                       write.y, write.x - TIAConstants::H_BLANK_CLOCKS,
+                       write.cycle, cart.getLabel(write.address, false, 2),
+                       write.value);
+    ++count;
+  }
+  buf << count << " write(s)";
+
+  return buf.str();
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 string TIADebug::toString()
 {
@@ -67,6 +67,19 @@ class TIADebug : public DebuggerSystem
     string debugColors() const;
     static string palette();
 
+    /**
+      Answers the TIA register values at the given number of system cycles
+      from the start of the current or the last frame, replayed from the
+      register history (see TIA::enableRegisterHistory()).
+    */
+    std::array<uInt8, 64> registersAt(uInt32 cycle, bool lastFrame = false) const;
+
+    /**
+      Lists the recorded register writes of the current or the last frame,
+      optionally only those of a single scanline.
+    */
+    string registerHistory(int scanline = -1, bool lastFrame = false) const;
+
     // TIA byte (or part of a byte) registers
     uInt8 nusiz0(int newVal = -1);
     uInt8 nusiz1(int newVal = -1);
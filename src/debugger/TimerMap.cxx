@@ -51,6 +51,7 @@ uInt32 TimerMap::add(uInt16 fromAddr, uInt16 toAddr,
   toKey(tpTo, mirrors, anyBank);
   myFromMap.insert(TimerPair(tpFrom, &myList.back()));
   myToMap.insert(TimerPair(tpTo, &myList.back()));
+  updateIndex();
 
   return size() - 1;
 }
@@ -77,6 +78,7 @@ uInt32 TimerMap::add(uInt16 addr, uInt8 bank, bool mirrors, bool anyBank)
     myList.push_back(tmNew);
     toKey(tp, mirrors, anyBank);
     myFromMap.insert(TimerPair(tp, &myList.back()));
+    updateIndex();
     return size() - 1;
   }
   else
@@ -105,6 +107,7 @@ uInt32 TimerMap::add(uInt16 addr, uInt8 bank, bool mirrors, bool anyBank)
         myFromMap.insert(TimerPair(tpFrom, &tmPartial));
         break;
       }
+    updateIndex();
     return idx;
   }
 }
@@ -137,6 +140,7 @@ bool TimerMap::erase(uInt32 idx)
 
     // Finally remove from list
     myList.erase(myList.begin() + idx);
+    updateIndex();
     return true;
   }
   return false;
@@ -148,6 +152,7 @@ void TimerMap::clear()
   myList.clear();
   myFromMap.clear();
   myToMap.clear();
+  myIndex.reset();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -157,9 +162,23 @@ void TimerMap::reset()
     it.reset();
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TimerMap::updateIndex()
+{
+  myIndex.reset();
+  for(const auto& [tp, timer]: myFromMap)
+    myIndex.set(tp.addr & ADDRESS_MASK);
+  for(const auto& [tp, timer]: myToMap)
+    myIndex.set(tp.addr & ADDRESS_MASK);
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void TimerMap::update(uInt16 addr, uInt8 bank, uInt64 cycles)
 {
+  // Both the 13 and the 16 bit timerpoints share the same 13 bit address
+  if(!myIndex.test(addr & ADDRESS_MASK))
+    return;
+
   if((addr & ADDRESS_MASK) != addr)
   {
     // 13 bit timerpoint
@@ -22,6 +22,7 @@
 #include <climits>
 #include <map>
 #include <deque>
+#include <bitset>
 
 #include "bspf.hxx"
 #include "Serializable.hxx"
@@ -246,6 +247,9 @@ class TimerMap : public Serializable
   private:
     static void toKey(TimerPoint& tp, bool mirrors, bool anyBank);
 
+    /** Rebuild the address index from the from and to maps */
+    void updateIndex();
+
   private:
     using TimerList = std::deque<Timer>; // makes sure that the element pointers do NOT change
     using TimerPair = std::pair<TimerPoint, Timer*>;
@@ -256,6 +260,10 @@ class TimerMap : public Serializable
     FromMap myFromMap;
     ToMap myToMap;
 
+    // Marks each (13 bit) address which is used by any timer point, so that
+    // update() can skip the map lookups for all other addresses
+    std::bitset<ADDRESS_MASK + 1> myIndex;
+
     // Following constructors and assignment operators not supported
     TimerMap(const TimerMap&) = delete;
     TimerMap(TimerMap&&) = delete;
@@ -0,0 +1,127 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2026 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#include <chrono>
+
+#include "Base.hxx"
+#include "DiStella.hxx"
+#include "TraceRecorder.hxx"
+
+using Common::Base;
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool TraceRecorder::start(const string& path)
+{
+  stop();
+
+  myFile.open(path, std::ios_base::binary | std::ios_base::trunc);
+  if(!myFile)
+    return false;
+
+  const auto recordSize = static_cast<uInt32>(sizeof(Record));
+  myFile.write(MAGIC.data(), MAGIC.size());
+  myFile.write(reinterpret_cast<const char*>(&recordSize), sizeof(recordSize));
+
+  if(!myBuffer)
+    myBuffer = std::make_unique<Record[]>(BUFFER_SIZE);
+  myHead = myTail = 0;
+  myRecorded = myDropped = 0;
+
+  myRecording = true;
+  myWriterThread = std::thread(&TraceRecorder::writerThread, this);
+
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt64 TraceRecorder::stop()
+{
+  if(!myRecording)
+    return 0;
+
+  myRecording = false;
+  myWriterThread.join();
+  myFile.close();
+
+  return myDropped;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TraceRecorder::writerThread()
+{
+  while(myRecording)
+  {
+    drain();
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  // Records added before recording was stopped
+  drain();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TraceRecorder::drain()
+{
+  const size_t head = myHead.load(std::memory_order_acquire);
+  size_t tail = myTail.load(std::memory_order_relaxed);
+
+  while(tail != head)
+  {
+    // Write in at most two chunks, at the wrap-around of the ring buffer
+    const size_t start = tail & BUFFER_MASK;
+    const size_t count = std::min(head - tail, BUFFER_SIZE - start);
+
+    myFile.write(reinterpret_cast<const char*>(&myBuffer[start]),
+                 static_cast<std::streamsize>(count * sizeof(Record)));
+    tail += count;
+    myTail.store(tail, std::memory_order_release);
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool TraceRecorder::format(const string& path, std::ostream& out)
+{
+  std::ifstream in(path, std::ios_base::binary);
+  std::array<char, MAGIC.size()> magic{};
+  uInt32 recordSize = 0;
+
+  in.read(magic.data(), magic.size());
+  in.read(reinterpret_cast<char*>(&recordSize), sizeof(recordSize));
+  if(!in || magic != MAGIC || recordSize != sizeof(Record))
+    return false;
+
+  out << "Frame Scn Cy | PS       A  X  Y  SP | Bk/Addr Disasm\n";
+
+  Record rec;
+  while(in.read(reinterpret_cast<char*>(&rec), sizeof(Record)))
+  {
+    out << Base::toString(rec.frame, Base::Fmt::_10_5) << " "
+        << Base::toString(rec.scanline, Base::Fmt::_10_3) << " "
+        << Base::toString(rec.cycle, Base::Fmt::_10_02) << " | "
+        << ((rec.ps & 0x80) ? 'N' : 'n') << ((rec.ps & 0x40) ? 'V' : 'v') << '-'
+        << ((rec.ps & 0x10) ? 'B' : 'b') << ((rec.ps & 0x08) ? 'D' : 'd')
+        << ((rec.ps & 0x04) ? 'I' : 'i') << ((rec.ps & 0x02) ? 'Z' : 'z')
+        << ((rec.ps & 0x01) ? 'C' : 'c') << " "
+        << Base::HEX2 << static_cast<int>(rec.a) << " "
+        << Base::HEX2 << static_cast<int>(rec.x) << " "
+        << Base::HEX2 << static_cast<int>(rec.y) << " "
+        << Base::HEX2 << static_cast<int>(rec.sp) << " | "
+        << Base::toString(rec.bank, Base::Fmt::_10) << "/"
+        << Base::HEX4 << rec.pc << " "
+        << DiStella::disassembleInstruction(rec.pc, rec.code) << '\n';
+  }
+  return true;
+}
@@ -0,0 +1,128 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2026 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#ifndef TRACE_RECORDER_HXX
+#define TRACE_RECORDER_HXX
+
+#include <atomic>
+#include <fstream>
+#include <thread>
+
+#include "bspf.hxx"
+
+/**
+  This class records a binary execution trace, one fixed size record per
+  CPU instruction.  The emulation thread only copies the record into a
+  lock-free single producer/single consumer ring buffer; a background
+  thread drains the buffer into the trace file.  Formatting into text
+  (see format()) is done offline, after the recording was stopped.
+
+  If the writer thread can't keep up, records are dropped (and counted)
+  instead of blocking the emulation.
+
+  @author  Stella Team
+*/
+class TraceRecorder
+{
+  public:
+    struct Record
+    {
+      uInt32 frame{0};
+      uInt16 pc{0};
+      uInt16 scanline{0};
+      uInt8  bank{0};
+      uInt8  cycle{0};     // CPU cycle within the scanline
+      uInt8  a{0}, x{0}, y{0}, sp{0}, ps{0};
+      std::array<uInt8, 3> code{};  // opcode and operand bytes
+    };
+
+  public:
+    TraceRecorder() = default;
+    ~TraceRecorder() { stop(); }
+
+    /**
+      Start recording into the given file, which is overwritten.
+
+      @return  False if the file couldn't be created
+    */
+    bool start(const string& path);
+
+    /**
+      Stop recording, and write all pending records.
+
+      @return  The number of records which had to be dropped
+    */
+    uInt64 stop();
+
+    bool isRecording() const { return myRecording; }
+    uInt64 recorded() const { return myRecorded; }
+
+    /**
+      Add a record; called by the emulation thread for every instruction.
+    */
+    void record(const Record& rec) {
+      const size_t head = myHead.load(std::memory_order_relaxed);
+
+      if(head - myTail.load(std::memory_order_acquire) == BUFFER_SIZE)
+      {
+        ++myDropped;
+        return;
+      }
+      myBuffer[head & BUFFER_MASK] = rec;
+      myHead.store(head + 1, std::memory_order_release);
+      ++myRecorded;
+    }
+
+    /**
+      Convert a recorded trace file into text, one line per instruction.
+      The code is disassembled from the recorded bytes using DiStella.
+
+      @param path  The trace file
+      @param out   The text output
+      @return  False if the file isn't a valid trace file
+    */
+    static bool format(const string& path, std::ostream& out);
+
+  private:
+    // Drain the ring buffer into the trace file until recording stops
+    void writerThread();
+
+    // Write all records between tail and head
+    void drain();
+
+  private:
+    static constexpr size_t BUFFER_SIZE = 1 << 16;  // must be a power of two
+    static constexpr size_t BUFFER_MASK = BUFFER_SIZE - 1;
+    static constexpr std::array<char, 8> MAGIC = { 'S', 't', 'T', 'r', 'a', 'c', 'e', '1' };
+
+    unique_ptr<Record[]> myBuffer;
+    std::atomic<size_t> myHead{0}, myTail{0};
+
+    std::ofstream myFile;
+    std::thread myWriterThread;
+    std::atomic<bool> myRecording{false};
+    uInt64 myRecorded{0}, myDropped{0};
+
+  private:
+    // Following constructors and assignment operators not supported
+    TraceRecorder(const TraceRecorder&) = delete;
+    TraceRecorder(TraceRecorder&&) = delete;
+    TraceRecorder& operator=(const TraceRecorder&) = delete;
+    TraceRecorder& operator=(TraceRecorder&&) = delete;
+};
+
+#endif
@@ -26,27 +26,57 @@ class TrapArray
     TrapArray() = default;
     ~TrapArray() = default;
 
-    bool isSet(uInt16 address) const { return myCount[address]; }
-    bool isClear(uInt16 address) const { return myCount[address] == 0; }
+    bool isSet(uInt16 address) const {
+      // Most pages contain no traps at all, so check the page summary first
+      return myPageCount[address >> 8] &&
+             (myBits[address >> 6] >> (address & 63)) & 1;
+    }
+    bool isClear(uInt16 address) const { return !isSet(address); }
 
-    void add(uInt16 address) { myCount[address]++; }
-    void remove(uInt16 address) { if(myCount[address]) myCount[address]--; }
+    void add(uInt16 address) {
+      if(myCount[address]++ == 0)
+      {
+        myBits[address >> 6] |= uInt64{1} << (address & 63);
+        myPageCount[address >> 8]++;
+      }
+    }
+    void remove(uInt16 address) {
+      if(myCount[address] && --myCount[address] == 0)
+      {
+        myBits[address >> 6] &= ~(uInt64{1} << (address & 63));
+        myPageCount[address >> 8]--;
+      }
+    }
     // void toggle(uInt16 address) { myCount[address] ? remove(address) : add(address); } // TODO condition
 
     // Zero-fills only on first call; subsequent calls are no-ops
     void initialize() {
       if(!myInitialized)
-        myCount.fill(0);
+        reset();
       myInitialized = true;
     }
-    void clearAll() { myInitialized = false; myCount.fill(0); }
+    void clearAll() { myInitialized = false; reset(); }
 
     bool isInitialized() const { return myInitialized; }
 
+  private:
+    void reset() {
+      myCount.fill(0);
+      myBits.fill(0);
+      myPageCount.fill(0);
+    }
+
   private:
     // The actual counts
     array<uInt8, 0x10000> myCount{};
 
+    // One bit per address which has a non-zero count; much more cache
+    // friendly than the counts when checked for every CPU access
+    array<uInt64, 0x10000 / 64> myBits{};
+
+    // Number of addresses with a trap, for each 256 byte page
+    array<uInt16, 0x100> myPageCount{};
+
     // Indicates whether we should treat this array as initialized
     bool myInitialized{false};
 
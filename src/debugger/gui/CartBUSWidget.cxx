@@ -234,6 +234,8 @@ CartridgeBUSWidget::CartridgeBUSWidget(
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void CartridgeBUSWidget::saveOldState()
 {
+  myCart.flushDatastreams();
+
   myOldState.tops.clear();
   myOldState.bottoms.clear();
   myOldState.datastreampointers.clear();
@@ -510,6 +512,7 @@ const ByteArray& CartridgeBUSWidget::internalRamOld(int start, int count)
 const ByteArray& CartridgeBUSWidget::internalRamCurrent(int start, int count)
 {
   myRamCurrent.clear();
+  myCart.flushDatastreams();
   for(int i = 0; i < count; i++)
     myRamCurrent.push_back(myCart.myRAM[start + i]);
   return myRamCurrent;
@@ -518,11 +521,14 @@ const ByteArray& CartridgeBUSWidget::internalRamCurrent(int start, int count)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void CartridgeBUSWidget::internalRamSetValue(int addr, uInt8 value)
 {
+  myCart.flushDatastreams();
   myCart.myRAM[addr] = value;
+  myCart.loadDatastreams();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 uInt8 CartridgeBUSWidget::internalRamGetValue(int addr)
 {
+  myCart.flushDatastreams();
   return myCart.myRAM[addr];
 }
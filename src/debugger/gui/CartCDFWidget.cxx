@@ -220,6 +220,8 @@ CartridgeCDFWidget::CartridgeCDFWidget(
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void CartridgeCDFWidget::saveOldState()
 {
+  myCart.flushDatastreams();
+
   myOldState.fastfetchoffset.clear();
   myOldState.datastreampointers.clear();
   myOldState.datastreamincrements.clear();
@@ -495,6 +497,7 @@ const ByteArray& CartridgeCDFWidget::internalRamOld(int start, int count)
 const ByteArray& CartridgeCDFWidget::internalRamCurrent(int start, int count)
 {
   myRamCurrent.clear();
+  myCart.flushDatastreams();
   for(int i = 0; i < count; i++)
     myRamCurrent.push_back(myCart.myRAM[start + i]);
   return myRamCurrent;
@@ -503,12 +506,15 @@ const ByteArray& CartridgeCDFWidget::internalRamCurrent(int start, int count)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void CartridgeCDFWidget::internalRamSetValue(int addr, uInt8 value)
 {
+  myCart.flushDatastreams();
   myCart.myRAM[addr] = value;
+  myCart.loadDatastreams();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 uInt8 CartridgeCDFWidget::internalRamGetValue(int addr)
 {
+  myCart.flushDatastreams();
   return myCart.myRAM[addr];
 }
 
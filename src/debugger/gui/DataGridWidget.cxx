@@ -117,6 +117,24 @@ void DataGridWidget::setList(const IntArray& alist, const IntArray& vlist,
   */
   const size_t size = vlist.size();  // assume the alist is the same size
 
+  // If the same cells are shown, only update the ones which differ
+  if(!_editMode && std::ranges::equal(_addrList, alist)
+     && _valueList.size() == size && changed.size() == size)
+  {
+    IntArray positions, values;
+    BoolArray diff;
+
+    for(size_t i = 0; i < size; ++i)
+      if(_valueList[i] != vlist[i] || _changedList[i] != changed[i])
+      {
+        positions.push_back(static_cast<int>(i));
+        values.push_back(vlist[i]);
+        diff.push_back(changed[i]);
+      }
+    setValues(positions, values, diff);
+    return;
+  }
+
   const bool dirty = _editMode
     || !std::ranges::equal(_valueList, vlist)
     || !std::ranges::equal(_changedList, changed);
@@ -179,6 +197,39 @@ void DataGridWidget::setList(int a, int v)
   setList(alist, vlist, changed);
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void DataGridWidget::setValues(const IntArray& positions, const IntArray& values,
+                               const BoolArray& changed)
+{
+  if(positions.empty())
+    return;
+
+  for(size_t i = 0; i < positions.size(); ++i)
+    updateCell(positions[i], values[i], changed[i]);
+
+  // Send item selected signal for starting with cell 0
+  sendCommand(DataGridWidget::kSelectionChangedCmd, _selectedItem, _id);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void DataGridWidget::updateCell(int position, int value, bool changed)
+{
+  if(position < 0 || std::cmp_greater_equal(position, _valueList.size()))
+    return;
+
+  // Only format values which have actually changed
+  if(_valueList[position] != value)
+  {
+    _valueList[position] = value;
+    _valueStringList[position] = Common::Base::toString(value, _base);
+  }
+  _changedList[position] = changed;
+
+  // Redraw only this cell (unless something else needs a full redraw)
+  _dirtyCells.push_back(position);
+  Widget::setDirty();
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void DataGridWidget::setEditable(bool editable, bool hiliteBG)
 {
@@ -650,46 +701,8 @@ void DataGridWidget::drawWidget(bool hilite)
 
   // Draw the list items
   for(int row = 0; row < _rows; row++)
-  {
     for(int col = 0; col < _cols; col++)
-    {
-      const int x = _x + 4 + (col * _colWidth);
-      const int y = _y + 2 + (row * _rowHeight);
-      const int pos = row*_cols + col;
-      ColorId textColor = kTextColor;
-
-      // Draw the selected item inverted, on a highlighted background.
-      if (_currentRow == row && _currentCol == col &&
-          _hasFocus && !_editMode)
-      {
-        s.fillRect(x - 4, y - 2, _colWidth+1, _rowHeight+1, kTextColorHi);
-        textColor = kTextColorInv;
-      }
-
-      if (_selectedItem == pos && _editMode)
-      {
-        adjustOffset();
-        s.drawString(_font, editString(), x, y, _colWidth, textColor,
-                     TextAlign::Left, -_editScrollOffset, false);
-      }
-      else
-      {
-        if(_changedList[pos])
-        {
-          s.fillRect(x - 3, y - 1, _colWidth-1, _rowHeight-1, kDbgChangedColor);
-
-          if(_hiliteList[pos])
-            textColor = kDbgColorHi;
-          else
-            textColor = kDbgChangedTextColor;
-        }
-        else if(_hiliteList[pos])
-          textColor = kDbgColorHi;
-
-        s.drawString(_font, _valueStringList[pos], x, y, _colWidth, textColor);
-      }
-    }
-  }
+      drawCell(s, row, col);
 
   // Only draw the caret while editing, and if it's in the current viewport
   if(_editMode)
@@ -705,6 +718,97 @@ void DataGridWidget::drawWidget(bool hilite)
     s.line(_x + 1, _y + 1, _x + _w - 2, _y + _h - 1, kColor);
     s.line(_x + _w - 2, _y + 1, _x + 1, _y + _h - 1, kColor);
   }
+
+  _dirtyCells.clear();
+  _fullRedraw = false;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void DataGridWidget::drawCell(FBSurface& s, int row, int col)
+{
+  const int x = _x + 4 + (col * _colWidth);
+  const int y = _y + 2 + (row * _rowHeight);
+  const int pos = row*_cols + col;
+  ColorId textColor = kTextColor;
+
+  // Draw the selected item inverted, on a highlighted background.
+  if (_currentRow == row && _currentCol == col &&
+      _hasFocus && !_editMode)
+  {
+    s.fillRect(x - 4, y - 2, _colWidth+1, _rowHeight+1, kTextColorHi);
+    textColor = kTextColorInv;
+  }
+
+  if (_selectedItem == pos && _editMode)
+  {
+    adjustOffset();
+    s.drawString(_font, editString(), x, y, _colWidth, textColor,
+                 TextAlign::Left, -_editScrollOffset, false);
+  }
+  else
+  {
+    if(_changedList[pos])
+    {
+      s.fillRect(x - 3, y - 1, _colWidth-1, _rowHeight-1, kDbgChangedColor);
+
+      if(_hiliteList[pos])
+        textColor = kDbgColorHi;
+      else
+        textColor = kDbgChangedTextColor;
+    }
+    else if(_hiliteList[pos])
+      textColor = kDbgColorHi;
+
+    s.drawString(_font, _valueStringList[pos], x, y, _colWidth, textColor);
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void DataGridWidget::draw()
+{
+  // Anything but updated cells requires a full redraw
+  if(_fullRedraw || _editMode || _crossGrid || !isDirty() ||
+     !isVisible() || !_boss->isVisible())
+  {
+    Widget::draw();
+    return;
+  }
+
+  FBSurface& s = _boss->dialog().surface();
+  const int oldX = _x, oldY = _y;
+  const bool hilite = (_flags & Widget::FLAG_HILITED) != 0;
+
+  // Account for our relative position in the dialog
+  _x = getAbsX();
+  _y = getAbsY();
+
+  for(const int pos: _dirtyCells)
+  {
+    const int row = pos / _cols, col = pos % _cols;
+
+    if(row >= _rows)
+      continue;
+
+    // Clear the cell inside the grid lines
+    s.fillRect(_x + 1 + col * _colWidth, _y + 1 + row * _rowHeight,
+               _colWidth - 1, _rowHeight - 1,
+               hilite && isEnabled() && isEditable() ? _bgcolorhi : _bgcolor);
+    drawCell(s, row, col);
+  }
+  _dirtyCells.clear();
+
+  _x = oldX;
+  _y = oldY;
+  clearDirty();
+
+  drawChain();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void DataGridWidget::setDirty()
+{
+  _fullRedraw = true;
+  Widget::setDirty();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -21,6 +21,7 @@
 class DataGridOpsWidget;
 class ScrollBarWidget;
 class CommandSender;
+class FBSurface;
 
 #include "Widget.hxx"
 #include "EditableWidget.hxx"
@@ -53,6 +54,13 @@ class DataGridWidget : public EditableWidget
     void setList(int a, int v, bool changed);
     void setList(int a, int v); // automatically calculate if changed
 
+    /**
+      Update the given cells only.  The formatted strings of all other cells
+      are kept, and only the updated cells are redrawn.
+    */
+    void setValues(const IntArray& positions, const IntArray& values,
+                   const BoolArray& changed);
+
     void setEditable(bool editable, bool hiliteBG = true) override;
 
     void setHiliteList(const BoolArray& hilitelist);
@@ -96,8 +104,12 @@ class DataGridWidget : public EditableWidget
     bool handleKeyDown(StellaKey key, StellaMod mod) override;
     bool handleKeyUp(StellaKey key, StellaMod mod) override;
 
+    void draw() override;
+    void setDirty() override;
+
   protected:
     void drawWidget(bool hilite) override;
+    void drawCell(FBSurface& s, int row, int col);
 
     int findItem(int x, int y) const;
 
@@ -136,6 +148,10 @@ class DataGridWidget : public EditableWidget
     BoolArray   _changedList;
     BoolArray   _hiliteList;
 
+    // Cells to redraw, unless the whole widget has to be redrawn
+    IntArray    _dirtyCells;
+    bool        _fullRedraw{true};
+
     int       _selectedItem{0};
     StellaKey _currentKeyDown{KBDK_UNKNOWN};
     string    _backupString;
@@ -155,6 +171,8 @@ class DataGridWidget : public EditableWidget
 
     void enableEditMode(bool state) { _editMode = state; }
 
+    void updateCell(int position, int value, bool changed);
+
 
   private:
     // Following constructors and assignment operators not supported
@@ -54,7 +54,6 @@ PromptWidget::PromptWidget(GuiObject* boss, const GUI::Font& font,
   // Calculate depending values
   _lineWidth = (_w - ScrollBarWidget::scrollBarWidth(_font) - 2) / _kConsoleCharWidth;
   _linesPerPage = (_h - 2) / _kConsoleLineHeight;
-  _linesInBuffer = kBufferSize / _lineWidth;
 
   // Add scrollbar
   // NOLINTNEXTLINE: we want to initialize here, not in the member list
@@ -75,29 +74,43 @@ void PromptWidget::drawWidget(bool hilite)
   ColorId fgcolor{}, bgcolor{};
   FBSurface& s = _boss->dialog().surface();
 
-  // Draw text
-  const int start = _scrollLine - _linesPerPage + 1;
+  // Draw text; only the visible rows are wrapped
+  const Int64 start = _scrollLine - _linesPerPage + 1;
+  auto line = std::ranges::upper_bound(_lines, start, {}, &Line::row);
+  if(line != _lines.begin())
+    --line;
   int y = _y + 2;
 
-  for (int line = 0; line < _linesPerPage; ++line)
+  for(Int64 row = start; row <= _scrollLine; ++row, y += _kConsoleLineHeight)
   {
+    while(std::next(line) != _lines.end() && std::next(line)->row <= row)
+      ++line;
+    if(row < line->row)
+      continue;
+
+    const size_t first = (row - line->row) * _lineWidth;
+    const size_t last = std::min(first + _lineWidth, line->text.size());
     int x = _x + 1;
-    for (int column = 0; column < _lineWidth; ++column) {
-      const int c = buffer((start + line) * _lineWidth + column);
 
-      if(c & (1 << 17))  // inverse video flag
+    for(size_t column = first; column < last; ++column)
+    {
+      const int c = line->text[column];
+      const uInt16 attr = line->attrs.empty()
+        ? static_cast<uInt16>(kTextColor) : line->attrs[column];
+
+      if(attr & kInverseAttr)
       {
         fgcolor = _bgcolor;
-        bgcolor = static_cast<ColorId>((c & 0x1ffff) >> 8);
+        bgcolor = static_cast<ColorId>(attr & ~kInverseAttr);
         s.fillRect(x, y, _kConsoleCharWidth, _kConsoleCharHeight, bgcolor);
       }
       else
-        fgcolor = static_cast<ColorId>(c >> 8);
+        fgcolor = static_cast<ColorId>(attr);
 
-      s.drawChar(_font, c & 0x7f, x, y, fgcolor);
+      if(c != ' ')
+        s.drawChar(_font, c & 0x7f, x, y, fgcolor);
       x += _kConsoleCharWidth;
     }
-    y += _kConsoleLineHeight;
   }
 
   // Draw the caret
@@ -138,11 +151,14 @@ bool PromptWidget::handleText(char text)
   if(text >= 0)
   {
     // FIXME - convert this class to inherit from EditableWidget
-    for(int i = _promptEndPos - 1; i >= _currentPos; i--)
-      buffer(i + 1) = buffer(i);
+    Line& line = _lines.back();
+    line.text.insert(_currentPos, 1, ' ');
+    if(!line.attrs.empty())
+      line.attrs.insert(line.attrs.begin() + _currentPos, kTextColor);
     _promptEndPos++;
     putcharIntern(text);
     scrollToCurrent();
+    setDirty();
 
     resetFunctions();
   }
@@ -167,11 +183,11 @@ bool PromptWidget::handleKeyDown(StellaKey key, StellaMod mod)
   {
     case Event::EndEdit:
     {
-      if(_scrollLine < _currentPos / _lineWidth)
+      if(_scrollLine < rowOf(_currentPos))
       {
         // Scroll page by page when not at cursor position:
         _scrollLine = std::min(_scrollLine + _linesPerPage,
-                               _promptEndPos / _lineWidth);
+                               rowOf(_promptEndPos));
         updateScrollBuffer();
         break;
       }
@@ -271,7 +287,7 @@ bool PromptWidget::handleKeyDown(StellaKey key, StellaMod mod)
 
     // scrolling events
     case Event::UIUp:
-      if(_scrollLine <= _firstLineInBuffer + _linesPerPage - 1)
+      if(_scrollLine <= firstRow() + _linesPerPage - 1)
         break;
 
       _scrollLine -= 1;
@@ -280,7 +296,7 @@ bool PromptWidget::handleKeyDown(StellaKey key, StellaMod mod)
 
     case Event::UIDown:
       // Don't scroll down when at bottom of buffer
-      if(_scrollLine >= _promptEndPos / _lineWidth)
+      if(_scrollLine >= rowOf(_promptEndPos))
         break;
 
       _scrollLine += 1;
@@ -289,31 +305,32 @@ bool PromptWidget::handleKeyDown(StellaKey key, StellaMod mod)
 
     case Event::UIPgUp:
       // Don't scroll up when at top of buffer
-      if(_scrollLine < _linesPerPage)
+      if(_scrollLine <= firstRow() + _linesPerPage - 1)
         break;
 
       _scrollLine = std::max(_scrollLine - (_linesPerPage - 1),
-                             _firstLineInBuffer + _linesPerPage - 1);
+                             firstRow() + _linesPerPage - 1);
       updateScrollBuffer();
       break;
 
     case Event::UIPgDown:
       // Don't scroll down when at bottom of buffer
-      if(_scrollLine >= _promptEndPos / _lineWidth)
+      if(_scrollLine >= rowOf(_promptEndPos))
         break;
 
       _scrollLine = std::min(_scrollLine + (_linesPerPage - 1),
-                             _promptEndPos / _lineWidth);
+                             rowOf(_promptEndPos));
       updateScrollBuffer();
       break;
 
     case Event::UIHome:
-      _scrollLine = _firstLineInBuffer + _linesPerPage - 1;
+      _scrollLine = firstRow() + _linesPerPage - 1;
       updateScrollBuffer();
       break;
 
     case Event::UIEnd:
-      _scrollLine = std::max(_promptEndPos / _lineWidth, _linesPerPage - 1);
+      _scrollLine = std::max(rowOf(_promptEndPos),
+                             firstRow() + _linesPerPage - 1);
       updateScrollBuffer();
       break;
 
@@ -359,7 +376,7 @@ void PromptWidget::handleCommand(CommandSender* sender, int cmd,
 {
   if(cmd == GuiObject::kSetPositionCmd)
   {
-    const int newPos = data + _linesPerPage - 1 + _firstLineInBuffer;
+    const Int64 newPos = data + _linesPerPage - 1 + firstRow();
     if (newPos != _scrollLine)
     {
       _scrollLine = newPos;
@@ -441,10 +458,7 @@ void PromptWidget::killChar(int direction)
       return;
 
     _currentPos--;
-    for (int i = _currentPos; i < _promptEndPos; i++)
-      buffer(i) = buffer(i + 1);
-
-    buffer(_promptEndPos) = ' ';
+    eraseChars(_currentPos, 1);
     _promptEndPos--;
   }
   else if(direction == 1)    // Delete next character (delete)
@@ -453,14 +467,8 @@ void PromptWidget::killChar(int direction)
       return;
 
     // There are further characters to the right of cursor
-    if(_currentPos + 1 <= _promptEndPos)
-    {
-      for (int i = _currentPos; i < _promptEndPos; i++)
-        buffer(i) = buffer(i + 1);
-
-      buffer(_promptEndPos) = ' ';
-      _promptEndPos--;
-    }
+    eraseChars(_currentPos, 1);
+    _promptEndPos--;
   }
 }
 
@@ -476,9 +484,7 @@ void PromptWidget::killLine(int direction)
   }
   else if(direction == 1)  // erase from current position to end of line
   {
-    for (int i = _currentPos; i < _promptEndPos; i++)
-      buffer(i) = ' ';
-
+    eraseChars(_currentPos, _promptEndPos - _currentPos);
     _promptEndPos = _currentPos;
   }
 }
@@ -490,7 +496,7 @@ void PromptWidget::killWord()
   bool space = true;
   while (_currentPos > _promptStartPos)
   {
-    if ((buffer(_currentPos - 1) & 0xff) == ' ')
+    if (_lines.back().text[_currentPos - 1] == ' ')
     {
       if (!space)
         break;
@@ -502,25 +508,35 @@ void PromptWidget::killWord()
     cnt++;
   }
 
-  for (int i = _currentPos; i < _promptEndPos; i++)
-    buffer(i) = buffer(i + cnt);
-
-  buffer(_promptEndPos) = ' ';
+  eraseChars(_currentPos, cnt);
   _promptEndPos -= cnt;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void PromptWidget::eraseChars(int pos, int count)
+{
+  Line& line = _lines.back();
+
+  if(pos < 0 || std::cmp_greater_equal(pos, line.text.size()) || count <= 0)
+    return;
+
+  count = std::min(count, static_cast<int>(line.text.size()) - pos);
+  line.text.erase(pos, count);
+  if(!line.attrs.empty())
+    line.attrs.erase(line.attrs.begin() + pos, line.attrs.begin() + pos + count);
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 string PromptWidget::getLine()
 {
 #ifdef PSEUDO_CUT_COPY_PASTE
   assert(_promptEndPos >= _promptStartPos);
-  string text;
-
-  // Copy current line to text
-  for(int i = _promptStartPos; i < _promptEndPos; i++)
-    text += buffer(i) & 0x7f;
 
-  return text;
+  // Copy the input of the current line
+  if(_promptStartPos < 0)
+    return EmptyString();
+  return _lines.back().text.substr(_promptStartPos,
+                                   _promptEndPos - _promptStartPos);
 #endif
 }
 
@@ -675,16 +691,14 @@ bool PromptWidget::historyScroll(int direction)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool PromptWidget::execute()
 {
-  nextLine();
-
+  // Copy the user input to command
   assert(_promptEndPos >= _promptStartPos);
-  const int len = _promptEndPos - _promptStartPos;
+  const string command = getLine();
 
-  if(len > 0)
-  {
-    // Copy the user input to command
-    const string command = getLine();
+  nextLine();
 
+  if(!command.empty())
+  {
     // Add the input to the history
     addToHistory(command.c_str());
 
@@ -732,7 +746,7 @@ bool PromptWidget::autoComplete(int direction)
   {
     // copy the input at first tab press only
     if(_tabCount == -1)
-      _inputStr[i] = buffer(_promptStartPos + i) & 0x7f;
+      _inputStr[i] = _lines.back().text[_promptStartPos + i];
     // whitespace characters
     if(strchr("{*@<> =[]()+-/&|!^~%", _inputStr[i]))
     {
@@ -780,7 +794,8 @@ bool PromptWidget::autoComplete(int direction)
   else
     _tabCount = (_tabCount + 1) % lst.size();
 
-  nextLine();
+  _textcolor = kTextColor;
+  _inverse = false;
   _currentPos = _promptStartPos;
   killLine(1);  // kill whole line
 
@@ -805,11 +820,24 @@ void PromptWidget::nextLine()
   _textcolor = kTextColor;
   _inverse = false;
 
-  const int line = _currentPos / _lineWidth;
-  if (line == _scrollLine && _scrollLine < _scrollStopLine)
-    _scrollLine++;
+  // The completed line only keeps the rows actually used
+  const Line& current = _lines.back();
+  const Int64 row = current.row + std::max<Int64>(1,
+      (static_cast<Int64>(current.text.size()) + _lineWidth - 1) / _lineWidth);
+
+  if (_scrollLine >= rowOf(_currentPos) && _scrollLine < row &&
+      _scrollLine < _scrollStopLine)
+    _scrollLine = row;
 
-  _currentPos = (line + 1) * _lineWidth;
+  // Drop the oldest line when the scrollback is full
+  _lines.emplace_back().row = row;
+  if(_lines.size() > kMaxLines)
+  {
+    _lines.pop_front();
+    _scrollLine = std::max(_scrollLine, firstRow() + _linesPerPage - 1);
+  }
+  _currentPos = 0;
+  _promptStartPos = _promptEndPos = -1;
 
   updateScrollBuffer();
 }
@@ -818,22 +846,11 @@ void PromptWidget::nextLine()
 // Call this (at least) when the current line changes or when a new line is added
 void PromptWidget::updateScrollBuffer()
 {
-  const int lastchar = std::max(_promptEndPos, _currentPos),
-            line = lastchar / _lineWidth,
-            numlines = (line < _linesInBuffer) ? line + 1 : _linesInBuffer,
-            firstline = line - numlines + 1;
-
-  if (firstline > _firstLineInBuffer)
-  {
-    // clear old line from buffer
-    for (int i = lastchar; i < (line+1) * _lineWidth; ++i)
-      buffer(i) = ' ';
-
-    _firstLineInBuffer = firstline;
-  }
+  const Int64 line = rowOf(std::max(_promptEndPos, _currentPos));
 
-  _scrollBar->_numEntries = numlines;
-  _scrollBar->_currentPos = _scrollBar->_numEntries - (line - _scrollLine + _linesPerPage);
+  _scrollBar->_numEntries = static_cast<int>(line - firstRow() + 1);
+  _scrollBar->_currentPos = _scrollBar->_numEntries -
+      static_cast<int>(line - _scrollLine + _linesPerPage);
   _scrollBar->_entriesPerPage = _linesPerPage;
   _scrollBar->recalc();
 }
@@ -878,26 +895,42 @@ void PromptWidget::putcharIntern(int c)
   }
   else if(isprint(c) || c == 0x1e || c == 0x1f) // graphic bits chars
   {
-    buffer(_currentPos) = c | (_textcolor << 8) | (_inverse << 17);
+    Line& line = _lines.back();
+    const uInt16 attr = static_cast<uInt16>(_textcolor) | (_inverse ? kInverseAttr : 0);
+
+    // Only lines with colors or inverse video need attributes
+    if(line.attrs.empty() && attr != kTextColor)
+      line.attrs.assign(line.text.size(), kTextColor);
+
+    if(std::cmp_less(_currentPos, line.text.size()))
+      line.text[_currentPos] = static_cast<char>(c);
+    else
+      line.text.push_back(static_cast<char>(c));
+    if(!line.attrs.empty())
+    {
+      line.attrs.resize(line.text.size(), kTextColor);
+      line.attrs[_currentPos] = attr;
+    }
+
     _currentPos++;
-    if ((_scrollLine + 1) * _lineWidth == _currentPos
-        && _scrollLine < _scrollStopLine)
+    if (rowOf(_currentPos) == _scrollLine + 1 && _scrollLine < _scrollStopLine)
     {
       _scrollLine++;
       updateScrollBuffer();
     }
   }
-  setDirty();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void PromptWidget::print(string_view str)
 {
   // limit scrolling of long text output
-  _scrollStopLine = _currentPos / _lineWidth + _linesPerPage - 1;
+  _scrollStopLine = rowOf(_currentPos) + _linesPerPage - 1;
   for(const auto c : str)
     putcharIntern(c);
-  _scrollStopLine = INT_MAX;
+  _scrollStopLine = std::numeric_limits<Int64>::max();
+
+  setDirty();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -905,17 +938,18 @@ void PromptWidget::drawCaret()
 {
 //cerr << "PromptWidget::drawCaret()\n";
   FBSurface& s = _boss->dialog().surface();
-  const int line = _currentPos / _lineWidth;
+  const Int64 line = rowOf(_currentPos);
 
   // Don't draw the cursor if it's not in the current view
-  if(_scrollLine < line)
+  if(_scrollLine < line || line <= _scrollLine - _linesPerPage)
     return;
 
-  const int displayLine = line - _scrollLine + _linesPerPage - 1,
+  const int displayLine = static_cast<int>(line - _scrollLine) + _linesPerPage - 1,
                           x = _x + 1 + (_currentPos % _lineWidth) * _kConsoleCharWidth,
                           y = _y + displayLine * _kConsoleLineHeight;
 
-  const char c = buffer(_currentPos); //FIXME: int to char??
+  const string& text = _lines.back().text;
+  const char c = std::cmp_less(_currentPos, text.size()) ? text[_currentPos] : ' ';
   s.fillRect(x, y, _kConsoleCharWidth, _kConsoleLineHeight, kTextColor);
   s.drawChar(_font, c, x, y + 2, kBGColor);
 }
@@ -923,7 +957,7 @@ void PromptWidget::drawCaret()
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void PromptWidget::scrollToCurrent()
 {
-  const int line = _promptEndPos / _lineWidth;
+  const Int64 line = rowOf(_promptEndPos);
 
   if (line + _linesPerPage <= _scrollLine)
   {
@@ -940,20 +974,24 @@ void PromptWidget::scrollToCurrent()
 string PromptWidget::saveBuffer(const FSNode& file)
 {
   string out;
-  out.reserve(_promptStartPos);  // reasonable upper bound
+  size_t size = 0;
+  for(const auto& line: _lines)
+    size += line.text.size() + 1;
+  out.reserve(size);
 
-  for(int start = 0; start < _promptStartPos; start += _lineWidth)
+  // The current line is saved up to the prompt only
+  for(size_t i = 0; i < _lines.size(); ++i)
   {
-    int end = start + _lineWidth - 1;
-    // Look for first non-space, printing char from end of line
-    while(end >= start && static_cast<char>(_buffer[end] & 0xff) <= ' ')
-      end--;
+    string_view text = _lines[i].text;
+    if(i == _lines.size() - 1)
+      text = text.substr(0, std::max(_promptStartPos, 0));
 
-    // Spit out the line minus its trailing junk
-    // Strip off any color/inverse bits
-    for(int j = start; j <= end; ++j)
-      out += static_cast<char>(_buffer[j] & 0xff);
+    // Strip off any trailing junk
+    size_t end = text.size();
+    while(end > 0 && text[end - 1] <= ' ')
+      end--;
 
+    out += text.substr(0, end);
     out += '\n';
   }
   try
@@ -973,11 +1011,11 @@ string PromptWidget::saveBuffer(const FSNode& file)
 void PromptWidget::clearScreen()
 {
   // Initialize start position
+  _lines.clear();
+  _lines.emplace_back();
   _currentPos = 0;
   _scrollLine = _linesPerPage - 1;
-  _firstLineInBuffer = 0;
   _promptStartPos = _promptEndPos = -1;
-  memset(_buffer, 0, kBufferSize * sizeof(int));
 
   if(!_firstTime)
     updateScrollBuffer();
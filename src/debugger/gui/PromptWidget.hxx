@@ -19,6 +19,7 @@
 #define PROMPT_WIDGET_HXX
 
 #include <cstdarg>
+#include <deque>
 
 class ScrollBarWidget;
 class FSNode;
@@ -69,7 +70,6 @@ class PromptWidget : public Widget, public CommandSender
   protected:
     ATTRIBUTE_FMT_PRINTF int printf(const char* format, ...);
     ATTRIBUTE_FMT_PRINTF int vprintf(const char* format, va_list argptr);
-    int& buffer(int idx) { return _buffer[idx % kBufferSize]; }
 
     void drawWidget(bool hilite) override;
     void drawCaret();
@@ -78,11 +78,16 @@ class PromptWidget : public Widget, public CommandSender
     void updateScrollBuffer();
     void scrollToCurrent();
 
+    // Rows of the scrollback
+    Int64 firstRow() const { return _lines.front().row; }
+    Int64 rowOf(int pos) const { return _lines.back().row + pos / _lineWidth; }
+
     // Line editing
     void nextLine();
     void killChar(int direction);
     void killLine(int direction);
     void killWord();
+    void eraseChars(int pos, int count);
 
     // Clipboard
     string getLine();
@@ -101,25 +106,37 @@ class PromptWidget : public Widget, public CommandSender
 
   private:
     enum: uInt16 {
-      kBufferSize = 32768,
       kLineBufferSize = 256,
       kHistorySize = 1000
     };
+    // Number of lines kept in the scrollback
+    static constexpr size_t kMaxLines = 100000;
+
+    // Character attributes; the color is stored in the lower bits
+    static constexpr uInt16 kInverseAttr = 0x8000;
+
+    // A line of output (or the current input), which is only wrapped at the
+    // widget width when it is drawn
+    struct Line {
+      string text;
+      vector<uInt16> attrs;  // per character, empty if all have the default
+      Int64 row{0};          // the first (wrapped) row of the line
+    };
 
-    int  _buffer[kBufferSize]{};  // NOLINT  (will be rewritten soon)
-    int  _linesInBuffer{0};
+    // The scrollback as a ring of lines; the last line is the current one
+    std::deque<Line> _lines;
 
     int  _lineWidth{0};
     int  _linesPerPage{0};
 
+    // Positions within the current line
     int  _currentPos{0};
-    int  _scrollLine{0};
-    int  _firstLineInBuffer{0};
-    int  _scrollStopLine{INT_MAX};
-
     int  _promptStartPos{0};
     int  _promptEndPos{0};
 
+    Int64 _scrollLine{0};  // row shown at the bottom
+    Int64 _scrollStopLine{std::numeric_limits<Int64>::max()};
+
     ScrollBarWidget* _scrollBar{nullptr};
 
     std::vector<string> _history;
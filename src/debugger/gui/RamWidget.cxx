@@ -348,7 +348,12 @@ void RamWidget::fillGrid(bool updateOld)
   IntArray vlist;
   BoolArray changed;
 
+  alist.reserve(myPageSize);
+  vlist.reserve(myPageSize);
+  changed.reserve(myPageSize);
+
   const uInt32 start = myCurrentRamBank * myPageSize;
+  // Only the cells which differ from the grid are reformatted and redrawn
   fillList(start, myPageSize, alist, vlist, changed);
 
   if(updateOld)
@@ -409,30 +414,18 @@ string RamWidget::doSearch(string_view str)
 
   const int searchVal = instance().debugger().stringToValue(str);
 
-  // Clear the search array of previous items
-  mySearchAddr.clear();
-  mySearchValue.clear();
-  mySearchState.clear();
-
-  // Now, search all memory locations for this value, and add it to the
-  // search array
+  // Start a new search over all memory locations, keeping only those
+  // which contain this value
   const ByteArray& ram = currentRam(0);
-  bool hitfound = false;
-  for(uInt32 addr = 0; addr < ram.size(); ++addr)
+  mySearch.start(ram);
+  if(comparisonSearch)
   {
-    const int value = ram[addr];
-    if(comparisonSearch && searchVal != value)
-    {
-      mySearchState.push_back(false);
-    }
+    if(searchVal >= 0 && searchVal <= 255)
+      mySearch.filterEqual(ram, static_cast<uInt8>(searchVal));
     else
-    {
-      mySearchAddr.push_back(addr);
-      mySearchValue.push_back(value);
-      mySearchState.push_back(true);
-      hitfound = true;
-    }
+      mySearch.reset();
   }
+  const bool hitfound = mySearch.count() > 0;
 
   // If we have some hits, enable the comparison methods
   if(hitfound)
@@ -451,67 +444,45 @@ string RamWidget::doSearch(string_view str)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 string RamWidget::doCompare(string_view str)
 {
-  bool comparativeSearch = false;
-  int searchVal = 0, offset = 0;
-
   if(str.empty())
     return "Enter an absolute or comparative value";
 
   // Do some pre-processing on the string
-  const string::size_type pos = str.find_first_of("+-", 0);
+  const string::size_type pos = str.find_first_of("+-!", 0);
   if(pos > 0 && pos != string::npos)
   {
-    // Only accept '+' or '-' at the start of the string
-    return "Input must be [+|-]NUM";
+    // Only accept '+', '-' or '!' at the start of the string
+    return "Input must be [+|-]NUM or !";
   }
 
-  // A comparative search searches memory for locations that have changed by
-  // the specified amount, vs. for exact values
-  if(str[0] == '+' || str[0] == '-')
-  {
-    comparativeSearch = true;
-    bool negative = false;
-    if(str[0] == '-')
-      negative = true;
-
-    string tmp{str};
-    tmp.erase(0, 1);  // remove the operator
-    offset = instance().debugger().stringToValue(tmp);
-    if(negative)
-      offset = -offset;
-  }
-  else
-    searchVal = instance().debugger().stringToValue(str);
-
-  // Now, search all memory locations previously 'found' for this value
+  // Now, filter all memory locations previously 'found'
   const ByteArray& ram = currentRam(0);
-  bool hitfound = false;
-  IntArray tempAddrList, tempValueList;
-  mySearchState.clear();
-  for(uInt32 i = 0; i < ram.size(); ++i)
-    mySearchState.push_back(false);
+  if(str[0] == '!')
+  {
+    // Search memory for locations that have changed at all
+    if(str.size() > 1)
+      return "Input must be [+|-]NUM or !";
 
-  for(uInt32 i = 0; i < mySearchAddr.size(); ++i)
+    mySearch.filterChanged(ram);
+  }
+  else if(str[0] == '+' || str[0] == '-')
   {
-    if(comparativeSearch)
-    {
-      searchVal = mySearchValue[i] + offset;
-      if(searchVal < 0 || searchVal > 255)
-        continue;
-    }
+    // A comparative search searches memory for locations that have changed by
+    // the specified amount, vs. for exact values
+    const int offset = instance().debugger().stringToValue(str.substr(1));
 
-    const int addr = mySearchAddr[i];
-    if(std::cmp_equal(ram[addr], searchVal))
-    {
-      tempAddrList.push_back(addr);
-      tempValueList.push_back(searchVal);
-      mySearchState[addr] = hitfound = true;
-    }
+    mySearch.filterChangedBy(ram, str[0] == '-' ? -offset : offset);
   }
+  else
+  {
+    const int searchVal = instance().debugger().stringToValue(str);
 
-  // Update the searchArray for the new addresses and data
-  mySearchAddr = tempAddrList;
-  mySearchValue = tempValueList;
+    if(searchVal >= 0 && searchVal <= 255)
+      mySearch.filterEqual(ram, static_cast<uInt8>(searchVal));
+    else
+      mySearch.reset();
+  }
+  const bool hitfound = mySearch.count() > 0;
 
   // If we have some hits, enable the comparison methods
   if(hitfound)
@@ -530,9 +501,7 @@ string RamWidget::doCompare(string_view str)
 void RamWidget::doRestart()
 {
   // Erase all search buffers, reset to start mode
-  mySearchAddr.clear();
-  mySearchValue.clear();
-  mySearchState.clear();
+  mySearch.reset();
   showSearchResults();
 
   mySearchButton->setEnabled(true);
@@ -545,16 +514,6 @@ void RamWidget::showSearchResults()
 {
   // Only update the search results for the bank currently being shown
   BoolArray temp;
-  const uInt32 start = myCurrentRamBank * myPageSize;
-  if(mySearchState.empty() || start > mySearchState.size())
-  {
-    for(uInt32 i = 0; i < myPageSize; ++i)
-      temp.push_back(false);
-  }
-  else
-  {
-    for(uInt32 i = start; i < start + myPageSize; ++i)
-      temp.push_back(mySearchState[i]);
-  }
+  mySearch.fillHiliteList(myCurrentRamBank * myPageSize, myPageSize, temp);
   myRamGrid->setHiliteList(temp);
 }
@@ -29,6 +29,7 @@ class InputTextDialog;
 
 #include "Widget.hxx"
 #include "Command.hxx"
+#include "RamSearch.hxx"
 
 class RamWidget : public Widget, public CommandSender
 {
@@ -117,9 +118,7 @@ class RamWidget : public Widget, public CommandSender
     ButtonWidget* myRestartButton{nullptr};
 
     ByteArray myOldValueList;
-    IntArray mySearchAddr;
-    IntArray mySearchValue;
-    BoolArray mySearchState;
+    RamSearch mySearch;
 
   private:
     // Following constructors and assignment operators not supported
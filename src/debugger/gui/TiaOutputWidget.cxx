@@ -47,6 +47,7 @@ TiaOutputWidget::TiaOutputWidget(GuiObject* boss, const GUI::Font& font,
   VarList::push_back(l, "Fill to scanline", "scanline");
   VarList::push_back(l, "Toggle breakpoint", "bp");
   VarList::push_back(l, "Set zoom position", "zoom");
+  VarList::push_back(l, "Toggle CPU budget", "budget");
 #ifdef IMAGE_SUPPORT
   VarList::push_back(l, "Save snapshot", "snap");
 #endif
@@ -183,6 +184,15 @@ void TiaOutputWidget::handleCommand(CommandSender* sender, int cmd, int data, in
       if(myZoom)
         myZoom->setPos(myClickX, myClickY);
     }
+    else if(rmb == "budget")
+    {
+      TIA& tia = instance().console().tia();
+
+      tia.enableLineBudget(!tia.lineBudgetEnabled());
+      instance().frameBuffer().showTextMessage(tia.lineBudgetEnabled()
+        ? "CPU budget enabled" : "CPU budget disabled");
+      setDirty();
+    }
     else if(rmb == "snap")
     {
       instance().debugger().parser().run("saveSnap");
@@ -226,6 +236,16 @@ string TiaOutputWidget::getToolTip(const Common::Point& pos) const
     << "\nY: #" << idx.y + startLine
     << "\nC: $" << Common::Base::toString(tiaOutputBuffer[i], Common::Base::Fmt::_16);
 
+  if(instance().console().tia().lineBudgetEnabled())
+  {
+    const TIA::LineBudget budget = lineBudget(startLine + yStart + idx.y);
+
+    buf << "\nCPU: #" << budget.cpu()
+        << "\nWSYNC: #" << budget.wsync;
+    if(budget.arm)
+      buf << "\nARM: #" << budget.arm;
+  }
+
   return buf.str();
 }
 
@@ -273,7 +293,49 @@ void TiaOutputWidget::drawWidget(bool hilite)
     s.drawPixels(myLineBuffer.data(), _x + 1, _y + 1 + y, width << 1);
   }
 
+  if(instance().console().tia().lineBudgetEnabled())
+    drawLineBudget(yStart, height);
+
   // Show electron beam position
   if(visible && scanx < width && scany+2U < height)
     s.fillRect(_x + 1 + (scanx<<1), _y + 1 + scany, 3, 3, kColorInfo);
 }
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TIA::LineBudget TiaOutputWidget::lineBudget(uInt32 scanline) const
+{
+  const TIA& tia = instance().console().tia();
+
+  // Like the image, lines not reached yet show the last frame
+  return tia.lineBudget(scanline, scanline >= tia.scanlines());
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TiaOutputWidget::drawLineBudget(uInt32 yStart, uInt32 height)
+{
+  FBSurface& s = dialog().surface();
+  const uInt32 startLine = instance().console().tia().startLine() + yStart;
+  const int armX = _x + 1 + (TIAConstants::H_CYCLES << 1) + 4;
+
+  // The ARM time is scaled to the busiest line displayed
+  uInt32 maxArm = 0;
+  for(uInt32 y = 0; y < height; ++y)
+    maxArm = std::max(maxArm, lineBudget(startLine + y).arm);
+
+  // CPU cycles as a bar of two pixels per cycle; lines without any WSYNC
+  // (i.e. using the whole line) are highlighted
+  for(uInt32 y = 0; y < height; ++y)
+  {
+    const TIA::LineBudget budget = lineBudget(startLine + y);
+
+    if(budget.cpu())
+      s.hLine(_x + 1, _y + 1 + y, _x + (budget.cpu() << 1),
+              budget.wsync ? kColorInfo : kDbgColorRed);
+    if(maxArm)
+    {
+      const uInt32 w = budget.arm * ARM_BAR_WIDTH / maxArm;
+      if(w)
+        s.hLine(armX, _y + 1 + y, armX + w - 1, kDbgColorHi);
+    }
+  }
+}
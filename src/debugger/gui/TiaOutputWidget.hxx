@@ -25,6 +25,7 @@ class FBSurface;
 
 #include "Widget.hxx"
 #include "Command.hxx"
+#include "TIA.hxx"
 
 class TiaOutputWidget : public Widget, public CommandSender
 {
@@ -63,6 +64,16 @@ class TiaOutputWidget : public Widget, public CommandSender
     void handleCommand(CommandSender* sender, int cmd, int data, int id) override;
 
   private:
+    /**
+      Draw the CPU budget overlay: the CPU cycles used before WSYNC of each
+      displayed scanline, and the ARM time relative to the busiest line.
+    */
+    void drawLineBudget(uInt32 yStart, uInt32 height);
+    TIA::LineBudget lineBudget(uInt32 scanline) const;
+
+  private:
+    static constexpr uInt32 ARM_BAR_WIDTH = 32;
+
     unique_ptr<ContextMenu> myMenu;
     TiaZoomWidget* myZoom{nullptr};
 
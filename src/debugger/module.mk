@@ -2,14 +2,23 @@ MODULE := src/debugger
 
 MODULE_OBJS := \
         src/debugger/BreakpointMap.o \
+        src/debugger/CallProfiler.o \
         src/debugger/Debugger.o \
+        src/debugger/DebugScriptRunner.o \
         src/debugger/DebuggerParser.o \
         src/debugger/CartDebug.o \
         src/debugger/CpuDebug.o \
         src/debugger/DiStella.o \
+        src/debugger/ExpressionCache.o \
+        src/debugger/ExpressionProgram.o \
+        src/debugger/LockstepServer.o \
+        src/debugger/RamSearch.o \
         src/debugger/RiotDebug.o \
+        src/debugger/StateSearch.o \
+        src/debugger/StepHistory.o \
         src/debugger/TIADebug.o \
-        src/debugger/TimerMap.o
+        src/debugger/TimerMap.o \
+        src/debugger/TraceRecorder.o
 
 MODULE_TEST_OBJS =
 
@@ -0,0 +1,196 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2026 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+
+#include <algorithm>
+
+#include "ArmProfiler.hxx"
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void ArmProfiler::addFunction(string_view name, uInt32 start, uInt32 size)
+{
+  const auto it = std::ranges::upper_bound(myFunctions, start, {},
+                                           &Function::start);
+  myFunctions.insert(it, Function{string{name}, start, size});
+  myIds.clear();
+
+  // Functions of unknown size extend to the next function
+  for(size_t i = 0; i < myFunctions.size(); ++i)
+  {
+    Function& fn = myFunctions[i];
+
+    if(fn.size)
+      fn.end = fn.start + fn.size - 1;
+    else if(i + 1 < myFunctions.size())
+      fn.end = std::max(fn.start, myFunctions[i + 1].start - 1);
+    else
+      fn.end = fn.start;
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void ArmProfiler::addRange(string_view name, uInt32 start, uInt32 end,
+                           uInt32 blockSize)
+{
+  myRanges.emplace_back(string{name}, start, end, blockSize);
+  myIds.clear();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void ArmProfiler::endRun(uInt64 cycles)
+{
+  if(myRunSamples.empty())
+  {
+    myTotalCycles += cycles;
+    return;
+  }
+
+  const double weight = static_cast<double>(cycles) / myRunSamples.size();
+
+  for(const auto& [pc, lr]: myRunSamples)
+  {
+    const uInt32 id = resolve(pc);
+    // LR points after the BL instruction
+    uInt32 caller = lr >= 2 ? resolve(lr - 2) : UNKNOWN;
+    if(caller == id)
+      caller = UNKNOWN;
+
+    if(id >= mySelf.size())
+      mySelf.resize(id + 1);
+    mySelf[id].cycles += weight;
+    ++mySelf[id].samples;
+
+    Costs& stack = myStacks[{caller, id}];
+    stack.cycles += weight;
+    ++stack.samples;
+  }
+  myTotalCycles += cycles;
+  myTotalSamples += static_cast<uInt32>(myRunSamples.size());
+  myRunSamples.clear();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void ArmProfiler::reset()
+{
+  myRunSamples.clear();
+  mySelf.clear();
+  myStacks.clear();
+  myTotalCycles = 0;
+  myTotalSamples = 0;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt32 ArmProfiler::resolve(uInt32 address)
+{
+  if(const auto it = myIds.find(address); it != myIds.end())
+    return it->second;
+
+  const string fnName = name(address);
+  uInt32 id = UNKNOWN;
+
+  if(!fnName.empty())
+  {
+    const auto [it, inserted] =
+      myNameIds.try_emplace(fnName, static_cast<uInt32>(myNames.size()));
+    if(inserted)
+      myNames.push_back(fnName);
+    id = it->second;
+  }
+  myIds.emplace(address, id);
+
+  return id;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+string ArmProfiler::name(uInt32 address) const
+{
+  // Find the last function starting at or before the address
+  auto it = std::ranges::upper_bound(myFunctions, address, {},
+                                     &Function::start);
+  if(it != myFunctions.begin() && address <= (--it)->end)
+    return it->name;
+
+  for(const auto& range: myRanges)
+    if(address >= range.start && address <= range.end)
+    {
+      const uInt32 offset = (address - range.start) & ~(range.blockSize - 1);
+      return std::format("{}+{:#06x}", range.name, offset);
+    }
+
+  return "";
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+vector<std::pair<uInt32, const ArmProfiler::Costs*>>
+ArmProfiler::sortedSelf() const
+{
+  vector<std::pair<uInt32, const Costs*>> sorted;
+
+  for(uInt32 id = 0; id < mySelf.size(); ++id)
+    if(mySelf[id].samples)
+      sorted.emplace_back(id, &mySelf[id]);
+
+  std::ranges::sort(sorted, [](const auto& a, const auto& b) {
+    return a.second->cycles > b.second->cycles;
+  });
+
+  return sorted;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+string ArmProfiler::flatProfile() const
+{
+  if(!myTotalSamples)
+    return "no ARM samples collected";
+
+  std::ostringstream buf;
+  double sum = 0.;
+
+  buf << std::format("{} ARM cycles, {} samples (every {} instructions)\n",
+                     myTotalCycles, myTotalSamples, INTERVAL)
+      << std::format("{:>7} {:>7} {:>12} {:>8}  {}",
+                     "self%", "cumul%", "cycles", "samples", "function");
+
+  for(const auto& [id, costs]: sortedSelf())
+  {
+    const double percent = costs->cycles * 100. / myTotalCycles;
+    sum += percent;
+    buf << std::format("\n{:>6.2f}% {:>6.2f}% {:>12.0f} {:>8}  {}",
+                       percent, sum, costs->cycles, costs->samples,
+                       myNames[id]);
+  }
+
+  return buf.str();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+string ArmProfiler::collapsedStacks() const
+{
+  std::ostringstream buf;
+
+  for(const auto& [ids, costs]: myStacks)
+  {
+    const auto [caller, id] = ids;
+
+    if(caller != UNKNOWN)
+      buf << myNames[caller] << ';';
+    buf << myNames[id]
+        << std::format(" {:.0f}\n", costs.cycles);
+  }
+
+  return buf.str();
+}
@@ -0,0 +1,177 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2026 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+
+#ifndef ARM_PROFILER_HXX
+#define ARM_PROFILER_HXX
+
+#include <map>
+#include <unordered_map>
+
+#include "bspf.hxx"
+
+/**
+  Sampling profiler for the ARM code of ELF and CDF/BUS/DPC+ carts.  Every
+  INTERVAL instructions the ARM emulation records the PC and LR; at the end
+  of each ARM run, the cycles of the run are distributed over its samples.
+  The addresses are resolved to functions, using the symbols of ELF carts,
+  or else to fixed size blocks of named address ranges.
+
+  Without frame pointers, the stack cannot be walked; so the LR is used as
+  the caller of the sampled function.  This is exact for leaf functions,
+  but only approximate for others (after the first call, LR points into the
+  function itself, which is then reported without caller).
+
+  The results are available as a flat profile and in the collapsed stack
+  format ('caller;function cycles') used by flame graph tools.
+
+  @author  Stella Team
+*/
+class ArmProfiler
+{
+  public:
+    // Sample every INTERVAL instructions (a prime avoids aliasing with loops)
+    static constexpr uInt32 INTERVAL = 61;
+
+  public:
+    ArmProfiler() = default;
+    ~ArmProfiler() = default;
+
+    /**
+      Add a function (e.g. from the ELF symbol table).
+
+      @param name   The name of the function
+      @param start  The first address of the function
+      @param size   The size of the function in bytes (0 if unknown, then
+                    the function extends to the next one)
+    */
+    void addFunction(string_view name, uInt32 start, uInt32 size);
+
+    /**
+      Add an address range, whose addresses not covered by a function are
+      reported in blocks ('name+offset').
+
+      @param name       The name of the range
+      @param start      The first address of the range
+      @param end        The last address of the range
+      @param blockSize  The size of the blocks, a power of two
+    */
+    void addRange(string_view name, uInt32 start, uInt32 end,
+                  uInt32 blockSize = 0x100);
+
+    /**
+      Called by the ARM emulation before each instruction.
+
+      @return  True if a sample must be taken
+    */
+    bool due() {
+      if(--myCountdown)
+        return false;
+      myCountdown = INTERVAL;
+      return true;
+    }
+
+    /**
+      Record a sample.
+
+      @param pc  The address of the next instruction
+      @param lr  The link register
+    */
+    void sample(uInt32 pc, uInt32 lr) {
+      myRunSamples.emplace_back(pc & ~1U, lr & ~1U);
+    }
+
+    /**
+      Called at the end of each ARM run, to attribute the cycles of the run
+      to its samples.
+
+      @param cycles  The ARM cycles of the run
+    */
+    void endRun(uInt64 cycles);
+
+    /**
+      Discard all collected samples.
+    */
+    void reset();
+
+    uInt64 totalCycles() const { return myTotalCycles; }
+
+    /**
+      Answer the flat profile, one function per line, ordered by the cycles
+      spent in the function itself.
+    */
+    string flatProfile() const;
+
+    /**
+      Answer the profile in collapsed stack format, for flame graphs.
+    */
+    string collapsedStacks() const;
+
+  private:
+    struct Function {
+      string name;
+      uInt32 start{0};
+      uInt32 size{0};
+      uInt32 end{0};
+    };
+    struct Range {
+      string name;
+      uInt32 start{0};
+      uInt32 end{0};
+      uInt32 blockSize{0};
+    };
+    struct Costs {
+      double cycles{0.};
+      uInt32 samples{0};
+    };
+
+    static constexpr uInt32 UNKNOWN = 0;  // id of unresolved addresses
+
+  private:
+    uInt32 resolve(uInt32 address);
+    string name(uInt32 address) const;
+
+    vector<std::pair<uInt32, const Costs*>> sortedSelf() const;
+
+  private:
+    vector<Function> myFunctions;  // sorted by start address
+    vector<Range> myRanges;
+
+    uInt32 myCountdown{INTERVAL};
+    vector<std::pair<uInt32, uInt32>> myRunSamples;  // PC, LR
+
+    // Names of the functions and blocks, by id; the ids of all addresses
+    // seen so far are cached
+    vector<string> myNames{"[unknown]"};
+    std::unordered_map<string, uInt32> myNameIds;
+    std::unordered_map<uInt32, uInt32> myIds;
+
+    // Costs by function id, and by caller and function id
+    vector<Costs> mySelf;
+    std::map<std::pair<uInt32, uInt32>, Costs> myStacks;
+    uInt64 myTotalCycles{0};
+    uInt32 myTotalSamples{0};
+
+  private:
+    // Following constructors and assignment operators not supported
+    ArmProfiler(const ArmProfiler&) = delete;
+    ArmProfiler(ArmProfiler&&) = delete;
+    ArmProfiler& operator=(const ArmProfiler&) = delete;
+    ArmProfiler& operator=(ArmProfiler&&) = delete;
+};
+
+#endif // ARM_PROFILER_HXX
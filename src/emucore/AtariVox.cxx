@@ -16,6 +16,7 @@
 //============================================================================
 
 #include "MediaFactory.hxx"
+#include "SerialPortAsync.hxx"
 #include "System.hxx"
 #include "AtariVox.hxx"
 
@@ -24,7 +25,7 @@ AtariVox::AtariVox(Jack jack, const Event& event, const System& system,
                    const string& portname, const FSNode& eepromfile,
                    const onMessageCallback& callback)
   : SaveKey(jack, event, system, eepromfile, callback, Controller::Type::AtariVox),
-    mySerialPort{MediaFactory::createSerialPort()}
+    mySerialPort{std::make_unique<SerialPortAsync>(MediaFactory::createSerialPort())}
 {
   if(mySerialPort->openPort(portname))
   {
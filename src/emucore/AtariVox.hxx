@@ -101,7 +101,8 @@ class AtariVox : public SaveKey
   private:
     // Instance of an real serial port on the system
     // Assuming there's a real AtariVox attached, we can send SpeakJet
-    // bytes directly to it
+    // bytes directly to it (through a worker thread, so that a slow port
+    // never stalls the emulation)
     unique_ptr<SerialPort> mySerialPort;
 
     // How many bits have been shifted into the shift register?
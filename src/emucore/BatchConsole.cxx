@@ -0,0 +1,341 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2026 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+
+#include "Cart.hxx"
+#include "Device.hxx"
+#include "HeadlessConsole.hxx"
+#include "M6502.hxx"
+#include "M6532.hxx"
+#include "System.hxx"
+#include "TIA.hxx"
+#include "exception/FatalEmulationError.hxx"
+#include "BatchConsole.hxx"
+
+// The instruction code in M6502.ins is shared with the M6502; the debugger
+// tracking of the sources of the registers is left out here
+#define DISASM_CODE  Device::CODE
+#define DISASM_DATA  Device::DATA
+#define DISASM_WRITE Device::WRITE
+#define DISASM_NONE  Device::NONE
+#define SET_LAST_PEEK(_addr1, _addr2)
+#define CLEAR_LAST_PEEK(_addr)
+#define SET_LAST_POKE(_addr)
+
+namespace {
+  // The processor status register of a lane, as used by M6502.ins
+  // (see M6502::PS())
+  struct StatusRegister
+  {
+    bool &N, &V, &B, &D, &I, &notZ, &C;
+
+    uInt8 operator()() const {
+      uInt8 ps = 0x20;
+
+      if(N)     ps |= 0x80;
+      if(V)     ps |= 0x40;
+      if(B)     ps |= 0x10;
+      if(D)     ps |= 0x08;
+      if(I)     ps |= 0x04;
+      if(!notZ) ps |= 0x02;
+      if(C)     ps |= 0x01;
+
+      return ps;
+    }
+
+    void operator()(uInt8 ps) const {
+      N = ps & 0x80;
+      V = ps & 0x40;
+      B = true;        // The 6507's B flag is always true
+      D = ps & 0x08;
+      I = ps & 0x04;
+      notZ = !(ps & 0x02);
+      C = ps & 0x01;
+    }
+  };
+
+  constexpr uInt32 NO_GROUP = ~0U;
+} // namespace
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+template<size_t... Opcodes>
+constexpr std::array<BatchConsole::Executor, 256>
+BatchConsole::makeExecutors(std::index_sequence<Opcodes...>)
+{
+  return {{ &BatchConsole::execute<static_cast<uInt8>(Opcodes)>... }};
+}
+
+const std::array<BatchConsole::Executor, 256> BatchConsole::ourExecutors =
+  BatchConsole::makeExecutors(std::make_index_sequence<256>());
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+BatchConsole::BatchConsole(const vector<HeadlessConsole*>& consoles)
+  : myConsoles{consoles}
+{
+  const size_t size = myConsoles.size();
+
+  for(HeadlessConsole* console: myConsoles)
+  {
+    if(!supports(console->cartridge()))
+      throw std::invalid_argument("ERROR: cartridge can't be batched");
+
+    mySystems.push_back(&console->system());
+    myCpus.push_back(&console->cpu());
+    myTIAs.push_back(&console->tia());
+  }
+
+  myA.resize(size);  myX.resize(size);  myY.resize(size);  mySP.resize(size);
+  myPC.resize(size);
+  myN.resize(size);  myV.resize(size);  myD.resize(size);  myI.resize(size);
+  myNotZ.resize(size);  myC.resize(size);
+  myOpcodes.resize(size);
+  myFailed.resize(size);
+
+  myGroupOfPC.resize(0x10000, NO_GROUP);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool BatchConsole::supports(const Cartridge& cart)
+{
+  // The Supercharger counts the distinct addresses accessed by the M6502
+  return cart.name() != "CartridgeAR";
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool BatchConsole::runFrame()
+{
+  // Start with one group per address
+  myNumGroups = 0;
+  for(uInt32 lane = 0; lane < numLanes(); ++lane)
+  {
+    myFailed[lane] = false;
+    loadRegisters(lane);
+    addToGroup(lane);
+  }
+  std::swap(myGroups, myNextGroups);
+  std::swap(myNumGroups, myNumNextGroups);
+  clearGroupIndex();
+
+  uInt64 instructions = 0, groups = 0;
+  while(myNumGroups > 0)
+  {
+    for(size_t g = 0; g < myNumGroups; ++g)
+      stepGroup(myGroups[g]);
+
+    ++instructions;
+    groups += myNumGroups;
+    regroup();
+  }
+  myDivergence = instructions > 0
+    ? static_cast<double>(groups) / static_cast<double>(instructions) : 1.0;
+
+  return std::ranges::none_of(myFailed, [](uInt8 failed) { return failed; });
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void BatchConsole::stepGroup(const Group& group)
+{
+  // Fetching the opcode is a memory access of each lane; with bankswitching,
+  // lanes at the same address may still see different instructions
+  bool same = true;
+  const uInt8 first = fetchOpcode(group.lanes.front());
+
+  for(size_t i = 1; i < group.lanes.size(); ++i)
+    same &= fetchOpcode(group.lanes[i]) == first;
+
+  if(same && !myFailed[group.lanes.front()])
+    (this->*ourExecutors[first])(group.lanes);
+  else
+  {
+    for(const uInt32& lane: group.lanes)
+      if(!myFailed[lane])
+        (this->*ourExecutors[myOpcodes[lane]])({&lane, 1});
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt8 BatchConsole::fetchOpcode(uInt32 lane)
+{
+  // Like M6502::peek()
+  try
+  {
+    myCpus[lane]->serviceHalt();
+    mySystems[lane]->incrementCycles(M6502::SYSTEM_CYCLES_PER_CPU);
+    myOpcodes[lane] = mySystems[lane]->peek(myPC[lane]++, Device::CODE);
+  }
+  catch(const FatalEmulationError&)
+  {
+    myFailed[lane] = true;
+  }
+  return myOpcodes[lane];
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+template<uInt8 Opcode>
+void BatchConsole::execute(std::span<const uInt32> lanes)
+{
+  for(const uInt32 lane: lanes)
+  {
+    System& system = *mySystems[lane];
+    M6502& cpu = *myCpus[lane];
+
+    // Like M6502::peek() and M6502::poke(), without the debugger hooks
+    const auto peek = [&system, &cpu](uInt16 address, Device::AccessFlags flags) {
+      cpu.serviceHalt();
+      system.incrementCycles(M6502::SYSTEM_CYCLES_PER_CPU);
+      return system.peek(address, flags);
+    };
+    const auto poke = [&system](uInt16 address, uInt8 value,
+                                Device::AccessFlags flags) {
+      system.incrementCycles(M6502::SYSTEM_CYCLES_PER_CPU);
+      system.poke(address, value, flags);
+    };
+
+    // The registers of the lane, in the names used by M6502.ins
+    uInt8 A = myA[lane], X = myX[lane], Y = myY[lane], SP = mySP[lane];
+    uInt16 PC = myPC[lane];
+    bool N = myN[lane], V = myV[lane], B = true, D = myD[lane], I = myI[lane],
+         notZ = myNotZ[lane], C = myC[lane];
+    const StatusRegister PS{N, V, B, D, I, notZ, C};
+
+    uInt16 operandAddress = 0, intermediateAddress = 0;
+    uInt8 operand = 0;
+
+    try
+    {
+      switch(Opcode)
+      {
+        // Only the case of this opcode remains after compilation
+        #include "M6502.ins"
+
+        default:
+          FatalEmulationError::raise("invalid instruction");
+      }
+    }
+    catch(const FatalEmulationError&)
+    {
+      myFailed[lane] = true;
+    }
+
+    myA[lane] = A;  myX[lane] = X;  myY[lane] = Y;  mySP[lane] = SP;
+    myPC[lane] = PC;
+    myN[lane] = N;  myV[lane] = V;  myD[lane] = D;  myI[lane] = I;
+    myNotZ[lane] = notZ;  myC[lane] = C;
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void BatchConsole::regroup()
+{
+  // Usually, the lanes of a single group are still running in lockstep
+  if(myNumGroups == 1)
+  {
+    Group& group = myGroups.front();
+    const uInt16 pc = myPC[group.lanes.front()];
+
+    if(std::ranges::all_of(group.lanes, [this, pc](uInt32 lane) {
+         return myPC[lane] == pc && !myFailed[lane] &&
+                !myTIAs[lane]->newFramePending();
+       }))
+    {
+      group.pc = pc;
+      return;
+    }
+  }
+
+  for(size_t g = 0; g < myNumGroups; ++g)
+  {
+    for(const uInt32 lane: myGroups[g].lanes)
+    {
+      // Lanes are done when their frame is complete, like M6502::execute()
+      // stops then
+      if(myFailed[lane] || myTIAs[lane]->newFramePending())
+        finishLane(lane);
+      else
+        addToGroup(lane);
+    }
+  }
+  std::swap(myGroups, myNextGroups);
+  std::swap(myNumGroups, myNumNextGroups);
+  clearGroupIndex();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void BatchConsole::addToGroup(uInt32 lane)
+{
+  const uInt16 pc = myPC[lane];
+  uInt32& index = myGroupOfPC[pc];
+
+  if(index == NO_GROUP)
+  {
+    index = static_cast<uInt32>(myNumNextGroups++);
+    if(index == myNextGroups.size())
+      myNextGroups.emplace_back();
+
+    myNextGroups[index].pc = pc;
+    myNextGroups[index].lanes.clear();
+  }
+  myNextGroups[index].lanes.push_back(lane);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void BatchConsole::clearGroupIndex()
+{
+  for(size_t g = 0; g < myNumGroups; ++g)
+    myGroupOfPC[myGroups[g].pc] = NO_GROUP;
+  myNumNextGroups = 0;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void BatchConsole::finishLane(uInt32 lane)
+{
+  storeRegisters(lane);
+
+  // Like M6502::execute() at its end
+  M6502& cpu = *myCpus[lane];
+  if(!myFailed[lane])
+    cpu.serviceHalt();
+  myTIAs[lane]->updateEmulation();
+  mySystems[lane]->m6532().updateEmulation();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void BatchConsole::loadRegisters(uInt32 lane)
+{
+  const M6502::Registers regs = myCpus[lane]->registers();
+
+  myA[lane] = regs.A;  myX[lane] = regs.X;  myY[lane] = regs.Y;
+  mySP[lane] = regs.SP;
+  myPC[lane] = regs.PC;
+  myN[lane] = regs.PS & 0x80;
+  myV[lane] = regs.PS & 0x40;
+  myD[lane] = regs.PS & 0x08;
+  myI[lane] = regs.PS & 0x04;
+  myNotZ[lane] = !(regs.PS & 0x02);
+  myC[lane] = regs.PS & 0x01;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void BatchConsole::storeRegisters(uInt32 lane)
+{
+  bool N = myN[lane], V = myV[lane], B = true, D = myD[lane], I = myI[lane],
+       notZ = myNotZ[lane], C = myC[lane];
+  const StatusRegister PS{N, V, B, D, I, notZ, C};
+
+  myCpus[lane]->setRegisters({myA[lane], myX[lane], myY[lane], mySP[lane],
+                              PS(), myPC[lane]});
+}
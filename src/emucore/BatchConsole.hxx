@@ -0,0 +1,155 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2026 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+
+#ifndef BATCH_CONSOLE_HXX
+#define BATCH_CONSOLE_HXX
+
+class Cartridge;
+class HeadlessConsole;
+class M6502;
+class System;
+class TIA;
+
+#include <span>
+
+#include "bspf.hxx"
+
+/**
+  An experimental engine which runs the processors of a batch of headless
+  consoles, usually running the same ROM, together.  The registers of all
+  consoles ('lanes') are kept in structure-of-arrays layout, and lanes
+  executing the same instruction form a group: each instruction is decoded
+  and dispatched once per group, and then executed for all of its lanes in
+  a tight loop, using the same instruction code as the M6502.  Groups are
+  split whenever their lanes diverge (e.g. take different branches) and
+  merged again when they reach the same address.
+
+  All memory accesses still go through each lane's own system, so the RIOT,
+  the cartridge and the TIA (which only catches up when accessed) behave
+  exactly like in a normally emulated console.  The lanes' processors are
+  updated with the registers after each frame, so that the consoles can be
+  used (saved, reset, inspected) as usual between frames.
+
+  Cartridges depending on the processor's internal state (currently only
+  the Supercharger) can't be run this way.
+
+  @author  Stella Team
+*/
+class BatchConsole
+{
+  public:
+    /**
+      Create a batch of the given consoles, which must outlive it.
+    */
+    explicit BatchConsole(const vector<HeadlessConsole*>& consoles);
+    ~BatchConsole() = default;
+
+    /**
+      Answer whether consoles with the given cartridge can be batched.
+    */
+    static bool supports(const Cartridge& cart);
+
+    uInt32 numLanes() const { return static_cast<uInt32>(myConsoles.size()); }
+
+    /**
+      Emulate one frame on all lanes, like TIA::update() does until a new
+      frame is pending.  The last frame of each lane must have been rendered
+      (see TIA::renderToFrameBuffer()) before.
+
+      @return  True if all lanes succeeded, false if any failed
+    */
+    bool runFrame();
+
+    /**
+      Answer whether the emulation of the lane failed in the last frame
+      (e.g. because of an invalid instruction).
+    */
+    bool failed(uInt32 lane) const { return myFailed[lane]; }
+
+    /**
+      The number of groups the lanes were split into, on average per
+      instruction during the last frame; 1 when all lanes ran in lockstep.
+    */
+    double divergence() const { return myDivergence; }
+
+  private:
+    struct Group {
+      uInt16 pc{0};
+      vector<uInt32> lanes;
+    };
+    using Executor = void (BatchConsole::*)(std::span<const uInt32>);
+
+    // Execute one instruction on all lanes of the group
+    void stepGroup(const Group& group);
+    uInt8 fetchOpcode(uInt32 lane);
+
+    // Execute the instruction with the given opcode (already fetched) on
+    // the given lanes
+    template<uInt8 Opcode>
+    void execute(std::span<const uInt32> lanes);
+
+    template<size_t... Opcodes>
+    static constexpr std::array<Executor, 256>
+    makeExecutors(std::index_sequence<Opcodes...>);
+
+    // Regroup the lanes by their program counter, finishing the lanes which
+    // completed their frame
+    void regroup();
+    void addToGroup(uInt32 lane);
+    void clearGroupIndex();
+    void finishLane(uInt32 lane);
+
+    void loadRegisters(uInt32 lane);
+    void storeRegisters(uInt32 lane);
+
+  private:
+    vector<HeadlessConsole*> myConsoles;
+    vector<System*> mySystems;
+    vector<M6502*> myCpus;
+    vector<TIA*> myTIAs;
+
+    // The registers of all lanes; the flags are kept unpacked, like in M6502
+    vector<uInt8> myA, myX, myY, mySP;
+    vector<uInt16> myPC;
+    vector<uInt8> myN, myV, myD, myI, myNotZ, myC;
+
+    vector<uInt8> myOpcodes;
+    vector<uInt8> myFailed;  // not vector<bool>, set per lane
+
+    // The current groups, and the ones for the next instruction; the group
+    // objects (and their lanes' storage) are reused
+    vector<Group> myGroups, myNextGroups;
+    size_t myNumGroups{0}, myNumNextGroups{0};
+
+    // The index of the next group with the given program counter
+    vector<uInt32> myGroupOfPC;
+
+    double myDivergence{1.0};
+
+    static const std::array<Executor, 256> ourExecutors;
+
+  private:
+    // Following constructors and assignment operators not supported
+    BatchConsole() = delete;
+    BatchConsole(const BatchConsole&) = delete;
+    BatchConsole(BatchConsole&&) = delete;
+    BatchConsole& operator=(const BatchConsole&) = delete;
+    BatchConsole& operator=(BatchConsole&&) = delete;
+};
+
+#endif
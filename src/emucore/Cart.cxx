@@ -18,6 +18,7 @@
 #include "FSNode.hxx"
 #include "Settings.hxx"
 #include "System.hxx"
+#include "RomCache.hxx"
 #ifdef DEBUGGER_SUPPORT
   #include "Debugger.hxx"
   #include "Base.hxx"
@@ -25,9 +26,30 @@
 
 #include "Cart.hxx"
 
+namespace {
+  template<typename T>
+  T* accessPage(vector<std::unique_ptr<T[]>>& pages, uInt32 offset,
+                uInt32 pageShift, T init)
+  {
+    const uInt32 page = offset >> pageShift;
+
+    // Offsets beyond the access area (e.g. of RAM mapped behind the ROM)
+    // get pages as well
+    if(page >= pages.size())
+      pages.resize(page + 1);
+    if(!pages[page])
+    {
+      pages[page] = std::make_unique<T[]>(size_t{1} << pageShift);
+      std::fill_n(pages[page].get(), size_t{1} << pageShift, init);
+    }
+    return pages[page].get() + (offset & ((1U << pageShift) - 1));
+  }
+} // namespace
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 Cartridge::Cartridge(const Settings& settings, string_view md5)
-  : mySettings{settings}
+  : mySettings{settings},
+    myMD5{md5}
 {
   const uInt32 seed =
     BSPF::stoi<16>(md5.substr(0, 8))  ^ BSPF::stoi<16>(md5.substr(8, 8)) ^
@@ -137,14 +159,156 @@ void Cartridge::pokeRAM(uInt8& dest, uInt16 address, uInt8 value)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void Cartridge::createRomAccessArrays(size_t size)
 {
-  myAccessSize = static_cast<uInt32>(size);
-
   // Always create ROM access base even if DEBUGGER_SUPPORT is disabled,
-  // since other parts of the code depend on it existing
-  myRomAccessBase = std::make_unique<Device::AccessFlags[]>(size);
-  std::fill_n(myRomAccessBase.get(), size, Device::ROW);
-  myRomAccessCounter = std::make_unique<Device::AccessCounter[]>(size * 2);
-  std::fill_n(myRomAccessCounter.get(), size * 2, 0);
+  // since other parts of the code depend on it existing; the pages
+  // themselves are only allocated when first used
+  const size_t pages = (size + ACCESS_PAGE_SIZE - 1) >> ACCESS_PAGE_SHIFT;
+
+  myRomAccessPages.clear();
+  myRomAccessPages.resize(pages);
+  myRomPeekCounterPages.clear();
+  myRomPeekCounterPages.resize(pages);
+  myRomPokeCounterPages.clear();
+  myRomPokeCounterPages.resize(pages);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+Device::AccessFlags* Cartridge::romAccessBase(uInt32 offset)
+{
+  return accessPage(myRomAccessPages, offset, ACCESS_PAGE_SHIFT,
+                    Device::AccessFlags{Device::ROW});
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+Device::AccessCounter* Cartridge::romPeekCounter(uInt32 offset)
+{
+  return accessPage(myRomPeekCounterPages, offset, ACCESS_PAGE_SHIFT,
+                    Device::AccessCounter{0});
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+Device::AccessCounter* Cartridge::romPokeCounter(uInt32 offset)
+{
+  return accessPage(myRomPokeCounterPages, offset, ACCESS_PAGE_SHIFT,
+                    Device::AccessCounter{0});
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+Device::AccessFlags Cartridge::romAccessFlags(uInt32 offset) const
+{
+  const uInt32 page = offset >> ACCESS_PAGE_SHIFT;
+
+  return page < myRomAccessPages.size() && myRomAccessPages[page]
+    ? myRomAccessPages[page][offset & (ACCESS_PAGE_SIZE - 1)]
+    : Device::AccessFlags{Device::ROW};
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+Device::AccessCounter Cartridge::romAccessCount(uInt32 offset, bool isWrite) const
+{
+  const auto& pages = isWrite ? myRomPokeCounterPages : myRomPeekCounterPages;
+  const uInt32 page = offset >> ACCESS_PAGE_SHIFT;
+
+  return page < pages.size() && pages[page]
+    ? pages[page][offset & (ACCESS_PAGE_SIZE - 1)]
+    : 0;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+size_t Cartridge::memoryUsage() const
+{
+  size_t bytes = 0;
+
+  for(const auto& page: myRomAccessPages)
+    if(page)
+      bytes += ACCESS_PAGE_SIZE * sizeof(Device::AccessFlags);
+  for(const auto& pages: {&myRomPeekCounterPages, &myRomPokeCounterPages})
+    for(const auto& page: *pages)
+      if(page)
+        bytes += ACCESS_PAGE_SIZE * sizeof(Device::AccessCounter);
+
+  for(const auto& block: myArena)
+    bytes += block.size;
+
+  return bytes;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+ByteBuffer Cartridge::allocateBuffer(size_t size)
+{
+  static constexpr size_t CACHE_LINE = 64;
+  static constexpr size_t BLOCK_SIZE = 64_KB;
+
+  const auto newBlock = [](size_t blockSize) {
+    ArenaBlock block{std::make_unique<uInt8[]>(blockSize + CACHE_LINE - 1)};
+    void* next = block.memory.get();
+    size_t free = blockSize + CACHE_LINE - 1;
+
+    block.size = free;
+    std::align(CACHE_LINE, blockSize, next, free);
+    block.next = static_cast<uInt8*>(next);
+    block.free = free;
+    return block;
+  };
+  // The memory is owned by the arena, so the buffers must not release it
+  const ByteBufferDeleter keep([](uInt8*, size_t) { }, size);
+
+  size = (size + CACHE_LINE - 1) & ~(CACHE_LINE - 1);
+
+  if(size >= BLOCK_SIZE / 2)
+  {
+    // Large buffers get a block of their own; the current block stays the
+    // last one, to take the following small buffers
+    ArenaBlock block = newBlock(size);
+    uInt8* buffer = block.next;
+
+    myArena.insert(myArena.empty() ? myArena.end() : myArena.end() - 1,
+                   std::move(block));
+    return {buffer, keep};
+  }
+
+  if(myArena.empty() || myArena.back().free < size)
+    myArena.push_back(newBlock(BLOCK_SIZE));
+
+  ArenaBlock& block = myArena.back();
+  uInt8* buffer = block.next;
+
+  block.next += size;
+  block.free -= size;
+  return {buffer, keep};
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+ByteBuffer Cartridge::sharedBuffer(string_view name, size_t size,
+                                   const std::function<void(uInt8*)>& fill)
+{
+  auto shared = RomCache::get<uInt8[]>(sharedKey(name, size),
+    [size, &fill]() {
+      shared_ptr<uInt8[]> data = std::make_shared<uInt8[]>(size);
+      fill(data.get());
+      return data;
+    });
+  uInt8* buffer = shared.get();
+
+  // The memory is owned by the cache entry, which is kept alive by us
+  mySharedBuffers.push_back(std::move(shared));
+  return {buffer, ByteBufferDeleter([](uInt8*, size_t) { }, size)};
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool Cartridge::unshareBuffer(ByteBuffer& buffer, size_t size)
+{
+  const auto it = std::ranges::find_if(mySharedBuffers,
+      [&buffer](const auto& shared) { return shared.get() == buffer.get(); });
+  if(it == mySharedBuffers.end())
+    return false;
+
+  ByteBuffer copy = allocateBuffer(size);
+  std::copy_n(buffer.get(), size, copy.get());
+  buffer = std::move(copy);
+  mySharedBuffers.erase(it);
+
+  return true;
 }
 
 #ifdef DEBUGGER_SUPPORT
@@ -164,7 +328,7 @@ string Cartridge::getAccessCounters() const
     for(uInt16 addr = 0; addr < bankSize; ++addr)
     {
       out << Common::Base::HEX4 << (addr | origin) << ","
-        << Common::Base::toString(myRomAccessCounter[offset + addr], Common::Base::Fmt::_10_8) << ", ";
+        << Common::Base::toString(romAccessCount(offset + addr, false), Common::Base::Fmt::_10_8) << ", ";
     }
     out << "\n";
     out << "Bank " << Common::Base::toString(bank, Common::Base::Fmt::_10_8) << " / 0.."
@@ -172,7 +336,7 @@ string Cartridge::getAccessCounters() const
     for(uInt16 addr = 0; addr < bankSize; ++addr)
     {
       out << Common::Base::HEX4 << (addr | origin) << ","
-        << Common::Base::toString(myRomAccessCounter[offset + addr + myAccessSize], Common::Base::Fmt::_10_8) << ", ";
+        << Common::Base::toString(romAccessCount(offset + addr, true), Common::Base::Fmt::_10_8) << ", ";
     }
     out << "\n";
 
@@ -202,7 +366,7 @@ uInt16 Cartridge::bankOrigin(uInt16 bank, uInt16 PC) const
     count[PC >> 13]++;
   for(uInt16 addr = 0x0000; addr < bankSize(bank); ++addr)
   {
-    const Device::AccessFlags flags = myRomAccessBase[offset + addr];
+    const Device::AccessFlags flags = romAccessFlags(offset + addr);
     // only count really accessed addresses
     if(flags & ~Device::ROW)
     {
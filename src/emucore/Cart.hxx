@@ -24,8 +24,11 @@ class CartDebugWidget;
 class CartRamWidget;
 class GuiObject;
 class Settings;
+class ArmProfiler;
 
 #include <functional>
+#include <optional>
+#include <span>
 
 #include "bspf.hxx"
 #include "Device.hxx"
@@ -127,6 +130,13 @@ class Cartridge : public Device
     */
     virtual bool bankChanged();
 
+    /**
+      Answer the number of bytes owned by the cartridge: its memory arena
+      (ROM and RAM) and the ROM access arrays.  Cartridges owning further
+      buffers (e.g. an ARM emulator) add these.
+    */
+    size_t memoryUsage() const override;
+
     /**
       Query the internal RAM size of the cart.
 
@@ -141,6 +151,26 @@ class Cartridge : public Device
     */
     virtual uInt8 internalRamGetValue(uInt16 addr) const { return 0; }
 
+    /**
+      A block of RAM on the cart.  ARM RAM is given with its address in
+      the address space of the ARM, other cart RAM is only accessible
+      through banking and has no fixed address.
+    */
+    struct RamArea {
+      std::span<uInt8> ram;
+      std::optional<uInt32> armAddress;
+    };
+    using RamAreaList = vector<RamArea>;
+
+    /**
+      Get the RAM on the cart, for direct access by external tools (e.g.
+      achievements or memory watchers).  The RAM stays valid as long as
+      the cart exists.
+
+      @return  The RAM areas, empty if the cart has no RAM
+    */
+    virtual RamAreaList ramAreas() { return {}; }
+
     /**
       Answer whether this is a PlusROM cart.  Note that until the
       initialize method has been called, this will always return false.
@@ -359,6 +389,19 @@ class Cartridge : public Device
     {
       return nullptr;
     }
+
+    /**
+      Enable or disable the sampling profiler of the ARM code.  Disabling
+      discards all collected samples.
+
+      @return  False if the cart has no ARM code
+    */
+    virtual bool enableArmProfiler(bool enable) { return false; }
+
+    /**
+      Answer the ARM profiler, nullptr if not enabled.
+    */
+    virtual ArmProfiler* armProfiler() { return nullptr; }
   #endif
 
   protected:
@@ -391,10 +434,76 @@ class Cartridge : public Device
       of the ROM (indicated by 'size').  Note that this is only used by
       the debugger, and is unavailable otherwise.
 
+      The storage is allocated lazily, in pages of ACCESS_PAGE_SIZE bytes,
+      when an address of the page is first mapped in, so banks which are
+      never used take no memory.
+
       @param size  The size of the code-access array to create
     */
     void createRomAccessArrays(size_t size);
 
+    /**
+      Answer a pointer to the access flags resp. the peek and poke counters
+      of the given offset into the ROM access area, allocating its page if
+      necessary.  The pointers remain valid for at least the rest of the
+      System page (offsets are aligned to System::PAGE_SIZE).
+    */
+    Device::AccessFlags* romAccessBase(uInt32 offset);
+    Device::AccessCounter* romPeekCounter(uInt32 offset);
+    Device::AccessCounter* romPokeCounter(uInt32 offset);
+
+    /**
+      Answer the access flags resp. counters of the given offset, without
+      allocating anything (pages never mapped in answer the defaults).
+    */
+    Device::AccessFlags romAccessFlags(uInt32 offset) const;
+    Device::AccessCounter romAccessCount(uInt32 offset, bool isWrite) const;
+
+    /**
+      Get a zero-filled buffer from the memory arena of this cartridge.
+      The buffers are aligned to cache lines and packed into large blocks,
+      so ROM and RAM of a cartridge share few cache lines and TLB entries.
+      The memory is owned by the arena and freed with the cartridge, so a
+      buffer must not outlive it.
+
+      @param size  The size of the buffer
+      @return  The buffer
+    */
+    ByteBuffer allocateBuffer(size_t size);
+
+    /**
+      Get a read-only buffer which is shared with all other cartridges in
+      this process built from the same ROM (see RomCache).  The contents are
+      only initialized (by 'fill') if no other cartridge holds the buffer.
+      Like the arena buffers, it must not outlive the cartridge.
+
+      @param name  Identifies the buffer among those of the ROM
+      @param size  The size of the buffer
+      @param fill  Initializes the contents of a new buffer
+      @return  The buffer
+    */
+    ByteBuffer sharedBuffer(string_view name, size_t size,
+                            const std::function<void(uInt8*)>& fill);
+
+    /**
+      Replace a buffer from sharedBuffer() by a private copy from the arena,
+      which may be modified (copy-on-write, e.g. for patching the ROM).
+
+      @param buffer  The buffer to replace
+      @param size    The size of the buffer
+      @return  True if the buffer was shared and has been replaced, so
+               that any pointers into it must be updated
+    */
+    bool unshareBuffer(ByteBuffer& buffer, size_t size);
+
+    /**
+      The RomCache key for data of the given name and size, which is derived
+      from the ROM of this cartridge.
+    */
+    string sharedKey(string_view name, size_t size) const {
+      return myMD5 + ':' + string{name} + ':' + std::to_string(size);
+    }
+
     /**
       Fill the given RAM array with (possibly random) data.
 
@@ -440,20 +549,20 @@ class Cartridge : public Device
     // Indicates if the bank has changed somehow (a bankswitch has occurred)
     bool myBankChanged{true};
 
-    // The array containing information about every byte of ROM indicating
+    // The pages containing information about every byte of ROM indicating
     // whether it is used as code, data, graphics etc.
-    std::unique_ptr<Device::AccessFlags[]> myRomAccessBase;
+    static constexpr uInt32 ACCESS_PAGE_SHIFT = 12;  // 4K
+    static constexpr uInt32 ACCESS_PAGE_SIZE = 1 << ACCESS_PAGE_SHIFT;
+    vector<std::unique_ptr<Device::AccessFlags[]>> myRomAccessPages;
 
-    // The array containing information about every byte of ROM indicating
-    // how often it is accessed.
-    std::unique_ptr<Device::AccessCounter[]> myRomAccessCounter;
+    // The pages containing information about every byte of ROM indicating
+    // how often it is read resp. written.
+    vector<std::unique_ptr<Device::AccessCounter[]>> myRomPeekCounterPages;
+    vector<std::unique_ptr<Device::AccessCounter[]>> myRomPokeCounterPages;
 
     // Contains address of illegal RAM write access or 0
     uInt16 myRamWriteAccess{0};
 
-    // Total size of ROM access area (might include RAM too)
-    uInt32 myAccessSize{0};
-
     // Callback to output messages
     messageCallback myMsgCallback{nullptr};
 
@@ -488,6 +597,22 @@ class Cartridge : public Device
     // access.
     ShortArray myRamReadAccesses;
 
+    // The memory blocks of the arena used by allocateBuffer(); the last
+    // block is the one that small buffers are taken from
+    struct ArenaBlock
+    {
+      std::unique_ptr<uInt8[]> memory;
+      uInt8* next{nullptr};
+      size_t free{0};
+      size_t size{0};
+    };
+    vector<ArenaBlock> myArena;
+
+    // The buffers from sharedBuffer() held by this cartridge, and the MD5
+    // of the ROM they belong to
+    vector<shared_ptr<uInt8[]>> mySharedBuffers;
+    string myMD5;
+
     // Following constructors and assignment operators not supported
     Cartridge() = delete;
     Cartridge(const Cartridge&) = delete;
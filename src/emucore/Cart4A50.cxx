@@ -24,7 +24,7 @@
 Cartridge4A50::Cartridge4A50(const ByteBuffer& image, size_t size,
                              string_view md5, const Settings& settings)
   : Cartridge(settings, md5),
-    myImage{std::make_unique<uInt8[]>(128_KB)},
+    myImage{allocateBuffer(128_KB)},
     mySize{size}
 {
   // Copy the ROM image into my buffer
@@ -189,28 +189,28 @@ Device::AccessFlags Cartridge4A50::getAccessFlags(uInt16 address) const
   if((address & 0x1800) == 0x1000)           // 2K region from 0x1000 - 0x17ff
   {
     if(myIsRomLow)
-      return myRomAccessBase[(address & 0x7ff) + mySliceLow];
+      return romAccessFlags((address & 0x7ff) + mySliceLow);
     else
-      return myRomAccessBase[131072 + (address & 0x7ff) + mySliceLow];
+      return romAccessFlags(131072 + (address & 0x7ff) + mySliceLow);
   }
   else if(((address & 0x1fff) >= 0x1800) &&  // 1.5K region from 0x1800 - 0x1dff
           ((address & 0x1fff) <= 0x1dff))
   {
     if(myIsRomMiddle)
-      return myRomAccessBase[(address & 0x7ff) + mySliceMiddle + 0x10000];
+      return romAccessFlags((address & 0x7ff) + mySliceMiddle + 0x10000);
     else
-      return myRomAccessBase[131072 + (address & 0x7ff) + mySliceMiddle];
+      return romAccessFlags(131072 + (address & 0x7ff) + mySliceMiddle);
   }
   else if((address & 0x1f00) == 0x1e00)      // 256B region from 0x1e00 - 0x1eff
   {
     if(myIsRomHigh)
-      return myRomAccessBase[(address & 0xff) + mySliceHigh + 0x10000];
+      return romAccessFlags((address & 0xff) + mySliceHigh + 0x10000);
     else
-      return myRomAccessBase[131072 + (address & 0xff) + mySliceHigh];
+      return romAccessFlags(131072 + (address & 0xff) + mySliceHigh);
   }
   else if((address & 0x1f00) == 0x1f00)      // 256B region from 0x1f00 - 0x1fff
   {
-    return myRomAccessBase[(address & 0xff) + 0x1ff00];
+    return romAccessFlags((address & 0xff) + 0x1ff00);
   }
   return 0;
 }
@@ -221,28 +221,28 @@ void Cartridge4A50::setAccessFlags(uInt16 address, Device::AccessFlags flags)
   if((address & 0x1800) == 0x1000)           // 2K region from 0x1000 - 0x17ff
   {
     if(myIsRomLow)
-      myRomAccessBase[(address & 0x7ff) + mySliceLow] |= flags;
+      *romAccessBase((address & 0x7ff) + mySliceLow) |= flags;
     else
-      myRomAccessBase[131072 + (address & 0x7ff) + mySliceLow] |= flags;
+      *romAccessBase(131072 + (address & 0x7ff) + mySliceLow) |= flags;
   }
   else if(((address & 0x1fff) >= 0x1800) &&  // 1.5K region from 0x1800 - 0x1dff
           ((address & 0x1fff) <= 0x1dff))
   {
     if(myIsRomMiddle)
-      myRomAccessBase[(address & 0x7ff) + mySliceMiddle + 0x10000] |= flags;
+      *romAccessBase((address & 0x7ff) + mySliceMiddle + 0x10000) |= flags;
     else
-      myRomAccessBase[131072 + (address & 0x7ff) + mySliceMiddle] |= flags;
+      *romAccessBase(131072 + (address & 0x7ff) + mySliceMiddle) |= flags;
   }
   else if((address & 0x1f00) == 0x1e00)      // 256B region from 0x1e00 - 0x1eff
   {
     if(myIsRomHigh)
-      myRomAccessBase[(address & 0xff) + mySliceHigh + 0x10000] |= flags;
+      *romAccessBase((address & 0xff) + mySliceHigh + 0x10000) |= flags;
     else
-      myRomAccessBase[131072 + (address & 0xff) + mySliceHigh] |= flags;
+      *romAccessBase(131072 + (address & 0xff) + mySliceHigh) |= flags;
   }
   else if((address & 0x1f00) == 0x1f00)      // 256B region from 0x1f00 - 0x1fff
   {
-    myRomAccessBase[(address & 0xff) + 0x1ff00] |= flags;
+    *romAccessBase((address & 0xff) + 0x1ff00) |= flags;
   }
 }
 #endif
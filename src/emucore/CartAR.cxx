@@ -45,6 +45,8 @@ CartridgeAR::CartridgeAR(const ByteBuffer& image, size_t size,
     std::copy_n(ourDefaultHeader.data(), ourDefaultHeader.size(),
                 myLoadImages.get() + myImage.size());
 
+  buildLoadIndex();
+
   // We use System::PageAccess.romAccessBase, but don't allow its use
   // through a pointer, since the AR scheme doesn't support bankswitching
   // in the normal sense
@@ -204,15 +206,15 @@ bool CartridgeAR::poke(uInt16 addr, uInt8)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 Device::AccessFlags CartridgeAR::getAccessFlags(uInt16 address) const
 {
-  return myRomAccessBase[(address & 0x07FF) +
-           myImageOffset[(address & 0x0800) ? 1 : 0]];
+  return romAccessFlags((address & 0x07FF) +
+           myImageOffset[(address & 0x0800) ? 1 : 0]);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void CartridgeAR::setAccessFlags(uInt16 address, Device::AccessFlags flags)
 {
-  myRomAccessBase[(address & 0x07FF) +
-    myImageOffset[(address & 0x0800) ? 1 : 0]] |= flags;
+  *romAccessBase((address & 0x07FF) +
+    myImageOffset[(address & 0x0800) ? 1 : 0]) |= flags;
 }
 #endif
 
@@ -288,69 +290,75 @@ void CartridgeAR::initializeROM()
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void CartridgeAR::loadIntoRAM(uInt8 load)
 {
+  // Find the image of the load we're looking for
+  const uInt16 image = myLoadIndex[load];
+  if(image == NO_LOAD)
+  {
+    // TODO: Should probably switch to an internal ROM routine to display
+    // this message to the user...
+    cerr << "ERROR: Supercharger load is missing from ROM image...\n";
+    return;
+  }
+
   bool success = true;
+  const size_t image_off = image * LOAD_SIZE;
+
+  // Copy the load's header
+  std::copy_n(myLoadImages.get() + image_off + myImage.size(),
+              myHeader.size(), myHeader.data());
+
+  // Verify the load's header
+  if(checksum(myHeader.data(), 8) != 0x55)
+  {
+    cerr << "WARNING: The Supercharger header checksum is invalid...\n";
+    myMsgCallback("Supercharger load #" + std::to_string(load) +
+                  " done with hearder checksum error");
+    success = false;
+  }
 
-  // Scan through all of the loads to see if we find the one we're looking for
-  for(uInt16 image = 0; image < myNumberOfLoadImages; ++image)
+  // Load all of the pages from the load
+  bool invalidPageChecksumSeen = false;
+  for(size_t j = 0; j < myHeader[3]; ++j)
   {
-    const size_t image_off = image * LOAD_SIZE;
+    const size_t bank = myHeader[16 + j] & 0b00011;
+    const size_t page = (myHeader[16 + j] & 0b11100) >> 2;
+    const uInt8* const src = myLoadImages.get() + image_off + j * 256;
+    const uInt8 sum = checksum(src, 256) + myHeader[16 + j] + myHeader[64 + j];
 
-    // Is this the correct load?
-    if(myLoadImages[image_off + myImage.size() + 5] == load)
+    if(!invalidPageChecksumSeen && (sum != 0x55))
     {
-      // Copy the load's header
-      std::copy_n(myLoadImages.get() + image_off + myImage.size(),
-                  myHeader.size(), myHeader.data());
-
-      // Verify the load's header
-      if(checksum(myHeader.data(), 8) != 0x55)
-      {
-        cerr << "WARNING: The Supercharger header checksum is invalid...\n";
-        myMsgCallback("Supercharger load #" + std::to_string(load) +
-                      " done with hearder checksum error");
-        success = false;
-      }
-
-      // Load all of the pages from the load
-      bool invalidPageChecksumSeen = false;
-      for(size_t j = 0; j < myHeader[3]; ++j)
-      {
-        const size_t bank = myHeader[16 + j] & 0b00011;
-        const size_t page = (myHeader[16 + j] & 0b11100) >> 2;
-        const uInt8* const src = myLoadImages.get() + image_off + j * 256;
-        const uInt8 sum = checksum(src, 256) + myHeader[16 + j] + myHeader[64 + j];
-
-        if(!invalidPageChecksumSeen && (sum != 0x55))
-        {
-          cerr << "WARNING: Some Supercharger page checksums are invalid...\n";
-          myMsgCallback("Supercharger load #" + std::to_string(load) +
-                        " done with page #" + std::to_string(j) +
-                        " checksum error");
-          invalidPageChecksumSeen = true;
-        }
-
-        // Copy page to Supercharger RAM (don't allow a copy into ROM area)
-        if(bank < 3)
-          std::copy_n(src, 256, myImage.data() + (bank * BANK_SIZE) + (page * 256));
-      }
-      success &= !invalidPageChecksumSeen;
-
-      // Copy the bank switching byte and starting address into the 2600's
-      // RAM for the "dummy" SC BIOS to access it
-      mySystem->pokeOob(0xfe, myHeader[0]);
-      mySystem->pokeOob(0xff, myHeader[1]);
-      mySystem->pokeOob(0x80, myHeader[2]);
-
-      myBankChanged = true;
-      if(success)
-        myMsgCallback("Supercharger load #" + std::to_string(load) + " done");
-      return;
+      cerr << "WARNING: Some Supercharger page checksums are invalid...\n";
+      myMsgCallback("Supercharger load #" + std::to_string(load) +
+                    " done with page #" + std::to_string(j) +
+                    " checksum error");
+      invalidPageChecksumSeen = true;
     }
+
+    // Copy page to Supercharger RAM (don't allow a copy into ROM area)
+    if(bank < 3)
+      std::copy_n(src, 256, myImage.data() + (bank * BANK_SIZE) + (page * 256));
   }
+  success &= !invalidPageChecksumSeen;
 
-  // TODO: Should probably switch to an internal ROM routine to display
-  // this message to the user...
-  cerr << "ERROR: Supercharger load is missing from ROM image...\n";
+  // Copy the bank switching byte and starting address into the 2600's
+  // RAM for the "dummy" SC BIOS to access it
+  mySystem->pokeOob(0xfe, myHeader[0]);
+  mySystem->pokeOob(0xff, myHeader[1]);
+  mySystem->pokeOob(0x80, myHeader[2]);
+
+  myBankChanged = true;
+  if(success)
+    myMsgCallback("Supercharger load #" + std::to_string(load) + " done");
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void CartridgeAR::buildLoadIndex()
+{
+  // The load number is stored at offset 5 of each load's header; if
+  // several images carry the same number, the first one is used
+  myLoadIndex.fill(NO_LOAD);
+  for(uInt16 image = myNumberOfLoadImages; image-- > 0; )
+    myLoadIndex[myLoadImages[image * LOAD_SIZE + myImage.size() + 5]] = image;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -453,6 +461,7 @@ bool CartridgeAR::load(Serializer& in)
 
     // Indicates how many 8448 loads there are
     myNumberOfLoadImages = in.getByte();
+    buildLoadIndex();
 
     // Indicates if the RAM is write enabled
     myWriteEnabled = in.getBool();
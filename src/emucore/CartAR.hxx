@@ -195,6 +195,9 @@ class CartridgeAR : public Cartridge
     // Load the specified load into SC RAM
     void loadIntoRAM(uInt8 load);
 
+    // Map each load number to the first load image carrying it
+    void buildLoadIndex();
+
     // Sets up a "dummy" BIOS ROM in the ROM bank of the cartridge
     void initializeROM();
 
@@ -217,6 +220,10 @@ class CartridgeAR : public Cartridge
     // Indicates how many 8448 loads there are
     uInt8 myNumberOfLoadImages{0};
 
+    // The load image for each load number (NO_LOAD if missing from the ROM)
+    static constexpr uInt16 NO_LOAD = 0xFFFF;
+    std::array<uInt16, 256> myLoadIndex{};
+
     // Indicates if the RAM is write enabled
     bool myWriteEnabled{false};
 
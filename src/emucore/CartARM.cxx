@@ -17,6 +17,9 @@
 
 #include "System.hxx"
 #include "Settings.hxx"
+#ifdef DEBUGGER_SUPPORT
+  #include "TIA.hxx"
+#endif
 #include "CartARM.hxx"
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -40,15 +43,17 @@ void CartridgeARM::setInitialState()
   if(devSettings)
   {
     myIncCycles = mySettings.getBool("dev.thumb.inccycles");
+    myApproxCycles = mySettings.getBool("dev.thumb.approxcycles");
     myThumbEmulator->setChipType(static_cast<Thumbulator::ChipType>(mySettings.getInt("dev.thumb.chiptype")));
     myThumbEmulator->setMamMode(static_cast<Thumbulator::MamModeType>(mySettings.getInt("dev.thumb.mammode")));
   }
   else
   {
-    myIncCycles = false;
+    myIncCycles = myApproxCycles = false;
     myThumbEmulator->setChipType();
   }
   enableCycleCount(devSettings);
+  myThumbEmulator->approximateCycles(myApproxCycles && !myIncCycles);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -79,13 +84,40 @@ void CartridgeARM::updateCycles(int cycles)
   myStats = myThumbEmulator->stats();
   myPrevCycles = myCycles;
   myCycles = myThumbEmulator->cycles();
+
+  // Without cycle counting, instructions are the best estimate
+  if(myArmProfiler)
+    myArmProfiler->endRun(myCycles ? myCycles : myStats.instructions);
+  if(mySystem->tia().lineBudgetEnabled())
+    mySystem->tia().recordArmTime(myCycles ? myCycles : myStats.instructions);
 #endif
 }
 
+#ifdef DEBUGGER_SUPPORT
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool CartridgeARM::enableArmProfiler(bool enable)
+{
+  if(enable && !myArmProfiler)
+  {
+    // The driver is emulated natively, so all ARM code is either the
+    // custom code in flash or code copied to RAM
+    myArmProfiler = std::make_unique<ArmProfiler>();
+    myArmProfiler->addRange("flash", 0x00000000, 0x0007FFFF);
+    myArmProfiler->addRange("ram", 0x40000000, 0x40007FFF);
+  }
+  else if(!enable)
+    myArmProfiler.reset();
+
+  myThumbEmulator->setProfiler(myArmProfiler.get());
+  return true;
+}
+#endif
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void CartridgeARM::incCycles(bool enable)
 {
   myIncCycles = enable;
+  myThumbEmulator->approximateCycles(myApproxCycles && !myIncCycles);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -139,3 +171,9 @@ bool CartridgeARM::load(Serializer& in)
 #endif
   return true;
 }
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+size_t CartridgeARM::memoryUsage() const
+{
+  return Cartridge::memoryUsage() + (myThumbEmulator ? sizeof(Thumbulator) : 0);
+}
@@ -21,6 +21,9 @@
 #include "Thumbulator.hxx"
 #include "PlusROM.hxx"
 #include "Cart.hxx"
+#ifdef DEBUGGER_SUPPORT
+  #include "ArmProfiler.hxx"
+#endif
 
 /**
   Abstract base class for ARM carts.
@@ -65,6 +68,12 @@ class CartridgeARM : public Cartridge
     */
     bool load(Serializer& in) override;
 
+    /**
+      Answer the number of bytes owned by this cart, including the
+      Thumbulator.
+    */
+    size_t memoryUsage() const override;
+
     /**
       Set the callback for displaying messages
     */
@@ -75,6 +84,11 @@ class CartridgeARM : public Cartridge
         myPlusROM->setMessageCallback(myMsgCallback);
     }
 
+  #ifdef DEBUGGER_SUPPORT
+    bool enableArmProfiler(bool enable) override;
+    ArmProfiler* armProfiler() override { return myArmProfiler.get(); }
+  #endif
+
   protected:
     /**
       Sets the initial state of the MAM mode
@@ -101,6 +115,29 @@ class CartridgeARM : public Cartridge
     void setMamMode(Thumbulator::MamModeType mamMode) { myThumbEmulator->setMamMode(mamMode); }
     Thumbulator::MamModeType mamMode() const { return myThumbEmulator->mamMode(); }
 
+    /**
+      Calculate the number of music mode OSC clocks (20 kHz) since the last
+      call.
+
+      @param cycles            The current system cycles
+      @param audioCycles       The system cycles at the last call (updated)
+      @param fractionalClocks  The clock fraction left over from the last
+                               call (updated)
+      @return  The number of whole OSC clocks elapsed
+    */
+    uInt32 musicModeClocks(uInt64 cycles, uInt64& audioCycles,
+                           double& fractionalClocks) const {
+      // The music output depends on how the fraction is rounded, so this
+      // must remain a double calculation (see also CartridgeCTY)
+      const auto elapsed = static_cast<uInt32>(cycles - audioCycles);
+      audioCycles = cycles;
+
+      const double clocks = ((20000.0 * elapsed) / myClockRate) + fractionalClocks;
+      const auto wholeClocks = static_cast<uInt32>(clocks);
+      fractionalClocks = clocks - static_cast<double>(wholeClocks);
+      return wholeClocks;
+    }
+
   protected:
     // Pointer to the Thumb ARM emulator object
     unique_ptr<Thumbulator> myThumbEmulator;
@@ -111,6 +148,9 @@ class CartridgeARM : public Cartridge
     // ARM code increases 6507 cycles
     bool myIncCycles{false};
 
+    // ARM cycles may be estimated (never while they increase 6507 cycles)
+    bool myApproxCycles{false};
+
     // Console clock rate
     double myClockRate{1193191.66666667};
   #ifdef DEBUGGER_SUPPORT
@@ -118,6 +158,8 @@ class CartridgeARM : public Cartridge
     Thumbulator::Stats myPrevStats{0};
     uInt32 myCycles{0};
     uInt32 myPrevCycles{0};
+
+    unique_ptr<ArmProfiler> myArmProfiler;
   #endif
 
   private:
@@ -49,10 +49,11 @@ namespace {
 CartridgeBUS::CartridgeBUS(const ByteBuffer& image, size_t size,
                            string_view md5, const Settings& settings)
   : CartridgeARM(settings, md5),
-    myImage{std::make_unique<uInt8[]>(32_KB)}
+    myImage{sharedBuffer("BUS image", 32_KB, [&image, size](uInt8* data) {
+      std::copy_n(image.get(), std::min(32_KB, size), data);
+    })}
 {
-  // Copy the ROM image into my buffer
-  std::copy_n(image.get(), std::min(32_KB, size), myImage.get());
+  // The image is shared by all consoles running this ROM (see patch())
 
   // Detect cart version
   setupVersion();
@@ -113,6 +114,8 @@ CartridgeBUS::CartridgeBUS(const ByteBuffer& image, size_t size,
       this);
   }
 
+  myThumbEmulator->shareDecodedRom(sharedKey("BUS code", 32_KB));
+
   this->setInitialState();  // NOLINT
 
   myPlusROM = std::make_unique<PlusROM>(mySettings, *this);
@@ -165,6 +168,8 @@ void CartridgeBUS::setInitialState()
 
   myFastJumpActive = 0;
 
+  loadDatastreams();
+
   CartridgeARM::setInitialState();
 }
 
@@ -190,14 +195,11 @@ void CartridgeBUS::install(System& system)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 inline void CartridgeBUS::updateMusicModeDataFetchers()
 {
-  // Calculate the number of cycles since the last update
-  const auto cycles = static_cast<uInt32>(mySystem->cycles() - myAudioCycles);
-  myAudioCycles = mySystem->cycles();
-
-  // Calculate the number of BUS OSC clocks since the last update
-  const double clocks = ((20000.0 * cycles) / myClockRate) + myFractionalClocks;
-  const auto wholeClocks = static_cast<uInt32>(clocks);
-  myFractionalClocks = clocks - static_cast<double>(wholeClocks);
+  // Calculate the number of BUS OSC clocks since the last update; the
+  // counters only depend on the elapsed time, so they are advanced here,
+  // when the amplitude is read, and never in between
+  const uInt32 wholeClocks =
+    musicModeClocks(mySystem->cycles(), myAudioCycles, myFractionalClocks);
 
   // Let's update counters and flags of the music mode data fetchers
   if(wholeClocks > 0)
@@ -214,14 +216,18 @@ inline void CartridgeBUS::callFunction(uInt8 value)
     case 254: // call with IRQ driven audio, no special handling needed at this
               // time for Stella as ARM code "runs in zero 6507 cycles".
     case 255: // call without IRQ driven audio
+      // The ARM code works on the datastreams in RAM
+      flushDatastreams();
       try {
         auto cycles = static_cast<uInt32>(mySystem->cycles() - myARMCycles);
 
         myARMCycles = mySystem->cycles();
         myThumbEmulator->run(cycles, value == 254);
         updateCycles(cycles);
+        loadDatastreams();
       }
       catch(const std::runtime_error& e) {
+        loadDatastreams();
         if(!mySystem->autodetectMode())
         {
           FatalEmulationError::raise(e.what());
@@ -379,7 +385,10 @@ uInt8 CartridgeBUS::peek(uInt16 address)
             if (sampleaddress < 0x8000)
               peekvalue = myImage[sampleaddress];
             else if (sampleaddress >= 0x40000000 && sampleaddress < 0x40002000) // check for RAM
+            {
+              flushDatastreams();
               peekvalue = myRAM[sampleaddress - 0x40000000];
+            }
             else
               peekvalue = 0;
 
@@ -799,9 +808,9 @@ bool CartridgeBUS::bank(uInt16 bank, uInt16)
   // Map Program ROM image into the system
   for(uInt16 addr = 0x1040; addr < 0x2000; addr += System::PAGE_SIZE)
   {
-    access.romAccessBase = &myRomAccessBase[myBankOffset + (addr & 0x0FFF)];
-    access.romPeekCounter = &myRomAccessCounter[myBankOffset + (addr & 0x0FFF)];
-    access.romPokeCounter = &myRomAccessCounter[myBankOffset + (addr & 0x0FFF) + 28_KB];
+    access.romAccessBase = romAccessBase(myBankOffset + (addr & 0x0FFF));
+    access.romPeekCounter = romPeekCounter(myBankOffset + (addr & 0x0FFF));
+    access.romPokeCounter = romPokeCounter(myBankOffset + (addr & 0x0FFF));
     mySystem->setPageAccess(addr, access);
   }
   return myBankChanged = true;
@@ -827,6 +836,12 @@ bool CartridgeBUS::patch(uInt16 address, uInt8 value)
   // For now, we ignore attempts to patch the BUS address space
   if(address >= 0x0040)
   {
+    // Switch to a private copy of the ROM first
+    const auto offset = myProgramImage - myImage.get();
+    unshareBuffer(myImage, 32_KB);
+    myProgramImage = myImage.get() + offset;
+    myThumbEmulator->romChanged(reinterpret_cast<uInt16*>(myImage.get()));
+
     myProgramImage[myBankOffset + (address & 0x0FFF)] = value;
     return myBankChanged = true;
   }
@@ -904,7 +919,10 @@ uInt32 CartridgeBUS::thumbCallback(uInt8 function, uInt32 value1, uInt32 value2)
 uInt8 CartridgeBUS::internalRamGetValue(uInt16 addr) const
 {
   if(addr < internalRamSize())
+  {
+    flushDatastreams();
     return myRAM[addr];
+  }
   else
     return 0;
 }
@@ -918,7 +936,8 @@ bool CartridgeBUS::save(Serializer& out) const
     out.putShort(myBankOffset);
 
     // Harmony RAM
-    out.putByteArray(myRAM);
+    flushDatastreams();
+    out.putPages(myRAM, myRAMSnapshot);
 
     // Addresses for bus override logic
     out.putShort(myBusOverdriveAddress);
@@ -961,7 +980,8 @@ bool CartridgeBUS::load(Serializer& in)
     myBankOffset = in.getShort();
 
     // Harmony RAM
-    in.getByteArray(myRAM);
+    in.getPages(myRAM, myRAMSnapshot);
+    loadDatastreams();
 
     // Addresses for bus override logic
     myBusOverdriveAddress = in.getShort();
@@ -1001,39 +1021,42 @@ bool CartridgeBUS::load(Serializer& in)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 uInt32 CartridgeBUS::getDatastreamPointer(uInt8 index) const
 {
-  const uInt16 address = myDatastreamBase + index * 4;
+  if(index < myDatastreamCount)
+    return myDatastreamPointers[index];
 
-  return myRAM[address + 0]        +  // low byte
-        (myRAM[address + 1] << 8)  +
-        (myRAM[address + 2] << 16) +
-        (myRAM[address + 3] << 24) ;  // high byte
+  // Not a datastream of this BUS version, look at the raw RAM
+  flushDatastreams();
+  return getUInt32(myRAM.data(), myDatastreamBase + index * 4);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void CartridgeBUS::setDatastreamPointer(uInt8 index, uInt32 value)
 {
-  const uInt16 address = myDatastreamBase + index * 4;
-
-  myRAM[address + 0] = value & 0xff;          // low byte
-  myRAM[address + 1] = (value >> 8) & 0xff;
-  myRAM[address + 2] = (value >> 16) & 0xff;
-  myRAM[address + 3] = (value >> 24) & 0xff;  // high byte
+  myDatastreamPointers[index] = value;
+  myDatastreamsDirty = true;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 uInt32 CartridgeBUS::getDatastreamIncrement(uInt8 index) const
 {
-  const uInt16 address = myDatastreamIncrementBase + index * 4;
+  if(index < INCREMENT_COUNT)
+    return myDatastreamIncrements[index];
 
-  return myRAM[address + 0]        +   // low byte
-        (myRAM[address + 1] << 8)  +
-        (myRAM[address + 2] << 16) +
-        (myRAM[address + 3] << 24) ;   // high byte
+  // The command stream has no increment of its own, it uses whatever
+  // follows the increments in RAM
+  return getUInt32(myRAM.data(), myDatastreamIncrementBase + index * 4);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void CartridgeBUS::setDatastreamIncrement(uInt8 index, uInt32 value)
 {
+  if(index < INCREMENT_COUNT)
+  {
+    myDatastreamIncrements[index] = value;
+    myDatastreamsDirty = true;
+    return;
+  }
+
   const uInt16 address = myDatastreamIncrementBase + index * 4;
 
   myRAM[address + 0] = value & 0xff;          // low byte
@@ -1042,6 +1065,42 @@ void CartridgeBUS::setDatastreamIncrement(uInt8 index, uInt32 value)
   myRAM[address + 3] = (value >> 24) & 0xff;  // high byte
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void CartridgeBUS::loadDatastreams()
+{
+  for(uInt8 i = 0; i < myDatastreamCount; ++i)
+    myDatastreamPointers[i] = getUInt32(myRAM.data(), myDatastreamBase + i * 4);
+  for(uInt8 i = 0; i < INCREMENT_COUNT; ++i)
+    myDatastreamIncrements[i] =
+      getUInt32(myRAM.data(), myDatastreamIncrementBase + i * 4);
+
+  myDatastreamsDirty = false;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void CartridgeBUS::flushDatastreams() const
+{
+  if(!myDatastreamsDirty)
+    return;
+
+  // The RAM copy is logically part of the cached state, so it is updated
+  // even for const access
+  const auto put = [ram = const_cast<uInt8*>(myRAM.data())]  // NOLINT
+    (uInt16 address, uInt32 value)
+  {
+    ram[address + 0] = value & 0xff;          // low byte
+    ram[address + 1] = (value >> 8) & 0xff;
+    ram[address + 2] = (value >> 16) & 0xff;
+    ram[address + 3] = (value >> 24) & 0xff;  // high byte
+  };
+  for(uInt8 i = 0; i < myDatastreamCount; ++i)
+    put(myDatastreamBase + i * 4, myDatastreamPointers[i]);
+  for(uInt8 i = 0; i < INCREMENT_COUNT; ++i)
+    put(myDatastreamIncrementBase + i * 4, myDatastreamIncrements[i]);
+
+  myDatastreamsDirty = false;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 uInt32 CartridgeBUS::getAddressMap(uInt8 index) const
 {
@@ -1180,6 +1239,7 @@ void CartridgeBUS::setupVersion()
 
     case 0x770: //  rpg_20170616_NTSC.bin newest
       myBUSSubtype = BUSSubtype::BUS3;
+      myDatastreamCount = DATASTREAM_COUNT;
       myDatastreamBase = 0x06D8;
       myDatastreamIncrementBase = 0x0720;
       myDatastreamMapBase = 0x0760;
@@ -160,6 +160,14 @@ class CartridgeBUS : public CartridgeARM
   */
   uInt8 internalRamGetValue(uInt16 addr) const override;
 
+  /**
+    Get the ARM RAM, for direct access by external tools.
+  */
+  RamAreaList ramAreas() override {
+    flushDatastreams();
+    return {{myRAM, 0x40000000}};
+  }
+
   #ifdef DEBUGGER_SUPPORT
     /**
       Get debugger widget responsible for accessing the inner workings
@@ -222,6 +230,16 @@ class CartridgeBUS : public CartridgeARM
     uInt32 getDatastreamIncrement(uInt8 index) const;
     void setDatastreamIncrement(uInt8 index, uInt32 value);
 
+    /**
+      The datastream pointers and increments are stored byte-wise in the
+      driver RAM, where the ARM code expects them.  The 6507 side works on
+      a decoded copy instead, which is (re)loaded whenever the RAM may have
+      been changed behind its back (ARM code, state load, debugger), and
+      written back before anything else looks at the RAM.
+    */
+    void loadDatastreams();
+    void flushDatastreams() const;
+
     uInt32 getAddressMap(uInt8 index) const;
     void setAddressMap(uInt8 index, uInt32 value);
 
@@ -251,6 +269,8 @@ class CartridgeBUS : public CartridgeARM
     //   $0800 - 4K Display Data
     //   $1800 - 2K C Variable & Stack
     std::array<uInt8, 8_KB> myRAM{};
+    // Copy-on-write snapshots of the RAM, for states which support them
+    mutable PageSnapshot myRAMSnapshot;
 
     // Indicates the offset into the ROM image (aligns to current bank)
     uInt16 myBankOffset{0};
@@ -280,6 +300,17 @@ class CartridgeBUS : public CartridgeARM
     // Pointer to the array of datastream maps
     uInt16 myDatastreamMapBase{0};  // was DSMAPS
 
+    // Decoded datastream pointers and increments (see loadDatastreams());
+    // the command and jump stream pointers only exist in BUS3
+    static constexpr uInt8 DATASTREAM_COUNT = 18, INCREMENT_COUNT = 16;
+    std::array<uInt32, DATASTREAM_COUNT> myDatastreamPointers{0};
+    std::array<uInt32, INCREMENT_COUNT> myDatastreamIncrements{0};
+    uInt8 myDatastreamCount{INCREMENT_COUNT};
+
+    // Set when a pointer or increment was changed since the last
+    // flushDatastreams()
+    mutable bool myDatastreamsDirty{false};
+
     // Pointer to the beginning of the waveform data block
     uInt16 myWaveformBase{0}; // was WAVEFORM
 
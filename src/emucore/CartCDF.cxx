@@ -58,9 +58,11 @@ CartridgeCDF::CartridgeCDF(const ByteBuffer& image, size_t size,
   : CartridgeARM(settings, md5)
 {
   // Copy the ROM image into my buffer
+  // The image is shared by all consoles running this ROM (see patch())
   mySize = std::min(size, 512_KB);
-  myImage = std::make_unique<uInt8[]>(mySize);
-  std::copy_n(image.get(), mySize, myImage.get());
+  myImage = sharedBuffer("CDF image", mySize, [&image, this](uInt8* data) {
+    std::copy_n(image.get(), mySize, data);
+  });
 
   // Detect cart version
   setupVersion();
@@ -103,6 +105,7 @@ CartridgeCDF::CartridgeCDF(const ByteBuffer& image, size_t size,
       settings.getFloat("dev.thumb.cyclefactor")) : 1.0,
     thumulatorConfiguration(myCDFSubtype),
     this);
+  myThumbEmulator->shareDecodedRom(sharedKey("CDF code", mySize));
 
   this->setInitialState();  // NOLINT
 
@@ -147,6 +150,8 @@ void CartridgeCDF::setInitialState()
   myFastJumpActive = myFastJumpStream = 0;
   myLDAXYimmediateOperandAddress = LDAXY_OVERRIDE_INACTIVE;
 
+  loadDatastreams();
+
   CartridgeARM::setInitialState();
 }
 
@@ -167,14 +172,11 @@ void CartridgeCDF::install(System& system)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 FORCE_INLINE void CartridgeCDF::updateMusicModeDataFetchers()
 {
-  // Calculate the number of cycles since the last update
-  const auto cycles = static_cast<uInt32>(mySystem->cycles() - myAudioCycles);
-  myAudioCycles = mySystem->cycles();
-
-  // Calculate the number of CDF OSC clocks since the last update
-  const double clocks = ((20000.0 * cycles) / myClockRate) + myFractionalClocks;
-  const auto wholeClocks = static_cast<uInt32>(clocks);
-  myFractionalClocks = clocks - static_cast<double>(wholeClocks);
+  // Calculate the number of CDF OSC clocks since the last update; the
+  // counters only depend on the elapsed time, so they are advanced here,
+  // when the amplitude is read, and never in between
+  const uInt32 wholeClocks =
+    musicModeClocks(mySystem->cycles(), myAudioCycles, myFractionalClocks);
 
   // Let's update counters and flags of the music mode data fetchers
   if(wholeClocks > 0)
@@ -191,14 +193,18 @@ inline void CartridgeCDF::callFunction(uInt8 value)
     case 254: // call with IRQ driven audio, no special handling needed at this
               // time for Stella as ARM code "runs in zero 6507 cycles".
     case 255: // call without IRQ driven audio
+      // The ARM code works on the datastreams in RAM
+      flushDatastreams();
       try {
         auto cycles = static_cast<uInt32>(mySystem->cycles() - myARMCycles);
 
         myARMCycles = mySystem->cycles();
         myThumbEmulator->run(cycles, value == 254);
         updateCycles(cycles);
+        loadDatastreams();
       }
       catch(const std::runtime_error& e) {
+        loadDatastreams();
         if(!mySystem->autodetectMode())
         {
           FatalEmulationError::raise(e.what());
@@ -296,7 +302,10 @@ uInt8 CartridgeCDF::peek(uInt16 address)
         if (sampleaddress < 0x00080000)
           peekvalue = myImage[sampleaddress];
         else if (sampleaddress >= 0x40000000 && sampleaddress < 0x40008000) // check for RAM
+        {
+          flushDatastreams();
           peekvalue = myRAM[sampleaddress - 0x40000000];
+        }
         else
           peekvalue = 0;
 
@@ -468,9 +477,9 @@ bool CartridgeCDF::bank(uInt16 bank, uInt16)
   // Map Program ROM image into the system
   for(uInt16 addr = 0x1040; addr < 0x2000; addr += System::PAGE_SIZE)
   {
-    access.romAccessBase = &myRomAccessBase[myBankOffset + (addr & 0x0FFF)];
-    access.romPeekCounter = &myRomAccessCounter[myBankOffset + (addr & 0x0FFF)];
-    access.romPokeCounter = &myRomAccessCounter[myBankOffset + (addr & 0x0FFF) + 28_KB];  // TODO: Change for CDFJ+???
+    access.romAccessBase = romAccessBase(myBankOffset + (addr & 0x0FFF));
+    access.romPeekCounter = romPeekCounter(myBankOffset + (addr & 0x0FFF));
+    access.romPokeCounter = romPokeCounter(myBankOffset + (addr & 0x0FFF));  // TODO: Change for CDFJ+???
     mySystem->setPageAccess(addr, access);
   }
   return myBankChanged = true;
@@ -496,6 +505,12 @@ bool CartridgeCDF::patch(uInt16 address, uInt8 value)
   // For now, we ignore attempts to patch the CDF address space
   if(address >= 0x0040)
   {
+    // Switch to a private copy of the ROM first
+    const auto offset = myProgramImage - myImage.get();
+    unshareBuffer(myImage, mySize);
+    myProgramImage = myImage.get() + offset;
+    myThumbEmulator->romChanged(reinterpret_cast<uInt16*>(myImage.get()));
+
     myProgramImage[myBankOffset + (address & 0x0FFF)] = value;
     return myBankChanged = true;
   }
@@ -546,7 +561,10 @@ uInt32 CartridgeCDF::thumbCallback(uInt8 function, uInt32 value1, uInt32 value2)
 uInt8 CartridgeCDF::internalRamGetValue(uInt16 addr) const
 {
   if(addr < internalRamSize())
+  {
+    flushDatastreams();
     return myRAM[addr];
+  }
   else
     return 0;
 }
@@ -570,7 +588,8 @@ bool CartridgeCDF::save(Serializer& out) const
     out.putShort(myJMPoperandAddress);
 
     // Harmony RAM
-    out.putByteArray(myRAM);
+    flushDatastreams();
+    out.putPages(myRAM, myRAMSnapshot);
 
     // Audio info
     out.putIntArray(myMusicCounters);
@@ -612,7 +631,8 @@ bool CartridgeCDF::load(Serializer& in)
     myJMPoperandAddress = in.getShort();
 
     // Harmony RAM
-    in.getByteArray(myRAM);
+    in.getPages(myRAM, myRAMSnapshot);
+    loadDatastreams();
 
     // Audio info
     in.getIntArray(myMusicCounters);
@@ -641,34 +661,54 @@ bool CartridgeCDF::load(Serializer& in)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 uInt32 CartridgeCDF::getDatastreamPointer(uInt8 index) const
 {
-  const uInt16 address = myDatastreamBase + index * 4;
-
-  return myRAM[address + 0]        +  // low byte
-        (myRAM[address + 1] << 8)  +
-        (myRAM[address + 2] << 16) +
-        (myRAM[address + 3] << 24) ;  // high byte
+  return myDatastreamPointers[index];
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void CartridgeCDF::setDatastreamPointer(uInt8 index, uInt32 value)
 {
-  const uInt16 address = myDatastreamBase + index * 4;
-
-  myRAM[address + 0] = value & 0xff;          // low byte
-  myRAM[address + 1] = (value >> 8) & 0xff;
-  myRAM[address + 2] = (value >> 16) & 0xff;
-  myRAM[address + 3] = (value >> 24) & 0xff;  // high byte
+  myDatastreamPointers[index] = value;
+  myDatastreamsDirty = true;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 uInt32 CartridgeCDF::getDatastreamIncrement(uInt8 index) const
 {
-  const uInt16 address = myDatastreamIncrementBase + index * 4;
+  return myDatastreamIncrements[index];
+}
 
-  return myRAM[address + 0]        +   // low byte
-        (myRAM[address + 1] << 8)  +
-        (myRAM[address + 2] << 16) +
-        (myRAM[address + 3] << 24) ;   // high byte
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void CartridgeCDF::loadDatastreams()
+{
+  for(uInt8 i = 0; i < DATASTREAM_COUNT; ++i)
+  {
+    myDatastreamPointers[i] = getUInt32(myRAM.data(), myDatastreamBase + i * 4);
+    myDatastreamIncrements[i] =
+      getUInt32(myRAM.data(), myDatastreamIncrementBase + i * 4);
+  }
+  myDatastreamsDirty = false;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void CartridgeCDF::flushDatastreams() const
+{
+  if(!myDatastreamsDirty)
+    return;
+
+  // Only the pointers can be changed by the 6507; the RAM copy is logically
+  // part of the cached state, so it is updated even for const access
+  uInt8* ram = const_cast<uInt8*>(myRAM.data());  // NOLINT
+  for(uInt8 i = 0; i < DATASTREAM_COUNT; ++i)
+  {
+    const uInt32 value = myDatastreamPointers[i];
+    const uInt16 address = myDatastreamBase + i * 4;
+
+    ram[address + 0] = value & 0xff;          // low byte
+    ram[address + 1] = (value >> 8) & 0xff;
+    ram[address + 2] = (value >> 16) & 0xff;
+    ram[address + 3] = (value >> 24) & 0xff;  // high byte
+  }
+  myDatastreamsDirty = false;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -180,6 +180,14 @@ class CartridgeCDF : public CartridgeARM
     */
     uInt8 internalRamGetValue(uInt16 addr) const override;
 
+    /**
+      Get the ARM RAM, for direct access by external tools.
+    */
+    RamAreaList ramAreas() override {
+      flushDatastreams();
+      return {{myRAM, 0x40000000}};
+    }
+
     /**
       Set if we are using CDFJ+ bankswitching
      */
@@ -268,6 +276,16 @@ class CartridgeCDF : public CartridgeARM
 
     uInt32 getDatastreamIncrement(uInt8 index) const;
 
+    /**
+      The datastream pointers and increments are stored byte-wise in the
+      driver RAM, where the ARM code expects them.  The 6507 side works on
+      a decoded copy instead, which is (re)loaded whenever the RAM may have
+      been changed behind its back (ARM code, state load, debugger), and
+      written back before anything else looks at the RAM.
+    */
+    void loadDatastreams();
+    void flushDatastreams() const;
+
     uInt8 readFromDatastream(uInt8 index);
 
     uInt32 getWaveform(uInt8 index) const;
@@ -278,7 +296,8 @@ class CartridgeCDF : public CartridgeARM
     uInt32 scanCDFDriver(uInt32 value);
 
   private:
-    static constexpr uInt8  COMMSTREAM = 0x20, JUMPSTREAM_BASE = 0x21;
+    static constexpr uInt8  COMMSTREAM = 0x20, JUMPSTREAM_BASE = 0x21,
+                            DATASTREAM_COUNT = JUMPSTREAM_BASE + 2;
     static constexpr uInt16 LDAXY_OVERRIDE_INACTIVE = 0xFFFF;
 
     // The ROM image of the cartridge
@@ -304,6 +323,8 @@ class CartridgeCDF : public CartridgeARM
     //   $0000 - 2K Driver
     //   $0800 - Display Data, C Variables & Stack
     std::array<uInt8, 32_KB> myRAM{};
+    // Copy-on-write snapshots of the RAM, for states which support them
+    mutable PageSnapshot myRAMSnapshot;
 
     // Indicates the offset into the ROM image (aligns to current bank)
     uInt16 myBankOffset{0};
@@ -378,6 +399,13 @@ class CartridgeCDF : public CartridgeARM
     // Pointer to the array of datastream increments
     uInt16 myDatastreamIncrementBase{0};
 
+    // Decoded datastream pointers and increments (see loadDatastreams())
+    std::array<uInt32, DATASTREAM_COUNT> myDatastreamPointers{0};
+    std::array<uInt32, DATASTREAM_COUNT> myDatastreamIncrements{0};
+
+    // Set when a pointer was changed since the last flushDatastreams()
+    mutable bool myDatastreamsDirty{false};
+
     // Pointer to the beginning of the waveform data block
     uInt16 myWaveformBase{0};
 
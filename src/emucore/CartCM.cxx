@@ -24,7 +24,7 @@
 CartridgeCM::CartridgeCM(const ByteBuffer& image, size_t size,
                          string_view md5, const Settings& settings)
   : Cartridge(settings, md5),
-    myImage{std::make_unique<uInt8[]>(16_KB)}
+    myImage{allocateBuffer(16_KB)}
 {
   // Copy the ROM image into my buffer
   std::copy_n(image.get(), std::min(16_KB, size), myImage.get());
@@ -120,9 +120,9 @@ bool CartridgeCM::bank(uInt16 bank, uInt16)
   for(uInt16 addr = 0x1000; addr < 0x1800; addr += System::PAGE_SIZE)
   {
     access.directPeekBase = &myImage[myBankOffset + (addr & 0x0FFF)];
-    access.romAccessBase = &myRomAccessBase[myBankOffset + (addr & 0x0FFF)];
-    access.romPeekCounter = &myRomAccessCounter[myBankOffset + (addr & 0x0FFF)];
-    access.romPokeCounter = &myRomAccessCounter[myBankOffset + (addr & 0x0FFF) + myAccessSize];
+    access.romAccessBase = romAccessBase(myBankOffset + (addr & 0x0FFF));
+    access.romPeekCounter = romPeekCounter(myBankOffset + (addr & 0x0FFF));
+    access.romPokeCounter = romPokeCounter(myBankOffset + (addr & 0x0FFF));
     mySystem->setPageAccess(addr, access);
   }
 
@@ -134,16 +134,16 @@ bool CartridgeCM::bank(uInt16 bank, uInt16)
     if(mySWCHA & 0x10)
     {
       access.directPeekBase = &myImage[myBankOffset + (addr & 0x0FFF)];
-      access.romAccessBase = &myRomAccessBase[myBankOffset + (addr & 0x0FFF)];
-      access.romPeekCounter = &myRomAccessCounter[myBankOffset + (addr & 0x0FFF)];
-      access.romPokeCounter = &myRomAccessCounter[myBankOffset + (addr & 0x0FFF) + myAccessSize];
+      access.romAccessBase = romAccessBase(myBankOffset + (addr & 0x0FFF));
+      access.romPeekCounter = romPeekCounter(myBankOffset + (addr & 0x0FFF));
+      access.romPokeCounter = romPokeCounter(myBankOffset + (addr & 0x0FFF));
     }
     else
     {
       access.directPeekBase = &myRAM[addr & 0x7FF];
-      access.romAccessBase = &myRomAccessBase[myBankOffset + (addr & 0x07FF)];
-      access.romPeekCounter = &myRomAccessCounter[myBankOffset + (addr & 0x07FF)];
-      access.romPokeCounter = &myRomAccessCounter[myBankOffset + (addr & 0x07FF) + myAccessSize];
+      access.romAccessBase = romAccessBase(myBankOffset + (addr & 0x07FF));
+      access.romPeekCounter = romPeekCounter(myBankOffset + (addr & 0x07FF));
+      access.romPokeCounter = romPokeCounter(myBankOffset + (addr & 0x07FF));
     }
 
     if((mySWCHA & 0x30) == 0x20)
@@ -25,7 +25,7 @@
 CartridgeCTY::CartridgeCTY(const ByteBuffer& image, size_t size,
                            string_view md5, const Settings& settings)
   : Cartridge(settings, md5),
-    myImage{std::make_unique<uInt8[]>(32_KB)}
+    myImage{allocateBuffer(32_KB)}
 {
   // Copy the ROM image into my buffer
   std::copy_n(image.get(), std::min(32_KB, size), myImage.get());
@@ -257,9 +257,9 @@ bool CartridgeCTY::bank(uInt16 bank, uInt16)
   System::PageAccess access(this, System::PageAccessType::READ);
   for(uInt16 addr = 0x1080; addr < 0x2000; addr += System::PAGE_SIZE)
   {
-    access.romAccessBase = &myRomAccessBase[myBankOffset + (addr & 0x0FFF)];
-    access.romPeekCounter = &myRomAccessCounter[myBankOffset + (addr & 0x0FFF)];
-    access.romPokeCounter = &myRomAccessCounter[myBankOffset + (addr & 0x0FFF) + myAccessSize];
+    access.romAccessBase = romAccessBase(myBankOffset + (addr & 0x0FFF));
+    access.romPeekCounter = romPeekCounter(myBankOffset + (addr & 0x0FFF));
+    access.romPokeCounter = romPokeCounter(myBankOffset + (addr & 0x0FFF));
     mySystem->setPageAccess(addr, access);
   }
   return myBankChanged = true;
@@ -68,6 +68,7 @@
 #include "CartX07.hxx"
 #include "CartELF.hxx"
 #include "MD5.hxx"
+#include "PropsSet.hxx"
 #include "Settings.hxx"
 
 #include "CartDetector.hxx"
@@ -160,23 +161,24 @@ namespace  // anonymous namespace, to keep these functions private
     @param type     The detected type of the slice of the ROM image
     @param id       The ID for the slice of the ROM image
     @param settings The settings container
+    @param context  The multicart game to move from, updated with the new one
 
     @return  Pointer to the new cartridge object allocated on the heap
   */
   unique_ptr<Cartridge>
   createFromMultiCart(const ByteBuffer& image, size_t& size, uInt32 numRoms,
                       string& md5, Bankswitch::Type& type, string& id,
-                      Settings& settings)
+                      Settings& settings, CartCreator::Context& context)
   {
     // Get a piece of the larger image
-    uInt32 i = settings.getInt("romloadcount");
+    uInt32 i = context.romLoadCount;
 
     // Move to the next game
-    if(!settings.getBool("romloadprev"))
+    if(!context.romLoadPrev)
       i = (i + 1) % numRoms;
     else
       i = (i - 1) % numRoms;
-    settings.setValue("romloadcount", i);
+    context.newRomLoadCount = i;
 
     size /= numRoms;
     const ByteBuffer slice = std::make_unique<uInt8[]>(size);
@@ -200,10 +202,54 @@ namespace  // anonymous namespace, to keep these functions private
   }
 };  // namespace
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+CartCreator::Context CartCreator::prepare(string_view md5,
+    const Settings& settings, PropertiesSet* propset)
+{
+  Context context;
+  context.md5 = md5;
+  context.rominfo = settings.getBool("rominfo");
+  context.romLoadCount = settings.getInt("romloadcount");
+  context.romLoadPrev = settings.getBool("romloadprev");
+
+  // Reuse the type detected when the ROM was loaded before
+  string cachedType;
+  if(!context.rominfo && propset &&
+     propset->getDetected(md5, PropertiesSet::DETECTED_CART_TYPE, cachedType))
+    context.cachedType = Bankswitch::nameToType(cachedType);
+
+  return context;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void CartCreator::finish(const Context& context, Settings& settings,
+                         PropertiesSet* propset)
+{
+  if(propset && context.detectedType != Bankswitch::Type::AUTO)
+    propset->setDetected(context.md5, PropertiesSet::DETECTED_CART_TYPE,
+                         Bankswitch::typeToName(context.detectedType));
+
+  if(context.newRomLoadCount)
+    settings.setValue("romloadcount", *context.newRomLoadCount);
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 unique_ptr<Cartridge> CartCreator::create(const FSNode& file,
     const ByteBuffer& image, size_t size, string& md5,
-    string_view dtype, Settings& settings)
+    string_view dtype, Settings& settings, PropertiesSet* propset)
+{
+  Context context = prepare(md5, settings, propset);
+  unique_ptr<Cartridge> cartridge =
+      create(file, image, size, md5, dtype, settings, context);
+  finish(context, settings, propset);
+
+  return cartridge;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+unique_ptr<Cartridge> CartCreator::create(const FSNode& file,
+    const ByteBuffer& image, size_t size, string& md5,
+    string_view dtype, Settings& settings, Context& context)
 {
   unique_ptr<Cartridge> cartridge;
   Bankswitch::Type type = Bankswitch::nameToType(dtype), detectedType = type;
@@ -217,10 +263,20 @@ unique_ptr<Cartridge> CartCreator::create(const FSNode& file,
 
   // See if we should try to auto-detect the cartridge type
   // If we ask for extended info, always do an autodetect
+  const bool rominfo = context.rominfo;
   bool autodetected = false;
-  if(type == Bankswitch::Type::AUTO || settings.getBool("rominfo"))
+  if(type == Bankswitch::Type::AUTO || rominfo)
   {
-    detectedType = CartDetector::autodetectType(image, size);
+    // Reuse the type detected when the ROM was loaded before
+    if(!rominfo)
+      detectedType = context.cachedType;
+
+    if(detectedType == Bankswitch::Type::AUTO || rominfo)
+    {
+      detectedType = CartDetector::autodetectType(image, size);
+      context.detectedType = detectedType;
+    }
+
     if(type != Bankswitch::Type::AUTO && type != detectedType)
       cerr << "Auto-detection not consistent: "
            << Bankswitch::typeToName(type) << ", "
@@ -283,7 +339,8 @@ unique_ptr<Cartridge> CartCreator::create(const FSNode& file,
   if(numMultiRoms)
   {
     if(validMultiSize)
-      cartridge = createFromMultiCart(image, size, numMultiRoms, md5, detectedType, id, settings);
+      cartridge = createFromMultiCart(image, size, numMultiRoms, md5, detectedType,
+                                      id, settings, context);
     else
       throw std::runtime_error(std::format(
           "Invalid cart size for type '{}'", Bankswitch::typeToName(type)));
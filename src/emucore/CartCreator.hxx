@@ -19,8 +19,11 @@
 #define CARTRIDGE_CREATOR_HXX
 
 class Cartridge;
+class PropertiesSet;
 class Settings;
 
+#include <optional>
+
 #include "Bankswitch.hxx"
 #include "bspf.hxx"
 
@@ -32,20 +35,90 @@ class Settings;
 */
 namespace CartCreator
 {
+  /**
+    Everything the creation of a cartridge needs from, or stores in, the
+    settings and the properties.  These must only be accessed from the main
+    thread, so this is filled in by prepare() and applied by finish() there,
+    while the cartridge itself can be created on any thread.
+  */
+  struct Context
+  {
+    // The md5sum of the complete ROM image
+    string md5;
+
+    // The type autodetected when the ROM was loaded before, if any
+    Bankswitch::Type cachedType{Bankswitch::Type::AUTO};
+
+    // With extended info, the type is always autodetected again
+    bool rominfo{false};
+
+    // The multicart game loaded before, and the direction to move in
+    uInt32 romLoadCount{0};
+    bool romLoadPrev{false};
+
+    // The newly autodetected type (if any), and the multicart game loaded
+    // now (if any)
+    Bankswitch::Type detectedType{Bankswitch::Type::AUTO};
+    std::optional<uInt32> newRomLoadCount;
+  };
+
+  /**
+    Gather the settings and cached properties for the given ROM image.
+    Must be called on the main thread.
+
+    @param md5      The md5sum for the given ROM image
+    @param settings The settings container
+    @param propset  If given, the cached autodetection results are used
+    @return   The context to create the cartridge with
+  */
+  Context prepare(string_view md5, const Settings& settings,
+                  PropertiesSet* propset = nullptr);
+
   /**
     Create a new cartridge object allocated on the heap.  The
     type of cartridge created depends on the properties object.
 
+    This doesn't access the properties or change the settings, and can
+    be done on any thread.
+
+    @param image    A pointer to the ROM image
+    @param size     The size of the ROM image
+    @param md5      The md5sum for the given ROM image (can be updated)
+    @param dtype    The detected bankswitch type of the ROM image
+    @param settings The settings container
+    @param context  The context from prepare(), updated with the results
+    @return   Pointer to the new cartridge object allocated on the heap
+  */
+  unique_ptr<Cartridge> create(const FSNode& file,
+      const ByteBuffer& image, size_t size, string& md5,
+      string_view dtype, Settings& settings, Context& context);
+
+  /**
+    Store the results of creating a cartridge, i.e. cache the autodetected
+    type and remember the multicart game.  Must be called on the main thread.
+
+    @param context  The context used to create the cartridge
+    @param settings The settings container
+    @param propset  If given, autodetection results are cached here
+  */
+  void finish(const Context& context, Settings& settings,
+              PropertiesSet* propset = nullptr);
+
+  /**
+    Create a new cartridge object allocated on the heap, on the main
+    thread.  This combines prepare(), create() and finish().
+
     @param image    A pointer to the ROM image
     @param size     The size of the ROM image
     @param md5      The md5sum for the given ROM image (can be updated)
     @param dtype    The detected bankswitch type of the ROM image
     @param settings The settings container
+    @param propset  If given, autodetection results are cached here
     @return   Pointer to the new cartridge object allocated on the heap
   */
   unique_ptr<Cartridge> create(const FSNode& file,
       const ByteBuffer& image, size_t size, string& md5,
-      string_view dtype, Settings& settings);
+      string_view dtype, Settings& settings, PropertiesSet* propset = nullptr);
 };  // namespace CartCreator
 
 #endif
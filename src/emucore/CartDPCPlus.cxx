@@ -28,14 +28,16 @@
 CartridgeDPCPlus::CartridgeDPCPlus(const ByteBuffer& image, size_t size,
                                    string_view md5, const Settings& settings)
   : CartridgeARM(settings, md5),
-    myImage{std::make_unique<uInt8[]>(32_KB)},
     mySize{std::min(size, 32_KB)}
 {
   // Image is always 32K, but in the case of ROM < 32K, the image is
-  // copied to the end of the buffer
-  if(mySize < 32_KB)
-    std::fill_n(myImage.get(), mySize, 0);
-  std::copy_n(image.get(), size, myImage.get() + (32_KB - mySize));
+  // copied to the end of the buffer.  The image is shared by all consoles
+  // running this ROM (see patch()).
+  myImage = sharedBuffer("DPC+ image", 32_KB, [&image, size, this](uInt8* data) {
+    if(mySize < 32_KB)
+      std::fill_n(data, mySize, 0);
+    std::copy_n(image.get(), size, data + (32_KB - mySize));
+  });
   createRomAccessArrays(24_KB);
 
   // Pointer to the program ROM (24K @ 3K offset; ignore first 3K)
@@ -61,6 +63,7 @@ CartridgeDPCPlus::CartridgeDPCPlus(const ByteBuffer& image, size_t size,
           settings.getFloat("dev.thumb.cyclefactor")) : 1.0,
        Thumbulator::ConfigureFor::DPCplus,
        this);
+  myThumbEmulator->shareDecodedRom(sharedKey("DPC+ code", 32_KB));
 
   // Currently 4 DPC+ driver versions have been identified:
   //   17884ec14f9b1d06fe8d617a1fbdcf47  Jitter  Encore Compatible
@@ -164,14 +167,11 @@ FORCE_INLINE void CartridgeDPCPlus::priorClockRandomNumberGenerator()
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 FORCE_INLINE void CartridgeDPCPlus::updateMusicModeDataFetchers()
 {
-  // Calculate the number of cycles since the last update
-  const auto cycles = static_cast<uInt32>(mySystem->cycles() - myAudioCycles);
-  myAudioCycles = mySystem->cycles();
-
-  // Calculate the number of DPC+ OSC clocks since the last update
-  const double clocks = ((20000.0 * cycles) / myClockRate) + myFractionalClocks;
-  const auto wholeClocks = static_cast<uInt32>(clocks);
-  myFractionalClocks = clocks - static_cast<double>(wholeClocks);
+  // Calculate the number of DPC+ OSC clocks since the last update; the
+  // counters only depend on the elapsed time, so they are advanced here,
+  // when the amplitude is read, and never in between
+  const uInt32 wholeClocks =
+    musicModeClocks(mySystem->cycles(), myAudioCycles, myFractionalClocks);
 
   // Let's update counters and flags of the music mode data fetchers
   if(wholeClocks > 0)
@@ -626,9 +626,9 @@ bool CartridgeDPCPlus::bank(uInt16 bank, uInt16)
   // Map Program ROM image into the system
   for(uInt16 addr = 0x1080; addr < 0x2000; addr += System::PAGE_SIZE)
   {
-    access.romAccessBase = &myRomAccessBase[myBankOffset + (addr & 0x0FFF)];
-    access.romPeekCounter = &myRomAccessCounter[myBankOffset + (addr & 0x0FFF)];
-    access.romPokeCounter = &myRomAccessCounter[myBankOffset + (addr & 0x0FFF) + 24_KB];
+    access.romAccessBase = romAccessBase(myBankOffset + (addr & 0x0FFF));
+    access.romPeekCounter = romPeekCounter(myBankOffset + (addr & 0x0FFF));
+    access.romPokeCounter = romPokeCounter(myBankOffset + (addr & 0x0FFF));
     mySystem->setPageAccess(addr, access);
   }
   return myBankChanged = true;
@@ -654,6 +654,12 @@ bool CartridgeDPCPlus::patch(uInt16 address, uInt8 value)
   // For now, we ignore attempts to patch the DPC address space
   if(address >= 0x0080)
   {
+    // Switch to a private copy of the ROM first
+    const auto offset = myProgramImage - myImage.get();
+    unshareBuffer(myImage, 32_KB);
+    myProgramImage = myImage.get() + offset;
+    myThumbEmulator->romChanged(reinterpret_cast<uInt16*>(myImage.get()));
+
     myProgramImage[myBankOffset + (address & 0x0FFF)] = value;
     return myBankChanged = true;
   }
@@ -149,6 +149,11 @@ class CartridgeDPCPlus : public CartridgeARM
     */
     uInt8 internalRamGetValue(uInt16 addr) const override;
 
+    /**
+      Get the ARM RAM, for direct access by external tools.
+    */
+    RamAreaList ramAreas() override { return {{myDPCRAM, 0x40000000}}; }
+
     /**
       Answer whether this is a PlusROM cart.  Note that until the
       initialize method has been called, this will always return false.
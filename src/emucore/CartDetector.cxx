@@ -22,18 +22,326 @@
 #include "CartDetector.hxx"
 #include "CartMVC.hxx"
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+namespace {
+  // All signatures which are searched for over the whole image
+  enum class Sig: uInt8 {
+    ORA_03E0_ORA, LDA_03E0_ORA,
+    LDA_0800, LDA_0840, BIT_0800, NOP_0800_JMP, NOP_0FFF_JMP,
+    BIT_0FC0, STA_0FC0, LDA_0FC0, BIT_EFC0,
+    STA_3E, STA_3F,
+    TXT_3EX, TXT_TJ3E, TXT_BUS, TXT_CDF, TXT_PLUSCDFJ, TXT_LENIN, TXT_DPCP,
+    STA_F3FF_X, STA_F400_Y,
+    STA_1FE0, STA_5FE0, STA_FFE9, NOP_1FE0, LDA_1FE0, LDA_FFE9, LDA_FFED,
+    LDA_BFF3,
+    LDA_FFE2, LDA_FFE4, LDA_FFE5, LDA_FFE6, LDA_1FE5, LDA_1FE7, NOP_1FE7,
+    STA_FFE7, STA_1FE7,
+    NOP_FFE0, LDA_FFE0, NOP_1FF0, LDA_1FF4,
+    STA_1FF9, STA_FFF9,
+    STA_1FF8_LSR, STA_FFF8_STA, STY_FFF9_LDA,
+    JSR_D000_DEC, JSR_F8C3_LDA, BNE_JSR_FE73, BNE_JSR_FE68, JSR_F000_STY,
+    LDA_FFF1_RTS,
+    LDA_0CB8,
+    LDA_0800_X,
+    STA_82_Y_JMP,
+    STA_0240, LDA_0240, LDA_021F_X, BIT_02C0, STA_02C0, LDA_02C0,
+    LDA_39_JMP,
+    LDA_080D, LDA_081D, LDA_082D, NOP_080D, NOP_081D, NOP_082D,
+    NumSigs
+  };
+  constexpr size_t NUM_SIGS = static_cast<size_t>(Sig::NumSigs);
+
+  struct Signature
+  {
+    Sig id{Sig::NumSigs};
+    uInt8 size{0};
+    std::array<uInt8, 8> bytes{};
+  };
+
+  // Signatures shared by several heuristics are listed only once
+  constexpr std::array<Signature, NUM_SIGS> ourSignatures = {{
+    // 03E0
+    { Sig::ORA_03E0_ORA, 4, { 0x0D, 0xE0, 0x03, 0x0D } },  // ORA $3E0, ORA (Popeye)
+    { Sig::LDA_03E0_ORA, 4, { 0xAD, 0xE0, 0x03, 0xAD } },  // LDA $3E0, ORA (Montezuma's Revenge)
+    // 0840
+    { Sig::LDA_0800,     3, { 0xAD, 0x00, 0x08 } },  // LDA $0800
+    { Sig::LDA_0840,     3, { 0xAD, 0x40, 0x08 } },  // LDA $0840
+    { Sig::BIT_0800,     3, { 0x2C, 0x00, 0x08 } },  // BIT $0800
+    { Sig::NOP_0800_JMP, 4, { 0x0C, 0x00, 0x08, 0x4C } },  // NOP $0800; JMP ...
+    { Sig::NOP_0FFF_JMP, 4, { 0x0C, 0xFF, 0x0F, 0x4C } },  // NOP $0FFF; JMP ...
+    // 0FA0
+    { Sig::BIT_0FC0, 3, { 0x2C, 0xC0, 0x0F } },  // BIT $FC0  (H.E.R.O., Kung-Fu Master)
+    { Sig::STA_0FC0, 3, { 0x8D, 0xC0, 0x0F } },  // STA $FC0  (Pole Position, Subterranea)
+    { Sig::LDA_0FC0, 3, { 0xAD, 0xC0, 0x0F } },  // LDA $FC0  (Front Line, Zaxxon)
+    { Sig::BIT_EFC0, 3, { 0x2C, 0xC0, 0xEF } },  // BIT $EFC0 (Motocross)
+    // 3E, 3F
+    { Sig::STA_3E, 2, { 0x85, 0x3E } },  // STA $3E
+    { Sig::STA_3F, 2, { 0x85, 0x3F } },  // STA $3F
+    // Strings
+    { Sig::TXT_3EX,      3, { '3', 'E', 'X' } },
+    { Sig::TXT_TJ3E,     4, { 'T', 'J', '3', 'E' } },
+    { Sig::TXT_BUS,      3, { 'B', 'U', 'S' } },
+    { Sig::TXT_CDF,      3, { 'C', 'D', 'F' } },
+    { Sig::TXT_PLUSCDFJ, 8, { 'P', 'L', 'U', 'S', 'C', 'D', 'F', 'J' } },
+    { Sig::TXT_LENIN,    5, { 'L', 'E', 'N', 'I', 'N' } },
+    { Sig::TXT_DPCP,     4, { 'D', 'P', 'C', '+' } },
+    // CV (attributed to the MESS project)
+    { Sig::STA_F3FF_X, 3, { 0x9D, 0xFF, 0xF3 } },  // STA $F3FF,X  MagiCard
+    { Sig::STA_F400_Y, 3, { 0x99, 0x00, 0xF4 } },  // STA $F400,Y  Video Life
+    // E0 (attributed to the MESS project)
+    { Sig::STA_1FE0, 3, { 0x8D, 0xE0, 0x1F } },  // STA $1FE0
+    { Sig::STA_5FE0, 3, { 0x8D, 0xE0, 0x5F } },  // STA $5FE0
+    { Sig::STA_FFE9, 3, { 0x8D, 0xE9, 0xFF } },  // STA $FFE9
+    { Sig::NOP_1FE0, 3, { 0x0C, 0xE0, 0x1F } },  // NOP $1FE0
+    { Sig::LDA_1FE0, 3, { 0xAD, 0xE0, 0x1F } },  // LDA $1FE0
+    { Sig::LDA_FFE9, 3, { 0xAD, 0xE9, 0xFF } },  // LDA $FFE9
+    { Sig::LDA_FFED, 3, { 0xAD, 0xED, 0xFF } },  // LDA $FFED
+    { Sig::LDA_BFF3, 3, { 0xAD, 0xF3, 0xBF } },  // LDA $BFF3
+    // E7 (attributed to the MESS project), E78K
+    { Sig::LDA_FFE2, 3, { 0xAD, 0xE2, 0xFF } },  // LDA $FFE2
+    { Sig::LDA_FFE4, 3, { 0xAD, 0xE4, 0xFF } },  // LDA $FFE4
+    { Sig::LDA_FFE5, 3, { 0xAD, 0xE5, 0xFF } },  // LDA $FFE5
+    { Sig::LDA_FFE6, 3, { 0xAD, 0xE6, 0xFF } },  // LDA $FFE6
+    { Sig::LDA_1FE5, 3, { 0xAD, 0xE5, 0x1F } },  // LDA $1FE5
+    { Sig::LDA_1FE7, 3, { 0xAD, 0xE7, 0x1F } },  // LDA $1FE7
+    { Sig::NOP_1FE7, 3, { 0x0C, 0xE7, 0x1F } },  // NOP $1FE7
+    { Sig::STA_FFE7, 3, { 0x8D, 0xE7, 0xFF } },  // STA $FFE7
+    { Sig::STA_1FE7, 3, { 0x8D, 0xE7, 0x1F } },  // STA $1FE7
+    // EF, EFF
+    { Sig::NOP_FFE0, 3, { 0x0C, 0xE0, 0xFF } },  // NOP $FFE0
+    { Sig::LDA_FFE0, 3, { 0xAD, 0xE0, 0xFF } },  // LDA $FFE0
+    { Sig::NOP_1FF0, 3, { 0x0C, 0xF0, 0x1F } },  // NOP $1FF0
+    { Sig::LDA_1FF4, 3, { 0xAD, 0xF4, 0x1F } },  // LDA $1FF4
+    // F8
+    { Sig::STA_1FF9, 3, { 0x8D, 0xF9, 0x1F } },  // STA $1FF9
+    { Sig::STA_FFF9, 3, { 0x8D, 0xF9, 0xFF } },  // STA $FFF9
+    // FC
+    { Sig::STA_1FF8_LSR, 6, { 0x8d, 0xf8, 0x1f, 0x4a, 0x4a, 0x8d } }, // STA $1FF8, LSR, LSR, STA... Power Play Arcade Menus, 3-D Ghost Attack
+    { Sig::STA_FFF8_STA, 6, { 0x8d, 0xf8, 0xff, 0x8d, 0xfc, 0xff } }, // STA $FFF8, STA $FFFC        Surf's Up (4K)
+    { Sig::STY_FFF9_LDA, 6, { 0x8c, 0xf9, 0xff, 0xad, 0xfc, 0xff } }, // STY $FFF9, LDA $FFFC        3-D Havoc
+    // FE (mostly attributed to the MESS project)
+    { Sig::JSR_D000_DEC, 5, { 0x20, 0x00, 0xD0, 0xC6, 0xC5 } },  // JSR $D000; DEC $C5  Decathlon
+    { Sig::JSR_F8C3_LDA, 5, { 0x20, 0xC3, 0xF8, 0xA5, 0x82 } },  // JSR $F8C3; LDA $82  Robot Tank
+    { Sig::BNE_JSR_FE73, 5, { 0xD0, 0xFB, 0x20, 0x73, 0xFE } },  // BNE $FB; JSR $FE73  Space Shuttle (NTSC/PAL)
+    { Sig::BNE_JSR_FE68, 5, { 0xD0, 0xFB, 0x20, 0x68, 0xFE } },  // BNE $FB; JSR $FE73  Space Shuttle (SECAM)
+    { Sig::JSR_F000_STY, 5, { 0x20, 0x00, 0xF0, 0x84, 0xD6 } },  // JSR $F000; $84, $D6 Thwocker
+    // JANE
+    { Sig::LDA_FFF1_RTS, 4, { 0xad, 0xf1, 0xff, 0x60 } },  // LDA $FFF1, RTS
+    // GL
+    { Sig::LDA_0CB8, 3, { 0xad, 0xb8, 0x0c } },  // LDA $0CB8
+    // SB
+    { Sig::LDA_0800_X, 3, { 0xBD, 0x00, 0x08 } },  // LDA $0800,x
+    // TV Boy
+    { Sig::STA_82_Y_JMP, 5, { 0x91, 0x82, 0x6c, 0xfc, 0xff } },  // STA ($82),Y; JMP ($FFFC)
+    // UA
+    { Sig::STA_0240,   3, { 0x8D, 0x40, 0x02 } },  // STA $240 (Funky Fish, Pleiades)
+    { Sig::LDA_0240,   3, { 0xAD, 0x40, 0x02 } },  // LDA $240 (???)
+    { Sig::LDA_021F_X, 3, { 0xBD, 0x1F, 0x02 } },  // LDA $21F,X (Gingerbread Man)
+    { Sig::BIT_02C0,   3, { 0x2C, 0xC0, 0x02 } },  // BIT $2C0 (Time Pilot)
+    { Sig::STA_02C0,   3, { 0x8D, 0xC0, 0x02 } },  // STA $2C0 (Fathom, Vanguard)
+    { Sig::LDA_02C0,   3, { 0xAD, 0xC0, 0x02 } },  // LDA $2C0 (Mickey)
+    // WD
+    { Sig::LDA_39_JMP, 3, { 0xA5, 0x39, 0x4C } },  // LDA $39, JMP
+    // X07
+    { Sig::LDA_080D, 3, { 0xAD, 0x0D, 0x08 } },  // LDA $080D
+    { Sig::LDA_081D, 3, { 0xAD, 0x1D, 0x08 } },  // LDA $081D
+    { Sig::LDA_082D, 3, { 0xAD, 0x2D, 0x08 } },  // LDA $082D
+    { Sig::NOP_080D, 3, { 0x0C, 0x0D, 0x08 } },  // NOP $080D
+    { Sig::NOP_081D, 3, { 0x0C, 0x1D, 0x08 } },  // NOP $081D
+    { Sig::NOP_082D, 3, { 0x0C, 0x2D, 0x08 } }   // NOP $082D
+  }};
+
+  constexpr size_t numSignatureStates()
+  {
+    size_t states = 1;  // root
+    for(const auto& sig: ourSignatures)
+      states += sig.size;
+    return states;
+  }
+
+  constexpr std::array<uInt8, 256> byteClasses()
+  {
+    std::array<uInt8, 256> classes{};
+    uInt8 numClasses = 1;  // class 0 is any byte not in a signature
+    for(const auto& sig: ourSignatures)
+      for(uInt8 i = 0; i < sig.size; ++i)
+        if(classes[sig.bytes[i]] == 0)
+          classes[sig.bytes[i]] = numClasses++;
+    return classes;
+  }
+
+  constexpr size_t numByteClasses()
+  {
+    const auto classes = byteClasses();
+    return *std::ranges::max_element(classes) + 1;
+  }
+
+  /**
+    Aho-Corasick automaton over all signatures, built at compile time.
+    To keep the transition table small, bytes which don't occur in any
+    signature share a single input class.
+  */
+  class SignatureMatcher
+  {
+    public:
+      static constexpr size_t NUM_STATES = numSignatureStates();
+      static constexpr size_t USED_CLASSES = numByteClasses();
+      // Rows are padded to a power of two, so the lookup needs no multiply
+      static constexpr size_t NUM_CLASSES = std::bit_ceil(USED_CLASSES);
+      static constexpr auto NO_OUTPUT = static_cast<uInt8>(NUM_SIGS);
+
+      // Keep the transition table small enough to stay in the L1 cache
+      using State = std::conditional_t<NUM_STATES <= 256, uInt8, uInt16>;
+      static_assert(NUM_STATES <= 65536);
+
+      constexpr SignatureMatcher()
+      {
+        myClass = byteClasses();
+        myOutput.fill(NO_OUTPUT);
+
+        // Build the trie; state 0 is the root, which is never a child
+        size_t states = 1;
+        for(size_t s = 0; s < NUM_SIGS; ++s)
+        {
+          const Signature& sig = ourSignatures[s];
+          if(static_cast<size_t>(sig.id) != s || sig.size == 0)
+            return;  // signature table out of order
+
+          State state = 0;
+          for(uInt8 i = 0; i < sig.size; ++i)
+          {
+            State& next = myNext[state][myClass[sig.bytes[i]]];
+            if(next == 0)
+              next = static_cast<State>(states++);
+            state = next;
+          }
+          if(myOutput[state] != NO_OUTPUT)
+            return;  // duplicate signature
+          myOutput[state] = static_cast<uInt8>(s);
+        }
+
+        // Add failure transitions in breadth-first order, so that the
+        // transitions of each failure state are already complete
+        std::array<State, NUM_STATES> fail{}, queue{};
+        size_t head = 0, tail = 0;
+
+        // Children of the root fail back to it, and all other root
+        // transitions already lead there
+        for(const State child: myNext[0])
+          if(child != 0)
+            queue[tail++] = child;
+
+        while(head < tail)
+        {
+          const State state = queue[head++];
+          for(size_t c = 0; c < USED_CLASSES; ++c)
+          {
+            const State child = myNext[state][c];
+            const State target = myNext[fail[state]][c];
+            if(child != 0)
+            {
+              fail[child] = target;
+              myDict[child] = myOutput[target] != NO_OUTPUT ? target : myDict[target];
+              queue[tail++] = child;
+            }
+            else
+              myNext[state][c] = target;
+          }
+        }
+        for(size_t state = 0; state < states; ++state)
+          myFirstHit[state] = myOutput[state] != NO_OUTPUT
+            ? static_cast<State>(state) : myDict[state];
+
+        myValid = true;
+      }
+
+      constexpr bool valid() const { return myValid; }
+
+      State next(State state, uInt8 byte) const {
+        return myNext[state][myClass[byte]];
+      }
+      State firstHit(State state) const { return myFirstHit[state]; }
+      State nextHit(State state) const  { return myDict[state]; }
+      uInt8 output(State state) const   { return myOutput[state]; }
+
+    private:
+      std::array<uInt8, 256> myClass{};
+      std::array<std::array<State, NUM_CLASSES>, NUM_STATES> myNext{};
+      // Signature ending at each state, if any
+      std::array<uInt8, NUM_STATES> myOutput{};
+      // Nearest state along the failure chain which ends a signature
+      // (0 if there is none), and the first such state including itself
+      std::array<State, NUM_STATES> myDict{}, myFirstHit{};
+      bool myValid{false};
+  };
+
+  constexpr SignatureMatcher ourMatcher;
+  static_assert(ourMatcher.valid(), "Invalid or duplicate cart signature");
+} // namespace
+
+/**
+  The number of times each signature occurs in an image, counted exactly
+  like 'searchForBytes' does (hits don't overlap, and a signature cannot
+  start at the last possible position).
+*/
+class CartDetector::SignatureHits
+{
+  public:
+    SignatureHits(const ByteBuffer& image, size_t size)
+    {
+      // Earliest position at which the next hit of a signature may start
+      std::array<size_t, NUM_SIGS> nextStart{};
+      SignatureMatcher::State state = 0;
+
+      // The final byte is never part of a hit
+      for(size_t i = 0; i + 1 < size; ++i)
+      {
+        state = ourMatcher.next(state, image[i]);
+        for(auto hit = ourMatcher.firstHit(state); hit != 0;
+            hit = ourMatcher.nextHit(hit))
+        {
+          const uInt8 s = ourMatcher.output(hit);
+          const size_t start = i + 1 - ourSignatures[s].size;
+          if(start >= nextStart[s])
+          {
+            ++myCount[s];
+            nextStart[s] = start + ourSignatures[s].size + 1;
+          }
+        }
+      }
+    }
+
+    // True if the signature was found at least 'minhits' times
+    bool found(Sig sig, uInt32 minhits = 1) const {
+      return myCount[static_cast<size_t>(sig)] >= minhits;
+    }
+    bool anyFound(std::initializer_list<Sig> sigs, uInt32 minhits = 1) const {
+      return std::ranges::any_of(sigs, [&](Sig sig) { return found(sig, minhits); });
+    }
+    bool allFound(std::initializer_list<Sig> sigs) const {
+      return std::ranges::all_of(sigs, [&](Sig sig) { return found(sig); });
+    }
+
+  private:
+    std::array<uInt32, NUM_SIGS> myCount{};
+};
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 Bankswitch::Type CartDetector::autodetectType(const ByteBuffer& image, size_t size)
 {
   // Guess type based on size
   Bankswitch::Type type = Bankswitch::Type::AUTO;
 
+  // Count all signatures in a single pass; the heuristics below only
+  // consult these counts unless they look at a specific area of the image
+  const SignatureHits hits(image, size);
+
   if (isProbablyELF(image, size)) {
     type =Bankswitch::Type::ELF;
   }
   else if ((size % 8448) == 0 || size == 6_KB)
   {
-    if(size == 6_KB && isProbablyGL(image, size))
+    if(size == 6_KB && isProbablyGL(hits))
       type = Bankswitch::Type::GL;
     else
       type = Bankswitch::Type::AR;
@@ -41,17 +349,17 @@ Bankswitch::Type CartDetector::autodetectType(const ByteBuffer& image, size_t si
   else if((size <= 2_KB) ||
           (size == 4_KB && std::memcmp(image.get(), image.get() + 2_KB, 2_KB) == 0))
   {
-    type = isProbablyCV(image, size) ? Bankswitch::Type::CV : Bankswitch::Type::_2K;
+    type = isProbablyCV(hits) ? Bankswitch::Type::CV : Bankswitch::Type::_2K;
   }
   else if(size == 4_KB)
   {
-    if(isProbablyCV(image, size))
+    if(isProbablyCV(hits))
       type = Bankswitch::Type::CV;
     else if(isProbably4KSC(image, size))
       type = Bankswitch::Type::_4KSC;
-    else if (isProbablyFC(image, size))
+    else if (isProbablyFC(hits))
       type = Bankswitch::Type::FC;
-    else if (isProbablyGL(image, size))
+    else if (isProbablyGL(hits))
       type = Bankswitch::Type::GL;
     else
       type = Bankswitch::Type::_4K;
@@ -59,40 +367,35 @@ Bankswitch::Type CartDetector::autodetectType(const ByteBuffer& image, size_t si
   else if(size == 8_KB)
   {
     // First check for *potential* F8
-    static constexpr uInt8 signature[2][3] = {
-      { 0x8D, 0xF9, 0x1F },  // STA $1FF9
-      { 0x8D, 0xF9, 0xFF }   // STA $FFF9
-    };
-    const bool f8 = searchForBytes(image, size, signature[0], 3, 2) ||
-                    searchForBytes(image, size, signature[1], 3, 2);
+    const bool f8 = hits.anyFound({ Sig::STA_1FF9, Sig::STA_FFF9 }, 2);
 
     if(isProbablySC(image, size))
       type = Bankswitch::Type::F8SC;
     else if(std::memcmp(image.get(), image.get() + 4_KB, 4_KB) == 0)
       type = Bankswitch::Type::_4K;
-    else if(isProbablyE0(image, size))
+    else if(isProbablyE0(hits))
       type = Bankswitch::Type::E0;
-    else if(isProbably3EX(image, size))
+    else if(isProbably3EX(hits))
       type = Bankswitch::Type::_3EX;
-    else if(isProbably3E(image, size))
+    else if(isProbably3E(hits))
       type = Bankswitch::Type::_3E;
-    else if(isProbably3F(image, size))
+    else if(isProbably3F(hits))
       type = Bankswitch::Type::_3F;
-    else if(isProbablyUA(image, size))
+    else if(isProbablyUA(hits))
       type = Bankswitch::Type::UA;
-    else if(isProbably0FA0(image, size))
+    else if(isProbably0FA0(hits))
       type = Bankswitch::Type::_0FA0;
-    else if(isProbablyFE(image, size) && !f8)
+    else if(isProbablyFE(hits) && !f8)
       type = Bankswitch::Type::FE;
-    else if(isProbably0840(image, size))
+    else if(isProbably0840(hits))
       type = Bankswitch::Type::_0840;
-    else if(isProbablyE78K(image, size))
+    else if(isProbablyE78K(hits))
       type = Bankswitch::Type::E7;
-    else if (isProbablyWD(image,size))
+    else if (isProbablyWD(hits))
       type = Bankswitch::Type::WD;
-    else if (isProbablyFC(image, size))
+    else if (isProbablyFC(hits))
       type = Bankswitch::Type::FC;
-    else if(isProbably03E0(image, size))
+    else if(isProbably03E0(hits))
       type = Bankswitch::Type::_03E0;
     else
       type = Bankswitch::Type::F8;
@@ -107,7 +410,7 @@ Bankswitch::Type CartDetector::autodetectType(const ByteBuffer& image, size_t si
   }
   else if(size == 12_KB)
   {
-    if(isProbablyE7(image, size))
+    if(isProbablyE7(hits))
       type = Bankswitch::Type::E7;
     else
       type = Bankswitch::Type::FA;
@@ -116,19 +419,19 @@ Bankswitch::Type CartDetector::autodetectType(const ByteBuffer& image, size_t si
   {
     if (isProbablySC(image, size))
       type = Bankswitch::Type::F6SC;
-    else if (isProbablyE7(image, size))
+    else if (isProbablyE7(hits))
       type = Bankswitch::Type::E7;
-    else if (isProbablyFC(image, size))
+    else if (isProbablyFC(hits))
       type = Bankswitch::Type::FC;
-    else if (isProbably3EX(image, size))
+    else if (isProbably3EX(hits))
       type = Bankswitch::Type::_3EX;
-    else if (isProbably3E(image, size))
+    else if (isProbably3E(hits))
       type = Bankswitch::Type::_3E;
   /* no known 16K 3F ROMS
-    else if(isProbably3F(image, size))
+    else if(isProbably3F(hits))
       type = Bankswitch::Type::3F;
   */
-    else if (isProbablyJANE(image, size))
+    else if (isProbablyJANE(hits))
       type = Bankswitch::Type::JANE;
     else
       type = Bankswitch::Type::F6;
@@ -141,119 +444,119 @@ Bankswitch::Type CartDetector::autodetectType(const ByteBuffer& image, size_t si
   {
     if(isProbablyARM(image, size))
       type = Bankswitch::Type::FA2;
-    else /*if(isProbablyDPCplus(image, size))*/
+    else /*if(isProbablyDPCplus(hits))*/
       type = Bankswitch::Type::DPCP;
   }
   else if(size == 32_KB)
   {
-    if (isProbablyCTY(image, size))
+    if (isProbablyCTY(hits))
       type = Bankswitch::Type::CTY;
-    else if(isProbablyCDF(image, size))
+    else if(isProbablyCDF(hits))
       type = Bankswitch::Type::CDF;
-    else if(isProbablyDPCplus(image, size))
+    else if(isProbablyDPCplus(hits))
       type = Bankswitch::Type::DPCP;
     else if(isProbablySC(image, size))
       type = Bankswitch::Type::F4SC;
-    else if(isProbably3EX(image, size))
+    else if(isProbably3EX(hits))
       type = Bankswitch::Type::_3EX;
-    else if(isProbably3E(image, size))
+    else if(isProbably3E(hits))
       type = Bankswitch::Type::_3E;
-    else if(isProbably3F(image, size))
+    else if(isProbably3F(hits))
       type = Bankswitch::Type::_3F;
-    else if (isProbablyBUS(image, size))
+    else if (isProbablyBUS(hits))
       type = Bankswitch::Type::BUS;
     else if(isProbablyFA2(image, size))
       type = Bankswitch::Type::FA2;
-    else if (isProbablyFC(image, size))
+    else if (isProbablyFC(hits))
       type = Bankswitch::Type::FC;
     else
       type = Bankswitch::Type::F4;
   }
   else if(size == 60_KB)
   {
-    if(isProbablyCTY(image, size))
+    if(isProbablyCTY(hits))
       type = Bankswitch::Type::CTY;
     else
       type = Bankswitch::Type::F4;
   }
   else if(size == 64_KB)
   {
-    if(isProbablyEFF(image, size))
+    if(isProbablyEFF(image, size, hits))
       type = Bankswitch::Type::EFF;
-    else if (isProbablyCDF(image, size))
+    else if (isProbablyCDF(hits))
       type = Bankswitch::Type::CDF;
-    else if(isProbably3EX(image, size))
+    else if(isProbably3EX(hits))
       type = Bankswitch::Type::_3EX;
-    else if(isProbably3E(image, size))
+    else if(isProbably3E(hits))
       type = Bankswitch::Type::_3E;
-    else if(isProbably3F(image, size))
+    else if(isProbably3F(hits))
       type = Bankswitch::Type::_3F;
     else if(isProbably4A50(image, size))
       type = Bankswitch::Type::_4A50;
-    else if(isProbablyEF(image, size, type))
+    else if(isProbablyEF(image, size, hits, type))
       ; // type has been set directly in the function
-    else if(isProbablyX07(image, size))
+    else if(isProbablyX07(hits))
       type = Bankswitch::Type::X07;
     else
       type = Bankswitch::Type::F0;
   }
   else if(size == 128_KB)
   {
-    if (isProbablyCDF(image, size))
+    if (isProbablyCDF(hits))
       type = Bankswitch::Type::CDF;
-    else if(isProbably3EX(image, size))
+    else if(isProbably3EX(hits))
       type = Bankswitch::Type::_3EX;
-    else if(isProbably3E(image, size))
+    else if(isProbably3E(hits))
       type = Bankswitch::Type::_3E;
     else if(isProbablyDF(image, size, type))
       ; // type has been set directly in the function
-    else if(isProbably3F(image, size))
+    else if(isProbably3F(hits))
       type = Bankswitch::Type::_3F;
     else if(isProbably4A50(image, size))
       type = Bankswitch::Type::_4A50;
-    else /*if(isProbablySB(image, size))*/
+    else /*if(isProbablySB(hits))*/
       type = Bankswitch::Type::SB;
   }
   else if(size == 256_KB)
   {
-    if (isProbablyCDF(image, size))
+    if (isProbablyCDF(hits))
       type = Bankswitch::Type::CDF;
-    else if(isProbably3EX(image, size))
+    else if(isProbably3EX(hits))
       type = Bankswitch::Type::_3EX;
-    else if(isProbably3E(image, size))
+    else if(isProbably3E(hits))
       type = Bankswitch::Type::_3E;
     else if(isProbablyBF(image, size, type))
       ; // type has been set directly in the function
-    else if(isProbably3F(image, size))
+    else if(isProbably3F(hits))
       type = Bankswitch::Type::_3F;
-    else /*if(isProbablySB(image, size))*/
+    else /*if(isProbablySB(hits))*/
       type = Bankswitch::Type::SB;
   }
   else if(size == 512_KB)
   {
-    if(isProbablyTVBoy(image, size))
+    if(isProbablyTVBoy(hits))
       type = Bankswitch::Type::TVBOY;
-    else if (isProbablyCDF(image, size))
+    else if (isProbablyCDF(hits))
       type = Bankswitch::Type::CDF;
-    else if(isProbably3EX(image, size))
+    else if(isProbably3EX(hits))
       type = Bankswitch::Type::_3EX;
-    else if(isProbably3E(image, size))
+    else if(isProbably3E(hits))
       type = Bankswitch::Type::_3E;
-    else if(isProbably3F(image, size))
+    else if(isProbably3F(hits))
       type = Bankswitch::Type::_3F;
   }
   else  // what else can we do?
   {
-    if(isProbably3EX(image, size))
+    if(isProbably3EX(hits))
       type = Bankswitch::Type::_3EX;
-    else if(isProbably3E(image, size))
+    else if(isProbably3E(hits))
       type = Bankswitch::Type::_3E;
-    else if(isProbably3F(image, size))
+    else if(isProbably3F(hits))
       type = Bankswitch::Type::_3F;
   }
 
   // Variable sized ROM formats are independent of image size and come last
-  if(isProbably3EPlus(image, size))
+  if(isProbably3EPlus(hits))
     type = Bankswitch::Type::_3EP;
   else if(isProbablyMDM(image, size))
     type = Bankswitch::Type::MDM;
@@ -331,100 +634,65 @@ bool CartDetector::isProbablyARM(const ByteBuffer& image, size_t size)
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool CartDetector::isProbably03E0(const ByteBuffer& image, size_t size)
+bool CartDetector::isProbably03E0(const SignatureHits& hits)
 {
   // 03E0 cart bankswitching for Brazilian Parker Bros ROMs, switches segment
   // 0 into bank 0 by accessing address 0x3E0 using 'LDA $3E0' or 'ORA $3E0'.
-  static constexpr uInt8 signature[2][4] = {
-    { 0x0D, 0xE0, 0x03, 0x0D },  // ORA $3E0, ORA (Popeye)
-    { 0xAD, 0xE0, 0x03, 0xAD }   // LDA $3E0, ORA (Montezuma's Revenge)
-  };
-  return std::ranges::any_of(signature, [&](const auto* sig) {
-    return searchForBytes(image, size, sig, 4);
-  });
+  return hits.anyFound({ Sig::ORA_03E0_ORA, Sig::LDA_03E0_ORA });
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool CartDetector::isProbably0840(const ByteBuffer& image, size_t size)
+bool CartDetector::isProbably0840(const SignatureHits& hits)
 {
   // 0840 cart bankswitching is triggered by accessing addresses 0x0800
   // or 0x0840 at least twice
-  static constexpr uInt8 signature1[3][3] = {
-    { 0xAD, 0x00, 0x08 },  // LDA $0800
-    { 0xAD, 0x40, 0x08 },  // LDA $0840
-    { 0x2C, 0x00, 0x08 }   // BIT $0800
-  };
-  if(std::ranges::any_of(signature1, [&](const auto* sig) {
-    return searchForBytes(image, size, sig, 3, 2);
-  }))
-    return true;
-
-  static constexpr uInt8 signature2[2][4] = {
-    { 0x0C, 0x00, 0x08, 0x4C },  // NOP $0800; JMP ...
-    { 0x0C, 0xFF, 0x0F, 0x4C }   // NOP $0FFF; JMP ...
-  };
-  return std::ranges::any_of(signature2, [&](const auto* sig) {
-    return searchForBytes(image, size, sig, 4, 2);
-  });
+  return hits.anyFound({ Sig::LDA_0800, Sig::LDA_0840, Sig::BIT_0800 }, 2) ||
+         hits.anyFound({ Sig::NOP_0800_JMP, Sig::NOP_0FFF_JMP }, 2);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool CartDetector::isProbably0FA0(const ByteBuffer& image, size_t size)
+bool CartDetector::isProbably0FA0(const SignatureHits& hits)
 {
   // Other Brazilian (Fotomania) ROM's bankswitching switches to bank 1 by
   // accessing address 0xFC0 using 'BIT $FC0', 'BIT $FC0' or 'STA $FC0'
   // Also a game (Motocross) using 'BIT $EFC0' has been found
-  static constexpr uInt8 signature[4][3] = {
-    { 0x2C, 0xC0, 0x0F },  // BIT $FC0  (H.E.R.O., Kung-Fu Master)
-    { 0x8D, 0xC0, 0x0F },  // STA $FC0  (Pole Position, Subterranea)
-    { 0xAD, 0xC0, 0x0F },  // LDA $FC0  (Front Line, Zaxxon)
-    { 0x2C, 0xC0, 0xEF }   // BIT $EFC0 (Motocross)
-  };
-  return std::ranges::any_of(signature, [&](const auto* sig) {
-    return searchForBytes(image, size, sig, 3);
-  });
+  return hits.anyFound({ Sig::BIT_0FC0, Sig::STA_0FC0, Sig::LDA_0FC0,
+                         Sig::BIT_EFC0 });
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool CartDetector::isProbably3E(const ByteBuffer& image, size_t size)
+bool CartDetector::isProbably3E(const SignatureHits& hits)
 {
   // 3E cart RAM bankswitching is triggered by storing the bank number
   // in address 3E using 'STA $3E', ROM bankswitching is triggered by
   // storing the bank number in address 3F using 'STA $3F'.
   // We expect the latter will be present at least 2 times, since there
   // are at least two banks
-
-  static constexpr uInt8 signature1[] = { 0x85, 0x3E };  // STA $3E
-  static constexpr uInt8 signature2[] = { 0x85, 0x3F };  // STA $3F
-  return searchForBytes(image, size, signature1, 2) &&
-         searchForBytes(image, size, signature2, 2, 2);
+  return hits.found(Sig::STA_3E) && hits.found(Sig::STA_3F, 2);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool CartDetector::isProbably3EX(const ByteBuffer& image, size_t size)
+bool CartDetector::isProbably3EX(const SignatureHits& hits)
 {
   // 3EX cart have at least 2 occurrences of the string "3EX"
-  static constexpr uInt8 _3EX[] = { '3', 'E', 'X' };
-  return searchForBytes(image, size, _3EX, 3, 2);
+  return hits.found(Sig::TXT_3EX, 2);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool CartDetector::isProbably3EPlus(const ByteBuffer& image, size_t size)
+bool CartDetector::isProbably3EPlus(const SignatureHits& hits)
 {
   // 3E+ cart is identified key 'TJ3E' in the ROM
-  static constexpr uInt8 tj3e[] = { 'T', 'J', '3', 'E' };
-  return searchForBytes(image, size, tj3e, 4);
+  return hits.found(Sig::TXT_TJ3E);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool CartDetector::isProbably3F(const ByteBuffer& image, size_t size)
+bool CartDetector::isProbably3F(const SignatureHits& hits)
 {
   // 3F cart bankswitching is triggered by storing the bank number
   // in address 3F using 'STA $3F'
   // We expect it will be present at least 2 times, since there are
   // at least two banks
-  static constexpr uInt8 signature[] = { 0x85, 0x3F };  // STA $3F
-  return searchForBytes(image, size, signature, 2, 2);
+  return hits.found(Sig::STA_3F, 2);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -481,47 +749,34 @@ bool CartDetector::isProbablyBF(const ByteBuffer& image, size_t size,
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool CartDetector::isProbablyBUS(const ByteBuffer& image, size_t size)
+bool CartDetector::isProbablyBUS(const SignatureHits& hits)
 {
   // BUS ARM code has 2 occurrences of the string BUS
   // Note: all Harmony/Melody custom drivers also contain the value
   // 0x10adab1e (LOADABLE) if needed for future improvement
-  static constexpr uInt8 bus[] = { 'B', 'U', 'S' };
-  return searchForBytes(image, size, bus, 3, 2);
+  return hits.found(Sig::TXT_BUS, 2);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool CartDetector::isProbablyCDF(const ByteBuffer& image, size_t size)
+bool CartDetector::isProbablyCDF(const SignatureHits& hits)
 {
   // CDF ARM code has 3 occurrences of the string CDF
   // Note: all Harmony/Melody custom drivers also contain the value
   // 0x10adab1e (LOADABLE) if needed for future improvement
-  static constexpr uInt8 cdf[] = { 'C', 'D', 'F' };
-  static constexpr uInt8 cdfjplus[] = { 'P', 'L', 'U', 'S', 'C', 'D', 'F', 'J' };
-  return (searchForBytes(image, size, cdf, 3, 3) ||
-          searchForBytes(image, size, cdfjplus, 8, 1));
+  return hits.found(Sig::TXT_CDF, 3) || hits.found(Sig::TXT_PLUSCDFJ);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool CartDetector::isProbablyCTY(const ByteBuffer& image, size_t size)
+bool CartDetector::isProbablyCTY(const SignatureHits& hits)
 {
-  static constexpr uInt8 lenin[] = { 'L', 'E', 'N', 'I', 'N' };
-  return searchForBytes(image, size, lenin, 5);
+  return hits.found(Sig::TXT_LENIN);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool CartDetector::isProbablyCV(const ByteBuffer& image, size_t size)
+bool CartDetector::isProbablyCV(const SignatureHits& hits)
 {
   // CV RAM access occurs at addresses $f3ff and $f400
-  // These signatures are attributed to the MESS project
-  static constexpr uInt8 signature[2][3] = {
-    { 0x9D, 0xFF, 0xF3 },  // STA $F3FF,X  MagiCard
-    { 0x99, 0x00, 0xF4 }   // STA $F400,Y  Video Life
-  };
-  if(searchForBytes(image, size, signature[0], 3))
-    return true;
-  else
-    return searchForBytes(image, size, signature[1], 3);
+  return hits.anyFound({ Sig::STA_F3FF_X, Sig::STA_F400_Y });
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -548,81 +803,53 @@ bool CartDetector::isProbablyDF(const ByteBuffer& image, size_t size,
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool CartDetector::isProbablyDPCplus(const ByteBuffer& image, size_t size)
+bool CartDetector::isProbablyDPCplus(const SignatureHits& hits)
 {
   // DPC+ ARM code has 2 occurrences of the string DPC+
   // Note: all Harmony/Melody custom drivers also contain the value
   // 0x10adab1e (LOADABLE) if needed for future improvement
-  static constexpr uInt8 dpcp[] = { 'D', 'P', 'C', '+' };
-  return searchForBytes(image, size, dpcp, 4, 2);
+  return hits.found(Sig::TXT_DPCP, 2);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool CartDetector::isProbablyE0(const ByteBuffer& image, size_t size)
+bool CartDetector::isProbablyE0(const SignatureHits& hits)
 {
   // E0 cart bankswitching is triggered by accessing addresses
   // $FE0 to $FF9 using absolute non-indexed addressing
   // To eliminate false positives (and speed up processing), we
   // search for only certain known signatures
   // Thanks to "stella@casperkitty.com" for this advice
-  // These signatures are attributed to the MESS project
-  static constexpr uInt8 signature[8][3] = {
-    { 0x8D, 0xE0, 0x1F },  // STA $1FE0
-    { 0x8D, 0xE0, 0x5F },  // STA $5FE0
-    { 0x8D, 0xE9, 0xFF },  // STA $FFE9
-    { 0x0C, 0xE0, 0x1F },  // NOP $1FE0
-    { 0xAD, 0xE0, 0x1F },  // LDA $1FE0
-    { 0xAD, 0xE9, 0xFF },  // LDA $FFE9
-    { 0xAD, 0xED, 0xFF },  // LDA $FFED
-    { 0xAD, 0xF3, 0xBF }   // LDA $BFF3
-  };
-  return std::ranges::any_of(signature, [&](const auto* sig) {
-    return searchForBytes(image, size, sig, 3);
-  });
+  return hits.anyFound({ Sig::STA_1FE0, Sig::STA_5FE0, Sig::STA_FFE9,
+                         Sig::NOP_1FE0, Sig::LDA_1FE0, Sig::LDA_FFE9,
+                         Sig::LDA_FFED, Sig::LDA_BFF3 });
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool CartDetector::isProbablyE7(const ByteBuffer& image, size_t size)
+bool CartDetector::isProbablyE7(const SignatureHits& hits)
 {
   // E7 cart bankswitching is triggered by accessing addresses
   // $FE0 to $FE6 using absolute non-indexed addressing
   // To eliminate false positives (and speed up processing), we
   // search for only certain known signatures
   // Thanks to "stella@casperkitty.com" for this advice
-  // These signatures are attributed to the MESS project
-  static constexpr uInt8 signature[7][3] = {
-    { 0xAD, 0xE2, 0xFF },  // LDA $FFE2
-    { 0xAD, 0xE5, 0xFF },  // LDA $FFE5
-    { 0xAD, 0xE5, 0x1F },  // LDA $1FE5
-    { 0xAD, 0xE7, 0x1F },  // LDA $1FE7
-    { 0x0C, 0xE7, 0x1F },  // NOP $1FE7
-    { 0x8D, 0xE7, 0xFF },  // STA $FFE7
-    { 0x8D, 0xE7, 0x1F }   // STA $1FE7
-  };
-  return std::ranges::any_of(signature, [&](const auto* sig) {
-    return searchForBytes(image, size, sig, 3);
-  });
+  return hits.anyFound({ Sig::LDA_FFE2, Sig::LDA_FFE5, Sig::LDA_1FE5,
+                         Sig::LDA_1FE7, Sig::NOP_1FE7, Sig::STA_FFE7,
+                         Sig::STA_1FE7 });
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool CartDetector::isProbablyE78K(const ByteBuffer& image, size_t size)
+bool CartDetector::isProbablyE78K(const SignatureHits& hits)
 {
   // E78K cart bankswitching is triggered by accessing addresses
   // $FE4 to $FE6 using absolute non-indexed addressing
   // To eliminate false positives (and speed up processing), we
   // search for only certain known signatures
-  static constexpr uInt8 signature[3][3] = {
-    { 0xAD, 0xE4, 0xFF },  // LDA $FFE4
-    { 0xAD, 0xE5, 0xFF },  // LDA $FFE5
-    { 0xAD, 0xE6, 0xFF },  // LDA $FFE6
-  };
-  return std::ranges::any_of(signature, [&](const auto* sig) {
-    return searchForBytes(image, size, sig, 3);
-  });
+  return hits.anyFound({ Sig::LDA_FFE4, Sig::LDA_FFE5, Sig::LDA_FFE6 });
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool CartDetector::isProbablyEF(const ByteBuffer& image, size_t size,
+                                const SignatureHits& hits,
                                 Bankswitch::Type& type)
 {
   // Newer EF carts store strings 'EFEF' and 'EFSC' starting at address $FFF8
@@ -643,15 +870,8 @@ bool CartDetector::isProbablyEF(const ByteBuffer& image, size_t size,
   // Otherwise, EF cart bankswitching switches banks by accessing addresses
   // 0xFE0 to 0xFEF, usually with either a NOP or LDA
   // It's likely that the code will switch to bank 0, so that's what is tested
-  static constexpr uInt8 signature[4][3] = {
-    { 0x0C, 0xE0, 0xFF },  // NOP $FFE0
-    { 0xAD, 0xE0, 0xFF },  // LDA $FFE0
-    { 0x0C, 0xE0, 0x1F },  // NOP $1FE0
-    { 0xAD, 0xE0, 0x1F }   // LDA $1FE0
-  };
-  const bool isEF = std::ranges::any_of(signature, [&](const auto* sig) {
-    return searchForBytes(image, size, sig, 3);
-  });
+  const bool isEF = hits.anyFound({ Sig::NOP_FFE0, Sig::LDA_FFE0,
+                                    Sig::NOP_1FE0, Sig::LDA_1FE0 });
 
   // Now that we know that the ROM is EF, we need to check if it's
   // the SC variant
@@ -665,7 +885,8 @@ bool CartDetector::isProbablyEF(const ByteBuffer& image, size_t size,
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool CartDetector::isProbablyEFF(const ByteBuffer& image, size_t size)
+bool CartDetector::isProbablyEFF(const ByteBuffer& image, size_t size,
+                                 const SignatureHits& hits)
 {
   static constexpr uInt8 effb[] = { 'E', 'F', 'F', 'B' };
   if(searchForBytes(image.get()+size-8, 8, effb, 4))
@@ -675,14 +896,7 @@ bool CartDetector::isProbablyEFF(const ByteBuffer& image, size_t size)
   // addresses 0xFE0 to 0xFEF, usually with a NOP, as well as the 0xFF0
   // to 0xFF3 for save-to-cart and read from 0xFF4 (for the EEPROM).
   // Unlike EF, we require to find all three.
-  static constexpr uInt8 signature[3][3] = {
-    { 0x0C, 0xE0, 0xFF },  // NOP $FFE0
-    { 0x0C, 0xF0, 0x1F },  // NOP $1FF0
-    { 0xAD, 0xF4, 0x1F }   // LDA $1FF4
-  };
-  return std::ranges::all_of(signature, [&](const auto* sig) {
-    return searchForBytes(image, size, sig, 3);
-  });
+  return hits.allFound({ Sig::NOP_FFE0, Sig::NOP_1FF0, Sig::LDA_1FF4 });
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -701,49 +915,33 @@ bool CartDetector::isProbablyFA2(const ByteBuffer& image, size_t)
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool CartDetector::isProbablyFC(const ByteBuffer& image, size_t size)
+bool CartDetector::isProbablyFC(const SignatureHits& hits)
 {
   // FC bankswitching uses consecutive writes to 3 hotspots
-  static constexpr uInt8 signature[3][6] = {
-    { 0x8d, 0xf8, 0x1f, 0x4a, 0x4a, 0x8d }, // STA $1FF8, LSR, LSR, STA... Power Play Arcade Menus, 3-D Ghost Attack
-    { 0x8d, 0xf8, 0xff, 0x8d, 0xfc, 0xff }, // STA $FFF8, STA $FFFC        Surf's Up (4K)
-    { 0x8c, 0xf9, 0xff, 0xad, 0xfc, 0xff }  // STY $FFF9, LDA $FFFC        3-D Havoc
-  };
-  return std::ranges::any_of(signature, [&](const auto* sig) {
-    return searchForBytes(image, size, sig, 6);
-  });
+  return hits.anyFound({ Sig::STA_1FF8_LSR, Sig::STA_FFF8_STA,
+                         Sig::STY_FFF9_LDA });
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool CartDetector::isProbablyFE(const ByteBuffer& image, size_t size)
+bool CartDetector::isProbablyFE(const SignatureHits& hits)
 {
   // FE bankswitching is very weird, but always seems to include a
   // 'JSR $xxxx'
-  // These signatures are (mostly) attributed to the MESS project
-  static constexpr uInt8 signature[5][5] = {
-    { 0x20, 0x00, 0xD0, 0xC6, 0xC5 },  // JSR $D000; DEC $C5  Decathlon
-    { 0x20, 0xC3, 0xF8, 0xA5, 0x82 },  // JSR $F8C3; LDA $82  Robot Tank
-    { 0xD0, 0xFB, 0x20, 0x73, 0xFE },  // BNE $FB; JSR $FE73  Space Shuttle (NTSC/PAL)
-    { 0xD0, 0xFB, 0x20, 0x68, 0xFE },  // BNE $FB; JSR $FE73  Space Shuttle (SECAM)
-    { 0x20, 0x00, 0xF0, 0x84, 0xD6 }   // JSR $F000; $84, $D6 Thwocker
-  };
-  return std::ranges::any_of(signature, [&](const auto* sig) {
-    return searchForBytes(image, size, sig, 5);
-  });
+  return hits.anyFound({ Sig::JSR_D000_DEC, Sig::JSR_F8C3_LDA,
+                         Sig::BNE_JSR_FE73, Sig::BNE_JSR_FE68,
+                         Sig::JSR_F000_STY });
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool CartDetector::isProbablyJANE(const ByteBuffer& image, size_t size)
+bool CartDetector::isProbablyJANE(const SignatureHits& hits)
 {
-  static constexpr uInt8 signature[] = { 0xad, 0xf1, 0xff, 0x60 };  // LDA $0CB8
-  return searchForBytes(image, size, signature, sizeof(signature));
+  return hits.found(Sig::LDA_FFF1_RTS);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool CartDetector::isProbablyGL(const ByteBuffer& image, size_t size)
+bool CartDetector::isProbablyGL(const SignatureHits& hits)
 {
-  static constexpr uInt8 signature[] = { 0xad, 0xb8, 0x0c };  // LDA $0CB8
-  return searchForBytes(image, size, signature, 3);
+  return hits.found(Sig::LDA_0CB8);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -790,71 +988,43 @@ size_t CartDetector::isProbablyMVC(const FSNode& rom)
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool CartDetector::isProbablySB(const ByteBuffer& image, size_t size)
+bool CartDetector::isProbablySB(const SignatureHits& hits)
 {
   // SB cart bankswitching switches banks by accessing address 0x0800
-  static constexpr uInt8 signature[2][3] = {
-    { 0xBD, 0x00, 0x08 },  // LDA $0800,x
-    { 0xAD, 0x00, 0x08 }   // LDA $0800
-  };
-  return std::ranges::any_of(signature, [&](const auto* sig) {
-    return searchForBytes(image, size, sig, 3);
-  });
+  return hits.anyFound({ Sig::LDA_0800_X, Sig::LDA_0800 });
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool CartDetector::isProbablyTVBoy(const ByteBuffer& image, size_t size)
+bool CartDetector::isProbablyTVBoy(const SignatureHits& hits)
 {
   // TV Boy cart bankswitching switches banks by accessing addresses 0x1800..$187F
-  static constexpr uInt8 signature[5] = { 0x91, 0x82, 0x6c, 0xfc, 0xff };  // STA ($82),Y; JMP ($FFFC)
-  return searchForBytes(image, size, signature, 5);
+  return hits.found(Sig::STA_82_Y_JMP);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool CartDetector::isProbablyUA(const ByteBuffer& image, size_t size)
+bool CartDetector::isProbablyUA(const SignatureHits& hits)
 {
   // UA cart bankswitching switches to bank 1 by accessing address 0x240
   // using 'STA $240' or 'LDA $240'.
   // Brazilian (Digivison) cart bankswitching switches to bank 1 by accessing address 0x2C0
   // using 'BIT $2C0', 'STA $2C0' or 'LDA $2C0'
-  static constexpr uInt8 signature[6][3] = {
-    { 0x8D, 0x40, 0x02 },  // STA $240 (Funky Fish, Pleiades)
-    { 0xAD, 0x40, 0x02 },  // LDA $240 (???)
-    { 0xBD, 0x1F, 0x02 },  // LDA $21F,X (Gingerbread Man)
-    { 0x2C, 0xC0, 0x02 },  // BIT $2C0 (Time Pilot)
-    { 0x8D, 0xC0, 0x02 },  // STA $2C0 (Fathom, Vanguard)
-    { 0xAD, 0xC0, 0x02 },  // LDA $2C0 (Mickey)
-  };
-  return std::ranges::any_of(signature, [&](const auto* sig) {
-    return searchForBytes(image, size, sig, 3);
-  });
+  return hits.anyFound({ Sig::STA_0240, Sig::LDA_0240, Sig::LDA_021F_X,
+                         Sig::BIT_02C0, Sig::STA_02C0, Sig::LDA_02C0 });
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool CartDetector::isProbablyWD(const ByteBuffer& image, size_t size)
+bool CartDetector::isProbablyWD(const SignatureHits& hits)
 {
   // WD cart bankswitching switches banks by accessing address 0x30..0x3f
-  static constexpr uInt8 signature[1][3] = {
-    { 0xA5, 0x39, 0x4C }  // LDA $39, JMP
-  };
-  return searchForBytes(image, size, signature[0], 3);
+  return hits.found(Sig::LDA_39_JMP);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool CartDetector::isProbablyX07(const ByteBuffer& image, size_t size)
+bool CartDetector::isProbablyX07(const SignatureHits& hits)
 {
   // X07 bankswitching switches to bank 0, 1, 2, etc by accessing address 0x08xd
-  static constexpr uInt8 signature[6][3] = {
-    { 0xAD, 0x0D, 0x08 },  // LDA $080D
-    { 0xAD, 0x1D, 0x08 },  // LDA $081D
-    { 0xAD, 0x2D, 0x08 },  // LDA $082D
-    { 0x0C, 0x0D, 0x08 },  // NOP $080D
-    { 0x0C, 0x1D, 0x08 },  // NOP $081D
-    { 0x0C, 0x2D, 0x08 }   // NOP $082D
-  };
-  return std::ranges::any_of(signature, [&](const auto* sig) {
-    return searchForBytes(image, size, sig, 3);
-  });
+  return hits.anyFound({ Sig::LDA_080D, Sig::LDA_081D, Sig::LDA_082D,
+                         Sig::NOP_080D, Sig::NOP_081D, Sig::NOP_082D });
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -31,7 +31,7 @@ CartridgeE7::CartridgeE7(const ByteBuffer& image, size_t size,
 void CartridgeE7::initialize(const ByteBuffer& image, size_t size)
 {
   // Allocate array for the ROM image
-  myImage = std::make_unique<uInt8[]>(size);
+  myImage = allocateBuffer(size);
 
   // Copy the ROM image into my buffer
   std::copy_n(image.get(), std::min<size_t>(romSize(), size), myImage.get());
@@ -82,9 +82,9 @@ void CartridgeE7::setAccess(uInt16 addrFrom, uInt16 size,
       access.directPeekBase = &directData[directOffset + (addr & addrMask)];
     else if(type == System::PageAccessType::WRITE)  // all RAM writes mapped to ::poke()
       access.directPokeBase = nullptr;
-    access.romAccessBase = &myRomAccessBase[codeOffset + (addr & addrMask)];
-    access.romPeekCounter = &myRomAccessCounter[codeOffset + (addr & addrMask)];
-    access.romPokeCounter = &myRomAccessCounter[codeOffset + (addr & addrMask) + myAccessSize];
+    access.romAccessBase = romAccessBase(codeOffset + (addr & addrMask));
+    access.romPeekCounter = romPeekCounter(codeOffset + (addr & addrMask));
+    access.romPokeCounter = romPokeCounter(codeOffset + (addr & addrMask));
     mySystem->setPageAccess(addr, access);
   }
 }
@@ -100,9 +100,9 @@ void CartridgeE7::install(System& system)
   for(uInt16 addr = (0x1FE0 & ~System::PAGE_MASK); addr < 0x2000;
       addr += System::PAGE_SIZE)
   {
-    access.romAccessBase = &myRomAccessBase[0x1fc0];
-    access.romPeekCounter = &myRomAccessCounter[0x1fc0];
-    access.romPokeCounter = &myRomAccessCounter[0x1fc0 + myAccessSize];
+    access.romAccessBase = romAccessBase(0x1fc0);
+    access.romPeekCounter = romPeekCounter(0x1fc0);
+    access.romPokeCounter = romPokeCounter(0x1fc0);
     mySystem->setPageAccess(addr, access);
   }
   /*setAccess(0x1FE0 & ~System::PAGE_MASK, System::PAGE_SIZE,
@@ -128,6 +128,11 @@ class CartridgeE7 : public Cartridge
     */
     uInt16 segmentCount() const override { return NUM_SEGMENTS; }
 
+    /**
+      Get the RAM on the cart, for direct access by external tools.
+    */
+    RamAreaList ramAreas() override { return {{myRAM, std::nullopt}}; }
+
     /**
       Patch the cartridge ROM.
 
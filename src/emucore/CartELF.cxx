@@ -15,6 +15,7 @@
 // this file, and for a DISCLAIMER OF ALL WARRANTIES.
 //============================================================================
 
+#include <iomanip>
 #include <sstream>
 
 #include "FSNode.hxx"
@@ -29,6 +30,7 @@
 #ifdef DEBUGGER_SUPPORT
   #include "CartELFWidget.hxx"
   #include "CartELFStateWidget.hxx"
+  #include "TIA.hxx"
 #endif
 
 #include "CartELF.hxx"
@@ -229,8 +231,10 @@ CartridgeELF::CartridgeELF(const ByteBuffer& image, size_t size, string_view md5
     myTransactionQueue{TRANSACTION_QUEUE_CAPACITY},
     myVcsLib{myTransactionQueue}
 {
-  myImage = std::make_unique<uInt8[]>(size);
-  std::memcpy(myImage.get(), image.get(), size);
+  // The image is never modified, so it is shared by all consoles running it
+  myImage = sharedBuffer("ELF image", size, [&image, size](uInt8* data) {
+    std::memcpy(data, image.get(), size);
+  });
 
   myLastPeekResult = std::make_unique<uInt8[]>(0x1000);
   std::fill_n(myLastPeekResult.get(), 0x1000, 0);
@@ -255,8 +259,8 @@ void CartridgeELF::install(System& system)
 
   for (uInt16 addr = 0; addr < 0x1000; addr += System::PAGE_SIZE) {
     System::PageAccess access(this, System::PageAccessType::READ);
-    access.romPeekCounter = &myRomAccessCounter[addr];
-    access.romPokeCounter = &myRomAccessCounter[addr];
+    access.romPeekCounter = romPeekCounter(addr);
+    access.romPokeCounter = romPeekCounter(addr);
 
     mySystem->setPageAccess(0x1000 + addr, access);
   }
@@ -326,6 +330,18 @@ bool CartridgeELF::load(Serializer& in)
   return true;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+size_t CartridgeELF::memoryUsage() const
+{
+  size_t bytes = Cartridge::memoryUsage() + myImageSize + 0x1000;
+
+  // The sections of the linked ELF image
+  if(mySectionStack)
+    bytes += STACK_SIZE + TEXT_SIZE + DATA_SIZE + RODATA_SIZE + TABLES_SIZE;
+
+  return bytes;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 uInt8 CartridgeELF::peek(uInt16 address)
 {
@@ -358,6 +374,16 @@ const ByteBuffer& CartridgeELF::getImage(size_t& size) const
   return myImage;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+Cartridge::RamAreaList CartridgeELF::ramAreas()
+{
+  // Only stack and data are writable, the other sections are code or constant
+  return {
+    {std::span{mySectionStack.get(), STACK_SIZE}, ADDR_STACK_BASE},
+    {std::span{mySectionData.get(), DATA_SIZE}, ADDR_DATA_BASE}
+  };
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 uInt8 CartridgeELF::overdrivePeek(uInt16 address, uInt8 value)
 {
@@ -392,6 +418,42 @@ CartDebugWidget* CartridgeELF::infoWidget(
   return new CartridgeELFWidget(boss, lfont, nfont, x, y, w, h, *this);
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool CartridgeELF::enableArmProfiler(bool enable)
+{
+  if (enable && !myArmProfiler) {
+    myArmProfiler = std::make_unique<ArmProfiler>();
+
+    const auto& symbols = myElfParser.getSymbols();
+    const auto& relocatedSymbols = myLinker->getRelocatedSymbols();
+
+    for (size_t i = 0; i < symbols.size(); i++) {
+      if (
+        symbols[i].type != ElfFile::STT_FUNC || !relocatedSymbols[i] ||
+        relocatedSymbols[i]->segment != ElfLinker::SegmentType::text
+      ) continue;
+
+      myArmProfiler->addFunction(
+        symbols[i].name, relocatedSymbols[i]->value & ~1U, symbols[i].size);
+    }
+
+    // vcslib functions are stubs, which are named by the external symbols
+    for (const auto& symbol: externalSymbols(SystemType::ntsc)) {
+      if (symbol.value >= ADDR_STUB_BASE && symbol.value < ADDR_STUB_BASE + STUB_SIZE)
+        myArmProfiler->addFunction(symbol.name, symbol.value & ~1U, 0);
+    }
+
+    // Code without symbols (e.g. stripped binaries)
+    myArmProfiler->addRange("text", ADDR_TEXT_BASE, ADDR_TEXT_BASE + TEXT_SIZE - 1);
+  }
+  else if (!enable)
+    myArmProfiler.reset();
+
+  myCortexEmu.setProfiler(myArmProfiler.get());
+
+  return true;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 string CartridgeELF::getDebugLog() const
 {
@@ -411,10 +473,10 @@ string CartridgeELF::getDebugLog() const
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-std::pair<unique_ptr<uInt8[]>, size_t> CartridgeELF::getArmImage() const
+std::pair<ByteBuffer, size_t> CartridgeELF::getArmImage() const
 {
   constexpr size_t imageSize = ADDR_TABLES_BASE + TABLES_SIZE;
-  unique_ptr<uInt8[]> image = std::make_unique<uInt8[]>(imageSize);
+  ByteBuffer image = std::make_unique<uInt8[]>(imageSize);
 
   memset(image.get(), 0, imageSize);
 
@@ -431,11 +493,15 @@ std::pair<unique_ptr<uInt8[]>, size_t> CartridgeELF::getArmImage() const
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 inline uInt8 CartridgeELF::driveBus(uInt16 address, uInt8 value)
 {
-  const auto* nextTransaction = myTransactionQueue.getNextTransaction(address,
-    mySystem->cycles() * myArmCyclesPer6502Cycle - myArmCyclesOffset);
-  if (nextTransaction) {
-    nextTransaction->setBusState(myIsBusDriven, myDriveBusValue);
-    syncArmTime(nextTransaction->timestamp);
+  const uInt64 armCycles = mySystem->cycles() * myArmCyclesPer6502Cycle - myArmCyclesOffset;
+
+  // Most accesses happen while no transaction is due yet
+  if (myTransactionQueue.hasTransactionDue(armCycles)) {
+    const auto* nextTransaction = myTransactionQueue.getNextTransaction(address, armCycles);
+    if (nextTransaction) {
+      nextTransaction->setBusState(myIsBusDriven, myDriveBusValue);
+      syncArmTime(nextTransaction->timestamp);
+    }
   }
 
   if (myIsBusDriven) value |= myDriveBusValue;
@@ -618,6 +684,11 @@ void CartridgeELF::runArm()
 
   const CortexM0::err_t err = myCortexEmu.run(cyclesGoal, cycles);
 
+#ifdef DEBUGGER_SUPPORT
+  if (myArmProfiler) myArmProfiler->endRun(cycles);
+  if (mySystem->tia().lineBudgetEnabled()) mySystem->tia().recordArmTime(cycles);
+#endif
+
   if (err) {
     if (CortexM0::getErrCustom(err) == ERR_RETURN) {
       if (myExecutionStage == ExecutionStage::main) {
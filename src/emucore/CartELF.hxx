@@ -30,6 +30,8 @@
 class ElfLinker;
 
 #ifdef DEBUGGER_SUPPORT
+  #include "ArmProfiler.hxx"
+
   class CartridgeELFWidget;
   class CartridgeELFStateWidget;
 #endif
@@ -60,6 +62,8 @@ class CartridgeELF: public Cartridge {
 
     bool load(Serializer& in) override;
 
+    size_t memoryUsage() const override;
+
     uInt8 peek(uInt16 address) override;
     uInt8 peekOob(uInt16 address) override;
 
@@ -83,6 +87,8 @@ class CartridgeELF: public Cartridge {
 
     bool doesBusStuffing() override { return true; }
 
+    RamAreaList ramAreas() override;
+
 #ifdef DEBUGGER_SUPPORT
     CartDebugWidget* debugWidget(
       GuiObject* boss, const GUI::Font& lfont, const GUI::Font& nfont, int x, int y, int w, int h
@@ -91,12 +97,15 @@ class CartridgeELF: public Cartridge {
     CartDebugWidget* infoWidget(
       GuiObject* boss, const GUI::Font& lfont, const GUI::Font& nfont, int x, int y, int w, int h
     ) override;
+
+    bool enableArmProfiler(bool enable) override;
+    ArmProfiler* armProfiler() override { return myArmProfiler.get(); }
 #endif
 
   public:
     string getDebugLog() const;
 
-    std::pair<unique_ptr<uInt8[]>, size_t> getArmImage() const;
+    std::pair<ByteBuffer, size_t> getArmImage() const;
 
   private:
     class BusFallbackDelegate: public CortexM0::BusTransactionDelegate {
@@ -185,6 +194,10 @@ class CartridgeELF: public Cartridge {
     ExecutionStage myExecutionStage{ExecutionStage::boot};
     uInt32 myInitFunctionIndex{0};
 
+#ifdef DEBUGGER_SUPPORT
+    unique_ptr<ArmProfiler> myArmProfiler;
+#endif
+
   private:
     // Following constructors and assignment operators not supported
     CartridgeELF(const CartridgeELF&) = delete;
@@ -48,7 +48,7 @@ CartridgeEnhanced::CartridgeEnhanced(const ByteBuffer& image, size_t size,
   mySize = bsSize;
 
   // Initialize ROM with all 0's, to fill areas that the ROM may not cover
-  myImage = std::make_unique<uInt8[]>(mySize);
+  myImage = allocateBuffer(mySize);
   std::fill_n(myImage.get(), mySize, 0);
 
   // Directly copy the ROM image into the buffer
@@ -81,6 +81,7 @@ void CartridgeEnhanced::install(System& system)
   myRamMask = ramSize - 1;                          // e.g. = 0xFFFF (doesn't matter for RAM size 0)
   myWriteOffset = myRamWpHigh ? ramSize : 0;        // e.g. = 0x0000
   myReadOffset  = myRamWpHigh ? 0 : ramSize;        // e.g. = 0x0080
+  myHotspot = hotspot();                            // e.g. = 0x1FF8
   // Allocate more space only if RAM has its own bank(s)
   createRomAccessArrays(mySize + (myRomOffset > 0 ? 0 : myRamSize));
 
@@ -89,7 +90,10 @@ void CartridgeEnhanced::install(System& system)
 
   // Allocate array for the RAM area
   if(myRamSize > 0)
-    myRAM = std::make_unique<uInt8[]>(myRamSize);
+    myRAM = allocateBuffer(myRamSize);
+
+  // Precompute the page access descriptors of all banks
+  createBankAccess();
 
   mySystem = &system;
 
@@ -107,9 +111,9 @@ void CartridgeEnhanced::install(System& system)
     {
       const uInt16 offset = addr & myRamMask;
 
-      access.romAccessBase = &myRomAccessBase[myWriteOffset + offset];
-      access.romPeekCounter = &myRomAccessCounter[myWriteOffset + offset];
-      access.romPokeCounter = &myRomAccessCounter[myWriteOffset + offset + myAccessSize];
+      access.romAccessBase = romAccessBase(myWriteOffset + offset);
+      access.romPeekCounter = romPeekCounter(myWriteOffset + offset);
+      access.romPokeCounter = romPokeCounter(myWriteOffset + offset);
       mySystem->setPageAccess(static_cast<uInt16>(addr), access);
     }
 
@@ -120,9 +124,9 @@ void CartridgeEnhanced::install(System& system)
       const size_t offset = addr & myRamMask;
 
       access.directPeekBase = &myRAM[offset];
-      access.romAccessBase = &myRomAccessBase[myReadOffset + offset];
-      access.romPeekCounter = &myRomAccessCounter[myReadOffset + offset];
-      access.romPokeCounter = &myRomAccessCounter[myReadOffset + offset + myAccessSize];
+      access.romAccessBase = romAccessBase(myReadOffset + offset);
+      access.romPeekCounter = romPeekCounter(myReadOffset + offset);
+      access.romPokeCounter = romPokeCounter(myReadOffset + offset);
       mySystem->setPageAccess(static_cast<uInt16>(addr), access);
     }
   }
@@ -163,7 +167,7 @@ uInt8 CartridgeEnhanced::peek(uInt16 address)
   }
 
   // hotspots in TIA range are reacting to pokes only
-  if(hotspot() >= 0x80)
+  if(myHotspot >= 0x80)
     if(checkSwitchBank(address & ADDR_MASK, 0) && myRandomHotspots)
       return myRWPRandomValues[address & 0xFF];
 
@@ -235,6 +239,67 @@ bool CartridgeEnhanced::poke(uInt16 address, uInt8 value)
   return false;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void CartridgeEnhanced::createBankAccess()
+{
+  // for ROMs < 4_KB, the whole address space will be mapped.
+  myRomBankPages = (mySize < 4_KB ? 4_KB : myBankSize) >> System::PAGE_SHIFT;
+  myRamBankPages = myRamBankCount > 0 ? (1 << myRamBankShift) >> System::PAGE_SHIFT : 0;
+
+  myBankAccess.clear();
+  myBankAccess.reserve(romBankCount() * myRomBankPages +
+                       myRamBankCount * myRamBankPages * 2);
+
+  // ROM banks; the hotspot pages are patched in bank()
+  System::PageAccess access(this, System::PageAccessType::READ);
+  for(uInt16 bank = 0; bank < romBankCount(); ++bank)
+  {
+    const uInt32 bankOffset = bank << myBankShift;
+
+    for(uInt16 page = 0; page < myRomBankPages; ++page)
+    {
+      const uInt32 offset = bankOffset + ((page << System::PAGE_SHIFT) & myBankMask);
+
+      access.directPeekBase = myDirectPeek ? &myImage[offset] : nullptr;
+      access.romAccessBase = romAccessBase(offset);
+      access.romPeekCounter = romPeekCounter(offset);
+      access.romPokeCounter = romPokeCounter(offset);
+      myBankAccess.push_back(access);
+    }
+  }
+
+  // RAM banks, which follow the ROM banks and are half the size of a ROM bank
+  for(uInt16 bank = 0; bank < myRamBankCount; ++bank)
+  {
+    const uInt32 bankOffset = static_cast<uInt32>(mySize) +
+      (bank << myRamBankShift);
+
+    // Writes are mapped to poke() (NOT using directPokeBase) to check for read from write port (RWP)
+    access = System::PageAccess(this, System::PageAccessType::WRITE);
+    for(uInt16 page = 0; page < myRamBankPages; ++page)
+    {
+      const uInt32 offset = bankOffset + (page << System::PAGE_SHIFT);
+
+      access.romAccessBase = romAccessBase(offset);
+      access.romPeekCounter = romPeekCounter(offset);
+      access.romPokeCounter = romPokeCounter(offset);
+      myBankAccess.push_back(access);
+    }
+
+    access.type = System::PageAccessType::READ;
+    for(uInt16 page = 0; page < myRamBankPages; ++page)
+    {
+      const uInt32 offset = bankOffset + (page << System::PAGE_SHIFT);
+
+      access.directPeekBase = &myRAM[offset - mySize];
+      access.romAccessBase = romAccessBase(offset);
+      access.romPeekCounter = romPeekCounter(offset);
+      access.romPokeCounter = romPokeCounter(offset);
+      myBankAccess.push_back(access);
+    }
+  }
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool CartridgeEnhanced::bank(uInt16 bank, uInt16 segment)
 {
@@ -247,7 +312,7 @@ bool CartridgeEnhanced::bank(uInt16 bank, uInt16 segment)
     // Setup ROM bank
     const uInt16 romBank = bank % romBankCount();
     // Remember what bank is in this segment
-    const uInt32 bankOffset = myCurrentSegOffset[segment] = romBank << myBankShift;
+    myCurrentSegOffset[segment] = romBank << myBankShift;
     const uInt16 hotspot = this->hotspot();
     const uInt16 hotSpotAddr = (hotspot & 0x1000) ? (hotspot & ~System::PAGE_MASK) : 0xFFFF;
     const uInt16 plusROMAddr = (myPlusROM->isValid()) ? (0x1FF0 & ~System::PAGE_MASK) : 0xFFFF;
@@ -257,67 +322,39 @@ bool CartridgeEnhanced::bank(uInt16 bank, uInt16 segment)
     // for ROMs < 4_KB, the whole address space will be mapped.
     const uInt16 toAddr   = (ROM_OFFSET + segmentOffset + (mySize < 4_KB ? 4_KB : myBankSize)) & ~System::PAGE_MASK;
 
-    System::PageAccess access(this, System::PageAccessType::READ);
     // Setup the page access methods for the current bank
-    for(uInt16 addr = fromAddr; addr < toAddr; addr += System::PAGE_SIZE)
-    {
-      const uInt32 offset = bankOffset + (addr & myBankMask);
-
-      if(myDirectPeek && addr != hotSpotAddr && addr != plusROMAddr)
-        access.directPeekBase = &myImage[offset];
-      else
-        access.directPeekBase = nullptr;
-      access.romAccessBase = &myRomAccessBase[offset];
-      access.romPeekCounter = &myRomAccessCounter[offset];
-      access.romPokeCounter = &myRomAccessCounter[offset + myAccessSize];
-      mySystem->setPageAccess(addr, access);
-    }
+    mySystem->setPageAccess(fromAddr,
+        &myBankAccess[romBank * myRomBankPages + ((fromAddr - segmentOffset - ROM_OFFSET) >> System::PAGE_SHIFT)],
+        (toAddr - fromAddr) >> System::PAGE_SHIFT);
+
+    // Hotspot pages must be peeked through the cart
+    if(myDirectPeek)
+      for(const uInt16 addr: {hotSpotAddr, plusROMAddr})
+        if(addr >= fromAddr && addr < toAddr)
+        {
+          System::PageAccess access = mySystem->getPageAccess(addr);
+
+          access.directPeekBase = nullptr;
+          mySystem->setPageAccess(addr, access);
+        }
   }
   else
   {
     // Setup RAM bank
     const uInt16 ramBank = (bank - romBankCount()) % myRamBankCount;
-    // The RAM banks follow the ROM banks and are half the size of a ROM bank
-    const uInt32 bankOffset = static_cast<uInt32>(mySize) +
-      (ramBank << myRamBankShift);
 
     // Remember what bank is in this segment
     myCurrentSegOffset[segment] = static_cast<uInt32>(mySize) +
       (ramBank << myBankShift);
 
-    // Set the page accessing method for the RAM writing pages
-    // Note: Writes are mapped to poke() (NOT using directPokeBase) to check for read from write port (RWP)
-    uInt16 fromAddr = (ROM_OFFSET + segmentOffset + myWriteOffset) & ~System::PAGE_MASK;
-    uInt16 toAddr   = (ROM_OFFSET + segmentOffset + myWriteOffset
-      + (myBankSize >> (myBankShift - myRamBankShift))) & ~System::PAGE_MASK;
-    System::PageAccess access(this, System::PageAccessType::WRITE);
-
-    for(uInt16 addr = fromAddr; addr < toAddr; addr += System::PAGE_SIZE)
-    {
-      const uInt32 offset = bankOffset + (addr & myRamMask);
-
-      access.romAccessBase = &myRomAccessBase[offset];
-      access.romPeekCounter = &myRomAccessCounter[offset];
-      access.romPokeCounter = &myRomAccessCounter[offset + myAccessSize];
-      mySystem->setPageAccess(addr, access);
-    }
-
-    // Set the page accessing method for the RAM reading pages
-    fromAddr = (ROM_OFFSET + segmentOffset + myReadOffset) & ~System::PAGE_MASK;
-    toAddr   = (ROM_OFFSET + segmentOffset + myReadOffset
-      + (myBankSize >> (myBankShift - myRamBankShift))) & ~System::PAGE_MASK;
-    access.type = System::PageAccessType::READ;
+    const System::PageAccess* access =
+        &myBankAccess[romBankCount() * myRomBankPages + ramBank * myRamBankPages * 2];
 
-    for(uInt16 addr = fromAddr; addr < toAddr; addr += System::PAGE_SIZE)
-    {
-      const uInt32 offset = bankOffset + (addr & myRamMask);
-
-      access.directPeekBase = &myRAM[offset - mySize];
-      access.romAccessBase = &myRomAccessBase[offset];
-      access.romPeekCounter = &myRomAccessCounter[offset];
-      access.romPokeCounter = &myRomAccessCounter[offset + myAccessSize];
-      mySystem->setPageAccess(addr, access);
-    }
+    // Set the page accessing methods for the RAM writing and reading pages
+    mySystem->setPageAccess(ROM_OFFSET + segmentOffset + myWriteOffset,
+                            access, myRamBankPages);
+    mySystem->setPageAccess(ROM_OFFSET + segmentOffset + myReadOffset,
+                            access + myRamBankPages, myRamBankPages);
   }
   return myBankChanged = true;
 }
@@ -334,6 +371,13 @@ uInt16 CartridgeEnhanced::getSegmentBank(uInt16 segment) const
   return myCurrentSegOffset[segment % myBankSegs] >> myBankShift;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+size_t CartridgeEnhanced::memoryUsage() const
+{
+  return Cartridge::memoryUsage() +
+      myBankAccess.capacity() * sizeof(System::PageAccess);
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 uInt16 CartridgeEnhanced::romBankCount() const
 {
@@ -362,6 +406,15 @@ bool CartridgeEnhanced::isRamBank(uInt16 address) const
   return myRamBankCount > 0 ? getBank(address) >= romBankCount() : false;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+Cartridge::RamAreaList CartridgeEnhanced::ramAreas()
+{
+  if(myRamSize == 0)
+    return {};
+
+  return {{std::span{myRAM.get(), myRamSize}, std::nullopt}};
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool CartridgeEnhanced::patch(uInt16 address, uInt8 value)
 {
@@ -22,6 +22,7 @@ class System;
 
 #include "bspf.hxx"
 #include "Cart.hxx"
+#include "System.hxx"
 #include "PlusROM.hxx"
 #ifdef DEBUGGER_SUPPORT
   #include "CartEnhancedWidget.hxx"
@@ -94,11 +95,22 @@ class CartridgeEnhanced : public Cartridge
     */
     uInt16 romBankCount() const override;
 
+    /**
+      Get the number of bytes owned by the cartridge, including the
+      precomputed bank descriptors.
+    */
+    size_t memoryUsage() const override;
+
     /**
       Query the number of RAM 'banks' supported by the cartridge.
     */
     uInt16 ramBankCount() const override;
 
+    /**
+      Get the RAM on the cart, for direct access by external tools.
+    */
+    RamAreaList ramAreas() override;
+
     /**
       Query whether the current PC allows code execution.
 
@@ -264,9 +276,22 @@ class CartridgeEnhanced : public Cartridge
     // Contains the offset into the ROM image for each of the bank segments
     DWordBuffer myCurrentSegOffset{nullptr};
 
+    // The (constant) result of hotspot(), cached in install() so that
+    // peek() doesn't need a virtual call for every access
+    uInt16 myHotspot{0};
+
     // Indicates whether to use direct ROM peeks or not
     bool myDirectPeek{true};
 
+    // Page access descriptors precomputed in install(), one block per ROM
+    // bank (myRomBankPages entries), followed by one block per RAM bank
+    // (myRamBankPages write pages, then myRamBankPages read pages).  The
+    // descriptors don't depend on the segment, so switching a bank only
+    // copies a block into the system's page table.
+    vector<System::PageAccess> myBankAccess;
+    uInt16 myRomBankPages{0};
+    uInt16 myRamBankPages{0};
+
     // Pointer to a dynamically allocated RAM area of the cartridge
     ByteBuffer myRAM{nullptr};
 
@@ -324,6 +349,12 @@ class CartridgeEnhanced : public Cartridge
     */
     virtual uInt16 getStartBank() const { return 0; }
 
+    /**
+      Precompute the page access descriptors of all ROM and RAM banks
+      (see myBankAccess).
+    */
+    void createBankAccess();
+
     /**
       Get the ROM offset of the segment of the given address.
 
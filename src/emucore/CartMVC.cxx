@@ -15,9 +15,16 @@
 // this file, and for a DISCLAIMER OF ALL WARRANTIES.
 //============================================================================
 
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
 #include "Serializer.hxx"
 #include "Serializable.hxx"
 #include "System.hxx"
+#ifdef ZIP_SUPPORT
+  #include "FSNodeZIP.hxx"
+#endif
 #include "CartMVC.hxx"
 
 /**
@@ -46,6 +53,215 @@ namespace {
 
   constexpr int TITLE_CYCLES = 1000000;
 
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+  /**
+    Read-ahead cache for the fields of a MovieCart stream.
+
+    A background thread owns the stream file and keeps a ring of fields
+    loaded around the field last requested, mostly in the direction the
+    movie is currently played (forward, rewinding or fast-forwarding),
+    and a few in the opposite one.  The emulation thread then normally
+    only copies an already loaded field instead of waiting for the disk.
+    The data returned is always that of the file, so emulation stays
+    deterministic no matter how far ahead the reader is.
+
+    Streams inside ZIP archives are inflated on demand as well, instead
+    of decompressing the whole (often huge) file first.
+  */
+  class FieldPrefetcher
+  {
+    public:
+      FieldPrefetcher() = default;
+      ~FieldPrefetcher() { close(); }
+
+      bool open(string_view path) {
+        close();
+
+      #ifdef ZIP_SUPPORT
+        if(BSPF::findIgnoreCase(path, ".zip") != string::npos)
+        {
+          try         { myZipStream = FSNodeZIP(path).openStream(); }
+          catch(...)  { return false; }
+          myFieldCount = myZipStream->size() / CartridgeMVC::MVC_FIELD_SIZE;
+        }
+        else
+      #endif
+        {
+          myFile = std::make_unique<Serializer>(path, Serializer::FileMode::ReadOnly);
+          myFieldCount = myFile ? myFile->size() / CartridgeMVC::MVC_FIELD_SIZE : 0;
+        }
+        if(myFieldCount > 0)
+        {
+          myStop = false;
+          myThread = std::thread(&FieldPrefetcher::run, this);
+        }
+        return myFile || myFieldCount > 0;
+      }
+
+      void close() {
+        if(myThread.joinable())
+        {
+          {
+            const std::lock_guard<std::mutex> lock(myMutex);
+            myStop = true;
+          }
+          myRequested.notify_one();
+          myThread.join();
+        }
+        for(auto& slot: mySlots)
+          slot.field = NO_FIELD;
+        myFile.reset();
+      #ifdef ZIP_SUPPORT
+        myZipStream.reset();
+      #endif
+        myFieldCount = 0;
+      }
+
+      [[nodiscard]] size_t fieldCount() const { return myFieldCount; }
+
+      /**
+        Copy the given field into the buffer, waiting for it to be loaded
+        if the read-ahead hasn't got it yet.
+
+        @param field   The field to read
+        @param buffer  The buffer to receive the data
+
+        @return  False if the field is not part of the stream or could not be read
+      */
+      bool read(uInt32 field, std::span<uInt8, CartridgeMVC::MVC_FIELD_SIZE> buffer) {
+        if(field >= myFieldCount)
+          return false;
+
+        std::unique_lock<std::mutex> lock(myMutex);
+
+        // Follow the direction of the movie, a paused movie toggles
+        // between two fields and keeps the last direction
+        if(field != myCenter)
+          myStride = static_cast<Int32>(static_cast<Int64>(field) - myCenter);
+        myCenter = field;
+        ++myGeneration;
+        myRequested.notify_one();
+
+        const Slot& slot = mySlots[field % SLOTS];
+        myLoaded.wait(lock, [&] { return slot.field == field; });
+        if(!slot.valid)
+          return false;
+
+        std::copy_n(slot.data.begin(), buffer.size(), buffer.begin());
+        return true;
+      }
+
+    private:
+      void run() {
+        std::array<uInt8, CartridgeMVC::MVC_FIELD_SIZE> data{};
+        std::unique_lock<std::mutex> lock(myMutex);
+
+        while(!myStop)
+        {
+          const uInt64 generation = myGeneration;
+          const uInt32 center = myCenter;
+          const Int32 stride = myStride;
+
+          // Each pass claims a slot at most once, so that a later (less
+          // important) field never evicts an earlier one of the same pass
+          uInt64 claimed = 0;
+          bool restart = false;
+          for(uInt32 k = 0; k < SLOTS && !restart && !myStop; ++k)
+          {
+            // Fields ahead first, then those behind the current one
+            const Int64 field = k < AHEAD
+              ? center + static_cast<Int64>(stride) * k
+              : center - static_cast<Int64>(stride) * (k - AHEAD + 1);
+            if(field < 0 || std::cmp_greater_equal(field, myFieldCount))
+              continue;
+
+            const uInt32 index = static_cast<uInt32>(field % SLOTS);
+            const uInt64 mask = uInt64{1} << index;
+            if(claimed & mask)
+              continue;
+            claimed |= mask;
+            if(mySlots[index].field == field)
+              continue;
+
+            lock.unlock();
+            const bool valid = readField(static_cast<uInt32>(field), data);
+            lock.lock();
+
+            Slot& slot = mySlots[index];
+            slot.data = data;
+            slot.valid = valid;
+            slot.field = static_cast<uInt32>(field);
+            myLoaded.notify_one();
+
+            // A new request moves the window, start over around it
+            restart = myGeneration != generation;
+          }
+
+          if(!restart)
+            myRequested.wait(lock, [&] { return myStop || myGeneration != generation; });
+        }
+      }
+
+      bool readField(uInt32 field,
+                     std::array<uInt8, CartridgeMVC::MVC_FIELD_SIZE>& data) {
+        const size_t offset = static_cast<size_t>(field) * CartridgeMVC::MVC_FIELD_SIZE;
+        try
+        {
+        #ifdef ZIP_SUPPORT
+          if(myZipStream)
+          {
+            myZipStream->read(offset, data);
+            return true;
+          }
+        #endif
+          myFile->setPosition(offset);
+          myFile->getByteArray(data);
+          return true;
+        }
+        catch(...)
+        {
+          return false;
+        }
+      }
+
+    private:
+      // Fields kept loaded ahead of and behind the current one
+      static constexpr uInt32 AHEAD = 24;
+      static constexpr uInt32 SLOTS = 32;
+      static_assert(AHEAD < SLOTS && SLOTS <= 64);
+      static constexpr uInt32 NO_FIELD = std::numeric_limits<uInt32>::max();
+
+      struct Slot {
+        uInt32 field{NO_FIELD};
+        bool valid{false};
+        std::array<uInt8, CartridgeMVC::MVC_FIELD_SIZE> data{};
+      };
+      std::array<Slot, SLOTS> mySlots;
+
+      // Only accessed by the thread while it is running
+      unique_ptr<Serializer> myFile;
+    #ifdef ZIP_SUPPORT
+      unique_ptr<ZipHandler::SeekableStream> myZipStream;
+    #endif
+      size_t myFieldCount{0};
+
+      std::mutex myMutex;
+      std::condition_variable myRequested, myLoaded;
+      uInt32 myCenter{0};
+      Int32 myStride{1};
+      uInt64 myGeneration{0};
+      bool myStop{false};
+
+      std::thread myThread;
+
+    private:
+      // Following constructors and assignment operators not supported
+      FieldPrefetcher(const FieldPrefetcher&) = delete;
+      FieldPrefetcher(FieldPrefetcher&&) = delete;
+      FieldPrefetcher& operator=(const FieldPrefetcher&) = delete;
+      FieldPrefetcher& operator=(FieldPrefetcher&&) = delete;
+  };
+
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
   /**
     Simulate retrieval 512 byte chunks from a serial source
@@ -56,14 +272,11 @@ namespace {
       StreamReader() = default;
 
       bool open(string_view path) {
-        myFile = std::make_unique<Serializer>(path, Serializer::FileMode::ReadOnly);
-        myFileSize = myFile ? myFile->size() : 0;
-
-        return static_cast<bool>(myFile);
+        return myFields.open(path);
       }
 
       [[nodiscard]] bool isValid() const {
-        return myFileSize > 0;
+        return myFields.fieldCount() > 0;
       }
 
       void blankPartialLines(bool index) {
@@ -156,22 +369,7 @@ namespace {
       }
 
       bool readField(uInt32 fnum, bool index) {
-        if(myFile)
-        {
-          const size_t offset = ((fnum + 0) * CartridgeMVC::MVC_FIELD_SIZE);
-
-          if(offset + CartridgeMVC::MVC_FIELD_SIZE <= myFileSize)
-          {
-            myFile->setPosition(offset);
-            if(index)
-              myFile->getByteArray(myBuffer1);
-            else
-              myFile->getByteArray(myBuffer2);
-
-            return true;
-          }
-        }
-        return false;
+        return myFields.read(fnum, index ? myBuffer1 : myBuffer2);
       }
 
       uInt8 readColor()   { return *myColor++;   }
@@ -254,8 +452,7 @@ namespace {
       uInt8         myOverscanLines{30};
       uInt8         myEmbeddedFrame{0};
 
-      unique_ptr<Serializer> myFile;
-      size_t myFileSize{0};
+      FieldPrefetcher myFields;
 
       std::array<uInt8, CartridgeMVC::MVC_FIELD_SIZE> myBuffer1{};
       std::array<uInt8, CartridgeMVC::MVC_FIELD_SIZE> myBuffer2{};
@@ -59,7 +59,9 @@
 #include "FrameLayout.hxx"
 #include "AudioQueue.hxx"
 #include "AudioSettings.hxx"
+#include "MemoryReport.hxx"
 #include "DevSettingsHandler.hxx"
+#include "StartupTrace.hxx"
 #include "frame-manager/FrameManager.hxx"
 #include "frame-manager/FrameLayoutDetector.hxx"
 
@@ -100,6 +102,26 @@ namespace {
     return speed < 0 ? -1 / (f_speed - 1) : 1 + f_speed;
   }
 
+  // Create a chip, reusing the storage of the given spare chip, if any
+  template<typename T, typename... Args>
+  unique_ptr<T> recycle(unique_ptr<T>& spare, Args&&... args)
+  {
+    if(!spare)
+      return std::make_unique<T>(std::forward<Args>(args)...);
+
+    T* chip = spare.release();
+    std::destroy_at(chip);
+    try
+    {
+      return unique_ptr<T>(std::construct_at(chip, std::forward<Args>(args)...));
+    }
+    catch(...)
+    {
+      ::operator delete(chip);
+      throw;
+    }
+  }
+
   string formatSpeed(int speed) {
     std::ostringstream ss;
 
@@ -111,9 +133,14 @@ namespace {
   }
 } // namespace
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+ConsoleChips::ConsoleChips() = default;
+ConsoleChips::~ConsoleChips() = default;
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 Console::Console(OSystem& osystem, unique_ptr<Cartridge>& cart,
-                 const Properties& props, AudioSettings& audioSettings)
+                 const Properties& props, AudioSettings& audioSettings,
+                 ConsoleChips* spare)
   : myOSystem{osystem},
     myEvent{osystem.eventHandler().event()},
     myAudioSettings{audioSettings},
@@ -124,9 +151,13 @@ Console::Console(OSystem& osystem, unique_ptr<Cartridge>& cart,
   myEmulationTiming = std::make_shared<EmulationTiming>();
   myCart->setProperties(&myProperties);
 
-  // Create subsystems for the console
-  my6502 = std::make_unique<M6502>(myOSystem.settings());
-  myRiot = std::make_unique<M6532>(*this, myOSystem.settings());
+  // Create subsystems for the console, reusing the chips of the previous
+  // console (if any) to avoid reallocating them for every ROM
+  ConsoleChips noChips;
+  ConsoleChips& chips = spare ? *spare : noChips;
+
+  my6502 = recycle(chips.cpu, myOSystem.settings());
+  myRiot = recycle(chips.riot, *this, myOSystem.settings());
 
   const TIA::onPhosphorCallback callback = [&frameBuffer = this->myOSystem.frameBuffer()](bool enable)
   {
@@ -137,7 +168,7 @@ Console::Console(OSystem& osystem, unique_ptr<Cartridge>& cart,
     frameBuffer.showTextMessage(msg.view());
 #endif
   };
-  myTIA  = std::make_unique<TIA>(*this, [this]() { return timing(); }, myOSystem.settings(), callback);
+  myTIA  = recycle(chips.tia, *this, [this]() { return timing(); }, myOSystem.settings(), callback);
   myFrameManager = std::make_unique<FrameManager>();
   mySwitches = std::make_unique<Switches>(myEvent, myProperties, myOSystem.settings());
 
@@ -148,7 +179,7 @@ Console::Console(OSystem& osystem, unique_ptr<Cartridge>& cart,
   myOSystem.random().initSeed(static_cast<uInt32>(TimerManager::getTicks()));
 
   // Construct the system and components
-  mySystem = std::make_unique<System>(myOSystem.random(), *my6502, *myRiot, *myTIA, *myCart);
+  mySystem = recycle(chips.system, myOSystem.random(), *my6502, *myRiot, *myTIA, *myCart);
 
   // The real controllers for this console will be added later
   // For now, we just add dummy joystick controllers, since autodetection
@@ -187,7 +218,10 @@ Console::Console(OSystem& osystem, unique_ptr<Cartridge>& cart,
   string autodetected;
   if(myDisplayFormat == "AUTO" || myOSystem.settings().getBool("rominfo"))
   {
-    autodetectFrameLayout();
+    {
+      const StartupTrace::Scope trace("autodetectFrameLayout");
+      autodetectFrameLayout();
+    }
 
     if(myProperties.get(PropType::Display_Format) == "AUTO")
     {
@@ -268,6 +302,17 @@ Console::~Console()
   }
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Console::releaseChips(ConsoleChips& chips)
+{
+  // The chips stay alive (and connected) until the next console reuses
+  // them, so the remaining teardown of this console can still use them
+  chips.system = std::move(mySystem);
+  chips.cpu = std::move(my6502);
+  chips.riot = std::move(myRiot);
+  chips.tia = std::move(myTIA);
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void Console::setConsoleTiming()
 {
@@ -288,16 +333,32 @@ void Console::setConsoleTiming()
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void Console::autodetectFrameLayout(bool reset)
 {
+  Settings& settings = myOSystem.settings();
+  const bool detectPal60 = settings.getBool("detectpal60");
+  const bool detectNtsc50 = settings.getBool("detectntsc50");
+  const string& md5 = myProperties.get(PropType::Cart_MD5);
+  const string detector = std::format("{}{}{}",
+    PropertiesSet::DETECTED_DISPLAY_FORMAT,
+    detectPal60 ? "+PAL60" : "", detectNtsc50 ? "+NTSC50" : "");
+
+  // A newly created console can reuse the layout detected when the ROM
+  // was loaded before ('rominfo' always runs the detection)
+  if(reset && !settings.getBool("rominfo") &&
+     myOSystem.propSet().getDetected(md5, detector, myDisplayFormat))
+    return;
+
   // Run the TIA, looking for PAL scanline patterns
   // We turn off the SuperCharger progress bars, otherwise the SC BIOS
   // will take over 250 frames!
   // The 'fastscbios' option must be changed before the system is reset
-  Settings& settings = myOSystem.settings();
   const bool fastscbios = settings.getBool("fastscbios");
   settings.setValue("fastscbios", true);
 
-  FrameLayoutDetector frameLayoutDetector;
+  // The pixel colors are only evaluated when detecting PAL60 and NTSC50,
+  // otherwise the TIA doesn't need to render anything
+  FrameLayoutDetector frameLayoutDetector(detectPal60 || detectNtsc50);
   myTIA->setFrameManager(&frameLayoutDetector, true);
+  myTIA->setAudioSuspended(true);
 
   if (reset) {
     mySystem->reset(true);
@@ -315,8 +376,7 @@ void Console::autodetectFrameLayout(bool reset)
   for(int i = 0; i < 40; ++i)
     myTIA->update();
 
-  switch(frameLayoutDetector.detectedLayout(
-    settings.getBool("detectpal60"), settings.getBool("detectntsc50"),
+  switch(frameLayoutDetector.detectedLayout(detectPal60, detectNtsc50,
     myProperties.get(PropType::Cart_Name)))
   {
     case FrameLayout::pal:
@@ -336,10 +396,13 @@ void Console::autodetectFrameLayout(bool reset)
       break;
   }
 
+  myTIA->setAudioSuspended(false);
   myTIA->setFrameManager(myFrameManager.get());
 
   // Don't forget to reset the SC progress bars again
   settings.setValue("fastscbios", fastscbios);
+
+  myOSystem.propSet().setDetected(md5, detector, myDisplayFormat);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -796,14 +859,19 @@ FBInitStatus Console::initializeVideo(bool full)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void Console::initializeAudio()
 {
+  const float speed = myOSystem.settings().getBool("turbo")
+    ? 50.0F
+    : myOSystem.settings().getFloat("speed");
+
   (*myEmulationTiming)
     .updatePlaybackRate(myAudioSettings.sampleRate())
     .updatePlaybackPeriod(myAudioSettings.fragmentSize())
     .updateAudioQueueExtraFragments(myAudioSettings.bufferSize())
     .updateAudioQueueHeadroom(myAudioSettings.headroom())
-    .updateSpeedFactor(myOSystem.settings().getBool("turbo")
-      ? 50.0F
-      : myOSystem.settings().getFloat("speed"));
+    .updateSpeedFactor(speed);
+
+  // Only draw about as many frames as can be displayed
+  myTIA->setFrameSkip(speed >= 2.0F ? static_cast<uInt32>(speed) - 1 : 0);
 
   createAudioQueue();
   myTIA->setAudioQueue(myAudioQueue);
@@ -940,6 +1008,15 @@ void Console::createAudioQueue()
   );
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Console::memoryReport(MemoryReport& report) const
+{
+  mySystem->memoryReport(report);
+
+  if(myAudioQueue)
+    report.add("Audio fragments", myAudioQueue->memoryUsage());
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void Console::setControllers(string_view romMd5)
 {
@@ -978,11 +1055,33 @@ void Console::setControllers(string_view romMd5)
     // Try to detect controllers
     if(image != nullptr && size != 0)
     {
+      // Reuse the controllers detected when the ROM was loaded before
+      // ('rominfo' always runs the detection)
+      const bool rominfo = myOSystem.settings().getBool("rominfo");
+      const auto detectType = [&](Controller::Type type, Controller::Jack port)
+      {
+        if(type != Controller::Type::Unknown && !rominfo)
+          return type;
+
+        const string_view detector = port == Controller::Jack::Left
+          ? PropertiesSet::DETECTED_LEFT_CONTROLLER
+          : PropertiesSet::DETECTED_RIGHT_CONTROLLER;
+        if(string cached; !rominfo &&
+           myOSystem.propSet().getDetected(romMd5, detector, cached))
+          return Controller::getType(cached);
+
+        const Controller::Type detectedType = ControllerDetector::detectType(
+            image, size, type, port, myOSystem.settings());
+        myOSystem.propSet().setDetected(romMd5, detector,
+                                        Controller::getPropName(detectedType));
+        return detectedType;
+      };
+
       Logger::debug(myProperties.get(PropType::Cart_Name) + ":");
-      leftType = ControllerDetector::detectType(image, size, leftType,
-          !swappedPorts ? Controller::Jack::Left : Controller::Jack::Right, myOSystem.settings());
-      rightType = ControllerDetector::detectType(image, size, rightType,
-          !swappedPorts ? Controller::Jack::Right : Controller::Jack::Left, myOSystem.settings());
+      leftType = detectType(leftType,
+          !swappedPorts ? Controller::Jack::Left : Controller::Jack::Right);
+      rightType = detectType(rightType,
+          !swappedPorts ? Controller::Jack::Right : Controller::Jack::Left);
     }
 
     unique_ptr<Controller>
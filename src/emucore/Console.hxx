@@ -29,6 +29,7 @@ class CompuMate;
 class Debugger;
 class AudioQueue;
 class AudioSettings;
+class MemoryReport;
 class DevSettingsHandler;
 
 #include "bspf.hxx"
@@ -57,6 +58,21 @@ struct ConsoleInfo
   string DisplayFormat;
 };
 
+/**
+  The chips of a closed console.  Their storage is reused by the next
+  console, which constructs its own chips in place.
+*/
+struct ConsoleChips
+{
+  ConsoleChips();
+  ~ConsoleChips();
+
+  unique_ptr<System> system;
+  unique_ptr<M6502> cpu;
+  unique_ptr<M6532> riot;
+  unique_ptr<TIA> tia;
+};
+
 /**
   This class represents the entire game console.
 
@@ -72,11 +88,19 @@ class Console : public Serializable, public ConsoleIO
       @param osystem  The OSystem object to use
       @param cart     The cartridge to use with this console
       @param props    The properties for the cartridge
+      @param spare    The chips of a closed console to reuse, if any
     */
     Console(OSystem& osystem, unique_ptr<Cartridge>& cart,
-            const Properties& props, AudioSettings& audioSettings);
+            const Properties& props, AudioSettings& audioSettings,
+            ConsoleChips* spare = nullptr);
     ~Console() override;
 
+    /**
+      Hand the chips over for reuse by the next console.  Must only be
+      called right before the console is destroyed.
+    */
+    void releaseChips(ConsoleChips& chips);
+
   public:
     /**
       Sets the left and right controllers for the console.
@@ -125,6 +149,14 @@ class Console : public Serializable, public ConsoleIO
     */
     System& system() const { return *mySystem; }
 
+    /**
+      Add the memory owned by the console (chips, cartridge and audio
+      fragments) to the given report.
+
+      @param report  The report to add the entries to
+    */
+    void memoryReport(MemoryReport& report) const;
+
     /**
       Get the cartridge used by the console which contains the ROM code
 
@@ -187,6 +219,17 @@ class Console : public Serializable, public ConsoleIO
      */
     EmulationTiming& emulationTiming() { return *myEmulationTiming; }
 
+    /**
+      Retrieve the queue of the generated audio fragments, if any.
+     */
+    const AudioQueue* audioQueue() const { return myAudioQueue.get(); }
+
+    /**
+      Share the queue of the generated audio fragments, e.g. for reading it
+      through an AudioQueue::Tap.
+     */
+    shared_ptr<AudioQueue> sharedAudioQueue() const { return myAudioQueue; }
+
     /**
       Toggle left and right controller ports swapping
     */
@@ -190,6 +190,14 @@ class Controller : public Serializable
     */
     virtual void update() { }
 
+    /**
+      Update only the analog inputs (e.g. paddle positions) according to
+      the events currently set.  This may be called several times between
+      two update() calls, which keep handling all digital inputs once
+      per frame.
+    */
+    virtual void updateAnalog() { }
+
     /**
       Returns the name of this controller.
     */
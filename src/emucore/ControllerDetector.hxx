@@ -63,9 +63,8 @@ class ControllerDetector
         Controller::Type type, Controller::Jack port,
         const Settings& settings, bool isQuadTari = false);
 
-  private:
     /**
-      Detects the controller type at the given port.
+      Detects the controller type at the given port from the ROM image alone.
 
       @param image       A reference to the ROM image
       @param size        The size of the ROM image
@@ -78,6 +77,7 @@ class ControllerDetector
     static Controller::Type autodetectPort(const ByteBuffer& image, size_t size,
         Controller::Jack port, const Settings& settings, bool isQuadTari);
 
+  private:
     /**
       Search the image for the specified byte signature.
 
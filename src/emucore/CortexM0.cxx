@@ -26,6 +26,10 @@
 
 #include "Serializable.hxx"
 #include "Base.hxx"
+#include "PerfCounters.hxx"
+#ifdef DEBUGGER_SUPPORT
+  #include "ArmProfiler.hxx"
+#endif
 
 namespace {
 #ifdef __BIG_ENDIAN__
@@ -572,26 +576,18 @@ void CortexM0::MemoryRegion::saveDirtyBits(Serializer& out) const
   out.putInt(accessWatermarkLow);
   out.putInt(accessWatermarkHigh);
 
-  switch (type) {
-    case MemoryRegionType::directCode:
-      out.putByteArray(std::span{
-        std::get<1>(access).backingStore + (accessWatermarkLow - base),
-        accessWatermarkHigh - accessWatermarkLow + 1}
-      );
-
-      break;
-
-    case MemoryRegionType::directData:
-      out.putByteArray(std::span{
-        std::get<0>(access).backingStore + (accessWatermarkLow - base),
-        accessWatermarkHigh - accessWatermarkLow + 1}
-      );
-
-      break;
-
-    default:
-      break;
-  }
+  const uInt8* backingStore = type == MemoryRegionType::directCode
+    ? std::get<1>(access).backingStore : std::get<0>(access).backingStore;
+
+  // Snapshot pages share the unchanged parts with the previous state, so
+  // they can cover the whole region
+  if (out.pagesEnabled())
+    out.putPages(std::span{backingStore, size}, snapshot);
+  else
+    out.putByteArray(std::span{
+      backingStore + (accessWatermarkLow - base),
+      accessWatermarkHigh - accessWatermarkLow + 1}
+    );
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -605,26 +601,16 @@ void CortexM0::MemoryRegion::loadDirtyBits(Serializer& in)
   accessWatermarkLow = in.getInt();
   accessWatermarkHigh = in.getInt();
 
-  switch (type) {
-    case MemoryRegionType::directCode:
-      in.getByteArray(std::span{
-        std::get<1>(access).backingStore + (accessWatermarkLow - base),
-        accessWatermarkHigh - accessWatermarkLow + 1}
-      );
+  uInt8* backingStore = type == MemoryRegionType::directCode
+    ? std::get<1>(access).backingStore : std::get<0>(access).backingStore;
 
-      break;
-
-    case MemoryRegionType::directData:
-      in.getByteArray(std::span{
-        std::get<0>(access).backingStore + (accessWatermarkLow - base),
-        accessWatermarkHigh - accessWatermarkLow + 1}
-      );
-
-      break;
-
-    default:
-      break;
-  }
+  if (in.pagesEnabled())
+    in.getPages(std::span{backingStore, size}, snapshot);
+  else
+    in.getByteArray(std::span{
+      backingStore + (accessWatermarkLow - base),
+      accessWatermarkHigh - accessWatermarkLow + 1}
+    );
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -701,6 +687,8 @@ CortexM0& CortexM0::resetMappings()
 
   myNextRegionIndex = 0;
   std::fill_n(myPageMap.get(), PAGEMAP_SIZE, 0xff);
+  myRegionStore.fill(nullptr);
+  myRegionOps.fill(nullptr);
 
   return *this;
 }
@@ -713,6 +701,7 @@ CortexM0& CortexM0::mapRegionData(uInt32 pageBase, uInt32 pageCount,
     setupMapping(pageBase, pageCount, readOnly, MemoryRegionType::directData);
 
   region.access.emplace<0>(MemoryRegionAccessData{backingStore});
+  myRegionStore[myPageMap[pageBase]] = backingStore;
 
   return *this;
 }
@@ -726,6 +715,8 @@ CortexM0& CortexM0::mapRegionCode(uInt32 pageBase, uInt32 pageCount,
 
   region.access.emplace<1>(MemoryRegionAccessCode{backingStore,
                            std::make_unique<uInt8[]>((pageCount * PAGE_SIZE) >> 1)});
+  myRegionStore[myPageMap[pageBase]] = backingStore;
+  myRegionOps[myPageMap[pageBase]] = std::get<1>(region.access).ops.get();
 
   return *this;
 }
@@ -816,9 +807,16 @@ uInt8 CortexM0::decodeInstructionWord(uInt16 instructionWord)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 CortexM0::err_t CortexM0::run(uInt32 maxCycles, uInt32& cycles)
 {
+  PERF_SCOPE(ARM);
+
   for (cycles = 0; cycles < maxCycles; cycles++, myCycleCounter++) {
     const uInt32 pc = read_register(15);
 
+  #ifdef DEBUGGER_SUPPORT
+    if (myProfiler && myProfiler->due())
+      myProfiler->sample(pc - 2, read_register(14));
+  #endif
+
     uInt16 inst = 0;
     uInt8 op = 0;
     err_t err = fetch16(pc - 2, inst, op);
@@ -858,6 +856,7 @@ CortexM0::MemoryRegion& CortexM0::setupMapping(uInt32 pageBase, uInt32 pageCount
 
   for (uInt32 page = pageBase; page < pageBase + pageCount; page++)
     myPageMap[page] = regionIndex;
+  myRegionBase[regionIndex] = region.base;
 
   return region;
 }
@@ -880,20 +879,19 @@ CortexM0::err_t CortexM0::read32(uInt32 address, uInt32& value)
 {
   if (address & 0x03) return errIntrinsic(ERR_ACCESS_ALIGNMENT_FAULT, address);
 
-  MemoryRegion& region = myRegions[myPageMap[address / PAGE_SIZE]];
+  const uInt8 index = myPageMap[address / PAGE_SIZE];
+
+  if (const uInt8* store = myRegionStore[index]) {
+    value = READ32(store, address - myRegionBase[index]);
+    return ERR_NONE;
+  }
+
+  MemoryRegion& region = myRegions[index];
 
   switch (region.type) {
     case MemoryRegionType::delegate:
       return std::get<2>(region.access)->read32(address, value, *this);
 
-    case MemoryRegionType::directCode:
-      value = READ32(std::get<1>(region.access).backingStore, address - region.base);
-      return ERR_NONE;
-
-    case MemoryRegionType::directData:
-      value = READ32(std::get<0>(region.access).backingStore, address - region.base);
-      return ERR_NONE;
-
     default:
       return myDefaultDelegate
         ? myDefaultDelegate->read32(address, value, *this)
@@ -906,20 +904,19 @@ CortexM0::err_t CortexM0::read16(uInt32 address, uInt16& value)
 {
   if (address & 0x01) return errIntrinsic(ERR_ACCESS_ALIGNMENT_FAULT, address);
 
-  MemoryRegion& region = myRegions[myPageMap[address / PAGE_SIZE]];
+  const uInt8 index = myPageMap[address / PAGE_SIZE];
+
+  if (const uInt8* store = myRegionStore[index]) {
+    value = READ16(store, address - myRegionBase[index]);
+    return ERR_NONE;
+  }
+
+  MemoryRegion& region = myRegions[index];
 
   switch (region.type) {
     case MemoryRegionType::delegate:
       return std::get<2>(region.access)->read16(address, value, *this);
 
-    case MemoryRegionType::directCode:
-      value = READ16(std::get<1>(region.access).backingStore, address - region.base);
-      return ERR_NONE;
-
-    case MemoryRegionType::directData:
-      value = READ16(std::get<0>(region.access).backingStore, address - region.base);
-      return ERR_NONE;
-
     default:
       return myDefaultDelegate
         ? myDefaultDelegate->read16(address, value, *this)
@@ -930,20 +927,19 @@ CortexM0::err_t CortexM0::read16(uInt32 address, uInt16& value)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 CortexM0::err_t CortexM0::read8(uInt32 address, uInt8& value)
 {
-  MemoryRegion& region = myRegions[myPageMap[address / PAGE_SIZE]];
+  const uInt8 index = myPageMap[address / PAGE_SIZE];
+
+  if (const uInt8* store = myRegionStore[index]) {
+    value = store[address - myRegionBase[index]];
+    return ERR_NONE;
+  }
+
+  MemoryRegion& region = myRegions[index];
 
   switch (region.type) {
     case MemoryRegionType::delegate:
       return std::get<2>(region.access)->read8(address, value, *this);
 
-    case MemoryRegionType::directCode:
-      value = std::get<1>(region.access).backingStore[address - region.base];
-      return ERR_NONE;
-
-    case MemoryRegionType::directData:
-      value = std::get<0>(region.access).backingStore[address - region.base];
-      return ERR_NONE;
-
     default:
       return myDefaultDelegate
         ? myDefaultDelegate->read8(address, value, *this)
@@ -1075,26 +1071,24 @@ CortexM0::err_t CortexM0::fetch16(uInt32 address, uInt16& value, uInt8& op)
 {
   if (address & 0x01) return errIntrinsic(ERR_ACCESS_ALIGNMENT_FAULT, address);
 
-  MemoryRegion& region = myRegions[myPageMap[address / PAGE_SIZE]];
+  const uInt8 index = myPageMap[address / PAGE_SIZE];
 
-  switch (region.type) {
-    case MemoryRegionType::delegate:
-      return std::get<2>(region.access)->fetch16(address, value, op, *this);
+  if (const uInt8* store = myRegionStore[index]) {
+    const uInt32 offset = address - myRegionBase[index];
 
-    case MemoryRegionType::directCode: {
-      const uInt32 offset = address - region.base;
-
-      value = READ16(std::get<1>(region.access).backingStore, offset);
-      op = std::get<1>(region.access).ops[offset >> 1];
+    value = READ16(store, offset);
+    // Code regions are decoded in advance, data regions on the fly
+    const uInt8* ops = myRegionOps[index];
+    op = ops ? ops[offset >> 1] : decodeInstructionWord(value);
 
-      return ERR_NONE;
-    }
+    return ERR_NONE;
+  }
 
-    case MemoryRegionType::directData:
-      value = READ16(std::get<0>(region.access).backingStore, address - region.base);
-      op = decodeInstructionWord(value);
+  MemoryRegion& region = myRegions[index];
 
-      return ERR_NONE;
+  switch (region.type) {
+    case MemoryRegionType::delegate:
+      return std::get<2>(region.access)->fetch16(address, value, op, *this);
 
     default:
       return myDefaultDelegate
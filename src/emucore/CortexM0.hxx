@@ -29,6 +29,7 @@
 #include "bspf.hxx"
 
 class Serializer;
+class ArmProfiler;
 
 class CortexM0: public Serializable
 {
@@ -150,6 +151,13 @@ class CortexM0: public Serializable
       return myCycleCounter;
     }
 
+  #ifdef DEBUGGER_SUPPORT
+    /**
+      Attach a profiler, which samples the executed code (nullptr detaches).
+    */
+    void setProfiler(ArmProfiler* profiler) { myProfiler = profiler; }
+  #endif
+
   private:
 
     enum class MemoryRegionType: uInt8 {
@@ -182,6 +190,10 @@ class CortexM0: public Serializable
       uInt32 accessWatermarkLow{static_cast<uInt32>(~0)};
       uInt32 accessWatermarkHigh{0};
 
+      // Copy-on-write snapshots of the whole region, for states which
+      // support them
+      mutable PageSnapshot snapshot;
+
       std::variant<
         MemoryRegionAccessData,   // ::get<0>, directData
         MemoryRegionAccessCode,   // ::get<1>, directCode
@@ -220,11 +232,23 @@ class CortexM0: public Serializable
 
     std::array<MemoryRegion, 0x100> myRegions{};
     unique_ptr<uInt8[]> myPageMap;
+
+    // Flat lookup of the direct regions by region index (see myPageMap), so
+    // reads and fetches resolve without going through the MemoryRegion:
+    // the backing store (nullptr unless directData or directCode), the
+    // decoded instructions (nullptr unless directCode) and the base address
+    std::array<uInt8*, 0x100> myRegionStore{};
+    std::array<uInt8*, 0x100> myRegionOps{};
+    std::array<uInt32, 0x100> myRegionBase{};
     uInt8 myNextRegionIndex{0};
     BusTransactionDelegate* myDefaultDelegate{nullptr};
 
     uInt64 myCycleCounter{0};
 
+  #ifdef DEBUGGER_SUPPORT
+    ArmProfiler* myProfiler{nullptr};
+  #endif
+
     static constexpr uInt32
       CPSR_N = 1U << 31,
       CPSR_Z = 1U << 30,
@@ -20,6 +20,8 @@
 
 class System;
 
+#include <limits>
+
 #include "bspf.hxx"
 #include "ConsoleTiming.hxx"
 #include "Serializable.hxx"
@@ -63,7 +65,21 @@ class Device : public Serializable
     };
     using AccessFlags = uInt16;
 
+  #ifdef SMALL_ACCESS_COUNTERS
+    using AccessCounter = uInt8;
+  #else
     using AccessCounter = uInt32;
+  #endif
+
+    /**
+      Add the given number of accesses to an access counter.  The counter
+      saturates instead of wrapping around.
+    */
+    static constexpr void countAccess(AccessCounter& counter,
+                                      AccessCounter count = 1) {
+      constexpr AccessCounter maxCount = std::numeric_limits<AccessCounter>::max();
+      counter = counter > maxCount - count ? maxCount : counter + count;
+    }
 
   public:
     Device() = default;
@@ -112,6 +128,14 @@ class Device : public Serializable
     */
     bool load(Serializer& in) override = 0;
 
+    /**
+      Answer the number of bytes of memory owned by this device besides the
+      object itself, e.g. ROM, RAM and other buffers allocated on the heap.
+
+      @return  The number of bytes
+    */
+    virtual size_t memoryUsage() const { return 0; }
+
   public:
     /**
       Get the byte at the specified address
@@ -152,8 +176,11 @@ class Device : public Serializable
       Increase the given address's access counter
 
       @param address The address to modify
+      @param isWrite Whether the accesses were writes
+      @param count   The number of accesses
     */
-    virtual void increaseAccessCounter(uInt16 address, bool isWrite = false) { }
+    virtual void increaseAccessCounter(uInt16 address, bool isWrite = false,
+                                       AccessCounter count = 1) { }
 
     /**
       Query the access counters
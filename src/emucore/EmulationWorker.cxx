@@ -25,32 +25,39 @@
 using namespace std::chrono;
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-EmulationWorker::EmulationWorker()
+EmulationWorker::EmulationWorker(ThreadScheduling::Priority priority, int cpu,
+                                 ThreadScheduling::Handoff handoff)
+  : myPriority{priority},
+    myCpu{cpu}
 {
-  std::mutex mutex;
-  std::unique_lock<std::mutex> lock(mutex);
-  std::condition_variable threadInitialized;
+  switch(handoff)
+  {
+    case ThreadScheduling::Handoff::spin:
+      mySpinTime = duration_cast<Clock::duration>(microseconds(50));
+      break;
+
+    case ThreadScheduling::Handoff::run:
+      // About a frame; the worker only parks when emulation isn't resumed in time
+      mySpinTime = duration_cast<Clock::duration>(milliseconds(20));
+      break;
 
-  myThread = std::thread(
-    &EmulationWorker::threadMain, this, &threadInitialized, &mutex
-  );
+    default:
+      break;
+  }
 
-  // Wait until the thread has acquired myThreadIsRunningMutex and moved on
-  while (myState == State::initializing) threadInitialized.wait(lock);
+  myThread = std::thread(&EmulationWorker::threadMain, this);
+
+  // Wait until the thread has initialized
+  myState.wait(State::initializing);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 EmulationWorker::~EmulationWorker()
 {
-  // This has to run in a block in order to release the mutex before joining
-  {
-    const std::unique_lock<std::mutex> lock(myThreadIsRunningMutex);
+  State state = waitWhileRunning();
 
-    if (myState != State::exception) {
-      signalQuit();
-      myWakeupCondition.notify_one();
-    }
-  }
+  while(state != State::exception && !requestState(state, State::quit))
+    state = waitWhileRunning();
 
   myThread.join();
 
@@ -70,266 +77,251 @@ void EmulationWorker::handlePossibleException()
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void EmulationWorker::start(uInt32 cyclesPerSecond, uInt64 maxCycles, uInt64 minCycles, DispatchResult* dispatchResult, TIA* tia)
+void EmulationWorker::start(uInt32 cyclesPerSecond, uInt64 maxCycles, uInt64 minCycles, DispatchResult* dispatchResult, TIA* tia,
+                            double unpacedSeconds)
 {
-  // Wait until any pending signal has been processed
-  waitUntilPendingSignalHasProcessed();
-
-  // Run in a block to release the mutex before notifying; this avoids an unecessary
-  // block that will waste a timeslice
-  {
-    // Acquire the mutex -> wait until the thread is suspended
-    const std::unique_lock<std::mutex> lock(myThreadIsRunningMutex);
-
-    // Pass on possible exceptions
-    handlePossibleException();
-
-    // Make sure that we don't overwrite the exit condition.
-    // This case is hypothetical and cannot happen, but handling it does not hurt, either
-    if (myPendingSignal == Signal::quit) return;
-
-    // NB: The thread does not suspend execution in State::initialized
-    if (myState != State::waitingForResume)
-      fatal("start called on running or dead worker");
-
-    // Store the parameters for emulation
-    myTia = tia;
-    myCyclesPerSecond = cyclesPerSecond;
-    myMaxCycles = maxCycles;
-    myMinCycles = minCycles;
-    myDispatchResult = dispatchResult;
-
-    // Raise the signal...
-    myPendingSignal = Signal::resume;
-  }
+  // Pass on possible exceptions
+  handlePossibleException();
 
-  // ... and wakeup the thread
-  myWakeupCondition.notify_one();
+  // The worker is parked (or spinning) and doesn't touch the parameters until
+  // it sees the state change below
+  if (myState != State::waitingForResume)
+    fatal("start called on running or dead worker");
+
+  // Store the parameters for emulation
+  myTia = tia;
+  myCyclesPerSecond = cyclesPerSecond;
+  myMaxCycles = maxCycles;
+  myMinCycles = minCycles;
+  myDispatchResult = dispatchResult;
+  myUnpacedSeconds = unpacedSeconds;
+
+  // Publish the parameters and wake up the worker
+  if (!requestState(State::waitingForResume, State::resumeRequested))
+    fatal("worker state changed while starting");
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 uInt64 EmulationWorker::stop()
 {
-  // See EmulationWorker::start above for the gory details
-  waitUntilPendingSignalHasProcessed();
-
-  uInt64 totalCycles{0};
-  {
-    const std::unique_lock<std::mutex> lock(myThreadIsRunningMutex);
-
-    // Paranoia: make sure that we don't doublecount an emulation timeslice
-    totalCycles = myTotalCycles;
-    myTotalCycles = 0;
-
-    handlePossibleException();
-
-    if (myPendingSignal == Signal::quit) return totalCycles;
+  // Wait until the current timeslice (if any) is done. The worker may start
+  // another timeslice when its deadline passes before we get to stop it, so
+  // retry until the state change sticks.
+  State state = waitWhileRunning();
+  while (state == State::waitingForStop) {
+    // No need to wake up the worker, it will notice the change when its
+    // deadline has passed, or when it is resumed
+    State expected = State::waitingForStop;
+    if (myState.compare_exchange_strong(expected, State::waitingForResume))
+      break;
 
-    // If the worker has stopped on its own, we return
-    if (myState == State::waitingForResume) return totalCycles;
+    state = waitWhileRunning();
+  }
 
-    // NB: The thread does not suspend execution in State::initialized or State::running
-    if (myState != State::waitingForStop)
-      fatal("stop called on a dead worker");
+  handlePossibleException();
 
-    myPendingSignal = Signal::stop;
-  }
+  if (state != State::waitingForStop && state != State::waitingForResume)
+    fatal("stop called on a dead worker");
 
-  myWakeupCondition.notify_one();
+  // Paranoia: make sure that we don't doublecount an emulation timeslice
+  const uInt64 totalCycles = myTotalCycles;
+  myTotalCycles = 0;
 
   return totalCycles;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void EmulationWorker::threadMain(std::condition_variable* initializedCondition,
-                                 std::mutex* initializationMutex)
+void EmulationWorker::threadMain()
 {
-  std::unique_lock<std::mutex> lock(myThreadIsRunningMutex);
+  ThreadScheduling::setPriority(myPriority, ThreadScheduling::Task::emulation);
+  ThreadScheduling::setAffinity(myCpu);
 
-  try {
-    {
-      // Wait until our parent releases the lock and sleeps
-      const std::scoped_lock guard(*initializationMutex);
-
-      // Update the state...
-      myState = State::initialized;
-
-      // ... and wake up our parent to notifiy that we have initialized. From this point, the
-      // parent can safely assume that we are running while the mutex is locked.
-      initializedCondition->notify_one();
-    }
+  // Wake up our parent to notify that we have initialized
+  myState = State::waitingForResume;
+  myState.notify_all();
 
+  try {
     // Loop until we have an exit condition
-    while (myPendingSignal != Signal::quit) handleWakeup(lock);
+    for(;;) {
+      State state = myState;
+
+      switch (state) {
+        case State::resumeRequested:
+          if (!myState.compare_exchange_strong(state, State::running)) break;
+
+          // Reset virtual clock and cycle counter
+          myVirtualTime = Clock::now();
+          myTotalCycles = 0;
+
+          // Enter emulation. This will emulate a timeslice and set the state upon completion.
+          if (myUnpacedSeconds > 0)
+            dispatchUnpacedEmulation();
+          else
+            dispatchEmulation();
+          break;
+
+        case State::waitingForResume:
+          waitForChange(state);
+          break;
+
+        case State::waitingForStop:
+          if (myVirtualTime <= Clock::now()) {
+            // The time allotted to the emulation timeslice has passed and we haven't been stopped?
+            // -> go for another emulation timeslice
+            if (!myState.compare_exchange_strong(state, State::running)) break;
+
+            Logger::debug("Frame dropped!");
+            dispatchEmulation();
+          }
+          else
+            waitForChange(state, myVirtualTime);
+          break;
+
+        case State::quit:
+          return;
+
+        default:
+          fatal("wakeup in invalid worker state");
+      }
+    }
   }
   catch (...) {
-    // Store away the exception and the state accordingly
+    // Store away the exception and the state accordingly. This also makes sure
+    // that the main thread will not deadlock if it is waiting for us.
     myPendingException = std::current_exception();
-    myState = State::exception;
-
-    // Raising the exit condition is consistent and makes shure that the main thread
-    // will not deadlock if an exception is raised while it is waiting for a signal
-    // to be processed.
-    signalQuit();
+    setState(State::exception);
   }
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void EmulationWorker::handleWakeup(std::unique_lock<std::mutex>& lock)
+void EmulationWorker::dispatchEmulation()
 {
-  switch (myState) {
-    case State::initialized:
-      // Enter waitingForResume and sleep after initialization
-      myState = State::waitingForResume;
-      myWakeupCondition.wait(lock);
-      break;
+  uInt64 totalCycles = 0;
 
-    case State::waitingForResume:
-      handleWakeupFromWaitingForResume(lock);
-      break;
+  do {
+    myTia->update(*myDispatchResult, totalCycles > 0 ? myMinCycles - totalCycles : myMaxCycles);
+    totalCycles += myDispatchResult->getCycles();
+  } while (totalCycles < myMinCycles && myDispatchResult->getStatus() == DispatchResult::Status::ok);
 
-    case State::waitingForStop:
-      handleWakeupFromWaitingForStop(lock);
-      break;
+  myTotalCycles += totalCycles;
 
-    default:
-      fatal("wakeup in invalid worker state");
+  bool continueEmulating = false;
+
+  if (myDispatchResult->getStatus() == DispatchResult::Status::ok) {
+    // If emulation finished successfully, we are free to go for another round
+    const duration<double> timesliceSeconds(static_cast<double>(totalCycles) / static_cast<double>(myCyclesPerSecond));
+    myVirtualTime += duration_cast<Clock::duration>(timesliceSeconds);
+
+    // If we aren't fast enough to keep up with the emulation, we stop immediatelly to avoid
+    // starving the system for processing time --- emulation will stutter anyway.
+    continueEmulating = myVirtualTime > Clock::now();
   }
+
+  // If we are free to continue emulating, we wait until either the timeslice has passed or we
+  // have been stopped from the main thread. Otherwise, we just stop and wait to be resumed.
+  setState(continueEmulating ? State::waitingForStop : State::waitingForResume);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void EmulationWorker::handleWakeupFromWaitingForResume(std::unique_lock<std::mutex>& lock)
+void EmulationWorker::dispatchUnpacedEmulation()
 {
-  switch (myPendingSignal) {
-    case Signal::resume:
-      // Clear the pending signal and notify the main thread
-      clearSignal();
-
-      // Reset virtual clock and cycle counter
-      myVirtualTime = high_resolution_clock::now();
-      myTotalCycles = 0;
+  // The virtual clock is the deadline here; TIA::update returns at least once
+  // per frame, so we don't overshoot by much
+  myVirtualTime += duration_cast<Clock::duration>(duration<double>(myUnpacedSeconds));
 
-      // Enter emulation. This will emulate a timeslice and set the state upon completion.
-      dispatchEmulation(lock);
-      break;
-
-    case Signal::none:
-      // Reenter sleep on spurious wakeups
-      myWakeupCondition.wait(lock);
-      break;
-
-    case Signal::quit:
-      break;
+  do {
+    myTia->update(*myDispatchResult, myMaxCycles);
+    myTotalCycles += myDispatchResult->getCycles();
+  } while (myDispatchResult->getStatus() == DispatchResult::Status::ok &&
+           Clock::now() < myVirtualTime);
 
-    default:
-      fatal("invalid signal while waiting for resume");
-  }
+  // Stop on our own and wait to be resumed
+  setState(State::waitingForResume);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void EmulationWorker::handleWakeupFromWaitingForStop(std::unique_lock<std::mutex>& lock)
+void EmulationWorker::setState(State state)
 {
-  switch (myPendingSignal) {
-    case Signal::stop:
-      // Clear the pending signal and notify the main thread
-      clearSignal();
-
-      // Enter waiting for resume and sleep
-      myState = State::waitingForResume;
-      myWakeupCondition.wait(lock);
-      break;
-
-    case Signal::none:
-      if(myVirtualTime <= high_resolution_clock::now())
-        // The time allotted to the emulation timeslice has passed and we haven't been stopped?
-        // -> go for another emulation timeslice
-      {
-        Logger::debug("Frame dropped!");
-        dispatchEmulation(lock);
-      }
-      else
-        // Wakeup was spurious, reenter sleep
-        myWakeupCondition.wait_until(lock, myVirtualTime);
-
-      break;
-
-    case Signal::quit:
-      break;
-
-    default:
-      fatal("invalid signal while waiting for stop");
-  }
+  // Only the worker leaves State::running, so there is no race here
+  myState = state;
+  myState.notify_all();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void EmulationWorker::dispatchEmulation(std::unique_lock<std::mutex>& lock)
+bool EmulationWorker::requestState(State expected, State desired)
 {
-  // Technically, we could do without State::running, but it is cleaner and might be useful in the future
-  myState = State::running;
-
-  uInt64 totalCycles = 0;
+  if (!myState.compare_exchange_strong(expected, desired))
+    return false;
+
+  // The worker sets myWorkerParked before checking the state for the last
+  // time, so it either sees the new state, or we see that it is parked. Taking
+  // the mutex makes sure that it is actually waiting before we notify.
+  if (myWorkerParked) {
+    { const std::scoped_lock lock(myParkMutex); }
+    myParkCondition.notify_one();
+  }
 
-  do {
-    myTia->update(*myDispatchResult, totalCycles > 0 ? myMinCycles - totalCycles : myMaxCycles);
-    totalCycles += myDispatchResult->getCycles();
-  } while (totalCycles < myMinCycles && myDispatchResult->getStatus() == DispatchResult::Status::ok);
+  return true;
+}
 
-  myTotalCycles += totalCycles;
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+EmulationWorker::State EmulationWorker::waitWhileRunning()
+{
+  const auto spinUntil = Clock::now() + mySpinTime;
+  State state = myState;
 
-  bool continueEmulating = false;
+  while (state == State::resumeRequested || state == State::running) {
+    if (Clock::now() < spinUntil)
+      std::this_thread::yield();
+    else
+      myState.wait(state);
 
-  if (myDispatchResult->getStatus() == DispatchResult::Status::ok) {
-    // If emulation finished successfully, we are free to go for another round
-    const duration<double> timesliceSeconds(static_cast<double>(totalCycles) / static_cast<double>(myCyclesPerSecond));
-    myVirtualTime += duration_cast<high_resolution_clock::duration>(timesliceSeconds);
-
-    // If we aren't fast enough to keep up with the emulation, we stop immediatelly to avoid
-    // starving the system for processing time --- emulation will stutter anyway.
-    continueEmulating = myVirtualTime > high_resolution_clock::now();
+    state = myState;
   }
 
-  if (continueEmulating) {
-    // If we are free to continue emulating, we sleep until either the timeslice has passed or we
-    // have been signalled from the main thread
-    myState = State::waitingForStop;
-    myWakeupCondition.wait_until(lock, myVirtualTime);
-  } else {
-    // If can't continue, we just stop and wait to be signalled
-    myState = State::waitingForResume;
-    myWakeupCondition.wait(lock);
-  }
+  return state;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void EmulationWorker::clearSignal()
+void EmulationWorker::waitForChange(State state, Clock::time_point deadline)
 {
-  {
-    const std::unique_lock<std::mutex> lock(mySignalChangeMutex);
-    myPendingSignal = Signal::none;
+  if (deadline == Clock::time_point::max()) {
+    // Waiting to be resumed: spin for a while, then park
+    if (!spinWhile(state, Clock::now() + mySpinTime))
+      park(state, deadline);
+  }
+  else {
+    // Waiting for the deadline: park until shortly before, then spin to hit
+    // it exactly (the OS usually wakes us up too late)
+    park(state, deadline - mySpinTime);
+    spinWhile(state, deadline);
   }
-
-  mySignalChangeCondition.notify_one();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void EmulationWorker::signalQuit()
+bool EmulationWorker::spinWhile(State state, Clock::time_point until) const
 {
-  {
-    const std::unique_lock<std::mutex> lock(mySignalChangeMutex);
-    myPendingSignal = Signal::quit;
+  while (myState == state) {
+    if (Clock::now() >= until) return false;
+    std::this_thread::yield();
   }
 
-  mySignalChangeCondition.notify_one();
+  return true;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void EmulationWorker::waitUntilPendingSignalHasProcessed()
+void EmulationWorker::park(State state, Clock::time_point until)
 {
-  std::unique_lock<std::mutex> lock(mySignalChangeMutex);
+  std::unique_lock<std::mutex> lock(myParkMutex);
+
+  myWorkerParked = true;
+
+  if (until == Clock::time_point::max())
+    myParkCondition.wait(lock, [&]{ return myState != state; });
+  else
+    myParkCondition.wait_until(lock, until, [&]{ return myState != state; });
 
-  // White until there is no pending signal (or the exit condition has been raised)
-  while (myPendingSignal != Signal::none && myPendingSignal != Signal::quit)
-    mySignalChangeCondition.wait(lock);
+  myWorkerParked = false;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -33,6 +33,16 @@
  * In combination, the scheduling in the main loop and the microscheduling in the worker
  * ensure that the emulation continues to run even if rendering blocks, ensuring the real
  * time scheduling required for cycle exact audio to work.
+ *
+ * The handoff between both threads is a single atomic state. The main thread only ever
+ * waits while the worker is emulating a timeslice; stopping a sleeping worker and starting
+ * it again are plain state changes, which wake up the worker only if it is parked. How the
+ * threads wait is selected by the handoff mode ('threads.handoff'):
+ *   park   Park right away (the OS wakes the thread up)
+ *   spin   Spin briefly before parking, and wake up shortly before each deadline to spin
+ *          up to it, which avoids the wakeup latency and jitter of the OS scheduler
+ *   run    Keep spinning for up to a frame, so the worker free-runs against its deadline
+ *          and is never parked during emulation (costs a CPU core)
  */
 
 #ifndef EMULATION_WORKER_HXX
@@ -46,6 +56,7 @@
 #include <chrono>
 
 #include "bspf.hxx"
+#include "ThreadScheduling.hxx"
 
 class TIA;
 class DispatchResult;
@@ -56,8 +67,11 @@ class EmulationWorker
 
     /**
       The constructor starts the worker thread and waits until it has initialized.
+      The thread runs with the given priority, pinned to the given CPU (if any).
      */
-    EmulationWorker();
+    explicit EmulationWorker(ThreadScheduling::Priority priority = ThreadScheduling::Priority::normal,
+                             int cpu = -1,
+                             ThreadScheduling::Handoff handoff = ThreadScheduling::Handoff::park);
 
     /**
       The destructor signals quit to the worker and joins.
@@ -66,14 +80,42 @@ class EmulationWorker
 
     /**
       Wake up the worker and start emulation with the specified parameters.
+
+      If unpacedSeconds is positive, the worker does not pace emulation to
+      real time, but emulates as fast as possible for the given time and then
+      stops on its own (benchmark mode).
      */
-    void start(uInt32 cyclesPerSecond, uInt64 maxCycles, uInt64 minCycles, DispatchResult* dispatchResult, TIA* tia);
+    void start(uInt32 cyclesPerSecond, uInt64 maxCycles, uInt64 minCycles, DispatchResult* dispatchResult, TIA* tia,
+               double unpacedSeconds = 0.);
 
     /**
       Stop emulation and return the number of 6507 cycles emulated.
      */
     uInt64 stop();
 
+  private:
+  /**
+    Thread state.
+   */
+    enum class State: uInt8 {
+      // Initial state
+      initializing,
+      // Sleeping and waiting for emulation to be resumed
+      waitingForResume,
+      // Emulation has been resumed by the main thread, but not started yet
+      resumeRequested,
+      // Running and emulating
+      running,
+      // Sleeping and waiting for emulation to be stopped
+      waitingForStop,
+      // Quit signalled during destruction
+      quit,
+      // An exception occurred and the thread has terminated (or is terminating)
+      exception
+    };
+
+    using Clock = std::chrono::high_resolution_clock;
+
   private:
 
     /**
@@ -83,121 +125,98 @@ class EmulationWorker
 
     /**
       The main thread entry point.
-      Passing references into a thread is awkward and requires std::ref -> use pointers here
      */
-    void threadMain(std::condition_variable* initializedCondition, std::mutex* initializationMutex);
+    void threadMain();
 
     /**
-      Handle thread wakeup after sleep depending on the thread state.
+      Run the emulation, and adjust the thread state according to the result.
      */
-    void handleWakeup(std::unique_lock<std::mutex>& lock);
+    void dispatchEmulation();
 
     /**
-      Handle wakeup while sleeping and waiting to be resumed.
+      Run the emulation at full speed until the unpaced time is up, then wait
+      to be resumed.
      */
-    void handleWakeupFromWaitingForResume(std::unique_lock<std::mutex>& lock);
+    void dispatchUnpacedEmulation();
 
     /**
-      Handle wakeup while sleeping and waiting to be stopped (or for the timeslice
-      to expire).
+      Leave State::running on the worker, and wake up the main thread.
      */
-    void handleWakeupFromWaitingForStop(std::unique_lock<std::mutex>& lock);
+    void setState(State state);
 
     /**
-      Run the emulation, adjust the thread state according to the result and sleep.
+      Change the state on the main thread and wake up the worker.
+
+      @return  False if the state wasn't the expected one
      */
-    void dispatchEmulation(std::unique_lock<std::mutex>& lock);
+    bool requestState(State expected, State desired);
 
     /**
-      Clear any pending signal and wake up the main thread (if it is waiting for the signal
-      to be cleared).
+      Wait on the main thread until the worker has finished its timeslice.
+
+      @return  The new state
      */
-    void clearSignal();
+    State waitWhileRunning();
 
     /**
-     * Signal quit and wake up the main thread if applicable.
+      Wait on the worker until the state changes, or the deadline (if any) is
+      reached.
      */
-    void signalQuit();
+    void waitForChange(State state, Clock::time_point deadline = Clock::time_point::max());
 
     /**
-      Wait and sleep until a pending signal has been processed (or quit sigmalled).
-      This is called from the main thread.
+      Spin until the state changes or the given time is reached.
+
+      @return  True if the state changed
      */
-    void waitUntilPendingSignalHasProcessed();
+    bool spinWhile(State state, Clock::time_point until) const;
 
     /**
-      Log a fatal error to cerr and throw a runtime exception.
+      Sleep until the state changes or the given time is reached.
      */
-    [[noreturn]] static void fatal(const string& message);
-
-  private:
-  /**
-    Thread state.
-   */
-    enum class State: uInt8 {
-      // Initial state
-      initializing,
-      // Thread has initialized. From the point, myThreadIsRunningMutex is locked if and only if
-      // the thread is running.
-      initialized,
-      // Sleeping and waiting for emulation to be resumed
-      waitingForResume,
-      // Running and emulating
-      running,
-      // Sleeping and waiting for emulation to be stopped
-      waitingForStop,
-      // An exception occurred and the thread has terminated (or is terminating)
-      exception
-    };
+    void park(State state, Clock::time_point until);
 
     /**
-      Thread behavior is controlled by signals that are raised prior to waking up the thread.
+      Log a fatal error to cerr and throw a runtime exception.
      */
-    enum class Signal: uInt8 {
-      // Resume emulation
-      resume,
-      // Stop emulation
-      stop,
-      // Quit (either during destruction or after an exception)
-      quit,
-      // No pending signal
-      none
-    };
+    [[noreturn]] static void fatal(const string& message);
 
   private:
 
     // Worker thread
     std::thread myThread;
 
-    // Condition variable for waking up the thread
-    std::condition_variable myWakeupCondition;
-    // The thread is running if and only if while this mutex is locked
-    std::mutex myThreadIsRunningMutex;
+    // Scheduling of the worker thread, applied when it starts
+    ThreadScheduling::Priority myPriority{ThreadScheduling::Priority::normal};
+    int myCpu{-1};
+
+    // How long to spin before parking (see the handoff modes above)
+    Clock::duration mySpinTime{0};
+
+    // The state is changed by both threads; the main thread waits on it directly
+    std::atomic<State> myState{State::initializing};
 
-    // Condition variable to signal changes to the pending signal
-    std::condition_variable mySignalChangeCondition;
-    // This mutex guards reading and writing the pending signal.
-    std::mutex mySignalChangeMutex;
+    // The worker parks on this condition variable; the main thread only needs
+    // to lock the mutex (to avoid a lost wakeup) if the worker is parked
+    std::condition_variable myParkCondition;
+    std::mutex myParkMutex;
+    std::atomic<bool> myWorkerParked{false};
 
     // Any exception on the worker thread is saved here to be rethrown on the main thread.
     std::exception_ptr myPendingException;
 
-    // Any pending signal (or Signal::none)
-    Signal myPendingSignal{Signal::none};
-    // The initial access to myState is not synchronized -> make this atomic
-    std::atomic<State> myState{State::initializing};
-
-    // Emulation parameters
+    // Emulation parameters, passed on by the change to State::resumeRequested
     TIA* myTia{nullptr};
     uInt64 myCyclesPerSecond{0};
     uInt64 myMaxCycles{0};
     uInt64 myMinCycles{0};
     DispatchResult* myDispatchResult{nullptr};
+    double myUnpacedSeconds{0.};
 
     // Total number of cycles during this emulation run
     uInt64 myTotalCycles{0};
-    // 6507 time
-    std::chrono::time_point<std::chrono::high_resolution_clock> myVirtualTime;
+    // 6507 time, the deadline for the next timeslice
+    Clock::time_point myVirtualTime;
 
   private:
 
@@ -18,7 +18,7 @@
 #ifndef EVENT_HXX
 #define EVENT_HXX
 
-#include <mutex>
+#include <atomic>
 #include <set>
 
 #include "bspf.hxx"
@@ -183,6 +183,7 @@ class Event
       SALeftAxis0Value, SALeftAxis1Value, SARightAxis0Value, SARightAxis1Value,
       QTPaddle3AFire, QTPaddle3BFire, QTPaddle4AFire, QTPaddle4BFire,
       UIHelp,
+      ToggleVideoRecording,
       LastType
     };
 
@@ -213,18 +214,14 @@ class Event
       Get the value associated with the event of the specified type.
     */
     Int32 get(Type type) const {
-      const std::scoped_lock lock(myMutex);
-
-      return myValues[type];
+      return myValues[type].load(std::memory_order_relaxed);
     }
 
     /**
       Set the value associated with the event of the specified type.
     */
     void set(Type type, Int32 value) {
-      const std::scoped_lock lock(myMutex);
-
-      myValues[type] = value;
+      myValues[type].store(value, std::memory_order_relaxed);
     }
 
     /**
@@ -232,9 +229,8 @@ class Event
     */
     void clear()
     {
-      const std::scoped_lock lock(myMutex);
-
-      myValues.fill(Event::NoType);
+      for(auto& value: myValues)
+        value.store(Event::NoType, std::memory_order_relaxed);
     }
 
     /**
@@ -257,10 +253,11 @@ class Event
     }
 
   private:
-    // Array of values associated with each event type
-    std::array<Int32, LastType> myValues;
-
-    mutable std::mutex myMutex;
+    // Array of values associated with each event type.  The values are set
+    // by the main thread and read by the emulation thread (controllers poll
+    // them many times per frame), so each one is a lock-free atomic.
+    // Values are independent of each other, so relaxed ordering suffices.
+    std::array<std::atomic<Int32>, LastType> myValues;
 
   private:
     // Following constructors and assignment operators not supported
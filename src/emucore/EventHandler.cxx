@@ -16,6 +16,7 @@
 //============================================================================
 
 #include <sstream>
+#include <thread>
 
 #include "Logger.hxx"
 
@@ -63,6 +64,7 @@
   #include "DialogContainer.hxx"
   #include "Launcher.hxx"
   #include "TimeMachine.hxx"
+  #include "VideoRecorder.hxx"
   #include "FileListWidget.hxx"
   #include "ScrollBarWidget.hxx"
 #endif
@@ -267,6 +269,11 @@ bool EventHandler::hasMouseControl() const
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void EventHandler::poll(uInt64 time)
 {
+  // Handle the events held back by pollAnalog()
+  for(const auto& [event, value, repeated]: myDeferredEvents)
+    handleEvent(event, value, repeated);
+  myDeferredEvents.clear();
+
   // Process events from the underlying hardware
   pollEvent();
 
@@ -274,7 +281,11 @@ void EventHandler::poll(uInt64 time)
   // related to emulation
   if(myState == EventHandlerState::EMULATION)
   {
-    myOSystem.console().riot().update();
+    // Movies record the input, or replace it, before the controllers see it
+    myOSystem.state().updateMovie(myEvent);
+    // During netplay, the input of both players is passed per frame
+    if(myOSystem.state().mode() != StateManager::Mode::Netplay)
+      myOSystem.console().riot().update();
 
     // Now check if the StateManager should be saving or loading state
     // (for rewind and/or movies
@@ -282,8 +293,7 @@ void EventHandler::poll(uInt64 time)
       myOSystem.state().update();
 
   #ifdef CHEATCODE_SUPPORT
-    for(const auto& cheat: myOSystem.cheat().perFrame())
-      cheat->evaluate();
+    myOSystem.cheat().evaluatePerFrame();
   #endif
 
   #ifdef IMAGE_SUPPORT
@@ -313,6 +323,27 @@ void EventHandler::enableTextEvents(bool enable)
   myOSystem.frameBuffer().enableTextEvents(enable);
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void EventHandler::pollAnalog()
+{
+  if(myState != EventHandlerState::EMULATION)
+    return;
+
+  myDeferEvents = true;
+  pollAnalogEvents();
+  myDeferEvents = false;
+
+  myOSystem.console().leftController().updateAnalog();
+  myOSystem.console().rightController().updateAnalog();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void EventHandler::waitEvent(uInt32 timeout)
+{
+  // Without a way to wait for the hardware, just sleep
+  std::this_thread::sleep_for(std::chrono::milliseconds(timeout));
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void EventHandler::handleTextEvent(char text)
 {
@@ -432,6 +463,14 @@ void EventHandler::handleEvent(Event::Type event, Int32 value, bool repeated)
   // or need to be preprocessed before passing them on
   const bool pressed = (value != 0);
 
+  // Only controllers may be changed in the middle of a frame
+  if(myDeferEvents && !JoystickEvents.contains(event) && !PaddlesEvents.contains(event) &&
+     !DrivingEvents.contains(event) && !KeyboardEvents.contains(event))
+  {
+    myDeferredEvents.push_back({event, value, repeated});
+    return;
+  }
+
   // Abort if global keys are pressed
   if(myGlobalKeyHandler->handleEvent(event, pressed, repeated))
     return;
@@ -1579,6 +1618,12 @@ void EventHandler::handleEvent(Event::Type event, Int32 value, bool repeated)
       if(pressed && !repeated) myOSystem.frameBuffer().tiaSurface().saveSnapShot();
       return;
 
+  #ifdef GUI_SUPPORT
+    case Event::ToggleVideoRecording:
+      if(pressed && !repeated) myOSystem.videoRecorder().toggleRecording();
+      return;
+  #endif
+
     case Event::ExitMode:
       // Special handling for Escape key
       // Basically, exit whichever mode we're currently in
@@ -2862,6 +2907,7 @@ EventHandler::EmulActionList EventHandler::ourEmulActionList = { {
   { Event::ToggleContSnapshots,     "Save continuous snapsh. (as defined)"  },
   { Event::ToggleContSnapshotsFrame,"Save continuous snapsh. (every frame)" },
 #endif
+  { Event::ToggleVideoRecording,    "Start/stop video recording"            },
   // Global keys:
   { Event::PreviousSettingGroup,    "Select previous setting group"         },
   { Event::NextSettingGroup,        "Select next setting group"             },
@@ -3163,6 +3209,7 @@ const Event::EventSet EventHandler::MiscEvents = {
   Event::ToggleBezel, Event::PlusRomsSetupMode, Event::ExitMode,
   Event::ToggleTurbo, Event::DecreaseSpeed, Event::IncreaseSpeed,
   Event::TakeSnapshot, Event::ToggleContSnapshots, Event::ToggleContSnapshotsFrame,
+  Event::ToggleVideoRecording,
   // Event::MouseAxisXMove, Event::MouseAxisYMove,
   // Event::MouseButtonLeftValue, Event::MouseButtonRightValue,
   Event::HighScoresMenuMode,
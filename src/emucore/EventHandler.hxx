@@ -68,6 +68,7 @@ class EventHandler
       @return The event object
     */
     const Event& event() const { return myEvent; }
+    Event& event() { return myEvent; }
 
     /**
       Initialize state of this eventhandler.
@@ -111,6 +112,29 @@ class EventHandler
     */
     void poll(uInt64 time);
 
+    /**
+      Collects and dispatches pending analog controller events (joystick
+      axes) only, and updates the analog inputs of the controllers.  This
+      may be called between two calls of poll(), in the middle of a frame,
+      so that e.g. paddle positions are sampled at a higher rate.  Any
+      non-controller event triggered meanwhile is deferred to the next
+      poll().
+    */
+    void pollAnalog();
+
+    /**
+      Block until an event from the underlying hardware is pending (which
+      is then dispatched by the next poll()), or the timeout has passed.
+
+      @param timeout  The maximum time to wait, in milliseconds
+    */
+    virtual void waitEvent(uInt32 timeout);
+
+    /**
+      Answer whether the last poll() received any events from the hardware.
+    */
+    bool receivedEvents() const { return myReceivedEvents; }
+
     /**
       Get/set the current state of the EventHandler.
 
@@ -427,6 +451,15 @@ class EventHandler
     */
     virtual void pollEvent() = 0;
 
+    // Set by pollEvent() if it received any events
+    bool myReceivedEvents{false};
+
+    /**
+      Collects and dispatches any pending analog controller events,
+      leaving all other events pending.
+    */
+    virtual void pollAnalogEvents() { }
+
     // Other events that can be received from the underlying event handler
     enum class SystemEvent: uInt8 {
       WINDOW_SHOWN,
@@ -526,6 +559,16 @@ class EventHandler
     // state change; we detect when this happens and discard the event
     bool mySkipMouseMotion{true};
 
+    // Non-controller events triggered during pollAnalog(), which are only
+    // handled by the next poll() (they may e.g. reload the console)
+    struct DeferredEvent {
+      Event::Type event{Event::NoType};
+      Int32 value{0};
+      bool repeated{false};
+    };
+    std::vector<DeferredEvent> myDeferredEvents;
+    bool myDeferEvents{false};
+
     // Whether the currently enabled console is emulating certain aspects
     // of the 7800 (for now, only the switches are notified)
     bool myIs7800{false};
@@ -545,7 +588,7 @@ class EventHandler
     #else
       REFRESH_SIZE         = 0,
     #endif
-      EMUL_ACTIONLIST_SIZE = 242 + PNG_SIZE + COMBO_SIZE + REFRESH_SIZE,
+      EMUL_ACTIONLIST_SIZE = 243 + PNG_SIZE + COMBO_SIZE + REFRESH_SIZE,
       MENU_ACTIONLIST_SIZE = 20
     ;
 
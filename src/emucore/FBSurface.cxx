@@ -17,6 +17,14 @@
 
 #include <cmath>
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+  #define FBSURFACE_SSE2
+  #include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__) || defined(_M_ARM64)
+  #define FBSURFACE_NEON
+  #include <arm_neon.h>
+#endif
+
 #include "Rect.hxx"
 #include "FrameBuffer.hxx"
 #include "FBSurface.hxx"
@@ -52,6 +60,7 @@ void FBSurface::readPixels(uInt8* buffer, uInt32 pitch, const Common::Rect& rect
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void FBSurface::pixel(uInt32 x, uInt32 y, ColorId color)
 {
+  setDirty(x, y, 1, 1);
   // Note: checkbounds() must be done in calling method
   uInt32* buffer = myPixels + (y * static_cast<size_t>(myPitch)) + x;
 
@@ -120,16 +129,38 @@ void FBSurface::line(uInt32 x, uInt32 y, uInt32 x2, uInt32 y2, ColorId color)
   }
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void FBSurface::fillPixels(uInt32* buffer, size_t count, uInt32 pixel)
+{
+  size_t i = 0;
+
+  // Store four pixels at once; most GUI fills are wide enough
+#if defined(FBSURFACE_SSE2)
+  const __m128i pixels = _mm_set1_epi32(static_cast<int>(pixel));
+  for(; i + 4 <= count; i += 4)
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(buffer + i), pixels);
+#elif defined(FBSURFACE_NEON)
+  const uint32x4_t pixels = vdupq_n_u32(pixel);
+  for(; i + 4 <= count; i += 4)
+    vst1q_u32(buffer + i, pixels);
+#endif
+
+  // Scalar code for the remaining pixels (or all, if SIMD is not available)
+  for(; i < count; ++i)
+    buffer[i] = pixel;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void FBSurface::hLine(uInt32 x, uInt32 y, uInt32 x2, ColorId color)
 {
-  if(!checkBounds(x, y) || !checkBounds(x2, 2))
+  if(!checkBounds(x, y) || !checkBounds(x2, y))
     return;
 
+  setDirty(x, y, x2 - x + 1, 1);
   // NOLINTNEXTLINE (erroneously marked as const)
   uInt32* buffer = myPixels + (y * static_cast<size_t>(myPitch)) + x;
-  while(x++ <= x2)
-    *buffer++ = myPalette[color];
+  if(x <= x2)
+    fillPixels(buffer, x2 - x + 1, myPalette[color]);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -138,6 +169,7 @@ void FBSurface::vLine(uInt32 x, uInt32 y, uInt32 y2, ColorId color)
   if(!checkBounds(x, y) || !checkBounds(x, y2))
     return;
 
+  setDirty(x, y, 1, y2 - y + 1);
   uInt32* buffer = myPixels + (y * static_cast<size_t>(myPitch)) + x;
   while(y++ <= y2)
   {
@@ -149,8 +181,17 @@ void FBSurface::vLine(uInt32 x, uInt32 y, uInt32 y2, ColorId color)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void FBSurface::fillRect(uInt32 x, uInt32 y, uInt32 w, uInt32 h, ColorId color)
 {
-  while(h--)
-    hLine(x, y+h, x+w-1, color);
+  if(w == 0 || h == 0 || !checkBounds(x, y) || !checkBounds(x + w - 1, y))
+    return;
+
+  // Like drawing each line separately, skip the lines below the surface
+  h = std::min(h, height() - y);
+  setDirty(x, y, w, h);
+  uInt32* buffer = myPixels + (y * static_cast<size_t>(myPitch)) + x;
+  const uInt32 pixel = myPalette[color];
+
+  for(; h--; buffer += myPitch)
+    fillPixels(buffer, w, pixel);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -198,20 +239,12 @@ void FBSurface::drawChar(const GUI::Font& font, uInt8 chr,
   if(!checkBounds(cx , cy) || !checkBounds(cx + bbw - 1, cy + bbh - 1))
     return;
 
-  const uInt16* tmp = desc.bits + (desc.offset ? desc.offset[chr] : (chr * desc.fbbh));
+  setDirty(cx, cy, bbw, bbh);
   uInt32* buffer = myPixels + (cy * static_cast<size_t>(myPitch)) + cx;
+  const uInt32 pixel = myPalette[color];
 
-  for(int y = 0; y < bbh; y++)
-  {
-    const uInt16 ptr = *tmp++;
-    uInt16 mask = 0x8000;
-
-    for(int x = 0; x < bbw; x++, mask >>= 1)
-      if(ptr & mask)
-        buffer[x] = myPalette[color];
-
-    buffer += myPitch;
-  }
+  for(const auto& run: font.glyphRuns(chr))
+    fillPixels(buffer + run.y * static_cast<size_t>(myPitch) + run.x, run.w, pixel);
 #endif
 }
 
@@ -229,16 +262,30 @@ void FBSurface::drawBitmap(const uInt32* bitmap, uInt32 tx, uInt32 ty,
   if(!checkBounds(tx, ty) || !checkBounds(tx + w - 1, ty + h - 1))
     return;
 
+  if(w == 0 || w > 32)
+    return;
+
+  setDirty(tx, ty, w, h);
   uInt32* buffer = myPixels + (ty * static_cast<size_t>(myPitch)) + tx;
+  const uInt32 pixel = myPalette[color];
 
-  for(uInt32 y = 0; y < h; ++y)
+  for(uInt32 y = 0; y < h; ++y, buffer += myPitch)
   {
-    uInt32 mask = 1 << (w - 1);
-    for(uInt32 x = 0; x < w; ++x, mask >>= 1)
-      if(bitmap[y] & mask)
-        buffer[x] = myPalette[color];
+    // Move the leftmost pixel to the MSB, and fill each run of set bits
+    uInt32 bits = bitmap[y] << (32 - w);
+    uInt32 x = 0;
 
-    buffer += myPitch;
+    while(bits)
+    {
+      const int skip = std::countl_zero(bits);
+      bits <<= skip;
+      x += skip;
+
+      const int run = std::countl_one(bits);
+      fillPixels(buffer + x, run, pixel);
+      bits = run < 32 ? bits << run : 0;
+      x += run;
+    }
   }
 }
 
@@ -248,11 +295,11 @@ void FBSurface::drawPixels(const uInt32* data, uInt32 tx, uInt32 ty, uInt32 nump
   if(!checkBounds(tx, ty) || !checkBounds(tx + numpixels - 1, ty))
     return;
 
+  setDirty(tx, ty, numpixels, 1);
   // NOLINTNEXTLINE (erroneously marked as const)
   uInt32* buffer = myPixels + (ty * static_cast<size_t>(myPitch)) + tx;
 
-  for(uInt32 i = 0; i < numpixels; ++i)
-    *buffer++ = data[i];
+  std::copy_n(data, numpixels, buffer);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
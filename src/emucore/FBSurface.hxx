@@ -28,6 +28,8 @@ namespace Common {
   struct Rect;
 }  // namespace Common
 
+#include <limits>
+
 #include "FrameBufferConstants.hxx"
 #include "FrameBuffer.hxx"
 #include "bspf.hxx"
@@ -53,11 +55,42 @@ class FBSurface
 
     /**
       This method returns the surface pixel pointer and pitch, which are
-      used when one wishes to modify the surface pixels directly.
+      used when one wishes to modify the surface pixels directly.  The
+      surface is then assumed to be modified.
     */
     void basePtr(uInt32*& pixels, uInt32& pitch) const {
       pixels = myPixels;
       pitch = myPitch;
+      myDirtyX1 = myDirtyY1 = 0;
+      myDirtyX2 = myDirtyY2 = std::numeric_limits<uInt32>::max();
+    }
+
+    /**
+      This method answers the number of bytes used by the surface pixels.
+    */
+    size_t memoryUsage() const {
+      return static_cast<size_t>(myPitch) * height() * sizeof(uInt32);
+    }
+
+    /**
+      Answer whether the surface pixels were modified since they were last
+      rendered.  Unmodified surfaces don't have to be uploaded again.
+    */
+    bool isDirty() const { return myDirtyX1 < myDirtyX2; }
+
+    /**
+      Get the bounding box of the pixels modified since the surface was last
+      rendered, so that only this area has to be uploaded again.  Note that
+      the box may extend beyond the surface (when all of it was modified).
+
+      @param x  The left edge of the box
+      @param y  The top edge of the box
+      @param w  The width of the box (0 if unmodified)
+      @param h  The height of the box (0 if unmodified)
+    */
+    void dirtyRect(uInt32& x, uInt32& y, uInt32& w, uInt32& h) const {
+      x = myDirtyX1;  w = isDirty() ? myDirtyX2 - myDirtyX1 : 0;
+      y = myDirtyY1;  h = isDirty() ? myDirtyY2 - myDirtyY1 : 0;
     }
 
     /**
@@ -338,6 +371,18 @@ class FBSurface
     */
     virtual bool render() = 0;
 
+    /**
+      These methods give direct access to the pixels drawn by the next
+      render() call (e.g. a locked streaming texture), which saves copying
+      the surface pixels there.  All pixels within the source rectangle must
+      be written, since their old content is undefined.  Pixels are always
+      written in the native 32-bit format, and the pitch is given in pixels.
+
+      @return  False if not supported; basePtr() must be used instead
+    */
+    virtual bool lockPixels(uInt32*& pixels, uInt32& pitch) { return false; }
+    virtual void unlockPixels() { }
+
     /**
       This method should be called to reset the surface to empty
       pixels / colour black.
@@ -403,6 +448,26 @@ class FBSurface
     */
     bool checkBounds(uInt32 x, uInt32 y) const;
 
+    /**
+      Fill the given number of pixels with the same value (using SIMD
+      stores where available).
+    */
+    static void fillPixels(uInt32* buffer, size_t count, uInt32 pixel);
+
+    // Mark all or some of the surface pixels as modified, or all as rendered
+    void setDirty() {
+      myDirtyX1 = myDirtyY1 = 0;
+      myDirtyX2 = myDirtyY2 = std::numeric_limits<uInt32>::max();
+    }
+    void setDirty(uInt32 x, uInt32 y, uInt32 w, uInt32 h) {
+      myDirtyX1 = std::min(myDirtyX1, x);  myDirtyX2 = std::max(myDirtyX2, x + w);
+      myDirtyY1 = std::min(myDirtyY1, y);  myDirtyY2 = std::max(myDirtyY2, y + h);
+    }
+    void setClean() {
+      myDirtyX1 = myDirtyY1 = std::numeric_limits<uInt32>::max();
+      myDirtyX2 = myDirtyY2 = 0;
+    }
+
     /**
       Check if the given character is a whitespace.
       @param c      Character to check
@@ -416,6 +481,11 @@ class FBSurface
   protected:
     uInt32* myPixels{nullptr};  // NOTE: MUST be set in child classes
     uInt32 myPitch{0};          // NOTE: MUST be set in child classes
+    // The bounding box (right and bottom edges exclusive) of the modified
+    // pixels; initially all pixels are considered modified
+    mutable uInt32 myDirtyX1{0}, myDirtyY1{0};
+    mutable uInt32 myDirtyX2{std::numeric_limits<uInt32>::max()},
+                   myDirtyY2{std::numeric_limits<uInt32>::max()};
     bool myEnableBlend{false};
     uInt32 myBlendLevel{100};
 
@@ -19,6 +19,7 @@
 
 #include "FSNodeFactory.hxx"
 #include "FSNode.hxx"
+#include "MD5.hxx"
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 FSNode::FSNode(const AbstractFSNodePtr& realNode)
@@ -306,8 +307,33 @@ size_t FSNode::getSize() const
   return (_realNode && _realNode->exists()) ? _realNode->getSize() : 0;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt64 FSNode::getLastModified() const
+{
+  return (_realNode && _realNode->exists()) ? _realNode->getLastModified() : 0;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 size_t FSNode::read(ByteBuffer& buffer, size_t size) const
+{
+  return read(buffer, size, nullptr);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+size_t FSNode::read(ByteBuffer& buffer, size_t size, string& md5) const
+{
+  md5.clear();
+  const size_t sizeRead = read(buffer, size, &md5);
+
+  // Hash afterwards if the private subclass couldn't do it while reading
+  if(md5.empty())
+    md5 = MD5::hash(buffer, sizeRead);
+
+  return sizeRead;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+size_t FSNode::read(ByteBuffer& buffer, size_t size, string* md5) const
 {
   // File must actually exist
   if(!(exists() && isReadable()))
@@ -315,7 +341,8 @@ size_t FSNode::read(ByteBuffer& buffer, size_t size) const
 
   // First let the private subclass attempt to open the file
   if(_realNode)
-    if(const auto sizeRead = _realNode->read(buffer, size); sizeRead > 0)
+    if(const auto sizeRead = md5 ? _realNode->read(buffer, size, *md5)
+                                 : _realNode->read(buffer, size); sizeRead > 0)
       return sizeRead;
 
   // Otherwise, the default behaviour is to read from a normal C++ ifstream
@@ -252,10 +252,19 @@ class FSNode
      */
     size_t getSize() const;
 
+    /**
+     * Get the last modification time of the current node path.
+     *
+     * @return  Seconds since the epoch, or 0 if the time is not available
+     */
+    uInt64 getLastModified() const;
+
     /**
      * Read data (binary format) into the given buffer.
      *
      * @param buffer  The buffer to contain the data (allocated in this method).
+     *                Depending on the platform, this may be a private
+     *                copy-on-write mapping of the file rather than a copy.
      * @param size    The amount of data to read (0 means read all data).
      *
      * @return  The number of bytes read (0 in the case of failure)
@@ -264,6 +273,21 @@ class FSNode
      */
     size_t read(ByteBuffer& buffer, size_t size = 0) const;
 
+    /**
+     * Same as above, but also compute the MD5 of the data read.  Nodes which
+     * can do so while reading (i.e. files inside ZIP archives, which are
+     * hashed while being decompressed) avoid a second pass over the data.
+     *
+     * @param buffer  The buffer to contain the data (allocated in this method).
+     * @param size    The amount of data to read (0 means read all data).
+     * @param md5     The MD5 of the data read.
+     *
+     * @return  The number of bytes read (0 in the case of failure)
+     *          This method can throw exceptions, and should be used inside
+     *          a try-catch block.
+     */
+    size_t read(ByteBuffer& buffer, size_t size, string& md5) const;
+
     /**
      * Read data (text format) into the given stream.
      *
@@ -326,6 +350,7 @@ class FSNode
     explicit FSNode(const AbstractFSNodePtr& realNode);
     AbstractFSNodePtr _realNode;
     void setPath(string_view path);
+    size_t read(ByteBuffer& buffer, size_t size, string* md5) const;
 };
 
 
@@ -469,6 +494,13 @@ class AbstractFSNode
      */
     virtual size_t getSize() const { return 0; }
 
+    /**
+     * Get the last modification time of the current node path.
+     *
+     * @return  Seconds since the epoch, or 0 if the time is not available
+     */
+    virtual uInt64 getLastModified() const { return 0; }
+
     /**
      * Read data (binary format) into the given buffer.
      *
@@ -481,6 +513,22 @@ class AbstractFSNode
      */
     virtual size_t read(ByteBuffer& buffer, size_t size) const { return 0; }
 
+    /**
+     * Read data (binary format) into the given buffer, and compute its MD5
+     * while doing so.  Nodes which can't do this leave 'md5' empty.
+     *
+     * @param buffer  The buffer to contain the data (allocated in this method).
+     * @param size    The amount of data to read (0 means read all data).
+     * @param md5     The MD5 of the data read, or empty.
+     *
+     * @return  The number of bytes read (0 in the case of failure)
+     *          This method can throw exceptions, and should be used inside
+     *          a try-catch block.
+     */
+    virtual size_t read(ByteBuffer& buffer, size_t size, string& md5) const {
+      return read(buffer, size);
+    }
+
     /**
      * Read data (text format) into the given stream.
      *
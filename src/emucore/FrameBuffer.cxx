@@ -34,6 +34,10 @@
 #include "FrameBuffer.hxx"
 #include "StateManager.hxx"
 #include "RewindManager.hxx"
+#include "FrameTimes.hxx"
+#include "PerfCounters.hxx"
+#include "MemoryReport.hxx"
+#include "StartupTrace.hxx"
 
 #ifdef DEBUGGER_SUPPORT
   #include "Debugger.hxx"
@@ -81,6 +85,13 @@ void FrameBuffer::initialize()
   // Get desktop resolution and supported renderers
   myBackend->queryHardware(myFullscreenDisplays, myWindowedDisplays, myRenderers);
 
+  // Resolve the settings read in every frame only once
+  Settings& settings = myOSystem.settings();
+  myPauseDim = settings.handle("pausedim");
+  myTurbo = settings.handle("turbo");
+  mySpeed = settings.handle("speed");
+  myDevSettings = settings.handle("dev.settings");
+
   const size_t numDisplays = myWindowedDisplays.size();
 
   for(size_t display = 0; display < numDisplays; ++display)
@@ -290,14 +301,23 @@ FBInitStatus FrameBuffer::createDisplay(string_view title, BufferType type,
   }
 
 #ifdef GUI_SUPPORT  // TODO: put message stuff in its own class
-  // Erase any messages from a previous run
+  // Erase any messages from a previous run, and rasterize the overlays
+  // again in case the fonts have changed
   myMsg.enabled = false;
+  myMsg.drawn.clear();
+  myStatsMsg.dirty = true;
 
   // Create surfaces for TIA statistics and general messages
   const GUI::Font& f = hidpiEnabled() ? infoFont() : font();
   myStatsMsg.color = kColorInfo;
+  // The last line is the frame time histogram
+#ifdef PERF_COUNTERS
+  myStatsMsg.w = f.getMaxCharWidth() * 48 + 3;
+  myStatsMsg.h = (f.getFontHeight() + 2) * 6;
+#else
   myStatsMsg.w = f.getMaxCharWidth() * 40 + 3;
-  myStatsMsg.h = (f.getFontHeight() + 2) * 3;
+  myStatsMsg.h = (f.getFontHeight() + 2) * 5;
+#endif
 
   if(!myStatsMsg.surface)
   {
@@ -354,6 +374,7 @@ FBInitStatus FrameBuffer::createDisplay(string_view title, BufferType type,
         break;
     }
     myTIASurface->enablePhosphor(enable, p_blend);
+    myOSystem.qualityGovernor().reset(*myTIASurface);
   }
 
   if(status != FBInitStatus::Success)
@@ -394,6 +415,7 @@ void FrameBuffer::update(UpdateMode mode)
   const bool rerender = (mode == UpdateMode::REDRAW || mode == UpdateMode::RERENDER
                          || myPendingRender);
   myPendingRender = false;
+  myPresented = false;
 
   switch(myOSystem.eventHandler().state())
   {
@@ -405,11 +427,13 @@ void FrameBuffer::update(UpdateMode mode)
     case EventHandlerState::PAUSE:
     {
       // Show a pause message immediately and then every 7 seconds
-      const bool shade = myOSystem.settings().getBool("pausedim");
+      const bool shade = myPauseDim.getBool();
 
-      if(myMsg.counter < MESSAGE_TIME && myPausedCount-- <= 0)
+      const auto now = std::chrono::steady_clock::now();
+
+      if(myMsg.counter < MESSAGE_TIME && now >= myPauseMessageTime)
       {
-        myPausedCount = static_cast<uInt32>(7 * myOSystem.frameRate());
+        myPauseMessageTime = now + std::chrono::seconds(7);
         showTextMessage("Paused", MessagePosition::MiddleCenter);
         renderTIA(false, shade);
       }
@@ -588,7 +612,11 @@ void FrameBuffer::update(UpdateMode mode)
 
   // Push buffers to screen only when necessary
   if(redraw || rerender)
+  {
     myBackend->renderToScreen();
+    StartupTrace::firstPresent();
+    myPresented = true;
+  }
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -598,6 +626,7 @@ void FrameBuffer::updateInEmulationMode(float framesPerSecond)
   //
   // We don't worry about selective rendering here; the rendering
   // always happens at the full framerate
+  const FrameTimes::Clock::time_point renderStart = FrameTimes::Clock::now();
 
   renderTIA();
 
@@ -606,14 +635,21 @@ void FrameBuffer::updateInEmulationMode(float framesPerSecond)
     drawFrameStats(framesPerSecond);
 
   myLastScanlines = myOSystem.console().tia().frameBufferScanlinesLastFrame();
-  myPausedCount = 0;
+  myPauseMessageTime = {};
 
   // Draw any pending messages
   if(myMsg.enabled)
     drawMessage();
 
   // Push buffers to screen
+  const FrameTimes::Clock::time_point presentStart = FrameTimes::Clock::now();
   myBackend->renderToScreen();
+  StartupTrace::firstPresent();
+
+  FrameTimes& frameTimes = myOSystem.frameTimes();
+  frameTimes.add(FrameTimes::Phase::Render, presentStart - renderStart);
+  frameTimes.add(FrameTimes::Phase::Present,
+                 FrameTimes::Clock::now() - presentStart);
 }
 
 #ifdef GUI_SUPPORT
@@ -699,6 +735,30 @@ bool FrameBuffer::messageShown() const
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void FrameBuffer::drawFrameStats(float framesPerSecond)
 {
+#ifdef GUI_SUPPORT
+  // Remember a changed scanline count until the stats are drawn again
+  myScanlinesChanged |=
+    myOSystem.console().tia().frameBufferScanlinesLastFrame() != myLastScanlines;
+
+  const auto now = std::chrono::steady_clock::now();
+  if(myStatsMsg.dirty || now - myStatsDrawTime >= STATS_INTERVAL)
+  {
+    myStatsMsg.dirty = false;
+    myStatsDrawTime = now;
+    rasterizeFrameStats(framesPerSecond);
+  }
+
+  myStatsMsg.surface->setDstPos(imageRect().x() + imageRect().w() / 64,
+                                imageRect().y() + imageRect().h() / 64);
+  myStatsMsg.surface->setDstSize(myStatsMsg.w * hidpiScaleFactor(),
+                                 myStatsMsg.h * hidpiScaleFactor());
+  myStatsMsg.surface->render();
+#endif
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void FrameBuffer::rasterizeFrameStats(float framesPerSecond)
+{
 #ifdef GUI_SUPPORT
   const ConsoleInfo& info = myOSystem.console().about();
   constexpr int xPos = 2;
@@ -711,8 +771,8 @@ void FrameBuffer::drawFrameStats(float framesPerSecond)
   myStatsMsg.surface->invalidate();
 
   // draw scanlines
-  ColorId color = myOSystem.console().tia().frameBufferScanlinesLastFrame() !=
-    myLastScanlines ? kDbgColorRed : myStatsMsg.color;
+  ColorId color = myScanlinesChanged ? kDbgColorRed : myStatsMsg.color;
+  myScanlinesChanged = false;
 
   ss
     << myOSystem.console().tia().frameBufferScanlinesLastFrame()
@@ -732,9 +792,9 @@ void FrameBuffer::drawFrameStats(float framesPerSecond)
     << std::fixed << std::setprecision(1) << framesPerSecond
     << "fps @ "
     << std::fixed << std::setprecision(0) << 100 *
-      (myOSystem.settings().getBool("turbo")
+      (myTurbo.getBool()
         ? 50.0F
-        : myOSystem.settings().getFloat("speed"))
+        : mySpeed.getFloat())
     << "% speed";
 
   myStatsMsg.surface->drawString(f, ss.view(), xPos, yPos,
@@ -748,7 +808,7 @@ void FrameBuffer::drawFrameStats(float framesPerSecond)
     myStatsMsg.surface->drawString(f, ss.view(), xPos, yPos,
                                    myStatsMsg.w, myStatsMsg.color, TextAlign::Left, 0, true, kBGColor);
 
-  if(myOSystem.settings().getBool("dev.settings"))
+  if(myDevSettings.getBool())
   {
     xPosEnd = myStatsMsg.surface->drawString(f, "| ", xPosEnd, yPos,
                                   myStatsMsg.w, color, TextAlign::Left, 0, true, kBGColor);
@@ -765,11 +825,36 @@ void FrameBuffer::drawFrameStats(float framesPerSecond)
         myStatsMsg.w, color, TextAlign::Left, 0, true, kBGColor);
   }
 
-  myStatsMsg.surface->setDstPos(imageRect().x() + imageRect().w() / 64,
-                                imageRect().y() + imageRect().h() / 64);
-  myStatsMsg.surface->setDstSize(myStatsMsg.w * hidpiScaleFactor(),
-                                 myStatsMsg.h * hidpiScaleFactor());
-  myStatsMsg.surface->render();
+#ifdef PERF_COUNTERS
+  yPos += dy;
+  myStatsMsg.surface->drawString(f, PerfCounters::summary(), xPos, yPos,
+      myStatsMsg.w, myStatsMsg.color, TextAlign::Left, 0, true, kBGColor);
+#endif
+
+  // Frame interval percentiles, and their histogram up to twice the period
+  const FrameTimes& frameTimes = myOSystem.frameTimes();
+  yPos += dy;
+  myStatsMsg.surface->drawString(f, frameTimes.summary(), xPos, yPos,
+      myStatsMsg.w, myStatsMsg.color, TextAlign::Left, 0, true, kBGColor);
+
+  yPos += dy;
+  const float maxMs = 2000.F / std::max(myOSystem.console().currentFrameRate(), 1.F);
+  const FrameTimes::Histogram bins =
+    frameTimes.histogram(FrameTimes::Phase::Interval, maxMs);
+  const uInt32 maxCount = std::max(*std::ranges::max_element(bins), 1U);
+  const auto barHeight = static_cast<uInt32>(dy - 2);
+
+  myStatsMsg.surface->fillRect(xPos, yPos, FrameTimes::BINS * 3, dy, kBGColor);
+  for(size_t i = 0; i < bins.size(); ++i)
+  {
+    // At least one pixel for any occurrence, so that single stutters show
+    const uInt32 h = bins[i]
+      ? std::max(bins[i] * barHeight / maxCount, 1U) : 0;
+    if(h)
+      myStatsMsg.surface->fillRect(xPos + static_cast<uInt32>(i) * 3,
+          yPos + dy - 1 - h, 2, h,
+          i >= FrameTimes::BINS / 2 ? kDbgColorRed : myStatsMsg.color);
+  }
 #endif
 }
 
@@ -789,6 +874,7 @@ void FrameBuffer::toggleFrameStats(bool toggle)
 void FrameBuffer::showFrameStats(bool enable)
 {
   myStatsEnabled = myStatsMsg.enabled = enable;
+  myStatsMsg.dirty = true;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -798,6 +884,7 @@ void FrameBuffer::enableMessages(bool enable)
   {
     // Only re-enable frame stats if they were already enabled before
     myStatsMsg.enabled = myStatsEnabled;
+    myStatsMsg.dirty = true;
   }
   else
   {
@@ -830,106 +917,118 @@ inline bool FrameBuffer::drawMessage()
     return false;
   }
 
-  if(myMsg.dirty)
+  // Place the message; this only moves the surface, so that it follows
+  // changes of the image rectangle
+  const Common::Rect& dst = myMsg.surface->dstRect();
+
+  switch(myMsg.position)
   {
-  #ifdef DEBUG_BUILD
-    cerr << "m";
-    //cerr << "--- draw message ---\n";
-  #endif
+    case MessagePosition::TopLeft:
+      myMsg.x = 5;
+      myMsg.y = 5;
+      break;
 
-    // Draw the bounded box and text
-    const Common::Rect& dst = myMsg.surface->dstRect();
-    const int fontWidth = font().getMaxCharWidth(),
-              fontHeight = font().getFontHeight();
-    const int VBORDER = fontHeight / 4;
-    const int HBORDER = fontWidth * 1.25 / 2.0;
-    constexpr int BORDER = 1;
+    case MessagePosition::TopCenter:
+      myMsg.x = (imageRect().w() - dst.w()) >> 1;
+      myMsg.y = 5;
+      break;
 
-    switch(myMsg.position)
-    {
-      case MessagePosition::TopLeft:
-        myMsg.x = 5;
-        myMsg.y = 5;
-        break;
+    case MessagePosition::TopRight:
+      myMsg.x = imageRect().w() - dst.w() - 5;
+      myMsg.y = 5;
+      break;
 
-      case MessagePosition::TopCenter:
-        myMsg.x = (imageRect().w() - dst.w()) >> 1;
-        myMsg.y = 5;
-        break;
+    case MessagePosition::MiddleLeft:
+      myMsg.x = 5;
+      myMsg.y = (imageRect().h() - dst.h()) >> 1;
+      break;
 
-      case MessagePosition::TopRight:
-        myMsg.x = imageRect().w() - dst.w() - 5;
-        myMsg.y = 5;
-        break;
+    case MessagePosition::MiddleCenter:
+      myMsg.x = (imageRect().w() - dst.w()) >> 1;
+      myMsg.y = (imageRect().h() - dst.h()) >> 1;
+      break;
 
-      case MessagePosition::MiddleLeft:
-        myMsg.x = 5;
-        myMsg.y = (imageRect().h() - dst.h()) >> 1;
-        break;
+    case MessagePosition::MiddleRight:
+      myMsg.x = imageRect().w() - dst.w() - 5;
+      myMsg.y = (imageRect().h() - dst.h()) >> 1;
+      break;
 
-      case MessagePosition::MiddleCenter:
-        myMsg.x = (imageRect().w() - dst.w()) >> 1;
-        myMsg.y = (imageRect().h() - dst.h()) >> 1;
-        break;
+    case MessagePosition::BottomLeft:
+      myMsg.x = 5;
+      myMsg.y = imageRect().h() - dst.h() - 5;
+      break;
 
-      case MessagePosition::MiddleRight:
-        myMsg.x = imageRect().w() - dst.w() - 5;
-        myMsg.y = (imageRect().h() - dst.h()) >> 1;
-        break;
+    case MessagePosition::BottomCenter:
+      myMsg.x = (imageRect().w() - dst.w()) >> 1;
+      myMsg.y = imageRect().h() - dst.h() - 5;
+      break;
 
-      case MessagePosition::BottomLeft:
-        myMsg.x = 5;
-        myMsg.y = imageRect().h() - dst.h() - 5;
-        break;
+    case MessagePosition::BottomRight:
+      myMsg.x = imageRect().w() - dst.w() - 5;
+      myMsg.y = imageRect().h() - dst.h() - 5;
+      break;
 
-      case MessagePosition::BottomCenter:
-        myMsg.x = (imageRect().w() - dst.w()) >> 1;
-        myMsg.y = imageRect().h() - dst.h() - 5;
-        break;
+    default:
+      break;  // Not supposed to get here
+  }
+  myMsg.surface->setDstPos(myMsg.x + imageRect().x(), myMsg.y + imageRect().y());
 
-      case MessagePosition::BottomRight:
-        myMsg.x = imageRect().w() - dst.w() - 5;
-        myMsg.y = imageRect().h() - dst.h() - 5;
-        break;
+  if(myMsg.dirty)
+  {
+    // Showing the same message again (e.g. 'Paused', or a repeated gauge
+    // value) doesn't require rasterizing it again
+    string content = std::format("{}\n{}\n{}\n{}\n{}x{}", myMsg.text,
+      myMsg.showGauge, myMsg.valueText, myMsg.value, myMsg.w, myMsg.h);
 
-      default:
-        break;  // Not supposed to get here
-    }
+    if(content != myMsg.drawn)
+    {
+    #ifdef DEBUG_BUILD
+      cerr << "m";
+      //cerr << "--- draw message ---\n";
+    #endif
 
-    myMsg.surface->setDstPos(myMsg.x + imageRect().x(), myMsg.y + imageRect().y());
-    myMsg.surface->fillRect(0, 0, myMsg.w, myMsg.h, kColor);
-    myMsg.surface->fillRect(BORDER, BORDER, myMsg.w - BORDER * 2, myMsg.h - BORDER * 2, kBtnColor);
-    myMsg.surface->drawString(font(), myMsg.text, HBORDER, VBORDER,
-                              myMsg.w, myMsg.color);
+      // Draw the bounded box and text
+      const int fontWidth = font().getMaxCharWidth(),
+                fontHeight = font().getFontHeight();
+      const int VBORDER = fontHeight / 4;
+      const int HBORDER = fontWidth * 1.25 / 2.0;
+      constexpr int BORDER = 1;
 
-    if(myMsg.showGauge)
-    {
-      constexpr int NUM_TICKMARKS = 4;
-      // limit gauge bar width if texts are too long
-      const int swidth = std::min(fontWidth * GAUGEBAR_WIDTH,
-                                  fontWidth * (MESSAGE_WIDTH - 2)
-                                  - font().getStringWidth(myMsg.text)
-                                  - font().getStringWidth(myMsg.valueText));
-      const int bwidth = swidth * myMsg.value / 100.F;
-      const int bheight = fontHeight >> 1;
-      const int x = HBORDER + font().getStringWidth(myMsg.text) + fontWidth;
-      // align bar with bottom of text
-      const int y = VBORDER + font().desc().ascent - bheight;
-
-      // draw gauge bar
-      myMsg.surface->fillRect(x - BORDER, y, swidth + BORDER * 2, bheight, kSliderBGColor);
-      myMsg.surface->fillRect(x, y + BORDER, bwidth, bheight - BORDER * 2, kSliderColor);
-      // draw tickmark in the middle of the bar
-      for(int i = 1; i < NUM_TICKMARKS; ++i)
+      myMsg.surface->fillRect(0, 0, myMsg.w, myMsg.h, kColor);
+      myMsg.surface->fillRect(BORDER, BORDER, myMsg.w - BORDER * 2, myMsg.h - BORDER * 2, kBtnColor);
+      myMsg.surface->drawString(font(), myMsg.text, HBORDER, VBORDER,
+                                myMsg.w, myMsg.color);
+
+      if(myMsg.showGauge)
       {
-        const int xt = x + swidth * i / NUM_TICKMARKS;
-        const ColorId color = (bwidth < xt - x) ? kCheckColor : kSliderBGColor;
-        myMsg.surface->vLine(xt, y + bheight / 2, y + bheight - 1, color);
+        constexpr int NUM_TICKMARKS = 4;
+        // limit gauge bar width if texts are too long
+        const int swidth = std::min(fontWidth * GAUGEBAR_WIDTH,
+                                    fontWidth * (MESSAGE_WIDTH - 2)
+                                    - font().getStringWidth(myMsg.text)
+                                    - font().getStringWidth(myMsg.valueText));
+        const int bwidth = swidth * myMsg.value / 100.F;
+        const int bheight = fontHeight >> 1;
+        const int x = HBORDER + font().getStringWidth(myMsg.text) + fontWidth;
+        // align bar with bottom of text
+        const int y = VBORDER + font().desc().ascent - bheight;
+
+        // draw gauge bar
+        myMsg.surface->fillRect(x - BORDER, y, swidth + BORDER * 2, bheight, kSliderBGColor);
+        myMsg.surface->fillRect(x, y + BORDER, bwidth, bheight - BORDER * 2, kSliderColor);
+        // draw tickmark in the middle of the bar
+        for(int i = 1; i < NUM_TICKMARKS; ++i)
+        {
+          const int xt = x + swidth * i / NUM_TICKMARKS;
+          const ColorId color = (bwidth < xt - x) ? kCheckColor : kSliderBGColor;
+          myMsg.surface->vLine(xt, y + bheight / 2, y + bheight - 1, color);
+        }
+        // draw value text
+        myMsg.surface->drawString(font(), myMsg.valueText,
+                                  x + swidth + fontWidth, VBORDER,
+                                  myMsg.w, myMsg.color);
       }
-      // draw value text
-      myMsg.surface->drawString(font(), myMsg.valueText,
-                                x + swidth + fontWidth, VBORDER,
-                                myMsg.w, myMsg.color);
+      myMsg.drawn = std::move(content);
     }
     myMsg.dirty = false;
     myMsg.surface->render();
@@ -946,7 +1045,7 @@ inline bool FrameBuffer::drawMessage()
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void FrameBuffer::setPauseDelay()
 {
-  myPausedCount = static_cast<uInt32>(2 * myOSystem.frameRate());
+  myPauseMessageTime = std::chrono::steady_clock::now() + std::chrono::seconds(2);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -964,6 +1063,27 @@ void FrameBuffer::deallocateSurface(const shared_ptr<FBSurface>& surface)
     mySurfaceList.remove(surface);
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void FrameBuffer::memoryReport(MemoryReport& report) const
+{
+  size_t surfaces = 0;
+  for(const auto& surface: mySurfaceList)
+    surfaces += surface->memoryUsage();
+  report.add(std::format("Surfaces ({})", mySurfaceList.size()), surfaces);
+
+#ifdef GUI_SUPPORT
+  size_t fonts = 0;
+  for(const auto* font: {myFont.get(), myInfoFont.get(), mySmallFont.get(),
+                         myLauncherFont.get()})
+    if(font)
+      fonts += sizeof(GUI::Font) + font->memoryUsage();
+  report.add("Fonts", fonts);
+#endif
+
+  if(myTIASurface)
+    myTIASurface->memoryReport(report);
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void FrameBuffer::resetSurfaces()
 {
@@ -1030,6 +1150,10 @@ void FrameBuffer::setUIPalette()
     myFullPalette[j] = mapRGB(r, g, b);
   }
   FBSurface::setPalette(myFullPalette);
+
+  // The overlays have to be rasterized with the new colors
+  myMsg.drawn.clear();
+  myStatsMsg.dirty = true;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -18,20 +18,22 @@
 #ifndef FRAMEBUFFER_HXX
 #define FRAMEBUFFER_HXX
 
+#include <chrono>
 #include <list>
 
 class OSystem;
 class Console;
-class Settings;
 class FBSurface;
 class TIASurface;
 class Bezel;
+class MemoryReport;
 
 #ifdef GUI_SUPPORT
   #include "Font.hxx"
 #endif
 
 #include "Rect.hxx"
+#include "Settings.hxx"
 #include "Variant.hxx"
 #include "TIAConstants.hxx"
 #include "FBBackend.hxx"
@@ -103,6 +105,12 @@ class FrameBuffer
     */
     void setPendingRender() { myPendingRender = true; }
 
+    /**
+      Answer whether the last update() presented a frame, or a message is
+      still being shown, i.e. the screen may change without any input.
+    */
+    bool isAnimating() const { return myPresented || myMsg.enabled; }
+
     /**
       Shows a text message onscreen.
 
@@ -174,6 +182,14 @@ class FrameBuffer
     */
     void deallocateSurface(const shared_ptr<FBSurface>& surface);
 
+    /**
+      Add the memory used by the surfaces, fonts and the TIA surface to
+      the given report.
+
+      @param report  The report to add the entries to
+    */
+    void memoryReport(MemoryReport& report) const;
+
     /**
       Set up the TIA/emulation palette.  Due to the way the palette is stored,
       a call to this method implicitly calls setUIPalette() too.
@@ -362,6 +378,11 @@ class FrameBuffer
     */
     bool fullScreen() const { return myBackend->fullScreen(); }
 
+    /**
+      Answers the refresh rate of the current display in Hz (0 if unknown).
+    */
+    int refreshRate() const { return myBackend->refreshRate(); }
+
     /**
       Updates theme according to OS setting.
 
@@ -492,9 +513,11 @@ class FrameBuffer
     void hideMessage();
 
     /**
-      Draws the frame stats overlay.
+      Draws the frame stats overlay. The stats are re-rasterized at most
+      every STATS_INTERVAL, in between the surface is only composited.
     */
     void drawFrameStats(float framesPerSecond);
+    void rasterizeFrameStats(float framesPerSecond);
 
 
     /**
@@ -540,7 +563,13 @@ class FrameBuffer
     uInt32 myInitializedCount{0};
 
     // Used to set intervals between messages while in pause mode
-    Int32 myPausedCount{0};
+    std::chrono::steady_clock::time_point myPauseMessageTime;
+
+    // Whether the last update() presented a frame
+    bool myPresented{false};
+
+    // Settings which are read in every frame
+    Settings::Handle myPauseDim, myTurbo, mySpeed, myDevSettings;
 
     // Maximum dimensions of the desktop area
     // Note that this takes 'hidpi' mode into account, so in some cases
@@ -606,12 +635,21 @@ class FrameBuffer
       bool showGauge{false};
       float value{0.F};
       string valueText;
+      // The content last rasterized into the surface (empty = none), so
+      // that an unchanged message is only composited
+      string drawn;
     };
     Message myMsg;
     Message myStatsMsg;
     bool myStatsEnabled{false};
     uInt32 myLastScanlines{0};
 
+    // When the frame stats were last rasterized, and whether the scanline
+    // count changed in any frame since then
+    std::chrono::steady_clock::time_point myStatsDrawTime;
+    bool myScanlinesChanged{false};
+    static constexpr auto STATS_INTERVAL = std::chrono::milliseconds(250);
+
     bool myGrabMouse{false};
     vector<bool> myHiDPIAllowed;
     vector<bool> myHiDPIEnabled;
@@ -0,0 +1,82 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2026 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#include "Cart.hxx"
+#include "ConsoleTiming.hxx"
+#include "FrameLayoutDetector.hxx"
+#include "Joystick.hxx"
+#include "Props.hxx"
+#include "Serializer.hxx"
+#include "Settings.hxx"
+#include "Switches.hxx"
+#include "HeadlessConsole.hxx"
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+HeadlessConsole::HeadlessConsole(unique_ptr<Cartridge> cart, Settings& settings,
+                                 const Properties& props)
+  : myCart{std::move(cart)},
+    myCpu{settings},
+    myRiot{myIO, settings},
+    myTIA{std::make_unique<TIA>(myIO, []() { return ConsoleTiming::ntsc; },
+                                settings, [](bool) { })},
+    mySystem{myRandom, myCpu, myRiot, *myTIA, *myCart}
+{
+  myIO.myLeftControl =
+    std::make_unique<Joystick>(Controller::Jack::Left, myEvent, mySystem);
+  myIO.myRightControl =
+    std::make_unique<Joystick>(Controller::Jack::Right, myEvent, mySystem);
+  myIO.mySwitches = std::make_unique<Switches>(myEvent, props, settings);
+
+  myTIA->bindToControllers();
+  myCart->setStartBankFromPropsFunc([]() { return -1; });
+  mySystem.initialize();
+
+  myTIA->setFrameManager(&myFrameManager);
+  mySystem.reset();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+HeadlessConsole::~HeadlessConsole() = default;
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void HeadlessConsole::detectLayout()
+{
+  // Like the ProfilingRunner does
+  FrameLayoutDetector frameLayoutDetector;
+  myTIA->setFrameManager(&frameLayoutDetector);
+  mySystem.reset();
+  for(int i = 0; i < 60; ++i) myTIA->update();
+
+  const FrameLayout layout = frameLayoutDetector.detectedLayout();
+  myTIA->setFrameManager(&myFrameManager);
+  myTIA->setLayout(layout);
+  mySystem.reset();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool HeadlessConsole::save(Serializer& out) const
+{
+  return mySystem.save(out) && myIO.myLeftControl->save(out) &&
+         myIO.myRightControl->save(out) && myIO.mySwitches->save(out);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool HeadlessConsole::load(Serializer& in)
+{
+  return mySystem.load(in) && myIO.myLeftControl->load(in) &&
+         myIO.myRightControl->load(in) && myIO.mySwitches->load(in);
+}
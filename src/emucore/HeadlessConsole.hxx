@@ -0,0 +1,104 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2026 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#ifndef HEADLESS_CONSOLE_HXX
+#define HEADLESS_CONSOLE_HXX
+
+class Cartridge;
+class Properties;
+class Serializer;
+class Settings;
+
+#include "bspf.hxx"
+#include "ConsoleIO.hxx"
+#include "Event.hxx"
+#include "FrameManager.hxx"
+#include "M6502.hxx"
+#include "M6532.hxx"
+#include "Random.hxx"
+#include "System.hxx"
+#include "TIA.hxx"
+
+/**
+  A minimal console (system, joysticks and switches) without any OSystem,
+  FrameBuffer or Sound attached.  It is used wherever the debugger needs to
+  emulate independently from the main console, e.g. for headless scripts or
+  on worker threads.  Each instance is completely independent, so several
+  of them can be used on different threads at the same time.
+
+  @author  Stella Team
+*/
+class HeadlessConsole
+{
+  public:
+    HeadlessConsole(unique_ptr<Cartridge> cart, Settings& settings,
+                    const Properties& props);
+    ~HeadlessConsole();
+
+    /**
+      Detect the frame layout by emulating a few frames, then reset.
+    */
+    void detectLayout();
+
+    /**
+      Save/load the state of the system, controllers and switches, in the
+      same format as Console::save()/load().
+    */
+    bool save(Serializer& out) const;
+    bool load(Serializer& in);
+
+    Cartridge& cartridge() const { return *myCart; }
+    M6502& cpu() { return myCpu; }
+    const M6502& cpu() const { return myCpu; }
+    TIA& tia() const { return *myTIA; }
+    M6532& riot() { return myRiot; }
+    System& system() { return mySystem; }
+    Event& event() { return myEvent; }
+    const Controller& leftController() const { return myIO.leftController(); }
+    const Controller& rightController() const { return myIO.rightController(); }
+
+  private:
+    struct IO: public ConsoleIO {
+      Controller& leftController() const override { return *myLeftControl; }
+      Controller& rightController() const override { return *myRightControl; }
+      Switches& switches() const override { return *mySwitches; }
+
+      unique_ptr<Controller> myLeftControl;
+      unique_ptr<Controller> myRightControl;
+      unique_ptr<Switches> mySwitches;
+    };
+
+    unique_ptr<Cartridge> myCart;
+    IO myIO;
+    Random myRandom{0};
+    Event myEvent;
+    M6502 myCpu;
+    M6532 myRiot;
+    unique_ptr<TIA> myTIA;  // too large to be placed on a (worker thread) stack
+    System mySystem;
+    FrameManager myFrameManager;
+
+  private:
+    // Following constructors and assignment operators not supported
+    HeadlessConsole() = delete;
+    HeadlessConsole(const HeadlessConsole&) = delete;
+    HeadlessConsole(HeadlessConsole&&) = delete;
+    HeadlessConsole& operator=(const HeadlessConsole&) = delete;
+    HeadlessConsole& operator=(HeadlessConsole&&) = delete;
+};
+
+#endif
@@ -64,8 +64,7 @@ void KidVid::update()
     const uInt32 songLength = ourSongStart[temp + 1] - ourSongStart[temp] - (262 * ClickFrames);
 
     // Play the remaining WAV file
-    const string& fileName = myOSystem.baseDir().getPath() +
-      ((temp < 10) ? "KVSHARED.WAV": getFileName());
+    const string& fileName = myOSystem.baseDir().getPath() + songFileName(temp);
     myOSystem.sound().playWav(fileName, ourSongStart[temp] + (songLength - mySongLength), mySongLength);
 
     myContinueSong = false;
@@ -224,6 +223,9 @@ bool KidVid::load(Serializer& in)
   myBlock = in.getInt();
 
   myContinueSong = myFilesFound && mySongPlaying;
+  if(myContinueSong)
+    myOSystem.sound().prefetchWav(myOSystem.baseDir().getPath() +
+      songFileName(ourSongPositions[mySongPointer - 1] & 0x7f));
 
   return Controller::load(in);
 }
@@ -239,6 +241,13 @@ string KidVid::getFileName() const
   return string{fileNames[tapeIndex()]};
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+string KidVid::songFileName(uInt32 song) const
+{
+  // The first songs are shared by all tapes
+  return song < 10 ? "KVSHARED.WAV" : getFileName();
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 uInt32 KidVid::tapeIndex() const
 {
@@ -284,6 +293,12 @@ void KidVid::openSampleFiles()
     mySongLength = 0;
     mySongPointer = firstSongPointer[tapeIndex()];
   }
+  if(myFilesFound)
+  {
+    // Decode both files in the background, long before the first song
+    myOSystem.sound().prefetchWav(myOSystem.baseDir().getPath() + "KVSHARED.WAV");
+    myOSystem.sound().prefetchWav(myOSystem.baseDir().getPath() + getFileName());
+  }
   myTapeBusy = false;
 #endif
 }
@@ -300,7 +315,7 @@ void KidVid::setNextSong()
     mySongLength = ourSongStart[temp + 1] - ourSongStart[temp] - (262 * ClickFrames);
 
     // Play the WAV file
-    const string& fileName = (temp < 10) ? "KVSHARED.WAV" : getFileName();
+    const string& fileName = songFileName(temp);
     myOSystem.sound().playWav(myOSystem.baseDir().getPath() + fileName,
                               ourSongStart[temp], mySongLength);
     myCallback(std::format("Read song #{} ({})",
@@ -312,6 +327,11 @@ void KidVid::setNextSong()
 
     mySongPlaying = myTapeBusy = true;
     ++mySongPointer;
+
+    // Make sure the file of the following song is ready in time
+    if(mySongPointer < ourSongPositions.size())
+      myOSystem.sound().prefetchWav(myOSystem.baseDir().getPath() +
+        songFileName(ourSongPositions[mySongPointer] & 0x7f));
   }
   else
   {
@@ -96,6 +96,9 @@ class KidVid : public Controller
     // Get name of the current sample file
     string getFileName() const;
 
+    // Get name of the sample file containing the given song
+    string songFileName(uInt32 song) const;
+
     // Map myTape (1-4) + myGame to an index
     uInt32 tapeIndex() const;
 
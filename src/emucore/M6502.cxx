@@ -17,7 +17,7 @@
 
 #ifdef DEBUGGER_SUPPORT
   #include "Debugger.hxx"
-  #include "Expression.hxx"
+  #include "ExpressionProgram.hxx"
   #include "Device.hxx"
   #include "Base.hxx"
 
@@ -42,6 +42,7 @@
 #include "System.hxx"
 #include "M6502.hxx"
 #include "DispatchResult.hxx"
+#include "PerfCounters.hxx"
 #include "exception/EmulationWarning.hxx"
 #include "exception/FatalEmulationError.hxx"
 
@@ -51,6 +52,9 @@ M6502::M6502(const Settings& settings)
 {
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+M6502::~M6502() = default;
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void M6502::install(System& system)
 {
@@ -93,16 +97,29 @@ void M6502::reset()
   myFlags = DISASM_NONE;
 
   myHaltRequested = false;
+  myLastStopCycles = mySystem->cycles();
   myGhostReadsTrap = mySettings.getBool("dbg.ghostreadstrap");
   myReadFromWritePortBreak = devSettings ? mySettings.getBool("dev.rwportbreak") : false;
   myWriteToReadPortBreak = devSettings ? mySettings.getBool("dev.wrportbreak") : false;
+#ifdef DEBUGGER_SUPPORT
+  // Access flags and counters are only maintained for developers (and
+  // once the debugger has been entered)
+  if(devSettings)
+    mySystem->enableAccessTracking();
+  mySystem->setAccessCounting(devSettings
+    ? System::AccessCounting::batched : System::AccessCounting::off);
+#endif
   myLogBreaks = mySettings.getBool("dbg.logbreaks");
   myLogTrace = mySettings.getBool("dbg.logtrace");
+#ifdef DEBUGGER_SUPPORT
+  myCallProfiler.unwind();
+#endif
 
   myLastBreakCycle = ULLONG_MAX;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+template<bool Hooks>
 inline uInt8 M6502::peek(uInt16 address, Device::AccessFlags flags)
 {
   handleHalt();
@@ -122,7 +139,7 @@ inline uInt8 M6502::peek(uInt16 address, Device::AccessFlags flags)
   myLastPeekAddress = address;
 
 #ifdef DEBUGGER_SUPPORT
-  if(myReadTraps.isInitialized() && myReadTraps.isSet(address)
+  if(Hooks && myReadTraps.isInitialized() && myReadTraps.isSet(address)
      && (myGhostReadsTrap || flags != DISASM_NONE))
   {
     myLastPeekBaseAddress = Debugger::getBaseAddress(myLastPeekAddress, true); // mirror handling
@@ -143,6 +160,7 @@ inline uInt8 M6502::peek(uInt16 address, Device::AccessFlags flags)
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+template<bool Hooks>
 inline void M6502::poke(uInt16 address, uInt8 value, Device::AccessFlags flags)
 {
   ////////////////////////////////////////////////
@@ -159,7 +177,7 @@ inline void M6502::poke(uInt16 address, uInt8 value, Device::AccessFlags flags)
   myLastPokeAddress = address;
 
 #ifdef DEBUGGER_SUPPORT
-  if(myWriteTraps.isInitialized() && myWriteTraps.isSet(address))
+  if(Hooks && myWriteTraps.isInitialized() && myWriteTraps.isSet(address))
   {
     myLastPokeBaseAddress = Debugger::getBaseAddress(myLastPokeAddress, false); // mirror handling
     const int cond = evalCondTraps();
@@ -182,19 +200,18 @@ void M6502::requestHalt()
   myHaltRequested = true;
 }
 
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-inline void M6502::handleHalt()
-{
-  if (myHaltRequested) {
-    myOnHaltCallback();
-    myHaltRequested = false;
-  }
-}
-
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void M6502::execute(uInt64 cycles, DispatchResult& result)
 {
-  _execute(cycles, result);
+#ifdef DEBUGGER_SUPPORT
+  // Only pay for the debugger checks if any of them can actually trigger
+  if(debuggerHooksArmed())
+    _execute<true>(cycles, result);
+  else
+#endif
+    _execute<false>(cycles, result);
+
+  myLastStopCycles = mySystem->cycles();
 
 #ifdef DEBUGGER_SUPPORT
   // Debugger hack: this ensures that stepping a "STA WSYNC" will actually end at the
@@ -221,10 +238,33 @@ bool M6502::execute(uInt64 cycles)
   return result.isSuccess();
 }
 
+#ifdef DEBUGGER_SUPPORT
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void M6502::replay(uInt64 cycles)
+{
+  DispatchResult result;
+
+  while(mySystem->cycles() < cycles)
+  {
+    _execute<false>(1, result);
+    handleHalt();
+    if(result.getStatus() == DispatchResult::Status::fatal)
+      break;
+  }
+  myLastStopCycles = mySystem->cycles();
+
+  mySystem->tia().updateEmulation();
+  mySystem->m6532().updateEmulation();
+}
+#endif
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 // NOLINTNEXTLINE (readability-function-size)
+template<bool Hooks>
 inline void M6502::_execute(uInt64 cycles, DispatchResult& result)
 {
+  PERF_SCOPE(M6502);
+
   myExecutionStatus = 0;
 
 #ifdef DEBUGGER_SUPPORT
@@ -232,6 +272,16 @@ inline void M6502::_execute(uInt64 cycles, DispatchResult& result)
   M6532& riot = mySystem->m6532();
 #endif
 
+  // The instruction code in M6502.ins calls peek() and poke() unqualified;
+  // these shadow the members and select the variant with or without traps
+  const auto peek = [this](uInt16 address, Device::AccessFlags flags) {
+    return this->peek<Hooks>(address, flags);
+  };
+  const auto poke = [this](uInt16 address, uInt8 value,
+                           Device::AccessFlags flags = Device::NONE) {
+    this->poke<Hooks>(address, value, flags);
+  };
+
   const uInt64 previousCycles = mySystem->cycles();
   uInt64 currentCycles = 0;
 
@@ -242,7 +292,7 @@ inline void M6502::_execute(uInt64 cycles, DispatchResult& result)
     {
   #ifdef DEBUGGER_SUPPORT
       // Don't break if we haven't actually executed anything yet
-      if (myLastBreakCycle != mySystem->cycles()) {
+      if (Hooks && myLastBreakCycle != mySystem->cycles()) {
         if(myJustHitReadTrapFlag || myJustHitWriteTrapFlag)
         {
           const bool read = myJustHitReadTrapFlag;
@@ -328,14 +378,20 @@ inline void M6502::_execute(uInt64 cycles, DispatchResult& result)
           mySystem->tia().updateEmulation();
           myDebugger->log("trace");
         }
+
+        if(myTraceRecorder.isRecording())
+          recordTrace();
       }
 
-      const int cond = evalCondSaveStates();
-      if(cond > -1)
+      if constexpr(Hooks)
       {
-        std::ostringstream msg;
-        msg << "conditional savestate [" << Common::Base::HEX2 << cond << "]";
-        myDebugger->addState(msg.view());
+        const int cond = evalCondSaveStates();
+        if(cond > -1)
+        {
+          std::ostringstream msg;
+          msg << "conditional savestate [" << Common::Base::HEX2 << cond << "]";
+          myDebugger->addState(msg.view());
+        }
       }
 
       mySystem->cart().clearAllRAMAccesses();
@@ -371,7 +427,10 @@ inline void M6502::_execute(uInt64 cycles, DispatchResult& result)
         }
 
     #ifdef DEBUGGER_SUPPORT
-        if(myReadFromWritePortBreak)
+        if(Hooks && myCallProfiler.isEnabled())
+          profileInstruction();
+
+        if(Hooks && myReadFromWritePortBreak)
         {
           const uInt16 rwpAddr = mySystem->cart().getIllegalRAMReadAccess();
           if(rwpAddr)
@@ -383,7 +442,7 @@ inline void M6502::_execute(uInt64 cycles, DispatchResult& result)
           }
         }
 
-        if (myWriteToReadPortBreak)
+        if (Hooks && myWriteToReadPortBreak)
         {
           const uInt16 wrpAddr = mySystem->cart().getIllegalRAMWriteAccess();
           if (wrpAddr)
@@ -406,7 +465,7 @@ inline void M6502::_execute(uInt64 cycles, DispatchResult& result)
       currentCycles = (mySystem->cycles() - previousCycles);
 
   #ifdef DEBUGGER_SUPPORT
-      if(myStepStateByInstruction)
+      if(Hooks && myStepStateByInstruction)
       {
         // Check out M6502::execute for an explanation.
         handleHalt();
@@ -529,9 +588,11 @@ bool M6502::load(Serializer& in)
 
     myHaltRequested = in.getBool();
     myLastBreakCycle = in.getLong();
+    myLastStopCycles = mySystem->cycles();
 
   #ifdef DEBUGGER_SUPPORT
     myTimer.load(in);
+    myCallProfiler.unwind();
 
     updateStepStateByInstruction();
   #endif
@@ -556,7 +617,14 @@ void M6502::attach(Debugger& debugger)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 uInt32 M6502::addCondBreak(Expression* e, string_view name, bool oneShot)
 {
-  myCondBreaks.emplace_back(e);
+  return addCondBreak(std::make_shared<const ExpressionProgram>(e), name, oneShot);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt32 M6502::addCondBreak(shared_ptr<const ExpressionProgram> program,
+                           string_view name, bool oneShot)
+{
+  myCondBreaks.emplace_back(std::move(program));
   myCondBreakNames.emplace_back(name);
 
   updateStepStateByInstruction();
@@ -597,7 +665,14 @@ const StringList& M6502::getCondBreakNames() const
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 uInt32 M6502::addCondSaveState(Expression* e, string_view name)
 {
-  myCondSaveStates.emplace_back(e);
+  return addCondSaveState(std::make_shared<const ExpressionProgram>(e), name);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt32 M6502::addCondSaveState(shared_ptr<const ExpressionProgram> program,
+                               string_view name)
+{
+  myCondSaveStates.emplace_back(std::move(program));
   myCondSaveStateNames.emplace_back(name);
 
   updateStepStateByInstruction();
@@ -638,7 +713,14 @@ const StringList& M6502::getCondSaveStateNames() const
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 uInt32 M6502::addCondTrap(Expression* e, string_view name)
 {
-  myTrapConds.emplace_back(e);
+  return addCondTrap(std::make_shared<const ExpressionProgram>(e), name);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt32 M6502::addCondTrap(shared_ptr<const ExpressionProgram> program,
+                          string_view name)
+{
+  myTrapConds.emplace_back(std::move(program));
   myTrapCondNames.emplace_back(name);
 
   updateStepStateByInstruction();
@@ -676,6 +758,87 @@ const StringList& M6502::getCondTrapNames() const
   return myTrapCondNames;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+Int32 M6502::evalCondBreaks() const
+{
+  for(Int32 i = static_cast<Int32>(myCondBreaks.size()) - 1; i >= 0; --i)
+    if(myCondBreaks[i]->evaluate())
+      return i;
+
+  return -1; // no break hit
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+Int32 M6502::evalCondSaveStates() const
+{
+  for(Int32 i = static_cast<Int32>(myCondSaveStates.size()) - 1; i >= 0; --i)
+    if(myCondSaveStates[i]->evaluate())
+      return i;
+
+  return -1; // no save state point hit
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+Int32 M6502::evalCondTraps() const
+{
+  for(Int32 i = static_cast<Int32>(myTrapConds.size()) - 1; i >= 0; --i)
+    if(myTrapConds[i]->evaluate())
+      return i;
+
+  return -1; // no trapif hit
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void M6502::recordTrace()
+{
+  // Make sure that the TIA state matches the current system clock.
+  TIA& tia = mySystem->tia();
+  tia.updateEmulation();
+
+  Cartridge& cart = mySystem->cart();
+  TraceRecorder::Record rec;
+
+  rec.frame    = tia.frameCount();
+  rec.pc       = PC;
+  rec.scanline = static_cast<uInt16>(tia.scanlines());
+  rec.bank     = static_cast<uInt8>(cart.getBank(PC));
+  rec.cycle    = static_cast<uInt8>(tia.clocksThisLine() / 3);
+  rec.a = A;  rec.x = X;  rec.y = Y;  rec.sp = SP;  rec.ps = PS();
+
+  // Fetch the instruction bytes without bankswitching or changing the bus
+  const bool locked = cart.hotspotsLocked();
+  cart.lockHotspots();
+  mySystem->lockDataBus();
+  for(uInt16 i = 0; i < rec.code.size(); ++i)
+    rec.code[i] = mySystem->peekOob(PC + i);
+  mySystem->unlockDataBus();
+  if(!locked)
+    cart.unlockHotspots();
+
+  myTraceRecorder.record(rec);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void M6502::profileInstruction()
+{
+  // The bank is only needed for the start of a routine
+  const uInt8 bank = (IR == 0x20 || IR == 0x00)
+    ? static_cast<uInt8>(mySystem->cart().getBank(PC)) : 0;
+
+  myCallProfiler.step(IR, PC, bank, SP, mySystem->cycles());
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool M6502::debuggerHooksArmed() const
+{
+  return myReadTraps.isInitialized() || myWriteTraps.isInitialized() ||
+         myBreakPoints.isInitialized() || myTimer.isInitialized() ||
+         myStepStateByInstruction || myLogTrace || myTraceRecorder.isRecording() ||
+         myCallProfiler.isEnabled() ||
+         myReadFromWritePortBreak || myWriteToReadPortBreak ||
+         myJustHitReadTrapFlag || myJustHitWriteTrapFlag;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void M6502::updateStepStateByInstruction()
 {
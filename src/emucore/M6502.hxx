@@ -27,11 +27,14 @@ class DispatchResult;
 #ifdef DEBUGGER_SUPPORT
   class Debugger;
   class CpuDebug;
+  class ExpressionProgram;
 
   #include "Expression.hxx"
   #include "TrapArray.hxx"
   #include "BreakpointMap.hxx"
   #include "TimerMap.hxx"
+  #include "TraceRecorder.hxx"
+  #include "CallProfiler.hxx"
 #endif
 
 #include "bspf.hxx"
@@ -55,6 +58,8 @@ class M6502 : public Serializable
   // The 6502 and Cart debugger classes are friends who need special access
   friend class CartDebug;
   friend class CpuDebug;
+  friend class DebugScriptRunner;
+  friend class LockstepServer;
 
   public:
 
@@ -65,7 +70,7 @@ class M6502 : public Serializable
       Create a new 6502 microprocessor.
     */
     explicit M6502(const Settings& settings);
-    ~M6502() override = default;
+    ~M6502() override;
 
   public:
     /**
@@ -114,6 +119,37 @@ class M6502 : public Serializable
 
     bool execute(uInt64 cycles);
 
+    /**
+      Answers the system cycles at which the last execute() stopped, before
+      a pending halt (e.g. WSYNC) was handled.  Emulation can be stopped at
+      exactly this point again, which input movies rely on.
+    */
+    uInt64 lastStopCycles() const { return myLastStopCycles; }
+
+    /**
+      The registers of the processor, for engines which drive the system
+      without execute() (see BatchConsole).
+    */
+    struct Registers {
+      uInt8 A{0}, X{0}, Y{0}, SP{0}, PS{0};
+      uInt16 PC{0};
+    };
+    Registers registers() const { return {A, X, Y, SP, PS(), PC}; }
+    void setRegisters(const Registers& regs) {
+      A = regs.A;  X = regs.X;  Y = regs.Y;  SP = regs.SP;
+      PS(regs.PS);
+      PC = regs.PC;
+    }
+
+    /**
+      Handle a pending halt (RDY low), as execute() does before each read.
+      Only needed when the system is driven without execute().
+    */
+    void serviceHalt() { handleHalt(); }
+
+    /// Indicates the number of system cycles per processor cycle
+    static constexpr uInt32 SYSTEM_CYCLES_PER_CPU = 1;
+
     /**
       Tell the processor to stop executing instructions.  Invoking this
       method while the processor is executing instructions will stop
@@ -225,20 +261,26 @@ class M6502 : public Serializable
 
     BreakpointMap& breakPoints() { return myBreakPoints; }
 
-    // methods for 'breakif' handling
+    // methods for 'breakif' handling (programs may be shared, see ExpressionCache)
     uInt32 addCondBreak(Expression* e, string_view name, bool oneShot = false);
+    uInt32 addCondBreak(shared_ptr<const ExpressionProgram> program,
+                        string_view name, bool oneShot = false);
     bool delCondBreak(uInt32 idx);
     void clearCondBreaks();
     const StringList& getCondBreakNames() const;
 
     // methods for 'savestateif' handling
     uInt32 addCondSaveState(Expression* e, string_view name);
+    uInt32 addCondSaveState(shared_ptr<const ExpressionProgram> program,
+                            string_view name);
     bool delCondSaveState(uInt32 idx);
     void clearCondSaveStates();
     const StringList& getCondSaveStateNames() const;
 
     // methods for 'trapif' handling
     uInt32 addCondTrap(Expression* e, string_view name);
+    uInt32 addCondTrap(shared_ptr<const ExpressionProgram> program,
+                       string_view name);
     bool delCondTrap(uInt32 idx);
     void clearCondTraps();
     const StringList& getCondTrapNames() const;
@@ -260,6 +302,19 @@ class M6502 : public Serializable
     bool getLogBreaks() const { return myLogBreaks; }
     void setLogTrace(bool enable) { myLogTrace = enable; }
     bool getLogTrace() const { return myLogTrace; }
+
+    // methods for 'traceRecord' handling
+    TraceRecorder& traceRecorder() { return myTraceRecorder; }
+
+    // methods for 'profile' handling
+    CallProfiler& callProfiler() { return myCallProfiler; }
+
+    /**
+      Execute single instructions like the debugger's 'step', but without
+      any debugger checks, until the system cycles reach 'cycles'.  This
+      is used to deterministically replay steps from a rewind state.
+    */
+    void replay(uInt64 cycles);
 #endif  // DEBUGGER_SUPPORT
 
   private:
@@ -275,6 +330,7 @@ class M6502 : public Serializable
 
       @return The byte at the specified address
     */
+    template<bool Hooks = true>
     uInt8 peek(uInt16 address, Device::AccessFlags flags);
 
     /**
@@ -284,6 +340,7 @@ class M6502 : public Serializable
       @param address  The address where the value should be stored
       @param value    The value to be stored at the address
     */
+    template<bool Hooks = true>
     void poke(uInt16 address, uInt8 value, Device::AccessFlags flags = Device::NONE);
 
     /**
@@ -323,15 +380,31 @@ class M6502 : public Serializable
     /**
       Check whether halt was requested (RDY low) and notify
     */
-    void handleHalt();
+    void handleHalt() {
+      if (myHaltRequested) {
+        myOnHaltCallback();
+        myHaltRequested = false;
+      }
+    }
 
     /**
       This is the actual dispatch function that does the grunt work. M6502::execute
       wraps it and makes sure that any pending halt is processed before returning.
+
+      With 'Hooks' disabled, all debugger checks (traps, breakpoints, timers,
+      conditional breaks, tracing etc.) are compiled out of the hot loop.
+      M6502::execute only selects this engine if none of them is armed.
     */
+    template<bool Hooks>
     void _execute(uInt64 cycles, DispatchResult& result);
 
 #ifdef DEBUGGER_SUPPORT
+    /**
+      Check whether any debugger feature is armed which requires the checks
+      of the full execution engine.
+    */
+    bool debuggerHooksArmed() const;
+
     /**
       Check whether we are required to update hardware (TIA + RIOT) in lockstep
       with the CPU and update the flag accordingly.
@@ -383,6 +456,9 @@ class M6502 : public Serializable
     /// Last cycle that triggered a breakpoint
     uInt64 myLastBreakCycle{ULLONG_MAX};
 
+    /// System cycles at which the last execute() stopped
+    uInt64 myLastStopCycles{0};
+
     /// Indicates the last address which was accessed specifically
     /// by a peek or poke command
     uInt16 myLastPeekAddress{0}, myLastPokeAddress{0};
@@ -403,9 +479,6 @@ class M6502 : public Serializable
     /// is set to zero
     uInt16 myDataAddressForPoke{0};
 
-    /// Indicates the number of system cycles per processor cycle
-    static constexpr uInt32 SYSTEM_CYCLES_PER_CPU = 1;
-
     /// Called when the processor enters halt state
     onHaltCallback myOnHaltCallback{nullptr};
 
@@ -413,31 +486,19 @@ class M6502 : public Serializable
     bool myHaltRequested{false};
 
 #ifdef DEBUGGER_SUPPORT
-    Int32 evalCondBreaks() {
-      for(Int32 i = static_cast<Int32>(myCondBreaks.size()) - 1; i >= 0; --i)
-        if(myCondBreaks[i]->evaluate())
-          return i;
-
-      return -1; // no break hit
-    }
-
-    Int32 evalCondSaveStates()
-    {
-      for(Int32 i = static_cast<Int32>(myCondSaveStates.size()) - 1; i >= 0; --i)
-        if(myCondSaveStates[i]->evaluate())
-          return i;
-
-      return -1; // no save state point hit
-    }
+    /**
+      Evaluate the conditional breaks/save states/traps, and return the
+      index of the last one which is true, or -1 if none is.
+    */
+    Int32 evalCondBreaks() const;
+    Int32 evalCondSaveStates() const;
+    Int32 evalCondTraps() const;
 
-    Int32 evalCondTraps()
-    {
-      for(Int32 i = static_cast<Int32>(myTrapConds.size()) - 1; i >= 0; --i)
-        if(myTrapConds[i]->evaluate())
-          return i;
+    // Add the current CPU/TIA state to the binary execution trace
+    void recordTrace();
 
-      return -1; // no trapif hit
-    }
+    // Pass the just executed instruction to the call profiler
+    void profileInstruction();
 
     /// Pointer to the debugger for this processor or the null pointer
     Debugger* myDebugger{nullptr};
@@ -455,15 +516,19 @@ class M6502 : public Serializable
     HitTrapInfo myHitTrapInfo;
 
     BreakpointMap myBreakPoints;
-    vector<unique_ptr<Expression>> myCondBreaks;
+    vector<shared_ptr<const ExpressionProgram>> myCondBreaks;
     StringList myCondBreakNames;
-    vector<unique_ptr<Expression>> myCondSaveStates;
+    vector<shared_ptr<const ExpressionProgram>> myCondSaveStates;
     StringList myCondSaveStateNames;
-    vector<unique_ptr<Expression>> myTrapConds;
+    vector<shared_ptr<const ExpressionProgram>> myTrapConds;
     StringList myTrapCondNames;
 
     TimerMap myTimer;
 
+    TraceRecorder myTraceRecorder;
+
+    CallProfiler myCallProfiler;
+
 #endif  // DEBUGGER_SUPPORT
 
     bool myGhostReadsTrap{false};          // trap on ghost reads
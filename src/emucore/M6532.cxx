@@ -53,9 +53,11 @@ void M6532::reset()
       ram = mySystem->randGenerator().next();
   else
     myRAM.fill(0);
+  myRAMWatchChanged = myRAMWatch.any();
 
   myTimer = mySystem->randGenerator().next() & 0xff;
   myDivider = 1024;
+  myDividerShift = 10;
   mySubTimer = 0;
   myWrappedThisCycle = false;
 
@@ -116,15 +118,15 @@ void M6532::updateEmulation()
   if (cycles == 0) return;
 
   myWrappedThisCycle = false;
-  mySubTimer = (cycles + mySubTimer) % myDivider;
+  mySubTimer = (cycles + mySubTimer) & (myDivider - 1);
 
   if ((myInterruptFlag & TimerBit) == 0)
   {
-    const uInt32 timerTicks = (cycles + subTimer) / myDivider;
+    const uInt32 timerTicks = (cycles + subTimer) >> myDividerShift;
 
     if(timerTicks > myTimer)
     {
-      cycles -= ((myTimer + 1) * myDivider - subTimer);
+      cycles -= (((myTimer + 1) << myDividerShift) - subTimer);
 
       myWrappedThisCycle = cycles == 0;
       myTimer = 0xFF;
@@ -261,7 +263,10 @@ bool M6532::poke(uInt16 addr, uInt8 value)
   // A9 = 0 is write to RAM
   if((addr & 0x0200) == 0x0000)
   {
-    myRAM[addr & 0x007f] = value;
+    const uInt16 index = addr & 0x007f;
+    if(myRAMWatch[index] && myRAM[index] != value)
+      myRAMWatchChanged = true;
+    myRAM[index] = value;
     return true;
   }
 
@@ -317,9 +322,10 @@ bool M6532::poke(uInt16 addr, uInt8 value)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void M6532::setTimerRegister(uInt8 value, uInt8 interval)
 {
-  static constexpr std::array<uInt32, 4> divider = { 1, 8, 64, 1024 };
+  static constexpr std::array<uInt32, 4> dividerShift = { 0, 3, 6, 10 };
 
-  myDivider = divider[interval];
+  myDividerShift = dividerShift[interval];
+  myDivider = 1U << myDividerShift;
   myOutTimer[interval] = value;
 
   myTimer = value;
@@ -409,10 +415,12 @@ bool M6532::load(Serializer& in)
   try
   {
     in.getByteArray(myRAM);
+    myRAMWatchChanged = myRAMWatch.any();
 
     myTimer = in.getInt();
     mySubTimer = in.getInt();
     myDivider = in.getInt();
+    myDividerShift = static_cast<uInt32>(std::countr_zero(myDivider));
     myWrappedThisCycle = in.getBool();
     myLastCycle = in.getLong();
     mySetTimerCycle = in.getLong();
@@ -516,18 +524,21 @@ void M6532::setAccessFlags(uInt16 address, Device::AccessFlags flags)
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void M6532::increaseAccessCounter(uInt16 address, bool isWrite)
+void M6532::increaseAccessCounter(uInt16 address, bool isWrite, AccessCounter count)
 {
   if (address & IO_BIT)
-    myIOAccessCounter[(isWrite ? IO_SIZE : 0) + (address & IO_MASK)]++;
+    countAccess(myIOAccessCounter[(isWrite ? IO_SIZE : 0) + (address & IO_MASK)], count);
   else {
     // the first access, either by direct RAM or stack access is assumed as initialization
-    if (myZPAccessDelay[address & RAM_MASK])
-      myZPAccessDelay[address & RAM_MASK]--;
-    else if (address & STACK_BIT)
-      myStackAccessCounter[(isWrite ? STACK_SIZE : 0) + (address & STACK_MASK)]++;
+    const auto delay = std::min<AccessCounter>(myZPAccessDelay[address & RAM_MASK], count);
+
+    myZPAccessDelay[address & RAM_MASK] -= delay;
+    if (address & STACK_BIT)
+      countAccess(myStackAccessCounter[(isWrite ? STACK_SIZE : 0) + (address & STACK_MASK)],
+                  count - delay);
     else
-      myRAMAccessCounter[(isWrite ? RAM_SIZE : 0) + (address & RAM_MASK)]++;
+      countAccess(myRAMAccessCounter[(isWrite ? RAM_SIZE : 0) + (address & RAM_MASK)],
+                  count - delay);
   }
 }
 
@@ -23,6 +23,8 @@ class RiotDebug;
 class System;
 class Settings;
 
+#include <bitset>
+
 #include "bspf.hxx"
 #include "Device.hxx"
 
@@ -130,6 +132,27 @@ class M6532 : public Device
     */
     const uInt8* getRAM() const { return myRAM.data(); }
 
+    /**
+      Watch writes to a RAM byte ($80 - $FF), independent of the debugger.
+      Writing a new value to a watched byte (and a reset or state load) is
+      recorded, until taken with takeWatchedChanges().
+
+      @param address  The address of the RAM byte
+      @param watch    Whether to watch or ignore the byte
+    */
+    void watchRAM(uInt16 address, bool watch = true) {
+      myRAMWatch[address & 0x007f] = watch;
+      myRAMWatchChanged = myRAMWatchChanged || watch;
+    }
+    void clearRAMWatches() { myRAMWatch.reset(); myRAMWatchChanged = false; }
+
+    /**
+      Whether a watched RAM byte changed since the last call.
+    */
+    bool takeWatchedChanges() {
+      return std::exchange(myRAMWatchChanged, false);
+    }
+
   #ifdef DEBUGGER_SUPPORT
     /**
       Query the given address type for the associated access flags.
@@ -149,8 +172,11 @@ class M6532 : public Device
       Increase the given address's access counter
 
       @param address The address to modify
+      @param isWrite Whether the accesses were writes
+      @param count   The number of accesses
     */
-    void increaseAccessCounter(uInt16 address, bool isWrite) override;
+    void increaseAccessCounter(uInt16 address, bool isWrite,
+                               AccessCounter count) override;
 
     /**
       Query the access counters
@@ -191,6 +217,10 @@ class M6532 : public Device
     // An amazing 128 bytes of RAM
     std::array<uInt8, 128> myRAM{};
 
+    // RAM bytes watched for changes, and whether any of them changed
+    std::bitset<128> myRAMWatch;
+    bool myRAMWatchChanged{false};
+
     // Current value of the timer
     uInt8 myTimer{0};
 
@@ -200,6 +230,10 @@ class M6532 : public Device
     // The divider
     uInt32 myDivider{1};
 
+    // log2 of the divider (all dividers are powers of two), so that the
+    // frequent catch-ups don't need any divisions
+    uInt32 myDividerShift{0};
+
     // Has the timer wrapped this very cycle?
     bool myWrappedThisCycle{false};
 
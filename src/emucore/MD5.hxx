@@ -71,16 +71,39 @@ class MD5
     static string hash(string_view buffer);
 
   public:
-    MD5() = default;
+    MD5() { init(); }
     ~MD5() = default;
 
-  private:
+    /**
+      Reset the object to begin a new message-digest operation.
+    */
     void init();
-    void update(const uInt8* input, uInt32 length);
+
+    /**
+      Continue the message-digest operation with the given message
+      chunk.  This may be called any number of times, with chunks of
+      any size, before calling 'hexdigest()'.
+
+      @param input   The next part of the message
+      @param length  The length of the message part
+    */
+    void update(const uInt8* input, size_t length);
+    void update(string_view input) {
+      update(reinterpret_cast<const uInt8*>(input.data()), input.size());
+    }
+
+    /**
+      Finish the message-digest operation (if not already done) and
+      return the digest as 32 hexadecimal digits.  Further calls to
+      'update()' are ignored until 'init()' is called again.
+
+      @return   The message-digest
+    */
+    string hexdigest();
+
+  private:
     void finalize();
-    string hexdigest() const;
-    void transform(const uInt8* block);
-    static void decode(uInt32* output, const uInt8* input, uInt32 len);
+    void transform(const uInt8* blocks, size_t numBlocks);
     static void encode(uInt8* output, const uInt32* input, uInt32 len);
 
     // F, G, H and I are basic MD5 functions.
@@ -123,7 +146,7 @@ class MD5
     static constexpr uInt32 BLOCKSIZE = 64;
     bool finalized{false};
     std::array<uInt8, BLOCKSIZE> buffer{}; // bytes that didn't fit in last chunk
-    std::array<uInt32, 2> count{};   // 64bit counter for number of bits (lo, hi)
+    uInt64 count{0};                 // number of bytes hashed so far
     std::array<uInt32, 4> state{};   // digest so far
     std::array<uInt8, 16> digest{};  // the result
 
@@ -0,0 +1,73 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2026 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#ifndef MEMORY_REPORT_HXX
+#define MEMORY_REPORT_HXX
+
+#include "bspf.hxx"
+
+/**
+  Collects the number of bytes owned by each subsystem (the chips and the
+  cartridge, rewind states, audio fragments, surfaces, fonts, ...), so that
+  the memory use of an instance can be inspected from the debugger prompt
+  ('memory') or a headless debugger script.
+
+  @author  Stella Team
+*/
+class MemoryReport
+{
+  public:
+    struct Entry {
+      string name;
+      size_t bytes{0};
+    };
+
+  public:
+    MemoryReport() = default;
+
+    void add(string_view name, size_t bytes) {
+      myEntries.emplace_back(string{name}, bytes);
+    }
+
+    const vector<Entry>& entries() const { return myEntries; }
+
+    size_t total() const {
+      size_t sum = 0;
+      for(const auto& entry: myEntries)
+        sum += entry.bytes;
+      return sum;
+    }
+
+    /**
+      Format the report as a table, one subsystem per line, in KB.
+    */
+    string toString() const {
+      std::ostringstream buf;
+
+      for(const auto& entry: myEntries)
+        buf << std::format("{:<32} {:>10.1f} KB\n", entry.name,
+                           entry.bytes / 1024.0);
+      buf << std::format("{:<32} {:>10.1f} KB", "Total", total() / 1024.0);
+
+      return buf.str();
+    }
+
+  private:
+    vector<Entry> myEntries;
+};
+
+#endif // MEMORY_REPORT_HXX
@@ -34,6 +34,10 @@
   Converted to templates to support also the 24LC16B / EFF (Grizzards) cart
   type by Bruce-Robert Pocock with loads of help from Ryan Witmer.
 
+  The EEPROM image is kept in memory, and is only written back to the data
+  file when the device is destroyed (and only if it was modified), so EEPROM
+  writes never cause file I/O during emulation.
+
   @author Stephen Anthony & J. Payson, and Bruce-Robert Pocock & Ryan Witmer
 */
 template<size_t DEVICE_FLASH_SIZE, size_t DEVICE_PAGE_SIZE>
@@ -15,6 +15,8 @@
 // this file, and for a DISCLAIMER OF ALL WARRANTIES.
 //============================================================================
 
+#include <future>
+
 #include "bspf.hxx"
 #include "Logger.hxx"
 
@@ -36,11 +38,16 @@
   #include "PlusRomsMenu.hxx"
   #include "Launcher.hxx"
   #include "TimeMachine.hxx"
+  #include "SharedMemoryExport.hxx"
+  #include "VideoRecorder.hxx"
+#endif
+
+#ifdef HTTP_LIB_SUPPORT
+  #include "MetricsServer.hxx"
 #endif
 
 #include "AsciiFold.hxx"
 #include "FSNode.hxx"
-#include "MD5.hxx"
 #include "Cart.hxx"
 #include "CartCreator.hxx"
 #include "CartDetector.hxx"
@@ -55,9 +62,14 @@
 #include "Console.hxx"
 #include "Random.hxx"
 #include "StateManager.hxx"
+#include "RewindManager.hxx"
+#include "RomPrefetcher.hxx"
+#include "MemoryReport.hxx"
 #include "TimerManager.hxx"
 #ifdef GUI_SUPPORT
   #include "HighScoresManager.hxx"
+  #include "RomIndex.hxx"
+  #include "DirectoryIndex.hxx"
 #endif
 #include "Version.hxx"
 #include "TIA.hxx"
@@ -65,6 +77,8 @@
 #include "EmulationWorker.hxx"
 #include "AudioSettings.hxx"
 #include "M6532.hxx"
+#include "PerfCounters.hxx"
+#include "StartupTrace.hxx"
 
 #include "OSystem.hxx"
 
@@ -102,6 +116,8 @@ OSystem::OSystem()
   mySettings = MediaFactory::createSettings();
 
   myPropSet = std::make_unique<PropertiesSet>();
+  myRomPrefetcher = std::make_unique<RomPrefetcher>(*mySettings, *myPropSet,
+    [this](string_view md5) { return cartProperties(md5); });
 
   Logger::instance().setLogParameters(Logger::Level::MAX, false);
 }
@@ -137,8 +153,6 @@ bool OSystem::initialize(const Settings::Options& options)
       << AsciiFold::toAscii(myNVRamDir.getShortPath()) << "'\n"
       << "Persistence:        '"
       << AsciiFold::toAscii(describePresistence()) << "'\n"
-      << "Cheat file:         '"
-      << AsciiFold::toAscii(myCheatFile.getShortPath()) << "'\n"
       << "Palette file:       '"
       << AsciiFold::toAscii(myPaletteFile.getShortPath()) << "'\n";
   Logger::info(buf.view());
@@ -149,6 +163,7 @@ bool OSystem::initialize(const Settings::Options& options)
   // it may be needed to initialize the size of graphical objects
   try
   {
+    const StartupTrace::Scope trace("FrameBuffer::initialize");
     myFrameBuffer = std::make_unique<FrameBuffer>(*this);
     myFrameBuffer->initialize();
   }
@@ -176,8 +191,9 @@ bool OSystem::initialize(const Settings::Options& options)
   myRandom = std::make_unique<Random>(static_cast<uInt32>(TimerManager::getTicks()));
 
 #ifdef CHEATCODE_SUPPORT
+  // The cheats of a ROM are only loaded when it is started
   myCheatManager = std::make_unique<CheatManager>(*this);
-  myCheatManager->loadCheatDatabase();
+  myCheatManager->setRepository(getCheatRepository());
 #endif
 
 #ifdef GUI_SUPPORT
@@ -189,9 +205,28 @@ bool OSystem::initialize(const Settings::Options& options)
   myMessageMenu = std::make_unique<MessageMenu>(*this);
   myPlusRomMenu = std::make_unique<PlusRomsMenu>(*this);
   myTimeMachine = std::make_unique<TimeMachine>(*this);
+  myVideoRecorder = std::make_unique<VideoRecorder>(*this);
+  mySharedMemoryExport = std::make_unique<SharedMemoryExport>(*this);
   myLauncher = std::make_unique<Launcher>(*this);
+  myRomIndex = std::make_unique<RomIndex>(*this);
+  myDirectoryIndex = std::make_unique<DirectoryIndex>();
+  myDirectoryIndex->setListedCallback([this](const string& dir,
+      uInt64 modified, uInt64 listed, const FSList& entries) {
+    myPropSet->addPerROMFiles(dir, modified, listed, entries);
+  });
 
   myHighScoresManager->setRepository(getHighscoreRepository());
+  myRomIndex->setRepository(getRomIndexRepository());
+#endif
+
+#ifdef HTTP_LIB_SUPPORT
+  if(const int port = mySettings->getInt("metrics"); port > 0)
+  {
+    myMetricsServer = std::make_unique<MetricsServer>(
+        mySettings->getString("metrics.bind"), port);
+    if(!myMetricsServer->isRunning())
+      myMetricsServer.reset();
+  }
 #endif
 
 #ifdef IMAGE_SUPPORT
@@ -231,12 +266,19 @@ void OSystem::loadConfig(const Settings::Options& options)
   if(!myHomeDir.isDirectory())
     myHomeDir.makeDir();
 
-  initPersistence(myBaseDir);
+  {
+    const StartupTrace::Scope trace("initPersistence");
+    initPersistence(myBaseDir);
+  }
 
   mySettings->setRepository(getSettingsRepository());
   myPropSet->setRepository(getPropertyRepository());
+  myPropSet->setDetectionRepository(getDetectionRepository());
 
-  mySettings->load(options);
+  {
+    const StartupTrace::Scope trace("Settings::load");
+    mySettings->load(options);
+  }
 
   // userDir is NOT affected by '-baseDir'and '-basedirinapp' params
   string userDir = mySettings->getString("userdir");
@@ -246,8 +288,28 @@ void OSystem::loadConfig(const Settings::Options& options)
   if(!myUserDir.isDirectory())
     myUserDir.makeDir();
 
-  Logger::instance().setLogParameters(mySettings->getInt("loglevel"),
-                                      mySettings->getBool("logtoconsole"));
+  // Apply the log settings now and whenever they change later on
+  const auto updateLogger = [this](const Variant&) {
+    Logger& logger = Logger::instance();
+    logger.setLogParameters(mySettings->getInt("loglevel"),
+                            mySettings->getBool("logtoconsole"));
+
+    // The rate limits are given as 'errors,info,debug' messages per second
+    std::istringstream limits(mySettings->getString("lograte"));
+    string limit;
+    for(int level = static_cast<int>(Logger::Level::MIN);
+        level <= static_cast<int>(Logger::Level::MAX); ++level)
+    {
+      if(!std::getline(limits, limit, ','))
+        limit.clear();
+      logger.setRateLimit(static_cast<Logger::Level>(level),
+                          static_cast<uInt32>(std::max(BSPF::stoi(limit), 0)));
+    }
+  };
+  updateLogger(EmptyVariant());
+  mySettings->onChange("loglevel", updateLogger);
+  mySettings->onChange("logtoconsole", updateLogger);
+  mySettings->onChange("lograte", updateLogger);
   Logger::debug("Loading config options ...");
 
   // Get updated paths for all configuration files
@@ -289,7 +351,6 @@ void OSystem::setConfigPaths()
   buildDirIfRequired(myCfgDir, myBaseDir, "cfg");
 #endif
 
-  myCheatFile = myBaseDir;  myCheatFile /= "stella.cht";
   myPaletteFile = myBaseDir;  myPaletteFile /= "stella.pal";
 
 #if 0
@@ -305,7 +366,6 @@ void OSystem::setConfigPaths()
   dbgPath("ssave dir ", mySnapshotSaveDir);
   dbgPath("sload dir ", mySnapshotLoadDir);
   dbgPath("bezel dir ", myBezelDir);
-  dbgPath("cheat file", myCheatFile);
   dbgPath("pal file  ", myPaletteFile);
 #endif
 }
@@ -391,6 +451,8 @@ bool OSystem::checkUserPalette(bool outputError) const
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 FBInitStatus OSystem::createFrameBuffer()
 {
+  const StartupTrace::Scope trace("createFrameBuffer");
+
   // Re-initialize the framebuffer to current settings
   FBInitStatus fbstatus = FBInitStatus::FailComplete;
   switch(myEventHandler->state())
@@ -432,6 +494,8 @@ FBInitStatus OSystem::createFrameBuffer()
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void OSystem::createSound()
 {
+  const StartupTrace::Scope trace("createSound");
+
   if(!mySound)
     mySound = MediaFactory::createAudio(*this, *myAudioSettings);
 #ifndef SOUND_SUPPORT
@@ -442,6 +506,7 @@ void OSystem::createSound()
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 string OSystem::createConsole(const FSNode& rom, string_view md5sum, bool newrom)
 {
+  const StartupTrace::Scope trace("createConsole");
   bool showmessage = false;
 
   // If same ROM has been given, we reload the current one (assuming one exists)
@@ -477,6 +542,12 @@ string OSystem::createConsole(const FSNode& rom, string_view md5sum, bool newrom
     return buf.str();
   }
 
+  return startConsole(showmessage);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+string OSystem::startConsole(bool showmessage)
+{
   if(myConsole)
   {
   #ifdef DEBUGGER_SUPPORT
@@ -486,6 +557,9 @@ string OSystem::createConsole(const FSNode& rom, string_view md5sum, bool newrom
   #endif
   #ifdef CHEATCODE_SUPPORT
     myCheatManager->loadCheats(myRomMD5);
+  #endif
+  #ifdef GUI_SUPPORT
+    myHighScoresManager->startTracking();
   #endif
     myEventHandler->reset(EventHandlerState::EMULATION);
     myEventHandler->setMouseControllerMode(mySettings->getString("usemouse"));
@@ -514,6 +588,7 @@ string OSystem::createConsole(const FSNode& rom, string_view md5sum, bool newrom
         myFrameBuffer->showTextMessage("Multicart " +
           myConsole->cartridge().detectedType() + ", loading ROM" + id);
     }
+    std::ostringstream buf;
     buf << "Game console created:\n"
         << "  ROM file: " << myRomFile.getShortPath() << '\n';
     const FSNode propsFile(myRomFile.getPathWithExt(".pro"));
@@ -526,6 +601,11 @@ string OSystem::createConsole(const FSNode& rom, string_view md5sum, bool newrom
 
     myEventHandler->handleConsoleStartupEvents();
     myConsole->riot().update();
+    myStateManager->startMovie();
+    myStateManager->startNetplay();
+  #ifdef GUI_SUPPORT
+    mySharedMemoryExport->start();
+  #endif
 
   #ifdef DEBUGGER_SUPPORT
     if(mySettings->getBool("debug"))
@@ -584,6 +664,142 @@ string OSystem::createConsole(const FSNode& rom, string_view md5sum, bool newrom
   return EmptyString();
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+struct OSystem::ConsoleLoad
+{
+  enum class Stage: uInt8 { Reading, Creating };
+
+  FSNode rom;
+  string md5;
+  LoadProgressCallback progress;
+  LoadDoneCallback done;
+
+  Stage stage{Stage::Reading};
+  bool cancelled{false};
+  std::future<void> task;
+
+  // Results of the worker, only accessed when the task has finished
+  ByteBuffer image;
+  size_t size{0};
+  Properties props;
+  string cartmd5;
+  CartCreator::Context cartContext;
+  unique_ptr<Cartridge> cart;
+};
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void OSystem::createConsoleAsync(const FSNode& rom, string_view md5sum,
+                                 const LoadProgressCallback& progress,
+                                 const LoadDoneCallback& done)
+{
+  if(myConsoleLoad)
+    return;
+
+  // A ROM prepared in the background is started right away
+  if(myRomPrefetcher->isReady(rom))
+  {
+    done(createConsole(rom, md5sum));
+    return;
+  }
+
+  myConsoleLoad = std::make_unique<ConsoleLoad>();
+  ConsoleLoad& load = *myConsoleLoad;
+  load.rom = rom;
+  load.md5 = md5sum;
+  load.progress = progress;
+  load.done = done;
+
+  // Read (and unzip) the image and hash it
+  load.task = std::async(std::launch::async, [&load] {
+    load.image = openROM(load.rom, load.size, true,
+                         load.md5.empty() ? &load.md5 : nullptr);
+    if(load.image == nullptr)
+      throw std::runtime_error("Couldn't read ROM file");
+  });
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void OSystem::prefetchRom(const FSNode& rom)
+{
+  myRomPrefetcher->prefetch(rom);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void OSystem::updateConsoleLoad()
+{
+  using enum ConsoleLoad::Stage;
+
+  // Only prepare the next ROM when not busy loading the current one
+  if(!myConsoleLoad)
+  {
+    myRomPrefetcher->update();
+    return;
+  }
+
+  ConsoleLoad& load = *myConsoleLoad;
+  if(load.progress((static_cast<int>(load.stage) + 1) * 100 / 3))
+    load.cancelled = true;
+
+  // A running stage can't be interrupted, the dialog stays open until it
+  // has finished
+  if(load.task.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+    return;
+
+  string result;
+  try
+  {
+    load.task.get();  // rethrows the errors of the worker
+
+    // The settings and properties are only accessed from the main thread,
+    // so the worker only reports what to store there
+    if(load.stage == Creating)
+      CartCreator::finish(load.cartContext, *mySettings, myPropSet.get());
+
+    if(load.cancelled)
+      result = "Loading cancelled";
+    else if(load.stage == Reading)
+    {
+      myPropSet->loadPerROM(load.rom, load.md5);
+      load.props = cartProperties(load.md5);
+      load.cartmd5 = load.md5;
+      // A new ROM starts with the first game of a multicart
+      mySettings->setValue("romloadcount", -1);
+      load.cartContext = CartCreator::prepare(load.md5, *mySettings,
+                                              myPropSet.get());
+
+      // Detect the type and create the cartridge (e.g. linking ELF images)
+      load.stage = Creating;
+      load.task = std::async(std::launch::async, [&load, this] {
+        load.cart = CartCreator::create(load.rom, load.image, load.size,
+          load.cartmd5, load.props.get(PropType::Cart_Type), *mySettings,
+          load.cartContext);
+      });
+      return;
+    }
+    else
+    {
+      // Continue as createConsole() does for a new ROM
+      myRomFile = load.rom;
+      myRomMD5  = load.md5;
+      myEventHandler->handleConsoleStartupEvents();
+
+      closeConsole();
+      myConsole = openConsole(myRomFile, std::move(load.cart), load.props,
+                              load.cartmd5);
+      result = startConsole(false);
+    }
+  }
+  catch(const std::runtime_error& e)
+  {
+    result = string("ERROR: ") + e.what();
+    Logger::error(result);
+  }
+
+  const LoadDoneCallback done = std::move(load.done);
+  myConsoleLoad.reset();
+  done(result);
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 std::optional<string> OSystem::reloadConsole(bool nextrom)
 {
@@ -601,6 +817,21 @@ bool OSystem::hasConsole() const
          myEventHandler->state() != EventHandlerState::LAUNCHER;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+MemoryReport OSystem::memoryReport() const
+{
+  MemoryReport report;
+
+  if(myConsole)
+    myConsole->memoryReport(report);
+  if(myStateManager)
+    report.add("Rewind states", myStateManager->rewindManager().memoryUsage());
+  if(myFrameBuffer)
+    myFrameBuffer->memoryReport(report);
+
+  return report;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool OSystem::createLauncher(string_view startdir)
 {
@@ -670,105 +901,147 @@ void OSystem::toggleTimeMachine()
 void OSystem::resetFps()
 {
   myFpsMeter.reset();
+  myFrameTimes.reset();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 unique_ptr<Console> OSystem::openConsole(const FSNode& romfile, string& md5)
 {
-  unique_ptr<Console> console;
-
-  // Open the cartridge image and read it in
+  ByteBuffer image;
   size_t size = 0;
-  if(const ByteBuffer image = openROM(romfile, md5, size); image != nullptr)
+
+  // Use the ROM prepared in the background, if any
+  if(RomPrefetcher::Rom prefetched; myRomPrefetcher->take(romfile, prefetched))
   {
-    // Get a valid set of properties, including any entered on the commandline
-    // For initial creation of the Cart, we're only concerned with the BS type
-    Properties props;
-    myPropSet->getMD5(md5, props);
+    md5 = prefetched.md5;
+    if(prefetched.cart)
+      return openConsole(romfile, std::move(prefetched.cart),
+                         std::move(prefetched.props), prefetched.cartmd5);
 
-    // Local helper method
-    const auto CMDLINE_PROPS_UPDATE = [&](string_view name, PropType prop)
-    {
-      const string_view s = mySettings->getString(name);
-      if(!s.empty()) props.set(prop, s);
-    };
+    image = std::move(prefetched.image);
+    size = prefetched.size;
+  }
+  else
+    // Open the cartridge image and read it in
+    image = openROM(romfile, md5, size);
 
-    CMDLINE_PROPS_UPDATE("bs", PropType::Cart_Type);
-    CMDLINE_PROPS_UPDATE("type", PropType::Cart_Type);
-    CMDLINE_PROPS_UPDATE("startbank", PropType::Cart_StartBank);
+  if(image != nullptr)
+  {
+    // For initial creation of the Cart, we're only concerned with the BS type
+    const Properties props = cartProperties(md5);
 
     // Now create the cartridge
     string cartmd5 = md5;
-    const string& type = props.get(PropType::Cart_Type);
-    const Cartridge::messageCallback callback = [&os = *this](string_view msg)
-    {
-      const bool devSettings = os.settings().getBool("dev.settings");
-
-      if(os.settings().getBool(devSettings ? "dev.extaccess" : "plr.extaccess"))
-        os.frameBuffer().showTextMessage(msg);
+    const auto createCart = [&]() {
+      const StartupTrace::Scope trace("CartCreator::create");
+      return CartCreator::create(romfile, image, size, cartmd5,
+                                 props.get(PropType::Cart_Type),
+                                 *mySettings, myPropSet.get());
     };
+    return openConsole(romfile, createCart(), props, cartmd5);
+  }
 
-    unique_ptr<Cartridge> cart =
-      CartCreator::create(romfile, image, size, cartmd5, type, *mySettings);
-    cart->setMessageCallback(callback);
+  return nullptr;
+}
 
-    // Some properties may not have a name set; we can't leave it blank
-    if(props.get(PropType::Cart_Name) == EmptyString())
-      props.set(PropType::Cart_Name, romfile.getNameWithExt(""));
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+Properties OSystem::cartProperties(string_view md5) const
+{
+  // Get a valid set of properties, including any entered on the commandline
+  Properties props;
+  myPropSet->getMD5(md5, props);
 
-    // It's possible that the cart created was from a piece of the image,
-    // and that the md5 (and hence the cart) has changed
-    if(props.get(PropType::Cart_MD5) != cartmd5)
-    {
-      if(!myPropSet->getMD5(cartmd5, props))
-      {
-        // Cart md5 wasn't found, so we create a new props for it
-        props.set(PropType::Cart_MD5, cartmd5);
-        props.set(PropType::Cart_Name, props.get(PropType::Cart_Name)+cart->multiCartID());
-        myPropSet->insert(props, false);
-      }
-    }
+  // Local helper method
+  const auto CMDLINE_PROPS_UPDATE = [&](string_view name, PropType prop)
+  {
+    const string_view s = mySettings->getString(name);
+    if(!s.empty()) props.set(prop, s);
+  };
 
-    CMDLINE_PROPS_UPDATE("sp", PropType::Console_SwapPorts);
-    CMDLINE_PROPS_UPDATE("lc", PropType::Controller_Left);
-    CMDLINE_PROPS_UPDATE("lq1", PropType::Controller_Left1);
-    CMDLINE_PROPS_UPDATE("lq2", PropType::Controller_Left2);
-    CMDLINE_PROPS_UPDATE("rc", PropType::Controller_Right);
-    CMDLINE_PROPS_UPDATE("rq1", PropType::Controller_Right1);
-    CMDLINE_PROPS_UPDATE("rq2", PropType::Controller_Right2);
-    const string& bc = mySettings->getString("bc");
-    if(!bc.empty()) {
-      props.set(PropType::Controller_Left, bc);
-      props.set(PropType::Controller_Right, bc);
-    }
-    const string& aq = mySettings->getString("aq");
-    if(!aq.empty())
+  CMDLINE_PROPS_UPDATE("bs", PropType::Cart_Type);
+  CMDLINE_PROPS_UPDATE("type", PropType::Cart_Type);
+  CMDLINE_PROPS_UPDATE("startbank", PropType::Cart_StartBank);
+
+  return props;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+unique_ptr<Console> OSystem::openConsole(const FSNode& romfile,
+    unique_ptr<Cartridge> cart, Properties props, string_view cartmd5)
+{
+  if(!cart)
+    return nullptr;
+
+  const Cartridge::messageCallback callback = [&os = *this](string_view msg)
+  {
+    const bool devSettings = os.settings().getBool("dev.settings");
+
+    if(os.settings().getBool(devSettings ? "dev.extaccess" : "plr.extaccess"))
+      os.frameBuffer().showTextMessage(msg);
+  };
+  cart->setMessageCallback(callback);
+
+  // Local helper method
+  const auto CMDLINE_PROPS_UPDATE = [&](string_view name, PropType prop)
+  {
+    const string_view s = mySettings->getString(name);
+    if(!s.empty()) props.set(prop, s);
+  };
+
+  // Some properties may not have a name set; we can't leave it blank
+  if(props.get(PropType::Cart_Name) == EmptyString())
+    props.set(PropType::Cart_Name, romfile.getNameWithExt(""));
+
+  // It's possible that the cart created was from a piece of the image,
+  // and that the md5 (and hence the cart) has changed
+  if(props.get(PropType::Cart_MD5) != cartmd5)
+  {
+    if(!myPropSet->getMD5(cartmd5, props))
     {
-      props.set(PropType::Controller_Left1, aq);
-      props.set(PropType::Controller_Left2, aq);
-      props.set(PropType::Controller_Right1, aq);
-      props.set(PropType::Controller_Right2, aq);
+      // Cart md5 wasn't found, so we create a new props for it
+      props.set(PropType::Cart_MD5, cartmd5);
+      props.set(PropType::Cart_Name, props.get(PropType::Cart_Name)+cart->multiCartID());
+      myPropSet->insert(props, false);
     }
-    CMDLINE_PROPS_UPDATE("cp", PropType::Controller_SwapPaddles);
-    CMDLINE_PROPS_UPDATE("ma", PropType::Controller_MouseAxis);
-    CMDLINE_PROPS_UPDATE("channels", PropType::Cart_Sound);
-    CMDLINE_PROPS_UPDATE("ld", PropType::Console_LeftDiff);
-    CMDLINE_PROPS_UPDATE("rd", PropType::Console_RightDiff);
-    CMDLINE_PROPS_UPDATE("tv", PropType::Console_TVType);
-    CMDLINE_PROPS_UPDATE("format", PropType::Display_Format);
-    CMDLINE_PROPS_UPDATE("vcenter", PropType::Display_VCenter);
-    CMDLINE_PROPS_UPDATE("pp", PropType::Display_Phosphor);
-    CMDLINE_PROPS_UPDATE("ppblend", PropType::Display_PPBlend);
-    CMDLINE_PROPS_UPDATE("pxcenter", PropType::Controller_PaddlesXCenter);
-    CMDLINE_PROPS_UPDATE("pycenter", PropType::Controller_PaddlesYCenter);
-    CMDLINE_PROPS_UPDATE("bezelname", PropType::Bezel_Name);
-
-    // Finally, create the cart with the correct properties
-    if(cart)
-      console = std::make_unique<Console>(*this, cart, props, *myAudioSettings);
   }
 
-  return console;
+  CMDLINE_PROPS_UPDATE("sp", PropType::Console_SwapPorts);
+  CMDLINE_PROPS_UPDATE("lc", PropType::Controller_Left);
+  CMDLINE_PROPS_UPDATE("lq1", PropType::Controller_Left1);
+  CMDLINE_PROPS_UPDATE("lq2", PropType::Controller_Left2);
+  CMDLINE_PROPS_UPDATE("rc", PropType::Controller_Right);
+  CMDLINE_PROPS_UPDATE("rq1", PropType::Controller_Right1);
+  CMDLINE_PROPS_UPDATE("rq2", PropType::Controller_Right2);
+  const string& bc = mySettings->getString("bc");
+  if(!bc.empty()) {
+    props.set(PropType::Controller_Left, bc);
+    props.set(PropType::Controller_Right, bc);
+  }
+  const string& aq = mySettings->getString("aq");
+  if(!aq.empty())
+  {
+    props.set(PropType::Controller_Left1, aq);
+    props.set(PropType::Controller_Left2, aq);
+    props.set(PropType::Controller_Right1, aq);
+    props.set(PropType::Controller_Right2, aq);
+  }
+  CMDLINE_PROPS_UPDATE("cp", PropType::Controller_SwapPaddles);
+  CMDLINE_PROPS_UPDATE("ma", PropType::Controller_MouseAxis);
+  CMDLINE_PROPS_UPDATE("channels", PropType::Cart_Sound);
+  CMDLINE_PROPS_UPDATE("ld", PropType::Console_LeftDiff);
+  CMDLINE_PROPS_UPDATE("rd", PropType::Console_RightDiff);
+  CMDLINE_PROPS_UPDATE("tv", PropType::Console_TVType);
+  CMDLINE_PROPS_UPDATE("format", PropType::Display_Format);
+  CMDLINE_PROPS_UPDATE("vcenter", PropType::Display_VCenter);
+  CMDLINE_PROPS_UPDATE("pp", PropType::Display_Phosphor);
+  CMDLINE_PROPS_UPDATE("ppblend", PropType::Display_PPBlend);
+  CMDLINE_PROPS_UPDATE("pxcenter", PropType::Controller_PaddlesXCenter);
+  CMDLINE_PROPS_UPDATE("pycenter", PropType::Controller_PaddlesYCenter);
+  CMDLINE_PROPS_UPDATE("bezelname", PropType::Bezel_Name);
+
+  // Finally, create the console with the correct properties
+  return std::make_unique<Console>(*this, cart, props, *myAudioSettings,
+                                   mySpareChips.get());
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -776,10 +1049,21 @@ void OSystem::closeConsole()
 {
   if(myConsole)
   {
+  #ifdef GUI_SUPPORT
+    // A recording or export can't continue with another console
+    myVideoRecorder->stopRecording();
+    mySharedMemoryExport->stop();
+    myHighScoresManager->stopTracking();
+  #endif
   #ifdef CHEATCODE_SUPPORT
     // If a previous console existed, save cheats before creating a new one
     myCheatManager->saveCheats(myConsole->properties().get(PropType::Cart_MD5));
   #endif
+    // Neither can a netplay session
+    myStateManager->stopNetplay();
+    // Keep the chips, so that the next console can reuse them
+    mySpareChips = std::make_unique<ConsoleChips>();
+    myConsole->releaseChips(*mySpareChips);
     myConsole.reset();
   }
 }
@@ -792,15 +1076,17 @@ ByteBuffer OSystem::openROM(const FSNode& rom, string& md5, size_t& size)
   // but also adds a properties entry if the one for the ROM doesn't
   // contain a valid name
 
-  ByteBuffer image = openROM(rom, size, true);  // handle error message here
+  // To save time, only generate an MD5 if we really need one
+  ByteBuffer image;
+  {
+    const StartupTrace::Scope trace("openROM");
+    image = openROM(rom, size, true,  // handle error message here
+                    md5.empty() ? &md5 : nullptr);
+  }
   if(image)
   {
     // If we get to this point, we know we have a valid file to open
     // Now we make sure that the file has a valid properties entry
-    // To save time, only generate an MD5 if we really need one
-    if(md5.empty())
-      md5 = MD5::hash(image, size);
-
     // Make sure to load a per-ROM properties entry, if one exists
     myPropSet->loadPerROM(rom, md5);
   }
@@ -812,14 +1098,15 @@ ByteBuffer OSystem::openROM(const FSNode& rom, string& md5, size_t& size)
 string OSystem::getROMMD5(const FSNode& rom)
 {
   size_t size = 0;
-  const ByteBuffer image = openROM(rom, size, false);  // ignore error message
+  string md5;
+  const ByteBuffer image = openROM(rom, size, false, &md5);  // ignore error message
 
-  return image ? MD5::hash(image, size) : EmptyString();
+  return image ? md5 : EmptyString();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 ByteBuffer OSystem::openROM(const FSNode& rom, size_t& size,
-                            bool showErrorMessage)
+                            bool showErrorMessage, string* md5)
 {
   // First check if this is a valid ROM filename
   const bool isValidROM = rom.isFile() && Bankswitch::isValidRomName(rom);
@@ -847,7 +1134,8 @@ ByteBuffer OSystem::openROM(const FSNode& rom, size_t& size,
   ByteBuffer image;
   try
   {
-    if(size = rom.read(image, sizeToRead); size == 0)
+    size = md5 ? rom.read(image, sizeToRead, *md5) : rom.read(image, sizeToRead);
+    if(size == 0)
       return nullptr;
   }
   catch(const std::runtime_error&)
@@ -882,39 +1170,138 @@ float OSystem::frameRate() const
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-double OSystem::dispatchEmulation(EmulationWorker& emulationWorker)
+double OSystem::dispatchEmulation(EmulationWorker& emulationWorker, bool lateLatch,
+                                  bool analogPoll)
 {
   if (!myConsole) return 0.;
 
   TIA& tia(myConsole->tia());
   const EmulationTiming& timing = myConsole->emulationTiming();
   DispatchResult dispatchResult;
+  const bool benchmark = myBenchmarkTime > 0;
+  const time_point<high_resolution_clock> startTime = high_resolution_clock::now();
+  uInt64 totalCycles = 0;
+
+  // When late-latching, the timeslice is emulated right now (with the input
+  // just polled), so its frame can be presented immediately.  As in the
+  // worker, at least the minimum number of cycles is emulated.
+  // With analog polling, the frame is emulated in slices of about 1 ms of
+  // 6507 time, and the analog controllers are sampled in between.
+  // Movie playback must stop exactly where the input was polled while
+  // recording, so it is always emulated here.  Analog polling would bypass
+  // the recorded input.
+  // Netplay emulates exactly one frame each time, or none while waiting for
+  // the remote player.
+  const bool moviePlayback =
+    myStateManager->mode() == StateManager::Mode::MoviePlayback;
+  const bool netplay = myStateManager->mode() == StateManager::Mode::Netplay;
+  analogPoll = analogPoll && !netplay &&
+    myStateManager->mode() != StateManager::Mode::MovieRecord;
+  lateLatch = (lateLatch && !benchmark) || moviePlayback || netplay;
+  if (moviePlayback) {
+    myStateManager->emulateMovie(dispatchResult, timing.maxCyclesPerTimeslice());
+    totalCycles = dispatchResult.getCycles();
+  }
+  else if (netplay) {
+    if (myStateManager->emulateNetplay(dispatchResult))
+      totalCycles = dispatchResult.getCycles();
+    else {
+      // Wait for one frame before trying again
+      dispatchResult.setOk(0);
+      totalCycles = timing.cyclesPerFrame();
+    }
+  }
+  else if (lateLatch) {
+    const uInt64 pollCycles = timing.cyclesPerSecond() / ANALOG_POLL_RATE;
+    const uInt32 frames = tia.framesSinceLastRender();
+    bool polling = analogPoll;
+
+    for(;;) {
+      tia.update(dispatchResult, polling
+        ? std::min(pollCycles, timing.maxCyclesPerTimeslice() - totalCycles)
+        : totalCycles > 0
+          ? timing.minCyclesPerTimeslice() - totalCycles : timing.maxCyclesPerTimeslice());
+      totalCycles += dispatchResult.getCycles();
+      if (dispatchResult.getStatus() != DispatchResult::Status::ok)
+        break;
+
+      if (polling) {
+        polling = tia.framesSinceLastRender() == frames &&
+                  totalCycles < timing.maxCyclesPerTimeslice();
+        if (polling) {
+          myEventHandler->pollAnalog();
+          continue;
+        }
+      }
+      if (totalCycles >= timing.minCyclesPerTimeslice())
+        break;
+    }
+  }
+
+  myFrameTimes.add(FrameTimes::Phase::Emulation,
+                   high_resolution_clock::now() - startTime);
 
   // Check whether we have a frame pending for rendering...
   const bool framePending = tia.newFramePending();
   // ... and copy it to the frame buffer. It is important to do this before
   // the worker is started to avoid racing.
   if (framePending) {
-    myFpsMeter.render(tia.framesSinceLastRender());
-    tia.renderToFrameBuffer();
-  }
-
-  // Start emulation on a dedicated thread. It will do its own scheduling to
-  // sync 6507 and real time and will run until we stop the worker.
-  emulationWorker.start(
-    timing.cyclesPerSecond(),
-    timing.maxCyclesPerTimeslice(),
-    timing.minCyclesPerTimeslice(),
-    &dispatchResult,
-    &tia
-  );
+    const uInt32 frames = tia.framesSinceLastRender();
 
-  // Render the frame. This may block, but emulation will continue to run on
-  // the worker, so the audio pipeline is kept fed :)
-  if (framePending) myFrameBuffer->updateInEmulationMode(myFpsMeter.fps());
+    myFpsMeter.render(frames);
+    myBenchmarkFrames += frames;
+#ifdef PERF_COUNTERS
+    PerfCounters::endFrame(frames);
+#endif
+    // Show a frame emulated ahead if enabled, else the pending one
+    if(!myStateManager->runAhead())
+      tia.renderToFrameBuffer();
+  #ifdef GUI_SUPPORT
+    myVideoRecorder->addFrame(frames);
+    mySharedMemoryExport->addFrame(frames);
+    myHighScoresManager->update();
+  #endif
+  #ifdef HTTP_LIB_SUPPORT
+    if(myMetricsServer) myMetricsServer->addFrame(frames);
+  #endif
+  }
 
-  // Stop the worker and wait until it has finished
-  const uInt64 totalCycles = emulationWorker.stop();
+  if (lateLatch) {
+    // Render the frame; with vsync, this blocks until the vblank
+    if (framePending) {
+      const time_point<high_resolution_clock> presentStart = high_resolution_clock::now();
+      myFrameBuffer->updateInEmulationMode(myFpsMeter.fps());
+      myFramePacer.presented(presentStart, high_resolution_clock::now());
+      myFrameTimes.endFrame();
+      myQualityGovernor.update(*this);
+    }
+  }
+  else {
+    // Start emulation on a dedicated thread. It will do its own scheduling to
+    // sync 6507 and real time and will run until we stop the worker.
+    emulationWorker.start(
+      timing.cyclesPerSecond(),
+      timing.maxCyclesPerTimeslice(),
+      timing.minCyclesPerTimeslice(),
+      &dispatchResult,
+      &tia,
+      benchmark ? myBenchmarkInterval : 0.
+    );
+
+    // Render the frame. This may block, but emulation will continue to run on
+    // the worker, so the audio pipeline is kept fed :)
+    if (framePending) myFrameBuffer->updateInEmulationMode(myFpsMeter.fps());
+
+    // Stop the worker and wait until it has finished
+    const time_point<high_resolution_clock> stopStart = high_resolution_clock::now();
+    totalCycles = emulationWorker.stop();
+    myFrameTimes.add(FrameTimes::Phase::Emulation,
+                     high_resolution_clock::now() - stopStart);
+    if (framePending) {
+      myFrameTimes.endFrame();
+      myQualityGovernor.update(*this);
+    }
+  }
 
   // Handle the dispatch result
   switch (dispatchResult.getStatus()) {
@@ -951,39 +1338,134 @@ double OSystem::dispatchEmulation(EmulationWorker& emulationWorker)
       myEventHandler->frying())
     myConsole->fry();
 
+  if (benchmark) {
+    myBenchmarkCycles += totalCycles;
+    myBenchmarkElapsed += duration_cast<duration<double>>(
+      high_resolution_clock::now() - startTime).count();
+    if (myBenchmarkElapsed >= myBenchmarkTime)
+      finishBenchmark();
+
+    // Don't wait for real time to catch up
+    return 0.;
+  }
+
   // Return the 6507 time used in seconds
   return static_cast<double>(totalCycles) /
       static_cast<double>(timing.cyclesPerSecond());
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void OSystem::startBenchmark()
+{
+  myBenchmarkTime = myConsole ? mySettings->getFloat("benchmark") : 0.F;
+  myBenchmarkInterval = mySettings->getInt("benchmark.interval") / 1000.;
+  myBenchmarkElapsed = 0.;
+  myBenchmarkCycles = myBenchmarkFrames = 0;
+
+  if (myConsole)
+    myConsole->tia().enableTimeProfiling(myBenchmarkTime > 0);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void OSystem::finishBenchmark()
+{
+  const double elapsed = std::max(myBenchmarkElapsed, 0.001);
+  const double tiaShare = myConsole->tia().profiledTime() / elapsed;
+
+  Logger::error(std::format(
+    "Benchmark: {}\n"
+    "  real time:  {:.2f} seconds\n"
+    "  cycles:     {} ({:.2f} MHz)\n"
+    "  frames:     {} ({:.1f} fps)\n"
+    "  time split: TIA {:.1f}%, 6507 + cartridge {:.1f}%",
+    myRomFile.getName(), myBenchmarkElapsed,
+    myBenchmarkCycles, static_cast<double>(myBenchmarkCycles) / elapsed / 1e6,
+    myBenchmarkFrames, static_cast<double>(myBenchmarkFrames) / elapsed,
+    tiaShare * 100, (1 - tiaShare) * 100));
+  Logger::error(myFrameTimes.report());
+
+  myConsole->tia().enableTimeProfiling(false);
+  myBenchmarkTime = 0.;
+  quit();
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void OSystem::mainLoop()
 {
   // 6507 time
   time_point<high_resolution_clock> virtualTime = high_resolution_clock::now();
   // The emulation worker
-  EmulationWorker emulationWorker;
+  const ThreadScheduling::Config scheduling = ThreadScheduling::config(*mySettings);
+  ThreadScheduling::setAffinity(scheduling.mainCpu);
+  EmulationWorker emulationWorker(scheduling.priority, scheduling.emulationCpu,
+                                  scheduling.handoff);
+
+  // Late-latching frames is paced to the display if presenting syncs to it
+  const Settings::Handle lateLatch = mySettings->handle("latelatch"),
+                         analogPoll = mySettings->handle("analogpoll"),
+                         vsync = mySettings->handle("vsync"),
+                         turbo = mySettings->handle("turbo"),
+                         idleMode = mySettings->handle("idle");
+  bool pacedToDisplay = false;
+  const auto resetFramePacer = [&]() {
+    pacedToDisplay = vsync.getBool() && !turbo.getBool();
+    myFramePacer.reset(pacedToDisplay ? myFrameBuffer->refreshRate() : 0);
+  };
 
   myFpsMeter.reset(TIAConstants::initialGarbageFrames);
+  myFrameTimes.reset();
+  myQualityGovernor.setStages(mySettings->getString("tv.governor"));
+  resetFramePacer();
+  startBenchmark();
+
+  // Outside of emulation, block for input once nothing changed for a while,
+  // waking up regularly for timers and the pause message
+  constexpr uInt64 IDLE_DELAY = 1000000;  // in us
+  constexpr uInt32 IDLE_TIMEOUT = 250;    // in ms
+  uInt64 lastActivity = TimerManager::getTicks();
+#ifdef PERF_COUNTERS
+  PerfCounters::setDumpFile(mySettings->getString("perf.dump"));
+#endif
 
   for(;;)
   {
     const bool wasEmulation = myEventHandler->state() == EventHandlerState::EMULATION;
 
+    myFramePacer.frameStarted();
     myEventHandler->poll(TimerManager::getTicks());
 
+    // Timers are run from here, instead of a thread of their own
+    myTimerManager->advance();
+    TimerManager::global().advance();
+
+    // Finish a console created in the background, or prepare the next one
+    updateConsoleLoad();
+
+  #ifdef HTTP_LIB_SUPPORT
+    if(myMetricsServer) myMetricsServer->update(*this);
+  #endif
+
     if(myQuitLoop) break;  // Exit if the user wants to quit
 
     if (!wasEmulation && myEventHandler->state() == EventHandlerState::EMULATION) {
       myFpsMeter.reset();
+      myFrameTimes.reset();
+      resetFramePacer();
+      startBenchmark();
       virtualTime = high_resolution_clock::now();
     }
+    else if(pacedToDisplay != (vsync.getBool() && !turbo.getBool()))
+      resetFramePacer();
+
+    const bool lateLatching = lateLatch.getBool() &&
+      myEventHandler->state() == EventHandlerState::EMULATION;
 
     double timesliceSeconds;  // NOLINT
 
     if (myEventHandler->state() == EventHandlerState::EMULATION)
       // Dispatch emulation and render frame (if applicable)
-      timesliceSeconds = dispatchEmulation(emulationWorker);
+      timesliceSeconds = dispatchEmulation(emulationWorker, lateLatching,
+                                           analogPoll.getBool());
     else if(myEventHandler->state() == EventHandlerState::PLAYBACK)
     {
       // Playback at emulation speed
@@ -996,6 +1478,18 @@ void OSystem::mainLoop()
       // Render the GUI with 60 Hz in all other modes
       timesliceSeconds = 1. / 60.;
       myFrameBuffer->update();
+
+      const uInt64 ticks = TimerManager::getTicks();
+      if(myEventHandler->receivedEvents() || myFrameBuffer->isAnimating() ||
+         myConsoleLoad || !myTimerManager->empty() ||
+         !TimerManager::global().empty())
+        lastActivity = ticks;
+      else if(idleMode.getBool() && ticks - lastActivity >= IDLE_DELAY)
+      {
+        myEventHandler->waitEvent(IDLE_TIMEOUT);
+        virtualTime = high_resolution_clock::now();
+        continue;
+      }
     }
 
     const duration<double> timeslice(timesliceSeconds);
@@ -1010,12 +1504,17 @@ void OSystem::mainLoop()
       )
       : 0;
 
+    // When late-latching, the next frame starts just in time for the vblank
+    // it is due for
+    const time_point<high_resolution_clock> nextStart = lateLatching
+      ? myFramePacer.nextStart(virtualTime) : virtualTime;
+
     if (duration_cast<duration<double>>(now - virtualTime).count() > maxLag)
       // If 6507 time is lagging behind more than one frame we reset it to real time
       virtualTime = now;
-    else if (virtualTime > now) {
+    else if (nextStart > now) {
       // Wait until we have caught up with 6507 time
-      std::this_thread::sleep_until(virtualTime);
+      std::this_thread::sleep_until(nextStart);
     }
   }
 
@@ -1023,8 +1522,6 @@ void OSystem::mainLoop()
 #ifdef CHEATCODE_SUPPORT
   if(myConsole)
     myCheatManager->saveCheats(myConsole->properties().get(PropType::Cart_MD5));
-
-  myCheatManager->saveCheatDatabase();
 #endif
 }
 
@@ -19,6 +19,7 @@
 #define OSYSTEM_HXX
 
 class Console;
+struct ConsoleChips;
 class FrameBuffer;
 class EventHandler;
 class Properties;
@@ -30,6 +31,10 @@ class TimerManager;
 class HighScoresManager;
 class EmulationWorker;
 class AudioSettings;
+class Cartridge;
+class MemoryReport;
+class MetricsServer;
+class RomPrefetcher;
 #ifdef CHEATCODE_SUPPORT
   class CheatManager;
 #endif
@@ -43,7 +48,11 @@ class AudioSettings;
   class OptionsMenu;
   class MessageMenu;
   class PlusRomsMenu;
+  class RomIndex;
+  class DirectoryIndex;
   class TimeMachine;
+  class SharedMemoryExport;
+  class VideoRecorder;
   class VideoAudioDialog;
 #endif
 #ifdef IMAGE_SUPPORT
@@ -58,6 +67,9 @@ class AudioSettings;
 #include "FrameBufferConstants.hxx"
 #include "EventHandlerConstants.hxx"
 #include "FpsMeter.hxx"
+#include "FramePacer.hxx"
+#include "FrameTimes.hxx"
+#include "QualityGovernor.hxx"
 #include "Settings.hxx"
 #include "Logger.hxx"
 #include "bspf.hxx"
@@ -145,6 +157,23 @@ class OSystem
     Console& console() const { return *myConsole; }
     bool hasConsole() const;
 
+    /**
+      Collect the memory owned by the subsystems: the console (chips,
+      cartridge, audio fragments), the rewind states, the surfaces and fonts
+      of the framebuffer and the TIA surface.
+
+      @return The report, one entry per subsystem
+    */
+    MemoryReport memoryReport() const;
+
+    /**
+      Get the times of the last displayed frames.
+
+      @return The frame times object
+    */
+    FrameTimes& frameTimes() { return myFrameTimes; }
+    QualityGovernor& qualityGovernor() { return myQualityGovernor; }
+
     /**
       Get the audio settings object of the system.
 
@@ -159,6 +188,20 @@ class OSystem
       @return The highscore manager object
     */
     HighScoresManager& highScores() const { return *myHighScoresManager; }
+
+    /**
+      Get the ROM info index used by the launcher.
+
+      @return The ROM index object
+    */
+    RomIndex& romIndex() const { return *myRomIndex; }
+
+    /**
+      Get the index of the directory trees listed by the launcher.
+
+      @return The directory index object
+    */
+    DirectoryIndex& directoryIndex() const { return *myDirectoryIndex; }
   #endif
 
     /**
@@ -249,6 +292,20 @@ class OSystem
       @return The time machine object
     */
     TimeMachine& timeMachine() const { return *myTimeMachine; }
+
+    /**
+      Get the video recorder of the system.
+
+      @return The video recorder object
+    */
+    VideoRecorder& videoRecorder() const { return *myVideoRecorder; }
+
+    /**
+      Get the shared memory export of the system.
+
+      @return The shared memory export object
+    */
+    SharedMemoryExport& sharedMemoryExport() const { return *mySharedMemoryExport; }
   #endif
 
   #ifdef IMAGE_SUPPORT
@@ -288,13 +345,6 @@ class OSystem
     */
     const FSNode& nvramDir() const { return myNVRamDir; }
 
-  #ifdef CHEATCODE_SUPPORT
-    /**
-      Return the full/complete path name of the cheat file.
-    */
-    const FSNode& cheatFile() const { return myCheatFile; }
-  #endif
-
   #ifdef DEBUGGER_SUPPORT
     /**
       Return the full/complete path name for storing Distella cfg files.
@@ -357,6 +407,22 @@ class OSystem
     */
     static string getROMMD5(const FSNode& rom);
 
+    /**
+      Open the given ROM and return an array containing its contents.
+      This method takes care of using only a valid size for the
+
+      @param romfile  The file node of the ROM to open (contains path)
+      @param size     The amount of data read into the image array
+      @param showErrorMessage  Whether to show (or ignore) any errors
+                               when opening the ROM
+      @param md5      If given, receives the MD5 of the image (computed
+                      while reading, when possible)
+
+      @return  Unique pointer to the array, otherwise nullptr
+    */
+    static ByteBuffer openROM(const FSNode& romfile, size_t& size,
+                              bool showErrorMessage, string* md5 = nullptr);
+
     /**
       Creates a new game console from the specified romfile, and correctly
       initializes the system state to start emulation of the Console.
@@ -380,6 +446,39 @@ class OSystem
     */
     std::optional<string> reloadConsole(bool nextrom = true);
 
+    // Called on the main thread while a console is created in the background,
+    // with the progress in percent; returns true to cancel the creation
+    using LoadProgressCallback = std::function<bool(int percent)>;
+    // Called on the main thread with the result of the creation
+    // (see createConsole())
+    using LoadDoneCallback = std::function<void(const string& result)>;
+
+    /**
+      Creates a new game console like createConsole(), but reads, hashes and
+      detects the ROM and creates the cartridge (which for ELF images
+      includes linking) on worker threads, so that the GUI keeps running
+      meanwhile.  The console itself is then created on the main thread.
+      Nothing is done while another console is being created.
+
+      @param rom       The FSNode of the ROM to use (contains path, etc)
+      @param md5       The MD5sum of the ROM (calculated if empty)
+      @param progress  Called from the main loop with the progress
+      @param done      Called once the console was created, failed or the
+                       creation was cancelled
+    */
+    void createConsoleAsync(const FSNode& rom, string_view md5,
+                            const LoadProgressCallback& progress,
+                            const LoadDoneCallback& done);
+
+    /**
+      Prepare the given ROM in the background (e.g. the next one in attract
+      mode), while the current one keeps running.  Creating a console for
+      it later only takes the prepared cartridge.
+
+      @param rom  The FSNode of the ROM to prepare
+    */
+    void prefetchRom(const FSNode& rom);
+
     /**
       Creates a new ROM launcher, to select a new ROM to emulate.
 
@@ -487,6 +586,12 @@ class OSystem
 
     virtual shared_ptr<CompositeKeyValueRepositoryAtomic> getHighscoreRepository() = 0;
 
+    virtual shared_ptr<KeyValueRepositoryAtomic> getRomIndexRepository() = 0;
+
+    virtual shared_ptr<CompositeKeyValueRepositoryAtomic> getDetectionRepository() = 0;
+
+    virtual shared_ptr<KeyValueRepositoryAtomic> getCheatRepository() = 0;
+
   protected:
 
     //////////////////////////////////////////////////////////////////////
@@ -535,6 +640,9 @@ class OSystem
     // Pointer to the (currently defined) Console object
     unique_ptr<Console> myConsole;
 
+    // The chips of the last closed console, reused by the next one
+    unique_ptr<ConsoleChips> mySpareChips;
+
     // Pointer to audio settings object
     unique_ptr<AudioSettings> myAudioSettings;
 
@@ -569,6 +677,12 @@ class OSystem
 
     // Pointer to the TimeMachine object
     unique_ptr<TimeMachine> myTimeMachine;
+
+    // Pointer to the VideoRecorder object
+    unique_ptr<VideoRecorder> myVideoRecorder;
+
+    // Pointer to the SharedMemoryExport object
+    unique_ptr<SharedMemoryExport> mySharedMemoryExport;
   #endif
 
   #ifdef IMAGE_SUPPORT
@@ -585,9 +699,20 @@ class OSystem
     // Pointer to the TimerManager object
     unique_ptr<TimerManager> myTimerManager;
 
+  #ifdef HTTP_LIB_SUPPORT
+    // Serves the metrics for remote monitoring ('-metrics'), if enabled
+    unique_ptr<MetricsServer> myMetricsServer;
+  #endif
+
   #ifdef GUI_SUPPORT
     // Pointer to the HighScoresManager object
     unique_ptr<HighScoresManager> myHighScoresManager;
+
+    // Pointer to the RomIndex object
+    unique_ptr<RomIndex> myRomIndex;
+
+    // Pointer to the DirectoryIndex object
+    unique_ptr<DirectoryIndex> myDirectoryIndex;
   #endif
 
     // Indicates whether ROM launcher was ever opened during this run
@@ -602,7 +727,7 @@ class OSystem
   private:
     FSNode myBaseDir, myStateDir, mySnapshotSaveDir, mySnapshotLoadDir,
            myNVRamDir, myCfgDir, myHomeDir, myUserDir, myBezelDir;
-    FSNode myCheatFile, myPaletteFile;
+    FSNode myPaletteFile;
     FSNode myRomFile;  string myRomMD5;
 
     string myFeatures;
@@ -611,12 +736,38 @@ class OSystem
     static constexpr uInt32 FPS_METER_QUEUE_SIZE = 100;
     FpsMeter myFpsMeter{FPS_METER_QUEUE_SIZE};
 
+    // Times of the last displayed frames, split by phase
+    FrameTimes myFrameTimes;
+
+    // Schedules the frames when late-latching
+    FramePacer myFramePacer;
+
+    // Reduces the TIA effects when the host is too slow
+    QualityGovernor myQualityGovernor;
+
+    // Rate (in Hz of 6507 time) of sampling the analog controllers during
+    // a late-latched frame, if enabled
+    static constexpr uInt32 ANALOG_POLL_RATE = 1000;
+
+    // Benchmark run time and display interval in seconds (0 = disabled),
+    // and the real time, 6507 cycles and frames emulated so far
+    double myBenchmarkTime{0.}, myBenchmarkInterval{0.};
+    double myBenchmarkElapsed{0.};
+    uInt64 myBenchmarkCycles{0}, myBenchmarkFrames{0};
+
     // If not empty, a hint for derived classes to use this as the
     // base directory (where all settings are stored)
     // Derived classes are free to ignore it and use their own defaults
     static string ourOverrideBaseDir;
     static bool ourOverrideBaseDirWithApp;
 
+    // The console being created and the ROM being prepared in the
+    // background; declared last, so that running workers are waited for
+    // before anything they use is destroyed
+    struct ConsoleLoad;
+    unique_ptr<ConsoleLoad> myConsoleLoad;
+    unique_ptr<RomPrefetcher> myRomPrefetcher;
+
   private:
     /**
       This method should be called to initiate the process of loading settings
@@ -631,28 +782,51 @@ class OSystem
     void createSound();
 
     /**
-      Open the given ROM and return an array containing its contents.
-      This method takes care of using only a valid size for the
+      Creates an actual Console object based on the given info.
 
-      @param romfile  The file node of the ROM to open (contains path)
-      @param size     The amount of data read into the image array
-      @param showErrorMessage  Whether to show (or ignore) any errors
-                               when opening the ROM
+      @param romfile  The file node of the ROM to use (contains path)
+      @param md5      The MD5sum of the ROM
 
-      @return  Unique pointer to the array, otherwise nullptr
+      @return  The actual Console object, otherwise nullptr
     */
-    static ByteBuffer openROM(const FSNode& romfile, size_t& size,
-                              bool showErrorMessage);
+    unique_ptr<Console> openConsole(const FSNode& romfile, string& md5);
 
     /**
-      Creates an actual Console object based on the given info.
+      Creates the Console object for an already created cartridge.
 
       @param romfile  The file node of the ROM to use (contains path)
-      @param md5      The MD5sum of the ROM
+      @param cart     The cartridge created from the ROM
+      @param props    The properties used to create the cartridge
+      @param cartmd5  The MD5sum of the cartridge (may differ from the ROM's
+                      for multicarts)
 
       @return  The actual Console object, otherwise nullptr
     */
-    unique_ptr<Console> openConsole(const FSNode& romfile, string& md5);
+    unique_ptr<Console> openConsole(const FSNode& romfile,
+                                    unique_ptr<Cartridge> cart,
+                                    Properties props, string_view cartmd5);
+
+    /**
+      Get the properties of a ROM, including the cartridge type and start
+      bank entered on the commandline.
+    */
+    Properties cartProperties(string_view md5) const;
+
+    /**
+      Start emulating the console just created.
+
+      @param showmessage  Whether the ROM is being reloaded
+
+      @return  String indicating any error message (EmptyString() for no errors)
+    */
+    string startConsole(bool showmessage);
+
+    /**
+      Continue creating a console in the background, and finish it once the
+      worker is done (see createConsoleAsync()).  Otherwise continue
+      preparing the ROM to prefetch.
+    */
+    void updateConsoleLoad();
 
     /**
       Close and finalize any currently open console.
@@ -667,7 +841,31 @@ class OSystem
     */
     static string getROMInfo(const Console& console);
 
-    double dispatchEmulation(EmulationWorker& emulationWorker);
+    /**
+      Emulate and render the next timeslice.
+
+      @param emulationWorker  The worker emulating while the frame is presented
+      @param lateLatch        If true, emulate on this thread before rendering,
+                              so the frame is presented right away
+      @param analogPoll       If true (and late-latching), sample the analog
+                              controllers during the frame too
+
+      @return  The 6507 time emulated in seconds
+    */
+    double dispatchEmulation(EmulationWorker& emulationWorker, bool lateLatch,
+                             bool analogPoll);
+
+    /**
+      Start a benchmark run if enabled by the 'benchmark' setting.  In
+      benchmark mode, emulation runs as fast as possible; after the given
+      time, the results are reported and the application quits.
+    */
+    void startBenchmark();
+
+    /**
+      Report the benchmark results and quit.
+    */
+    void finishBenchmark();
 
     // Following constructors and assignment operators not supported
     OSystem(const OSystem&) = delete;
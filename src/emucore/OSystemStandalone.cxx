@@ -15,6 +15,7 @@
 // this file, and for a DISCLAIMER OF ALL WARRANTIES.
 //============================================================================
 
+#include "Logger.hxx"
 #include "StellaDb.hxx"
 #include "OSystemStandalone.hxx"
 
@@ -22,7 +23,9 @@
 void OSystemStandalone::initPersistence(FSNode& basedir)
 {
   myStellaDb = std::make_shared<StellaDb>(basedir.getPath(), "stella");
-  myStellaDb->initialize();
+  myStellaDb->initialize([](uInt32 percent) {
+    Logger::info("importing old game properties: " + std::to_string(percent) + "%");
+  });
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -49,6 +52,24 @@ shared_ptr<CompositeKeyValueRepositoryAtomic> OSystemStandalone::getHighscoreRep
   return {myStellaDb, &myStellaDb->highscoreRepository()};
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+shared_ptr<KeyValueRepositoryAtomic> OSystemStandalone::getRomIndexRepository()
+{
+  return {myStellaDb, &myStellaDb->romIndexRepository()};
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+shared_ptr<CompositeKeyValueRepositoryAtomic> OSystemStandalone::getDetectionRepository()
+{
+  return {myStellaDb, &myStellaDb->detectionRepository()};
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+shared_ptr<KeyValueRepositoryAtomic> OSystemStandalone::getCheatRepository()
+{
+  return {myStellaDb, &myStellaDb->cheatRepository()};
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void OSystemStandalone::getBaseDirectories(
     string& basedir, string& homedir, bool useappdir, string_view usedir)
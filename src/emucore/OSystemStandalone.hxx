@@ -34,6 +34,12 @@ class OSystemStandalone : public OSystem
 
     shared_ptr<CompositeKeyValueRepositoryAtomic> getHighscoreRepository() override;
 
+    shared_ptr<KeyValueRepositoryAtomic> getRomIndexRepository() override;
+
+    shared_ptr<CompositeKeyValueRepositoryAtomic> getDetectionRepository() override;
+
+    shared_ptr<KeyValueRepositoryAtomic> getCheatRepository() override;
+
   protected:
 
     void initPersistence(FSNode& basedir) override;
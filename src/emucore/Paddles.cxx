@@ -154,6 +154,15 @@ void Paddles::update()
   updateB();
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Paddles::updateAnalog()
+{
+  // A change consumed here no longer overrides mouse and digital input
+  // in the next update(), just like a change seen in a previous frame
+  updateAnalogAxesA();
+  updateAnalogAxesB();
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void Paddles::updateA()
 {
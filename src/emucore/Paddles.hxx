@@ -71,6 +71,11 @@ class Paddles : public Controller
     */
     void update() override;
 
+    /**
+      Update the paddle positions from analog axis events.
+    */
+    void updateAnalog() override;
+
     /**
       Returns the name of this controller.
     */
@@ -0,0 +1,60 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2026 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#include <cstring>
+
+#include "PageSnapshot.hxx"
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void PageSnapshot::take(std::span<const uInt8> memory, Pages& pages)
+{
+  const size_t count = numPages(memory.size());
+  myLast.resize(count);
+
+  for(size_t i = 0, offset = 0; i < count; ++i, offset += PAGE_SIZE)
+  {
+    const size_t length = std::min(PAGE_SIZE, memory.size() - offset);
+    auto& last = myLast[i];
+
+    // Copy on write: share the page unless it has changed
+    if(!last || std::memcmp(last->data(), memory.data() + offset, length) != 0)
+    {
+      auto page = std::make_shared<Page>();
+      std::memcpy(page->data(), memory.data() + offset, length);
+      last = std::move(page);
+    }
+    pages.push_back(last);
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void PageSnapshot::restore(std::span<uInt8> memory,
+                           const shared_ptr<const Page>* pages)
+{
+  const size_t count = numPages(memory.size());
+  myLast.resize(count);
+
+  for(size_t i = 0, offset = 0; i < count; ++i, offset += PAGE_SIZE)
+  {
+    const size_t length = std::min(PAGE_SIZE, memory.size() - offset);
+    const auto& page = pages[i];
+
+    if(std::memcmp(page->data(), memory.data() + offset, length) != 0)
+      std::memcpy(memory.data() + offset, page->data(), length);
+    myLast[i] = page;
+  }
+}
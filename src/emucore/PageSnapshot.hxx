@@ -0,0 +1,82 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2026 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#ifndef PAGE_SNAPSHOT_HXX
+#define PAGE_SNAPSHOT_HXX
+
+#include <span>
+
+#include "bspf.hxx"
+
+/**
+  Copy-on-write snapshots of a block of memory (e.g. the ARM RAM of a cart),
+  with a granularity of PAGE_SIZE bytes.  A snapshot consists of shared,
+  immutable pages; only the pages which changed since the previous snapshot
+  are copied, all others are shared with it.  So keeping many snapshots
+  (e.g. for rollback) only costs the pages which actually changed.
+
+  Write protecting the memory pages would need OS specific signal handling,
+  and most writes to the memory happen in plain C++ code anyway.  Instead,
+  changed pages are found by comparing them to the previous snapshot, which
+  is much cheaper than copying them.  The previous snapshot is only a cache,
+  so the memory may be changed in any way between snapshots.
+
+  @author  Stella Team
+*/
+class PageSnapshot
+{
+  public:
+    static constexpr size_t PAGE_SIZE = 1_KB;
+
+    using Page = std::array<uInt8, PAGE_SIZE>;
+    using Pages = vector<shared_ptr<const Page>>;
+
+  public:
+    PageSnapshot() = default;
+    ~PageSnapshot() = default;
+
+    /**
+      The number of pages in a snapshot of 'size' bytes.
+    */
+    static constexpr size_t numPages(size_t size) {
+      return (size + PAGE_SIZE - 1) / PAGE_SIZE;
+    }
+
+    /**
+      Take a snapshot of the memory, appending its pages to 'pages'.
+    */
+    void take(std::span<const uInt8> memory, Pages& pages);
+
+    /**
+      Restore the memory from the snapshot starting at 'pages', copying
+      only the pages which differ.
+    */
+    void restore(std::span<uInt8> memory, const shared_ptr<const Page>* pages);
+
+  private:
+    // The pages which the memory contained at the last snapshot
+    Pages myLast;
+
+  private:
+    // Following constructors and assignment operators not supported
+    PageSnapshot(const PageSnapshot&) = delete;
+    PageSnapshot(PageSnapshot&&) = delete;
+    PageSnapshot& operator=(const PageSnapshot&) = delete;
+    PageSnapshot& operator=(PageSnapshot&&) = delete;
+};
+
+#endif
@@ -17,6 +17,8 @@
 
 #include <regex>
 #include <atomic>
+#include <condition_variable>
+#include <mutex>
 #include <thread>
 
 #include "bspf.hxx"
@@ -37,6 +39,9 @@
     constexpr uInt16 WRITE_SEND_BUFFER    = 0x1FF1;
     constexpr uInt16 RECEIVE_BUFFER       = 0x1FF2;
     constexpr uInt16 RECEIVE_BUFFER_SIZE  = 0x1FF3;
+
+    // Requests which may be queued or running at the same time
+    constexpr size_t MAX_PENDING_REQUESTS = 4;
 } // namespace
 #endif
 
@@ -86,7 +91,7 @@ class PlusROMRequest {
     ~PlusROMRequest() = default;
 
   #ifdef HTTP_LIB_SUPPORT
-    void execute() {
+    void execute(httplib::Client& client) {
       myState = State::pending;
 
       std::ostringstream content;
@@ -95,15 +100,10 @@ class PlusROMRequest {
         << "id=" << myId.id << "; "
         << "nick=" << myId.nick;
 
-      httplib::Client client(myDestination.host);
       const httplib::Headers headers = {
         {"PlusROM-Info", content.str()}  // httplib can't accept string_view
       };
 
-      client.set_connection_timeout(milliseconds(CONNECTION_TIMEOUT_MSEC));
-      client.set_read_timeout(milliseconds(READ_TIMEOUT_MSEC));
-      client.set_write_timeout(milliseconds(WRITE_TIMEOUT_MSEC));
-
       auto response = client.Post(
         myDestination.path,
         headers,
@@ -204,6 +204,99 @@ class PlusROMRequest {
     PlusROMRequest& operator=(PlusROMRequest&&) = delete;
 };
 
+/**
+  All requests of a PlusROM are sent by one persistent thread, which keeps
+  the connection to the host alive between requests.
+*/
+class PlusROMWorker {
+  public:
+  #ifdef HTTP_LIB_SUPPORT
+    PlusROMWorker(const string& host, const Cartridge::messageCallback& callback)
+      : myClient{host},
+        myMsgCallback{callback}
+    {
+      myClient.set_keep_alive(true);
+      myClient.set_connection_timeout(milliseconds(CONNECTION_TIMEOUT_MSEC));
+      myClient.set_read_timeout(milliseconds(READ_TIMEOUT_MSEC));
+      myClient.set_write_timeout(milliseconds(WRITE_TIMEOUT_MSEC));
+
+      myThread = std::thread(&PlusROMWorker::run, this);
+    }
+
+    ~PlusROMWorker()
+    {
+      {
+        const std::scoped_lock lock(myMutex);
+        myQuit = true;
+        myQueue.clear();
+      }
+      myQueued.notify_one();
+      // Abort a running request instead of waiting for its timeouts
+      myClient.stop();
+      myThread.join();
+    }
+
+    void enqueue(const shared_ptr<PlusROMRequest>& request)
+    {
+      {
+        const std::scoped_lock lock(myMutex);
+        myQueue.push_back(request);
+      }
+      myQueued.notify_one();
+    }
+
+  private:
+    void run()
+    {
+      for(;;)
+      {
+        shared_ptr<PlusROMRequest> request;
+        {
+          std::unique_lock lock(myMutex);
+          myQueued.wait(lock, [this] { return myQuit || !myQueue.empty(); });
+          if(myQuit)
+            return;
+
+          request = std::move(myQueue.front());
+          myQueue.pop_front();
+        }
+
+        request->execute(myClient);
+        switch(request->getState())
+        {
+          case PlusROMRequest::State::failed:
+            myMsgCallback("PlusROM data sending failed!");
+            break;
+
+          case PlusROMRequest::State::done:
+            myMsgCallback("PlusROM data sent successfully");
+            break;
+
+          default:
+            break;
+        }
+      }
+    }
+
+  private:
+    httplib::Client myClient;
+    const Cartridge::messageCallback& myMsgCallback;
+
+    std::mutex myMutex;
+    std::condition_variable myQueued;
+    std::deque<shared_ptr<PlusROMRequest>> myQueue;
+    bool myQuit{false};
+
+    std::thread myThread;
+  #endif
+
+  private:
+    PlusROMWorker(const PlusROMWorker&) = delete;
+    PlusROMWorker(PlusROMWorker&&) = delete;
+    PlusROMWorker& operator=(const PlusROMWorker&) = delete;
+    PlusROMWorker& operator=(PlusROMWorker&&) = delete;
+};
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 PlusROM::PlusROM(const Settings& settings, const Cartridge& cart)
   : mySettings{settings},
@@ -211,6 +304,9 @@ PlusROM::PlusROM(const Settings& settings, const Cartridge& cart)
 {
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+PlusROM::~PlusROM() = default;
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool PlusROM::initialize(const ByteBuffer& image, size_t size)
 {
@@ -349,7 +445,7 @@ bool PlusROM::save(Serializer& out) const
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool PlusROM::load(Serializer& in)
 {
-  myRequest = std::make_shared<PlusROMRequest>();
+  myRequests.clear();
 
   try
   {
@@ -372,7 +468,7 @@ bool PlusROM::load(Serializer& in)
 void PlusROM::reset()
 {
   myRxReadPos = myRxWritePos = myTxPos = myLastRxReadPos = myLastTxPos = 0;
-  myRequest = std::make_shared<PlusROMRequest>();
+  myRequests.clear();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -402,21 +498,14 @@ bool PlusROM::isValidPath(string_view path)
 void PlusROM::send()
 {
 #ifdef HTTP_LIB_SUPPORT
-  if (myRequest->getState() == PlusROMRequest::State::pending) {
-    myMsgCallback("Ignoring new PlusROM request made while another is pending");
-    return;
-  }
+  // Try to make room by consuming any requests that have completed.
+  receive();
 
-  if (myRequest->getState() == PlusROMRequest::State::created) {
-    myMsgCallback("Ignoring new PlusROM request made while another is ready to be sent");
+  if (myRequests.size() >= MAX_PENDING_REQUESTS) {
+    myMsgCallback("Ignoring new PlusROM request made while too many are pending");
     return;
   }
 
-  if (myRequest->getState() == PlusROMRequest::State::done) {
-    // Try to make room by consuming any requests that have completed.
-    receive();
-  }
-
   string id = mySettings.getString("plusroms.id");
 
   if(id == EmptyString())
@@ -425,40 +514,22 @@ void PlusROM::send()
   if(id != EmptyString())
   {
     const string nick = mySettings.getString("plusroms.nick");
-    myRequest = std::make_shared<PlusROMRequest>(
+    myRequests.push_back(std::make_shared<PlusROMRequest>(
       PlusROMRequest::Destination(myHost, "/" + myPath),
       PlusROMRequest::PlusStoreId(nick, id),
       myTxBuffer.data(),
       myTxPos
-      );
+      ));
 
     myLastTxPos = myTxPos - 1;
     myTxPos = 0;
 
-
-    // The lambda will retain a copy of the shared_ptr that is alive as long
-    // as the thread is running. Thus, the request can only be destructed once
-    // the thread has finished, and we can safely evict it from the class at
-    // any time.
-    std::thread thread([this](const shared_ptr<PlusROMRequest>& request)
-    {
-      request->execute();
-      switch(request->getState())
-      {
-        case PlusROMRequest::State::failed:
-          myMsgCallback("PlusROM data sending failed!");
-          break;
-
-        case PlusROMRequest::State::done:
-          myMsgCallback("PlusROM data sent successfully");
-          break;
-
-        default:
-          break;
-      }
-    }, myRequest);
-
-    thread.detach();
+    // The worker is only created once the ROM really uses the network.
+    // It retains a copy of the request while sending it, so the request can
+    // be evicted from the queue at any time.
+    if(!myWorker)
+      myWorker = std::make_unique<PlusROMWorker>(myHost, myMsgCallback);
+    myWorker->enqueue(myRequests.back());
   }
 #endif
 }
@@ -467,26 +538,32 @@ void PlusROM::send()
 void PlusROM::receive()
 {
 #ifdef HTTP_LIB_SUPPORT
-  switch (myRequest->getState()) {
-    case PlusROMRequest::State::failed:
-      myMsgCallback("PlusROM data receiving failed!");
-      break;
-    case PlusROMRequest::State::done:
-    {
-      myMsgCallback("PlusROM data received successfully");
-      // Request has finished sucessfully? -> consume the response.
-      const auto [responseSize, response] = myRequest->getResponse();
+  // Consume the responses in the order the requests were sent
+  while(!myRequests.empty())
+  {
+    PlusROMRequest& request = *myRequests.front();
+
+    switch (request.getState()) {
+      case PlusROMRequest::State::failed:
+        myMsgCallback("PlusROM data receiving failed!");
+        break;
+      case PlusROMRequest::State::done:
+      {
+        myMsgCallback("PlusROM data received successfully");
+        // Request has finished sucessfully? -> consume the response.
+        const auto [responseSize, response] = request.getResponse();
 
-      myLastRxReadPos = myRxReadPos;
-      for (size_t i = 0; i < responseSize; ++i)
-        myRxBuffer[myRxWritePos++] = response[i];
+        myLastRxReadPos = myRxReadPos;
+        for (size_t i = 0; i < responseSize; ++i)
+          myRxBuffer[myRxWritePos++] = response[i];
 
-      break;
-    }
-    default:
-      break;
+        break;
+      }
+      default:
+        return;  // still queued or being sent
     }
-
+    myRequests.pop_front();
+  }
 #endif
 }
 
@@ -48,12 +48,13 @@
 */
 
 class PlusROMRequest;
+class PlusROMWorker;
 
 class PlusROM : public Serializable
 {
   public:
     PlusROM(const Settings& settings, const Cartridge& cart);
-    ~PlusROM() override = default;
+    ~PlusROM() override;
 
   public:
     /**
@@ -176,7 +177,7 @@ class PlusROM : public Serializable
     void receive();
 
     /**
-      Send pending data to the backend on a thread.
+      Queue pending data for sending to the backend.
     */
     void send();
 
@@ -193,11 +194,16 @@ class PlusROM : public Serializable
     uInt8 myRxReadPos{0}, myRxWritePos{0}, myTxPos{0};
     uInt8 myLastRxReadPos{0}, myLastTxPos{0};
 
-    std::shared_ptr<PlusROMRequest> myRequest;
+    // Requests which are queued, being sent or not yet received
+    std::deque<shared_ptr<PlusROMRequest>> myRequests;
 
     // Callback to output messages
     Cartridge::messageCallback myMsgCallback{nullptr};
 
+    // Sends the requests on a persistent thread and connection
+    // (must be destroyed first, since it uses the callback)
+    unique_ptr<PlusROMWorker> myWorker;
+
   private:
     // Following constructors and assignment operators not supported
     PlusROM(const PlusROM&) = delete;
@@ -15,7 +15,12 @@
 // this file, and for a DISCLAIMER OF ALL WARRANTIES.
 //============================================================================
 
+#include <atomic>
 #include <chrono>
+#include <cmath>
+#include <fstream>
+#include <mutex>
+#include <thread>
 
 #include "ProfilingRunner.hxx"
 #include "FSNode.hxx"
@@ -34,6 +39,8 @@
 #include "Joystick.hxx"
 #include "Random.hxx"
 #include "DispatchResult.hxx"
+#include "Version.hxx"
+#include "json_lib.hxx"
 
 using namespace std::chrono;
 
@@ -50,113 +57,379 @@ namespace {
       from++;
     }
   }
+
+  double framesPerSecond(uInt64 frames, double realtime) {
+    return realtime > 0 ? static_cast<double>(frames) / realtime : 0.;
+  }
+
+  // Nearest-rank percentile of sorted samples
+  double percentile(const vector<double>& sorted, double p) {
+    if (sorted.empty()) return 0.;
+
+    const auto rank = static_cast<size_t>(
+        std::ceil(p * static_cast<double>(sorted.size())));
+    return sorted[std::clamp<size_t>(rank, 1, sorted.size()) - 1];
+  }
 } // namespace
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 ProfilingRunner::ProfilingRunner(int argc, char* argv[])
-  : profilingRuns{std::max<size_t>(argc - 2, 0)}
 {
   for (int i = 2; i < argc; i++) {
-    ProfilingRun& run(profilingRuns[i-2]);
-
     const string arg = argv[i];
-    const size_t splitPoint = arg.find_first_of(':');
 
-    run.romFile = splitPoint == string::npos ? arg : arg.substr(0, splitPoint);
+    if (arg == "-jobs") {
+      if (++i < argc) {
+        const int jobs = BSPF::stoi(argv[i]);
+        myJobs = jobs > 0
+          ? static_cast<uInt32>(jobs)
+          : std::max(std::thread::hardware_concurrency(), 1U);
+      }
+      continue;
+    }
+
+    if (arg == "-manifest") {
+      if (++i < argc) myManifests.emplace_back(argv[i]);
+      continue;
+    }
+
+    if (arg == "-warmup") {
+      if (++i < argc)
+        myWarmupFrames = static_cast<uInt32>(std::max(BSPF::stoi(argv[i]), 0));
+      continue;
+    }
 
-    if (splitPoint == string::npos) run.runtime = RUNTIME_DEFAULT;
-    else  {
-      const int runtime = BSPF::stoi(arg.substr(splitPoint+1, string::npos));
-      run.runtime = runtime > 0 ? runtime : RUNTIME_DEFAULT;
+    if (arg == "-iterations") {
+      if (++i < argc)
+        myIterations = static_cast<uInt32>(std::max(BSPF::stoi(argv[i]), 1));
+      continue;
     }
+
+    if (arg == "-json") {
+      if (++i < argc) myJsonFile = argv[i];
+      continue;
+    }
+
+    addRun(arg);
   }
 
   mySettings.setValue("fastscbios", true);
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void ProfilingRunner::addRun(string_view spec, string_view baseDir)
+{
+  ProfilingRun& run = profilingRuns.emplace_back();
+  const size_t splitPoint = spec.find_first_of(':');
+  const string_view romFile = spec.substr(0, splitPoint);
+
+  // ROMs in manifests are relative to the manifest, unless absolute
+  if (romFile.starts_with(FSNode::PATH_SEPARATOR) || romFile.starts_with('~'))
+    run.romFile = romFile;
+  else
+    run.romFile = string{baseDir} + string{romFile};
+
+  if (splitPoint == string_view::npos) run.runtime = RUNTIME_DEFAULT;
+  else  {
+    const int runtime = BSPF::stoi(spec.substr(splitPoint+1));
+    run.runtime = runtime > 0 ? runtime : RUNTIME_DEFAULT;
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void ProfilingRunner::loadManifest(const string& filename)
+{
+  const FSNode manifest(filename);
+  std::stringstream in;
+
+  try
+  {
+    manifest.read(in);
+  }
+  catch(const std::runtime_error& e)
+  {
+    throw std::runtime_error(std::format("ERROR: unable to read manifest {} ({})",
+                                         filename, e.what()));
+  }
+
+  string baseDir = manifest.getParent().getPath();
+  if (!baseDir.empty() && baseDir.back() != FSNode::PATH_SEPARATOR)
+    baseDir += FSNode::PATH_SEPARATOR;
+
+  // One 'rom[:seconds]' per line, '#' starts a comment line
+  string line;
+  while (std::getline(in, line)) {
+    const string spec = BSPF::trim(line);
+
+    if (!spec.empty() && spec.front() != '#') addRun(spec, baseDir);
+  }
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool ProfilingRunner::run()
+{
+  for (const string& manifest : myManifests)
+    loadManifest(manifest);
+
+  // Each ROM is run 'myIterations' times in a row
+  vector<ProfilingResult> results(profilingRuns.size() * myIterations);
+  for (ProfilingResult& result : results)
+    result.message = "not run";
+
+  const bool ok = myJobs > 0 ? runBatch(results) : runSequential(results);
+
+  if (!myJsonFile.empty()) writeJson(results);
+
+  return ok;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool ProfilingRunner::runSequential(vector<ProfilingResult>& results)
 {
   cout << "Profiling Stella...\n";
 
-  for (const ProfilingRun& run : profilingRuns) {
+  for (size_t i = 0; i < results.size(); ++i) {
+    const ProfilingRun& run = profilingRuns[i / myIterations];
+
     cout << "\nrunning " << run.romFile << " for " << run.runtime
-         << " seconds...\n";
+         << " seconds";
+    if (myIterations > 1)
+      cout << std::format(" ({}/{})", i % myIterations + 1, myIterations);
+    cout << "...\n";
+
+    ProfilingResult& result = results[i];
+    result = runOne(run, mySettings, myProps, myWarmupFrames, true);
+    if (!result.ok) {
+      cout << result.message << '\n';
+      return false;
+    }
 
-    if (!runOne(run)) return false;
+    (cout << "100%" << '\n').flush();
+    cout << "real time: " << result.realtime << " seconds\n";
+    if (!result.frameTimes.empty())
+      cout << std::format("frame time: {:.1f} us median, {:.1f} us p99\n",
+                          percentile(result.frameTimes, 0.5),
+                          percentile(result.frameTimes, 0.99));
   }
 
   return true;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-// FIXME
-// Warning	C6262	Function uses '301164' bytes of stack : exceeds / analyze :
-//                stacksize '16384'.  Consider moving some data to heap.
-bool ProfilingRunner::runOne(const ProfilingRun& run)
+bool ProfilingRunner::runBatch(vector<ProfilingResult>& results)
+{
+  const uInt32 jobs = std::min<uInt32>(myJobs,
+      std::max<uInt32>(static_cast<uInt32>(results.size()), 1));
+
+  cout << std::format("Profiling Stella, {} runs on {} cores...\n",
+                      results.size(), jobs) << std::flush;
+
+  vector<WorkerStats> stats(jobs);
+  std::atomic<size_t> nextRun{0};
+  std::mutex outputMutex;
+
+  const auto worker = [&](uInt32 core) {
+    // Settings are not thread-safe, so each core gets its own copy
+    Settings settings;
+    settings.setValue("fastscbios", true);
+    const Properties props;
+
+    for (size_t i = nextRun++; i < results.size(); i = nextRun++) {
+      const ProfilingRun& run = profilingRuns[i / myIterations];
+      results[i] = runOne(run, settings, props, myWarmupFrames, false);
+
+      WorkerStats& stat = stats[core];
+      ++stat.roms;
+      stat.frames += results[i].frames;
+      stat.realtime += results[i].realtime;
+
+      const std::scoped_lock lock(outputMutex);
+      if (results[i].ok)
+        cout << std::format("[{}] {}: {} frames in {:.2f} seconds ({:.1f} fps)\n",
+                            core, run.romFile, results[i].frames,
+                            results[i].realtime,
+                            framesPerSecond(results[i].frames, results[i].realtime));
+      else
+        cout << std::format("[{}] {}: {}\n", core, run.romFile,
+                            results[i].message);
+      cout.flush();
+    }
+  };
+
+  const time_point<high_resolution_clock> tp = high_resolution_clock::now();
+
+  vector<std::thread> threads;
+  threads.reserve(jobs);
+  for (uInt32 core = 0; core < jobs; ++core)
+    threads.emplace_back(worker, core);
+  for (auto& thread : threads)
+    thread.join();
+
+  const double realtimeUsed = duration_cast<duration<double>>(high_resolution_clock::now () - tp).count();
+
+  cout << "\nper core:\n";
+  uInt64 totalFrames = 0;
+  for (uInt32 core = 0; core < jobs; ++core) {
+    const WorkerStats& stat = stats[core];
+    totalFrames += stat.frames;
+
+    cout << std::format("  core {:>3}: {:>5} ROMs, {:>10} frames, {:10.1f} fps\n",
+                        core, stat.roms, stat.frames,
+                        framesPerSecond(stat.frames, stat.realtime));
+  }
+
+  const auto failed = std::ranges::count_if(results,
+      [](const ProfilingResult& result) { return !result.ok; });
+
+  cout << std::format("\ntotal: {} frames in {:.2f} seconds, {:.1f} fps "
+                      "({:.1f} fps per core), {} failed\n",
+                      totalFrames, realtimeUsed,
+                      framesPerSecond(totalFrames, realtimeUsed),
+                      framesPerSecond(totalFrames, realtimeUsed) / jobs, failed);
+
+  return failed == 0;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void ProfilingRunner::writeJson(const vector<ProfilingResult>& results) const
+{
+  using json = nlohmann::json;
+
+  json roms = json::array();
+
+  for (size_t r = 0; r < profilingRuns.size(); ++r) {
+    const ProfilingRun& run = profilingRuns[r];
+    json iterations = json::array();
+    vector<double> frameTimes;
+    uInt64 frames = 0;
+    double realtime = 0.;
+    string error;
+
+    for (uInt32 it = 0; it < myIterations; ++it) {
+      const ProfilingResult& result = results[r * myIterations + it];
+
+      iterations.push_back({
+        {"ok", result.ok},
+        {"cycles", result.cycles},
+        {"frames", result.frames},
+        {"realtime", result.realtime}
+      });
+
+      if (!result.ok) {
+        if (error.empty()) error = BSPF::trim(result.message);
+        continue;
+      }
+
+      frames += result.frames;
+      realtime += result.realtime;
+      frameTimes.insert(frameTimes.end(), result.frameTimes.begin(),
+                        result.frameTimes.end());
+    }
+    std::ranges::sort(frameTimes);
+
+    json rom = {
+      {"rom", run.romFile},
+      {"runtime", run.runtime},
+      {"ok", error.empty()},
+      {"fps", framesPerSecond(frames, realtime)},
+      {"frametime", {  // in microseconds
+        {"samples", frameTimes.size()},
+        {"median", percentile(frameTimes, 0.5)},
+        {"p99", percentile(frameTimes, 0.99)},
+        {"max", frameTimes.empty() ? 0. : frameTimes.back()}
+      }},
+      {"iterations", iterations}
+    };
+    if (!error.empty()) rom["error"] = error;
+
+    roms.push_back(rom);
+  }
+
+  const json report = {
+    {"version", string{STELLA_VERSION}},
+    {"warmup", myWarmupFrames},
+    {"iterations", myIterations},
+    {"jobs", myJobs},
+    {"roms", roms}
+  };
+
+  std::ofstream out(myJsonFile);
+  if (!out)
+    throw std::runtime_error("ERROR: unable to write " + myJsonFile);
+
+  out << report.dump(2) << '\n';
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+ProfilingRunner::ProfilingResult ProfilingRunner::runOne(
+    const ProfilingRun& run, Settings& settings, const Properties& props,
+    uInt32 warmupFrames, bool verbose)
 {
+  ProfilingResult result;
   const FSNode imageFile(run.romFile);
 
   if (!imageFile.isFile()) {
-    cout << "ERROR: " << run.romFile << " is not a ROM image\n";
-    return false;
+    result.message = "ERROR: " + run.romFile + " is not a ROM image";
+    return result;
   }
 
   ByteBuffer image;
   const size_t size = imageFile.read(image);
   if (size == 0) {
-    cout << "ERROR: unable to read " << run.romFile << '\n';
-    return false;
+    result.message = "ERROR: unable to read " + run.romFile;
+    return result;
   }
 
   string md5 = MD5::hash(image, size);
   const string type;
   unique_ptr<Cartridge> cartridge = CartCreator::create(
-      imageFile, image, size, md5, type, mySettings);
+      imageFile, image, size, md5, type, settings);
 
   if (!cartridge) {
-    cout << "ERROR: unable to determine cartridge type\n";
-    return false;
+    result.message = "ERROR: unable to determine cartridge type";
+    return result;
   }
 
   IO consoleIO;
   Random rng(0);
   const Event event;
 
-  M6502 cpu(mySettings);
-  M6532 riot(consoleIO, mySettings);
+  M6502 cpu(settings);
+  M6532 riot(consoleIO, settings);
 
   const TIA::onPhosphorCallback callback = [] (bool enable) {};
 
-  TIA tia(consoleIO, []() { return ConsoleTiming::ntsc; }, mySettings, callback);
-  System system(rng, cpu, riot, tia, *cartridge);
+  // The TIA is too large to be placed on the (worker thread) stack
+  const auto tia = std::make_unique<TIA>(consoleIO,
+      []() { return ConsoleTiming::ntsc; }, settings, callback);
+  System system(rng, cpu, riot, *tia, *cartridge);
 
   consoleIO.myLeftControl = std::make_unique<Joystick>(Controller::Jack::Left, event, system);
   consoleIO.myRightControl = std::make_unique<Joystick>(Controller::Jack::Right, event, system);
-  consoleIO.mySwitches = std::make_unique<Switches>(event, myProps, mySettings);
+  consoleIO.mySwitches = std::make_unique<Switches>(event, props, settings);
 
-  tia.bindToControllers();
+  tia->bindToControllers();
   cartridge->setStartBankFromPropsFunc([]() { return -1; });
   system.initialize();
 
   FrameLayoutDetector frameLayoutDetector;
-  tia.setFrameManager(&frameLayoutDetector);
+  tia->setFrameManager(&frameLayoutDetector);
   system.reset();
 
-  (cout << "detecting frame layout... ").flush();
-  for(int i = 0; i < 60; ++i) tia.update();
+  if (verbose) (cout << "detecting frame layout... ").flush();
+  for(int i = 0; i < 60; ++i) tia->update();
 
   const FrameLayout frameLayout = frameLayoutDetector.detectedLayout();
   ConsoleTiming consoleTiming = ConsoleTiming::ntsc;
 
   switch (frameLayout) {
     case FrameLayout::ntsc:
-      cout << "NTSC";
+      if (verbose) cout << "NTSC";
       consoleTiming = ConsoleTiming::ntsc;
       break;
 
     case FrameLayout::pal:
-      cout << "PAL";
+      if (verbose) cout << "PAL";
       consoleTiming = ConsoleTiming::pal;
       break;
 
@@ -164,11 +437,11 @@ bool ProfilingRunner::runOne(const ProfilingRun& run)
       break;
   }
 
-  (cout << '\n').flush();
+  if (verbose) (cout << '\n').flush();
 
   FrameManager frameManager;
-  tia.setFrameManager(&frameManager);
-  tia.setLayout(frameLayout);
+  tia->setFrameManager(&frameManager);
+  tia->setLayout(frameLayout);
 
   system.reset();
 
@@ -180,32 +453,46 @@ bool ProfilingRunner::runOne(const ProfilingRun& run)
   dispatchResult.setOk(0);
 
   uInt32 percent = 0;
-  (cout << "0%").flush();
+  if (verbose) (cout << "0%").flush();
+
+  result.frameTimes.reserve(static_cast<size_t>(run.runtime) * 60);
 
   const time_point<high_resolution_clock> tp = high_resolution_clock::now();
+  time_point<high_resolution_clock> frameStart = tp;
 
   while (cycles < cyclesTarget && dispatchResult.getStatus() == DispatchResult::Status::ok) {
-    tia.update(dispatchResult);
+    tia->update(dispatchResult);
     cycles += dispatchResult.getCycles();
 
-    if (tia.newFramePending()) tia.renderToFrameBuffer();
+    if (tia->newFramePending()) {
+      tia->renderToFrameBuffer();
 
-    const uInt32 percentNow = static_cast<uInt32>(std::min((100 * cycles) /
-      cyclesTarget, static_cast<uInt64>(100)));
-    updateProgress(percent, percentNow);
+      const time_point<high_resolution_clock> frameEnd = high_resolution_clock::now();
+      if (++result.frames > warmupFrames)
+        result.frameTimes.push_back(
+          duration<double, std::micro>(frameEnd - frameStart).count());
+      frameStart = frameEnd;
+    }
 
-    percent = percentNow;
+    if (verbose) {
+      const uInt32 percentNow = static_cast<uInt32>(std::min((100 * cycles) /
+        cyclesTarget, static_cast<uInt64>(100)));
+      updateProgress(percent, percentNow);
+
+      percent = percentNow;
+    }
   }
 
-  const double realtimeUsed = duration_cast<duration<double>>(high_resolution_clock::now () - tp).count();
+  result.realtime = duration_cast<duration<double>>(high_resolution_clock::now () - tp).count();
+  result.cycles = cycles;
 
   if (dispatchResult.getStatus() != DispatchResult::Status::ok) {
-    cout << "\nERROR: emulation failed after " << cycles << " cycles";
-    return false;
+    result.message = std::format("\nERROR: emulation failed after {} cycles", cycles);
+    return result;
   }
 
-  (cout << "100%" << '\n').flush();
-  cout << "real time: " << realtimeUsed << " seconds\n";
+  std::ranges::sort(result.frameTimes);
 
-  return true;
+  result.ok = true;
+  return result;
 }
@@ -25,6 +25,22 @@
 #include "ConsoleIO.hxx"
 #include "Props.hxx"
 
+/**
+  Headless runner for profiling the emulation core.  Each ROM is run for the
+  given amount of emulated time without any FrameBuffer or Sound attached.
+
+  The ROMs are either run one after another, showing a progress bar, or, when
+  '-jobs <n>' is specified, spread across a pool of <n> worker threads.  Each
+  worker owns a completely independent Cartridge/System/TIA instance, so
+  the cores never share any emulation state.  In this batch mode only the
+  per-ROM results and the aggregate frames/sec for each core are reported.
+
+  For tracking performance between releases, the ROMs can also be read from
+  manifest files ('-manifest <file>', one 'rom[:seconds]' per line), each ROM
+  can be run several times ('-iterations <n>'), and the results, including
+  the median and 99th percentile of the per-frame emulation time after
+  '-warmup <frames>' frames, can be written as JSON ('-json <file>').
+*/
 class ProfilingRunner {
   public:
 
@@ -39,6 +55,21 @@ class ProfilingRunner {
       uInt32 runtime{0};
     };
 
+    struct ProfilingResult {
+      bool ok{false};
+      string message;
+      uInt64 cycles{0};
+      uInt64 frames{0};
+      double realtime{0.};
+      vector<double> frameTimes;  // sorted, in microseconds, after the warmup
+    };
+
+    struct WorkerStats {
+      uInt32 roms{0};
+      uInt64 frames{0};
+      double realtime{0.};
+    };
+
     struct IO: public ConsoleIO {
       Controller& leftController() const override { return *myLeftControl; }
       Controller& rightController() const override { return *myRightControl; }
@@ -51,11 +82,32 @@ class ProfilingRunner {
 
   private:
 
-    bool runOne(const ProfilingRun& run);
+    void addRun(string_view spec, string_view baseDir = "");
+    void loadManifest(const string& filename);
+
+    bool runSequential(vector<ProfilingResult>& results);
+    bool runBatch(vector<ProfilingResult>& results);
+
+    void writeJson(const vector<ProfilingResult>& results) const;
+
+    static ProfilingResult runOne(const ProfilingRun& run, Settings& settings,
+                                  const Properties& props, uInt32 warmupFrames,
+                                  bool verbose);
 
   private:
 
     vector<ProfilingRun> profilingRuns;
+    vector<string> myManifests;
+
+    // Number of worker threads (0 = run sequentially with progress output)
+    uInt32 myJobs{0};
+
+    // Frames excluded from the frame time statistics, and runs of each ROM
+    uInt32 myWarmupFrames{60};
+    uInt32 myIterations{1};
+
+    // Write the results as JSON to this file (if not empty)
+    string myJsonFile;
 
     Settings mySettings;
 
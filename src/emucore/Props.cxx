@@ -15,14 +15,27 @@
 // this file, and for a DISCLAIMER OF ALL WARRANTIES.
 //============================================================================
 
+#include <mutex>
+#include <unordered_set>
+
 #include "Props.hxx"
 #include "Variant.hxx"
 #include "bspf.hxx"
 
+namespace {
+  // Transparent hashing for heterogeneous lookup
+  struct InternHash {
+    using is_transparent = void;
+    size_t operator()(string_view key) const noexcept {
+      return std::hash<string_view>{}(key);
+    }
+  };
+} // namespace
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 Properties::Properties()
+  : myValues{emptyValues()}
 {
-  setDefaults();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -39,15 +52,17 @@ bool Properties::save(KeyValueRepository& repo) const
 {
   KVRMap props;
 
+  // Do all removals and the save below in one batch
+  const KeyValueRepositoryBatch batch(repo.atomic());
   for(size_t i = 0; i < NUM_PROPS; ++i)
   {
-    if(myProperties[i] == ourDefaultProperties[i])
+    if(!myValues->value[i])
     {
       if(repo.atomic())
         repo.atomic()->remove(ourPropertyNames[i]);
     }
     else
-      props[string{ourPropertyNames[i]}] = myProperties[i];
+      props[string{ourPropertyNames[i]}] = *myValues->value[i];
   }
 
   return repo.save(props);
@@ -60,9 +75,9 @@ void Properties::set(PropType key, string_view value)
   if(pos >= NUM_PROPS)
     return;
 
-  myProperties[pos] = value;
-  if(BSPF::equalsIgnoreCase(myProperties[pos], "AUTO-DETECT"))
-    myProperties[pos] = "AUTO";
+  string newValue{value};
+  if(BSPF::equalsIgnoreCase(newValue, "AUTO-DETECT"))
+    newValue = "AUTO";
 
   switch(key)
   {
@@ -82,20 +97,49 @@ void Properties::set(PropType key, string_view value)
     case PropType::Controller_MouseAxis:
     case PropType::Display_Format:
     case PropType::Display_Phosphor:
-      BSPF::toUpperCase(myProperties[pos]);
+      BSPF::toUpperCase(newValue);
       break;
 
     case PropType::Display_PPBlend:
     {
-      const int blend = BSPF::stoi(myProperties[pos]);
+      const int blend = BSPF::stoi(newValue);
       if(blend < 0 || blend > 100)
-        myProperties[pos] = ourDefaultProperties[pos];
+        newValue = ourDefaultProperties[pos];
       break;
     }
 
     default:
       break;
   }
+
+  if(newValue == get(key))
+    return;
+
+  detach();
+  myValues->own.erase(key);
+  if(newValue == ourDefaultProperties[pos])
+    myValues->value[pos] = nullptr;
+  else if(isInterned(key))
+    myValues->value[pos] = intern(newValue);
+  else
+  {
+    string& own = myValues->own[key] = std::move(newValue);
+    myValues->value[pos] = &own;
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool Properties::operator==(const Properties& properties) const
+{
+  if(myValues == properties.myValues)
+    return true;
+
+  for(size_t i = 0; i < NUM_PROPS; ++i)
+    if(get(PropType{static_cast<uInt8>(i)}) !=
+       properties.get(PropType{static_cast<uInt8>(i)}))
+      return false;
+
+  return true;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -140,14 +184,88 @@ void Properties::print() const
 void Properties::reset(PropType key)
 {
   const auto pos = static_cast<size_t>(key);
-  myProperties[pos] = ourDefaultProperties[pos];
+  if(!myValues->value[pos])
+    return;
+
+  detach();
+  myValues->value[pos] = nullptr;
+  myValues->own.erase(key);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void Properties::setDefaults()
 {
-  for(size_t i = 0; i < NUM_PROPS; ++i)
-    myProperties[i] = ourDefaultProperties[i];
+  myValues = emptyValues();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Properties::detach()
+{
+  if(myValues.use_count() == 1)
+    return;
+
+  myValues = std::make_shared<Values>(*myValues);
+  // The copied pointers still refer to the original's own values
+  for(auto& [key, own]: myValues->own)
+    myValues->value[static_cast<size_t>(key)] = &own;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool Properties::isInterned(PropType key)
+{
+  switch(key)
+  {
+    // These are (mostly) unique for each ROM
+    case PropType::Cart_MD5:
+    case PropType::Cart_ModelNo:
+    case PropType::Cart_Name:
+    case PropType::Cart_Note:
+    case PropType::Cart_Highscore:
+    case PropType::Cart_Url:
+    case PropType::Bezel_Name:
+      return false;
+
+    default:
+      return true;
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+const string* Properties::intern(string_view value)
+{
+  // Properties are also created by worker threads (e.g. state search)
+  static std::mutex mutex;
+  static std::unordered_set<string, InternHash, std::equal_to<>> pool;
+
+  const std::scoped_lock lock(mutex);
+
+  auto it = pool.find(value);
+  if(it == pool.end())
+    it = pool.emplace(value).first;
+
+  // Elements of an unordered_set never move
+  return &*it;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+const shared_ptr<Properties::Values>& Properties::emptyValues()
+{
+  // All objects with only default values share these
+  static const auto values = std::make_shared<Values>();
+  return values;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+const string& Properties::defaultValue(size_t pos)
+{
+  static const auto defaults = [] {
+    std::array<string, NUM_PROPS> values;
+    for(size_t i = 0; i < NUM_PROPS; ++i)
+      values[i] = ourDefaultProperties[i];
+    return values;
+  }();
+
+  return defaults[pos];
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
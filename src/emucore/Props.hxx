@@ -18,6 +18,8 @@
 #ifndef PROPERTIES_HXX
 #define PROPERTIES_HXX
 
+#include <map>
+
 #include "repository/KeyValueRepository.hxx"
 #include "bspf.hxx"
 
@@ -63,6 +65,12 @@ enum class PropType : uInt8 {
   object as its "defaults"; this second properties object is searched
   if the property key is not found in the original property list.
 
+  Only values which differ from the defaults are stored.  Values which
+  repeat across many ROMs (manufacturer, bankswitch and controller types,
+  switches etc.) are interned, so they are stored only once.  The values
+  are shared between copies until one of them is modified, so copying
+  a properties object is cheap.
+
   @author  Bradford W. Mott and Stephen Anthony
 */
 class Properties
@@ -81,9 +89,13 @@ class Properties
     Properties(const Properties&) = default;
     Properties& operator=(const Properties&) = default;
 
-    // Enable move semantics for efficient storage in PropsList maps
-    Properties(Properties&&) = default;
-    Properties& operator=(Properties&&) = default;
+    // Moving only shares the values (as copying does), which keeps the
+    // source valid
+    Properties(Properties&& other) noexcept : myValues{other.myValues} { }
+    Properties& operator=(Properties&& other) noexcept {
+      myValues = other.myValues;
+      return *this;
+    }
 
   public:
     void load(KeyValueRepository& repo);
@@ -99,7 +111,11 @@ class Properties
     */
     const string& get(PropType key) const {
       const auto pos = static_cast<size_t>(key);
-      return pos < NUM_PROPS ? myProperties[pos] : EmptyString();
+      if(pos >= NUM_PROPS)
+        return EmptyString();
+
+      const string* value = myValues->value[pos];
+      return value ? *value : defaultValue(pos);
     }
 
     /**
@@ -133,9 +149,7 @@ class Properties
       @param properties The properties object to compare to
       @return True if the properties are equal, else false
     */
-    bool operator==(const Properties& properties) const {
-      return myProperties == properties.myProperties;
-    }
+    bool operator==(const Properties& properties) const;
     bool operator!=(const Properties& properties) const {
       return !(*this == properties);
     }
@@ -155,9 +169,34 @@ class Properties
     */
     static void printHeader();
 
+    /**
+      Whether the values of the given property repeat across many ROMs,
+      and are therefore interned.
+    */
+    static bool isInterned(PropType key);
+
+    /**
+      Answer the single shared copy of the given value.  Interned strings
+      are never released, so only values with few variants are interned.
+    */
+    static const string* intern(string_view value);
+
+    static const string& defaultValue(size_t pos);
+
+    // Make sure the values are not shared with other objects
+    void detach();
+
   private:
-    // The array of properties for this instance (mutable runtime values)
-    std::array<string, NUM_PROPS> myProperties;
+    struct Values {
+      // Each value, or nullptr for the default.  Interned values point into
+      // the pool, all others into 'own'.
+      std::array<const string*, NUM_PROPS> value{};
+      std::map<PropType, string> own;
+    };
+    static const shared_ptr<Values>& emptyValues();
+
+    // The values of this instance, shared between copies until modified
+    shared_ptr<Values> myValues;
 
     // Default property values — constexpr string_view, no heap allocation
     static constexpr std::array<string_view, NUM_PROPS> ourDefaultProperties = {{
@@ -16,18 +16,86 @@
 //============================================================================
 
 #include <algorithm>
+#include <ctime>
 
 #include "bspf.hxx"
 #include "FSNode.hxx"
+#include "FSNodeFactory.hxx"
 #include "DefProps.hxx"
 #include "Props.hxx"
 #include "PropsSet.hxx"
 #include "repository/CompositeKeyValueRepositoryNoop.hxx"
 #include "repository/KeyValueRepositoryPropertyFile.hxx"
 
+namespace {
+  // Increase this whenever any of the cached detection heuristics changes,
+  // so that results of older versions are ignored
+  constexpr int DETECTION_VERSION = 1;
+
+  string detectionKey(string_view detector)
+  {
+    return std::format("{}:{}", detector, DETECTION_VERSION);
+  }
+
+  using MD5Key = std::array<uInt8, 16>;
+
+  // Convert an md5sum in ASCII hex (in either case) into its binary form;
+  // an invalid md5sum results in false
+  constexpr bool toMD5Key(string_view md5, MD5Key& key)
+  {
+    const auto nibble = [](char c) -> int {
+      if(c >= '0' && c <= '9')  return c - '0';
+      if(c >= 'a' && c <= 'f')  return c - 'a' + 10;
+      if(c >= 'A' && c <= 'F')  return c - 'A' + 10;
+      return -1;
+    };
+
+    if(md5.size() != key.size() * 2)
+      return false;
+
+    for(size_t i = 0; i < key.size(); ++i)
+    {
+      const int hi = nibble(md5[i * 2]), lo = nibble(md5[i * 2 + 1]);
+      if(hi < 0 || lo < 0)
+        return false;
+      key[i] = static_cast<uInt8>((hi << 4) | lo);
+    }
+    return true;
+  }
+
+  // Search the built-in database for the given md5sum, and return the
+  // index of its entry (or DEF_PROPS_SIZE if it doesn't exist)
+  constexpr uInt32 findDefProps(string_view md5)
+  {
+    MD5Key key{};
+    if(!toMD5Key(md5, key))
+      return DEF_PROPS_SIZE;
+
+    const auto it = std::ranges::lower_bound(DefPropsMD5, key);
+    return it != DefPropsMD5.end() && *it == key
+        ? static_cast<uInt32>(it - DefPropsMD5.begin()) : DEF_PROPS_SIZE;
+  }
+
+  // Make sure the tables generated by 'create_props.pl' are consistent
+  static_assert(std::ranges::is_sorted(DefPropsMD5));
+  static_assert(findDefProps(DefProps[0][0]) == 0);
+  static_assert(findDefProps(DefProps[DEF_PROPS_SIZE - 1][0]) == DEF_PROPS_SIZE - 1);
+  static_assert(findDefProps("e68e28752d3c54edd3ccda42c27e320c") <  DEF_PROPS_SIZE);
+  static_assert(findDefProps("not an md5sum") == DEF_PROPS_SIZE);
+
+  // Answer whether the path refers to a directory inside a ZIP file
+  bool isInsideZip(string_view path)
+  {
+    const size_t pos = BSPF::findIgnoreCase(path, ".zip");
+    return pos != string::npos && pos + 4 < path.length() &&
+           path[pos + 4] == FSNode::PATH_SEPARATOR;
+  }
+} // namespace
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 PropertiesSet::PropertiesSet()
-  : myRepository{std::make_shared<CompositeKeyValueRepositoryNoop>()}
+  : myRepository{std::make_shared<CompositeKeyValueRepositoryNoop>()},
+    myDetectionRepository{std::make_shared<CompositeKeyValueRepositoryNoop>()}
 {
 }
 
@@ -37,6 +105,13 @@ void PropertiesSet::setRepository(shared_ptr<CompositeKeyValueRepository> reposi
   myRepository = std::move(repository);
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void PropertiesSet::setDetectionRepository(
+    shared_ptr<CompositeKeyValueRepositoryAtomic> repository)
+{
+  myDetectionRepository = std::move(repository);
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool PropertiesSet::getMD5(string_view md5, Properties& properties,
                            bool useDefaults) const
@@ -76,23 +151,9 @@ bool PropertiesSet::getMD5(string_view md5, Properties& properties,
   // Otherwise, search the internal database using binary search
   if(!found)
   {
-    const auto it = std::ranges::lower_bound( // NOLINT(readability-qualified-auto)
-      DefProps, md5,
-      [](string_view a, string_view b) {
-          return BSPF::compareIgnoreCase(a, b) < 0;
-      },
-      [](const auto& entry) {
-          return entry[static_cast<uInt8>(PropType::Cart_MD5)];
-      });
-
-    if(it != DefProps.end() &&
-       BSPF::compareIgnoreCase((*it)[static_cast<uInt8>(PropType::Cart_MD5)], md5) == 0)
+    if(const DefaultsView defaults = getDefaults(md5); defaults)
     {
-      const auto& entry = *it;
-      for(uInt8 p = 0; p < static_cast<uInt8>(PropType::NumTypes); ++p)
-        if(entry[p][0] != 0)
-          properties.set(PropType{p}, entry[p]);
-
+      defaults.copyTo(properties);
       found = true;
     }
   }
@@ -100,6 +161,57 @@ bool PropertiesSet::getMD5(string_view md5, Properties& properties,
   return found;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool PropertiesSet::getProperty(string_view md5, PropType key,
+                                string& value) const
+{
+  // External and inserted entries are rare, so only these are copied whole
+  if(myRepository->has(md5) || myTempProps.contains(md5))
+  {
+    Properties properties;
+    getMD5(md5, properties);
+    value = properties.get(key);
+    return true;
+  }
+
+  // The built-in entry (or the defaults) can be accessed directly
+  const DefaultsView defaults = getDefaults(md5);
+  value = defaults.get(key);
+
+  return static_cast<bool>(defaults);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+PropertiesSet::DefaultsView PropertiesSet::getDefaults(string_view md5)
+{
+  const uInt32 idx = findDefProps(md5);
+
+  return idx < DEF_PROPS_SIZE ? DefaultsView(DefProps[idx].data())
+                              : DefaultsView();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+string_view PropertiesSet::DefaultsView::get(PropType key) const
+{
+  const auto pos = static_cast<size_t>(key);
+  if(pos >= Properties::NUM_PROPS)
+    return {};
+
+  return myEntry && myEntry[pos][0] != 0
+      ? string_view{myEntry[pos]} : Properties::ourDefaultProperties[pos];
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void PropertiesSet::DefaultsView::copyTo(Properties& properties) const
+{
+  if(!myEntry)
+    return;
+
+  for(uInt8 p = 0; p < static_cast<uInt8>(PropType::NumTypes); ++p)
+    if(myEntry[p][0] != 0)
+      properties.set(PropType{p}, myEntry[p]);
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void PropertiesSet::insert(const Properties& properties, bool save)
 {
@@ -117,6 +229,9 @@ void PropertiesSet::insert(const Properties& properties, bool save)
   if(md5.empty())
     return;
 
+  // Changed properties may lead to different detection results
+  myDetectionRepository->remove(md5);
+
   // Make sure the exact entry isn't already in any list
   Properties defaultProps;
   if(getMD5(md5, defaultProps, false) && defaultProps == properties)
@@ -141,9 +256,10 @@ void PropertiesSet::loadPerROM(const FSNode& rom, string_view md5)
 
   // First, does this ROM have a per-ROM properties entry?
   // If so, load it into the database
-  const FSNode propsNode(rom.getPathWithExt(".pro"));
-  if(propsNode.exists())
+  const string propsPath = rom.getPathWithExt(".pro");
+  if(hasPerROMFile(propsPath))
   {
+    const FSNode propsNode(propsPath);
     KeyValueRepositoryPropertyFile repo(propsNode);
     props.load(repo);
     insert(props, false);
@@ -166,6 +282,73 @@ void PropertiesSet::loadPerROM(const FSNode& rom, string_view md5)
     insert(props, false);
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void PropertiesSet::addPerROMFiles(const string& dir, uInt64 modified,
+                                   uInt64 listed, const FSList& entries)
+{
+  // Only directories of the file system itself are checked in hasPerROMFile(),
+  // and only if they weren't changed in the second they were listed
+  if(modified == 0 || modified >= listed || dir.empty() ||
+     dir.back() != FSNode::PATH_SEPARATOR || isInsideZip(dir))
+  {
+    myPerROMDirectories.erase(dir);
+    return;
+  }
+
+  PerROMDirectory& directory = myPerROMDirectories[dir];
+  directory.modified = modified;
+  directory.listed = directory.checked = listed;
+  directory.files.clear();
+
+  for(const auto& node: entries)
+  {
+    if(string name = node.getName();
+       !node.isDirectory() && BSPF::endsWithIgnoreCase(name, ".pro"))
+      directory.files.insert(BSPF::toLowerCase(name));
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool PropertiesSet::hasPerROMFile(const string& path)
+{
+  const size_t pos = path.find_last_of(FSNode::PATH_SEPARATOR);
+  if(pos != string::npos)
+  {
+    const string_view dir = string_view{path}.substr(0, pos + 1);
+    const auto it = myPerROMDirectories.find(dir);
+
+    if(it != myPerROMDirectories.end())
+    {
+      PerROMDirectory& directory = it->second;
+      const auto now = static_cast<uInt64>(std::time(nullptr));
+
+      // A file added or removed changes the directory's modification time;
+      // as it only has a resolution of seconds, the files can only be
+      // trusted if they were read after the second of the last change
+      bool valid = now < directory.checked + CHECK_INTERVAL;
+      if(!valid)
+      {
+        const uInt64 modified = FSNodeFactory::create(dir,
+            FSNodeFactory::Type::SYSTEM)->getLastModified();
+        valid = modified == directory.modified && modified < directory.listed;
+        directory.checked = now;
+      }
+
+      if(valid)
+      {
+        // Names are compared ignoring case, since the file system may do
+        // so too; the rare hits are confirmed below
+        if(string name = path.substr(pos + 1);
+           !directory.files.contains(BSPF::toLowerCase(name)))
+          return false;
+      }
+      else
+        myPerROMDirectories.erase(it);
+    }
+  }
+  return FSNode(path).exists();
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void PropertiesSet::print() const
 {
@@ -196,3 +379,27 @@ void PropertiesSet::print() const
   for(const auto& [md5, props] : list)
     props.print();
 }
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool PropertiesSet::getDetected(string_view md5, string_view detector,
+                                string& result) const
+{
+  if(md5.empty())
+    return false;
+
+  Variant value;
+  if(!myDetectionRepository->get(md5, detectionKey(detector), value) ||
+     value.toString().empty())
+    return false;
+
+  result = value.toString();
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void PropertiesSet::setDetected(string_view md5, string_view detector,
+                                string_view result)
+{
+  if(!md5.empty())
+    myDetectionRepository->save(md5, detectionKey(detector), result);
+}
@@ -19,11 +19,12 @@
 #define PROPERTIES_SET_HXX
 
 #include <map>
+#include <set>
 
-class FSNode;
 class OSystem;
 
 #include "bspf.hxx"
+#include "FSNode.hxx"
 #include "Props.hxx"
 #include "repository/CompositeKeyValueRepository.hxx"
 
@@ -44,6 +45,50 @@ class PropertiesSet
     ~PropertiesSet() = default;
 
     void setRepository(shared_ptr<CompositeKeyValueRepository> repository);
+    void setDetectionRepository(shared_ptr<CompositeKeyValueRepositoryAtomic> repository);
+
+    // Names of the detectors whose results are cached
+    static constexpr string_view DETECTED_CART_TYPE = "Cart.Type";
+    static constexpr string_view DETECTED_LEFT_CONTROLLER = "Controller.Left";
+    static constexpr string_view DETECTED_RIGHT_CONTROLLER = "Controller.Right";
+    static constexpr string_view DETECTED_DISPLAY_FORMAT = "Display.Format";
+
+    /**
+      A lightweight, read-only view of an entry in the built-in properties
+      database.  It refers to the compiled-in strings directly, so nothing
+      is copied; properties not set in the entry report their default value.
+    */
+    class DefaultsView
+    {
+      public:
+        DefaultsView() = default;
+
+        // Answer whether the view refers to an entry
+        explicit operator bool() const { return myEntry != nullptr; }
+
+        // Get the value assigned to the specified key
+        string_view get(PropType key) const;
+
+        // Copy all properties set in the entry to a properties object
+        void copyTo(Properties& properties) const;
+
+      private:
+        explicit DefaultsView(const char* const* entry) : myEntry{entry} { }
+
+        const char* const* myEntry{nullptr};
+
+        friend class PropertiesSet;
+    };
+
+    /**
+      Get the entry from the built-in properties database with the given MD5,
+      without consulting any external properties or copying any strings.
+
+      @param md5  The md5 of the entry to get (in either case)
+
+      @return  A view of the entry, which is empty if it wasn't found
+    */
+    static DefaultsView getDefaults(string_view md5);
 
     /**
       Get the property from the set with the given MD5.
@@ -59,6 +104,20 @@ class PropertiesSet
     bool getMD5(string_view md5, Properties& properties,
                 bool useDefaults = false) const;
 
+    /**
+      Get a single property from the set with the given MD5, without copying
+      all the others (e.g. the name of each ROM in a list).  Entries are
+      searched in the same order as in getMD5().
+
+      @param md5    The md5 of the property to get
+      @param key    The property to get
+      @param value  The value of the property, or its default value if
+                    the MD5 wasn't found
+
+      @return  True if the set with the specified md5 was found, else false
+    */
+    bool getProperty(string_view md5, PropType key, string& value) const;
+
     /**
       Insert the properties into the set.  If a duplicate is inserted
       the old properties are overwritten with the new ones.
@@ -84,11 +143,70 @@ class PropertiesSet
     */
     void loadPerROM(const FSNode& rom, string_view md5);
 
+    /**
+      Remember which per-ROM properties files a directory contains, as seen
+      by a directory listing (e.g. of the launcher), so that loadPerROM()
+      doesn't have to check for each ROM's file separately.  The knowledge
+      is discarded as soon as the directory's modification time changes.
+
+      @param dir       The path of the directory
+      @param modified  The modification time of the directory when listed
+      @param listed    When the entries were read
+      @param entries   All entries of the directory
+    */
+    void addPerROMFiles(const string& dir, uInt64 modified, uInt64 listed,
+                        const FSList& entries);
+
     /**
       Prints the contents of the PropertiesSet as a flat file.
     */
     void print() const;
 
+    /**
+      Get the cached result of an autodetection heuristic for the ROM with
+      the given MD5.  The results are saved in the detection repository, so
+      ROMs with 'AUTO' properties don't have to be examined again each time
+      they are loaded.  They are discarded whenever the ROM's properties are
+      changed, or the detection heuristics are changed (see DETECTION_VERSION
+      in PropsSet.cxx).
+
+      @param md5       The md5 of the ROM
+      @param detector  The name of the detector, which must also describe
+                       any settings the result depends on
+      @param result    The cached result, if found
+
+      @return  True if a cached result was found, else false
+    */
+    bool getDetected(string_view md5, string_view detector, string& result) const;
+
+    /**
+      Cache the result of an autodetection heuristic for the ROM with the
+      given MD5.
+
+      @param md5       The md5 of the ROM
+      @param detector  The name of the detector (see getDetected())
+      @param result    The detected value
+    */
+    void setDetected(string_view md5, string_view detector, string_view result);
+
+  private:
+    struct PerROMDirectory {
+      uInt64 modified{0};
+      uInt64 listed{0};   // when the entries were read
+      uInt64 checked{0};  // when the modification time was last compared
+      std::set<string, std::less<>> files;  // names of the .pro files
+    };
+
+    // The modification time of a directory is only compared again after
+    // this many seconds
+    static constexpr uInt64 CHECK_INTERVAL = 2;
+
+    /**
+      Answer whether the given per-ROM properties file exists, preferably
+      from the files remembered by addPerROMFiles().
+    */
+    bool hasPerROMFile(const string& path);
+
   private:
     // std::less<> enables heterogeneous lookup with string_view keys,
     // avoiding string construction on every find/contains call
@@ -98,6 +216,10 @@ class PropertiesSet
     PropsList myTempProps;
 
     shared_ptr<CompositeKeyValueRepository> myRepository;
+    shared_ptr<CompositeKeyValueRepositoryAtomic> myDetectionRepository;
+
+    // The per-ROM properties files of the directories listed, by path
+    std::map<string, PerROMDirectory, std::less<>> myPerROMDirectories;
 
   private:
     // Following constructors and assignment operators not supported
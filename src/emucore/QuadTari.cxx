@@ -166,6 +166,13 @@ void QuadTari::update()
   mySecondController->update();
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void QuadTari::updateAnalog()
+{
+  myFirstController->updateAnalog();
+  mySecondController->updateAnalog();
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 string QuadTari::name() const
 {
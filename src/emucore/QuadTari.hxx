@@ -77,6 +77,11 @@ class QuadTari : public Controller
     */
     void update() override;
 
+    /**
+      Update the analog inputs of both controllers.
+    */
+    void updateAnalog() override;
+
     /**
       Returns the name of this controller.
     */
@@ -0,0 +1,407 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2026 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#include <chrono>
+#include <fstream>
+
+#include "RegressionRunner.hxx"
+#include "FSNode.hxx"
+#include "Bankswitch.hxx"
+#include "Cart.hxx"
+#include "CartCreator.hxx"
+#include "MD5.hxx"
+#include "Control.hxx"
+#include "Event.hxx"
+#include "M6502.hxx"
+#include "M6532.hxx"
+#include "TIA.hxx"
+#include "TIAConstants.hxx"
+#include "ConsoleTiming.hxx"
+#include "FrameManager.hxx"
+#include "FrameLayoutDetector.hxx"
+#include "System.hxx"
+#include "Joystick.hxx"
+#include "Random.hxx"
+#include "DispatchResult.hxx"
+#include "Version.hxx"
+#include "json_lib.hxx"
+
+using namespace std::chrono;
+
+namespace {
+  /**
+    The scripted input: RESET is pressed for a few frames once the ROM had
+    time to initialize, and afterwards the joystick changes its direction and
+    fire button every 8 frames, driven by the given (fixed seed) generator.
+    Until then the joystick stays centered: with input from frame 0 on, the
+    ARM code of Turbo Arcade (Demo V1) follows a pointer read from ROM
+    address 0 and runs away, until the Thumbulator aborts the emulation in
+    frame 2 after 500000 instructions.  The baseline emulator fails the
+    same way, the ROM simply doesn't expect input while it initializes.
+  */
+  void applyInput(Event& event, const Random& rng, uInt32 frame)
+  {
+    event.set(Event::ConsoleReset, frame >= 60 && frame < 66);
+
+    if (frame < 66 || frame % 8 != 0) return;
+
+    // centered, N, NE, E, SE, S, SW, W, NW
+    static constexpr std::array<uInt8, 9> DIRECTIONS = {
+      0b0000, 0b0001, 0b1001, 0b1000, 0b1010, 0b0010, 0b0110, 0b0100, 0b0101
+    };
+    const uInt32 value = rng.next();
+    const uInt8 direction = DIRECTIONS[value % DIRECTIONS.size()];
+
+    event.set(Event::LeftJoystickUp, (direction & 0b0001) != 0);
+    event.set(Event::LeftJoystickDown, (direction & 0b0010) != 0);
+    event.set(Event::LeftJoystickLeft, (direction & 0b0100) != 0);
+    event.set(Event::LeftJoystickRight, (direction & 0b1000) != 0);
+    event.set(Event::LeftJoystickFire, (value & 0x100) != 0);
+  }
+} // namespace
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+RegressionRunner::RegressionRunner(int argc, char* argv[])
+{
+  vector<string> manifests;
+
+  for (int i = 2; i < argc; ++i) {
+    const string arg = argv[i];
+
+    if (arg == "-golden") {
+      if (++i < argc) myGoldenDir = argv[i];
+      continue;
+    }
+
+    if (arg == "-record") {
+      myRecord = true;
+      continue;
+    }
+
+    if (arg == "-frames") {
+      if (++i < argc)
+        myFrames = static_cast<uInt32>(std::max(BSPF::stoi(argv[i]), 1));
+      continue;
+    }
+
+    if (arg == "-manifest") {
+      if (++i < argc) manifests.emplace_back(argv[i]);
+      continue;
+    }
+
+    if (arg == "-json") {
+      if (++i < argc) myJsonFile = argv[i];
+      continue;
+    }
+
+    if (FSNode(arg).isDirectory()) addDirectory(arg);
+    else                           addRun(arg);
+  }
+
+  for (const string& manifest : manifests)
+    loadManifest(manifest);
+
+  if (myRuns.empty() && manifests.empty())
+    addDirectory("test/roms");
+
+  // '-frames' applies to all ROMs without an explicit frame count
+  for (RegressionRun& run : myRuns)
+    if (run.frames == 0) run.frames = myFrames;
+
+  if (!myGoldenDir.empty() && myGoldenDir.back() != FSNode::PATH_SEPARATOR)
+    myGoldenDir += FSNode::PATH_SEPARATOR;
+
+  mySettings.setValue("fastscbios", true);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RegressionRunner::addRun(string_view spec, string_view baseDir)
+{
+  RegressionRun& run = myRuns.emplace_back();
+  const size_t splitPoint = spec.find_first_of(':');
+  const string_view romFile = spec.substr(0, splitPoint);
+
+  // ROMs in manifests are relative to the manifest, unless absolute
+  if (romFile.starts_with(FSNode::PATH_SEPARATOR) || romFile.starts_with('~'))
+    run.romFile = romFile;
+  else
+    run.romFile = string{baseDir} + string{romFile};
+
+  if (splitPoint != string_view::npos)
+    run.frames = static_cast<uInt32>(
+        std::max(BSPF::stoi(spec.substr(splitPoint+1)), 0));
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RegressionRunner::addDirectory(const string& dir)
+{
+  // Includes the ROMs in subdirectories
+  FSList files;
+  FSNode(dir).getAllChildren(files, FSNode::ListMode::All,
+      [](const FSNode& node) { return Bankswitch::isValidRomName(node); },
+      false);
+
+  // Keep the order stable, independent of the filesystem
+  std::ranges::sort(files, [](const FSNode& a, const FSNode& b) {
+    return a.getPath() < b.getPath();
+  });
+
+  for (const FSNode& file : files)
+    myRuns.push_back({file.getPath(), 0});
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RegressionRunner::loadManifest(const string& filename)
+{
+  const FSNode manifest(filename);
+  std::stringstream in;
+
+  try
+  {
+    manifest.read(in);
+  }
+  catch(const std::runtime_error& e)
+  {
+    throw std::runtime_error(std::format("ERROR: unable to read manifest {} ({})",
+                                         filename, e.what()));
+  }
+
+  string baseDir = manifest.getParent().getPath();
+  if (!baseDir.empty() && baseDir.back() != FSNode::PATH_SEPARATOR)
+    baseDir += FSNode::PATH_SEPARATOR;
+
+  // One 'rom[:frames]' per line, '#' starts a comment line
+  string line;
+  while (std::getline(in, line)) {
+    const string spec = BSPF::trim(line);
+
+    if (!spec.empty() && spec.front() != '#') addRun(spec, baseDir);
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+string RegressionRunner::goldenFile(const RegressionRun& run) const
+{
+  return myGoldenDir + FSNode(run.romFile).getNameWithExt(".golden");
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool RegressionRunner::run()
+{
+  cout << std::format("{} {} ROMs against {}...\n\n",
+                      myRecord ? "Recording" : "Verifying", myRuns.size(),
+                      myGoldenDir);
+
+  vector<RegressionResult> results;
+  results.reserve(myRuns.size());
+  uInt32 failed = 0;
+
+  for (const RegressionRun& run : myRuns) {
+    (cout << run.romFile << " (" << run.frames << " frames): ").flush();
+
+    const RegressionResult& result = results.emplace_back(runOne(run));
+
+    if (result.ok)
+      cout << std::format("ok, {:.3f} seconds\n", result.realtime);
+    else {
+      cout << result.message << '\n';
+      ++failed;
+    }
+  }
+
+  cout << std::format("\n{} of {} ROMs {}\n", myRuns.size() - failed,
+                      myRuns.size(), myRecord ? "recorded" : "identical");
+
+  if (!myJsonFile.empty()) writeJson(results);
+
+  return failed == 0;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RegressionRunner::writeJson(const vector<RegressionResult>& results) const
+{
+  using json = nlohmann::json;
+
+  json roms = json::array();
+
+  for (size_t r = 0; r < myRuns.size(); ++r) {
+    const RegressionRun& run = myRuns[r];
+    const RegressionResult& result = results[r];
+
+    json rom = {
+      {"rom", run.romFile},
+      {"frames", run.frames},
+      {"ok", result.ok},
+      {"realtime", result.realtime},
+      {"mismatches", result.mismatches}
+    };
+    if (result.mismatches > 0) rom["firstmismatch"] = result.firstMismatch;
+    if (!result.ok) rom["error"] = result.message;
+
+    roms.push_back(rom);
+  }
+
+  const json report = {
+    {"version", string{STELLA_VERSION}},
+    {"record", myRecord},
+    {"roms", roms}
+  };
+
+  std::ofstream out(myJsonFile);
+  if (!out)
+    throw std::runtime_error("ERROR: unable to write " + myJsonFile);
+
+  out << report.dump(2) << '\n';
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+RegressionRunner::RegressionResult RegressionRunner::runOne(
+    const RegressionRun& run)
+{
+  RegressionResult result;
+  const FSNode imageFile(run.romFile);
+
+  ByteBuffer image;
+  const size_t size = imageFile.isFile() ? imageFile.read(image) : 0;
+  if (size == 0) {
+    result.message = "ERROR: unable to read " + run.romFile;
+    return result;
+  }
+
+  // Read the golden file first, a missing one fails without emulating
+  vector<string> golden;
+  const string goldenFileName = goldenFile(run);
+  if (!myRecord) {
+    std::ifstream in(goldenFileName);
+    if (!in) {
+      result.message = "ERROR: no golden file " + goldenFileName;
+      return result;
+    }
+    for (string line; std::getline(in, line); )
+      if (!line.empty() && line.front() != '#') golden.push_back(line);
+  }
+
+  string md5 = MD5::hash(image, size);
+  const string type;
+  unique_ptr<Cartridge> cartridge = CartCreator::create(
+      imageFile, image, size, md5, type, mySettings);
+
+  if (!cartridge) {
+    result.message = "ERROR: unable to determine cartridge type";
+    return result;
+  }
+
+  IO consoleIO;
+  Random rng(0);
+  Event event;
+
+  M6502 cpu(mySettings);
+  M6532 riot(consoleIO, mySettings);
+
+  const TIA::onPhosphorCallback callback = [] (bool enable) {};
+
+  // The TIA is too large to be placed on the stack
+  const auto tia = std::make_unique<TIA>(consoleIO,
+      []() { return ConsoleTiming::ntsc; }, mySettings, callback);
+  System system(rng, cpu, riot, *tia, *cartridge);
+
+  consoleIO.myLeftControl = std::make_unique<Joystick>(Controller::Jack::Left, event, system);
+  consoleIO.myRightControl = std::make_unique<Joystick>(Controller::Jack::Right, event, system);
+  consoleIO.mySwitches = std::make_unique<Switches>(event, myProps, mySettings);
+
+  tia->bindToControllers();
+  cartridge->setStartBankFromPropsFunc([]() { return -1; });
+  system.initialize();
+
+  FrameLayoutDetector frameLayoutDetector;
+  tia->setFrameManager(&frameLayoutDetector);
+  system.reset();
+
+  for(int i = 0; i < 60; ++i) tia->update();
+
+  const FrameLayout frameLayout = frameLayoutDetector.detectedLayout();
+
+  FrameManager frameManager;
+  tia->setFrameManager(&frameManager);
+  tia->setLayout(frameLayout);
+
+  system.reset();
+
+  ByteArray audio;
+  tia->setAudioCapture(&audio);
+
+  const Random inputRng(0x2600);
+  std::ostringstream recorded;
+  recorded << "# " << imageFile.getName() << ", " << run.frames << " frames\n";
+
+  DispatchResult dispatchResult;
+  duration<double> realtime{0};
+
+  for (uInt32 frame = 0; frame < run.frames; ++frame) {
+    applyInput(event, inputRng, frame);
+    consoleIO.myLeftControl->update();
+    consoleIO.myRightControl->update();
+    consoleIO.mySwitches->update();
+
+    const time_point<steady_clock> start = steady_clock::now();
+    do
+      tia->update(dispatchResult);
+    while (!tia->newFramePending() &&
+           dispatchResult.getStatus() == DispatchResult::Status::ok);
+    tia->renderToFrameBuffer();
+    realtime += steady_clock::now() - start;
+
+    if (dispatchResult.getStatus() != DispatchResult::Status::ok) {
+      result.message = std::format("ERROR: emulation failed in frame {}", frame);
+      return result;
+    }
+
+    // Frames which haven't synced yet can have more scanlines than the
+    // frame buffer holds
+    const uInt32 scanlines = std::min(tia->frameBufferScanlinesLastFrame(),
+                                      TIAConstants::frameBufferHeight);
+    const string line = std::format("{} {} {}", frame,
+        MD5::hash(tia->frameBuffer(),
+          static_cast<size_t>(scanlines) * TIAConstants::frameBufferWidth),
+        MD5::hash(audio.data(), audio.size()));
+    audio.clear();
+
+    if (myRecord)
+      recorded << line << '\n';
+    else if (frame >= golden.size() || golden[frame] != line) {
+      if (result.mismatches++ == 0) result.firstMismatch = frame;
+    }
+  }
+  tia->setAudioCapture(nullptr);
+  result.realtime = realtime.count();
+
+  if (myRecord) {
+    std::ofstream out(goldenFileName);
+    if (!(out << recorded.str())) {
+      result.message = "ERROR: unable to write " + goldenFileName;
+      return result;
+    }
+  }
+  else if (result.mismatches > 0) {
+    result.message = std::format("FAILED, {} of {} frames differ, first in frame {}",
+                                 result.mismatches, run.frames, result.firstMismatch);
+    return result;
+  }
+
+  result.ok = true;
+  return result;
+}
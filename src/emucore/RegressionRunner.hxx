@@ -0,0 +1,109 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2026 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#ifndef REGRESSION_RUNNER_HXX
+#define REGRESSION_RUNNER_HXX
+
+#include "bspf.hxx"
+#include "Control.hxx"
+#include "Switches.hxx"
+#include "Settings.hxx"
+#include "ConsoleIO.hxx"
+#include "Props.hxx"
+
+/**
+  Headless runner which verifies that the emulation core still produces
+  bit-identical output ('stella -regress').  Each ROM is run for a number of
+  frames with a fixed input script (RESET is pressed once, then the left
+  joystick moves in a pseudo-random, but reproducible pattern).  The MD5 of
+  the visible part of each frame and of the audio samples generated during
+  the frame are compared to the ROM's golden file in '-golden <dir>'.
+
+  The ROMs are given on the commandline, either directly or as directories
+  which are searched recursively (default 'test/roms'), or in manifest files
+  ('-manifest <file>', one 'rom[:frames]' per line).  With '-record', the
+  golden files are (re)written instead of compared.
+
+  The emulation time of each ROM is reported as well, and the results can be
+  written as JSON ('-json <file>').
+*/
+class RegressionRunner {
+  public:
+
+    RegressionRunner(int argc, char* argv[]);
+
+    bool run();
+
+  private:
+
+    struct RegressionRun {
+      string romFile;
+      uInt32 frames{0};  // 0 = use '-frames'
+    };
+
+    struct RegressionResult {
+      bool ok{false};
+      string message;
+      uInt32 mismatches{0};
+      uInt32 firstMismatch{0};
+      double realtime{0.};   // emulation time only, in seconds
+    };
+
+    struct IO: public ConsoleIO {
+      Controller& leftController() const override { return *myLeftControl; }
+      Controller& rightController() const override { return *myRightControl; }
+      Switches& switches() const override { return *mySwitches; }
+
+      unique_ptr<Controller> myLeftControl;
+      unique_ptr<Controller> myRightControl;
+      unique_ptr<Switches> mySwitches;
+    };
+
+  private:
+
+    void addRun(string_view spec, string_view baseDir = "");
+    void addDirectory(const string& dir);
+    void loadManifest(const string& filename);
+
+    string goldenFile(const RegressionRun& run) const;
+
+    RegressionResult runOne(const RegressionRun& run);
+
+    void writeJson(const vector<RegressionResult>& results) const;
+
+  private:
+
+    vector<RegressionRun> myRuns;
+
+    // Directory containing one '<rom>.golden' file per ROM
+    string myGoldenDir{"test/golden"};
+
+    // Write the golden files instead of comparing against them
+    bool myRecord{false};
+
+    // Frames to run each ROM, unless given in the manifest
+    uInt32 myFrames{600};
+
+    // Write the results as JSON to this file (if not empty)
+    string myJsonFile;
+
+    Settings mySettings;
+
+    Properties myProps;
+};
+
+#endif // REGRESSION_RUNNER_HXX
@@ -0,0 +1,43 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2026 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+
+#include "RomCache.hxx"
+
+std::mutex RomCache::myMutex;
+std::map<string, std::weak_ptr<void>, std::less<>> RomCache::myEntries;
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+shared_ptr<void> RomCache::lookup(const string& key,
+                                  const std::function<shared_ptr<void>()>& create)
+{
+  const std::scoped_lock lock(myMutex);
+
+  if(const auto it = myEntries.find(key); it != myEntries.end())
+  {
+    if(auto data = it->second.lock())
+      return data;
+  }
+
+  // Forget about the entries of ROMs no longer in use
+  std::erase_if(myEntries, [](const auto& entry) { return entry.second.expired(); });
+
+  auto data = create();
+  myEntries[key] = data;
+
+  return data;
+}
@@ -0,0 +1,78 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2026 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+
+#ifndef ROM_CACHE_HXX
+#define ROM_CACHE_HXX
+
+#include <functional>
+#include <map>
+#include <mutex>
+
+#include "bspf.hxx"
+
+/**
+  A process-wide cache for read-only data built from a ROM image (the image
+  itself, decoded ARM code, ...), so that many consoles running the same ROM
+  in one process (batch runs, vectorized environments, servers) share a
+  single copy.  Entries are keyed by the MD5 of the ROM plus a name for the
+  kind of data, and live only as long as some console holds them.
+
+  Shared data must never be modified; users which need to change it (e.g.
+  when patching the ROM in the debugger) have to switch to a private copy.
+
+  @author  Stella Team
+*/
+class RomCache
+{
+  public:
+    /**
+      Get the data stored under the given key, or create it if no live copy
+      exists.  The cache is locked while 'create' runs, so each entry is only
+      created once, even when consoles are started in parallel.
+
+      @param key     The key, usually "<md5>:<name>:<size>"
+      @param create  Creates the data if it is not cached yet
+      @return  The shared data
+    */
+    template<typename T>
+    static shared_ptr<T> get(const string& key,
+                             const std::function<shared_ptr<T>()>& create)
+    {
+      return std::static_pointer_cast<T>(
+        lookup(key, [&create]() -> shared_ptr<void> { return create(); }));
+    }
+
+  private:
+    static shared_ptr<void> lookup(const string& key,
+                                   const std::function<shared_ptr<void>()>& create);
+
+  private:
+    static std::mutex myMutex;
+    static std::map<string, std::weak_ptr<void>, std::less<>> myEntries;
+
+  private:
+    // Following constructors and assignment operators not supported
+    RomCache() = delete;
+    ~RomCache() = delete;
+    RomCache(const RomCache&) = delete;
+    RomCache(RomCache&&) = delete;
+    RomCache& operator=(const RomCache&) = delete;
+    RomCache& operator=(RomCache&&) = delete;
+};
+
+#endif
@@ -0,0 +1,218 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2026 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+
+#include <future>
+
+#include "Bankswitch.hxx"
+#include "Cart.hxx"
+#include "CartCreator.hxx"
+#include "CartDetector.hxx"
+#include "Logger.hxx"
+#include "OSystem.hxx"
+#include "PropsSet.hxx"
+#include "Settings.hxx"
+#include "RomPrefetcher.hxx"
+
+struct RomPrefetcher::Job
+{
+  enum class Step: uInt8 { Queued, Reading, Detecting, Creating, Done };
+
+  Step step{Step::Queued};
+  std::future<void> task;
+
+  Rom rom;
+  Bankswitch::Type type{Bankswitch::Type::AUTO};
+  CartCreator::Context context;
+
+  bool isRunning() const {
+    return task.valid() &&
+      task.wait_for(std::chrono::seconds(0)) != std::future_status::ready;
+  }
+
+  template<typename Work>
+  void start(Step next, Work&& work) {
+    step = next;
+    task = std::async(std::launch::async, std::forward<Work>(work));
+  }
+};
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+RomPrefetcher::RomPrefetcher(Settings& settings, PropertiesSet& propset,
+                             const PropertiesCallback& properties)
+  : mySettings{settings},
+    myPropSet{propset},
+    myProperties{properties}
+{
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+RomPrefetcher::~RomPrefetcher() = default;
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RomPrefetcher::prefetch(const FSNode& rom)
+{
+  if(myJob && myJob->rom.file == rom)
+    return;
+
+  if(myJob && myJob->isRunning())
+    myRetired.push_back(std::move(myJob));
+
+  myJob = std::make_unique<Job>();
+  myJob->rom.file = rom;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RomPrefetcher::update()
+{
+  std::erase_if(myRetired, [](const unique_ptr<Job>& job) {
+    return !job->isRunning();
+  });
+
+  if(!myJob || myJob->step == Job::Step::Done || myJob->isRunning())
+    return;
+
+  try
+  {
+    advance(*myJob);
+  }
+  catch(const std::runtime_error& e)
+  {
+    Logger::debug(std::format("Prefetching '{}' failed: {}",
+                              myJob->rom.file.getShortPath(), e.what()));
+    myJob.reset();
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool RomPrefetcher::isReady(const FSNode& rom) const
+{
+  return myJob && myJob->rom.file == rom && myJob->step == Job::Step::Done;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool RomPrefetcher::take(const FSNode& rom, Rom& result)
+{
+  if(!myJob || !(myJob->rom.file == rom))
+    return false;
+  if(myJob->step == Job::Step::Queued)
+  {
+    // Not started yet, the caller is faster loading it directly
+    myJob.reset();
+    return false;
+  }
+
+  try
+  {
+    while(myJob->step != Job::Step::Done)
+    {
+      myJob->task.wait();
+      advance(*myJob);
+    }
+  }
+  catch(const std::runtime_error&)
+  {
+    // Let the caller load the ROM and report the error
+    myJob.reset();
+    return false;
+  }
+
+  result = std::move(myJob->rom);
+  myJob.reset();
+
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RomPrefetcher::advance(Job& job)
+{
+  using enum Job::Step;
+  Rom& rom = job.rom;
+
+  if(job.task.valid())
+    job.task.get();  // rethrows the errors of the worker
+
+  switch(job.step)
+  {
+    case Queued:
+      // Read (and unzip) the image and hash it
+      job.start(Reading, [&rom] {
+        rom.image = OSystem::openROM(rom.file, rom.size, true, &rom.md5);
+        if(rom.image == nullptr)
+          throw std::runtime_error("Couldn't read ROM file");
+      });
+      return;
+
+    case Reading:
+    {
+      // The properties are only accessed from the main thread
+      myPropSet.loadPerROM(rom.file, rom.md5);
+      rom.props = myProperties(rom.md5);
+      rom.cartmd5 = rom.md5;
+
+      // Find out the type like CartCreator::create() does, but detect it on
+      // the worker
+      job.type = Bankswitch::typeFromExtension(rom.file);
+      if(job.type == Bankswitch::Type::AUTO)
+        job.type = Bankswitch::nameToType(rom.props.get(PropType::Cart_Type));
+      if(string cached; job.type == Bankswitch::Type::AUTO &&
+         myPropSet.getDetected(rom.md5, PropertiesSet::DETECTED_CART_TYPE, cached))
+        job.type = Bankswitch::nameToType(cached);
+      if(job.type == Bankswitch::Type::AUTO)
+      {
+        job.start(Detecting, [&job] {
+          job.type = CartDetector::autodetectType(job.rom.image, job.rom.size);
+        });
+        return;
+      }
+      break;
+    }
+
+    case Detecting:
+      // Cache the type, so that the cartridge is created with it
+      myPropSet.setDetected(rom.md5, PropertiesSet::DETECTED_CART_TYPE,
+                            Bankswitch::typeToName(job.type));
+      break;
+
+    case Creating:
+      CartCreator::finish(job.context, mySettings, &myPropSet);
+      [[fallthrough]];
+
+    case Done:
+      job.step = Done;
+      return;
+  }
+
+  // Multicarts select their game from the settings when the console is
+  // created, and with 'rominfo' the type is always detected again when the
+  // console is created, so these are left for then
+  const bool isMulti = job.type >= Bankswitch::Type::_2IN1 &&
+                       job.type <= Bankswitch::Type::_128IN1;
+  if(isMulti || mySettings.getBool("rominfo"))
+  {
+    job.step = Done;
+    return;
+  }
+
+  // The settings and properties are only accessed from the main thread
+  job.context = CartCreator::prepare(rom.md5, mySettings, &myPropSet);
+  job.start(Creating, [&rom, &context = job.context, this] {
+    rom.cart = CartCreator::create(rom.file, rom.image, rom.size, rom.cartmd5,
+                                   rom.props.get(PropType::Cart_Type),
+                                   mySettings, context);
+  });
+}
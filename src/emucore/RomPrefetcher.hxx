@@ -0,0 +1,122 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2026 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+
+#ifndef ROM_PREFETCHER_HXX
+#define ROM_PREFETCHER_HXX
+
+class Cartridge;
+class PropertiesSet;
+class Settings;
+
+#include <functional>
+
+#include "FSNode.hxx"
+#include "Props.hxx"
+#include "bspf.hxx"
+
+/**
+  Prepares the ROM to be started next in the background, e.g. while the
+  current one is played in attract mode: the image is read (and unzipped)
+  and hashed, its type detected and the cartridge created, which for ELF
+  images includes linking.  Creating the console then only has to take the
+  prepared cartridge.
+
+  Each step runs as a task on a worker thread; between them, the properties
+  are looked up and the detected type is cached on the main thread (see
+  update()).  Multicarts, whose cartridge depends on the game selected when
+  the console is created, only get the image prepared.
+
+  @author  Stella Team
+*/
+class RomPrefetcher
+{
+  public:
+    // The prepared ROM
+    struct Rom {
+      FSNode file;
+      ByteBuffer image;
+      size_t size{0};
+      string md5;
+      Properties props;              // used for creating the cartridge
+      string cartmd5;
+      unique_ptr<Cartridge> cart;    // nullptr if not created ahead
+    };
+
+    // Returns the properties to create the cartridge of the given ROM with
+    using PropertiesCallback = std::function<Properties(string_view md5)>;
+
+    RomPrefetcher(Settings& settings, PropertiesSet& propset,
+                  const PropertiesCallback& properties);
+    ~RomPrefetcher();
+
+    /**
+      Prepare the given ROM, replacing the one prepared before.  The work
+      starts with the next update().
+    */
+    void prefetch(const FSNode& rom);
+
+    /**
+      Start the next step of preparing the ROM when the previous one has
+      finished.  Must be called regularly from the main thread.
+    */
+    void update();
+
+    /**
+      Whether the given ROM has been prepared completely.
+    */
+    bool isReady(const FSNode& rom) const;
+
+    /**
+      Take the prepared ROM, if it is the given one.  Any remaining steps
+      are finished first.
+
+      @param rom     The ROM wanted
+      @param result  Receives the prepared ROM
+
+      @return  True if the ROM was prepared (or could be finished)
+    */
+    bool take(const FSNode& rom, Rom& result);
+
+  private:
+    struct Job;
+
+    /**
+      Continue after the worker of a step has finished.
+    */
+    void advance(Job& job);
+
+  private:
+    Settings& mySettings;
+    PropertiesSet& myPropSet;
+    PropertiesCallback myProperties;
+
+    unique_ptr<Job> myJob;
+
+    // Replaced jobs, kept until their running step has finished
+    std::vector<unique_ptr<Job>> myRetired;
+
+  private:
+    // Following constructors and assignment operators not supported
+    RomPrefetcher() = delete;
+    RomPrefetcher(const RomPrefetcher&) = delete;
+    RomPrefetcher(RomPrefetcher&&) = delete;
+    RomPrefetcher& operator=(const RomPrefetcher&) = delete;
+    RomPrefetcher& operator=(RomPrefetcher&&) = delete;
+};
+
+#endif // ROM_PREFETCHER_HXX
@@ -0,0 +1,112 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2026 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+
+#include "SerialPortAsync.hxx"
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+SerialPortAsync::SerialPortAsync(unique_ptr<SerialPort> port)
+  : myPort{std::move(port)}
+{
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+SerialPortAsync::~SerialPortAsync()
+{
+  if(myRunning)
+  {
+    myRunning = false;
+    myWorkerThread.join();
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool SerialPortAsync::openPort(const string& device)
+{
+  if(myRunning || !myPort->openPort(device))
+    return false;
+
+  myReadyCTS = myPort->isCTS();
+  myCTS = myReadyCTS;
+
+  myRunning = true;
+  myWorkerThread = std::thread(&SerialPortAsync::workerThread, this);
+
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool SerialPortAsync::readByte(uInt8& data)
+{
+  return myRX.pop(data);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool SerialPortAsync::writeByte(uInt8 data)
+{
+  return myRunning && myTX.push(data);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void SerialPortAsync::workerThread()
+{
+  while(myRunning)
+  {
+    // A byte the port doesn't accept (yet) is retried in the next round,
+    // so is one the SpeakJet isn't ready for
+    const size_t head = myTX.head.load(std::memory_order_acquire);
+    size_t tail = myTX.tail.load(std::memory_order_relaxed);
+    while(tail != head && myPort->isCTS() == myReadyCTS &&
+          myPort->writeByte(myTX.data[tail & BUFFER_MASK]))
+      myTX.tail.store(++tail, std::memory_order_release);
+
+    uInt8 data = 0;
+    while(myPort->readByte(data))
+      myRX.push(data);  // dropped if nobody reads
+
+    myCTS.store(myPort->isCTS(), std::memory_order_relaxed);
+
+    // The SpeakJet receives less than 2000 bytes per second
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool SerialPortAsync::Ring::push(uInt8 value)
+{
+  const size_t h = head.load(std::memory_order_relaxed);
+
+  if(h - tail.load(std::memory_order_acquire) == BUFFER_SIZE)
+    return false;
+
+  data[h & BUFFER_MASK] = value;
+  head.store(h + 1, std::memory_order_release);
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool SerialPortAsync::Ring::pop(uInt8& value)
+{
+  const size_t t = tail.load(std::memory_order_relaxed);
+
+  if(t == head.load(std::memory_order_acquire))
+    return false;
+
+  value = data[t & BUFFER_MASK];
+  tail.store(t + 1, std::memory_order_release);
+  return true;
+}
@@ -0,0 +1,129 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2026 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+
+#ifndef SERIALPORT_ASYNC_HXX
+#define SERIALPORT_ASYNC_HXX
+
+#include <atomic>
+#include <thread>
+
+#include "SerialPort.hxx"
+
+/**
+  Wraps a serial port so that it never blocks the caller (the emulation).
+  Written bytes are put into a lock-free single producer/single consumer
+  ring buffer, and a worker thread passes them on to the port.  The worker
+  also polls the port, putting received bytes into a second ring buffer
+  and caching the CTS state, so that reading only accesses memory.
+
+  Like AtariVox, the CTS level at the time the port is opened is taken as
+  'ready' (some adaptors invert it).  Bytes are only passed on while the
+  port is ready, and the emulation sees it as not ready as long as more
+  than a few written bytes are still queued.
+
+  If the port can't keep up and the buffer is full, bytes are dropped
+  instead of blocking.
+
+  @author  Stella Team
+*/
+class SerialPortAsync : public SerialPort
+{
+  public:
+    explicit SerialPortAsync(unique_ptr<SerialPort> port);
+    ~SerialPortAsync() override;
+
+    /**
+      Open the given serial port (synchronously), then start the worker.
+
+      @param device  The name of the port
+      @return  False on any errors, else true
+    */
+    bool openPort(const string& device) override;
+
+    /**
+      Read a byte received by the worker.
+
+      @param data  Destination for the byte read from the port
+      @return  True if a byte was read, else false
+    */
+    bool readByte(uInt8& data) override;
+
+    /**
+      Queue a byte to be written by the worker.
+
+      @param data  The byte to write to the port
+      @return  True if the byte was queued, else false
+    */
+    bool writeByte(uInt8 data) override;
+
+    /**
+      The CTS state, as last polled by the worker, or 'not ready' while the
+      written bytes haven't been passed on yet.
+
+      @return  True if CTS signal enabled, else false
+    */
+    bool isCTS() override {
+      return myTX.size() > MAX_QUEUED
+        ? !myReadyCTS : myCTS.load(std::memory_order_relaxed);
+    }
+
+    StringList portNames() override { return myPort->portNames(); }
+
+  private:
+    // Pass written bytes to the port and poll it until stopped
+    void workerThread();
+
+  private:
+    static constexpr size_t BUFFER_SIZE = 1 << 12;  // must be a power of two
+    static constexpr size_t BUFFER_MASK = BUFFER_SIZE - 1;
+    // The queued bytes the port may still receive after the emulation saw
+    // CTS; the CTS state is at most one worker round (~1 ms) old
+    static constexpr size_t MAX_QUEUED = 2;
+
+    struct Ring {
+      std::array<uInt8, BUFFER_SIZE> data{};
+      std::atomic<size_t> head{0}, tail{0};
+
+      bool push(uInt8 value);
+      bool pop(uInt8& value);
+      size_t size() const {
+        return head.load(std::memory_order_acquire) -
+               tail.load(std::memory_order_acquire);
+      }
+    };
+
+    unique_ptr<SerialPort> myPort;
+
+    // Written by the emulation (TX) and by the worker (RX)
+    Ring myTX, myRX;
+    std::atomic<bool> myCTS{true};
+    bool myReadyCTS{true};
+
+    std::thread myWorkerThread;
+    std::atomic<bool> myRunning{false};
+
+  private:
+    // Following constructors and assignment operators not supported
+    SerialPortAsync() = delete;
+    SerialPortAsync(const SerialPortAsync&) = delete;
+    SerialPortAsync(SerialPortAsync&&) = delete;
+    SerialPortAsync& operator=(const SerialPortAsync&) = delete;
+    SerialPortAsync& operator=(SerialPortAsync&&) = delete;
+};
+
+#endif
@@ -44,12 +44,34 @@ Serializer::Serializer(string_view filename, FileMode fm)
 Serializer::Serializer()
 {
   myMemory.emplace();
-  myMemory->buffer.reserve(4_KB);  // tweak or remove as needed
+  myMemory->arena->reserve(4_KB);  // tweak or remove as needed
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+Serializer::Serializer(Arena& arena)
+{
+  myMemory.emplace(arena);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+Serializer::Serializer(std::span<std::byte> buffer)
+{
+  myMemory.emplace(buffer.data(), buffer.size(), false);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+Serializer::Serializer(std::span<const std::byte> data)
+{
+  // The stream is read-only, so the data is never written to
+  myMemory.emplace(const_cast<std::byte*>(data.data()), data.size(), true);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void Serializer::setPosition(size_t pos)
 {
+  if(pos == 0)
+    myPageIndex = 0;
+
   if(myMemory)
   {
     if(pos > myMemory->size)
@@ -78,6 +100,18 @@ void Serializer::rewind()
   setPosition(0);
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Serializer::reset()
+{
+  myPages.clear();
+  myPageIndex = 0;
+
+  if(myMemory)
+    myMemory->pos = myMemory->size = 0;
+  else
+    rewind();
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 size_t Serializer::size()
 {
@@ -101,72 +135,26 @@ size_t Serializer::size()
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-template<typename T>
-inline T Serializer::readRaw()
+size_t Serializer::memoryUsage() const
 {
-  if constexpr(std::is_same_v<T, double>)
-  {
-    const auto raw = readRaw<uInt64>();
-    return std::bit_cast<double>(raw);
-  }
-  else
-  {
-    T value{};
-
-    if(myMemory)
-    {
-      if(myMemory->pos + sizeof(T) > myMemory->size)
-      {
-        myMemory->ensureSize(myMemory->pos + sizeof(T));
-        myMemory->size = myMemory->pos + sizeof(T);
-      }
-      std::memcpy(&value, myMemory->buffer.data() + myMemory->pos, sizeof(T));
-      myMemory->pos += sizeof(T);
-    }
-    else if(myFile)
-    {
-      myFile->stream.read(reinterpret_cast<char*>(&value), sizeof(T));
-    }
-    else
-      throw std::runtime_error("Serializer not initialized");
-
-    return fromLittle(value);
-  }
+  return (myMemory ? myMemory->ownBuffer.capacity() : 0) +
+    myPages.capacity() * sizeof(PageSnapshot::Pages::value_type);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-template<typename T>
-inline void Serializer::writeRaw(T value)
+size_t Serializer::position()
 {
-  if constexpr(std::is_same_v<T, double>)
+  if(myMemory)
   {
-    writeRaw<uInt64>(std::bit_cast<uInt64>(value));
-    return;
+    return myMemory->pos;
   }
-  else
+  else if(myFile)
   {
-    value = toLittle(value);
-
-    if(myMemory)
-    {
-      myMemory->ensureCapacity(sizeof(T));
-      std::memcpy(myMemory->buffer.data() + myMemory->pos, &value, sizeof(T));
-      myMemory->pos += sizeof(T);
-      myMemory->size = std::max(myMemory->size, myMemory->pos);
-    }
-    else if(myFile)
-    {
-      myFile->writeBuffered(reinterpret_cast<const uInt8*>(&value), sizeof(T));
-    }
-    else
-      throw std::runtime_error("Serializer not initialized");
+    myFile->flushBuffer();
+    return static_cast<size_t>(myFile->stream.tellp());
   }
-}
-
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-uInt8 Serializer::getByte()
-{
-  return readRaw<uInt8>();
+  else
+    return 0;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -179,7 +167,7 @@ void Serializer::getByteArray(std::span<uInt8> array)
       myMemory->ensureSize(myMemory->pos + array.size());
       myMemory->size = myMemory->pos + array.size();
     }
-    std::memcpy(array.data(), myMemory->buffer.data() + myMemory->pos, array.size());
+    std::memcpy(array.data(), myMemory->data + myMemory->pos, array.size());
     myMemory->pos += array.size();
   }
   else if(myFile)
@@ -190,12 +178,6 @@ void Serializer::getByteArray(std::span<uInt8> array)
     throw std::runtime_error("Serializer not initialized");
 }
 
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-uInt16 Serializer::getShort()
-{
-  return readRaw<uInt16>();
-}
-
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void Serializer::getShortArray(std::span<uInt16> array)
 {
@@ -206,12 +188,6 @@ void Serializer::getShortArray(std::span<uInt16> array)
       val = byteswap(val);
 }
 
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-uInt32 Serializer::getInt()
-{
-  return readRaw<uInt32>();
-}
-
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void Serializer::getIntArray(std::span<uInt32> array)
 {
@@ -222,24 +198,6 @@ void Serializer::getIntArray(std::span<uInt32> array)
       val = byteswap(val);
 }
 
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-uInt64 Serializer::getLong()
-{
-  return readRaw<uInt64>();
-}
-
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-double Serializer::getDouble()
-{
-  return readRaw<double>();
-}
-
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool Serializer::getBool()
-{
-  return getByte() == TruePattern;
-}
-
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 string Serializer::getString()
 {
@@ -250,19 +208,13 @@ string Serializer::getString()
   return result;
 }
 
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void Serializer::putByte(uInt8 value)
-{
-  writeRaw<uInt8>(value);
-}
-
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void Serializer::putByteArray(std::span<const uInt8> array)
 {
   if(myMemory)
   {
     myMemory->ensureCapacity(array.size());
-    std::memcpy(myMemory->buffer.data() + myMemory->pos, array.data(), array.size());
+    std::memcpy(myMemory->data + myMemory->pos, array.data(), array.size());
     myMemory->pos += array.size();
     myMemory->size = std::max(myMemory->size, myMemory->pos);
   }
@@ -274,12 +226,6 @@ void Serializer::putByteArray(std::span<const uInt8> array)
     throw std::runtime_error("Serializer not initialized");
 }
 
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void Serializer::putShort(uInt16 value)
-{
-  writeRaw<uInt16>(value);
-}
-
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void Serializer::putShortArray(std::span<const uInt16> array)
 {
@@ -291,12 +237,6 @@ void Serializer::putShortArray(std::span<const uInt16> array)
       writeRaw<uInt16>(val);
 }
 
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void Serializer::putInt(uInt32 value)
-{
-  writeRaw<uInt32>(value);
-}
-
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void Serializer::putIntArray(std::span<const uInt32> array)
 {
@@ -309,27 +249,47 @@ void Serializer::putIntArray(std::span<const uInt32> array)
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void Serializer::putLong(uInt64 value)
+void Serializer::putString(string_view str)
 {
-  writeRaw<uInt64>(value);
+  putInt(static_cast<uInt32>(str.size()));
+  putByteArray(std::span<const uInt8>(
+      reinterpret_cast<const uInt8*>(str.data()), str.size()));
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void Serializer::putDouble(double value)
+void Serializer::enablePages(bool enable)
 {
-  writeRaw<double>(value);
+  myPagesEnabled = enable;
+  myPages.clear();
+  myPageIndex = 0;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void Serializer::putString(string_view str)
+void Serializer::putPages(std::span<const uInt8> memory, PageSnapshot& snapshot)
 {
-  putInt(static_cast<uInt32>(str.size()));
-  putByteArray(std::span<const uInt8>(
-      reinterpret_cast<const uInt8*>(str.data()), str.size()));
+  if(!myPagesEnabled)
+  {
+    putByteArray(memory);
+    return;
+  }
+  // Overwrite the pages following the current position
+  myPages.resize(myPageIndex);
+  snapshot.take(memory, myPages);
+  myPageIndex = myPages.size();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void Serializer::putBool(bool b)
+void Serializer::getPages(std::span<uInt8> memory, PageSnapshot& snapshot)
 {
-  putByte(b ? TruePattern : FalsePattern);
+  if(!myPagesEnabled)
+  {
+    getByteArray(memory);
+    return;
+  }
+  const size_t count = PageSnapshot::numPages(memory.size());
+  if(myPageIndex + count > myPages.size())
+    throw std::out_of_range("Serializer pages missing");
+
+  snapshot.restore(memory, &myPages[myPageIndex]);
+  myPageIndex += count;
 }
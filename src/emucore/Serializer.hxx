@@ -22,8 +22,10 @@
 #include <cstring>
 #include <optional>
 #include <span>
+#include <stdexcept>
 
 #include "FSNode.hxx"
+#include "PageSnapshot.hxx"
 #include "bspf.hxx"
 
 /**
@@ -46,6 +48,10 @@ class Serializer
     // Serializer is essentially always read and write
     enum class FileMode: uInt8 { ReadOnly, ReadWrite, ReadWriteTrunc };
 
+    // Caller-owned storage for a memory-based Serializer; it only grows,
+    // so reusing it for later states avoids any further allocations
+    using Arena = vector<std::byte>;
+
   public:
     /**
       Creates a new Serializer device for streaming binary data.
@@ -56,11 +62,23 @@ class Serializer
 
       Otherwise if (c'tor 2), the stream will be in memory.
 
+      If an arena is provided (c'tor 3), the stream will be in memory too,
+      but stored in the given arena, which must outlive the Serializer.
+      The stream starts out empty, independent of the arena contents.
+
+      If a span is provided, the stream is stored directly in the caller's
+      memory, which must outlive the Serializer and never grows; accessing
+      data past its end throws.  A writable span (c'tor 4) starts out
+      empty, a const span (c'tor 5) contains its data and is read-only.
+
       The valid() method must immediately be called to verify the stream
       was correctly initialized.
     */
     explicit Serializer(string_view filename, FileMode fm = FileMode::ReadWrite);
     Serializer();
+    explicit Serializer(Arena& arena);
+    explicit Serializer(std::span<std::byte> buffer);
+    explicit Serializer(std::span<const std::byte> data);
 
     ~Serializer() = default;
 
@@ -81,11 +99,28 @@ class Serializer
     */
     void rewind();
 
+    /**
+      Empties a memory-based stream, keeping its storage for reuse.
+      For file-based streams, this is the same as rewind().
+    */
+    void reset();
+
     /**
       Returns the current total size of the stream.
     */
     size_t size();
 
+    /**
+      Returns the number of bytes of memory owned by the stream, i.e. the
+      storage of a memory-based stream which is not provided by the caller.
+    */
+    size_t memoryUsage() const;
+
+    /**
+      Returns the current read/write location in the stream.
+    */
+    size_t position();
+
     /**
       Reads a byte value (unsigned 8-bit) from the current input stream.
 
@@ -226,6 +261,33 @@ class Serializer
     */
     void putBool(bool b);
 
+    /**
+      Lets putPages()/getPages() store memory blocks as copy-on-write
+      snapshot pages (see PageSnapshot), which are kept by the Serializer
+      instead of being written to the stream.  Such a stream can only be
+      read back by the same Serializer, so this is meant for in-memory
+      states which are kept for a short time, e.g. for rollback.
+    */
+    void enablePages(bool enable);
+    bool pagesEnabled() const { return myPagesEnabled; }
+
+    /**
+      Writes a block of memory, either as a byte array or as snapshot pages
+      (if enabled), which share the unchanged pages with the last snapshot.
+
+      @param memory    The memory to write
+      @param snapshot  The snapshot state of this memory block
+    */
+    void putPages(std::span<const uInt8> memory, PageSnapshot& snapshot);
+
+    /**
+      Reads a block of memory written by putPages().
+
+      @param memory    The memory to read into
+      @param snapshot  The snapshot state of this memory block
+    */
+    void getPages(std::span<uInt8> memory, PageSnapshot& snapshot);
+
   private:
     // Raw Read/Write
     template<typename T> T readRaw();
@@ -259,22 +321,42 @@ class Serializer
   private:
     // Memory backend
     struct MemoryStream {
-      vector<std::byte> buffer;
+      Arena ownBuffer;
+      // Either ownBuffer, a caller-owned arena or nullptr for a fixed span
+      Arena* arena{&ownBuffer};
+      std::byte* data{nullptr};
+      size_t capacity{0};
+      bool readOnly{false};
       size_t pos{0};
       size_t size{0};
 
-      MemoryStream() { }  // NOLINT: can't use = default here
-                          // possible clang bug; fails to compile with default
+      MemoryStream() = default;
+      explicit MemoryStream(Arena& a)
+        : arena{&a}, data{a.data()}, capacity{a.size()} { }
+      MemoryStream(std::byte* d, size_t c, bool ro)
+        : arena{nullptr}, data{d}, capacity{c}, readOnly{ro}, size{ro ? c : 0} { }
 
       void ensureCapacity(size_t additional) {
+        if(readOnly)
+          throw std::runtime_error("Serializer is read-only");
         ensureSize(pos + additional);
       }
       void ensureSize(size_t absolute) {
-        if(absolute > buffer.size()) {
-          const size_t newSize = std::max(buffer.size() * 2, absolute);
-          buffer.resize(newSize);
+        if(absolute > capacity) {
+          if(arena == nullptr)
+            throw std::out_of_range("Serializer buffer too small");
+
+          const size_t newSize = std::max(capacity * 2, absolute);
+          arena->resize(newSize);
+          data = arena->data();
+          capacity = newSize;
         }
       }
+
+      MemoryStream(const MemoryStream&) = delete;
+      MemoryStream(MemoryStream&&) = delete;
+      MemoryStream& operator=(const MemoryStream&) = delete;
+      MemoryStream& operator=(MemoryStream&&) = delete;
     };
     std::optional<MemoryStream> myMemory;
 
@@ -326,6 +408,11 @@ class Serializer
     };
     std::optional<FileStream> myFile;
 
+    // Pages of the memory blocks written by putPages() (if enabled)
+    bool myPagesEnabled{false};
+    PageSnapshot::Pages myPages;
+    size_t myPageIndex{0};
+
     // Using these values for legacy reasons
     static constexpr uInt8 TruePattern = 0xfe, FalsePattern = 0x01;
 
@@ -337,4 +424,143 @@ class Serializer
     Serializer& operator=(Serializer&&) = delete;
 };
 
+// ############################################################################
+// Implementation
+// ############################################################################
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+template<typename T>
+inline T Serializer::readRaw()
+{
+  if constexpr(std::is_same_v<T, double>)
+  {
+    const auto raw = readRaw<uInt64>();
+    return std::bit_cast<double>(raw);
+  }
+  else
+  {
+    T value{};
+
+    if(myMemory)
+    {
+      if(myMemory->pos + sizeof(T) > myMemory->size)
+      {
+        myMemory->ensureSize(myMemory->pos + sizeof(T));
+        myMemory->size = myMemory->pos + sizeof(T);
+      }
+      std::memcpy(&value, myMemory->data + myMemory->pos, sizeof(T));
+      myMemory->pos += sizeof(T);
+    }
+    else if(myFile)
+    {
+      myFile->stream.read(reinterpret_cast<char*>(&value), sizeof(T));
+    }
+    else
+      throw std::runtime_error("Serializer not initialized");
+
+    return fromLittle(value);
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+template<typename T>
+inline void Serializer::writeRaw(T value)
+{
+  if constexpr(std::is_same_v<T, double>)
+  {
+    writeRaw<uInt64>(std::bit_cast<uInt64>(value));
+    return;
+  }
+  else
+  {
+    value = toLittle(value);
+
+    if(myMemory)
+    {
+      myMemory->ensureCapacity(sizeof(T));
+      std::memcpy(myMemory->data + myMemory->pos, &value, sizeof(T));
+      myMemory->pos += sizeof(T);
+      myMemory->size = std::max(myMemory->size, myMemory->pos);
+    }
+    else if(myFile)
+    {
+      myFile->writeBuffered(reinterpret_cast<const uInt8*>(&value), sizeof(T));
+    }
+    else
+      throw std::runtime_error("Serializer not initialized");
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+inline uInt8 Serializer::getByte()
+{
+  return readRaw<uInt8>();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+inline uInt16 Serializer::getShort()
+{
+  return readRaw<uInt16>();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+inline uInt32 Serializer::getInt()
+{
+  return readRaw<uInt32>();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+inline uInt64 Serializer::getLong()
+{
+  return readRaw<uInt64>();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+inline double Serializer::getDouble()
+{
+  return readRaw<double>();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+inline bool Serializer::getBool()
+{
+  return getByte() == TruePattern;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+inline void Serializer::putByte(uInt8 value)
+{
+  writeRaw<uInt8>(value);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+inline void Serializer::putShort(uInt16 value)
+{
+  writeRaw<uInt16>(value);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+inline void Serializer::putInt(uInt32 value)
+{
+  writeRaw<uInt32>(value);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+inline void Serializer::putLong(uInt64 value)
+{
+  writeRaw<uInt64>(value);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+inline void Serializer::putDouble(double value)
+{
+  writeRaw<double>(value);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+inline void Serializer::putBool(bool b)
+{
+  putByte(b ? TruePattern : FalsePattern);
+}
+
 #endif
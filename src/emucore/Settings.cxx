@@ -25,6 +25,7 @@
 #include "Joystick.hxx"
 #include "Paddles.hxx"
 #include "CartELF.hxx"
+#include "StateManager.hxx"
 #ifdef GUI_SUPPORT
   #include "JitterEmulation.hxx"
 #endif
@@ -57,7 +58,10 @@ Settings::Settings()
   // Video-related options
   setPermanent("video", "");
   setPermanent("speed", "1.0");
+  setPermanent("runahead", "0");
   setPermanent("vsync", "true");
+  setPermanent("latelatch", "false");
+  setPermanent("analogpoll", "false");
   setPermanent("center", "true");
   setPermanent("windowedpos", Common::Point(50, 50));
   setPermanent("display", 0);
@@ -102,6 +106,7 @@ Settings::Settings()
   setPermanent(PhosphorHandler::SETTING_BLEND, PhosphorHandler::DEFAULT_BLEND);
   setPermanent("tv.scanlines", "0");
   setPermanent("tv.scanmask", TIASurface::SETTING_STANDARD);
+  setPermanent("tv.governor", "");
   // TV options when using 'custom' mode
   setPermanent("tv.sharpness", "0.0");
   setPermanent("tv.resolution", "0.0");
@@ -159,6 +164,7 @@ Settings::Settings()
   setPermanent("sssingle", "false");
   setPermanent("ss1x", "false");
   setPermanent("ssinterval", "2");
+  setPermanent("recpipe", "");
   setPermanent("autoslot", "false");
   setPermanent("saveonexit", "none");
 
@@ -214,13 +220,31 @@ Settings::Settings()
   // Misc options
   setPermanent("loglevel", static_cast<int>(Logger::Level::INFO));
   setPermanent("logtoconsole", "0");
+  setPermanent("lograte", "0,100,100");
   setPermanent("avoxport", "");
   setPermanent("fastscbios", "true");
   setPermanent("threads", "false");
+  setPermanent("threads.priority", "normal");
+  setPermanent("threads.cpu.main", -1);
+  setPermanent("threads.cpu.emulation", -1);
+  setPermanent("threads.cpu.render", "");
+  setPermanent("threads.handoff", "park");
+  setPermanent("idle", "true");
   setTemporary("romloadcount", "0");
   setTemporary("maxres", "");
   setPermanent("initials", "");
   setTemporary("turbo", "0");
+  setTemporary("benchmark", "0");
+  setTemporary("recordmovie", "");
+  setTemporary("playmovie", "");
+  setTemporary("nethost", "0");
+  setTemporary("netjoin", "");
+  setTemporary("shmexport", "");
+  setTemporary("shmformat", "indices");
+  setPermanent("metrics", "0");
+  setPermanent("metrics.bind", "127.0.0.1");
+  setPermanent("benchmark.interval", "20");
+  setPermanent("perf.dump", "");
   setPermanent("plusroms.nick", "");
   setTemporary("plusroms.id", "");
   setPermanent("plusroms.fixedid", "");
@@ -268,6 +292,9 @@ Settings::Settings()
   setPermanent("plr.tm.uncompressed", 60);
   setPermanent("plr.tm.interval", "30f"); // = 0.5 seconds
   setPermanent("plr.tm.horizon", "10m"); // = ~10 minutes
+  setPermanent("plr.tm.delta", "true");
+  setPermanent("plr.tm.budget", 0);
+  setPermanent("plr.tm.budgetmem", 0);
   setPermanent("plr.detectedinfo", "false");
   setPermanent("plr.extaccess", "false");
 
@@ -310,6 +337,9 @@ Settings::Settings()
   setPermanent("dev.tm.uncompressed", 600);
   setPermanent("dev.tm.interval", "1f"); // = 1 frame
   setPermanent("dev.tm.horizon", "30s"); // = ~30 seconds
+  setPermanent("dev.tm.delta", "true");
+  setPermanent("dev.tm.budget", 0);
+  setPermanent("dev.tm.budgetmem", 0);
   setPermanent("dev.detectedinfo", "true");
   setPermanent("dev.extaccess", "true");
   setPermanent("dev.plusroms.on", "true");
@@ -319,6 +349,7 @@ Settings::Settings()
 #ifdef DEBUGGER_SUPPORT
   setPermanent("dev.thumb.inccycles", "true");
   setPermanent("dev.thumb.cyclefactor", "1.05");
+  setPermanent("dev.thumb.approxcycles", "false");
   setPermanent("dev.thumb.chiptype", "0"); // = LPC2103
   setPermanent("dev.thumb.mammode", "2");
 #endif
@@ -342,6 +373,13 @@ void Settings::load(const Options& options)
   for(const auto& [key, value]: fromFile)
     setValue(key, value, false);
 
+  // Only settings missing from the file (e.g. new ones) and those changed
+  // from now on have to be written on the next save
+  myDirtySettings.clear();
+  for(const auto& [key, value]: myPermanentSettings)
+    if(!fromFile.contains(key))
+      myDirtySettings.emplace(key);
+
   // Apply command-line overrides (still non-persistent)
   for(const auto& [key, value]: options)
     setValue(key, value, false);
@@ -354,11 +392,29 @@ void Settings::load(const Options& options)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void Settings::save()
 {
-  // Convert unordered_map → map only at the boundary
-  // TODO: maybe KVRMap can be converted to unordered_map too?
-  KVRMap out;
-  out.insert(myPermanentSettings.begin(), myPermanentSettings.end());
-  myRepository->save(out);
+  if(myDirtySettings.empty())
+    return;
+
+  if(auto* atomic = myRepository->atomic(); atomic)
+  {
+    // Only write the changed settings, all in one transaction
+    const KeyValueRepositoryBatch batch(atomic);
+
+    for(const auto& key: myDirtySettings)
+      if(const auto it = myPermanentSettings.find(key);
+         it != myPermanentSettings.end())
+        atomic->save(key, it->second);
+  }
+  else
+  {
+    // Files can only be rewritten as a whole
+    // Convert unordered_map → map only at the boundary
+    // TODO: maybe KVRMap can be converted to unordered_map too?
+    KVRMap out;
+    out.insert(myPermanentSettings.begin(), myPermanentSettings.end());
+    myRepository->save(out);
+  }
+  myDirtySettings.clear();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -380,6 +436,9 @@ void Settings::validate()
   if (getFloat("speed") <= 0) setValue("speed", "1.0");
 
   clampSetting("tia.vsizeadjust", -5, 5, 0);
+  clampSetting("runahead", 0, static_cast<int>(StateManager::MAX_RUNAHEAD_FRAMES), 0);
+  if (getFloat("benchmark") < 0) setValue("benchmark", "0");
+  clampSetting("benchmark.interval", 1, 1000, 20);
 
   string s{getString("tia.dbgcolors")};
   std::ranges::sort(s);
@@ -413,6 +472,10 @@ void Settings::validate()
   clampSetting("dev.tm.uncompressed", 0, getInt("dev.tm.size"), getInt("dev.tm.size"));
   clampSetting("plr.tm.size", 20, 1000, 20);
   clampSetting("plr.tm.uncompressed", 0, getInt("plr.tm.size"), getInt("plr.tm.size"));
+  clampSetting("dev.tm.budget", 0, 100, 0);
+  clampSetting("plr.tm.budget", 0, 100, 0);
+  clampSetting("dev.tm.budgetmem", 0, 4096, 0);
+  clampSetting("plr.tm.budgetmem", 0, 4096, 0);
 
 #ifdef SOUND_SUPPORT
   AudioSettings::normalize(*this);
@@ -460,6 +523,8 @@ void Settings::usage()
     << "                 opengles        OpenGLES 1 acceleration\n"
     << "                 software        Software mode (no acceleration)\n\n"
     << "  -vsync        <1|0>          Enable 'synchronize to vertical blank interrupt'\n"
+    << "  -latelatch    <1|0>          Emulate each frame just before it is displayed\n"
+    << "  -analogpoll   <1|0>          Sample analog axes at 1 kHz when late-latching\n"
     << "  -fullscreen   <1|0>          Enable fullscreen mode\n"
     << "  -center       <1|0>          Centers game window in windowed modes\n"
     << "  -windowedpos  <XxY>          Sets the window position in windowed emulator mode\n"
@@ -484,6 +549,10 @@ void Settings::usage()
     << "  -detectntsc50    <1|0>         Enable NTSC-50 autodetection\n\n"
     << "  -speed           <number>      Run emulation at the given speed\n"
     << "  -turbo           <1|0>         Enable 'Turbo' mode for maximum emulation speed\n"
+    << "  -runahead        <0-5>         Emulate frames ahead to reduce input latency\n"
+    << "  -benchmark       <seconds>     Run the ROM at maximum speed, report and quit\n"
+    << "  -benchmark.interval <ms>       Display interval while benchmarking\n"
+    << "  -perf.dump       <file>        Write per-frame timing counters to a CSV file\n"
     << "  -uimessages      <1|0>         Show onscreen UI messages for different events\n"
     << "  -pausedim        <1|0>         Enable emulation dimming in pause mode\n\n"
     << "  -bezel.show        <1|0>       Show bezel around emulation window\n"
@@ -501,7 +570,7 @@ void Settings::usage()
     << "  -audio.sample_rate        <number>   Output sample rate (44100|48000|96000)\n"
     << "  -audio.fragment_size      <number>   Fragment size (128|256|512|1024|\n"
     << "                                        2048|4096)\n"
-    << "  -audio.resampling_quality <1-3>      Resampling quality\n"
+    << "  -audio.resampling_quality <1-4>      Resampling quality\n"
     << "  -audio.headroom           <0-20>     Additional half-frames to prebuffer\n"
     << "  -audio.buffer_size        <0-20>     Max. number of additional half-\n"
     << "                                        frames to buffer\n"
@@ -528,6 +597,8 @@ void Settings::usage()
     << "  -tv.scanmask  <standard|      Use the specified scanline mask\n"
     << "                 thin|pixel|\n"
     << "                 mame>\n"
+    << "  -tv.governor  <list>          Disable these effects in order when the host\n"
+    << "                                 is too slow (ntsc,phosphor,scanlines,qis)\n"
     << "  -tv.sharpness   <-1.0 - 1.0>  Set TV effects custom sharpness\n"
     << "  -tv.resolution  <-1.0 - 1.0>  Set TV effects custom resolution\n"
     << "  -tv.artifacts   <-1.0 - 1.0>  Set TV effects custom artifacts\n"
@@ -537,6 +608,8 @@ void Settings::usage()
     << "                                description)\n"
     << "  -loglevel     <0|1|2>        Set level of logging during application run\n\n"
     << "  -logtoconsole <1|0>          Log output to console/commandline\n"
+    << "  -lograte      <e,i,d>        Max. error, info and debug messages each thread\n"
+    << "                                may log per second (0 = unlimited)\n"
     << "  -joydeadzone  <0-29>         Sets digital 'dead zone' area for analog joysticks\n"
     << "  -joyallow4    <1|0>          Allow all 4 directions on a joystick to be\n"
     << "                                pressed simultaneously\n"
@@ -565,6 +638,15 @@ void Settings::usage()
     << "  -fastscbios   <1|0>          Disable Supercharger BIOS progress loading bars\n"
     << "  -threads      <1|0>          Whether to using multi-threading during\n"
     << "                                emulation\n"
+    << "  -threads.priority <normal|high|realtime>\n"
+    << "                               Priority of the emulation and audio threads\n"
+    << "  -threads.cpu.main <number>   CPU to run the main thread on (-1 = any)\n"
+    << "  -threads.cpu.emulation <number>\n"
+    << "                               CPU to run the emulation thread on (-1 = any)\n"
+    << "  -threads.cpu.render <list>   CPUs to run the render threads on (e.g. 2,4-7)\n"
+    << "  -threads.handoff <park|spin|run>\n"
+    << "                               How the emulation thread waits between frames\n"
+    << "  -idle         <1|0>          Block while paused or in menus until input arrives\n"
     << "  -snapsavedir  <path>         The directory to save snapshot files to\n"
     << "  -snaploaddir  <path>         The directory to load snapshot files from\n"
     << "  -snapname     <int|rom>      Name snapshots according to internal database or\n"
@@ -573,7 +655,13 @@ void Settings::usage()
     << "  -ss1x         <1|0>          Generate TIA snapshot in 1x mode (ignore\n"
     << "                                scaling/effects)\n"
     << "  -ssinterval   <number>       Number of seconds between snapshots in\n"
-    << "                                continuous snapshot mode\n\n"
+    << "                                continuous snapshot mode\n"
+    << "  -recpipe      <command>      Pipe recorded videos as raw RGB24 into this\n"
+    << "                                command ({width}, {height}, {rate} and\n"
+    << "                                {file} are replaced)\n"
+    << "  -shmexport    <name>         Export frames and sound into this shared memory\n"
+    << "                                segment\n"
+    << "  -shmformat    <indices|rgba> Pixel format of the exported frames\n\n"
     << "  -saveonexit   <none|current| Automatically save state(s) when exiting\n"
     << "                 all>           emulation\n"
     << "  -autoslot     <0|1>          Automatically change to next save slot when\n"
@@ -649,6 +737,15 @@ void Settings::usage()
     << "  -basedir  <path>             Override the base directory for all config files\n"
     << "  -baseinappdir                Override the base directory for all config files\n"
     << "                                by attempting to use the application directory\n"
+    << "  -starttrace   <file>         Write the time spent in each startup stage to a\n"
+    << "                                Chrome trace file\n"
+    << "  -recordmovie  <file>         Record the input to a movie file\n"
+    << "  -playmovie    <file>         Play back a movie file\n"
+    << "  -nethost      <port>         Host a netplay session on the given port\n"
+    << "  -netjoin      <host[:port]>  Join the netplay session at the given address\n"
+    << "  -metrics      <port>         Serve Prometheus metrics on the given port\n"
+    << "                                (0 = off)\n"
+    << "  -metrics.bind <address>      Address to serve the metrics on\n"
     << "  -plusroms.nick <nick>        Define a nickname for the PlusROMs backends.\n"
     << "  -plusroms.id   <id>          Define a temporary ID for the PlusROMs backends.\n"
     << "  -filterbstypes <0|1>         Filter bankswitch type list by ROM size.\n"
@@ -745,6 +842,8 @@ void Settings::usage()
     << "  -dev.thumb.inccycles   <1|0>     Determines whether ARM emulation cycles\n"
     << "                                    increase system cycles\n"
     << "  -dev.thumb.cyclefactor <float>   Sets the ARM cycles correction multiplier\n"
+    << "  -dev.thumb.approxcycles <1|0>    Estimate ARM cycles for ROMs which don't\n"
+    << "                                    read a timer (not with inccycles)\n"
     << "  -dev.thumb.chiptype    <0|1>     Selects the ARM chip type\n"
     << "  -dev.thumb.mammode     <0-3>     Selects the LPC's MAM mode\n"
 #endif
@@ -828,14 +927,58 @@ void Settings::setValue(string_view key, const Variant& value, bool persist)
   {
     if(it->second != value)
     {
-      if(atomic)
-        atomic->save(key, value);
+      if(atomic && atomic->save(key, value))
+        myDirtySettings.erase(it->first);
+      else
+        myDirtySettings.emplace(key);
 
       it->second = value;
+      notifyChange(it->second);
+    }
+  }
+  else if(const auto it = myTemporarySettings.find(key); it != myTemporarySettings.end())
+  {
+    if(it->second != value)
+    {
+      it->second = value;
+      notifyChange(it->second);
     }
   }
   else
-    myTemporarySettings.insert_or_assign(string(key), value);
+    myTemporarySettings.emplace(key, value);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+Settings::Handle Settings::handle(string_view key)
+{
+  return Handle(slot(key));
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Settings::onChange(string_view key, const ChangeCallback& callback)
+{
+  myObservers[&slot(key)].push_back(callback);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+Variant& Settings::slot(string_view key)
+{
+  if(const auto it = myPermanentSettings.find(key); it != myPermanentSettings.end())
+    return it->second;
+
+  // Elements of an unordered_map never move, so the slot stays valid
+  return myTemporarySettings.try_emplace(string(key)).first->second;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Settings::notifyChange(const Variant& slot) const
+{
+  if(myObservers.empty())
+    return;
+
+  if(const auto it = myObservers.find(&slot); it != myObservers.end())
+    for(const auto& callback: it->second)
+      callback(slot);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
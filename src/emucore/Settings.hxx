@@ -18,7 +18,9 @@
 #ifndef SETTINGS_HXX
 #define SETTINGS_HXX
 
+#include <functional>
 #include <unordered_map>
+#include <unordered_set>
 
 #include "Variant.hxx"
 #include "bspf.hxx"
@@ -71,6 +73,33 @@ class Settings
     static constexpr int SETTINGS_VERSION = 1;
     static constexpr string_view SETTINGS_VERSION_KEY = "settings.version";
 
+    /**
+      A setting resolved by handle(), which answers the current value
+      without looking up (and hashing) the key again.  This should be used
+      for settings which are read very often, e.g. once per frame.
+    */
+    class Handle
+    {
+      public:
+        Handle() = default;
+
+        const Variant& value() const { return *mySlot; }
+
+        int getInt() const     { return mySlot->toInt();   }
+        float getFloat() const { return mySlot->toFloat(); }
+        bool getBool() const   { return mySlot->toBool();  }
+        const string& getString() const { return mySlot->toString(); }
+
+      private:
+        explicit Handle(const Variant& slot) : mySlot{&slot} { }
+
+        const Variant* mySlot{&EmptyVariant()};
+
+        friend class Settings;
+    };
+
+    using ChangeCallback = std::function<void(const Variant&)>;
+
   public:
     /**
       This method should be called to display usage information.
@@ -90,7 +119,8 @@ class Settings
 
     /**
       This method is called to save the current settings to the
-      settings file.
+      settings file.  Only settings changed since the last load or save
+      are written; nothing is written if there are none.
     */
     void save();
 
@@ -110,6 +140,37 @@ class Settings
     */
     void setValue(string_view key, const Variant& value, bool persist = true);
 
+    /**
+      Resolve the specified key to a handle, which stays valid for the
+      lifetime of this object.  Unknown keys are added as (empty)
+      temporary settings.
+
+      @param key  The key of the setting
+      @return  The handle of the setting
+    */
+    Handle handle(string_view key);
+
+    /**
+      Register a callback, which is called with the new value whenever the
+      value of the specified setting is changed by setValue().  This allows
+      applying changes immediately, instead of polling the setting.
+
+      @param key       The key of the setting
+      @param callback  The callback to register
+    */
+    void onChange(string_view key, const ChangeCallback& callback);
+
+    /**
+      Group all settings persisted during the lifetime of the returned
+      object into one batch of writes (one transaction for a database).
+      This should be used whenever many settings are changed at once.
+
+      @return  The batch, which ends when the object is destroyed
+    */
+    KeyValueRepositoryBatch batch() const {
+      return KeyValueRepositoryBatch(myRepository->atomic());
+    }
+
     /**
       Convenience methods to return specific types.
 
@@ -146,6 +207,17 @@ class Settings
     */
     void validate();
 
+    /**
+      Answer the storage of the specified setting, adding an empty
+      temporary setting if the key is unknown.
+    */
+    Variant& slot(string_view key);
+
+    /**
+      Call the callbacks registered for the given setting.
+    */
+    void notifyChange(const Variant& slot) const;
+
   private:
     // Holds key/value pairs that are necessary for Stella to
     // function and must be saved on each program exit.
@@ -157,6 +229,12 @@ class Settings
 
     shared_ptr<KeyValueRepository> myRepository;
 
+    // Permanent settings changed, but not yet written to the repository
+    std::unordered_set<string, TransparentHash, TransparentEqual> myDirtySettings;
+
+    // Change callbacks, by setting storage (which never moves)
+    std::unordered_map<const Variant*, vector<ChangeCallback>> myObservers;
+
   private:
     // Following constructors and assignment operators not supported
     Settings(const Settings&) = delete;
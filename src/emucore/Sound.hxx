@@ -120,6 +120,13 @@ class Sound
     */
     virtual void stopWav() { }
 
+    /**
+      Prepare a WAV file to be played later on, without blocking.
+
+      @param fileName  The name of the WAV file
+    */
+    virtual void prefetchWav(const string& fileName) { }
+
     /**
       Get the size of the WAV file which remains to be played.
 
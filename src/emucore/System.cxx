@@ -16,12 +16,14 @@
 //============================================================================
 
 #include <iostream>
+#include <span>
 
 #include "Device.hxx"
 #include "M6502.hxx"
 #include "M6532.hxx"
 #include "TIA.hxx"
 #include "Cart.hxx"
+#include "MemoryReport.hxx"
 #include "System.hxx"
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -36,7 +38,8 @@ System::System(Random& random, M6502& m6502, M6532& m6532,
 {
   // Initialize page access table
   const PageAccess access(&myNullDevice, System::PageAccessType::READ);
-  myPageAccessTable.fill(access);
+  for(uInt16 page = 0; page < NUM_PAGES; ++page)
+    setPageAccess(page << PAGE_SHIFT, access);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -94,98 +97,17 @@ void System::clearDirtyPages()
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-template<bool oob>
-uInt8 System::peekImpl(uInt16 addr, Device::AccessFlags flags)
+uInt8 System::overdrivePeek(uInt16 addr, uInt8 value)
 {
-  const PageAccess& access = getPageAccess(addr);
-
-#ifdef DEBUGGER_SUPPORT
-  // Set access type
-  if(access.romAccessBase)
-    *(access.romAccessBase + (addr & PAGE_MASK)) |= (flags | (addr & Device::HADDR));
-  else
-    access.device->setAccessFlags(addr, flags);
-  // Increase access counter
-  if(flags != Device::NONE)
-  {
-    if(access.romPeekCounter)
-      *(access.romPeekCounter + (addr & PAGE_MASK)) += 1;
-    else
-      access.device->increaseAccessCounter(addr);
-  }
-#endif
-
-  // See if this page uses direct accessing or not
-  uInt8 result = access.directPeekBase
-      ? *(access.directPeekBase + (addr & PAGE_MASK))
-      : (oob ? access.device->peekOob(addr) : access.device->peek(addr));
-
-  if (!oob && myCartridgeDoesBusStuffing) result = myCart.overdrivePeek(addr, result);
-
-#ifdef DEBUGGER_SUPPORT
-  if(!myDataBusLocked)
-#endif
-    myDataBusState = result;
-
-  return result;
+  return myCart.overdrivePeek(addr, value);
 }
 
-template
-uInt8 System::peekImpl<true>(uInt16 addr, Device::AccessFlags flags);
-
-template
-uInt8 System::peekImpl<false>(uInt16 addr, Device::AccessFlags flags);
-
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-template<bool oob>
-void System::pokeImpl(uInt16 addr, uInt8 value, Device::AccessFlags flags)
+uInt8 System::overdrivePoke(uInt16 addr, uInt8 value)
 {
-  if (!oob && myCartridgeDoesBusStuffing) value = myCart.overdrivePoke(addr, value);
-
-  const uInt16 page = (addr & ADDRESS_MASK) >> PAGE_SHIFT;
-  const PageAccess& access = myPageAccessTable[page];
-
-#ifdef DEBUGGER_SUPPORT
-  // Set access type
-  if(access.romAccessBase)
-    *(access.romAccessBase + (addr & PAGE_MASK)) |= (flags | (addr & Device::HADDR));
-  else
-    access.device->setAccessFlags(addr, flags);
-  // Increase access counter
-  if(flags != Device::NONE)
-  {
-    if(access.romPokeCounter)
-      *(access.romPokeCounter + (addr & PAGE_MASK)) += 1;
-    else
-      access.device->increaseAccessCounter(addr, true);
-  }
-#endif
-
-  // See if this page uses direct accessing or not
-  if(access.directPokeBase)
-  {
-    // Since we have direct access to this poke, we can dirty its page
-    *(access.directPokeBase + (addr & PAGE_MASK)) = value;
-    myPageIsDirtyTable[page] = true;
-  }
-  else
-  {
-    // The specific device informs us if the poke succeeded
-    myPageIsDirtyTable[page] = oob ? access.device->pokeOob(addr, value) : access.device->poke(addr, value);
-  }
-
-#ifdef DEBUGGER_SUPPORT
-  if(!myDataBusLocked)
-#endif
-    myDataBusState = value;
+  return myCart.overdrivePoke(addr, value);
 }
 
-template
-void System::pokeImpl<true>(uInt16 addr, uInt8 value, Device::AccessFlags flags);
-
-template
-void System::pokeImpl<false>(uInt16 addr, uInt8 value, Device::AccessFlags flags);
-
 #ifdef DEBUGGER_SUPPORT
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 Device::AccessFlags System::getAccessFlags(uInt16 addr) const
@@ -218,7 +140,7 @@ void System::increaseAccessCounter(uInt16 addr, bool isWrite) const
   {
     if(access.romPokeCounter)
     {
-      *(access.romPokeCounter + (addr & PAGE_MASK)) += 1;
+      Device::countAccess(*(access.romPokeCounter + (addr & PAGE_MASK)));
       return;
     }
   }
@@ -226,12 +148,43 @@ void System::increaseAccessCounter(uInt16 addr, bool isWrite) const
   {
     if(access.romPeekCounter)
     {
-      *(access.romPeekCounter + (addr & PAGE_MASK)) += 1;
+      Device::countAccess(*(access.romPeekCounter + (addr & PAGE_MASK)));
       return;
     }
   }
   access.device->increaseAccessCounter(addr, isWrite);
 }
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void System::setAccessCounting(AccessCounting mode)
+{
+  flushAccessCounters();
+  myAccessCounting = mode;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void System::flushAccessCounters()
+{
+  const auto log = std::span(myAccessLog.data(), myAccessLogSize);
+
+  // Group by address, keeping the order of the accesses to each address
+  // (the devices treat the first accesses as initialization)
+  std::ranges::stable_sort(log, {}, [](uInt32 entry) { return entry & 0xffff; });
+
+  for(size_t i = 0; i < log.size();)
+  {
+    const uInt32 entry = log[i];
+    size_t end = i + 1;
+    while(end < log.size() && log[end] == entry)
+      ++end;
+
+    const auto addr = static_cast<uInt16>(entry);
+    getPageAccess(addr).device->increaseAccessCounter(
+      addr, entry & 0x10000, static_cast<Device::AccessCounter>(end - i));
+    i = end;
+  }
+  myAccessLogSize = 0;
+}
 #endif
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -291,3 +244,13 @@ bool System::load(Serializer& in)
 
   return true;
 }
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void System::memoryReport(MemoryReport& report) const
+{
+  report.add("System", sizeof(System));
+  report.add("M6502", sizeof(M6502));
+  report.add("M6532", sizeof(M6532) + myM6532.memoryUsage());
+  report.add("TIA", sizeof(TIA) + myTIA.memoryUsage());
+  report.add("Cartridge (" + myCart.name() + ")", myCart.memoryUsage());
+}
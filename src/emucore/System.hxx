@@ -22,6 +22,7 @@ class M6502;
 class M6532;
 class TIA;
 class Cartridge;
+class MemoryReport;
 
 #include "bspf.hxx"
 #include "Device.hxx"
@@ -173,6 +174,12 @@ class System : public Serializable
      */
     uInt8 peek(uInt16 address, Device::AccessFlags flags = Device::NONE)
     {
+    #ifdef DEBUGGER_SUPPORT
+      if(myAccessCounting != AccessCounting::off)
+        return peekImpl<false, true, true>(address, flags);
+      if(myAccessTracking)
+        return peekImpl<false, true>(address, flags);
+    #endif
       return peekImpl<false>(address, flags);
     }
 
@@ -181,6 +188,12 @@ class System : public Serializable
      */
     uInt8 peekOob(uInt16 address, Device::AccessFlags flags = Device::NONE)
     {
+    #ifdef DEBUGGER_SUPPORT
+      if(myAccessCounting != AccessCounting::off)
+        return peekImpl<true, true, true>(address, flags);
+      if(myAccessTracking)
+        return peekImpl<true, true>(address, flags);
+    #endif
       return peekImpl<true>(address, flags);
     }
 
@@ -189,6 +202,18 @@ class System : public Serializable
      */
     void poke(uInt16 address, uInt8 value, Device::AccessFlags flags = Device::NONE)
     {
+    #ifdef DEBUGGER_SUPPORT
+      if(myAccessCounting != AccessCounting::off)
+      {
+        pokeImpl<false, true, true>(address, value, flags);
+        return;
+      }
+      if(myAccessTracking)
+      {
+        pokeImpl<false, true>(address, value, flags);
+        return;
+      }
+    #endif
       pokeImpl<false>(address, value, flags);
     }
 
@@ -197,6 +222,18 @@ class System : public Serializable
      */
     void pokeOob(uInt16 address, uInt8 value, Device::AccessFlags flags = Device::NONE)
     {
+    #ifdef DEBUGGER_SUPPORT
+      if(myAccessCounting != AccessCounting::off)
+      {
+        pokeImpl<true, true, true>(address, value, flags);
+        return;
+      }
+      if(myAccessTracking)
+      {
+        pokeImpl<true, true>(address, value, flags);
+        return;
+      }
+    #endif
       pokeImpl<true>(address, value, flags);
     }
 
@@ -227,6 +264,30 @@ class System : public Serializable
       @param address The address to modify
     */
     void increaseAccessCounter(uInt16 address, bool isWrite) const;
+
+    /**
+      Enable updating the access type flags by peek() and poke().  Until
+      then, the lean bus accesses without any debugger bookkeeping are
+      used.  Once enabled, tracking stays on for this system.
+    */
+    void enableAccessTracking() { myAccessTracking = true; }
+
+    /**
+      How the access counters are updated by peek() and poke().  ROM
+      counters are always updated directly, the device counters (TIA,
+      RIOT) are logged and applied in batches.
+    */
+    enum class AccessCounting: uInt8 {
+      off,     // no counting at all, peek() and poke() skip the counters
+      batched  // count, logging device accesses
+    };
+    void setAccessCounting(AccessCounting mode);
+
+    /**
+      Apply the logged device accesses to the device access counters.
+      Must be called before the counters are read.
+    */
+    void flushAccessCounters();
   #endif
 
   public:
@@ -307,7 +368,32 @@ class System : public Serializable
       @param access The accessing methods to be used by the page
     */
     void setPageAccess(uInt16 addr, const PageAccess& access) {
-      myPageAccessTable[(addr & ADDRESS_MASK) >> PAGE_SHIFT] = access;
+      const uInt16 page = (addr & ADDRESS_MASK) >> PAGE_SHIFT;
+
+      myPageAccessTable[page] = access;
+      myDirectPeekTable[page] = access.directPeekBase;
+      myDirectPokeTable[page] = access.directPokeBase;
+      myDeviceTable[page] = access.device;
+    }
+
+    /**
+      Set the page accessing methods for a block of consecutive pages, e.g.
+      from a descriptor block which was precomputed for a whole bank.
+
+      @param addr   The address of the first page to set
+      @param access The accessing methods to be used by the pages
+      @param pages  The number of pages to set
+    */
+    void setPageAccess(uInt16 addr, const PageAccess* access, uInt16 pages) {
+      const uInt16 page = (addr & ADDRESS_MASK) >> PAGE_SHIFT;
+
+      std::copy_n(access, pages, &myPageAccessTable[page]);
+      for(uInt16 i = 0; i < pages; ++i)
+      {
+        myDirectPeekTable[page + i] = access[i].directPeekBase;
+        myDirectPokeTable[page + i] = access[i].directPokeBase;
+        myDeviceTable[page + i] = access[i].device;
+      }
     }
 
     /**
@@ -369,6 +455,14 @@ class System : public Serializable
     */
     bool load(Serializer& in) override;
 
+    /**
+      Add the memory owned by the system, its chips and the cartridge
+      to the given report.
+
+      @param report  The report to add the entries to
+    */
+    void memoryReport(MemoryReport& report) const;
+
   private:
     /**
       Get the byte at the specified address.  No masking of the
@@ -377,13 +471,15 @@ class System : public Serializable
 
         oob      Out-of-band peeks are not part of the activity of the
                  emulated system
+        track    Update the access type flags (debugger only)
+        count    Update the access counters (debugger only, implies track)
       @param address  The address from which the value should be loaded
       @param flags    Indicates that this address has the given flags
                       for type of access (CODE, DATA, GFX, etc)
 
       @return The byte at the specified address
     */
-    template<bool oob = false>
+    template<bool oob = false, bool track = false, bool count = false>
     uInt8 peekImpl(uInt16 address, Device::AccessFlags flags);
 
     /**
@@ -398,12 +494,24 @@ class System : public Serializable
 
         oob      Out-of-band peeks are not part of the activity of the
                  emulated system
+        track    Update the access type flags (debugger only)
+        count    Update the access counters (debugger only, implies track)
       @param address  The address where the value should be stored
       @param value    The value to be stored at the address
     */
-    template<bool oob = false>
+    template<bool oob = false, bool track = false, bool count = false>
     void pokeImpl(uInt16 address, uInt8 value, Device::AccessFlags flags);
 
+  #ifdef DEBUGGER_SUPPORT
+    // Log an access to be counted by the device at the address
+    void logDeviceAccess(uInt16 address, bool isWrite);
+  #endif
+
+    // Let the cartridge modify the data bus (bus stuffing), kept out of line
+    // since it is rarely used
+    uInt8 overdrivePeek(uInt16 address, uInt8 value);
+    uInt8 overdrivePoke(uInt16 address, uInt8 value);
+
   private:
     // The system RNG
     Random& myRandom;
@@ -429,6 +537,14 @@ class System : public Serializable
     // The list of PageAccess structures
     std::array<PageAccess, NUM_PAGES> myPageAccessTable;
 
+    // Compact copies of the direct access pointers and devices of the
+    // PageAccess structures, which is all that peek and poke need outside
+    // the debugger.  They are updated by setPageAccess(), and keep the
+    // whole address space in a few cache lines.
+    std::array<uInt8*, NUM_PAGES> myDirectPeekTable{};
+    std::array<uInt8*, NUM_PAGES> myDirectPokeTable{};
+    std::array<Device*, NUM_PAGES> myDeviceTable{};
+
     // The list of dirty pages
     std::array<bool, NUM_PAGES> myPageIsDirtyTable{};
 
@@ -447,6 +563,18 @@ class System : public Serializable
 
     bool myCartridgeDoesBusStuffing{false};
 
+  #ifdef DEBUGGER_SUPPORT
+    AccessCounting myAccessCounting{AccessCounting::off};
+
+    // Whether peek() and poke() update the access type flags
+    bool myAccessTracking{false};
+
+    // Device accesses not yet counted, as address | 0x10000 for writes;
+    // sorted and aggregated when full or when the counters are needed
+    std::array<uInt32, 4096> myAccessLog{};
+    uInt32 myAccessLogSize{0};
+  #endif
+
   private:
     // Following constructors and assignment operators not supported
     System() = delete;
@@ -456,4 +584,111 @@ class System : public Serializable
     System& operator=(System&&) = delete;
 };
 
+// ############################################################################
+// Implementation, inline for use by the CPU emulation
+// ############################################################################
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+template<bool oob, bool track, bool count>
+inline uInt8 System::peekImpl(uInt16 addr, Device::AccessFlags flags)
+{
+  const uInt16 page = (addr & ADDRESS_MASK) >> PAGE_SHIFT;
+
+#ifdef DEBUGGER_SUPPORT
+  if(track)
+  {
+    const PageAccess& access = myPageAccessTable[page];
+
+    // Set access type
+    if(access.romAccessBase)
+      *(access.romAccessBase + (addr & PAGE_MASK)) |= (flags | (addr & Device::HADDR));
+    else
+      access.device->setAccessFlags(addr, flags);
+    // Increase access counter
+    if(count && flags != Device::NONE)
+    {
+      if(access.romPeekCounter)
+        Device::countAccess(*(access.romPeekCounter + (addr & PAGE_MASK)));
+      else
+        logDeviceAccess(addr, false);
+    }
+  }
+#endif
+
+  // See if this page uses direct accessing or not
+  const uInt8* direct = myDirectPeekTable[page];
+  uInt8 result = direct
+      ? direct[addr & PAGE_MASK]
+      : (oob ? myDeviceTable[page]->peekOob(addr) : myDeviceTable[page]->peek(addr));
+
+  if (!oob && myCartridgeDoesBusStuffing) result = overdrivePeek(addr, result);
+
+#ifdef DEBUGGER_SUPPORT
+  if(!myDataBusLocked)
+#endif
+    myDataBusState = result;
+
+  return result;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+template<bool oob, bool track, bool count>
+inline void System::pokeImpl(uInt16 addr, uInt8 value, Device::AccessFlags flags)
+{
+  if (!oob && myCartridgeDoesBusStuffing) value = overdrivePoke(addr, value);
+
+  const uInt16 page = (addr & ADDRESS_MASK) >> PAGE_SHIFT;
+
+#ifdef DEBUGGER_SUPPORT
+  if(track)
+  {
+    const PageAccess& access = myPageAccessTable[page];
+
+    // Set access type
+    if(access.romAccessBase)
+      *(access.romAccessBase + (addr & PAGE_MASK)) |= (flags | (addr & Device::HADDR));
+    else
+      access.device->setAccessFlags(addr, flags);
+    // Increase access counter
+    if(count && flags != Device::NONE)
+    {
+      if(access.romPokeCounter)
+        Device::countAccess(*(access.romPokeCounter + (addr & PAGE_MASK)));
+      else
+        logDeviceAccess(addr, true);
+    }
+  }
+#endif
+
+  // See if this page uses direct accessing or not
+  if(uInt8* direct = myDirectPokeTable[page]; direct)
+  {
+    // Since we have direct access to this poke, we can dirty its page
+    direct[addr & PAGE_MASK] = value;
+    myPageIsDirtyTable[page] = true;
+  }
+  else
+  {
+    // The specific device informs us if the poke succeeded
+    myPageIsDirtyTable[page] = oob
+        ? myDeviceTable[page]->pokeOob(addr, value)
+        : myDeviceTable[page]->poke(addr, value);
+  }
+
+#ifdef DEBUGGER_SUPPORT
+  if(!myDataBusLocked)
+#endif
+    myDataBusState = value;
+}
+
+#ifdef DEBUGGER_SUPPORT
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+inline void System::logDeviceAccess(uInt16 addr, bool isWrite)
+{
+  myAccessLog[myAccessLogSize] = addr | (isWrite ? 0x10000 : 0);
+  if(++myAccessLogSize == myAccessLog.size())
+    flushAccessCounters();
+}
+#endif
+
 #endif
@@ -22,6 +22,10 @@
 #include "TIA.hxx"
 #include "PNGLibrary.hxx"
 #include "PaletteHandler.hxx"
+#include "ThreadPool.hxx"
+#include "ThreadScheduling.hxx"
+#include "PerfCounters.hxx"
+#include "MemoryReport.hxx"
 #include "TIASurface.hxx"
 
 namespace {
@@ -63,7 +67,7 @@ TIASurface::TIASurface(OSystem& system)
   myRGBFramebuffer.fill(0);
 
   // Enable/disable threading in the NTSC TV effects renderer
-  myNTSCFilter.enableThreading(myOSystem.settings().getBool("threads"));
+  enableThreading(myOSystem.settings().getBool("threads"));
 
   myPaletteHandler = std::make_unique<PaletteHandler>(myOSystem);
   myPaletteHandler->loadConfig(myOSystem.settings());
@@ -102,12 +106,29 @@ void TIASurface::setPalette(const PaletteArray& tia_palette,
                             const PaletteArray& rgb_palette)
 {
   myPalette = tia_palette;
+  myRGBPalette = rgb_palette;
+  myPhosphorRows.invalidate();
 
   // The NTSC filtering needs access to the raw RGB data, since it calculates
   // its own internal palette
   myNTSCFilter.setPalette(rgb_palette);
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TIASurface::invalidatePhosphor()
+{
+  myPhosphorRows.invalidate();
+  myNTSCFilter.invalidatePhosphor();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TIASurface::memoryReport(MemoryReport& report) const
+{
+  report.add("TIA surface buffers", sizeof(TIASurface) - sizeof(NTSCFilter));
+  report.add("NTSC filter kernels", myNTSCFilter.memoryUsage());
+  report.add("Phosphor LUT", PhosphorHandler::memoryUsage());
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 const FBSurface& TIASurface::baseSurface(Common::Rect& rect) const
 {
@@ -292,6 +313,7 @@ void TIASurface::enablePhosphor(bool enable, int blend)
         enable ? static_cast<uInt8>(myFilter) | 0x01
                : static_cast<uInt8>(myFilter) & 0x10);
     myRGBFramebuffer.fill(0);
+    invalidatePhosphor();
   }
 }
 
@@ -416,6 +438,19 @@ void TIASurface::createScanlineSurface()
   enableNTSC(ntscEnabled());
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TIASurface::enableThreading(bool enable)
+{
+  const uInt32 numThreads = ThreadPool::renderThreads(enable);
+  if(myThreadPool && myThreadPool->numThreads() == numThreads)
+    return;
+
+  myNTSCFilter.setThreadPool(nullptr);
+  myThreadPool = std::make_unique<ThreadPool>(numThreads,
+      ThreadScheduling::parseCpuList(myOSystem.settings().getString("threads.cpu.render")));
+  myNTSCFilter.setThreadPool(myThreadPool.get());
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void TIASurface::enableNTSC(bool enable)
 {
@@ -439,6 +474,7 @@ void TIASurface::enableNTSC(bool enable)
   mySLineSurface->setBlendLevel(scanlines);
 
   myRGBFramebuffer.fill(0);
+  invalidatePhosphor();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -503,10 +539,16 @@ inline uInt32 TIASurface::averageBuffers(uInt32 bufOfs)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void TIASurface::render(bool shade)
 {
+  PERF_SCOPE(TIASurface);
+
   const uInt32 width = myTIA->width(), height = myTIA->height();
 
+  // Write straight into the texture if the backend supports it, which saves
+  // uploading the surface (and a staging copy in the driver)
   uInt32 *out{nullptr}, outPitch{0};
-  myTiaSurface->basePtr(out, outPitch);
+  const bool direct = myTiaSurface->lockPixels(out, outPitch);
+  if(!direct)
+    myTiaSurface->basePtr(out, outPitch);
 
   switch(myFilter)
   {
@@ -531,26 +573,42 @@ void TIASurface::render(bool shade)
     case Filter::Phosphor:
     {
       const uInt8* tiaIn = myTIA->frameBuffer();
+      const uInt64* lineHashes = myTIA->frameBufferLineHashes();
       uInt32* rgbIn = myRGBFramebuffer.data();
 
       if(mySaveSnapFlag)
         std::copy_n(myRGBFramebuffer.begin(), width * height,
                     myPrevRGBFramebuffer.begin());
 
-      uInt32 bufofs = 0, screenofsY = 0;
-      for(uInt32 y = height; y ; --y)
+      myThreadPool->run([&](uInt32 stripe, uInt32 numStripes)
       {
-        uInt32 pos = screenofsY;
-        for(uInt32 x = width / 2; x ; --x)
+        const uInt32 yStart = height * stripe / numStripes;
+        const uInt32 yEnd = height * (stripe + 1) / numStripes;
+
+        uInt32 bufofs = yStart * width, screenofsY = yStart * outPitch;
+        for(uInt32 y = yStart; y < yEnd; ++y)
         {
-          // Store back into displayed frame buffer (for next frame)
-          rgbIn[bufofs] = out[pos++] = PhosphorHandler::getPixel(myPalette[tiaIn[bufofs]], rgbIn[bufofs]);
-          ++bufofs;
-          rgbIn[bufofs] = out[pos++] = PhosphorHandler::getPixel(myPalette[tiaIn[bufofs]], rgbIn[bufofs]);
-          ++bufofs;
+          uInt32* outRow = out + screenofsY;
+          uInt32* rgbRow = rgbIn + bufofs;
+
+          // Unchanged rows just have to be copied
+          if(myPhosphorRows.skipRow(y, lineHashes[y]))
+            std::copy_n(rgbRow, width, outRow);
+          else
+          {
+            // Convert into a local row, since the output may be slow to
+            // read back (e.g. texture memory)
+            std::array<uInt32, TIAConstants::frameBufferWidth> row;
+            for(uInt32 x = 0; x < width; ++x)
+              row[x] = myPalette[tiaIn[bufofs + x]];
+            // Store back into displayed frame buffer (for next frame)
+            myPhosphorRows.setStable(y,
+                !PhosphorHandler::blendRow(row.data(), rgbRow, outRow, width));
+          }
+          bufofs += width;
+          screenofsY += outPitch;
         }
-        screenofsY += outPitch;
-      }
+      });
       break;
     }
 
@@ -563,10 +621,13 @@ void TIASurface::render(bool shade)
     case Filter::BlarggPhosphor:
     {
       if(mySaveSnapFlag)
-        std::copy_n(myRGBFramebuffer.begin(), height * outPitch,
+        // The blended pixels are stored without padding, so don't use
+        // the pitch of the (possibly locked) output
+        std::copy_n(myRGBFramebuffer.begin(), AtariNTSC::outWidth(width) * height,
                     myPrevRGBFramebuffer.begin());
 
-      myNTSCFilter.render(myTIA->frameBuffer(), width, height, out, outPitch << 2, myRGBFramebuffer.data());
+      myNTSCFilter.render(myTIA->frameBuffer(), width, height, out, outPitch << 2,
+                          myRGBFramebuffer.data(), myTIA->frameBufferLineHashes());
       break;
     }
 
@@ -574,11 +635,14 @@ void TIASurface::render(bool shade)
       break;  // Not supposed to get here
   }
 
+  if(direct)
+    myTiaSurface->unlockPixels();
+
   // Draw TIA image
   myTiaSurface->render();
 
   // Draw overlaying scanlines
-  if(myScanlinesEnabled)
+  if(myScanlinesEnabled && !myScanlinesSuppressed)
     mySLineSurface->render();
 
   if(shade)
@@ -655,7 +719,7 @@ void TIASurface::renderForSnapshot()
     myTiaSurface->render();
 
     // Draw overlaying scanlines
-    if(myScanlinesEnabled)
+    if(myScanlinesEnabled && !myScanlinesSuppressed)
       mySLineSurface->render();
   }
 }
@@ -664,12 +728,35 @@ void TIASurface::renderForSnapshot()
 void TIASurface::updateSurfaceSettings()
 {
   if(myTiaSurface != nullptr)
-    myTiaSurface->setScalingInterpolation(
-      interpolationModeFromSettings(myOSystem.settings()));
+    myTiaSurface->setScalingInterpolation(interpolationMode());
 
   if(mySLineSurface != nullptr)
-    mySLineSurface->setScalingInterpolation(
-      interpolationModeFromSettings(myOSystem.settings()));
+    mySLineSurface->setScalingInterpolation(interpolationMode());
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TIASurface::suppressSmoothing(bool suppress)
+{
+  if(suppress == mySmoothingSuppressed)
+    return;
+
+  mySmoothingSuppressed = suppress;
+  updateSurfaceSettings();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool TIASurface::smoothingEnabled() const
+{
+  return interpolationModeFromSettings(myOSystem.settings()) ==
+    ScalingInterpolation::blur;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+ScalingInterpolation TIASurface::interpolationMode() const
+{
+  return mySmoothingSuppressed
+    ? ScalingInterpolation::sharp
+    : interpolationModeFromSettings(myOSystem.settings());
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -23,6 +23,8 @@ class Console;
 class OSystem;
 class FBSurface;
 class PaletteHandler;
+class ThreadPool;
+class MemoryReport;
 
 #include <thread>
 
@@ -39,6 +41,12 @@ class PaletteHandler;
   This is placed in a separate class since currently, rendering a TIA image
   can consist of TV filters, a separate scanline surface, phosphor modes, etc.
 
+  The palette conversion, NTSC filtering and phosphor blending are done on
+  the CPU, but only at the TIA resolution (at most 568 x 320 pixels, see
+  render()).  Scaling to the output resolution, the interpolation/QIS
+  blitters and blending the (static) scanline mask texture happen on the
+  GPU, so the CPU load doesn't depend on the window or display size.
+
   @author  Stephen Anthony
 */
 
@@ -77,6 +85,11 @@ class TIASurface
     void setPalette(const PaletteArray& tia_palette,
                     const PaletteArray& rgb_palette);
 
+    /**
+      Answer the RGB components of the current palette.
+    */
+    const PaletteArray& rgbPalette() const { return myRGBPalette; }
+
     /**
       Get a TIA surface that has no post-processing whatsoever.  This is
       currently used to save PNG image in the so-called '1x mode'.
@@ -101,6 +114,12 @@ class TIASurface
     */
     NTSCFilter& ntsc() { return myNTSCFilter; }
 
+    /**
+      Add the memory used by the TIA surface (RGB buffers, NTSC filter and
+      phosphor lookup table) to the given report.
+    */
+    void memoryReport(MemoryReport& report) const;
+
     /**
       Use NTSC filtering effects specified by the given preset.
     */
@@ -172,6 +191,20 @@ class TIASurface
     bool ntscEnabled() const { return static_cast<uInt8>(myFilter) & 0x10; }
     string effectsInfo() const;
 
+    /**
+      Temporarily skip the scanline overlay resp. the smooth (QIS) scaling,
+      without changing the settings (used by the QualityGovernor).
+    */
+    void suppressScanlines(bool suppress) { myScanlinesSuppressed = suppress; }
+    void suppressSmoothing(bool suppress);
+    bool scanlinesEnabled() const { return myScanlinesEnabled; }
+    bool smoothingEnabled() const;
+
+    /**
+      Enable/disable threading in the CPU based rendering stages.
+    */
+    void enableThreading(bool enable);
+
     /**
       This method should be called to draw the TIA image(s) to the screen.
     */
@@ -214,6 +247,11 @@ class TIASurface
     };
 
   private:
+    /**
+      The phosphor buffer has been modified, all rows must be blended again.
+    */
+    void invalidatePhosphor();
+
     /**
       Average current calculated buffer's pixel with previous calculated buffer's pixel (50:50).
     */
@@ -222,6 +260,9 @@ class TIASurface
     // Is plain video mode enabled?
     bool correctAspect() const;
 
+    // The scaling interpolation from the settings, unless suppressed
+    ScalingInterpolation interpolationMode() const;
+
     // Convert scanline mask setting name into type
     ScanlineMask scanlineMaskType(int direction = 0);
 
@@ -246,6 +287,9 @@ class TIASurface
     // Phosphor blend
     int myPBlend{0};
 
+    // Rows which are unchanged in phosphor mode
+    PhosphorHandler::DirtyRows myPhosphorRows;
+
     std::array<uInt32, static_cast<std::size_t>
       (AtariNTSC::outWidth(TIAConstants::frameBufferWidth) *
       TIAConstants::frameBufferHeight)> myRGBFramebuffer{};
@@ -257,8 +301,13 @@ class TIASurface
     // Use scanlines in TIA rendering mode
     bool myScanlinesEnabled{false};
 
+    // Effects temporarily disabled by the QualityGovernor
+    bool myScanlinesSuppressed{false}, mySmoothingSuppressed{false};
+
     // Palette for normal TIA rendering mode
     PaletteArray myPalette{};
+    // The same palette in R/G/B format
+    PaletteArray myRGBPalette{};
 
     // Flag for saving a snapshot
     bool mySaveSnapFlag{false};
@@ -266,6 +315,9 @@ class TIASurface
     // The palette handler
     unique_ptr<PaletteHandler> myPaletteHandler;
 
+    // Threads shared by all CPU based rendering stages
+    unique_ptr<ThreadPool> myThreadPool;
+
   private:
     // Following constructors and assignment operators not supported
     TIASurface() = delete;
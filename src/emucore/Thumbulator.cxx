@@ -27,6 +27,11 @@
 #include "Base.hxx"
 #include "Cart.hxx"
 #include "Thumbulator.hxx"
+#include "PerfCounters.hxx"
+#include "RomCache.hxx"
+#ifdef DEBUGGER_SUPPORT
+  #include "ArmProfiler.hxx"
+#endif
 using Common::Base;
 
 // Uncomment the following to enable specific functionality
@@ -149,14 +154,16 @@ Thumbulator::Thumbulator(const uInt16* rom_ptr, uInt16* ram_ptr, uInt32 rom_size
     cBase{c_base},
     cStart{c_start},
     cStack{c_stack},
-    decodedRom{std::make_unique<Op[]>(romSize / 2)},  // NOLINT
-    decodedParam{std::make_unique<uInt32[]>(romSize / 2)},  // NOLINT
+    decodedRom{std::make_shared<DecodedRom>(romSize)},
+    decodedRam{std::make_unique<Op[]>(RAMSIZE / 2)},  // NOLINT
+    decodedRamParam{std::make_unique<uInt32[]>(RAMSIZE / 2)},  // NOLINT
     ram{ram_ptr},
     configuration{configurefor},
     myCartridge{cartridge}
 {
-  for(uInt32 i = 0; i < romSize / 2; ++i)
-    decodedRom[i] = decodeInstructionWord(CONV_RAMROM(rom[i]), i * 2);
+  // Code in ROM and RAM is decoded lazily when it is executed
+  std::fill_n(decodedRam.get(), RAMSIZE / 2, Op::numOps);
+  decodedRamIndices.reserve(RAMSIZE / 2);
 
   setConsoleTiming(ConsoleTiming::ntsc);
   trapFatalErrors(traponfatal);
@@ -173,11 +180,16 @@ string Thumbulator::doRun(uInt32& cycles, bool irqDrivenAudio)
   reset();
   for(;;)
   {
+  #ifdef DEBUGGER_SUPPORT
+    if(_profiler && _profiler->due())
+      _profiler->sample(reg_norm[15] - 2, reg_norm[14]);
+  #endif
     if(execute()) break;
     if(_stats.instructions > 500000) // way more than would otherwise be possible
       throw std::runtime_error("instructions > 500000");
   }
 #ifdef THUMB_CYCLE_COUNT
+  updateCycleModel();
   _totalCycles *= _armCyclesFactor;
 
   // assuming 10% per scanline is spend for audio updates
@@ -199,6 +211,39 @@ string Thumbulator::doRun(uInt32& cycles, bool irqDrivenAudio)
 #endif
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Thumbulator::enableCycleCount(bool enable)
+{
+  _countCycles = enable;
+#ifdef THUMB_CYCLE_COUNT
+  // Start a new profile
+  _approxCycles = _timerRead = false;
+  _profiledRuns = 0;
+  _profiledCycles = _profiledInstructions = 0;
+#endif
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Thumbulator::approximateCycles(bool enable)
+{
+#ifdef THUMB_CYCLE_COUNT
+  if(enable == _allowApproxCycles)
+    return;
+
+  _allowApproxCycles = enable;
+  // Revert to the exact model and start a new profile
+  if(_approxCycles)
+  {
+    _approxCycles = false;
+    _countCycles = true;
+  }
+  _profiledRuns = 0;
+  _profiledCycles = _profiledInstructions = 0;
+#else
+  (void)enable;
+#endif
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void Thumbulator::setConsoleTiming(ConsoleTiming timing)
 {
@@ -238,10 +283,23 @@ void Thumbulator::updateTimer(uInt32 cycles)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 string Thumbulator::run(uInt32& cycles, bool irqDrivenAudio)
 {
+  PERF_SCOPE(ARM);
+
+  // The 6507 side has direct access to the RAM, so code decoded there
+  // during previous calls may be stale by now
+  invalidateDecodedRam();
   updateTimer(cycles);
   return doRun(cycles, irqDrivenAudio);
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Thumbulator::invalidateDecodedRam()
+{
+  for(const uInt16 index: decodedRamIndices)
+    decodedRam[index] = Op::numOps;
+  decodedRamIndices.clear();
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 int Thumbulator::fatalError(string_view opcode, uInt32 v1, string_view msg)
 {
@@ -337,6 +395,8 @@ FORCE_INLINE uInt32 Thumbulator::fetch16(uInt32 addr)
       addr &= ROMADDMASK;
       if(addr < 0x50)
         fatalError("fetch16", addr, "abort");
+      if(addr >= romSize) // the image can be smaller than the address space
+        return fatalError("fetch16", addr, "abort - out of range");
       addr >>= 1;
       data = CONV_RAMROM(rom[addr]);
       DO_DBUG(statusMsg << "fetch16(" << Base::HEX8 << addr << ")=" << Base::HEX4 << data << '\n');
@@ -375,6 +435,8 @@ void Thumbulator::write16(uInt32 addr, uInt32 data)
       addr &= RAMADDMASK;
       addr >>= 1;
       ram[addr] = CONV_DATA(data);
+      // Self-modifying code: drop the decoded instruction (if any)
+      decodedRam[addr] = Op::numOps;
       return;
 
     case 0xE0000000: //MAMCR
@@ -607,6 +669,8 @@ uInt32 Thumbulator::read16(uInt32 addr)
         fatalError("read16", addr, "abort - out of range");
 
       addr &= ROMADDMASK;
+      if(addr >= romSize) // the image can be smaller than the address space
+        return data;
       addr >>= 1;
       data = CONV_RAMROM(rom[addr]);
       DO_DBUG(statusMsg << "read16(" << Base::HEX8 << addr << ")=" << Base::HEX4 << data << '\n');
@@ -683,9 +747,15 @@ uInt32 Thumbulator::read32(uInt32 addr)
 
         case 0xE0004008:  // T0TC - Timer 0 Counter
         #ifdef THUMB_CYCLE_COUNT
+          timerRead();
           if(T0TCR & 1)
+          {
             // timer is counting
+          #ifdef SKIP_TIMER_POLLS
+            skipTimerPollLoop(addr);
+          #endif
             data = T0TC + (tim0Total + (_totalCycles - tim0Start)) * _armCyclesFactor;  // NOLINT
+          }
           else
             // timer is disabled
             data = T0TC + tim0Total * _armCyclesFactor;  // NOLINT
@@ -700,9 +770,15 @@ uInt32 Thumbulator::read32(uInt32 addr)
 
         case 0xE0008008:  // T1TC - Timer 1 Counter
         #ifdef THUMB_CYCLE_COUNT
+          timerRead();
           if(T1TCR & 1)
+          {
             // timer is counting
+          #ifdef SKIP_TIMER_POLLS
+            skipTimerPollLoop(addr);
+          #endif
             data = T1TC + (tim1Total + (_totalCycles - tim1Start)) * _armCyclesFactor;
+          }
           else
             // timer is disabled
             data = T1TC + tim1Total * _armCyclesFactor;
@@ -725,7 +801,8 @@ uInt32 Thumbulator::read32(uInt32 addr)
           return data;
 #ifdef THUMB_CYCLE_COUNT
         case 0xE01FC100: // APBDIV
-          _countCycles = true; // enabe cycle counting
+          if(!_approxCycles)
+            _countCycles = true; // enabe cycle counting
           return 1; // random value
 #endif
 
@@ -794,7 +871,45 @@ void Thumbulator::do_cvflag(uInt32 a, uInt32 b, uInt32 c)
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-Thumbulator::Op Thumbulator::decodeInstructionWord(uint16_t inst, uInt32 pc) {
+const Thumbulator::DecodedPage& Thumbulator::decodeRomPage(uInt32 page)
+{
+  auto decoded = std::make_unique<DecodedPage>();
+  const uInt32 first = page * DECODED_PAGE_OPS;
+  const uInt32 count = std::min(DECODED_PAGE_OPS, romSize / 2 - first);
+
+  for(uInt32 i = 0; i < count; ++i)
+    decoded->op[i] = decodeInstructionWord(CONV_RAMROM(rom[first + i]),
+                                           (first + i) * 2, decoded->param[i]);
+
+  // Another emulator sharing the cache may have decoded the page meanwhile;
+  // the results are identical, so just keep the first one
+  const DecodedPage* published = nullptr;
+  if(decodedRom->pages[page].compare_exchange_strong(published, decoded.get(),
+                                                     std::memory_order_acq_rel))
+    return *decoded.release();
+  return *published;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Thumbulator::shareDecodedRom(const string& key)
+{
+  const uInt32 size = romSize;
+
+  decodedRom = RomCache::get<DecodedRom>(key, [size]() {
+    return std::make_shared<DecodedRom>(size);
+  });
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Thumbulator::romChanged(const uInt16* rom_ptr)
+{
+  rom = rom_ptr;
+  decodedRom = std::make_shared<DecodedRom>(romSize);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+Thumbulator::Op Thumbulator::decodeInstructionWord(uint16_t inst, uInt32 pc,
+                                                    uInt32& param) {
   //ADC add with carry
   if((inst & 0xFFC0) == 0x4140) return Op::adc;
 
@@ -839,7 +954,7 @@ Thumbulator::Op Thumbulator::decodeInstructionWord(uint16_t inst, uInt32 pc) {
     rb <<= 1;
     rb += pc;
     rb += 2;
-    decodedParam[pc / 2] = rb + 4;
+    param = rb + 4;
 
     switch(op)
     {
@@ -900,7 +1015,7 @@ Thumbulator::Op Thumbulator::decodeInstructionWord(uint16_t inst, uInt32 pc) {
     rb <<= 1;
     rb += pc;
     rb += 2;
-    decodedParam[pc / 2] = rb + 4;
+    param = rb + 4;
 
     return Op::b2;
   }
@@ -1112,10 +1227,34 @@ FORCE_INLINE int Thumbulator::execute()  // NOLINT (readability-function-size)
   ++_stats.instructions;
 
   Op decodedOp{};
+  uInt32 decodedArg = 0;
   if ((instructionPtr & 0xF0000000) == 0 && instructionPtr < romSize)
-    decodedOp = decodedRom[instructionPtr2];
+  {
+    const DecodedPage* page = decodedRom->pages[instructionPtr >> DECODED_PAGE_SHIFT]
+      .load(std::memory_order_acquire);
+    const DecodedPage& decoded = page ? *page
+      : decodeRomPage(instructionPtr >> DECODED_PAGE_SHIFT);
+    const uInt32 index = instructionPtr2 & (DECODED_PAGE_OPS - 1);
+
+    decodedOp = decoded.op[index];
+    decodedArg = decoded.param[index];
+  }
+  else if ((instructionPtr & 0xF0000000) == 0x40000000)
+  {
+    // Code running from RAM (e.g. copied there to avoid flash wait states)
+    const uInt32 ramPtr2 = (instructionPtr & RAMADDMASK) >> 1;
+
+    decodedOp = decodedRam[ramPtr2];
+    if(decodedOp == Op::numOps)
+    {
+      decodedOp = decodedRam[ramPtr2] =
+        decodeInstructionWord(inst, instructionPtr, decodedRamParam[ramPtr2]);
+      decodedRamIndices.push_back(static_cast<uInt16>(ramPtr2));
+    }
+    decodedArg = decodedRamParam[ramPtr2];
+  }
   else
-    decodedOp = decodeInstructionWord(CONV_RAMROM(rom[instructionPtr2]), instructionPtr);
+    decodedOp = decodeInstructionWord(inst, instructionPtr, decodedArg);
 
 #ifdef COUNT_OPS
   ++opCount[static_cast<int>(decodedOp)];
@@ -1343,70 +1482,70 @@ FORCE_INLINE int Thumbulator::execute()  // NOLINT (readability-function-size)
     case Op::beq: {
       THUMB_STAT(_stats.branches)
       if(!znFlags)
-        write_register(15, decodedParam[instructionPtr2]);
+        write_register(15, decodedArg);
       return 0;
     }
 
     case Op::bne: {
       THUMB_STAT(_stats.branches)
       if(znFlags)
-        write_register(15, decodedParam[instructionPtr2]);
+        write_register(15, decodedArg);
       return 0;
     }
 
     case Op::bcs: {
       THUMB_STAT(_stats.branches)
       if(cFlag)
-        write_register(15, decodedParam[instructionPtr2]);
+        write_register(15, decodedArg);
       return 0;
     }
 
     case Op::bcc: {
       THUMB_STAT(_stats.branches)
       if(!cFlag)
-        write_register(15, decodedParam[instructionPtr2]);
+        write_register(15, decodedArg);
       return 0;
     }
 
     case Op::bmi: {
       THUMB_STAT(_stats.branches)
       if(znFlags & 0x80000000)
-        write_register(15, decodedParam[instructionPtr2]);
+        write_register(15, decodedArg);
       return 0;
     }
 
     case Op::bpl: {
       THUMB_STAT(_stats.branches)
       if(!(znFlags & 0x80000000))
-        write_register(15, decodedParam[instructionPtr2]);
+        write_register(15, decodedArg);
       return 0;
     }
 
     case Op::bvs: {
       THUMB_STAT(_stats.branches)
       if(vFlag)
-        write_register(15, decodedParam[instructionPtr2]);
+        write_register(15, decodedArg);
       return 0;
     }
 
     case Op::bvc: {
       THUMB_STAT(_stats.branches)
       if(!vFlag)
-        write_register(15, decodedParam[instructionPtr2]);
+        write_register(15, decodedArg);
       return 0;
     }
 
     case Op::bhi: {
       THUMB_STAT(_stats.branches)
       if(cFlag && znFlags)
-        write_register(15, decodedParam[instructionPtr2]);
+        write_register(15, decodedArg);
       return 0;
     }
 
     case Op::bls: {
       THUMB_STAT(_stats.branches)
       if(!znFlags || !cFlag)
-        write_register(15, decodedParam[instructionPtr2]);
+        write_register(15, decodedArg);
       return 0;
     }
 
@@ -1414,7 +1553,7 @@ FORCE_INLINE int Thumbulator::execute()  // NOLINT (readability-function-size)
       THUMB_STAT(_stats.branches)
       if(((znFlags & 0x80000000) && vFlag) ||
          ((!(znFlags & 0x80000000)) && !vFlag))
-        write_register(15, decodedParam[instructionPtr2]);
+        write_register(15, decodedArg);
       return 0;
     }
 
@@ -1422,7 +1561,7 @@ FORCE_INLINE int Thumbulator::execute()  // NOLINT (readability-function-size)
       THUMB_STAT(_stats.branches)
       if((!(znFlags & 0x80000000) && vFlag) ||
          ( (znFlags & 0x80000000) && !vFlag))
-        write_register(15, decodedParam[instructionPtr2]);
+        write_register(15, decodedArg);
       return 0;
     }
 
@@ -1432,7 +1571,7 @@ FORCE_INLINE int Thumbulator::execute()  // NOLINT (readability-function-size)
       {
         if(((znFlags & 0x80000000) && vFlag) ||
            ((!(znFlags & 0x80000000)) && !vFlag))
-          write_register(15, decodedParam[instructionPtr2]);      }
+          write_register(15, decodedArg);      }
       return 0;
     }
 
@@ -1441,14 +1580,14 @@ FORCE_INLINE int Thumbulator::execute()  // NOLINT (readability-function-size)
       if(!znFlags ||
          (!(znFlags & 0x80000000) && vFlag) ||
          ( (znFlags & 0x80000000) && !vFlag))
-        write_register(15, decodedParam[instructionPtr2]);
+        write_register(15, decodedArg);
       return 0;
     }
 
     //B(2) unconditional branch
     case Op::b2: {
       THUMB_STAT(_stats.branches)
-      write_register(15, decodedParam[instructionPtr2]);
+      write_register(15, decodedArg);
       return 0;
     }
 
@@ -2865,6 +3004,9 @@ int Thumbulator::reset()
 #endif
 #ifdef THUMB_CYCLE_COUNT
   _totalCycles = 0;
+ #ifdef SKIP_TIMER_POLLS
+  _timerPoll = TimerPoll{};
+ #endif
  #ifdef EMULATE_PIPELINE
   _fetchPipeline = _memory0Pipeline = _memory1Pipeline = 0;
  #endif
@@ -3209,6 +3351,155 @@ void Thumbulator::incICycles(uInt32 m)
   _totalCycles += m;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Thumbulator::updateCycleModel()
+{
+  if(_approxCycles)
+    _totalCycles = static_cast<uInt32>(_stats.instructions * _cyclesPerInstruction);
+  else if(_allowApproxCycles && _countCycles && !_timerRead &&
+          _profiledRuns < CYCLE_PROFILE_RUNS)
+  {
+    _profiledCycles += _totalCycles;
+    _profiledInstructions += _stats.instructions;
+    if(++_profiledRuns == CYCLE_PROFILE_RUNS && _profiledInstructions != 0)
+    {
+      // No timer read so far, so the exact timing is most likely not
+      // observed by the ROM
+      _cyclesPerInstruction = static_cast<double>(_profiledCycles) / _profiledInstructions;
+      _approxCycles = true;
+      _countCycles = false;
+    }
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Thumbulator::timerRead()
+{
+  _timerRead = true;
+  if(_approxCycles)
+  {
+    // Revert to the exact model, starting with the estimate for this run
+    _totalCycles = static_cast<uInt32>(_stats.instructions * _cyclesPerInstruction);
+    _approxCycles = false;
+    _countCycles = true;
+  }
+}
+
+#ifdef SKIP_TIMER_POLLS
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Thumbulator::skipTimerPollLoop(uInt32 addr)
+{
+  // Called while executing the ldr, so the PC points two instructions ahead
+  const uInt32 loopPtr = reg_norm[15] - 4;
+  const bool sameLoop = loopPtr == _timerPoll.loopPtr && addr == _timerPoll.timerAddr
+    && _stats.instructions - _timerPoll.instructions == 3;
+  const uInt32 delta = _totalCycles - _timerPoll.cycles;
+
+  if(sameLoop && delta != 0 && delta == _timerPoll.delta && decodeTimerPollLoop(loopPtr))
+  {
+    const auto timerValue = [&](uInt32 cycles) -> uInt32 {
+      return static_cast<uInt32>(addr == 0xE0008008
+        ? T1TC + (tim1Total + (cycles - tim1Start)) * _armCyclesFactor
+        : T0TC + (tim0Total + (cycles - tim0Start)) * _armCyclesFactor);
+    };
+    // Find the first iteration which exits the loop, within the instruction
+    // limit of doRun() (else the loop is left running into the limit)
+    const uInt32 maxIterations = (500000 - std::min(_stats.instructions, 500000U)) / 3;
+
+    for(uInt32 i = 0; i < maxIterations; ++i)
+      if(!timerPollLoopContinues(timerValue(_totalCycles + i * delta)))
+      {
+        // The skipped iterations would have left everything but the
+        // cycles and the instruction count unchanged
+        _totalCycles += i * delta;
+        _stats.instructions += i * 3;
+        break;
+      }
+  }
+  _timerPoll.loopPtr = loopPtr;
+  _timerPoll.timerAddr = addr;
+  _timerPoll.delta = sameLoop ? delta : 0;
+  _timerPoll.cycles = _totalCycles;
+  _timerPoll.instructions = _stats.instructions;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool Thumbulator::decodeTimerPollLoop(uInt32 loopPtr)
+{
+  const auto instruction = [&](uInt32 addr) -> uInt32 {
+    if((addr & 0xF0000000) != 0)
+      return CONV_RAMROM(ram[(addr & RAMADDMASK) >> 1]);
+    return (addr & ROMADDMASK) < romSize
+      ? CONV_RAMROM(rom[(addr & ROMADDMASK) >> 1]) : 0;
+  };
+  uInt32 param = 0;
+
+  // ldr rd,[rn,#imm], which must not change its base register
+  const uInt32 ldr = instruction(loopPtr);
+  const uInt32 rd = ldr & 0x7;
+  if(decodeInstructionWord(ldr, loopPtr, param) != Op::ldr1 || ((ldr >> 3) & 0x7) == rd)
+    return false;
+
+  // cmp rd,#imm / cmp rd,rm / cmp rm,rd
+  const uInt32 cmp = instruction(loopPtr + 2);
+  _timerPoll.cmpOp = decodeInstructionWord(cmp, loopPtr + 2, param);
+  if(_timerPoll.cmpOp == Op::cmp1)
+  {
+    if(((cmp >> 8) & 0x7) != rd)
+      return false;
+    _timerPoll.operand = cmp & 0xFF;
+    _timerPoll.timerFirst = true;
+  }
+  else if(_timerPoll.cmpOp == Op::cmp2 || _timerPoll.cmpOp == Op::cmp3)
+  {
+    const uInt32 rn = _timerPoll.cmpOp == Op::cmp2
+      ? cmp & 0x7 : (cmp & 0x7) | ((cmp >> 4) & 0x8);
+    const uInt32 rm = (cmp >> 3) & (_timerPoll.cmpOp == Op::cmp2 ? 0x7 : 0xF);
+
+    if(rn == rm || rn == 15 || rm == 15 || (rn != rd && rm != rd))
+      return false;
+    _timerPoll.timerFirst = rn == rd;
+    _timerPoll.operand = reg_norm[_timerPoll.timerFirst ? rm : rn];
+  }
+  else
+    return false;
+
+  // b<cond> back to the ldr
+  _timerPoll.branchOp = decodeInstructionWord(instruction(loopPtr + 4), loopPtr + 4, param);
+  return _timerPoll.branchOp >= Op::beq && _timerPoll.branchOp <= Op::ble
+    && param == loopPtr + 2;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool Thumbulator::timerPollLoopContinues(uInt32 value) const
+{
+  // Evaluate the flags of the compare like do_znflags() and do_cvflag()
+  const uInt32 a = _timerPoll.timerFirst ? value : _timerPoll.operand;
+  const uInt32 b = _timerPoll.timerFirst ? _timerPoll.operand : value;
+  const uInt32 r = a - b;
+  const bool n = r >> 31, z = r == 0, c = a >= b, v = ((a ^ b) & (a ^ r)) >> 31;
+
+  switch(_timerPoll.branchOp)
+  {
+    case Op::beq: return z;
+    case Op::bne: return !z;
+    case Op::bcs: return c;
+    case Op::bcc: return !c;
+    case Op::bmi: return n;
+    case Op::bpl: return !n;
+    case Op::bvs: return v;
+    case Op::bvc: return !v;
+    case Op::bhi: return c && !z;
+    case Op::bls: return !c || z;
+    case Op::bge: return n == v;
+    case Op::blt: return n != v;
+    case Op::bgt: return !z && n == v;
+    case Op::ble: return z || n != v;
+    default:      return false;
+  }
+}
+#endif // SKIP_TIMER_POLLS
+
 #endif // THUMB_CYCLE_COUNT
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -26,6 +26,9 @@
 #define THUMBULATOR_HXX
 
 class Cartridge;
+class ArmProfiler;
+
+#include <atomic>
 
 #include "bspf.hxx"
 #include "Console.hxx"
@@ -39,6 +42,9 @@ class Cartridge;
 #ifdef THUMB_CYCLE_COUNT
   //#define EMULATE_PIPELINE  // enable coarse ARM pipeline emulation (TODO)
   #define TIMER_0           // enable timer 0 support (e.g. for measuring cycle count)
+  #ifndef THUMB_STATS
+    #define SKIP_TIMER_POLLS  // fast forward loops polling a timer (skews statistics)
+  #endif
 #endif
 
 class Thumbulator
@@ -99,7 +105,8 @@ class Thumbulator
                otherwise an empty string
     */
     string run(uInt32& cycles, bool irqDrivenAudio);
-    void enableCycleCount(bool enable) { _countCycles = enable; }
+    void enableCycleCount(bool enable);
+    void approximateCycles(bool enable);
     const Stats& stats() const { return _stats; }
     uInt32 cycles() const { return _totalCycles; }
     ChipPropsType setChipType(ChipType type = ChipType::AUTO);
@@ -136,6 +143,28 @@ class Thumbulator
     */
     void setConsoleTiming(ConsoleTiming timing);
 
+    /**
+      Share the decoded ROM code with all other emulators in this process
+      running the same ROM (see RomCache).
+
+      @param key  Identifies the ROM contents
+    */
+    void shareDecodedRom(const string& key);
+
+    /**
+      Inform the Thumbulator class that the ROM contents have been changed
+      (e.g. patched in the debugger), possibly at a new location.  Any code
+      decoded from the old contents is discarded.
+    */
+    void romChanged(const uInt16* rom_ptr);
+
+  #ifdef DEBUGGER_SUPPORT
+    /**
+      Attach a profiler, which samples the executed code (nullptr detaches).
+    */
+    void setProfiler(ArmProfiler* profiler) { _profiler = profiler; }
+  #endif
+
   private:
 
     enum class Op : uInt8 {
@@ -223,7 +252,11 @@ class Thumbulator
     void write32(uInt32 addr, uInt32 data);
     void updateTimer(uInt32 cycles);
 
-    Op decodeInstructionWord(uint16_t inst, uInt32 pc);
+    Op decodeInstructionWord(uint16_t inst, uInt32 pc, uInt32& param);
+    void invalidateDecodedRam();
+
+    struct DecodedPage;
+    const DecodedPage& decodeRomPage(uInt32 page);
 
     void do_cvflag(uInt32 a, uInt32 b, uInt32 c);
 
@@ -244,6 +277,15 @@ class Thumbulator
     void incSCycles(uInt32 addr, AccessType = AccessType::data);
     void incNCycles(uInt32 addr, AccessType = AccessType::data);
     void incICycles(uInt32 m = 1);
+  #endif
+  #ifdef THUMB_CYCLE_COUNT
+    void updateCycleModel();
+    void timerRead();
+  #endif
+  #ifdef SKIP_TIMER_POLLS
+    void skipTimerPollLoop(uInt32 addr);
+    bool decodeTimerPollLoop(uInt32 loopPtr);
+    bool timerPollLoopContinues(uInt32 value) const;
   #endif
     bool searchPattern(uInt32 pattern, uInt32 repeats = 1) const;
 
@@ -253,8 +295,36 @@ class Thumbulator
     uInt32 cBase{0};
     uInt32 cStart{0};
     uInt32 cStack{0};
-    const unique_ptr<Op[]> decodedRom;  // NOLINT
-    const unique_ptr<uInt32[]> decodedParam;  // NOLINT
+    // Decode cache for the ROM, filled one page at a time when code is
+    // first fetched from it (most of a large ROM is data or never executed).
+    // The cache may be shared by emulators running on different threads, so
+    // a decoded page is published atomically, and never changed afterwards.
+    static constexpr uInt32 DECODED_PAGE_SHIFT = 10;  // 1 KB
+    static constexpr uInt32 DECODED_PAGE_OPS = (1U << DECODED_PAGE_SHIFT) / 2;
+    struct DecodedPage {
+      std::array<Op, DECODED_PAGE_OPS> op{};
+      std::array<uInt32, DECODED_PAGE_OPS> param{};
+    };
+    struct DecodedRom {
+      explicit DecodedRom(uInt32 romSize)
+        : pages((romSize + (1U << DECODED_PAGE_SHIFT) - 1) >> DECODED_PAGE_SHIFT) { }
+      ~DecodedRom() {
+        for(auto& page: pages)
+          delete page.load();  // NOLINT: owned by the cache
+      }
+      vector<std::atomic<const DecodedPage*>> pages;
+
+      DecodedRom(const DecodedRom&) = delete;
+      DecodedRom(DecodedRom&&) = delete;
+      DecodedRom& operator=(const DecodedRom&) = delete;
+      DecodedRom& operator=(DecodedRom&&) = delete;
+    };
+    shared_ptr<DecodedRom> decodedRom;
+    // Lazily filled decode cache for code executed from RAM; 'Op::numOps'
+    // marks entries which still need to be decoded
+    const unique_ptr<Op[]> decodedRam;  // NOLINT
+    const unique_ptr<uInt32[]> decodedRamParam;  // NOLINT
+    vector<uInt16> decodedRamIndices;
     uInt16* ram{nullptr};
     std::array<uInt32, 16> reg_norm{}; // normal execution mode, do not have a thread mode
     uInt32 znFlags{0};
@@ -310,6 +380,37 @@ class Thumbulator
     uInt32 _branchBufferAddr[2]{0};
     uInt32 _dataBufferAddr{0};
   #endif
+  #ifdef THUMB_CYCLE_COUNT
+    // If enabled and no timer is read during the first CYCLE_PROFILE_RUNS
+    // runs, the cycles are afterwards estimated from the instruction count
+    // instead of modelling each access. The first timer read reverts to the
+    // exact model.
+    static constexpr uInt32 CYCLE_PROFILE_RUNS = 1000;
+    bool _allowApproxCycles{false};
+    bool _approxCycles{false};
+    bool _timerRead{false};
+    uInt32 _profiledRuns{0};
+    uInt64 _profiledCycles{0}, _profiledInstructions{0};
+    double _cyclesPerInstruction{0.0};
+  #endif
+  #ifdef SKIP_TIMER_POLLS
+    // The last timer read, to detect loops which only poll a timer:
+    //   ldr rd,[rn,#imm]; cmp rd,<op2> (or cmp <op2>,rd); b<cond> (back to ldr)
+    // Once two consecutive iterations took the same cycles, the loop is
+    // fast forwarded to the iteration which reads the exiting timer value.
+    struct TimerPoll {
+      uInt32 loopPtr{0};       // address of the ldr instruction
+      uInt32 timerAddr{0};     // address of the timer register read
+      uInt32 cycles{0};        // _totalCycles at the read
+      uInt32 instructions{0};  // _stats.instructions at the read
+      uInt32 delta{0};         // cycles per iteration, 0 if not yet steady
+      Op cmpOp{Op::invalid};   // decoded compare and branch of the loop
+      Op branchOp{Op::invalid};
+      uInt32 operand{0};       // the value the timer is compared with
+      bool timerFirst{true};   // timer is the first compare operand
+    };
+    TimerPoll _timerPoll;
+  #endif
   #ifdef COUNT_OPS
     uInt32 opCount[size_t(Op::numOps)]{0};
   #endif
@@ -318,6 +419,10 @@ class Thumbulator
 
     Cartridge* myCartridge{nullptr};
 
+  #ifdef DEBUGGER_SUPPORT
+    ArmProfiler* _profiler{nullptr};
+  #endif
+
     static constexpr uInt32
       ROMADDMASK = 0x7FFFF,
       RAMADDMASK = 0x7FFF,
@@ -0,0 +1,265 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2026 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+
+#include <thread>
+
+#include "Cart.hxx"
+#include "CartCreator.hxx"
+#include "DispatchResult.hxx"
+#include "FSNode.hxx"
+#include "HeadlessConsole.hxx"
+#include "MD5.hxx"
+#include "PaletteHandler.hxx"
+#include "Props.hxx"
+#include "PropsSet.hxx"
+#include "ScoreTracker.hxx"
+#include "VectorEnvironment.hxx"
+
+namespace {
+  uInt32 numThreads(const VectorEnvironment::Config& config)
+  {
+    const uInt32 jobs = config.jobs > 0
+      ? config.jobs : std::max(std::thread::hardware_concurrency(), 1U);
+
+    return std::clamp(jobs, 1U, std::max(config.numEnvs, 1U));
+  }
+} // namespace
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+VectorEnvironment::VectorEnvironment(const string& romFile, const Config& config)
+  : myConfig{config},
+    myPool{numThreads(config)}
+{
+  myConfig.numEnvs = std::max(myConfig.numEnvs, 1U);
+  myConfig.frameSkip = std::max(myConfig.frameSkip, 1U);
+  myConfig.obsHeight = std::clamp(myConfig.obsHeight, 1U,
+                                  TIAConstants::frameBufferHeight);
+
+  const FSNode imageFile(romFile);
+  ByteBuffer image;
+  const size_t size = imageFile.isFile() ? imageFile.read(image) : 0;
+  if(size == 0)
+    throw std::runtime_error("ERROR: unable to read " + romFile);
+
+  string md5 = MD5::hash(image, size);
+
+  // The score addresses are taken from the built-in properties
+  Properties props;
+  const PropertiesSet propSet;
+  propSet.getMD5(md5, props);
+
+  uInt32 numVariations = 0;
+  myHasScore = HighScoresManager::scoresProps(props, numVariations, myScoresProps);
+
+  myEnvs.reserve(myConfig.numEnvs);
+  for(uInt32 i = 0; i < myConfig.numEnvs; ++i)
+  {
+    auto& env = myEnvs.emplace_back(std::make_unique<Env>());
+    const string type = props.get(PropType::Cart_Type);
+    unique_ptr<Cartridge> cartridge = CartCreator::create(
+        imageFile, image, size, md5, type, env->settings);
+    if(!cartridge)
+      throw std::runtime_error("ERROR: unable to determine cartridge type");
+
+    env->console = std::make_unique<HeadlessConsole>(std::move(cartridge),
+                                                     env->settings, props);
+    env->console->detectLayout();
+    env->random.initSeed(myConfig.seed + i);
+
+    if(myHasScore)
+    {
+      HeadlessConsole& console = *env->console;
+      env->tracker = std::make_unique<ScoreTracker>(myScoresProps, numVariations);
+      env->tracker->attach(console.riot(), [&console](uInt16 addr) -> Int16 {
+        // Like HighScoresManager::peek(), but for the headless console
+        if(addr < 0x100U || console.cartridge().internalRamSize() == 0)
+          return console.system().peekOob(addr);
+        else
+          return console.cartridge().internalRamGetValue(addr);
+      });
+    }
+
+    if(myConfig.preprocess)
+    {
+      env->processor = std::make_unique<ObservationProcessor>(myConfig.observation);
+      // The headless consoles always use NTSC timing
+      env->processor->setPalette(PaletteHandler::standardPalette(ConsoleTiming::ntsc));
+    }
+  }
+
+  myObservationSize = myConfig.preprocess
+    ? myEnvs.front()->processor->observationSize()
+    : static_cast<size_t>(TIAConstants::H_PIXEL) * myConfig.obsHeight;
+  myObservations.resize(myObservationSize * myConfig.numEnvs);
+  myRewards.resize(myConfig.numEnvs);
+  myDones.resize(myConfig.numEnvs);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+VectorEnvironment::~VectorEnvironment() = default;
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void VectorEnvironment::reset()
+{
+  myPool.run(numEnvs(), [this](uInt32 index, uInt32) {
+    resetEnv(index);
+    myRewards[index] = 0;
+    myDones[index] = false;
+  });
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void VectorEnvironment::step(const vector<Action>& actions)
+{
+  if(actions.size() != myEnvs.size())
+    throw std::invalid_argument("ERROR: one action per console required");
+
+  myPool.run(numEnvs(), [this, &actions](uInt32 index, uInt32) {
+    stepEnv(index, actions[index]);
+  });
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void VectorEnvironment::resetEnv(uInt32 index)
+{
+  Env& env = *myEnvs[index];
+  HeadlessConsole& console = *env.console;
+
+  console.system().reset();
+  env.episodeFrames = 0;
+
+  // Let the game settle, then press RESET to start it
+  for(uInt32 i = 0; i < 60; ++i)
+    runFrame(env, Action::Noop);
+  console.event().set(Event::ConsoleReset, 1);
+  for(uInt32 i = 0; i < 4; ++i)
+    runFrame(env, Action::Noop);
+  console.event().set(Event::ConsoleReset, 0);
+
+  // Random no-ops, so that the episodes differ
+  const uInt32 noops = myConfig.noopMax > 0
+    ? env.random.next() % (myConfig.noopMax + 1) : 0;
+  for(uInt32 i = 0; i < noops; ++i)
+    runFrame(env, Action::Noop);
+
+  env.episodeFrames = 0;
+  env.score = 0;
+  if(env.tracker)
+  {
+    env.tracker->update();
+    env.score = env.tracker->score();
+  }
+  if(env.processor)
+    env.processor->reset();
+  storeObservation(index);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void VectorEnvironment::stepEnv(uInt32 index, Action action)
+{
+  Env& env = *myEnvs[index];
+  bool ok = true;
+
+  // The second to last frame is max-pooled with the last one
+  for(uInt32 i = 0; i < myConfig.frameSkip && ok; ++i)
+    ok = runFrame(env, action, i + 2 == myConfig.frameSkip);
+
+  // Only changed scores are decoded, invalid ones (e.g. BCD scores while
+  // they are updated) are kept pending by the tracker
+  Int32 reward = 0;
+  if(env.tracker && env.tracker->update() &&
+     env.tracker->score() != HSM::NO_VALUE)
+  {
+    reward = env.tracker->score() - env.score;
+    if(myScoresProps.scoreInvert)
+      reward = -reward;
+    env.score = env.tracker->score();
+  }
+  myRewards[index] = reward;
+
+  const bool done = !ok || env.episodeFrames >= myConfig.maxEpisodeFrames;
+  myDones[index] = done;
+
+  if(done)
+    resetEnv(index);
+  else
+    storeObservation(index);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool VectorEnvironment::runFrame(Env& env, Action action, bool pool)
+{
+  HeadlessConsole& console = *env.console;
+  TIA& tia = console.tia();
+  DispatchResult result;
+
+  setAction(env, action);
+  console.riot().update();
+
+  do
+    tia.update(result);
+  while(!tia.newFramePending() &&
+        result.getStatus() == DispatchResult::Status::ok);
+  tia.renderToFrameBuffer();
+  ++env.episodeFrames;
+
+  if(pool && env.processor)
+    env.processor->addFrame(tia.frameBuffer(), tia.frameBufferScanlinesLastFrame());
+
+  return result.getStatus() == DispatchResult::Status::ok;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void VectorEnvironment::setAction(Env& env, Action action)
+{
+  // Directions and fire of each action, in the order of the Action enum
+  static constexpr std::array<uInt8, static_cast<size_t>(Action::NumActions)> bits = {
+    0x00, 0x10, 0x01, 0x08, 0x04, 0x02, 0x09, 0x05, 0x0a,
+    0x06, 0x11, 0x18, 0x14, 0x12, 0x19, 0x15, 0x1a, 0x16
+  };
+  const auto index = static_cast<size_t>(action);
+  const uInt8 input = index < bits.size() ? bits[index] : 0;
+  Event& event = env.console->event();
+
+  event.set(Event::LeftJoystickUp,    (input & 0x01) ? 1 : 0);
+  event.set(Event::LeftJoystickDown,  (input & 0x02) ? 1 : 0);
+  event.set(Event::LeftJoystickLeft,  (input & 0x04) ? 1 : 0);
+  event.set(Event::LeftJoystickRight, (input & 0x08) ? 1 : 0);
+  event.set(Event::LeftJoystickFire,  (input & 0x10) ? 1 : 0);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void VectorEnvironment::storeObservation(uInt32 index)
+{
+  Env& env = *myEnvs[index];
+  TIA& tia = env.console->tia();
+  uInt8* dst = myObservations.data() + myObservationSize * index;
+
+  if(env.processor)
+  {
+    env.processor->process(tia.frameBuffer(), tia.frameBufferScanlinesLastFrame(), dst);
+    return;
+  }
+
+  const size_t lines = std::min(tia.frameBufferScanlinesLastFrame(),
+                                myConfig.obsHeight);
+  const size_t bytes = lines * TIAConstants::H_PIXEL;
+
+  std::copy_n(tia.frameBuffer(), bytes, dst);
+  std::fill_n(dst + bytes, myObservationSize - bytes, 0);
+}
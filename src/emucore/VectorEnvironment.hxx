@@ -0,0 +1,151 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2026 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+
+#ifndef VECTOR_ENVIRONMENT_HXX
+#define VECTOR_ENVIRONMENT_HXX
+
+class HeadlessConsole;
+class ScoreTracker;
+
+#include "bspf.hxx"
+#include "HighScoresManager.hxx"
+#include "ObservationProcessor.hxx"
+#include "Random.hxx"
+#include "Settings.hxx"
+#include "ThreadPool.hxx"
+
+/**
+  A vectorized environment for reinforcement learning: a batch of headless
+  consoles running the same ROM, which are stepped in lockstep with one
+  action per console.  The consoles are spread across a thread pool, and
+  neither an OSystem, nor SDL is required.
+
+  After each step, the observations (the palette indices of the last frame
+  of each console, stacked), the rewards and the done flags can be fetched.
+  Optionally, the frames are preprocessed (grayscale, downscaled, max-pooled
+  over the last two frames and stacked) by an ObservationProcessor.
+  Rewards are the change of the score during the step, as defined by the
+  ROM's high score properties (see HighScoresManager) and followed by a
+  ScoreTracker; ROMs without score addresses always have a reward of 0.  Since there is no generic way to
+  detect the end of a game, an episode is done after a maximum number of
+  frames or when the emulation fails.  Consoles which are done are reset
+  automatically, their observation then is the first one of the new episode.
+
+  Episodes start like in the Arcade Learning Environment: the console is
+  reset, RESET is pressed, and then a random number of no-op frames is run.
+
+  @author  Stella Team
+*/
+class VectorEnvironment
+{
+  public:
+    // The full action set of a joystick, in the order used by the ALE
+    enum class Action: uInt8 {
+      Noop, Fire, Up, Right, Left, Down, UpRight, UpLeft, DownRight,
+      DownLeft, UpFire, RightFire, LeftFire, DownFire, UpRightFire,
+      UpLeftFire, DownRightFire, DownLeftFire,
+      NumActions
+    };
+
+    struct Config {
+      uInt32 numEnvs{8};
+      uInt32 jobs{0};                 // number of threads (0 = all cores)
+      uInt32 frameSkip{4};            // frames per step, the action is repeated
+      uInt32 maxEpisodeFrames{108000};
+      uInt32 noopMax{30};             // random no-op frames at episode start
+      uInt32 obsHeight{210};          // scanlines per raw observation
+      uInt32 seed{0};
+      bool preprocess{false};         // use the ObservationProcessor
+      ObservationProcessor::Config observation;
+    };
+
+  public:
+    /**
+      Create the consoles; throws a runtime_error if the ROM can't be loaded.
+    */
+    VectorEnvironment(const string& romFile, const Config& config);
+    ~VectorEnvironment();
+
+    uInt32 numEnvs() const { return static_cast<uInt32>(myEnvs.size()); }
+
+    // Bytes per observation of one console (TIA pixels * scanlines, or the
+    // size of a preprocessed observation)
+    size_t observationSize() const { return myObservationSize; }
+
+    // Whether the ROM defines score addresses, so that rewards are available
+    bool hasScore() const { return myHasScore; }
+
+    /**
+      Start a new episode on all consoles.
+    */
+    void reset();
+
+    /**
+      Step all consoles by 'frameSkip' frames, using one action per console.
+    */
+    void step(const vector<Action>& actions);
+
+    // The results of the last step() or reset()
+    const ByteArray& observations() const { return myObservations; }
+    const vector<Int32>& rewards() const { return myRewards; }
+    const vector<uInt8>& dones() const { return myDones; }
+
+  private:
+    // One console and its episode, only accessed by one thread at a time
+    struct Env {
+      Settings settings;  // Settings are not thread-safe
+      unique_ptr<HeadlessConsole> console;
+      unique_ptr<ScoreTracker> tracker;  // if the ROM defines a score
+      unique_ptr<ObservationProcessor> processor;
+      Random random{0};
+      Int32 score{0};
+      uInt32 episodeFrames{0};
+    };
+
+  private:
+    void resetEnv(uInt32 index);
+    void stepEnv(uInt32 index, Action action);
+
+    bool runFrame(Env& env, Action action, bool pool = false);
+    void setAction(Env& env, Action action);
+    void storeObservation(uInt32 index);
+
+  private:
+    Config myConfig;
+
+    vector<unique_ptr<Env>> myEnvs;
+    ThreadPool myPool;
+
+    bool myHasScore{false};
+    HSM::ScoresProps myScoresProps;
+
+    size_t myObservationSize{0};
+    ByteArray myObservations;
+    vector<Int32> myRewards;
+    vector<uInt8> myDones;  // not vector<bool>, written by several threads
+
+  private:
+    // Following constructors and assignment operators not supported
+    VectorEnvironment() = delete;
+    VectorEnvironment(const VectorEnvironment&) = delete;
+    VectorEnvironment(VectorEnvironment&&) = delete;
+    VectorEnvironment& operator=(const VectorEnvironment&) = delete;
+    VectorEnvironment& operator=(VectorEnvironment&&) = delete;
+};
+
+#endif
@@ -61,6 +61,7 @@ BusTransactionQueue& BusTransactionQueue::reset()
   myQueueNext = myQueueSize = 0;
   myNextInjectAddress = 0;
   myTimestamp = 0;
+  updateNextTimestamp();
 
   return *this;
 }
@@ -98,6 +99,8 @@ bool BusTransactionQueue::load(Serializer& in)
 
     for (size_t i = 0; i < myQueueSize; i++)
       myQueue[i].deserialize(in);
+
+    updateNextTimestamp();
   }
   catch(...) {
     cerr << "ERROR: failed to load bus transaction queue\n";
@@ -201,6 +204,7 @@ BusTransactionQueue::Transaction* BusTransactionQueue::getNextTransaction(uInt16
 
   myQueueNext = (myQueueNext + 1) % myQueueCapacity;
   myQueueSize--;
+  updateNextTimestamp();
 
   return nextTransaction;
 }
@@ -219,6 +223,8 @@ void BusTransactionQueue::push(const Transaction& transaction)
 
     if (lastTransaction.address == transaction.address) {
       lastTransaction = transaction;
+      if (myQueueSize == 1) updateNextTimestamp();
+
       return;
     }
   }
@@ -227,4 +233,13 @@ void BusTransactionQueue::push(const Transaction& transaction)
     throw FatalEmulationError("read stream overflow");
 
   myQueue[(myQueueNext + myQueueSize++) % myQueueCapacity] = transaction;
+  if (myQueueSize == 1) updateNextTimestamp();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void BusTransactionQueue::updateNextTimestamp()
+{
+  myNextTimestamp = myQueueSize > 0
+    ? myQueue[myQueueNext].timestamp
+    : std::numeric_limits<uInt64>::max();
 }
@@ -18,6 +18,8 @@
 #ifndef BUS_TRANSACTION_QUEUE
 #define BUS_TRANSACTION_QUEUE
 
+#include <limits>
+
 #include "Serializable.hxx"
 #include "bspf.hxx"
 
@@ -61,6 +63,16 @@ class BusTransactionQueue: public Serializable {
     BusTransactionQueue& yield(uInt16 address, uInt16 mask = 0xffff);
 
     bool hasPendingTransaction() const;
+
+    /**
+      Fast check whether the head of the queue is due at the given timestamp.
+      If this returns false, getNextTransaction is guaranteed to return
+      nullptr, so the caller can skip the queue entirely.
+    */
+    bool hasTransactionDue(uInt64 timestamp) const {
+      return timestamp >= myNextTimestamp;
+    }
+
     Transaction* getNextTransaction(uInt16 address, uInt64 timestamp);
     Transaction* peekNextTransaction();
 
@@ -70,6 +82,7 @@ class BusTransactionQueue: public Serializable {
 
   private:
     void push(const Transaction& transaction);
+    void updateNextTimestamp();
 
   private:
     const size_t myQueueCapacity{0};
@@ -78,6 +91,10 @@ class BusTransactionQueue: public Serializable {
     size_t myQueueNext{0};
     size_t myQueueSize{0};
 
+    // Timestamp of the transaction at the head of the queue, or the maximum
+    // value if the queue is empty
+    uInt64 myNextTimestamp{std::numeric_limits<uInt64>::max()};
+
     uInt16 myNextInjectAddress{0};
     uInt64 myTimestamp{0};
 
@@ -73,6 +73,7 @@ void ElfLinker::link(const vector<ExternalSymbol>& externalSymbols)
   myDataData.reset();
   myRodataData.reset();
   myRelocatedSections.resize(0);
+  myLinkedExternalSymbols.reset();
 
   relocateSections();
 
@@ -82,6 +83,11 @@ void ElfLinker::link(const vector<ExternalSymbol>& externalSymbols)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void ElfLinker::relink(const vector<ExternalSymbol>& externalSymbols)
 {
+  // The segment data is never modified outside of linking, so nothing
+  // needs to be done if the external symbols did not change
+  if (myLinkedExternalSymbols == externalSymbols) return;
+
+  myLinkedExternalSymbols.reset();
   myRelocatedSymbols.resize(0);
   myInitArray.resize(0);
   myPreinitArray.resize(0);
@@ -90,6 +96,8 @@ void ElfLinker::relink(const vector<ExternalSymbol>& externalSymbols)
   relocateSymbols(externalSymbols);
   relocateInitArrays();
   applyRelocationsToSections();
+
+  myLinkedExternalSymbols = externalSymbols;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -76,6 +76,8 @@ class ElfLinker {
     struct ExternalSymbol {
       string name;
       uInt32 value{0};
+
+      bool operator==(const ExternalSymbol&) const = default;
     };
 
   public:
@@ -84,6 +86,12 @@ class ElfLinker {
 
     ElfLinker& setUndefinedSymbolDefault(uInt32 defaultValue);
     void link(const vector<ExternalSymbol>& externalSymbols);
+
+    /**
+      Relink against the given external symbols.  The segments are only
+      recreated if the symbols differ from the ones used in the last link;
+      otherwise the linked image is already up to date and this is a no-op.
+    */
     void relink(const vector<ExternalSymbol>& externalSymbols);
 
     uInt32 getSegmentSize(SegmentType type) const;
@@ -149,6 +157,9 @@ class ElfLinker {
     vector<uInt32> myInitArray;
     vector<uInt32> myPreinitArray;
 
+    // The external symbols the current image was linked against
+    std::optional<vector<ExternalSymbol>> myLinkedExternalSymbols;
+
   private:
     ElfLinker(const ElfLinker&) = delete;
     ElfLinker(ElfLinker&&) = delete;
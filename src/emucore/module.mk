@@ -1,7 +1,9 @@
 MODULE := src/emucore
 
 MODULE_OBJS := \
+	src/emucore/ArmProfiler.o \
 	src/emucore/AtariVox.o \
+	src/emucore/BatchConsole.o \
 	src/emucore/Booster.o \
 	src/emucore/Cart.o \
 	src/emucore/CartARM.o \
@@ -73,6 +75,7 @@ MODULE_OBJS := \
 	src/emucore/FSNode.o \
 	src/emucore/Genesis.o \
 	src/emucore/GlobalKeyHandler.o \
+	src/emucore/HeadlessConsole.o \
 	src/emucore/Joy2BPlus.o \
 	src/emucore/Joystick.o \
 	src/emucore/Keyboard.o \
@@ -85,19 +88,25 @@ MODULE_OBJS := \
 	src/emucore/OSystem.o \
 	src/emucore/OSystemStandalone.o \
 	src/emucore/Paddles.o \
+	src/emucore/PageSnapshot.o \
 	src/emucore/PlusROM.o \
 	src/emucore/PointingDevice.o \
 	src/emucore/ProfilingRunner.o \
+	src/emucore/RegressionRunner.o \
 	src/emucore/Props.o \
 	src/emucore/PropsSet.o \
 	src/emucore/QuadTari.o \
+	src/emucore/RomCache.o \
+	src/emucore/RomPrefetcher.o \
 	src/emucore/SaveKey.o \
 	src/emucore/Serializer.o \
+	src/emucore/SerialPortAsync.o \
 	src/emucore/Settings.o \
 	src/emucore/Switches.o \
 	src/emucore/System.o \
 	src/emucore/TIASurface.o \
-	src/emucore/Thumbulator.o
+	src/emucore/Thumbulator.o \
+	src/emucore/VectorEnvironment.o
 
 MODULE_TEST_OBJS =
 
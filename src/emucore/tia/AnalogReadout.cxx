@@ -16,6 +16,7 @@
 //============================================================================
 
 #include <cmath>
+#include <limits>
 
 #include "AnalogReadout.hxx"
 
@@ -35,6 +36,7 @@ void AnalogReadout::reset(uInt64 timestamp)
   myTimestamp = timestamp;
 
   setConsoleTiming(ConsoleTiming::ntsc);
+  updateTripPoint();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -51,14 +53,15 @@ void AnalogReadout::vblank(uInt8 value, uInt64 timestamp)
   }
 
   myTimestamp = timestamp;
+  updateTripPoint();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 uInt8 AnalogReadout::inpt(uInt64 timestamp)
 {
-  updateCharge(timestamp);
-
-  const bool state = myIsDumped ? false : myU > myUThresh;
+  // The charge itself is only evaluated when the connection changes
+  const double elapsed = static_cast<double>(timestamp - myTimestamp);
+  const bool state = myTripRising ? elapsed > myTripPoint : elapsed < myTripPoint;
 
   return state ? 0x80 : 0;
 }
@@ -67,15 +70,21 @@ uInt8 AnalogReadout::inpt(uInt64 timestamp)
 void AnalogReadout::update(Connection connection, uInt64 timestamp,
                            ConsoleTiming consoleTiming)
 {
+  bool changed = false;
+
   if (consoleTiming != myConsoleTiming) {
     setConsoleTiming(consoleTiming);
+    changed = true;
   }
 
   if (connection != myConnection) {
     updateCharge(timestamp);
 
     myConnection = connection;
+    changed = true;
   }
+
+  if (changed) updateTripPoint();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -116,6 +125,43 @@ void AnalogReadout::updateCharge(uInt64 timestamp)
   myTimestamp = timestamp;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void AnalogReadout::updateTripPoint()
+{
+  // Solve the charge curves of updateCharge() for myU == myUThresh;
+  // log() of 0 yields -inf, so that a readout that can't change anymore
+  // never (or always) trips
+  if (myIsDumped) {
+    myTripRising = false;
+    myTripPoint = -std::numeric_limits<double>::infinity();
+    return;
+  }
+
+  const double tau = (myConnection.resistance + R0) * C * myClockFreq;
+
+  switch (myConnection.type) {
+    case ConnectionType::vcc:
+      myTripRising = true;
+      myTripPoint = tau * log((U_SUPP - myU) / (U_SUPP - myUThresh));
+      break;
+
+    case ConnectionType::ground:
+      myTripRising = false;
+      myTripPoint = tau * log(myU / myUThresh);
+      break;
+
+    case ConnectionType::disconnected:
+      myTripRising = false;
+      myTripPoint = myU > myUThresh
+        ? std::numeric_limits<double>::infinity()
+        : -std::numeric_limits<double>::infinity();
+      break;
+
+    default:
+      throw std::runtime_error("unreachable");
+  }
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool AnalogReadout::save(Serializer& out) const
 {
@@ -156,6 +202,8 @@ bool AnalogReadout::load(Serializer& in)
     myClockFreq = in.getDouble();
 
     myIsDumped = in.getBool();
+
+    updateTripPoint();
   }
   catch(...)
   {
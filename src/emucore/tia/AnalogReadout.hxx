@@ -80,6 +80,12 @@ class AnalogReadout : public Serializable
 
     void updateCharge(uInt64 timestamp);
 
+    /**
+      Calculate when the charge crosses the threshold under the current
+      connection, so that inpt() only compares timestamps.
+    */
+    void updateTripPoint();
+
   private:
 
     double myUThresh{0.0};
@@ -93,6 +99,11 @@ class AnalogReadout : public Serializable
 
     bool myIsDumped{false};
 
+    // The readout is high for (timestamp - myTimestamp) above (rising) or
+    // below (falling) myTripPoint, in clocks; derived from the state above
+    double myTripPoint{0.0};
+    bool myTripRising{false};
+
     static constexpr double
       R0 = 1.8e3,
       C = 68e-9,
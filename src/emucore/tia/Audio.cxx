@@ -64,6 +64,50 @@ void Audio::setAudioQueue(const shared_ptr<AudioQueue>& queue)
   mySampleIndex = 0;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Audio::tick(uInt32 clocks)
+{
+  while(clocks > 0)
+  {
+    // The channels are clocked at fixed positions of the scanline
+    // (phase0 at 9 and 81, phase1 at 37 and 149).  Until then, only the
+    // (constant) volumes are accumulated.
+    const uInt8 nextPhase = myCounter <= 9 ? 9 : myCounter <= 37 ? 37
+                          : myCounter <= 81 ? 81 : myCounter <= 149 ? 149
+                          : 228 + 9;
+    const uInt32 run = std::min<uInt32>(clocks, nextPhase - myCounter + 1);
+
+    // Volume for each channel is sampled every color clock. the average of
+    // these samples will be taken twice a scanline in the phase1() function
+    mySumChannel0 += static_cast<uInt32>(myChannel0.actualVolume()) * run;
+    mySumChannel1 += static_cast<uInt32>(myChannel1.actualVolume()) * run;
+    mySumCt += run;
+
+    const uInt32 counter = myCounter + run - 1;
+    myCounter = static_cast<uInt8>((myCounter + run) % 228);
+    clocks -= run;
+
+    switch(counter % 228)
+    {
+      case 9:
+      case 81:
+        myChannel0.phase0();
+        myChannel1.phase0();
+        break;
+
+      case 37:
+      case 149:
+        myChannel0.phase1();
+        myChannel1.phase1();
+        createSample();
+        break;
+
+      default:
+        break;
+    }
+  }
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void Audio::createSample()
 {
@@ -73,7 +117,11 @@ void Audio::createSample()
   const auto sample1 = static_cast<uInt8>(mySumChannel1 / mySumCt);
   mySumChannel0 = mySumChannel1 = mySumCt = 0;
 
+  if(mySuspended) return;
+
   addSample(sample0, sample1);
+  if(myCapturedSamples)
+    myCapturedSamples->push_back(sample0 | (sample1 << 4));
 #ifdef GUI_SUPPORT
   if(myRewindMode)
     mySamples.push_back(sample0 | (sample1 << 4));
@@ -126,7 +174,8 @@ bool Audio::save(Serializer& out) const
     //out.putInt(mySampleIndex);
     //out.putShortArray((uInt16*)myCurrentFragment, myAudioQueue->fragmentSize());
 
-    mySamples.clear();
+    if(!mySuspended)
+      mySamples.clear();
   #endif
   }
   catch(...)
@@ -160,14 +209,20 @@ bool Audio::load(Serializer& in)
     //mySampleIndex = in.getInt();
     //in.getShortArray((uInt16*)myCurrentFragment, myAudioQueue->fragmentSize());
 
-    // Feed all loaded samples into the audio queue
-    for(size_t i = 0; i < sampleSize; i++)
+    // While suspended, the samples are kept for the next regular save
+    if(mySuspended)
+      mySamples = std::move(samples);
+    else
     {
-      const uInt8 sample = samples[i];
-      const uInt8 sample0 = sample & 0x0f;
-      const uInt8 sample1 = sample >> 4;
-
-      addSample(sample0, sample1);
+      // Feed all loaded samples into the audio queue
+      for(size_t i = 0; i < sampleSize; i++)
+      {
+        const uInt8 sample = samples[i];
+        const uInt8 sample0 = sample & 0x0f;
+        const uInt8 sample1 = sample >> 4;
+
+        addSample(sample0, sample1);
+      }
     }
   #endif
   }
@@ -45,7 +45,30 @@ class Audio : public Serializable
     #endif
     }
 
-    FORCE_INLINE void tick();
+    /**
+      Enable/disable audio output. While suspended, no samples are pushed
+      to the queue or recorded, and the recorded samples survive a
+      save/load cycle. This is used while speculatively emulating frames
+      (run-ahead), which must not be heard.
+    */
+    void setAudioSuspended(bool suspend) { mySuspended = suspend; }
+
+    /**
+      Set the buffer which receives the audible samples for recording
+      (packed like the rewind samples), or nullptr to stop capturing.
+    */
+    void setAudioCapture(ByteArray* samples) { myCapturedSamples = samples; }
+
+    /**
+      Advance the audio by the given number of color clocks.  The audio
+      registers cannot change during this time (writes to them take effect
+      immediately and are never delayed), so the clocks are processed in
+      batches up to the next phase of the channels, during which the channel
+      outputs are constant.
+
+      @param clocks  The number of color clocks to advance
+    */
+    void tick(uInt32 clocks);
 
     AudioChannel& channel0() { return myChannel0; }
 
@@ -78,6 +101,8 @@ class Audio : public Serializable
 
     Int16* myCurrentFragment{nullptr};
     uInt32 mySampleIndex{0};
+    bool mySuspended{false};
+    ByteArray* myCapturedSamples{nullptr};
   #ifdef GUI_SUPPORT
     bool myRewindMode{false};
     mutable ByteArray mySamples;
@@ -90,38 +115,4 @@ class Audio : public Serializable
     Audio& operator=(Audio&&) = delete;
 };
 
-// ############################################################################
-// Implementation
-// ############################################################################
-
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void Audio::tick()
-{
-  // Volume for each channel is sampled every color clock. the average of
-  // these samples will be taken twice a scanline in the phase1() function
-  mySumChannel0 += static_cast<uInt32>(myChannel0.actualVolume());
-  mySumChannel1 += static_cast<uInt32>(myChannel1.actualVolume());
-  mySumCt++;
-
-  switch (myCounter) {
-    case 9:
-    case 81:
-      myChannel0.phase0();
-      myChannel1.phase0();
-      break;
-
-    case 37:
-    case 149:
-      myChannel0.phase1();
-      myChannel1.phase1();
-	  createSample();
-      break;
-
-    default:
-      break;
-  }
-
-  if (++myCounter == 228) myCounter = 0;
-}
-
 #endif // TIA_AUDIO_HXX
@@ -17,6 +17,114 @@
 
 #include "AudioChannel.hxx"
 
+namespace {
+  // The poly4 (pulse) and poly5 (noise) counters only depend on themselves
+  // and AUDC, so all their decisions are precomputed for every possible
+  // state.
+
+  // Bits of the noise table entries
+  constexpr uInt8 HOLD = 0x01, FEEDBACK = 0x02;
+
+  // Pulse counter hold and noise feedback, indexed by AUDC, pulse and
+  // noise counter
+  using NoiseTable = std::array<std::array<std::array<uInt8, 32>, 16>, 16>;
+
+  constexpr NoiseTable createNoiseTable()
+  {
+    NoiseTable table{};
+
+    for (uInt8 audc = 0; audc < 16; ++audc)
+      for (uInt8 pulse = 0; pulse < 16; ++pulse)
+        for (uInt8 noise = 0; noise < 32; ++noise) {
+          bool hold = false, feedback = false;
+
+          switch (audc & 0x03) {
+            case 0x00:
+            case 0x01:
+              hold = false;
+              break;
+
+            case 0x02:
+              hold = (noise & 0x1e) != 0x02;
+              break;
+
+            case 0x03:
+              hold = !(noise & 0x01);
+              break;
+
+            default:  // not possible, but silence the compiler
+              break;
+          }
+
+          switch (audc & 0x03) {
+            case 0x00:
+              feedback =
+                ((pulse ^ noise) & 0x01) ||
+                !(noise || (pulse != 0x0a)) ||
+                !(audc & 0x0c);
+              break;
+
+            default:
+              feedback =
+                (((noise & 0x04) ? 1 : 0) ^ (noise & 0x01)) ||
+                noise == 0;
+              break;
+          }
+
+          table[audc][pulse][noise] = (hold ? HOLD : 0) | (feedback ? FEEDBACK : 0);
+        }
+
+    return table;
+  }
+
+  // The next (not held) pulse counter, indexed by AUDC, noise counter bit 4
+  // and pulse counter
+  using PulseTable = std::array<std::array<std::array<uInt8, 16>, 2>, 16>;
+
+  constexpr PulseTable createPulseTable()
+  {
+    PulseTable table{};
+
+    for (uInt8 audc = 0; audc < 16; ++audc)
+      for (uInt8 bit4 = 0; bit4 < 2; ++bit4)
+        for (uInt8 pulse = 0; pulse < 16; ++pulse) {
+          bool feedback = false;
+
+          switch (audc >> 2) {
+            case 0x00:
+              feedback =
+                (((pulse & 0x02) ? 1 : 0) ^ (pulse & 0x01)) &&
+                (pulse != 0x0a) &&
+                (audc & 0x03);
+              break;
+
+            case 0x01:
+              feedback = !(pulse & 0x08);
+              break;
+
+            case 0x02:
+              feedback = !bit4;
+              break;
+
+            case 0x03:
+              feedback = !((pulse & 0x02) || !(pulse & 0x0e));
+              break;
+
+            default:
+              break;
+          }
+
+          table[audc][bit4][pulse] =
+            (~(pulse >> 1) & 0x07) | (feedback ? 0x08 : 0);
+        }
+
+    return table;
+  }
+
+  constexpr NoiseTable NOISE_TABLE = createNoiseTable();
+  constexpr PulseTable PULSE_TABLE = createPulseTable();
+} // namespace
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void AudioChannel::reset()
 {
@@ -29,42 +137,11 @@ void AudioChannel::reset()
 void AudioChannel::phase0()
 {
   if (myClockEnable) {
-    myNoiseCounterBit4 = myNoiseCounter & 0x01;
-
-    switch (myAudc & 0x03) {
-      case 0x00:
-      case 0x01:
-        myPulseCounterHold = false;
-        break;
+    const uInt8 next = NOISE_TABLE[myAudc][myPulseCounter & 0x0f][myNoiseCounter & 0x1f];
 
-      case 0x02:
-        myPulseCounterHold = (myNoiseCounter & 0x1e) != 0x02;
-        break;
-
-      case 0x03:
-        myPulseCounterHold = !myNoiseCounterBit4;
-        break;
-
-      default:  // not possible, but silence the compiler
-        break;
-    }
-
-    switch (myAudc & 0x03) {
-      case 0x00:
-        myNoiseFeedback =
-          ((myPulseCounter ^ myNoiseCounter) & 0x01) ||
-          !(myNoiseCounter || (myPulseCounter != 0x0a)) ||
-          !(myAudc & 0x0c);
-
-        break;
-
-      default:
-        myNoiseFeedback =
-          (((myNoiseCounter & 0x04) ? 1 : 0) ^ (myNoiseCounter & 0x01)) ||
-          myNoiseCounter == 0;
-
-      break;
-    }
+    myNoiseCounterBit4 = myNoiseCounter & 0x01;
+    myPulseCounterHold = next & HOLD;
+    myNoiseFeedback = next & FEEDBACK;
   }
 
   myClockEnable = myDivCounter == myAudf;
@@ -80,42 +157,14 @@ void AudioChannel::phase0()
 void AudioChannel::phase1()
 {
   if (myClockEnable) {
-    bool pulseFeedback = false;
-    switch (myAudc >> 2) {
-      case 0x00:
-        pulseFeedback =
-          (((myPulseCounter & 0x02) ? 1 : 0) ^ (myPulseCounter & 0x01)) &&
-          (myPulseCounter != 0x0a) &&
-          (myAudc & 0x03);
-        break;
-
-      case 0x01:
-        pulseFeedback = !(myPulseCounter & 0x08);
-        break;
-
-      case 0x02:
-        pulseFeedback = !myNoiseCounterBit4;
-        break;
-
-      case 0x03:
-        pulseFeedback = !((myPulseCounter & 0x02) || !(myPulseCounter & 0x0e));
-        break;
-
-      default:
-        break;
-    }
-
     myNoiseCounter >>= 1;
     if (myNoiseFeedback) {
       myNoiseCounter |= 0x10;
     }
 
     if (!myPulseCounterHold) {
-      myPulseCounter = ~(myPulseCounter >> 1) & 0x07;
-
-      if (pulseFeedback) {
-        myPulseCounter |= 0x08;
-      }
+      myPulseCounter =
+        PULSE_TABLE[myAudc][myNoiseCounterBit4 ? 1 : 0][myPulseCounter & 0x0f];
     }
   }
 }
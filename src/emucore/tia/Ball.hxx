@@ -110,6 +110,11 @@ class Ball : public Serializable
     void setInvertedPhaseClock(bool enable);
     void setShortLateHMove(bool enable);
 
+    /**
+      Whether any of the developer TIA quirks is enabled for this object.
+     */
+    bool hasQuirks() const { return myUseInvertedPhaseClock || myUseShortLateHMove; }
+
     /**
       Start movement --- this is triggered by strobing HMOVE.
      */
@@ -168,11 +173,13 @@ class Ball : public Serializable
     /**
       Process a single movement tick. Inline for performance (implementation below).
      */
+    template<bool Quirks = true>
     FORCE_INLINE void movementTick(uInt32 clock, uInt32 hclock, bool hblank);
 
     /**
       Tick one color clock. Inline for performance (implementation below).
      */
+    template<bool Quirks = true>
     FORCE_INLINE void tick(bool isReceivingRegularClock = true);
 
   public:
@@ -344,6 +351,7 @@ class Ball : public Serializable
 // ############################################################################
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+template<bool Quirks>
 void Ball::movementTick(uInt32 clock, uInt32 hclock, bool hblank)
 {
   myLastMovementTick = myCounter;
@@ -353,12 +361,12 @@ void Ball::movementTick(uInt32 clock, uInt32 hclock, bool hblank)
     // Stop movement once the number of clocks according to HMBL is reached
     if (clock == myHmmClocks)
       isMoving = false;
-    else if (!myUseShortLateHMove || hclock != 0)
+    else if (!Quirks || !myUseShortLateHMove || hclock != 0)
     {
       // Process the tick if we are in hblank. Otherwise, the tick is either masked
       // by an ordinary tick or merges two consecutive ticks into a single tick (inverted
       // movement clock phase mode).
-      if(hblank) tick(false);
+      if(hblank) tick<Quirks>(false);
       // Track a tick outside hblank for later processing
       myInvertedPhaseClock = !hblank;
     }
@@ -366,11 +374,12 @@ void Ball::movementTick(uInt32 clock, uInt32 hclock, bool hblank)
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+template<bool Quirks>
 void Ball::tick(bool isReceivingRegularClock)
 {
   // If we are in inverted movement clock phase mode and a movement tick occurred, it
   // will supress the tick.
-  if(myUseInvertedPhaseClock && myInvertedPhaseClock)
+  if(Quirks && myUseInvertedPhaseClock && myInvertedPhaseClock)
   {
     myInvertedPhaseClock = false;
     return;
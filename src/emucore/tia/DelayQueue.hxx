@@ -18,6 +18,9 @@
 #ifndef TIA_DELAY_QUEUE
 #define TIA_DELAY_QUEUE
 
+#include <bit>
+#include <limits>
+
 #include "Serializable.hxx"
 #include "bspf.hxx"
 #include "smartmod.hxx"
@@ -29,6 +32,8 @@ class DelayQueueIteratorImpl;
 template<unsigned length, unsigned capacity>
 class DelayQueue : public Serializable
 {
+  static_assert(length < 32, "slot occupancy must fit into an uInt32");
+
   public:
     friend DelayQueueIteratorImpl<length, capacity>;
 
@@ -44,6 +49,29 @@ class DelayQueue : public Serializable
 
     template<typename T> void execute(T executor);
 
+    /**
+      Check whether any delayed writes are pending.
+    */
+    bool isEmpty() const { return myOccupied == 0; }
+
+    /**
+      Get the number of clocks before the next delayed write is due, i.e.
+      the number of execute() calls which won't execute anything.
+
+      @return  The number of idle clocks (0 if a write is due with the next
+               execute(), UINT32_MAX if the queue is empty)
+    */
+    uInt32 idleClocks() const;
+
+    /**
+      Advance the queue by the given number of clocks.  Only valid for at
+      most idleClocks() clocks, in which case this is equivalent to (but much
+      faster than) calling execute() 'clocks' times.
+    */
+    void skip(uInt32 clocks) {
+      myIndex = static_cast<uInt8>((myIndex + clocks) % length);
+    }
+
     /**
       Serializable methods (see that class for more information).
     */
@@ -55,6 +83,10 @@ class DelayQueue : public Serializable
     uInt8 myIndex{0};
     std::array<uInt8, 0xFF> myIndices{};
 
+    // Bit i is set if member i contains any entries; not part of the state,
+    // since it can be derived from the members
+    uInt32 myOccupied{0};
+
   private:
     DelayQueue(const DelayQueue&) = delete;
     DelayQueue(DelayQueue&&) = delete;
@@ -82,11 +114,15 @@ void DelayQueue<length, capacity>::push(uInt8 address, uInt8 value, uInt8 delay)
 
   const uInt8 currentIndex = myIndices[address];
 
-  if (currentIndex < length)
+  if (currentIndex < length) {
     myMembers[currentIndex].remove(address);
+    if (myMembers[currentIndex].mySize == 0)
+      myOccupied &= ~(1U << currentIndex);
+  }
 
   const uInt8 index = smartmod<length>(myIndex + delay);
   myMembers[index].push(address, value);
+  myOccupied |= 1U << index;
 
   myIndices[address] = index;
 }
@@ -100,6 +136,21 @@ void DelayQueue<length, capacity>::reset()
 
   myIndex = 0;
   myIndices.fill(0xFF);
+  myOccupied = 0;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+template<unsigned length, unsigned capacity>
+uInt32 DelayQueue<length, capacity>::idleClocks() const
+{
+  if (myOccupied == 0) return std::numeric_limits<uInt32>::max();
+
+  // Rotate the occupancy, so that the current member becomes bit 0
+  constexpr uInt32 mask = (1U << length) - 1;
+  const uInt32 rotated =
+    ((myOccupied >> myIndex) | (myOccupied << (length - myIndex))) & mask;
+
+  return static_cast<uInt32>(std::countr_zero(rotated));
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -114,6 +165,7 @@ void DelayQueue<length, capacity>::execute(T executor)
     myIndices[currentMember.myEntries[i].address] = 0xFF;
   }
 
+  myOccupied &= ~(1U << myIndex);
   currentMember.clear();
 
   myIndex = smartmod<length>(myIndex + 1);
@@ -155,6 +207,11 @@ bool DelayQueue<length, capacity>::load(Serializer& in)
 
     myIndex = in.getByte();
     in.getByteArray(myIndices);
+
+    myOccupied = 0;
+    for (uInt32 i = 0; i < length; ++i)
+      if (myMembers[i].mySize > 0)
+        myOccupied |= 1U << i;
   }
   catch(...)
   {
@@ -62,6 +62,11 @@ class Missile : public Serializable
     void setInvertedPhaseClock(bool enable);
     void setShortLateHMove(bool enable);
 
+    /**
+      Whether any of the developer TIA quirks is enabled for this object.
+     */
+    bool hasQuirks() const { return myUseInvertedPhaseClock || myUseShortLateHMove; }
+
     void toggleCollisions(bool enabled);
 
     void toggleEnabled(bool enabled);
@@ -78,8 +83,10 @@ class Missile : public Serializable
     bool save(Serializer& out) const override;
     bool load(Serializer& in) override;
 
+    template<bool Quirks = true>
     FORCE_INLINE void movementTick(uInt8 clock, uInt8 hclock, bool hblank);
 
+    template<bool Quirks = true>
     FORCE_INLINE void tick(uInt8 hclock, bool isReceivingMclock = true);
 
   public:
@@ -144,6 +151,7 @@ class Missile : public Serializable
 // ############################################################################
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+template<bool Quirks>
 void Missile::movementTick(uInt8 clock, uInt8 hclock, bool hblank)
 {
   if(isMoving)
@@ -151,12 +159,12 @@ void Missile::movementTick(uInt8 clock, uInt8 hclock, bool hblank)
     // Stop movement once the number of clocks according to HMMx is reached
     if(clock == myHmmClocks)
       isMoving = false;
-    else if (!myUseShortLateHMove || hclock != 0)
+    else if (!Quirks || !myUseShortLateHMove || hclock != 0)
     {
       // Process the tick if we are in hblank. Otherwise, the tick is either masked
       // by an ordinary tick or merges two consecutive ticks into a single tick (inverted
       // movement clock phase mode).
-      if(hblank) tick(hclock, false);
+      if(hblank) tick<Quirks>(hclock, false);
       // Track a tick outside hblank for later processing
       myInvertedPhaseClock = !hblank;
     }
@@ -164,11 +172,12 @@ void Missile::movementTick(uInt8 clock, uInt8 hclock, bool hblank)
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+template<bool Quirks>
 void Missile::tick(uInt8 hclock, bool isReceivingMclock)
 {
   // If we are in inverted movement clock phase mode and a movement tick occurred, it
   // will supress the tick.
-  if(myUseInvertedPhaseClock && myInvertedPhaseClock)
+  if(Quirks && myUseInvertedPhaseClock && myInvertedPhaseClock)
   {
     myInvertedPhaseClock = false;
     return;
@@ -62,6 +62,11 @@ class Player : public Serializable
     void setInvertedPhaseClock(bool enable);
     void setShortLateHMove(bool enable);
 
+    /**
+      Whether any of the developer TIA quirks is enabled for this object.
+     */
+    bool hasQuirks() const { return myUseInvertedPhaseClock || myUseShortLateHMove; }
+
     void startMovement();
 
     void nextLine();
@@ -89,8 +94,10 @@ class Player : public Serializable
     bool save(Serializer& out) const override;
     bool load(Serializer& in) override;
 
+    template<bool Quirks = true>
     FORCE_INLINE void movementTick(uInt32 clock, uInt32 hclock, bool hblank);
 
+    template<bool Quirks = true>
     FORCE_INLINE void tick();
 
   public:
@@ -160,6 +167,7 @@ class Player : public Serializable
 // ############################################################################
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+template<bool Quirks>
 void Player::movementTick(uInt32 clock, uInt32 hclock, bool hblank)
 {
   if(isMoving)
@@ -167,12 +175,12 @@ void Player::movementTick(uInt32 clock, uInt32 hclock, bool hblank)
     // Stop movement once the number of clocks according to HMPx is reached
     if (clock == myHmmClocks)
       isMoving = false;
-    else if (!myUseShortLateHMove || hclock != 0)
+    else if (!Quirks || !myUseShortLateHMove || hclock != 0)
     {
       // Process the tick if we are in hblank. Otherwise, the tick is either masked
       // by an ordinary tick or merges two consecutive ticks into a single tick (inverted
       // movement clock phase mode).
-      if(hblank) tick();
+      if(hblank) tick<Quirks>();
       // Track a tick outside hblank for later processing
       myInvertedPhaseClock = !hblank;
     }
@@ -180,11 +188,12 @@ void Player::movementTick(uInt32 clock, uInt32 hclock, bool hblank)
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+template<bool Quirks>
 void Player::tick()
 {
   // If we are in inverted movement clock phase mode and a movement tick occurred, it
   // will supress the tick.
-  if(myUseInvertedPhaseClock && myInvertedPhaseClock)
+  if(Quirks && myUseInvertedPhaseClock && myInvertedPhaseClock)
   {
     myInvertedPhaseClock = false;
     return;
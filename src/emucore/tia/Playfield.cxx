@@ -272,6 +272,13 @@ uInt8 Playfield::getColor() const
 void Playfield::updatePattern()
 {
   myEffectivePattern = myIsSuppressed ? 0 : myPattern;
+
+  uInt64 reflected = 0;
+  for (uInt32 i = 0; i < 20; ++i)
+    if (myEffectivePattern & (1 << i)) reflected |= uInt64{1} << (39 - i);
+
+  myBlocks[0] = uInt64{myEffectivePattern} | (uInt64{myEffectivePattern} << 20);
+  myBlocks[1] = uInt64{myEffectivePattern} | reflected;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
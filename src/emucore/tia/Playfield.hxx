@@ -227,6 +227,13 @@ class Playfield : public Serializable
      */
     uInt32 myEffectivePattern{0};
 
+    /**
+      The effective pattern expanded to the 40 4-pixel blocks of a line,
+      bit n is block n. The left half is the same in both; the right half
+      is copied (index 0) or reflected (index 1).
+     */
+    std::array<uInt64, 2> myBlocks{};
+
     /**
       Reflected mode on / off.
      */
@@ -276,19 +283,7 @@ void Playfield::tick(uInt32 x)
 
   if (x & 0x03) return;
 
-  uInt32 currentPixel;  // NOLINT (cppcoreguidelines-init-variables)
-
-  if (myEffectivePattern == 0) {
-      currentPixel = 0;
-  } else if (x < TIAConstants::H_PIXEL / 2 - 1) {
-      currentPixel = myEffectivePattern & (1 << (x >> 2));
-  } else if (myRefp) {
-      currentPixel = myEffectivePattern & (1 << (39 - (x >> 2)));
-  } else {
-      currentPixel = myEffectivePattern & (1 << ((x >> 2) - 20));
-  }
-
-  collision = currentPixel ? myCollisionMaskEnabled : myCollisionMaskDisabled;
+  collision = ((myBlocks[myRefp] >> (x >> 2)) & 1) ? myCollisionMaskEnabled : myCollisionMaskDisabled;
 }
 
 #endif // TIA_PLAYFIELD
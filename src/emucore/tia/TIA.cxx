@@ -15,6 +15,8 @@
 // this file, and for a DISCLAIMER OF ALL WARRANTIES.
 //============================================================================
 
+#include <chrono>
+
 #include "TIA.hxx"
 #include "M6502.hxx"
 #include "M6532.hxx"
@@ -25,6 +27,10 @@
 #include "DispatchResult.hxx"
 #include "PhosphorHandler.hxx"
 #include "Base.hxx"
+#include "PerfCounters.hxx"
+#include "Logger.hxx"
+#include "TIACapture.hxx"
+#include "TIAReplay.hxx"
 
 namespace {
   enum CollisionMask: uInt16 {
@@ -57,6 +63,20 @@ namespace {
     lateHblank = 158,
     frame = 157
   };
+
+  // Hash one line of pixels.  Every step is a bijection of the previous
+  // hash, so lines differing in a single 8 pixel word never collide.
+  uInt64 lineHash(const uInt8* line)
+  {
+    uInt64 hash = 0;
+    for(uInt32 x = 0; x < TIAConstants::frameBufferWidth; x += 8)
+    {
+      uInt64 word = 0;
+      std::memcpy(&word, line + x, sizeof(word));
+      hash = std::rotl(hash ^ (word * 0x9E3779B97F4A7C15ULL), 31) * 0xBF58476D1CE4E5B9ULL;
+    }
+    return hash;
+  }
 }  // namespace
 
 // This parameter still has room for tuning. If we go lower than 73, long005 will show
@@ -89,6 +109,9 @@ TIA::TIA(ConsoleIO& console, const ConsoleTimingProvider& timingProvider,
   initialize();
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TIA::~TIA() = default;
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void TIA::setFrameManager(AbstractFrameManager* frameManager, bool layoutDetector)
 {
@@ -123,6 +146,18 @@ void TIA::setAudioRewindMode(bool enable)
   myAudio.setAudioRewindMode(enable);
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TIA::setAudioSuspended(bool suspend)
+{
+  myAudio.setAudioSuspended(suspend);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TIA::setAudioCapture(ByteArray* samples)
+{
+  myAudio.setAudioCapture(samples);
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void TIA::clearFrameManager()
 {
@@ -162,6 +197,7 @@ void TIA::initialize()
   myPlayer0.reset();
   myPlayer1.reset();
   myBall.reset();
+  updateQuirks();
 
   myInput0.reset();
   myInput1.reset();
@@ -177,6 +213,8 @@ void TIA::initialize()
 #ifdef DEBUGGER_SUPPORT
   myCyclesAtFrameStart = 0;
   myFrameWsyncCycles = 0;
+  myRegisterHistoryCount = myRegisterHistoryFrameStart =
+    myRegisterHistoryLastStart = 0;
 #endif
 
   if (myFrameManager)
@@ -188,8 +226,9 @@ void TIA::initialize()
 
   // Blank the various framebuffers; they may contain graphical garbage
   myBackBuffer.fill(0);
-  myFrontBuffer.fill(0);
-  myFramebuffer.fill(0);
+  myFrameBuffers[0].fill(0);
+  myFrameBuffers[1].fill(0);
+  rehashBuffers();
 
   // Prepare variables for auto-phosphor
   memset(&myPosP0, 0, sizeof(ObjectPos));
@@ -222,6 +261,11 @@ void TIA::initialize()
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void TIA::reset()
 {
+  // Neither a capture nor a replay can follow the TIA across a reset
+  stopCapture();
+  myReplay.reset();
+  ByteArray().swap(myReplayReturnState);
+
   // Simply call initialize(); mostly to get around calling a virtual method
   // from the constructor
   initialize();
@@ -561,6 +605,13 @@ bool TIA::poke(uInt16 address, uInt8 value)
 
   address &= 0x3F;
 
+#ifdef DEBUGGER_SUPPORT
+  if(myRegisterHistoryEnabled)
+    recordRegisterWrite(static_cast<uInt8>(address), value);
+#endif
+  if(myCapture)
+    myCapture->write(mySystem->cycles(), static_cast<uInt8>(address), value);
+
   switch (address)
   {
     case WSYNC:
@@ -927,13 +978,14 @@ bool TIA::poke(uInt16 address, uInt8 value)
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool TIA::saveDisplay(Serializer& out) const
+bool TIA::saveDisplay(Serializer& out, bool framebuffer) const
 {
   try
   {
-    out.putByteArray(myFramebuffer);
+    if(framebuffer)
+      out.putByteArray(renderBuffer());
     out.putByteArray(myBackBuffer);
-    out.putByteArray(myFrontBuffer);
+    out.putByteArray(frontBuffer());
     out.putInt(myFramesSinceLastRender);
   }
   catch(...)
@@ -946,15 +998,17 @@ bool TIA::saveDisplay(Serializer& out) const
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool TIA::loadDisplay(Serializer& in)
+bool TIA::loadDisplay(Serializer& in, bool framebuffer)
 {
   try
   {
     // Reset frame buffer pointer and data
-    in.getByteArray(myFramebuffer);
+    if(framebuffer)
+      in.getByteArray(renderBuffer());
     in.getByteArray(myBackBuffer);
-    in.getByteArray(myFrontBuffer);
+    in.getByteArray(frontBuffer());
     myFramesSinceLastRender = in.getInt();
+    rehashBuffers();
   }
   catch(...)
   {
@@ -965,6 +1019,44 @@ bool TIA::loadDisplay(Serializer& in)
   return true;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TIA::createThumbnail(ByteArray& pixels, uInt32 scale) const
+{
+  const FrameBufferArray& buffer = renderBuffer();
+  const uInt32 width = TIAConstants::frameBufferWidth / scale,
+               height = std::min(myFrameBufferScanlines,
+                                 TIAConstants::frameBufferHeight) / scale;
+
+  pixels.resize(static_cast<size_t>(width) * height);
+  for(uInt32 y = 0; y < height; ++y)
+  {
+    const uInt8* src = &buffer[y * scale * TIAConstants::frameBufferWidth];
+    uInt8* dst = &pixels[y * width];
+
+    for(uInt32 x = 0; x < width; ++x)
+      dst[x] = src[x * scale];
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TIA::showThumbnail(const ByteArray& pixels, uInt32 scale)
+{
+  FrameBufferArray& buffer = renderBuffer();
+  const uInt32 width = TIAConstants::frameBufferWidth / scale,
+               height = std::min<uInt32>(static_cast<uInt32>(pixels.size()) / width * scale,
+                                         TIAConstants::frameBufferHeight);
+
+  for(uInt32 y = 0; y < height; ++y)
+  {
+    const uInt8* src = &pixels[(y / scale) * width];
+    uInt8* dst = &buffer[y * TIAConstants::frameBufferWidth];
+
+    for(uInt32 x = 0; x < TIAConstants::frameBufferWidth; ++x)
+      dst[x] = src[x / scale];
+  }
+  rehashBuffers();
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void TIA::applyDeveloperSettings()
 {
@@ -1030,7 +1122,10 @@ void TIA::applyDeveloperSettings()
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void TIA::update(DispatchResult& result, uInt64 maxCycles)
 {
-  mySystem->m6502().execute(maxCycles, result);
+  if(myReplay)
+    updateReplay(result, maxCycles);
+  else
+    mySystem->m6502().execute(maxCycles, result);
 
   updateEmulation();
 }
@@ -1042,16 +1137,49 @@ void TIA::renderToFrameBuffer()
 
   myFramesSinceLastRender = 0;
 
-  myFramebuffer = myFrontBuffer;
+  // The previous frame buffer is overwritten by the next completed frame
+  myFramebufferIndex ^= 1;
 
   myFrameBufferScanlines = myFrontBufferScanlines;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TIA::setFrameSkip(uInt32 frames)
+{
+  // The layout detector needs to see every pixel
+  myFrameSkip = myIsLayoutDetector ? 0 : frames;
+  myFramesSkipped = 0;
+  mySkipFrame = mySkipDrawing;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TIA::setSkipDrawing(bool skip)
+{
+  mySkipDrawing = skip && !myIsLayoutDetector;
+  // Takes effect for the current frame already
+  myFramesSkipped = 0;
+  mySkipFrame = mySkipDrawing;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TIA::enableTimeProfiling(bool enable)
+{
+  myProfileTime = enable;
+  myProfiledTime = 0;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+double TIA::profiledTime() const
+{
+  return static_cast<double>(myProfiledTime) / 1e9;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void TIA::clearFrameBuffer()
 {
-  myFramebuffer.fill(0);
-  myFrontBuffer.fill(0);
+  myFrameBuffers[0].fill(0);
+  myFrameBuffers[1].fill(0);
+  rehashBuffers();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -1062,6 +1190,118 @@ void TIA::update(uInt64 maxCycles)
   update(dispatchResult, maxCycles);
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool TIA::startCapture(const string& path)
+{
+  stopCapture();
+
+  // The first write is relative to the state
+  updateEmulation();
+
+  ByteArray state;
+  auto capture = std::make_unique<TIACapture>();
+  if(!saveState(state) || !capture->start(path, state, mySystem->cycles()))
+    return false;
+
+  myCapture = std::move(capture);
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt64 TIA::stopCapture()
+{
+  if(!myCapture)
+    return 0;
+
+  const uInt64 captured = myCapture->stop();
+  myCapture.reset();
+
+  return captured;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool TIA::startReplay(const string& path)
+{
+  stopReplay();
+
+  auto replay = std::make_unique<TIAReplay>();
+  if(!replay->load(path))
+    return false;
+
+  updateEmulation();
+  if(!saveState(myReplayReturnState))
+    return false;
+  if(!loadState(replay->state()))
+  {
+    loadState(myReplayReturnState);
+    return false;
+  }
+  replay->rewind(mySystem->cycles());
+
+  myReplay = std::move(replay);
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt64 TIA::stopReplay()
+{
+  if(!myReplay)
+    return 0;
+
+  const uInt64 replayed = myReplay->replayed();
+  myReplay.reset();
+
+  updateEmulation();
+  loadState(myReplayReturnState);
+  ByteArray().swap(myReplayReturnState);
+
+  return replayed;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TIA::updateReplay(DispatchResult& result, uInt64 maxCycles)
+{
+  const uInt64 startCycles = mySystem->cycles();
+  const bool running = myReplay->run(*this, *mySystem, maxCycles);
+
+  result.setOk(mySystem->cycles() - startCycles);
+  if(!running)
+    Logger::info(std::format("TIA replay finished, {} writes replayed",
+                             stopReplay()));
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool TIA::saveState(ByteArray& state) const
+{
+  Serializer::Arena arena;
+  Serializer out(arena);
+
+  if(!save(out))
+    return false;
+
+  const auto* data = reinterpret_cast<const uInt8*>(arena.data());
+  state.assign(data, data + out.size());
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool TIA::loadState(const ByteArray& state)
+{
+  Serializer in(std::as_bytes(std::span(state)));
+
+  if(!load(in))
+    return false;
+
+  // Continue from the current system cycle, instead of the one the state
+  // was saved at
+  const uInt64 offset = mySystem->cycles() - myLastCycle;
+  myLastCycle += offset;
+#ifdef DEBUGGER_SUPPORT
+  myCyclesAtFrameStart += offset;
+#endif
+  return true;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool TIA::enableColorLoss(bool enabled)
 {
@@ -1375,7 +1615,17 @@ void TIA::updateEmulation()
   mySubClock = 0;
   myLastCycle = systemCycles;
 
-  cycle(cyclesToRun);
+  if (myProfileTime)
+  {
+    using namespace std::chrono;
+    const auto start = high_resolution_clock::now();
+
+    cycle(cyclesToRun);
+    myProfiledTime += static_cast<uInt64>(
+      duration_cast<nanoseconds>(high_resolution_clock::now() - start).count());
+  }
+  else
+    cycle(cyclesToRun);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -1413,21 +1663,48 @@ void TIA::onFrameComplete()
   mySystem->m6502().stop();
 #ifdef DEBUGGER_SUPPORT
   myCyclesAtFrameStart = mySystem->cycles();
+  if(myRegisterHistoryEnabled)
+    startRegisterHistoryFrame();
+  if(myLineBudgetEnabled)
+    startLineBudgetFrame();
 #endif
 
-  if (myXAtRenderingStart > 0)
-    std::fill_n(myBackBuffer.begin(), myXAtRenderingStart, 0);
+  // A skipped frame leaves the front buffer with the last drawn frame
+  if (!mySkipFrame)
+  {
+    const uInt32 lastY = myFrameManager->getY();
 
-  // Blank out any extra lines not drawn this frame
-  const Int32 missingScanlines = myFrameManager->missingScanlines();
-  if (missingScanlines > 0)
-    std::fill_n(myBackBuffer.begin() +
-      static_cast<size_t>(TIAConstants::H_PIXEL * myFrameManager->getY()),
-      missingScanlines * TIAConstants::H_PIXEL, 0);
+    if (myXAtRenderingStart > 0)
+      std::fill_n(myBackBuffer.begin(), myXAtRenderingStart, 0);
 
-  myFrontBuffer = myBackBuffer;
+    // Blank out any extra lines not drawn this frame
+    const Int32 missingScanlines = myFrameManager->missingScanlines();
+    if (missingScanlines > 0)
+      std::fill_n(myBackBuffer.begin() +
+        static_cast<size_t>(TIAConstants::frameBufferWidth * lastY),
+        missingScanlines * TIAConstants::frameBufferWidth, 0);
 
-  myFrontBufferScanlines = scanlinesLastFrame();
+    // The first line and the (partial) line the frame ended on were changed
+    // after they had been hashed, the missing lines are blank
+    hashBackLine(0);
+    hashBackLine(lastY);
+    for (uInt32 y = lastY + 1; y < lastY + std::max(missingScanlines, 0); ++y)
+      hashBackLine(y);
+
+    frontBuffer() = myBackBuffer;
+    myFrameLineHashes[myFramebufferIndex ^ 1] = myBackLineHashes;
+
+    myFrontBufferScanlines = scanlinesLastFrame();
+  }
+
+  // Decide whether the next frame gets drawn
+  if (mySkipDrawing)
+    mySkipFrame = true;
+  else if (myFrameSkip > 0)
+  {
+    mySkipFrame = myFramesSkipped < myFrameSkip;
+    myFramesSkipped = mySkipFrame ? myFramesSkipped + 1 : 0;
+  }
 
   if(myAutoPhosphorEnabled)
   {
@@ -1435,7 +1712,7 @@ void TIA::onFrameComplete()
     // If difference to latest frame is larger than to older frames, and this happens for
     // multiple frames, enabled phosphor mode.
     static constexpr int MIN_FLICKER_DELTA = 6;
-    static constexpr int MAX_FLICKER_DELTA = TIAConstants::H_PIXEL - MIN_FLICKER_DELTA;
+    static constexpr int MAX_FLICKER_DELTA = TIAConstants::frameBufferWidth - MIN_FLICKER_DELTA;
     static constexpr int MIN_DIFF = 4;
     static constexpr int PHOSPHOR_FRAMES = 8;
 
@@ -1517,6 +1794,9 @@ void TIA::onHalt()
   mySystem->incrementCycles(mySubClock / TIAConstants::CYCLE_CLOCKS);
 #ifdef DEBUGGER_SUPPORT
   myFrameWsyncCycles += 3 + mySubClock / TIAConstants::CYCLE_CLOCKS;
+  if(myLineBudgetEnabled && scanlines() < LINE_BUDGET_LINES)
+    myLineBudget[scanlines()].wsync +=
+      static_cast<uInt16>(mySubClock / TIAConstants::CYCLE_CLOCKS);
 #endif
   mySubClock %= TIAConstants::CYCLE_CLOCKS;
 }
@@ -1524,8 +1804,21 @@ void TIA::onHalt()
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void TIA::cycle(uInt32 colorClocks)
 {
+  PERF_SCOPE(TIA);
+
   for (uInt32 i = 0; i < colorClocks; ++i)
   {
+    // Fast path: skip over runs of idle clocks in bulk
+    if (const uInt32 idleClocks = idleClockRun(colorClocks - i); idleClocks > 0)
+    {
+      myDelayQueue.skip(idleClocks);
+      myCollisionUpdateRequired = false;
+      myHctr += idleClocks;
+      myTimestamp += idleClocks;
+      i += idleClocks - 1;
+      continue;
+    }
+
     myDelayQueue.execute(
       [this] (uInt8 address, uInt8 value) {delayedWrite(address, value);}
     );
@@ -1534,12 +1827,15 @@ void TIA::cycle(uInt32 colorClocks)
     myCollisionUpdateScheduled = false;
 
     if (myLinesSinceChange < 2) {
-      tickMovement();
+      // Stock consoles use the specialized object code without quirk checks
+      if (myHasQuirks) tickMovement<true>(); else tickMovement<false>();
 
       if (myHstate == HState::blank)
         tickHblank();
+      else if (myHasQuirks)
+        tickHframe<true>();
       else
-        tickHframe();
+        tickHframe<false>();
 
       if (myCollisionUpdateRequired && !myFrameManager->vblank()) updateCollision();
     }
@@ -1547,15 +1843,45 @@ void TIA::cycle(uInt32 colorClocks)
     if (++myHctr >= TIAConstants::H_CLOCKS)
       nextLine();
 
-  #ifdef SOUND_SUPPORT
-    myAudio.tick();
-  #endif
-
     ++myTimestamp;
   }
+
+#ifdef SOUND_SUPPORT
+  // The audio registers are written immediately (by poke(), which updates
+  // the emulation before), so they are constant for the whole run
+  myAudio.tick(colorClocks);
+#endif
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+FORCE_INLINE uInt32 TIA::idleClockRun(uInt32 maxClocks) const
+{
+  // Clocks are idle if no delayed write is due, no collision update is
+  // pending and neither the line cache nor HBLANK (without movement) is
+  // going to change any state before the next scanline or the end of HBLANK
+  if (myCollisionUpdateScheduled)
+    return 0;
+
+  uInt32 run = 0;
+
+  if (myLinesSinceChange >= 2)
+    // Stop right before the clock which triggers nextLine()
+    run = TIAConstants::H_CLOCKS - 1 - myHctr;
+  else if (myHstate == HState::blank && !myMovementInProgress &&
+           !myExtendedHblank && myHctr > 0 &&
+           myHctr < TIAConstants::H_BLANK_CLOCKS - 1)
+    // Stop right before the clock which ends HBLANK
+    run = TIAConstants::H_BLANK_CLOCKS - 1 - myHctr;
+
+  // Stop right before the next delayed write
+  run = std::min(run, myDelayQueue.idleClocks());
+
+  // Single clocks are not worth the effort
+  return run > 1 ? std::min(run, maxClocks) : 0;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+template<bool Quirks>
 FORCE_INLINE void TIA::tickMovement()
 {
   if (!myMovementInProgress) return;
@@ -1564,11 +1890,11 @@ FORCE_INLINE void TIA::tickMovement()
     const bool hblank = myHstate == HState::blank;
     const uInt8 movementCounter = myMovementClock > 15 ? 0 : myMovementClock;
 
-    myMissile0.movementTick(movementCounter, myHctr, hblank);
-    myMissile1.movementTick(movementCounter, myHctr, hblank);
-    myPlayer0.movementTick(movementCounter, myHctr, hblank);
-    myPlayer1.movementTick(movementCounter, myHctr, hblank);
-    myBall.movementTick(movementCounter, myHctr, hblank);
+    myMissile0.movementTick<Quirks>(movementCounter, myHctr, hblank);
+    myMissile1.movementTick<Quirks>(movementCounter, myHctr, hblank);
+    myPlayer0.movementTick<Quirks>(movementCounter, myHctr, hblank);
+    myPlayer1.movementTick<Quirks>(movementCounter, myHctr, hblank);
+    myBall.movementTick<Quirks>(movementCounter, myHctr, hblank);
 
     myMovementInProgress =
       myMissile0.isMoving ||
@@ -1608,6 +1934,7 @@ void TIA::tickHblank()
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+template<bool Quirks>
 void TIA::tickHframe()
 {
   const uInt32 y = myFrameManager->getY();
@@ -1616,13 +1943,13 @@ void TIA::tickHframe()
   myCollisionUpdateRequired = true;
 
   myPlayfield.tick(x);
-  myMissile0.tick(myHctr);
-  myMissile1.tick(myHctr);
-  myPlayer0.tick();
-  myPlayer1.tick();
-  myBall.tick();
+  myMissile0.tick<Quirks>(myHctr);
+  myMissile1.tick<Quirks>(myHctr);
+  myPlayer0.tick<Quirks>();
+  myPlayer1.tick<Quirks>();
+  myBall.tick<Quirks>();
 
-  if (myFrameManager->isRendering())
+  if (myFrameManager->isRendering() && !mySkipFrame)
     renderPixel(x, y);
 }
 
@@ -1633,10 +1960,10 @@ void TIA::applyRsync()
       ? myHctr - TIAConstants::H_BLANK_CLOCKS : 0;
 
   myHctrDelta = TIAConstants::H_CLOCKS - 3 - myHctr;
-  if (myFrameManager->isRendering())
+  if (myFrameManager->isRendering() && !mySkipFrame)
     std::fill_n(myBackBuffer.begin() +
-      static_cast<size_t>(myFrameManager->getY() * TIAConstants::H_PIXEL + x),
-      TIAConstants::H_PIXEL - x, 0);
+      static_cast<size_t>(myFrameManager->getY() * TIAConstants::frameBufferWidth + x),
+      TIAConstants::frameBufferWidth - x, 0);
 
   myHctr = TIAConstants::H_CLOCKS - 3;
 }
@@ -1657,6 +1984,17 @@ FORCE_INLINE void TIA::nextLine()
   myHstate = HState::blank;
   myHctrDelta = 0;
 
+  // Hash the completed line; a cloned line has the hash of the one before
+  if (myFrameManager->isRendering() && !mySkipFrame && !myIsLayoutDetector)
+  {
+    const uInt32 y = myFrameManager->getY();
+
+    if (cloned && y > 0 && y < TIAConstants::frameBufferHeight)
+      myBackLineHashes[y] = myBackLineHashes[y - 1];
+    else
+      hashBackLine(y);
+  }
+
   myFrameManager->nextLine();
   myMissile0.nextLine();
   myMissile1.nextLine();
@@ -1716,8 +2054,10 @@ void TIA::cloneLastLine()
 {
   if(myIsLayoutDetector)
   {
+    if(!myFrameManager->isRendering()) return;
+
     // y is always 0 in FrameLayoutDetector
-    for(uInt32 i = 0 ; i < TIAConstants::H_PIXEL; ++i)
+    for(uInt32 i = 0 ; i < TIAConstants::frameBufferWidth; ++i)
       myFrameManager->pixelColor(myBackBuffer[i]);
   }
   else
@@ -1726,8 +2066,9 @@ void TIA::cloneLastLine()
 
     if(!myFrameManager->isRendering() || y == 0) return;
 
-    std::copy_n(myBackBuffer.begin() + (y - 1) * TIAConstants::H_PIXEL,
-      TIAConstants::H_PIXEL, myBackBuffer.begin() + y * TIAConstants::H_PIXEL);
+    if(!mySkipFrame)
+      std::copy_n(myBackBuffer.begin() + (y - 1) * TIAConstants::frameBufferWidth,
+        TIAConstants::frameBufferWidth, myBackBuffer.begin() + y * TIAConstants::frameBufferWidth);
 
     // Save positions of objects for auto-phosphor
     if(myAutoPhosphorEnabled)
@@ -1764,7 +2105,7 @@ FORCE_INLINE void TIA::updateCollision()
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 FORCE_INLINE void TIA::renderPixel(uInt32 x, uInt32 y)
 {
-  if (x >= TIAConstants::H_PIXEL) return;
+  if (x >= TIAConstants::frameBufferWidth) return;
 
   uInt8 color = 0;
 
@@ -1819,11 +2160,31 @@ FORCE_INLINE void TIA::renderPixel(uInt32 x, uInt32 y)
     }
   }
 
-  myBackBuffer[y * TIAConstants::H_PIXEL + x] = color;
+  myBackBuffer[y * TIAConstants::frameBufferWidth + x] = color;
   if (myIsLayoutDetector)
     myFrameManager->pixelColor(color);
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TIA::hashBackLine(uInt32 y)
+{
+  if (y < TIAConstants::frameBufferHeight)
+    myBackLineHashes[y] = lineHash(&myBackBuffer[static_cast<size_t>(y) * TIAConstants::frameBufferWidth]);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TIA::rehashBuffers()
+{
+  for (uInt32 y = 0; y < TIAConstants::frameBufferHeight; ++y)
+  {
+    const size_t offset = static_cast<size_t>(y) * TIAConstants::frameBufferWidth;
+
+    myBackLineHashes[y] = lineHash(&myBackBuffer[offset]);
+    myFrameLineHashes[0][y] = lineHash(&myFrameBuffers[0][offset]);
+    myFrameLineHashes[1][y] = lineHash(&myFrameBuffers[1][offset]);
+  }
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void TIA::flushLineCache()
 {
@@ -1837,8 +2198,10 @@ void TIA::flushLineCache()
     for (myHctr = 0; myHctr < rewindCycles; ++myHctr) {
       if (myHstate == HState::blank)
         tickHblank();
+      else if (myHasQuirks)
+        tickHframe<true>();
       else
-        tickHframe();
+        tickHframe<false>();
     }
   }
 }
@@ -1846,9 +2209,9 @@ void TIA::flushLineCache()
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void TIA::clearHmoveComb()
 {
-  if (myFrameManager->isRendering() && myHstate == HState::blank)
+  if (myFrameManager->isRendering() && myHstate == HState::blank && !mySkipFrame)
     std::fill_n(myBackBuffer.begin() +
-      static_cast<size_t>(myFrameManager->getY() * TIAConstants::H_PIXEL),
+      static_cast<size_t>(myFrameManager->getY() * TIAConstants::frameBufferWidth),
       8, myColorHBlank);
 }
 
@@ -1893,6 +2256,7 @@ void TIA::setPlInvertedPhaseClock(bool enable)
 {
   myPlayer0.setInvertedPhaseClock(enable);
   myPlayer1.setInvertedPhaseClock(enable);
+  updateQuirks();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -1900,12 +2264,14 @@ void TIA::setMsInvertedPhaseClock(bool enable)
 {
   myMissile0.setInvertedPhaseClock(enable);
   myMissile1.setInvertedPhaseClock(enable);
+  updateQuirks();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void TIA::setBlInvertedPhaseClock(bool enable)
 {
   myBall.setInvertedPhaseClock(enable);
+  updateQuirks();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -1913,6 +2279,7 @@ void TIA::setPlShortLateHMove(bool enable)
 {
   myPlayer0.setShortLateHMove(enable);
   myPlayer1.setShortLateHMove(enable);
+  updateQuirks();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -1920,12 +2287,22 @@ void TIA::setMsShortLateHMove(bool enable)
 {
   myMissile0.setShortLateHMove(enable);
   myMissile1.setShortLateHMove(enable);
+  updateQuirks();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void TIA::setBlShortLateHMove(bool enable)
 {
   myBall.setShortLateHMove(enable);
+  updateQuirks();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TIA::updateQuirks()
+{
+  myHasQuirks = myPlayer0.hasQuirks() || myPlayer1.hasQuirks() ||
+                myMissile0.hasQuirks() || myMissile1.hasQuirks() ||
+                myBall.hasQuirks();
 }
 
 
@@ -2272,6 +2649,112 @@ Int64 TIA::dumpPortsCycles()
 }
 
 #ifdef DEBUGGER_SUPPORT
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TIA::enableRegisterHistory(bool enable)
+{
+  if(enable == myRegisterHistoryEnabled)
+    return;
+
+  myRegisterHistoryEnabled = enable;
+  if(enable)
+  {
+    myRegisterHistory.resize(REGISTER_HISTORY_SIZE);
+    myRegisterHistoryCount = 0;
+    // Nothing recorded for the last frame
+    startRegisterHistoryFrame();
+    startRegisterHistoryFrame();
+  }
+  else
+  {
+    myRegisterHistory.clear();
+    myRegisterHistory.shrink_to_fit();
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TIA::recordRegisterWrite(uInt8 address, uInt8 value)
+{
+  RegisterWrite& write =
+    myRegisterHistory[myRegisterHistoryCount++ & (REGISTER_HISTORY_SIZE - 1)];
+
+  write.cycle = frameCycles();
+  write.y = static_cast<uInt16>(scanlines());
+  write.x = static_cast<uInt8>(clocksThisLine());
+  write.address = address;
+  write.value = value;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TIA::startRegisterHistoryFrame()
+{
+  myRegisterHistoryLastStart = myRegisterHistoryFrameStart;
+  myRegisterHistoryFrameStart = myRegisterHistoryCount;
+  myRegisterHistoryLastRegs = myRegisterHistoryFrameRegs;
+  myRegisterHistoryFrameRegs = myShadowRegisters;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+const std::array<uInt8, 64>& TIA::registerHistory(RegisterWrites& writes,
+                                                  bool lastFrame) const
+{
+  const uInt64 end = lastFrame ? myRegisterHistoryFrameStart
+                               : myRegisterHistoryCount;
+  uInt64 start = lastFrame ? myRegisterHistoryLastStart
+                           : myRegisterHistoryFrameStart;
+
+  // Older writes have already been overwritten
+  if(end - start > REGISTER_HISTORY_SIZE)
+    start = end - REGISTER_HISTORY_SIZE;
+
+  writes.clear();
+  if(myRegisterHistoryEnabled)
+  {
+    writes.reserve(end - start);
+    for(uInt64 i = start; i < end; ++i)
+      writes.push_back(myRegisterHistory[i & (REGISTER_HISTORY_SIZE - 1)]);
+  }
+  return lastFrame ? myRegisterHistoryLastRegs : myRegisterHistoryFrameRegs;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TIA::enableLineBudget(bool enable)
+{
+  if(enable == myLineBudgetEnabled)
+    return;
+
+  myLineBudgetEnabled = enable;
+  if(enable)
+  {
+    myLineBudget.assign(LINE_BUDGET_LINES, LineBudget{});
+    myLineBudgetLast.assign(LINE_BUDGET_LINES, LineBudget{});
+  }
+  else
+  {
+    myLineBudget.clear();
+    myLineBudget.shrink_to_fit();
+    myLineBudgetLast.clear();
+    myLineBudgetLast.shrink_to_fit();
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TIA::recordArmTime(uInt32 armCycles)
+{
+  // The ARM runs at the current CPU cycle, which the TIA may not have
+  // reached yet
+  updateEmulation();
+
+  if(scanlines() < LINE_BUDGET_LINES)
+    myLineBudget[scanlines()].arm += armCycles;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TIA::startLineBudgetFrame()
+{
+  myLineBudget.swap(myLineBudgetLast);
+  std::ranges::fill(myLineBudget, LineBudget{});
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void TIA::createAccessArrays()
 {
@@ -2303,18 +2786,18 @@ void TIA::setAccessFlags(uInt16 address, Device::AccessFlags flags)
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void TIA::increaseAccessCounter(uInt16 address, bool isWrite)
+void TIA::increaseAccessCounter(uInt16 address, bool isWrite, AccessCounter count)
 {
   if(isWrite)
   {
     // the first two write accesses are assumed as initialization
-    if(myAccessDelay[address & TIA_MASK])
-      myAccessDelay[address & TIA_MASK]--;
-    else
-      myAccessCounter[address & TIA_MASK]++;
+    const auto delay = std::min<AccessCounter>(myAccessDelay[address & TIA_MASK], count);
+
+    myAccessDelay[address & TIA_MASK] -= delay;
+    countAccess(myAccessCounter[address & TIA_MASK], count - delay);
   }
   else
-    myAccessCounter[TIA_SIZE + (address & TIA_READ_MASK)]++;
+    countAccess(myAccessCounter[TIA_SIZE + (address & TIA_READ_MASK)], count);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -44,6 +44,8 @@
 
 class AudioQueue;
 class DispatchResult;
+class TIACapture;
+class TIAReplay;
 
 /**
   This class is a device that emulates the Television Interface Adaptor
@@ -118,7 +120,7 @@ class TIA : public Device
     */
     TIA(ConsoleIO& console, const ConsoleTimingProvider& timingProvider,
         Settings& settings, const onPhosphorCallback& callback);
-    ~TIA() override = default;
+    ~TIA() override;
 
   public:
     /**
@@ -138,6 +140,16 @@ class TIA : public Device
     */
     void setAudioRewindMode(bool enable);
 
+    /**
+      Suspend/resume audio output, e.g. while emulating run-ahead frames.
+    */
+    void setAudioSuspended(bool suspend);
+
+    /**
+      Capture the audible samples into the given buffer (see Audio).
+    */
+    void setAudioCapture(ByteArray* samples);
+
     /**
       Clear the configured frame manager and deteach the lifecycle callbacks.
      */
@@ -207,9 +219,25 @@ class TIA : public Device
       the debugger state save has 'cycle resolution', and hence needs
       more information.  The methods below save/load this extra info,
       and eliminate having to save approx. 50K to normal state files.
+
+      The framebuffer shown on screen can be excluded, so that a frame
+      rendered in between survives loading the display again (run-ahead).
     */
-    bool saveDisplay(Serializer& out) const;
-    bool loadDisplay(Serializer& in);
+    bool saveDisplay(Serializer& out, bool framebuffer = true) const;
+    bool loadDisplay(Serializer& in, bool framebuffer = true);
+
+    /**
+      Create a thumbnail of the current frame, using every 'scale'th pixel
+      of every 'scale'th scanline.  Like the frame buffer, the thumbnail
+      contains palette indices and is frameBufferWidth / scale pixels wide.
+    */
+    void createThumbnail(ByteArray& pixels, uInt32 scale) const;
+
+    /**
+      Show a thumbnail created by createThumbnail() instead of the current
+      frame, until the next frame is rendered or the display is loaded.
+    */
+    void showThumbnail(const ByteArray& pixels, uInt32 scale);
 
     /**
       This method should be called at an interval corresponding to the
@@ -220,6 +248,42 @@ class TIA : public Device
 
     void update(uInt64 maxCycles = 50000);
 
+    /**
+      Start capturing every register write, together with the current TIA
+      state, into the given file (see TIACapture).
+
+      @return  False if the file couldn't be created
+    */
+    bool startCapture(const string& path);
+
+    /**
+      Stop capturing.
+
+      @return  The number of writes captured
+    */
+    uInt64 stopCapture();
+
+    bool isCapturing() const { return myCapture != nullptr; }
+
+    /**
+      Replay a capture created by startCapture() in update(), instead of
+      running the CPU (see TIAReplay).  The TIA state of the capture replaces
+      the current one, which is restored when the replay is stopped or
+      reaches its end.
+
+      @return  False if the file isn't a valid capture
+    */
+    bool startReplay(const string& path);
+
+    /**
+      Stop replaying, and return to normal emulation.
+
+      @return  The number of writes replayed
+    */
+    uInt64 stopReplay();
+
+    bool isReplaying() const { return myReplay != nullptr; }
+
     /**
       Did we generate a new frame?
      */
@@ -240,6 +304,43 @@ class TIA : public Device
      */
     void renderToFrameBuffer();
 
+    /**
+      Set the number of frames emulated without drawing any pixels between
+      two drawn frames (e.g. when running much faster than displayed).
+      Collisions and timing are still emulated exactly; only the output of
+      the skipped frames is lost.
+
+      @param frames  The number of frames to skip (0 disables frame skip)
+     */
+    void setFrameSkip(uInt32 frames);
+
+    /**
+      The number of frames skipped between two drawn frames.
+     */
+    uInt32 frameSkip() const { return myFrameSkip; }
+
+    /**
+      Skip drawing all frames, starting with the current one, until enabled
+      again (e.g. while a frontend won't display them).  Like the frame skip,
+      this only affects the output.
+
+      @param skip  Whether to skip drawing
+     */
+    void setSkipDrawing(bool skip);
+
+    /**
+      Enable/disable measuring the real time spent emulating the TIA itself
+      (as opposed to the CPU and the cartridge), and reset the measurement.
+     */
+    void enableTimeProfiling(bool enable);
+
+    /**
+      The real time spent emulating the TIA since profiling was enabled.
+
+      @return  The time in seconds
+     */
+    double profiledTime() const;
+
     /**
       Return the buffer that holds the currently drawing TIA frame
       (the TIA output widget needs this).
@@ -249,7 +350,16 @@ class TIA : public Device
     /**
       Returns a pointer to the internal frame buffer.
     */
-    uInt8* frameBuffer() { return myFramebuffer.data(); }
+    uInt8* frameBuffer() { return renderBuffer().data(); }
+
+    /**
+      Returns the hashes of the lines in the frame buffer, one per line.
+      Lines with the same hash as in an earlier frame have (almost
+      certainly) not changed and can be skipped by the consumers.
+    */
+    const uInt64* frameBufferLineHashes() const {
+      return myFrameLineHashes[myFramebufferIndex].data();
+    }
 
     void clearFrameBuffer();
 
@@ -358,6 +468,72 @@ class TIA : public Device
     uInt32 frameWSyncCycles() const {
       return static_cast<uInt32>(myFrameWsyncCycles);
     }
+
+    /**
+      A single TIA register write, as recorded by the register history.
+    */
+    struct RegisterWrite {
+      uInt32 cycle{0};    // system cycles from the start of the frame
+      uInt16 y{0};        // scanline
+      uInt8  x{0};        // color clock within the scanline
+      uInt8  address{0};
+      uInt8  value{0};
+    };
+    using RegisterWrites = vector<RegisterWrite>;
+
+    /**
+      Enable/disable recording every register write into the register
+      history.  The history buffer is only allocated while enabled.
+    */
+    void enableRegisterHistory(bool enable);
+    bool registerHistoryEnabled() const { return myRegisterHistoryEnabled; }
+
+    /**
+      Answers the register writes of the current (partial) or the last
+      (complete) frame, in the order they happened.  Only the most recent
+      writes are kept if a frame has more than the history can hold.
+
+      @param lastFrame  Answer the last instead of the current frame
+      @return  The register values at the start of the frame
+    */
+    const std::array<uInt8, 64>& registerHistory(RegisterWrites& writes,
+                                                 bool lastFrame = false) const;
+
+    /**
+      The CPU budget of a single scanline, as recorded by the line budget.
+    */
+    struct LineBudget {
+      uInt16 wsync{0};    // system cycles lost to WSYNC stalls
+      uInt32 arm{0};      // ARM cycles (or instructions) run by the cartridge
+
+      // System cycles used by the CPU before WSYNC
+      uInt32 cpu() const {
+        return TIAConstants::H_CYCLES - std::min<uInt32>(wsync, TIAConstants::H_CYCLES);
+      }
+    };
+
+    /**
+      Enable/disable recording the CPU budget of every scanline.  When
+      disabled, the only cost is a flag test in onHalt() and after each
+      ARM run.
+    */
+    void enableLineBudget(bool enable);
+    bool lineBudgetEnabled() const { return myLineBudgetEnabled; }
+
+    /**
+      Add ARM time to the budget of the current scanline (called by the
+      ARM based cartridges, only while the line budget is enabled).
+    */
+    void recordArmTime(uInt32 armCycles);
+
+    /**
+      Answers the budget of the given scanline of the current (partial) or
+      the last (complete) frame.
+    */
+    LineBudget lineBudget(uInt32 scanline, bool lastFrame = false) const {
+      const auto& budget = lastFrame ? myLineBudgetLast : myLineBudget;
+      return scanline < budget.size() ? budget[scanline] : LineBudget{};
+    }
   #endif // DEBUGGER_SUPPORT
 
     /**
@@ -620,8 +796,11 @@ class TIA : public Device
       Increase the given address's access counter
 
       @param address The address to modify
+      @param isWrite Whether the accesses were writes
+      @param count   The number of accesses
     */
-    void increaseAccessCounter(uInt16 address, bool isWrite) override;
+    void increaseAccessCounter(uInt16 address, bool isWrite,
+                               AccessCounter count) override;
 
     /**
       Query the access counters
@@ -679,8 +858,17 @@ class TIA : public Device
     void cycle(uInt32 colorClocks);
 
     /**
-     * Advance the movement logic by a single clock.
+     * Determine how many of the next (at most maxClocks) color clocks would
+     * not change any state except for the counters, and thus can be skipped
+     * in bulk by cycle().
+     */
+    uInt32 idleClockRun(uInt32 maxClocks) const;
+
+    /**
+     * Advance the movement logic by a single clock. The objects check for
+     * the developer quirks only if Quirks is set.
      */
+    template<bool Quirks>
     void tickMovement();
 
     /**
@@ -691,10 +879,23 @@ class TIA : public Device
     /**
      * Advance a single clock duing the visible part of the scanline.
      */
+    template<bool Quirks>
     void tickHframe();
 
+    /**
+     * Check whether any of the objects uses a developer quirk.
+     */
+    void updateQuirks();
+
     /**
      * Update the collision bitfield.
+     *
+     * Every object provides a 15 bit mask with one bit per object pair,
+     * which has all bits set while the object is drawn and only the bits of
+     * pairs not involving the object otherwise. ANDing the six masks yields
+     * all pairs colliding at the current pixel, so the collision latches of
+     * all 15 pairs are updated with a single AND chain. The CXxx registers
+     * are only derived from the latched bits when they are read.
      */
     void updateCollision();
 
@@ -724,6 +925,16 @@ class TIA : public Device
      */
     void cloneLastLine();
 
+    /**
+     * Update the hash of the given line of the back buffer.
+     */
+    void hashBackLine(uInt32 y);
+
+    /**
+     * Recalculate the line hashes of all buffers (e.g. after loading them).
+     */
+    void rehashBuffers();
+
     /**
      * Execute a delayed write. Called when the DelayQueue is pumped.
      */
@@ -785,8 +996,24 @@ class TIA : public Device
     */
     void updateDumpPorts(uInt8 value);
 
+    /**
+     * Save/load the TIA state into/from memory, e.g. for a capture.  A loaded
+     * state continues at the current system cycle.
+     */
+    bool saveState(ByteArray& state) const;
+    bool loadState(const ByteArray& state);
+
+    /**
+     * Run the replay instead of the CPU for up to the given number of cycles.
+     */
+    void updateReplay(DispatchResult& result, uInt64 maxCycles);
+
   #ifdef DEBUGGER_SUPPORT
     void createAccessArrays();
+
+    void recordRegisterWrite(uInt8 address, uInt8 value);
+    void startRegisterHistoryFrame();
+    void startLineBudgetFrame();
   #endif // DEBUGGER_SUPPORT
 
   private:
@@ -855,13 +1082,29 @@ class TIA : public Device
     LatchedInput myInput0;
     LatchedInput myInput1;
 
-    // Pointer to the internal color-index-based frame buffer
-    std::array<uInt8, static_cast<size_t>(TIAConstants::H_PIXEL * TIAConstants::frameBufferHeight)> myFramebuffer{};
+    using FrameBufferArray =
+      std::array<uInt8, static_cast<size_t>(TIAConstants::H_PIXEL * TIAConstants::frameBufferHeight)>;
+
+    // The frame is rendered to the backbuffer and only copied to the front
+    // buffer upon completion
+    FrameBufferArray myBackBuffer{};
 
-    // The frame is rendered to the backbuffer and only copied to the framebuffer
-    // upon completion
-    std::array<uInt8, static_cast<size_t>(TIAConstants::H_PIXEL * TIAConstants::frameBufferHeight)> myBackBuffer{};
-    std::array<uInt8, static_cast<size_t>(TIAConstants::H_PIXEL * TIAConstants::frameBufferHeight)> myFrontBuffer{};
+    // The internal color-index-based frame buffer (rendered by TIASurface while
+    // the emulation continues) and the front buffer. These swap roles in
+    // renderToFrameBuffer() instead of copying the frame.
+    std::array<FrameBufferArray, 2> myFrameBuffers{};
+    uInt8 myFramebufferIndex{0};
+
+    FrameBufferArray& renderBuffer() { return myFrameBuffers[myFramebufferIndex]; }
+    const FrameBufferArray& renderBuffer() const { return myFrameBuffers[myFramebufferIndex]; }
+    FrameBufferArray& frontBuffer() { return myFrameBuffers[myFramebufferIndex ^ 1]; }
+    const FrameBufferArray& frontBuffer() const { return myFrameBuffers[myFramebufferIndex ^ 1]; }
+
+    // The line hashes of the back buffer, updated whenever a line completes,
+    // and those of the two frame buffers above (swapped alongside them)
+    using LineHashArray = std::array<uInt64, TIAConstants::frameBufferHeight>;
+    LineHashArray myBackLineHashes{};
+    std::array<LineHashArray, 2> myFrameLineHashes{};
 
     // We snapshot frame statistics when the back buffer is copied to the front buffer
     // and when the front buffer is copied to the frame buffer
@@ -870,6 +1113,19 @@ class TIA : public Device
     // Frames since the last time a frame was rendered to the render buffer
     uInt32 myFramesSinceLastRender{0};
 
+    // Frames to skip between drawn frames, the skipped frames since the
+    // last drawn one, and whether the current frame is drawn at all
+    uInt32 myFrameSkip{0};
+    uInt32 myFramesSkipped{0};
+    bool mySkipFrame{false};
+
+    // Skip drawing any frames
+    bool mySkipDrawing{false};
+
+    // Whether to measure the real time spent in the TIA, and that time (ns)
+    bool myProfileTime{false};
+    uInt64 myProfiledTime{0};
+
     /**
      * Setting this to true randomizes TIA on reset.
      */
@@ -928,6 +1184,12 @@ class TIA : public Device
      */
     bool myMovementInProgress{false};
 
+    /**
+     * Is any movement related developer quirk enabled? If not, the objects
+     * are ticked without checking for these quirks.
+     */
+    bool myHasQuirks{false};
+
     /**
      * Do we have an extended hblank this line? Get set by strobing HMOVE and
      * cleared when the line wraps.
@@ -1023,6 +1285,28 @@ class TIA : public Device
      * System cycles used by WSYNC during current frame.
      */
     uInt64 myFrameWsyncCycles{0};
+
+    /**
+     * Ring buffer of the recorded register writes (empty when disabled).
+     * The write counters are never wrapped, only the indices into the ring.
+     */
+    static constexpr uInt32 REGISTER_HISTORY_SIZE = 1 << 15;  // ~2 frames
+    bool myRegisterHistoryEnabled{false};
+    RegisterWrites myRegisterHistory;
+    uInt64 myRegisterHistoryCount{0};
+    // Write counters at the start of the current and the last frame
+    uInt64 myRegisterHistoryFrameStart{0}, myRegisterHistoryLastStart{0};
+    // Register values at the start of the current and the last frame
+    std::array<uInt8, 64> myRegisterHistoryFrameRegs{},
+                          myRegisterHistoryLastRegs{};
+
+    /**
+     * Per scanline CPU budget of the current and the last frame (empty when
+     * disabled).  Lines beyond LINE_BUDGET_LINES are not recorded.
+     */
+    static constexpr uInt32 LINE_BUDGET_LINES = 512;
+    bool myLineBudgetEnabled{false};
+    vector<LineBudget> myLineBudget, myLineBudgetLast;
   #endif // DEBUGGER_SUPPORT
 
     /**
@@ -1032,6 +1316,14 @@ class TIA : public Device
     uInt8 myJitterSensitivity{0};
     uInt8 myJitterRecovery{0};
 
+    /**
+     * The register write capture and replay (if active), and the TIA state
+     * to return to after replaying.
+     */
+    unique_ptr<TIACapture> myCapture;
+    unique_ptr<TIAReplay> myReplay;
+    ByteArray myReplayReturnState;
+
     static constexpr uInt16
       TIA_SIZE = 0x40, TIA_MASK = TIA_SIZE - 1,
       TIA_READ_SIZE = 0x10, TIA_READ_MASK = TIA_READ_SIZE - 1,
@@ -0,0 +1,102 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2026 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+
+#ifdef ZIP_SUPPORT
+  #include <zlib.h>
+#endif
+
+#include "TIACapture.hxx"
+
+namespace {
+  void putInt(std::ofstream& out, uInt32 value)
+  {
+    const std::array<char, 4> bytes = {
+      static_cast<char>(value), static_cast<char>(value >> 8),
+      static_cast<char>(value >> 16), static_cast<char>(value >> 24)
+    };
+    out.write(bytes.data(), bytes.size());
+  }
+} // namespace
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool TIACapture::start(const string& path, const ByteArray& state, uInt64 cycle)
+{
+  stop();
+
+  myFile.open(path, std::ios_base::binary | std::ios_base::trunc);
+  if(!myFile)
+    return false;
+
+  myFile.write(MAGIC.data(), MAGIC.size());
+  myFile.put(static_cast<char>(VERSION));
+  putInt(myFile, static_cast<uInt32>(state.size()));
+  myFile.write(reinterpret_cast<const char*>(state.data()),
+               static_cast<std::streamsize>(state.size()));
+
+  // A write may overshoot the block size by a few bytes
+  myBlock.clear();
+  myBlock.reserve(BLOCK_SIZE + 16);
+  myLastCycle = cycle;
+  myCaptured = 0;
+
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt64 TIACapture::stop()
+{
+  if(!myFile.is_open())
+    return 0;
+
+  writeBlock();
+  myFile.close();
+
+  ByteArray().swap(myBlock);
+  ByteArray().swap(myPacked);
+
+  return myCaptured;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TIACapture::writeBlock()
+{
+  if(myBlock.empty())
+    return;
+
+  uInt8 compression = STORED;
+  const uInt8* data = myBlock.data();
+  size_t size = myBlock.size();
+#ifdef ZIP_SUPPORT
+  uLongf packedSize = compressBound(static_cast<uLong>(size));
+  myPacked.resize(packedSize);
+  if(compress2(myPacked.data(), &packedSize, data, static_cast<uLong>(size),
+               Z_BEST_SPEED) == Z_OK && packedSize < size)
+  {
+    compression = DEFLATED;
+    data = myPacked.data();
+    size = packedSize;
+  }
+#endif
+  putInt(myFile, static_cast<uInt32>(myBlock.size()));
+  putInt(myFile, static_cast<uInt32>(size));
+  myFile.put(static_cast<char>(compression));
+  myFile.write(reinterpret_cast<const char*>(data),
+               static_cast<std::streamsize>(size));
+
+  myBlock.clear();
+}
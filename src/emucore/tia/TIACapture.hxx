@@ -0,0 +1,116 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2026 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+
+#ifndef TIA_CAPTURE_HXX
+#define TIA_CAPTURE_HXX
+
+#include <fstream>
+
+#include "bspf.hxx"
+
+/**
+  This class captures the timestamped stream of TIA register writes into a
+  file, which TIAReplay can later feed straight back into a TIA (e.g. to
+  re-render a session with different video settings) without emulating the
+  CPU or the cartridge.
+
+  The file starts with this header (all values little endian):
+    "STIA", version (1 byte), TIA state size (4 bytes), TIA state
+  followed by blocks of writes:
+    raw size, stored size (4 bytes each),
+    compression (1 byte, 0 = none, 1 = zlib), stored data
+  Each write is stored as the system cycles since the previous write (or the
+  TIA state), 7 bits per byte with bit 7 set if more bytes follow, then the
+  register address and the value written.  Most writes take three bytes.
+
+  @author  Stella Team
+*/
+class TIACapture
+{
+  public:
+    static constexpr std::array<char, 4> MAGIC = { 'S', 'T', 'I', 'A' };
+    static constexpr uInt8 VERSION = 1;
+    static constexpr uInt8 STORED = 0, DEFLATED = 1;
+
+  public:
+    TIACapture() = default;
+    ~TIACapture() { stop(); }
+
+    /**
+      Start capturing into the given file, which is overwritten.
+
+      @param path   The capture file
+      @param state  The TIA state (see TIA::save()) the writes start from
+      @param cycle  The system cycle the state was saved at
+      @return  False if the file couldn't be created
+    */
+    bool start(const string& path, const ByteArray& state, uInt64 cycle);
+
+    /**
+      Stop capturing, and write all pending writes.
+
+      @return  The number of writes captured
+    */
+    uInt64 stop();
+
+    bool isCapturing() const { return myFile.is_open(); }
+    uInt64 captured() const { return myCaptured; }
+
+    /**
+      Add a register write; called by TIA::poke() for every write.
+    */
+    void write(uInt64 cycle, uInt8 address, uInt8 value) {
+      uInt64 delta = cycle - myLastCycle;
+
+      myLastCycle = cycle;
+      while(delta >= 0x80)
+      {
+        myBlock.push_back(static_cast<uInt8>(delta | 0x80));
+        delta >>= 7;
+      }
+      myBlock.push_back(static_cast<uInt8>(delta));
+      myBlock.push_back(address);
+      myBlock.push_back(value);
+      ++myCaptured;
+
+      if(myBlock.size() >= BLOCK_SIZE)
+        writeBlock();
+    }
+
+  private:
+    // Compress (if possible) and write the collected writes
+    void writeBlock();
+
+  private:
+    // Blocks are compressed on the emulation thread, so they are kept small
+    static constexpr size_t BLOCK_SIZE = 64 * 1024;
+
+    std::ofstream myFile;
+    ByteArray myBlock, myPacked;
+    uInt64 myLastCycle{0};
+    uInt64 myCaptured{0};
+
+  private:
+    // Following constructors and assignment operators not supported
+    TIACapture(const TIACapture&) = delete;
+    TIACapture(TIACapture&&) = delete;
+    TIACapture& operator=(const TIACapture&) = delete;
+    TIACapture& operator=(TIACapture&&) = delete;
+};
+
+#endif
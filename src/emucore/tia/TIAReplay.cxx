@@ -0,0 +1,175 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2026 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+
+#include <fstream>
+#include <iterator>
+
+#ifdef ZIP_SUPPORT
+  #include <zlib.h>
+#endif
+
+#include "M6502.hxx"
+#include "System.hxx"
+#include "TIA.hxx"
+#include "TIACapture.hxx"
+#include "TIAReplay.hxx"
+
+namespace {
+  uInt32 getInt(const ByteArray& data, size_t pos)
+  {
+    return data[pos] | (data[pos + 1] << 8) | (data[pos + 2] << 16) |
+      (static_cast<uInt32>(data[pos + 3]) << 24);
+  }
+} // namespace
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool TIAReplay::load(const string& path)
+{
+  std::ifstream in(path, std::ios_base::binary);
+  if(!in)
+    return false;
+
+  myFile.assign(std::istreambuf_iterator<char>(in),
+                std::istreambuf_iterator<char>());
+
+  constexpr size_t headerSize = TIACapture::MAGIC.size() + 1 + 4;
+  if(myFile.size() < headerSize ||
+     !std::equal(TIACapture::MAGIC.begin(), TIACapture::MAGIC.end(),
+                 myFile.begin()) ||
+     myFile[TIACapture::MAGIC.size()] != TIACapture::VERSION)
+    return false;
+
+  const uInt32 stateSize = getInt(myFile, headerSize - 4);
+  if(myFile.size() - headerSize < stateSize)
+    return false;
+
+  myState.assign(myFile.begin() + headerSize,
+                 myFile.begin() + headerSize + stateSize);
+  myFirstBlock = headerSize + stateSize;
+  rewind(0);
+
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TIAReplay::rewind(uInt64 cycle)
+{
+  myBlock.clear();
+  myBlockPos = 0;
+  myFilePos = myFirstBlock;
+  myPending = false;
+  myCycle = cycle;
+  myReplayed = 0;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool TIAReplay::run(TIA& tia, System& system, uInt64 maxCycles)
+{
+  const uInt64 endCycle = system.cycles() + maxCycles;
+  const uInt32 frames = tia.framesSinceLastRender();
+
+  // Like the CPU, stop after the write which completed the frame
+  while(tia.framesSinceLastRender() == frames)
+  {
+    if(!myPending && !(myPending = nextWrite()))
+      return false;
+
+    if(myCycle > endCycle)
+    {
+      system.incrementCycles(static_cast<uInt32>(endCycle - system.cycles()));
+      break;
+    }
+    // WSYNC stalls have already advanced the clock up to the next write
+    if(myCycle > system.cycles())
+      system.incrementCycles(static_cast<uInt32>(myCycle - system.cycles()));
+
+    tia.poke(myAddress, myValue);
+    // The CPU would release the halt right before its next read
+    if(myAddress == WSYNC)
+      system.m6502().serviceHalt();
+
+    myPending = false;
+    ++myReplayed;
+  }
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool TIAReplay::nextWrite()
+{
+  if(myBlockPos == myBlock.size() && !nextBlock())
+    return false;
+
+  uInt64 delta = 0;
+  for(uInt32 shift = 0; ; shift += 7)
+  {
+    if(myBlockPos == myBlock.size() || shift > 63)
+      return false;
+
+    const uInt8 byte = myBlock[myBlockPos++];
+    delta |= static_cast<uInt64>(byte & 0x7f) << shift;
+    if(!(byte & 0x80))
+      break;
+  }
+  if(myBlock.size() - myBlockPos < 2)
+    return false;
+
+  myCycle += delta;
+  myAddress = myBlock[myBlockPos++];
+  myValue = myBlock[myBlockPos++];
+
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool TIAReplay::nextBlock()
+{
+  constexpr size_t headerSize = 4 + 4 + 1;
+
+  if(myFile.size() - myFilePos < headerSize)
+    return false;
+
+  const uInt32 rawSize = getInt(myFile, myFilePos);
+  const uInt32 storedSize = getInt(myFile, myFilePos + 4);
+  const uInt8 compression = myFile[myFilePos + 8];
+  const size_t dataPos = myFilePos + headerSize;
+
+  if(myFile.size() - dataPos < storedSize || rawSize == 0)
+    return false;
+
+  if(compression == TIACapture::STORED && storedSize == rawSize)
+    myBlock.assign(myFile.begin() + dataPos,
+                   myFile.begin() + dataPos + storedSize);
+#ifdef ZIP_SUPPORT
+  else if(compression == TIACapture::DEFLATED)
+  {
+    myBlock.resize(rawSize);
+    uLongf size = rawSize;
+    if(uncompress(myBlock.data(), &size, myFile.data() + dataPos,
+                  storedSize) != Z_OK || size != rawSize)
+      return false;
+  }
+#endif
+  else
+    return false;
+
+  myBlockPos = 0;
+  myFilePos = dataPos + storedSize;
+
+  return true;
+}
@@ -0,0 +1,105 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2026 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+
+#ifndef TIA_REPLAY_HXX
+#define TIA_REPLAY_HXX
+
+class System;
+class TIA;
+
+#include "bspf.hxx"
+
+/**
+  This class feeds a register write stream captured by TIACapture back into
+  a TIA.  Only the TIA is emulated while replaying; the CPU, RIOT and the
+  cartridge (including any ARM code) are skipped, and the system clock
+  simply jumps to the cycle of each write.  Re-rendering a capture is
+  therefore only bound by the speed of the TIA itself.
+
+  The complete (compressed) file is kept in memory, and decoded one block
+  at a time.
+
+  @author  Stella Team
+*/
+class TIAReplay
+{
+  public:
+    TIAReplay() = default;
+    ~TIAReplay() = default;
+
+    /**
+      Load a capture file created by TIACapture.
+
+      @return  False if the file isn't a valid capture file
+    */
+    bool load(const string& path);
+
+    /**
+      The TIA state (see TIA::save()) the capture starts from.
+    */
+    const ByteArray& state() const { return myState; }
+
+    /**
+      Restart at the first write of the capture.
+
+      @param cycle  The system cycle the TIA state was loaded at
+    */
+    void rewind(uInt64 cycle);
+
+    /**
+      Feed the captured writes into the TIA, until it completes a frame or
+      the given number of system cycles has passed.
+
+      @return  False if the end of the capture was reached
+    */
+    bool run(TIA& tia, System& system, uInt64 maxCycles);
+
+    uInt64 replayed() const { return myReplayed; }
+
+  private:
+    // Decode the next write, or answer false at the end of the capture
+    bool nextWrite();
+
+    // Decode the next block of writes
+    bool nextBlock();
+
+  private:
+    ByteArray myFile;
+    ByteArray myState;
+    size_t myFirstBlock{0};
+
+    // The current block, and the position of the next one in the file
+    ByteArray myBlock;
+    size_t myBlockPos{0}, myFilePos{0};
+
+    // The next write, if already decoded
+    bool myPending{false};
+    uInt64 myCycle{0};
+    uInt8 myAddress{0}, myValue{0};
+
+    uInt64 myReplayed{0};
+
+  private:
+    // Following constructors and assignment operators not supported
+    TIAReplay(const TIAReplay&) = delete;
+    TIAReplay(TIAReplay&&) = delete;
+    TIAReplay& operator=(const TIAReplay&) = delete;
+    TIAReplay& operator=(TIAReplay&&) = delete;
+};
+
+#endif
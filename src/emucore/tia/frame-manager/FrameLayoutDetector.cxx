@@ -145,7 +145,8 @@ FrameLayout FrameLayoutDetector::detectedLayout(bool detectPal60,
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-FrameLayoutDetector::FrameLayoutDetector()
+FrameLayoutDetector::FrameLayoutDetector(bool sampleColors)
+  : mySampleColors{sampleColors}
 {
   reset();
 }
@@ -157,7 +158,7 @@ void FrameLayoutDetector::onReset()
   myNtscFrameSum = myPalFrameSum = 0;
   myLinesWaitingForVsyncToStart = 0;
   myColorCount.fill(0);
-  myIsRendering = true;
+  myIsRendering = mySampleColors;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -33,7 +33,12 @@ class FrameLayoutDetector: public AbstractFrameManager
 {
   public:
 
-    FrameLayoutDetector();
+    /**
+     * Create a detector.  If color sampling is disabled, the detector only
+     * counts scanlines and frames, and the TIA doesn't render any pixels
+     * while it is active.
+     */
+    explicit FrameLayoutDetector(bool sampleColors = true);
     ~FrameLayoutDetector() override = default;
 
   public:
@@ -117,6 +122,11 @@ class FrameLayoutDetector: public AbstractFrameManager
      */
     State myState{State::waitForVsyncStart};
 
+    /**
+     * Are pixel colors sampled (only required for PAL60/NTSC50 detection)?
+     */
+    bool mySampleColors{true};
+
     // The aggregated likelynesses of respective two frame layouts.
     double myNtscFrameSum{0}, myPalFrameSum{0};
 
@@ -2,6 +2,8 @@ MODULE := src/emucore/tia
 
 MODULE_OBJS := \
 	src/emucore/tia/TIA.o \
+	src/emucore/tia/TIACapture.o \
+	src/emucore/tia/TIAReplay.o \
 	src/emucore/tia/Playfield.o \
 	src/emucore/tia/DrawCounterDecodes.o \
 	src/emucore/tia/Missile.o \
@@ -914,6 +914,7 @@ void DeveloperDialog::loadConfig()
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void DeveloperDialog::saveConfig()
 {
+  const auto batch = instance().settings().batch();
   const bool devSettings = mySettingsGroupEmulation->getSelected() == SettingsSet::developer;
 
   instance().settings().setValue("dev.settings", devSettings);
@@ -1026,6 +1027,9 @@ void DeveloperDialog::setDefaults()
       myUncompressed[set] = devSettings ? 600 : 60;
       myStateInterval[set] = devSettings ? "1f" : "30f";
       myStateHorizon[set] = devSettings ? "30s" : "10m";
+      myStateDelta[set] = true;
+      myStateBudget[set] = 0;
+      myStateBudgetMem[set] = 0;
 
       setWidgetStates(set);
       break;
@@ -83,7 +83,7 @@ EmulationDialog::EmulationDialog(OSystem& osystem, DialogContainer& parent,
 
   // Set real dimensions
   _w = 37 * fontWidth + HBORDER * 2 + CheckboxWidget::prefixSize(_font);
-  _h = 13 * (lineHeight + VGAP) + VGAP * 7 + VBORDER * 3 + _th + buttonHeight;
+  _h = 15 * (lineHeight + VGAP) + VGAP * 7 + VBORDER * 3 + _th + buttonHeight;
 
   int xpos = HBORDER, ypos = VBORDER + _th;
 
@@ -104,6 +104,21 @@ EmulationDialog::EmulationDialog(OSystem& osystem, DialogContainer& parent,
   wid.push_back(myUseVSync);
   ypos += lineHeight + VGAP;
 
+  // Emulate frames just in time before presenting them
+  myLateLatch = new CheckboxWidget(this, _font, xpos + INDENT, ypos + 1, "Late-latch frames");
+  myLateLatch->setToolTip("Check to emulate each frame just before it is\n"
+                          "displayed, reducing the input latency.");
+  wid.push_back(myLateLatch);
+  ypos += lineHeight + VGAP;
+
+  // Sample analog controllers during late-latched frames
+  myAnalogPoll = new CheckboxWidget(this, _font, xpos + INDENT * 2, ypos + 1,
+                                    "Sample analog axes at 1 kHz");
+  myAnalogPoll->setToolTip("Check to update analog paddle positions\n"
+                           "during late-latched frames too.");
+  wid.push_back(myAnalogPoll);
+  ypos += lineHeight + VGAP;
+
 
   myTurbo = new CheckboxWidget(this, _font, xpos, ypos + 1, "Turbo mode");
   myTurbo->setToolTip(Event::ToggleTurbo);
@@ -181,6 +196,8 @@ void EmulationDialog::loadConfig()
 
   // Use sync to vertical blank
   myUseVSync->setState(settings.getBool("vsync"));
+  myLateLatch->setState(settings.getBool("latelatch"));
+  myAnalogPoll->setState(settings.getBool("analogpoll"));
 
   // Enable 'Turbo' mode
   myTurbo->setState(settings.getBool("turbo"));
@@ -211,6 +228,7 @@ void EmulationDialog::loadConfig()
 void EmulationDialog::saveConfig()
 {
   Settings& settings = instance().settings();
+  const auto batch = settings.batch();
 
   // Speed
   const int speedup = mySpeed->getValue();
@@ -220,6 +238,8 @@ void EmulationDialog::saveConfig()
 
   // Use sync to vertical blank
   settings.setValue("vsync", myUseVSync->getState());
+  settings.setValue("latelatch", myLateLatch->getState());
+  settings.setValue("analogpoll", myAnalogPoll->getState());
 
   // Enable 'Turbo' mode
   settings.setValue("turbo", myTurbo->getState());
@@ -254,7 +274,7 @@ void EmulationDialog::saveConfig()
     instance().console().initializeVideo();
     instance().createFrameBuffer();
 
-    instance().frameBuffer().tiaSurface().ntsc().enableThreading(myUseThreads->getState());
+    instance().frameBuffer().tiaSurface().enableThreading(myUseThreads->getState());
   }
 }
 
@@ -264,6 +284,8 @@ void EmulationDialog::setDefaults()
   // speed
   mySpeed->setValue(0);
   myUseVSync->setState(true);
+  myLateLatch->setState(false);
+  myAnalogPoll->setState(false);
   // misc
   myUIMessages->setState(true);
   myFastSCBios->setState(true);
@@ -39,6 +39,8 @@ class EmulationDialog : public Dialog
   private:
     SliderWidget*     mySpeed{nullptr};
     CheckboxWidget*   myUseVSync{nullptr};
+    CheckboxWidget*   myLateLatch{nullptr};
+    CheckboxWidget*   myAnalogPoll{nullptr};
     CheckboxWidget*   myTurbo{nullptr};
     CheckboxWidget*   myUIMessages{nullptr};
     CheckboxWidget*   myFastSCBios{nullptr};
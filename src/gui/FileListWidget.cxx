@@ -15,12 +15,18 @@
 // this file, and for a DISCLAIMER OF ALL WARRANTIES.
 //============================================================================
 
+#include <ctime>
+
 #include "bspf.hxx"
 #include "ScrollBarWidget.hxx"
 #include "TimerManager.hxx"
 #include "ProgressDialog.hxx"
 #include "FBSurface.hxx"
 #include "Bankswitch.hxx"
+#include "OSystem.hxx"
+#include "DirectoryIndex.hxx"
+#include "PropsSet.hxx"
+#include "SearchIndex.hxx"
 
 #include "FileListWidget.hxx"
 
@@ -34,6 +40,9 @@ FileListWidget::FileListWidget(GuiObject* boss, const GUI::Font& font,
   setTarget(this);
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+FileListWidget::~FileListWidget() = default;
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void FileListWidget::setDirectory(const FSNode& node, string_view select)
 {
@@ -89,39 +98,98 @@ void FileListWidget::setLocation(const FSNode& node, string_view select)
 
   getChildren(isCancelled);
 
+  // Any pattern applies to the new contents
+  _allFiles = std::move(_fileList);
+  _searchIndex.reset();
+
   // Now fill the list widget with the names from the file list,
   // even if cancelled
+  updateList(select);
+
+  progress().close();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void FileListWidget::setPattern(string_view pattern)
+{
+  if(pattern == _pattern)
+    return;
+
+  _pattern = pattern;
+
+  // Keep the selection, if it is still shown
+  const string selected = getSelectedString();
+  updateList(selected);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void FileListWidget::updateList(string_view select)
+{
+  _fileList.clear();
+
+  if(_pattern.empty())
+    _fileList = _allFiles;
+  else
+  {
+    if(_searchIndex == nullptr)
+    {
+      // Index the files (but not the directories) by name and the
+      // additional search terms
+      _searchIndex = std::make_unique<SearchIndex>();
+
+      StringList terms;
+      for(uInt32 i = 0; i < _allFiles.size(); ++i)
+      {
+        const FSNode& file = _allFiles[i];
+        if(file.isDirectory())
+          continue;
+
+        _searchIndex->add(i, file.getName());
+        if(_searchTerms)
+        {
+          terms.clear();
+          _searchTerms(file, terms);
+          for(const auto& term: terms)
+            _searchIndex->add(i, term);
+        }
+      }
+    }
+    const std::vector<uInt32> matches = _searchIndex->find(_pattern);
+    auto match = matches.cbegin();
+
+    for(uInt32 i = 0; i < _allFiles.size(); ++i)
+    {
+      if(match != matches.cend() && *match == i)
+      {
+        _fileList.push_back(_allFiles[i]);
+        ++match;
+      }
+      else if(_allFiles[i].isDirectory())
+        _fileList.push_back(_allFiles[i]);
+    }
+  }
+
+  // Determining the icon types requires checking each entry, so this is
+  // deferred until an entry is actually displayed.
   StringList list;
-  const size_t orgLen = _node.getShortPath().length();
 
-  _dirList.clear();
+  list.reserve(_fileList.size());
   _iconTypeList.clear();
+  _iconTypeList.reserve(_fileList.size());
 
   for(const auto& file : _fileList)
   {
-    const string& path = file.getShortPath();
     const string& name = file.getName();
 
-    // display only relative path in tooltip
-    if(path.length() >= orgLen && !fullPathToolTip())
-      _dirList.push_back(path.substr(orgLen));
-    else
-      _dirList.push_back(path);
-
     if(file.isDirectory() && !BSPF::endsWithIgnoreCase(name, ".zip"))
     {
       list.push_back(name);
-      if(name == "..")
-        _iconTypeList.push_back(IconType::updir);
-      else
-        _iconTypeList.push_back(getIconType(file.getPath()));
+      _iconTypeList.push_back(name == ".." ? IconType::updir : IconType::pending);
     }
     else
     {
-      const string& displayName = _showFileExtensions ? name : file.getNameWithExt(EmptyString());
-
-      list.push_back(displayName);
-      _iconTypeList.push_back(getIconType(file.getPath()));
+      list.push_back(_showFileExtensions ? name : file.getNameWithExt(EmptyString()));
+      _iconTypeList.push_back(IconType::pending);
     }
   }
   extendLists(list);
@@ -129,8 +197,6 @@ void FileListWidget::setLocation(const FSNode& node, string_view select)
   setList(list);
   setSelected(select);
   ListWidget::recalc();
-
-  progress().close();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -144,22 +210,36 @@ void FileListWidget::getChildren(const FSNode::CancelCheck& isCancelled)
 {
   if(_includeSubDirs)
   {
-    // Actually this could become HUGE
+    // Actually this could become HUGE, so only changed directories are read
     _fileList.reserve(0x2000);
-    _node.getAllChildren(_fileList, _fsmode, _filter, true, isCancelled);
+    instance().directoryIndex().getAllChildren(_node, _fileList, _fsmode,
+        _filter, true, isCancelled);
   }
   else
   {
     _fileList.reserve(0x200);
-    _node.getChildren(_fileList, _fsmode, _filter, false, true, isCancelled);
+
+    // Note the per-ROM properties files passing by, so that selecting a
+    // ROM doesn't have to check for its file separately
+    FSList proFiles;
+    const uInt64 modified = _node.getLastModified();
+    const auto listed = static_cast<uInt64>(std::time(nullptr));
+    const auto filter = [&](const FSNode& node) {
+      if(BSPF::endsWithIgnoreCase(node.getName(), ".pro"))
+        proFiles.push_back(node);
+      return _filter(node);
+    };
+
+    if(_node.getChildren(_fileList, _fsmode, filter, false, true, isCancelled) &&
+       _fsmode != FSNode::ListMode::DirectoriesOnly)
+      instance().propSet().addPerROMFiles(_node.getPath(), modified, listed,
+                                          proFiles);
   }
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-FileListWidget::IconType FileListWidget::getIconType(string_view path) const
+FileListWidget::IconType FileListWidget::getIconType(const FSNode& node) const
 {
-  const FSNode node(path);
-
   if(node.isDirectory())
   {
     return BSPF::endsWithIgnoreCase(node.getName(), ".zip")
@@ -170,6 +250,17 @@ FileListWidget::IconType FileListWidget::getIconType(string_view path) const
       ? IconType::rom : IconType::unknown;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+FileListWidget::IconType FileListWidget::iconType(int i) const
+{
+  IconType& type = _iconTypeList[i];
+
+  if(type == IconType::pending)
+    type = getIconType(_fileList[i]);
+
+  return type;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void FileListWidget::selectDirectory()
 {
@@ -383,13 +474,17 @@ bool FileListWidget::handleText(char text)
   for(const auto& i : _list)
   {
     if(BSPF::startsWithIgnoreCase(i, _quickSelectStr))
+    {
       // Select directories when the first character is uppercase
+      const IconType type = iconType(selectedItem);
+
       if(firstShift ==
-          (_iconTypeList[selectedItem] == IconType::directory
-          || _iconTypeList[selectedItem] == IconType::userdir
-          || _iconTypeList[selectedItem] == IconType::recentdir
-          || _iconTypeList[selectedItem] == IconType::popdir))
+          (type == IconType::directory
+          || type == IconType::userdir
+          || type == IconType::recentdir
+          || type == IconType::popdir))
         break;
+    }
     selectedItem++;
   }
 
@@ -693,11 +788,11 @@ const FileListWidget::Icon* FileListWidget::getIcon(int i) const
     &unknown_large, &rom_large, &directory_large, &zip_large, &up_large,
   };
   const bool smallIcon = iconWidth() < 24;
-  const int iconType = static_cast<int>(_iconTypeList[i]);
+  const int type = static_cast<int>(iconType(i));
 
-  assert(iconType < idx);
+  assert(type < idx);
 
-  return smallIcon ? small_icons[iconType] : large_icons[iconType];
+  return smallIcon ? small_icons[type] : large_icons[type];
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -717,8 +812,23 @@ string FileListWidget::getToolTip(const Common::Point& pos) const
   if(idx < 0)
     return EmptyString();
 
-  if(_includeSubDirs && std::cmp_greater(_dirList.size(), idx))
-    return _toolTipText + _dirList[idx];
+  if(_includeSubDirs && std::cmp_greater(_fileList.size(), idx))
+  {
+    // Virtual folders have no path to display
+    const IconType type = _iconTypeList[idx];
+    if(type == IconType::userdir || type == IconType::recentdir
+       || type == IconType::popdir)
+      return _toolTipText;
+
+    // Display only relative path in tooltip
+    const string& path = _fileList[idx].getShortPath();
+    const size_t orgLen = _node.getShortPath().length();
+
+    if(path.length() >= orgLen && !fullPathToolTip())
+      return _toolTipText + path.substr(orgLen);
+    else
+      return _toolTipText + path;
+  }
 
   const string value = _list[idx];
 
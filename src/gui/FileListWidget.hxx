@@ -20,6 +20,7 @@
 
 class CommandSender;
 class ProgressDialog;
+class SearchIndex;
 
 #include "FSNode.hxx"
 #include "Stack.hxx"
@@ -51,11 +52,12 @@ class FileListWidget : public StringListWidget
       kNextDirCmd   = 'nxtc'   // go back in history to next directory
     };
     using IconTypeFilter = std::function<bool(const FSNode& node)>;
+    using SearchTerms = std::function<void(const FSNode& node, StringList& terms)>;
 
   public:
     FileListWidget(GuiObject* boss, const GUI::Font& font,
                    int x, int y, int w, int h);
-    ~FileListWidget() override = default;
+    ~FileListWidget() override;
 
     bool handleKeyDown(StellaKey key, StellaMod mod) override;
     bool handleText(char text) override;
@@ -69,6 +71,17 @@ class FileListWidget : public StringListWidget
       _filter = filter;
     }
 
+    /** Provide additional texts (besides the name) a file can be found by */
+    void setSearchTerms(const SearchTerms& terms) { _searchTerms = terms; }
+
+    /**
+      Only show the files matching the given pattern (directories are always
+      shown).  Unlike the name filter, this doesn't read the directory again.
+
+        @param pattern  The pattern, may contain '*' and '?' as wildcards
+    */
+    void setPattern(string_view pattern);
+
     // When enabled, all subdirectories will be searched too.
     void setIncludeSubDirs(bool enable) { _includeSubDirs = enable; }
 
@@ -101,6 +114,9 @@ class FileListWidget : public StringListWidget
     /** Gets current node(s) */
     const FSNode& selected();
     const FSNode& currentDir() const { return _node; }
+    const FSList& fileList() const { return _fileList; }
+    /** Gets all nodes, including the ones not matching the pattern */
+    const FSList& allFiles() const { return _allFiles; }
 
     static void setQuickSelectDelay(uInt64 time) { S_QUICK_SELECT_DELAY = time; }
     static uInt64 getQuickSelectDelay() { return S_QUICK_SELECT_DELAY; }
@@ -132,6 +148,7 @@ class FileListWidget : public StringListWidget
       userdir,
       recentdir,
       popdir,
+      pending,    // not determined yet, see iconType()
       numLauncherTypes = popdir - numTypes + 1
     };
     using IconTypeList = std::vector<IconType>;
@@ -140,6 +157,8 @@ class FileListWidget : public StringListWidget
   protected:
     /** Very similar to setDirectory(), but also updates the history */
     void setLocation(const FSNode& node, string_view select);
+    /** Fill the list from the nodes matching the pattern */
+    void updateList(string_view select);
     /** Select to home directory */
     void selectHomeDir();
     /** Select previous directory in history (if applicable) */
@@ -148,7 +167,9 @@ class FileListWidget : public StringListWidget
     void selectNextHistory();
     virtual void getChildren(const FSNode::CancelCheck& isCancelled);
     virtual void extendLists(StringList& list) { }
-    virtual IconType getIconType(string_view path) const;
+    virtual IconType getIconType(const FSNode& node) const;
+    /** Get the icon type of the given entry, determining it on first use */
+    IconType iconType(int i) const;
     virtual const Icon* getIcon(int i) const;
     int iconWidth() const;
     virtual bool fullPathToolTip() const { return false; }
@@ -162,18 +183,23 @@ class FileListWidget : public StringListWidget
     FSNode _node;
     FSList _fileList;
     FSNode::NameFilter _filter;
+    FSList _allFiles;  // all nodes passing the filter, _fileList are the shown ones
     string _selectedFile;
-    StringList _dirList;
     std::vector<HistoryType> _history;
     int _historyHome{0}; // offset into initially created history
     std::vector<HistoryType>::iterator _currentHistory{_history.begin()};
-    IconTypeList _iconTypeList;
+    // Icon types are only determined for the entries actually drawn
+    mutable IconTypeList _iconTypeList;
 
   private:
     FSNode::ListMode _fsmode{FSNode::ListMode::All};
     bool _includeSubDirs{false};
     bool _showFileExtensions{true};
 
+    string _pattern;
+    SearchTerms _searchTerms;
+    unique_ptr<SearchIndex> _searchIndex;  // built when first searched
+
     uInt32 _selected{0};
 
     // Allow quick select for "uppercase", non-letter input
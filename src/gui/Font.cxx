@@ -28,6 +28,38 @@ namespace GUI {
 Font::Font(const FontDesc& desc)
   : myFontDesc{desc}
 {
+  myGlyphRunStart.reserve(static_cast<size_t>(desc.size) + 1);
+
+  for(int glyph = 0; glyph < desc.size; ++glyph)
+  {
+    myGlyphRunStart.push_back(static_cast<uInt32>(myGlyphRuns.size()));
+
+    const int bbw = desc.bbx ? desc.bbx[glyph].w : desc.fbbw;  // NOLINT
+    const int bbh = desc.bbx ? desc.bbx[glyph].h : desc.fbbh;  // NOLINT
+    const uInt16* bits = desc.bits +
+      (desc.offset ? desc.offset[glyph] : (glyph * desc.fbbh));  // NOLINT
+
+    for(int y = 0; y < bbh; ++y)
+    {
+      const uInt16 row = bits[y];  // NOLINT
+
+      for(int x = 0; x < bbw; )
+      {
+        if(!(row & (0x8000 >> x)))
+        {
+          ++x;
+          continue;
+        }
+
+        const int start = x;
+        while(x < bbw && (row & (0x8000 >> x)))
+          ++x;
+        myGlyphRuns.push_back({static_cast<uInt8>(start), static_cast<uInt8>(y),
+                               static_cast<uInt8>(x - start)});
+      }
+    }
+  }
+  myGlyphRunStart.push_back(static_cast<uInt32>(myGlyphRuns.size()));
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
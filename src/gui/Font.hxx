@@ -21,6 +21,8 @@
 #ifndef FONT_HXX
 #define FONT_HXX
 
+#include <span>
+
 #include "bspf.hxx"
 
 struct BBX
@@ -54,6 +56,15 @@ namespace GUI {
 
 class Font
 {
+  public:
+    // A horizontal run of set pixels, relative to the glyph's bounding box
+    struct GlyphRun
+    {
+      uInt8 x{0};
+      uInt8 y{0};
+      uInt8 w{0};
+    };
+
   public:
     explicit Font(const FontDesc& desc);
     ~Font() = default;
@@ -68,9 +79,32 @@ class Font
 
     int getStringWidth(string_view str) const;
 
+    /**
+      Get the number of bytes used by the precomputed glyph runs.
+    */
+    size_t memoryUsage() const {
+      return myGlyphRuns.capacity() * sizeof(GlyphRun) +
+             myGlyphRunStart.capacity() * sizeof(uInt32);
+    }
+
+    /**
+      Get the pixel runs of a glyph, which are precomputed from the bitmap
+      data, so that a glyph can be drawn without testing each pixel.
+
+      @param glyph  The index of the glyph (i.e. character - firstchar)
+    */
+    std::span<const GlyphRun> glyphRuns(uInt32 glyph) const {
+      return {myGlyphRuns.data() + myGlyphRunStart[glyph],
+              myGlyphRuns.data() + myGlyphRunStart[glyph + 1]};
+    }
+
   private:
     FontDesc myFontDesc;
 
+    // The runs of all glyphs, and the start of each glyph's runs in there
+    vector<GlyphRun> myGlyphRuns;
+    vector<uInt32> myGlyphRunStart;
+
   private:
     // Following constructors and assignment operators not supported
     Font() = delete;
@@ -451,6 +451,7 @@ void InputDialog::loadConfig()
 void InputDialog::saveConfig()
 {
   Settings& settings = instance().settings();
+  const auto batch = settings.batch();
 
   // *** Device & Ports ***
   // Digital dead zone
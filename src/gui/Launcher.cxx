@@ -42,7 +42,8 @@ Launcher::Launcher(OSystem& osystem)
   mySize.w = std::min(mySize.w, static_cast<uInt32>(d.w * overscan));
   mySize.h = std::min(mySize.h, static_cast<uInt32>(d.h * overscan));
 
-  myBaseDialog = new LauncherDialog(myOSystem, *this, 0, 0, mySize.w, mySize.h);
+  // The dialog itself is only created when the launcher is first used
+  // (not at all when a ROM is started from the commandline)
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -61,35 +62,39 @@ FBInitStatus Launcher::initializeVideo()
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 const string& Launcher::selectedRom()
 {
-  return (static_cast<LauncherDialog*>(myBaseDialog))->selectedRom();
+  return (static_cast<LauncherDialog*>(baseDialog()))->selectedRom();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 const string& Launcher::selectedRomMD5()
 {
-  return (static_cast<LauncherDialog*>(myBaseDialog))->selectedRomMD5();
+  return (static_cast<LauncherDialog*>(baseDialog()))->selectedRomMD5();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-const FSNode& Launcher::currentDir() const
+const FSNode& Launcher::currentDir()
 {
-  return (static_cast<LauncherDialog*>(myBaseDialog))->currentDir();
+  return (static_cast<LauncherDialog*>(baseDialog()))->currentDir();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void Launcher::reload()
 {
-  (static_cast<LauncherDialog*>(myBaseDialog))->reload();
+  (static_cast<LauncherDialog*>(baseDialog()))->reload();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void Launcher::quit()
 {
-  (static_cast<LauncherDialog*>(myBaseDialog))->quit();
+  if(myBaseDialog != nullptr)
+    (static_cast<LauncherDialog*>(myBaseDialog))->quit();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 Dialog* Launcher::baseDialog()
 {
+  if(myBaseDialog == nullptr)
+    myBaseDialog = new LauncherDialog(myOSystem, *this, 0, 0, mySize.w, mySize.h);
+
   return myBaseDialog;
 }
@@ -58,7 +58,7 @@ class Launcher : public DialogContainer
     /**
       Wrapper for LauncherDialog::currentDir() method.
     */
-    const FSNode& currentDir() const;
+    const FSNode& currentDir();
 
     /**
       Wrapper for LauncherDialog::reload() method.
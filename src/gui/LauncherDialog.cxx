@@ -44,6 +44,7 @@
 #include "StellaKeys.hxx"
 #include "Props.hxx"
 #include "PropsSet.hxx"
+#include "RomIndex.hxx"
 #include "RomImageWidget.hxx"
 #include "RomInfoWidget.hxx"
 #include "TIAConstants.hxx"
@@ -418,15 +419,8 @@ const string& LauncherDialog::selectedRomMD5()
   if(currentNode().isDirectory() || !Bankswitch::isValidRomName(currentNode()))
     return EmptyString();
 
-  // Attempt to conserve memory
-  if(myMD5List.size() > 500)
-    myMD5List.clear();
-
-  // Lookup MD5, and if not present, cache it
-  if(!myMD5List.contains(currentNode().getPath()))
-    myMD5List[currentNode().getPath()] = OSystem::getROMMD5(currentNode());
-
-  return myMD5List[currentNode().getPath()];
+  // Lookup MD5 in the ROM index, which examines the ROM if necessary
+  return instance().romIndex().get(currentNode()).md5;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -446,10 +440,8 @@ void LauncherDialog::reload()
 {
   const bool extensions = instance().settings().getBool("launcherextensions");
 
-  myMD5List.clear();
   myList->setShowFileExtensions(extensions);
   myList->reload();
-  myPendingReload = false;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -469,12 +461,12 @@ void LauncherDialog::quit()
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void LauncherDialog::tick()
 {
-  if(myPendingReload && myReloadTime < TimerManager::getTicks() / 1000)
-    reload();
-
   if(myPendingRomInfo && myRomInfoTime < TimerManager::getTicks() / 1000)
     loadPendingRomInfo();
 
+  // Store what the ROM index scanner found meanwhile
+  instance().romIndex().save();
+
   Dialog::tick();
 }
 
@@ -548,6 +540,9 @@ void LauncherDialog::updateUI()
     << (myShortCount ? " items" : " items found");
   myRomCount->setLabel(buf.view());
 
+  // Examine the ROMs of the current directory in the background
+  instance().romIndex().scan(myList->allFiles());
+
   loadRomInfo();
 }
 
@@ -560,19 +555,6 @@ string LauncherDialog::getRomDir()
   return tmpromdir != EmptyString() ? tmpromdir : settings.getString("romdir");
 }
 
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool LauncherDialog::matchWithWildcardsIgnoreCase(
-    string_view str, string_view pattern)
-{
-  string in{str};
-  string pat{pattern};
-
-  BSPF::toUpperCase(in);
-  BSPF::toUpperCase(pat);
-
-  return BSPF::matchWithWildcards(in, pat);
-}
-
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void LauncherDialog::applyFiltering()
 {
@@ -586,15 +568,22 @@ void LauncherDialog::applyFiltering()
         if(!Bankswitch::isValidRomName(node, ext) ||
            BSPF::compareIgnoreCase(ext, "zip") == 0) // exclude ZIPs without any valid ROMs
           return false;
-
-        // Skip over files that don't match the pattern in the 'pattern' textbox
-        if(myPattern && !myPattern->getText().empty() &&
-           !matchWithWildcardsIgnoreCase(node.getName(), myPattern->getText()))
-          return false;
       }
       return true;
     }
   );
+  // The pattern in the 'pattern' textbox also matches the names and
+  // manufacturers of ROMs already in the ROM index
+  myList->setSearchTerms(
+    [&](const FSNode& node, StringList& terms) {
+      if(const string md5 = instance().romIndex().knownMD5(node); !md5.empty())
+      {
+        const PropertiesSet& propSet = instance().propSet();
+        propSet.getProperty(md5, PropType::Cart_Name, terms.emplace_back());
+        propSet.getProperty(md5, PropType::Cart_Manufacturer, terms.emplace_back());
+      }
+    }
+  );
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -696,6 +685,38 @@ void LauncherDialog::loadRomInfo()
     myRomImageWidget->clearProperties();
     myRomInfoWidget->clearProperties();
   }
+  prefetchRomImages();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void LauncherDialog::prefetchRomImages()
+{
+  const FSList& files = myList->fileList();
+  const int selected = myList->getSelected();
+  StringList names;
+
+  // Closest rows first, so that scrolling in either direction benefits;
+  // only ROMs already in the index are considered, to avoid examining them
+  for(int i = 1; i <= PREFETCH_ROWS; ++i)
+  {
+    for(const int row: {selected + i, selected - i})
+    {
+      if(row < 0 || row >= static_cast<int>(files.size()))
+        continue;
+
+      const FSNode& node = files[row];
+      if(node.isDirectory() || !Bankswitch::isValidRomName(node))
+        continue;
+
+      if(const string md5 = instance().romIndex().knownMD5(node); !md5.empty())
+      {
+        instance().propSet().getProperty(md5, PropType::Cart_Name,
+                                         names.emplace_back());
+      }
+      names.push_back(node.getName());
+    }
+  }
+  myRomImageWidget->prefetchImages(names);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -1011,21 +1032,9 @@ void LauncherDialog::handleCommand(CommandSender* sender, int cmd,
 
     case EditableWidget::kChangedCmd:
     case EditableWidget::kAcceptCmd:
-    {
-      const bool subDirs = instance().settings().getBool("launchersubdirs");
-
-      myList->setIncludeSubDirs(subDirs);
-      if(subDirs && cmd == EditableWidget::kChangedCmd)
-      {
-        // delay (potentially slow) subdirectories reloads until user stops typing
-        myReloadTime = TimerManager::getTicks() / 1000 +
-          LauncherFileListWidget::getQuickSelectDelay();
-        myPendingReload = true;
-      }
-      else
-        reload();
+      // Only filters the current contents, so this is fast enough for typing
+      myList->setPattern(myPattern->getText());
       break;
-    }
 
     case kQuitCmd:
       handleQuit();
@@ -1101,17 +1110,36 @@ void LauncherDialog::loadRom()
   myList->updateFavorites();
   saveConfig();
 
-  const string& result = instance().createConsole(currentNode(), selectedRomMD5());
-  if(result == EmptyString())
+  // Reading the ROM and creating the cartridge happen in the background,
+  // while the launcher keeps running
+  if(myLoadProgress == nullptr)
+    myLoadProgress = std::make_unique<ProgressDialog>(this, _font,
+      "        Loading ROM" + ELLIPSIS + "        ");
+  myLoadProgress->resetProgress();
+  myLoadProgress->open();
+
+  const auto progress = [this](int percent)
+  {
+    myLoadProgress->showProgress(percent);
+    return myLoadProgress->isCancelled();
+  };
+  const auto done = [this, node = currentNode(), rom = myList->getSelectedString()]
+    (const string& result)
   {
-    instance().settings().setValue("lastrom", myList->getSelectedString());
+    myLoadProgress->close();
 
-    // If romdir has never been set, set it now based on the selected rom
-    if(instance().settings().getString("romdir") == EmptyString())
-      instance().settings().setValue("romdir", currentNode().getParent().getShortPath());
-  }
-  else
-    instance().frameBuffer().showTextMessage(result, MessagePosition::MiddleCenter, true);
+    if(result == EmptyString())
+    {
+      instance().settings().setValue("lastrom", rom);
+
+      // If romdir has never been set, set it now based on the selected rom
+      if(instance().settings().getString("romdir") == EmptyString())
+        instance().settings().setValue("romdir", node.getParent().getShortPath());
+    }
+    else
+      instance().frameBuffer().showTextMessage(result, MessagePosition::MiddleCenter, true);
+  };
+  instance().createConsoleAsync(currentNode(), selectedRomMD5(), progress, done);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -1222,15 +1250,44 @@ void LauncherDialog::openContextMenu(int x, int y)
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void LauncherDialog::loadRandomRom()
+{
+  // Start the ROM picked (and prepared) last time, if it is still listed
+  const FSList& files = myList->fileList();
+  const auto next = std::ranges::find_if(files, [this](const FSNode& node) {
+    return node.getPath() == myNextRandomRom;
+  });
+  const int item = next != files.end()
+    ? static_cast<int>(next - files.begin()) : pickRandomRom();
+  if(item < 0)
+    return;
+
+  myList->setSelected(item);
+  loadRom();
+
+  // Prepare the next random ROM in the background meanwhile
+  if(const int nextItem = pickRandomRom(); nextItem >= 0 && nextItem != item)
+  {
+    myNextRandomRom = files[nextItem].getPath();
+    instance().prefetchRom(files[nextItem]);
+  }
+  else
+    myNextRandomRom.clear();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+int LauncherDialog::pickRandomRom() const
 {
   const Random rand;
-  int tries = 100; // limit to 100 tries, in case the directory contains no ROMs
+  const FSList& files = myList->fileList();
 
-  do {
-    myList->setSelected(rand.next() % myList->getList().size());
-  } while(myList->isDirectory(myList->selected()) && --tries);
-  if(tries)
-    loadRom();
+  // Limit to 100 tries, in case the directory contains no ROMs
+  for(int tries = 100; tries > 0 && !files.empty(); --tries)
+  {
+    const int item = static_cast<int>(rand.next() % files.size());
+    if(!myList->isDirectory(files[item]))
+      return item;
+  }
+  return -1;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -26,6 +26,7 @@ class OSystem;
 class Properties;
 class EditTextWidget;
 class NavigationWidget;
+class ProgressDialog;
 class LauncherFileListWidget;
 class RomImageWidget;
 class RomInfoWidget;
@@ -38,7 +39,6 @@ namespace GUI {
   class MessageBox;
 }  // namespace GUI
 
-#include <unordered_map>
 #include <unordered_set>
 
 #include "bspf.hxx"
@@ -72,8 +72,8 @@ class LauncherDialog : public Dialog, CommandSender
 
     /**
       Get MD5sum for the currently selected file.
-      If the MD5 hasn't already been calculated, it will be
-      calculated (and cached) for future use.
+      If the MD5 isn't already in the ROM index, it will be
+      calculated (and stored) for future use.
 
       @return md5sum if a valid ROM file, else the empty string
     */
@@ -123,6 +123,7 @@ class LauncherDialog : public Dialog, CommandSender
     static constexpr int MIN_ROMINFO_CHARS = 30;
     static constexpr int MIN_ROMINFO_ROWS = 7; // full lines
     static constexpr int MIN_ROMINFO_LINES = 4; // extra lines
+    static constexpr int PREFETCH_ROWS = 3; // images loaded above and below
 
     void updateUI();
     void addTitleWidget(int& ypos);
@@ -132,17 +133,6 @@ class LauncherDialog : public Dialog, CommandSender
     void addButtonWidgets(int& ypos);
     string getRomDir();
 
-    /**
-      Search if string contains pattern including wildcard '*'
-      and '?' as joker, ignoring case.
-
-      @param str      The searched string
-      @param pattern  The pattern to search for
-
-      @return True if pattern was found.
-    */
-    static bool matchWithWildcardsIgnoreCase(string_view str, string_view pattern);
-
     void applyFiltering();
 
     float getRomInfoZoom(int listHeight) const;
@@ -151,7 +141,9 @@ class LauncherDialog : public Dialog, CommandSender
     void loadRom();
     void loadRomInfo();
     void loadPendingRomInfo();
+    void prefetchRomImages();
     void loadRandomRom();
+    int pickRandomRom() const;
     void openSettings();
     void openGameProperties();
     void openContextMenu(int x = -1, int y = -1);
@@ -198,18 +190,20 @@ class LauncherDialog : public Dialog, CommandSender
     RomImageWidget*   myRomImageWidget{nullptr};
     RomInfoWidget*    myRomInfoWidget{nullptr};
 
-    std::unordered_map<string,string> myMD5List;
-
     // Show a message about the dangers of using this function
     unique_ptr<GUI::MessageBox> myConfirmMsg;
 
+    // Shown while a ROM is loaded in the background
+    unique_ptr<ProgressDialog> myLoadProgress;
+
+    // The path of the next random ROM, prepared in the background
+    string myNextRandomRom;
+
     int mySelectedItem{0};
 
     bool myUseMinimalUI{false};
     bool myEventHandled{false};
     bool myShortCount{false};
-    bool myPendingReload{false};
-    uInt64 myReloadTime{0};
     bool myPendingRomInfo{false};
     uInt64 myRomInfoTime{0};
 
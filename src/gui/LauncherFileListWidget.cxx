@@ -110,7 +110,6 @@ void LauncherFileListWidget::addFolder(StringList& list, int& offset,
   _fileList.insert(_fileList.begin() + offset,
     FSNode(_node.getPath() + n));
   list.insert(list.begin() + offset, n);
-  _dirList.insert(_dirList.begin() + offset, "");
   _iconTypeList.insert((_iconTypeList.begin() + offset), icon);
 
   ++offset;
@@ -231,8 +230,8 @@ void LauncherFileListWidget::userFavor(string_view path)
       break;
     pos++;
   }
-  if(pos < _iconTypeList.size())
-    _iconTypeList[pos] = getIconType(path);
+  if(pos < _iconTypeList.size() && _iconTypeList[pos] != IconType::updir)
+    _iconTypeList[pos] = IconType::pending;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -254,12 +253,11 @@ void LauncherFileListWidget::removeAllRecent()
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-FileListWidget::IconType LauncherFileListWidget::getIconType(string_view path) const
+FileListWidget::IconType LauncherFileListWidget::getIconType(const FSNode& node) const
 {
-  if(!isUserFavorite(path))
-    return FileListWidget::getIconType(path);
+  if(!isUserFavorite(node.getPath()))
+    return FileListWidget::getIconType(node);
 
-  const FSNode node(path);
   if(node.isDirectory())
     return BSPF::endsWithIgnoreCase(node.getName(), ".zip")
       ? IconType::favzip : IconType::favdir;
@@ -521,14 +519,16 @@ const FileListWidget::Icon* LauncherFileListWidget::getIcon(int i) const
     &user_large, &recent_large, &popular_large
   };
 
-  if(static_cast<int>(_iconTypeList[i]) < static_cast<int>(IconType::numTypes))
+  const IconType type = iconType(i);
+
+  if(static_cast<int>(type) < static_cast<int>(IconType::numTypes))
     return FileListWidget::getIcon(i);
 
   const bool smallIcon = iconWidth() < 24;
-  const int iconType =
-    static_cast<int>(_iconTypeList[i]) - static_cast<int>(IconType::numTypes);
+  const int idx =
+    static_cast<int>(type) - static_cast<int>(IconType::numTypes);
 
-  assert(iconType < NLT);
+  assert(idx < NLT);
 
-  return smallIcon ? small_icons[iconType] : large_icons[iconType];
+  return smallIcon ? small_icons[idx] : large_icons[idx];
 }
@@ -106,10 +106,9 @@ void LoggerDialog::saveConfig()
   const int loglevel = myLogLevel->getSelectedTag().toInt();
   const bool logtoconsole = myLogToConsole->getState();
 
+  // This also updates the logger
   instance().settings().setValue("loglevel", loglevel);
   instance().settings().setValue("logtoconsole", logtoconsole);
-
-  Logger::instance().setLogParameters(loglevel, logtoconsole);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -128,6 +128,13 @@ void ProgressDialog::incProgress()
   setProgress(++myProgress);
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void ProgressDialog::showProgress(int progress)
+{
+  myProgress = progress;
+  mySlider->setValue(progress);
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void ProgressDialog::handleCommand(CommandSender* sender, int cmd,
                                    int data, int id)
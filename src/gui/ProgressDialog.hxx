@@ -38,6 +38,9 @@ class ProgressDialog : public Dialog
     void resetProgress();
     void setProgress(int progress);
     void incProgress();
+    // Set the progress without redrawing or polling events, for work done
+    // outside of the main loop (which keeps drawing the dialog)
+    void showProgress(int progress);
     bool isCancelled() const { return myIsCancelled; }
 
   protected:
@@ -15,6 +15,11 @@
 // this file, and for a DISCLAIMER OF ALL WARRANTIES.
 //============================================================================
 
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
 #include "bspf.hxx"
 #include "Launcher.hxx"
 #include "Bankswitch.hxx"
@@ -127,25 +132,76 @@ void RomAuditDialog::auditRoms()
   progress.setRange(0, static_cast<int>(files.size()) - 1, 5);
   progress.open();
 
+  // The audit is a pipeline: the directory has been enumerated above,
+  // several worker threads now read (and possibly decompress) and hash the
+  // files, and this thread looks up the properties and renames the files
+  // as their hashes become available (and keeps the progress dialog alive)
+  struct Hashed {
+    size_t idx{0};
+    string md5;
+    string extension;
+  };
+  std::mutex mutex;
+  std::condition_variable hashedCond;
+  vector<Hashed> hashed, ready;
+  std::atomic<size_t> nextFile{0};
+  std::atomic<uInt32> processed{0};
+  std::atomic_bool cancelled{false};
+  uInt32 finishedWorkers = 0;
+
+  const auto numWorkers = static_cast<uInt32>(std::clamp<size_t>(
+      std::thread::hardware_concurrency(), 1, std::max<size_t>(files.size(), 1)));
+  vector<std::thread> workers;
+  workers.reserve(numWorkers);
+  for(uInt32 i = 0; i < numWorkers; ++i)
+    workers.emplace_back([&]
+    {
+      for(size_t idx = nextFile++; idx < files.size() && !cancelled; idx = nextFile++)
+      {
+        // Calculate the MD5 so we can get the rest of the info
+        // from the PropertiesSet (stella.pro)
+        string extension;
+        if(files[idx].isFile() &&
+           Bankswitch::isValidRomName(files[idx], extension))
+        {
+          string md5 = OSystem::getROMMD5(files[idx]);
+
+          const std::scoped_lock lock(mutex);
+          hashed.emplace_back(idx, std::move(md5), std::move(extension));
+          hashedCond.notify_one();
+        }
+        ++processed;
+      }
+
+      const std::scoped_lock lock(mutex);
+      ++finishedWorkers;
+      hashedCond.notify_one();
+    });
+
   // NOLINTBEGIN: several variables are tagged as const by clang-tidy,
   //              but they obviously cannot be; suspect a bug in the tool
-  Properties props;
+  string name;
   uInt32 renamed = 0, notfound = 0;
-  for(uInt32 idx = 0; idx < files.size() && !progress.isCancelled(); ++idx)
+  for(bool done = false; !done; )
   {
-    string extension;
-    if(files[idx].isFile() &&
-       Bankswitch::isValidRomName(files[idx], extension))
     {
-      bool renameSucceeded = false;
+      std::unique_lock lock(mutex);
+      hashedCond.wait_for(lock, std::chrono::milliseconds(50), [&] {
+        return !hashed.empty() || finishedWorkers == numWorkers;
+      });
+      ready.swap(hashed);
+      done = finishedWorkers == numWorkers;
+    }
 
-      // Calculate the MD5 so we can get the rest of the info
-      // from the PropertiesSet (stella.pro)
-      const string& md5 = OSystem::getROMMD5(files[idx]);
-      if(instance().propSet().getMD5(md5, props))
-      {
-        const string& name = props.get(PropType::Cart_Name);
+    // Files already hashed are not renamed anymore after cancelling
+    for(const auto& [idx, md5, extension]: ready)
+    {
+      if(cancelled)
+        break;
 
+      bool renameSucceeded = false;
+      if(instance().propSet().getProperty(md5, PropType::Cart_Name, name))
+      {
         // Only rename the file if we found a valid properties entry
         if(!name.empty() && name != files[idx].getName())
         {
@@ -160,12 +216,18 @@ void RomAuditDialog::auditRoms()
       else
         ++notfound;
     }
+    ready.clear();
 
-    // Update the progress bar, indicating one more ROM has been processed
-    progress.incProgress();
+    // Update the progress bar, indicating how many ROMs have been processed
+    progress.setProgress(static_cast<int>(processed));
+    if(progress.isCancelled())
+      cancelled = true;
   }
   // NOLINTEND
 
+  for(auto& worker: workers)
+    worker.join();
+
   progress.close();
 
   myResults1->setText(std::to_string(renamed));
@@ -15,7 +15,6 @@
 // this file, and for a DISCLAIMER OF ALL WARRANTIES.
 //============================================================================
 
-#include <regex>
 #include "EventHandler.hxx"
 #include "Dialog.hxx"
 #include "FBSurface.hxx"
@@ -68,6 +67,9 @@ void RomImageWidget::clearProperties()
   myHaveProperties = mySurfaceIsValid = false;
   if(mySurface)
     mySurface->setVisible(false);
+#ifdef IMAGE_SUPPORT
+  myPendingImage.clear();
+#endif
 
   // Decide whether the information should be shown immediately
   if(instance().eventHandler().state() == EventHandlerState::LAUNCHER)
@@ -87,6 +89,9 @@ void RomImageWidget::reloadProperties(const FSNode& node)
   // The ROM may have changed since we were last in the browser, either
   // by saving a different image or through a change in video renderer,
   // so we reload the properties
+#ifdef IMAGE_SUPPORT
+  snapshots().refresh(true);
+#endif
   if(myHaveProperties)
     parseProperties(node);
 }
@@ -117,6 +122,13 @@ void RomImageWidget::parseProperties(const FSNode& node, bool full)
     myFrameSurface = fb.allocateSurface(1, 1, ScalingInterpolation::sharp);
     myFrameSurface->setVisible(true);
 
+  #ifdef IMAGE_SUPPORT
+    // Thumbnails are scaled to the largest size they can be shown at
+    const uInt32 scale = fb.hidpiScaleFactor();
+    myThumbnails = std::make_unique<ThumbnailCache>(instance(),
+        (_w - 2) * scale, (myImageHeight - 1) * scale);
+  #endif
+
     dialog().addRenderCallback([this]() {
       if(mySurfaceIsValid)
       {
@@ -139,24 +151,32 @@ void RomImageWidget::parseProperties(const FSNode& node, bool full)
     myLabel.clear();
 
     // Get a valid filename representing a snapshot file for this rom and load the snapshot
-    const string& path = instance().snapshotLoadDir().getPath();
+    string fileName;
 
     // 1. Try to load first snapshot by property name
-    string fileName = path + myProperties.get(PropType::Cart_Name);
-    tryImageFormats(fileName);
-    if(!mySurfaceIsValid)
+    bool found = findImage(myProperties.get(PropType::Cart_Name), fileName);
+    if(!found)
     {
       // 2. If none exists, try to load first snapshot by ROM file name
-      fileName = path + node.getName();
-      tryImageFormats(fileName);
+      found = findImage(node.getName(), fileName);
     }
-    if(mySurfaceIsValid)
+    if(found)
+    {
       myImageList.emplace_back(fileName);
+      loadImage(fileName);
+    }
     else
     {
       // 3. If no ROM snapshots exist, try to load a default snapshot
-      fileName = path + "default_snapshot";
-      tryImageFormats(fileName);
+      if(findImage("default_snapshot", fileName))
+        loadImage(fileName);
+      else
+      {
+        myPendingImage.clear();
+        mySurfaceIsValid = false;
+        mySurfaceErrorMsg = "No image found";
+        setDirty();
+      }
     }
   }
   else
@@ -205,6 +225,23 @@ bool RomImageWidget::changeImage(int direction)
   return false;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RomImageWidget::prefetchImages(const StringList& names)
+{
+#ifdef IMAGE_SUPPORT
+  if(!myThumbnails)
+    return;
+
+  StringList fileNames;
+  string fileName;
+
+  for(const auto& name: names)
+    if(findImage(name, fileName))
+      fileNames.push_back(fileName);
+  myThumbnails->prefetch(fileNames);
+#endif
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void RomImageWidget::toggleImageZoom()
 {
@@ -221,20 +258,17 @@ void RomImageWidget::toggleImageZoom()
 bool RomImageWidget::getImageList(const string& propName, const string& romName,
                                   const string& oldFileName)
 {
-  const std::regex symbols{R"([-[\]{}()*+?.,\^$|#])"}; // \s
-  const string rgxPropName = std::regex_replace(propName, symbols, R"(\$&)");
-  const string rgxRomName  = std::regex_replace(romName,  symbols, R"(\$&)");
-  // Look for <name.png|jpg> or <name_#.png|jpg> (# is a number)
-  const std::regex rgx("^(" + rgxPropName + "|" + rgxRomName + ")(_\\d+)?\\.(png|jpg)$");
-
-  const FSNode::NameFilter filter = ([&](const FSNode& node) {
-      return std::regex_match(node.getName(), rgx);
-    }
-  );
-
-  // Find all images matching the given names and the extension
-  const FSNode node(instance().snapshotLoadDir().getPath());
-  node.getChildren(myImageList, FSNode::ListMode::FilesOnly, filter, false, false);
+  // Find all images matching the given names, <name.png|jpg> or
+  // <name_#.png|jpg> (# is a number)
+  myImageList = snapshots().find(propName);
+  if(!BSPF::equalsIgnoreCase(propName, romName))
+  {
+    // Numbered images may match both names
+    for(const auto& image: snapshots().find(romName))
+      if(std::ranges::none_of(myImageList, [&image](const FSNode& node) {
+           return node.getPath() == image.getPath(); }))
+        myImageList.push_back(image);
+  }
 
   // Sort again, not considering extensions, else <filename.png|jpg> would be at
   // the end of the list
@@ -257,36 +291,64 @@ bool RomImageWidget::getImageList(const string& propName, const string& romName,
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool RomImageWidget::tryImageFormats(string& fileName)
+bool RomImageWidget::findImage(string_view name, string& fileName)
 {
-  if(loadImage(fileName + ".png"))
-  {
-    fileName += ".png";
-    return true;
-  }
-  if(loadImage(fileName + ".jpg"))
-  {
-    fileName += ".jpg";
-    return true;
-  }
-  return false;
+  // Only <name.png|jpg>, the numbered images are sorted after it
+  const FSList images = snapshots().find(name);
+  if(images.empty() ||
+     !BSPF::equalsIgnoreCase(images.front().getNameWithExt(), name))
+    return false;
+
+  // The files are decoded in the background
+  fileName = images.front().getPath();
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+SnapshotIndex& RomImageWidget::snapshots()
+{
+  // The snapshot directory may have been changed in the settings
+  const FSNode& dir = instance().snapshotLoadDir();
+  if(!mySnapshots || mySnapshots->path() != dir.getPath())
+    mySnapshots = std::make_unique<SnapshotIndex>(dir);
+
+  return *mySnapshots;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool RomImageWidget::loadImage(const string& fileName)
 {
-  mySurfaceErrorMsg.clear();
+  // If the thumbnail isn't available yet, tick() shows it once it is
+  myPendingImage = fileName;
+  if(!showThumbnail())
+  {
+    mySurfaceIsValid = false;
+    mySurfaceErrorMsg.clear();
+    if(mySurface)
+      mySurface->setVisible(false);
+    setDirty();
+  }
+  return true;
+}
 
-  const string::size_type idx = fileName.find_last_of('.');
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool RomImageWidget::showThumbnail()
+{
+  const ThumbnailCache::ThumbnailPtr thumbnail =
+      myThumbnails->get(myPendingImage);
+  if(!thumbnail)
+    return false;
 
-  if(idx != string::npos && fileName.substr(idx + 1) == "png")
-    mySurfaceIsValid = loadPng(fileName);
-  else
-    mySurfaceIsValid = loadJpg(fileName);
+  myPendingImage.clear();
+  myImageFile = thumbnail->fileName;
+  myFullImage = false;
+  mySurfaceErrorMsg = thumbnail->error;
+  mySurfaceIsValid = mySurfaceErrorMsg.empty();
 
   if(mySurfaceIsValid)
   {
-    mySrcRect = mySurface->srcRect();
+    drawThumbnail(*thumbnail);
+    setLabel(thumbnail->metaData);
     zoomSurfaces(false, true);
   }
 
@@ -296,19 +358,62 @@ bool RomImageWidget::loadImage(const string& fileName)
   if (!myZoomMode)
     myZoomTimer = 0;
   setDirty();
-  return mySurfaceIsValid;
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RomImageWidget::drawThumbnail(const ThumbnailCache::Thumbnail& thumbnail)
+{
+  const uInt32 width = thumbnail.width, height = thumbnail.height;
+
+  // First determine if we need to resize the surface
+  if(width > mySurface->width() || height > mySurface->height())
+    mySurface->resize(width, height);
+
+  mySurface->setSrcPos(0, 0);
+  mySurface->setSrcSize(width, height);
+
+  uInt32 *dst{nullptr}, pitch{0};
+  mySurface->basePtr(dst, pitch);
+  const uInt32* src = thumbnail.pixels.data();
+  for(uInt32 y = 0; y < height; ++y, src += width, dst += pitch)
+    std::copy_n(src, width, dst);
+
+  mySrcRect = mySurface->srcRect();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool RomImageWidget::loadPng(const string& fileName)
+void RomImageWidget::loadFullImage()
 {
+  // Also marked on failure, so that the thumbnail is zoomed instead of
+  // trying again
+  myFullImage = true;
   try
   {
     VariantList metaData;
-    instance().png().loadImage(fileName, *mySurface, metaData);
+    if(BSPF::endsWithIgnoreCase(myImageFile, ".png"))
+      instance().png().loadImage(myImageFile, *mySurface, metaData);
+    else
+      instance().jpg().loadImage(myImageFile, *mySurface, metaData);
 
-    // Retrieve label for loaded image
-    myLabel.clear();
+    mySrcRect = mySurface->srcRect();
+  }
+  catch(const std::runtime_error&)
+  {
+    // Restore the (possibly overwritten) thumbnail
+    if(const auto thumbnail = myThumbnails->get(myImageFile);
+       thumbnail && thumbnail->error.empty())
+      drawThumbnail(*thumbnail);
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RomImageWidget::setLabel(const VariantList& metaData)
+{
+  // Retrieve label for loaded image
+  myLabel.clear();
+  if(BSPF::endsWithIgnoreCase(myImageFile, ".png"))
+  {
     for(const auto& data: metaData)
     {
       if(data.first == "Title")
@@ -320,25 +425,9 @@ bool RomImageWidget::loadPng(const string& fileName)
           && data.second.toString().starts_with("Stella"))
         myLabel = "Snapshot"; // default for Stella snapshots with missing "Title" meta data
     }
-    return true;
   }
-  catch(const std::runtime_error& e)
-  {
-    mySurfaceErrorMsg = e.what();
-  }
-  return false;
-}
-
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool RomImageWidget::loadJpg(const string& fileName)
-{
-  try
+  else
   {
-    VariantList metaData;
-    instance().jpg().loadImage(fileName, *mySurface, metaData);
-
-    // Retrieve label for loaded image
-    myLabel.clear();
     for(const auto& data: metaData)
     {
       if(data.first == "ImageDescription")
@@ -347,13 +436,7 @@ bool RomImageWidget::loadJpg(const string& fileName)
         break;
       }
     }
-    return true;
   }
-  catch(const std::runtime_error& e)
-  {
-    mySurfaceErrorMsg = e.what();
-  }
-  return false;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -363,6 +446,10 @@ void RomImageWidget::zoomSurfaces(bool zoomed, bool force)
   {
     const uInt32 scaleDpi = instance().frameBuffer().hidpiScaleFactor();
 
+    // Zooming uses the image in its original size, not the thumbnail
+    if(zoomed && mySurfaceIsValid && !myFullImage)
+      loadFullImage();
+
     myIsZoomed = zoomed;
 
     if(!zoomed)
@@ -515,6 +602,10 @@ void RomImageWidget::handleMouseMoved(int x, int y)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void RomImageWidget::tick()
 {
+  // Show the requested image once its thumbnail has been loaded
+  if(!myPendingImage.empty())
+    showThumbnail();
+
   if(myMouseArea == Area::ZOOM || myZoomMode)
   {
     myZoomTimer += REQUEST_SPEED;
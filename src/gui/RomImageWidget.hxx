@@ -22,6 +22,8 @@ class FBSurface;
 class Properties;
 
 #include "Widget.hxx"
+#include "SnapshotIndex.hxx"
+#include "ThumbnailCache.hxx"
 
 class RomImageWidget : public Widget
 {
@@ -40,6 +42,8 @@ class RomImageWidget : public Widget
     void clearProperties();
     void reloadProperties(const FSNode& node);
     bool changeImage(int direction = 1);
+    // Load the images for the given ROM names in advance
+    void prefetchImages(const StringList& names);
     // Toggle zoom via keyboard
     void toggleImageZoom();
     void disableImageZoom() { myZoomMode = false; }
@@ -61,10 +65,13 @@ class RomImageWidget : public Widget
   #ifdef IMAGE_SUPPORT
     bool getImageList(const string& propName, const string& romName,
                       const string& oldFileName);
-    bool tryImageFormats(string& fileName);
+    bool findImage(string_view name, string& fileName);
+    SnapshotIndex& snapshots();
     bool loadImage(const string& fileName);
-    bool loadPng(const string& fileName);
-    bool loadJpg(const string& fileName);
+    bool showThumbnail();
+    void drawThumbnail(const ThumbnailCache::Thumbnail& thumbnail);
+    void loadFullImage();
+    void setLabel(const VariantList& metaData);
 
     void zoomSurfaces(bool zoomed, bool force = false);
     void positionSurfaces();
@@ -123,6 +130,22 @@ class RomImageWidget : public Widget
 
     // Last mouse position, used for zooming
     Common::Point myMousePos;
+
+    // Scaled images, loaded in the background
+    unique_ptr<ThumbnailCache> myThumbnails;
+
+    // The images in the snapshot directory, by ROM name
+    unique_ptr<SnapshotIndex> mySnapshots;
+
+    // The image waiting for its thumbnail to be loaded, if any
+    string myPendingImage;
+
+    // The image currently shown
+    string myImageFile;
+
+    // Whether the image in its original size was loaded into the surface,
+    // instead of the thumbnail (done for zooming)
+    bool myFullImage{false};
   #endif
 
     // Current navigation area of the mouse
@@ -20,9 +20,8 @@
 #include "FBSurface.hxx"
 #include "Font.hxx"
 #include "OSystem.hxx"
-#include "ControllerDetector.hxx"
 #include "Bankswitch.hxx"
-#include "CartDetector.hxx"
+#include "RomIndex.hxx"
 #include "Props.hxx"
 #include "PropsSet.hxx"
 #include "RomInfoWidget.hxx"
@@ -111,7 +110,7 @@ void RomInfoWidget::parseProperties(const FSNode& node, bool full)
   {
     const bool swappedPorts = myProperties.get(PropType::Console_SwapPorts) == "YES";
 
-    // Load the image for controller and bankswitch type auto detection
+    // Use the ROM index for controller and bankswitch type auto detection
     string left = myProperties.get(PropType::Controller_Left);
     string right = myProperties.get(PropType::Controller_Right);
     const Controller::Type leftType = Controller::getType(left);
@@ -119,33 +118,32 @@ void RomInfoWidget::parseProperties(const FSNode& node, bool full)
     string bsDetected = myProperties.get(PropType::Cart_Type);
     bool isPlusCart = false;
     size_t size = 0;
-    try
+    left = right = "";
+    if(node.exists() && !node.isDirectory())
     {
-      if(node.exists() && !node.isDirectory())
+      if(const RomIndex::Entry& entry = instance().romIndex().get(node);
+         !entry.md5.empty())
       {
-        string md5;
-        if(const ByteBuffer image = instance().openROM(node, md5, size); image != nullptr)
+        const auto detectedName = [&](Controller::Type type, Controller::Jack port)
         {
-          Logger::debug(myProperties.get(PropType::Cart_Name) + ":");
-          left = ControllerDetector::detectName(image, size, leftType,
-            !swappedPorts ? Controller::Jack::Left : Controller::Jack::Right,
-              instance().settings());
-          right = ControllerDetector::detectName(image, size, rightType,
-            !swappedPorts ? Controller::Jack::Right : Controller::Jack::Left,
-              instance().settings());
-          if(bsDetected == "AUTO")
-            bsDetected = Bankswitch::typeToName(CartDetector::autodetectType(image, size));
-
-          isPlusCart = CartDetector::isProbablyPlusROM(image, size);
-        }
+          if(swappedPorts)
+            port = port == Controller::Jack::Left
+              ? Controller::Jack::Right : Controller::Jack::Left;
+
+          return Controller::getName(type != Controller::Type::Unknown ? type
+            : Controller::getType(port == Controller::Jack::Left ? entry.left
+                                                                 : entry.right));
+        };
+
+        left = detectedName(leftType, Controller::Jack::Left);
+        right = detectedName(rightType, Controller::Jack::Right);
+        if(bsDetected == "AUTO")
+          bsDetected = entry.type;
+
+        isPlusCart = entry.plusROM;
+        size = entry.romSize;
       }
     }
-    catch(const std::runtime_error&)
-    {
-      // Do nothing; we simply don't update the controllers if openROM
-      // failed for any reason
-      left = right = "";
-    }
     if(!left.empty() && !right.empty())
       myRomInfo.push_back("Controllers: " + (left + " (left), " + right + " (right)"));
 
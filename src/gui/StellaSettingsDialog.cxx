@@ -259,6 +259,7 @@ void StellaSettingsDialog::loadConfig()
 void StellaSettingsDialog::saveConfig()
 {
   Settings& settings = instance().settings();
+  const auto batch = settings.batch();
 
   // UI palette
   settings.setValue("uipalette",
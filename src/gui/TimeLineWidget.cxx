@@ -118,10 +118,12 @@ void TimeLineWidget::handleMouseDown(int x, int y, MouseButton b, int clickCount
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void TimeLineWidget::handleMouseUp(int x, int y, MouseButton b, int clickCount)
 {
-  if(isEnabled() && _isDragging)
-    sendCommand(_cmd, _value, _id);
+  const bool dragged = _isDragging;
 
+  // The final command is sent after dragging has ended
   _isDragging = false;
+  if(isEnabled() && dragged)
+    sendCommand(_cmd, _value, _id);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -42,6 +42,8 @@ class TimeLineWidget : public ButtonWidget
     */
     void setStepValues(const IntArray& steps);
 
+    bool isDragging() const { return _isDragging; }
+
     void handleMouseMoved(int x, int y) override;
     void handleMouseDown(int x, int y, MouseButton b, int clickCount) override;
     void handleMouseUp(int x, int y, MouseButton b, int clickCount) override;
@@ -25,7 +25,6 @@ TimeMachine::TimeMachine(OSystem& osystem)
   : DialogContainer(osystem),
     myWidth{FBMinimum::Width}
 {
-  myBaseDialog = new TimeMachineDialog(myOSystem, *this, myWidth);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -38,7 +37,7 @@ TimeMachine::~TimeMachine()
 void TimeMachine::requestResize()
 {
   uInt32 w = 0, h = 0;
-  myBaseDialog->getDynamicBounds(w, h);
+  baseDialog()->getDynamicBounds(w, h);
 
   // Only re-create when absolutely necessary
   if(myWidth != w)
@@ -65,11 +64,14 @@ void TimeMachine::requestResize()
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 Dialog* TimeMachine::baseDialog()
 {
+  if(myBaseDialog == nullptr)
+    myBaseDialog = new TimeMachineDialog(myOSystem, *this, myWidth);
+
   return myBaseDialog;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void TimeMachine::setEnterWinds(Int32 numWinds)
 {
-  static_cast<TimeMachineDialog*>(myBaseDialog)->setEnterWinds(numWinds);
+  static_cast<TimeMachineDialog*>(baseDialog())->setEnterWinds(numWinds);
 }
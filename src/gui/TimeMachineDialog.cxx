@@ -401,6 +401,11 @@ void TimeMachineDialog::handleCommand(CommandSender* sender, int cmd,
   {
     case kTimeline:
     {
+      // While dragging, only preview the states; loading is deferred
+      // until the mouse button is released
+      if(myTimeline->isDragging() && showThumbnail(myTimeline->getValue() + 1))
+        break;
+
       const Int32 winds = myTimeline->getValue() -
           instance().state().rewindManager().getCurrentIdx() + 1;
       handleWinds(winds);
@@ -482,7 +487,12 @@ void TimeMachineDialog::initBar()
   myTimeline->setMaxValue(maxValue);
   myTimeline->setStepValues(cycles);
 
-  myMessageWidget->setLabel("");
+  // Budget mode may capture the states less often than configured
+  if(r.budgetMode())
+    myMessageWidget->setLabel("1 state/" +
+                              r.getUnitString(r.getEffectiveInterval()));
+  else
+    myMessageWidget->setLabel("");
   handleWinds(_enterWinds);
   _enterWinds = 0;
 
@@ -550,6 +560,21 @@ void TimeMachineDialog::handleWinds(Int32 numWinds)
   mySaveAllWidget->setEnabled(r.getLastIdx() != 0);
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool TimeMachineDialog::showThumbnail(uInt32 idx)
+{
+  RewindManager& r = instance().state().rewindManager();
+
+  if(!r.showThumbnail(idx))
+    return false;
+
+  const IntArray cycles = r.cyclesList();
+  myCurrentTimeWidget->setLabel(getTimeString(cycles[idx - 1]));
+  myCurrentIdxWidget->setValue(idx);
+  myMessageWidget->setLabel("");
+  return true;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void TimeMachineDialog::handleToggle()
 {
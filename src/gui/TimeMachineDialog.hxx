@@ -52,6 +52,8 @@ class TimeMachineDialog : public Dialog
     string getTimeString(uInt64 cycles) const;
     /** re/unwind and update display */
     void handleWinds(Int32 numWinds = 0);
+    /** preview a state while dragging the timeline */
+    bool showThumbnail(uInt32 idx);
     /** toggle Time Machine mode */
     void handleToggle();
 
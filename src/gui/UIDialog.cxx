@@ -457,6 +457,7 @@ void UIDialog::loadConfig()
 void UIDialog::saveConfig()
 {
   Settings& settings = instance().settings();
+  const auto batch = settings.batch();
 
   // ROM path
   settings.setValue("romdir", myRomPath->getText());
@@ -596,6 +596,7 @@ void VideoAudioDialog::addAudioTab()
   VarList::push_back(items, "Low", static_cast<int>(AudioSettings::ResamplingQuality::nearestNeighbour));
   VarList::push_back(items, "High", static_cast<int>(AudioSettings::ResamplingQuality::lanczos_2));
   VarList::push_back(items, "Ultra", static_cast<int>(AudioSettings::ResamplingQuality::lanczos_3));
+  VarList::push_back(items, "BLEP", static_cast<int>(AudioSettings::ResamplingQuality::blep));
   myResamplingPopup = new PopUpWidget(myTab, _font, xpos, ypos,
                                       pwidth, lineHeight,
                                       items, "Resampling quality ", lwidth);
@@ -813,6 +814,7 @@ void VideoAudioDialog::updateSettingsWithPreset(AudioSettings& audioSettings)
 void VideoAudioDialog::saveConfig()
 {
   Settings& settings = instance().settings();
+  const auto batch = settings.batch();
 
   /////////////////////////////////////////////////////////////////////////////
   // Display tab
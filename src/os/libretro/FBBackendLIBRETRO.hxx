@@ -60,12 +60,12 @@ class FBBackendLIBRETRO : public FBBackend
       @param windowedRes    Maximum resolution supported in windowed mode
       @param renderers      List of renderer names (internal name -> end-user name)
     */
-    void queryHardware(vector<Common::Size>& fullscreenRes,
-                       vector<Common::Size>& windowedRes,
+    void queryHardware(std::map<uInt32, Common::Size>& fullscreenRes,
+                       std::map<uInt32, Common::Size>& windowedRes,
                        VariantList& renderers) override
     {
-      fullscreenRes.emplace_back(1920, 1080);
-      windowedRes.emplace_back(1920, 1080);
+      fullscreenRes.try_emplace(0, 1920, 1080);
+      windowedRes.try_emplace(0, 1920, 1080);
 
       VarList::push_back(renderers, "software", "Software");
     }
@@ -63,6 +63,33 @@ class FBSurfaceLIBRETRO : public FBSurface
 
     void translateCoords(Int32& x, Int32& y) const override { }
     bool render() override { return true; }
+
+    /**
+      Let the following renders write straight into the given pixels (a
+      frontend owned framebuffer) instead of the surface buffer; nullptr
+      switches back to the surface buffer.  Like basePtr(), this is allowed
+      on a const surface.
+
+      @param pixels  The target pixels
+      @param pitch   The pitch of the target, in pixels
+    */
+    void setRenderTarget(uInt32* pixels, uInt32 pitch) const {
+      myTarget = pixels;
+      myTargetPitch = pitch;
+      myTargetRendered = false;
+    }
+    // Answer whether anything was rendered into the target
+    bool targetRendered() const { return myTargetRendered; }
+
+    bool lockPixels(uInt32*& pixels, uInt32& pitch) override {
+      if(!myTarget)
+        return false;
+
+      pixels = myTarget;
+      pitch = myTargetPitch;
+      myTargetRendered = true;
+      return true;
+    }
     void invalidate() override { }
     void invalidateRect(uInt32, uInt32, uInt32, uInt32) override { }
     void reload() override { }
@@ -76,6 +103,10 @@ class FBSurfaceLIBRETRO : public FBSurface
     unique_ptr<uInt32[]> myPixelData;
     Common::Rect mySrcGUIR, myDstGUIR;
 
+    mutable uInt32* myTarget{nullptr};
+    mutable uInt32 myTargetPitch{0};
+    mutable bool myTargetRendered{false};
+
   private:
     // Following constructors and assignment operators not supported
     FBSurfaceLIBRETRO() = delete;
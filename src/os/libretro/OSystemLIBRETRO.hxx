@@ -76,6 +76,21 @@ class OSystemLIBRETRO : public OSystem
       return std::make_shared<CompositeKeyValueRepositoryNoop>();
     }
 
+    shared_ptr<KeyValueRepositoryAtomic>
+    getRomIndexRepository() override {
+      return std::make_shared<KeyValueRepositoryNoop>();
+    }
+
+    shared_ptr<CompositeKeyValueRepositoryAtomic>
+    getDetectionRepository() override {
+      return std::make_shared<CompositeKeyValueRepositoryNoop>();
+    }
+
+    shared_ptr<KeyValueRepositoryAtomic>
+    getCheatRepository() override {
+      return std::make_shared<KeyValueRepositoryNoop>();
+    }
+
   protected:
     void initPersistence(FSNode& basedir) override { }
     string describePresistence() override { return "none"; }
@@ -114,6 +114,22 @@ class SoundLIBRETRO : public Sound
       *samples = outIndex / 2;
     }
 
+    /**
+      Empties the playback buffer without producing any output (for frames
+      whose audio the frontend doesn't use).
+    */
+    void drop()
+    {
+      while (myAudioQueue->size())
+      {
+        Int16* nextFragment = myAudioQueue->dequeue(myCurrentFragment);
+        if (!nextFragment)
+          return;
+
+        myCurrentFragment = nextFragment;
+      }
+    }
+
   protected:
     //////////////////////////////////////////////////////////////////////
     // Most methods here aren't used at all.  See Sound class for
@@ -28,6 +28,7 @@
 #include "Switches.hxx"
 #include "TIA.hxx"
 #include "TIASurface.hxx"
+#include "TimerManager.hxx"
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 StellaLIBRETRO::StellaLIBRETRO()
@@ -60,6 +61,7 @@ bool StellaLIBRETRO::create(bool logging)
   }
 
   settings.setValue("speed", 1.0);
+  settings.setValue("runahead", run_ahead);
   settings.setValue("uimessages", false);
 
   settings.setValue("format", console_format);
@@ -106,6 +108,7 @@ bool StellaLIBRETRO::create(bool logging)
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
   video_ready = false;
+  video_enabled = true;
   audio_samples = 0;
 
   system_ready = true;
@@ -119,6 +122,7 @@ void StellaLIBRETRO::destroy()
 
   video_ready = false;
   audio_samples = 0;
+  state_size = 0;
 
   myOSystem.reset();
 }
@@ -141,6 +145,10 @@ void StellaLIBRETRO::runFrame()
 
   // refresh ram copy
   memcpy(system_ram, myOSystem->console().system().m6532().getRAM(), 128);
+
+  // run expired timers
+  myOSystem->timer().advance();
+  TimerManager::global().advance();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -166,29 +174,62 @@ void StellaLIBRETRO::updateVideo()
     if(tia.scanlines() == 0) break;
   }
 
-  video_ready = tia.newFramePending();
+  // Skipped frames are never presented
+  video_ready = tia.newFramePending() && video_enabled;
 
   if (video_ready)
   {
     FrameBuffer& frame = myOSystem->frameBuffer();
+    const auto& surface = static_cast<const FBSurfaceLIBRETRO&>(
+        frame.tiaSurface().tiaSurface());
+
+    if(!myOSystem->state().runAhead())
+    {
+      tia.renderToFrameBuffer();
+
+      if(observation)
+      {
+        observation->setPalette(frame.tiaSurface().rgbPalette());
+        observation->process(tia.frameBuffer(),
+                             tia.frameBufferScanlinesLastFrame(),
+                             observation_buffer.data());
+      }
+    }
+
+    // The frontend buffer can only be used if the frame fits exactly
+    if(video_target && (getVideoWidth() != video_target_width ||
+                        getVideoHeight() != video_target_height))
+      video_target = nullptr;
 
-    tia.renderToFrameBuffer();
+    surface.setRenderTarget(video_target, getVideoWidthMax());
     frame.updateInEmulationMode(0);
+
+    // Some modes (e.g. Blargg phosphor) always use the surface buffer
+    if(!surface.targetRendered())
+      video_target = nullptr;
+    surface.setRenderTarget(nullptr, 0);
   }
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void StellaLIBRETRO::updateAudio()
 {
-  static_cast<SoundLIBRETRO&>(myOSystem->sound()).dequeue(audio_buffer.get(), &audio_samples);
+  auto& sound = static_cast<SoundLIBRETRO&>(myOSystem->sound());
+
+  if(audio_enabled)
+    sound.dequeue(audio_buffer.get(), &audio_samples);
+  else
+  {
+    sound.drop();
+    audio_samples = 0;
+  }
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool StellaLIBRETRO::loadState(const void* data, size_t size)
 {
-  Serializer state;
-
-  state.putByteArray(std::span{reinterpret_cast<const uInt8*>(data), size});
+  // Read straight from the frontend buffer; any padding is ignored
+  Serializer state(std::span{static_cast<const std::byte*>(data), size});
 
   if(!myOSystem->state().loadState(state))
     return false;
@@ -200,27 +241,34 @@ bool StellaLIBRETRO::loadState(const void* data, size_t size)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool StellaLIBRETRO::saveState(void* data, size_t size) const
 {
-  Serializer state;
+  // Write straight into the frontend buffer, which fails if it is too small
+  auto* buffer = static_cast<std::byte*>(data);
+  Serializer state(std::span{buffer, size});
 
   if (!myOSystem->state().saveState(state))
     return false;
 
-  if (state.size() > size)
-    return false;
-
-  state.getByteArray(std::span{reinterpret_cast<uInt8*>(data), state.size()});
+  // Clear the padding, so that equal states have equal contents (netplay)
+  std::fill(buffer + state.size(), buffer + size, std::byte{0});
   return true;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 size_t StellaLIBRETRO::getStateSize() const
 {
-  Serializer state;
+  // The frontend expects the same size for the whole session, so this is
+  // determined only once, leaving room for states growing later on
+  if(state_size == 0)
+  {
+    Serializer state;
 
-  if (!myOSystem->state().saveState(state))
-    return 0;
+    if (!myOSystem->state().saveState(state))
+      return 0;
+
+    state_size = state.size() + std::max<size_t>(state.size() / 4, 4_KB);
+  }
 
-  return state.size();
+  return state_size;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -258,6 +306,9 @@ float StellaLIBRETRO::getVideoAspect() const
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void* StellaLIBRETRO::getVideoBuffer() const
 {
+  if (video_target)
+    return video_target;
+
   if (!render_surface)
   {
     const FBSurface& surface =
@@ -270,6 +321,15 @@ void* StellaLIBRETRO::getVideoBuffer() const
   return render_surface;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void StellaLIBRETRO::setVideoTarget(void* pixels, uInt32 width, uInt32 height,
+                                    uInt32 pitch)
+{
+  video_target = pitch == getVideoPitch() ? static_cast<uInt32*>(pixels) : nullptr;
+  video_target_width = width;
+  video_target_height = height;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool StellaLIBRETRO::getVideoNTSC() const
 {
@@ -388,3 +448,47 @@ void StellaLIBRETRO::setAudioStereo(int mode)
     myOSystem->console().initializeAudio();
   }
 }
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void StellaLIBRETRO::setRunAhead(uInt32 frames)
+{
+  run_ahead = frames;
+
+  if (system_ready)
+  {
+    myOSystem->settings().setValue("runahead", run_ahead);
+    myOSystem->state().setRunAheadFrames(run_ahead);
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void StellaLIBRETRO::setVideoEnabled(bool enable)
+{
+  // The observation is taken from the drawn frames
+  enable = enable || observation != nullptr;
+  if(enable == video_enabled)
+    return;
+
+  video_enabled = enable;
+  if(system_ready)
+    myOSystem->console().tia().setSkipDrawing(!video_enabled);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void StellaLIBRETRO::setObservation(bool enable)
+{
+  if(enable == (observation != nullptr))
+    return;
+
+  if(enable)
+  {
+    observation = std::make_unique<ObservationProcessor>(
+        ObservationProcessor::Config{});
+    observation_buffer.assign(observation->observationSize(), 0);
+  }
+  else
+  {
+    observation.reset();
+    observation_buffer.clear();
+  }
+}
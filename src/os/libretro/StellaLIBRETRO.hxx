@@ -28,8 +28,10 @@
 #include "EmulationTiming.hxx"
 #include "EventHandler.hxx"
 #include "M6532.hxx"
+#include "ObservationProcessor.hxx"
 #include "Paddles.hxx"
 #include "PaletteHandler.hxx"
+#include "Serializer.hxx"
 #include "System.hxx"
 #include "TIA.hxx"
 #include "TIASurface.hxx"
@@ -67,6 +69,9 @@ class StellaLIBRETRO
 
     uInt8* getRAM() { return system_ram; }
     constexpr uInt32 getRAMSize() const { return 128; }
+    Cartridge::RamAreaList getCartRAM() const {
+      return myOSystem->console().cartridge().ramAreas();
+    }
 
     size_t getStateSize() const;
 
@@ -84,6 +89,15 @@ class StellaLIBRETRO
     bool   getVideoResize();
 
     void*  getVideoBuffer() const;
+
+    /**
+      Render the next frame straight into a frontend owned framebuffer (see
+      RETRO_ENVIRONMENT_GET_CURRENT_SOFTWARE_FRAMEBUFFER).  The buffer is
+      only used if the frame has exactly the given size and the buffer has
+      the video pitch; getVideoBuffer() then returns it instead of the
+      internal buffer.  Pass nullptr once the frame has been presented.
+    */
+    void   setVideoTarget(void* pixels, uInt32 width, uInt32 height, uInt32 pitch);
     uInt32 getVideoWidth() const {
       return getVideoZoom() == 1 ? myOSystem->console().tia().width() : getVideoWidthMax();
     }
@@ -115,6 +129,14 @@ class StellaLIBRETRO
 
     Int16* getAudioBuffer() { return audio_buffer.get(); }
 
+    // The preprocessed observation of the last frame (if enabled)
+    uInt8* getObservation() {
+      return observation ? observation_buffer.data() : nullptr;
+    }
+    size_t getObservationSize() const {
+      return observation ? observation_buffer.size() : 0;
+    }
+
   public:
     void   setROM(const char* path, const void* data, size_t size);
 
@@ -129,6 +151,19 @@ class StellaLIBRETRO
 
     void   setAudioStereo(int mode);
 
+    void   setRunAhead(uInt32 frames);
+
+    void   setObservation(bool enable);
+
+    /**
+      Whether the frontend uses the video and audio of the next frame (see
+      RETRO_ENVIRONMENT_GET_AUDIO_VIDEO_ENABLE).  Frames which aren't used
+      (e.g. during fast-forward or run-ahead) are emulated without drawing
+      pixels, filtering or copying audio.
+    */
+    void   setVideoEnabled(bool enable);
+    void   setAudioEnabled(bool enable) { audio_enabled = enable; }
+
     void   setInputEvent(Event::Type type, Int32 state) {
              myOSystem->eventHandler().handleEvent(type, state);
     }
@@ -179,13 +214,24 @@ class StellaLIBRETRO
     mutable uInt32* render_surface{nullptr};
     uInt32 render_width{0}, render_height{0};
 
+    uInt32* video_target{nullptr};
+    uInt32 video_target_width{0}, video_target_height{0};
+
     bool video_ready{false};
+    bool video_enabled{true};
 
     unique_ptr<Int16[]> audio_buffer;
     uInt32 audio_samples{0};
+    bool audio_enabled{true};
+
+    unique_ptr<ObservationProcessor> observation;
+    ByteArray observation_buffer;
 
     uInt8 system_ram[128];
 
+    // Fixed state size for the loaded cart, 0 if not determined yet
+    mutable size_t state_size{0};
+
     // (31440 rate / 50 Hz) * 16-bit stereo * 1.25x padding
     static constexpr uInt32 audio_buffer_max = (31440 / 50 * 4 * 5) / 4;
 
@@ -200,6 +246,8 @@ class StellaLIBRETRO
 
     string audio_mode{"byrom"};
 
+    uInt32 run_ahead{0};
+
     bool phosphor_default{false};
 };
 
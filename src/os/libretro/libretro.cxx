@@ -47,6 +47,11 @@ static int setting_crop_voverscan, crop_top;
 static NTSCFilter::Preset setting_filter;
 static const char* setting_palette;
 static int setting_reload;
+static int setting_runahead;
+static bool setting_rgb565;
+
+// RGB565 output, if the frontend provides no framebuffer
+static uint16_t video_buffer_rgb565[AtariNTSC::outWidth(160) * 312];
 
 static bool system_reset;
 
@@ -172,6 +177,45 @@ static void draw_crosshair(int16_t x, int16_t y, uint16_t color)
    }
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+static void video_output_rgb565()
+{
+  const unsigned width  = stella.getVideoWidth() - crop_left;
+  const unsigned height = stella.getVideoHeight() - crop_top * 2;
+  const unsigned pitch_in = stella.getVideoWidthMax();
+  const uint32_t* in = reinterpret_cast<const uint32_t*>(stella.getVideoBuffer()) +
+      crop_left + (crop_top * pitch_in);
+
+  uint16_t* out = video_buffer_rgb565;
+  size_t pitch_out = pitch_in * 2;
+
+  // Convert straight into the frontend's buffer, if it provides one
+  struct retro_framebuffer fb = {};
+  fb.width = width;
+  fb.height = height;
+  fb.access_flags = RETRO_MEMORY_ACCESS_WRITE;
+  if(environ_cb(RETRO_ENVIRONMENT_GET_CURRENT_SOFTWARE_FRAMEBUFFER, &fb) &&
+     fb.format == RETRO_PIXEL_FORMAT_RGB565)
+  {
+    out = static_cast<uint16_t*>(fb.data);
+    pitch_out = fb.pitch;
+  }
+
+  uint16_t* row = out;
+  for(unsigned y = 0; y < height; ++y)
+  {
+    for(unsigned x = 0; x < width; ++x)
+    {
+      const uint32_t c = in[x];
+      row[x] = ((c >> 8) & 0xf800) | ((c >> 5) & 0x07e0) | ((c >> 3) & 0x001f);
+    }
+    in += pitch_in;
+    row = reinterpret_cast<uint16_t*>(reinterpret_cast<uint8_t*>(row) + pitch_out);
+  }
+
+  video_cb(out, width, height, pitch_out);
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 static void update_input()
 {
@@ -593,6 +637,18 @@ static void update_variables(bool init = false)
     setting_reload = value;
   }
 
+  RETRO_GET("stella_runahead")
+  {
+    const int value = atoi(var.value);
+
+    if(setting_runahead != value)
+    {
+      stella.setRunAhead(value);
+
+      setting_runahead = value;
+    }
+  }
+
   RETRO_GET("stella_paddle_mouse_sensitivity")
   {
     stella_paddle_mouse_sensitivity = atoi(var.value);
@@ -619,6 +675,11 @@ static void update_variables(bool init = false)
       stella_lightgun_crosshair = true;
   }
 
+  RETRO_GET("stella_observation")
+  {
+    stella.setObservation(!strcmp(var.value, "enabled"));
+  }
+
   if(!init && !system_reset)
   {
     crop_left = setting_crop_hoverscan ? (stella.getVideoZoom() == 2 ? 32 : 8) : 0;
@@ -630,6 +691,45 @@ static void update_variables(bool init = false)
 #undef RETRO_GET
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+static void update_memory_maps()
+{
+  // RIOT RAM at its 6507 address; cart RAM, which has no fixed address,
+  // one after the other in a separate "CART" space; ARM RAM at its address
+  // in the "ARM" space.  All of these are a power of two in size.
+  static vector<retro_memory_descriptor> descriptors;
+  size_t cartStart = 0;
+
+  descriptors.clear();
+  descriptors.push_back({ RETRO_MEMDESC_SYSTEM_RAM, stella.getRAM(), 0,
+                          0x80, 0, 0, stella.getRAMSize(), NULL });
+
+  for(const auto& area: stella.getCartRAM())
+  {
+    retro_memory_descriptor desc = {};
+    desc.flags = RETRO_MEMDESC_SYSTEM_RAM;
+    desc.ptr = area.ram.data();
+    desc.len = area.ram.size();
+    if(area.armAddress)
+    {
+      desc.start = *area.armAddress;
+      desc.addrspace = "ARM";
+    }
+    else
+    {
+      desc.start = cartStart;
+      desc.addrspace = "CART";
+      cartStart += area.ram.size();
+    }
+    descriptors.push_back(desc);
+  }
+
+  struct retro_memory_map map = {
+    descriptors.data(), static_cast<unsigned>(descriptors.size())
+  };
+  environ_cb(RETRO_ENVIRONMENT_SET_MEMORY_MAPS, &map);
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 static bool reset_system()
 {
@@ -642,6 +742,9 @@ static bool reset_system()
   // start system
   if(!stella.create(log_cb ? true : false)) return false;
 
+  // let achievements and memory watchers read the RAM directly
+  update_memory_maps();
+
   // get auto-detect controllers
   input_type[0] = stella.getLeftControllerType();
   input_type[1] = stella.getRightControllerType();
@@ -745,6 +848,20 @@ void retro_set_environment(retro_environment_t cb)
   };
 
   static struct retro_core_option_v2_definition option_defs[] = {
+    {
+      "stella_pixel_format",
+      "Pixel format",
+      NULL,
+      "RGB565 halves the video bandwidth on low-end devices. Takes effect when the content is restarted.",
+      NULL,
+      "video",
+      {
+        { "xrgb8888", "XRGB8888" },
+        { "rgb565", "RGB565" },
+        { NULL, NULL },
+      },
+      "xrgb8888",
+    },
     {
       "stella_console",
       "Console display",
@@ -1241,6 +1358,37 @@ void retro_set_environment(retro_environment_t cb)
       },
       "off",
     },
+    {
+      "stella_runahead",
+      "Run-ahead frames",
+      NULL,
+      "Emulate frames ahead to reduce input latency.",
+      NULL,
+      "system",
+      {
+        { "0", NULL },
+        { "1", NULL },
+        { "2", NULL },
+        { "3", NULL },
+        { "4", NULL },
+        { NULL, NULL },
+      },
+      "0",
+    },
+    {
+      "stella_observation",
+      "Observation buffer",
+      NULL,
+      "Provide a preprocessed copy of each frame (grayscale, 84x84, max-pooled, 4 frames stacked) as video RAM, e.g. for reinforcement learning.",
+      NULL,
+      "system",
+      {
+        { "disabled", NULL },
+        { "enabled", NULL },
+        { NULL, NULL },
+      },
+      "disabled",
+    },
     { NULL, NULL, NULL, NULL, NULL, NULL, { { NULL, NULL } }, NULL },
   };
 
@@ -1251,6 +1399,7 @@ void retro_set_environment(retro_environment_t cb)
 
   static struct retro_variable variables[] = {
     // Adding more variables and rearranging them is safe.
+    { "stella_pixel_format", "Pixel format (restart); xrgb8888|rgb565" },
     { "stella_console", "Console display; auto|ntsc|pal|secam|ntsc50|pal60|secam60" },
     { "stella_palette", "Palette colors; standard|z26|user|custom" },
     { "stella_filter", "TV effects; disabled|composite|s-video|rgb|badly adjusted" },
@@ -1268,6 +1417,8 @@ void retro_set_environment(retro_environment_t cb)
     { "stella_paddle_analog_absolute", "Paddle analog absolute; disabled|enabled" },
     { "stella_lightgun_crosshair", "Lightgun crosshair; disabled|enabled" },
     { "stella_reload", "Enable reload/next game; off|on" },
+    { "stella_runahead", "Run-ahead frames; 0|1|2|3|4" },
+    { "stella_observation", "Observation buffer; disabled|enabled" },
     { NULL, NULL },
   };
 
@@ -1311,6 +1462,7 @@ static const struct retro_controller_description controllers[] = {
 bool retro_load_game(const struct retro_game_info *info)
 {
   enum retro_pixel_format fmt = RETRO_PIXEL_FORMAT_XRGB8888;
+  struct retro_variable var = { "stella_pixel_format", NULL };
 
   static const struct retro_controller_info controller_info[] = {
     { controllers, sizeof(controllers) / sizeof(controllers[0]) },
@@ -1362,12 +1514,31 @@ bool retro_load_game(const struct retro_game_info *info)
   // Send controller input descriptions to libretro
   environ_cb(RETRO_ENVIRONMENT_SET_INPUT_DESCRIPTORS, (void*)input_descriptors);
 
-  if(!environ_cb(RETRO_ENVIRONMENT_SET_PIXEL_FORMAT, &fmt))
+  // The pixel format can only be changed when loading
+  setting_rgb565 = environ_cb(RETRO_ENVIRONMENT_GET_VARIABLE, &var) && var.value &&
+      !strcmp(var.value, "rgb565");
+  if(setting_rgb565)
+  {
+    fmt = RETRO_PIXEL_FORMAT_RGB565;
+    if(!environ_cb(RETRO_ENVIRONMENT_SET_PIXEL_FORMAT, &fmt))
+    {
+      if(log_cb) log_cb(RETRO_LOG_INFO, "RGB565 is not supported, using XRGB8888.\n");
+      setting_rgb565 = false;
+      fmt = RETRO_PIXEL_FORMAT_XRGB8888;
+    }
+  }
+
+  if(!setting_rgb565 && !environ_cb(RETRO_ENVIRONMENT_SET_PIXEL_FORMAT, &fmt))
   {
     if(log_cb) log_cb(RETRO_LOG_INFO, "XRGB8888 is not supported.\n");
     return false;
   }
 
+  // States are complete, portable (little-endian) and of a fixed size, so
+  // none of the quirks apply; this tells the frontend so explicitly
+  uint64_t quirks = 0;
+  environ_cb(RETRO_ENVIRONMENT_SET_SERIALIZATION_QUIRKS, &quirks);
+
   stella.setROM(info->path, info->data, info->size);
 
   return reset_system();
@@ -1402,6 +1573,27 @@ void retro_run()
 
   update_input();
 
+  // Skip the output the frontend won't use (fast-forward, run-ahead)
+  int av_enable = 0;
+  if(!environ_cb(RETRO_ENVIRONMENT_GET_AUDIO_VIDEO_ENABLE, &av_enable))
+    av_enable = RETRO_AV_ENABLE_VIDEO | RETRO_AV_ENABLE_AUDIO;
+  stella.setVideoEnabled(av_enable & RETRO_AV_ENABLE_VIDEO);
+  stella.setAudioEnabled(av_enable & RETRO_AV_ENABLE_AUDIO);
+
+  // Render straight into the frontend's buffer, if it provides one which
+  // matches the frame (the pointer must be passed on unchanged, so this
+  // doesn't work with cropping)
+  if(!setting_rgb565 && !crop_left && !crop_top)
+  {
+    struct retro_framebuffer fb = {};
+    fb.width = stella.getVideoWidth();
+    fb.height = stella.getVideoHeight();
+    fb.access_flags = RETRO_MEMORY_ACCESS_WRITE;
+    if(environ_cb(RETRO_ENVIRONMENT_GET_CURRENT_SOFTWARE_FRAMEBUFFER, &fb) &&
+       fb.format == RETRO_PIXEL_FORMAT_XRGB8888)
+      stella.setVideoTarget(fb.data, fb.width, fb.height, fb.pitch);
+  }
+
   stella.runFrame();
 
   if(stella_lightgun_crosshair && input_crosshair[0] && input_crosshair[1])
@@ -1411,10 +1603,18 @@ void retro_run()
     update_geometry();
 
   if(stella.getVideoReady())
-    video_cb(reinterpret_cast<uInt32*>(stella.getVideoBuffer()) + crop_left + (crop_top * stella.getVideoWidthMax()),
-        stella.getVideoWidth() - crop_left,
-        stella.getVideoHeight() - crop_top * 2,
-        stella.getVideoPitch());
+  {
+    if(setting_rgb565)
+      video_output_rgb565();
+    else
+      video_cb(reinterpret_cast<uInt32*>(stella.getVideoBuffer()) + crop_left + (crop_top * stella.getVideoWidthMax()),
+          stella.getVideoWidth() - crop_left,
+          stella.getVideoHeight() - crop_top * 2,
+          stella.getVideoPitch());
+  }
+
+  // The frontend buffer is only valid during this call
+  stella.setVideoTarget(nullptr, 0, 0, 0);
 
   if(stella.getAudioReady())
     audio_batch_cb(stella.getAudioBuffer(), stella.getAudioSize());
@@ -1435,14 +1635,7 @@ void retro_deinit()
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 size_t retro_serialize_size()
 {
-  int runahead = -1;
-  if(environ_cb(RETRO_ENVIRONMENT_GET_AUDIO_VIDEO_ENABLE, &runahead))
-  {
-    // maximum state size possible
-    if(runahead & 4)
-      return 0x100000;
-  }
-
+  // Fixed for the loaded cart, as required by run-ahead and netplay
   return stella.getStateSize();
 }
 
@@ -1466,6 +1659,9 @@ void *retro_get_memory_data(unsigned id)
     case RETRO_MEMORY_SYSTEM_RAM:
       return stella.getRAM();
 
+    case RETRO_MEMORY_VIDEO_RAM:
+      return stella.getObservation();
+
     default:
       return NULL;
   }
@@ -1479,6 +1675,9 @@ size_t retro_get_memory_size(unsigned id)
     case RETRO_MEMORY_SYSTEM_RAM:
       return stella.getRAMSize();
 
+    case RETRO_MEMORY_VIDEO_RAM:
+      return stella.getObservationSize();
+
     default:
       return 0;
   }
@@ -0,0 +1,329 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2026 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+
+#include "BatchConsole.hxx"
+#include "Cart.hxx"
+#include "CartCreator.hxx"
+#include "DispatchResult.hxx"
+#include "FSNode.hxx"
+#include "HeadlessConsole.hxx"
+#include "MD5.hxx"
+#include "PaletteHandler.hxx"
+#include "Props.hxx"
+#include "PropsSet.hxx"
+#include "Serializer.hxx"
+#include "Settings.hxx"
+#include "stella.h"
+
+struct stella_console
+{
+  Settings settings;
+  unique_ptr<HeadlessConsole> console;
+  ByteArray capturedAudio;
+  vector<Int16> audio;
+  std::array<Int16, 0x1f> mixingTable{};
+  uInt32 height{0};
+};
+
+struct stella_batch
+{
+  vector<stella_console*> consoles;
+  unique_ptr<BatchConsole> batch;
+};
+
+namespace {
+  void startFrame(stella_console* console)
+  {
+    console->capturedAudio.clear();
+    console->console->riot().update();
+  }
+
+  void finishFrame(stella_console* console)
+  {
+    TIA& tia = console->console->tia();
+
+    tia.renderToFrameBuffer();
+    console->height = std::min(tia.frameBufferScanlinesLastFrame(),
+                               TIAConstants::frameBufferHeight);
+
+    // Mix both channels into mono samples
+    console->audio.resize(console->capturedAudio.size());
+    std::ranges::transform(console->capturedAudio, console->audio.begin(),
+        [console](uInt8 sample) {
+          return console->mixingTable[(sample & 0x0f) + (sample >> 4)];
+        });
+  }
+
+  Int16 mixingTableEntry(uInt8 v, uInt8 vMax)
+  {
+    // Same as the TIA's Audio mixing of both channels
+    constexpr double R_MAX = 30.;
+    constexpr double R = 1.;
+
+    return static_cast<Int16>(
+      floor(0x7fff * static_cast<double>(v) / static_cast<double>(vMax) *
+            (R_MAX + R * static_cast<double>(vMax)) / (R_MAX + R * static_cast<double>(v)))
+    );
+  }
+} // namespace
+
+// The libretro platform layer reads the ROM and logs through these; ROMs
+// are always passed in memory here, and the Logger keeps its own messages
+uInt32 libretro_read_rom(void*) { return 0; }
+uInt32 libretro_get_rom_size() { return 0; }
+void libretro_logger(int, const char*) { }
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+stella_console* stella_create(const void* rom, size_t size, const char* type,
+                              const char* name)
+{
+  if(rom == nullptr || size == 0 || size > Cartridge::maxSize())
+    return nullptr;
+
+  try
+  {
+    auto instance = std::make_unique<stella_console>();
+
+    ByteBuffer image = std::make_unique<uInt8[]>(size);
+    std::copy_n(static_cast<const uInt8*>(rom), size, image.get());
+    string md5 = MD5::hash(image, size);
+
+    Properties props;
+    const PropertiesSet propSet;
+    propSet.getMD5(md5, props);
+
+    string cartType = type != nullptr ? type : "";
+    if(cartType.empty())
+      cartType = props.get(PropType::Cart_Type);
+
+    const FSNode imageFile(name != nullptr ? name : "");
+    unique_ptr<Cartridge> cartridge = CartCreator::create(
+        imageFile, image, size, md5, cartType, instance->settings);
+    if(!cartridge)
+      return nullptr;
+
+    instance->console = std::make_unique<HeadlessConsole>(
+        std::move(cartridge), instance->settings, props);
+    instance->console->detectLayout();
+    instance->console->tia().setAudioCapture(&instance->capturedAudio);
+
+    for(uInt8 i = 0; i < instance->mixingTable.size(); ++i)
+      instance->mixingTable[i] = mixingTableEntry(i, 0x1e);
+
+    return instance.release();
+  }
+  catch(...)
+  {
+    return nullptr;
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void stella_destroy(stella_console* console)
+{
+  delete console;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void stella_reset(stella_console* console)
+{
+  console->console->system().reset();
+  console->capturedAudio.clear();
+  console->audio.clear();
+  console->height = 0;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+int stella_step_frame(stella_console* console)
+{
+  TIA& tia = console->console->tia();
+  DispatchResult result;
+
+  startFrame(console);
+
+  do
+    tia.update(result);
+  while(!tia.newFramePending() &&
+        result.getStatus() == DispatchResult::Status::ok);
+
+  finishFrame(console);
+
+  return result.getStatus() == DispatchResult::Status::ok ? 1 : 0;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+stella_batch* stella_batch_create(stella_console* const* consoles, size_t count)
+{
+  if(consoles == nullptr || count == 0)
+    return nullptr;
+
+  try
+  {
+    auto instance = std::make_unique<stella_batch>();
+    vector<HeadlessConsole*> lanes;
+
+    for(size_t i = 0; i < count; ++i)
+    {
+      if(!BatchConsole::supports(consoles[i]->console->cartridge()))
+        return nullptr;
+
+      instance->consoles.push_back(consoles[i]);
+      lanes.push_back(consoles[i]->console.get());
+    }
+    instance->batch = std::make_unique<BatchConsole>(lanes);
+
+    return instance.release();
+  }
+  catch(...)
+  {
+    return nullptr;
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void stella_batch_destroy(stella_batch* batch)
+{
+  delete batch;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+int stella_batch_step_frame(stella_batch* batch)
+{
+  for(stella_console* console: batch->consoles)
+    startFrame(console);
+
+  const bool ok = batch->batch->runFrame();
+
+  for(stella_console* console: batch->consoles)
+    finishFrame(console);
+
+  return ok ? 1 : 0;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void stella_set_input(stella_console* console, int port, uint32_t buttons)
+{
+  static constexpr std::array<std::array<Event::Type, 5>, 2> events = {{
+    { Event::LeftJoystickUp, Event::LeftJoystickDown, Event::LeftJoystickLeft,
+      Event::LeftJoystickRight, Event::LeftJoystickFire },
+    { Event::RightJoystickUp, Event::RightJoystickDown, Event::RightJoystickLeft,
+      Event::RightJoystickRight, Event::RightJoystickFire }
+  }};
+  if(port < 0 || port > 1)
+    return;
+
+  Event& event = console->console->event();
+  for(size_t i = 0; i < events[port].size(); ++i)
+    event.set(events[port][i], (buttons & (1U << i)) ? 1 : 0);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void stella_set_switches(stella_console* console, uint32_t switches)
+{
+  Event& event = console->console->event();
+  const auto set = [&event](Event::Type on, Event::Type off, bool value) {
+    event.set(on, value ? 1 : 0);
+    event.set(off, value ? 0 : 1);
+  };
+
+  event.set(Event::ConsoleReset, (switches & STELLA_SWITCH_RESET) ? 1 : 0);
+  event.set(Event::ConsoleSelect, (switches & STELLA_SWITCH_SELECT) ? 1 : 0);
+  set(Event::ConsoleBlackWhite, Event::ConsoleColor,
+      switches & STELLA_SWITCH_BW);
+  set(Event::ConsoleLeftDiffA, Event::ConsoleLeftDiffB,
+      switches & STELLA_SWITCH_LEFT_DIFF_A);
+  set(Event::ConsoleRightDiffA, Event::ConsoleRightDiffB,
+      switches & STELLA_SWITCH_RIGHT_DIFF_A);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+const uint8_t* stella_frame(stella_console* console, uint32_t* width,
+                            uint32_t* height)
+{
+  if(width != nullptr)
+    *width = TIAConstants::H_PIXEL;
+  if(height != nullptr)
+    *height = console->height;
+
+  return console->console->tia().frameBuffer();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+const uint32_t* stella_palette(stella_console*)
+{
+  // The headless consoles always use NTSC timing
+  return PaletteHandler::standardPalette(ConsoleTiming::ntsc).data();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+const int16_t* stella_audio(stella_console* console, size_t* samples)
+{
+  if(samples != nullptr)
+    *samples = console->audio.size();
+
+  return console->audio.data();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+const uint8_t* stella_ram(stella_console* console)
+{
+  return console->console->riot().getRAM();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+size_t stella_state_size(stella_console* console)
+{
+  try
+  {
+    Serializer state;
+    return console->console->save(state) ? state.size() : 0;
+  }
+  catch(...)
+  {
+    return 0;
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+size_t stella_save_state(stella_console* console, void* data, size_t size)
+{
+  try
+  {
+    // Write straight into the caller's buffer, which fails if it is too small
+    Serializer state(std::span{static_cast<std::byte*>(data), size});
+    return console->console->save(state) ? state.size() : 0;
+  }
+  catch(...)
+  {
+    return 0;
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+int stella_load_state(stella_console* console, const void* data, size_t size)
+{
+  try
+  {
+    Serializer state(std::span{static_cast<const std::byte*>(data), size});
+    return console->console->load(state) ? 1 : 0;
+  }
+  catch(...)
+  {
+    return 0;
+  }
+}
@@ -0,0 +1,148 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2026 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+
+#ifndef STELLA_H
+#define STELLA_H
+
+/*
+  A small C interface to the emulation core, for embedding Stella in other
+  programs (e.g. reinforcement learning environments or test harnesses).
+  Each handle is a complete, independent console without any frontend,
+  video or sound output attached; handles may be used on different threads
+  at the same time.  The console always uses NTSC timing and joysticks on
+  both ports.
+
+  All pointers returned by the library remain owned by the handle, and are
+  valid until the next call to stella_step_frame(), stella_reset() or
+  stella_destroy() on the same handle.
+*/
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(_WIN32) && defined(STELLA_SHARED)
+  #define STELLA_API __declspec(dllexport)
+#elif defined(__GNUC__)
+  #define STELLA_API __attribute__((visibility("default")))
+#else
+  #define STELLA_API
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Joystick bits for stella_set_input() */
+#define STELLA_INPUT_UP     0x01
+#define STELLA_INPUT_DOWN   0x02
+#define STELLA_INPUT_LEFT   0x04
+#define STELLA_INPUT_RIGHT  0x08
+#define STELLA_INPUT_FIRE   0x10
+
+/* Console switch bits for stella_set_switches() */
+#define STELLA_SWITCH_RESET         0x01
+#define STELLA_SWITCH_SELECT        0x02
+#define STELLA_SWITCH_BW            0x04  /* otherwise color */
+#define STELLA_SWITCH_LEFT_DIFF_A   0x08  /* otherwise B */
+#define STELLA_SWITCH_RIGHT_DIFF_A  0x10  /* otherwise B */
+
+/* Sample rate of the audio returned by stella_audio() */
+#define STELLA_AUDIO_RATE 31440
+
+typedef struct stella_console stella_console;
+typedef struct stella_batch stella_batch;
+
+/*
+  Create a console from a ROM image in memory.  The image is copied.  The
+  bankswitch type (e.g. "F8" or "AUTO") and the file name (only used for
+  detecting the type by its extension) may be NULL.  Returns NULL if the
+  cartridge could not be created.
+*/
+STELLA_API stella_console* stella_create(const void* rom, size_t size,
+                                         const char* type, const char* name);
+STELLA_API void stella_destroy(stella_console* console);
+
+/* Power cycle the console */
+STELLA_API void stella_reset(stella_console* console);
+
+/*
+  Emulate one frame with the current input.  Returns 0 if the emulation
+  failed (e.g. the CPU hit an illegal instruction), 1 otherwise.
+*/
+STELLA_API int stella_step_frame(stella_console* console);
+
+/*
+  Experimental: run several consoles (usually with the same ROM) together,
+  decoding each instruction once for all consoles executing it.  The results
+  are the same as calling stella_step_frame() on each console, which remain
+  usable as before.  The consoles must not be destroyed before the batch,
+  and must all be used on the same thread.  Returns NULL if any console's
+  cartridge can't be batched (i.e. the Supercharger).
+*/
+STELLA_API stella_batch* stella_batch_create(stella_console* const* consoles,
+                                             size_t count);
+STELLA_API void stella_batch_destroy(stella_batch* batch);
+
+/* Emulate one frame on all consoles of the batch, like stella_step_frame() */
+STELLA_API int stella_batch_step_frame(stella_batch* batch);
+
+/* Set the joystick state of port 0 (left) or 1 (right), see STELLA_INPUT_* */
+STELLA_API void stella_set_input(stella_console* console, int port,
+                                 uint32_t buttons);
+
+/* Set the console switches, see STELLA_SWITCH_* */
+STELLA_API void stella_set_switches(stella_console* console, uint32_t switches);
+
+/*
+  The last frame, as one palette index per pixel ('width' pixels per row,
+  'height' rows).
+*/
+STELLA_API const uint8_t* stella_frame(stella_console* console,
+                                       uint32_t* width, uint32_t* height);
+
+/* The palette for stella_frame(), 256 entries of 0x00RRGGBB */
+STELLA_API const uint32_t* stella_palette(stella_console* console);
+
+/*
+  The mono audio generated during the last frame, at STELLA_AUDIO_RATE
+  (about 524 samples per frame).
+*/
+STELLA_API const int16_t* stella_audio(stella_console* console,
+                                       size_t* samples);
+
+/* The 128 bytes of RIOT RAM */
+STELLA_API const uint8_t* stella_ram(stella_console* console);
+
+/*
+  Save the complete state into caller provided memory.  stella_state_size()
+  returns the size required for the current state; saving fails (returns 0)
+  if the buffer is too small, otherwise the size written is returned.
+*/
+STELLA_API size_t stella_state_size(stella_console* console);
+STELLA_API size_t stella_save_state(stella_console* console, void* data,
+                                    size_t size);
+
+/* Load a state created by stella_save_state(); returns 1 on success */
+STELLA_API int stella_load_state(stella_console* console, const void* data,
+                                 size_t size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -15,6 +15,9 @@
 // this file, and for a DISCLAIMER OF ALL WARRANTIES.
 //============================================================================
 
+#include <fcntl.h>
+#include <sys/mman.h>
+
 #include "AsciiFold.hxx"
 #include "FSNodePOSIX.hxx"
 
@@ -113,6 +116,53 @@ size_t FSNodePOSIX::getSize() const
   return _size;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt64 FSNodePOSIX::getLastModified() const
+{
+  struct stat st{};
+  return (stat(_path.c_str(), &st) == 0) ? static_cast<uInt64>(st.st_mtime) : 0;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+size_t FSNodePOSIX::read(ByteBuffer& buffer, size_t size) const
+{
+  // Larger files are mapped copy-on-write instead of being read; the pages
+  // are shared with the OS file cache until somebody writes to them
+  if (!_isFile)
+    return 0;
+
+  const int fd = open(_path.c_str(), O_RDONLY);
+  if (fd < 0)
+    return 0;
+
+  // The file may have changed since its size was cached, so the mapping must
+  // use the size of the file actually opened; mapping past EOF faults on access
+  struct stat st{};
+  if (fstat(fd, &st) != 0)
+  {
+    close(fd);
+    return 0;
+  }
+  _size = st.st_size;
+
+  const size_t sizeRead = size > 0 ? std::min(_size, size) : _size;
+  if (sizeRead < MAP_THRESHOLD)
+  {
+    close(fd);
+    return 0;  // let FSNode read the file instead
+  }
+
+  void* data = mmap(nullptr, sizeRead, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+  close(fd);  // the mapping stays valid after closing the file
+  if (data == MAP_FAILED)  // NOLINT(performance-no-int-to-ptr)
+    return 0;
+
+  const auto release = [](uInt8* ptr, size_t length) { munmap(ptr, length); };
+  buffer = ByteBuffer(static_cast<uInt8*>(data), ByteBufferDeleter(release, sizeRead));
+
+  return sizeRead;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool FSNodePOSIX::hasParent() const
 {
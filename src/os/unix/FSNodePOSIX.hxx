@@ -70,9 +70,11 @@ class FSNodePOSIX : public AbstractFSNode
     bool rename(string_view newfile) override;
 
     size_t getSize() const override;
+    uInt64 getLastModified() const override;
     bool hasParent() const override;
     AbstractFSNodePtr getParent() const override;
     bool getChildren(AbstractFSList& list, ListMode mode) const override;
+    size_t read(ByteBuffer& buffer, size_t size) const override;
 
     std::ifstream openIFStream(std::ios::openmode mode) const override {
       return std::ifstream(_path, mode);
@@ -94,6 +96,10 @@ class FSNodePOSIX : public AbstractFSNode
 
     static const string& homeDir();
 
+    // Smaller files are simply read, since the mapping costs more than
+    // the copy it saves
+    static constexpr size_t MAP_THRESHOLD = 64_KB;
+
   private:
     string _path, _displayName;
     bool _isFile{false}, _isDirectory{true};
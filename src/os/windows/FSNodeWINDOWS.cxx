@@ -127,6 +127,13 @@ size_t FSNodeWINDOWS::getSize() const
   return _size.value_or(0);
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt64 FSNodeWINDOWS::getLastModified() const
+{
+  struct _stat st;
+  return (_wstat(_pathW.c_str(), &st) == 0) ? static_cast<uInt64>(st.st_mtime) : 0;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 AbstractFSNodePtr FSNodeWINDOWS::getParent() const
 {
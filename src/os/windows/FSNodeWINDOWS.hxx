@@ -58,6 +58,7 @@ class FSNodeWINDOWS : public AbstractFSNode
     bool rename(string_view newfile) override;
 
     size_t getSize() const override;
+    uInt64 getLastModified() const override;
     bool hasParent() const override { return !_isPseudoRoot; }
     AbstractFSNodePtr getParent() const override;
     bool getChildren(AbstractFSList& fslist, ListMode mode) const override;
@@ -189,3 +189,14 @@ sub build_prop_string {
 
   return $result;
 }
+
+# Convert an md5sum into a C++ compatible array of 16 bytes
+sub build_md5_key {
+  my $md5 = $_[0];
+  if ($md5 !~ /^[0-9a-f]{32}$/) {
+    die "Invalid md5sum: $md5\n";
+  }
+  my @bytes = map { "0x$_" } ($md5 =~ /(..)/g);
+
+  return "  { " . join(",", @bytes) . " }";
+}
@@ -81,8 +81,10 @@ print OUTFILE "*/\n";
 print OUTFILE "static constexpr BSPF::array2D<const char*, DEF_PROPS_SIZE, " . $typesize . "> DefProps = {{\n";
 
 # Walk the hash map and print each item in order of md5sum
+# (case-insensitive, so the order matches that of the binary keys below)
+my @sortedkeys = sort { lc($a) cmp lc($b) } keys %propset;
 my $idx = 0;
-for my $key ( sort keys %propset )
+for my $key ( @sortedkeys )
 {
   print OUTFILE PropSet::build_prop_string(@{ $propset{$key} });
 
@@ -93,6 +95,26 @@ for my $key ( sort keys %propset )
   $idx++;
 }
 
+print OUTFILE "}};\n";
+print OUTFILE "\n";
+print OUTFILE "/**\n";
+print OUTFILE "  The md5sums of the entries above in binary form, in the same order,\n";
+print OUTFILE "  used for searching the table.\n";
+print OUTFILE "*/\n";
+print OUTFILE "static constexpr std::array<std::array<uInt8, 16>, DEF_PROPS_SIZE> DefPropsMD5 = {{\n";
+
+$idx = 0;
+for my $key ( @sortedkeys )
+{
+  print OUTFILE PropSet::build_md5_key(lc($key));
+
+  if ($idx+1 < $setsize) {
+    print OUTFILE ",";
+  }
+  print OUTFILE "\n";
+  $idx++;
+}
+
 print OUTFILE "}};\n";
 print OUTFILE "\n// NOLINTEND\n\n";
 print OUTFILE "#endif\n";